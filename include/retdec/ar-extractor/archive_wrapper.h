@@ -7,10 +7,13 @@
 #ifndef RETDEC_AR_EXTRACTOR_ARCHIVE_WRAPPER_H
 #define RETDEC_AR_EXTRACTOR_ARCHIVE_WRAPPER_H
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <llvm/ADT/ArrayRef.h>
 #include <llvm/Object/Archive.h>
 #include <llvm/Support/Error.h>
 
@@ -27,10 +30,13 @@ class ArchiveWrapper : private retdec::utils::NonCopyable
 	public:
 		ArchiveWrapper(const std::string &archivePath, bool &succes,
 			std::string &errorMessage);
+		ArchiveWrapper(const char *data, std::size_t size, bool &succes,
+			std::string &errorMessage);
 
 		/// @brief Getters.
 		/// @{
 		std::size_t getNumberOfObjects() const;
+		const char *getBufferStart() const;
 		/// @}
 
 		/// @brief Query methods.
@@ -57,6 +63,18 @@ class ArchiveWrapper : private retdec::utils::NonCopyable
 			const std::string &outputPath = "") const;
 		/// @}
 
+		/// @brief In-place access methods.
+		/// @{
+		bool getObjectRangeByName(const std::string &name, std::size_t &offset,
+			std::size_t &size, std::string &errorMessage) const;
+		bool getObjectRangeByIndex(const std::size_t index, std::size_t &offset,
+			std::size_t &size, std::string &errorMessage) const;
+		bool forEachMember(
+			const std::function<void(const std::string &,
+				llvm::ArrayRef<std::uint8_t>)> &callback,
+			std::string &errorMessage) const;
+		/// @}
+
 	private:
 		/// LLVM archive parser.
 		std::unique_ptr<llvm::object::Archive> archive;
@@ -65,6 +83,9 @@ class ArchiveWrapper : private retdec::utils::NonCopyable
 
 		/// @brief Auxiliary methods.
 		/// @{
+		void init(bool &succes, std::string &errorMessage);
+		bool getRange(const llvm::StringRef &child, std::size_t &offset,
+			std::size_t &size) const;
 		bool getNames(std::vector<std::string> &result,
 			std::string &errorMessage) const;
 		bool getCount(std::size_t &count, std::string &errorMessage) const;
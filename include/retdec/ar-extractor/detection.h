@@ -7,6 +7,7 @@
 #ifndef RETDEC_AR_EXTRACTOR_DETECTION_H
 #define RETDEC_AR_EXTRACTOR_DETECTION_H
 
+#include <cstddef>
 #include <string>
 
 namespace retdec {
@@ -14,6 +15,8 @@ namespace ar_extractor {
 
 bool isArchive(const std::string &path);
 
+bool isArchive(const char *data, std::size_t size);
+
 bool isThinArchive(const std::string &path);
 
 bool isNormalArchive(const std::string &path);
@@ -9,6 +9,7 @@
 
 #include <map>
 #include <set>
+#include <unordered_map>
 
 #include <llvm/IR/Module.h>
 
@@ -39,7 +40,9 @@ class CtorDtor
 
 		using FunctionSet    = std::set<llvm::Function*>;
 		using FunctionToInfo = std::map<llvm::Function*, FunctionInfo>;
-		using StoreToVtable  = std::map<llvm::StoreInst*, const common::Vtable*>;
+		using StoreToVtable  = std::unordered_map<
+				llvm::StoreInst*,
+				const common::Vtable*>;
 
 	public:
 		void runOnModule(llvm::Module* m, Config* c, FileImage* i);
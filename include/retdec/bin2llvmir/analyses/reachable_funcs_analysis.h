@@ -7,9 +7,9 @@
 #ifndef RETDEC_BIN2LLVMIR_ANALYSES_REACHABLE_FUNCS_ANALYSIS_H
 #define RETDEC_BIN2LLVMIR_ANALYSES_REACHABLE_FUNCS_ANALYSIS_H
 
+#include <set>
 #include <string>
 
-#include <llvm/ADT/SCCIterator.h>
 #include <llvm/Analysis/CallGraph.h>
 
 namespace retdec {
@@ -26,14 +26,6 @@ public:
 	static std::set<llvm::Function*> getReachableDefinedFuncsFor(llvm::Function &func,
 		llvm::Module &module, llvm::CallGraph &callGraph);
 	static std::set<llvm::Function*> getGloballyReachableFuncsFor(llvm::Module &module);
-
-private:
-	std::set<llvm::Function*> getDirectlyReachableDefinedFuncsFor(
-		const std::set<llvm::Function*> &funcs, llvm::CallGraph &callGraph) const;
-	std::set<llvm::Function*> getDirectlyReachableDefinedFuncsFor(
-		llvm::CallGraphNode &reachableFrom) const;
-	std::set<llvm::Function*> getIndirectlyReachableDefinedFuncsFor(
-		const std::set<llvm::Function*> &funcs, llvm::Module &module) const;
 };
 
 } // namespace bin2llvmir
@@ -3,9 +3,8 @@
 * @brief Reaching definitions analysis (RDA) builds UD and DU chains.
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 *
-* Right now, this works on an entire module. But we could insert an another layer
-* that represents functions. Then it would be possible to associate BBs with
-* functions that own them and recompute RDA only for the selected function.
+* Definitions are numbered densely per function and the dataflow runs over bit
+* vectors of these numbers, function by function, in reverse post-order.
 */
 
 #ifndef RETDEC_BIN2LLVMIR_ANALYSES_REACHING_DEFINITIONS_H
@@ -15,8 +14,10 @@
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
+#include <llvm/ADT/BitVector.h>
 #include <llvm/ADT/SmallPtrSet.h>
 #include <llvm/IR/Module.h>
 
@@ -59,6 +60,9 @@ class Definition
 		/// Definition instruction position in its BB.
 		/// Can be used to find out if def dominates its uses in the same BB.
 		unsigned posInBb = 0;
+		/// Dense number of the definition in its function, used as index
+		/// into the dataflow bit vectors.
+		unsigned id = 0;
 };
 
 class Use
@@ -90,7 +94,6 @@ class BasicBlockEntry
 				std::ostream& out,
 				const BasicBlockEntry& bbe);
 
-		void initializeKillDefSets();
 		Changed initDefsOut();
 
 		const DefSet& defsFromUse(const llvm::Instruction* I) const;
@@ -106,12 +109,12 @@ class BasicBlockEntry
 
 		BBEntrySet prevBBs;
 
+		// Dataflow sets indexed by Definition::id.
 		// defsIn is union of prevBBs' defsOuts
-		DefSet defsOut;
-		DefSet genDefs;
-		std::unordered_set<llvm::Value*> killDefs;
-
-		bool changed = false;
+		llvm::BitVector defsIn;
+		llvm::BitVector defsOut;
+		llvm::BitVector genDefs;
+		llvm::BitVector killDefs;
 
 	private:
 		unsigned id;
@@ -128,9 +131,14 @@ class ReachingDefinitionsAnalysis
 				llvm::Function& F,
 				Abi* abi = nullptr,
 				bool trackFlagRegs = false);
+		std::size_t update(llvm::Module& M);
+		void invalidate(const llvm::Function* F);
 		void clear();
 		bool wasRun() const;
 
+		static void setThreads(unsigned threads);
+		static unsigned getThreads();
+
 	// Full instance interface.
 	//
 	public:
@@ -152,22 +160,81 @@ class ReachingDefinitionsAnalysis
 				llvm::Instruction* I);
 
 	private:
-		void run();
-		const BasicBlockEntry& getBasicBlockEntry(const llvm::Instruction* I) const;
-		void initializeBasicBlocks(llvm::Module& M);
-		void initializeBasicBlocks(llvm::Function& F);
-		void initializeBasicBlocksPrev();
-		void initializeKillGenSets();
-		void propagate();
-		void initializeDefsAndUses();
-		void clearInternal();
+		using BasicBlockEntries = std::unordered_map<
+				const llvm::BasicBlock*,
+				BasicBlockEntry>;
+		/// Definitions of each defined value, indexed by Definition::id.
+		using SourceDefinitions = std::unordered_map<
+				const llvm::Value*,
+				llvm::BitVector>;
+		/// Read-only results of a single function once it is analysed.
+		struct FunctionEntry
+		{
+			/// Id of the function's first basic block.
+			unsigned firstId = 0;
+			BasicBlockEntries bbs;
+			/// Instruction to its definition/(first) use, for fast queries.
+			std::unordered_map<const llvm::Instruction*, const Definition*> insn2def;
+			std::unordered_map<const llvm::Instruction*, const Use*> insn2use;
+		};
+
+	private:
+		void run(const std::vector<llvm::Function*>& fncs);
+		void run(llvm::Function* F, FunctionEntry& fe);
+		void initializeBasicBlocks(llvm::Function& F, FunctionEntry& fe);
+		void initializeBasicBlocksPrev(BasicBlockEntries& bbs);
+		void initializeIndexes(FunctionEntry& fe);
+		void numberDefinitions(
+				const llvm::Function* F,
+				BasicBlockEntries& bbs,
+				std::vector<Definition*>& defs,
+				SourceDefinitions& srcDefs);
+		void initializeKillGenSets(
+				BasicBlockEntries& bbs,
+				std::size_t defCount,
+				const SourceDefinitions& srcDefs);
+		void propagate(const llvm::Function* F, BasicBlockEntries& bbs);
+		void initializeDefsAndUses(
+				BasicBlockEntries& bbs,
+				const std::vector<Definition*>& defs,
+				const SourceDefinitions& srcDefs);
+		void clearInternal(BasicBlockEntries& bbs);
+		const FunctionEntry* getFunctionEntry(const llvm::Instruction* I) const;
 
 	private:
-		std::map<const llvm::Function*, std::map<const llvm::BasicBlock*, BasicBlockEntry>> bbMap;
+		std::map<const llvm::Function*, FunctionEntry> bbMap;
+		unsigned _nextBbId = 0;
 		bool _trackFlagRegs = false;
 		const llvm::GlobalVariable* _specialGlobal = nullptr;
 		bool _run = false;
 		Abi* _abi = nullptr;
+
+		static thread_local unsigned _threads;
+};
+
+/**
+ * Reaching definitions analyses shared by passes running on the same module.
+ *
+ * The analysis is computed on the first @c getRda() and kept until it is
+ * invalidated. Passes using it must @c invalidate() every function they
+ * modify; only these functions are recomputed by the next @c getRda().
+ * Passes that do not use the provider must not run while the analysis is
+ * kept -- it should be invalidated as a whole before them.
+ */
+class ReachingDefinitionsProvider
+{
+	public:
+		static ReachingDefinitionsAnalysis* getRda(
+				llvm::Module* m,
+				Abi* abi = nullptr,
+				bool trackFlagRegs = false);
+		static void invalidate(llvm::Module* m, const llvm::Function* f);
+		static void invalidate(llvm::Module* m);
+		static void clear();
+
+	private:
+		using Key = std::pair<llvm::Module*, bool>;
+		static thread_local std::map<Key, ReachingDefinitionsAnalysis> _module2rda;
 };
 
 } // namespace bin2llvmir
@@ -31,13 +31,19 @@ namespace bin2llvmir {
  * analysis.
  *
  * For optimization reasons, some data members of this structure are static,
- * i.e. common for all instances.
+ * i.e. common for all instances in the current thread. Decompilations running
+ * in different threads do not share them.
  * The typical usage of this class is: creation -> simplification -> pattern
  * detection -> action based on pattern -> throwing away the current instance
  * before creating and processing the new one.
  * In such a case, global data members and global behaviour configuration is
  * not a problem. If you, for whatever reason, want to store instances, keep
  * this in mind.
+ *
+ * Expansion of the same value at the same level always gives the same
+ * subtree. A single tree construction therefore expands every such value
+ * only once, its repeated occurrences are copies. Similarly, simplification
+ * of a big tree simplifies structurally identical subtrees only once.
  */
 class SymbolicTree
 {
@@ -147,25 +153,43 @@ class SymbolicTree
 		static void setNaryLimit(unsigned n);
 
 	private:
-		static Abi* _abi;
-		static Config* _config;
-		static bool _val2valUsed;
-		static bool _trackThroughAllocaLoads;
-		static bool _trackThroughGeneralRegisterLoads;
-		static bool _trackOnlyFlagRegisters;
-		static bool _simplifyAtCreation;
-		static unsigned _naryLimit;
+		struct ExpansionCache;
+		struct SimplificationCache;
+
+	private:
+		static thread_local Abi* _abi;
+		static thread_local Config* _config;
+		static thread_local bool _val2valUsed;
+		static thread_local bool _trackThroughAllocaLoads;
+		static thread_local bool _trackThroughGeneralRegisterLoads;
+		static thread_local bool _trackOnlyFlagRegisters;
+		static thread_local bool _simplifyAtCreation;
+		static thread_local unsigned _naryLimit;
+		static thread_local ExpansionCache* _expansionCache;
 
 	// Private methods.
 	//
 	private:
+		static SymbolicTree create(
+				ReachingDefinitionsAnalysis* rda,
+				llvm::Value* v,
+				unsigned maxNodeLevel,
+				std::map<llvm::Value*, llvm::Value*>* v2v,
+				bool linear);
+		void build(
+				ReachingDefinitionsAnalysis* RDA,
+				std::map<llvm::Value*, llvm::Value*>* val2val,
+				unsigned maxNodeLevel,
+				bool linear);
 		void expandNode(
 				ReachingDefinitionsAnalysis* RDA,
 				std::map<llvm::Value*, llvm::Value*>* val2val,
 				unsigned maxNodeLevel,
 				bool linear);
 
-		void _simplifyNode();
+		void _simplifyNode(SimplificationCache* cache);
+		unsigned internSubtrees(SimplificationCache& cache) const;
+		std::size_t getNodeCount() const;
 		void fixLevel(unsigned level = 0);
 
 		void _getPreOrder(std::vector<SymbolicTree*>& res) const;
@@ -7,6 +7,8 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_CLASS_HIERARCHY_HIERARCHY_ANALYSIS_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_CLASS_HIERARCHY_HIERARCHY_ANALYSIS_H
 
+#include <unordered_map>
+
 #include <llvm/IR/Module.h>
 #include <llvm/Pass.h>
 
@@ -20,6 +22,15 @@ namespace bin2llvmir {
 
 class ClassHierarchyAnalysis : public llvm::ModulePass
 {
+	public:
+		using GccRttiToClass = std::unordered_map<
+				const rtti_finder::ClassTypeInfo*,
+				Class*>;
+		using MsvcRttiToClass = std::unordered_map<
+				const rtti_finder::RTTITypeDescriptor*,
+				Class*>;
+		using VtableToClass = std::unordered_map<const common::Vtable*, Class*>;
+
 	public:
 		static char ID;
 		ClassHierarchyAnalysis();
@@ -27,8 +38,8 @@ class ClassHierarchyAnalysis : public llvm::ModulePass
 
 		void processRttiGcc();
 		void processRttiMsvc();
-		void processVtablesGcc(std::map<const rtti_finder::ClassTypeInfo*, Class*> &rtti2class);
-		void processVtablesMsvc(std::map<const rtti_finder::RTTITypeDescriptor*, Class*> &rtti2class);
+		void processVtablesGcc(GccRttiToClass& rtti2class);
+		void processVtablesMsvc(MsvcRttiToClass& rtti2class);
 		void processCtorsDtors();
 
 		void setToConfig(llvm::Module* m) const;
@@ -39,6 +50,8 @@ class ClassHierarchyAnalysis : public llvm::ModulePass
 
 		CtorDtor ctorDtor;
 		ClassHierarchy classHierarchy;
+		/// Classes of the processed vtables.
+		VtableToClass vtable2class;
 };
 
 } // namespace bin2llvmir
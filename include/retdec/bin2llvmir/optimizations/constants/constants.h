@@ -55,6 +55,8 @@ class ConstantsAnalysis : public llvm::ModulePass
 		DebugFormat* _dbgf = nullptr;
 
 		std::unordered_set<llvm::Value*> _toRemove;
+		/// Functions whose reaching definitions must be recomputed.
+		std::unordered_set<llvm::Function*> _modified;
 };
 
 } // namespace bin2llvmir
@@ -11,6 +11,7 @@
 #include <optional>
 #include <queue>
 #include <sstream>
+#include <tuple>
 
 #include <llvm/IR/CFG.h>
 #include <llvm/IR/Function.h>
@@ -29,7 +30,10 @@
 #include "retdec/bin2llvmir/providers/names.h"
 #include "retdec/bin2llvmir/optimizations/decoder/decoder_debug.h"
 #include "retdec/bin2llvmir/optimizations/decoder/decoder_ranges.h"
+#include "retdec/bin2llvmir/optimizations/decoder/disassembly_cache.h"
 #include "retdec/bin2llvmir/optimizations/decoder/jump_targets.h"
+#include "retdec/bin2llvmir/optimizations/decoder/mode_map.h"
+#include "retdec/bin2llvmir/optimizations/decoder/speculative_disassembler.h"
 #include "retdec/bin2llvmir/utils/ir_modifier.h"
 #include "retdec/bin2llvmir/utils/symbolic_tree_match.h"
 #include "retdec/capstone2llvmir/capstone2llvmir.h"
@@ -40,6 +44,42 @@ namespace bin2llvmir {
 
 class Decoder : public llvm::ModulePass
 {
+	public:
+		/// Counters of the decoding work.
+		struct Statistics
+		{
+			/// Decoding of jump targets of one type.
+			struct JumpTargetType
+			{
+				/// Decoded jump targets.
+				std::size_t decoded = 0;
+				/// Time spent decoding them [us].
+				std::uint64_t time = 0;
+			};
+
+			/// Translated instructions (including delay slots).
+			std::size_t decodedInstructions = 0;
+			/// Bytes of translated instructions.
+			std::size_t decodedBytes = 0;
+			/// Bytes skipped as data because their dry run failed.
+			std::size_t skippedBytes = 0;
+			/// Dry runs of jump targets.
+			std::size_t dryRuns = 0;
+			/// Dry runs that rejected their jump targets.
+			std::size_t dryRunRejections = 0;
+			/// Pseudo calls whose targets were resolved by
+			/// @c resolvePseudoCalls().
+			std::size_t pseudoCallsResolved = 0;
+			/// Pseudo calls removed by @c resolvePseudoCalls() because
+			/// their targets are unknown.
+			std::size_t pseudoCallsRemoved = 0;
+			/// Delay slots moved before their branches.
+			std::size_t delaySlotFixups = 0;
+			/// Functions created by splitting other functions.
+			std::size_t functionSplits = 0;
+			std::map<JumpTarget::eType, JumpTargetType> jumpTargetTypes;
+		};
+
 	public:
 		static char ID;
 		Decoder();
@@ -53,7 +93,18 @@ class Decoder : public llvm::ModulePass
 				NameContainer* n,
 				Abi* a);
 
+		const JumpTargets::Statistics& getJumpTargetStatistics() const;
+		const Statistics& getStatistics() const;
+
 	private:
+		/// Items read from a switch table.
+		struct SwitchTable
+		{
+			std::vector<common::Address> cases;
+			/// Address after the last item.
+			common::Address end;
+		};
+
 		using ByteData = typename std::pair<const std::uint8_t*, std::size_t>;
 
 	private:
@@ -64,7 +115,8 @@ class Decoder : public llvm::ModulePass
 	//
 	private:
 		void initTranslator();
-		void initDryRunCsInstruction();
+		void initDisassemblyCache();
+		void initModeMap();
 		void initEnvironment();
 		void initEnvironmentAsm2LlvmMapping();
 		void initEnvironmentPseudoFunctions();
@@ -73,6 +125,7 @@ class Decoder : public llvm::ModulePass
 		void initAllowedRangesWithSegments();
 		void initAllowedRangesWithConfig();
 		void initJumpTargets();
+		void initSpeculativeDisassembler();
 		void initJumpTargetsConfig();
 		void initJumpTargetsEntryPoint();
 		void initJumpTargetsExterns();
@@ -80,6 +133,7 @@ class Decoder : public llvm::ModulePass
 		void initJumpTargetsExports();
 		void initJumpTargetsDebug();
 		void initJumpTargetsSymbols();
+		void initJumpTargetsUnwind();
 		void initConfigFunctions();
 		void initStaticCode();
 		void initVtables();
@@ -87,6 +141,11 @@ class Decoder : public llvm::ModulePass
 	private:
 		void decode();
 		bool getJumpTarget(JumpTarget& jt);
+		bool isSelectedClosureDecoding() const;
+		bool isAllowedInSelectedClosure(const JumpTarget& jt) const;
+		bool enterSelectedClosureCall(
+				llvm::Function* caller,
+				llvm::Function* callee);
 		void decodeJumpTarget(const JumpTarget& jt);
 		std::size_t decodeJumpTargetDryRun(
 				const JumpTarget& jt,
@@ -98,6 +157,12 @@ class Decoder : public llvm::ModulePass
 						ByteData& bytes,
 						common::Address& addr,
 						llvm::IRBuilder<>& irb);
+		void speculate();
+		cs_insn* disassemble(
+				const ByteData& bytes,
+				common::Address addr,
+				cs_mode mode);
+		bool disassembleDryRun(ByteData& bytes, uint64_t& addr, cs_mode mode);
 
 		bool getJumpTargetsFromInstruction(
 				common::Address addr,
@@ -112,6 +177,15 @@ class Decoder : public llvm::ModulePass
 				llvm::CallInst* branchCall,
 				llvm::Value* val,
 				SymbolicTree& st);
+		const SwitchTable& getSwitchTable(
+				common::Address tableAddr,
+				unsigned tableSize,
+				unsigned maxIdx,
+				common::Address nextTableAddr);
+		const std::vector<unsigned>& getSwitchIndexTable(
+				common::Address tableAddr,
+				llvm::IntegerType* type,
+				unsigned tableSize);
 		bool instructionBreaksBasicBlock(
 				common::Address addr,
 				capstone2llvmir::Capstone2LlvmIrTranslator::TranslationResultOne& tr);
@@ -220,12 +294,7 @@ class Decoder : public llvm::ModulePass
 	// MIPS specific.
 	//
 	private:
-		bool disasm_mips(
-				csh ce,
-				cs_mode m,
-				ByteData& bytes,
-				uint64_t& a,
-				cs_insn* i);
+		bool disasm_mips(cs_mode m, ByteData& bytes, uint64_t& a);
 		std::size_t decodeJumpTargetDryRun_mips(
 				const JumpTarget& jt,
 				ByteData bytes,
@@ -298,7 +367,21 @@ class Decoder : public llvm::ModulePass
 		Abi* _abi = nullptr;
 
 		std::unique_ptr<capstone2llvmir::Capstone2LlvmIrTranslator> _c2l;
+		/// Instructions disassembled by dry runs and translation.
+		std::unique_ptr<DisassemblyCache> _disasmCache;
+		/// Instruction from @c _disasmCache processed by a dry run.
 		cs_insn* _dryCsInsn = nullptr;
+		/// Known basic modes of addresses - from mapping symbols and already
+		/// decoded ranges. Used only on ARM/Thumb.
+		ModeMap _modes;
+
+		/// Disassembles jump targets from the top of @c _jumpTargets ahead.
+		std::unique_ptr<SpeculativeDisassembler> _speculative;
+		/// Jump targets already passed to @c _speculative.
+		std::set<std::pair<common::Address, cs_mode>> _speculated;
+		/// Number of jump targets from the top of @c _jumpTargets passed to
+		/// @c _speculative.
+		std::size_t _speculationWindow = 0;
 
 		llvm::IRBuilder<>* _irb;
 
@@ -314,6 +397,9 @@ class Decoder : public llvm::ModulePass
 		std::set<common::Address> _staticFncs;
 		std::set<common::Address> _vtableFncs;
 		std::set<llvm::Function*> _terminatingFncs;
+		/// Call depths of functions from the selected ones, if only the call
+		/// graph closure of the selected functions is decoded.
+		std::map<llvm::Function*, std::size_t> _selectedClosureDepths;
 		llvm::Function* _entryPointFunction = nullptr;
 		/// Start of all recognized jump tables.
 		/// TODO: use this to check that one table does not use labels from
@@ -328,6 +414,17 @@ class Decoder : public llvm::ModulePass
 		/// label is not in jump table).
 		std::map<common::Address, std::set<llvm::SwitchInst*>> _switchTableStarts;
 
+		/// Memoized switch tables, keyed by the table address and bounds
+		/// (table size, max index, next table address).
+		std::map<
+				std::tuple<common::Address, unsigned, unsigned, common::Address>,
+				SwitchTable> _switchTables;
+		/// Memoized switch index tables, keyed by the table address, item
+		/// bit width, and table size.
+		std::map<
+				std::tuple<common::Address, unsigned, unsigned>,
+				std::vector<unsigned>> _switchIndexTables;
+
 		// We create helper BBs (without name and address) to handle MIPS
 		// likely branches. For convenience, we map them to real BBs they will
 		// eventually jump to.
@@ -337,6 +434,8 @@ class Decoder : public llvm::ModulePass
 		bool _switchGenerated = false;
 
 		bool _somethingDecoded = false;
+
+		Statistics _stats;
 };
 
 } // namespace bin2llvmir
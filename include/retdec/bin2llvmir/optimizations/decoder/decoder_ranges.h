@@ -8,6 +8,7 @@
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_DECODER_DECODER_RANGES_H
 
 #include <iostream>
+#include <map>
 
 #include "retdec/common/address.h"
 #include "retdec/bin2llvmir/providers/fileimage.h"
@@ -15,6 +16,43 @@
 namespace retdec {
 namespace bin2llvmir {
 
+/**
+ * Set of disjoint address ranges ordered by their start addresses.
+ *
+ * It has the same semantics as @c common::AddressRangeContainer, i.e.
+ * overlapping and continuous ranges are merged on insertion and removal splits
+ * ranges, but it is backed by a balanced tree instead of a sorted vector.
+ * Insertion, removal and lookup are logarithmic in the number of ranges (plus
+ * the number of merged/removed ranges), so they stay cheap when removals
+ * fragment the ranges into many pieces. Pointers to the ranges stay valid
+ * until the ranges are modified.
+ */
+class AddressRangeMap
+{
+	public:
+		using Ranges = std::map<common::Address, common::AddressRange>;
+		using const_iterator = Ranges::const_iterator;
+
+	public:
+		void insert(common::Address s, common::Address e);
+		void remove(common::Address s, common::Address e);
+		const common::AddressRange* getRange(common::Address a) const;
+
+		bool empty() const;
+		std::size_t size() const;
+		const common::AddressRange& front() const;
+		const_iterator begin() const;
+		const_iterator end() const;
+
+	friend std::ostream& operator<<(
+			std::ostream &os,
+			const AddressRangeMap& rs);
+
+	private:
+		/// Ranges indexed by their start addresses.
+		Ranges _ranges;
+};
+
 class RangesToDecode
 {
 	public:
@@ -27,6 +65,11 @@ class RangesToDecode
 		void remove(common::Address s, common::Address e);
 		void remove(const common::AddressRange& r);
 		void removeZeroSequences(FileImage* image);
+		void demoteDataSequences(FileImage* image);
+		void demoteDataSequences(
+				common::Address start,
+				const std::uint8_t* data,
+				std::size_t size);
 
 		bool isStrict() const;
 		bool primaryEmpty() const;
@@ -46,11 +89,11 @@ class RangesToDecode
 	private:
 		void removeZeroSequences(
 				FileImage* image,
-				common::AddressRangeContainer& rs);
+				AddressRangeMap& rs);
 
 	private:
-		common::AddressRangeContainer _primaryRanges;
-		common::AddressRangeContainer _alternativeRanges;
+		AddressRangeMap _primaryRanges;
+		AddressRangeMap _alternativeRanges;
 		unsigned archInsnAlign = 0;
 		bool _strict = false;
 };
@@ -0,0 +1,74 @@
+/**
+* @file include/retdec/bin2llvmir/optimizations/decoder/disassembly_cache.h
+* @brief Cache of Capstone instructions disassembled by the decoder.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_DECODER_DISASSEMBLY_CACHE_H
+#define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_DECODER_DISASSEMBLY_CACHE_H
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+#include <capstone/capstone.h>
+
+#include "retdec/capstone2llvmir/insn_pool.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Instructions disassembled by the decoder indexed by their basic mode and
+ * address.
+ *
+ * A miss disassembles a short linear sweep from the missing address, so that
+ * the following instructions are ready when the dry run or the translation
+ * gets to them. Failed disassembly is cached as well. Instructions are owned
+ * by the cache, users that need to keep them must copy them.
+ *
+ * The cache has its own Capstone handle for every basic mode, so that
+ * disassembly in a mode never switches the mode of the translator's handle.
+ */
+class DisassemblyCache
+{
+	public:
+		DisassemblyCache(cs_arch arch, cs_mode extraMode);
+		~DisassemblyCache();
+		DisassemblyCache(const DisassemblyCache&) = delete;
+		DisassemblyCache& operator=(const DisassemblyCache&) = delete;
+
+		bool lookup(cs_mode mode, std::uint64_t addr, cs_insn*& insn) const;
+		cs_insn* sweep(
+				cs_mode mode,
+				std::uint64_t addr,
+				const std::uint8_t* bytes,
+				std::size_t size);
+		void insert(cs_mode mode, const cs_insn& insn);
+		void copy(
+				const cs_insn& from,
+				cs_insn* to,
+				std::size_t toDetailSize) const;
+
+		std::size_t size() const;
+
+	private:
+		using Instructions = std::unordered_map<std::uint64_t, cs_insn*>;
+
+	private:
+		csh getHandle(cs_mode mode);
+
+	private:
+		cs_arch _arch;
+		cs_mode _extraMode;
+		/// Handles per basic mode, @c 0 if the mode can not be opened.
+		std::map<cs_mode, csh> _handles;
+		capstone2llvmir::CapstoneInsnPool _pool;
+		/// Instructions per basic mode, @c nullptr if disassembly failed.
+		std::map<cs_mode, Instructions> _insns;
+};
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
@@ -8,7 +8,9 @@
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_DECODER_JUMP_TARGETS_H
 
 #include <optional>
-#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "retdec/bin2llvmir/optimizations/decoder/decoder_debug.h"
 #include "retdec/capstone2llvmir/capstone2llvmir.h"
@@ -45,6 +47,7 @@ class JumpTarget
 			IMPORT,
 			DEBUG,
 			SYMBOL,
+			UNWIND,
 			EXPORT,
 			STATIC_CODE,
 			VTABLE,
@@ -72,6 +75,8 @@ class JumpTarget
 		cs_mode getMode() const;
 		void setMode(cs_mode m) const;
 
+		static std::string typeToString(eType t);
+
 	friend std::ostream& operator<<(std::ostream &out, const JumpTarget& jt);
 
 	private:
@@ -92,12 +97,33 @@ class JumpTarget
 
 /**
  * Jump target container.
+ *
+ * Jump targets are kept in a binary heap ordered by @c JumpTarget::operator<,
+ * i.e. @c top() is the jump target with the highest priority. A jump target
+ * equal to an already queued one is not queued again, equal jump targets are
+ * found in a hash table of the queued ones.
  */
 class JumpTargets
 {
 	public:
-		auto begin();
-		auto end();
+		/// Counters of jump targets passed to the container.
+		struct Statistics
+		{
+			/// Jump targets queued for decoding.
+			std::size_t pushed = 0;
+			/// Jump targets not queued because they already were.
+			std::size_t duplicates = 0;
+			/// Jump targets with undefined or misaligned addresses.
+			std::size_t rejected = 0;
+			/// Jump targets taken from the container.
+			std::size_t popped = 0;
+		};
+
+		using const_iterator = std::vector<const JumpTarget*>::const_iterator;
+
+	public:
+		const_iterator begin() const;
+		const_iterator end() const;
 
 		bool empty();
 		std::size_t size() const;
@@ -112,10 +138,35 @@ class JumpTargets
 				retdec::common::Address f,
 				std::optional<std::size_t> sz = std::nullopt);
 
+		const Statistics& getStatistics() const;
+
 	friend std::ostream& operator<<(std::ostream &out, const JumpTargets& jts);
 
-	public:
-		std::set<JumpTarget> _data;
+	private:
+		/// Members compared by @c JumpTarget::operator<.
+		struct Key
+		{
+			retdec::common::Address address;
+			JumpTarget::eType type;
+			retdec::common::Address from;
+
+			bool operator==(const Key& o) const;
+		};
+		struct KeyHash
+		{
+			std::size_t operator()(const Key& k) const;
+		};
+
+	private:
+		static Key getKey(const JumpTarget& jt);
+		static bool heapCompare(const JumpTarget* a, const JumpTarget* b);
+
+	private:
+		/// Queued jump targets.
+		std::unordered_map<Key, JumpTarget, KeyHash> _queued;
+		/// Heap of jump targets from @c _queued.
+		std::vector<const JumpTarget*> _heap;
+		Statistics _stats;
 
 	public:
 		static Config* config;
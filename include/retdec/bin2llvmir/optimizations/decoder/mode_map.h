@@ -0,0 +1,44 @@
+/**
+* @file include/retdec/bin2llvmir/optimizations/decoder/mode_map.h
+* @brief Map of basic modes in which addresses are decoded.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_DECODER_MODE_MAP_H
+#define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_DECODER_MODE_MAP_H
+
+#include <map>
+#include <optional>
+
+#include <capstone/capstone.h>
+
+#include "retdec/common/address.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Basic modes (e.g. ARM/Thumb) of address ranges.
+ *
+ * A mode set at an address holds up to the next address with a set mode,
+ * the same way as ELF mapping symbols (@c $a, @c $t, @c $d) work. An unknown
+ * mode (e.g. data) can be set as well.
+ */
+class ModeMap
+{
+	public:
+		void set(common::Address addr, std::optional<cs_mode> mode);
+		void set(const common::AddressRange& range, cs_mode mode);
+		std::optional<cs_mode> get(common::Address addr) const;
+
+		bool empty() const;
+		std::size_t size() const;
+
+	private:
+		std::map<common::Address, std::optional<cs_mode>> _modes;
+};
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
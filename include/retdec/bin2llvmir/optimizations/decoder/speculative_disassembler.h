@@ -0,0 +1,106 @@
+/**
+* @file include/retdec/bin2llvmir/optimizations/decoder/speculative_disassembler.h
+* @brief Speculative disassembly of jump targets on worker threads.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_DECODER_SPECULATIVE_DISASSEMBLER_H
+#define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_DECODER_SPECULATIVE_DISASSEMBLER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <capstone/capstone.h>
+
+#include "retdec/common/address.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Disassembles jump targets that are going to be decoded on worker threads.
+ *
+ * Only Capstone disassembly is done speculatively, its results are staged in
+ * batches. LLVM IR translation stays on the decoder's thread, which takes the
+ * staged instructions in its own order, so the decoding result does not
+ * depend on the number of threads or their timing. Every batch holds a
+ * sequence of instructions from one jump target up to the first jump or
+ * return. If the decoder needs anything else, it disassembles it itself.
+ */
+class SpeculativeDisassembler
+{
+	public:
+		/// Instructions disassembled from one jump target.
+		struct Batch
+		{
+			common::Address start;
+			cs_mode mode = CS_MODE_LITTLE_ENDIAN;
+			std::vector<cs_insn> insns;
+			std::vector<cs_detail> details;
+		};
+
+	public:
+		SpeculativeDisassembler(
+				cs_arch arch,
+				cs_mode extraMode,
+				unsigned threads);
+		~SpeculativeDisassembler();
+
+		SpeculativeDisassembler(const SpeculativeDisassembler&) = delete;
+		SpeculativeDisassembler& operator=(
+				const SpeculativeDisassembler&) = delete;
+
+		void request(
+				common::Address start,
+				cs_mode mode,
+				const uint8_t* bytes,
+				std::size_t size);
+		std::unique_ptr<Batch> acquire(common::Address start, cs_mode mode);
+
+	private:
+		struct Job
+		{
+			common::Address start;
+			cs_mode mode = CS_MODE_LITTLE_ENDIAN;
+			const uint8_t* bytes = nullptr;
+			std::size_t size = 0;
+		};
+		using Key = std::pair<common::Address, cs_mode>;
+
+	private:
+		void work();
+		std::unique_ptr<Batch> disassemble(csh handle, const Job& job) const;
+		void dropOldBatches();
+
+	private:
+		cs_arch _arch = CS_ARCH_ALL;
+		cs_mode _extraMode = CS_MODE_LITTLE_ENDIAN;
+		/// Maximal number of batches in @c _done.
+		std::size_t _maxDone = 0;
+
+		std::mutex _mutex;
+		std::condition_variable _jobAdded;
+		std::condition_variable _batchDone;
+		bool _stop = false;
+		/// Jobs waiting for a worker.
+		std::deque<Job> _jobs;
+		/// Jobs being disassembled by workers.
+		std::set<Key> _running;
+		/// Disassembled batches in order of their completion.
+		std::map<Key, std::unique_ptr<Batch>> _done;
+		std::deque<Key> _doneOrder;
+
+		std::vector<std::thread> _workers;
+};
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
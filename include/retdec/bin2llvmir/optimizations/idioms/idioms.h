@@ -34,8 +34,12 @@ public:
 
 	IdiomsAnalysis * getCompilerAnalysis(llvm::Module & M);
 
+	const IdiomsAnalysis::Statistics & getStatistics() const;
+
 private:
 	IdiomsAnalysis * m_idioms = nullptr;
+	/// Statistics of all the analyses finalized by this pass.
+	IdiomsAnalysis::Statistics m_statistics;
 	Config* m_config = nullptr;
 };
 
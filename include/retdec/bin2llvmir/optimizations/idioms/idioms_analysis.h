@@ -7,7 +7,13 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_IDIOMS_IDIOMS_ANALYSIS_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_IDIOMS_IDIOMS_ANALYSIS_H
 
+#include <bitset>
+#include <cstdint>
 #include <cstdio>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
 
 #include <llvm/ADT/Statistic.h>
 #include <llvm/IR/BasicBlock.h>
@@ -30,6 +36,13 @@
 namespace retdec {
 namespace bin2llvmir {
 
+/**
+ * Instruction idioms of all the compilers. Basic block idioms are kept in a
+ * dispatch table in the order in which they have to be exchanged, each of
+ * them with opcodes of instructions it can be rooted at. An idiom is looked
+ * for only in basic blocks that contain such an instruction, and its
+ * exchanger is called only on these instructions.
+ */
 class IdiomsAnalysis:
 	public IdiomsBorland,
 	public IdiomsCommon,
@@ -39,16 +52,51 @@ class IdiomsAnalysis:
 	public IdiomsMagicDivMod,
 	public IdiomsOWatcom,
 	public IdiomsVStudio  {
+public:
+	/// Counters of one idiom.
+	struct IdiomStatistics {
+		/// Exchanged instructions.
+		std::size_t hits = 0;
+		/// Time spent looking for the idiom [ns].
+		std::uint64_t time = 0;
+	};
+	/// Idiom exchanger name to its counters.
+	using Statistics = std::map<std::string, IdiomStatistics>;
+
 public:
 	IdiomsAnalysis(llvm::Module * M, CC_compiler cc, CC_arch arch)
 	{
 		init(M, cc, arch);
+		initBasicBlockIdioms();
 	}
 	virtual bool doAnalysis(llvm::Function & f, llvm::Pass * p) override;
 
+	Statistics getStatistics() const;
+
 private:
+	using Opcodes = std::bitset<llvm::Instruction::OtherOpsEnd>;
+	using BasicBlockExchanger = llvm::Instruction * (IdiomsAnalysis::*)(llvm::BasicBlock::iterator) const;
+
+	/// Entry of the basic block idioms dispatch table.
+	struct BasicBlockIdiom {
+		BasicBlockExchanger exchanger;
+		const char * name;
+		/// Opcodes of instructions the idiom can be rooted at.
+		Opcodes opcodes;
+		IdiomStatistics statistics;
+	};
+
+private:
+	void initBasicBlockIdioms();
+	void addIdiom(BasicBlockExchanger exchanger, const char * name, std::initializer_list<unsigned> opcodes);
+	static Opcodes getOpcodes(const llvm::BasicBlock & bb);
+
 	bool analyse(llvm::Function & f, llvm::Pass * p, int (IdiomsAnalysis::*exchanger)(llvm::Function &, llvm::Pass *) const, const char * fname);
-	bool analyse(llvm::BasicBlock & bb, llvm::Instruction * (IdiomsAnalysis::*exchanger)(llvm::BasicBlock::iterator) const, const char * fname);
+	bool analyse(llvm::BasicBlock & bb, BasicBlockIdiom & idiom);
+
+private:
+	std::vector<BasicBlockIdiom> m_bbIdioms;
+	IdiomStatistics m_multiBbStatistics;
 };
 
 } // namespace bin2llvmir
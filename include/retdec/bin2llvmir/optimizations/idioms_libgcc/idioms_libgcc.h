@@ -7,6 +7,8 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_IDIOMS_LIBGCC_IDIOMS_LIBGCC_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_IDIOMS_LIBGCC_IDIOMS_LIBGCC_H
 
+#include <map>
+
 #include <llvm/IR/Module.h>
 #include <llvm/Pass.h>
 
@@ -36,6 +38,7 @@ class IdiomsLibgcc : public llvm::ModulePass
 	private:
 		bool run();
 		bool runInstruction(llvm::Instruction* inst);
+		const Fnc2Action::value_type* getAction(const std::string& calledFnc);
 
 	private:
 		std::unique_ptr<IdiomsLibgccImpl> _impl;
@@ -44,6 +47,8 @@ class IdiomsLibgcc : public llvm::ModulePass
 		Abi* _abi = nullptr;
 
 		Fnc2Action _fnc2action;
+		/// Called function name to its action (@c nullptr if there is none).
+		std::map<std::string, const Fnc2Action::value_type*> _fnc2actionCache;
 };
 
 } // namespace bin2llvmir
@@ -7,6 +7,8 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_INST_OPT_INST_OPT_PASS_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_INST_OPT_INST_OPT_PASS_H
 
+#include <map>
+
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
@@ -23,11 +25,23 @@ class InstructionOptimizer : public llvm::ModulePass
 		virtual bool runOnModule(llvm::Module& m) override;
 		bool runOnModuleCustom(llvm::Module& m);
 
+		static void clear();
+
 	private:
 		bool run();
+		static std::size_t getFingerprint(llvm::Function& f);
 
 	private:
 		llvm::Module* _module = nullptr;
+
+		/// Fingerprints of functions which were not changed by the last run
+		/// on their module. Running on them again would not change them
+		/// either, so they are skipped if their fingerprints are the same.
+		/// The pass runs several times in the pipeline, so this is shared
+		/// by all the pass instances.
+		static thread_local std::map<
+				llvm::Module*,
+				std::map<const llvm::Function*, std::size_t>> _unchanged;
 };
 
 } // namespace bin2llvmir
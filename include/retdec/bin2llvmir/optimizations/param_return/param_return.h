@@ -54,6 +54,7 @@ class ParamReturn : public llvm::ModulePass
 	//
 	private:
 		void collectAllCalls();
+		void collectUsageData();
 
 		DataFlowEntry createDataFlowEntry(llvm::Value* calledValue) const;
 
@@ -67,7 +68,7 @@ class ParamReturn : public llvm::ModulePass
 	// Collection of functions usage data.
 	//
 	private:
-		void addDataFromCall(DataFlowEntry *dataflow, llvm::CallInst *call) const;
+		void addDataFromCall(CallEntry* ce) const;
 
 	// Optimizations.
 	//
@@ -117,7 +118,7 @@ class ParamReturn : public llvm::ModulePass
 		// their parameters correctly.
 
 		void propagateWrapped();
-		void propagateWrapped(DataFlowEntry& de);
+		DataFlowEntry* propagateWrapped(DataFlowEntry& de);
 		void applyToIr();
 		void applyToIr(DataFlowEntry& de);
 		void connectWrappers(const DataFlowEntry& de);
@@ -135,7 +136,7 @@ class ParamReturn : public llvm::ModulePass
 		Demangler* _demangler = nullptr;
 
 		std::map<llvm::Value*, DataFlowEntry> _fnc2calls;
-		ReachingDefinitionsAnalysis _RDA;
+		ReachingDefinitionsAnalysis* _RDA = nullptr;
 		Collector::Ptr _collector;
 };
 
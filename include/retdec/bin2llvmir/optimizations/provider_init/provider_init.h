@@ -7,6 +7,8 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_PROVIDER_INIT_PROVIDER_INIT_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_PROVIDER_INIT_PROVIDER_INIT_H
 
+#include <cstdint>
+
 #include <llvm/IR/Module.h>
 #include <llvm/Pass.h>
 
@@ -19,6 +21,12 @@ class Config;
 } // namespace config
 namespace bin2llvmir {
 
+/**
+ * Initializes all the providers for the processed module.
+ *
+ * Provider state is thread-local -- each thread can run its own
+ * decompilation, and this pass resets only the state of the current thread.
+ */
 class ProviderInitialization : public llvm::ModulePass
 {
 	public:
@@ -28,9 +36,13 @@ class ProviderInitialization : public llvm::ModulePass
 		virtual bool doFinalization(llvm::Module& m) override;
 
 		void setConfig(retdec::config::Config* c);
+		void setInputData(const std::uint8_t* data, std::size_t size);
 
 	private:
 		retdec::config::Config* _config = nullptr;
+		/// Input file content, if set it is used instead of the input file.
+		const std::uint8_t* _inputData = nullptr;
+		std::size_t _inputDataSize = 0;
 };
 
 } // namespace bin2llvmir
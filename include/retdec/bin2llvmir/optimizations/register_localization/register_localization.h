@@ -7,6 +7,9 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_REGISTER_LOCALIZATION_REGISTER_LOCALIZATION_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_REGISTER_LOCALIZATION_REGISTER_LOCALIZATION_H
 
+#include <vector>
+
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Pass.h>
@@ -27,19 +30,17 @@ class RegisterLocalization : public llvm::ModulePass
 
 	private:
 		bool run();
-		llvm::AllocaInst* getLocalized(
-				llvm::GlobalVariable* reg,
-				llvm::Function* fnc,
-				std::map<llvm::Function*, llvm::AllocaInst*>& fnc2alloca);
-		bool localize(
-				llvm::GlobalVariable* reg,
-				std::map<llvm::Function*, llvm::AllocaInst*>& fnc2alloca,
-				llvm::Instruction* insn);
+		bool runOnFunction(llvm::Function& f);
+		std::size_t getRegisterIndex(llvm::Value* val) const;
 
 	private:
 		llvm::Module* _module = nullptr;
 		Abi* _abi = nullptr;
 		Config* _config = nullptr;
+
+		/// ABI registers and their indexes.
+		std::vector<llvm::GlobalVariable*> _regs;
+		llvm::DenseMap<llvm::GlobalVariable*, std::size_t> _reg2idx;
 };
 
 } // namespace bin2llvmir
@@ -13,6 +13,7 @@
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Module.h>
@@ -29,6 +30,7 @@ class TypeEntry;
 class EquationEntry;
 class EqSet;
 class EqSetContainer;
+class IrModifier;
 
 /**
  * Priority of data type sources.
@@ -122,7 +124,9 @@ struct EquationEntryHash
 	std::size_t operator() (const EquationEntry& e) const { return e.hash(); }
 };
 
-using ValueEntrySet = std::unordered_set<ValueEntry, ValueEntryHash>;
+/// Values are never in more than one set (see
+/// @c SimpleTypesAnalysis::processedObjs), so they are not deduplicated.
+using ValueEntryVector = std::vector<ValueEntry>;
 using TypeEntrySet = std::unordered_set<TypeEntry, TypeEntryHash>;
 using EquationEntrySet = std::unordered_set<EquationEntry, EquationEntryHash>;
 
@@ -136,11 +140,7 @@ class EqSet
 		void insert(Config* config, llvm::Value* v, eSourcePriority p = eSourcePriority::PRIORITY_NONE);
 		void insert(llvm::Type* t, eSourcePriority p = eSourcePriority::PRIORITY_NONE);
 		void propagate(llvm::Module* module);
-		void apply(
-				llvm::Module* module,
-				Config* config,
-				FileImage* objf,
-				std::unordered_set<llvm::Instruction*>& instToErase);
+		void apply(Config* config, IrModifier& irModif);
 
 		friend std::ostream& operator<<(std::ostream& out, const EqSet& eq);
 
@@ -161,8 +161,8 @@ class EqSet
 
 		/// Type of an entire equivalence set.
 		TypeEntry masterType;
-		/// Values in the set.
-		ValueEntrySet valSet;
+		/// Values in the set, in the order they were added.
+		ValueEntryVector valSet;
 		/// This allows to add certain types to set without having a value for them.
 		TypeEntrySet typeSet;
 		/// This allows to propagate type to another equivalence set, which may not
@@ -35,6 +35,9 @@ class StackAnalysis : public llvm::ModulePass
 
 	private:
 		bool run();
+		void runOnFunction(
+				ReachingDefinitionsAnalysis& RDA,
+				llvm::Function& f);
 		void handleInstruction(
 				ReachingDefinitionsAnalysis& RDA,
 				llvm::Instruction* inst,
@@ -56,6 +59,8 @@ class StackAnalysis : public llvm::ModulePass
 		DebugFormat* _dbgf = nullptr;
 
 		std::unordered_set<llvm::Value*> _toRemove;
+		/// Functions whose reaching definitions must be recomputed.
+		std::unordered_set<llvm::Function*> _modified;
 };
 
 } // namespace bin2llvmir
@@ -7,10 +7,15 @@
 #ifndef RETDEC_BIN2LLVMIR_OPTIMIZATIONS_SYSCALLS_SYSCALLS_H
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_SYSCALLS_SYSCALLS_H
 
+#include <cstdint>
+#include <map>
+#include <vector>
+
 #include <llvm/IR/Module.h>
 #include <llvm/Pass.h>
 
 #include "retdec/bin2llvmir/providers/abi/abi.h"
+#include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/providers/config.h"
 #include "retdec/bin2llvmir/providers/fileimage.h"
 #include "retdec/bin2llvmir/providers/lti.h"
@@ -20,7 +25,51 @@ const bool debug_enabled = false;
 namespace retdec {
 namespace bin2llvmir {
 
-class AsmInstruction;
+/**
+ * Syscall code and name of the function it calls.
+ */
+struct SyscallEntry
+{
+	std::uint64_t code;
+	const char* name;
+};
+
+/**
+ * View of a constant array of syscalls sorted by their codes.
+ */
+class SyscallTable
+{
+	public:
+		template <std::size_t N>
+		constexpr SyscallTable(const SyscallEntry (&entries)[N]) :
+				_begin(entries),
+				_end(entries + N)
+		{
+
+		}
+
+		/**
+		 * @return @c True if codes are strictly increasing, i.e. the table
+		 *         can be searched by @c find().
+		 */
+		constexpr bool isSorted() const
+		{
+			for (auto* it = _begin; it != _end && it + 1 != _end; ++it)
+			{
+				if (it->code >= (it + 1)->code)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		const char* find(std::uint64_t code) const;
+
+	private:
+		const SyscallEntry* _begin = nullptr;
+		const SyscallEntry* _end = nullptr;
+};
 
 class SyscallFixer : public llvm::ModulePass
 {
@@ -37,10 +86,14 @@ class SyscallFixer : public llvm::ModulePass
 
 	private:
 		bool run();
+		void collectSites(unsigned insnId);
 		bool transform(
 				AsmInstruction ai,
 				uint64_t code,
-				const std::map<uint64_t, std::string>& codeMap);
+				const SyscallTable& table);
+		llvm::Function* getSyscallFunction(
+				uint64_t code,
+				const SyscallTable& table);
 
 		bool runArm();
 		bool runArm_linux_32();
@@ -64,6 +117,13 @@ class SyscallFixer : public llvm::ModulePass
 		FileImage* _image = nullptr;
 		Lti* _lti = nullptr;
 		Abi* _abi = nullptr;
+
+		/// Syscall instructions found in the module. They are processed all
+		/// at once after the module was searched, not while it is modified.
+		std::vector<AsmInstruction> _sites;
+		/// Functions called by syscall codes, @c nullptr if a code can not be
+		/// transformed.
+		std::map<uint64_t, llvm::Function*> _code2fnc;
 };
 
 } // namespace bin2llvmir
@@ -8,6 +8,8 @@
 #define RETDEC_BIN2LLVMIR_OPTIMIZATIONS_WRITER_DSM_WRITER_DSM_H
 
 #include <ostream>
+#include <string>
+#include <vector>
 
 #include <llvm/IR/Module.h>
 #include <llvm/Pass.h>
@@ -35,31 +37,21 @@ class DsmWriter : public llvm::ModulePass
 
 	private:
 		void run(std::ostream& ret);
-		void generateHeader(std::ostream& ret);
-		void generateCode(std::ostream& ret);
-		void generateCodeSeg(
-				const retdec::loader::Segment* seg,
-				std::ostream& ret);
-		void generateFunction(
-				const retdec::common::Function* fnc,
-				std::ostream& ret);
-		void generateInstruction(AsmInstruction& ai, std::ostream& ret);
-		void generateData(std::ostream& ret);
-		void generateDataSeg(
-				const retdec::loader::Segment* seg,
-				std::ostream& ret);
+		void generateHeader();
+		void generateCode();
+		void generateCodeSeg(const retdec::loader::Segment* seg);
+		void generateFunction(const retdec::common::Function* fnc);
+		void generateInstruction(AsmInstruction& ai);
+		void generateData();
+		void generateDataSeg(const retdec::loader::Segment* seg);
 		void generateDataRange(
 				retdec::common::Address start,
-				retdec::common::Address end,
-				std::ostream& ret);
-		void generateAlignedAddress(
-				retdec::common::Address addr,
-				std::ostream& ret);
+				retdec::common::Address end);
+		void generateAlignedAddress(retdec::common::Address addr);
 
-		void getAsmInstructionHex(AsmInstruction& ai, std::ostream& ret);
+		void getAsmInstructionHex(AsmInstruction& ai);
 		std::string processInstructionDsm(AsmInstruction& ai);
 		void generateData(
-				std::ostream& ret,
 				retdec::common::Address start,
 				std::size_t size,
 				const std::string& objVal = "");
@@ -74,6 +66,10 @@ class DsmWriter : public llvm::ModulePass
 		std::string getFunctionName(llvm::Function* f) const;
 		std::string getFunctionName(const retdec::common::Function* f) const;
 
+		void appendHex(std::uint64_t val);
+		void flush();
+		void flushIfFull();
+
 	private:
 		llvm::Module* _module = nullptr;
 		Config* _config = nullptr;
@@ -84,7 +80,16 @@ class DsmWriter : public llvm::ModulePass
 		std::size_t _longestAddr = 0;
 		std::map<retdec::common::Address, const retdec::common::Function*> _addr2fnc;
 
+		/// Output the generated text is streamed to.
+		std::ostream* _out = nullptr;
+		/// Text generated since the last flush to @c _out. It is reused, so
+		/// its capacity stays bounded by the size of the biggest function.
+		std::string _buffer;
+		/// Instruction bytes, reused for all instructions.
+		std::vector<std::uint64_t> _bytes;
+
 		const std::size_t DATA_SEGMENT_LINE    = 16;
+		const std::size_t FLUSH_SIZE = 1 << 20;
 		const std::string ALIGN = "   ";
 		const std::string INSTR_SEPARATOR = "\t"; // maybe "\t"
 };
@@ -167,7 +167,7 @@ class AbiProvider
 		static void clear();
 
 	private:
-		static std::map<llvm::Module*, std::unique_ptr<Abi>> _module2abi;
+		static thread_local std::map<llvm::Module*, std::unique_ptr<Abi>> _module2abi;
 };
 
 } // namespace bin2llvmir
@@ -7,14 +7,20 @@
 #ifndef RETDEC_BIN2LLVMIR_PROVIDERS_ASM_INSTRUCTION_H
 #define RETDEC_BIN2LLVMIR_PROVIDERS_ASM_INSTRUCTION_H
 
+#include <memory>
+#include <vector>
+
 #include <capstone/capstone.h>
+#include "retdec/capstone2llvmir/insn_pool.h"
 #include "retdec/capstone2llvmir/arm/arm_defs.h"
 #include "retdec/capstone2llvmir/mips/mips_defs.h"
 #include "retdec/capstone2llvmir/powerpc/powerpc_defs.h"
 #include "retdec/capstone2llvmir/x86/x86_defs.h"
 
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/ValueHandle.h>
 
 #include "retdec/bin2llvmir/utils/llvm.h"
 #include "retdec/common/address.h"
@@ -22,7 +28,51 @@
 namespace retdec {
 namespace bin2llvmir {
 
-using Llvm2CapstoneInsnMap = typename std::map<llvm::StoreInst*, cs_insn*>;
+/**
+ * Index of LLVM IR <-> Capstone instruction mapping of one module.
+ *
+ * It maps special LLVM IR mapping instructions to Capstone instructions in
+ * O(1), and addresses to mapping instructions in O(log n) using a flat,
+ * address-sorted array. Instructions are added in any order, they get sorted
+ * lazily when looked up by address.
+ *
+ * It stays valid when passes erase LLVM IR instructions: erased mapping
+ * instructions are never found by address, and no erased instruction is ever
+ * dereferenced.
+ */
+class Llvm2CapstoneInsnMap
+{
+	public:
+		void emplace(llvm::StoreInst* s, cs_insn* i);
+		void clear();
+
+		bool empty() const;
+		std::size_t size() const;
+
+		cs_insn* getCapstoneInsn(const llvm::StoreInst* s) const;
+		llvm::StoreInst* getLlvmToAsmInstruction(
+				retdec::common::Address a) const;
+
+	private:
+		void sort() const;
+
+	private:
+		struct Entry
+		{
+			retdec::common::Address address;
+			llvm::WeakVH store;
+		};
+
+	private:
+		/// Mapping instruction to Capstone instruction.
+		/// Keys may be erased instructions, but such keys are never looked
+		/// up, since all the live mapping instructions are in this map.
+		llvm::DenseMap<const llvm::StoreInst*, cs_insn*> _store2insn;
+		/// Address to mapping instruction, sorted by address up to
+		/// @c _sortedCount. Entries of erased instructions are null.
+		mutable std::vector<Entry> _addr2store;
+		mutable std::size_t _sortedCount = 0;
+};
 
 /**
  * Assembly instruction representation.
@@ -154,6 +204,10 @@ class AsmInstruction
 	public:
 		static Llvm2CapstoneInsnMap& getLlvmToCapstoneInsnMap(
 				const llvm::Module* m);
+		static capstone2llvmir::CapstoneInsnPool& getCapstoneInsnPool(
+				const llvm::Module* m,
+				cs_arch arch);
+		static void clearCapstoneInsns(const llvm::Module* m);
 		static llvm::GlobalVariable* getLlvmToAsmGlobalVariable(
 				const llvm::Module* m);
 		static void setLlvmToAsmGlobalVariable(
@@ -185,14 +239,20 @@ class AsmInstruction
 		using ModuleGlobalPair = std::pair<
 				const llvm::Module*,
 				llvm::GlobalVariable*>;
-		using ModuleInstructionMap = std::pair<
-				const llvm::Module*,
-				std::map<llvm::StoreInst*, cs_insn*>>;
+		/// Capstone instructions of a module. They are owned by the pool.
+		struct ModuleInstructionMap
+		{
+			const llvm::Module* module = nullptr;
+			Llvm2CapstoneInsnMap insnMap;
+			std::unique_ptr<capstone2llvmir::CapstoneInsnPool> insnPool;
+		};
+		static ModuleInstructionMap& getModuleInstructionMap(
+				const llvm::Module* m);
 
 	private:
 		llvm::StoreInst* _llvmToAsmInstr = nullptr;
-		static std::vector<ModuleGlobalPair> _module2global;
-		static std::vector<ModuleInstructionMap> _module2instMap;
+		static thread_local std::vector<ModuleGlobalPair> _module2global;
+		static thread_local std::vector<ModuleInstructionMap> _module2instMap;
 
 	public:
 		template<
@@ -208,7 +208,7 @@ class ConfigProvider
 		static void clear();
 
 	private:
-		static std::map<llvm::Module*, Config> _module2config;
+		static thread_local std::map<llvm::Module*, Config> _module2config;
 };
 
 } // namespace bin2llvmir
@@ -7,6 +7,8 @@
 #ifndef RETDEC_BIN2LLVMIR_PROVIDERS_DEBUGFORMAT_H
 #define RETDEC_BIN2LLVMIR_PROVIDERS_DEBUGFORMAT_H
 
+#include <memory>
+
 #include <llvm/IR/Module.h>
 
 #include "retdec/bin2llvmir/providers/demangler.h"
@@ -30,6 +32,9 @@ class DebugFormat : public debugformat::DebugFormat
  * in LLVM passes' prologs to initialize pass-local demangler object. All
  * analyses, utils and other modules *MUST NOT* use it. If they need to work
  * with debug info, they should accept it in parameter.
+ *
+ * Debug info is loaded from PDB and DWARF upon its first request, not when
+ * it is added.
  */
 class DebugFormatProvider
 {
@@ -39,20 +44,34 @@ class DebugFormatProvider
 				const retdec::fileformat::Symbol*>;
 
 	public:
-		static DebugFormat* addDebugFormat(
+		static bool addDebugFormat(
 				llvm::Module* m,
 				retdec::loader::Image* objf,
 				const std::string& pdbFile,
-				Demangler* demangler);
+				Demangler* demangler,
+				unsigned threads = 1);
 
 		static DebugFormat* getDebugFormat(llvm::Module* m);
 		static bool getDebugFormat(llvm::Module* m, DebugFormat*& df);
 
 		static void clear();
 
+	private:
+		/// Sources of debug info and the debug info loaded from them.
+		struct DebugFormatEntry
+		{
+			retdec::loader::Image* image = nullptr;
+			std::string pdbFile;
+			retdec::demangler::Demangler* demangler = nullptr;
+			unsigned threads = 1;
+			/// @c nullptr until the first request.
+			std::unique_ptr<DebugFormat> debug;
+		};
+
 	private:
 		/// Mapping of modules to debug info associated with them.
-		static std::map<llvm::Module*, DebugFormat> _module2debug;
+		static thread_local std::map<llvm::Module*, DebugFormatEntry>
+				_module2debug;
 };
 
 } // namespace bin2llvmir
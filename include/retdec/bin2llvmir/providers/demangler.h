@@ -7,7 +7,13 @@
 #ifndef RETDEC_BIN2LLVMIR_PROVIDERS_DEMANGLER_H
 #define RETDEC_BIN2LLVMIR_PROVIDERS_DEMANGLER_H
 
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <llvm/IR/Module.h>
 
@@ -27,6 +33,68 @@ class Type;
 
 namespace bin2llvmir {
 
+/**
+ * @brief Demangler that remembers demangled names.
+ *
+ * Names demangled to strings are shared by all the instances with the same
+ * underlying demangler (i.e. by demanglers of all the modules) in the process.
+ * Access to them is synchronized, but every instance itself must be used by
+ * a single thread at a time. Functions demangled to ctypes are remembered by
+ * the instance, because they belong to the ctypes module of the caller.
+ */
+class CachingDemangler : public demangler::Demangler
+{
+public:
+	using DemanglerCreator = std::function<
+		std::unique_ptr<demangler::Demangler>()>;
+
+public:
+	CachingDemangler(
+		const std::string &compiler,
+		const DemanglerCreator &creator);
+
+	std::string demangleToString(const std::string &mangled) override;
+
+	std::shared_ptr<ctypes::Function> demangleFunctionToCtypes(
+		const std::string &mangled,
+		std::unique_ptr<ctypes::Module> &module,
+		const ctypesparser::CTypesParser::TypeWidths &typeWidths,
+		const ctypesparser::CTypesParser::TypeSignedness &typeSignedness,
+		unsigned defaultBitWidth) override;
+
+	void demangleToStrings(
+		const std::vector<std::string> &mangled,
+		unsigned threads);
+
+	static void clearCache();
+
+private:
+	/// Demangled name and status of its demangling.
+	using DemangledName = std::pair<std::string, Status>;
+
+	/// Demangled names shared by instances with the same compiler.
+	struct NameCache
+	{
+		std::mutex mutex;
+		std::unordered_map<std::string, DemangledName> names;
+	};
+
+private:
+	DemanglerCreator _creator;
+	std::unique_ptr<demangler::Demangler> _demangler;
+	std::shared_ptr<NameCache> _names;
+
+	/// Module of the remembered ctypes functions.
+	ctypes::Module *_ctypesModule = nullptr;
+	std::unordered_map<
+		std::string,
+		std::shared_ptr<ctypes::Function>> _ctypesFunctions;
+
+	/// Name caches of all compilers, shared by all instances in the process.
+	static std::map<std::string, std::shared_ptr<NameCache>> _nameCaches;
+	static std::mutex _nameCachesMutex;
+};
+
 /*
  * @brief Combined interface for Demangler library and ctypes2llvmir translator.
  */
@@ -42,9 +110,12 @@ public:
 		llvm::Module *llvmModule,
 		Config *config,
 		const std::shared_ptr<ctypesparser::TypeConfig> &typeConfig,
-		std::unique_ptr<retdec::demangler::Demangler> demangler);
+		std::unique_ptr<CachingDemangler> demangler);
 
 	std::string demangleToString(const std::string &mangled);
+	void demangleToStrings(
+		const std::vector<std::string> &mangled,
+		unsigned threads);
 
 	FunctionPair getPairFunction(const std::string &mangled);
 
@@ -58,7 +129,7 @@ private:
 	Config *_config = nullptr;
 	std::unique_ptr<retdec::ctypes::Module> _ctypesModule;
 	std::shared_ptr<ctypesparser::TypeConfig> _typeConfig;
-	std::unique_ptr<demangler::Demangler> _demangler;
+	std::unique_ptr<CachingDemangler> _demangler;
 };
 
 /**
@@ -110,7 +181,7 @@ public:
 
 private:
 	/// Mapping of modules to demanglers associated with them.
-	static std::map<llvm::Module *, std::unique_ptr<Demangler>> _module2demangler;
+	static thread_local std::map<llvm::Module *, std::unique_ptr<Demangler>> _module2demangler;
 };
 
 } // namespace bin2llvmir
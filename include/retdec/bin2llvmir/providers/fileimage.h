@@ -7,6 +7,9 @@
 #ifndef RETDEC_BIN2LLVMIR_PROVIDERS_FILEIMAGE_H
 #define RETDEC_BIN2LLVMIR_PROVIDERS_FILEIMAGE_H
 
+#include <cstdint>
+#include <memory>
+
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Value.h>
@@ -17,6 +20,7 @@
 #include "retdec/bin2llvmir/providers/debugformat.h"
 #include "retdec/loader/loader/image.h"
 #include "retdec/rtti-finder/rtti_finder.h"
+#include "retdec/stacofin/stacofin.h"
 
 namespace retdec {
 namespace bin2llvmir {
@@ -32,6 +36,11 @@ class FileImage
 				llvm::Module* m,
 				const std::string& path,
 				Config* config);
+		FileImage(
+				llvm::Module* m,
+				const std::uint8_t* data,
+				std::size_t size,
+				Config* config);
 		FileImage(
 				llvm::Module* m,
 				const std::shared_ptr<retdec::fileformat::FileFormat>& ff,
@@ -42,6 +51,7 @@ class FileImage
 				Config* config);
 
 		void initRtti(Config* config);
+		void initStaticCode(Config* config);
 
 	// Constant getters - get LLVM constant from the given address.
 	//
@@ -96,6 +106,7 @@ class FileImage
 	//
 	public:
 		const retdec::rtti_finder::RttiFinder& getRtti() const;
+		const retdec::stacofin::Finder* getStaticCode() const;
 
 	// Private data.
 	//
@@ -103,12 +114,16 @@ class FileImage
 		llvm::Module* _module = nullptr;
 		std::unique_ptr<retdec::loader::Image> _image;
 		retdec::rtti_finder::RttiFinder _rtti;
+		/// Static code detections, if they were searched for in advance.
+		std::unique_ptr<retdec::stacofin::Finder> _staticCode;
 };
 
 /**
  * Completely static object -- all members and methods are static -> it can be
  * used by anywhere in bin2llvmirl. It provides mapping of modules to file
  * images associated with them.
+ * The mapping is thread-local, so decompilations running in different threads
+ * do not interfere with each other.
  *
  * @attention Even though this is accessible anywhere in bin2llvmirl, use it only
  * in LLVM passes' prologs to initialize pass-local file image object. All
@@ -122,6 +137,11 @@ class FileImageProvider
 				llvm::Module* m,
 				const std::string& path,
 				Config* config);
+		static FileImage* addFileImage(
+				llvm::Module* m,
+				const std::uint8_t* data,
+				std::size_t size,
+				Config* config);
 		static FileImage* addFileImage(
 				llvm::Module* m,
 				const std::shared_ptr<retdec::fileformat::FileFormat>& ff,
@@ -142,7 +162,7 @@ class FileImageProvider
 
 	private:
 		/// Mapping of modules to file images associated with them.
-		static std::map<llvm::Module*, FileImage> _module2image;
+		static thread_local std::map<llvm::Module*, FileImage> _module2image;
 };
 
 } // namespace bin2llvmir
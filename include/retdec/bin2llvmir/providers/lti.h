@@ -7,6 +7,12 @@
 #ifndef RETDEC_BIN2LLVMIR_PROVIDERS_LTI_H
 #define RETDEC_BIN2LLVMIR_PROVIDERS_LTI_H
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include <llvm/IR/Module.h>
 
 #include "retdec/ctypesparser/json_ctypes_parser.h"
@@ -40,8 +46,29 @@ class Lti
 		FunctionPair getPairFunction(const std::string& name);
 		llvm::Function* getLlvmFunction(const std::string& name);
 
+		static void clearCache();
+
 	private:
-		void loadLtiFile(const std::string& filePath);
+		/**
+		 * Functions of a set of LTI files. The files are loaded at once, but
+		 * their functions are parsed only when they are requested for the
+		 * first time.
+		 */
+		struct LtiDatabase
+		{
+			/// Guards lazy parsing of functions.
+			std::mutex mutex;
+			/// Already parsed functions.
+			std::unique_ptr<retdec::ctypes::Module> module;
+			/// Loaded files, in the order in which they are searched.
+			std::vector<std::unique_ptr<ctypesparser::JSONCTypesParser>> files;
+		};
+
+	private:
+		std::vector<std::string> getLtiFilesToLoad() const;
+		std::shared_ptr<LtiDatabase> loadLtiFiles(
+				const std::vector<std::string>& filePaths);
+		void loadLtiFile(const std::string& filePath, LtiDatabase& db);
 		llvm::Type* getLlvmType(std::shared_ptr<retdec::ctypes::Type> type);
 
 	private:
@@ -49,8 +76,12 @@ class Lti
 		Config* _config = nullptr;
 		std::shared_ptr<ctypesparser::TypeConfig> _typeConfig;
 		retdec::loader::Image* _image = nullptr;
-		std::unique_ptr<retdec::ctypes::Module> _ltiModule;
-		ctypesparser::JSONCTypesParser _ltiParser;
+		std::shared_ptr<LtiDatabase> _ltiDb;
+
+		/// LTI databases shared by all @c Lti instances in the process.
+		/// Key identifies the loaded files and the parsing configuration.
+		static std::map<std::string, std::shared_ptr<LtiDatabase>> _ltiCache;
+		static std::mutex _ltiCacheMutex;
 };
 
 class LtiProvider
@@ -61,12 +92,13 @@ class LtiProvider
 			Config* c,
 			const std::shared_ptr<ctypesparser::TypeConfig>& typeConfig,
 			retdec::loader::Image* objf);
+		static Lti* addLti(llvm::Module* m, Lti&& lti);
 		static Lti* getLti(llvm::Module* m);
 		static bool getLti(llvm::Module* m, Lti*& lti);
 		static void clear();
 
 	private:
-		static std::map<llvm::Module*, Lti> _module2lti;
+		static thread_local std::map<llvm::Module*, Lti> _module2lti;
 };
 
 } // namespace bin2llvmir
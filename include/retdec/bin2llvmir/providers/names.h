@@ -8,7 +8,9 @@
 #define RETDEC_BIN2LLVMIR_PROVIDERS_NAMES_H
 
 #include <map>
+#include <memory>
 #include <set>
+#include <unordered_map>
 
 #include "retdec/bin2llvmir/providers/config.h"
 #include "retdec/bin2llvmir/providers/debugformat.h"
@@ -16,6 +18,7 @@
 #include "retdec/bin2llvmir/providers/fileimage.h"
 #include "retdec/bin2llvmir/providers/lti.h"
 #include "retdec/common/address.h"
+#include "retdec/utils/interned_string.h"
 
 namespace retdec {
 namespace bin2llvmir {
@@ -112,11 +115,13 @@ class Name
 		eType getType() const;
 
 	private:
-		void fixPic32Mangling();
-		void fixPostfix();
+		static void fixPic32Mangling(std::string& name);
+		static void fixPostfix(std::string& name);
 
 	private:
-		std::string _name;
+		/// Interned, because the same names are added for many addresses and
+		/// compared many times.
+		utils::InternedString _name;
 		eType _type = eType::INVALID;
 };
 
@@ -149,6 +154,9 @@ class Names
 
 /**
  * Names container.
+ *
+ * Names from debug info are added upon the first access to the container, so
+ * that the debug info is not loaded before some pass needs the names.
  */
 class NameContainer
 {
@@ -156,7 +164,6 @@ class NameContainer
 		NameContainer(
 				llvm::Module* m,
 				Config* c,
-				DebugFormat* d,
 				FileImage* i,
 				Demangler* dm,
 				Lti* lti = nullptr);
@@ -171,6 +178,12 @@ class NameContainer
 		const Name& getPreferredNameForAddress(retdec::common::Address a);
 
 	private:
+		bool addName(
+				retdec::common::Address a,
+				const std::string& name,
+				Name::eType type,
+				Lti* lti = nullptr);
+
 		void initFromConfig();
 		void initFromDebug();
 		void initFromImage();
@@ -178,21 +191,41 @@ class NameContainer
 		std::string getNameFromImportLibAndOrd(
 				const std::string& libName,
 				int ord);
-		bool loadImportOrds(const std::string& libName);
+
+	public:
+		static void clearImportOrds();
 
 	private:
 		/// <ordinal number, function name>
 		using ImportOrdMap = std::map<int, std::string>;
 
+		struct AddressHash
+		{
+			std::size_t operator()(const retdec::common::Address& a) const
+			{
+				return std::hash<std::uint64_t>()(a.getValue());
+			}
+		};
+
 	private:
+		static const ImportOrdMap* loadImportOrds(const std::string& filePath);
+
+	private:
+		llvm::Module* _module = nullptr;
 		Config* _config = nullptr;
-		DebugFormat* _debug = nullptr;
 		FileImage* _image = nullptr;
 		Lti* _lti = nullptr;
+		/// @c True if names from debug info were already added.
+		bool _debugInitialized = false;
+
+		std::unordered_map<retdec::common::Address, Names, AddressHash> _data;
+		static Names _emptyNames;
 
-		std::map<retdec::common::Address, Names> _data;
-		/// <library name without suffix ".dll", map with ordinals>
-		std::map<std::string, ImportOrdMap> _dllOrds;
+		/// <ordinals file path, map with ordinals (@c nullptr if the file
+		/// can not be loaded)>, shared by the containers of all the modules.
+		static thread_local std::map<
+				std::string,
+				std::unique_ptr<ImportOrdMap>> _ordFiles;
 };
 
 /**
@@ -204,7 +237,6 @@ class NamesProvider
 		static NameContainer* addNames(
 				llvm::Module* m,
 				Config* c,
-				DebugFormat* d,
 				FileImage* i,
 				Demangler* dm,
 				Lti* lti);
@@ -213,7 +245,7 @@ class NamesProvider
 		static void clear();
 
 	private:
-		static std::map<llvm::Module*, NameContainer> _module2names;
+		static thread_local std::map<llvm::Module*, NameContainer> _module2names;
 };
 
 } // namespace bin2llvmir
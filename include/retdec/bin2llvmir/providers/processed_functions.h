@@ -0,0 +1,58 @@
+/**
+ * @file include/retdec/bin2llvmir/providers/processed_functions.h
+ * @brief Functions already processed by passes and their state.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_BIN2LLVMIR_PROVIDERS_PROCESSED_FUNCTIONS_H
+#define RETDEC_BIN2LLVMIR_PROVIDERS_PROCESSED_FUNCTIONS_H
+
+#include <cstdint>
+#include <map>
+#include <utility>
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Completely static object -- all members and methods are static -> it can be
+ * used by anywhere in bin2llvmirl. It remembers which functions of modules
+ * were processed by passes, and how the functions looked like afterwards.
+ *
+ * A pass whose transformation of a function depends only on the function's
+ * IR and which does nothing on its own output can skip the functions that
+ * were not modified since its last run.
+ */
+class ProcessedFunctionsProvider
+{
+	public:
+		static bool isUnchanged(
+				llvm::Module* m,
+				const void* pass,
+				const llvm::Function* f);
+		static void setProcessed(
+				llvm::Module* m,
+				const void* pass,
+				const llvm::Function* f);
+
+		static std::uint64_t getFingerprint(const llvm::Function* f);
+
+		static void clear();
+
+	private:
+		using Key = std::pair<const void*, const llvm::Function*>;
+
+	private:
+		/// Mapping of modules to fingerprints of functions processed by
+		/// passes (identified by their IDs).
+		static thread_local std::map<llvm::Module*, std::map<Key, std::uint64_t>>
+				_module2fingerprints;
+};
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file include/retdec/bin2llvmir/utils/async_writers.h
+ * @brief Writing of output files on background threads.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_BIN2LLVMIR_UTILS_ASYNC_WRITERS_H
+#define RETDEC_BIN2LLVMIR_UTILS_ASYNC_WRITERS_H
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Output writers running on background threads, so that the following passes
+ * do not wait for them. The writers must not touch the module the passes
+ * work on, they get its frozen copy instead (see @c snapshot()).
+ */
+class AsyncWriters
+{
+	public:
+		/// Frozen copy of a module in its own context.
+		struct Snapshot
+		{
+			std::unique_ptr<llvm::LLVMContext> context;
+			std::unique_ptr<llvm::Module> module;
+		};
+
+	public:
+		static std::shared_ptr<std::string> serialize(const llvm::Module& m);
+		static Snapshot snapshot(
+				const std::string& bitcode,
+				const std::string& moduleId);
+
+		static void start(std::function<void()> job);
+		static void wait();
+		static std::size_t running();
+
+	private:
+		static std::mutex _mutex;
+		static std::vector<std::thread> _threads;
+		static std::exception_ptr _error;
+};
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
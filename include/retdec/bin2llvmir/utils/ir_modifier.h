@@ -7,6 +7,10 @@
 #ifndef RETDEC_BIN2LLVMIR_UTILS_IR_MODIFIER_H
 #define RETDEC_BIN2LLVMIR_UTILS_IR_MODIFIER_H
 
+#include <map>
+#include <unordered_set>
+#include <vector>
+
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
 
@@ -89,6 +93,15 @@ class IrModifier
 				bool dbg = false,
 				bool wideString = false);
 
+		void scheduleObjectTypeChange(
+				llvm::Value* val,
+				llvm::Type* toType,
+				llvm::Constant* init = nullptr,
+				bool wideString = false);
+		std::size_t applyObjectTypeChanges(
+				FileImage* objf,
+				std::unordered_set<llvm::Instruction*>* instToErase = nullptr);
+
 		FunctionPair modifyFunction(
 				llvm::Function* fnc,
 				llvm::Type* ret,
@@ -114,10 +127,30 @@ class IrModifier
 				llvm::Type* toType,
 				llvm::Constant* init = nullptr,
 				bool wideString = false);
+		llvm::Value* convertObjectToType(
+				llvm::Value* obj,
+				llvm::Type* type,
+				llvm::Instruction* before);
+
+	protected:
+		/// Object type change scheduled by scheduleObjectTypeChange().
+		struct ObjectTypeChange
+		{
+			llvm::Value* val = nullptr;
+			llvm::Type* toType = nullptr;
+			llvm::Constant* init = nullptr;
+			bool wideString = false;
+		};
 
 	protected:
 		llvm::Module* _module = nullptr;
 		Config* _config = nullptr;
+		/// Changes waiting for applyObjectTypeChanges().
+		std::vector<ObjectTypeChange> _objectTypeChanges;
+		/// Casts of changed objects shared by all their uses. They are kept
+		/// while the scheduled changes are being applied.
+		std::map<std::pair<llvm::Value*, llvm::Type*>, llvm::Value*> _objectCasts;
+		bool _applyingObjectTypeChanges = false;
 };
 
 } // namespace bin2llvmir
@@ -0,0 +1,89 @@
+/**
+ * @file include/retdec/bin2llvmir/utils/ordinal_database.h
+ * @brief Compiled database of names of functions imported by ordinals.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_BIN2LLVMIR_UTILS_ORDINAL_DATABASE_H
+#define RETDEC_BIN2LLVMIR_UTILS_ORDINAL_DATABASE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Database of names of functions imported by ordinals, compiled from all the
+ * @c <arch>/<lib>.ord files in the ordinals directory into a single file (see
+ * @c support/compile-ordinals.py).
+ *
+ * The file is mapped into memory and queried in place, without parsing:
+ * @code
+ * header:    "RDORDDB1", u32 number of libraries, u32 number of ordinals
+ * libraries: {u32 key offset, u32 first ordinal, u32 number of ordinals},
+ *            sorted by keys ("<arch>/<lib>")
+ * ordinals:  {u32 ordinal, u32 name offset}, sorted by ordinals per library
+ * strings:   interned NUL-terminated strings (offsets are from file start)
+ * @endcode
+ * All numbers are little-endian.
+ *
+ * Databases are immutable, so every file is loaded only once per process and
+ * shared by all decompilations and threads (see @c get()).
+ */
+class OrdinalDatabase
+{
+	public:
+		/// Name of the database file in the ordinals directory.
+		static const std::string fileName;
+
+	public:
+		static std::shared_ptr<const OrdinalDatabase> get(
+				const std::string& ordinalsDir);
+		static std::unique_ptr<OrdinalDatabase> create(
+				std::unique_ptr<llvm::MemoryBuffer> buffer);
+
+		bool hasLibrary(
+				const std::string& arch,
+				const std::string& libName) const;
+		llvm::StringRef getName(
+				const std::string& arch,
+				const std::string& libName,
+				std::uint32_t ord) const;
+
+	private:
+		OrdinalDatabase(std::unique_ptr<llvm::MemoryBuffer> buffer);
+
+		bool init();
+		std::uint32_t read32(std::size_t offset) const;
+		llvm::StringRef readString(std::size_t offset) const;
+		bool findLibrary(
+				const std::string& arch,
+				const std::string& libName,
+				std::size_t& entry) const;
+
+	private:
+		std::unique_ptr<llvm::MemoryBuffer> _buffer;
+		std::uint32_t _libCount = 0;
+		std::uint32_t _ordCount = 0;
+		std::size_t _ordsOffset = 0;
+		std::size_t _stringsOffset = 0;
+
+		/// <ordinals directory, database (@c nullptr if it can not be
+		/// loaded)>
+		static std::mutex _mutex;
+		static std::map<
+				std::string,
+				std::shared_ptr<const OrdinalDatabase>> _databases;
+};
+
+} // namespace bin2llvmir
+} // namespace retdec
+
+#endif
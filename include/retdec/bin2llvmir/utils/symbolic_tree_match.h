@@ -12,6 +12,8 @@
 #ifndef RETDEC_BIN2LLVMIR_UTILS_SYMBOLIC_TREE_MATCH_H
 #define RETDEC_BIN2LLVMIR_UTILS_SYMBOLIC_TREE_MATCH_H
 
+#include <llvm/IR/Operator.h>
+
 #include "retdec/bin2llvmir/analyses/symbolic_tree.h"
 
 namespace retdec {
@@ -1233,6 +1235,166 @@ inline specific_fpval m_FPOne()
 	return m_SpecificFP(1.0);
 }
 
+//
+//==============================================================================
+// Pattern shapes.
+//==============================================================================
+//
+
+/// Opcode of a pattern shape that does not restrict the root's opcode.
+constexpr unsigned ANY_OPCODE = ~0u;
+/// Arity of a pattern shape that does not restrict the root's operands.
+constexpr unsigned ANY_ARITY = ~0u;
+
+/**
+ * Shape of the root of a @c SymbolicTree: the opcode of its instruction or
+ * constant expression (zero for other values) and its number of operands.
+ * Computed once, it rejects patterns of other shapes without running them.
+ */
+struct Shape
+{
+	unsigned opcode = 0;
+	unsigned arity = 0;
+
+	explicit Shape(const SymbolicTree& st) :
+			arity(st.ops.size())
+	{
+		if (auto* o = llvm::dyn_cast<llvm::Operator>(st.value))
+		{
+			opcode = o->getOpcode();
+		}
+	}
+};
+
+/**
+ * Shape of the roots of trees @c Pattern can match, known at compile time.
+ * It is a necessary condition only, the pattern itself decides. Patterns
+ * without a specialization may match roots of any shape.
+ */
+template <typename Pattern> struct pattern_shape
+{
+	static constexpr unsigned opcode = ANY_OPCODE;
+	static constexpr unsigned arity = ANY_ARITY;
+};
+
+template <typename Class> struct class_opcode
+{
+	static constexpr unsigned value = ANY_OPCODE;
+};
+template <> struct class_opcode<llvm::ICmpInst>
+{
+	static constexpr unsigned value = llvm::Instruction::ICmp;
+};
+template <> struct class_opcode<llvm::FCmpInst>
+{
+	static constexpr unsigned value = llvm::Instruction::FCmp;
+};
+
+template <typename L, typename R, unsigned Opcode, bool C>
+struct pattern_shape<BinaryOp_match<L, R, Opcode, C>>
+{
+	static constexpr unsigned opcode = Opcode;
+	static constexpr unsigned arity = 2;
+};
+
+template <typename L, typename R, bool C>
+struct pattern_shape<AnyBinaryOp_match<L, R, C>>
+{
+	static constexpr unsigned opcode = ANY_OPCODE;
+	static constexpr unsigned arity = 2;
+};
+
+template <typename L> struct pattern_shape<not_match<L>>
+{
+	static constexpr unsigned opcode = llvm::Instruction::Xor;
+	static constexpr unsigned arity = 2;
+};
+
+template <typename L> struct pattern_shape<neg_match<L>>
+{
+	static constexpr unsigned opcode = llvm::Instruction::Sub;
+	static constexpr unsigned arity = 2;
+};
+
+template <typename L, typename R, typename Class, typename P, bool C>
+struct pattern_shape<CmpClass_match<L, R, Class, P, C>>
+{
+	static constexpr unsigned opcode = class_opcode<Class>::value;
+	static constexpr unsigned arity = 2;
+};
+
+template <typename L, typename R, typename Class, typename P, bool C>
+struct pattern_shape<CmpClass_pred_match<L, R, Class, P, C>>
+{
+	static constexpr unsigned opcode = class_opcode<Class>::value;
+	static constexpr unsigned arity = 2;
+};
+
+template <typename Op> struct pattern_shape<LoadClass_match<Op>>
+{
+	static constexpr unsigned opcode = llvm::Instruction::Load;
+	static constexpr unsigned arity = 1;
+};
+
+/// Both patterns must match, so the shape of either of them must.
+template <typename L, typename R> struct pattern_shape<match_combine_and<L, R>>
+{
+	static constexpr bool useL = pattern_shape<L>::opcode != ANY_OPCODE
+			|| pattern_shape<L>::arity != ANY_ARITY;
+	static constexpr unsigned opcode =
+			useL ? pattern_shape<L>::opcode : pattern_shape<R>::opcode;
+	static constexpr unsigned arity =
+			useL ? pattern_shape<L>::arity : pattern_shape<R>::arity;
+};
+
+/// Either pattern may match, so only what their shapes share is required.
+template <typename L, typename R> struct pattern_shape<match_combine_or<L, R>>
+{
+	static constexpr unsigned opcode =
+			pattern_shape<L>::opcode == pattern_shape<R>::opcode
+			? pattern_shape<L>::opcode : ANY_OPCODE;
+	static constexpr unsigned arity =
+			pattern_shape<L>::arity == pattern_shape<R>::arity
+			? pattern_shape<L>::arity : ANY_ARITY;
+};
+
+/**
+ * Check if pattern @c Pattern may match a tree whose root has @a shape.
+ */
+template <typename Pattern>
+bool mayMatch(const Shape& shape)
+{
+	constexpr unsigned opcode = pattern_shape<Pattern>::opcode;
+	constexpr unsigned arity = pattern_shape<Pattern>::arity;
+	return (opcode == ANY_OPCODE || opcode == shape.opcode)
+			&& (arity == ANY_ARITY || arity == shape.arity);
+}
+
+/**
+ * The same as @c match(st, p), but @a p is not run at all if its shape is
+ * not compatible with @a shape of @a st. Use it when many patterns are tried
+ * on the same tree one after another.
+ */
+template <typename Pattern>
+bool match(SymbolicTree& st, const Shape& shape, const Pattern& p)
+{
+	return mayMatch<Pattern>(shape) && match(st, p);
+}
+
+/**
+ * Try @a patterns on @a st in order, until one of them matches. The shape of
+ * @a st is computed only once and only patterns of compatible shapes are run.
+ * @return Index of the matching pattern, or -1 if none of them matches.
+ */
+template <typename... Patterns>
+int match_first(SymbolicTree& st, const Patterns&... patterns)
+{
+	Shape shape(st);
+	int index = 0;
+	bool found = ((match(st, shape, patterns) || (++index, false)) || ...);
+	return found ? index : -1;
+}
+
 } // namespace st_match
 } // namespace bin2llvmir
 } // namespace retdec
@@ -20,6 +20,7 @@
 
 #include "retdec/common/address.h"
 #include "retdec/capstone2llvmir/exceptions.h"
+#include "retdec/capstone2llvmir/insn_pool.h"
 
 // These are additions to capstone - include them all here.
 #include "retdec/capstone2llvmir/arm/arm_defs.h"
@@ -251,6 +252,17 @@ class Capstone2LlvmIrTranslator
 				cs_mode extra = CS_MODE_LITTLE_ENDIAN);
 
 		virtual ~Capstone2LlvmIrTranslator() = default;
+
+		/**
+		 * Create a translator of the same architecture, modes and
+		 * configuration (except the instruction pool) that translates into
+		 * module @p m. The clone has its own Capstone handle, the tables of
+		 * instruction translation methods are shared. If @p m is in another
+		 * LLVM context, the clone may translate concurrently with this
+		 * translator (see @c TranslatorPool).
+		 */
+		virtual std::unique_ptr<Capstone2LlvmIrTranslator> clone(
+				llvm::Module* m) const = 0;
 //
 //==============================================================================
 // Translator configuration methods.
@@ -284,10 +296,51 @@ class Capstone2LlvmIrTranslator
 		 * Default value: true.
 		 */
 		virtual void setGeneratePseudoAsmFunctions(bool f) = 0;
+		/**
+		 * Pool from which all the translated Capstone instructions are
+		 * allocated. If set, the translated instructions are owned by the
+		 * pool and they must not be freed by the caller.
+		 * The pool must outlive the use of the translated instructions.
+		 *
+		 * Default value: nullptr (every instruction is allocated by
+		 * @c cs_malloc()).
+		 */
+		virtual void setInstructionPool(CapstoneInsnPool* pool) = 0;
+		/**
+		 * Should the translator memoize LLVM IR generated for instructions
+		 * and replay it for the following instructions with the same
+		 * encoding? Only instructions whose translation does not depend on
+		 * their address are memoized.
+		 * True -> memoize.
+		 * False -> translate every instruction.
+		 *
+		 * Default value: false.
+		 */
+		virtual void setUseTranslationCache(bool f) = 0;
+		/**
+		 * Delete all the memoized translations.
+		 */
+		virtual void clearTranslationCache() = 0;
+		/**
+		 * Should the translator materialize only the flags which may be read?
+		 * A flag stored by an instruction is removed, together with its
+		 * computation, when the same flag is stored again later in the same
+		 * basic block and no load of the flag and no call is between the two
+		 * stores. Flags are kept at block exits and around calls.
+		 * Only x86 translator has flags that are materialized lazily.
+		 * True -> materialize only flags which may be read.
+		 * False -> materialize all flags.
+		 *
+		 * Default value: false.
+		 */
+		virtual void setLazyFlags(bool f) = 0;
 
 		virtual bool isIgnoreUnexpectedOperands() const = 0;
 		virtual bool isIgnoreUnhandledInstructions() const = 0;
 		virtual bool isGeneratePseudoAsmFunctions() const = 0;
+		virtual CapstoneInsnPool* getInstructionPool() const = 0;
+		virtual bool isUseTranslationCache() const = 0;
+		virtual bool isLazyFlags() const = 0;
 //
 //==============================================================================
 // Mode query & modification methods.
@@ -354,7 +407,8 @@ class Capstone2LlvmIrTranslator
 			/// module and should be automatically destroyed when module is
 			/// destroyed.
 			/// All capstone instructions are dynamically allocated by this
-			/// method, and must be freed by caller to avoid memory leaks.
+			/// method, and must be freed by caller to avoid memory leaks
+			/// (unless they are allocated from the instruction pool).
 			std::list<std::pair<llvm::StoreInst*, cs_insn*>> insns;
 			/// Byte size of the translated binary chunk.
 			std::size_t size = 0;
@@ -403,7 +457,8 @@ class Capstone2LlvmIrTranslator
 			llvm::StoreInst* llvmInsn = nullptr;
 			/// Translated capstone instruction.
 			/// Capstone instruction is dynamically allocated by this
-			/// method, and must be freed by caller to avoid memory leaks.
+			/// method, and must be freed by caller to avoid memory leaks
+			/// (unless it is allocated from the instruction pool).
 			cs_insn* capstoneInsn = nullptr;
 			/// Byte size of the translated binary chunk.
 			std::size_t size = 0;
@@ -433,6 +488,20 @@ class Capstone2LlvmIrTranslator
 				std::size_t& size,
 				retdec::common::Address& a,
 				llvm::IRBuilder<>& irb) = 0;
+		/**
+		 * Translate one already disassembled assembly instruction.
+		 * @param insn  Capstone instruction disassembled with details by an
+		 *              engine in the same architecture and mode as the
+		 *              translator's engine. Its ownership is passed to the
+		 *              caller in the same way as for @c translateOne().
+		 * @param irb   LLVM IR builder used to create LLVM IR translation.
+		 *              Translated LLVM IR instructions are created at its
+		 *              current position.
+		 * @return See @c TranslationResult structure.
+		 */
+		virtual TranslationResultOne translateDisassembled(
+				cs_insn* insn,
+				llvm::IRBuilder<>& irb) = 0;
 //
 //==============================================================================
 // Capstone related getters and query methods.
@@ -755,6 +824,12 @@ class Capstone2LlvmIrTranslator
 		 * semantics is not implemented.
 		 */
 		virtual const std::set<llvm::Function*>& getPseudoAsmFunctions() const = 0;
+		/**
+		 * Make the translator treat function @p f from its module as the
+		 * pseudo assembly function of the same name and type, e.g. when it was
+		 * generated by a clone of the translator and merged into the module.
+		 */
+		virtual void addPseudoAsmFunction(llvm::Function* f) = 0;
 };
 
 } // namespace capstone2llvmir
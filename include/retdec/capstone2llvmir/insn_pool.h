@@ -0,0 +1,69 @@
+/**
+ * @file include/retdec/capstone2llvmir/insn_pool.h
+ * @brief Pooled storage of Capstone instructions.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_CAPSTONE2LLVMIR_INSN_POOL_H
+#define RETDEC_CAPSTONE2LLVMIR_INSN_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <capstone/capstone.h>
+
+namespace retdec {
+namespace capstone2llvmir {
+
+/**
+ * Arena of Capstone instructions.
+ *
+ * Instructions are allocated in chunks and they all live until the pool is
+ * destroyed, i.e. there is no per-instruction @c cs_malloc() and @c cs_free().
+ * Instructions from the pool must never be passed to @c cs_free().
+ *
+ * Capstone fills only the common part of @c cs_detail and the member of its
+ * architecture union that belongs to the disassembled architecture. Therefore,
+ * the pool allocates only this arch-specific prefix of @c cs_detail for every
+ * instruction, which is several times smaller than the whole structure for
+ * most architectures. The detail must be accessed only through the member
+ * of the pool's architecture (e.g. @c detail->arm for @c CS_ARCH_ARM).
+ */
+class CapstoneInsnPool
+{
+	public:
+		explicit CapstoneInsnPool(cs_arch arch, std::size_t chunkSize = 4096);
+		CapstoneInsnPool(const CapstoneInsnPool&) = delete;
+		CapstoneInsnPool& operator=(const CapstoneInsnPool&) = delete;
+
+		cs_insn* allocate();
+		void release(cs_insn* insn);
+
+		std::size_t size() const;
+		std::size_t getDetailSize() const;
+
+		static std::size_t getDetailSize(cs_arch arch);
+
+	private:
+		void addChunk();
+
+	private:
+		struct Chunk
+		{
+			std::unique_ptr<cs_insn[]> insns;
+			std::unique_ptr<unsigned char[]> details;
+		};
+
+	private:
+		std::size_t _chunkSize = 0;
+		std::size_t _detailSize = 0;
+		/// Number of instructions used in the last chunk.
+		std::size_t _used = 0;
+		std::vector<Chunk> _chunks;
+};
+
+} // namespace capstone2llvmir
+} // namespace retdec
+
+#endif
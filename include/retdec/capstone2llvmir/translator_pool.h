@@ -0,0 +1,96 @@
+/**
+ * @file include/retdec/capstone2llvmir/translator_pool.h
+ * @brief Translators for concurrent translation on worker threads.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_CAPSTONE2LLVMIR_TRANSLATOR_POOL_H
+#define RETDEC_CAPSTONE2LLVMIR_TRANSLATOR_POOL_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include "retdec/capstone2llvmir/capstone2llvmir.h"
+
+namespace retdec {
+namespace capstone2llvmir {
+
+/**
+ * Pool of translators that translate concurrently on worker threads.
+ *
+ * An LLVM context must not be used by several threads at once, so every
+ * translator of the pool is a clone of the main translator bound to its own
+ * staging module in its own LLVM context. Each clone has its own Capstone
+ * handle, the tables of instruction translation methods are shared.
+ *
+ * A worker thread acquires a translator, stages LLVM IR by translating at the
+ * builder returned by @c Worker::stage(), takes the staged code by
+ * @c Worker::finish(), and releases the translator. The committing thread
+ * (the one using the main translator) merges the staged code into the main
+ * module by @c commit(). The staged code crosses LLVM contexts as bitcode,
+ * so it pays off to stage many instructions at once.
+ */
+class TranslatorPool
+{
+	public:
+		/// LLVM IR staged by a worker, independent of its LLVM context.
+		struct StagedCode
+		{
+			/// Bitcode of the staging module.
+			std::string bitcode;
+			/// Names of the pseudo assembly functions of the staging module.
+			std::vector<std::string> pseudoAsmFunctions;
+		};
+
+		/// Translator bound to a staging module.
+		class Worker
+		{
+			public:
+				Capstone2LlvmIrTranslator& getTranslator();
+				llvm::IRBuilder<>& stage();
+				StagedCode finish();
+
+			private:
+				friend class TranslatorPool;
+				Worker(const Capstone2LlvmIrTranslator& main);
+
+			private:
+				std::unique_ptr<llvm::LLVMContext> _context;
+				std::unique_ptr<llvm::Module> _module;
+				std::unique_ptr<Capstone2LlvmIrTranslator> _translator;
+				llvm::Function* _function = nullptr;
+				std::unique_ptr<llvm::IRBuilder<>> _irb;
+		};
+
+	public:
+		TranslatorPool(Capstone2LlvmIrTranslator& main, unsigned threads);
+		TranslatorPool(const TranslatorPool&) = delete;
+		TranslatorPool& operator=(const TranslatorPool&) = delete;
+
+		Worker* acquire();
+		void release(Worker* worker);
+
+		std::vector<llvm::StoreInst*> commit(
+				const StagedCode& code,
+				llvm::IRBuilder<>& irb);
+
+	private:
+		Capstone2LlvmIrTranslator& _main;
+		std::vector<std::unique_ptr<Worker>> _workers;
+
+		std::mutex _mutex;
+		std::condition_variable _released;
+		std::vector<Worker*> _free;
+};
+
+} // namespace capstone2llvmir
+} // namespace retdec
+
+#endif
@@ -7,10 +7,11 @@
 #ifndef RETDEC_COMMON_BASIC_BLOCK_H
 #define RETDEC_COMMON_BASIC_BLOCK_H
 
-#include <set>
 #include <tuple>
+#include <vector>
 
 #include "retdec/common/address.h"
+#include "retdec/common/flat_set.h"
 #include "retdec/common/range.h"
 
 struct cs_insn;
@@ -25,9 +26,9 @@ class BasicBlock : public AddressRange
 
 	public:
 		/// Start addresses of predecessor basic blocks.
-		std::set<Address> preds;
+		FlatSet<Address> preds;
 		/// Start addresses of successor basic blocks.
-		std::set<Address> succs;
+		FlatSet<Address> succs;
 
 		/// All the calls in this basic block.
 		struct CallEntry
@@ -41,7 +42,7 @@ class BasicBlock : public AddressRange
 						< std::tie(o.srcAddr, o.targetAddr);
 			}
 		};
-		std::set<CallEntry> calls;
+		FlatSet<CallEntry> calls;
 
 		/// Basic block instructions.
 		/// These are pointers to Capstone instruction representations.
@@ -0,0 +1,249 @@
+/**
+ * @file include/retdec/common/flat_set.h
+ * @brief Set stored in a sorted vector.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_COMMON_FLAT_SET_H
+#define RETDEC_COMMON_FLAT_SET_H
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace retdec {
+namespace common {
+
+/**
+ * Ordered set of unique elements stored in a sorted vector.
+ *
+ * It has the query API of @c std::set, but its elements are stored
+ * contiguously, without a node allocation per element. It is meant for sets
+ * that are built at once and then only traversed and queried: inserting
+ * elements in order (or a whole range at once) is cheap, inserting into the
+ * middle moves all the following elements. Any insertion or erasure
+ * invalidates all iterators and pointers to elements.
+ *
+ * All lookups accept any key comparable by @c Compare with the elements, so
+ * transparent comparators work as with @c std::set.
+ */
+template <typename T, typename Compare = std::less<T>>
+class FlatSet
+{
+	public:
+		using key_type = T;
+		using value_type = T;
+		using key_compare = Compare;
+		using value_compare = Compare;
+		using size_type = typename std::vector<T>::size_type;
+		using difference_type = typename std::vector<T>::difference_type;
+		using reference = const T&;
+		using const_reference = const T&;
+		// Elements are keys, they can not be modified in place.
+		using iterator = typename std::vector<T>::const_iterator;
+		using const_iterator = iterator;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = reverse_iterator;
+
+	public:
+		FlatSet() = default;
+
+		explicit FlatSet(const Compare& comp) :
+				_comp(comp)
+		{}
+
+		FlatSet(std::initializer_list<T> il)
+		{
+			insert(il.begin(), il.end());
+		}
+
+		template <typename InputIt>
+		FlatSet(InputIt first, InputIt last)
+		{
+			insert(first, last);
+		}
+
+		/// @name Iterators.
+		/// @{
+		iterator begin() const { return _data.cbegin(); }
+		iterator end() const { return _data.cend(); }
+		iterator cbegin() const { return _data.cbegin(); }
+		iterator cend() const { return _data.cend(); }
+		reverse_iterator rbegin() const { return reverse_iterator(end()); }
+		reverse_iterator rend() const { return reverse_iterator(begin()); }
+		/// @}
+
+		/// @name Capacity.
+		/// @{
+		bool empty() const { return _data.empty(); }
+		size_type size() const { return _data.size(); }
+		void reserve(size_type n) { _data.reserve(n); }
+		void shrink_to_fit() { _data.shrink_to_fit(); }
+		/// @}
+
+		/// @name Modifiers.
+		/// @{
+		void clear() { _data.clear(); }
+
+		std::pair<iterator, bool> insert(const T& v)
+		{
+			return emplaceValue(T(v));
+		}
+
+		std::pair<iterator, bool> insert(T&& v)
+		{
+			return emplaceValue(std::move(v));
+		}
+
+		/**
+		 * Insert @a v. Hint @a pos is used only to append elements inserted
+		 * in order at @c end() in constant time.
+		 */
+		iterator insert(const_iterator pos, const T& v)
+		{
+			if (pos == end() && (empty() || _comp(_data.back(), v)))
+			{
+				_data.push_back(v);
+				return std::prev(end());
+			}
+			return insert(v).first;
+		}
+
+		/**
+		 * Insert all elements of [@a first, @a last) at once. Elements
+		 * equivalent to the already present ones, or to the preceding ones in
+		 * the range, are not inserted (as with @c std::set).
+		 */
+		template <typename InputIt>
+		void insert(InputIt first, InputIt last)
+		{
+			auto oldSize = _data.size();
+			_data.insert(_data.end(), first, last);
+			auto mid = _data.begin() + oldSize;
+			std::stable_sort(mid, _data.end(), _comp);
+			std::inplace_merge(_data.begin(), mid, _data.end(), _comp);
+			_data.erase(
+					std::unique(_data.begin(), _data.end(),
+							[this](const T& a, const T& b) {
+								return !_comp(a, b);
+							}),
+					_data.end());
+		}
+
+		void insert(std::initializer_list<T> il)
+		{
+			insert(il.begin(), il.end());
+		}
+
+		template <typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args)
+		{
+			return emplaceValue(T(std::forward<Args>(args)...));
+		}
+
+		template <typename... Args>
+		iterator emplace_hint(const_iterator pos, Args&&... args)
+		{
+			return insert(pos, T(std::forward<Args>(args)...));
+		}
+
+		iterator erase(const_iterator pos)
+		{
+			return _data.erase(pos);
+		}
+
+		iterator erase(const_iterator first, const_iterator last)
+		{
+			return _data.erase(first, last);
+		}
+
+		template <typename K>
+		size_type erase(const K& k)
+		{
+			auto it = find(k);
+			if (it == end())
+			{
+				return 0;
+			}
+			_data.erase(it);
+			return 1;
+		}
+
+		void swap(FlatSet& o)
+		{
+			_data.swap(o._data);
+			std::swap(_comp, o._comp);
+		}
+		/// @}
+
+		/// @name Lookup.
+		/// @{
+		template <typename K>
+		iterator find(const K& k) const
+		{
+			auto it = lower_bound(k);
+			return it != end() && !_comp(k, *it) ? it : end();
+		}
+
+		template <typename K>
+		size_type count(const K& k) const
+		{
+			return find(k) != end();
+		}
+
+		template <typename K>
+		iterator lower_bound(const K& k) const
+		{
+			return std::lower_bound(begin(), end(), k, _comp);
+		}
+
+		template <typename K>
+		iterator upper_bound(const K& k) const
+		{
+			return std::upper_bound(begin(), end(), k, _comp);
+		}
+
+		template <typename K>
+		std::pair<iterator, iterator> equal_range(const K& k) const
+		{
+			return std::equal_range(begin(), end(), k, _comp);
+		}
+		/// @}
+
+		key_compare key_comp() const { return _comp; }
+		value_compare value_comp() const { return _comp; }
+
+		bool operator==(const FlatSet& o) const { return _data == o._data; }
+		bool operator!=(const FlatSet& o) const { return _data != o._data; }
+		bool operator<(const FlatSet& o) const { return _data < o._data; }
+
+	private:
+		std::pair<iterator, bool> emplaceValue(T&& v)
+		{
+			// Fast path for elements inserted in order.
+			if (empty() || _comp(_data.back(), v))
+			{
+				_data.push_back(std::move(v));
+				return {std::prev(end()), true};
+			}
+
+			auto it = lower_bound(v);
+			if (it != end() && !_comp(v, *it))
+			{
+				return {it, false};
+			}
+			return {_data.insert(it, std::move(v)), true};
+		}
+
+	private:
+		std::vector<T> _data;
+		Compare _comp;
+};
+
+} // namespace common
+} // namespace retdec
+
+#endif
@@ -7,11 +7,13 @@
 #ifndef RETDEC_COMMON_FUNCTION_H
 #define RETDEC_COMMON_FUNCTION_H
 
+#include <map>
 #include <set>
 #include <string>
 
 #include "retdec/common/calling_convention.h"
 #include "retdec/common/basic_block.h"
+#include "retdec/common/flat_set.h"
 #include "retdec/common/object.h"
 #include "retdec/common/storage.h"
 #include "retdec/common/type.h"
@@ -137,10 +139,14 @@ class Function : public retdec::common::AddressRange
 		common::Type returnType;
 		common::ObjectSequentialContainer parameters;
 		common::ObjectSetContainer locals;
-		std::set<std::string> usedCryptoConstants;
-		std::set<common::BasicBlock> basicBlocks;
+		FlatSet<std::string> usedCryptoConstants;
+		/// Cheaper paths the back-end took for this function because it was
+		/// too costly to decompile (e.g. structuring by gotos). Mutable
+		/// because it is set on functions stored in a set, like the link type.
+		mutable std::set<std::string> degradations;
+		FlatSet<common::BasicBlock> basicBlocks;
 		/// Addresses of instructions which reference (use) this  function.
-		std::set<common::Address> codeReferences;
+		FlatSet<common::Address> codeReferences;
 
 	private:
 		std::string _name; ///< This is objects unique ID.
@@ -201,15 +207,38 @@ struct FunctionAddressCompare
 /**
  * An associative container with functions' names as the key.
  * See Function class for details.
+ * Functions are also indexed by their start addresses, see @c insert() for
+ * details.
  */
 class FunctionContainer : public std::set<Function, FunctionNameCompare>
 {
 	public:
+		FunctionContainer();
+		FunctionContainer(const FunctionContainer& o);
+		FunctionContainer& operator=(const FunctionContainer& o);
+
 		bool hasFunction(const std::string& name);
 		const Function* getFunctionByName(const std::string& name) const;
 		const Function* getFunctionByStartAddress(
 				const retdec::common::Address& addr) const;
 		const Function* getFunctionByRealName(const std::string& name) const;
+
+		/// @name Reimplemented base container methods.
+		///
+		/// They need to be reimplemented to modify both underlying container
+		/// and @c _addr2fnc map.
+		/// @{
+		std::pair<iterator,bool> insert(const Function& f);
+		iterator insert(const_iterator, const Function& f);
+		void clear();
+		size_t erase(const Function& f);
+		iterator erase(const_iterator pos);
+		/// @}
+
+	private:
+		/// Map allows fast functions search by start address. There might
+		/// be more functions starting at the same address.
+		std::multimap<retdec::common::Address, const Function*> _addr2fnc;
 };
 
 // TODO:
@@ -218,7 +247,7 @@ class FunctionContainer : public std::set<Function, FunctionNameCompare>
 // potentially unwanted side effects.
 // Also, because it does not take range as template argument, it is not ready
 // to be used with common::Function.
-class FunctionSet : public std::set<
+class FunctionSet : public FlatSet<
 		retdec::common::Function,
 		retdec::common::FunctionAddressCompare>
 {
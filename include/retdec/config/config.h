@@ -43,6 +43,17 @@ class Config
 		void readJsonString(const std::string& json);
 		void readJsonFile(const std::string& input);
 
+		std::string generateBinaryString() const;
+		void readBinaryString(const std::string& data);
+
+		std::string generateFile(const std::string& outputFilePath) const;
+		void readFile(const std::string& input);
+
+	private:
+		template <typename Writer>
+		void serialize(Writer& writer) const;
+		void deserialize(const rapidjson::Value& root);
+
 	public:
 		Parameters parameters;
 		common::Architecture architecture;
@@ -29,9 +29,19 @@ class Parameters
 		bool isSomethingSelected() const;
 		bool isVerboseOutput() const;
 		bool isKeepAllFunctions() const;
+		bool isPruneUnreachableFunctionsEarly() const;
 		bool isSelectedDecodeOnly() const;
+		bool isTranslationCache() const;
+		bool isLazyFlags() const;
+		bool isAsyncIrWriters() const;
+		bool isConcurrentInit() const;
 		bool isDetectStaticCode() const;
+		bool isSkipStaticCodeBodies() const;
+		bool isCompressOutputAsm() const;
+		bool isBinaryOutputConfig() const;
+		bool isCompactOutputConfig() const;
 		bool isTimeout() const;
+		bool isPhaseTimeout() const;
 		bool isMaxMemoryLimitHalfRam() const;
 		bool isBackendNoOpts() const;
 		bool isBackendEmitCfg() const;
@@ -42,36 +52,62 @@ class Parameters
 		bool isBackendNoVarRenaming() const;
 		bool isBackendNoCompoundOperators() const;
 		bool isBackendNoSymbolicNames() const;
+		bool isBackendReleaseLlvmIr() const;
+		bool isBackendBirOnly() const;
 		/// @}
 
 		/// @name Parameters set methods.
 		/// @{
 		void setIsVerboseOutput(bool b);
 		void setIsKeepAllFunctions(bool b);
+		void setIsPruneUnreachableFunctionsEarly(bool b);
 		void setIsSelectedDecodeOnly(bool b);
+		void setSelectedDecodeDepth(uint64_t depth);
+		void setDecoderThreads(uint64_t threads);
+		void setRdaThreads(uint64_t threads);
+		void setIsTranslationCache(bool b);
+		void setIsLazyFlags(bool b);
+		void setIsAsyncIrWriters(bool b);
+		void setIsConcurrentInit(bool b);
 		void setOrdinalNumbersDirectory(const std::string& n);
 		void setInputFile(const std::string& file);
 		void setInputPdbFile(const std::string& file);
 		void setOutputFile(const std::string& n);
 		void setOutputBitcodeFile(const std::string& file);
 		void setOutputAsmFile(const std::string& file);
+		void setIsCompressOutputAsm(bool b);
+		void setIsBinaryOutputConfig(bool b);
+		void setIsCompactOutputConfig(bool b);
 		void setOutputLlvmirFile(const std::string& file);
 		void setOutputConfigFile(const std::string& file);
 		void setOutputUnpackedFile(const std::string& file);
+		void setProfileOutFile(const std::string& file);
+		void setInputBirFile(const std::string& file);
+		void setOutputBirFile(const std::string& file);
 		void setOutputFormat(const std::string& format);
 		void setLogFile(const std::string& file);
 		void setErrFile(const std::string& file);
 		void setMaxMemoryLimit(uint64_t limit);
 		void setIsMaxMemoryLimitHalfRam(bool f);
 		void setTimeout(uint64_t seconds);
+		void setPhaseTimeout(uint64_t seconds);
 		void setEntryPoint(const retdec::common::Address& a);
 		void setMainAddress(const retdec::common::Address& a);
 		void setSectionVMA(const retdec::common::Address& a);
 		void setBackendDisabledOpts(const std::string& o);
 		void setBackendEnabledOpts(const std::string& o);
 		void setBackendCallInfoObtainer(const std::string& val);
+		void setBackendAliasAnalysis(const std::string& val);
 		void setBackendVarRenamer(const std::string& val);
+		void setBackendCopyPropStmtLimit(uint64_t limit);
+		void setBackendFunctionCostLimit(uint64_t limit);
+		void setBackendValidation(const std::string& val);
+		void setBackendValidationSamplePercent(uint64_t percent);
+		void setBackendFuncCacheDirectory(const std::string& dir);
+		void setBackendGraphThreads(uint64_t threads);
 		void setIsDetectStaticCode(bool b);
+		void setIsSkipStaticCodeBodies(bool b);
+		void setStaticCodeCacheDirectory(const std::string& dir);
 		void setIsBackendNoOpts(bool b);
 		void setIsBackendEmitCfg(bool b);
 		void setIsBackendEmitCg(bool b);
@@ -81,6 +117,8 @@ class Parameters
 		void setIsBackendNoVarRenaming(bool b);
 		void setIsBackendNoCompoundOperators(bool b);
 		void setIsBackendNoSymbolicNames(bool b);
+		void setIsBackendReleaseLlvmIr(bool b);
+		void setIsBackendBirOnly(bool b);
 		/// @}
 
 		/// @name Parameters get methods.
@@ -94,18 +132,33 @@ class Parameters
 		const std::string& getOutputLlvmirFile() const;
 		const std::string& getOutputConfigFile() const;
 		const std::string& getOutputUnpackedFile() const;
+		const std::string& getProfileOutFile() const;
+		const std::string& getInputBirFile() const;
+		const std::string& getOutputBirFile() const;
 		const std::string& getOutputFormat() const;
 		const std::string& getLogFile() const;
 		const std::string& getErrFile() const;
 		uint64_t getMaxMemoryLimit() const;
 		uint64_t getTimeout() const;
+		uint64_t getPhaseTimeout() const;
+		uint64_t getSelectedDecodeDepth() const;
+		uint64_t getDecoderThreads() const;
+		uint64_t getRdaThreads() const;
 		retdec::common::Address getEntryPoint() const;
 		retdec::common::Address getMainAddress() const;
 		retdec::common::Address getSectionVMA() const;
 		const std::string& getBackendDisabledOpts() const;
 		const std::string& getBackendEnabledOpts() const;
 		const std::string& getBackendCallInfoObtainer() const;
+		const std::string& getBackendAliasAnalysis() const;
 		const std::string& getBackendVarRenamer() const;
+		uint64_t getBackendCopyPropStmtLimit() const;
+		uint64_t getBackendFunctionCostLimit() const;
+		const std::string& getBackendValidation() const;
+		uint64_t getBackendValidationSamplePercent() const;
+		const std::string& getBackendFuncCacheDirectory() const;
+		uint64_t getBackendGraphThreads() const;
+		const std::string& getStaticCodeCacheDirectory() const;
 		/// @}
 
 		void fixRelativePaths(const std::string& configPath);
@@ -135,6 +188,11 @@ class Parameters
 		/// LLVM passes.
 		std::vector<std::string> llvmPasses;
 
+		/// The back-end merges the BIR snapshots of these shards of a
+		/// distributed decompilation into one module instead of converting
+		/// and optimizing LLVM IR (if not empty).
+		std::vector<std::string> inputBirShards;
+
 	private:
 		/// Decompilation will verbosely inform about the
 		/// decompilation process.
@@ -143,12 +201,20 @@ class Parameters
 		/// Keep all functions in the decompiler's output.
 		/// Otherwise, only functions reachable from main are kept.
 		bool _keepAllFunctions = false;
+		/// Remove functions unreachable from main also before the parameter
+		/// and return analysis, not only after the type analyses.
+		bool _pruneUnreachableFunctionsEarly = false;
 
 		/// Decode only parts selected through selective decompilation.
 		/// Otherwise, entire binary is decoded.
 		/// This speeds up decompilation, but usually produces lower-quality
 		/// results.
 		bool _selectedDecodeOnly = false;
+		/// If non-zero and @c _selectedDecodeOnly is set, calls from the
+		/// selected parts are followed up to this depth and the functions
+		/// they reach are decoded as well. Everything else is left undecoded
+		/// and treated as external stubs.
+		uint64_t _selectedDecodeDepth = 0;
 
 		std::string _ordinalNumbersDirectory;
 		std::string _inputFile;
@@ -156,21 +222,80 @@ class Parameters
 		std::string _outputFile;
 		std::string _outputBitcodeFile;
 		std::string _outputAsmFile;
+		/// Write the disassembly listing compressed in gzip format.
+		bool _compressOutputAsm = false;
+		bool _binaryOutputConfig = false;
+		/// Write the JSON output config without pretty printing.
+		bool _compactOutputConfig = false;
 		std::string _outputLlFile;
 		std::string _outputConfigFile;
 		std::string _outputUnpackedFile;
+		/// Per-pass timing and memory profile is written here (if set).
+		std::string _profileOutFile;
+		/// The back-end loads the optimized module from this BIR snapshot
+		/// instead of converting and optimizing LLVM IR (if set).
+		std::string _inputBirFile;
+		/// The back-end saves the optimized module into this BIR snapshot
+		/// (if set).
+		std::string _outputBirFile;
 		std::string _outputFormat;
 		std::string _logFile;
 		std::string _errFile;
 		uint64_t _maxMemoryLimit = 0;
 		bool _maxMemoryLimitHalfRam = true;
 		uint64_t _timeout = 0;
+		/// Time budget of a single decompilation phase (in seconds).
+		/// A phase that runs out of it finishes early in a cheaper way.
+		uint64_t _phaseTimeout = 0;
+		/// Number of threads that speculatively disassemble code for the
+		/// decoder. Zero means that the decoder disassembles everything itself.
+		uint64_t _decoderThreads = 0;
+		/// Number of threads that compute reaching definitions of functions
+		/// in parallel. Zero means that they are computed on a single thread.
+		uint64_t _rdaThreads = 0;
+		/// Translation of repeated instructions into LLVM IR is memoized and
+		/// replayed.
+		bool _translationCache = false;
+		/// Flags stored by translated instructions are kept only if they
+		/// may be read before they are overwritten.
+		bool _lazyFlags = false;
+		/// LLVM IR and bitcode outputs are written on background threads from
+		/// a snapshot of the module, while the following passes run.
+		bool _asyncIrWriters = false;
+		/// Independent front-end analyses of the input file run concurrently
+		/// when providers are initialized.
+		bool _concurrentInit = false;
 
 		bool _detectStaticCode = true;
+		/// Confirmed statically linked functions are not decoded, they are
+		/// only declared.
+		bool _skipStaticCodeBodies = false;
+		/// Compiled static code signatures are cached here (if set).
+		std::string _staticCodeCacheDirectory;
 		std::string _backendDisabledOpts;
 		std::string _backendEnabledOpts;
 		std::string _backendCallInfoObtainer = "optim";
+		std::string _backendAliasAnalysis = "simple";
 		std::string _backendVarRenamer = "readable";
+		/// Functions with more statements than this are optimized by the
+		/// simple copy propagation instead of the full one. Zero means no
+		/// limit.
+		uint64_t _backendCopyPropStmtLimit = 0;
+		/// Functions whose estimated cost is above this are structured by
+		/// gotos and skipped by the most expensive optimizations. Zero means
+		/// no limit.
+		uint64_t _backendFunctionCostLimit = 0;
+		/// How thoroughly the resulting module is validated (full, sampled, or
+		/// off).
+		std::string _backendValidation = "full";
+		/// Percentage of functions validated by the sampled validation.
+		uint64_t _backendValidationSamplePercent = 10;
+		/// Optimized functions are cached here (if set) and reused in later
+		/// runs, also on other inputs.
+		std::string _backendFuncCacheDirectory;
+		/// Number of threads that emit CFGs of functions in parallel. Zero
+		/// means that they are emitted on a single thread.
+		uint64_t _backendGraphThreads = 0;
 		bool _backendNoOpts = false;
 		bool _backendEmitCfg = false;
 		bool _backendEmitCg = false;
@@ -180,6 +305,11 @@ class Parameters
 		bool _backendNoVarRenaming = false;
 		bool _backendNoCompoundOperators = false;
 		bool _backendNoSymbolicNames = false;
+		/// Release bodies of LLVM functions once they are converted into BIR.
+		bool _backendReleaseLlvmIr = false;
+		/// The back-end only saves the optimized module into the output BIR
+		/// snapshot, nothing is emitted.
+		bool _backendBirOnly = false;
 
 		retdec::common::Address _entryPoint;
 		retdec::common::Address _mainAddress;
@@ -13,6 +13,7 @@
 #include "retdec/cpdetect/errors.h"
 #include "retdec/cpdetect/heuristics/heuristics.h"
 #include "retdec/cpdetect/search.h"
+#include "retdec/cpdetect/signature_database.h"
 
 namespace retdec {
 namespace cpdetect {
@@ -25,12 +26,7 @@ class CompilerDetector : private retdec::utils::NonCopyable
 	private:
 		retdec::fileformat::FileFormat &fileParser;
 		DetectParams &cpParams;
-		std::vector<std::string> externalDatabase;
-
-		/// @name External databases parsing
-		/// @{
-		bool getExternalDatabases();
-		/// @}
+		const SignatureDatabase &database;
 
 		/// @name Other methods
 		/// @{
@@ -45,12 +41,6 @@ class CompilerDetector : private retdec::utils::NonCopyable
 		ReturnCode getAllCompilers();
 		/// @}
 
-	protected:
-		void populateInternalPaths(
-				const fs::path& dir,
-				const std::set<std::string>& formats,
-				const std::set<std::string>& archs);
-
 	protected:
 		/// results - detected tools
 		ToolInformation &toolInfo;
@@ -59,18 +49,18 @@ class CompilerDetector : private retdec::utils::NonCopyable
 		Search search;
 		/// class for heuristics detections
 		std::unique_ptr<Heuristics> heuristics;
-		/// internal rule database files
-		std::vector<std::string> internalPaths;
-		/// path to shared folder
-		fs::path pathToShared;
-		/// external database file suffixes
-		std::set<std::string> externalSuffixes;
+		/// formats of internal rules
+		std::set<std::string> formats;
+		/// architectures of internal rules
+		std::set<std::string> archs;
 
 	public:
 		CompilerDetector(
 				retdec::fileformat::FileFormat &parser,
 				DetectParams &params,
-				ToolInformation &toolInfo);
+				ToolInformation &toolInfo,
+				const SignatureDatabase &signatures
+						= SignatureDatabase::getDefault());
 
 		/// @name Detection methods
 		/// @{
@@ -7,7 +7,9 @@
 #ifndef RETDEC_CPDETECT_CPTYPES_H
 #define RETDEC_CPDETECT_CPTYPES_H
 
+#include <chrono>
 #include <limits>
+#include <utility>
 #include <vector>
 
 #include "retdec/cpdetect/settings.h"
@@ -218,6 +220,8 @@ struct ToolInformation
 	retdec::fileformat::Section epSection;
 	/// hexadecimal representation of entry point bytes
 	std::string epBytes;
+	/// time spent by each run heuristic, in order of evaluation
+	std::vector<std::pair<std::string, std::chrono::microseconds>> heuristicTimes;
 
 	/// @name Adding result methods
 	/// @{
@@ -7,6 +7,8 @@
 #ifndef RETDEC_CPDETECT_SEARCH_H
 #define RETDEC_CPDETECT_SEARCH_H
 
+#include <unordered_map>
+
 #include "retdec/cpdetect/cptypes.h"
 #include "retdec/fileformat/file_format/file_format.h"
 
@@ -54,9 +56,18 @@ class Search
 		/// @c true if search of patterns is supported for input file,
 		/// @c false otherwise
 		bool fileSupported;
+		/// strings whose occurrences are found by one pass over file
+		std::vector<std::string> indexedStrings;
+		/// sorted offsets of occurrences of indexed strings
+		mutable std::unordered_map<std::string, std::vector<std::size_t>> stringOffsets;
+		/// @c true if indexed strings were already searched
+		mutable bool stringsIndexed = false;
 
 		/// @name Auxiliary methods
 		/// @{
+		void buildStringIndex() const;
+		const std::vector<std::size_t>* getStringOffsets(
+				const std::string &str) const;
 		bool haveSlashes() const;
 		std::size_t nibblesFromBytes(std::size_t nBytes) const;
 		std::size_t bytesFromNibbles(std::size_t nNibbles) const;
@@ -114,6 +125,7 @@ class Search
 
 		/// @name Search methods based on plain-string comparison
 		/// @{
+		void indexStrings(const std::vector<std::string> &strs);
 		bool hasString(const std::string &str) const;
 		bool hasString(const std::string &str, std::size_t fileOffset) const;
 		bool hasString(
@@ -0,0 +1,81 @@
+/**
+ * @file include/retdec/cpdetect/signature_database.h
+ * @brief Database of YARA signatures shared by compiler detections.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_CPDETECT_SIGNATURE_DATABASE_H
+#define RETDEC_CPDETECT_SIGNATURE_DATABASE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "retdec/utils/filesystem.h"
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+
+namespace yaracpp {
+
+class YaraDetector;
+
+} // namespace yaracpp
+
+namespace cpdetect {
+
+/**
+ * SignatureDatabase - compiled YARA rules for compiler detection
+ *
+ * Rule files of each combination of formats and architectures are
+ * discovered and compiled only when they are requested for the first time.
+ * Compiled rules are never changed after that, so one database may be
+ * shared by all detections in process, even if they run in more threads.
+ */
+class SignatureDatabase : private retdec::utils::NonCopyable
+{
+	private:
+		/// directory with internal rules (formats/archs/files)
+		fs::path internalDir;
+		/// directory with external rules
+		fs::path externalDir;
+		/// rule file suffixes
+		std::set<std::string> suffixes;
+		/// guards lazy initialization of members below
+		mutable std::mutex mutex;
+		/// external rule files, @c nullptr if not searched yet
+		mutable std::unique_ptr<std::vector<std::string>> externalPaths;
+		/// compiled rules indexed by formats, architectures and externals
+		mutable std::map<std::string, std::unique_ptr<yaracpp::YaraDetector>> rules;
+
+		/// @name Auxiliary methods
+		/// @{
+		std::vector<std::string> findInternalPaths(
+				const std::set<std::string>& formats,
+				const std::set<std::string>& archs) const;
+		std::vector<std::string> findExternalPaths() const;
+		/// @}
+	public:
+		SignatureDatabase(
+				const fs::path& internalRulesDir,
+				const fs::path& externalRulesDir = fs::path("."));
+		~SignatureDatabase();
+
+		/// @name Getters
+		/// @{
+		const yaracpp::YaraDetector* getRules(
+				const std::set<std::string>& formats,
+				const std::set<std::string>& archs,
+				bool external) const;
+		/// @}
+
+		static const SignatureDatabase& getDefault();
+};
+
+} // namespace cpdetect
+} // namespace retdec
+
+#endif
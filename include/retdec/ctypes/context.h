@@ -7,9 +7,10 @@
 #ifndef RETDEC_CTYPES_CONTEXT_H
 #define RETDEC_CTYPES_CONTEXT_H
 
-#include <map>
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 
@@ -95,9 +96,17 @@ class Context
 		/// Stored functions.
 		Functions functions;
 
-		using FunctionTypes = std::map<
-			std::tuple<std::shared_ptr<Type>, FunctionType::Parameters, std::string, bool>,
-			std::shared_ptr<FunctionType>
+		using FunctionTypeKey = std::tuple<
+			std::shared_ptr<Type>, FunctionType::Parameters, std::string, bool>;
+		/// Hash of function type keys, types are hashed by their addresses.
+		struct FunctionTypeKeyHash
+		{
+			std::size_t operator()(const FunctionTypeKey &key) const;
+		};
+		using FunctionTypes = std::unordered_map<
+			FunctionTypeKey,
+			std::shared_ptr<FunctionType>,
+			FunctionTypeKeyHash
 		>;
 		/// Stored function types, key is return type and parameters' types.
 		FunctionTypes functionTypes;
@@ -116,9 +125,17 @@ class Context
 		/// Stored reference types, key is type that they reference.
 		ReferenceTypes referenceTypes;
 
-		using ArrayTypes = std::map<
-				std::pair<std::shared_ptr<Type>, ArrayType::Dimensions>,
-				std::shared_ptr<ArrayType>
+		using ArrayTypeKey = std::pair<
+			std::shared_ptr<Type>, ArrayType::Dimensions>;
+		/// Hash of array type keys, types are hashed by their addresses.
+		struct ArrayTypeKeyHash
+		{
+			std::size_t operator()(const ArrayTypeKey &key) const;
+		};
+		using ArrayTypes = std::unordered_map<
+			ArrayTypeKey,
+			std::shared_ptr<ArrayType>,
+			ArrayTypeKeyHash
 		>;
 		/// Stored array types, key is element type and dimensions
 		ArrayTypes arrayTypes;
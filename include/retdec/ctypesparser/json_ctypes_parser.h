@@ -10,6 +10,7 @@
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <rapidjson/document.h>
 
@@ -37,6 +38,17 @@ class JSONCTypesParser: public CTypesParser
 			const TypeWidths &typeWidths = {},
 			const retdec::ctypes::CallConvention &callConvention = retdec::ctypes::CallConvention());
 
+		/// @name Lazy parsing.
+		/// @{
+		void loadIndex(
+			std::istream &stream,
+			const std::shared_ptr<retdec::ctypes::Context> &context,
+			const TypeWidths &typeWidths = {},
+			const retdec::ctypes::CallConvention &callConvention = retdec::ctypes::CallConvention());
+		std::shared_ptr<retdec::ctypes::Function> parseIndexedFunction(
+			const std::string &name);
+		/// @}
+
 	private:
 		std::string loadJson(std::istream &stream) const;
 		std::unique_ptr<rapidjson::Document> parseJson(char *buffer) const;
@@ -44,6 +56,9 @@ class JSONCTypesParser: public CTypesParser
 			const std::unique_ptr<rapidjson::Document> &root,
 			std::unique_ptr<retdec::ctypes::Module> &module);
 		void addTypesToMap(const rapidjson::Value &types);
+		void indexJson(const std::string &json);
+		const rapidjson::Value &getJsonType(const std::string &typeKey);
+		const rapidjson::Value &parseIndexedEntry(const std::pair<std::size_t, std::size_t> &entry);
 
 		/// @name Parsing methods.
 		/// @{
@@ -128,7 +143,9 @@ class JSONCTypesParser: public CTypesParser
 
 	private:
 		using ParserContext = std::unordered_map<std::string, std::shared_ptr<retdec::ctypes::Type>>;
-		using TypesMap = std::unordered_map<std::string, rapidjson::Value::ConstMemberIterator>;
+		using TypesMap = std::unordered_map<std::string, const rapidjson::Value*>;
+		/// <entry name, <offset of entry's JSON object, its end>>
+		using JsonIndex = std::unordered_map<std::string, std::pair<std::size_t, std::size_t>>;
 
 	private:
 		/// Context for the parser (to speedup the parsing).
@@ -139,6 +156,16 @@ class JSONCTypesParser: public CTypesParser
 
 		/// Call convention used when JSON does not contain one.
 		retdec::ctypes::CallConvention defaultCallConv;
+
+		/// JSON loaded by @c loadIndex().
+		std::string indexedJson;
+
+		/// Offsets of functions and types in @c indexedJson.
+		JsonIndex functionsIndex;
+		JsonIndex typesIndex;
+
+		/// Types of @c indexedJson parsed so far, @c typesMap points to them.
+		std::vector<std::unique_ptr<rapidjson::Document>> indexedTypes;
 };
 
 } // namespace ctypesparser
@@ -40,7 +40,8 @@ class DebugFormat
 				retdec::loader::Image* inFile,
 				const std::string& pdbFile,
 				SymbolTable* symtab,
-				retdec::demangler::Demangler* demangler
+				retdec::demangler::Demangler* demangler,
+				unsigned threads = 1
 		);
 
 		retdec::common::Function* getFunction(retdec::common::Address a);
@@ -48,6 +49,20 @@ class DebugFormat
 
 		bool hasInformation() const;
 
+	private:
+		/// Results of loading of one DWARF compilation unit.
+		struct DwarfUnit
+		{
+			/// Line table of the unit, @c nullptr if there is none.
+			const llvm::DWARFDebugLine::LineTable* lines = nullptr;
+			/// Types of the unit's DIEs indexed by their offsets (cache).
+			std::map<uint64_t, std::string> dieOff2type;
+			/// Functions with linkage names not demangled yet.
+			std::vector<retdec::common::Function> functions;
+			std::vector<retdec::common::Object> globals;
+			std::vector<std::string> types;
+		};
+
 	private:
 		void loadPdb();
 		void loadPdbTypes();
@@ -56,14 +71,19 @@ class DebugFormat
 		retdec::common::Type loadPdbType(retdec::pdbparser::PDBTypeDef* type);
 
 		void loadDwarf();
-		void loadDwarf_CU(llvm::DWARFDie die);
-		retdec::common::Function loadDwarf_subprogram(llvm::DWARFDie die);
-		std::string loadDwarf_type(llvm::DWARFDie die);
-		std::string _loadDwarf_type(llvm::DWARFDie die);
+		void loadDwarf_CU(llvm::DWARFDie die, DwarfUnit& u) const;
+		retdec::common::Function loadDwarf_subprogram(
+				llvm::DWARFDie die,
+				DwarfUnit& u) const;
+		std::string loadDwarf_type(llvm::DWARFDie die, DwarfUnit& u) const;
+		std::string _loadDwarf_type(llvm::DWARFDie die, DwarfUnit& u) const;
 		retdec::common::Object loadDwarf_formal_parameter(
 				llvm::DWARFDie die,
-				unsigned argCntr);
-		retdec::common::Object loadDwarf_variable(llvm::DWARFDie die);
+				unsigned argCntr,
+				DwarfUnit& u) const;
+		retdec::common::Object loadDwarf_variable(
+				llvm::DWARFDie die,
+				DwarfUnit& u) const;
 
 		void loadSymtab();
 
@@ -74,13 +94,12 @@ class DebugFormat
 		SymbolTable* _symtab = nullptr;
 		/// Underlying binary file representation.
 		retdec::loader::Image* _inFile = nullptr;
-		/// Underlying PDB representation.
+		/// Underlying PDB representation, available only during loading.
 		retdec::pdbparser::PDBFile* _pdbFile = nullptr;
 		/// Demangler.
 		retdec::demangler::Demangler* _demangler = nullptr;
-
-		/// Dwarf named types cache.
-		std::map<std::pair<llvm::DWARFUnit*, uint32_t>, std::string> dieOff2type;
+		/// Number of threads loading DWARF compilation units.
+		unsigned _threads = 1;
 
 	public:
 		retdec::common::GlobalVarContainer globals;
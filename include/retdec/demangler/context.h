@@ -7,8 +7,12 @@
 #ifndef RETDEC_CONTEXT_H
 #define RETDEC_CONTEXT_H
 
+#include <functional>
 #include <memory>
-#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 
 namespace retdec {
 namespace demangler {
@@ -178,69 +182,105 @@ public:
 	/// @}
 
 private:
-	using BuiltInTypeNodes = std::map<
+	/**
+	 * @brief Hash of keys of the caches.
+	 *
+	 * Elements of tuples are hashed separately and combined.
+	 */
+	struct KeyHash
+	{
+		template <typename T>
+		std::size_t operator()(const T &key) const
+		{
+			return std::hash<T>()(key);
+		}
+
+		template <typename... Ts>
+		std::size_t operator()(const std::tuple<Ts...> &key) const
+		{
+			std::size_t seed = 0;
+			std::apply([&seed](const auto &... items) {
+				((seed ^= std::hash<std::decay_t<decltype(items)>>()(items)
+					+ 0x9e3779b9 + (seed << 6) + (seed >> 2)), ...);
+			}, key);
+			return seed;
+		}
+	};
+
+	using BuiltInTypeNodes = std::unordered_map<
 		std::tuple<std::string, bool, bool>,
-		std::shared_ptr<BuiltInTypeNode>
+		std::shared_ptr<BuiltInTypeNode>,
+		KeyHash
 	>;
 	BuiltInTypeNodes builtInTypes;
 
-	using CharTypeNodes = std::map<
+	using CharTypeNodes = std::unordered_map<
 		std::tuple<ThreeStateSignedness, bool, bool>,
-		std::shared_ptr<CharTypeNode>
+		std::shared_ptr<CharTypeNode>,
+		KeyHash
 	>;
 	CharTypeNodes charTypes;
 
-	using IntegralTypeNodes = std::map<
+	using IntegralTypeNodes = std::unordered_map<
 		std::tuple<std::string, bool, bool, bool>,
-		std::shared_ptr<IntegralTypeNode>
+		std::shared_ptr<IntegralTypeNode>,
+		KeyHash
 	>;
 	IntegralTypeNodes integralTypes;
 
-	using PointerTypeNodes = std::map<
+	using PointerTypeNodes = std::unordered_map<
 		std::tuple<std::shared_ptr<Node>, bool, bool>,
-		std::shared_ptr<PointerTypeNode>
+		std::shared_ptr<PointerTypeNode>,
+		KeyHash
 	>;
 	PointerTypeNodes pointerTypes;
 
-	using ReferenceTypeNodes = std::map<
+	using ReferenceTypeNodes = std::unordered_map<
 		std::shared_ptr<Node>,
-		std::shared_ptr<ReferenceTypeNode>
+		std::shared_ptr<ReferenceTypeNode>,
+		KeyHash
 	>;
 	ReferenceTypeNodes referenceTypes;
 
-	using RReferenceTypeNodes = std::map<
+	using RReferenceTypeNodes = std::unordered_map<
 		std::shared_ptr<Node>,
-		std::shared_ptr<RReferenceTypeNode>
+		std::shared_ptr<RReferenceTypeNode>,
+		KeyHash
 	>;
 	RReferenceTypeNodes rReferenceTypes;
 
-	using NamedTypeNodes = std::map<
+	using NamedTypeNodes = std::unordered_map<
 		std::tuple<std::string, bool, bool>,
-		std::shared_ptr<NamedTypeNode>
+		std::shared_ptr<NamedTypeNode>,
+		KeyHash
 	>;
 	NamedTypeNodes namedTypes;
 
-	using FunctionNodes = std::map<
+	using FunctionNodes = std::unordered_map<
 		std::string,
-		std::shared_ptr<Node>
+		std::shared_ptr<Node>,
+		KeyHash
 	>;
 	FunctionNodes functions;
 
-	using NameNodes = std::map<
+	using NameNodes = std::unordered_map<
 		std::string,
-		std::shared_ptr<NameNode>
+		std::shared_ptr<NameNode>,
+		KeyHash
 	>;
 	NameNodes nameNodes;
 
-	using NestedNameNodes =std::map<
+	using NestedNameNodes = std::unordered_map<
 		std::tuple<std::shared_ptr<Node>, std::shared_ptr<Node>>,
-		std::shared_ptr<NestedNameNode>
+		std::shared_ptr<NestedNameNode>,
+		KeyHash
 	>;
 	NestedNameNodes nestedNameNodes;
 
-	using ArrayNodes = std::map<
+	using ArrayNodes = std::unordered_map<
 		std::tuple<std::shared_ptr<Node>, unsigned, bool, bool>,
-		std::shared_ptr<ArrayNode>
+		std::shared_ptr<ArrayNode>,
+		KeyHash
 	>;
 	ArrayNodes arrayNodes;
 
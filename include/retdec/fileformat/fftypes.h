@@ -71,9 +71,16 @@ enum LoadFlags
 	NONE              = 0,
 	NO_FILE_HASHES    = 1,
 	NO_VERBOSE_HASHES = 2,
-	DETECT_STRINGS    = 4
+	DETECT_STRINGS    = 4,
+	NO_CERTIFICATES   = 8,
+	NO_ANOMALIES      = 16,
+	BOUNDED_MEMORY    = 32
 };
 
+/// Files loaded with @c LoadFlags::BOUNDED_MEMORY that are longer than this
+/// are loaded only up to this length, the rest is read in chunks when needed.
+const std::size_t BOUNDED_MEMORY_LOAD_LIMIT = 256 * 1024 * 1024;
+
 } // namespace fileformat
 } // namespace retdec
 
@@ -15,6 +15,8 @@
 #include <utility>
 #include <vector>
 
+#include <llvm/ADT/ArrayRef.h>
+
 #include "retdec/utils/byte_value_storage.h"
 #include "retdec/utils/non_copyable.h"
 #include "retdec/fileformat/fftypes.h"
@@ -46,6 +48,7 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		std::istream auxIStream;                 ///< auxiliary input stream
 		std::vector<unsigned char> *loadedBytes; ///< reference to serialized content of input file
 		LoadFlags loadFlags;                     ///< load flags for configurable file loading
+		std::size_t inputFileLength = 0;         ///< length of the whole input file
 
 		/// @name Initialization methods
 		/// @{
@@ -57,6 +60,13 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		/// @{
 		virtual std::size_t initSectionTableHashOffsets() = 0;
 		/// @}
+
+		/// @name Virtual on-demand loading methods
+		/// @{
+		virtual void loadCertificates();
+		virtual void loadDeferredTables();
+		virtual void loadUnwindFunctions();
+		/// @}
 	protected:
 		std::string crc32;                                                ///< CRC32 of file content
 		std::string md5;                                                  ///< MD5 of file content
@@ -82,6 +92,8 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		RichHeader *richHeader;                                           ///< rich header
 		PdbInfo *pdbInfo;                                                 ///< information about related PDB debug file
 		CertificateTable *certificateTable;                               ///< table of certificates
+		bool certificateTableLoaded;                                      ///< @c true if certificates were already loaded
+		bool deferredTablesLoaded;                                        ///< @c true if deferred symbol, import and export tables were already loaded
 		TlsInfo *tlsInfo;                                                 ///< thread-local information
 		ElfCoreInfo *elfCoreInfo;                                         ///< information about core file structures
 		Format fileFormat;                                                ///< format of input file
@@ -90,6 +102,8 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		std::vector<std::pair<std::size_t, std::size_t>> secHashInfo;     ///< information for calculation of section table hash
 		std::optional<bool> signatureVerified;                            ///< indicates whether the signature is present and also verified
 		retdec::common::RangeContainer<std::uint64_t> nonDecodableRanges;  ///< Address ranges which should not be decoded for instructions.
+		std::vector<retdec::common::Range<std::uint64_t>> unwindFunctions; ///< function ranges from unwind information
+		bool unwindFunctionsLoaded;                                       ///< @c true if function ranges from unwind information were already loaded
 		std::vector<std::pair<std::string, std::string>> anomalies;       ///< file format anomalies
 
 		/// @name Clear methods
@@ -102,6 +116,11 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		void computeSectionTableHashes();
 		/// @}
 
+		/// @name On-demand loading
+		/// @{
+		void ensureDeferredTablesLoaded() const;
+		/// @}
+
 		/// @name Setters
 		/// @{
 		void setLoadedBytes(std::vector<unsigned char> *lBytes);
@@ -198,6 +217,8 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		std::size_t getNumberOfDynamicTables() const;
 		std::size_t getFileLength() const;
 		std::size_t getLoadedFileLength() const;
+		std::size_t getInputFileLength() const;
+		bool isLoadedPartially() const;
 		std::size_t getOverlaySize() const;
 		bool getOverlayEntropy(double &res) const;
 		std::size_t nibblesFromBytes(std::size_t bytes) const;
@@ -207,6 +228,8 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		bool getAddressFromOffset(std::uint64_t &result, std::uint64_t offset) const;
 		bool getBytes(std::vector<std::uint8_t> &result, unsigned long long offset, unsigned long long numberOfBytes) const;
 		bool getEpBytes(std::vector<std::uint8_t> &result, unsigned long long numberOfBytes) const;
+		llvm::ArrayRef<std::uint8_t> getBytesRef(unsigned long long offset, unsigned long long numberOfBytes) const;
+		llvm::ArrayRef<std::uint8_t> getEpBytesRef(unsigned long long numberOfBytes) const;
 		bool getHexBytes(std::string &result, unsigned long long offset, unsigned long long numberOfBytes) const;
 		bool getHexEpBytes(std::string &result, unsigned long long numberOfBytes) const;
 		bool getHexBytesFromEnd(std::string &result, unsigned long long numberOfBytes) const;
@@ -248,6 +271,7 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		bool isSignaturePresent() const;
 		bool isSignatureVerified() const;
 		const retdec::common::RangeContainer<std::uint64_t>& getNonDecodableAddressRanges() const;
+		const std::vector<retdec::common::Range<std::uint64_t>>& getUnwindFunctionRanges() const;
 		/// @}
 
 		/// @name Containers
@@ -273,6 +297,7 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		/// @{
 		virtual bool getXByte(std::uint64_t address, std::uint64_t x, std::uint64_t &res, retdec::utils::Endianness e = retdec::utils::Endianness::UNKNOWN) const override;
 		virtual bool getXBytes(std::uint64_t address, std::uint64_t x, std::vector<std::uint8_t> &res) const override;
+		llvm::ArrayRef<std::uint8_t> getXBytesRef(std::uint64_t address, std::uint64_t x) const;
 		virtual bool setXByte(std::uint64_t address, std::uint64_t x, std::uint64_t val, retdec::utils::Endianness e = retdec::utils::Endianness::UNKNOWN) override;
 		virtual bool setXBytes(std::uint64_t address, const std::vector<std::uint8_t> &val) override;
 		bool isPointer(unsigned long long address, std::uint64_t* pointer = nullptr) const;
@@ -287,6 +312,7 @@ class FileFormat : public retdec::utils::ByteValueStorage, private retdec::utils
 		bool get10ByteOffset(std::uint64_t offset, long double &res) const;
 		bool getXByteOffset(std::uint64_t offset, std::uint64_t x, std::uint64_t &res, retdec::utils::Endianness e = retdec::utils::Endianness::UNKNOWN) const;
 		bool getXBytesOffset(std::uint64_t offset, std::uint64_t x, std::vector<std::uint8_t> &res) const;
+		llvm::ArrayRef<std::uint8_t> getXBytesOffsetRef(std::uint64_t offset, std::uint64_t x) const;
 		bool getWordOffset(std::uint64_t offset, std::uint64_t &res, retdec::utils::Endianness e = retdec::utils::Endianness::UNKNOWN) const;
 		bool getNTBSOffset(std::uint64_t offset, std::string &res, std::size_t size = 0) const;
 		bool getNTWSOffset(std::uint64_t offset, std::size_t width, std::vector<std::uint64_t> &res) const;
@@ -58,6 +58,7 @@ class IntelHexParser
 		/// @{
 		bool parse();
 		void handleData(const IntelHexToken &token);
+		void appendData(const std::string &data);
 		void setOffset(const IntelHexToken &token);
 		void setSegment(const IntelHexToken &token);
 		void setEIP(const IntelHexToken &token);
@@ -82,6 +83,7 @@ class IntelHexParser
 		/// @name Hexadecimal conversions
 		/// @{
 		static unsigned long long strToInt(const std::string &str);
+		static unsigned char hexPairToByte(const char *str);
 		static bool isHexadec(char c);
 		static bool isHexadec(const std::string &vec);
 		/// @}
@@ -38,6 +38,7 @@ class MachOFormat : public FileFormat
 		std::size_t segmentCounter = 0;                                ///< number of section commands found
 		std::vector<MachOSymbol> symbols;                              ///< temporary symbol representation
 		std::vector<unsigned long long> indirectTable;                 ///< indirect table for import addresses
+		std::vector<llvm::object::MachOObjectFile::LoadCommandInfo> deferredCommands; ///< symbol, import and export commands loaded on demand
 		llvm::MachO::mach_header header32;                             ///< 32 bit Mach-O header
 		llvm::MachO::mach_header_64 header64;                          ///< 64 bit Mach-O header
 		llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> fileBuffer; ///< LLVM buffer of input file
@@ -94,6 +95,7 @@ class MachOFormat : public FileFormat
 		std::uint32_t getNumberOfCommands() const;
 		std::uint32_t getFirstCommandOffset() const;
 		void loadCommands();
+		virtual void loadDeferredTables() override;
 		void dumpCommands(std::ostream &outStream);
 		/// @}
 
@@ -40,6 +40,7 @@ class PeFormat : public FileFormat
 		std::string typeLibId;                                     ///< .NET type lib ID
 		std::vector<std::shared_ptr<DotnetClass>> definedClasses;  ///< .NET defined class list
 		std::vector<std::shared_ptr<DotnetClass>> importedClasses; ///< .NET imported class list
+		bool dotnetTypesDetected;                                  ///< @c true if .NET types were already reconstructed
 		std::string typeRefHashCrc32;                              ///< .NET typeref table hash as CRC32
 		std::string typeRefHashMd5;                                ///< .NET typeref table hash as MD5
 		std::string typeRefHashSha256;                             ///< .NET typeref table hash as SHA256
@@ -73,7 +74,8 @@ class PeFormat : public FileFormat
 		void loadPdbInfo();
 		void loadResourceNodes(std::vector<const PeLib::ResourceChild*> &nodes, const std::vector<std::size_t> &levels);
 		void loadResources();
-		void loadCertificates();
+		virtual void loadCertificates() override;
+		virtual void loadUnwindFunctions() override;
 		void loadTlsInformation();
 		static bool checkDefaultList(std::string_view);
 		/// @}
@@ -10,6 +10,8 @@
 #include <cstdint>
 #include <unordered_map>
 
+#include <llvm/ADT/ArrayRef.h>
+
 #include "retdec/fileformat/types/dotnet_headers/stream.h"
 
 namespace retdec {
@@ -23,6 +25,7 @@ class BlobStream : public Stream
 		BlobStream(std::vector<std::uint8_t> data, std::uint64_t streamOffset, std::uint64_t streamSize);
 
 		std::vector<std::uint8_t> getElement(std::size_t offset) const;
+		llvm::ArrayRef<std::uint8_t> getElementRef(std::size_t offset) const;
 };
 
 } // namespace fileformat
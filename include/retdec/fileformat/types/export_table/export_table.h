@@ -22,10 +22,16 @@ class ExportTable
 	private:
 		using exportsIterator = std::vector<Export>::const_iterator;
 		std::vector<Export> exports;                ///< stored exports
-		std::string expHashCrc32;                   ///< exphash CRC32
-		std::string expHashMd5;                     ///< exphash MD5
-		std::string expHashSha256;                  ///< exphash SHA256
+		bool hashesEnabled = false;                 ///< @c true if exphashes should be provided
+		mutable bool expHashInputValid = false;     ///< @c true if @c expHashInput is up to date
+		mutable std::vector<std::uint8_t> expHashInput; ///< data exphashes are computed from
+		mutable std::string expHashCrc32;           ///< exphash CRC32 (computed on first use)
+		mutable std::string expHashMd5;             ///< exphash MD5 (computed on first use)
+		mutable std::string expHashSha256;          ///< exphash SHA256 (computed on first use)
 		std::string dllName;
+
+		const std::vector<std::uint8_t>& getExpHashInput() const;
+		void invalidateHashes();
 	public:
 		/// @name Setters
 		/// @{
@@ -52,7 +58,7 @@ class ExportTable
 
 		/// @name Other methods
 		/// @{
-		void computeHashes();
+		void enableHashes();
 		void clear();
 		void addExport(Export &newExport);
 		bool hasExports() const;
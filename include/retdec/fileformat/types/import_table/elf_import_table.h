@@ -12,8 +12,8 @@ namespace fileformat {
 
 class ElfImportTable : public ImportTable
 {
-public:
-	void computeHashes() override;
+protected:
+	std::string getImpHashInput() const override;
 };
 
 } // namespace fileformat
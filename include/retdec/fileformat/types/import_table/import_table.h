@@ -25,10 +25,19 @@ class ImportTable
 		std::vector<std::string> libraries;           ///< name of libraries
 		std::vector<std::string> missingDeps;         ///< missing dependencies
 		std::vector<std::unique_ptr<Import>> imports; ///< stored imports
-		std::string impHashCrc32;                     ///< imphash CRC32
-		std::string impHashMd5;                       ///< imphash MD5
-		std::string impHashSha256;                    ///< imphash SHA256
-		std::string impHashTlsh;
+
+		virtual std::string getImpHashInput() const;
+	private:
+		bool hashesEnabled = false;                   ///< @c true if imphashes should be provided
+		mutable bool impHashInputValid = false;       ///< @c true if @c impHashInput is up to date
+		mutable std::string impHashInput;             ///< data imphashes are computed from
+		mutable std::string impHashCrc32;             ///< imphash CRC32 (computed on first use)
+		mutable std::string impHashMd5;               ///< imphash MD5 (computed on first use)
+		mutable std::string impHashSha256;            ///< imphash SHA256 (computed on first use)
+		mutable std::string impHashTlsh;              ///< imphash TLSH (computed on first use)
+
+		const std::string& getCachedImpHashInput() const;
+		void invalidateHashes();
 	public:
 		/// @name Getters
 		/// @{
@@ -57,7 +66,7 @@ class ImportTable
 
 		/// @name Other methods
 		/// @{
-		virtual void computeHashes();
+		void enableHashes();
 		void clear();
 		void addLibrary(std::string name, bool missingDependency = false);
 		void addImport(std::unique_ptr<Import>&& import);
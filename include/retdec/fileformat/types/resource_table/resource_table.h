@@ -46,12 +46,18 @@ class ResourceTable
 		std::vector<ResourceIcon *> icons;                           ///< icons
 		std::vector<std::pair<std::string, std::string>> languages;  ///< supported languages, LCID and code page
 		std::vector<std::pair<std::string, std::string>> strings;    ///< version info strings
-		std::string iconHashCrc32;                                   ///< iconhash CRC32
-		std::string iconHashMd5;                                     ///< iconhash MD5
-		std::string iconHashSha256;                                  ///< iconhash SHA256
-		std::string iconPerceptualAvgHash;                           ///< icon perceptual hash AvgHash
+		bool iconHashesEnabled = false;                              ///< @c true if iconhashes should be provided
+		mutable bool iconHashInputValid = false;                     ///< @c true if @c iconHashInput is up to date
+		mutable std::vector<std::uint8_t> iconHashInput;             ///< data iconhashes are computed from
+		mutable std::string iconHashCrc32;                           ///< iconhash CRC32 (computed on first use)
+		mutable std::string iconHashMd5;                             ///< iconhash MD5 (computed on first use)
+		mutable std::string iconHashSha256;                          ///< iconhash SHA256 (computed on first use)
+		mutable bool iconPerceptualAvgHashValid = false;             ///< @c true if @c iconPerceptualAvgHash is up to date
+		mutable std::string iconPerceptualAvgHash;                   ///< icon perceptual hash AvgHash (computed on first use)
 
 		std::string computePerceptualAvgHash(const ResourceIcon &icon) const;
+		const std::vector<std::uint8_t>& getIconHashInput() const;
+		void invalidateIconHashes();
 		bool parseVersionInfo(const std::vector<std::uint8_t> &bytes);
 		bool parseVersionInfoChild(const std::vector<std::uint8_t> &bytes, std::size_t &offset);
 		bool parseVarFileInfoChild(const std::vector<std::uint8_t> &bytes, std::size_t &offset);
@@ -90,7 +96,7 @@ class ResourceTable
 
 		/// @name Other methods
 		/// @{
-		void computeIconHashes();
+		void enableIconHashes();
 		void parseVersionInfoResources();
 		void clear();
 		void addResource(std::unique_ptr<Resource>&& newResource);
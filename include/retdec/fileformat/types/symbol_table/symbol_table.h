@@ -25,6 +25,11 @@ class SymbolTable
 		using symbolsIterator = std::vector<std::shared_ptr<Symbol>>::iterator;
 		std::vector<std::shared_ptr<Symbol>> table; ///< stored symbols
 		std::string name;                           ///< name of symbol table
+		/// (address, position in @c table) of symbols with an address, sorted
+		mutable std::vector<std::pair<unsigned long long, std::size_t>> addressIndex;
+		mutable bool addressIndexValid = false;     ///< @c true if @c addressIndex is up to date
+
+		std::size_t findSymbolOnAddress(unsigned long long addr) const;
 	public:
 		/// @name Const getters
 		/// @{
@@ -8,6 +8,7 @@
 #define RETDEC_FILEFORMAT_UTILS_CRYPTO_H
 
 #include <cstdint>
+#include <istream>
 #include <string>
 
 namespace retdec {
@@ -17,6 +18,17 @@ std::string getCrc32(const unsigned char *data, std::uint64_t length);
 std::string getMd5(const unsigned char *data, std::uint64_t length);
 std::string getSha1(const unsigned char *data, std::uint64_t length);
 std::string getSha256(const unsigned char *data, std::uint64_t length);
+void getCrc32Md5Sha256(
+		const unsigned char *data,
+		std::uint64_t length,
+		std::string &crc32,
+		std::string &md5,
+		std::string &sha256);
+bool getCrc32Md5Sha256(
+		std::istream &stream,
+		std::string &crc32,
+		std::string &md5,
+		std::string &sha256);
 
 } // namespace fileformat
 } // namespace retdec
@@ -7,11 +7,29 @@
 #ifndef RETDEC_FILEFORMAT_UTILS_FORMAT_DETECTION_H
 #define RETDEC_FILEFORMAT_UTILS_FORMAT_DETECTION_H
 
+#include "retdec/utils/byte_value_storage.h"
 #include "retdec/fileformat/fftypes.h"
 
 namespace retdec {
 namespace fileformat {
 
+/**
+ * Basic information about input file which can be read from its headers
+ * without parsing the whole file.
+ */
+struct FormatSummary
+{
+	Format format = Format::UNDETECTABLE;
+	Architecture architecture = Architecture::UNKNOWN;
+	retdec::utils::Endianness endianness = retdec::utils::Endianness::UNKNOWN;
+	std::size_t bitness = 0;           ///< 0 if unknown
+	bool hasEntryPoint = false;
+	std::uint64_t entryPoint = 0;      ///< virtual address of the entry point
+	bool hasOverlay = false;
+	std::uint64_t overlayOffset = 0;   ///< offset of data after the last section (PE only)
+	bool isPackedHint = false;         ///< headers look like a packed file
+};
+
 Format detectFileFormat(
 		const std::string& filePath,
 		bool isRaw = false);
@@ -25,6 +43,19 @@ Format detectFileFormat(
 		std::size_t size,
 		bool isRaw = false);
 
+FormatSummary detectFileFormatSummary(
+		const std::string& filePath,
+		bool isRaw = false);
+
+FormatSummary detectFileFormatSummary(
+		std::istream &inputStream,
+		bool isRaw = false);
+
+FormatSummary detectFileFormatSummary(
+		const std::uint8_t* data,
+		std::size_t size,
+		bool isRaw = false);
+
 } // namespace fileformat
 } // namespace retdec
 
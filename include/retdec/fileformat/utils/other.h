@@ -7,6 +7,8 @@
 #ifndef RETDEC_FILEFORMAT_UTILS_OTHER_H
 #define RETDEC_FILEFORMAT_UTILS_OTHER_H
 
+#include <cstdint>
+#include <istream>
 #include <string>
 #include <vector>
 
@@ -22,6 +24,7 @@ std::vector<std::string> getSupportedArchitectures();
 std::string lcidToStr(std::size_t lcid);
 std::string codePageToStr(std::size_t cpage);
 double computeDataEntropy(const std::uint8_t *data, std::size_t dataLen);
+bool computeDataEntropy(std::istream &stream, std::uint64_t offset, std::uint64_t size, double &res);
 
 } // namespace fileformat
 } // namespace retdec
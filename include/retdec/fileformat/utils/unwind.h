@@ -0,0 +1,28 @@
+/**
+ * @file include/retdec/fileformat/utils/unwind.h
+ * @brief Function ranges from unwind information.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_FILEFORMAT_UTILS_UNWIND_H
+#define RETDEC_FILEFORMAT_UTILS_UNWIND_H
+
+#include <cstdint>
+#include <vector>
+
+#include "retdec/common/range.h"
+
+namespace retdec {
+namespace fileformat {
+
+std::vector<retdec::common::Range<std::uint64_t>> parseEhFrame(
+		const std::uint8_t *data,
+		std::size_t size,
+		std::uint64_t address,
+		bool littleEndian,
+		std::size_t wordSize);
+
+} // namespace fileformat
+} // namespace retdec
+
+#endif
@@ -7,9 +7,10 @@
 #ifndef RETDEC_LLVMIR_EMUL_LLVMIR_EMUL_H
 #define RETDEC_LLVMIR_EMUL_LLVMIR_EMUL_H
 
+#include <functional>
 #include <list>
-#include <map>
 #include <set>
+#include <unordered_map>
 
 #include <llvm/CodeGen/IntrinsicLowering.h>
 #include <llvm/ExecutionEngine/GenericValue.h>
@@ -75,6 +76,9 @@ class LocalExecutionContext;
  *    and 2 byte integer value is stored to 0x1002, right now these two values
  *    are both separate entries in the memory map and do not affect each other,
  *    even though they should.
+ *
+ * Memory, globals and values are accessed by every emulated load, store and
+ * instruction, so they are kept in hash maps rather than ordered ones.
  */
 class GlobalExecutionContext
 {
@@ -99,11 +103,11 @@ class GlobalExecutionContext
 	public:
 		llvm::Module* _module = nullptr;
 
-		std::map<uint64_t, llvm::GenericValue> memory;
+		std::unordered_map<uint64_t, llvm::GenericValue> memory;
 		std::list<uint64_t> memoryLoads;
 		std::list<uint64_t> memoryStores;
 
-		std::map<llvm::GlobalVariable*, llvm::GenericValue> globals;
+		std::unordered_map<llvm::GlobalVariable*, llvm::GenericValue> globals;
 		std::list<llvm::GlobalVariable*> globalsLoads;
 		std::list<llvm::GlobalVariable*> globalsStores;
 
@@ -113,7 +117,7 @@ class GlobalExecutionContext
 		/// However, we want to provide this information to the user of this
 		/// library after emulation is done, so we need to preserve it for all
 		/// emulated objects and not to thorw it away after local frame is left.
-		std::map<llvm::Value*, llvm::GenericValue> values;
+		std::unordered_map<llvm::Value*, llvm::GenericValue> values;
 };
 
 class LocalExecutionContext
@@ -158,6 +162,38 @@ class LlvmIrEmulator : public llvm::InstVisitor<LlvmIrEmulator>
 				llvm::Function* f,
 				const llvm::ArrayRef<llvm::GenericValue> argVals = {});
 
+	// Snapshots and batch emulation.
+	//
+	public:
+		/**
+		 * Emulation state saved by @c saveSnapshot(): memory, globals and
+		 * values with logs of their accesses, visited instructions and
+		 * basic blocks, calls, and the exit value.
+		 */
+		class Snapshot
+		{
+			private:
+				Snapshot(const LlvmIrEmulator& emu);
+
+			private:
+				GlobalExecutionContext _globalEc;
+				llvm::GenericValue _exitValue;
+				std::list<llvm::Instruction*> _visitedInsns;
+				std::list<llvm::BasicBlock*> _visitedBbs;
+				std::list<CallEntry> _calls;
+				std::size_t _ecStackRetiredSize = 0;
+
+			friend class LlvmIrEmulator;
+		};
+
+		Snapshot saveSnapshot() const;
+		void restoreSnapshot(const Snapshot& s);
+
+		std::vector<llvm::GenericValue> runFunctionBatch(
+				llvm::Function* f,
+				const std::vector<std::vector<llvm::GenericValue>>& argVals,
+				const std::function<void(std::size_t)>& afterRun = nullptr);
+
 	// Emulation query methods.
 	//
 	public:
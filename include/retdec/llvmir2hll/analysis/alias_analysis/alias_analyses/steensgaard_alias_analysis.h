@@ -0,0 +1,95 @@
+/**
+* @file include/retdec/llvmir2hll/analysis/alias_analysis/alias_analyses/steensgaard_alias_analysis.h
+* @brief A unification-based (Steensgaard-style) alias analysis.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_ANALYSIS_ALIAS_ANALYSIS_ALIAS_ANALYSES_STEENSGAARD_ALIAS_ANALYSIS_H
+#define RETDEC_LLVMIR2HLL_ANALYSIS_ALIAS_ANALYSIS_ALIAS_ANALYSES_STEENSGAARD_ALIAS_ANALYSIS_H
+
+#include <map>
+#include <string>
+
+#include "retdec/llvmir2hll/analysis/alias_analysis/alias_analysis.h"
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/llvmir2hll/support/types.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+class Function;
+class Module;
+class Variable;
+
+/**
+* @brief A unification-based (Steensgaard-style) alias analysis.
+*
+* Within every function, variables and the memory they point to are grouped
+* into points-to classes kept in a union-find structure over integer ids. An
+* assignment of two pointers unifies their classes, so the analysis runs in
+* almost linear time in the size of the function.
+*
+* The analysis utilizes the following assumptions:
+*  - a non-pointer variable never points to any variable
+*  - a global pointer may point to any variable that has its address taken
+*  - a local pointer may point only to the variables in its points-to class;
+*    when the class is reachable from outside of the function (parameters,
+*    global variables, calls), the pointer may point to any variable that has
+*    its address taken in the function
+*  - a variable may be pointed if and only if its address is taken
+*
+* Functions are analyzed lazily, upon the first query concerning their local
+* variables. The whole module is analyzed only when a query concerns a global
+* variable.
+*
+* Use create() to create instances. Instances of this class have
+* reference object semantics.
+*/
+class SteensgaardAliasAnalysis: public AliasAnalysis {
+public:
+	static ShPtr<AliasAnalysis> create();
+
+	virtual ~SteensgaardAliasAnalysis() override;
+
+	virtual void init(ShPtr<Module> module) override;
+	virtual std::string getId() const override;
+	virtual const VarSet &mayPointTo(ShPtr<Variable> var) const override;
+	virtual ShPtr<Variable> pointsTo(ShPtr<Variable> var) const override;
+	virtual bool mayBePointed(ShPtr<Variable> var) const override;
+
+private:
+	class PointsToGraph;
+
+	/// Mapping of a function into its points-to graph.
+	using FuncPointsToGraphMap = std::map<ShPtr<Function>,
+		UPtr<PointsToGraph>>;
+
+	/// Mapping of a variable into a function.
+	using VarFuncMap = std::map<ShPtr<Variable>, ShPtr<Function>>;
+
+private:
+	SteensgaardAliasAnalysis();
+
+	const PointsToGraph &getPointsToGraph(ShPtr<Function> func) const;
+	void analyzeWholeModule() const;
+
+private:
+	/// Points-to graphs of the already analyzed functions.
+	mutable FuncPointsToGraphMap funcGraphs;
+
+	/// All variables in the module whose address is taken. Valid only after
+	/// the whole module has been analyzed.
+	mutable VarSet allAddressedVars;
+
+	/// Has the whole module been analyzed?
+	mutable bool wholeModuleAnalyzed;
+
+	/// Mapping of a local variable into the function in which it is defined.
+	/// Function arguments are included.
+	VarFuncMap varFuncMap;
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
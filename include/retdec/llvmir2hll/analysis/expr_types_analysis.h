@@ -54,19 +54,24 @@ class Expression;
 class ExprTypesAnalysis final: private OrderedAllVisitor,
 		private retdec::utils::NonCopyable {
 public:
-	/// Mapping of a expression into a vector of signed/unsigned information.
 	/// Possible tags about expressions.
 	enum class ExprTag {
 		Signed,  /// Signed type.
 		Unsigned /// Unsigned Type.
 	};
 
-	using TagVector = std::vector<ExprTag>;
-	using ExprTagsMap = std::map< ShPtr<Expression>, TagVector>;
+	/// Numbers of signed/unsigned tags of an expression.
+	struct TagCounts {
+		std::size_t signedCount = 0;
+		std::size_t unsignedCount = 0;
+	};
+
+	/// Mapping of an expression into the numbers of its signed/unsigned tags.
+	using ExprTagsMap = std::map<ShPtr<Expression>, TagCounts>;
 
 public:
-	std::size_t getCountOfTag(ShPtr<Expression> expr, ExprTag tag);
-	ExprTagsMap analyzeExprTypes(ShPtr<Module> module);
+	std::size_t getCountOfTag(ShPtr<Expression> expr, ExprTag tag) const;
+	const ExprTagsMap &analyzeExprTypes(ShPtr<Module> module);
 
 	static ShPtr<ExprTypesAnalysis> create();
 
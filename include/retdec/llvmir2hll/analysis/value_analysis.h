@@ -207,6 +207,10 @@ private:
 * Upon calling clearCache(), the analysis gets validated automatically. If you
 * modify or remove a statement and call removeFromCache(), then you do not have
 * to call invalidate().
+*
+* The cache is bounded. When it is full, the least recently used results are
+* evicted from it, so do not keep references into a ValueData without keeping
+* the ValueData itself.
 */
 class ValueAnalysis: private OrderedAllVisitor,
 	private retdec::utils::NonCopyable, public ValidState,
@@ -230,11 +234,16 @@ public:
 	/// @}
 
 	static ShPtr<ValueAnalysis> create(ShPtr<AliasAnalysis> aliasAnalysis,
-		bool enableCaching = false);
+		bool enableCaching = false,
+		std::size_t maxCacheSize = DEFAULT_MAX_CACHE_SIZE);
+
+public:
+	/// Default maximal number of cached results.
+	static const std::size_t DEFAULT_MAX_CACHE_SIZE;
 
 private:
-	explicit ValueAnalysis(ShPtr<AliasAnalysis> aliasAnalysis,
-		bool enableCaching = false);
+	ValueAnalysis(ShPtr<AliasAnalysis> aliasAnalysis, bool enableCaching,
+		std::size_t maxCacheSize);
 
 	void computeAndStoreIndirectlyUsedVars(ShPtr<DerefOpExpr> expr);
 
@@ -178,6 +178,24 @@ public:
 	*/
 	virtual void markFuncAsStaticallyLinked(const std::string &func) = 0;
 
+	/**
+	* @brief Returns the cheaper paths that the decompilation of the given
+	*        function took because the function was too costly.
+	*
+	* If the given function does not exist or has not been degraded, the empty
+	* set is returned.
+	*/
+	virtual StringSet getDegradationsOfFunc(const std::string &func) const = 0;
+
+	/**
+	* @brief Records that the decompilation of the given function took the
+	*        given cheaper path.
+	*
+	* If there is no such function, nothing is done.
+	*/
+	virtual void markFuncAsDegraded(const std::string &func,
+		const std::string &degradation) = 0;
+
 	/**
 	* @brief Returns a C declaration string for the given function.
 	*
@@ -78,6 +78,9 @@ public:
 	virtual bool isInstructionIdiomFunc(const std::string &func) const override;
 	virtual bool isExportedFunc(const std::string &func) const override;
 	virtual void markFuncAsStaticallyLinked(const std::string &func) override;
+	virtual StringSet getDegradationsOfFunc(const std::string &func) const override;
+	virtual void markFuncAsDegraded(const std::string &func,
+		const std::string &degradation) override;
 	virtual std::string getDeclarationStringForFunc(const std::string &func) const override;
 	virtual std::string getCommentForFunc(const std::string &func) const override;
 	virtual StringSet getDetectedCryptoPatternsForFunc(const std::string &func) const override;
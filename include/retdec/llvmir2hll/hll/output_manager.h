@@ -23,6 +23,7 @@ class OutputManager
 	public:
 		virtual ~OutputManager();
 		virtual void finalize();
+		virtual void flush();
 
 	// Configuration methods.
 	//
@@ -29,6 +29,7 @@ class JsonOutputManager : public OutputManager
 	public:
 		JsonOutputManager(llvm::raw_ostream& out);
 		virtual void finalize() override;
+		virtual void flush() override;
 
 	public:
 		virtual void newLine() override;
@@ -18,6 +18,7 @@ class PlainOutputManager : public OutputManager
 {
 	public:
 		PlainOutputManager(llvm::raw_ostream& out);
+		virtual void flush() override;
 
 	public:
 		virtual void newLine() override;
@@ -8,6 +8,7 @@
 #define RETDEC_LLVMIR2HLL_IR_INT_TYPE_H
 
 #include <map>
+#include <mutex>
 
 #include "retdec/llvmir2hll/ir/type.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
@@ -57,6 +58,9 @@ private:
 	/// Set of already created unsigned integer types of the given size.
 	static SizeToIntTypeMap createdUnsignedTypes;
 
+	/// Guards the sets of created types (types are shared between threads).
+	static std::mutex createdTypesMutex;
+
 private:
 	// Since instances are created by calling the static function create(), the
 	// constructor can be private.
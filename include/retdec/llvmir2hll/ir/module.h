@@ -102,6 +102,10 @@ public:
 	FuncSet getStaticallyLinkedFuncs() const;
 	void markFuncAsStaticallyLinked(ShPtr<Function> func);
 
+	FuncSet getDegradedFuncs() const;
+	StringSet getDegradationsOfFunc(ShPtr<Function> func) const;
+	void markFuncAsDegraded(ShPtr<Function> func, const std::string &degradation);
+
 	bool hasDynamicallyLinkedFuncs() const;
 	FuncSet getDynamicallyLinkedFuncs() const;
 
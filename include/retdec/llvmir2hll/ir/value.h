@@ -7,6 +7,7 @@
 #ifndef RETDEC_LLVMIR2HLL_IR_VALUE_H
 #define RETDEC_LLVMIR2HLL_IR_VALUE_H
 
+#include <cstdint>
 #include <iosfwd>
 #include <string>
 
@@ -68,8 +69,20 @@ public:
 
 	std::string getTextRepr();
 
+	/**
+	* @brief Returns the ID of the value.
+	*
+	* IDs are unique and they increase in the order in which values are
+	* created.
+	*/
+	std::uint64_t getId() const { return id; }
+
 protected:
-	Value() = default;
+	Value();
+
+private:
+	/// ID of the value.
+	const std::uint64_t id;
 };
 
 /// @name Emission To Streams
@@ -12,6 +12,7 @@
 #include "retdec/llvmir2hll/ir/expression.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
 #include "retdec/llvmir2hll/support/types.h"
+#include "retdec/utils/interned_string.h"
 
 namespace retdec {
 namespace llvmir2hll {
@@ -64,10 +65,10 @@ private:
 
 private:
 	/// Initial name of the variable.
-	std::string initialName;
+	retdec::utils::InternedString initialName;
 
 	/// Name of the variable.
-	std::string name;
+	retdec::utils::InternedString name;
 
 	/// Type of the variable.
 	ShPtr<Type> type;
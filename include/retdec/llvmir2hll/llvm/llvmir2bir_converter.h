@@ -7,7 +7,9 @@
 #ifndef RETDEC_LLVMIR2HLL_LLVM_LLVMIR2BIR_CONVERTER_H
 #define RETDEC_LLVMIR2HLL_LLVM_LLVMIR2BIR_CONVERTER_H
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 
 #include "retdec/llvmir2hll/llvm/llvmir2bir_converter.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
@@ -52,6 +54,8 @@ public:
 	/// @name Options
 	/// @{
 	void setOptionStrictFPUSemantics(bool strict = true);
+	void setOptionReleaseLLVMFuncBodies(bool release = true);
+	void setOptionFuncCostLimit(std::uint64_t limit);
 	/// @}
 
 private:
@@ -95,6 +99,13 @@ private:
 	/// Use strict FPU semantics?
 	bool optionStrictFPUSemantics;
 
+	/// Release bodies of LLVM functions after their conversion?
+	bool optionReleaseLLVMFuncBodies;
+
+	/// Functions whose estimated cost is above this are structured only by
+	/// gotos. Zero means no limit.
+	std::uint64_t optionFuncCostLimit;
+
 	/// Should debugging messages be enabled?
 	bool enableDebug;
 
@@ -112,6 +123,9 @@ private:
 
 	/// Variables manager.
 	ShPtr<VariablesManager> variablesManager;
+
+	/// Mapping of LLVM functions into their counterparts in BIR.
+	std::unordered_map<llvm::Function *, ShPtr<Function>> convertedFuncs;
 };
 
 } // namespace llvmir2hll
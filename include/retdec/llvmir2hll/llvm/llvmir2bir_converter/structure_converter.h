@@ -7,6 +7,7 @@
 #ifndef RETDEC_LLVMIR2HLL_LLVM_LLVMIR2BIR_CONVERTER_STRUCTURE_CONVERTER_H
 #define RETDEC_LLVMIR2HLL_LLVM_LLVMIR2BIR_CONVERTER_STRUCTURE_CONVERTER_H
 
+#include <cstdint>
 #include <functional>
 #include <queue>
 #include <stack>
@@ -67,6 +68,7 @@ private:
 
 	using MapBBToBBSet = std::unordered_map<llvm::BasicBlock *, BBSet>;
 	using MapBBToCFGNode = std::unordered_map<llvm::BasicBlock *, ShPtr<CFGNode>>;
+	using MapCFGNodeToCFGNodeSet = std::unordered_map<ShPtr<CFGNode>, CFGNode::CFGNodeSet>;
 	using MapCFGNodeToSwitchClause = std::unordered_map<ShPtr<CFGNode>, ShPtr<SwitchClause>>;
 	using MapCFGNodeToDFSNodeState = std::unordered_map<ShPtr<CFGNode>, DFSNodeState>;
 	using MapLoopToCFGNode = std::unordered_map<llvm::Loop *, ShPtr<CFGNode>>;
@@ -79,6 +81,19 @@ public:
 
 	ShPtr<Statement> convertFuncBody(llvm::Function &func);
 
+	/// @name Options
+	/// @{
+	void setOptionFuncCostLimit(std::uint64_t limit);
+	/// @}
+
+	/// @name Statistics of the last conversion
+	/// @{
+	std::size_t getNumOfReductionPasses() const;
+	std::size_t getNumOfReductions() const;
+	std::uint64_t getFuncCost() const;
+	bool wasReductionSkipped() const;
+	/// @}
+
 private:
 	/// @name Construction and traversal through control-flow graph
 	/// @{
@@ -86,6 +101,7 @@ private:
 	void detectBackEdges(ShPtr<CFGNode> cfg) const;
 	bool reduceCFG(ShPtr<CFGNode> cfg);
 	bool inspectCFGNode(ShPtr<CFGNode> node);
+	bool tryToReduceCFGNode(ShPtr<CFGNode> node);
 	ShPtr<CFGNode> popFromQueue(CFGNodeQueue &queue) const;
 	void addUnvisitedSuccessorsToQueue(const ShPtr<CFGNode> &node,
 		CFGNodeQueue &toBeVisited, CFGNode::CFGNodeSet &visited) const;
@@ -100,6 +116,8 @@ private:
 		std::function<bool (ShPtr<CFGNode>)> pred) const;
 	bool existsPathWithoutLoopsBetween(const ShPtr<CFGNode> &node1,
 		const ShPtr<CFGNode> &node2) const;
+	const CFGNode::CFGNodeSet &getReachableNodes(
+		const ShPtr<CFGNode> &node) const;
 	/// @}
 
 	/// @name Detection of constructions
@@ -221,6 +239,7 @@ private:
 	/// @name Work with LLVM analyses
 	/// @{
 	void initialiazeLLVMAnalyses(llvm::Function &func);
+	std::uint64_t computeFuncCost(llvm::Function &func) const;
 	llvm::Loop *getLoopFor(const ShPtr<CFGNode> &node) const;
 	bool isLoopHeader(const ShPtr<CFGNode> &node) const;
 	bool isLoopHeader(const ShPtr<CFGNode> &node, llvm::Loop *loop) const;
@@ -313,6 +332,25 @@ private:
 
 	/// The resulting module in BIR.
 	ShPtr<Module> resModule;
+
+	/// Cache of nodes reachable from the given node (see getReachableNodes()).
+	mutable MapCFGNodeToCFGNodeSet reachableNodesCache;
+
+	/// Number of passes over the CFG during the last conversion.
+	std::size_t numOfReductionPasses = 0;
+
+	/// Number of reduced nodes during the last conversion.
+	std::size_t numOfReductions = 0;
+
+	/// Functions whose cost is above this are structured only by gotos. Zero
+	/// means no limit.
+	std::uint64_t funcCostLimit = 0;
+
+	/// Estimated cost of the function converted by the last conversion.
+	std::uint64_t funcCost = 0;
+
+	/// Was the reduction of the CFG skipped during the last conversion?
+	bool reductionSkipped = false;
 };
 
 } // namespace llvmir2hll
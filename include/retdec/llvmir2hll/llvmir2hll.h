@@ -60,9 +60,11 @@
 #include "retdec/llvmir2hll/semantics/semantics/compound_semantics_builder.h"
 #include "retdec/llvmir2hll/semantics/semantics/default_semantics.h"
 #include "retdec/llvmir2hll/semantics/semantics_factory.h"
+#include "retdec/llvmir2hll/support/bir_snapshot.h"
 #include "retdec/llvmir2hll/support/const_symbol_converter.h"
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/llvmir2hll/support/expr_types_fixer.h"
+#include "retdec/llvmir2hll/support/func_result_cache.h"
 #include "retdec/llvmir2hll/support/library_funcs_remover.h"
 #include "retdec/llvmir2hll/support/unreachable_code_in_cfg_remover.h"
 #include "retdec/llvmir2hll/utils/ir.h"
@@ -118,14 +120,21 @@ private:
 	void createSemanticsFromLLVMIR();
 	bool loadConfig();
 	void saveConfig();
+	bool convertLLVMIRToOptimizedBIR();
+	bool loadBIR();
+	bool loadMergedBIR();
+	void initLoadedBIR();
+	bool saveBIR();
 	bool convertLLVMIRToBIR();
 	void removeLibraryFuncs();
 	void removeCodeUnreachableInCFG();
 	void fixSignedUnsignedTypes();
 	void convertLLVMIntrinsicFunctions();
 	void obtainDebugInfo();
+	void createFuncResultCache();
+	llvmir2hll::FuncSet restoreCachedFuncs();
 	void initAliasAnalysis();
-	void runOptimizations();
+	void runOptimizations(const llvmir2hll::FuncSet &restoredFuncs);
 	void renameVariables();
 	void convertConstantsToSymbolicNames();
 	void validateResultingModule();
@@ -166,6 +175,9 @@ private:
 	/// The used obtainer of information about function and function calls.
 	ShPtr<llvmir2hll::CallInfoObtainer> cio;
 
+	/// The CG of the resulting module after pattern finding (if any).
+	ShPtr<llvmir2hll::CG> resModuleCG;
+
 	/// The used evaluator of arithmetical expressions.
 	ShPtr<llvmir2hll::ArithmExprEvaluator> arithmExprEvaluator;
 
@@ -175,6 +187,9 @@ private:
 	/// The used renamer of variables.
 	ShPtr<llvmir2hll::VarRenamer> varRenamer;
 
+	/// The used cache of optimized functions (if any).
+	UPtr<llvmir2hll::FuncResultCache> funcResultCache;
+
 	/// Output file stream.
 	std::unique_ptr<llvm::ToolOutputFile> outFile;
 
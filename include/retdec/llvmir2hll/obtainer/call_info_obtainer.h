@@ -318,8 +318,9 @@ protected:
 	/// Analysis of values.
 	ShPtr<ValueAnalysis> va;
 
-	/// Mapping of a function into its CFG.
-	FuncCFGMap funcCFGMap;
+	/// Mapping of a function into its CFG. Contains every function in the
+	/// module; a CFG is the null pointer until it is requested.
+	mutable FuncCFGMap funcCFGMap;
 
 	/// The used builder of CFGs.
 	ShPtr<CFGBuilder> cfgBuilder;
@@ -402,23 +403,8 @@ private:
 		CalledFuncInfoMap calledFuncInfoMap;
 	};
 
-	/**
-	* @brief An SCC with a represent.
-	*/
-	struct SCCWithRepresent {
-		SCCWithRepresent(FuncSet scc, ShPtr<Function> represent):
-			scc(scc), represent(represent) {}
-
-		FuncSet scc;
-		ShPtr<Function> represent;
-	};
-
 private:
 	FuncVectorSet computeSCCs();
-	bool callsJustComputedFuncs(ShPtr<Function> func,
-		const FuncSet &computedFuncs) const;
-	SCCWithRepresent findNextSCC(const FuncVectorSet &sccs,
-		const FuncSet &computedFuncs, const FuncSet &remainingFuncs) const;
 };
 
 } // namespace llvmir2hll
@@ -10,6 +10,7 @@
 #include <string>
 
 #include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/llvmir2hll/support/types.h"
 #include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
 #include "retdec/utils/non_copyable.h"
 
@@ -50,6 +51,7 @@ public:
 	virtual std::string getId() const = 0;
 
 	ShPtr<Module> optimize();
+	void restrictToFuncs(const FuncSet &funcs);
 
 	/**
 	* @brief Creates an instance of OptimizerType with the given arguments and
@@ -74,9 +76,18 @@ protected:
 	virtual void doOptimization();
 	virtual void doFinalization();
 
+	bool shouldBeOptimized(ShPtr<Function> func) const;
+
 protected:
 	/// The module that is being optimized.
 	ShPtr<Module> module;
+
+private:
+	/// Functions to which the optimization is restricted.
+	FuncSet funcsToOptimize;
+
+	/// Has the optimization been restricted by restrictToFuncs()?
+	bool restrictedToFuncs = false;
 };
 
 } // namespace llvmir2hll
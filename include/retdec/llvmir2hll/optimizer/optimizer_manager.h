@@ -7,6 +7,11 @@
 #ifndef RETDEC_LLVMIR2HLL_OPTIMIZER_OPTIMIZER_MANAGER_H
 #define RETDEC_LLVMIR2HLL_OPTIMIZER_OPTIMIZER_MANAGER_H
 
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+
 #include "retdec/llvmir2hll/optimizer/optimizer.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
 #include "retdec/llvmir2hll/support/types.h"
@@ -17,6 +22,7 @@ namespace llvmir2hll {
 
 class ArithmExprEvaluator;
 class CallInfoObtainer;
+class Function;
 class HLLWriter;
 class Module;
 class ValueAnalysis;
@@ -32,19 +38,40 @@ public:
 	OptimizerManager(const StringSet &enabledOpts, const StringSet &disabledOpts,
 		ShPtr<HLLWriter> hllWriter, ShPtr<ValueAnalysis> va,
 		ShPtr<CallInfoObtainer> cio, ShPtr<ArithmExprEvaluator> arithmExprEvaluator,
-		bool enableDebug = false);
+		bool enableDebug = false, std::size_t copyPropStmtLimit = 0);
 
+	void skipFuncs(const FuncSet &funcs);
 	void optimize(ShPtr<Module> m);
+	bool ranOutOfResources() const;
+
+private:
+	/// State of a function in the optimized module.
+	struct FuncState {
+		/// Fingerprint of the function (see FuncFingerprinter).
+		std::size_t fingerprint;
+
+		/// Number of optimizations that were run before the last
+		/// modification of the function.
+		std::size_t lastModification;
+	};
 
 private:
 	void printOptimization(const std::string &optName) const;
+	void printOptimizationStats(const std::string &optName, double seconds,
+		std::size_t numOfModifiedFuncs) const;
 	bool optShouldBeRun(const std::string &optName) const;
-	void runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimizer);
+	void runOptimizerProvidedItShouldBeRun(ShPtr<Module> m,
+		ShPtr<Optimizer> optimizer, bool onlyOnModifiedFuncs);
 	bool shouldSecondCopyPropagationBeRun() const;
+	std::size_t updateFuncStates(ShPtr<Module> m);
+	FuncSet getFuncsModifiedSince(std::size_t numOfRunOptsSoFar) const;
 
 	template<typename Optimization, typename... Args>
 	void run(ShPtr<Module> m, Args &&... args);
 
+	template<typename Optimization, typename... Args>
+	void rerun(ShPtr<Module> m, Args &&... args);
+
 private:
 	/// No other optimization than these will be run.
 	const StringSet enabledOpts;
@@ -67,11 +94,36 @@ private:
 	/// Enable emission of debug messages?
 	bool enableDebug;
 
+	/// Functions with more statements than this are not optimized by the full
+	/// CopyPropagationOptimizer. Zero means no limit.
+	std::size_t copyPropStmtLimit;
+
 	/// Should we recover from out-of-memory errors during optimizations?
 	bool recoverFromOutOfMemory;
 
-	/// List of our optimizations that were run.
-	StringSet backendRunOpts;
+	/// Number of optimizations that were run so far.
+	std::size_t numOfRunOpts = 0;
+
+	/// For each optimization that was run, the value of @c numOfRunOpts
+	/// right after its last run.
+	std::map<std::string, std::size_t> lastRuns;
+
+	/// States of the functions in the optimized module.
+	std::unordered_map<ShPtr<Function>, FuncState> funcStates;
+
+	/// Functions that were too costly to be structured. The most expensive
+	/// optimizations are not run on them.
+	FuncSet degradedFuncs;
+
+	/// Functions that are not optimized at all (see skipFuncs()).
+	FuncSet skippedFuncs;
+
+	/// Have the remaining optimizations been skipped because the phase
+	/// budget was spent?
+	bool phaseBudgetExpired = false;
+
+	/// Has an optimization been interrupted because it ran out of memory?
+	bool recoveredFromOutOfMemory = false;
 };
 
 } // namespace llvmir2hll
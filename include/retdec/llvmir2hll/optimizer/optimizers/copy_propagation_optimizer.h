@@ -7,6 +7,8 @@
 #ifndef RETDEC_LLVMIR2HLL_OPTIMIZER_OPTIMIZERS_COPY_PROPAGATION_OPTIMIZER_H
 #define RETDEC_LLVMIR2HLL_OPTIMIZER_OPTIMIZERS_COPY_PROPAGATION_OPTIMIZER_H
 
+#include <cstddef>
+
 #include "retdec/llvmir2hll/analysis/def_use_analysis.h"
 #include "retdec/llvmir2hll/optimizer/func_optimizer.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
@@ -57,6 +59,10 @@ class VarUsesVisitor;
 * @endcode
 * provided that @c a is non-global.
 *
+* Functions having more statements than the given limit are optimized by
+* SimpleCopyPropagationOptimizer instead. Def-use and use-def chains of such
+* functions would be too expensive to compute.
+*
 * Instances of this class have reference object semantics.
 *
 * This is a concrete optimizer which should not be subclassed.
@@ -64,7 +70,7 @@ class VarUsesVisitor;
 class CopyPropagationOptimizer final: public FuncOptimizer {
 public:
 	CopyPropagationOptimizer(ShPtr<Module> module, ShPtr<ValueAnalysis> va,
-		ShPtr<CallInfoObtainer> cio);
+		ShPtr<CallInfoObtainer> cio, std::size_t stmtLimit = 0);
 
 	virtual std::string getId() const override { return "CopyPropagation"; }
 
@@ -95,6 +101,7 @@ private:
 		ShPtr<Variable> stmtLhsVar,
 		const StmtSet &uses);
 	bool shouldBeIncludedInDefUseChains(ShPtr<Variable> var);
+	void runSimpleCopyPropagation(ShPtr<Function> func);
 
 private:
 	/// The used builder of CFGs.
@@ -142,6 +149,10 @@ private:
 
 	/// Has the code changed?
 	bool codeChanged;
+
+	/// Functions with more statements than this are optimized by
+	/// SimpleCopyPropagationOptimizer. Zero means no limit.
+	std::size_t stmtLimit;
 };
 
 } // namespace llvmir2hll
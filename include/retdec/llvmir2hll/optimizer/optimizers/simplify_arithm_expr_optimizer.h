@@ -72,6 +72,10 @@ private:
 	/// @c true if the module was optimized in a sub/optimization, @c false
 	/// otherwise.
 	bool codeChanged;
+
+	/// Expressions that no sub-optimizer has changed since the currently
+	/// optimized function (or global variable) started to be optimized.
+	ExpressionSet unchangedExprs;
 };
 
 } // namespace llvmir2hll
@@ -57,6 +57,10 @@ public:
 		ShPtr<CallExpr> call, ShPtr<Statement> stmt, ShPtr<Function> func,
 		ShPtr<Module> module) = 0;
 
+	virtual Patterns findPatternsForSeqs(
+		const std::vector<APICallInfoSeq> &infos, ShPtr<CallExpr> call,
+		ShPtr<Statement> stmt, ShPtr<Function> func, ShPtr<Module> module);
+
 protected:
 	APICallSeqFinder(ShPtr<ValueAnalysis> va, ShPtr<CallInfoObtainer> cio);
 
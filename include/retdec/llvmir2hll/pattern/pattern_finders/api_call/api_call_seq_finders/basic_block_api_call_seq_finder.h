@@ -7,7 +7,10 @@
 #ifndef RETDEC_LLVMIR2HLL_PATTERN_PATTERN_FINDERS_API_CALL_API_CALL_SEQ_FINDERS_BASIC_BLOCK_API_CALL_SEQ_FINDER_H
 #define RETDEC_LLVMIR2HLL_PATTERN_PATTERN_FINDERS_API_CALL_API_CALL_SEQ_FINDERS_BASIC_BLOCK_API_CALL_SEQ_FINDER_H
 
+#include <vector>
+
 #include "retdec/llvmir2hll/pattern/pattern_finders/api_call/api_call_info_seq.h"
+#include "retdec/llvmir2hll/pattern/pattern_finders/api_call/api_call_seq_data.h"
 #include "retdec/llvmir2hll/pattern/pattern_finders/api_call/api_call_seq_finder.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
 
@@ -48,11 +51,17 @@ public:
 	virtual Patterns findPatterns(const APICallInfoSeq &info,
 		ShPtr<CallExpr> call, ShPtr<Statement> stmt, ShPtr<Function> func,
 		ShPtr<Module> module) override;
+	virtual Patterns findPatternsForSeqs(
+		const std::vector<APICallInfoSeq> &infos, ShPtr<CallExpr> call,
+		ShPtr<Statement> stmt, ShPtr<Function> func,
+		ShPtr<Module> module) override;
 
 	static ShPtr<BasicBlockAPICallSeqFinder> create(ShPtr<ValueAnalysis> va,
 		ShPtr<CallInfoObtainer> cio);
 
 private:
+	Patterns findPatternsInBlock(std::vector<APICallSeqData> &seqsData,
+		ShPtr<CallExpr> call, ShPtr<Statement> stmt, ShPtr<Function> func);
 };
 
 } // namespace llvmir2hll
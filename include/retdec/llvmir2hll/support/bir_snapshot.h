@@ -0,0 +1,98 @@
+/**
+* @file include/retdec/llvmir2hll/support/bir_snapshot.h
+* @brief Saving and loading of modules into binary snapshots.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_SUPPORT_BIR_SNAPSHOT_H
+#define RETDEC_LLVMIR2HLL_SUPPORT_BIR_SNAPSHOT_H
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/llvmir2hll/support/types.h"
+#include "retdec/utils/non_copyable.h"
+
+namespace llvm {
+
+class Module;
+
+} // namespace llvm
+
+namespace retdec {
+namespace llvmir2hll {
+
+class Config;
+class Function;
+class Module;
+class Semantics;
+
+/**
+* @brief Saving and loading of modules into binary snapshots.
+*
+* A snapshot holds the global variables, the functions with their bodies, and
+* the names of variables from debug information, i.e. everything that is
+* needed to emit the module. A module that has been saved after the
+* optimizations can thus be loaded and emitted again (e.g. with a different
+* variable renamer or output format) without converting and optimizing it
+* again.
+*
+* Variables and types keep their identity (a variable used in several places
+* is a single object after loading), and variables and functions are created
+* in the order in which they were originally created, so a loaded module is
+* emitted in the same way as the saved one. Metadata are kept only for
+* statements.
+*
+* The LLVM module, the semantics, and the config are not part of a snapshot,
+* they are given when the snapshot is loaded.
+*
+* Snapshots of modules created from parts of a single LLVM module (e.g. when
+* functions are decompiled in several processes) can be merged into a single
+* module by loadMerged().
+*
+* A single function can be saved by saveFunc() and later loaded into a function
+* of another module by loadFuncs(), e.g. when the same function is found in
+* several inputs.
+*
+* This class implements the "static helper" (or "library") design pattern (it
+* has just static functions and no public instances can be created).
+*/
+class BIRSnapshot: private retdec::utils::NonCopyable {
+public:
+	static bool save(ShPtr<Module> module, std::ostream &out);
+	static ShPtr<Module> load(std::istream &in, const llvm::Module *llvmModule,
+		ShPtr<Semantics> semantics, ShPtr<Config> config);
+	/**
+	* @brief A snapshot of a function to be loaded into a function of another
+	*        module (see loadFuncs()).
+	*/
+	struct FuncSnapshot {
+		/// Function into which the snapshot is loaded.
+		ShPtr<Function> func;
+
+		/// Stream with the snapshot.
+		std::istream *in;
+
+		/// Functions to be used instead of the functions of the given names
+		/// in the saved module (e.g. when they are named differently).
+		std::map<std::string, ShPtr<Function>> funcs;
+	};
+
+	static ShPtr<Module> loadMerged(const std::vector<std::istream *> &ins,
+		const llvm::Module *llvmModule, ShPtr<Semantics> semantics,
+		ShPtr<Config> config);
+
+	static bool saveFunc(ShPtr<Module> module, ShPtr<Function> func,
+		std::ostream &out);
+	static FuncSet loadFuncs(ShPtr<Module> module,
+		const std::vector<FuncSnapshot> &snapshots);
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
@@ -7,7 +7,10 @@
 #ifndef RETDEC_LLVMIR2HLL_SUPPORT_CACHING_H
 #define RETDEC_LLVMIR2HLL_SUPPORT_CACHING_H
 
+#include <cstddef>
+#include <list>
 #include <unordered_map>
+#include <utility>
 
 namespace retdec {
 namespace llvmir2hll {
@@ -20,6 +23,9 @@ namespace llvmir2hll {
 * @tparam HashFunc Hashing function for CachedKey. The default is @c
 *                  std::hash<CachedKey>.
 *
+* The cache may be bounded by the maximal number of cached results. When it is
+* full, the least recently used result is evicted from it.
+*
 * Usage example (see Analysis/UsedVarsVisitor):
 * @code
 * class UsedVarsVisitor: public Caching<ShPtr<Value>, ShPtr<UsedVars>,
@@ -50,7 +56,15 @@ template<typename CachedKey, typename CachedValue,
 	typename HashFunc = std::hash<CachedKey>>
 class Caching {
 public:
-	explicit Caching(bool enableCaching): cachingEnabled(enableCaching) {}
+	/**
+	* @brief Constructs a new mixin.
+	*
+	* @param[in] enableCaching Should caching be enabled?
+	* @param[in] maxCacheSize Maximal number of cached results. Zero means that
+	*                         the cache is unbounded.
+	*/
+	explicit Caching(bool enableCaching, std::size_t maxCacheSize = 0):
+		cachingEnabled(enableCaching), maxCacheSize(maxCacheSize) {}
 
 	/**
 	* @brief Enables caching.
@@ -77,6 +91,7 @@ public:
 	*/
 	void clearCache() {
 		cache.clear();
+		lruKeys.clear();
 	}
 
 	/**
@@ -86,7 +101,15 @@ public:
 	* this function does nothing.
 	*/
 	void removeFromCache(const CachedKey &key) {
-		cache.erase(key);
+		auto it = cache.find(key);
+		if (it == cache.end()) {
+			return;
+		}
+
+		if (maxCacheSize > 0) {
+			lruKeys.erase(it->second.second);
+		}
+		cache.erase(it);
 	}
 
 	/**
@@ -96,14 +119,39 @@ public:
 		return cachingEnabled;
 	}
 
+	/**
+	* @brief Returns the number of cached results.
+	*/
+	std::size_t getCacheSize() const {
+		return cache.size();
+	}
+
 protected:
 	/**
 	* @brief If caching is enabled, associates the given @a value with @a key.
 	*/
 	void addToCache(const CachedKey &key, const CachedValue &value) {
-		if (cachingEnabled) {
-			cache[key] = value;
+		if (!cachingEnabled) {
+			return;
+		}
+
+		auto it = cache.find(key);
+		if (it != cache.end()) {
+			it->second.first = value;
+			markAsRecentlyUsed(it->second.second);
+			return;
 		}
+
+		typename LRUKeys::iterator lruPos{};
+		if (maxCacheSize > 0) {
+			if (cache.size() >= maxCacheSize) {
+				// Evict the least recently used result.
+				cache.erase(lruKeys.back());
+				lruKeys.pop_back();
+			}
+			lruPos = lruKeys.insert(lruKeys.begin(), key);
+		}
+		cache.emplace(key, std::make_pair(value, lruPos));
 	}
 
 	/**
@@ -119,13 +167,30 @@ protected:
 		if (cachingEnabled) {
 			auto it = cache.find(key);
 			if (it != cache.end()) {
-				value = it->second;
+				value = it->second.first;
+				markAsRecentlyUsed(it->second.second);
 				return true;
 			}
 		}
 		return false;
 	}
 
+private:
+	/// Keys of cached results, from the most recently used one.
+	using LRUKeys = std::list<CachedKey>;
+
+private:
+	/**
+	* @brief Moves the key at @a lruPos to the front of @c lruKeys.
+	*
+	* If the cache is unbounded, this function does nothing.
+	*/
+	void markAsRecentlyUsed(typename LRUKeys::iterator lruPos) const {
+		if (maxCacheSize > 0) {
+			lruKeys.splice(lruKeys.begin(), lruKeys, lruPos);
+		}
+	}
+
 private:
 	/// Container for storing cached results.
 	// For performance reasons, it is better to use an unordered_map (i.e. a
@@ -133,14 +198,25 @@ private:
 	// a std::map can retrieve a value associated to a key in O(log(n)), where
 	// n is the number of items in the map, while an unordered_map can do this
 	// in O(1). Insertions into the maps have the same complexities.
-	using Cache = std::unordered_map<CachedKey, CachedValue, HashFunc>;
+	//
+	// Together with every result, we store the position of its key in @c
+	// lruKeys (it is valid only if the cache is bounded).
+	using Cache = std::unordered_map<CachedKey,
+		std::pair<CachedValue, typename LRUKeys::iterator>, HashFunc>;
 
 private:
 	/// Is caching enabled?
 	bool cachingEnabled;
 
+	/// Maximal number of cached results (zero means unbounded).
+	std::size_t maxCacheSize;
+
 	/// Cache for storing cached results.
 	Cache cache;
+
+	/// Keys of cached results in the order of their use. It is maintained
+	/// only if the cache is bounded.
+	mutable LRUKeys lruKeys;
 };
 
 } // namespace llvmir2hll
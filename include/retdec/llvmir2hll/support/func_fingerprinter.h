@@ -0,0 +1,54 @@
+/**
+* @file include/retdec/llvmir2hll/support/func_fingerprinter.h
+* @brief Computation of fingerprints of functions.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_SUPPORT_FUNC_FINGERPRINTER_H
+#define RETDEC_LLVMIR2HLL_SUPPORT_FUNC_FINGERPRINTER_H
+
+#include <cstddef>
+
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+namespace llvmir2hll {
+
+class Function;
+
+/**
+* @brief Computation of fingerprints of functions.
+*
+* A fingerprint is a hash of the signature of a function and of the identities
+* and textual representations of all statements in its body. When a function
+* is changed (a statement or an expression is added, removed, or replaced),
+* its fingerprint changes, too.
+*
+* This class implements the "static helper" (or "library") design pattern (it
+* has just static functions and no instances can be created).
+*/
+class FuncFingerprinter: private OrderedAllVisitor,
+		private retdec::utils::NonCopyable {
+public:
+	static std::size_t fingerprint(ShPtr<Function> func);
+
+private:
+	FuncFingerprinter();
+
+	std::size_t fingerprintInternal(ShPtr<Function> func);
+	void addToFingerprint(std::size_t value);
+
+	virtual void visitStmt(ShPtr<Statement> stmt, bool visitSuccessors = true,
+		bool visitNestedStmts = true) override;
+
+private:
+	/// The computed fingerprint.
+	std::size_t fp;
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
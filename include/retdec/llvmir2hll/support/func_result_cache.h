@@ -0,0 +1,93 @@
+/**
+* @file include/retdec/llvmir2hll/support/func_result_cache.h
+* @brief A cache of optimized functions shared by decompilations of different
+*        inputs.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_LLVMIR2HLL_SUPPORT_FUNC_RESULT_CACHE_H
+#define RETDEC_LLVMIR2HLL_SUPPORT_FUNC_RESULT_CACHE_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/llvmir2hll/support/types.h"
+#include "retdec/utils/non_copyable.h"
+
+namespace llvm {
+
+class Function;
+class Module;
+
+} // namespace llvm
+
+namespace retdec {
+namespace llvmir2hll {
+
+class Module;
+
+/**
+* @brief A cache of optimized functions shared by decompilations of different
+*        inputs.
+*
+* Many inputs contain the same functions (e.g. runtime helpers or parts of
+* embedded libraries). Every function of an LLVM module gets a key, which is a
+* hash of its normalized code: its instructions and their types, operands
+* numbered by their order instead of named, and offsets of instructions from
+* the start of the function instead of their addresses. Called functions are
+* represented by their names and types when they are only declared, and by
+* their own keys when they are defined. Functions that refer to global
+* variables or that are (mutually) recursive with other functions do not get a
+* key, so they are never cached.
+*
+* Before the optimizations, the functions whose keys are in the cache are
+* restored from it (see restore()), so they do not have to be optimized. After
+* the optimizations, the other functions with a key are stored into it (see
+* store()). Each entry is a single file named by its key, which is written
+* atomically, so the cache can be shared by several processes.
+*
+* The key also contains the given context, which has to describe everything
+* else that influences the optimized functions (e.g. the used optimizations).
+*/
+class FuncResultCache: private retdec::utils::NonCopyable {
+public:
+	FuncResultCache(const std::string &dir, const std::string &context);
+
+	void computeKeys(const llvm::Module &llvmModule);
+	std::string getKey(const std::string &funcName) const;
+
+	FuncSet restore(ShPtr<Module> module);
+	std::size_t store(ShPtr<Module> module);
+
+private:
+	std::string computeKey(const llvm::Function &func);
+	std::string getEntryPath(const std::string &key) const;
+
+private:
+	/// Directory with the entries.
+	std::string dir;
+
+	/// Context of the keys.
+	std::string context;
+
+	/// Keys of functions of the LLVM module (the empty string for functions
+	/// that cannot be cached).
+	std::map<const llvm::Function *, std::string> keys;
+
+	/// Keys of functions by their names.
+	std::map<std::string, std::string> keysByName;
+
+	/// For every function with a key, the names and keys of the defined
+	/// functions that it calls.
+	std::map<std::string, std::map<std::string, std::string>> calleeKeys;
+
+	/// Functions that have been restored from the cache.
+	FuncSet restoredFuncs;
+};
+
+} // namespace llvmir2hll
+} // namespace retdec
+
+#endif
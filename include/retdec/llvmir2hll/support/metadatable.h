@@ -7,6 +7,9 @@
 #ifndef RETDEC_LLVMIR2HLL_SUPPORT_METADATABLE_H
 #define RETDEC_LLVMIR2HLL_SUPPORT_METADATABLE_H
 
+#include <memory>
+#include <utility>
+
 namespace retdec {
 namespace llvmir2hll {
 
@@ -24,21 +27,27 @@ public:
 	* @param[in] data Metadata to be attached.
 	*/
 	void setMetadata(T data) {
-		this->data = data;
+		if (data.empty()) {
+			this->data.reset();
+		} else if (this->data) {
+			*this->data = std::move(data);
+		} else {
+			this->data = std::make_unique<T>(std::move(data));
+		}
 	}
 
 	/**
 	* @brief Returns the attached metadata.
 	*/
 	T getMetadata() const {
-		return data;
+		return data ? *data : T();
 	}
 
 	/**
 	* @brief Are there any non-empty metadata?
 	*/
 	bool hasMetadata() const {
-		return !data.empty();
+		return data != nullptr;
 	}
 
 protected:
@@ -49,7 +58,9 @@ protected:
 
 private:
 	/// Attached metadata.
-	T data;
+	// Only a few objects have metadata, so they are allocated only when
+	// non-empty metadata are attached.
+	std::unique_ptr<T> data;
 };
 
 } // namespace llvmir2hll
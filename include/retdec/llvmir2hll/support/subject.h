@@ -8,6 +8,7 @@
 #define RETDEC_LLVMIR2HLL_SUPPORT_SUBJECT_H
 
 #include <algorithm>
+#include <memory>
 #include <vector>
 
 #include "retdec/llvmir2hll/support/smart_ptr.h"
@@ -89,7 +90,10 @@ public:
 	* @param[in] observer Observer to be added.
 	*/
 	void addObserver(ObserverPtr observer) {
-		observers.push_back(observer);
+		if (!observers) {
+			observers = std::make_unique<ObserverContainer>();
+		}
+		observers->push_back(observer);
 	}
 
 	/**
@@ -105,7 +109,7 @@ public:
 	* @brief Removes all observers.
 	*/
 	void removeObservers() {
-		observers.clear();
+		observers.reset();
 	}
 
 	/**
@@ -125,7 +129,11 @@ public:
 	void notifyObservers(ShPtr<ArgType> arg = nullptr) {
 		// We have to iterate over a copy of the container because it can be
 		// modified during the iteration (either by us or in an update() call).
-		for (const auto &observer : ObserverContainer(observers)) {
+		if (!observers) {
+			return;
+		}
+
+		for (const auto &observer : ObserverContainer(*observers)) {
 			notifyObserverOrRemoveItIfNotExists(observer, arg);
 		}
 	}
@@ -144,17 +152,26 @@ protected:
 	* @brief Returns a constant iterator to the first observer.
 	*/
 	observer_iterator observer_begin() const {
-		return observers.begin();
+		return observers ? observers->cbegin() : noObservers().cbegin();
 	}
 
 	/**
 	* @brief Returns a constant iterator past the last observer.
 	*/
 	observer_iterator observer_end() const {
-		return observers.end();
+		return observers ? observers->cend() : noObservers().cend();
 	}
 
 private:
+	/**
+	* @brief Returns an empty container of observers.
+	*
+	* It is iterated over when the subject has no observers.
+	*/
+	static const ObserverContainer &noObservers() {
+		static const ObserverContainer empty;
+		return empty;
+	}
 
 	/**
 	* @brief Notifies the given observer (if it exists) or removes it (if it
@@ -189,16 +206,25 @@ private:
 	* @brief Removes the given observer and all the non-existing observers.
 	*/
 	void removeObserverAndNonExistingObservers(ObserverPtr observer) {
-		observers.erase(std::remove_if(observers.begin(), observers.end(),
+		if (!observers) {
+			return;
+		}
+
+		observers->erase(std::remove_if(observers->begin(), observers->end(),
 			[&observer](const auto &other) {
 				return other.expired() || observer.lock() == other.lock();
 			}
-		));
+		), observers->end());
+		if (observers->empty()) {
+			observers.reset();
+		}
 	}
 
 private:
 	/// Container to store observers.
-	ObserverContainer observers;
+	// Most subjects are never observed, so the container is allocated only
+	// when the first observer is added.
+	UPtr<ObserverContainer> observers;
 };
 
 } // namespace llvmir2hll
@@ -47,35 +47,50 @@ using LineRange = std::pair<std::uint64_t, std::uint64_t>;
 /// No line range.
 extern const LineRange NO_LINE_RANGE;
 
+/**
+* @brief Orders values by their IDs (see Value::getId()), i.e. by the order in
+*        which they were created.
+*
+* Unlike the ordering by addresses, it is the same in every run, so sets of
+* values are iterated in a deterministic order. Null pointers precede all
+* values.
+*/
+struct ValueIdLess {
+	template<typename T1, typename T2>
+	bool operator()(const ShPtr<T1> &v1, const ShPtr<T2> &v2) const {
+		return v1 && v2 ? v1->getId() < v2->getId() : !v1 && v2;
+	}
+};
+
 /// Set of strings.
 using StringSet = std::set<std::string>;
 
 /// Set of values.
-using ValueSet = std::set<ShPtr<Value>>;
+using ValueSet = std::set<ShPtr<Value>, ValueIdLess>;
 
 /// Set of variables.
-using VarSet = std::set<ShPtr<Variable>>;
+using VarSet = std::set<ShPtr<Variable>, ValueIdLess>;
 
 /// Set of VarDefStmt.
-using VarDefStmtSet = std::set<ShPtr<VarDefStmt>>;
+using VarDefStmtSet = std::set<ShPtr<VarDefStmt>, ValueIdLess>;
 
 /// Set of types.
-using TypeSet = std::set<ShPtr<Type>>;
+using TypeSet = std::set<ShPtr<Type>, ValueIdLess>;
 
 /// Set of structured types.
-using StructTypeSet = std::set<ShPtr<StructType>>;
+using StructTypeSet = std::set<ShPtr<StructType>, ValueIdLess>;
 
 /// Set of statements.
-using StmtSet = std::set<ShPtr<Statement>>;
+using StmtSet = std::set<ShPtr<Statement>, ValueIdLess>;
 
 /// Set of expressions.
-using ExpressionSet = std::set<ShPtr<Expression>>;
+using ExpressionSet = std::set<ShPtr<Expression>, ValueIdLess>;
 
 /// Set of function calls.
-using CallSet = std::set<ShPtr<CallExpr>>;
+using CallSet = std::set<ShPtr<CallExpr>, ValueIdLess>;
 
 /// Set of functions.
-using FuncSet = std::set<ShPtr<Function>>;
+using FuncSet = std::set<ShPtr<Function>, ValueIdLess>;
 
 /// Unordered set of statements.
 using StmtUSet = std::unordered_set<ShPtr<Statement>>;
@@ -83,6 +98,9 @@ using StmtUSet = std::unordered_set<ShPtr<Statement>>;
 /// Unordered set of types.
 using TypeUSet = std::unordered_set<ShPtr<Type>>;
 
+/// Unordered set of strings.
+using StringUSet = std::unordered_set<std::string>;
+
 /// Vector of strings.
 using StringVector = std::vector<std::string>;
 
@@ -10,6 +10,7 @@
 #include <string>
 
 #include "retdec/llvmir2hll/support/smart_ptr.h"
+#include "retdec/llvmir2hll/support/types.h"
 #include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
 #include "retdec/utils/io/log.h"
 
@@ -37,6 +38,7 @@ public:
 	virtual std::string getId() const = 0;
 
 	bool validate(ShPtr<Module> module, bool printMessageOnError = false);
+	void restrictToFuncs(const FuncSet &funcs);
 
 protected:
 	Validator();
@@ -70,6 +72,12 @@ private:
 
 	/// @c true if there has not been an error, @c false otherwise.
 	bool moduleIsCorrect;
+
+	/// Functions to which the validation is restricted.
+	FuncSet funcsToValidate;
+
+	/// Has the validation been restricted by restrictToFuncs()?
+	bool restrictedToFuncs;
 };
 
 } // namespace llvmir2hll
@@ -7,8 +7,9 @@
 #ifndef RETDEC_LLVMIR2HLL_VAR_RENAMER_VAR_RENAMER_H
 #define RETDEC_LLVMIR2HLL_VAR_RENAMER_VAR_RENAMER_H
 
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
 #include "retdec/llvmir2hll/var_name_gen/var_name_gen.h"
@@ -99,11 +100,14 @@ protected:
 	/// @}
 
 protected:
+	/// Unordered set of variables.
+	using VarUSet = std::unordered_set<ShPtr<Variable>>;
+
 	/// Mapping of a function into a set of strings.
-	using FuncStringSetMap = std::map<ShPtr<Function>, StringSet>;
+	using FuncStringUSetMap = std::unordered_map<ShPtr<Function>, StringUSet>;
 
 	/// Mapping of a function's name into the function.
-	using FuncByNameMap = std::map<std::string, ShPtr<Function>>;
+	using FuncByNameMap = std::unordered_map<std::string, ShPtr<Function>>;
 
 protected:
 	/// Used generator of variable names.
@@ -126,17 +130,17 @@ protected:
 	FuncByNameMap funcsByName;
 
 	/// Variables which have already been renamed.
-	VarSet renamedVars;
+	VarUSet renamedVars;
 
 	/// Assigned names of global variables.
-	StringSet globalVarsNames;
+	StringUSet globalVarsNames;
 
 	/// Assigned names to local variables of all functions in the module,
 	/// including function parameters.
 	///
 	/// To get the set of names assigned to the current function @c func,
 	/// use @c localVarsNames[func].
-	FuncStringSetMap localVarsNames;
+	FuncStringUSetMap localVarsNames;
 
 	/// The currently visited function.
 	ShPtr<Function> currFunc;
@@ -24,8 +24,8 @@ public:
 protected:
 	Segment* addSegment(const retdec::fileformat::Section* section, std::uint64_t address, std::uint64_t memSize);
 
-	void applyRelocations();
-	void resolveRelocation(const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol& sym);
+	void addRelocations();
+	virtual void resolveRelocation(const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol& sym) override;
 };
 
 } // namespace loader
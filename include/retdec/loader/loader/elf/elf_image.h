@@ -57,8 +57,8 @@ protected:
 	bool canLoadSections(const std::vector<retdec::fileformat::Section*>& sections) const;
 	void fixBssSegments();
 	void createExternSegment();
-	void applyRelocations();
-	void resolveRelocation(const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol& sym);
+	void addRelocations();
+	virtual void resolveRelocation(const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol& sym) override;
 
 	SegmentToSectionsTable createSegmentToSectionsTable();
 	const Segment* addSegment(const retdec::fileformat::SecSeg* secSeg, std::uint64_t address, std::uint64_t memSize);
@@ -12,6 +12,7 @@
 #include "retdec/utils/byte_value_storage.h"
 #include "retdec/fileformat/fftypes.h"
 #include "retdec/fileformat/file_format/file_format.h"
+#include "retdec/loader/loader/relocation_index.h"
 #include "retdec/loader/loader/segment.h"
 #include "retdec/loader/utils/name_generator.h"
 
@@ -40,6 +41,7 @@ public:
 
 	virtual bool getXByte(std::uint64_t address, std::uint64_t x, std::uint64_t& res, retdec::utils::Endianness e = retdec::utils::Endianness::UNKNOWN) const override;
 	virtual bool getXBytes(std::uint64_t address, std::uint64_t x, std::vector<std::uint8_t>& res) const override;
+	llvm::ArrayRef<std::uint8_t> getXBytesRef(std::uint64_t address, std::uint64_t x) const;
 
 	virtual bool setXByte(std::uint64_t address, std::uint64_t x, std::uint64_t val, retdec::utils::Endianness e = retdec::utils::Endianness::UNKNOWN) override;
 	virtual bool setXBytes(std::uint64_t address, const std::vector<std::uint8_t>& res) override;
@@ -75,22 +77,41 @@ public:
 	const std::string& getStatusMessage() const;
 	const retdec::fileformat::LoaderErrorInfo & getLoaderErrorInfo() const;
 
+	void resolveRelocations();
+	bool hasPendingRelocations() const;
+
 protected:
 	Segment* insertSegment(std::unique_ptr<Segment> segment);
 	void removeSegment(Segment* segment);
 	void nameSegment(Segment* segment);
 	void sortSegments();
+	void invalidateSegmentIndex();
 
 	void setStatusMessage(const std::string& message);
 
+	void addRelocation(const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol& sym, std::uint64_t size);
+	virtual void resolveRelocation(const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol& sym);
+
 private:
 	const Segment* _getSegment(std::size_t index) const;
 	const Segment* _getSegment(const std::string& name) const;
 	const Segment* _getSegmentWithIndex(std::size_t index) const;
 	const Segment* _getSegmentFromAddress(std::uint64_t address) const;
+	void _buildSegmentIndex() const;
+
+	/// Entry of the index of segments sorted by their start address.
+	struct SegmentIndexEntry
+	{
+		std::uint64_t address;    ///< Start address of the segment.
+		std::uint64_t maxEnd;     ///< Maximal end address of this and all preceding entries.
+		std::size_t position;     ///< Position of the segment in @c _segments.
+	};
 
 	std::shared_ptr<retdec::fileformat::FileFormat> _fileFormat;
 	std::vector<std::unique_ptr<Segment>> _segments;
+	mutable std::vector<SegmentIndexEntry> _segmentIndex;
+	mutable bool _segmentIndexValid = false;
+	RelocationIndex _relocations;
 	std::uint64_t _baseAddress;
 	NameGenerator _namelessSegNameGen;
 	std::string _statusMessage;
@@ -0,0 +1,76 @@
+/**
+ * @file include/retdec/loader/loader/relocation_index.h
+ * @brief Declaration of index of lazily applied relocations.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_LOADER_RETDEC_LOADER_RELOCATION_INDEX_H
+#define RETDEC_LOADER_RETDEC_LOADER_RELOCATION_INDEX_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "retdec/fileformat/types/relocation_table/relocation.h"
+#include "retdec/fileformat/types/symbol_table/symbol.h"
+
+namespace retdec {
+namespace loader {
+
+/**
+ * Relocations indexed by the addresses they patch, applied lazily.
+ *
+ * Images add their relocations here instead of applying them when they are
+ * loaded. A relocation is applied when a range of bytes it patches is first
+ * accessed, so only relocations in the parts of the image that are actually
+ * used are ever applied. Relocations that patch overlapping ranges are
+ * applied together, in the order in which they were added, so the result is
+ * the same as if all of them were applied at once.
+ *
+ * Resolution modifies the image data from methods that read them, so it is
+ * not thread-safe. Call resolveAll() before the image is read from several
+ * threads.
+ */
+class RelocationIndex
+{
+public:
+	using Resolver = std::function<void(const retdec::fileformat::Relocation&, const retdec::fileformat::Symbol&)>;
+
+	RelocationIndex(Resolver resolver);
+	RelocationIndex(const RelocationIndex&) = delete;
+	RelocationIndex& operator=(const RelocationIndex&) = delete;
+
+	void add(const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol& sym, std::uint64_t size);
+	void resolve(std::uint64_t address, std::uint64_t size);
+	void resolveAll();
+
+	bool hasPending() const;
+	std::size_t getNumberOfPending() const;
+
+private:
+	/// Relocation patching bytes <start, end).
+	struct Entry
+	{
+		std::uint64_t start;
+		std::uint64_t end;
+		std::size_t order;                            ///< Order in which it was added.
+		const retdec::fileformat::Relocation* rel;    ///< @c nullptr once applied.
+		const retdec::fileformat::Symbol* sym;
+	};
+
+	void buildIndex();
+	void apply(std::vector<Entry*>& entries);
+
+	Resolver _resolver;
+	std::vector<Entry> _entries;
+	/// Maximal end address of each entry and all preceding entries.
+	std::vector<std::uint64_t> _maxEnds;
+	bool _indexValid = true;
+	bool _resolving = false;
+	std::size_t _pending = 0;
+};
+
+} // namespace loader
+} // namespace retdec
+
+#endif
@@ -12,9 +12,12 @@
 #include <string>
 #include <vector>
 
+#include <llvm/ADT/ArrayRef.h>
+
 #include "retdec/common/range.h"
 #include "retdec/fileformat/fftypes.h"
 #include "retdec/fileformat/types/sec_seg/sec_seg.h"
+#include "retdec/loader/loader/relocation_index.h"
 #include "retdec/loader/loader/segment_data_source.h"
 #include "retdec/loader/utils/range.h"
 
@@ -46,6 +49,7 @@ public:
 
 	bool getBytes(std::vector<unsigned char>& result) const;
 	bool getBytes(std::vector<unsigned char>& result, std::uint64_t addressOffset, std::uint64_t size) const;
+	llvm::ArrayRef<std::uint8_t> getBytesRef(std::uint64_t addressOffset, std::uint64_t size) const;
 	bool getBits(std::string& result) const;
 	bool getBits(std::string& result, std::uint64_t addressOffset, std::uint64_t bytesCount) const;
 
@@ -56,13 +60,18 @@ public:
 
 	void addNonDecodableRange(retdec::common::Range<std::uint64_t> range);
 
+	void setRelocationIndex(RelocationIndex* relocations);
+
 private:
+	void resolveRelocations(std::uint64_t addressOffset, std::uint64_t size) const;
+
 	const retdec::fileformat::SecSeg* _secSeg;
 	std::uint64_t _address;
 	std::uint64_t _size;
 	std::unique_ptr<SegmentDataSource> _dataSource;
 	std::string _name;
 	retdec::common::RangeContainer<std::uint64_t> _nonDecodableRanges;
+	RelocationIndex* _relocations = nullptr; ///< Relocations applied lazily when data are accessed.
 };
 
 } // namespace loader
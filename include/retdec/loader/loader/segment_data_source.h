@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include <llvm/ADT/ArrayRef.h>
 #include <llvm/ADT/StringRef.h>
 
 namespace retdec {
@@ -31,6 +32,7 @@ public:
 	void resize(std::uint64_t newSize);
 	bool shrink(std::uint64_t newOffset, std::uint64_t newSize);
 
+	llvm::ArrayRef<std::uint8_t> getDataRef(std::uint64_t loadOffset, std::uint64_t loadSize) const;
 	bool loadData(std::uint64_t loadOffset, std::uint64_t loadSize, std::vector<std::uint8_t>& data) const;
 	bool saveData(std::uint64_t saveOffset, std::uint64_t saveSize, const std::vector<std::uint8_t>& data);
 
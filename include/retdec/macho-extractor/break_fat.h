@@ -27,10 +27,14 @@ class BreakMachOUniversal
 		/// @brief Auxiliary methods
 		/// @{
 		bool isArchive();
-		const char* getFileBufferStart();
 		bool getByArchFamily(
 				std::uint32_t cpuType,
 				llvm::object::MachOUniversalBinary::object_iterator &res);
+		bool getByFamilyName(
+				const std::string &familyName,
+				llvm::object::MachOUniversalBinary::object_iterator &res);
+		bool getBest(
+				llvm::object::MachOUniversalBinary::object_iterator &res);
 		bool extract(
 				llvm::object::MachOUniversalBinary::object_iterator &object,
 				const std::string &outPath);
@@ -47,6 +51,7 @@ class BreakMachOUniversal
 		/// @{
 		bool isValid();
 		bool isStaticLibrary();
+		const char* getFileBufferStart();
 		bool listArchitectures(
 				std::ostream &output,
 				bool withObjects = false);
@@ -70,6 +75,23 @@ class BreakMachOUniversal
 				const std::string &machoArchName,
 				const std::string &outPath);
 		/// @}
+
+		/// @brief In-place access methods
+		/// @{
+		bool getBestArchiveRange(
+				std::uint64_t &offset,
+				std::uint64_t &size);
+		bool getArchiveRangeForFamily(
+				const std::string &familyName,
+				std::uint64_t &offset,
+				std::uint64_t &size);
+		bool getArchiveRangeWithIndex(
+				unsigned index,
+				std::string &archName,
+				std::uint64_t &offset,
+				std::uint64_t &size);
+		unsigned getNumberOfArchives();
+		/// @}
 };
 
 } // namespace macho_extractor
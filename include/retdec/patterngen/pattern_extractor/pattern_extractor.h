@@ -7,6 +7,8 @@
 #ifndef RETDEC_PATTERNGEN_PATTERN_EXTRACTOR_PATTERN_EXTRACTOR_H
 #define RETDEC_PATTERNGEN_PATTERN_EXTRACTOR_PATTERN_EXTRACTOR_H
 
+#include <cstddef>
+#include <cstdint>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -37,6 +39,7 @@ class PatternExtractor
 		std::string errorMessage;          ///< Error message if invalid state.
 		std::vector<std::string> warnings; ///< Vector with possible warnings.
 
+		std::string sourcePath;              ///< Path to file for rules.
 		std::string groupName;               ///< Name for set of rules.
 		std::vector<SymbolPattern> patterns; ///< Vector of patterns found.
 
@@ -67,6 +70,9 @@ class PatternExtractor
 		/// @{
 		PatternExtractor(const std::string &filePath,
 			const std::string &groupName = "unknown_group");
+		PatternExtractor(const std::uint8_t *data, std::size_t size,
+			const std::string &sourcePath,
+			const std::string &groupName = "unknown_group");
 		~PatternExtractor();
 		/// @}
 
@@ -136,7 +136,7 @@ class PDBFile
 				pdb_loaded(false), pdb_initialized(false), pdb_filename(nullptr), pdb_version(0), page_size(0), pdb_file_size(
 				        0), pdb_file_data(
 				nullptr), num_streams(0), pdb_fpo_num(0), pdb_newfpo_num(0), pdb_sec_num(0), pdb_header(nullptr), pdb_root_dir(
-				nullptr), pdb_info_v700(nullptr), dbi_header_v700(nullptr), pdb_types(nullptr), pdb_symbols(nullptr)
+				nullptr), pdb_root_dir_copied(false), pdb_info_v700(nullptr), dbi_header_v700(nullptr), pdb_types(nullptr), pdb_symbols(nullptr)
 		{
 		}
 		;
@@ -152,13 +152,7 @@ class PDBFile
 		{
 			return pdb_version;
 		}
-		PDBStream * get_stream(unsigned int num)
-		{
-			if (num < num_streams)
-				return &streams[num];
-			else
-				return nullptr;
-		}
+		PDBStream * get_stream(unsigned int num);
 		const char * get_module_name(unsigned int num)
 		{
 			if (num < modules.size())
@@ -199,6 +193,8 @@ class PDBFile
 		// Internal functions
 		bool stream_is_linear(PDB_DWORD *pages, int num_pages);
 		char * extract_stream(PDB_DWORD *pages, int num_pages);
+		bool map_pdb_file(const char *filename);
+		void unmap_pdb_file(void);
 		PDBFileState load_pdb_v200(void);
 		PDBFileState load_pdb_v700(void);
 		void parse_modules(void);
@@ -220,6 +216,7 @@ class PDBFile
 		// Data structure pointers
 		PDB_HEADER * pdb_header;
 		PDB_ROOT * pdb_root_dir;
+		bool pdb_root_dir_copied;
 		PDBInfo70 * pdb_info_v700;
 		NewDBIHdr * dbi_header_v700;
 
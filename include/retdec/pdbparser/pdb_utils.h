@@ -94,10 +94,11 @@ typedef struct PDB__IMAGE_SECTION_HEADER
 // PDB Stream
 typedef struct _PDBStream
 {
-		char * data;  // stream data pointer
+		char * data;  // stream data pointer, nullptr until non-linear stream is extracted
 		int size;  // stream size in bytes
 		bool unused;  // indicates unused stream
 		bool linear;  // stream is linear in PDB file
+		PDB_DWORD * pages;  // indexes of pages used by stream
 } PDBStream;
 
 // PDB Modules vector
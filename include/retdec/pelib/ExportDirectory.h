@@ -51,6 +51,8 @@ namespace PeLib
 		  unsigned int size() const; // EXPORT
 		  /// Writes the current export directory to a file.
 		  int write(const std::string& strFilename, unsigned int uiOffset, unsigned int uiRva) const; // EXPORT
+		  /// Writes the current export directory to a stream.
+		  int write(std::ostream& ofFile, unsigned int uiOffset, unsigned int uiRva) const; // EXPORT
 
 		  /// Changes the name of the file (according to the export directory).
 		  void setNameString(const std::string& strFilename); // EXPORT
@@ -67,6 +67,7 @@ const std::uint32_t BuildNumber64Bit = 0x10000;     // Emulate 64-bit system
 const std::uint32_t IoFlagHeadersOnly = 1;          // Only load/save PE headers
 const std::uint32_t IoFlagNewFile     = 2;          // Create the PE as new file (for unpackers)
 const std::uint32_t IoFlagLoadAsImage = 4;          // Load the data as mapped image file
+const std::uint32_t IoFlagMapFileData = 8;          // Pages may refer to the file data, which must outlive the loader
 
 //-----------------------------------------------------------------------------
 // Structure for comparison with Windows mapped images
@@ -110,10 +111,21 @@ struct PELIB_FILE_PAGE
 		return true;
 	}
 
+	// Initializes the page as a view of a whole page of file data. The data are copied
+	// to the page's own buffer only when the page is written to.
+	void setViewPage(const std::uint8_t * data)
+	{
+		buffer.clear();
+		view = data;
+		isInvalidPage = false;
+		isZeroPage = false;
+	}
+
 	// Initializes the page as zero page. To save memory, we won't initialize buffer
 	void setZeroPage()
 	{
 		buffer.clear();
+		view = nullptr;
 		isInvalidPage = false;
 		isZeroPage = true;
 	}
@@ -124,7 +136,13 @@ struct PELIB_FILE_PAGE
 		{
 			// Make sure that there is buffer allocated
 			if(buffer.size() != PELIB_PAGE_SIZE)
-				buffer.resize(PELIB_PAGE_SIZE);
+			{
+				if(view != nullptr)
+					buffer.assign(view, view + PELIB_PAGE_SIZE);
+				else
+					buffer.resize(PELIB_PAGE_SIZE);
+				view = nullptr;
+			}
 
 			// Copy the data, up to page size
 			if((offset + length) > PELIB_PAGE_SIZE)
@@ -133,7 +151,16 @@ struct PELIB_FILE_PAGE
 		}
 	}
 
-	ByteBuffer buffer;                    // A page-sized buffer, holding one image page. Empty if isInvalidPage
+	// Returns the page data, or nullptr for a page without data (zeroed or invalid)
+	const std::uint8_t * data() const
+	{
+		if(view != nullptr)
+			return view;
+		return buffer.empty() ? nullptr : buffer.data();
+	}
+
+	ByteBuffer buffer;                    // A page-sized buffer, holding one image page. Empty if isInvalidPage or a view
+	const std::uint8_t * view = nullptr;  // A page of file data viewed by the page (see IoFlagMapFileData)
 	bool isInvalidPage;                   // For invalid pages within image (SectionAlignment > 0x1000)
 	bool isZeroPage;                      // For sections with VirtualSize != 0, RawSize = 0
 };
@@ -426,6 +453,7 @@ class ImageLoader
 									  std::uint32_t pointerToRawData,
 									  std::uint32_t sizeOfRawData,
 									  std::uint32_t characteristics,
+									  std::uint32_t loadFlags,
 									  bool isImageHeader = false);
 
 	bool isGoodPagePointer(PFN_VERIFY_ADDRESS PfnVerifyAddress, void * pagePtr);
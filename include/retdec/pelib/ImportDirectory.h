@@ -155,6 +155,8 @@ namespace PeLib
 		  unsigned int calculateSize(std::uint32_t pointerSize) const; // EXPORT
 		  /// Writes the import directory to a file.
 		  int write(const std::string& strFilename, std::uint32_t uiOffset, std::uint32_t uiRva, std::uint32_t pointerSize); // EXPORT
+		  /// Writes the import directory to a stream.
+		  int write(std::ostream& ofFile, std::uint32_t uiOffset, std::uint32_t uiRva, std::uint32_t pointerSize); // EXPORT
 		  /// Updates the pointer size for the import directory
 		  void setPointerSize(std::uint32_t pointerSize);
 
@@ -1024,6 +1026,22 @@ namespace PeLib
 			return ERROR_OPENING_FILE;
 		}
 
+		int ret = write(static_cast<std::ostream&>(ofFile), uiOffset, uiRva, pointerSize);
+		ofFile.close();
+
+		return ret;
+	}
+
+	/**
+	* Writes the current import directory to a stream.
+	* @param ofFile Output stream (e.g. opened file).
+	* @param uiOffset File Offset of the new import directory.
+	* @param uiRva RVA which belongs to that file offset.
+	* @param pointerSize Size of the pointer (4 bytes or 8 bytes)
+	**/
+	inline
+	int ImportDirectory::write(std::ostream& ofFile, std::uint32_t uiOffset, std::uint32_t uiRva, std::uint32_t pointerSize)
+	{
 		ofFile.seekp(uiOffset, std::ios_base::beg);
 
 		std::vector<std::uint8_t> vBuffer;
@@ -1032,7 +1050,6 @@ namespace PeLib
 		rebuild(vBuffer, uiRva);
 
 		ofFile.write(reinterpret_cast<const char*>(vBuffer.data()), vBuffer.size());
-		ofFile.close();
 
 		std::copy(m_vNewiid.begin(), m_vNewiid.end(), std::back_inserter(m_vOldiid));
 		m_vNewiid.clear();
@@ -16,6 +16,8 @@
 #include <vector>
 #include <iterator>
 #include <cassert>
+#include <cstring>
+#include <type_traits>
 
 namespace PeLib
 {
@@ -37,10 +39,23 @@ namespace PeLib
 //jk: temporarily disabled because of fails on 64bit systems
 //			assert(ulIndex + sizeof(value) <= m_vBuffer.size());
 
-			std::vector<char> data(sizeof(T), 0);
-			std::size_t size = ulIndex + sizeof(T) > m_vBuffer.size() ? m_vBuffer.size() - ulIndex : sizeof(T);
-			read(data.data(), (unsigned long)size);
-			value = *reinterpret_cast<T*>(data.data());
+			static_assert(std::is_trivially_copyable<T>::value, "InputBuffer can only read trivially copyable types");
+
+			// Bytes missing at the end of the buffer are read as zeros
+			char data[sizeof(T)] = {};
+			read(data, sizeof(T));
+			std::memcpy(&value, data, sizeof(T));
+			return *this;
+		  }
+
+		  /// Reads @a count consecutive values at once. Values missing at the end of the buffer are zeroed.
+		  template<typename T>
+		  InputBuffer& readArray(T* values, std::size_t count)
+		  {
+			static_assert(std::is_trivially_copyable<T>::value, "InputBuffer can only read trivially copyable types");
+
+			std::memset(values, 0, count * sizeof(T));
+			read(reinterpret_cast<char*>(values), (unsigned long)(count * sizeof(T)));
 			return *this;
 		  }
 
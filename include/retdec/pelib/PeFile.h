@@ -135,8 +135,9 @@ namespace PeLib
 		/// Load the PE file using the already-open stream
 		int loadPeHeaders(bool loadHeadersOnly = false);
 
-		/// Alternate load - can be used when the data are already loaded to memory to prevent duplicating large buffers
-		int loadPeHeaders(ByteBuffer & fileData, bool loadHeadersOnly = false);
+		/// Alternate load - can be used when the data are already loaded to memory to prevent duplicating large buffers.
+		/// If mapFileData is set, the image refers to fileData instead of copying it, so fileData must outlive the PE file.
+		int loadPeHeaders(ByteBuffer & fileData, bool loadHeadersOnly = false, bool mapFileData = false);
 
 		/// returns PEFILE64 or PEFILE32
 		int getFileType() const;
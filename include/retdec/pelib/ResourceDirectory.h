@@ -135,10 +135,15 @@ namespace PeLib
 
 		private:
 		  /// The resource data.
-		  std::vector<std::uint8_t> m_data;
+		  mutable std::vector<std::uint8_t> m_data;
+		  /// Image from which the resource data are read on first access. Null once they are loaded.
+		  mutable ImageLoader* m_dataLoader = nullptr;
 		  /// PeLib equivalent of the Win32 structure IMAGE_RESOURCE_DATA_ENTRY
 		  PELIB_IMAGE_RESOURCE_DATA_ENTRY entry;
 
+		  /// Reads the resource data from the image if they were not read yet.
+		  void loadData() const;
+
 		protected:
 		  int read(ImageLoader & imageLoader, std::uint32_t uiRsrcRva, std::uint32_t uiOffset, std::uint32_t sizeOfImage, ResourceDirectory* resDir);
 		  /// Writes the next resource leaf into the OutputBuffer.
@@ -420,6 +425,8 @@ namespace PeLib
 //		  unsigned int size() const;
 		  /// Writes the resource directory to a file.
 		  int write(const std::string& strFilename, unsigned int uiOffset, unsigned int uiRva) const;
+		  /// Writes the resource directory to a stream.
+		  int write(std::ostream& ofFile, unsigned int uiOffset, unsigned int uiRva) const;
 
 		  /// Adds a new resource type.
 		  int addResourceType(std::uint32_t dwResTypeId);
@@ -700,6 +707,7 @@ namespace PeLib
 		std::vector<ResourceChild>::const_iterator ResIter = locateResourceT(restypeid, resid);
 		ResourceNode* currNode = static_cast<ResourceNode*>(ResIter->child);
 		ResourceLeaf* currLeaf = static_cast<ResourceLeaf*>(currNode->children[0].child);
+		currLeaf->loadData();
 		data.assign(currLeaf->m_data.begin(), currLeaf->m_data.end());
 
 		return ERROR_NONE;
@@ -717,7 +725,7 @@ namespace PeLib
 		std::vector<ResourceChild>::iterator ResIter = locateResourceT(restypeid, resid);
 		ResourceNode* currNode = static_cast<ResourceNode*>(ResIter->child);
 		ResourceLeaf* currLeaf = static_cast<ResourceLeaf*>(currNode->children[0].child);
-		currLeaf->m_data.assign(data.begin(), data.end());
+		currLeaf->setData(data);
 
 		return ERROR_NONE;
 	}
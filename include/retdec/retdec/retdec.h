@@ -7,6 +7,13 @@
 #ifndef RETDEC_RETDEC_RETDEC_H
 #define RETDEC_RETDEC_RETDEC_H
 
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
 #include <capstone/capstone.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
@@ -41,16 +48,179 @@ LlvmModuleContextPair disassemble(
 		retdec::common::FunctionSet* fs = nullptr
 );
 
+/**
+ * Disassemble the \p size bytes of input file content at \p data.
+ * The data are not copied and must stay valid during the whole disassembly.
+ *
+ * \param[in]  data Input file content.
+ * \param[in]  size Size of \p data.
+ * \param[out] fs   Set of functions to fill.
+ * \return Pointer to LLVM module created by the disassembly,
+ *         or \c nullptr if the disassembly failed.
+ */
+LlvmModuleContextPair disassemble(
+		const std::uint8_t* data,
+		std::size_t size,
+		retdec::common::FunctionSet* fs = nullptr
+);
+
+/**
+ * Callback receiving functions created by the disassembly.
+ * It returns \c true to continue with the next function, or \c false to
+ * stop the disassembly.
+ */
+using FunctionCallback = std::function<bool(retdec::common::Function&&)>;
+
+/**
+ * Disassemble the input file and pass each of its functions to \p cb as
+ * soon as it is created, instead of collecting all of them.
+ * The callback takes ownership of the function, and it can keep only the
+ * parts it needs.
+ *
+ * Instructions in the functions' basic blocks are owned by the disassembly
+ * and they are valid only during the callback. The LLVM module is destroyed
+ * when the function returns.
+ *
+ * \param[in] inputPath Path the the input file to disassemble.
+ * \param[in] cb        Callback called for every function.
+ * \return \c false if \p cb stopped the disassembly, \c true otherwise.
+ */
+bool disassemble(
+		const std::string& inputPath,
+		const FunctionCallback& cb
+);
+
+/**
+ * Same as the callback based disassembly of a file above, but for the
+ * \p size bytes of input file content at \p data.
+ */
+bool disassemble(
+		const std::uint8_t* data,
+		std::size_t size,
+		const FunctionCallback& cb
+);
+
+/**
+ * Outputs of a decompilation kept in memory.
+ */
+struct DecompilationResult
+{
+	/// Decompiled code in the target high-level language.
+	std::string hll;
+	/// Configuration (JSON) updated by the decompilation.
+	std::string config;
+	/// Final LLVM IR, only if it was requested.
+	std::string llvmIr;
+};
+
 /**
  * Run a decompilation according to a \p config configuration.
  * If \p outString is set, decompilation output will be returned
  * in this string. Otherwise, output file is expected to be set in \p config.
+ *
+ * The decompilation can be cancelled through a
+ * \c retdec::utils::CancellationToken made current in the calling thread by
+ * \c retdec::utils::CancellationScope. It is checked between passes and in
+ * the long-running loops, and \c retdec::utils::OperationCancelled is thrown
+ * when the token is cancelled. Every pass is a cancellation phase: when the
+ * token's phase budget is spent, the pass finishes early in a cheaper way.
  */
 bool decompile(
 		retdec::config::Config& config,
 		std::string* outString = nullptr
 );
 
+/**
+ * Run a decompilation according to a \p config configuration on the input
+ * file content \p inputData held in memory. The input file set in \p config
+ * is not read, it is used only to name the outputs.
+ */
+bool decompile(
+		retdec::config::Config& config,
+		const std::vector<std::uint8_t>& inputData,
+		std::string* outString = nullptr
+);
+
+/**
+ * Run a decompilation according to a \p config configuration on the
+ * \p size bytes of input file content at \p data, e.g. a slice of a fat
+ * Mach-O or an object of an archive. The data are not copied and must stay
+ * valid during the whole decompilation.
+ */
+bool decompile(
+		retdec::config::Config& config,
+		const std::uint8_t* data,
+		std::size_t size,
+		std::string* outString = nullptr
+);
+
+/**
+ * Run a decompilation according to a \p config configuration on the
+ * \p size bytes of input file content at \p data and keep all its outputs
+ * in \p result. No files are read or written: the output files set in
+ * \p config are ignored (\p config itself is not modified), and the input
+ * file set in it is used only to name the outputs.
+ *
+ * \param[in]  config Decompilation configuration.
+ * \param[in]  data   Input file content, it must stay valid during the
+ *                    whole decompilation.
+ * \param[in]  size   Size of \p data.
+ * \param[out] result Decompilation outputs.
+ * \param[in]  llvmIr Also print the final LLVM IR into \p result.
+ */
+bool decompile(
+		const retdec::config::Config& config,
+		const std::uint8_t* data,
+		std::size_t size,
+		DecompilationResult* result,
+		bool llvmIr = false
+);
+
+/**
+ * Same as the decompilation of data in memory above, but the input file
+ * content is read from \p input first.
+ */
+bool decompile(
+		const retdec::config::Config& config,
+		std::istream& input,
+		DecompilationResult* result,
+		bool llvmIr = false
+);
+
+/**
+ * Resume a decompilation according to a \p config configuration from the
+ * LLVM IR bitcode in \p bitcodeFile, which was written by the
+ * \c retdec-write-bc pass of an earlier decompilation of the same input.
+ * Only the passes following the last \c retdec-write-bc pass are run.
+ * \p config has to be the configuration saved by that decompilation.
+ * Functions of the bitcode are renamed according to \p renames (old name to
+ * new name), which \p config must already use. If functions or ranges are
+ * selected in \p config, bodies of the other functions are removed.
+ */
+bool decompileBitcode(
+		retdec::config::Config& config,
+		const std::string& bitcodeFile,
+		std::string* outString = nullptr,
+		const std::map<std::string, std::string>& renames = {}
+);
+
+/**
+ * Split the LLVM IR bitcode in \p bitcodeFile into shards, which can be
+ * decompiled by \c decompileBitcode() independently of each other, and write
+ * them into \p shardFiles. Every shard keeps all the global variables and
+ * declarations of all the functions, but only a part of the function bodies.
+ * Each function body is in exactly one shard. Shards get contiguous runs of
+ * functions (in the module order) of roughly the same number of instructions.
+ *
+ * The optimized BIR of the shards, saved with
+ * \c Parameters::setIsBackendBirOnly(), can then be merged by a decompilation
+ * of the whole \p bitcodeFile with \c Parameters::inputBirShards.
+ */
+void splitBitcode(
+		const std::string& bitcodeFile,
+		const std::vector<std::string>& shardFiles
+);
+
 } // namespace retdec
 
 #endif
@@ -23,8 +23,8 @@ namespace loader {
 class RttiFinder
 {
 	public:
-		void findGcc(const retdec::loader::Image* img);
-		void findMsvc(const retdec::loader::Image* img);
+		void findGcc(const retdec::loader::Image* img, unsigned threads = 1);
+		void findMsvc(const retdec::loader::Image* img, unsigned threads = 1);
 
 		const VtablesGcc& getVtablesGcc() const;
 		const VtablesMsvc& getVtablesMsvc() const;
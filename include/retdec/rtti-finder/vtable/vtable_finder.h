@@ -26,12 +26,14 @@ namespace loader {
 void findGccVtables(
 		const retdec::loader::Image* img,
 		VtablesGcc& vtables,
-		RttiGcc& rttis);
+		RttiGcc& rttis,
+		unsigned threads = 1);
 
 void findMsvcVtables(
 		const retdec::loader::Image* img,
 		VtablesMsvc& vtables,
-		RttiMsvc& rttis);
+		RttiMsvc& rttis,
+		unsigned threads = 1);
 
 } // namespace rtti_finder
 } // namespace retdec
@@ -0,0 +1,89 @@
+/**
+ * @file include/retdec/serdes/binary.h
+ * @brief Compact binary (de)serialization format.
+ * @copyright (c) 2019 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_SERDES_BINARY_H
+#define RETDEC_SERDES_BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <rapidjson/document.h>
+
+namespace retdec {
+namespace serdes {
+
+/**
+ * Version of the binary format. It must be increased whenever the encoding
+ * changes, data of other versions are refused by the reader.
+ */
+const uint32_t BINARY_FORMAT_VERSION = 1;
+
+/**
+ * Writer of the binary format.
+ *
+ * It has the same interface as rapidjson writers, so all the serialization
+ * functions may use it instead of them. The binary format encodes the same
+ * JSON value model, but integers are stored as variable-length numbers and
+ * every object key is stored only once, all its other occurrences refer to
+ * it by a number. Tokens are written directly to the output stream.
+ */
+class BinaryWriter
+{
+	public:
+		using Ch = char;
+
+	public:
+		explicit BinaryWriter(std::ostream& out);
+
+		bool Null();
+		bool Bool(bool b);
+		bool Int(int i);
+		bool Uint(unsigned u);
+		bool Int64(int64_t i);
+		bool Uint64(uint64_t u);
+		bool Double(double d);
+		bool String(const char* str, rapidjson::SizeType length, bool copy = false);
+		bool String(const char* str);
+		bool String(const std::string& str);
+		bool Key(const char* str, rapidjson::SizeType length, bool copy = false);
+		bool StartObject();
+		bool EndObject(rapidjson::SizeType memberCount = 0);
+		bool StartArray();
+		bool EndArray(rapidjson::SizeType elementCount = 0);
+
+	private:
+		enum class State
+		{
+			ARRAY,
+			OBJECT_KEY,
+			OBJECT_VALUE
+		};
+
+	private:
+		bool writeValue(uint8_t tag);
+		bool writeKey(const char* str, std::size_t length);
+		void writeVarUint(uint64_t u);
+		void writeBytes(const char* data, std::size_t size);
+
+	private:
+		std::ostream& _out;
+		/// States of all currently open objects and arrays.
+		std::vector<State> _containers;
+		/// Numbers of already written object keys.
+		std::unordered_map<std::string, uint64_t> _keys;
+};
+
+bool isBinary(const char* data, std::size_t size);
+bool readBinary(const char* data, std::size_t size, rapidjson::Document& doc);
+
+} // namespace serdes
+} // namespace retdec
+
+#endif
@@ -12,10 +12,21 @@
 
 #include <rapidjson/document.h>
 #include <rapidjson/encodings.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "retdec/serdes/binary.h"
 
 namespace retdec {
 namespace serdes {
 
+/// Writer of compact JSON directly into a stream.
+using JsonStreamWriter = rapidjson::Writer<rapidjson::OStreamWrapper>;
+/// Writer of pretty printed JSON directly into a stream.
+using PrettyJsonStreamWriter = rapidjson::PrettyWriter<rapidjson::OStreamWrapper>;
+
 /**
  * Explicitly instantiate all the needed serialization functions of form:
  * @code
@@ -29,6 +40,15 @@ namespace serdes {
 		const T&);                                                             \
 	template void serialize(                                                   \
 		rapidjson::PrettyWriter<rapidjson::StringBuffer, rapidjson::ASCII<>>&, \
+		const T&);                                                             \
+	template void serialize(                                                   \
+		retdec::serdes::JsonStreamWriter&,                                     \
+		const T&);                                                             \
+	template void serialize(                                                   \
+		retdec::serdes::PrettyJsonStreamWriter&,                               \
+		const T&);                                                             \
+	template void serialize(                                                   \
+		retdec::serdes::BinaryWriter&,                                         \
 		const T&);
 
 int64_t deserializeInt64(
@@ -21,6 +21,9 @@ namespace retdec {
 namespace loader {
 	class Image;
 } // namespace loader
+namespace yaracpp {
+	class YaraDetector;
+} // namespace yaracpp
 
 namespace stacofin {
 
@@ -138,6 +141,8 @@ class Finder
 	private:
 		/// Code coverage.
 		CoveredCode coveredCode;
+		/// Directory with cached compiled signatures, empty if not used.
+		std::string _cacheDirectory;
 
 		DetectedFunctionsMultimap _allDetections;
 		DetectedFunctionsPtrMap _confirmedDetections;
@@ -158,6 +163,10 @@ class Finder
 		using ByteData = typename std::pair<const std::uint8_t*, std::size_t>;
 
 	private:
+		void searchDetector(
+				const retdec::loader::Image& image,
+				yaracpp::YaraDetector& detector,
+				const std::string& yaraFile);
 		bool initDisassembler();
 		void solveReferences();
 
@@ -169,6 +178,7 @@ class Finder
 
 		void checkRef(Reference& ref);
 		void checkRef_x86(Reference& ref);
+		common::Address getImportStubTarget_x86(common::Address addr);
 
 		void confirmWithoutRefs();
 		void confirmAllRefsOk(std::size_t minFncSzWithoutRefs = 0x20);
@@ -185,6 +195,13 @@ class Finder
 
 		std::map<common::Address, std::string> _imports;
 		std::set<std::string> _sectionNames;
+
+		/// Decoded targets of reference sites, keyed by site address and
+		/// thumb mode. Overlapping detections share many reference sites.
+		std::map<std::pair<common::Address, bool>, common::Address> _refTargets;
+		/// Memory operands of import stub jumps at reference targets,
+		/// undefined if there is no stub.
+		std::map<common::Address, common::Address> _importStubs_x86;
 };
 
 } // namespace stacofin
@@ -8,6 +8,7 @@
 #define RETDEC_UNPACKER_DECOMPRESSION_COMPRESSED_DATA_H
 
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 #include "retdec/utils/dynamic_buffer.h"
@@ -26,7 +27,7 @@ class CompressedData
 {
 public:
 	CompressedData() = delete;
-	CompressedData(const DynamicBuffer& buffer) : _buffer(buffer) {} ///< Constructor.
+	CompressedData(DynamicBuffer buffer) : _buffer(std::move(buffer)) {} ///< Constructor.
 	CompressedData(const CompressedData& data) : _buffer(data._buffer) {} ///< Copy constructor.
 	virtual ~CompressedData() = default;
 
@@ -42,7 +43,7 @@ public:
 	 *
 	 * @param buffer New buffer to set.
 	 */
-	void setBuffer(const DynamicBuffer& buffer) { _buffer = buffer; }
+	void setBuffer(DynamicBuffer buffer) { _buffer = std::move(buffer); }
 
 	/**
 	 * Pure virtual method for decompressing the data.
@@ -53,6 +54,17 @@ public:
 	 */
 	virtual bool decompress(DynamicBuffer& outputBuffer) = 0;
 
+	/**
+	 * Returns whether the last decompression reached the end of compressed data.
+	 * Failed decompression that did not reach it failed because of the data
+	 * themselves, so it fails the same way on any longer data with the same
+	 * beginning. Data which do not track their reading position always
+	 * report that the end was reached.
+	 *
+	 * @return True if the end of compressed data was reached, otherwise false.
+	 */
+	virtual bool isInputExhausted() const { return true; }
+
 protected:
 	DynamicBuffer _buffer; ///< Buffer containg the compressed data.
 
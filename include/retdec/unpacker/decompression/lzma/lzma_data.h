@@ -43,10 +43,11 @@ class LzmaData : public CompressedData
 {
 public:
 	LzmaData() = delete;
-	LzmaData(const DynamicBuffer& buffer, uint8_t pb, uint8_t lp, uint8_t lc);
+	LzmaData(DynamicBuffer buffer, uint8_t pb, uint8_t lp, uint8_t lc);
 	LzmaData(const LzmaData& data) = delete;
 
 	virtual bool decompress(DynamicBuffer& outputBuffer) override;
+	virtual bool isInputExhausted() const override;
 
 private:
 	LzmaData& operator =(const LzmaData&);
@@ -19,7 +19,7 @@ class LzmatData : public CompressedData
 {
 public:
 	LzmatData() = delete;
-	LzmatData(const DynamicBuffer& buffer);
+	LzmatData(DynamicBuffer buffer);
 	LzmatData(const LzmatData&) = delete;
 
 	virtual bool decompress(DynamicBuffer& outputBuffer) override;
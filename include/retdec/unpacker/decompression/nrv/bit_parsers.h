@@ -7,6 +7,8 @@
 #ifndef RETDEC_UNPACKER_DECOMPRESSION_NRV_BIT_PARSERS_H
 #define RETDEC_UNPACKER_DECOMPRESSION_NRV_BIT_PARSERS_H
 
+#include <algorithm>
+
 #include "retdec/fileformat/fftypes.h"
 #include "retdec/utils/dynamic_buffer.h"
 
@@ -23,6 +25,7 @@ public:
 	virtual ~BitParser() = default;
 
 	virtual bool getBit(uint8_t& bit, const DynamicBuffer& data, uint32_t& pos) = 0;
+	virtual void reset() = 0;
 
 private:
 	BitParser& operator =(const BitParser&);
@@ -38,6 +41,11 @@ public:
 
 	BitParserN(const BitParser&) = delete;
 
+	virtual void reset() override
+	{
+		_value = 0;
+	}
+
 protected:
 	T _value;
 
@@ -45,7 +53,11 @@ private:
 	BitParserN& operator =(const BitParserN&);
 };
 
-class BitParser8 : public BitParserN<uint32_t>
+/**
+ * Bits are stored in bytes. Class is final, so decompressors which know
+ * the exact type of parser call @c getBit() directly.
+ */
+class BitParser8 final : public BitParserN<uint32_t>
 {
 public:
 	BitParser8() = default;
@@ -60,7 +72,7 @@ public:
 			if (pos >= data.getRealDataSize())
 				return false;
 
-			_value = data.read<uint8_t>(pos++, retdec::utils::Endianness::LITTLE);
+			_value = data.getRawBuffer()[pos++];
 
 			bit = (_value >> 7) & 1;
 			_value <<= 1;
@@ -71,7 +83,12 @@ public:
 	}
 };
 
-class BitParserLe32 : public BitParserN<uint32_t>
+/**
+ * Bits are stored in little endian 32-bit words. Class is final, so
+ * decompressors which know the exact type of parser call @c getBit()
+ * directly.
+ */
+class BitParserLe32 final : public BitParserN<uint32_t>
 {
 public:
 	BitParserLe32() = default;
@@ -83,10 +100,16 @@ public:
 		_value <<= 1;
 		if (_value == 0)
 		{
-			if (pos >= data.getRealDataSize())
+			const auto size = data.getRealDataSize();
+			if (pos >= size)
 				return false;
 
-			_value = data.read<uint32_t>(pos, retdec::utils::Endianness::LITTLE);
+			// Missing bytes at the end of data are read as zeroes.
+			const auto* bytes = data.getRawBuffer() + pos;
+			const auto available = std::min<uint32_t>(size - pos, 4);
+			_value = 0;
+			for (uint32_t i = 0; i < available; ++i)
+				_value |= static_cast<uint32_t>(bytes[i]) << (i << 3);
 			pos += 4;
 
 			bit = (_value >> 31) & 1;
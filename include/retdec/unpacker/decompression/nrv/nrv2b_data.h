@@ -20,12 +20,14 @@ class Nrv2bData : public NrvData
 {
 public:
 	Nrv2bData() = delete;
-	Nrv2bData(const DynamicBuffer& buffer, BitParser* bitParser);
+	Nrv2bData(DynamicBuffer buffer, BitParser* bitParser);
 	Nrv2bData(const Nrv2bData&) = delete;
 
 	virtual bool decompress(DynamicBuffer& outputBuffer) override;
 
 private:
+	template <typename T> bool decompress(T& bitParser, DynamicBuffer& outputBuffer);
+
 	Nrv2bData& operator =(const Nrv2bData&);
 };
 
@@ -20,12 +20,14 @@ class Nrv2dData : public NrvData
 {
 public:
 	Nrv2dData() = delete;
-	Nrv2dData(const DynamicBuffer& buffer, BitParser* bitParser);
+	Nrv2dData(DynamicBuffer buffer, BitParser* bitParser);
 	Nrv2dData(const Nrv2dData&) = delete;
 
 	virtual bool decompress(DynamicBuffer& outputBuffer) override;
 
 private:
+	template <typename T> bool decompress(T& bitParser, DynamicBuffer& outputBuffer);
+
 	Nrv2dData& operator =(const Nrv2dData&);
 };
 
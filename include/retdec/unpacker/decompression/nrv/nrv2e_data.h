@@ -20,12 +20,14 @@ class Nrv2eData : public NrvData
 {
 public:
 	Nrv2eData() = delete;
-	Nrv2eData(const DynamicBuffer& buffer, BitParser* bitParser);
+	Nrv2eData(DynamicBuffer buffer, BitParser* bitParser);
 	Nrv2eData(const Nrv2eData&) = delete;
 
 	virtual bool decompress(DynamicBuffer& outputBuffer) override;
 
 private:
+	template <typename T> bool decompress(T& bitParser, DynamicBuffer& outputBuffer);
+
 	Nrv2eData& operator =(const Nrv2eData&);
 };
 
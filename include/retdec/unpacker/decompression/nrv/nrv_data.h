@@ -17,16 +17,36 @@ class NrvData : public CompressedData
 {
 public:
 	NrvData() = delete;
-	NrvData(const DynamicBuffer& buffer, BitParser* bitParser) : CompressedData(buffer), _readPos(0), _writePos(0), _bitParser(bitParser) {}
+	NrvData(DynamicBuffer buffer, BitParser* bitParser) : CompressedData(std::move(buffer)), _readPos(0), _writePos(0), _bitParser(bitParser) {}
 	NrvData(const NrvData&) = delete;
 
 	void reset()
 	{
 		_readPos = 0;
 		_writePos = 0;
+		_bitParser->reset();
+	}
+
+	virtual bool isInputExhausted() const override
+	{
+		return _readPos >= _buffer.getRealDataSize();
 	}
 
 protected:
+	/**
+	 * Call @a fnc with bit parser cast to its final type, so the bit
+	 * reading in decompression loops is not a virtual call. Unknown
+	 * parsers are passed as @c BitParser.
+	 */
+	template <typename Fnc> bool withBitParser(Fnc&& fnc)
+	{
+		if (auto* parser = dynamic_cast<BitParser8*>(_bitParser))
+			return fnc(*parser);
+		if (auto* parser = dynamic_cast<BitParserLe32*>(_bitParser))
+			return fnc(*parser);
+		return fnc(*_bitParser);
+	}
+
 	uint32_t _readPos, _writePos;
 	BitParser* _bitParser;
 
@@ -7,11 +7,15 @@
 #ifndef RETDEC_UNPACKER_PLUGIN_H
 #define RETDEC_UNPACKER_PLUGIN_H
 
+#include <cstdint>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
+#include "retdec/utils/file_io.h"
 #include "retdec/utils/io/log.h"
+#include "retdec/utils/memory_stream.h"
 #include "retdec/unpacker/unpacker_exception.h"
 
 #define plugin(T) retdec::unpackertool::Plugin::instance<T>()
@@ -83,7 +87,7 @@ public:
 	struct Arguments
 	{
 		std::string inputFile; ///< Path to the input file (packed file).
-		std::string outputFile; ///< Path to the output file (unpacked file).
+		std::string outputFile; ///< Path to the output file (unpacked file). If empty, unpacked file is kept only in memory.
 		bool brute; ///< Brute mode of the unpacking was chosen.
 	};
 
@@ -109,6 +113,17 @@ public:
 		return &startupArgs;
 	}
 
+	/**
+	 * Returns the unpacked file produced by the last successful run of the plugin.
+	 * It is available even if no output file was requested.
+	 *
+	 * @return Bytes of the unpacked file.
+	 */
+	const std::vector<std::uint8_t>& getUnpackedData() const
+	{
+		return _output.getData();
+	}
+
 	/**
 	 * Runs the plugin and all its phases. Also sets the startup arguments of the plugin.
 	 *
@@ -127,11 +142,18 @@ public:
 
 		_cachedExitCode = PLUGIN_EXIT_UNPACKED;
 		startupArgs = args;
+		_output.reset();
 
 		try
 		{
 			prepare();
 			unpack();
+
+			if (!startupArgs.outputFile.empty()
+					&& !retdec::utils::writeFile(startupArgs.outputFile, _output.getData()))
+			{
+				throw retdec::unpacker::FatalException("Unable to write output file '", startupArgs.outputFile, "'.");
+			}
 		}
 		catch (const retdec::unpacker::FatalException& ex)
 		{
@@ -207,11 +229,23 @@ protected:
 	Plugin(const Plugin&);
 	Plugin& operator =(const Plugin&);
 
+	/**
+	 * Returns the stream the plugin writes the unpacked file to. Plugins never write
+	 * the output file directly, the stream is saved into it after the successful unpacking.
+	 *
+	 * @return Output stream.
+	 */
+	std::ostream& getOutput()
+	{
+		return _output;
+	}
+
 	Plugin::Info info; ///< The static info of the plugin.
 	Plugin::Arguments startupArgs; ///< Startup arguments of the plugin.
 
 private:
 	PluginExitCode _cachedExitCode; ///< Cached exit code of the plugin for the unpacked file.
+	retdec::utils::MemoryStream _output; ///< Unpacked file.
 
 	template <typename T, typename... Args> static void logImpl(Logger& out, const T& data, const Args&... args)
 	{
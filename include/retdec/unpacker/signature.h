@@ -160,8 +160,8 @@ public:
 private:
 	Signature& operator =(const Signature&);
 
-	bool searchMatchImpl(const std::vector<uint8_t>& bytesToMatch, uint64_t offset, uint64_t maxSearchDist, retdec::utils::DynamicBuffer* captureBuffer) const;
-	int64_t matchImpl(const std::vector<uint8_t>& bytesToMatch, uint64_t offset, retdec::utils::DynamicBuffer* captureBuffer) const;
+	bool searchMatchImpl(retdec::utils::Span<const uint8_t> bytesToMatch, uint64_t offset, uint64_t maxSearchDist, retdec::utils::DynamicBuffer* captureBuffer) const;
+	int64_t matchImpl(retdec::utils::Span<const uint8_t> bytesToMatch, uint64_t offset, retdec::utils::DynamicBuffer* captureBuffer) const;
 
 	std::vector<Signature::Byte> _buffer; ///< Signature bytes buffer.
 };
@@ -7,6 +7,7 @@
 #ifndef RETDEC_UNPACKER_UNPACKING_STUB_H
 #define RETDEC_UNPACKER_UNPACKING_STUB_H
 
+#include <ostream>
 #include <string>
 
 namespace retdec {
@@ -39,9 +40,9 @@ public:
 	/**
 	 * Pure virtual method that should implement unpacking process in its subclasses.
 	 *
-	 * @param outputFile Path to the output unpacked file.
+	 * @param output Stream the unpacked file is written to.
 	 */
-	virtual void unpack(const std::string& outputFile) = 0;
+	virtual void unpack(std::ostream& output) = 0;
 
 	/**
 	 * Pure virtual method that should free all owned resources.
@@ -7,11 +7,34 @@
 #ifndef RETDEC_UNPACKERTOOL_UNPACKERTOOL_H
 #define RETDEC_UNPACKERTOOL_UNPACKERTOOL_H
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace retdec {
 namespace unpackertool {
 
 int _main(int argc, char** argv);
 
+/**
+ * Unpack \p inputFile into memory, no output file is created.
+ * \param[in]  inputFile    Path to the packed file.
+ * \param[out] unpackedData Content of the unpacked file.
+ * \param[in]  brute        Run plugins in the brute mode.
+ * \return Unpacker exit code, \c 0 if the file was successfully unpacked.
+ */
+int unpack(
+		const std::string& inputFile,
+		std::vector<std::uint8_t>& unpackedData,
+		bool brute = false);
+
+/**
+ * Check whether the file content \p data of \p size bytes is packed by
+ * a packer some unpacker plugin can handle. The data are parsed in place.
+ */
+bool isPacked(const std::uint8_t* data, std::size_t size);
+
 } // namespace unpackertool
 } // namespace retdec
 
@@ -191,6 +191,13 @@ protected:
 			Endianness endian,
 			std::uint64_t offset = 0,
 			std::uint64_t size = 0) const;
+	bool createValueFromBytes(
+			const std::uint8_t* data,
+			std::size_t dataSize,
+			std::uint64_t& value,
+			Endianness endian,
+			std::uint64_t offset = 0,
+			std::uint64_t size = 0) const;
 	bool createBytesFromValue(
 			std::uint64_t data,
 			std::uint64_t x,
@@ -0,0 +1,104 @@
+/**
+ * @file include/retdec/utils/cancellation.h
+ * @brief Cooperative cancellation of long-running operations.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_UTILS_CANCELLATION_H
+#define RETDEC_UTILS_CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+namespace utils {
+
+/**
+ * @brief Thrown when a cancelled operation reaches a cancellation point.
+ */
+class OperationCancelled : public std::runtime_error
+{
+	public:
+		OperationCancelled();
+};
+
+/**
+ * @brief Cancellation state of one operation (e.g. one decompilation).
+ *
+ * The operation is cancelled either explicitly by @c cancel(), which may be
+ * called from any thread, or when its deadline passes. The operation itself
+ * polls the token at its cancellation points and stops by throwing
+ * @c OperationCancelled.
+ *
+ * Besides the deadline of the whole operation, the token may hold a time
+ * budget of a single phase. A phase whose budget is spent is not cancelled,
+ * it should finish early by using a cheaper (less precise) approach.
+ *
+ * The token may also hold a soft memory limit. While the process uses more
+ * memory than that, the budget of every phase is considered spent, so the
+ * operation degrades the same way instead of running into the hard limit
+ * and failing on @c std::bad_alloc.
+ */
+class CancellationToken : private NonCopyable
+{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+	public:
+		void cancel();
+		void setDeadline(Clock::time_point deadline);
+		void setPhaseBudget(Clock::duration budget);
+		void setMemoryLimit(std::size_t limit);
+		void startPhase();
+
+		bool isCancelled() const;
+		bool isPhaseBudgetExpired() const;
+		bool isMemoryLimitExceeded() const;
+		void throwIfCancelled() const;
+
+	private:
+		std::atomic<bool> _cancelled{false};
+		Clock::time_point _deadline = Clock::time_point::max();
+		Clock::duration _phaseBudget = Clock::duration::zero();
+		Clock::time_point _phaseDeadline = Clock::time_point::max();
+
+		std::size_t _memoryLimit = 0;
+		/// Memory usage is sampled only once in a while, the last result
+		/// is used in between.
+		mutable std::atomic<Clock::rep> _nextMemorySample{0};
+		mutable std::atomic<bool> _memoryLimitExceeded{false};
+};
+
+/**
+ * @brief Makes the given token the current token of the calling thread for
+ *        the lifetime of the scope.
+ */
+class CancellationScope : private NonCopyable
+{
+	public:
+		explicit CancellationScope(CancellationToken& token);
+		~CancellationScope();
+
+	private:
+		CancellationToken* _previous = nullptr;
+};
+
+/// @name Operations on the current token of the calling thread.
+/// If there is no such token, nothing is ever cancelled or expired.
+/// @{
+CancellationToken* getCurrentCancellationToken();
+bool isCancellationRequested();
+void throwIfCancellationRequested();
+void startCancellationPhase();
+bool isPhaseBudgetExpired();
+bool isMemoryLimitExceeded();
+/// @}
+
+} // namespace utils
+} // namespace retdec
+
+#endif
@@ -233,9 +233,10 @@ Container filter(const Container &input, const Predicate &predicate) {
 * @brief Adds all values from @a from into @a to.
 *
 * @tparam T Type of elements in the sets.
+* @tparam Compare Ordering of elements in the sets.
 */
-template<typename T>
-void addToSet(const std::set<T> &from, std::set<T> &to) {
+template<typename T, typename Compare>
+void addToSet(const std::set<T, Compare> &from, std::set<T, Compare> &to) {
 	to.insert(from.begin(), from.end());
 }
 
@@ -246,12 +247,14 @@ void addToSet(const std::set<T> &from, std::set<T> &to) {
 * in @a s2.
 *
 * @tparam T Type of elements in the sets.
+* @tparam Compare Ordering of elements in the sets.
 */
-template<typename T>
-std::set<T> setUnion(const std::set<T> &s1, const std::set<T> &s2) {
-	std::set<T> result;
+template<typename T, typename Compare>
+std::set<T, Compare> setUnion(const std::set<T, Compare> &s1,
+		const std::set<T, Compare> &s2) {
+	std::set<T, Compare> result(s1.key_comp());
 	std::set_union(s1.begin(), s1.end(), s2.begin(), s2.end(),
-		std::inserter(result, result.end()));
+		std::inserter(result, result.end()), s1.key_comp());
 	return result;
 }
 
@@ -262,12 +265,14 @@ std::set<T> setUnion(const std::set<T> &s1, const std::set<T> &s2) {
 * s1 and @a s2.
 *
 * @tparam T Type of elements in the sets.
+* @tparam Compare Ordering of elements in the sets.
 */
-template<typename T>
-std::set<T> setIntersection(const std::set<T> &s1, const std::set<T> &s2) {
-	std::set<T> result;
+template<typename T, typename Compare>
+std::set<T, Compare> setIntersection(const std::set<T, Compare> &s1,
+		const std::set<T, Compare> &s2) {
+	std::set<T, Compare> result(s1.key_comp());
 	std::set_intersection(s1.begin(), s1.end(), s2.begin(), s2.end(),
-		std::inserter(result, result.end()));
+		std::inserter(result, result.end()), s1.key_comp());
 	return result;
 }
 
@@ -278,12 +283,14 @@ std::set<T> setIntersection(const std::set<T> &s1, const std::set<T> &s2) {
 * but are not in @a s2.
 *
 * @tparam T Type of elements in the sets.
+* @tparam Compare Ordering of elements in the sets.
 */
-template<typename T>
-std::set<T> setDifference(const std::set<T> &s1, const std::set<T> &s2) {
-	std::set<T> result;
+template<typename T, typename Compare>
+std::set<T, Compare> setDifference(const std::set<T, Compare> &s1,
+		const std::set<T, Compare> &s2) {
+	std::set<T, Compare> result(s1.key_comp());
 	std::set_difference(s1.begin(), s1.end(), s2.begin(), s2.end(),
-		std::inserter(result, result.end()));
+		std::inserter(result, result.end()), s1.key_comp());
 	return result;
 }
 
@@ -291,9 +298,11 @@ std::set<T> setDifference(const std::set<T> &s1, const std::set<T> &s2) {
 * @brief Removes all values that are in @a toRemove from @a from.
 *
 * @tparam T Type of elements in the sets.
+* @tparam Compare Ordering of elements in the sets.
 */
-template<typename T>
-void removeFromSet(std::set<T> &from, const std::set<T> &toRemove) {
+template<typename T, typename Compare>
+void removeFromSet(std::set<T, Compare> &from,
+		const std::set<T, Compare> &toRemove) {
 	// The solution using std::set_difference<> is slightly faster
 	// than this manual loop:
 	//
@@ -315,9 +324,11 @@ void removeFromSet(std::set<T> &from, const std::set<T> &toRemove) {
 * @brief Returns @c true if @a s1 is disjoint with @a s2.
 *
 * @tparam T Type of elements in the sets.
+* @tparam Compare Ordering of elements in the sets.
 */
-template<typename T>
-bool areDisjoint(const std::set<T> &s1, const std::set<T> &s2) {
+template<typename T, typename Compare>
+bool areDisjoint(const std::set<T, Compare> &s1,
+		const std::set<T, Compare> &s2) {
 	// s1 and s2 are disjoint iff s1 \cap s2 = \emptyset
 	// (see http://en.wikipedia.org/wiki/Disjoint_set)
 	return setIntersection(s1, s2).empty();
@@ -327,9 +338,11 @@ bool areDisjoint(const std::set<T> &s1, const std::set<T> &s2) {
 * @brief Returns @c true if @a s1 and @a s2 have at least one item in common.
 *
 * @tparam T Type of elements in the sets.
+* @tparam Compare Ordering of elements in the sets.
 */
-template<typename T>
-bool shareSomeItem(const std::set<T> &s1, const std::set<T> &s2) {
+template<typename T, typename Compare>
+bool shareSomeItem(const std::set<T, Compare> &s1,
+		const std::set<T, Compare> &s2) {
 	return !areDisjoint(s1, s2);
 }
 
@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "retdec/utils/byte_value_storage.h"
+#include "retdec/utils/span.h"
 
 namespace retdec {
 namespace utils {
@@ -49,12 +50,23 @@ public:
 			retdec::utils::Endianness endianness
 					= retdec::utils::Endianness::LITTLE
 	);
+	DynamicBuffer(
+			std::vector<uint8_t>&& data,
+			retdec::utils::Endianness endianness
+					= retdec::utils::Endianness::LITTLE
+	);
 	DynamicBuffer(const DynamicBuffer& dynamicBuffer);
+	DynamicBuffer(DynamicBuffer&& dynamicBuffer) noexcept;
 	DynamicBuffer(
 			const DynamicBuffer& dynamicBuffer,
 			uint32_t startPos,
 			uint32_t amount
 	);
+	DynamicBuffer(
+			Span<const uint8_t> data,
+			retdec::utils::Endianness endianness
+					= retdec::utils::Endianness::LITTLE
+	);
 
 	DynamicBuffer& operator =(DynamicBuffer dynamicBuffer);
 
@@ -71,9 +83,51 @@ public:
 	const uint8_t* getRawBuffer() const;
 	std::vector<uint8_t> getBuffer() const;
 
+	Span<const uint8_t> getSpan() const;
+	Span<uint8_t> getSpan();
+	Span<const uint8_t> getSpan(uint32_t startPos, uint32_t amount) const;
+	Span<uint8_t> getSpan(uint32_t startPos, uint32_t amount);
+
 	void forEach(const std::function<void(uint8_t&)>& func);
 	void forEachReverse(const std::function<void(uint8_t&)>& func);
 
+	/**
+	 * Replaces every byte of the real data with the result of @p func called
+	 * on it. Unlike forEach(), the function is not called through
+	 * @c std::function, so simple transformations (e.g. XOR with a constant)
+	 * get inlined and vectorized.
+	 *
+	 * @tparam Func Callable type taking and returning @c uint8_t.
+	 *
+	 * @param func Function to transform every byte with.
+	 */
+	template <typename Func> void transform(Func func)
+	{
+		transform(0, getRealDataSize(), func);
+	}
+
+	/**
+	 * Replaces the bytes of the real data in the specified range with the
+	 * result of @p func called on them. The range is clamped to the real
+	 * data.
+	 *
+	 * @tparam Func Callable type taking and returning @c uint8_t.
+	 *
+	 * @param startPos The position where to start transforming.
+	 * @param amount Number of bytes from startPos to transform.
+	 * @param func Function to transform every byte with.
+	 */
+	template <typename Func> void transform(
+			uint32_t startPos,
+			uint32_t amount,
+			Func func)
+	{
+		Span<uint8_t> bytes = getSpan(startPos, amount);
+		uint8_t* data = bytes.data();
+		for (std::size_t i = 0, size = bytes.size(); i < size; ++i)
+			data[i] = static_cast<uint8_t>(func(data[i]));
+	}
+
 	/**
 	 * Reads the data from the buffer. If the reading position is beyond the
 	 * size of the real data, the real data are resized so this value can be
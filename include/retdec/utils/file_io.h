@@ -11,6 +11,8 @@
 #include <fstream>
 #include <vector>
 
+#include "retdec/utils/span.h"
+
 namespace retdec {
 namespace utils {
 
@@ -118,9 +120,29 @@ template <typename N> bool readFile(
 	if (!fileStream.good())
 		return false;
 
-	const bool untilEof = !desiredSize;
+	bool untilEof = !desiredSize;
 	if (untilEof)
-		desiredSize = FILE_BURST_READ_LENGTH;
+	{
+		// Reading by bursts makes the result grow geometrically, so a large
+		// file would be held in memory up to three times during the read (and
+		// twice afterwards). When the size of the stream is known, read the
+		// rest of it at once into an exactly sized buffer.
+		fileStream.seekg(0, std::ios::end);
+		const auto end = fileStream.tellg();
+		fileStream.seekg(start, std::ios::beg);
+		if (end != std::streampos(-1) && fileStream.good())
+		{
+			const auto streamEnd = static_cast<std::size_t>(end);
+			desiredSize = streamEnd > start ? streamEnd - start : 0;
+			untilEof = false;
+		}
+		else
+		{
+			fileStream.clear();
+			fileStream.seekg(start, std::ios::beg);
+			desiredSize = FILE_BURST_READ_LENGTH;
+		}
+	}
 
 	result.clear();
 	std::size_t alreadyRead = 0;
@@ -194,6 +216,12 @@ template <typename N> bool writeFile(
 	return writeBytes(fileStream, data, desiredSize);
 }
 
+bool writeFile(
+		std::ostream& fileStream,
+		Span<const std::uint8_t> data,
+		std::size_t start = 0,
+		std::size_t desiredSize = 0);
+
 /**
  * Write bytes to file
  *
@@ -0,0 +1,231 @@
+/**
+ * @file include/retdec/utils/instrumentation.h
+ * @brief Scoped timers and named counters for hot-path instrumentation.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_UTILS_INSTRUMENTATION_H
+#define RETDEC_UTILS_INSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+#include "retdec/utils/non_copyable.h"
+
+namespace retdec {
+namespace utils {
+namespace instrumentation {
+
+/**
+ * @brief Aggregated measurements of one timer.
+ */
+struct TimerStats
+{
+	/// Number of finished scopes.
+	std::uint64_t count = 0;
+	/// Total time spent in the scopes (in nanoseconds).
+	std::uint64_t totalNs = 0;
+	/// Longest scope (in nanoseconds).
+	std::uint64_t maxNs = 0;
+};
+
+/**
+ * @brief Measurements of all threads merged by their names.
+ */
+struct Stats
+{
+	std::map<std::string, TimerStats> timers;
+	std::map<std::string, std::uint64_t> counters;
+
+	Stats operator-(const Stats& other) const;
+};
+
+namespace detail {
+
+extern std::atomic<bool> enabled;
+extern std::atomic<bool> tracing;
+
+} // namespace detail
+
+/**
+ * @return @c true if measurements are collected. When they are not, every
+ *         timer and counter costs only this check.
+ */
+inline bool isEnabled()
+{
+	return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @return @c true if timed scopes, spans and phases are recorded as trace
+ *         events (if measurements are collected at all).
+ */
+inline bool isTracing()
+{
+	return detail::tracing.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool enabled);
+void setTracing(bool tracing);
+
+void addToCounter(const char* name, std::uint64_t value);
+const char* intern(const std::string& name);
+
+void beginSpan(const char* name);
+void endSpan();
+void beginPhase(const std::string& name, unsigned level);
+
+Stats collect();
+void reset();
+bool writeChromeTrace(std::ostream& out);
+bool writeChromeTrace(const std::string& outFile);
+
+/**
+ * @brief Measures the time spent in its scope.
+ *
+ * Times are aggregated per thread and per name, so the name has to be
+ * a string with static storage duration: a string literal, or a name
+ * returned by @c intern(). When tracing is enabled, every scope is also
+ * recorded as a trace event, which may carry arguments added by
+ * @c addArg().
+ */
+class ScopedTimer : private NonCopyable
+{
+	public:
+		explicit ScopedTimer(const char* name)
+		{
+			if (isEnabled())
+			{
+				_name = name;
+				_start = std::chrono::steady_clock::now();
+			}
+		}
+
+		~ScopedTimer()
+		{
+			if (_name)
+			{
+				stop();
+			}
+		}
+
+		/**
+		 * @return @c true if this scope is recorded as a trace event.
+		 */
+		bool isTraced() const
+		{
+			return _name && isTracing();
+		}
+
+		/**
+		 * Add argument @a key with @a value to the trace event of this
+		 * scope. The key has to be a string with static storage duration.
+		 */
+		template <typename T>
+		void addArg(const char* key, const T& value)
+		{
+			if (isTraced())
+			{
+				appendArg(key, value);
+			}
+		}
+
+	private:
+		void stop();
+		void appendArg(const char* key, std::uint64_t value);
+		void appendArg(const char* key, const std::string& value);
+
+	private:
+		const char* _name = nullptr;
+		std::chrono::steady_clock::time_point _start;
+		/// Arguments of the trace event as members of a JSON object.
+		std::string _args;
+};
+
+} // namespace instrumentation
+} // namespace utils
+} // namespace retdec
+
+/**
+ * Instrumentation is compiled in only if @c RETDEC_INSTRUMENTATION is
+ * defined (the RETDEC_INSTRUMENTATION CMake option). Otherwise, the macros
+ * below expand to nothing and their arguments are not evaluated.
+ */
+#ifdef RETDEC_INSTRUMENTATION
+	#define RETDEC_INSTRUMENTATION_CONCAT_IMPL(a, b) a##b
+	#define RETDEC_INSTRUMENTATION_CONCAT(a, b) \
+		RETDEC_INSTRUMENTATION_CONCAT_IMPL(a, b)
+
+	/// Measure the rest of the current scope under the given name.
+	#define RETDEC_SCOPED_TIMER(name) \
+		::retdec::utils::instrumentation::ScopedTimer \
+			RETDEC_INSTRUMENTATION_CONCAT(_retdecScopedTimer, __LINE__)(name)
+
+	/// Measure the rest of the current scope by timer @a var, which can be
+	/// given arguments by @c RETDEC_TIMER_ARG.
+	#define RETDEC_SCOPED_TIMER_VAR(var, name) \
+		::retdec::utils::instrumentation::ScopedTimer var(name)
+
+	/// Add argument @a key with @a value to the trace event of timer @a var.
+	/// The value is evaluated only if the scope is traced.
+	#define RETDEC_TIMER_ARG(var, key, value) \
+		do { \
+			if (var.isTraced()) \
+			{ \
+				var.addArg(key, value); \
+			} \
+		} while (false)
+
+	/// Add @a value to the counter of the given name.
+	#define RETDEC_COUNTER_ADD(name, value) \
+		do { \
+			if (::retdec::utils::instrumentation::isEnabled()) \
+			{ \
+				::retdec::utils::instrumentation::addToCounter(name, value); \
+			} \
+		} while (false)
+
+	/// Start a traced span of the given name, @c RETDEC_TRACE_END ends it.
+	#define RETDEC_TRACE_BEGIN(name) \
+		do { \
+			if (::retdec::utils::instrumentation::isEnabled() \
+					&& ::retdec::utils::instrumentation::isTracing()) \
+			{ \
+				::retdec::utils::instrumentation::beginSpan(name); \
+			} \
+		} while (false)
+
+	/// End the last span started by @c RETDEC_TRACE_BEGIN on this thread.
+	#define RETDEC_TRACE_END() \
+		do { \
+			if (::retdec::utils::instrumentation::isEnabled() \
+					&& ::retdec::utils::instrumentation::isTracing()) \
+			{ \
+				::retdec::utils::instrumentation::endSpan(); \
+			} \
+		} while (false)
+
+	/// Start a traced phase of the given name and nesting level.
+	#define RETDEC_TRACE_PHASE(name, level) \
+		do { \
+			if (::retdec::utils::instrumentation::isEnabled() \
+					&& ::retdec::utils::instrumentation::isTracing()) \
+			{ \
+				::retdec::utils::instrumentation::beginPhase(name, level); \
+			} \
+		} while (false)
+#else
+	#define RETDEC_SCOPED_TIMER(name) do {} while (false)
+	#define RETDEC_SCOPED_TIMER_VAR(var, name) do {} while (false)
+	#define RETDEC_TIMER_ARG(var, key, value) do {} while (false)
+	#define RETDEC_COUNTER_ADD(name, value) do {} while (false)
+	#define RETDEC_TRACE_BEGIN(name) do {} while (false)
+	#define RETDEC_TRACE_END() do {} while (false)
+	#define RETDEC_TRACE_PHASE(name, level) do {} while (false)
+#endif
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * @file include/retdec/utils/interned_string.h
+ * @brief Process-wide interning of strings.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_UTILS_INTERNED_STRING_H
+#define RETDEC_UTILS_INTERNED_STRING_H
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace retdec {
+namespace utils {
+
+/**
+ * @brief Handle of a string stored in a process-wide pool.
+ *
+ * Equal strings are stored in the pool only once, so handles are as cheap to
+ * copy, compare for equality, and hash as pointers, no matter how long the
+ * strings are (e.g. mangled C++ names). Ordering compares the strings
+ * themselves, so sorted containers of handles iterate in the same order as
+ * containers of strings.
+ *
+ * The pool is thread-safe. Strings are never removed from it, so it suits
+ * names (of symbols, functions, types, variables), which repeat a lot, but
+ * not arbitrary data.
+ */
+class InternedString
+{
+	public:
+		InternedString();
+		InternedString(const std::string& str);
+		InternedString(const char* str);
+
+		const std::string& str() const;
+		const char* c_str() const;
+		operator const std::string&() const;
+
+		bool empty() const;
+		std::size_t size() const;
+
+		bool operator==(const InternedString& o) const;
+		bool operator!=(const InternedString& o) const;
+		bool operator<(const InternedString& o) const;
+
+		static std::size_t getPoolSize();
+
+	private:
+		/// String in the pool.
+		const std::string* _str;
+};
+
+/**
+ * @brief Returns the interned string.
+ */
+inline const std::string& InternedString::str() const
+{
+	return *_str;
+}
+
+inline const char* InternedString::c_str() const
+{
+	return _str->c_str();
+}
+
+inline InternedString::operator const std::string&() const
+{
+	return *_str;
+}
+
+inline bool InternedString::empty() const
+{
+	return _str->empty();
+}
+
+inline std::size_t InternedString::size() const
+{
+	return _str->size();
+}
+
+/**
+ * @brief Equal strings are interned only once, so it suffices to compare the
+ *        pointers.
+ */
+inline bool InternedString::operator==(const InternedString& o) const
+{
+	return _str == o._str;
+}
+
+inline bool InternedString::operator!=(const InternedString& o) const
+{
+	return _str != o._str;
+}
+
+inline bool InternedString::operator<(const InternedString& o) const
+{
+	return _str != o._str && *_str < *o._str;
+}
+
+inline std::ostream& operator<<(std::ostream& out, const InternedString& s)
+{
+	return out << s.str();
+}
+
+} // namespace utils
+} // namespace retdec
+
+namespace std {
+
+template<>
+struct hash<retdec::utils::InternedString>
+{
+	std::size_t operator()(const retdec::utils::InternedString& s) const
+	{
+		return std::hash<const void*>()(s.c_str());
+	}
+};
+
+} // namespace std
+
+#endif
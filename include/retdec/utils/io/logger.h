@@ -79,6 +79,32 @@ private:
 	std::ofstream _file;
 };
 
+/**
+ * @brief Logger writing its output on a background thread.
+ *
+ * Every thread collects its output in its own buffer. A record is complete
+ * at the end of a line or when the output is flushed (e.g. by std::endl).
+ * Complete records are queued and the background thread writes them in the
+ * order they were completed. Logging threads thus never wait for the target
+ * and records of different threads are never interleaved. The output is
+ * never colored.
+ */
+class AsyncLogger : public Logger {
+public:
+	AsyncLogger(std::ostream& target, bool verbose = true);
+	AsyncLogger(const std::string& file, bool verbose = true);
+	~AsyncLogger();
+
+	void flush();
+
+private:
+	class Buffer;
+
+	std::ofstream _file;
+	std::unique_ptr<Buffer> _buffer;
+	std::ostream _stream;
+};
+
 template<typename T>
 inline Logger& Logger::operator << (const T& p)
 {
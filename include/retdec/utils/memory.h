@@ -16,6 +16,9 @@ std::size_t getTotalSystemMemory();
 bool limitSystemMemory(std::size_t limit);
 bool limitSystemMemoryToHalfOfTotalSystemMemory();
 
+std::size_t getCurrentProcessMemory();
+std::size_t getPeakProcessMemory();
+
 } // namespace utils
 } // namespace retdec
 
@@ -0,0 +1,89 @@
+/**
+ * @file include/retdec/utils/memory_stream.h
+ * @brief Declaration of in-memory binary stream.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_UTILS_MEMORY_STREAM_H
+#define RETDEC_UTILS_MEMORY_STREAM_H
+
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+#include <vector>
+
+namespace retdec {
+namespace utils {
+
+/**
+ * @brief Stream buffer operating on the vector of bytes.
+ *
+ * Unlike @c std::stringbuf, it behaves like a file opened for both reading
+ * and writing. The put position can be moved beyond the end of the data,
+ * and a write there fills the gap with zero bytes.
+ */
+class MemoryStreamBuffer : public std::streambuf
+{
+	public:
+		explicit MemoryStreamBuffer(std::vector<std::uint8_t>& data);
+
+		void resetPositions();
+
+	protected:
+		/// @name Reading.
+		/// @{
+		virtual int_type underflow() override;
+		virtual int_type uflow() override;
+		virtual std::streamsize xsgetn(char* s, std::streamsize n) override;
+		virtual std::streamsize showmanyc() override;
+		/// @}
+
+		/// @name Writing.
+		/// @{
+		virtual int_type overflow(int_type ch) override;
+		virtual std::streamsize xsputn(const char* s, std::streamsize n) override;
+		/// @}
+
+		/// @name Positioning.
+		/// @{
+		virtual pos_type seekoff(
+				off_type off,
+				std::ios_base::seekdir dir,
+				std::ios_base::openmode which) override;
+		virtual pos_type seekpos(
+				pos_type pos,
+				std::ios_base::openmode which) override;
+		/// @}
+
+	private:
+		std::vector<std::uint8_t>& _data;
+		std::size_t _getPos = 0;
+		std::size_t _putPos = 0;
+};
+
+/**
+ * @brief Binary stream which keeps all its data in memory.
+ *
+ * It can be used in places where a file stream would be used otherwise,
+ * e.g. to build a whole output file in memory and decide later whether
+ * it should be written to disk at all.
+ */
+class MemoryStream : public std::iostream
+{
+	public:
+		MemoryStream();
+		explicit MemoryStream(std::vector<std::uint8_t> data);
+
+		const std::vector<std::uint8_t>& getData() const;
+		std::vector<std::uint8_t> releaseData();
+		void reset();
+
+	private:
+		std::vector<std::uint8_t> _data;
+		MemoryStreamBuffer _buffer;
+};
+
+} // namespace utils
+} // namespace retdec
+
+#endif
@@ -0,0 +1,60 @@
+/**
+* @file include/retdec/utils/parallel.h
+* @brief Parallel loops.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#ifndef RETDEC_UTILS_PARALLEL_H
+#define RETDEC_UTILS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace retdec {
+namespace utils {
+
+/**
+ * Call @a fnc for all indexes <0, @a n) on @a threads threads (including
+ * the calling one). Indexes are taken in order, one by one.
+ */
+template <typename Fnc>
+void parallelFor(std::size_t n, unsigned threads, Fnc fnc)
+{
+	threads = std::min<std::size_t>(threads, n);
+	if (threads <= 1)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			fnc(i);
+		}
+		return;
+	}
+
+	std::atomic<std::size_t> next(0);
+	auto worker = [&]()
+	{
+		for (std::size_t i = next++; i < n; i = next++)
+		{
+			fnc(i);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned t = 1; t < threads; ++t)
+	{
+		workers.emplace_back(worker);
+	}
+	worker();
+	for (auto& w : workers)
+	{
+		w.join();
+	}
+}
+
+} // namespace utils
+} // namespace retdec
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @file include/retdec/utils/span.h
+ * @brief Non-owning view of contiguous elements.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_UTILS_SPAN_H
+#define RETDEC_UTILS_SPAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace retdec {
+namespace utils {
+
+/**
+ * @brief Non-owning view of contiguous elements (a subset of C++20
+ *        @c std::span).
+ *
+ * The viewed elements must outlive the span and must not be reallocated
+ * while it is used (e.g. by growing the vector that holds them). Use
+ * @c Span<const T> for read-only views.
+ */
+template <typename T>
+class Span
+{
+public:
+	using element_type = T;
+	using value_type = typename std::remove_cv<T>::type;
+	using iterator = T*;
+	using reverse_iterator = std::reverse_iterator<T*>;
+
+	constexpr Span() noexcept = default;
+	constexpr Span(T* data, std::size_t size) noexcept
+			: _data(data), _size(size) {}
+
+	/**
+	 * Views all the elements of @a vec.
+	 */
+	template <typename U, typename = typename std::enable_if<
+			std::is_convertible<U*, T*>::value>::type>
+	Span(std::vector<U>& vec) noexcept
+			: _data(vec.data()), _size(vec.size()) {}
+
+	/**
+	 * Views all the elements of @a vec (read-only).
+	 */
+	template <typename U, typename = typename std::enable_if<
+			std::is_convertible<const U*, T*>::value>::type>
+	Span(const std::vector<U>& vec) noexcept
+			: _data(vec.data()), _size(vec.size()) {}
+
+	/**
+	 * Read-only view of a mutable span.
+	 */
+	template <typename U, typename = typename std::enable_if<
+			std::is_convertible<U*, T*>::value>::type>
+	constexpr Span(const Span<U>& other) noexcept
+			: _data(other.data()), _size(other.size()) {}
+
+	constexpr T* data() const noexcept { return _data; }
+	constexpr std::size_t size() const noexcept { return _size; }
+	constexpr bool empty() const noexcept { return _size == 0; }
+
+	constexpr T& operator[](std::size_t i) const { return _data[i]; }
+
+	constexpr iterator begin() const noexcept { return _data; }
+	constexpr iterator end() const noexcept { return _data + _size; }
+	reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+	reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+	/**
+	 * Returns the view of @a count elements starting at @a pos. Unlike
+	 * @c std::span, the range is clamped to the viewed elements.
+	 */
+	constexpr Span subspan(std::size_t pos, std::size_t count = SIZE_MAX) const
+	{
+		if (pos > _size)
+			pos = _size;
+		if (count > _size - pos)
+			count = _size - pos;
+		return Span(_data + pos, count);
+	}
+
+	/**
+	 * Returns the copy of the viewed elements.
+	 */
+	std::vector<value_type> toVector() const
+	{
+		return std::vector<value_type>(begin(), end());
+	}
+
+private:
+	T* _data = nullptr;
+	std::size_t _size = 0;
+};
+
+} // namespace utils
+} // namespace retdec
+
+#endif
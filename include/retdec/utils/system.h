@@ -7,6 +7,9 @@
 #ifndef RETDEC_UTILS_SYSTEM_H
 #define RETDEC_UTILS_SYSTEM_H
 
+#include <string>
+#include <vector>
+
 namespace retdec {
 namespace utils {
 
@@ -14,6 +17,11 @@ bool isLittleEndian();
 
 bool systemHasLongDouble();
 
+std::vector<unsigned> parseCpuList(const std::string& list);
+std::vector<std::vector<unsigned>> getCpusByNumaNode();
+unsigned getAvailableCpuCount();
+bool setCpuAffinity(const std::vector<unsigned>& cpus);
+
 } // namespace utils
 } // namespace retdec
 
@@ -53,6 +53,19 @@ class YaraDetector
 				/// @}
 		};
 
+		/**
+		 * Memory region to scan, it is not copied
+		 */
+		struct MemoryRegion
+		{
+			/// address of the first byte of region
+			std::uint64_t address;
+			/// bytes of region
+			const std::uint8_t* data;
+			/// number of bytes
+			std::size_t size;
+		};
+
 		struct RuleFile
 		{
 			RuleFile(
@@ -86,6 +99,8 @@ class YaraDetector
 		bool stateIsValid = true;
 		/// indicates whether text files need recompilation
 		bool needsRecompilation = true;
+		/// directory with cached compiled text files, empty if not used
+		std::string cacheDirectory;
 
 		/// @name Static auxiliary methods
 		/// @{
@@ -103,7 +118,14 @@ class YaraDetector
 				T&& value,
 				bool storeAllRules = false
 		);
+		template <typename T> bool scanCompiledRules(
+				const T& value,
+				CallbackSettings &settings
+		) const;
 		YR_RULES* getCompiledRules();
+		YR_RULES* getCachedRules(
+				const std::string &pathToFile,
+				const std::string &nameSpace);
 		/// @}
 	public:
 		YaraDetector();
@@ -116,7 +138,9 @@ class YaraDetector
 				const std::string &pathToFile,
 				const std::string &nameSpace = std::string()
 		);
+		void setRulesCacheDirectory(const std::string &dir);
 		bool isInValidState() const;
+		bool compile();
 		/// @}
 
 		/// @name Detection methods
@@ -126,9 +150,19 @@ class YaraDetector
 				bool storeAllRules = false
 		);
 		bool analyze(
-				std::vector<std::uint8_t> &bytes,
+				const std::vector<std::uint8_t> &bytes,
 				bool storeAllRules = false
 		);
+		bool analyze(
+				const std::vector<MemoryRegion> &regions,
+				bool storeAllRules = false
+		);
+		bool analyze(
+				const std::vector<std::uint8_t> &bytes,
+				std::vector<YaraRule> &detected,
+				std::vector<YaraRule> &undetected,
+				bool storeAllRules = false
+		) const;
 		const std::vector<YaraRule>& getDetectedRules() const;
 		const std::vector<YaraRule>& getUndetectedRules() const;
 		/// @}
@@ -4,6 +4,7 @@ from __future__ import print_function
 
 import argparse
 import importlib
+import json
 import os
 import re
 import shutil
@@ -168,7 +169,9 @@ class ArchiveDecompiler:
             self._cleanup()
             return 0
 
-        # Run the decompilation over all the found files.
+        # Run the decompilation over all the found files. The decompiler
+        # reads the archive only once and decompiles all its files in a
+        # single process, with the timeout applied to each file separately.
         print('Running `%s' % DECOMPILER, end='')
 
         if self.decompiler_args:
@@ -177,35 +180,38 @@ class ArchiveDecompiler:
         print('` over %d files with timeout %d s. (run `kill %d ` to terminate this script)...' % (
             self.file_count, self.timeout, os.getpid()), file=sys.stderr)
 
-        for i in range(self.file_count):
-            file_index = (i + 1)
-            print('%d/%d\t\t' % (file_index, self.file_count))
-
-            # We have to use indexes instead of names because archives can contain multiple files with same name.
-            log_file = self.library_path + '.file_' + str(file_index) + '.log.verbose'
-
-            # Do not escape!
-            arg_list = [
-                sys.executable,
-                DECOMPILER,
-                '--ar-index=' + str(i),
-                '-o', self.library_path + '.file_' + str(file_index) + '.c',
-                self.library_path,
-            ]
-            if self.decompiler_args:
-                arg_list.append(self.decompiler_args)
-            output, rc, timeouted = CmdRunner.run_cmd(
-                arg_list,
-                timeout=self.timeout,
-                buffer_output=True,
-            )
-
-            with open(log_file, 'w') as f:
-                f.write(output)
-
-            if timeouted:
+        log_file = self.library_path + '.log.verbose'
+        index_file = self.library_path + '.index.json'
+
+        # Do not escape!
+        arg_list = [
+            DECOMPILER,
+            '--ar-all',
+            '--ar-jobs', str(os.cpu_count() or 1),
+            '--timeout', str(self.timeout),
+            self.library_path,
+        ]
+        if self.decompiler_args:
+            arg_list.extend(self.decompiler_args)
+        output, _, _ = CmdRunner.run_cmd(arg_list, buffer_output=True)
+
+        with open(log_file, 'w') as f:
+            f.write(output)
+
+        try:
+            with open(index_file) as f:
+                objects = json.load(f)['objects']
+        except (IOError, ValueError, KeyError):
+            self._print_error_plain_or_json('Decompilation of the archive failed, see %s.' % log_file)
+            self._cleanup()
+            return 1
+
+        for obj in objects:
+            print('%d/%d\t\t' % (obj['index'] + 1, self.file_count))
+
+            if obj['exitCode'] is None or obj['exitCode'] == 137:
                 print('[TIMEOUT]')
-            elif rc != 0:
+            elif obj['exitCode'] != 0:
                 print('[FAIL]')
             else:
                 print('[OK]')
@@ -0,0 +1,342 @@
+#!/usr/bin/env python3
+
+"""
+Runs a corpus of input files through retdec-decompiler and records how long
+the decompilation and its stages took, how much memory it needed and how
+large its outputs were. The results can be compared with stored baseline
+results.
+
+The corpus is a JSON file of the following form (paths are relative to the
+directory of the corpus file, args are optional decompiler arguments):
+
+    {
+        "samples": [
+            {"name": "pe-x86-small", "path": "pe/x86/small.exe"},
+            {"name": "elf-arm-huge", "path": "elf/arm/huge", "args": ["-k"]}
+        ]
+    }
+
+A sample may also have ceilings of its wall time (seconds), peak memory
+(bytes) and wall times of its stages (seconds), which are checked with
+--check-limits:
+
+    {"name": "pe-switch", "path": "pe/switch.exe",
+     "limits": {"wallTime": 60, "peakRss": 1073741824,
+                "stages": {"decoder": 20}}}
+
+A sample with a wall time ceiling and no --timeout is killed when it runs
+twice as long as its ceiling, so that a stuck decompilation fails instead of
+blocking the run.
+
+Returns:
+   * 0 all samples were measured (and no regression was found)
+   * 1 a sample failed, a regression against the baseline was found, or
+       a ceiling was exceeded
+"""
+
+from __future__ import print_function
+
+import argparse
+import importlib
+import json
+import os
+import shutil
+import statistics
+import sys
+import tempfile
+import time
+
+utils = importlib.import_module('retdec-utils')
+utils.check_python_version()
+utils.ensure_script_is_being_run_from_installed_retdec()
+
+CmdRunner = utils.CmdRunner
+sys.stdout = utils.Unbuffered(sys.stdout)
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DECOMPILER = os.path.join(SCRIPT_DIR, 'retdec-decompiler')
+
+# Output suffixes whose sizes are recorded.
+OUTPUTS = ['', '.dsm', '.ll', '.config.json']
+
+# Times (in seconds) and memory (in bytes) that may grow by less than these
+# absolute amounts are never reported as regressions. It filters out noise in
+# tiny values.
+MIN_TIME_REGRESSION = 0.005
+MIN_MEMORY_REGRESSION = 1024 * 1024
+
+
+def parse_args(_args):
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+
+    parser.add_argument('corpus',
+                        metavar='CORPUS',
+                        help='JSON file with the list of samples.')
+
+    parser.add_argument('-o', '--output',
+                        dest='output',
+                        metavar='FILE',
+                        help='Store the results as JSON into FILE.')
+
+    parser.add_argument('-b', '--baseline',
+                        dest='baseline',
+                        metavar='FILE',
+                        help='Compare the results with results stored in FILE.')
+
+    parser.add_argument('-r', '--runs',
+                        dest='runs',
+                        type=int,
+                        default=1,
+                        help='Decompile each sample N times and record the medians (default: 1).')
+
+    parser.add_argument('-t', '--threshold',
+                        dest='threshold',
+                        type=float,
+                        default=0.25,
+                        help='Relative growth of a time or memory reported as a regression (default: 0.25).')
+
+    parser.add_argument('--timeout',
+                        dest='timeout',
+                        type=int,
+                        help='Kill a decompilation running longer than N seconds.')
+
+    parser.add_argument('--check-limits',
+                        dest='check_limits',
+                        action='store_true',
+                        help='Fail when a sample exceeds the ceilings of its "limits".')
+
+    parser.add_argument('--filter',
+                        dest='filter',
+                        metavar='TEXT',
+                        help='Measure only samples whose names contain TEXT.')
+
+    return parser.parse_args(_args)
+
+
+def stage_of_pass(argument):
+    """Returns the name of the pipeline stage the given pass belongs to.
+
+    The provider initialization is where the input file is loaded and parsed
+    by fileformat, so it stands for the format loading stage.
+    """
+    if argument == 'retdec-provider-init':
+        return 'providerInit'
+    if argument == 'retdec-decoder':
+        return 'decoder'
+    if argument == 'retdec-llvmir2hll':
+        return 'llvmir2hll'
+    if argument.startswith('retdec-'):
+        return 'bin2llvmir'
+    return 'llvm'
+
+
+def read_profile(path):
+    """Returns the total and the per-stage measurements from the profile
+    written by retdec-decompiler --profile-out."""
+    with open(path, 'r') as f:
+        profile = json.load(f)
+
+    stages = {}
+    for p in profile.get('passes', []):
+        stage = stages.setdefault(stage_of_pass(p.get('argument', '')),
+                                  {'wallTime': 0.0, 'cpuTime': 0.0})
+        stage['wallTime'] += p.get('wallTime', 0.0)
+        stage['cpuTime'] += p.get('cpuTime', 0.0)
+
+    return profile.get('total', {}), stages
+
+
+def run_sample(sample, corpus_dir, work_dir, timeout):
+    """Decompiles the given sample once and returns its measurements."""
+    path = os.path.join(corpus_dir, sample['path'])
+    out = os.path.join(work_dir, 'out.c')
+    profile = os.path.join(work_dir, 'profile.json')
+
+    cmd = [DECOMPILER, path, '-o', out, '--profile-out', profile]
+    cmd += sample.get('args', [])
+
+    start = time.time()
+    _, rc, timeouted = CmdRunner.run_cmd(cmd, timeout=timeout, buffer_output=True)
+    elapsed = time.time() - start
+
+    result = {'status': 'timeout' if timeouted else 'ok' if rc == 0 else 'failed',
+              'returnCode': rc,
+              'processTime': elapsed}
+    if result['status'] != 'ok' or not os.path.isfile(profile):
+        return result
+
+    total, stages = read_profile(profile)
+    result['wallTime'] = total.get('wallTime', 0.0)
+    result['cpuTime'] = total.get('cpuTime', 0.0)
+    result['peakRss'] = total.get('peakRss', 0)
+    result['stages'] = stages
+
+    base = os.path.splitext(out)[0]
+    result['outputs'] = {}
+    for suffix in OUTPUTS:
+        output = out if suffix == '' else base + suffix
+        if os.path.isfile(output):
+            result['outputs'][os.path.basename(output)] = os.path.getsize(output)
+
+    return result
+
+
+def median_of_runs(runs):
+    """Merges measurements of several runs of one sample into their medians.
+    A failed run makes the whole sample failed."""
+    for r in runs:
+        if r['status'] != 'ok':
+            return r
+
+    result = dict(runs[0])
+    for key in ['processTime', 'wallTime', 'cpuTime', 'peakRss']:
+        if key in result:
+            result[key] = statistics.median([r[key] for r in runs])
+    result['stages'] = {}
+    for stage in runs[0].get('stages', {}):
+        times = [r['stages'][stage] for r in runs if stage in r.get('stages', {})]
+        result['stages'][stage] = {
+            key: statistics.median([t[key] for t in times])
+            for key in ['wallTime', 'cpuTime']
+        }
+    return result
+
+
+def grew(old, new, threshold, minimum):
+    return new > old * (1.0 + threshold) and new - old > minimum
+
+
+def compare(name, old, new, threshold):
+    """Returns the list of regressions of the given sample."""
+    if old is None:
+        return []
+    if old['status'] != new['status']:
+        return ['%s: status %s -> %s' % (name, old['status'], new['status'])]
+    if new['status'] != 'ok':
+        return []
+
+    regressions = []
+    exceeded = []
+
+    def check(what, o, n, minimum):
+        if o is not None and n is not None and grew(o, n, threshold, minimum):
+            regressions.append('%s: %s %s -> %s' % (name, what, o, n))
+
+    check('wallTime', old.get('wallTime'), new.get('wallTime'), MIN_TIME_REGRESSION)
+    check('cpuTime', old.get('cpuTime'), new.get('cpuTime'), MIN_TIME_REGRESSION)
+    check('peakRss', old.get('peakRss'), new.get('peakRss'), MIN_MEMORY_REGRESSION)
+    for stage, times in new.get('stages', {}).items():
+        o = old.get('stages', {}).get(stage, {})
+        check(stage + '.wallTime', o.get('wallTime'), times['wallTime'], MIN_TIME_REGRESSION)
+
+    old_outputs = old.get('outputs', {})
+    for output, size in new.get('outputs', {}).items():
+        if output in old_outputs and old_outputs[output] != size:
+            regressions.append('%s: size of %s %d -> %d'
+                               % (name, output, old_outputs[output], size))
+
+    return regressions
+
+
+def sample_timeout(sample, timeout):
+    """Returns the timeout of decompilation of the given sample."""
+    if timeout is not None:
+        return timeout
+    wall_time = sample.get('limits', {}).get('wallTime')
+    if wall_time is not None:
+        return int(2 * wall_time) + 1
+    return None
+
+
+def exceeded_limits(name, limits, r):
+    """Returns the list of ceilings of the given sample that were exceeded."""
+    if r['status'] != 'ok':
+        return ['%s: status %s' % (name, r['status'])]
+
+    exceeded = []
+
+    def check(what, limit, value):
+        if limit is not None and value is not None and value > limit:
+            exceeded.append('%s: %s %s > %s' % (name, what, value, limit))
+
+    check('wallTime', limits.get('wallTime'), r.get('wallTime'))
+    check('peakRss', limits.get('peakRss'), r.get('peakRss'))
+    for stage, limit in limits.get('stages', {}).items():
+        times = r.get('stages', {}).get(stage, {})
+        check(stage + '.wallTime', limit, times.get('wallTime'))
+    return exceeded
+
+
+def print_result(name, r):
+    if r['status'] != 'ok':
+        print('%-30s %s (return code %d)' % (name, r['status'], r['returnCode']))
+        return
+
+    stages = ' '.join('%s=%.3f' % (s, t['wallTime'])
+                      for s, t in sorted(r.get('stages', {}).items()))
+    print('%-30s wall=%.3fs cpu=%.3fs rss=%dMB %s'
+          % (name, r.get('wallTime', 0.0), r.get('cpuTime', 0.0),
+             r.get('peakRss', 0) // (1024 * 1024), stages))
+
+
+def main():
+    args = parse_args(sys.argv[1:])
+
+    if not os.path.isfile(DECOMPILER):
+        utils.print_error_and_die('%s not found' % DECOMPILER)
+    if args.runs < 1:
+        utils.print_error_and_die('the number of runs has to be positive')
+
+    try:
+        with open(args.corpus, 'r') as f:
+            corpus = json.load(f)
+        baseline = {}
+        if args.baseline:
+            with open(args.baseline, 'r') as f:
+                baseline = json.load(f).get('samples', {})
+    except (IOError, ValueError) as e:
+        utils.print_error_and_die(str(e))
+
+    corpus_dir = os.path.dirname(os.path.abspath(args.corpus))
+    results = {}
+    failed = False
+    regressions = []
+    exceeded = []
+
+    work_dir = tempfile.mkdtemp(prefix='retdec-bench-')
+    try:
+        for sample in corpus.get('samples', []):
+            name = sample['name']
+            if args.filter and args.filter not in name:
+                continue
+
+            timeout = sample_timeout(sample, args.timeout)
+            runs = [run_sample(sample, corpus_dir, work_dir, timeout)
+                    for _ in range(args.runs)]
+            r = median_of_runs(runs)
+            results[name] = r
+            print_result(name, r)
+
+            failed = failed or r['status'] != 'ok'
+            regressions += compare(name, baseline.get(name), r, args.threshold)
+            if args.check_limits and 'limits' in sample:
+                exceeded += exceeded_limits(name, sample['limits'], r)
+    finally:
+        shutil.rmtree(work_dir, ignore_errors=True)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump({'samples': results}, f, indent=4, sort_keys=True)
+            f.write('\n')
+
+    for r in regressions:
+        utils.print_warning('regression in ' + r)
+    for e in exceeded:
+        utils.print_warning('ceiling exceeded in ' + e)
+
+    sys.exit(1 if failed or regressions or exceeded else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,6 +1,11 @@
 #!/usr/bin/env python3
 
-"""Runs all the installed unit tests."""
+"""Runs all the installed unit tests.
+
+With --slow-inputs, it also decompiles the installed corpus of slow inputs and
+checks that no input exceeds its time and memory ceilings (see
+retdec-bench.py).
+"""
 
 from __future__ import print_function
 
@@ -39,6 +44,9 @@ sys.stdout = utils.Unbuffered(sys.stdout)
 
 SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
 UNIT_TESTS_DIR = SCRIPT_DIR
+BENCH = os.path.join(SCRIPT_DIR, 'retdec-bench.py')
+SLOW_INPUTS_CORPUS = os.path.join(SCRIPT_DIR, '..', 'share', 'retdec',
+                                  'slow-inputs', 'corpus.json')
 
 def print_colored(message, color=None):
     """Emits a colored version of the given message to the standard output (without
@@ -121,14 +129,42 @@ def run_unit_tests_in_dir(path, verbose=False):
         return 0
 
 
+def run_slow_inputs():
+    """Decompiles the corpus of slow inputs and checks their ceilings.
+
+    Returns 0 if no ceiling was exceeded, 1 otherwise.
+    """
+    print()
+    print_colored('slow inputs', colorama.Fore.YELLOW + colorama.Style.BRIGHT)
+
+    if not os.path.isfile(BENCH) or not os.path.isfile(SLOW_INPUTS_CORPUS):
+        print_colored('FAILED (the corpus or %s is not installed)\n'
+                      % os.path.basename(BENCH), colorama.Fore.RED)
+        return 1
+
+    output, return_code, _ = CmdRunner.run_cmd(
+        [sys.executable, BENCH, SLOW_INPUTS_CORPUS, '--check-limits'],
+        buffer_output=True)
+    print(output)
+
+    if return_code != 0:
+        print_colored('FAILED (return code %d)\n' % return_code, colorama.Fore.RED)
+        return 1
+    return 0
+
+
 def main():
-    verbose = len(sys.argv) > 1 and sys.argv[1] in ['-v', '--verbose']
+    verbose = '-v' in sys.argv[1:] or '--verbose' in sys.argv[1:]
+    slow_inputs = '--slow-inputs' in sys.argv[1:]
 
     if not os.path.isdir(UNIT_TESTS_DIR):
         utils.print_error_and_die('error: no unit tests found in %s' % UNIT_TESTS_DIR)
 
     print('Running all unit tests in %s...' % UNIT_TESTS_DIR)
-    sys.exit(run_unit_tests_in_dir(UNIT_TESTS_DIR, verbose))
+    rc = run_unit_tests_in_dir(UNIT_TESTS_DIR, verbose)
+    if slow_inputs:
+        rc = max(rc, run_slow_inputs())
+    sys.exit(rc)
 
 
 if __name__ == "__main__":
@@ -10,6 +10,7 @@
 #include <fstream>
 #include <ostream>
 
+#include <llvm/ADT/StringExtras.h>
 #include <rapidjson/document.h>
 #include <rapidjson/prettywriter.h>
 
@@ -109,6 +110,39 @@ ArchiveWrapper::ArchiveWrapper(
 	bool &succes,
 	std::string &errorMessage)
 	: buffer(MemoryBuffer::getFile(llvm::Twine(archivePath)))
+{
+	init(succes, errorMessage);
+}
+
+/**
+ * Constructor from archive content held in memory.
+ *
+ * Data are not copied, they must outlive the constructed object.
+ *
+ * @param data content of input archive
+ * @param size size of @p data
+ * @param succes result of object construction
+ * @param errorMessage possible error message if @p success is set to false
+ */
+ArchiveWrapper::ArchiveWrapper(
+	const char *data,
+	std::size_t size,
+	bool &succes,
+	std::string &errorMessage)
+	: buffer(MemoryBuffer::getMemBuffer(llvm::StringRef(data, size), "", false))
+{
+	init(succes, errorMessage);
+}
+
+/**
+ * Parse the archive from buffer.
+ *
+ * @param succes result of parsing
+ * @param errorMessage possible error message if @p success is set to false
+ */
+void ArchiveWrapper::init(
+	bool &succes,
+	std::string &errorMessage)
 {
 	succes = false;
 	if (!buffer) {
@@ -137,6 +171,17 @@ std::size_t ArchiveWrapper::getNumberOfObjects() const
 	return objectCount;
 }
 
+/**
+ * Get start of archive content.
+ *
+ * @return pointer to the first byte of archive, object ranges are relative
+ * to it.
+ */
+const char *ArchiveWrapper::getBufferStart() const
+{
+	return buffer.get()->getBufferStart();
+}
+
 /**
  * Check whether archive is thin archive.
  *
@@ -407,6 +452,167 @@ bool ArchiveWrapper::extractByIndex(
 	return false;
 }
 
+/**
+ * Get position of object file by its name.
+ *
+ * If multiple files with the same name are present, only the first one is
+ * used. Object can be accessed in place at @p offset from getBufferStart().
+ *
+ * @param name target name
+ * @param offset offset of object in archive
+ * @param size size of object
+ * @param errorMessage possible error message if @c false is returned
+ *
+ * @return @c true if no errors occurred, @c false otherwise
+ */
+bool ArchiveWrapper::getObjectRangeByName(
+	const std::string &name,
+	std::size_t &offset,
+	std::size_t &size,
+	std::string &errorMessage) const
+{
+	Error error = Error::success();
+	for (const auto &child : archive->children(error)) {
+		if (checkError(error, errorMessage)) {
+			return false;
+		}
+
+		auto nameOrErr = child.getName();
+		if (!nameOrErr || name != fixName(nameOrErr->str())) {
+			continue;
+		}
+
+		auto bufferOrErr = child.getBuffer();
+		if (!bufferOrErr || !getRange(*bufferOrErr, offset, size)) {
+			consumeError(bufferOrErr.takeError());
+			errorMessage = "Could not get file buffer";
+			return false;
+		}
+		return true;
+	}
+
+	if (checkError(error, errorMessage)) {
+		return false;
+	}
+
+	errorMessage = "Could not find desired file";
+	return false;
+}
+
+/**
+ * Get position of object file by its index.
+ *
+ * Object can be accessed in place at @p offset from getBufferStart().
+ *
+ * @param index target index
+ * @param offset offset of object in archive
+ * @param size size of object
+ * @param errorMessage possible error message if @c false is returned
+ *
+ * @return @c true if no errors occurred, @c false otherwise
+ */
+bool ArchiveWrapper::getObjectRangeByIndex(
+	const std::size_t index,
+	std::size_t &offset,
+	std::size_t &size,
+	std::string &errorMessage) const
+{
+	Error error = Error::success();
+	std::size_t counter = 0;
+	for (const auto &child : archive->children(error)) {
+		if (checkError(error, errorMessage)) {
+			return false;
+		}
+
+		// No random access available.
+		if (index != counter++) {
+			continue;
+		}
+
+		auto bufferOrErr = child.getBuffer();
+		if (!bufferOrErr || !getRange(*bufferOrErr, offset, size)) {
+			consumeError(bufferOrErr.takeError());
+			errorMessage = "Could not get file buffer";
+			return false;
+		}
+		return true;
+	}
+
+	if (checkError(error, errorMessage)) {
+		return false;
+	}
+
+	errorMessage = "Could not find desired file";
+	return false;
+}
+
+/**
+ * Call @p callback for every object file in archive.
+ *
+ * Objects are passed in place without extraction, in the order in which
+ * they are stored in archive. Their content stays valid for the lifetime of
+ * the wrapper. Unlike repeated calls of getObjectRangeByIndex(), archive is
+ * walked only once. Members of thin archives are supported as well.
+ *
+ * @param callback function called with name and content of every object
+ * @param errorMessage possible error message if @c false is returned
+ *
+ * @return @c true if no errors occurred, @c false otherwise
+ */
+bool ArchiveWrapper::forEachMember(
+	const std::function<void(const std::string &,
+		llvm::ArrayRef<std::uint8_t>)> &callback,
+	std::string &errorMessage) const
+{
+	Error error = Error::success();
+	for (const auto &child : archive->children(error)) {
+		if (checkError(error, errorMessage)) {
+			return false;
+		}
+
+		auto nameOrErr = child.getName();
+		std::string name = nameOrErr ? nameOrErr->str() : "invalid_name";
+		consumeError(nameOrErr.takeError());
+
+		auto bufferOrErr = child.getBuffer();
+		if (!bufferOrErr) {
+			consumeError(bufferOrErr.takeError());
+			errorMessage = "Could not get file buffer";
+			return false;
+		}
+
+		callback(name, llvm::arrayRefFromStringRef(*bufferOrErr));
+	}
+
+	return !checkError(error, errorMessage);
+}
+
+/**
+ * Get position of object content inside of archive buffer.
+ *
+ * @param child content of object
+ * @param offset offset of object in archive
+ * @param size size of object
+ *
+ * @return @c true if object lies inside of archive buffer (it is not the
+ * case for thin archives), @c false otherwise
+ */
+bool ArchiveWrapper::getRange(
+	const llvm::StringRef &child,
+	std::size_t &offset,
+	std::size_t &size) const
+{
+	const auto *start = buffer.get()->getBufferStart();
+	const auto *end = buffer.get()->getBufferEnd();
+	if (child.data() < start || child.data() + child.size() > end) {
+		return false;
+	}
+
+	offset = child.data() - start;
+	size = child.size();
+	return true;
+}
+
 /**
  * Get names of all object files in archive.
  *
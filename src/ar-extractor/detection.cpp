@@ -111,6 +111,26 @@ bool isArchive(
 	return false;
 }
 
+/**
+ * Check if file content held in memory is an archive (normal or thin).
+ *
+ * @param data input file content
+ * @param size size of @p data
+ *
+ * @return @c true if content is an archive, @c false otherwise
+ */
+bool isArchive(
+	const char *data,
+	std::size_t size)
+{
+	if (size < arMagicSize) {
+		return false;
+	}
+
+	const std::string start(data, arMagicSize);
+	return start == archMagic || start == thinMagic;
+}
+
 /**
  * Check if file is a thin archive.
  *
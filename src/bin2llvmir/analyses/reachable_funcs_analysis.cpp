@@ -4,13 +4,17 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
-#include <llvm/IR/InstVisitor.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <llvm/ADT/BitVector.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
 
-#include "retdec/utils/container.h"
-#include "retdec/bin2llvmir/analyses/indirectly_called_funcs_analysis.h"
 #include "retdec/bin2llvmir/analyses/reachable_funcs_analysis.h"
 
-using namespace retdec::utils;
 using namespace llvm;
 
 namespace retdec {
@@ -19,115 +23,184 @@ namespace bin2llvmir {
 namespace {
 
 /**
-* @brief Call analysis.
+* @brief Signature of an indirect call or of a function it can call: return
+*        type followed by types of arguments.
+*/
+using Signature = std::vector<llvm::Type*>;
+
+/**
+* @brief Call graph of module's functions with dense numbering, stored in a
+*        compressed sparse row format.
+*
+* Nodes <0, number of functions) are functions in the order of the module's
+* function list. The remaining nodes are signatures of indirect calls and
+* their successors are all the functions that can be called by such calls
+* (see @c IndirectlyCalledFuncsAnalysis::getFuncsForIndirectCall()).
 */
-class CallAnalysis: private InstVisitor<CallAnalysis> {
+class FuncsGraph {
 public:
-	bool isFuncDirectlySelfRecursive(Function &func);
+	FuncsGraph(Module &module, CallGraph &callGraph);
+
+	std::set<llvm::Function*> getReachableDefinedFuncsFor(Function &func) const;
 
 private:
-	friend class InstVisitor<CallAnalysis>;
-	void visitCallInst(CallInst &callInst);
+	using Index = unsigned;
 
 private:
-	/// Signals if we have self recursive function.
-	bool isSelfRecursive = false;
+	Index getSignatureNode(const Signature &sig);
+	Index getVarArgNode(llvm::Type *retType);
+	void addIndirectCallEdges(Index fncNode, CallInst &call);
 
-	/// Function to analyze.
-	Function *funcToAnalyze = nullptr;
+private:
+	/// Functions by their indexes.
+	std::vector<Function*> funcs;
+	/// Indexes of functions.
+	DenseMap<const Function*, Index> func2idx;
+
+	/// Nodes of non-variadic functions' signatures.
+	std::map<Signature, Index> sig2node;
+	/// Nodes of variadic functions' return types.
+	std::map<llvm::Type*, Index> varArg2node;
+	/// Number of all nodes.
+	Index nodes = 0;
+
+	/// Edges <from, to> accumulated before the construction of CSR.
+	std::vector<std::pair<Index, Index>> edges;
+	/// Successors of node @c n are <succs[offsets[n]], succs[offsets[n+1]]).
+	std::vector<Index> offsets;
+	std::vector<Index> succs;
 };
 
-/**
-* @brief Returns @c true if @a func is self directly recursive, otherwise
-*        @c false.
-*/
-bool CallAnalysis::isFuncDirectlySelfRecursive(Function &func) {
-	funcToAnalyze = &func;
-	isSelfRecursive = false;
-
-	// Go through calls.
-	visit(funcToAnalyze);
-
-	return isSelfRecursive;
-}
+FuncsGraph::FuncsGraph(Module &module, CallGraph &callGraph) {
+	for (Function &func : module) {
+		func2idx[&func] = funcs.size();
+		funcs.push_back(&func);
+	}
+	nodes = funcs.size();
 
-/**
-* @brief Finds out if function is self recursive.
-*/
-void CallAnalysis::visitCallInst(CallInst &callInst) {
-	Function *calledFunc(callInst.getCalledFunction());
+	for (Index i = 0; i < funcs.size(); ++i) {
+		Function *func = funcs[i];
 
-	if (!calledFunc) {
-		// Indirect call, so skip.
-		return;
-	}
+		for (auto &record : *callGraph[func]) {
+			Function *callee = record.second->getFunction();
+			auto fIt = callee ? func2idx.find(callee) : func2idx.end();
+			if (fIt != func2idx.end()) {
+				edges.emplace_back(i, fIt->second);
+			}
+		}
 
-	if (calledFunc == funcToAnalyze) {
-		isSelfRecursive = true;
+		for (auto &bb : *func) {
+			for (auto &insn : bb) {
+				auto *call = dyn_cast<CallInst>(&insn);
+				if (call && call->getCalledFunction() == nullptr) {
+					addIndirectCallEdges(i, *call);
+				}
+			}
+		}
 	}
-}
 
-/**
-* @brief Indirect calls finder.
-*/
-class IndirectCallsFinder: private InstVisitor<IndirectCallsFinder> {
-public:
-	std::set<llvm::CallInst*> getIndirectCallsFor(const std::set<llvm::Function*> &funcs);
+	// Functions that can be called by indirect calls.
+	for (Index i = 0; i < funcs.size(); ++i) {
+		Function *func = funcs[i];
+		if (func->isVarArg()) {
+			auto fIt = varArg2node.find(func->getReturnType());
+			if (fIt != varArg2node.end()) {
+				edges.emplace_back(fIt->second, i);
+			}
+			continue;
+		}
 
-private:
-	friend class InstVisitor<IndirectCallsFinder>;
-	void visitCallInst(CallInst &callInst);
+		Signature sig{func->getReturnType()};
+		for (auto &arg : func->args()) {
+			sig.push_back(arg.getType());
+		}
+		auto fIt = sig2node.find(sig);
+		if (fIt != sig2node.end()) {
+			edges.emplace_back(fIt->second, i);
+		}
+	}
 
-private:
-	/// Set of indirect calls.
-	std::set<llvm::CallInst*> indirectCalls;
-};
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
 
-/**
-* @brief Finds indirect calls.
-*/
-void IndirectCallsFinder::visitCallInst(CallInst &callInst) {
-	if (callInst.getCalledFunction() == nullptr) {
-		indirectCalls.insert(&callInst);
+	offsets.assign(nodes + 1, 0);
+	succs.reserve(edges.size());
+	for (auto &e : edges) {
+		++offsets[e.first + 1];
+		succs.push_back(e.second);
+	}
+	for (Index n = 0; n < nodes; ++n) {
+		offsets[n + 1] += offsets[n];
 	}
+	edges.clear();
+	edges.shrink_to_fit();
 }
 
-/**
-* @brief Returns all indirect calls that are in @a funcs.
-*/
-std::set<llvm::CallInst*> IndirectCallsFinder::getIndirectCallsFor(const std::set<llvm::Function*>& funcs) {
-	for (Function *func : funcs) {
-		visit(*func);
+FuncsGraph::Index FuncsGraph::getSignatureNode(const Signature &sig) {
+	auto p = sig2node.emplace(sig, nodes);
+	if (p.second) {
+		++nodes;
 	}
+	return p.first->second;
+}
 
-	return indirectCalls;
+FuncsGraph::Index FuncsGraph::getVarArgNode(llvm::Type *retType) {
+	auto p = varArg2node.emplace(retType, nodes);
+	if (p.second) {
+		++nodes;
+	}
+	return p.first->second;
 }
 
 /**
-* @brief Returns @c true if @a func is self recursive, otherwise @c false.
+* @brief Adds edges from function @a fncNode to signatures of functions that
+*        can be called by indirect call @a call.
 */
-bool isDirectlySelfRecursive(Function &toCheck) {
-	CallAnalysis callAnalysis;
-	return callAnalysis.isFuncDirectlySelfRecursive(toCheck);
+void FuncsGraph::addIndirectCallEdges(Index fncNode, CallInst &call) {
+	Signature sig{call.getType()};
+	for (unsigned i = 0; i < call.getNumArgOperands(); ++i) {
+		sig.push_back(call.getArgOperand(i)->getType());
+	}
+	edges.emplace_back(fncNode, getSignatureNode(sig));
+	edges.emplace_back(fncNode, getVarArgNode(call.getType()));
 }
 
 /**
-* @brief Returns @c true if @a funcNodeToCheck contains defined function,
-*        otherwise @c false.
+* @brief Returns @a func, defined functions that are reachable from it through
+*        calls, and all functions that can be called by indirect calls in
+*        these functions.
 */
-bool containsDefinedFunc(CallGraphNode &funcNodeToCheck) {
-	Function *funcToCheck(funcNodeToCheck.getFunction());
-	if (!funcToCheck) {
-		// We have for example end node of call graph.
-		return false;
+std::set<llvm::Function*> FuncsGraph::getReachableDefinedFuncsFor(
+		Function &func) const {
+	const Index funcsCount = funcs.size();
+	BitVector visited(nodes);
+	BitVector reachable(funcsCount);
+
+	std::vector<Index> worklist{func2idx.lookup(&func)};
+	visited.set(worklist.back());
+	reachable.set(worklist.back());
+	while (!worklist.empty()) {
+		Index n = worklist.back();
+		worklist.pop_back();
+
+		for (Index k = offsets[n]; k < offsets[n + 1]; ++k) {
+			Index s = succs[k];
+			if (n >= funcsCount
+					|| (s < funcsCount && !funcs[s]->isDeclaration())) {
+				reachable.set(s);
+			}
+			if (!visited.test(s)) {
+				visited.set(s);
+				worklist.push_back(s);
+			}
+		}
 	}
 
-	if (funcToCheck->isDeclaration()) {
-		// We have only declared function.
-		return false;
+	std::set<llvm::Function*> reachableFuncs;
+	for (auto i : reachable.set_bits()) {
+		reachableFuncs.insert(funcs[i]);
 	}
-
-	return true;
+	return reachableFuncs;
 }
 
 } // anonymous namespace
@@ -136,6 +209,9 @@ bool containsDefinedFunc(CallGraphNode &funcNodeToCheck) {
 * @brief Returns defined functions that are reachable directly and indirectly
 *        from function @a func.
 *
+* Functions that can be called by indirect calls in the reachable functions
+* are reachable as well, even if they are only declared.
+*
 * @param[in] func We are finding defined functions that are reachable from
 *            this function.
 * @param[in] module We are considering only functions in this module.
@@ -143,31 +219,7 @@ bool containsDefinedFunc(CallGraphNode &funcNodeToCheck) {
 */
 std::set<llvm::Function*> ReachableFuncsAnalysis::getReachableDefinedFuncsFor(
 		llvm::Function &func, Module &module, llvm::CallGraph &callGraph) {
-	std::set<llvm::Function*> reachableFuncs{&func};
-	std::size_t reachableSize(0);
-	ReachableFuncsAnalysis reachableFuncsAnalysis;
-
-	addToSet(reachableFuncsAnalysis.getDirectlyReachableDefinedFuncsFor(
-			reachableFuncs, callGraph), reachableFuncs);
-
-	do {
-		// Need to iterate while changing, because reachable functions can call
-		// indirect calls and from this indirect calls can be called some other
-		// functions, so all of these functions are reachable from the start
-		// function.
-		reachableSize = reachableFuncs.size();
-
-		// Calculate direct reachable functions for current reachable functions.
-		addToSet(reachableFuncsAnalysis.getDirectlyReachableDefinedFuncsFor(
-			reachableFuncs, callGraph), reachableFuncs);
-
-		// Calculate indirect reachable functions for current reachable
-		// functions.
-		addToSet(reachableFuncsAnalysis.getIndirectlyReachableDefinedFuncsFor(
-			reachableFuncs, module), reachableFuncs);
-	} while (reachableSize != reachableFuncs.size());
-
-	return reachableFuncs;
+	return FuncsGraph(module, callGraph).getReachableDefinedFuncsFor(func);
 }
 
 /**
@@ -192,87 +244,5 @@ std::set<llvm::Function*> ReachableFuncsAnalysis::getGloballyReachableFuncsFor(l
 	return reachableFuncs;
 }
 
-/**
-* @brief Returns defined functions that are directly reachable from @a funcs
-*
-* @param[in] funcs We are finding defined functions that are reachable from
-*            this functions.
-* @param[in] callGraph We are finding in this call graph.
-*/
-std::set<llvm::Function*> ReachableFuncsAnalysis::getDirectlyReachableDefinedFuncsFor(
-		const std::set<llvm::Function*> &funcs, llvm::CallGraph &callGraph) const {
-	std::set<llvm::Function*> reachableFuncs;
-	for (Function *func : funcs) {
-		CallGraphNode *funcNode(callGraph[func]);
-		addToSet(getDirectlyReachableDefinedFuncsFor(*funcNode),
-			reachableFuncs);
-	}
-
-	return reachableFuncs;
-}
-
-/**
-* @brief Returns defined functions that are directly reachable from function in
-*        @a reachableFrom.
-*/
-std::set<llvm::Function*> ReachableFuncsAnalysis::getDirectlyReachableDefinedFuncsFor(
-		llvm::CallGraphNode &reachableFrom) const {
-	std::set<llvm::Function*> reachableDefinedFuncs;
-	for (scc_iterator<CallGraphNode *> i = scc_begin(&reachableFrom),
-			e = scc_end(&reachableFrom); i != e; ++i) {
-		// For example we have this code:
-		// void func() {
-		//   return;
-		// }
-		// int main() {
-		//   func();
-		// }
-		// This iteration goes through functions that are reachable from
-		// function which is in input parameter of this method. Unfortunately
-		// call graph contains end call graph node and consider reachable
-		// function same function from which we do an analysis. So if we want to
-		// get reachable functions from main we get in this iteration functions
-		// like main, func and end call graph node. So we need to check if main
-		// is self recursive and we want to add only defined functions. So we
-		// don't want to add end node for example.
-		const std::vector<llvm::CallGraphNode*> &callNodesVec(*i);
-		for (auto &node : callNodesVec) {
-			// Goes through functions that created one strongly connected
-			// component. But here we don't need to consider that we have
-			// strongly connected component. Just go through functions.
-			Function *funcToCheck(node->getFunction());
-			if (node == &reachableFrom) {
-				// Need to check if function from which we do analysis is
-				// self recursive because this means that is reachable from its
-				// own.
-				if (isDirectlySelfRecursive(*funcToCheck)) {
-					reachableDefinedFuncs.insert(funcToCheck);
-				}
-				continue;
-			}
-
-			if (containsDefinedFunc(*node)) {
-				reachableDefinedFuncs.insert(funcToCheck);
-			}
-		}
-	}
-
-	return reachableDefinedFuncs;
-}
-
-/**
-* @brief Returns indirectly reachable functions from @a funcs that are in
-*        @a module.
-*/
-std::set<llvm::Function*> ReachableFuncsAnalysis::getIndirectlyReachableDefinedFuncsFor(
-		const std::set<llvm::Function*> &funcs, Module &module) const {
-	IndirectCallsFinder indirectCallsFinder;
-	// Calculate indirect calls for current reachable functions.
-	std::set<llvm::CallInst*> indirectCalls(indirectCallsFinder.
-		getIndirectCallsFor(funcs));
-	return IndirectlyCalledFuncsAnalysis::getFuncsForIndirectCalls(
-		indirectCalls, module.getFunctionList());
-}
-
 } // namespace bin2llvmir
 } // namespace retdec
@@ -4,6 +4,7 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
 #include <iomanip>
 #include <set>
 #include <sstream>
@@ -16,6 +17,8 @@
 #include <llvm/IR/Instructions.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include "retdec/utils/instrumentation.h"
+#include "retdec/utils/parallel.h"
 #include "retdec/utils/time.h"
 #include "retdec/bin2llvmir/analyses/reaching_definitions.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
@@ -35,6 +38,26 @@ namespace bin2llvmir {
 //=============================================================================
 //
 
+thread_local unsigned ReachingDefinitionsAnalysis::_threads = 0;
+
+/**
+ * Set the number of threads that analyse functions of a module in parallel.
+ * @c 0 or @c 1 means the analysis runs on the calling thread only. The
+ * setting is per calling thread, results do not depend on it.
+ */
+void ReachingDefinitionsAnalysis::setThreads(unsigned threads)
+{
+	_threads = threads;
+}
+
+/**
+ * @return Number of threads set by @c setThreads() on the calling thread.
+ */
+unsigned ReachingDefinitionsAnalysis::getThreads()
+{
+	return _threads;
+}
+
 bool ReachingDefinitionsAnalysis::runOnModule(
 		Module& M,
 		Abi* abi,
@@ -45,8 +68,12 @@ bool ReachingDefinitionsAnalysis::runOnModule(
 	_specialGlobal = AsmInstruction::getLlvmToAsmGlobalVariable(&M);
 
 	clear();
-	initializeBasicBlocks(M);
-	run();
+	std::vector<Function*> fncs;
+	for (Function& F : M)
+	{
+		fncs.push_back(&F);
+	}
+	run(fncs);
 
 	_run = true;
 	return false;
@@ -62,38 +89,115 @@ bool ReachingDefinitionsAnalysis::runOnFunction(
 	_specialGlobal = AsmInstruction::getLlvmToAsmGlobalVariable(F.getParent());
 
 	clear();
-	initializeBasicBlocks(F);
-	run();
+	run({&F});
 
 	_run = true;
 	return false;
 }
 
-void ReachingDefinitionsAnalysis::run()
+/**
+ * Recompute the analysis for functions of @a M that were invalidated by
+ * @c invalidate(), or added to @a M since the last run. Results of functions
+ * that are no longer in @a M are dropped. The analysis must have been run on
+ * @a M by @c runOnModule() before.
+ * @return Number of recomputed functions.
+ */
+std::size_t ReachingDefinitionsAnalysis::update(llvm::Module& M)
 {
-	initializeBasicBlocksPrev();
-	initializeKillGenSets();
-	propagate();
-	initializeDefsAndUses();
+	std::set<const Function*> fncs;
+	for (Function& F : M)
+	{
+		fncs.insert(&F);
+	}
+	for (auto it = bbMap.begin(); it != bbMap.end();)
+	{
+		if (fncs.count(it->first) == 0)
+		{
+			it = bbMap.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
 
-	LOG << *this << "\n";
+	std::vector<Function*> toRun;
+	for (Function& F : M)
+	{
+		if (bbMap.count(&F) == 0)
+		{
+			toRun.push_back(&F);
+		}
+	}
+	run(toRun);
 
-	clearInternal();
+	LOG << "RDA: updated " << toRun.size() << " functions\n";
+	return toRun.size();
 }
 
-void ReachingDefinitionsAnalysis::initializeBasicBlocks(llvm::Module& M)
+/**
+ * Drop the results of function @a F. It is recomputed by the next
+ * @c update(). This must be called for every modified function before any
+ * other query of the analysis.
+ */
+void ReachingDefinitionsAnalysis::invalidate(const llvm::Function* F)
 {
-	for (Function& F : M)
+	bbMap.erase(F);
+}
+
+/**
+ * Analyse functions @a fncs. Their entries are created here, then the
+ * functions are analysed independently, possibly in parallel.
+ */
+void ReachingDefinitionsAnalysis::run(const std::vector<llvm::Function*>& fncs)
+{
+	std::vector<FunctionEntry*> entries;
+	entries.reserve(fncs.size());
+	for (auto* F : fncs)
 	{
-		initializeBasicBlocks(F);
+		auto& fe = bbMap[F];
+		fe.firstId = _nextBbId;
+		_nextBbId += F->size();
+		entries.push_back(&fe);
 	}
+
+	parallelFor(fncs.size(), _threads, [&](std::size_t i)
+	{
+		run(fncs[i], *entries[i]);
+	});
+
+	LOG << *this << "\n";
 }
 
-void ReachingDefinitionsAnalysis::initializeBasicBlocks(llvm::Function& F)
+void ReachingDefinitionsAnalysis::run(llvm::Function* F, FunctionEntry& fe)
 {
+	RETDEC_SCOPED_TIMER_VAR(timer, "rda.function");
+	RETDEC_TIMER_ARG(timer, "function", F->getName().str());
+	RETDEC_TIMER_ARG(timer, "basicBlocks", std::uint64_t(F->size()));
+	RETDEC_COUNTER_ADD("rda.basicBlocks", F->size());
+
+	auto& bbs = fe.bbs;
+	std::vector<Definition*> defs;
+	SourceDefinitions srcDefs;
+
+	initializeBasicBlocks(*F, fe);
+	initializeBasicBlocksPrev(bbs);
+	initializeIndexes(fe);
+	numberDefinitions(F, bbs, defs, srcDefs);
+	initializeKillGenSets(bbs, defs.size(), srcDefs);
+	propagate(F, bbs);
+	initializeDefsAndUses(bbs, defs, srcDefs);
+	clearInternal(bbs);
+}
+
+void ReachingDefinitionsAnalysis::initializeBasicBlocks(
+		llvm::Function& F,
+		FunctionEntry& fe)
+{
+	unsigned id = fe.firstId;
 	for (BasicBlock& B : F)
 	{
-		BasicBlockEntry bbe(&B, bbMap.size());
+		BasicBlockEntry bbe(&B, id++);
 
 		int insnPos = -1;
 		for (Instruction& I : B)
@@ -200,13 +304,14 @@ void ReachingDefinitionsAnalysis::initializeBasicBlocks(llvm::Function& F)
 			}
 		}
 
-		bbMap[&F][&B] = bbe;
+		fe.bbs.emplace(&B, std::move(bbe));
 	}
 }
 
 void ReachingDefinitionsAnalysis::clear()
 {
 	bbMap.clear();
+	_nextBbId = 0;
 	_run = false;
 }
 
@@ -219,22 +324,23 @@ bool ReachingDefinitionsAnalysis::wasRun() const
  * Clear internal structures used to compute RDA, but not needed to use it once
  * it is computed.
  */
-void ReachingDefinitionsAnalysis::clearInternal()
+void ReachingDefinitionsAnalysis::clearInternal(BasicBlockEntries& bbs)
 {
-	for (auto& pair1 : bbMap)
-	for (auto& pair : pair1.second)
+	for (auto& pair : bbs)
 	{
 		BasicBlockEntry& bb = pair.second;
-		bb.defsOut.clear();
-		bb.genDefs.clear();
-		bb.killDefs.clear();
+		// Release the memory, clear() keeps it.
+		bb.defsIn = llvm::BitVector();
+		bb.defsOut = llvm::BitVector();
+		bb.genDefs = llvm::BitVector();
+		bb.killDefs = llvm::BitVector();
 	}
 }
 
-void ReachingDefinitionsAnalysis::initializeBasicBlocksPrev()
+void ReachingDefinitionsAnalysis::initializeBasicBlocksPrev(
+		BasicBlockEntries& bbs)
 {
-	for (auto &pair1 : bbMap)
-	for (auto& pair : pair1.second)
+	for (auto& pair : bbs)
 	{
 		auto B = pair.first;
 		auto &entry = pair.second;
@@ -242,60 +348,128 @@ void ReachingDefinitionsAnalysis::initializeBasicBlocksPrev()
 		for (auto PI = pred_begin(B), E = pred_end(B); PI != E; ++PI)
 		{
 			auto* pred = *PI;
-			auto p = pair1.second.find(pred);
+			auto p = bbs.find(pred);
 
-			assert(p != pair1.second.end() && "we should have all BBs stored in bbMap");
+			assert(p != bbs.end() && "we should have all BBs stored in bbMap");
 
 			entry.prevBBs.insert( &p->second );
 		}
 	}
 }
 
-void ReachingDefinitionsAnalysis::initializeKillGenSets()
+void ReachingDefinitionsAnalysis::initializeIndexes(FunctionEntry& fe)
 {
-	for (auto &pair1 : bbMap)
-	for (auto& pair : pair1.second)
+	for (auto& pair : fe.bbs)
 	{
-		pair.second.initializeKillDefSets();
+		for (auto& d : pair.second.defs)
+		{
+			fe.insn2def.emplace(d.def, &d);
+		}
+		for (auto& u : pair.second.uses)
+		{
+			fe.insn2use.emplace(u.use, &u);
+		}
 	}
 }
 
-void ReachingDefinitionsAnalysis::propagate()
+/**
+ * Number definitions in function @a F densely, in the order of its basic
+ * blocks.
+ * @param[out] defs    Definitions indexed by their numbers.
+ * @param[out] srcDefs Numbers of definitions of each defined value.
+ */
+void ReachingDefinitionsAnalysis::numberDefinitions(
+		const llvm::Function* F,
+		BasicBlockEntries& bbs,
+		std::vector<Definition*>& defs,
+		SourceDefinitions& srcDefs)
 {
-	for (auto &pair1 : bbMap)
+	for (const BasicBlock& B : *F)
 	{
-		const Function* fnc = pair1.first;
-
-		std::vector<BasicBlockEntry*> workList;
-		workList.reserve(pair1.second.size());
-		ReversePostOrderTraversal<const Function*> RPOT(fnc); // Expensive to create
-		for (auto I = RPOT.begin(); I != RPOT.end(); ++I)
+		auto fIt = bbs.find(&B);
+		assert(fIt != bbs.end());
+		for (Definition& d : fIt->second.defs)
 		{
-			const BasicBlock* bb = *I;
-			auto fIt = pair1.second.find(bb);
-			assert(fIt != pair1.second.end());
-			workList.push_back(&(fIt->second));
-
-			fIt->second.changed = true;
+			d.id = defs.size();
+			defs.push_back(&d);
 		}
+	}
 
-		bool changed = true;
-		while (changed)
+	for (auto* d : defs)
+	{
+		auto& bv = srcDefs[d->src];
+		if (bv.empty())
 		{
-			changed = false;
+			bv.resize(defs.size());
+		}
+		bv.set(d->id);
+	}
+}
 
-			for (auto* bbe : workList)
+/**
+ * GEN[B] = the last definition of each value defined in B
+ * KILL[B] = all the definitions of values defined in B
+ */
+void ReachingDefinitionsAnalysis::initializeKillGenSets(
+		BasicBlockEntries& bbs,
+		std::size_t defCount,
+		const SourceDefinitions& srcDefs)
+{
+	for (auto& pair : bbs)
+	{
+		BasicBlockEntry& bbe = pair.second;
+		bbe.defsIn.resize(defCount);
+		bbe.defsOut.resize(defCount);
+		bbe.genDefs.resize(defCount);
+		bbe.killDefs.resize(defCount);
+
+		for (auto dIt = bbe.defs.rbegin(); dIt != bbe.defs.rend(); ++dIt)
+		{
+			// Killed if a later definition of the same value was seen.
+			if (!bbe.killDefs.test(dIt->id))
 			{
-				changed |= bbe->initDefsOut();
+				bbe.genDefs.set(dIt->id);
+				bbe.killDefs |= srcDefs.find(dIt->src)->second;
 			}
 		}
 	}
 }
 
-void ReachingDefinitionsAnalysis::initializeDefsAndUses()
+void ReachingDefinitionsAnalysis::propagate(
+		const llvm::Function* F,
+		BasicBlockEntries& bbs)
+{
+	std::vector<BasicBlockEntry*> workList;
+	workList.reserve(bbs.size());
+	ReversePostOrderTraversal<const Function*> RPOT(F); // Expensive to create
+	for (auto I = RPOT.begin(); I != RPOT.end(); ++I)
+	{
+		const BasicBlock* bb = *I;
+		auto fIt = bbs.find(bb);
+		assert(fIt != bbs.end());
+		workList.push_back(&(fIt->second));
+	}
+
+	bool changed = true;
+	while (changed)
+	{
+		changed = false;
+
+		for (auto* bbe : workList)
+		{
+			changed |= bbe->initDefsOut();
+		}
+	}
+}
+
+void ReachingDefinitionsAnalysis::initializeDefsAndUses(
+		BasicBlockEntries& bbs,
+		const std::vector<Definition*>& defs,
+		const SourceDefinitions& srcDefs)
 {
-	for (auto &pair1 : bbMap)
-	for (auto& pair : pair1.second)
+	llvm::BitVector reaching;
+
+	for (auto& pair : bbs)
 	{
 		BasicBlockEntry &bb = pair.second;
 
@@ -320,60 +494,85 @@ void ReachingDefinitionsAnalysis::initializeDefsAndUses()
 
 			if (u.defs.empty())
 			{
-				for (auto p : bb.prevBBs)
-				for (auto d : p->defsOut)
+				auto fIt = srcDefs.find(u.src);
+				if (fIt == srcDefs.end())
 				{
-					if (d->getSource() == u.src)
-					{
-						d->uses.insert(&u);
-						u.defs.insert(d);
-					}
+					continue;
+				}
+
+				reaching = bb.defsIn;
+				reaching &= fIt->second;
+				for (unsigned id : reaching.set_bits())
+				{
+					Definition* d = defs[id];
+					d->uses.insert(&u);
+					u.defs.insert(d);
 				}
 			}
 		}
 	}
 }
 
-const BasicBlockEntry& ReachingDefinitionsAnalysis::getBasicBlockEntry(
-		const Instruction* I) const
+const DefSet& ReachingDefinitionsAnalysis::defsFromUse(const Instruction* I) const
 {
-	auto* F = I->getFunction();
-	auto pair1 = bbMap.find(F);
-	assert(pair1 != bbMap.end() && "we do not have this function in bbMap");
-
-	auto* BB = I->getParent();
-	auto pair = pair1->second.find(BB);
-	assert(pair != pair1->second.end() && "we do not have this basic block in bbMap");
-
-	return pair->second;
+	static DefSet emptyDefSet;
+	auto* u = getUse(I);
+	return u ? u->defs : emptyDefSet;
 }
 
-const DefSet& ReachingDefinitionsAnalysis::defsFromUse(const Instruction* I) const
+const UseSet& ReachingDefinitionsAnalysis::usesFromDef(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).defsFromUse(I);
+	static UseSet emptyUseSet;
+	auto* d = getDef(I);
+	return d ? d->uses : emptyUseSet;
 }
 
-const UseSet& ReachingDefinitionsAnalysis::usesFromDef(const Instruction* I) const
+/**
+ * @return Entry of the function containing @a I, @c nullptr if there is none.
+ */
+const ReachingDefinitionsAnalysis::FunctionEntry*
+ReachingDefinitionsAnalysis::getFunctionEntry(const llvm::Instruction* I) const
 {
-	return getBasicBlockEntry(I).usesFromDef(I);
+	if (I->getParent() == nullptr)
+	{
+		return nullptr;
+	}
+	auto fIt = bbMap.find(I->getFunction());
+	return fIt != bbMap.end() ? &fIt->second : nullptr;
 }
 
 const Definition* ReachingDefinitionsAnalysis::getDef(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).getDef(I);
+	auto* fe = getFunctionEntry(I);
+	if (fe == nullptr)
+	{
+		return nullptr;
+	}
+	auto fIt = fe->insn2def.find(I);
+	return fIt != fe->insn2def.end() ? fIt->second : nullptr;
 }
 
 const Use* ReachingDefinitionsAnalysis::getUse(const Instruction* I) const
 {
-	return getBasicBlockEntry(I).getUse(I);
+	auto* fe = getFunctionEntry(I);
+	if (fe == nullptr)
+	{
+		return nullptr;
+	}
+	auto fIt = fe->insn2use.find(I);
+	return fIt != fe->insn2use.end() ? fIt->second : nullptr;
 }
 
 std::ostream& operator<<(std::ostream& out, const ReachingDefinitionsAnalysis& rda)
 {
 	for (auto &pair1 : rda.bbMap)
-	for (auto& pair : pair1.second)
+	for (const BasicBlock& B : *pair1.first)
 	{
-		out << pair.second;
+		auto fIt = pair1.second.bbs.find(&B);
+		if (fIt != pair1.second.bbs.end())
+		{
+			out << fIt->second;
+		}
 	}
 	return out;
 }
@@ -391,52 +590,32 @@ BasicBlockEntry::BasicBlockEntry(const llvm::BasicBlock* b, std::size_t _id) :
 
 }
 
-void BasicBlockEntry::initializeKillDefSets()
-{
-	killDefs.clear();
-	genDefs.clear();
-
-	for (auto dIt = defs.rbegin(); dIt != defs.rend(); ++dIt)
-	{
-		Definition& d = *dIt;
-
-		bool added = (killDefs.insert(d.getSource())).second;
-		if (added)
-		{
-			genDefs.insert(&d);
-		}
-	}
-}
-
 /**
  * REACH_in[B] = Sum (p in pred[B]) (REACH_out[p])
  * REACH_out[B] = GEN[B] + ( REACH_in[B] - KILL[B] )
+ *
+ * Both sets only grow during the propagation, @c defsIn is therefore not
+ * reset.
  */
 Changed BasicBlockEntry::initDefsOut()
 {
-	auto oldSz = defsOut.size();
-
-	if (defsOut.empty() && !genDefs.empty())
+	for (auto* p : prevBBs)
 	{
-		defsOut = std::move(genDefs);
+		defsIn |= p->defsOut;
 	}
 
-	for (auto* p : prevBBs)
+	auto oldCount = defsOut.count();
+
+	defsOut |= genDefs;
+	for (unsigned id : defsIn.set_bits())
 	{
-		if (p->changed)
+		if (!killDefs.test(id))
 		{
-			for (auto* d : p->defsOut)
-			{
-				if (killDefs.find(d->getSource()) == killDefs.end())
-				{
-					defsOut.insert(d);
-				}
-			}
+			defsOut.set(id);
 		}
 	}
 
-	changed = oldSz != defsOut.size();
-	return changed;
+	return oldCount != defsOut.count();
 }
 
 std::string BasicBlockEntry::getName() const
@@ -784,5 +963,75 @@ std::set<llvm::Instruction*> ReachingDefinitionsAnalysis::usesFromDef_onDemand(
 	return ret;
 }
 
+//
+//=============================================================================
+//  ReachingDefinitionsProvider
+//=============================================================================
+//
+
+thread_local std::map<ReachingDefinitionsProvider::Key, ReachingDefinitionsAnalysis>
+		ReachingDefinitionsProvider::_module2rda;
+
+/**
+ * Get the analysis of module @a m, compute it if it is not available, or
+ * recompute its invalidated functions.
+ * @param m             Analysed module.
+ * @param abi           ABI used if the analysis is computed.
+ * @param trackFlagRegs Analyses with and without flag registers are kept
+ *                      separately.
+ */
+ReachingDefinitionsAnalysis* ReachingDefinitionsProvider::getRda(
+		llvm::Module* m,
+		Abi* abi,
+		bool trackFlagRegs)
+{
+	if (m == nullptr)
+	{
+		return nullptr;
+	}
+
+	auto& rda = _module2rda[Key(m, trackFlagRegs)];
+	if (rda.wasRun())
+	{
+		rda.update(*m);
+	}
+	else
+	{
+		rda.runOnModule(*m, abi, trackFlagRegs);
+	}
+	return &rda;
+}
+
+/**
+ * Invalidate the results of function @a f in all the analyses of module @a m.
+ */
+void ReachingDefinitionsProvider::invalidate(
+		llvm::Module* m,
+		const llvm::Function* f)
+{
+	for (bool flags : {false, true})
+	{
+		auto fIt = _module2rda.find(Key(m, flags));
+		if (fIt != _module2rda.end())
+		{
+			fIt->second.invalidate(f);
+		}
+	}
+}
+
+/**
+ * Drop all the analyses of module @a m.
+ */
+void ReachingDefinitionsProvider::invalidate(llvm::Module* m)
+{
+	_module2rda.erase(Key(m, false));
+	_module2rda.erase(Key(m, true));
+}
+
+void ReachingDefinitionsProvider::clear()
+{
+	_module2rda.clear();
+}
+
 } // namespace bin2llvmir
 } // namespace retdec
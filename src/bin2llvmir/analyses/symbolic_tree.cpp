@@ -4,13 +4,17 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <map>
+#include <memory>
 #include <ostream>
 #include <sstream>
+#include <tuple>
 
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Operator.h>
 
+#include "retdec/utils/instrumentation.h"
 #include "retdec/utils/string.h"
 #include "retdec/bin2llvmir/analyses/symbolic_tree.h"
 #include "retdec/bin2llvmir/utils/llvm.h"
@@ -27,12 +31,79 @@ using namespace retdec::bin2llvmir::st_match;
 namespace retdec {
 namespace bin2llvmir {
 
+namespace {
+
+/// Maximal number of nodes in subtrees memoized by a single tree
+/// construction.
+const std::size_t EXPANSION_CACHE_MAX_NODES = 1 << 16;
+/// Maximal number of nodes in subtrees memoized by a single simplification.
+const std::size_t SIMPLIFICATION_CACHE_MAX_NODES = 1 << 16;
+/// Smaller trees are simplified without memoization.
+const std::size_t SIMPLIFICATION_CACHE_MIN_NODES = 64;
+
+} // anonymous namespace
+
+/**
+ * Subtrees expanded by a single tree construction, indexed by the expanded
+ * value and its level. A subtree is memoized when it is expanded for the
+ * second time, and copied since then.
+ */
+struct SymbolicTree::ExpansionCache
+{
+	struct Entry
+	{
+		unsigned expansions = 0;
+		/// @c True if the subtree's user is the user it was created for,
+		/// @c false if it was replaced by simplification at creation.
+		bool ownUser = true;
+		std::unique_ptr<SymbolicTree> tree;
+	};
+
+	std::map<std::pair<llvm::Value*, unsigned>, Entry> entries;
+	std::size_t nodes = 0;
+};
+
+/**
+ * Structurally identical subtrees of a single simplification. A subtree is
+ * identified by its value, user, and identifiers of its operands.
+ */
+struct SymbolicTree::SimplificationCache
+{
+	using Key = std::tuple<llvm::Value*, llvm::Value*, std::vector<unsigned>>;
+
+	std::map<Key, unsigned> key2id;
+	std::map<const SymbolicTree*, unsigned> node2id;
+	/// Number of occurrences of each subtree identifier.
+	std::vector<unsigned> occurrences;
+	/// Simplified subtrees with more than one occurrence.
+	std::map<unsigned, SymbolicTree> simplified;
+	std::size_t nodes = 0;
+};
+
+/**
+ * Construct a tree, values repeated in it are expanded only once.
+ */
+SymbolicTree SymbolicTree::create(
+		ReachingDefinitionsAnalysis* rda,
+		llvm::Value* v,
+		unsigned maxNodeLevel,
+		std::map<llvm::Value*, llvm::Value*>* val2val,
+		bool linear)
+{
+	ExpansionCache cache;
+	auto* prev = _expansionCache;
+	_expansionCache = &cache;
+	SymbolicTree ret(rda, v, nullptr, 0, maxNodeLevel, val2val, linear);
+	_expansionCache = prev;
+	return ret;
+}
+
 SymbolicTree SymbolicTree::PrecomputedRda(
 		ReachingDefinitionsAnalysis& rda,
 		llvm::Value* v,
 		unsigned maxNodeLevel)
 {
-	return SymbolicTree(&rda, v, nullptr, 0, maxNodeLevel, nullptr, false);
+	return create(&rda, v, maxNodeLevel, nullptr, false);
 }
 
 SymbolicTree SymbolicTree::PrecomputedRdaWithValueMap(
@@ -42,21 +113,21 @@ SymbolicTree SymbolicTree::PrecomputedRdaWithValueMap(
 		unsigned maxNodeLevel)
 {
 	_val2valUsed = false;
-	return SymbolicTree(&rda, v, nullptr, 0, maxNodeLevel, val2val, false);
+	return create(&rda, v, maxNodeLevel, val2val, false);
 }
 
 SymbolicTree SymbolicTree::OnDemandRda(
 		llvm::Value* v,
 		unsigned maxNodeLevel)
 {
-	return SymbolicTree(nullptr, v, nullptr, 0, maxNodeLevel, nullptr, false);
+	return create(nullptr, v, maxNodeLevel, nullptr, false);
 }
 
 SymbolicTree SymbolicTree::Linear(
 		llvm::Value* v,
 		unsigned maxNodeLevel)
 {
-	return SymbolicTree(nullptr, v, nullptr, 0, maxNodeLevel, nullptr, true);
+	return create(nullptr, v, maxNodeLevel, nullptr, true);
 }
 
 SymbolicTree::SymbolicTree(
@@ -71,6 +142,41 @@ SymbolicTree::SymbolicTree(
 		value(v),
 		user(u),
 		_level(nodeLevel)
+{
+	ExpansionCache::Entry* entry = nullptr;
+	if (_expansionCache)
+	{
+		entry = &_expansionCache->entries[{v, nodeLevel}];
+		if (entry->tree)
+		{
+			value = entry->tree->value;
+			user = entry->ownUser ? u : entry->tree->user;
+			ops = std::vector<SymbolicTree>(entry->tree->ops);
+			RETDEC_COUNTER_ADD("symbolicTree.cachedExpansions", 1);
+			return;
+		}
+	}
+
+	RETDEC_COUNTER_ADD("symbolicTree.expansions", 1);
+	build(rda, val2val, maxNodeLevel, linear);
+
+	// The reference is still valid, std::map does not move its elements.
+	if (entry
+			&& ++entry->expansions > 1
+			&& !ops.empty()
+			&& _expansionCache->nodes < EXPANSION_CACHE_MAX_NODES)
+	{
+		entry->ownUser = user == u;
+		entry->tree = std::make_unique<SymbolicTree>(*this);
+		_expansionCache->nodes += getNodeCount();
+	}
+}
+
+void SymbolicTree::build(
+		ReachingDefinitionsAnalysis* rda,
+		std::map<llvm::Value*, llvm::Value*>* val2val,
+		unsigned maxNodeLevel,
+		bool linear)
 {
 	ops.reserve(_naryLimit);
 
@@ -340,20 +446,83 @@ void SymbolicTree::expandNode(
 
 void SymbolicTree::simplifyNode()
 {
-	_simplifyNode();
+	if (getNodeCount() >= SIMPLIFICATION_CACHE_MIN_NODES)
+	{
+		SimplificationCache cache;
+		internSubtrees(cache);
+		_simplifyNode(&cache);
+	}
+	else
+	{
+		_simplifyNode(nullptr);
+	}
 	fixLevel();
 }
 
-void SymbolicTree::_simplifyNode()
+/**
+ * Assign identifiers to all the subtrees, structurally identical subtrees
+ * get the same identifier.
+ * @return Identifier of this tree.
+ */
+unsigned SymbolicTree::internSubtrees(SimplificationCache& cache) const
+{
+	std::vector<unsigned> opIds;
+	opIds.reserve(ops.size());
+	for (auto& o : ops)
+	{
+		opIds.push_back(o.internSubtrees(cache));
+	}
+
+	auto p = cache.key2id.emplace(
+			SimplificationCache::Key(value, user, std::move(opIds)),
+			cache.occurrences.size());
+	unsigned id = p.first->second;
+	if (p.second)
+	{
+		cache.occurrences.push_back(0);
+	}
+	++cache.occurrences[id];
+	cache.node2id[this] = id;
+	return id;
+}
+
+/**
+ * @param cache Simplification cache with all the subtrees interned by
+ *              @c internSubtrees(), or @c nullptr.
+ */
+void SymbolicTree::_simplifyNode(SimplificationCache* cache)
 {
 	if (ops.empty())
 	{
 		return;
 	}
 
+	// Nodes are not moved before they are simplified, their addresses
+	// identify them.
+	unsigned id = 0;
+	bool memoize = false;
+	if (cache)
+	{
+		auto iIt = cache->node2id.find(this);
+		if (iIt != cache->node2id.end())
+		{
+			id = iIt->second;
+			auto sIt = cache->simplified.find(id);
+			if (sIt != cache->simplified.end())
+			{
+				value = sIt->second.value;
+				user = sIt->second.user;
+				ops = std::vector<SymbolicTree>(sIt->second.ops);
+				return;
+			}
+			memoize = cache->occurrences[id] > 1
+					&& cache->nodes < SIMPLIFICATION_CACHE_MAX_NODES;
+		}
+	}
+
 	for (auto &o : ops)
 	{
-		o._simplifyNode();
+		o._simplifyNode(cache);
 	}
 
 	if (isa<LoadInst>(value) && ops.size() > 1)
@@ -382,6 +551,10 @@ void SymbolicTree::_simplifyNode()
 	ConstantInt* c1 = nullptr;
 	ConstantInt* c2 = nullptr;
 
+	// Most nodes match none of the patterns below, their shape rejects them
+	// without running the matchers.
+	st_match::Shape shape(*this);
+
 	if (isa<CastInst>(value))
 	{
 		*this = std::move(ops[0]);
@@ -400,7 +573,7 @@ void SymbolicTree::_simplifyNode()
 	// MIPS, use function address for t9.
 	//
 	else if (_abi->isMips()
-			&& match(*this, m_Load(
+			&& match(*this, shape, m_Load(
 					m_Specific(_abi->getRegister(MIPS_REG_T9)),
 					&load)))
 	{
@@ -408,47 +581,47 @@ void SymbolicTree::_simplifyNode()
 		value = ConstantInt::get(load->getType(), addr);
 		ops.clear();
 	}
-	else if (match(*this, m_Load(m_GlobalVariable(global), &load))
+	else if (match(*this, shape, m_Load(m_GlobalVariable(global), &load))
 			&& global == load->getPointerOperand()
 			&& ops[0].ops.size() == 1)
 	{
 		*this = std::move(ops[0].ops[0]);
 	}
-	else if (match(*this, m_Load(m_Value(val), &load))
+	else if (match(*this, shape, m_Load(m_Value(val), &load))
 			&& (isa<AllocaInst>(llvm_utils::skipCasts(load->getPointerOperand()))
 			|| isa<GlobalVariable>(llvm_utils::skipCasts(load->getPointerOperand()))))
 	{
 		*this = std::move(ops[0]);
 	}
-	else if (match(*this, m_Add(m_ConstantInt(c1), m_ConstantInt(c2))))
+	else if (match(*this, shape, m_Add(m_ConstantInt(c1), m_ConstantInt(c2))))
 	{
 		value = ConstantInt::get(
 				c1->getType(),
 				c1->getSExtValue() + c2->getSExtValue());
 		ops.clear();
 	}
-	else if (match(*this, m_Sub(m_ConstantInt(c1), m_ConstantInt(c2))))
+	else if (match(*this, shape, m_Sub(m_ConstantInt(c1), m_ConstantInt(c2))))
 	{
 		value = ConstantInt::get(
 				c1->getType(),
 				c1->getSExtValue() - c2->getSExtValue());
 		ops.clear();
 	}
-	else if (match(*this, m_Or(m_ConstantInt(c1), m_ConstantInt(c2))))
+	else if (match(*this, shape, m_Or(m_ConstantInt(c1), m_ConstantInt(c2))))
 	{
 		value = ConstantInt::get(
 				c1->getType(),
 				c1->getSExtValue() | c2->getSExtValue());
 		ops.clear();
 	}
-	else if (match(*this, m_And(m_ConstantInt(c1), m_ConstantInt(c2))))
+	else if (match(*this, shape, m_And(m_ConstantInt(c1), m_ConstantInt(c2))))
 	{
 		value = ConstantInt::get(
 				c1->getType(),
 				c1->getSExtValue() & c2->getSExtValue());
 		ops.clear();
 	}
-	else if (match(*this, m_Add(m_GlobalVariable(global), m_ConstantInt(c1)))
+	else if (match(*this, shape, m_Add(m_GlobalVariable(global), m_ConstantInt(c1)))
 			&& ops[0].user && !isa<LoadInst>(ops[0].user)
 			&& _config)
 	{
@@ -458,17 +631,17 @@ void SymbolicTree::_simplifyNode()
 			ops.clear();
 		}
 	}
-	else if (match(*this, m_Add(m_Value(), m_Zero()))
-			|| match(*this, m_Sub(m_Value(), m_Zero())))
+	else if (match(*this, shape, m_Add(m_Value(), m_Zero()))
+			|| match(*this, shape, m_Sub(m_Value(), m_Zero())))
 	{
 		*this = std::move(ops[0]);
 	}
-	else if (match(*this, m_Add(m_Zero(), m_Value()))
-			|| match(*this, m_Sub(m_Zero(), m_Value())))
+	else if (match(*this, shape, m_Add(m_Zero(), m_Value()))
+			|| match(*this, shape, m_Sub(m_Zero(), m_Value())))
 	{
 		*this = std::move(ops[1]);
 	}
-	else if (match(*this, m_Add(
+	else if (match(*this, shape, m_Add(
 			m_Add(m_Value(), m_ConstantInt(c1)),
 			m_ConstantInt(c2))))
 	{
@@ -488,6 +661,12 @@ void SymbolicTree::_simplifyNode()
 	{
 		std::swap(ops[0], ops[1]);
 	}
+
+	if (memoize)
+	{
+		cache->simplified.emplace(id, *this);
+		cache->nodes += getNodeCount();
+	}
 }
 
 /**
@@ -652,6 +831,16 @@ void SymbolicTree::_getPostOrder(std::vector<SymbolicTree*>& res) const
 	res.emplace_back(const_cast<SymbolicTree*>(this));
 }
 
+std::size_t SymbolicTree::getNodeCount() const
+{
+	std::size_t cntr = 1;
+	for (auto& o : ops)
+	{
+		cntr += o.getNodeCount();
+	}
+	return cntr;
+}
+
 void SymbolicTree::fixLevel(unsigned level)
 {
 	if (level == 0)
@@ -699,14 +888,15 @@ bool SymbolicTree::isNary(unsigned N) const
 //==============================================================================
 //
 
-Abi* SymbolicTree::_abi = nullptr;
-Config* SymbolicTree::_config = nullptr;
-bool SymbolicTree::_val2valUsed = false;
-bool SymbolicTree::_trackThroughAllocaLoads = true;
-bool SymbolicTree::_trackThroughGeneralRegisterLoads = true;
-bool SymbolicTree::_trackOnlyFlagRegisters = false;
-bool SymbolicTree::_simplifyAtCreation = true;
-unsigned SymbolicTree::_naryLimit = 3;
+thread_local Abi* SymbolicTree::_abi = nullptr;
+thread_local Config* SymbolicTree::_config = nullptr;
+thread_local bool SymbolicTree::_val2valUsed = false;
+thread_local bool SymbolicTree::_trackThroughAllocaLoads = true;
+thread_local bool SymbolicTree::_trackThroughGeneralRegisterLoads = true;
+thread_local bool SymbolicTree::_trackOnlyFlagRegisters = false;
+thread_local bool SymbolicTree::_simplifyAtCreation = true;
+thread_local unsigned SymbolicTree::_naryLimit = 3;
+thread_local SymbolicTree::ExpansionCache* SymbolicTree::_expansionCache = nullptr;
 
 void SymbolicTree::clear()
 {
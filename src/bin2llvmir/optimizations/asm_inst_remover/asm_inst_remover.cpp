@@ -75,12 +75,7 @@ bool AsmInstructionRemover::run(Module& M)
 
 	// Free Capstone instructions.
 	//
-	auto& insnMap = AsmInstruction::getLlvmToCapstoneInsnMap(&M);
-	for (auto& p : insnMap)
-	{
-		cs_free(p.second, 1);
-	}
-	insnMap.clear();
+	AsmInstruction::clearCapstoneInsns(&M);
 
 	// Remove special global variable.
 	//
@@ -182,7 +182,8 @@ void ClassHierarchyAnalysis::processRttiGcc()
 	auto& rttiGcc = image->getRtti().getRttiGcc();
 
 	Class* c = nullptr;
-	std::map<const rtti_finder::ClassTypeInfo*, Class*> rtti2class;
+	GccRttiToClass rtti2class;
+	rtti2class.reserve(rttiGcc.size());
 
 	for (auto& rtti : rttiGcc)
 	{
@@ -223,7 +224,8 @@ void ClassHierarchyAnalysis::processRttiMsvc()
 	auto& rttiA = image->getRtti().getRttiMsvc();
 
 	Class* c = nullptr;
-	std::map<const rtti_finder::RTTITypeDescriptor*, Class*> rtti2class;
+	MsvcRttiToClass rtti2class;
+	rtti2class.reserve(rttiA.typeDescriptors.size());
 
 	for (auto& rtti : rttiA.typeDescriptors)
 	{
@@ -254,8 +256,7 @@ void ClassHierarchyAnalysis::processRttiMsvc()
 	processVtablesMsvc(rtti2class);
 }
 
-void ClassHierarchyAnalysis::processVtablesGcc(
-		std::map<const rtti_finder::ClassTypeInfo*, Class*> &rtti2class)
+void ClassHierarchyAnalysis::processVtablesGcc(GccRttiToClass& rtti2class)
 {
 	auto& vtables = image->getRtti().getVtablesGcc();
 	auto& cdtor = ctorDtor.getResults();
@@ -284,11 +285,11 @@ void ClassHierarchyAnalysis::processVtablesGcc(
 		}
 
 		c->virtualFunctionTables.insert(gcc);
+		vtable2class[gcc] = c;
 	}
 }
 
-void ClassHierarchyAnalysis::processVtablesMsvc(
-		std::map<const rtti_finder::RTTITypeDescriptor*, Class*> &rtti2class)
+void ClassHierarchyAnalysis::processVtablesMsvc(MsvcRttiToClass& rtti2class)
 {
 	auto& vtables = image->getRtti().getVtablesMsvc();
 	auto& cdtor = ctorDtor.getResults();
@@ -317,6 +318,7 @@ void ClassHierarchyAnalysis::processVtablesMsvc(
 		}
 
 		c->virtualFunctionTables.insert(msvc);
+		vtable2class[msvc] = c;
 	}
 }
 
@@ -337,22 +339,22 @@ void ClassHierarchyAnalysis::processCtorsDtors()
 
 		auto* lastVtableStored = p.second.vftableStores.back().second;
 
-		for (auto& c : classHierarchy.classes)
+		// Each vtable belongs to the class of its RTTI, see
+		// processVtablesGcc() and processVtablesMsvc().
+		auto cIt = vtable2class.find(lastVtableStored);
+		if (cIt == vtable2class.end())
 		{
-			for (auto* vt : c.virtualFunctionTables)
-			{
-				if (vt == lastVtableStored)
-				{
-					if (p.second.ctor)
-					{
-						c.constructors.insert(p.first);
-					}
-					if (p.second.dtor)
-					{
-						c.destructors.insert(p.first);
-					}
-				}
-			}
+			continue;
+		}
+		auto* c = cIt->second;
+
+		if (p.second.ctor)
+		{
+			c->constructors.insert(p.first);
+		}
+		if (p.second.dtor)
+		{
+			c->destructors.insert(p.first);
 		}
 	}
 }
@@ -107,6 +107,7 @@ bool CondBranchOpt::runOnInstruction(
 	Value* subVal = nullptr;
 	BinaryOperator* binOp = nullptr;
 	ICmpInst* icmp = nullptr;
+	Shape shape(root);
 
 	// ZF SF OF xor or
 	// ZF OF SF xor or
@@ -115,7 +116,7 @@ bool CondBranchOpt::runOnInstruction(
 	//
 	// => icmp sle
 	//
-	if (match(root, m_c_Or(
+	if (match(root, shape, m_c_Or(
 			m_CombineOr(
 					m_c_ICmp(ICmpInst::ICMP_NE, m_Instruction<ICmpInst>(), m_Instruction<ICmpInst>()),
 					m_c_ICmp(ICmpInst::ICMP_NE, m_Instruction<ICmpInst>(), m_Instruction<ICmpInst>())),
@@ -125,7 +126,7 @@ bool CondBranchOpt::runOnInstruction(
 	{
 		return transformConditionSub(br, testedVal, subVal, binOp, ICmpInst::ICMP_SLE);
 	}
-	if (match(root, m_c_Or(
+	if (match(root, shape, m_c_Or(
 			m_CombineOr(
 					m_c_ICmp(ICmpInst::ICMP_NE, m_Instruction<ICmpInst>(), m_Instruction<ICmpInst>()),
 					m_c_ICmp(ICmpInst::ICMP_NE, m_Instruction<ICmpInst>(), m_Instruction<ICmpInst>())),
@@ -142,7 +143,7 @@ bool CondBranchOpt::runOnInstruction(
 	//
 	// => icmp slt
 	//
-	if (match(root, m_c_ICmp(ICmpInst::ICMP_NE,
+	if (match(root, shape, m_c_ICmp(ICmpInst::ICMP_NE,
 			m_c_ICmp(ICmpInst::ICMP_SLT,
 					m_Sub(m_Value(testedVal), m_Value(subVal), &binOp),
 					m_Zero()),
@@ -153,7 +154,7 @@ bool CondBranchOpt::runOnInstruction(
 
 	// => icmp sgt
 	//
-	if (match(root, m_c_ICmp(ICmpInst::ICMP_EQ,
+	if (match(root, shape, m_c_ICmp(ICmpInst::ICMP_EQ,
 			m_c_ICmp(ICmpInst::ICMP_EQ,
 					m_c_ICmp(ICmpInst::ICMP_EQ, m_Value(), m_Value()),
 					m_Zero()),
@@ -173,7 +174,7 @@ bool CondBranchOpt::runOnInstruction(
 	//
 	// => icmp sgt
 	//
-	if (match(root, m_c_ICmp(ICmpInst::ICMP_NE,
+	if (match(root, shape, m_c_ICmp(ICmpInst::ICMP_NE,
 			m_c_Or(
 					m_c_ICmp(ICmpInst::ICMP_NE,
 							m_c_ICmp(ICmpInst::ICMP_SLT, m_Value(), m_Value()),
@@ -185,7 +186,7 @@ bool CondBranchOpt::runOnInstruction(
 	{
 		return transformConditionSub(br, testedVal, subVal, binOp, ICmpInst::ICMP_SGT);
 	}
-	if (match(root, m_c_ICmp(ICmpInst::ICMP_NE,
+	if (match(root, shape, m_c_ICmp(ICmpInst::ICMP_NE,
 			m_c_Or(
 					m_c_ICmp(ICmpInst::ICMP_NE,
 							m_c_ICmp(ICmpInst::ICMP_SLT, m_Value(), m_Value()),
@@ -206,7 +207,7 @@ bool CondBranchOpt::runOnInstruction(
 	//
 	// => icmp sge
 	//
-	if (match(root, m_c_ICmp(ICmpInst::ICMP_NE,
+	if (match(root, shape, m_c_ICmp(ICmpInst::ICMP_NE,
 			m_c_ICmp(ICmpInst::ICMP_NE,
 					m_c_ICmp(ICmpInst::ICMP_SLT,
 							m_Sub(m_Value(testedVal), m_Value(subVal), &binOp),
@@ -219,7 +220,7 @@ bool CondBranchOpt::runOnInstruction(
 
 	// => icmp sge
 	//
-	if (match(root, m_c_ICmp(ICmpInst::ICMP_EQ,
+	if (match(root, shape, m_c_ICmp(ICmpInst::ICMP_EQ,
 			m_c_ICmp(ICmpInst::ICMP_SLT,
 					m_Sub(m_Value(testedVal), m_Value(subVal), &binOp),
 					m_Zero()),
@@ -233,7 +234,7 @@ bool CondBranchOpt::runOnInstruction(
 	//
 	// => icmp ne
 	//
-	if (match(root, m_c_ICmp(ICmpInst::ICMP_NE,
+	if (match(root, shape, m_c_ICmp(ICmpInst::ICMP_NE,
 			m_c_ICmp(ICmpInst::ICMP_EQ,
 					m_Sub(m_Value(testedVal), m_Value(subVal), &binOp),
 					m_Zero()),
@@ -246,7 +247,7 @@ bool CondBranchOpt::runOnInstruction(
 	//
 	llvm::LoadInst* load = nullptr;
 	ConstantInt* ci = nullptr;
-	if (match(root, m_c_ICmp(ICmpInst::ICMP_NE,
+	if (match(root, shape, m_c_ICmp(ICmpInst::ICMP_NE,
 			m_c_ICmp(ICmpInst::ICMP_UGT,
 					m_Load(m_Value(), &load),
 					m_ConstantInt(ci)),
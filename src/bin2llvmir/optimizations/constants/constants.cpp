@@ -74,8 +74,7 @@ bool ConstantsAnalysis::runOnModuleCustom(
 
 bool ConstantsAnalysis::run()
 {
-	ReachingDefinitionsAnalysis RDA;
-	RDA.runOnModule(*_module, _abi);
+	auto& RDA = *ReachingDefinitionsProvider::getRda(_module, _abi);
 
 	for (Function& f : *_module)
 	for (inst_iterator I = inst_begin(&f), E = inst_end(&f); I != E;)
@@ -111,6 +110,11 @@ bool ConstantsAnalysis::run()
 	}
 
 	IrModifier::eraseUnusedInstructionsRecursive(_toRemove);
+	for (auto* f : _modified)
+	{
+		ReachingDefinitionsProvider::invalidate(_module, f);
+	}
+	_modified.clear();
 
 	return false;
 }
@@ -145,6 +149,7 @@ void ConstantsAnalysis::checkForGlobalInInstruction(
 
 		if (ngv)
 		{
+			_modified.insert(inst->getFunction());
 			if (max == &root)
 			{
 				auto* conv = IrModifier::convertConstantToType(ngv, val->getType());
@@ -164,6 +169,7 @@ void ConstantsAnalysis::checkForGlobalInInstruction(
 	auto* gv = dyn_cast<GlobalVariable>(root.value);
 	if (isa<LoadInst>(inst) && gv && root.ops.size() <= 1)
 	{
+		_modified.insert(inst->getFunction());
 		auto* conv = IrModifier::convertConstantToType(gv, val->getType());
 		_toRemove.insert(val);
 		inst->replaceUsesOfWith(val, conv);
@@ -47,6 +47,16 @@ std::size_t Decoder::decodeJumpTargetDryRun_arm(
 		ByteData bytes,
 		bool strict)
 {
+	// The mode is known from mapping symbols or already decoded code - the
+	// other mode is not tried.
+	//
+	if (auto mode = _modes.get(jt.getAddress()))
+	{
+		std::size_t decodedSz = 0;
+		jt.setMode(*mode);
+		return decodeJumpTargetDryRun_arm(jt, bytes, *mode, decodedSz, strict);
+	}
+
 	std::size_t decodedSzArm = 0;
 	auto skipArm = decodeJumpTargetDryRun_arm(
 			jt,
@@ -105,17 +115,13 @@ std::size_t Decoder::decodeJumpTargetDryRun_arm(
 		std::size_t &decodedSz,
 		bool strict)
 {
-
-	auto basicMode = _c2l->getBasicMode();
-	if (mode != basicMode) _c2l->modifyBasicMode(mode);
-
 	csh ce = _c2l->getCapstoneEngine();
 
 	decodedSz = 0;
 	uint64_t addr = jt.getAddress();
 	std::size_t nops = 0;
 	bool first = true;
-	while (cs_disasm_iter(ce, &bytes.first, &bytes.second, &addr, _dryCsInsn))
+	while (disassembleDryRun(bytes, addr, mode))
 	{
 		decodedSz += _dryCsInsn->size;
 
@@ -133,14 +139,12 @@ std::size_t Decoder::decodeJumpTargetDryRun_arm(
 		else if (jt.getType() == JumpTarget::eType::LEFTOVER
 				&& nops > 0)
 		{
-			if (mode != basicMode) _c2l->modifyBasicMode(basicMode);
 			return nops;
 		}
 
 		if (_c2l->isControlFlowInstruction(*_dryCsInsn)
 				|| insnWrittesPc(ce, _dryCsInsn))
 		{
-			if (mode != basicMode) _c2l->modifyBasicMode(basicMode);
 			return false;
 		}
 
@@ -149,7 +153,6 @@ std::size_t Decoder::decodeJumpTargetDryRun_arm(
 
 	if (nops > 0)
 	{
-		if (mode != basicMode) _c2l->modifyBasicMode(basicMode);
 		return nops;
 	}
 
@@ -157,11 +160,9 @@ std::size_t Decoder::decodeJumpTargetDryRun_arm(
 	//
 	if (getBasicBlockAtAddress(addr) && getFunctionAtAddress(addr) == nullptr)
 	{
-		if (mode != basicMode) _c2l->modifyBasicMode(basicMode);
 		return false;
 	}
 
-	if (mode != basicMode) _c2l->modifyBasicMode(basicMode);
 	return true;
 }
 
@@ -4,10 +4,15 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
+#include <chrono>
+
 #include <llvm/IR/Dominators.h>
 #include <llvm/IR/PatternMatch.h>
 
+#include "retdec/utils/cancellation.h"
 #include "retdec/utils/conversion.h"
+#include "retdec/utils/instrumentation.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/io/log.h"
 #include "retdec/bin2llvmir/optimizations/decoder/decoder.h"
@@ -32,6 +37,16 @@ static llvm::RegisterPass<Decoder> X(
 		false // Analysis Pass
 );
 
+namespace {
+
+/// Maximal level of symbolic trees used to recognize switch table bounds
+/// and indexes.
+const unsigned SWITCH_TREE_MAX_LEVEL = 10;
+/// Maximal number of items read from a switch table whose size is unknown.
+const std::size_t SWITCH_TABLE_MAX_SIZE = 1 << 16;
+
+} // anonymous namespace
+
 Decoder::Decoder() :
 		ModulePass(ID)
 {
@@ -40,10 +55,20 @@ Decoder::Decoder() :
 
 Decoder::~Decoder()
 {
-	if (_dryCsInsn)
-	{
-		cs_free(_dryCsInsn, 1);
-	}
+
+}
+
+/**
+ * @return Statistics of jump targets processed by the last run.
+ */
+const JumpTargets::Statistics& Decoder::getJumpTargetStatistics() const
+{
+	return _jumpTargets.getStatistics();
+}
+
+const Decoder::Statistics& Decoder::getStatistics() const
+{
+	return _stats;
 }
 
 bool Decoder::runOnModule(llvm::Module& m)
@@ -104,15 +129,18 @@ bool Decoder::run()
 	}
 
 	initTranslator();
-	initDryRunCsInstruction();
+	initDisassemblyCache();
+	initModeMap();
 	initEnvironment();
 	initRanges();
 	initJumpTargets();
+	initSpeculativeDisassembler();
 
 	LOG << _ranges << std::endl;
 	LOG << _jumpTargets << std::endl;
 
 	decode();
+	_c2l->clearTranslationCache();
 
 	if (debug_enabled && fs::exists(_config->getOutputDirectory()))
 	{
@@ -148,8 +176,44 @@ void Decoder::decode()
 	JumpTarget jt;
 	while (getJumpTarget(jt))
 	{
+		utils::throwIfCancellationRequested();
+
 		LOG << "\t" << "processing : " << jt << std::endl;
+		speculate();
+
+		auto start = std::chrono::steady_clock::now();
 		decodeJumpTarget(jt);
+		auto& jtType = _stats.jumpTargetTypes[jt.getType()];
+		++jtType.decoded;
+		jtType.time += std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - start).count();
+	}
+	_speculative.reset();
+
+	auto& jtStats = _jumpTargets.getStatistics();
+	LOG << "\n" << "jump targets: pushed = " << jtStats.pushed
+			<< ", duplicates = " << jtStats.duplicates
+			<< ", rejected = " << jtStats.rejected
+			<< ", popped = " << jtStats.popped << std::endl;
+	LOG << "decoded: instructions = " << _stats.decodedInstructions
+			<< ", bytes = " << _stats.decodedBytes
+			<< ", skipped bytes = " << _stats.skippedBytes
+			<< ", dry runs = " << _stats.dryRuns
+			<< ", dry run rejections = " << _stats.dryRunRejections
+			<< ", delay slot fixups = " << _stats.delaySlotFixups
+			<< ", function splits = " << _stats.functionSplits << std::endl;
+	for (auto& p : _stats.jumpTargetTypes)
+	{
+		LOG << "\t" << JumpTarget::typeToString(p.first) << ": decoded = "
+				<< p.second.decoded << ", time [us] = " << p.second.time
+				<< std::endl;
+	}
+
+	if (!_ranges.primaryEmpty() && utils::isPhaseBudgetExpired())
+	{
+		Log::error() << Log::Warning << "decoding phase ran out of "
+				<< (utils::isMemoryLimitExceeded() ? "memory" : "time")
+				<< ", leftover ranges were not decoded" << std::endl;
 	}
 
 	if (!_somethingDecoded)
@@ -160,13 +224,37 @@ void Decoder::decode()
 
 bool Decoder::getJumpTarget(JumpTarget& jt)
 {
-	if (!_jumpTargets.empty())
+	while (!_jumpTargets.empty())
 	{
 		jt = _jumpTargets.top();
 		_jumpTargets.pop();
+
+		if (!isSelectedClosureDecoding())
+		{
+			return true;
+		}
+		else if (!isAllowedInSelectedClosure(jt))
+		{
+			LOG << "\t" << "not in selected closure -> skip : " << jt
+					<< std::endl;
+			continue;
+		}
+
+		if (jt.getType() == JumpTarget::eType::SELECTED_RANGE_START)
+		{
+			if (auto* f = getFunctionAtAddress(jt.getAddress()))
+			{
+				_selectedClosureDepths[f] = 0;
+			}
+		}
 		return true;
 	}
-	else if (!_ranges.primaryEmpty())
+
+	// Decoding of leftover ranges is skipped once the phase budget is spent:
+	// code reachable from the already decoded code is decoded anyway.
+	if (!_ranges.primaryEmpty()
+			&& !isSelectedClosureDecoding()
+			&& !utils::isPhaseBudgetExpired())
 	{
 		jt = JumpTarget(
 				_ranges.primaryFront().getStart(),
@@ -178,8 +266,64 @@ bool Decoder::getJumpTarget(JumpTarget& jt)
 	return false;
 }
 
+/**
+ * @return @c True if only the call graph closure of the selected functions
+ * is decoded, @c false otherwise.
+ */
+bool Decoder::isSelectedClosureDecoding() const
+{
+	auto& params = _config->getConfig().parameters;
+	return params.isSelectedDecodeOnly()
+			&& params.getSelectedDecodeDepth() > 0;
+}
+
+/**
+ * In the selected closure decoding, only the selected functions, code
+ * reachable from them, and import stubs are decoded. Jump targets from
+ * other sources (symbols, exports, ...) would pull in the entire binary.
+ */
+bool Decoder::isAllowedInSelectedClosure(const JumpTarget& jt) const
+{
+	return jt.getType() <= JumpTarget::eType::CONTROL_FLOW_RETURN_TARGET
+			|| jt.getType() == JumpTarget::eType::SELECTED_RANGE_START
+			|| jt.getType() == JumpTarget::eType::IMPORT;
+}
+
+/**
+ * Records that @a caller calls @a callee in the selected closure decoding.
+ * @return @c True if @a callee should be decoded, @c false if it is too deep
+ * in the call graph and it is left as an undecoded stub.
+ */
+bool Decoder::enterSelectedClosureCall(
+		llvm::Function* caller,
+		llvm::Function* callee)
+{
+	auto maxDepth = _config->getConfig().parameters.getSelectedDecodeDepth();
+
+	auto cIt = _selectedClosureDepths.find(caller);
+	if (cIt == _selectedClosureDepths.end() || cIt->second >= maxDepth)
+	{
+		return false;
+	}
+
+	auto depth = cIt->second + 1;
+	auto it = _selectedClosureDepths.find(callee);
+	if (it == _selectedClosureDepths.end())
+	{
+		_selectedClosureDepths.emplace(callee, depth);
+	}
+	else if (depth < it->second)
+	{
+		it->second = depth;
+	}
+	return true;
+}
+
 void Decoder::decodeJumpTarget(const JumpTarget& jt)
 {
+	RETDEC_SCOPED_TIMER_VAR(timer, "decoder.decodeJumpTarget");
+	RETDEC_TIMER_ARG(timer, "address", jt.getAddress().toHexPrefixString());
+
 	const Address start = jt.getAddress();
 	if (start.isUndefined())
 	{
@@ -244,12 +388,15 @@ void Decoder::decodeJumpTarget(const JumpTarget& jt)
 	if (jt.getType() == JumpTarget::eType::LEFTOVER
 			|| useAlt)
 	{
+		++_stats.dryRuns;
 		if (auto skipSz = decodeJumpTargetDryRun(jt, bytes, useStrict))
 		{
 			AddressRange sr(start, start+skipSz);
 			LOG << "\t\t" << "dry run failed -> skip range = " << sr
 					<< std::endl;
 			_ranges.remove(sr);
+			++_stats.dryRunRejections;
+			_stats.skippedBytes += skipSz;
 			return;
 		}
 	}
@@ -294,6 +441,17 @@ void Decoder::decodeJumpTarget(const JumpTarget& jt)
 				<< std::endl;
 	}
 
+	if (_speculative)
+	{
+		if (auto batch = _speculative->acquire(start, jt.getMode()))
+		{
+			for (auto& insn : batch->insns)
+			{
+				_disasmCache->insert(batch->mode, insn);
+			}
+		}
+	}
+
 	Address addr = start;
 	bool bbEnd = false;
 	do
@@ -337,6 +495,11 @@ void Decoder::decodeJumpTarget(const JumpTarget& jt)
 	while (!bbEnd);
 
 	auto end = addr > start ? addr : Address(start+1);
+	if (addr > start
+			&& _config->getConfig().architecture.isArm32OrThumb())
+	{
+		_modes.set(AddressRange(start, addr), jt.getMode());
+	}
 	_ranges.remove(start, end);
 	LOG << "\t\tdecoded range = " << AddressRange(start, end) << std::endl;
 }
@@ -344,27 +507,157 @@ void Decoder::decodeJumpTarget(const JumpTarget& jt)
 capstone2llvmir::Capstone2LlvmIrTranslator::TranslationResultOne
 Decoder::translate(ByteData& bytes, common::Address& addr, llvm::IRBuilder<>& irb)
 {
-	auto res = _c2l->translateOne(bytes.first, bytes.second, addr, irb);
+	capstone2llvmir::Capstone2LlvmIrTranslator::TranslationResultOne res;
+
+	auto* cached = disassemble(bytes, addr, _c2l->getBasicMode());
 
 	// MIPS 64-bit mode can decompile more instructions than the 32-bit mode.
 	// When 32-bit mode is used, some 32-bit instructions that IDA handles fail
 	// to disassemble.
 	// But we cannot always use 64-bit mode, because some other (FPU)
 	// instructions are disassembled differently. Try to swtich modes only if
-	// translations fails.
+	// translations fails. The translator is switched only if the 64-bit
+	// disassembly succeeds.
 	//
-	if (_config->getConfig().architecture.isMipsOrPic32()
-			&& (_c2l->getBasicMode() & CS_MODE_MIPS32)
-			&& res.failed())
+	bool mips64 = false;
+	if (cached == nullptr
+			&& _config->getConfig().architecture.isMipsOrPic32()
+			&& (_c2l->getBasicMode() & CS_MODE_MIPS32))
+	{
+		cached = disassemble(bytes, addr, CS_MODE_MIPS64);
+		if (cached)
+		{
+			_c2l->modifyBasicMode(CS_MODE_MIPS64);
+			mips64 = true;
+		}
+	}
+
+	if (cached)
+	{
+		// Translated instructions are kept by the module, the cached one
+		// stays in the cache.
+		auto* pool = _c2l->getInstructionPool();
+		cs_insn* insn = pool
+				? pool->allocate()
+				: cs_malloc(_c2l->getCapstoneEngine());
+		_disasmCache->copy(
+				*cached,
+				insn,
+				pool ? pool->getDetailSize() : sizeof(cs_detail));
+
+		res = _c2l->translateDisassembled(insn, irb);
+		bytes.first += res.size;
+		bytes.second -= res.size;
+		addr += res.size;
+
+		++_stats.decodedInstructions;
+		_stats.decodedBytes += res.size;
+	}
+
+	if (mips64)
 	{
-		_c2l->modifyBasicMode(CS_MODE_MIPS64);
-		res = _c2l->translateOne(bytes.first, bytes.second, addr, irb);
 		_c2l->modifyBasicMode(CS_MODE_MIPS32);
 	}
 
 	return res;
 }
 
+/**
+ * Disassemble instruction at @a addr in basic @a mode through
+ * @c _disasmCache. The translator's mode is not changed.
+ * @return Cached instruction that fits into @a bytes, or @c nullptr if there
+ *         is no such instruction.
+ */
+cs_insn* Decoder::disassemble(
+		const ByteData& bytes,
+		common::Address addr,
+		cs_mode mode)
+{
+	cs_insn* insn = nullptr;
+	if (!_disasmCache->lookup(mode, addr, insn))
+	{
+		// Sweep over the whole segment, not only the given bytes, so that
+		// the cached result does not depend on the caller's range.
+		ByteData segBytes = _image->getImage()->getRawSegmentData(addr);
+		insn = _disasmCache->sweep(
+				mode,
+				addr,
+				segBytes.first,
+				segBytes.second);
+	}
+
+	return insn && insn->size <= bytes.second ? insn : nullptr;
+}
+
+/**
+ * Dry run counterpart of @c cs_disasm_iter() - set @c _dryCsInsn to the
+ * instruction at @a addr disassembled in basic @a mode, and move @a bytes and
+ * @a addr after it.
+ * @return @c True if the instruction was disassembled.
+ */
+bool Decoder::disassembleDryRun(ByteData& bytes, uint64_t& addr, cs_mode mode)
+{
+	_dryCsInsn = disassemble(bytes, addr, mode);
+	if (_dryCsInsn == nullptr)
+	{
+		return false;
+	}
+
+	bytes.first += _dryCsInsn->size;
+	bytes.second -= _dryCsInsn->size;
+	addr += _dryCsInsn->size;
+	return true;
+}
+
+/**
+ * Pass jump targets that are going to be decoded soon to the speculative
+ * disassembler. Jump targets are taken in the heap order, so they are the top
+ * ones only approximately.
+ */
+void Decoder::speculate()
+{
+	if (_speculative == nullptr)
+	{
+		return;
+	}
+
+	std::size_t n = 0;
+	for (auto* jt : _jumpTargets)
+	{
+		if (n++ == _speculationWindow)
+		{
+			break;
+		}
+
+		Address start = jt->getAddress();
+		if (start.isUndefined()
+				|| !_speculated.emplace(start, jt->getMode()).second)
+		{
+			continue;
+		}
+
+		auto* range = _ranges.get(start);
+		ByteData bytes = _image->getImage()->getRawSegmentData(start);
+		if (range == nullptr || bytes.first == nullptr)
+		{
+			continue;
+		}
+
+		// Jump targets with known sizes (e.g. functions from symbols or
+		// unwind information) are disassembled only up to their ends.
+		std::size_t size = range->getEnd() - start;
+		if (jt->hasSize())
+		{
+			size = std::min<std::size_t>(size, jt->getSize().value());
+		}
+		_speculative->request(
+				start,
+				jt->getMode(),
+				bytes.first,
+				std::min<std::size_t>(size, bytes.second));
+	}
+}
+
 /**
  * Check if the given jump targets and bytes can/should be decoded.
  * \return The number of bytes to skip from decoding. If zero, then dry run was
@@ -550,12 +843,24 @@ bool Decoder::getJumpTargetsFromInstruction(
 				return false;
 			}
 
-			_jumpTargets.push(
-					t,
-					JumpTarget::eType::CONTROL_FLOW_CALL_TARGET,
-					determineMode(tr.capstoneInsn, t),
-					addr);
-			LOG << "\t\t" << "call @ " << addr << " -> " << t << std::endl;
+			// Functions too deep in the call graph of the selected functions
+			// are not decoded, they stay as stubs.
+			if (tFnc
+					&& isSelectedClosureDecoding()
+					&& !enterSelectedClosureCall(pCall->getFunction(), tFnc))
+			{
+				LOG << "\t\t" << "call @ " << addr << " -> " << t
+						<< " (out of selected closure)" << std::endl;
+			}
+			else
+			{
+				_jumpTargets.push(
+						t,
+						JumpTarget::eType::CONTROL_FLOW_CALL_TARGET,
+						determineMode(tr.capstoneInsn, t),
+						addr);
+				LOG << "\t\t" << "call @ " << addr << " -> " << t << std::endl;
+			}
 
 			// The created function might be in range that we are currently
 			// decoding -> if so, trim range size.
@@ -1122,7 +1427,9 @@ bool Decoder::getJumpTargetSwitch(
 	unsigned tableSize = 0;
 if (brToSwitch)
 {
-	auto stCond = SymbolicTree::OnDemandRda(brToSwitch->getCondition());
+	auto stCond = SymbolicTree::OnDemandRda(
+			brToSwitch->getCondition(),
+			SWITCH_TREE_MAX_LEVEL);
 	stCond.simplifyNode();
 
 	auto levelOrd = stCond.getLevelOrder();
@@ -1140,35 +1447,28 @@ if (brToSwitch)
 		//						>|   %312 = trunc i32 %311 to i8
 		//						>| i8 90
 		//				>| i8 0
-		if (match(*n, m_c_Or(
-				m_c_ICmp(llvm::ICmpInst::ICMP_ULT, m_Value(), m_ConstantInt(ci)),
-				m_c_ICmp(llvm::ICmpInst::ICMP_EQ, m_Value(), m_Zero()))))
-		{
-			tableSize = ci->getZExtValue() + 1;
-			LOG << "\t\t\t" << "table size (1) = " << tableSize << std::endl;
-			break;
-		}
-		// TODO: apply this only if it si branching over?
+		// TODO: apply (2) and (3) only if it si branching over?
 		// mips (???):
 		//>|   %319 = icmp ne i32 %318, 0
 		//		>|   %316 = icmp ult i32 %315, 121
 		//				>|   %314 = and i32 %313, 255
 		//				>| i32 121
 		//		>| i32 0
-		else if (match(*n, m_c_ICmp(llvm::ICmpInst::ICMP_NE,
-				m_c_ICmp(llvm::ICmpInst::ICMP_ULT, m_Value(), m_not_Zero(ci)),
-				m_Zero())))
+		int p = match_first(*n,
+				m_c_Or(
+						m_c_ICmp(llvm::ICmpInst::ICMP_ULT, m_Value(), m_ConstantInt(ci)),
+						m_c_ICmp(llvm::ICmpInst::ICMP_EQ, m_Value(), m_Zero())),
+				m_c_ICmp(llvm::ICmpInst::ICMP_NE,
+						m_c_ICmp(llvm::ICmpInst::ICMP_ULT, m_Value(), m_not_Zero(ci)),
+						m_Zero()),
+				m_c_ICmp(llvm::ICmpInst::ICMP_EQ,
+						m_c_ICmp(llvm::ICmpInst::ICMP_ULT, m_Value(), m_not_Zero(ci)),
+						m_Zero()));
+		if (p >= 0)
 		{
-			tableSize = ci->getZExtValue();
-			LOG << "\t\t\t" << "table size (2) = " << tableSize << std::endl;
-			break;
-		}
-		else if (match(*n, m_c_ICmp(llvm::ICmpInst::ICMP_EQ,
-				m_c_ICmp(llvm::ICmpInst::ICMP_ULT, m_Value(), m_not_Zero(ci)),
-				m_Zero())))
-		{
-			tableSize = ci->getZExtValue();
-			LOG << "\t\t\t" << "table size (3) = " << tableSize << std::endl;
+			tableSize = ci->getZExtValue() + (p == 0);
+			LOG << "\t\t\t" << "table size (" << p + 1 << ") = "
+					<< tableSize << std::endl;
 			break;
 		}
 	}
@@ -1179,7 +1479,7 @@ if (brToSwitch)
 	//
 	std::vector<unsigned> idxs;
 	unsigned maxIdx = 0;
-	auto idxRoot = SymbolicTree::OnDemandRda(idx);
+	auto idxRoot = SymbolicTree::OnDemandRda(idx, SWITCH_TREE_MAX_LEVEL);
 	idxRoot.simplifyNode();
 
 	llvm::LoadInst* l = nullptr;
@@ -1202,70 +1502,29 @@ if (brToSwitch)
 		// We have to use the original index.
 		idx = insn;
 
-		while (true)
+		idxs = getSwitchIndexTable(tableAddr2, it, tableSize);
+		for (unsigned i : idxs)
 		{
-			auto* ci = _image->getConstantInt(it, tableAddr2);
-			if (ci == nullptr)
-			{
-				break;
-			}
-			// A safer condition to end this would be to track constant
-			// (second table size) used in comparison in instruction
-			// before the cond jmp instruction.
-			unsigned idx = ci->getZExtValue();
-			if (tableSize > 0 && idxs.size() == tableSize)
-			{
-				break;
-			}
-
-			LOG << "\t\t\t\t" << idx << std::endl;
-
-			maxIdx = idx > maxIdx ? idx : maxIdx;
-			idxs.push_back(idx);
-			tableAddr2 += _abi->getTypeByteSize(ci->getType());
+			LOG << "\t\t\t\t" << i << std::endl;
+			maxIdx = i > maxIdx ? i : maxIdx;
 		}
 	}
 
 	// Get targets from jump table.
 	//
 	LOG << "\t\t\t" << "table labels:" << std::endl;
-	std::vector<Address> cases;
-	Address tableItemAddr = tableAddr;
 	Address nextTableAddr;
 	auto swTblIt = _switchTableStarts.upper_bound(tableAddr);
 	if (swTblIt != _switchTableStarts.end())
 	{
 		nextTableAddr = swTblIt->first;
 	}
-	while (true)
+	auto& table = getSwitchTable(tableAddr, tableSize, maxIdx, nextTableAddr);
+	std::vector<Address> cases = table.cases;
+	for (std::size_t i = 0; i < cases.size(); ++i)
 	{
-		auto* ci = _image->getImage()->isPointer(tableItemAddr)
-				? _image->getConstantDefault(tableItemAddr)
-				: nullptr;
-		if (ci == nullptr)
-		{
-			break;
-		}
-
-		Address item = ci->getZExtValue();
-		LOG << "\t\t\t\t" << item << " @ " << tableItemAddr << std::endl;
-
-		tableItemAddr += archByteSz;
-		cases.push_back(item);
-
-		if (tableSize > 0 && cases.size() == tableSize)
-		{
-			break;
-		}
-		// idx from zero, there can be one more item than max idx number.
-		if (maxIdx > 0 && cases.size() > maxIdx)
-		{
-			break;
-		}
-		if (nextTableAddr.isUndefined() && tableItemAddr >= nextTableAddr)
-		{
-			break;
-		}
+		LOG << "\t\t\t\t" << cases[i] << " @ "
+				<< Address(tableAddr + i * archByteSz) << std::endl;
 	}
 	if (cases.empty())
 	{
@@ -1273,7 +1532,7 @@ if (brToSwitch)
 				<< std::endl;
 		return false;
 	}
-	Address tableAddrEnd = tableItemAddr;
+	Address tableAddrEnd = table.end;
 
 	// Put together two tables.
 	//
@@ -1364,6 +1623,102 @@ if (brToSwitch)
 	return true;
 }
 
+/**
+ * Read switch table items (case targets) from @a tableAddr. Reading stops
+ * on the first item which is not a pointer, or when the table bound given
+ * by @a tableSize, @a maxIdx, or @a nextTableAddr is reached.
+ * The same table is often analysed several times (e.g. from duplicated
+ * blocks), items are therefore read only once and memoized.
+ */
+const Decoder::SwitchTable& Decoder::getSwitchTable(
+		common::Address tableAddr,
+		unsigned tableSize,
+		unsigned maxIdx,
+		common::Address nextTableAddr)
+{
+	auto key = std::make_tuple(tableAddr, tableSize, maxIdx, nextTableAddr);
+	auto fIt = _switchTables.find(key);
+	if (fIt != _switchTables.end())
+	{
+		LOG << "\t\t\t" << "memoized table @ " << tableAddr << std::endl;
+		return fIt->second;
+	}
+
+	unsigned archByteSz =  _config->getConfig().architecture.getByteSize();
+
+	SwitchTable& table = _switchTables[key];
+	Address tableItemAddr = tableAddr;
+	while (table.cases.size() < SWITCH_TABLE_MAX_SIZE)
+	{
+		auto* ci = _image->getImage()->isPointer(tableItemAddr)
+				? _image->getConstantDefault(tableItemAddr)
+				: nullptr;
+		if (ci == nullptr)
+		{
+			break;
+		}
+
+		tableItemAddr += archByteSz;
+		table.cases.push_back(ci->getZExtValue());
+
+		if (tableSize > 0 && table.cases.size() == tableSize)
+		{
+			break;
+		}
+		// idx from zero, there can be one more item than max idx number.
+		if (maxIdx > 0 && table.cases.size() > maxIdx)
+		{
+			break;
+		}
+		if (nextTableAddr.isUndefined() && tableItemAddr >= nextTableAddr)
+		{
+			break;
+		}
+	}
+	table.end = tableItemAddr;
+
+	return table;
+}
+
+/**
+ * Read up to @a tableSize (unbounded if zero) switch index table items of
+ * type @a type from @a tableAddr. Items are memoized.
+ */
+const std::vector<unsigned>& Decoder::getSwitchIndexTable(
+		common::Address tableAddr,
+		llvm::IntegerType* type,
+		unsigned tableSize)
+{
+	auto key = std::make_tuple(tableAddr, type->getBitWidth(), tableSize);
+	auto fIt = _switchIndexTables.find(key);
+	if (fIt != _switchIndexTables.end())
+	{
+		return fIt->second;
+	}
+
+	auto& idxs = _switchIndexTables[key];
+	while (idxs.size() < SWITCH_TABLE_MAX_SIZE)
+	{
+		auto* ci = _image->getConstantInt(type, tableAddr);
+		if (ci == nullptr)
+		{
+			break;
+		}
+		// A safer condition to end this would be to track constant
+		// (second table size) used in comparison in instruction
+		// before the cond jmp instruction.
+		if (tableSize > 0 && idxs.size() == tableSize)
+		{
+			break;
+		}
+
+		idxs.push_back(ci->getZExtValue());
+		tableAddr += _abi->getTypeByteSize(ci->getType());
+	}
+
+	return idxs;
+}
+
 /**
  * ; ASM branch insn
  * ; ASM delay slot insn
@@ -1404,6 +1759,7 @@ void Decoder::handleDelaySlotTypical(
 		}
 		_llvm2capstone->emplace(r.llvmInsn, r.capstoneInsn);
 	}
+	++_stats.delaySlotFixups;
 
 	irb.SetInsertPoint(oldIp);
 }
@@ -1461,6 +1817,7 @@ void Decoder::handleDelaySlotLikely(
 			}
 			_llvm2capstone->emplace(res.llvmInsn, res.capstoneInsn);
 		}
+		++_stats.delaySlotFixups;
 
 		_likelyBb2Target.emplace(newBb, target);
 	}
@@ -1523,6 +1880,11 @@ void Decoder::resolvePseudoCalls()
 				auto* st = llvm::cast<llvm::StoreInst>(*real->user_begin());
 				st->eraseFromParent();
 				real->eraseFromParent();
+				++_stats.pseudoCallsRemoved;
+			}
+			else
+			{
+				++_stats.pseudoCallsResolved;
 			}
 		}
 	}
@@ -18,6 +18,64 @@ using namespace retdec::utils;
 namespace retdec {
 namespace bin2llvmir {
 
+namespace {
+
+/// Depth (in references) of statically linked functions around the entry
+/// point whose bodies are decoded even if static code bodies are skipped.
+const std::size_t STATIC_CODE_ENTRY_POINT_DEPTH = 2;
+
+/**
+ * Main detection searches for the call of main in the start-up code, which
+ * is usually statically linked. Get addresses of the confirmed static
+ * functions within @c STATIC_CODE_ENTRY_POINT_DEPTH references from the one
+ * containing the entry point @a ep.
+ */
+std::set<Address> getStaticCodeAroundEntryPoint(
+		const stacofin::DetectedFunctionsPtrMap& detections,
+		Address ep)
+{
+	std::set<Address> ret;
+	if (ep.isUndefined())
+	{
+		return ret;
+	}
+
+	std::vector<const stacofin::DetectedFunction*> level;
+	for (auto& p : detections)
+	{
+		if (p.first <= ep && ep < p.first + p.second->size)
+		{
+			level.push_back(p.second);
+			ret.insert(p.first);
+		}
+	}
+
+	for (std::size_t d = 0; d < STATIC_CODE_ENTRY_POINT_DEPTH; ++d)
+	{
+		std::vector<const stacofin::DetectedFunction*> next;
+		for (auto* sf : level)
+		{
+			for (auto& r : sf->references)
+			{
+				if (r.targetFnc == nullptr)
+				{
+					continue;
+				}
+				auto a = r.targetFnc->getAddress();
+				if (detections.count(a) && ret.insert(a).second)
+				{
+					next.push_back(r.targetFnc);
+				}
+			}
+		}
+		level = std::move(next);
+	}
+
+	return ret;
+}
+
+} // anonymous namespace
+
 /**
  * Initialize capstone2llvmir translator according to the architecture of
  * file to decompile.
@@ -84,15 +142,100 @@ void Decoder::initTranslator()
 			_module,
 			basicMode,
 			extraMode);
+	_c2l->setInstructionPool(
+			&AsmInstruction::getCapstoneInsnPool(_module, arch));
+	_c2l->setUseTranslationCache(
+			_config->getConfig().parameters.isTranslationCache());
+	_c2l->setLazyFlags(
+			_config->getConfig().parameters.isLazyFlags());
+}
+
+/**
+ * Initialize speculative disassembly, if it is enabled.
+ */
+void Decoder::initSpeculativeDisassembler()
+{
+	auto threads = _config->getConfig().parameters.getDecoderThreads();
+	if (threads == 0)
+	{
+		return;
+	}
+
+	_speculative = std::make_unique<SpeculativeDisassembler>(
+			_c2l->getArchitecture(),
+			_c2l->getExtraMode(),
+			threads);
+	_speculationWindow = 4 * threads;
 }
 
 /**
- * Initialize instruction used in dry run disassembly.
+ * Initialize cache of instructions shared by dry runs and translation.
  */
-void Decoder::initDryRunCsInstruction()
+void Decoder::initDisassemblyCache()
 {
-	csh ce = _c2l->getCapstoneEngine();
-	_dryCsInsn = cs_malloc(ce);
+	_disasmCache = std::make_unique<DisassemblyCache>(
+			_c2l->getArchitecture(),
+			_c2l->getExtraMode());
+}
+
+/**
+ * Seed the ARM/Thumb modes of addresses from symbols. Sized Thumb function
+ * symbols set modes of their ranges, ELF mapping symbols (@c $a, @c $t,
+ * @c $d and their @c .<suffix> variants) set modes up to the next mapping
+ * symbol, so they win over function symbols.
+ */
+void Decoder::initModeMap()
+{
+	if (!_config->getConfig().architecture.isArm32OrThumb())
+	{
+		return;
+	}
+
+	std::vector<std::pair<Address, std::optional<cs_mode>>> mapping;
+	for (const auto* t : _image->getFileFormat()->getSymbolTables())
+	for (const auto& s : *t)
+	{
+		unsigned long long a = 0;
+		if (!s->getRealAddress(a))
+		{
+			continue;
+		}
+
+		const auto& name = s->getName();
+		if (name.size() >= 2
+				&& name[0] == '$'
+				&& (name.size() == 2 || name[2] == '.'))
+		{
+			if (name[1] == 'a')
+			{
+				mapping.emplace_back(a, CS_MODE_ARM);
+			}
+			else if (name[1] == 't')
+			{
+				mapping.emplace_back(a, CS_MODE_THUMB);
+			}
+			else if (name[1] == 'd')
+			{
+				mapping.emplace_back(a, std::nullopt);
+			}
+			continue;
+		}
+
+		unsigned long long sz = 0;
+		if (s->isFunction() && s->getSize(sz) && sz > 0)
+		{
+			_modes.set(
+					AddressRange(a, a + sz),
+					s->isThumbSymbol() ? CS_MODE_THUMB : CS_MODE_ARM);
+		}
+	}
+
+	for (auto& m : mapping)
+	{
+		_modes.set(m.first, m.second);
+	}
+
+	LOG << "\n" << "initModeMap(): " << _modes.size() << " modes" << std::endl;
 }
 
 /**
@@ -193,13 +336,21 @@ void Decoder::initRanges()
 	a = arch.isPpc() ? 4 : a;
 	_ranges.setArchitectureInstructionAlignment(a);
 
-	if (_config->getConfig().parameters.isSelectedDecodeOnly())
+	if (isSelectedClosureDecoding())
+	{
+		// Functions called from the selected ones may be anywhere, what
+		// gets decoded is limited by jump targets.
+		initAllowedRangesWithSegments();
+		initAllowedRangesWithConfig();
+	}
+	else if (_config->getConfig().parameters.isSelectedDecodeOnly())
 	{
 		initAllowedRangesWithConfig();
 	}
 	else
 	{
 		initAllowedRangesWithSegments();
+		_ranges.demoteDataSequences(_image);
 	}
 
 	_ranges.removeZeroSequences(_image);
@@ -552,6 +703,7 @@ void Decoder::initJumpTargets()
 	initJumpTargetsImports();
 	initJumpTargetsDebug();
 	initJumpTargetsSymbols(); // MUST be before exports
+	initJumpTargetsUnwind();
 	initJumpTargetsExports();
 	initVtables();
 }
@@ -883,6 +1035,50 @@ void Decoder::initJumpTargetsSymbols()
 	}
 }
 
+/**
+ * Functions with exact ranges from unwind information (PE .pdata, ELF and
+ * Mach-O .eh_frame). Their known sizes bound both the decoding and the
+ * speculative disassembly of the functions.
+ */
+void Decoder::initJumpTargetsUnwind()
+{
+	LOG << "\n" << "initJumpTargetsUnwind():" << std::endl;
+
+	for (const auto& r : _image->getFileFormat()->getUnwindFunctionRanges())
+	{
+		common::Address addr = r.getStart();
+		std::optional<std::size_t> sz = r.getSize();
+
+		// Linkers emit FDEs also for whole PLT sections, whose stubs are
+		// handled as imports.
+		auto* sec = _image->getFileFormat()->getSectionFromAddress(addr);
+		if (sec && startsWith(sec->getName(), ".plt"))
+		{
+			LOG << "\t" << "[-] " << addr << " (in " << sec->getName()
+					<< ")" << std::endl;
+			continue;
+		}
+
+		if (auto* jt = _jumpTargets.push(
+				addr,
+				JumpTarget::eType::UNWIND,
+				_c2l->getBasicMode(),
+				Address::Undefined,
+				sz))
+		{
+			auto* nf = createFunction(jt->getAddress());
+			addFunctionSize(nf, sz);
+
+			LOG << "\t" << "[+] " << addr << " @ " << nf->getName().str()
+					<< " (size = " << r.getSize() << ")" << std::endl;
+		}
+		else
+		{
+			LOG << "\t" << "[-] " << addr << " (no JT)" << std::endl;
+		}
+	}
+}
+
 void Decoder::initJumpTargetsDebug()
 {
 	LOG << "\n" << "initJumpTargetsDebug():" << std::endl;
@@ -934,8 +1130,27 @@ void Decoder::initStaticCode()
 {
 	LOG << "\n" << "initStaticCode():" << std::endl;
 
-	stacofin::Finder SCA;
-	SCA.searchAndConfirm(*_image->getImage(), _config->getConfig());
+	// Static code is usually searched for already by provider initialization.
+	stacofin::Finder localSCA;
+	const stacofin::Finder* sca = _image->getStaticCode();
+	if (sca == nullptr)
+	{
+		localSCA.searchAndConfirm(*_image->getImage(), _config->getConfig());
+		sca = &localSCA;
+	}
+	auto& SCA = *sca;
+
+	// Bodies of the skipped functions are not needed: all statically linked
+	// functions are only declared after main detection anyway, and their
+	// signatures come from the type information.
+	bool skipBodies = _config->getConfig().parameters.isSkipStaticCodeBodies();
+	std::set<Address> keepBodies;
+	if (skipBodies)
+	{
+		keepBodies = getStaticCodeAroundEntryPoint(
+				SCA.getConfirmedDetections(),
+				_config->getConfig().parameters.getEntryPoint());
+	}
 
 	for (auto& p : SCA.getConfirmedDetections())
 	{
@@ -957,6 +1172,26 @@ void Decoder::initStaticCode()
 			}
 		}
 
+		if (skipBodies
+				&& sf->getAddress().isDefined()
+				&& keepBodies.count(sf->getAddress()) == 0)
+		{
+			auto* nf = createFunction(sf->getAddress(), true);
+			_staticFncs.insert(sf->getAddress());
+			if (sf->isTerminating())
+			{
+				_terminatingFncs.insert(nf);
+			}
+			// The signature matched all the bytes, so they are not decoded
+			// as another function. Leftover decoding finds the callees.
+			addFunctionSize(nf, sf->size);
+			_ranges.remove(sf->getAddress(), sf->getAddress() + sf->size);
+
+			LOG << "\t" << "[+] " << sf->getAddress() << " @ "
+					<< nf->getName().str() << " (body skipped)" << std::endl;
+			continue;
+		}
+
 		if (auto* jt = _jumpTargets.push(
 				sf->getAddress(),
 				JumpTarget::eType::STATIC_CODE,
@@ -1041,6 +1276,11 @@ void Decoder::initConfigFunctions()
 
 		Address start = p.second;
 		Address end = getFunctionEndAddress(f);
+		auto szIt = _fnc2sz.find(f);
+		if (f->isDeclaration() && szIt != _fnc2sz.end())
+		{
+			end = start + szIt->second;
+		}
 		end = end > start ? end : Address(start + 1);
 
 		// TODO: this is really bad, should be solved by better design of config
@@ -4,6 +4,12 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
 #include "retdec/bin2llvmir/optimizations/decoder/decoder_ranges.h"
 
 using namespace retdec::common;
@@ -17,11 +23,207 @@ inline retdec::common::Address align(
 	return a && s % a ? retdec::common::Address(s + a - (s % a)) : s;
 }
 
+/// Size of the windows classified by @c isDataWindow().
+const std::size_t DATA_WINDOW_SIZE = 64;
+/// Minimal number of consecutive data windows which are demoted. An odd
+/// window of code which looks like data is never demoted on its own.
+const std::size_t DATA_MIN_WINDOWS = 4;
+/// Entropy (bits per byte) of compressed or encrypted data. A window of
+/// 64 bytes has at most 6 bits, windows of code seldom get over 5.3 bits,
+/// windows of compressed data seldom get under 5.5 bits.
+const double DATA_MIN_ENTROPY = 5.5;
+
+/**
+ * @return Entropy (bits per byte) of @a size bytes at @a data, where @a size
+ *         is at most @c DATA_WINDOW_SIZE. The counts of such a window fit
+ *         into bytes and only the counted bytes are visited, which is much
+ *         cheaper than a general entropy computation over 256 counters.
+ */
+double windowEntropy(const std::uint8_t* data, std::size_t size)
+{
+	// c * log2(c) for all the possible counts c.
+	static const auto cLog2c = []()
+	{
+		std::array<double, DATA_WINDOW_SIZE + 1> ret{};
+		for (std::size_t c = 1; c < ret.size(); ++c)
+		{
+			ret[c] = c * std::log2(c);
+		}
+		return ret;
+	}();
+
+	std::array<std::uint8_t, 256> counts{};
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		counts[data[i]]++;
+	}
+
+	// H = -sum((c/n) * log2(c/n)) = log2(n) - sum(c * log2(c)) / n
+	double sum = 0.0;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		auto& c = counts[data[i]];
+		sum += cLog2c[c];
+		c = 0;
+	}
+	return std::log2(size) - sum / size;
+}
+
+/**
+ * @return @c True if the window of @a size bytes at @a data looks like data
+ *         rather than code, i.e. it is text (e.g. a string pool) or it is
+ *         compressed.
+ */
+bool isDataWindow(const std::uint8_t* data, std::size_t size)
+{
+	std::size_t printable = 0;
+	std::size_t zeros = 0;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		auto b = data[i];
+		printable += (b >= 0x20 && b <= 0x7e) || b == '\t' || b == '\n' || b == '\r';
+		zeros += b == 0;
+	}
+	if (printable + zeros >= size - size / 16 && printable >= size * 5 / 8)
+	{
+		return true;
+	}
+
+	return windowEntropy(data, size) >= DATA_MIN_ENTROPY;
+}
+
 } // namespace anonymous
 
 namespace retdec {
 namespace bin2llvmir {
 
+//
+//==============================================================================
+// AddressRangeMap
+//==============================================================================
+//
+
+/**
+ * Insert range <@a s, @a e), merge it with all the ranges it overlaps or
+ * touches.
+ */
+void AddressRangeMap::insert(common::Address s, common::Address e)
+{
+	if (e < s)
+	{
+		return;
+	}
+
+	auto it = _ranges.upper_bound(s);
+	if (it != _ranges.begin() && std::prev(it)->second.getEnd() >= s)
+	{
+		--it;
+	}
+
+	Address newStart = s;
+	Address newEnd = e;
+	while (it != _ranges.end() && it->second.getStart() <= e)
+	{
+		newStart = std::min(newStart, it->second.getStart());
+		newEnd = std::max(newEnd, it->second.getEnd());
+		it = _ranges.erase(it);
+	}
+
+	_ranges.emplace_hint(it, newStart, AddressRange(newStart, newEnd));
+}
+
+/**
+ * Remove range <@a s, @a e), split the ranges it partially overlaps.
+ */
+void AddressRangeMap::remove(common::Address s, common::Address e)
+{
+	if (e <= s)
+	{
+		return;
+	}
+
+	auto it = _ranges.upper_bound(s);
+	if (it != _ranges.begin() && std::prev(it)->second.getEnd() > s)
+	{
+		--it;
+	}
+
+	while (it != _ranges.end() && it->second.getStart() < e)
+	{
+		AddressRange old = it->second;
+		it = _ranges.erase(it);
+
+		if (old.getStart() < s)
+		{
+			_ranges.emplace_hint(
+					it,
+					old.getStart(),
+					AddressRange(old.getStart(), s));
+		}
+		if (old.getEnd() > e)
+		{
+			_ranges.emplace_hint(it, e, AddressRange(e, old.getEnd()));
+			break;
+		}
+	}
+}
+
+/**
+ * @return Range containing address @a a, or @c nullptr if there is no such
+ *         range.
+ */
+const common::AddressRange* AddressRangeMap::getRange(common::Address a) const
+{
+	auto it = _ranges.upper_bound(a);
+	if (it == _ranges.begin())
+	{
+		return nullptr;
+	}
+
+	--it;
+	return it->second.contains(a) ? &it->second : nullptr;
+}
+
+bool AddressRangeMap::empty() const
+{
+	return _ranges.empty();
+}
+
+std::size_t AddressRangeMap::size() const
+{
+	return _ranges.size();
+}
+
+const common::AddressRange& AddressRangeMap::front() const
+{
+	return _ranges.begin()->second;
+}
+
+AddressRangeMap::const_iterator AddressRangeMap::begin() const
+{
+	return _ranges.begin();
+}
+
+AddressRangeMap::const_iterator AddressRangeMap::end() const
+{
+	return _ranges.end();
+}
+
+std::ostream& operator<<(std::ostream &os, const AddressRangeMap& rs)
+{
+	for (auto& p : rs)
+	{
+		os << p.second << "\n";
+	}
+	return os;
+}
+
+//
+//==============================================================================
+// RangesToDecode
+//==============================================================================
+//
+
 void RangesToDecode::addPrimary(common::Address s, common::Address e)
 {
 	s = align(s, archInsnAlign);
@@ -76,13 +278,14 @@ void RangesToDecode::removeZeroSequences(FileImage* image)
 
 void RangesToDecode::removeZeroSequences(
 		FileImage* image,
-		common::AddressRangeContainer& rs)
+		AddressRangeMap& rs)
 {
 	unsigned minSequence = 0x50; // TODO: Maybe should be smaller.
 	retdec::common::AddressRangeContainer toRemove;
 
-	for (auto& range : rs)
+	for (auto& p : rs)
 	{
+		auto& range = p.second;
 		Address start = range.getStart();
 		Address end = range.getEnd();
 		uint64_t size = range.getSize();
@@ -146,8 +349,73 @@ void RangesToDecode::removeZeroSequences(
 
 	for (auto& range : toRemove)
 	{
-		rs.remove(range);
+		rs.remove(range.getStart(), range.getEnd());
+	}
+}
+
+/**
+ * Demote likely data in the primary ranges (text, compressed data) to the
+ * alternative ranges. They are then not swept for code as leftovers, but
+ * they are still decoded when control flow gets there. The bytes are
+ * classified only once, before the decoding, so that tables and blobs in
+ * code sections do not go through disassembly and its dry runs repeatedly.
+ */
+void RangesToDecode::demoteDataSequences(FileImage* image)
+{
+	std::vector<AddressRange> primary;
+	for (auto& p : _primaryRanges)
+	{
+		primary.push_back(p.second);
+	}
+
+	for (auto& r : primary)
+	{
+		auto bytes = image->getImage()->getRawSegmentData(r.getStart());
+		if (bytes.first == nullptr)
+		{
+			continue;
+		}
+		demoteDataSequences(
+				r.getStart(),
+				bytes.first,
+				std::min<std::uint64_t>(bytes.second, r.getSize()));
+	}
+}
+
+/**
+ * Demote likely data in @a size bytes at @a data, which are the content of
+ * a primary range starting at @a start.
+ */
+void RangesToDecode::demoteDataSequences(
+		common::Address start,
+		const std::uint8_t* data,
+		std::size_t size)
+{
+	std::size_t runStart = 0;
+	std::size_t runWindows = 0;
+	auto demoteRun = [&](std::size_t runEnd)
+	{
+		if (runWindows >= DATA_MIN_WINDOWS)
+		{
+			_primaryRanges.remove(start + runStart, start + runEnd);
+			_alternativeRanges.insert(start + runStart, start + runEnd);
+		}
+		runWindows = 0;
+	};
+
+	std::size_t offset = 0;
+	for (; offset + DATA_WINDOW_SIZE <= size; offset += DATA_WINDOW_SIZE)
+	{
+		if (!isDataWindow(data + offset, DATA_WINDOW_SIZE))
+		{
+			demoteRun(offset);
+		}
+		else if (runWindows++ == 0)
+		{
+			runStart = offset;
+		}
 	}
+	demoteRun(offset);
 }
 
 bool RangesToDecode::isStrict() const
@@ -167,12 +435,12 @@ bool RangesToDecode::alternativeEmpty() const
 
 const common::AddressRange& RangesToDecode::primaryFront() const
 {
-	return *_primaryRanges.begin();
+	return _primaryRanges.front();
 }
 
 const common::AddressRange& RangesToDecode::alternativeFront() const
 {
-	return *_alternativeRanges.begin();
+	return _alternativeRanges.front();
 }
 
 const common::AddressRange* RangesToDecode::getPrimary(common::Address a) const
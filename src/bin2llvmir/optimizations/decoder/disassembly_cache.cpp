@@ -0,0 +1,206 @@
+/**
+* @file src/bin2llvmir/optimizations/decoder/disassembly_cache.cpp
+* @brief Cache of Capstone instructions disassembled by the decoder.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "retdec/bin2llvmir/optimizations/decoder/disassembly_cache.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+namespace {
+
+/// Maximal number of instructions disassembled by one sweep.
+const std::size_t SWEEP_MAX_INSNS = 64;
+
+} // anonymous namespace
+
+/**
+ * @param arch      Architecture of the cached instructions.
+ * @param extraMode Extra mode (endianness) of the decoder's translator.
+ */
+DisassemblyCache::DisassemblyCache(cs_arch arch, cs_mode extraMode) :
+		_arch(arch),
+		_extraMode(extraMode),
+		_pool(arch)
+{
+
+}
+
+DisassemblyCache::~DisassemblyCache()
+{
+	for (auto& p : _handles)
+	{
+		if (p.second)
+		{
+			cs_close(&p.second);
+		}
+	}
+}
+
+/**
+ * @return Handle disassembling in basic mode @a mode, opened on the first
+ *         use, or @c 0 if it can not be opened.
+ */
+csh DisassemblyCache::getHandle(cs_mode mode)
+{
+	auto it = _handles.find(mode);
+	if (it != _handles.end())
+	{
+		return it->second;
+	}
+
+	csh handle = 0;
+	if (cs_open(_arch, static_cast<cs_mode>(mode + _extraMode), &handle)
+			!= CS_ERR_OK)
+	{
+		handle = 0;
+	}
+	else if (cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON) != CS_ERR_OK)
+	{
+		cs_close(&handle);
+		handle = 0;
+	}
+	_handles.emplace(mode, handle);
+	return handle;
+}
+
+/**
+ * Find instruction at @a addr disassembled in basic mode @a mode.
+ * @param[out] insn Found instruction, @c nullptr if its disassembly failed.
+ * @return @c True if @a addr was already disassembled in @a mode.
+ */
+bool DisassemblyCache::lookup(
+		cs_mode mode,
+		std::uint64_t addr,
+		cs_insn*& insn) const
+{
+	auto mIt = _insns.find(mode);
+	if (mIt == _insns.end())
+	{
+		return false;
+	}
+
+	auto it = mIt->second.find(addr);
+	if (it == mIt->second.end())
+	{
+		return false;
+	}
+
+	insn = it->second;
+	return true;
+}
+
+/**
+ * Disassemble @a size @a bytes located at @a addr in basic mode @a mode. The
+ * sweep ends on the first failure, on an already cached address, or after
+ * a fixed number of instructions.
+ * @return Instruction at @a addr, or @c nullptr if it can not be disassembled.
+ */
+cs_insn* DisassemblyCache::sweep(
+		cs_mode mode,
+		std::uint64_t addr,
+		const std::uint8_t* bytes,
+		std::size_t size)
+{
+	cs_insn* first = nullptr;
+	if (lookup(mode, addr, first))
+	{
+		return first;
+	}
+
+	csh handle = getHandle(mode);
+	auto& insns = _insns[mode];
+	std::uint64_t a = addr;
+	for (std::size_t n = 0; n < SWEEP_MAX_INSNS; ++n)
+	{
+		if (insns.count(a))
+		{
+			break;
+		}
+
+		std::uint64_t next = a;
+		cs_insn* insn = _pool.allocate();
+		if (bytes == nullptr
+				|| handle == 0
+				|| !cs_disasm_iter(handle, &bytes, &size, &next, insn))
+		{
+			_pool.release(insn);
+			insns.emplace(a, nullptr);
+			break;
+		}
+
+		insns.emplace(a, insn);
+		if (n == 0)
+		{
+			first = insn;
+		}
+		a = next;
+	}
+
+	return first;
+}
+
+/**
+ * Add instruction @a insn disassembled elsewhere in basic mode @a mode.
+ * Already cached addresses are kept.
+ */
+void DisassemblyCache::insert(cs_mode mode, const cs_insn& insn)
+{
+	auto& insns = _insns[mode];
+	if (insns.count(insn.address))
+	{
+		return;
+	}
+
+	cs_insn* i = _pool.allocate();
+	cs_detail* detail = i->detail;
+	*i = insn;
+	i->detail = detail;
+	if (insn.detail)
+	{
+		std::memcpy(detail, insn.detail, _pool.getDetailSize());
+	}
+	insns.emplace(insn.address, i);
+}
+
+/**
+ * Copy cached instruction @a from into instruction @a to, which has its own
+ * detail of size @a toDetailSize.
+ */
+void DisassemblyCache::copy(
+		const cs_insn& from,
+		cs_insn* to,
+		std::size_t toDetailSize) const
+{
+	cs_detail* detail = to->detail;
+	*to = from;
+	to->detail = detail;
+	if (detail && from.detail)
+	{
+		std::memcpy(
+				detail,
+				from.detail,
+				std::min(toDetailSize, _pool.getDetailSize()));
+	}
+}
+
+/**
+ * @return Number of cached addresses, including failed ones.
+ */
+std::size_t DisassemblyCache::size() const
+{
+	std::size_t sz = 0;
+	for (auto& p : _insns)
+	{
+		sz += p.second.size();
+	}
+	return sz;
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
@@ -555,6 +555,7 @@ llvm::Function* Decoder::splitFunctionOn(
 				newFnc);
 
 		addFunction(splitAddr, newFnc);
+		++_stats.functionSplits;
 
 		newFnc->getBasicBlockList().splice(
 				newFnc->begin(),
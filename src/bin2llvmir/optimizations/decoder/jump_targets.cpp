@@ -4,6 +4,8 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
+
 #include "retdec/bin2llvmir/optimizations/decoder/jump_targets.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/providers/config.h"
@@ -99,63 +101,54 @@ void JumpTarget::setMode(cs_mode m) const
 	_mode = m;
 }
 
-std::ostream& operator<<(std::ostream &out, const JumpTarget& jt)
+/**
+ * @return Name of jump target type @a t.
+ */
+std::string JumpTarget::typeToString(eType t)
 {
-	std::string t;
-	switch (jt.getType())
+	switch (t)
 	{
 		case JumpTarget::eType::CONTROL_FLOW_BR_FALSE:
-			t = "CONTROL_FLOW_BR_FALSE";
-			break;
+			return "CONTROL_FLOW_BR_FALSE";
 		case JumpTarget::eType::CONTROL_FLOW_BR_TRUE:
-			t = "CONTROL_FLOW_BR_TRUE";
-			break;
+			return "CONTROL_FLOW_BR_TRUE";
 		case JumpTarget::eType::CONTROL_FLOW_SWITCH_CASE:
-			t = "CONTROL_FLOW_SWITCH_CASE";
-			break;
+			return "CONTROL_FLOW_SWITCH_CASE";
 		case JumpTarget::eType::CONTROL_FLOW_CALL_TARGET:
-			t = "CONTROL_FLOW_CALL_TARGET";
-			break;
+			return "CONTROL_FLOW_CALL_TARGET";
 		case JumpTarget::eType::CONTROL_FLOW_RETURN_TARGET:
-			t = "CONTROL_FLOW_RETURN_TARGET";
-			break;
+			return "CONTROL_FLOW_RETURN_TARGET";
 		case JumpTarget::eType::CONFIG:
-			t = "CONFIG";
-			break;
+			return "CONFIG";
 		case JumpTarget::eType::ENTRY_POINT:
-			t = "ENTRY_POINT";
-			break;
+			return "ENTRY_POINT";
 		case JumpTarget::eType::SELECTED_RANGE_START:
-			t = "SELECTED_RANGE_START";
-			break;
+			return "SELECTED_RANGE_START";
 		case JumpTarget::eType::IMPORT:
-			t = "IMPORT";
-			break;
+			return "IMPORT";
 		case JumpTarget::eType::EXPORT:
-			t = "EXPORT";
-			break;
+			return "EXPORT";
 		case JumpTarget::eType::DEBUG:
-			t = "DEBUG";
-			break;
+			return "DEBUG";
 		case JumpTarget::eType::SYMBOL:
-			t = "SYMBOL";
-			break;
+			return "SYMBOL";
+		case JumpTarget::eType::UNWIND:
+			return "UNWIND";
 		case JumpTarget::eType::STATIC_CODE:
-			t = "STATIC_CODE";
-			break;
+			return "STATIC_CODE";
 		case JumpTarget::eType::VTABLE:
-			t = "VTABLE";
-			break;
+			return "VTABLE";
 		case JumpTarget::eType::LEFTOVER:
-			t = "LEFTOVER";
-			break;
+			return "LEFTOVER";
 		default:
 			assert(false && "unknown type");
-			t = "unknown";
-			break;
+			return "unknown";
 	}
+}
 
-	out << jt.getAddress() << " (" << t << ")";
+std::ostream& operator<<(std::ostream &out, const JumpTarget& jt)
+{
+	out << jt.getAddress() << " (" << JumpTarget::typeToString(jt.getType()) << ")";
 
 	auto& arch = jt.config->getConfig().architecture;
 	out << " (" << capstone_utils::mode2string(arch, jt.getMode()) << ")";
@@ -180,6 +173,42 @@ std::ostream& operator<<(std::ostream &out, const JumpTarget& jt)
 
 Config* JumpTargets::config = nullptr;
 
+bool JumpTargets::Key::operator==(const Key& o) const
+{
+	return address == o.address && type == o.type && from == o.from;
+}
+
+std::size_t JumpTargets::KeyHash::operator()(const Key& k) const
+{
+	auto combine = [](std::size_t h, std::size_t v)
+	{
+		return h ^ (v + 0x9e3779b9 + (h << 6) + (h >> 2));
+	};
+
+	std::size_t h = std::hash<uint64_t>()(k.address.getValue());
+	h = combine(h, std::hash<uint64_t>()(k.from.getValue()));
+	return combine(h, static_cast<std::size_t>(k.type));
+}
+
+JumpTargets::Key JumpTargets::getKey(const JumpTarget& jt)
+{
+	return Key{jt.getAddress(), jt.getType(), jt.getFromAddress()};
+}
+
+/**
+ * Heap comparator - the top of the heap is the smallest jump target.
+ */
+bool JumpTargets::heapCompare(const JumpTarget* a, const JumpTarget* b)
+{
+	return *b < *a;
+}
+
+/**
+ * Queue a new jump target.
+ * @return Queued jump target (or the equal one that was already queued),
+ *         or @c nullptr if the jump target was rejected. It is valid until
+ *         the jump target is popped.
+ */
 const JumpTarget* JumpTargets::push(
 		retdec::common::Address a,
 		JumpTarget::eType t,
@@ -213,54 +242,87 @@ const JumpTarget* JumpTargets::push(
 		else
 		{
 			LOG << "\t\t" << "[+] JT @ " << a << std::endl;
-			return &(*_data.emplace(a, t, m, f, sz).first);
+			JumpTarget jt(a, t, m, f, sz);
+			auto res = _queued.emplace(getKey(jt), jt);
+			if (res.second)
+			{
+				++_stats.pushed;
+				_heap.push_back(&res.first->second);
+				std::push_heap(_heap.begin(), _heap.end(), heapCompare);
+			}
+			else
+			{
+				++_stats.duplicates;
+			}
+			return &res.first->second;
 		}
 	}
 
+	++_stats.rejected;
 	return nullptr;
 }
 
 std::size_t JumpTargets::size() const
 {
-	return _data.size();
+	return _heap.size();
 }
 
 void JumpTargets::clear()
 {
-	_data.clear();
+	_heap.clear();
+	_queued.clear();
 }
 
 bool JumpTargets::empty()
 {
-	return _data.empty();
+	return _heap.empty();
 }
 
 const JumpTarget& JumpTargets::top()
 {
-	return *_data.begin();
+	return *_heap.front();
 }
 
 void JumpTargets::pop()
 {
-	_data.erase(top());
+	std::pop_heap(_heap.begin(), _heap.end(), heapCompare);
+	auto key = getKey(*_heap.back());
+	_heap.pop_back();
+	_queued.erase(key);
+	++_stats.popped;
 }
 
-auto JumpTargets::begin()
+/**
+ * Iteration in the heap order - the top first, the rest is only partially
+ * ordered by priority.
+ */
+JumpTargets::const_iterator JumpTargets::begin() const
 {
-	return _data.begin();
+	return _heap.begin();
 }
 
-auto JumpTargets::end()
+JumpTargets::const_iterator JumpTargets::end() const
 {
-	return _data.end();
+	return _heap.end();
+}
+
+const JumpTargets::Statistics& JumpTargets::getStatistics() const
+{
+	return _stats;
 }
 
 std::ostream& operator<<(std::ostream &out, const JumpTargets& jts)
 {
+	auto sorted = jts._heap;
+	std::sort(sorted.begin(), sorted.end(), [](auto* a, auto* b)
+	{
+		return *a < *b;
+	});
+
 	out << "Jump targets:" << std::endl;
-	for (auto& jt : jts._data)
+	for (auto* jt : sorted)
 	{
-		out << "\t" << jt << std::endl;
+		out << "\t" << *jt << std::endl;
 	}
 	return out;
 }
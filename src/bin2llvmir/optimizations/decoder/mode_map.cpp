@@ -0,0 +1,68 @@
+/**
+* @file src/bin2llvmir/optimizations/decoder/mode_map.cpp
+* @brief Map of basic modes in which addresses are decoded.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include "retdec/bin2llvmir/optimizations/decoder/mode_map.h"
+
+using namespace retdec::common;
+
+namespace retdec {
+namespace bin2llvmir {
+
+/**
+ * Set @a mode from @a addr up to the next address with a set mode.
+ */
+void ModeMap::set(common::Address addr, std::optional<cs_mode> mode)
+{
+	_modes[addr] = mode;
+}
+
+/**
+ * Set @a mode of the whole @a range. Modes set inside the range are
+ * replaced, the mode after the range is kept.
+ */
+void ModeMap::set(const common::AddressRange& range, cs_mode mode)
+{
+	if (range.getStart() >= range.getEnd())
+	{
+		return;
+	}
+
+	auto after = get(range.getEnd());
+	_modes.erase(
+			_modes.lower_bound(range.getStart()),
+			_modes.lower_bound(range.getEnd()));
+	_modes[range.getStart()] = mode;
+	_modes.emplace(range.getEnd(), after);
+}
+
+/**
+ * @return Mode at @a addr, or nothing if it is not known.
+ */
+std::optional<cs_mode> ModeMap::get(common::Address addr) const
+{
+	auto it = _modes.upper_bound(addr);
+	if (it == _modes.begin())
+	{
+		return std::nullopt;
+	}
+	return std::prev(it)->second;
+}
+
+bool ModeMap::empty() const
+{
+	return _modes.empty();
+}
+
+/**
+ * @return Number of addresses with a set mode.
+ */
+std::size_t ModeMap::size() const
+{
+	return _modes.size();
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
@@ -25,12 +25,10 @@ std::size_t Decoder::decodeJumpTargetDryRun_ppc(
 		return true;
 	}
 
-	csh ce = _c2l->getCapstoneEngine();
-
 	uint64_t addr = jt.getAddress();
 	std::size_t nops = 0;
 	bool first = true;
-	while (cs_disasm_iter(ce, &bytes.first, &bytes.second, &addr, _dryCsInsn))
+	while (disassembleDryRun(bytes, addr, _c2l->getBasicMode()))
 	{
 		if (jt.getType() == JumpTarget::eType::LEFTOVER
 				&& (first || nops > 0)
@@ -0,0 +1,238 @@
+/**
+* @file src/bin2llvmir/optimizations/decoder/speculative_disassembler.cpp
+* @brief Speculative disassembly of jump targets on worker threads.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+
+#include "retdec/bin2llvmir/optimizations/decoder/speculative_disassembler.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+namespace {
+
+/// Maximal number of instructions in one batch.
+const std::size_t BATCH_MAX_INSNS = 256;
+/// Maximal number of disassembled batches waiting for the decoder per
+/// worker. The oldest batches are dropped when it is exceeded.
+const std::size_t BATCHES_PER_WORKER = 8;
+
+} // anonymous namespace
+
+/**
+ * @param arch Architecture of the decoder's translator.
+ * @param extraMode Extra mode (endianness) of the decoder's translator.
+ * @param threads Number of worker threads.
+ */
+SpeculativeDisassembler::SpeculativeDisassembler(
+		cs_arch arch,
+		cs_mode extraMode,
+		unsigned threads)
+		:
+		_arch(arch),
+		_extraMode(extraMode),
+		_maxDone(BATCHES_PER_WORKER * threads)
+{
+	for (unsigned i = 0; i < threads; ++i)
+	{
+		_workers.emplace_back(&SpeculativeDisassembler::work, this);
+	}
+}
+
+SpeculativeDisassembler::~SpeculativeDisassembler()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_jobAdded.notify_all();
+
+	for (auto& w : _workers)
+	{
+		w.join();
+	}
+}
+
+/**
+ * Request disassembly of @a size @a bytes located at address @a start in
+ * basic mode @a mode. The bytes must stay valid until the disassembler is
+ * destroyed.
+ */
+void SpeculativeDisassembler::request(
+		common::Address start,
+		cs_mode mode,
+		const uint8_t* bytes,
+		std::size_t size)
+{
+	if (_workers.empty() || bytes == nullptr || size == 0)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		Key key(start, mode);
+		if (_running.count(key) || _done.count(key))
+		{
+			return;
+		}
+		for (auto& j : _jobs)
+		{
+			if (j.start == start && j.mode == mode)
+			{
+				return;
+			}
+		}
+		_jobs.push_back(Job{start, mode, bytes, size});
+	}
+	_jobAdded.notify_one();
+}
+
+/**
+ * Take the batch disassembled from @a start in basic mode @a mode.
+ * If the batch is being disassembled, wait for it.
+ * @return The batch, or @c nullptr if it was not requested or it has not been
+ *         started yet. In such a case, the request is cancelled.
+ */
+std::unique_ptr<SpeculativeDisassembler::Batch>
+SpeculativeDisassembler::acquire(common::Address start, cs_mode mode)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	Key key(start, mode);
+
+	auto jIt = std::find_if(_jobs.begin(), _jobs.end(), [&](const Job& j)
+	{
+		return j.start == start && j.mode == mode;
+	});
+	if (jIt != _jobs.end())
+	{
+		_jobs.erase(jIt);
+		return nullptr;
+	}
+
+	_batchDone.wait(lock, [&]() { return _running.count(key) == 0; });
+
+	auto it = _done.find(key);
+	if (it == _done.end())
+	{
+		return nullptr;
+	}
+
+	auto batch = std::move(it->second);
+	_done.erase(it);
+	_doneOrder.erase(std::find(_doneOrder.begin(), _doneOrder.end(), key));
+	return batch;
+}
+
+void SpeculativeDisassembler::work()
+{
+	csh handle = 0;
+	bool opened = false;
+	cs_mode openedMode = CS_MODE_LITTLE_ENDIAN;
+
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobAdded.wait(lock, [this]() { return _stop || !_jobs.empty(); });
+			if (_stop)
+			{
+				break;
+			}
+			job = _jobs.front();
+			_jobs.pop_front();
+			_running.insert(Key(job.start, job.mode));
+		}
+
+		if (!opened || openedMode != job.mode)
+		{
+			if (opened)
+			{
+				cs_close(&handle);
+			}
+			opened = cs_open(
+					_arch,
+					static_cast<cs_mode>(job.mode + _extraMode),
+					&handle) == CS_ERR_OK
+					&& cs_option(handle, CS_OPT_DETAIL, CS_OPT_ON) == CS_ERR_OK;
+			openedMode = job.mode;
+		}
+
+		auto batch = opened ? disassemble(handle, job) : nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			Key key(job.start, job.mode);
+			_running.erase(key);
+			if (batch)
+			{
+				_done[key] = std::move(batch);
+				_doneOrder.push_back(key);
+				dropOldBatches();
+			}
+		}
+		_batchDone.notify_all();
+	}
+
+	if (opened)
+	{
+		cs_close(&handle);
+	}
+}
+
+std::unique_ptr<SpeculativeDisassembler::Batch>
+SpeculativeDisassembler::disassemble(csh handle, const Job& job) const
+{
+	auto batch = std::make_unique<Batch>();
+	batch->start = job.start;
+	batch->mode = job.mode;
+	batch->insns.resize(BATCH_MAX_INSNS);
+	batch->details.resize(BATCH_MAX_INSNS);
+
+	const uint8_t* bytes = job.bytes;
+	std::size_t size = job.size;
+	uint64_t address = job.start;
+	std::size_t n = 0;
+	while (n < BATCH_MAX_INSNS)
+	{
+		cs_insn* insn = &batch->insns[n];
+		insn->detail = &batch->details[n];
+		if (!cs_disasm_iter(handle, &bytes, &size, &address, insn))
+		{
+			break;
+		}
+		++n;
+
+		if (cs_insn_group(handle, insn, CS_GRP_JUMP)
+				|| cs_insn_group(handle, insn, CS_GRP_RET)
+				|| cs_insn_group(handle, insn, CS_GRP_IRET))
+		{
+			break;
+		}
+	}
+
+	if (n == 0)
+	{
+		return nullptr;
+	}
+
+	// Shrinking keeps the storage, instructions still point to their details.
+	batch->insns.resize(n);
+	batch->details.resize(n);
+	return batch;
+}
+
+void SpeculativeDisassembler::dropOldBatches()
+{
+	while (_doneOrder.size() > _maxDone)
+	{
+		_done.erase(_doneOrder.front());
+		_doneOrder.pop_front();
+	}
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
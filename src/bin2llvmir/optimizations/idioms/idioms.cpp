@@ -50,11 +50,27 @@ bool Idioms::doInitialization(Module &M) {
  * @return always true
  */
 bool Idioms::doFinalization(Module &M) {
+	if (m_idioms) {
+		for (const auto & p : m_idioms->getStatistics()) {
+			auto & s = m_statistics[p.first];
+			s.hits += p.second.hits;
+			s.time += p.second.time;
+		}
+	}
+
 	delete m_idioms;
+	m_idioms = nullptr;
 
 	return true;
 }
 
+/**
+ * Get hits and time of instruction idioms of all the finalized analyses
+ */
+const IdiomsAnalysis::Statistics & Idioms::getStatistics() const {
+	return m_statistics;
+}
+
 /**
  * Instruction idioms analysis
  *
@@ -4,6 +4,8 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <chrono>
+
 #include "retdec/bin2llvmir/optimizations/idioms/idioms_analysis.h"
 
 using namespace llvm;
@@ -12,25 +14,248 @@ namespace retdec {
 namespace bin2llvmir {
 
 /**
- * Analyse given BasicBlock and use instruction exchanger to transform
- * instruction idioms
+ * Add basic block idiom to the end of the dispatch table
  *
- * @param bb BasicBlock to analyse
  * @param exchanger instruction idiom exchanger
- * @param fname instruction idiom exchanger name (for debug purpose only)
+ * @param name instruction idiom exchanger name
+ * @param opcodes opcodes of instructions the idiom can be rooted at
  */
-bool IdiomsAnalysis::analyse(llvm::BasicBlock & bb, llvm::Instruction * (IdiomsAnalysis::*exchanger)(llvm::BasicBlock::iterator) const, const char * fname) {
+void IdiomsAnalysis::addIdiom(BasicBlockExchanger exchanger, const char * name, std::initializer_list<unsigned> opcodes) {
+	BasicBlockIdiom idiom{exchanger, name, Opcodes(), IdiomStatistics()};
+	for (unsigned op : opcodes)
+		idiom.opcodes.set(op);
+
+	m_bbIdioms.push_back(idiom);
+}
+
+/**
+ * Fill the dispatch table with basic block idioms of the actual compiler and
+ * architecture
+ *
+ * Position of instruction idiom exchangers is IMPORTANT! More complicated
+ * instruction idioms have to be exchanged before simplier ones. They can
+ * consist of other instruction idioms (the simple ones), so they have to be
+ * exchanged at first place!
+ */
+void IdiomsAnalysis::initBasicBlockIdioms() {
+	CC_compiler cc = getCompiler();
+	CC_arch arch = getArch();
+
+	if (arch == ARCH_POWERPC || arch == ARCH_ARM || arch == ARCH_x86 || arch == ARCH_THUMB || arch == ARCH_ANY)
+		if (cc == CC_GCC || cc == CC_Intel || cc == CC_VStudio || cc == CC_ANY) {
+			addIdiom(&IdiomsMagicDivMod::signedMod1,
+						"IdiomsMagicDivMod::signedMod1", {Instruction::Add});
+
+			addIdiom(&IdiomsMagicDivMod::signedMod2,
+						"IdiomsMagicDivMod::signedMod2", {Instruction::Add});
+
+			addIdiom(&IdiomsMagicDivMod::magicUnsignedDiv2,
+						"IdiomsMagicDivMod::magicUnsignedDiv2", {Instruction::LShr});
+
+			addIdiom(&IdiomsMagicDivMod::magicUnsignedDiv1,
+						"IdiomsMagicDivMod::magicUnsignedDiv1", {Instruction::Trunc});
+
+			addIdiom(&IdiomsMagicDivMod::magicSignedDiv1,
+						"IdiomsMagicDivMod::magicSignedDiv1", {Instruction::Sub});
+
+			addIdiom(&IdiomsMagicDivMod::magicSignedDiv2,
+						"IdiomsMagicDivMod::magicSignedDiv2", {Instruction::Sub});
+
+			addIdiom(&IdiomsMagicDivMod::magicSignedDiv3,
+						"IdiomsMagicDivMod::magicSignedDiv3", {Instruction::Sub});
+
+			addIdiom(&IdiomsMagicDivMod::magicSignedDiv4,
+						"IdiomsMagicDivMod::magicSignedDiv4", {Instruction::Sub});
+
+			addIdiom(&IdiomsMagicDivMod::magicSignedDiv5,
+						"IdiomsMagicDivMod::magicSignedDiv5", {Instruction::Sub});
+
+			addIdiom(&IdiomsMagicDivMod::magicSignedDiv6,
+						"IdiomsMagicDivMod::magicSignedDiv6", {Instruction::Sub});
+
+			// Found in PowerPC - div 10
+			addIdiom(&IdiomsMagicDivMod::magicSignedDiv7pos,
+						"IdiomsMagicDivMod::magicSignedDiv7pos", {Instruction::Sub});
+
+			// Found in PowerPC - the same as previous, but the divisor
+			// is negative, i.e. div -10
+			addIdiom(&IdiomsMagicDivMod::magicSignedDiv7neg,
+						"IdiomsMagicDivMod::magicSignedDiv7neg", {Instruction::Sub});
+
+			// Found in PowerPC - div 6
+			addIdiom(&IdiomsMagicDivMod::magicSignedDiv8pos,
+						"IdiomsMagicDivMod::magicSignedDiv8pos", {Instruction::Sub});
+
+			// Found in PowerPC - the same as previous, but the divisor
+			// is negative, i.e. div -3
+			addIdiom(&IdiomsMagicDivMod::magicSignedDiv8neg,
+						"IdiomsMagicDivMod::magicSignedDiv8neg", {Instruction::Sub});
+
+			addIdiom(&IdiomsMagicDivMod::unsignedMod,
+						"IdiomsMagicDivMod::unsignedMod", {Instruction::Sub});
+	}
+
+	// all arch
+	if (cc == CC_GCC || cc == CC_ANY)
+		addIdiom(&IdiomsGCC::exchangeSignedModuloByTwo,
+					"IdiomsGCC::exchangeSignedModuloByTwo", {Instruction::Sub});
+
+	// PowerPC model lacks FPU and x86 uses x87.
+	if (arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
+		if (cc == CC_GCC || cc == CC_ANY)
+			addIdiom(&IdiomsGCC::exchangeCopysign,
+						"IdiomsGCC::exchangeCopysign", {Instruction::Or});
+
+	// PowerPC model lacks FPU and x86 uses x87.
+	if (arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
+		if (cc == CC_GCC || cc == CC_ANY)
+			addIdiom(&IdiomsGCC::exchangeFloatAbs,
+						"IdiomsGCC::exchangeFloatAbs", {Instruction::And});
+
+	if (arch == ARCH_x86 || arch == ARCH_ANY)
+		if (cc == CC_Intel || cc == CC_VStudio || cc == CC_ANY)
+			addIdiom(&IdiomsVStudio::exchangeOrMinusOneAssign,
+						"IdiomsVStudio::exchangeOrMinusOneAssign", {Instruction::Or});
+
+	if (arch == ARCH_x86 || arch == ARCH_ANY)
+		if (cc == CC_Intel || cc == CC_VStudio || cc == CC_ANY)
+			addIdiom(&IdiomsVStudio::exchangeAndZeroAssign,
+						"IdiomsVStudio::exchangeAndZeroAssign", {Instruction::And});
+
+	// all arch
+	if (cc == CC_GCC || cc == CC_ANY)
+		addIdiom(&IdiomsGCC::exchangeCondBitShiftDiv1,
+					"IdiomsGCC::exchangeCondBitShiftDiv1", {Instruction::AShr});
+
+	// all arch
+	if (cc == CC_GCC || cc == CC_ANY)
+		addIdiom(&IdiomsGCC::exchangeCondBitShiftDiv2,
+					"IdiomsGCC::exchangeCondBitShiftDiv2", {Instruction::Sub});
+
+	// all arch
+	if (cc == CC_GCC || cc == CC_ANY)
+		addIdiom(&IdiomsGCC::exchangeCondBitShiftDiv3,
+					"IdiomsGCC::exchangeCondBitShiftDiv3", {Instruction::Sub});
+
+	// all arch
+	if (cc == CC_GCC || cc == CC_Intel || cc == CC_LLVM || cc == CC_VStudio || cc == CC_ANY)
+		addIdiom(&IdiomsCommon::exchangeSignedModulo2n,
+					"IdiomsCommon::exchangeSignedModulo2n", {Instruction::Sub});
+
+	// all arch
+	if (cc == CC_GCC || cc == CC_Intel || cc == CC_ANY)
+		addIdiom(&IdiomsCommon::exchangeGreaterEqualZero,
+					"IdiomsCommon::exchangeGreaterEqualZero", {Instruction::Xor, Instruction::LShr});
+
+	// all arch
+	if (cc == CC_GCC || cc == CC_LLVM || cc == CC_VStudio || cc == CC_ANY)
+		addIdiom(&IdiomsGCC::exchangeXorMinusOne,
+					"IdiomsGCC::exchangeXorMinusOne", {Instruction::Xor});
+
+	if (arch == ARCH_POWERPC || arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
+		if (cc == CC_GCC || cc == CC_ANY)
+			addIdiom(&IdiomsCommon::exchangeDivByMinusTwo,
+						"IdiomsCommon::exchangeDivByMinusTwo", {Instruction::Sub});
+
+	// all arch
+	if (cc == CC_GCC || cc == CC_Intel || cc == CC_LLVM || cc == CC_ANY)
+		addIdiom(&IdiomsCommon::exchangeLessThanZero,
+					"IdiomsCommon::exchangeLessThanZero", {Instruction::LShr});
+
+	// PowerPC model lacks FPU and x86 uses x87.
+	if (cc == CC_GCC || cc == CC_ANY)
+		if (arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
+			addIdiom(&IdiomsGCC::exchangeFloatNeg,
+						"IdiomsGCC::exchangeFloatNeg", {Instruction::Xor});
+
+	// all arch
+	if (cc == CC_GCC || cc == CC_ANY)
+		addIdiom(&IdiomsCommon::exchangeUnsignedModulo2n,
+					"IdiomsCommon::exchangeUnsignedModulo2n", {Instruction::And});
+
+	// all arch
+	if (cc == CC_LLVM || cc == CC_ANY)
+		addIdiom(&IdiomsLLVM::exchangeIsGreaterThanMinusOne,
+					"IdiomsLLVM::exchangeIsGreaterThanMinusOne", {Instruction::ICmp});
+
+	// all arch
+	// all compilers
+	addIdiom(&IdiomsCommon::exchangeBitShiftSDiv1,
+				"IdiomsCommon::exchangeBitShiftSDiv1", {Instruction::Or});
+
+	// all arch
+	// all compilers
+	addIdiom(&IdiomsCommon::exchangeBitShiftUDiv,
+				"IdiomsCommon::exchangeBitShiftUDiv", {Instruction::LShr});
+
+	// all arch
+	// all compilers
+	addIdiom(&IdiomsCommon::exchangeBitShiftMul,
+				"IdiomsCommon::exchangeBitShiftMul", {Instruction::Shl});
+
+	// all arch
+	if (cc == CC_LLVM || cc == CC_ANY) {
+		addIdiom(&IdiomsLLVM::exchangeIsGreaterThanMinusOne,
+					"IdiomsLLVM::exchangeIsGreaterThanMinusOne", {Instruction::ICmp});
+	}
+
+	// all arch
+	if (cc == CC_LLVM || cc == CC_ANY) {
+		addIdiom(&IdiomsLLVM::exchangeCompareEq,
+					"IdiomsLLVM::exchangeCompareEq", {Instruction::Xor});
+
+#if 0
+		/* We do not recognize this well */
+		addIdiom(&IdiomsLLVM::exchangeCompareNeq,
+					"IdiomsLLVM::exchangeCompareNeq", {});
+#endif
+
+		addIdiom(&IdiomsLLVM::exchangeCompareSlt,
+					"IdiomsLLVM::exchangeCompareSlt", {Instruction::And});
+
+		addIdiom(&IdiomsLLVM::exchangeCompareSle,
+					"IdiomsLLVM::exchangeCompareSle", {Instruction::Or});
+	}
+}
+
+/**
+ * Get opcodes of all the instructions in given BasicBlock
+ *
+ * @param bb BasicBlock to inspect
+ */
+IdiomsAnalysis::Opcodes IdiomsAnalysis::getOpcodes(const llvm::BasicBlock & bb) {
+	Opcodes opcodes;
+	for (const Instruction & insn : bb)
+		opcodes.set(insn.getOpcode());
+
+	return opcodes;
+}
+
+/**
+ * Analyse given BasicBlock and use instruction exchanger of the idiom to
+ * transform instruction idioms
+ *
+ * @param bb BasicBlock to analyse
+ * @param idiom basic block idiom, its exchanger is called only on instructions
+ * the idiom can be rooted at
+ */
+bool IdiomsAnalysis::analyse(llvm::BasicBlock & bb, BasicBlockIdiom & idiom) {
 	bool change_made = false;
 
+	auto start = std::chrono::steady_clock::now();
+
 	for (BasicBlock::iterator iter = bb.begin(), end = bb.end(); iter != end; /**/) {
 		BasicBlock::iterator insn = iter;
 		++iter; // go to next instruction to use valid iterator in next loop
 
-		// call exchanger on every instruction
-		Instruction * res = (this->*exchanger)(insn);
+		if (!idiom.opcodes.test(insn->getOpcode()))
+			continue;
+
+		Instruction * res = (this->*idiom.exchanger)(insn);
 
 		if (res) {
 			change_made = true;
+			++idiom.statistics.hits;
 
 			(*insn).replaceAllUsesWith(res);
 
@@ -51,6 +276,9 @@ bool IdiomsAnalysis::analyse(llvm::BasicBlock & bb, llvm::Instruction * (IdiomsA
 		}
 	}
 
+	idiom.statistics.time += std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count();
+
 	return change_made;
 }
 
@@ -64,16 +292,13 @@ bool IdiomsAnalysis::analyse(llvm::BasicBlock & bb, llvm::Instruction * (IdiomsA
 bool IdiomsAnalysis::doAnalysis(Function & f, Pass * p) {
 	/*
 	 * Instruction idioms are inspected in a tree of Instructions. Every
-	 * instruction idiom has to be called on a basic block. Position of
-	 * instruction idiom exchangers is IMPORTANT! More complicated instruction
-	 * idioms have to be exchanged before simplier ones. They can consist of
-	 * other instruction idioms (the simple ones), so they have to be exchanged
-	 * at first place!
+	 * instruction idiom has to be called on a basic block in the order of the
+	 * dispatch table. An idiom is skipped in basic blocks without any
+	 * instruction it can be rooted at.
 	 */
 	bool change_made = false; // was there any exchange?
 
 	CC_compiler cc = getCompiler();
-	CC_arch arch = getArch();
 
 	// Inspect multi-basic block idioms
 	if (cc == CC_GCC || cc == CC_ANY) {
@@ -84,184 +309,39 @@ bool IdiomsAnalysis::doAnalysis(Function & f, Pass * p) {
 	// Inspect basic-block idioms
 	for (Function::iterator b = f.begin(); b != f.end(); ++b) {
 		BasicBlock & bb = *b;
-		if (arch == ARCH_POWERPC || arch == ARCH_ARM || arch == ARCH_x86 || arch == ARCH_THUMB || arch == ARCH_ANY)
-			if (cc == CC_GCC || cc == CC_Intel || cc == CC_VStudio || cc == CC_ANY) {
-				change_made |= analyse(bb, &IdiomsMagicDivMod::signedMod1,
-											"IdiomsMagicDivMod::signedMod1");
-
-				change_made |= analyse(bb, &IdiomsMagicDivMod::signedMod2,
-											"IdiomsMagicDivMod::signedMod2");
-
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicUnsignedDiv2,
-											"IdiomsMagicDivMod::magicUnsignedDiv2");
-
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicUnsignedDiv1,
-											"IdiomsMagicDivMod::magicUnsignedDiv1");
-
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv1,
-											"IdiomsMagicDivMod::magicSignedDiv1");
-
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv2,
-											"IdiomsMagicDivMod::magicSignedDiv2");
-
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv3,
-											"IdiomsMagicDivMod::magicSignedDiv3");
-
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv4,
-											"IdiomsMagicDivMod::magicSignedDiv4");
-
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv5,
-											"IdiomsMagicDivMod::magicSignedDiv5");
-
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv6,
-											"IdiomsMagicDivMod::magicSignedDiv6");
-
-				// Found in PowerPC - div 10
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv7pos,
-											"IdiomsMagicDivMod::magicSignedDiv7pos");
-
-				// Found in PowerPC - the same as previous, but the divisor
-				// is negative, i.e. div -10
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv7neg,
-											"IdiomsMagicDivMod::magicSignedDiv7neg");
-
-				// Found in PowerPC - div 6
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv8pos,
-											"IdiomsMagicDivMod::magicSignedDiv8pos");
-
-				// Found in PowerPC - the same as previous, but the divisor
-				// is negative, i.e. div -3
-				change_made |= analyse(bb, &IdiomsMagicDivMod::magicSignedDiv8neg,
-											"IdiomsMagicDivMod::magicSignedDiv8neg");
-
-				change_made |= analyse(bb, &IdiomsMagicDivMod::unsignedMod,
-											"IdiomsMagicDivMod::unsignedMod");
-		}
-
-		// all arch
-		if (cc == CC_GCC || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsGCC::exchangeSignedModuloByTwo,
-										"IdiomsGCC::exchangeSignedModuloByTwo");
+		Opcodes opcodes = getOpcodes(bb);
 
-		// PowerPC model lacks FPU and x86 uses x87.
-		if (arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
-			if (cc == CC_GCC || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsGCC::exchangeCopysign,
-											"IdiomsGCC::exchangeCopysign");
-
-		// PowerPC model lacks FPU and x86 uses x87.
-		if (arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
-			if (cc == CC_GCC || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsGCC::exchangeFloatAbs,
-											"IdiomsGCC::exchangeFloatAbs");
-
-		if (arch == ARCH_x86 || arch == ARCH_ANY)
-			if (cc == CC_Intel || cc == CC_VStudio || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsVStudio::exchangeOrMinusOneAssign,
-											"IdiomsVStudio::exchangeOrMinusOneAssign");
-
-		if (arch == ARCH_x86 || arch == ARCH_ANY)
-			if (cc == CC_Intel || cc == CC_VStudio || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsVStudio::exchangeAndZeroAssign,
-										"IdiomsVStudio::exchangeAndZeroAssign");
-
-		// all arch
-		if (cc == CC_GCC || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsGCC::exchangeCondBitShiftDiv1,
-										"IdiomsGCC::exchangeCondBitShiftDiv1");
+		for (BasicBlockIdiom & idiom : m_bbIdioms) {
+			if ((opcodes & idiom.opcodes).none())
+				continue;
 
-		// all arch
-		if (cc == CC_GCC || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsGCC::exchangeCondBitShiftDiv2,
-										"IdiomsGCC::exchangeCondBitShiftDiv2");
-
-		// all arch
-		if (cc == CC_GCC || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsGCC::exchangeCondBitShiftDiv3,
-										"IdiomsGCC::exchangeCondBitShiftDiv3");
-
-		// all arch
-		if (cc == CC_GCC || cc == CC_Intel || cc == CC_LLVM || cc == CC_VStudio || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsCommon::exchangeSignedModulo2n,
-										"IdiomsCommon::exchangeSignedModulo2n");
-
-		// all arch
-		if (cc == CC_GCC || cc == CC_Intel || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsCommon::exchangeGreaterEqualZero,
-										"IdiomsCommon::exchangeGreaterEqualZero");
-
-		// all arch
-		if (cc == CC_GCC || cc == CC_LLVM || cc == CC_VStudio || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsGCC::exchangeXorMinusOne,
-										"IdiomsGCC::exchangeXorMinusOne");
-
-		if (arch == ARCH_POWERPC || arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
-			if (cc == CC_GCC || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsCommon::exchangeDivByMinusTwo,
-											"IdiomsCommon::exchangeDivByMinusTwo");
-
-		// all arch
-		if (cc == CC_GCC || cc == CC_Intel || cc == CC_LLVM || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsCommon::exchangeLessThanZero,
-										"IdiomsCommon::exchangeLessThanZero");
-
-		// PowerPC model lacks FPU and x86 uses x87.
-		if (cc == CC_GCC || cc == CC_ANY)
-			if (arch == ARCH_ARM || arch == ARCH_THUMB || arch == ARCH_MIPS || arch == ARCH_ANY)
-				change_made |= analyse(bb, &IdiomsGCC::exchangeFloatNeg,
-											"IdiomsGCC::exchangeFloatNeg");
-
-		// all arch
-		if (cc == CC_GCC || cc == CC_ANY)
-			change_made |= analyse(bb, &IdiomsCommon::exchangeUnsignedModulo2n,
-										"IdiomsCommon::exchangeUnsignedModulo2n");
-
-		// all arch
-		if (cc == CC_LLVM || cc == CC_ANY)
-				change_made |= analyse(bb, &IdiomsLLVM::exchangeIsGreaterThanMinusOne,
-											"IdiomsLLVM::exchangeIsGreaterThanMinusOne");
-
-		// all arch
-		// all compilers
-		change_made |= analyse(bb, &IdiomsCommon::exchangeBitShiftSDiv1,
-									"IdiomsCommon::exchangeBitShiftSDiv1");
-
-		// all arch
-		// all compilers
-		change_made |= analyse(bb, &IdiomsCommon::exchangeBitShiftUDiv,
-									"IdiomsCommon::exchangeBitShiftUDiv");
-
-		// all arch
-		// all compilers
-		change_made |= analyse(bb, &IdiomsCommon::exchangeBitShiftMul,
-									"IdiomsCommon::exchangeBitShiftMul");
-
-		// all arch
-		if (cc == CC_LLVM || cc == CC_ANY) {
-			change_made |= analyse(bb, &IdiomsLLVM::exchangeIsGreaterThanMinusOne,
-										"IdiomsLLVM::exchangeIsGreaterThanMinusOne");
+			if (analyse(bb, idiom)) {
+				change_made = true;
+				// Exchanged instructions may be roots of the following idioms.
+				opcodes = getOpcodes(bb);
+			}
 		}
+	}
 
-		// all arch
-		if (cc == CC_LLVM || cc == CC_ANY) {
-			change_made |= analyse(bb, &IdiomsLLVM::exchangeCompareEq,
-										"IdiomsLLVM::exchangeCompareEq");
-
-	#if 0
-			/* We do not recognize this well */
-			change_made |= analyse(bb, &IdiomsLLVM::exchangeCompareNeq,
-										"IdiomsLLVM::exchangeCompareNeq");
-	#endif
-
-			change_made |= analyse(bb, &IdiomsLLVM::exchangeCompareSlt,
-										"IdiomsLLVM::exchangeCompareSlt");
+	return change_made;
+}
 
-			change_made |= analyse(bb, &IdiomsLLVM::exchangeCompareSle,
-									"IdiomsLLVM::exchangeCompareSle");
-		}
+/**
+ * Get hits and time of all the instruction idioms
+ *
+ * Counters of an idiom listed several times in the dispatch table are summed.
+ */
+IdiomsAnalysis::Statistics IdiomsAnalysis::getStatistics() const {
+	Statistics stats;
+	stats["IdiomsGCC::exchangeCondBitShiftDivMultiBB"] = m_multiBbStatistics;
+
+	for (const BasicBlockIdiom & idiom : m_bbIdioms) {
+		IdiomStatistics & s = stats[idiom.name];
+		s.hits += idiom.statistics.hits;
+		s.time += idiom.statistics.time;
 	}
 
-	return change_made;
+	return stats;
 }
 
 /**
@@ -277,8 +357,14 @@ bool IdiomsAnalysis::doAnalysis(Function & f, Pass * p) {
 bool IdiomsAnalysis::analyse(llvm::Function & f, llvm::Pass * p, int (IdiomsAnalysis::*exchanger)(llvm::Function &, llvm::Pass *) const, const char * fname) {
 	int num_idioms = 0;
 
+	auto start = std::chrono::steady_clock::now();
+
 	num_idioms += IdiomsGCC::exchangeCondBitShiftDivMultiBB(f, p);
 
+	m_multiBbStatistics.hits += num_idioms;
+	m_multiBbStatistics.time += std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count();
+
 	return num_idioms == 0;
 }
 
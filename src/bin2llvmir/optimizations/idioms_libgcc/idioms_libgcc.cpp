@@ -1430,6 +1430,7 @@ bool IdiomsLibgcc::run()
 	}
 
 	bool changed = false;
+	_fnc2actionCache.clear();
 
 	for (Function& f : *_module)
 	for (auto it = inst_begin(&f), eIt = inst_end(&f); it != eIt;)
@@ -1459,16 +1460,41 @@ bool IdiomsLibgcc::runInstruction(llvm::Instruction* inst)
 
 	std::string calledFnc = call->getCalledFunction()->getName();
 
+	if (auto* p = getAction(calledFnc))
+	{
+		p->second(call);
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @return The first action whose name is contained in @a calledFnc, or
+ *         @c nullptr if there is none. The result is cached, because the
+ *         same functions are called many times.
+ */
+const IdiomsLibgcc::Fnc2Action::value_type* IdiomsLibgcc::getAction(
+		const std::string& calledFnc)
+{
+	auto fIt = _fnc2actionCache.find(calledFnc);
+	if (fIt != _fnc2actionCache.end())
+	{
+		return fIt->second;
+	}
+
+	const Fnc2Action::value_type* action = nullptr;
 	for (auto& p : _fnc2action)
 	{
 		if (contains(calledFnc, p.first))
 		{
-			p.second(call);
-			return true;
+			action = &p;
+			break;
 		}
 	}
 
-	return false;
+	_fnc2actionCache.emplace(calledFnc, action);
+	return action;
 }
 
 } // namespace bin2llvmir
@@ -23,6 +23,11 @@ static RegisterPass<InstructionOptimizer> X(
 		false // Analysis Pass
 );
 
+thread_local std::map<
+		llvm::Module*,
+		std::map<const llvm::Function*, std::size_t>>
+InstructionOptimizer::_unchanged;
+
 InstructionOptimizer::InstructionOptimizer() :
 		ModulePass(ID)
 {
@@ -44,18 +49,74 @@ bool InstructionOptimizer::runOnModuleCustom(llvm::Module& m)
 bool InstructionOptimizer::run()
 {
 	bool changed = false;
+	auto& unchanged = _unchanged[_module];
 
 	for (Function& f : *_module)
-	for (auto it = inst_begin(&f), eIt = inst_end(&f); it != eIt;)
 	{
-		Instruction* insn = &*it;
-		++it;
+		auto fIt = unchanged.find(&f);
+		if (fIt != unchanged.end() && fIt->second == getFingerprint(f))
+		{
+			continue;
+		}
+
+		bool fChanged = false;
+		for (auto it = inst_begin(&f), eIt = inst_end(&f); it != eIt;)
+		{
+			Instruction* insn = &*it;
+			++it;
+
+			fChanged |= inst_opt::optimize(insn);
+		}
 
-		changed |= inst_opt::optimize(insn);
+		if (fChanged)
+		{
+			unchanged.erase(&f);
+		}
+		else
+		{
+			unchanged[&f] = getFingerprint(f);
+		}
+		changed |= fChanged;
 	}
 
 	return changed;
 }
 
+/**
+ * @return Hash of all the instructions in @a f -- their opcodes, types and
+ *         operands. Instruction optimizations look only at these, so if
+ *         fingerprints of the function are the same, optimizations have the
+ *         same result.
+ */
+std::size_t InstructionOptimizer::getFingerprint(llvm::Function& f)
+{
+	std::size_t h = 0;
+	auto combine = [&h](std::size_t v)
+	{
+		h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2);
+	};
+
+	for (auto& i : instructions(&f))
+	{
+		combine(std::hash<const void*>()(&i));
+		combine(i.getOpcode());
+		combine(std::hash<const void*>()(i.getType()));
+		for (auto& op : i.operands())
+		{
+			combine(std::hash<const void*>()(op.get()));
+		}
+	}
+
+	return h;
+}
+
+/**
+ * Forget all the unchanged functions.
+ */
+void InstructionOptimizer::clear()
+{
+	_unchanged.clear();
+}
+
 } // namespace bin2llvmir
 } // namespace retdec
@@ -49,21 +49,26 @@ bool InstructionRdaOptimizer::run()
 {
 	bool changed = false;
 
+	auto& RDA = *ReachingDefinitionsProvider::getRda(_module, _abi, true);
 	for (Function& f : *_module)
 	{
-		changed |= runOnFunction(&f);
+		if (runOnFunction(&f, RDA))
+		{
+			// Now, before addresses of erased instructions are reused.
+			ReachingDefinitionsProvider::invalidate(_module, &f);
+			changed = true;
+		}
 	}
 
 	return changed;
 }
 
-bool InstructionRdaOptimizer::runOnFunction(llvm::Function* f)
+bool InstructionRdaOptimizer::runOnFunction(
+		llvm::Function* f,
+		ReachingDefinitionsAnalysis& RDA)
 {
 	bool changed = false;
 
-	ReachingDefinitionsAnalysis RDA;
-	RDA.runOnFunction(*f, _abi, true);
-
 	std::unordered_set<llvm::Value*> toRemove;
 
 	for (auto it = inst_begin(f), eIt = inst_end(f); it != eIt;)
@@ -195,6 +195,13 @@ retdec::common::Address MainDetection::getFromContext()
 
 	for (auto& ci : tools)
 	{
+		// Tools are sorted from the most certain detection, so the first
+		// match wins and matchers of the less certain tools are not run.
+		if (mainAddr.isDefined())
+		{
+			break;
+		}
+
 		int major = ci.getMajorVersion();
 		int minor = ci.getMinorVersion();
 
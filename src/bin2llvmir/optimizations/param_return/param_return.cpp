@@ -7,6 +7,7 @@
 #include <cassert>
 #include <iomanip>
 #include <limits>
+#include <queue>
 
 #include <llvm/IR/CFG.h>
 #include <llvm/IR/Constants.h>
@@ -15,6 +16,7 @@
 #include <llvm/IR/Instructions.h>
 
 #include "retdec/utils/container.h"
+#include "retdec/utils/parallel.h"
 #include "retdec/utils/string.h"
 #include "retdec/bin2llvmir/optimizations/param_return/filter/filter.h"
 #include "retdec/bin2llvmir/optimizations/param_return/param_return.h"
@@ -59,7 +61,6 @@ bool ParamReturn::runOnModule(Module& m)
 	_dbgf = DebugFormatProvider::getDebugFormat(_module);
 	_lti = LtiProvider::getLti(_module);
 	_demangler = DemanglerProvider::getDemangler(_module);
-	_collector = CollectorProvider::createCollector(_abi, _module, &_RDA);
 
 	return run();
 }
@@ -80,7 +81,6 @@ bool ParamReturn::runOnModuleCustom(
 	_dbgf = dbgf;
 	_lti = lti;
 	_demangler = demangler;
-	_collector = CollectorProvider::createCollector(_abi, _module, &_RDA);
 
 	return run();
 }
@@ -93,7 +93,8 @@ bool ParamReturn::run()
 		return false;
 	}
 
-	_RDA.runOnModule(*_module, _abi);
+	_RDA = ReachingDefinitionsProvider::getRda(_module, _abi);
+	_collector = CollectorProvider::createCollector(_abi, _module, _RDA);
 
 	collectAllCalls();
 //	dumpInfo();
@@ -103,7 +104,10 @@ bool ParamReturn::run()
 //	dumpInfo();
 	applyToIr();
 
-	_RDA.clear();
+	// Signatures of functions and their calls were changed all over the
+	// module.
+	ReachingDefinitionsProvider::invalidate(_module);
+	_RDA = nullptr;
 
 	return false;
 }
@@ -154,17 +158,80 @@ void ParamReturn::collectAllCalls()
 					createDataFlowEntry(calledVal))).first;
 		}
 
-		addDataFromCall(&fIt->second, call);
+		fIt->second.createCallEntry(call);
 	}
+
+	collectUsageData();
+}
+
+/**
+ * Collect definitions' and calls' data of all the entries created by
+ * @c collectAllCalls(). The collector only reads the IR and the reaching
+ * definitions, and every function's entry and the entries of calls located in
+ * it are written by a single task. Therefore, functions are processed in
+ * parallel, on as many threads as the reaching definitions analysis.
+ */
+void ParamReturn::collectUsageData()
+{
+	struct Task
+	{
+		DataFlowEntry* definition = nullptr;
+		std::vector<CallEntry*> calls;
+	};
+	std::vector<Task> tasks;
+	std::map<Function*, std::size_t> fnc2task;
+
+	auto getTask = [&tasks, &fnc2task](Function* f) -> Task&
+	{
+		auto p = fnc2task.emplace(f, tasks.size());
+		if (p.second)
+		{
+			tasks.emplace_back();
+		}
+		return tasks[p.first->second];
+	};
+
+	// Call entries are not created anymore, pointers to them are stable.
+	for (auto& p : _fnc2calls)
+	{
+		auto& de = p.second;
+		if (de.hasDefinition())
+		{
+			getTask(de.getFunction()).definition = &de;
+		}
+		for (auto& ce : de.callEntries())
+		{
+			getTask(ce.getCallInstruction()->getFunction()).calls.push_back(
+					&ce);
+		}
+	}
+
+	parallelFor(
+			tasks.size(),
+			ReachingDefinitionsAnalysis::getThreads(),
+			[this, &tasks](std::size_t i)
+	{
+		auto& t = tasks[i];
+		if (t.definition)
+		{
+			_collector->collectDefArgs(t.definition);
+			_collector->collectDefRets(t.definition);
+		}
+		for (auto* ce : t.calls)
+		{
+			addDataFromCall(ce);
+		}
+	});
 }
 
+/**
+ * Create entry of @a calledValue with data that does not depend on its
+ * usage. The usage data are collected later by @c collectUsageData().
+ */
 DataFlowEntry ParamReturn::createDataFlowEntry(Value* calledValue) const
 {
 	DataFlowEntry dataflow(calledValue);
 
-	_collector->collectDefArgs(&dataflow);
-	_collector->collectDefRets(&dataflow);
-
 	collectExtraData(&dataflow);
 
 	return dataflow;
@@ -536,10 +603,8 @@ CallInst* ParamReturn::getWrapper(Function* fnc) const
 	return nullptr;
 }
 
-void ParamReturn::addDataFromCall(DataFlowEntry *dataflow, CallInst *call) const
+void ParamReturn::addDataFromCall(CallEntry* ce) const
 {
-	CallEntry* ce = dataflow->createCallEntry(call);
-
 	_collector->collectCallArgs(ce);
 
 	// TODO: Use info from collecting return loads.
@@ -923,19 +988,43 @@ void ParamReturn::modifyType(DataFlowEntry& de) const
 	de.setArgs(std::move(args));
 }
 
-void ParamReturn::propagateWrapped() {
+/**
+ * Propagate signatures of wrappers to wrapped functions. A wrapped function
+ * can be a wrapper itself, so its entry is propagated again whenever its
+ * signature changes, until there is nothing to propagate.
+ */
+void ParamReturn::propagateWrapped()
+{
+	std::queue<DataFlowEntry*> worklist;
 	for (auto& p : _fnc2calls)
 	{
-		propagateWrapped(p.second);
+		worklist.push(&p.second);
+	}
+
+	while (!worklist.empty())
+	{
+		auto* de = worklist.front();
+		worklist.pop();
+
+		if (auto* wrapDe = propagateWrapped(*de))
+		{
+			worklist.push(wrapDe);
+		}
 	}
 }
 
-void ParamReturn::propagateWrapped(DataFlowEntry& de) {
+/**
+ * Propagate signature of wrapper @a de to the function it wraps.
+ * @return Entry of the wrapped function if its signature changed,
+ *         @c nullptr otherwise.
+ */
+DataFlowEntry* ParamReturn::propagateWrapped(DataFlowEntry& de)
+{
 	auto* fnc = de.getFunction();
 	auto* wrappedCall = de.getWrappedCall();
 	if (fnc == nullptr || wrappedCall == nullptr)
 	{
-		return;
+		return nullptr;
 	}
 
 	llvm::CallInst* wrappedCall2 = nullptr;
@@ -955,7 +1044,7 @@ void ParamReturn::propagateWrapped(DataFlowEntry& de) {
 	if (wrappedCall != wrappedCall2) {
 		// Something strange. Reset wrapped call and give up.
 		de.setWrappedCall(nullptr);
-		return;
+		return nullptr;
 	}
 	auto* callee = wrappedCall->getCalledFunction();
 	auto fIt = _fnc2calls.find(callee);
@@ -966,12 +1055,17 @@ void ParamReturn::propagateWrapped(DataFlowEntry& de) {
 
 	if (!wrapDe.argTypes().empty()) {
 		// Types have already been supplied.
-		return;
+		return nullptr;
 	}
 
+	bool changed = !de.argTypes().empty()
+			|| wrapDe.getRetType() != de.getRetType();
+
 	wrapDe.setArgTypes(std::vector(de.argTypes()), std::vector(de.argNames()));
 	wrapDe.setRetType(de.getRetType());
 	// dumpInfo(wrapDe);
+
+	return changed && &wrapDe != &de ? &wrapDe : nullptr;
 }
 
 void ParamReturn::applyToIr()
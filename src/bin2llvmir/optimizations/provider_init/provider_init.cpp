@@ -4,12 +4,15 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <future>
 #include <regex>
 
 #include <llvm/Support/CommandLine.h>
 
 #include "retdec/utils/io/log.h"
+#include "retdec/bin2llvmir/analyses/reaching_definitions.h"
 #include "retdec/bin2llvmir/analyses/symbolic_tree.h"
+#include "retdec/bin2llvmir/optimizations/inst_opt/inst_opt_pass.h"
 #include "retdec/bin2llvmir/optimizations/provider_init/provider_init.h"
 #include "retdec/bin2llvmir/providers/abi/abi.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
@@ -20,6 +23,7 @@
 #include "retdec/bin2llvmir/providers/fileimage.h"
 #include "retdec/bin2llvmir/providers/lti.h"
 #include "retdec/bin2llvmir/providers/names.h"
+#include "retdec/bin2llvmir/providers/processed_functions.h"
 #include "retdec/cpdetect/cpdetect.h"
 #include "retdec/utils/string.h"
 #include "retdec/yaracpp/yara_detector.h"
@@ -168,6 +172,18 @@ void ProviderInitialization::setConfig(retdec::config::Config* c)
 	_config = c;
 }
 
+/**
+ * Use input file content @a data of @a size bytes instead of reading the input
+ * file set in the config. The data must outlive the pass run.
+ */
+void ProviderInitialization::setInputData(
+		const std::uint8_t* data,
+		std::size_t size)
+{
+	_inputData = data;
+	_inputDataSize = size;
+}
+
 /**
  * @return Always @c false -- this pass does not modify module.
  */
@@ -181,8 +197,11 @@ bool ProviderInitialization::runOnModule(Module& m)
 	FileImageProvider::clear();
 	LtiProvider::clear();
 	NamesProvider::clear();
+	ProcessedFunctionsProvider::clear();
 	SymbolicTree::clear();
 	CallingConventionProvider::clear();
+	ReachingDefinitionsProvider::clear();
+	InstructionOptimizer::clear();
 
 	// Config.
 	//
@@ -196,13 +215,17 @@ bool ProviderInitialization::runOnModule(Module& m)
 	{
 		throw std::runtime_error("ProviderInitialization: c == nullptr");
 	}
+	ReachingDefinitionsAnalysis::setThreads(
+			c->getConfig().parameters.getRdaThreads());
 
 	// Fileimage.
 	//
-	auto* f = FileImageProvider::addFileImage(
-			&m,
-			c->getConfig().parameters.getInputFile(),
-			c);
+	auto* f = _inputData
+			? FileImageProvider::addFileImage(&m, _inputData, _inputDataSize, c)
+			: FileImageProvider::addFileImage(
+					&m,
+					c->getConfig().parameters.getInputFile(),
+					c);
 	if (f == nullptr)
 	{
 		throw std::runtime_error("ProviderInitialization: f == nullptr");
@@ -266,6 +289,35 @@ bool ProviderInitialization::runOnModule(Module& m)
 		throw std::runtime_error("Unsupported target format and architecture combination");
 	}
 
+	// Analyses of the input file below do not depend on each other, only on
+	// the config set above and on the detected tools. With concurrent init,
+	// they run on their own threads, otherwise they are deferred and run on
+	// this thread when their results are needed. All of them are finished
+	// before decoding. Providers are thread-local, so they are added here.
+	//
+	auto policy = c->getConfig().parameters.isConcurrentInit()
+			? std::launch::async
+			: std::launch::deferred;
+
+	// Relocations are applied lazily, when the image data are read, so the
+	// image must not be read concurrently before all of them are applied.
+	//
+	if (policy == std::launch::async)
+	{
+		f->getImage()->resolveRelocations();
+	}
+
+	// YARA crypto patterns scanning.
+	//
+	yaracpp::YaraDetector yara;
+	auto cryptoScan = std::async(policy, [c, f, &yara]() {
+		for (auto& crypto : c->getConfig().parameters.cryptoPatternPaths)
+		{
+			yara.addRuleFile(crypto);
+		}
+		yara.analyze(f->getFileFormat()->getBytes());
+	});
+
 	// Run cpdetect and set info to config.
 	// TODO: we could probably be using cpdetect results.
 	//
@@ -354,28 +406,19 @@ bool ProviderInitialization::runOnModule(Module& m)
 		c->getConfig().architecture.setIsPic32();
 	}
 
-	// YARA crypto patterns scanning.
+	// These can happen only after tools are detected. Tables of the file
+	// format are loaded on demand, so it must not happen concurrently.
 	//
-	yaracpp::YaraDetector yara;
-	for (auto& crypto : c->getConfig().parameters.cryptoPatternPaths)
-	{
-		yara.addRuleFile(crypto);
-	}
-	yara.analyze(c->getConfig().parameters.getInputFile());
-	for(const auto &rule : yara.getDetectedRules())
-	{
-		common::Pattern p = saveCryptoRule(
-				rule,
-				f->getFileFormat()
-		);
-		c->getConfig().patterns.push_back(p);
-	}
-	// TODO: removeRedundantCryptoRules()
-	// TODO: sortCryptoPatternMatches()
-
-	// This can happen only after tools are detected.
-	//
-	f->initRtti(c);
+	f->getFileFormat()->getImportTable();
+	auto rtti = std::async(policy, [c, f]() {
+		f->initRtti(c);
+	});
+	auto staticCode = std::async(policy, [c, f]() {
+		if (c->getConfig().parameters.isDetectStaticCode())
+		{
+			f->initStaticCode(c);
+		}
+	});
 
 	// ABI.
 	//
@@ -392,16 +435,51 @@ bool ProviderInitialization::runOnModule(Module& m)
 		throw std::runtime_error("ProviderInitialization: d == nullptr");
 	}
 
-	auto* debug = DebugFormatProvider::addDebugFormat(
+	auto ltiLoad = std::async(policy, [&m, c, typeConfig, f]() {
+		return Lti(&m, c, typeConfig, f->getImage());
+	});
+
+	// Symbols are demangled again and again by many passes, demangle them all
+	// at once, in parallel.
+	//
+	std::vector<std::string> symbolNames;
+	for (const auto* t : f->getFileFormat()->getSymbolTables())
+	{
+		for (const auto& s : *t)
+		{
+			symbolNames.push_back(s->getName());
+		}
+	}
+	d->demangleToStrings(
+			symbolNames,
+			c->getConfig().parameters.getRdaThreads());
+
+	DebugFormatProvider::addDebugFormat(
 			&m,
 			f->getImage(),
 			c->getConfig().parameters.getInputPdbFile(),
-			d
+			d,
+			c->getConfig().parameters.getRdaThreads()
 	);
 
-	auto* lti = LtiProvider::addLti(&m, c, typeConfig, f->getImage());
+	auto* lti = LtiProvider::addLti(&m, ltiLoad.get());
+
+	cryptoScan.get();
+	for(const auto &rule : yara.getDetectedRules())
+	{
+		common::Pattern p = saveCryptoRule(
+				rule,
+				f->getFileFormat()
+		);
+		c->getConfig().patterns.push_back(p);
+	}
+	// TODO: removeRedundantCryptoRules()
+	// TODO: sortCryptoPatternMatches()
+
+	NamesProvider::addNames(&m, c, f, d, lti);
 
-	NamesProvider::addNames(&m, c, debug, f, d, lti);
+	rtti.get();
+	staticCode.get();
 
 	AsmInstruction::clear();
 
@@ -4,6 +4,7 @@
 * @copyright (c) 2019 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
 #include <cassert>
 
 #include <llvm/IR/Instruction.h>
@@ -12,6 +13,7 @@
 
 #include "retdec/bin2llvmir/optimizations/register_localization/register_localization.h"
 #include "retdec/bin2llvmir/providers/names.h"
+#include "retdec/bin2llvmir/providers/processed_functions.h"
 #include "retdec/bin2llvmir/utils/debug.h"
 #include "retdec/bin2llvmir/utils/ir_modifier.h"
 #include "retdec/bin2llvmir/utils/llvm.h"
@@ -63,95 +65,139 @@ bool RegisterLocalization::run()
 	{
 		return false;
 	}
-	const auto& regs = _abi->getRegisters();
+
+	_regs.clear();
+	_reg2idx.clear();
+	for (GlobalVariable* reg : _abi->getRegisters())
+	{
+		if (_reg2idx.try_emplace(reg, _regs.size()).second)
+		{
+			_regs.push_back(reg);
+		}
+	}
 
 	bool changed = false;
+	for (Function& f : *_module)
+	{
+		if (ProcessedFunctionsProvider::isUnchanged(_module, &ID, &f))
+		{
+			continue;
+		}
 
-	for (GlobalVariable* reg : regs)
+		changed |= runOnFunction(f);
+		ProcessedFunctionsProvider::setProcessed(_module, &ID, &f);
+	}
+
+	return changed;
+}
+
+/**
+ * Localize all registers used in function @a f.
+ * @return @c True if @a f was modified.
+ */
+bool RegisterLocalization::runOnFunction(llvm::Function& f)
+{
+	if (f.empty() || f.front().empty())
 	{
-		std::map<Function*, AllocaInst*> fnc2alloca;
+		return false;
+	}
 
-		for (auto uIt = reg->user_begin(); uIt != reg->user_end(); )
+	// Register uses are grouped by registers -- allocas are created in the
+	// order of the ABI registers. A constant expression user is localized
+	// through an instruction created from it, the expression is grouped with
+	// its first register.
+	//
+	using Use = std::pair<Instruction*, ConstantExpr*>;
+	std::vector<std::vector<Use>> uses(_regs.size());
+	bool hasUses = false;
+	for (auto& i : instructions(f))
+	{
+		for (auto& op : i.operands())
 		{
-			User* user = *uIt;
-			++uIt;
-
-			if (auto* insn = dyn_cast<Instruction>(user))
+			ConstantExpr* expr = dyn_cast<ConstantExpr>(op);
+			std::size_t idx = getRegisterIndex(op);
+			if (expr)
 			{
-				changed = localize(reg, fnc2alloca, insn);
+				for (auto& eop : expr->operands())
+				{
+					idx = std::min(idx, getRegisterIndex(eop));
+				}
 			}
-			else if (auto* expr = dyn_cast<ConstantExpr>(user))
+			if (idx == _regs.size())
 			{
-				for (auto euIt = expr->user_begin(); euIt != expr->user_end(); )
-				{
-					User* euser = *euIt;
-					++euIt;
+				continue;
+			}
 
-					if (auto* insn = dyn_cast<Instruction>(euser))
-					{
-						auto* einsn = expr->getAsInstruction();
-						einsn->insertBefore(insn);
-
-						if (localize(reg, fnc2alloca, einsn))
-						{
-							insn->replaceUsesOfWith(expr, einsn);
-							changed = true;
-						}
-					}
-				}
+			auto& rUses = uses[idx];
+			if (rUses.empty() || rUses.back() != Use(&i, expr))
+			{
+				rUses.push_back(Use(&i, expr));
+				hasUses = true;
 			}
 		}
 	}
+	if (!hasUses)
+	{
+		return false;
+	}
 
-	return changed;
-}
-
-llvm::AllocaInst* RegisterLocalization::getLocalized(
-		llvm::GlobalVariable* reg,
-		llvm::Function* fnc,
-		std::map<llvm::Function*, llvm::AllocaInst*>& fnc2alloca)
-{
-		auto fIt = fnc2alloca.find(fnc);
-		if (fIt != fnc2alloca.end())
-		{
-			return fIt->second;
-		}
-		else if (!fnc->empty() && !fnc->front().empty())
-		{
-			auto* a = new AllocaInst(
-					reg->getValueType(),
-					reg->getAddressSpace(),
-					nullptr,
-					reg->getName(),
-					&fnc->front().front());
-			fnc2alloca.emplace(fnc, a);
-			return a;
-		}
-		else
+	for (std::size_t idx = 0; idx < _regs.size(); ++idx)
+	{
+		GlobalVariable* reg = _regs[idx];
+		auto& rUses = uses[idx];
+		if (rUses.empty())
 		{
-			// Should not really happen.
-			return nullptr;
+			continue;
 		}
-}
 
-bool RegisterLocalization::localize(
-		llvm::GlobalVariable* reg,
-		std::map<llvm::Function*, llvm::AllocaInst*>& fnc2alloca,
-		llvm::Instruction* insn)
-{
-	AllocaInst* localized = getLocalized(
-			reg,
-			insn->getFunction(),
-			fnc2alloca);
+		auto* localized = new AllocaInst(
+				reg->getValueType(),
+				reg->getAddressSpace(),
+				nullptr,
+				reg->getName(),
+				&f.front().front());
 
-	if (localized == nullptr)
-	{
-		return false;
+		for (std::size_t u = 0; u < rUses.size(); ++u)
+		{
+			Instruction* insn = rUses[u].first;
+			ConstantExpr* expr = rUses[u].second;
+			if (expr == nullptr)
+			{
+				insn->replaceUsesOfWith(reg, localized);
+			}
+			else if (is_contained(insn->operands(), expr))
+			{
+				auto* einsn = expr->getAsInstruction();
+				einsn->insertBefore(insn);
+				einsn->replaceUsesOfWith(reg, localized);
+				insn->replaceUsesOfWith(expr, einsn);
+
+				// Other registers used by the expression.
+				for (auto& eop : einsn->operands())
+				{
+					auto eIdx = getRegisterIndex(eop);
+					if (eIdx < _regs.size())
+					{
+						uses[eIdx].push_back(Use(einsn, nullptr));
+					}
+				}
+			}
+		}
 	}
 
-	insn->replaceUsesOfWith(reg, localized);
 	return true;
 }
 
+/**
+ * @return Index of register @a val in @c _regs, or @c _regs.size() if it is
+ *         not a register.
+ */
+std::size_t RegisterLocalization::getRegisterIndex(llvm::Value* val) const
+{
+	auto* gv = dyn_cast<GlobalVariable>(val);
+	auto it = gv ? _reg2idx.find(gv) : _reg2idx.end();
+	return it != _reg2idx.end() ? it->second : _regs.size();
+}
+
 } // namespace bin2llvmir
 } // namespace retdec
@@ -290,6 +290,15 @@ void SimpleTypesAnalysis::setGlobalConstants()
 
 void SimpleTypesAnalysis::buildEqSets(Module& M)
 {
+	// Nearly every global, argument and instruction ends up in some set,
+	// reserving the index up front avoids rehashing it while it grows.
+	std::size_t values = M.global_size();
+	for (auto& F : M)
+	{
+		values += F.arg_size() + F.getInstructionCount();
+	}
+	processedObjs.reserve(values);
+
 	for (auto& glob : M.getGlobalList())
 	{
 		if (config->getConfig().globals.getObjectByName(glob.getName()) == nullptr)
@@ -364,7 +373,7 @@ void SimpleTypesAnalysis::processValue(std::queue<Value*>& toProcess, EqSet& eqS
 		auto current = toProcess.front();
 		toProcess.pop();
 
-		if (processedObjs.find(current) != processedObjs.end())
+		if (!processedObjs.emplace(current, &eqSet).second)
 		{
 			continue;
 		}
@@ -372,7 +381,6 @@ void SimpleTypesAnalysis::processValue(std::queue<Value*>& toProcess, EqSet& eqS
 		LOG << "\t[CURRENT]: " << llvmObjToString(current) << std::endl;
 
 		eqSet.insert(config, current);
-		processedObjs.insert({current, &eqSet});
 
 		for (auto uIt = current->user_begin(); uIt != current->user_end(); ++uIt)
 		{
@@ -741,10 +749,12 @@ void EqSetContainer::apply(
 		FileImage* objf,
 		std::unordered_set<llvm::Instruction*>& instToErase)
 {
+	IrModifier irModif(module, config);
 	for (auto& eq : eqSets)
 	{
-		eq.apply(module, config, objf, instToErase);
+		eq.apply(config, irModif);
 	}
+	irModif.applyObjectTypeChanges(objf, &instToErase);
 }
 
 std::ostream& operator<<(std::ostream& out, const EqSetContainer& eqs)
@@ -776,7 +786,7 @@ void EqSet::insert(Config* config, llvm::Value* v, eSourcePriority p)
 
 	if (p != eSourcePriority::PRIORITY_NONE)
 	{
-		valSet.insert( {v,p} );
+		valSet.emplace_back(v, p);
 	}
 	else
 	{
@@ -828,7 +838,7 @@ void EqSet::insert(Config* config, llvm::Value* v, eSourcePriority p)
 			}
 		}
 
-		valSet.insert( {v,p} );
+		valSet.emplace_back(v, p);
 	}
 }
 
@@ -1160,13 +1170,15 @@ void EqSet::propagate(llvm::Module* module)
 	{
 		Type* valueType = vs.getTypeForPropagation();
 
-		if (vs.priority < masterType.priority)
+		if (vs.priority < masterType.priority
+				|| (vs.priority == masterType.priority
+				&& valueType == masterType.type))
 		{
 			continue;
 		}
 		else if (vs.priority == masterType.priority)
 		{
-			if (valueType != masterType.type && masterType.priority != eSourcePriority::PRIORITY_NONE)
+			if (masterType.priority != eSourcePriority::PRIORITY_NONE)
 			{
 				LOG << "[WARNING] same priority types differ: "
 					<< llvmObjToString(valueType) << " vs. "
@@ -1187,13 +1199,15 @@ void EqSet::propagate(llvm::Module* module)
 	}
 	for (auto& ts : typeSet)
 	{
-		if (ts.priority < masterType.priority)
+		if (ts.priority < masterType.priority
+				|| (ts.priority == masterType.priority
+				&& ts.type == masterType.type))
 		{
 			continue;
 		}
 		else if (ts.priority == masterType.priority)
 		{
-			if (ts.type != masterType.type && masterType.priority != eSourcePriority::PRIORITY_NONE)
+			if (masterType.priority != eSourcePriority::PRIORITY_NONE)
 			{
 				LOG << "[WARNING] same priority types differ: "
 					<< llvmObjToString(ts.type) << " vs. "
@@ -1217,11 +1231,11 @@ void EqSet::propagate(llvm::Module* module)
 	LOG << "\npropagate END   " << id << " =============================\n";
 }
 
-void EqSet::apply(
-		llvm::Module* module,
-		Config* config,
-		FileImage* objf,
-		std::unordered_set<llvm::Instruction*>& instToErase)
+/**
+ * Schedule type changes of all the objects in this set to the master type.
+ * They are applied by @a irModif together with changes of the other sets.
+ */
+void EqSet::apply(Config* config, IrModifier& irModif)
 {
 	if (valSet.empty())
 		return;
@@ -1230,7 +1244,6 @@ void EqSet::apply(
 
 	auto &conf = config->getConfig();
 
-	IrModifier irModif(module, config);
 	for (auto& vs : valSet)
 	{
 		if (!(isa<AllocaInst>(vs.value) || isa<GlobalVariable>(vs.value) || isa<Argument>(vs.value)))
@@ -1263,7 +1276,7 @@ void EqSet::apply(
 
 		LOG << "\t" << vs << "  ==>  " << llvmObjToString(masterType.type) << std::endl;
 
-		irModif.changeObjectType(objf, vs.value, masterType.type, nullptr, &instToErase);
+		irModif.scheduleObjectTypeChange(vs.value, masterType.type);
 	}
 
 	LOG << "\napply END   " << id << " =============================\n";
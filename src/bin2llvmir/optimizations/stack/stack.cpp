@@ -16,6 +16,7 @@
 #include "retdec/bin2llvmir/analyses/reaching_definitions.h"
 #include "retdec/bin2llvmir/optimizations/stack/stack.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
+#include "retdec/bin2llvmir/providers/processed_functions.h"
 #include "retdec/bin2llvmir/utils/ir_modifier.h"
 #define debug_enabled false
 #include "retdec/bin2llvmir/utils/llvm.h"
@@ -69,63 +70,90 @@ bool StackAnalysis::run()
 		return false;
 	}
 
-	ReachingDefinitionsAnalysis RDA;
-	RDA.runOnModule(*_module, _abi);
+	auto& RDA = *ReachingDefinitionsProvider::getRda(_module, _abi);
 
+	std::vector<Function*> processed;
 	for (auto& f : *_module)
 	{
-		std::map<Value*, Value*> val2val;
-		for (inst_iterator I = inst_begin(f), E = inst_end(f); I != E;)
+		if (ProcessedFunctionsProvider::isUnchanged(_module, &ID, &f))
 		{
-			Instruction& i = *I;
-			++I;
+			continue;
+		}
 
-			if (StoreInst *store = dyn_cast<StoreInst>(&i))
-			{
-				if (AsmInstruction::isLlvmToAsmInstruction(store))
-				{
-					continue;
-				}
+		runOnFunction(RDA, f);
+		processed.push_back(&f);
+	}
 
-				handleInstruction(
-						RDA,
-						store,
-						store->getValueOperand(),
-						store->getValueOperand()->getType(),
-						val2val);
+	IrModifier::eraseUnusedInstructionsRecursive(_toRemove);
+	for (auto* f : _modified)
+	{
+		ReachingDefinitionsProvider::invalidate(_module, f);
+	}
+	_modified.clear();
 
-				if (isa<GlobalVariable>(store->getPointerOperand()))
-				{
-					continue;
-				}
+	for (auto* f : processed)
+	{
+		ProcessedFunctionsProvider::setProcessed(_module, &ID, f);
+	}
+
+	return false;
+}
+
+/**
+ * Replace stack accesses in function @a f. Replaced values are only queued
+ * in @c _toRemove.
+ */
+void StackAnalysis::runOnFunction(
+		ReachingDefinitionsAnalysis& RDA,
+		llvm::Function& f)
+{
+	std::map<Value*, Value*> val2val;
+	for (inst_iterator I = inst_begin(f), E = inst_end(f); I != E;)
+	{
+		Instruction& i = *I;
+		++I;
 
-				handleInstruction(
-						RDA,
-						store,
-						store->getPointerOperand(),
-						store->getValueOperand()->getType(),
-						val2val);
+		if (StoreInst *store = dyn_cast<StoreInst>(&i))
+		{
+			if (AsmInstruction::isLlvmToAsmInstruction(store))
+			{
+				continue;
 			}
-			else if (LoadInst* load = dyn_cast<LoadInst>(&i))
+
+			handleInstruction(
+					RDA,
+					store,
+					store->getValueOperand(),
+					store->getValueOperand()->getType(),
+					val2val);
+
+			if (isa<GlobalVariable>(store->getPointerOperand()))
 			{
-				if (isa<GlobalVariable>(load->getPointerOperand()))
-				{
-					continue;
-				}
+				continue;
+			}
 
-				handleInstruction(
-						RDA,
-						load,
-						load->getPointerOperand(),
-						load->getType(),
-						val2val);
+			handleInstruction(
+					RDA,
+					store,
+					store->getPointerOperand(),
+					store->getValueOperand()->getType(),
+					val2val);
+		}
+		else if (LoadInst* load = dyn_cast<LoadInst>(&i))
+		{
+			if (isa<GlobalVariable>(load->getPointerOperand()))
+			{
+				continue;
 			}
+
+			handleInstruction(
+					RDA,
+					load,
+					load->getPointerOperand(),
+					load->getType(),
+					val2val);
 		}
 	}
-
-	IrModifier::eraseUnusedInstructionsRecursive(_toRemove);
-
-	return false;
 }
 
 void StackAnalysis::handleInstruction(
@@ -215,6 +243,8 @@ void StackAnalysis::handleInstruction(
 		realName = configSv->getName();
 	}
 
+	_modified.insert(inst->getFunction());
+
 	IrModifier irModif(_module, _config);
 	auto p = irModif.getStackVariable(
 			inst->getFunction(),
@@ -10,13 +10,15 @@
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 
 using namespace llvm;
+using retdec::bin2llvmir::SyscallEntry;
+using retdec::bin2llvmir::SyscallTable;
 
 /**
  * http://lxr.free-electrons.com/source/arch/arm/include/asm/unistd.h?v=3.1;a%3Darm
  * https://w3challs.com/syscalls/?arch=arm_strong
  * https://w3challs.com/syscalls/?arch=arm_thumb
  */
-std::map<uint64_t, std::string> syscalls_arm_linux_32 =
+constexpr SyscallEntry syscalls_arm_linux_32[] =
 {
 	{0, "restart_syscall"},
 	{1, "exit"},
@@ -396,6 +398,9 @@ std::map<uint64_t, std::string> syscalls_arm_linux_32 =
 	{374, "sendmmsg"},
 	{375, "setns"}
 };
+static_assert(
+		SyscallTable(syscalls_arm_linux_32).isSorted(),
+		"syscall table must be sorted by codes");
 
 namespace retdec {
 namespace bin2llvmir {
@@ -412,14 +417,14 @@ bool SyscallFixer::runArm()
 
 bool SyscallFixer::runArm_linux_32()
 {
+	collectSites(ARM_INS_SVC);
+
 	bool changed = false;
-	for (Function& F : *_module)
+	for (auto& ai : _sites)
 	{
-		for (auto ai = AsmInstruction(&F); ai.isValid(); ai = ai.getNext())
-		{
-			changed |= runArm_linux_32(ai);
-		}
+		changed |= runArm_linux_32(ai);
 	}
+	_sites.clear();
 	return changed;
 }
 
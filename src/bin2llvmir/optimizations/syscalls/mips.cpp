@@ -10,6 +10,8 @@
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 
 using namespace llvm;
+using retdec::bin2llvmir::SyscallEntry;
+using retdec::bin2llvmir::SyscallTable;
 
 /*
  * Fill map from syscall codes to standard functions according to:
@@ -21,7 +23,7 @@ using namespace llvm;
  * https://w3challs.com/syscalls/?arch=mips_n32
  * https://w3challs.com/syscalls/?arch=mips_n64
  */
-std::map<uint64_t, std::string> syscalls_mips_linux =
+constexpr SyscallEntry syscalls_mips_linux[] =
 {
 	{4001, "exit"},
 	{4002, "fork"},
@@ -235,6 +237,9 @@ std::map<uint64_t, std::string> syscalls_mips_linux =
 
 	{4264, "sys_clock_getres"},
 };
+static_assert(
+		SyscallTable(syscalls_mips_linux).isSorted(),
+		"syscall table must be sorted by codes");
 
 namespace retdec {
 namespace bin2llvmir {
@@ -251,14 +256,14 @@ bool SyscallFixer::runMips()
 
 bool SyscallFixer::runMips_linux()
 {
+	collectSites(MIPS_INS_SYSCALL);
+
 	bool changed = false;
-	for (Function& F : *_module)
+	for (auto& ai : _sites)
 	{
-		for (auto ai = AsmInstruction(&F); ai.isValid(); ai = ai.getNext())
-		{
-			changed |= runMips_linux(ai);
-		}
+		changed |= runMips_linux(ai);
 	}
+	_sites.clear();
 	return changed;
 }
 
@@ -4,6 +4,8 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+
 #include "retdec/bin2llvmir/optimizations/syscalls/syscalls.h"
 #include "retdec/bin2llvmir/utils/llvm.h"
 #include "retdec/bin2llvmir/utils/ir_modifier.h"
@@ -13,6 +15,20 @@ using namespace llvm;
 namespace retdec {
 namespace bin2llvmir {
 
+/**
+ * @return Name of the function called by syscall @a code, or @c nullptr if
+ *         there is no such syscall in the table.
+ */
+const char* SyscallTable::find(std::uint64_t code) const
+{
+	auto* it = std::lower_bound(
+			_begin,
+			_end,
+			code,
+			[](const SyscallEntry& e, std::uint64_t c) { return e.code < c; });
+	return it != _end && it->code == code ? it->name : nullptr;
+}
+
 char SyscallFixer::ID = 0;
 
 static RegisterPass<SyscallFixer> X(
@@ -60,6 +76,9 @@ bool SyscallFixer::run()
 		return false;
 	}
 
+	_sites.clear();
+	_code2fnc.clear();
+
 	if (_config->getConfig().architecture.isMipsOrPic32())
 	{
 		return runMips();
@@ -82,20 +101,49 @@ bool SyscallFixer::run()
 	}
 }
 
-bool SyscallFixer::transform(
-		AsmInstruction ai,
+/**
+ * Collect all instructions with Capstone ID @a insnId into @c _sites.
+ */
+void SyscallFixer::collectSites(unsigned insnId)
+{
+	_sites.clear();
+	for (Function& F : *_module)
+	{
+		for (auto ai = AsmInstruction(&F); ai.isValid(); ai = ai.getNext())
+		{
+			auto* insn = ai.getCapstoneInsn();
+			if (insn && insn->id == insnId)
+			{
+				_sites.push_back(ai);
+			}
+		}
+	}
+}
+
+/**
+ * @return Function called by syscall @a code from @a table, or @c nullptr if
+ *         there is no such syscall, or it can not be called. Functions are
+ *         resolved only for the first site of every code.
+ */
+llvm::Function* SyscallFixer::getSyscallFunction(
 		uint64_t code,
-		const std::map<uint64_t, std::string>& codeMap)
+		const SyscallTable& table)
 {
+	auto cIt = _code2fnc.find(code);
+	if (cIt != _code2fnc.end())
+	{
+		return cIt->second;
+	}
+	Function*& ret = _code2fnc[code];
+
 	// Find syscall name.
 	//
-	auto fit = codeMap.find(code);
-	if (fit == codeMap.end())
+	const char* callName = table.find(code);
+	if (callName == nullptr)
 	{
 		LOG << "\tno syscall entry for code" << std::endl;
-		return false;
+		return ret;
 	}
-	std::string callName = fit->second;
 	LOG << "\tfound in syscall map: " << callName << std::endl;
 
 	// Find syscall function.
@@ -108,17 +156,32 @@ bool SyscallFixer::transform(
 	if (lf == nullptr)
 	{
 		LOG << "\tno function for name" << std::endl;
-		return false;
+		return ret;
 	}
 	for (Argument& a : lf->args())
 	{
 		if (!a.getType()->isFirstClassType())
 		{
 			LOG << "\tnone first class type argument" << std::endl;
-			return false;
+			return ret;
 		}
 	}
 
+	ret = lf;
+	return ret;
+}
+
+bool SyscallFixer::transform(
+		AsmInstruction ai,
+		uint64_t code,
+		const SyscallTable& table)
+{
+	Function* lf = getSyscallFunction(code, table);
+	if (lf == nullptr)
+	{
+		return false;
+	}
+
 	if (ai.eraseInstructions())
 	{
 		LOG << "\tasm instruction cannot be erased" << std::endl;
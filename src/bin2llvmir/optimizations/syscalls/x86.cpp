@@ -10,6 +10,8 @@
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 
 using namespace llvm;
+using retdec::bin2llvmir::SyscallEntry;
+using retdec::bin2llvmir::SyscallTable;
 
 /**
  * From /usr/include/asm/unistd_32.h
@@ -19,7 +21,7 @@ using namespace llvm;
  * TODO: windows, 64-bit, Itanium, etc.:
  * https://w3challs.com/syscalls
  */
-std::map<uint64_t, std::string> syscalls_x86_linux_32 =
+constexpr SyscallEntry syscalls_x86_linux_32[] =
 {
 	{0, "restart_syscall"},
 	{1, "exit"},
@@ -398,11 +400,14 @@ std::map<uint64_t, std::string> syscalls_x86_linux_32 =
 	{378, "preadv2"},
 	{379, "pwritev2"}
 };
+static_assert(
+		SyscallTable(syscalls_x86_linux_32).isSorted(),
+		"syscall table must be sorted by codes");
 
 /**
  * From: /usr/include/linux/net.h
  */
-std::map<uint64_t, std::string> x86SocketSyscalls =
+constexpr SyscallEntry x86SocketSyscalls[] =
 {
 	{1, "socket"}, // SYS_SOCKET -- sys_socket(2)
 	{2, "bind"}, // SYS_BIND -- sys_bind(2)
@@ -425,6 +430,9 @@ std::map<uint64_t, std::string> x86SocketSyscalls =
 	{19, "recvmmsg"}, // SYS_RECVMMSG -- sys_recvmmsg(2)
 	{20, "sendmmsg"} // SYS_SENDMMSG -- sys_sendmmsg(2)
 };
+static_assert(
+		SyscallTable(x86SocketSyscalls).isSorted(),
+		"syscall table must be sorted by codes");
 
 namespace retdec {
 namespace bin2llvmir {
@@ -441,14 +449,14 @@ bool SyscallFixer::runX86()
 
 bool SyscallFixer::runX86_linux_32()
 {
+	collectSites(X86_INS_INT);
+
 	bool changed = false;
-	for (Function& F : *_module)
+	for (auto& ai : _sites)
 	{
-		for (auto ai = AsmInstruction(&F); ai.isValid(); ai = ai.getNext())
-		{
-			changed |= runX86_linux_32(ai);
-		}
+		changed |= runX86_linux_32(ai);
 	}
+	_sites.clear();
 	return changed;
 }
 
@@ -10,6 +10,7 @@
 
 #include "retdec/bin2llvmir/optimizations/writer_bc/writer_bc.h"
 #include "retdec/bin2llvmir/providers/config.h"
+#include "retdec/bin2llvmir/utils/async_writers.h"
 
 using namespace llvm;
 
@@ -66,6 +67,20 @@ bool BitcodeWriter::runOnModule(Module& M)
 		return false;
 	}
 
+	// Bitcode is generated here, only the file is written on a background
+	// thread.
+	if (c->getConfig().parameters.isAsyncIrWriters())
+	{
+		auto bitcode = AsyncWriters::serialize(M);
+		AsyncWriters::start([bitcode, out]()
+		{
+			std::unique_ptr<ToolOutputFile> bcOut = createBitcodeOutputFile(out);
+			bcOut->os() << *bitcode;
+			bcOut->keep();
+		});
+		return false;
+	}
+
 	std::unique_ptr<ToolOutputFile> bcOut = createBitcodeOutputFile(out);
 	raw_ostream* bcOs = &bcOut->os();
 	bool ShouldPreserveUseListOrder = true;
@@ -10,21 +10,119 @@
 #include <iomanip>
 #include <sstream>
 
+#ifdef RETDEC_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/Instructions.h>
 
+#include "retdec/utils/io/log.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/time.h"
 #include "retdec/bin2llvmir/optimizations/writer_dsm/writer_dsm.h"
 
 using namespace retdec::common;
 using namespace retdec::utils;
+using namespace retdec::utils::io;
 
 #define debug_enabled false
 
 namespace retdec {
 namespace bin2llvmir {
 
+namespace {
+
+#ifdef RETDEC_HAVE_ZLIB
+
+/**
+ * Stream buffer compressing everything written to it into gzip format and
+ * writing it to the underlying stream. The compressed data are complete only
+ * after @c finish().
+ */
+class GzipStreamBuf : public std::streambuf
+{
+	public:
+		explicit GzipStreamBuf(std::ostream& out) :
+				_out(out)
+		{
+			_ok = deflateInit2(
+					&_zs,
+					Z_DEFAULT_COMPRESSION,
+					Z_DEFLATED,
+					15 + 16, // Maximal window with a gzip header.
+					8,
+					Z_DEFAULT_STRATEGY) == Z_OK;
+		}
+
+		~GzipStreamBuf() override
+		{
+			finish();
+		}
+
+		bool finish()
+		{
+			if (_ok && !_finished)
+			{
+				_finished = true;
+				_ok = deflateChunk(nullptr, 0, Z_FINISH);
+				deflateEnd(&_zs);
+			}
+			return _ok && _out.good();
+		}
+
+	protected:
+		std::streamsize xsputn(const char* s, std::streamsize n) override
+		{
+			return deflateChunk(s, n, Z_NO_FLUSH) ? n : 0;
+		}
+
+		int_type overflow(int_type c) override
+		{
+			if (traits_type::eq_int_type(c, traits_type::eof()))
+			{
+				return traits_type::not_eof(c);
+			}
+			char ch = traits_type::to_char_type(c);
+			return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+		}
+
+	private:
+		bool deflateChunk(const char* data, std::size_t size, int flush)
+		{
+			if (!_ok || (_finished && flush != Z_FINISH))
+			{
+				return false;
+			}
+
+			_zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+			_zs.avail_in = static_cast<uInt>(size);
+			do
+			{
+				_zs.next_out = reinterpret_cast<Bytef*>(_chunk);
+				_zs.avail_out = sizeof(_chunk);
+				if (deflate(&_zs, flush) == Z_STREAM_ERROR)
+				{
+					return false;
+				}
+				_out.write(_chunk, sizeof(_chunk) - _zs.avail_out);
+			} while (_zs.avail_out == 0);
+
+			return true;
+		}
+
+	private:
+		std::ostream& _out;
+		z_stream _zs = {};
+		bool _ok = false;
+		bool _finished = false;
+		char _chunk[1 << 16];
+};
+
+#endif
+
+} // anonymous namespace
+
 char DsmWriter::ID = 0;
 
 static llvm::RegisterPass<DsmWriter> X(
@@ -55,20 +153,38 @@ bool DsmWriter::runOnModule(llvm::Module& m)
 	}
 	_abi = AbiProvider::getAbi(_module);
 
-	std::string dsmOut = _config->getConfig().parameters.getOutputAsmFile();
+	auto& params = _config->getConfig().parameters;
+	std::string dsmOut = params.getOutputAsmFile();
 	if (dsmOut.empty())
 	{
 		return false;
 	}
 
-	std::ofstream outFile(dsmOut, std::ofstream::out);
+	std::ofstream outFile(dsmOut, std::ofstream::out | std::ofstream::binary);
 	assert(outFile.is_open() && "Error in opening output dsm file");
 	if (!outFile.is_open())
 	{
 		return false;
 	}
 
-	run(outFile);
+	if (params.isCompressOutputAsm())
+	{
+#ifdef RETDEC_HAVE_ZLIB
+		GzipStreamBuf gzBuf(outFile);
+		std::ostream gzOut(&gzBuf);
+		run(gzOut);
+		gzBuf.finish();
+#else
+		Log::error() << Log::Warning
+				<< "DSM compression is not supported by this build, "
+				<< "writing uncompressed " << dsmOut << std::endl;
+		run(outFile);
+#endif
+	}
+	else
+	{
+		run(outFile);
+	}
 	outFile.close();
 
 	return false;
@@ -93,6 +209,11 @@ bool DsmWriter::runOnModuleCustom(
 	return false;
 }
 
+/**
+ * The disassembly is generated into one reused buffer, which is streamed to
+ * @a ret after every function and whenever it grows over a fixed size. The
+ * whole listing is never kept in memory.
+ */
 void DsmWriter::run(std::ostream& ret)
 {
 	if (_config == nullptr || _objf == nullptr || _abi == nullptr)
@@ -100,34 +221,46 @@ void DsmWriter::run(std::ostream& ret)
 		return;
 	}
 
+	_out = &ret;
+	_buffer.clear();
+	_buffer.reserve(FLUSH_SIZE);
+
 	findLongestAddress();
 	findLongestInstruction();
-	generateHeader(ret);
-	generateCode(ret);
-	generateData(ret);
+	generateHeader();
+	generateCode();
+	generateData();
+	flush();
+
+	_out = nullptr;
+	std::string().swap(_buffer);
+	std::vector<std::uint64_t>().swap(_bytes);
 }
 
-void DsmWriter::generateHeader(std::ostream& ret)
+void DsmWriter::generateHeader()
 {
-	ret << ";;\n";
-	ret << ";; This file was generated by the Retargetable Decompiler\n";
-	ret << ";; Website: https://retdec.com\n";
-	ret << ";;\n";
-	ret << ";; Decompilation date: "
-	    << retdec::utils::getCurrentDate() << " "
-	    << retdec::utils::getCurrentTime() << "\n";
-	ret << ";; Architecture: "
-	    << _config->getConfig().architecture.getName() << "\n";
-	ret << ";;\n";
+	_buffer += ";;\n";
+	_buffer += ";; This file was generated by the Retargetable Decompiler\n";
+	_buffer += ";; Website: https://retdec.com\n";
+	_buffer += ";;\n";
+	_buffer += ";; Decompilation date: ";
+	_buffer += retdec::utils::getCurrentDate();
+	_buffer += " ";
+	_buffer += retdec::utils::getCurrentTime();
+	_buffer += "\n";
+	_buffer += ";; Architecture: ";
+	_buffer += _config->getConfig().architecture.getName();
+	_buffer += "\n";
+	_buffer += ";;\n";
 }
 
-void DsmWriter::generateCode(std::ostream& ret)
+void DsmWriter::generateCode()
 {
-	ret << "\n";
-	ret << ";;\n";
-	ret << ";; Code Segment" << "\n";
-	ret << ";;\n";
-	ret << "\n";
+	_buffer += "\n";
+	_buffer += ";;\n";
+	_buffer += ";; Code Segment\n";
+	_buffer += ";;\n";
+	_buffer += "\n";
 
 	for (auto& f : _config->getConfig().functions)
 	{
@@ -146,15 +279,15 @@ void DsmWriter::generateCode(std::ostream& ret)
 			continue;
 		}
 
-		generateCodeSeg(seg.get(), ret);
+		generateCodeSeg(seg.get());
 	}
 }
 
-void DsmWriter::generateCodeSeg(
-		const retdec::loader::Segment* seg,
-		std::ostream& ret)
+void DsmWriter::generateCodeSeg(const retdec::loader::Segment* seg)
 {
-	ret << "; section: " << seg->getName() << "\n";
+	_buffer += "; section: ";
+	_buffer += seg->getName();
+	_buffer += "\n";
 
 	Address addr;
 	for (addr = seg->getAddress(); addr < seg->getEndAddress(); )
@@ -163,57 +296,58 @@ void DsmWriter::generateCodeSeg(
 		auto* f = fIt != _addr2fnc.end() ? fIt->second : nullptr;
 		if (f)
 		{
-			generateFunction(f, ret);
+			generateFunction(f);
 			addr = f->getEnd() > addr ? f->getEnd() : Address(addr + 1);
 			continue;
 		}
 
-		Address nextFncAddr = addr;
-		while (nextFncAddr < seg->getEndAddress())
+		Address nextFncAddr = seg->getEndAddress();
+		auto nextIt = _addr2fnc.lower_bound(addr);
+		if (nextIt != _addr2fnc.end() && nextIt->first < nextFncAddr)
 		{
-			if (_addr2fnc.count(nextFncAddr))
-			{
-				break;
-			}
-			++nextFncAddr;
+			nextFncAddr = nextIt->first;
 		}
 
 		Address last = nextFncAddr;
-		ret << "; data inside code section at "
-				<< addr.toHexPrefixString() << " -- "
-				<< last.toHexPrefixString() << "\n";
-		generateDataRange(addr, nextFncAddr, ret);
+		_buffer += "; data inside code section at ";
+		_buffer += addr.toHexPrefixString();
+		_buffer += " -- ";
+		_buffer += last.toHexPrefixString();
+		_buffer += "\n";
+		generateDataRange(addr, nextFncAddr);
 		addr = nextFncAddr;
 	}
 }
 
-void DsmWriter::generateFunction(
-		const retdec::common::Function* fnc,
-		std::ostream& ret)
+void DsmWriter::generateFunction(const retdec::common::Function* fnc)
 {
-	ret << ";";
+	_buffer += ";";
 
 	if (fnc->isStaticallyLinked())
 	{
-		ret << " statically linked";
+		_buffer += " statically linked";
 	}
 	else if (fnc->isDynamicallyLinked())
 	{
-		ret << " dynamically linked";
+		_buffer += " dynamically linked";
 	}
 	else if (fnc->isSyscall())
 	{
-		ret << " system-call";
+		_buffer += " system-call";
 	}
 	else if (fnc->isIdiom())
 	{
 		assert(false && "idiom function should not have valid address");
-		ret << " instruction-idiom";
+		_buffer += " instruction-idiom";
 	}
 
-	ret << " function: " << getFunctionName(fnc) << " at "
-			<< fnc->getStart().toHexPrefixString()
-			<< " -- " << fnc->getEnd().toHexPrefixString() << "\n";
+	_buffer += " function: ";
+	_buffer += getFunctionName(fnc);
+	_buffer += " at ";
+	_buffer += fnc->getStart().toHexPrefixString();
+	_buffer += " -- ";
+	_buffer += fnc->getEnd().toHexPrefixString();
+	_buffer += "\n";
 
 	if (!fnc->isDecompilerDefined() && !fnc->isUserDefined())
 	{
@@ -223,64 +357,72 @@ void DsmWriter::generateFunction(
 	auto ai = AsmInstruction(_module, fnc->getStart());
 	while (ai.isValid())
 	{
-		generateInstruction(ai, ret);
+		generateInstruction(ai);
 
 		auto next = ai.getNext();
 		if (next.isValid() && ai.getEndAddress() < next.getAddress())
 		{
-			ret << "; data inside code section at "
-					<< ai.getEndAddress().toHexPrefixString()
-					<< " -- "
-					<< next.getAddress().toHexPrefixString() << "\n";
-			generateDataRange(ai.getEndAddress(), next.getAddress(), ret);
+			_buffer += "; data inside code section at ";
+			_buffer += ai.getEndAddress().toHexPrefixString();
+			_buffer += " -- ";
+			_buffer += next.getAddress().toHexPrefixString();
+			_buffer += "\n";
+			generateDataRange(ai.getEndAddress(), next.getAddress());
 		}
 		else if (next.isInvalid() && ai.getEndAddress() < fnc->getEnd())
 		{
 			Address end = fnc->getEnd() + 1;
-			ret << "; data inside code section at "
-					<< ai.getEndAddress().toHexPrefixString()
-					<< " -- " << end.toHexPrefixString() << "\n";
-			generateDataRange(ai.getEndAddress(), end, ret);
+			_buffer += "; data inside code section at ";
+			_buffer += ai.getEndAddress().toHexPrefixString();
+			_buffer += " -- ";
+			_buffer += end.toHexPrefixString();
+			_buffer += "\n";
+			generateDataRange(ai.getEndAddress(), end);
 		}
 
 		ai = next;
 	}
+
+	flush();
 }
 
-void DsmWriter::getAsmInstructionHex(AsmInstruction& ai, std::ostream& ret)
+void DsmWriter::getAsmInstructionHex(AsmInstruction& ai)
 {
 	std::size_t longestHexa = _longestInst * 3 - 1;
 	const std::size_t aiHexa = ai.getByteSize() * 3 - 1;
 
-	std::vector<std::uint64_t> bytes;
-	if (_objf->getImage()->get1ByteArray(ai.getAddress(), bytes, ai.getByteSize()))
+	_bytes.clear();
+	if (_objf->getImage()->get1ByteArray(ai.getAddress(), _bytes, ai.getByteSize()))
 	{
-		for (size_t i = 0; i < bytes.size(); ++i)
+		for (size_t i = 0; i < _bytes.size(); ++i)
 		{
-			ret << (i == 0 ? "" : " ") << std::setw(2) << std::setfill('0')
-					<< std::hex << bytes[i];
+			if (i != 0)
+			{
+				_buffer += ' ';
+			}
+			appendHex(_bytes[i]);
 		}
 	}
 	else
 	{
 		for (size_t i = 0; i < ai.getByteSize(); ++i)
 		{
-			ret << (i == 0 ? "??" : " ??");
+			_buffer += i == 0 ? "??" : " ??";
 		}
 	}
 
 	const auto diff = longestHexa - aiHexa;
-	for (size_t i = 0; i < diff; ++i)
-	{
-		ret << ' ';
-	}
+	_buffer.append(diff, ' ');
 }
 
-void DsmWriter::generateInstruction(AsmInstruction& ai, std::ostream& ret)
+void DsmWriter::generateInstruction(AsmInstruction& ai)
 {
-	generateAlignedAddress(ai.getAddress(), ret);
-	getAsmInstructionHex(ai, ret);
-	ret << ALIGN << INSTR_SEPARATOR << processInstructionDsm(ai) << "\n";
+	generateAlignedAddress(ai.getAddress());
+	getAsmInstructionHex(ai);
+	_buffer += ALIGN;
+	_buffer += INSTR_SEPARATOR;
+	_buffer += processInstructionDsm(ai);
+	_buffer += "\n";
 }
 
 std::string DsmWriter::processInstructionDsm(AsmInstruction& ai)
@@ -401,13 +543,13 @@ std::string DsmWriter::processInstructionDsm(AsmInstruction& ai)
 	return ret;
 }
 
-void DsmWriter::generateData(std::ostream& ret)
+void DsmWriter::generateData()
 {
-	ret << "\n";
-	ret << ";;\n";
-	ret << ";; Data Segment" << "\n";
-	ret << ";;\n";
-	ret << "\n";
+	_buffer += "\n";
+	_buffer += ";;\n";
+	_buffer += ";; Data Segment\n";
+	_buffer += ";;\n";
+	_buffer += "\n";
 
 	for (auto& seg : _objf->getSegments())
 	{
@@ -418,22 +560,21 @@ void DsmWriter::generateData(std::ostream& ret)
 			continue;
 		}
 
-		generateDataSeg(seg.get(), ret);
+		generateDataSeg(seg.get());
 	}
 }
 
-void DsmWriter::generateDataSeg(
-		const retdec::loader::Segment* seg,
-		std::ostream& ret)
+void DsmWriter::generateDataSeg(const retdec::loader::Segment* seg)
 {
-	ret << "; section: " << seg->getName() << "\n";
-	generateDataRange(seg->getAddress(), seg->getEndAddress() + 1, ret);
+	_buffer += "; section: ";
+	_buffer += seg->getName();
+	_buffer += "\n";
+	generateDataRange(seg->getAddress(), seg->getEndAddress() + 1);
 }
 
 void DsmWriter::generateDataRange(
 		retdec::common::Address start,
-		retdec::common::Address end,
-		std::ostream& ret)
+		retdec::common::Address end)
 {
 	auto addr = start;
 	while (addr < end)
@@ -462,34 +603,35 @@ void DsmWriter::generateDataRange(
 			if (addr < gvAddr)
 			{
 				auto sz = gvAddr - addr;
-				generateData(ret, addr, sz);
+				generateData(addr, sz);
 				addr += sz;
 			}
 
 			auto sz = _abi->getTypeByteSize(init->getType());
-			generateData(ret, addr, sz, val);
+			generateData(addr, sz, val);
 			addr += sz;
 		}
 		else
 		{
-			generateData(ret, addr, end-addr);
+			generateData(addr, end-addr);
 			addr += end - addr;
 		}
 	}
 }
 
 void DsmWriter::generateData(
-		std::ostream& ret,
 		retdec::common::Address start,
 		std::size_t size,
 		const std::string& objVal)
 {
+	std::string ascii;
+
 	Address off = 0;
 	while (off < size)
 	{
-		std::string ascii = "|";
+		ascii = "|";
 
-		generateAlignedAddress(Address(start + off), ret);
+		generateAlignedAddress(Address(start + off));
 
 		for (std::size_t off1 = 0; off1 < DATA_SEGMENT_LINE; ++off1)
 		{
@@ -499,42 +641,45 @@ void DsmWriter::generateData(
 				if (_objf->getImage()->get1Byte(start + off + off1, val))
 				{
 					unsigned char c = val;
-					ret << std::setw(2) << std::setfill('0') << std::hex << val;
+					appendHex(val);
 					ascii += std::isprint(c) ? c : '.';
 				}
 				else
 				{
-					ret << "??";
+					_buffer += "??";
 					ascii += "?";
 				}
 			}
 			else
 			{
-				ret << "  ";
+				_buffer += "  ";
 				ascii += " ";
 			}
 
 			if (off1 == 7)
 			{
-				ret << " ";
+				_buffer += " ";
 			}
 
 			if (off1+1 < DATA_SEGMENT_LINE)
 			{
-				ret << " ";
+				_buffer += " ";
 			}
 		}
 
 		ascii += "|";
 
-		ret << ALIGN << ascii;
+		_buffer += ALIGN;
+		_buffer += ascii;
 
 		if (off == 0 && !objVal.empty())
 		{
-			ret << ALIGN << objVal;
+			_buffer += ALIGN;
+			_buffer += objVal;
 		}
 
-		ret << "\n";
+		_buffer += "\n";
+		flushIfFull();
 
 		off += DATA_SEGMENT_LINE;
 	}
@@ -618,19 +763,16 @@ std::string DsmWriter::reduceNegativeNumbers(const std::string& str)
 	return res;
 }
 
-void DsmWriter::generateAlignedAddress(
-		retdec::common::Address addr,
-		std::ostream& ret)
+void DsmWriter::generateAlignedAddress(retdec::common::Address addr)
 {
 	auto as = addr.toHexPrefixString();
+	_buffer += as;
+	_buffer += ":";
 	if (_longestAddr > as.size())
 	{
-		ret << as << ":" << std::string(_longestAddr - as.size(), ' ') << ALIGN;
-	}
-	else
-	{
-		ret << as << ":" << ALIGN;
+		_buffer.append(_longestAddr - as.size(), ' ');
 	}
+	_buffer += ALIGN;
 }
 
 void DsmWriter::findLongestAddress()
@@ -716,5 +858,55 @@ std::string DsmWriter::getFunctionName(const retdec::common::Function* f) const
 	return rn.empty() ? f->getName() : rn;
 }
 
+/**
+ * Append @a val to the buffer as a hexadecimal number with at least two digits.
+ */
+void DsmWriter::appendHex(std::uint64_t val)
+{
+	static const char* digits = "0123456789abcdef";
+
+	if (val <= 0xff)
+	{
+		_buffer += digits[val >> 4];
+		_buffer += digits[val & 0x0f];
+		return;
+	}
+
+	char hex[16];
+	std::size_t n = 0;
+	for (; val; val >>= 4)
+	{
+		hex[n++] = digits[val & 0x0f];
+	}
+	while (n)
+	{
+		_buffer += hex[--n];
+	}
+}
+
+/**
+ * Stream the buffered text to the output and reuse the buffer.
+ */
+void DsmWriter::flush()
+{
+	if (_out && !_buffer.empty())
+	{
+		_out->write(_buffer.data(), _buffer.size());
+	}
+	_buffer.clear();
+}
+
+/**
+ * Flush the buffer, if it is big enough. Used inside big data ranges, which
+ * are not split by functions.
+ */
+void DsmWriter::flushIfFull()
+{
+	if (_buffer.size() >= FLUSH_SIZE)
+	{
+		flush();
+	}
+}
+
 } // namespace bin2llvmir
 } // namespace retdec
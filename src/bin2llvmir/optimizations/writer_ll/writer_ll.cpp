@@ -9,6 +9,7 @@
 
 #include "retdec/bin2llvmir/optimizations/writer_ll/writer_ll.h"
 #include "retdec/bin2llvmir/providers/config.h"
+#include "retdec/bin2llvmir/utils/async_writers.h"
 
 using namespace llvm;
 
@@ -66,6 +67,25 @@ bool LlvmIrWriter::runOnModule(Module& M)
 		return false;
 	}
 
+	// Printing of a big module takes long, it is done from the module's
+	// snapshot on a background thread.
+	if (c->getConfig().parameters.isAsyncIrWriters())
+	{
+		auto bitcode = AsyncWriters::serialize(M);
+		auto id = M.getModuleIdentifier();
+		AsyncWriters::start([bitcode, id, out]()
+		{
+			auto s = AsyncWriters::snapshot(*bitcode, id);
+			std::string().swap(*bitcode);
+
+			std::unique_ptr<ToolOutputFile> llOut = createAssemblyOutputFile(out);
+			bool ShouldPreserveUseListOrder = true;
+			s.module->print(llOut->os(), nullptr, ShouldPreserveUseListOrder);
+			llOut->keep();
+		});
+		return false;
+	}
+
 	std::unique_ptr<ToolOutputFile> llOut = createAssemblyOutputFile(out);
 	raw_ostream* llOs = &llOut->os();
 	bool ShouldPreserveUseListOrder = true;
@@ -4,13 +4,13 @@
 * @copyright (c) 2020 Avast Software, licensed under the MIT license
 */
 
+#include <set>
+#include <vector>
+
 #include <llvm/IR/CFG.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/Operator.h>
 
-#include <Eigen/Core>
-#include <Eigen/QR>
-
 #include "retdec/utils/io/log.h"
 #include "retdec/bin2llvmir/optimizations/x87_fpu/x87_fpu.h"
 #include "retdec/utils/string.h"
@@ -29,18 +29,6 @@ using namespace retdec::utils::io;
 namespace retdec {
 namespace bin2llvmir {
 
-int augmentedRank(Eigen::MatrixXd &A, Eigen::MatrixXd &B)
-{
-	A.conservativeResize(Eigen::NoChange, A.cols()+1);
-	A.col(A.cols()-1) = B;
-
-	int rankAugmentedA = A.colPivHouseholderQr().rank();
-
-	A.conservativeResize(Eigen::NoChange, A.cols()-1);
-
-	return rankAugmentedA;
-}
-
 class FunctionAnalyzeMetadata
 {
 	public:
@@ -54,12 +42,11 @@ class FunctionAnalyzeMetadata
 		std::map<llvm::BasicBlock*, std::map<IndexType,unsigned >> indexes;
 
 		std::list<llvm::BasicBlock*> terminatingBasicBlocks;
-		// A * x = B
-		Eigen::MatrixXd A;
-		Eigen::MatrixXd B;
-		Eigen::MatrixXd x;
-
-		int numberOfEquations = 0;
+		// Change of the FPU top in every basic block.
+		std::map<llvm::BasicBlock*, int> topDeltas;
+		// FPU top at the entry and at the exit of every basic block, by
+		// their indexes.
+		std::vector<int> tops;
 
 		// 1. index to register, 2.pseudo instruction
 		std::list<std::pair<uint32_t ,llvm::Instruction*>> pseudoCalls;
@@ -69,8 +56,8 @@ class FunctionAnalyzeMetadata
 		bool expectedTopAnalyzed = false;
 		std::set<llvm::Function*> calledFunctions;
 
-	void initSystem();
-	void addEquation(const std::list<std::tuple<llvm::BasicBlock&,int,IndexType >>& vars, int result);
+	bool solveSystem();
+	std::size_t systemSize() const;
 	FunctionAnalyzeMetadata(llvm::Function &function1) : function(function1) {};
 
 };
@@ -145,29 +132,86 @@ std::list<FunctionAnalyzeMetadata> getFunctions2Analyze(llvm::GlobalVariable* to
 	return functionsMetadata;
 }
 
-void FunctionAnalyzeMetadata::initSystem()
+/**
+ * Compute FPU tops at the entry and at the exit of all basic blocks from the
+ * changes of the top in the blocks (@c topDeltas).
+ *
+ * The top at the exit of a block is its top at the entry plus its change, and
+ * the top at the entry of a block is equal to the tops at the exits of all its
+ * predecessors. Tops are therefore propagated along CFG edges, in both
+ * directions, from the entry block, which starts with an empty stack. Blocks
+ * not connected to the entry block are expected to start with an empty stack
+ * as well. This needs memory linear in the number of blocks and edges.
+ *
+ * @return @c false if the tops are inconsistent, i.e. a block is reached with
+ *         different tops along different paths, @c true otherwise.
+ */
+bool FunctionAnalyzeMetadata::solveSystem()
 {
-	unsigned matrixLen = 1;// + terminatingBasicBlocks.size();
-	for (Function::iterator bbIt=function.begin(), bbEndIt = function.end(); bbIt != bbEndIt; ++bbIt)
+	tops.assign(2 * function.size(), 0);
+	std::set<llvm::BasicBlock*> solved;
+	std::vector<llvm::BasicBlock*> worklist;
+
+	auto setInTop = [&](llvm::BasicBlock* bb, int inTop)
+	{
+		auto& bbIndexes = indexes[bb];
+		if (!solved.insert(bb).second)
+		{
+			return tops[bbIndexes[inIndex]] == inTop;
+		}
+		tops[bbIndexes[inIndex]] = inTop;
+		tops[bbIndexes[outIndex]] = inTop + topDeltas[bb];
+		worklist.push_back(bb);
+		return true;
+	};
+
+	for (auto& root : function)
 	{
-		BasicBlock* bb = bbIt.operator->();
-		matrixLen += 1 + pred_size(bb);
+		if (solved.count(&root))
+		{
+			continue;
+		}
+
+		setInTop(&root, EMPTY_FPU_STACK);
+		while (!worklist.empty())
+		{
+			auto* bb = worklist.back();
+			worklist.pop_back();
+
+			int inTop = tops[indexes[bb][inIndex]];
+			int outTop = tops[indexes[bb][outIndex]];
+			for (auto* succ : successors(bb))
+			{
+				if (!setInTop(succ, outTop))
+				{
+					return false;
+				}
+			}
+			for (auto* pred : predecessors(bb))
+			{
+				if (!setInTop(pred, inTop - topDeltas[pred]))
+				{
+					return false;
+				}
+			}
+		}
 	}
-	A.resize(matrixLen, 2*function.size());
-	B.resize(matrixLen, 1);
-	A.setZero();
-	B.setZero();
+
+	return true;
 }
 
-void FunctionAnalyzeMetadata::addEquation(const std::list<std::tuple<llvm::BasicBlock&,int,IndexType >>& vars, int result)
+/**
+ * @return Number of equations of the system solved by @c solveSystem(): one
+ *         for the entry block, one for every block and one for every CFG edge.
+ */
+std::size_t FunctionAnalyzeMetadata::systemSize() const
 {
-	B(numberOfEquations, 0) = result;
-	for (auto var : vars)
+	std::size_t ret = 1;
+	for (auto& bb : function)
 	{
-		A(numberOfEquations, indexes[&std::get<0>(var)][std::get<2>(var)]) = std::get<1>(var);
+		ret += 1 + pred_size(&bb);
 	}
-
-	numberOfEquations++;
+	return ret;
 }
 
 bool X87FpuAnalysis::checkArchAndCallConvException(llvm::Function* fun)
@@ -223,10 +267,6 @@ bool X87FpuAnalysis::run()
 
 	for (auto& funMd: analyzedFunctionsMetadata)
 	{
-		funMd.initSystem();
-		BasicBlock& enterBlock = funMd.function.begin().operator*();
-		funMd.addEquation({{enterBlock, 1, funMd.inIndex}}, EMPTY_FPU_STACK);
-
 		for (Function::iterator bbIt=funMd.function.begin(),
 			bbEndIt = funMd.function.end(); bbIt != bbEndIt; ++bbIt)
 		{
@@ -238,43 +278,18 @@ bool X87FpuAnalysis::run()
 				funMd.analyzeSuccess = false;
 			}
 
-			funMd.addEquation({{*bb, -1, funMd.inIndex},{*bb, 1, funMd.outIndex}}, relativeOutBbTop);
-
-			//if (_config->getConfig().architecture.isX86_16() || _config->getConfig().architecture.isX86_64()
-			//	&& std::find(funMd.terminatingBasicBlocks.begin(), funMd.terminatingBasicBlocks.end(), bb) != funMd.terminatingBasicBlocks.end())
-			//{
-			//	funMd.addEquation({{*bb, 1, funMd.outIndex}}, EMPTY_FPU_STACK);
-			//}
-
-			for (auto it = pred_begin(bb), et=pred_end(bb); it != et; ++it)
-			{
-				BasicBlock *pred = it.operator*();
-				funMd.addEquation({{*bb, 1, funMd.inIndex},{*pred, -1, funMd.outIndex}}, 0);
-			}
+			funMd.topDeltas[bb] = relativeOutBbTop;
 		}
 
-		if (funMd.A.rows() <= PERFORMANCE_CEIL)
+		if (!funMd.solveSystem())
 		{
-			const auto& pivHouseholderQr = funMd.A.colPivHouseholderQr();
-			int matRank = pivHouseholderQr.rank();
-			int augmentedMatRank = augmentedRank(funMd.A, funMd.B);
-
-			if (matRank == augmentedMatRank) // there is exactly one solution
-			{
-				funMd.x = pivHouseholderQr.solve(funMd.B);
-			}
-			else
+			if (funMd.systemSize() <= PERFORMANCE_CEIL)
 			{
 				funMd.analyzeSuccess = false;
 			}
-		}
-		else // worst scenario => due to performance ceil turn to simple no CFG analyse
-		{
-			int height = funMd.A.rows();
-			funMd.x.resize(height, 1);
-			for (int i = 0; i < height; ++i)
+			else // huge function => turn to simple no CFG analyse
 			{
-				funMd.x(i, 0) = EMPTY_FPU_STACK;
+				funMd.tops.assign(funMd.tops.size(), EMPTY_FPU_STACK);
 			}
 		}
 	}
@@ -490,9 +505,9 @@ bool X87FpuAnalysis::optimizeAnalyzedFpuInstruction(
 			auto *callStore = _config->isLlvmX87StorePseudoFunctionCall(i.second);
 			auto *callLoad = _config->isLlvmX87LoadPseudoFunctionCall(i.second);
 
-			double bbIn = funMd.x(funMd.indexes[i.second->getParent()][funMd.inIndex], 0);
+			int bbIn = funMd.tops[funMd.indexes[i.second->getParent()][funMd.inIndex]];
 			int diff = (int)i.first % EMPTY_FPU_STACK; // correction of possible stack over/under-flow
-			int top = (int)round(bbIn) + diff; // value of stack at the beginnig of BB + difference at actual instr
+			int top = bbIn + diff; // value of stack at the beginnig of BB + difference at actual instr
 
 			int registerIndex;
 			GlobalVariable *reg;
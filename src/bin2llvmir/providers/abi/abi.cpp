@@ -297,7 +297,7 @@ Config* Abi::getConfig() const
 //==============================================================================
 //
 
-std::map<llvm::Module*, std::unique_ptr<Abi>> AbiProvider::_module2abi;
+thread_local std::map<llvm::Module*, std::unique_ptr<Abi>> AbiProvider::_module2abi;
 
 Abi* AbiProvider::addAbi(
 		llvm::Module* m,
@@ -4,6 +4,8 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/InstIterator.h>
 
@@ -20,8 +22,130 @@ using namespace llvm;
 namespace retdec {
 namespace bin2llvmir {
 
-std::vector<AsmInstruction::ModuleGlobalPair> AsmInstruction::_module2global;
-std::vector<AsmInstruction::ModuleInstructionMap> AsmInstruction::_module2instMap;
+//
+//==============================================================================
+// Llvm2CapstoneInsnMap
+//==============================================================================
+//
+
+namespace {
+
+/// Unsorted tail of the address index is searched linearly up to this size,
+/// bigger tails are sorted first.
+const std::size_t UNSORTED_LIMIT = 256;
+
+} // anonymous namespace
+
+/**
+ * Add mapping instruction @a s of Capstone instruction @a i.
+ */
+void Llvm2CapstoneInsnMap::emplace(llvm::StoreInst* s, cs_insn* i)
+{
+	_store2insn[s] = i;
+	_addr2store.push_back(Entry{i->address, llvm::WeakVH(s)});
+}
+
+void Llvm2CapstoneInsnMap::clear()
+{
+	_store2insn.clear();
+	_addr2store.clear();
+	_sortedCount = 0;
+}
+
+bool Llvm2CapstoneInsnMap::empty() const
+{
+	return _store2insn.empty();
+}
+
+std::size_t Llvm2CapstoneInsnMap::size() const
+{
+	return _store2insn.size();
+}
+
+/**
+ * @return Capstone instruction of mapping instruction @a s, or @c nullptr if
+ *         there is no such instruction.
+ */
+cs_insn* Llvm2CapstoneInsnMap::getCapstoneInsn(const llvm::StoreInst* s) const
+{
+	auto it = _store2insn.find(s);
+	return it != _store2insn.end() ? it->second : nullptr;
+}
+
+/**
+ * @return Mapping instruction of the ASM instruction at address @a a, or
+ *         @c nullptr if there is no such (not erased) instruction.
+ */
+llvm::StoreInst* Llvm2CapstoneInsnMap::getLlvmToAsmInstruction(
+		retdec::common::Address a) const
+{
+	if (_addr2store.size() - _sortedCount > UNSORTED_LIMIT)
+	{
+		sort();
+	}
+
+	auto sortedEnd = _addr2store.begin() + _sortedCount;
+	auto it = std::lower_bound(
+			_addr2store.begin(),
+			sortedEnd,
+			a,
+			[](const Entry& e, retdec::common::Address a)
+			{
+				return e.address < a;
+			});
+	for (; it != sortedEnd && it->address == a; ++it)
+	{
+		if (it->store)
+		{
+			return llvm::cast<llvm::StoreInst>(static_cast<llvm::Value*>(it->store));
+		}
+	}
+
+	for (it = sortedEnd; it != _addr2store.end(); ++it)
+	{
+		if (it->address == a && it->store)
+		{
+			return llvm::cast<llvm::StoreInst>(static_cast<llvm::Value*>(it->store));
+		}
+	}
+
+	return nullptr;
+}
+
+/**
+ * Sort the whole address index. Entries of erased instructions are dropped.
+ */
+void Llvm2CapstoneInsnMap::sort() const
+{
+	auto byAddress = [](const Entry& e1, const Entry& e2)
+	{
+		return e1.address < e2.address;
+	};
+
+	auto sortedEnd = std::remove_if(
+			_addr2store.begin(),
+			_addr2store.begin() + _sortedCount,
+			[](const Entry& e) { return e.store == nullptr; });
+	auto tailEnd = std::remove_if(
+			_addr2store.begin() + _sortedCount,
+			_addr2store.end(),
+			[](const Entry& e) { return e.store == nullptr; });
+	auto tail = std::move(_addr2store.begin() + _sortedCount, tailEnd, sortedEnd);
+	_addr2store.erase(tail, _addr2store.end());
+
+	std::stable_sort(sortedEnd, _addr2store.end(), byAddress);
+	std::inplace_merge(_addr2store.begin(), sortedEnd, _addr2store.end(), byAddress);
+	_sortedCount = _addr2store.size();
+}
+
+//
+//==============================================================================
+// AsmInstruction
+//==============================================================================
+//
+
+thread_local std::vector<AsmInstruction::ModuleGlobalPair> AsmInstruction::_module2global;
+thread_local std::vector<AsmInstruction::ModuleInstructionMap> AsmInstruction::_module2instMap;
 
 AsmInstruction::AsmInstruction()
 {
@@ -95,6 +219,17 @@ AsmInstruction::AsmInstruction(llvm::Module* m, retdec::common::Address addr)
 		return;
 	}
 
+	// Modules decoded in this process have an index of all their mapping
+	// instructions, other modules (e.g. loaded from LLVM IR) are searched.
+	for (auto& p : _module2instMap)
+	{
+		if (p.module == m && !p.insnMap.empty())
+		{
+			_llvmToAsmInstr = p.insnMap.getLlvmToAsmInstruction(addr);
+			return;
+		}
+	}
+
 	ConstantInt* ci = ConstantInt::get(
 			Type::getInt64Ty(m->getContext()),
 			addr,
@@ -183,21 +318,53 @@ const llvm::GlobalVariable* AsmInstruction::getLlvmToAsmGlobalVariablePrivate(
 	}
 }
 
-Llvm2CapstoneInsnMap& AsmInstruction::getLlvmToCapstoneInsnMap(
+AsmInstruction::ModuleInstructionMap& AsmInstruction::getModuleInstructionMap(
 		const llvm::Module* m)
 {
 	for (auto& p : _module2instMap)
 	{
-		if (p.first == m)
+		if (p.module == m)
 		{
-			return p.second;
+			return p;
 		}
 	}
 
-	auto it = _module2instMap.emplace(_module2instMap.end(), std::make_pair(
-			m,
-			std::map<llvm::StoreInst*, cs_insn*>()));
-	return it->second;
+	_module2instMap.emplace_back();
+	_module2instMap.back().module = m;
+	return _module2instMap.back();
+}
+
+Llvm2CapstoneInsnMap& AsmInstruction::getLlvmToCapstoneInsnMap(
+		const llvm::Module* m)
+{
+	return getModuleInstructionMap(m).insnMap;
+}
+
+/**
+ * Returns pool of Capstone instructions of module @a m. It is created for
+ * architecture @a arch if it does not exist yet. Instructions from the pool
+ * live until @c clearCapstoneInsns() or @c clear() is called.
+ */
+capstone2llvmir::CapstoneInsnPool& AsmInstruction::getCapstoneInsnPool(
+		const llvm::Module* m,
+		cs_arch arch)
+{
+	auto& p = getModuleInstructionMap(m);
+	if (p.insnPool == nullptr)
+	{
+		p.insnPool = std::make_unique<capstone2llvmir::CapstoneInsnPool>(arch);
+	}
+	return *p.insnPool;
+}
+
+/**
+ * Frees all the Capstone instructions of module @a m.
+ */
+void AsmInstruction::clearCapstoneInsns(const llvm::Module* m)
+{
+	auto& p = getModuleInstructionMap(m);
+	p.insnMap.clear();
+	p.insnPool.reset();
 }
 
 llvm::GlobalVariable* AsmInstruction::getLlvmToAsmGlobalVariable(
@@ -346,10 +513,9 @@ cs_insn* AsmInstruction::getCapstoneInsn() const
 {
 	for (auto& p : _module2instMap)
 	{
-		if (p.first == _llvmToAsmInstr->getModule())
+		if (p.module == _llvmToAsmInstr->getModule())
 		{
-			auto it =  p.second.find(_llvmToAsmInstr);
-			return it != p.second.end() ? it->second : nullptr;
+			return p.insnMap.getCapstoneInsn(_llvmToAsmInstr);
 		}
 	}
 
@@ -72,7 +72,7 @@ void Config::doFinalization()
 
 	if (!_configDB.parameters.getOutputConfigFile().empty())
 	{
-		_configDB.generateJsonFile(_configDB.parameters.getOutputConfigFile());
+		_configDB.generateFile(_configDB.parameters.getOutputConfigFile());
 	}
 }
 
@@ -732,7 +732,7 @@ void Config::tagFunctionsWithUsedCryptoGlobals()
 //=============================================================================
 //
 
-std::map<llvm::Module*, Config> ConfigProvider::_module2config;
+thread_local std::map<llvm::Module*, Config> ConfigProvider::_module2config;
 
 Config* ConfigProvider::addConfig(llvm::Module* m, retdec::config::Config& c)
 {
@@ -23,46 +23,63 @@ namespace bin2llvmir {
 //=============================================================================
 //
 
-std::map<Module*, DebugFormat> DebugFormatProvider::_module2debug;
+thread_local std::map<Module*, DebugFormatProvider::DebugFormatEntry>
+		DebugFormatProvider::_module2debug;
 
 /**
- * Create and add to provider a debug info for the given module @a m, file
- * image @a objf, pdb file path @a pdbFile, and demangler @a demangler.
- * @return Created and added debug ingo or @c nullptr if something went wrong
- *         and it was not successfully created.
+ * Add to provider a debug info for the given module @a m, file image @a objf,
+ * pdb file path @a pdbFile, and demangler @a demangler. The debug info is
+ * loaded when it is requested for the first time, DWARF units on @a threads
+ * threads.
+ * @return @c True if debug info was added, @c false if something went wrong
+ *         and it can not be created.
  */
-DebugFormat* DebugFormatProvider::addDebugFormat(
+bool DebugFormatProvider::addDebugFormat(
 				llvm::Module* m,
 				retdec::loader::Image* objf,
 				const std::string& pdbFile,
-				Demangler* demangler)
+				Demangler* demangler,
+				unsigned threads)
 {
 	if (objf == nullptr)
 	{
-		return nullptr;
+		return false;
 	}
 
-	auto p = _module2debug.emplace(
-			m,
-			DebugFormat(
-					objf,
-					pdbFile,
-					nullptr, // symbol table -- not needed.
-					demangler ? demangler->getDemangler() : nullptr
-			)
-	);
-	return &p.first->second;
+	auto& e = _module2debug[m];
+	e.image = objf;
+	e.pdbFile = pdbFile;
+	e.demangler = demangler ? demangler->getDemangler() : nullptr;
+	e.threads = threads;
+	e.debug.reset();
+	return true;
 }
 
 /**
  * @return Get debug info associated with the given module @a m or @c nullptr
- *         if there is no associated debug info.
+ *         if there is no associated debug info. The debug info is loaded by
+ *         the first call.
  */
 DebugFormat* DebugFormatProvider::getDebugFormat(
 		llvm::Module* m)
 {
 	auto f = _module2debug.find(m);
-	return f != _module2debug.end() ? &f->second : nullptr;
+	if (f == _module2debug.end())
+	{
+		return nullptr;
+	}
+
+	auto& e = f->second;
+	if (e.debug == nullptr)
+	{
+		e.debug = std::make_unique<DebugFormat>(
+				e.image,
+				e.pdbFile,
+				nullptr, // symbol table -- not needed.
+				e.demangler,
+				e.threads);
+	}
+	return e.debug.get();
 }
 
 /**
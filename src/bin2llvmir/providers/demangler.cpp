@@ -13,12 +13,147 @@
 #include "retdec/ctypes/function.h"
 #include "retdec/ctypes/function_type.h"
 #include "retdec/ctypesparser/type_config.h"
+#include "retdec/utils/parallel.h"
 
 using namespace llvm;
 
 namespace retdec {
 namespace bin2llvmir {
 
+/******************************************************************/
+/********************** Caching Demangler *************************/
+/******************************************************************/
+
+std::map<std::string, std::shared_ptr<CachingDemangler::NameCache>>
+	CachingDemangler::_nameCaches;
+std::mutex CachingDemangler::_nameCachesMutex;
+
+/**
+ * @param compiler Compiler of the demangled names, instances with the same
+ *                 compiler share the demangled names.
+ * @param creator  Creates the underlying demangler of @a compiler.
+ */
+CachingDemangler::CachingDemangler(
+	const std::string &compiler,
+	const DemanglerCreator &creator) :
+	demangler::Demangler(compiler),
+	_creator(creator),
+	_demangler(creator())
+{
+	std::lock_guard<std::mutex> lock(_nameCachesMutex);
+	auto &names = _nameCaches[compiler];
+	if (names == nullptr) {
+		names = std::make_shared<NameCache>();
+	}
+	_names = names;
+}
+
+std::string CachingDemangler::demangleToString(const std::string &mangled)
+{
+	{
+		std::lock_guard<std::mutex> lock(_names->mutex);
+		auto fIt = _names->names.find(mangled);
+		if (fIt != _names->names.end()) {
+			_status = fIt->second.second;
+			return fIt->second.first;
+		}
+	}
+
+	auto demangled = _demangler->demangleToString(mangled);
+	_status = _demangler->status();
+
+	std::lock_guard<std::mutex> lock(_names->mutex);
+	_names->names.emplace(mangled, DemangledName(demangled, _status));
+	return demangled;
+}
+
+std::shared_ptr<ctypes::Function> CachingDemangler::demangleFunctionToCtypes(
+	const std::string &mangled,
+	std::unique_ptr<ctypes::Module> &module,
+	const ctypesparser::CTypesParser::TypeWidths &typeWidths,
+	const ctypesparser::CTypesParser::TypeSignedness &typeSignedness,
+	unsigned defaultBitWidth)
+{
+	if (module.get() != _ctypesModule) {
+		_ctypesFunctions.clear();
+		_ctypesModule = module.get();
+	}
+
+	auto fIt = _ctypesFunctions.find(mangled);
+	if (fIt != _ctypesFunctions.end()) {
+		_status = fIt->second ? success : invalid_mangled_name;
+		return fIt->second;
+	}
+
+	auto f = _demangler->demangleFunctionToCtypes(
+		mangled,
+		module,
+		typeWidths,
+		typeSignedness,
+		defaultBitWidth);
+	_status = _demangler->status();
+	_ctypesFunctions.emplace(mangled, f);
+	return f;
+}
+
+/**
+ * Demangle all the @a mangled names to strings on @a threads threads and
+ * remember them, so that the following @c demangleToString() calls of all the
+ * instances with the same compiler only look them up.
+ */
+void CachingDemangler::demangleToStrings(
+	const std::vector<std::string> &mangled,
+	unsigned threads)
+{
+	std::vector<const std::string *> todo;
+	{
+		std::lock_guard<std::mutex> lock(_names->mutex);
+		for (auto &m : mangled) {
+			if (_names->names.count(m) == 0) {
+				todo.push_back(&m);
+			}
+		}
+	}
+
+	// Underlying demanglers are not thread-safe, every chunk of names is
+	// demangled by its own one.
+	threads = std::max(1u, threads);
+	std::size_t chunk = (todo.size() + threads - 1) / threads;
+	utils::parallelFor(threads, threads, [&](std::size_t i) {
+		auto first = std::min(todo.size(), i * chunk);
+		auto last = std::min(todo.size(), first + chunk);
+		if (first == last) {
+			return;
+		}
+
+		auto d = i == 0 ? nullptr : _creator();
+		auto *dem = d ? d.get() : _demangler.get();
+		std::vector<std::pair<const std::string *, DemangledName>> res;
+		res.reserve(last - first);
+		for (auto k = first; k < last; ++k) {
+			auto demangled = dem->demangleToString(*todo[k]);
+			res.emplace_back(todo[k], DemangledName(demangled, dem->status()));
+		}
+
+		std::lock_guard<std::mutex> lock(_names->mutex);
+		for (auto &r : res) {
+			_names->names.emplace(*r.first, r.second);
+		}
+	});
+}
+
+/**
+ * Forget demangled names of all the instances.
+ */
+void CachingDemangler::clearCache()
+{
+	std::lock_guard<std::mutex> lock(_nameCachesMutex);
+	for (auto &p : _nameCaches) {
+		std::lock_guard<std::mutex> l(p.second->mutex);
+		p.second->names.clear();
+	}
+}
+
 /******************************************************************/
 /************************** Demangler *****************************/
 /******************************************************************/
@@ -27,7 +162,7 @@ Demangler::Demangler(
 	llvm::Module *llvmModule,
 	Config *config,
 	const std::shared_ptr<ctypesparser::TypeConfig> &typeConfig,
-	std::unique_ptr<retdec::demangler::Demangler> demangler) :
+	std::unique_ptr<CachingDemangler> demangler) :
 	_llvmModule(llvmModule),
 	_config(config),
 	_ctypesModule(std::make_unique<ctypes::Module>(std::make_shared<ctypes::Context>())),
@@ -39,6 +174,17 @@ std::string Demangler::demangleToString(const std::string &mangled)
 	return _demangler->demangleToString(mangled);
 }
 
+/**
+ * Demangle all the @a mangled names on @a threads threads in advance, see
+ * @c CachingDemangler::demangleToStrings().
+ */
+void Demangler::demangleToStrings(
+	const std::vector<std::string> &mangled,
+	unsigned threads)
+{
+	_demangler->demangleToStrings(mangled, threads);
+}
+
 Demangler::FunctionPair Demangler::getPairFunction(const std::string &mangled)
 {
 	auto ctypesFunction = _demangler->demangleFunctionToCtypes(
@@ -86,7 +232,12 @@ std::unique_ptr<Demangler> DemanglerFactory::getItaniumDemangler(
 	const std::shared_ptr<ctypesparser::TypeConfig> &typeConfig)
 {
 	return std::make_unique<Demangler>(
-		m, config, typeConfig, std::make_unique<demangler::ItaniumDemangler>());
+		m,
+		config,
+		typeConfig,
+		std::make_unique<CachingDemangler>("itanium", []() {
+			return std::make_unique<demangler::ItaniumDemangler>();
+		}));
 }
 
 /**
@@ -99,7 +250,12 @@ std::unique_ptr<Demangler> DemanglerFactory::getMicrosoftDemangler(
 	const std::shared_ptr<ctypesparser::TypeConfig> &typeConfig)
 {
 	return std::make_unique<Demangler>(
-		m, config, typeConfig, std::make_unique<demangler::MicrosoftDemangler>());
+		m,
+		config,
+		typeConfig,
+		std::make_unique<CachingDemangler>("microsoft", []() {
+			return std::make_unique<demangler::MicrosoftDemangler>();
+		}));
 }
 
 /**
@@ -112,13 +268,18 @@ std::unique_ptr<Demangler> DemanglerFactory::getBorlandDemangler(
 	const std::shared_ptr<ctypesparser::TypeConfig> &typeConfig)
 {
 	return std::make_unique<Demangler>(
-		m, config, typeConfig, std::make_unique<demangler::BorlandDemangler>());
+		m,
+		config,
+		typeConfig,
+		std::make_unique<CachingDemangler>("borland", []() {
+			return std::make_unique<demangler::BorlandDemangler>();
+		}));
 }
 
 /******************************************************************/
 /********************** Demangler Provider ************************/
 /******************************************************************/
-std::map<Module *, std::unique_ptr<Demangler>> DemanglerProvider::_module2demangler;
+thread_local std::map<Module *, std::unique_ptr<Demangler>> DemanglerProvider::_module2demangler;
 
 /**
  * Create and add to provider a demangler for the given module @a m
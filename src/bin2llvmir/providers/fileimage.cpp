@@ -15,6 +15,20 @@ using namespace llvm;
 namespace retdec {
 namespace bin2llvmir {
 
+namespace {
+
+/**
+ * Parts of the input file that are useless for decompilation. Their parsing
+ * and hashing is expensive on large inputs, so it is skipped.
+ */
+constexpr fileformat::LoadFlags loadFlags = static_cast<fileformat::LoadFlags>(
+		fileformat::LoadFlags::NO_FILE_HASHES
+		| fileformat::LoadFlags::NO_VERBOSE_HASHES
+		| fileformat::LoadFlags::NO_CERTIFICATES
+		| fileformat::LoadFlags::NO_ANOMALIES);
+
+} // anonymous namespace
+
 //
 //=============================================================================
 //  FileImage
@@ -30,7 +44,26 @@ FileImage::FileImage(
 				m,
 				retdec::loader::createImage(
 						path,
-						config->getConfig().fileFormat.isRaw()),
+						config->getConfig().fileFormat.isRaw(),
+						loadFlags),
+				config)
+{
+
+}
+
+FileImage::FileImage(
+		llvm::Module* m,
+		const std::uint8_t* data,
+		std::size_t size,
+		Config* config)
+		:
+		FileImage(
+				m,
+				retdec::loader::createImage(
+						data,
+						size,
+						config->getConfig().fileFormat.isRaw(),
+						loadFlags),
 				config)
 {
 
@@ -102,16 +135,28 @@ FileImage::FileImage(
 
 void FileImage::initRtti(Config* config)
 {
+	auto threads = config->getConfig().parameters.getDecoderThreads();
 	if (config->getConfig().tools.isMsvc())
 	{
-		_rtti.findMsvc(getImage());
+		_rtti.findMsvc(getImage(), threads);
 	}
 	else
 	{
-		_rtti.findGcc(getImage());
+		_rtti.findGcc(getImage(), threads);
 	}
 }
 
+/**
+ * Search for statically linked code in advance, so that the decoder does not
+ * have to. Tools detected in @a config select the signatures.
+ */
+void FileImage::initStaticCode(Config* config)
+{
+	auto sca = std::make_unique<stacofin::Finder>();
+	sca->searchAndConfirm(*getImage(), config->getConfig());
+	_staticCode = std::move(sca);
+}
+
 retdec::loader::Image* FileImage::getImage() const
 {
 	return _image.get();
@@ -127,6 +172,15 @@ const retdec::rtti_finder::RttiFinder& FileImage::getRtti() const
 	return _rtti;
 }
 
+/**
+ * @return Static code detections made by @c initStaticCode(), or @c nullptr
+ *         if it was not called.
+ */
+const retdec::stacofin::Finder* FileImage::getStaticCode() const
+{
+	return _staticCode.get();
+}
+
 ConstantInt* FileImage::getConstantInt(
 		IntegerType* t,
 		retdec::common::Address addr)
@@ -625,7 +679,7 @@ bool FileImage::isImportTerminating(
 //=============================================================================
 //
 
-std::map<llvm::Module*, FileImage> FileImageProvider::_module2image;
+thread_local std::map<llvm::Module*, FileImage> FileImageProvider::_module2image;
 
 /**
  * Create and add to provider a file image created from file at @a path for
@@ -641,6 +695,21 @@ FileImage* FileImageProvider::addFileImage(
 	return addFileImage(m, FileImage(m, path, config));
 }
 
+/**
+ * Create and add to provider a file image created from the input file content
+ * @a data of @a size bytes held in memory for the given module @a m.
+ * @return Created and added file image or @c nullptr if something went wrong
+ *         and it was not successfully created.
+ */
+FileImage* FileImageProvider::addFileImage(
+		llvm::Module* m,
+		const std::uint8_t* data,
+		std::size_t size,
+		Config* config)
+{
+	return addFileImage(m, FileImage(m, data, size, config));
+}
+
 /**
  * Create and add to provider a file image @a ff for the given module @a m
  * and architecture @a a.
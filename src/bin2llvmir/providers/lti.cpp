@@ -31,6 +31,9 @@ namespace bin2llvmir {
 //=============================================================================
 //
 
+std::map<std::string, std::shared_ptr<Lti::LtiDatabase>> Lti::_ltiCache;
+std::mutex Lti::_ltiCacheMutex;
+
 Lti::Lti(
 	llvm::Module *m,
 	Config *c,
@@ -42,17 +45,22 @@ Lti::Lti(
 		_typeConfig(typeConfig),
 		_image(objf)
 {
-	_ltiModule = std::make_unique<retdec::ctypes::Module>(
-			std::make_shared<retdec::ctypes::Context>());
+	_ltiDb = loadLtiFiles(getLtiFilesToLoad());
+}
 
-	_ltiParser = ctypesparser::JSONCTypesParser(
-			static_cast<unsigned>(c->getConfig().architecture.getBitSize()));
+/**
+ * Get paths to all the LTI files that should be loaded for the current input,
+ * in the order in which they should be loaded.
+ */
+std::vector<std::string> Lti::getLtiFilesToLoad() const
+{
+	std::vector<std::string> ret;
 
 	for (auto& l : _config->getConfig().parameters.libraryTypeInfoPaths)
 	{
 		if (retdec::utils::endsWith(l, "cstdlib.json"))
 		{
-			loadLtiFile(l);
+			ret.push_back(l);
 		}
 	}
 
@@ -68,12 +76,12 @@ Lti::Lti(
 		if (retdec::utils::endsWith(l, "windows.json")
 				&& _config->getConfig().fileFormat.isPe())
 		{
-			loadLtiFile(l);
+			ret.push_back(l);
 		}
 		else if (winDriver
 				&& retdec::utils::endsWith(l, "windrivers.json"))
 		{
-			loadLtiFile(l);
+			ret.push_back(l);
 		}
 		else if (retdec::utils::endsWith(l, "linux.json")
 				&& (_config->getConfig().fileFormat.isElf()
@@ -81,17 +89,60 @@ Lti::Lti(
 				|| _config->getConfig().fileFormat.isIntelHex()
 				|| _config->getConfig().fileFormat.isRaw()))
 		{
-			loadLtiFile(l);
+			ret.push_back(l);
 		}
 		else if (retdec::utils::endsWith(l, "arm.json") &&
 				_config->getConfig().architecture.isArm32OrThumb())
 		{
-			loadLtiFile(l);
+			ret.push_back(l);
 		}
 	}
+
+	return ret;
+}
+
+/**
+ * Get a database with all the functions from @a filePaths.
+ * Databases are loaded only once per process and shared between all the
+ * decompilations that use the same LTI configuration (e.g. in batch mode),
+ * including the ones running concurrently in other threads.
+ * Functions are parsed into a shared database under its mutex, already parsed
+ * functions are never modified.
+ */
+std::shared_ptr<Lti::LtiDatabase> Lti::loadLtiFiles(
+		const std::vector<std::string>& filePaths)
+{
+	std::string key = std::to_string(
+			_config->getConfig().architecture.getBitSize());
+	for (auto& tw : _typeConfig->typeWidths())
+	{
+		key += ";" + tw.first + "=" + std::to_string(tw.second);
+	}
+	for (auto& f : filePaths)
+	{
+		key += "|" + f;
+	}
+
+	std::lock_guard<std::mutex> lock(_ltiCacheMutex);
+	auto fIt = _ltiCache.find(key);
+	if (fIt != _ltiCache.end())
+	{
+		return fIt->second;
+	}
+
+	auto db = std::make_shared<LtiDatabase>();
+	db->module = std::make_unique<retdec::ctypes::Module>(
+			std::make_shared<retdec::ctypes::Context>());
+	for (auto& f : filePaths)
+	{
+		loadLtiFile(f, *db);
+	}
+
+	_ltiCache.emplace(key, db);
+	return db;
 }
 
-void Lti::loadLtiFile(const std::string& filePath)
+void Lti::loadLtiFile(const std::string& filePath, LtiDatabase& db)
 {
 	std::ifstream file(filePath);
 	if (file)
@@ -101,19 +152,58 @@ void Lti::loadLtiFile(const std::string& filePath)
 		{
 			cc = "stdcall";
 		}
-		_ltiParser.parseInto(file, _ltiModule, _typeConfig->typeWidths(), cc);
+		auto parser = std::make_unique<ctypesparser::JSONCTypesParser>(
+				static_cast<unsigned>(
+						_config->getConfig().architecture.getBitSize()));
+		parser->loadIndex(
+				file,
+				db.module->getContext(),
+				_typeConfig->typeWidths(),
+				cc);
+		db.files.push_back(std::move(parser));
 	}
 }
 
+/**
+ * Drop all the cached LTI databases.
+ * Databases still used by existing @c Lti instances stay alive until those
+ * instances are destroyed.
+ */
+void Lti::clearCache()
+{
+	std::lock_guard<std::mutex> lock(_ltiCacheMutex);
+	_ltiCache.clear();
+}
+
 bool Lti::hasLtiFunction(const std::string& name)
 {
 	return getLtiFunction(name) != nullptr;
 }
 
+/**
+ * Find LTI function with @c name. It is parsed from the first loaded file
+ * that contains it, if it was not requested before.
+ */
 std::shared_ptr<retdec::ctypes::Function> Lti::getLtiFunction(
 		const std::string& name)
 {
-	return _ltiModule->getFunctionWithName(name);
+	std::lock_guard<std::mutex> lock(_ltiDb->mutex);
+
+	if (auto f = _ltiDb->module->getFunctionWithName(name))
+	{
+		return f;
+	}
+
+	for (auto& file : _ltiDb->files)
+	{
+		if (auto f = file->parseIndexedFunction(name))
+		{
+			_ltiDb->module->addFunction(f);
+			return f;
+		}
+	}
+
+	return nullptr;
 }
 
 /**
@@ -234,7 +324,7 @@ llvm::Type* Lti::getLlvmType(std::shared_ptr<retdec::ctypes::Type> type)
 //=============================================================================
 //
 
-std::map<llvm::Module*, Lti> LtiProvider::_module2lti;
+thread_local std::map<llvm::Module*, Lti> LtiProvider::_module2lti;
 
 Lti* LtiProvider::addLti(
 	llvm::Module *m,
@@ -247,7 +337,16 @@ Lti* LtiProvider::addLti(
 		return nullptr;
 	}
 
-	auto p = _module2lti.emplace(m, Lti(m, c, typeConfig, objf));
+	return addLti(m, Lti(m, c, typeConfig, objf));
+}
+
+/**
+ * Add an already created @a lti for module @a m. This allows LTI files to be
+ * loaded on another thread.
+ */
+Lti* LtiProvider::addLti(llvm::Module* m, Lti&& lti)
+{
+	auto p = _module2lti.emplace(m, std::move(lti));
 	return &p.first->second;
 }
 
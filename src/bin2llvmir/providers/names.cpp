@@ -5,6 +5,7 @@
 */
 
 #include "retdec/bin2llvmir/providers/names.h"
+#include "retdec/bin2llvmir/utils/ordinal_database.h"
 #include "retdec/utils/string.h"
 
 using namespace retdec::common;
@@ -79,20 +80,22 @@ Name::Name()
 }
 
 Name::Name(Config* c, const std::string& name, eType type, Lti* lti) :
-		_name(normalizeNamePrefix(name)),
 		_type(type)
 {
+	std::string n = normalizeNamePrefix(name);
 	if (c->getConfig().architecture.isPic32())
 	{
-		fixPic32Mangling();
+		fixPic32Mangling(n);
 	}
 
-	fixPostfix();
+	fixPostfix(n);
 
-	if (lti && _type > eType::LTI_FUNCTION && lti->getLtiFunction(_name))
+	if (lti && _type > eType::LTI_FUNCTION && lti->getLtiFunction(n))
 	{
 		_type = eType::LTI_FUNCTION;
 	}
+
+	_name = n;
 }
 
 Name::operator std::string() const
@@ -109,17 +112,20 @@ bool Name::operator<(const Name& o) const
 {
 	if (_type == o._type)
 	{
+		const std::string& name = _name.str();
+		const std::string& oName = o._name.str();
+
 		// E.g. real case symbol table:
 		// 0x407748 @ .text
 		// 0x407748 @ _printf
 		//
-		if (!_name.empty() && _name.front() == '.'
-				&& !o._name.empty() && o._name.front() != '.')
+		if (!name.empty() && name.front() == '.'
+				&& !oName.empty() && oName.front() != '.')
 		{
 			return false;
 		}
-		else if (!_name.empty() && _name.front() != '.'
-				&& !o._name.empty() && o._name.front() == '.')
+		else if (!name.empty() && name.front() != '.'
+				&& !oName.empty() && oName.front() == '.')
 		{
 			return true;
 		}
@@ -138,7 +144,7 @@ bool Name::operator<(const Name& o) const
 
 const std::string& Name::getName() const
 {
-	return _name;
+	return _name.str();
 }
 
 Name::eType Name::getType() const
@@ -146,41 +152,41 @@ Name::eType Name::getType() const
 	return _type;
 }
 
-void Name::fixPic32Mangling()
+void Name::fixPic32Mangling(std::string& name)
 {
-	if (_name.empty()) return;
+	if (name.empty()) return;
 
-	if (_name.find("_d") == 0)
+	if (name.find("_d") == 0)
 	{
-		_name = _name.substr(2);
+		name = name.substr(2);
 	}
-	else if (_name[0] == '_')
+	else if (name[0] == '_')
 	{
-		_name = _name.substr(1);
+		name = name.substr(1);
 	}
 
-	if (_name.empty()) return;
+	if (name.empty()) return;
 
-	if (_name.find("_cd") != std::string::npos)
+	if (name.find("_cd") != std::string::npos)
 	{
-		_name = _name.substr(0, _name.find("_cd"));
+		name = name.substr(0, name.find("_cd"));
 	}
-	else if (_name.find("_gG") != std::string::npos)
+	else if (name.find("_gG") != std::string::npos)
 	{
-		_name = _name.substr(0, _name.find("_gG"));
+		name = name.substr(0, name.find("_gG"));
 	}
-	else if (_name.find("_eE") != std::string::npos)
+	else if (name.find("_eE") != std::string::npos)
 	{
-		_name = _name.substr(0, _name.find("_eE"));
+		name = name.substr(0, name.find("_eE"));
 	}
-	else if (_name.find("_fF") != std::string::npos)
+	else if (name.find("_fF") != std::string::npos)
 	{
-		_name = _name.substr(0, _name.find("_fF"));
+		name = name.substr(0, name.find("_fF"));
 	}
-	else if (retdec::utils::endsWith(_name, "_s"))
+	else if (retdec::utils::endsWith(name, "_s"))
 	{
-		_name.pop_back();
-		_name.pop_back();
+		name.pop_back();
+		name.pop_back();
 	}
 }
 
@@ -193,12 +199,12 @@ void Name::fixPic32Mangling()
  * Maybe we should keep the postfix somewhere and let the user know this fix
  * happened (e.g. add comment to name).
  */
-void Name::fixPostfix()
+void Name::fixPostfix(std::string& name)
 {
-	const auto pos = _name.find("@@GLIBC_");
+	const auto pos = name.find("@@GLIBC_");
 	if(pos && pos != std::string::npos)
 	{
-		_name.erase(pos);
+		name.erase(pos);
 	}
 }
 
@@ -261,21 +267,24 @@ bool Names::empty() const
 //==============================================================================
 //
 
+Names NameContainer::_emptyNames;
+thread_local std::map<
+		std::string,
+		std::unique_ptr<NameContainer::ImportOrdMap>> NameContainer::_ordFiles;
+
 NameContainer::NameContainer(
-		llvm::Module*,
+		llvm::Module* m,
 		Config* c,
-		DebugFormat* d,
 		FileImage* i,
 		Demangler*,
 		Lti* lti)
 		:
+		_module(m),
 		_config(c),
-		_debug(d),
 		_image(i),
 		_lti(lti)
 {
 	initFromConfig();
-	initFromDebug();
 	initFromImage();
 }
 
@@ -289,35 +298,54 @@ bool NameContainer::addNameForAddress(
 		Name::eType type,
 		Lti* lti)
 {
-	if (a.isUndefined() || name.empty())
-	{
-		return false;
-	}
-
-	auto& ns = _data[a];
-	return ns.addName(_config, name, type, lti ? lti : _lti);
+	initFromDebug();
+	return addName(a, name, type, lti);
 }
 
 const Names& NameContainer::getNamesForAddress(retdec::common::Address a)
 {
-	return _data[a];
+	initFromDebug();
+	auto fIt = _data.find(a);
+	return fIt != _data.end() ? fIt->second : _emptyNames;
 }
 
 const Name& NameContainer::getPreferredNameForAddress(retdec::common::Address a)
 {
-	return _data[a].getPreferredName();
+	initFromDebug();
+	auto fIt = _data.find(a);
+	return fIt != _data.end()
+			? fIt->second.getPreferredName()
+			: _emptyNames.getPreferredName();
+}
+
+/**
+ * Same as @c addNameForAddress(), but it does not add names from debug info.
+ */
+bool NameContainer::addName(
+		retdec::common::Address a,
+		const std::string& name,
+		Name::eType type,
+		Lti* lti)
+{
+	if (a.isUndefined() || name.empty())
+	{
+		return false;
+	}
+
+	auto& ns = _data[a];
+	return ns.addName(_config, name, type, lti ? lti : _lti);
 }
 
 void NameContainer::initFromConfig()
 {
-	addNameForAddress(
+	addName(
 			_config->getConfig().parameters.getEntryPoint(),
 			names::entryPointName,
 			Name::eType::ENTRY_POINT);
 
 	for (auto& f : _config->getConfig().functions)
 	{
-		addNameForAddress(
+		addName(
 				f.getStart(),
 				f.getName(),
 				Name::eType::CONFIG_FUNCTION);
@@ -325,7 +353,7 @@ void NameContainer::initFromConfig()
 
 	for (auto& g : _config->getConfig().globals)
 	{
-		addNameForAddress(
+		addName(
 				g.getStorage().getAddress(),
 				g.getName(),
 				Name::eType::CONFIG_GLOBAL);
@@ -334,25 +362,32 @@ void NameContainer::initFromConfig()
 
 void NameContainer::initFromDebug()
 {
-	if (_debug == nullptr)
+	if (_debugInitialized)
+	{
+		return;
+	}
+	_debugInitialized = true;
+
+	auto* debug = DebugFormatProvider::getDebugFormat(_module);
+	if (debug == nullptr)
 	{
 		return;
 	}
 
-	for (const auto& p : _debug->functions)
+	for (const auto& p : debug->functions)
 	{
-		addNameForAddress(
+		addName(
 				p.first,
 				p.second.getName(),
 				Name::eType::DEBUG_FUNCTION);
 	}
 
-	for (const auto& g : _debug->globals)
+	for (const auto& g : debug->globals)
 	{
 		Address addr;
 		if (g.getStorage().isMemory(addr))
 		{
-			addNameForAddress(
+			addName(
 					addr,
 					g.getName(),
 					Name::eType::DEBUG_GLOBAL);
@@ -387,14 +422,14 @@ void NameContainer::initFromImage()
 		{
 			name = names::generatedImportPrefix + std::to_string(ord);
 
-			addNameForAddress(
+			addName(
 					addr,
 					name,
 					Name::eType::IMPORT_GENERATED);
 		}
 		else
 		{
-			addNameForAddress(
+			addName(
 					addr,
 					name,
 					Name::eType::IMPORT);
@@ -404,7 +439,7 @@ void NameContainer::initFromImage()
 	if (auto* exTbl = _image->getFileFormat()->getExportTable())
 		for (const auto& exp : *exTbl)
 		{
-			addNameForAddress(
+			addName(
 					exp.getAddress(),
 					exp.getName(),
 					Name::eType::EXPORT);
@@ -438,7 +473,7 @@ void NameContainer::initFromImage()
 					a -= 1;
 				}
 
-				addNameForAddress(a, s->getName(), t);
+				addName(a, s->getName(), t);
 			}
 		}
 
@@ -452,7 +487,7 @@ void NameContainer::initFromImage()
 				ep -= 1;
 			}
 
-			addNameForAddress(
+			addName(
 					ep,
 					names::entryPointName,
 					Name::eType::ENTRY_POINT);
@@ -478,22 +513,30 @@ std::string NameContainer::getNameFromImportLibAndOrd(
 		const std::string& libName,
 		int ord)
 {
-	auto it = _dllOrds.find(libName);
-	if (it == _dllOrds.end())
+	std::string arch;
+	if (_config->getConfig().architecture.isArm()) arch = "arm";
+	else if (_config->getConfig().architecture.isX86()) arch = "x86";
+	else return std::string();
+
+	auto dir = _config->getConfig().parameters.getOrdinalNumbersDirectory();
+
+	// Prefer the compiled database, fall back to the individual files when
+	// it is not installed.
+	if (auto db = OrdinalDatabase::get(dir))
 	{
-		if (!loadImportOrds(libName))
-		{
-			return std::string();
-		}
-		else
-		{
-			it = _dllOrds.find(libName);
-		}
+		return ord >= 0 ? db->getName(arch, libName, ord).str() : std::string();
+	}
+
+	auto filePath = dir + "/" + arch + "/" + libName + ".ord";
+
+	const ImportOrdMap* ords = loadImportOrds(filePath);
+	if (ords == nullptr)
+	{
+		return std::string();
 	}
 
-	const ImportOrdMap& ords = it->second;
-	auto ordIt = ords.find(ord);
-	if (ordIt != ords.end())
+	auto ordIt = ords->find(ord);
+	if (ordIt != ords->end())
 	{
 		return ordIt->second;
 	}
@@ -501,25 +544,32 @@ std::string NameContainer::getNameFromImportLibAndOrd(
 	return std::string();
 }
 
-bool NameContainer::loadImportOrds(const std::string& libName)
+/**
+ * Load ordinals from file \p filePath. Every file is loaded only once, even
+ * if it can not be loaded.
+ * 
+eturn Loaded ordinals, or \c nullptr if the file can not be loaded.
+ */
+const NameContainer::ImportOrdMap* NameContainer::loadImportOrds(
+		const std::string& filePath)
 {
-	std::string arch;
-	if (_config->getConfig().architecture.isArm()) arch = "arm";
-	else if (_config->getConfig().architecture.isX86()) arch = "x86";
-	else return false;
+	auto fIt = _ordFiles.find(filePath);
+	if (fIt != _ordFiles.end())
+	{
+		return fIt->second.get();
+	}
 
-	auto dir = _config->getConfig().parameters.getOrdinalNumbersDirectory();
-	auto filePath = dir + "/" + arch + "/" + libName + ".ord";
+	auto& ordMap = _ordFiles[filePath];
 
 	std::ifstream inputFile;
 	inputFile.open(filePath);
 	if (!inputFile)
 	{
-		return false;
+		return nullptr;
 	}
 
+	ordMap = std::make_unique<ImportOrdMap>();
 	std::string line;
-	ImportOrdMap ordMap;
 	while (!getline(inputFile, line).eof())
 	{
 		std::stringstream ordDecl(line);
@@ -529,13 +579,20 @@ bool NameContainer::loadImportOrds(const std::string& libName)
 		ordDecl >> ord >> funcName;
 		if (ord >= 0)
 		{
-			ordMap[ord] = funcName;
+			(*ordMap)[ord] = funcName;
 		}
 	}
 	inputFile.close();
-	_dllOrds.emplace(libName, ordMap);
 
-	return true;
+	return ordMap.get();
+}
+
+/**
+ * Forget all the loaded ordinals files.
+ */
+void NameContainer::clearImportOrds()
+{
+	_ordFiles.clear();
 }
 
 //
@@ -544,17 +601,15 @@ bool NameContainer::loadImportOrds(const std::string& libName)
 //==============================================================================
 //
 
-std::map<llvm::Module*, NameContainer> NamesProvider::_module2names;
+thread_local std::map<llvm::Module*, NameContainer> NamesProvider::_module2names;
 
 NameContainer* NamesProvider::addNames(
 		llvm::Module* m,
 		Config* c,
-		DebugFormat* d,
 		FileImage* i,
 		Demangler* dm,
 		Lti* lti)
 {
-	// Debug info may not be present -> \p d can be nullptr.
 	if (m == nullptr
 			|| c == nullptr
 			|| i == nullptr
@@ -563,7 +618,7 @@ NameContainer* NamesProvider::addNames(
 		return nullptr;
 	}
 
-	auto p = _module2names.emplace(m, NameContainer(m, c, d, i, dm, lti));
+	auto p = _module2names.emplace(m, NameContainer(m, c, i, dm, lti));
 	return &p.first->second;
 }
 
@@ -582,6 +637,7 @@ bool NamesProvider::getNames(llvm::Module* m, NameContainer*& names)
 void NamesProvider::clear()
 {
 	_module2names.clear();
+	NameContainer::clearImportOrds();
 }
 
 } // namespace bin2llvmir
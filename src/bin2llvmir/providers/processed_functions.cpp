@@ -0,0 +1,86 @@
+/**
+ * @file src/bin2llvmir/providers/processed_functions.cpp
+ * @brief Functions already processed by passes and their state.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <llvm/ADT/Hashing.h>
+#include <llvm/IR/Instruction.h>
+
+#include "retdec/bin2llvmir/providers/processed_functions.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+thread_local std::map<
+		llvm::Module*,
+		std::map<ProcessedFunctionsProvider::Key, std::uint64_t>>
+		ProcessedFunctionsProvider::_module2fingerprints;
+
+/**
+ * @return @c True if function @a f of module @a m was processed by @a pass
+ *         and it has not changed since then.
+ */
+bool ProcessedFunctionsProvider::isUnchanged(
+		llvm::Module* m,
+		const void* pass,
+		const llvm::Function* f)
+{
+	auto mIt = _module2fingerprints.find(m);
+	if (mIt == _module2fingerprints.end())
+	{
+		return false;
+	}
+
+	auto fIt = mIt->second.find(Key(pass, f));
+	return fIt != mIt->second.end() && fIt->second == getFingerprint(f);
+}
+
+/**
+ * Remember that function @a f of module @a m in its current state was
+ * processed by @a pass.
+ */
+void ProcessedFunctionsProvider::setProcessed(
+		llvm::Module* m,
+		const void* pass,
+		const llvm::Function* f)
+{
+	_module2fingerprints[m][Key(pass, f)] = getFingerprint(f);
+}
+
+/**
+ * @return Hash of function @a f -- its basic blocks and the opcodes, types
+ *         and operands of their instructions. Values are hashed by their
+ *         identities, so e.g. a replaced operand changes the fingerprint.
+ */
+std::uint64_t ProcessedFunctionsProvider::getFingerprint(
+		const llvm::Function* f)
+{
+	llvm::hash_code h = llvm::hash_combine(f, f->getFunctionType(), f->size());
+	for (auto& bb : *f)
+	{
+		h = llvm::hash_combine(h, &bb);
+		for (auto& i : bb)
+		{
+			h = llvm::hash_combine(
+					h,
+					&i,
+					i.getOpcode(),
+					i.getType(),
+					i.getNumOperands());
+			for (auto& op : i.operands())
+			{
+				h = llvm::hash_combine(h, op.get());
+			}
+		}
+	}
+	return h;
+}
+
+void ProcessedFunctionsProvider::clear()
+{
+	_module2fingerprints.clear();
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
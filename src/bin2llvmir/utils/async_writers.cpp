@@ -0,0 +1,125 @@
+/**
+ * @file src/bin2llvmir/utils/async_writers.cpp
+ * @brief Writing of output files on background threads.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <stdexcept>
+
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "retdec/bin2llvmir/utils/async_writers.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+std::mutex AsyncWriters::_mutex;
+std::vector<std::thread> AsyncWriters::_threads;
+std::exception_ptr AsyncWriters::_error;
+
+/**
+ * @return Bitcode of module @a m. Use-list order is preserved, so that the
+ *         module loaded from it prints the same as @a m.
+ */
+std::shared_ptr<std::string> AsyncWriters::serialize(const llvm::Module& m)
+{
+	auto bitcode = std::make_shared<std::string>();
+	llvm::raw_string_ostream os(*bitcode);
+	bool ShouldPreserveUseListOrder = true;
+	llvm::WriteBitcodeToFile(m, os, ShouldPreserveUseListOrder);
+	os.flush();
+	return bitcode;
+}
+
+/**
+ * Load module @a moduleId from @a bitcode created by @c serialize() into a new
+ * context. The snapshot is independent of the serialized module, it can be
+ * used on any thread.
+ */
+AsyncWriters::Snapshot AsyncWriters::snapshot(
+		const std::string& bitcode,
+		const std::string& moduleId)
+{
+	Snapshot ret;
+	ret.context = std::make_unique<llvm::LLVMContext>();
+
+	auto m = llvm::parseBitcodeFile(
+			llvm::MemoryBufferRef(bitcode, moduleId),
+			*ret.context);
+	if (!m)
+	{
+		throw std::runtime_error(
+			"failed to load module snapshot: " + llvm::toString(m.takeError())
+		);
+	}
+
+	ret.module = std::move(m.get());
+	return ret;
+}
+
+/**
+ * Run @a job on a new background thread. An exception thrown by the job is
+ * rethrown by @c wait().
+ */
+void AsyncWriters::start(std::function<void()> job)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_threads.emplace_back([job = std::move(job)]()
+	{
+		try
+		{
+			job();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_error)
+			{
+				_error = std::current_exception();
+			}
+		}
+	});
+}
+
+/**
+ * Wait until all the started jobs finish. If some of them failed, the first
+ * failure is rethrown.
+ */
+void AsyncWriters::wait()
+{
+	std::vector<std::thread> threads;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		threads.swap(_threads);
+	}
+	for (auto& t : threads)
+	{
+		t.join();
+	}
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		std::swap(error, _error);
+	}
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+/**
+ * @return Number of started jobs not yet waited for.
+ */
+std::size_t AsyncWriters::running()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _threads.size();
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
@@ -853,6 +853,13 @@ llvm::Value* IrModifier::changeObjectType(
 		users.push_back(U);
 	}
 
+	// Casts of the original object are its users, they must not be reused.
+	for (auto it = _objectCasts.lower_bound({val, nullptr});
+			it != _objectCasts.end() && it->first.first == val;)
+	{
+		it = _objectCasts.erase(it);
+	}
+
 	for (auto* user : users)
 	{
 		Constant* c = dyn_cast<Constant>(user);
@@ -873,7 +880,7 @@ llvm::Value* IrModifier::changeObjectType(
 			}
 			else
 			{
-				auto* conv = IrModifier::convertValueToType(nval, origType, store);
+				auto* conv = convertObjectToType(nval, origType, store);
 				store->setOperand(0, conv);
 			}
 		}
@@ -921,7 +928,7 @@ llvm::Value* IrModifier::changeObjectType(
 			}
 			else
 			{
-				auto* conv = IrModifier::convertValueToType(nval, cast->getType(), cast);
+				auto* conv = convertObjectToType(nval, cast->getType(), cast);
 				if (cast != conv)
 				{
 					cast->replaceAllUsesWith(conv);
@@ -939,7 +946,7 @@ llvm::Value* IrModifier::changeObjectType(
 		// maybe GetElementPtrInst should be specially handled?
 		else if (auto* instr = dyn_cast<Instruction>(user))
 		{
-			auto* conv = IrModifier::convertValueToType(nval, origType, instr);
+			auto* conv = convertObjectToType(nval, origType, instr);
 			if (val != conv)
 			{
 				instr->replaceUsesOfWith(val, conv);
@@ -972,9 +979,88 @@ llvm::Value* IrModifier::changeObjectType(
 		}
 	}
 
+	if (!_applyingObjectTypeChanges)
+	{
+		_objectCasts.clear();
+	}
+
 	return nval;
 }
 
+/**
+ * Schedule change of @c val type to @c toType. It is performed, together with
+ * all the other scheduled changes, by @c applyObjectTypeChanges(). Until then,
+ * neither the IR nor the config is modified.
+ * Parameters have the same meaning as in @c changeObjectType().
+ */
+void IrModifier::scheduleObjectTypeChange(
+		llvm::Value* val,
+		llvm::Type* toType,
+		llvm::Constant* init,
+		bool wideString)
+{
+	_objectTypeChanges.push_back({val, toType, init, wideString});
+}
+
+/**
+ * Apply all the changes scheduled by @c scheduleObjectTypeChange() in the
+ * order they were scheduled. Unlike separate @c changeObjectType() calls,
+ * all the uses of a changed object which need it in the same type share
+ * a single cast, no matter which change created it.
+ * @param objf        Object file for the objects.
+ * @param instToErase See @c changeObjectType().
+ * @return Number of applied changes.
+ */
+std::size_t IrModifier::applyObjectTypeChanges(
+		FileImage* objf,
+		std::unordered_set<llvm::Instruction*>* instToErase)
+{
+	std::vector<ObjectTypeChange> changes;
+	changes.swap(_objectTypeChanges);
+
+	_applyingObjectTypeChanges = true;
+	for (auto& c : changes)
+	{
+		changeObjectType(
+				objf,
+				c.val,
+				c.toType,
+				c.init,
+				instToErase,
+				false,
+				c.wideString);
+	}
+	_applyingObjectTypeChanges = false;
+	_objectCasts.clear();
+
+	return changes.size();
+}
+
+/**
+ * Convert object @a obj, whose type was changed, to @a type for its use
+ * in @a before. Constant objects are converted by uniqued constant
+ * expressions. Casts of allocas are placed right after them, so that
+ * a single cast dominates, and is shared by, all the uses in the function.
+ */
+llvm::Value* IrModifier::convertObjectToType(
+		llvm::Value* obj,
+		llvm::Type* type,
+		llvm::Instruction* before)
+{
+	auto* alloca = dyn_cast<AllocaInst>(obj);
+	if (alloca == nullptr || obj->getType() == type)
+	{
+		return convertValueToType(obj, type, before);
+	}
+
+	auto& conv = _objectCasts[{obj, type}];
+	if (conv == nullptr)
+	{
+		conv = convertValueToTypeAfter(obj, type, alloca);
+	}
+	return conv;
+}
+
 /**
  * Inspired by ArgPromotion::DoPromotion().
  * Steps performed in ArgPromotion::DoPromotion() that are not done here:
@@ -0,0 +1,244 @@
+/**
+ * @file src/bin2llvmir/utils/ordinal_database.cpp
+ * @brief Compiled database of names of functions imported by ordinals.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <cstring>
+
+#include "retdec/bin2llvmir/utils/ordinal_database.h"
+
+namespace retdec {
+namespace bin2llvmir {
+
+namespace {
+
+const char DATABASE_MAGIC[] = "RDORDDB1";
+const std::size_t MAGIC_SIZE = sizeof(DATABASE_MAGIC) - 1;
+const std::size_t HEADER_SIZE = MAGIC_SIZE + 2 * 4;
+const std::size_t LIB_ENTRY_SIZE = 3 * 4;
+const std::size_t ORD_ENTRY_SIZE = 2 * 4;
+
+} // anonymous namespace
+
+const std::string OrdinalDatabase::fileName = "ordinals.db";
+
+std::mutex OrdinalDatabase::_mutex;
+std::map<
+		std::string,
+		std::shared_ptr<const OrdinalDatabase>> OrdinalDatabase::_databases;
+
+OrdinalDatabase::OrdinalDatabase(std::unique_ptr<llvm::MemoryBuffer> buffer) :
+		_buffer(std::move(buffer))
+{
+
+}
+
+/**
+ * Get the database from ordinals directory @p ordinalsDir. Every database is
+ * loaded only once, even if it can not be loaded.
+ * @return Loaded database, or @c nullptr if there is no valid database in the
+ *         directory.
+ */
+std::shared_ptr<const OrdinalDatabase> OrdinalDatabase::get(
+		const std::string& ordinalsDir)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto dIt = _databases.find(ordinalsDir);
+	if (dIt != _databases.end())
+	{
+		return dIt->second;
+	}
+
+	auto& db = _databases[ordinalsDir];
+
+	// Large files are mapped into memory instead of read.
+	auto buffer = llvm::MemoryBuffer::getFile(ordinalsDir + "/" + fileName);
+	if (buffer)
+	{
+		db = create(std::move(buffer.get()));
+	}
+
+	return db;
+}
+
+/**
+ * Create a database from its compiled data in @p buffer.
+ * @return Created database, or @c nullptr if the data are not valid.
+ */
+std::unique_ptr<OrdinalDatabase> OrdinalDatabase::create(
+		std::unique_ptr<llvm::MemoryBuffer> buffer)
+{
+	if (buffer == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::unique_ptr<OrdinalDatabase> db(new OrdinalDatabase(std::move(buffer)));
+	return db->init() ? std::move(db) : nullptr;
+}
+
+/**
+ * Does the database contain ordinals of library @p libName (lower case,
+ * without the @c .dll suffix) for architecture @p arch?
+ */
+bool OrdinalDatabase::hasLibrary(
+		const std::string& arch,
+		const std::string& libName) const
+{
+	std::size_t entry = 0;
+	return findLibrary(arch, libName, entry);
+}
+
+/**
+ * Get the name of the function with ordinal @p ord in library @p libName
+ * (lower case, without the @c .dll suffix) for architecture @p arch.
+ * @return Name of the function, or an empty string if it is not known. The
+ *         returned string points into the database.
+ */
+llvm::StringRef OrdinalDatabase::getName(
+		const std::string& arch,
+		const std::string& libName,
+		std::uint32_t ord) const
+{
+	std::size_t entry = 0;
+	if (!findLibrary(arch, libName, entry))
+	{
+		return llvm::StringRef();
+	}
+
+	std::uint64_t first = read32(entry + 4);
+	std::uint64_t count = read32(entry + 8);
+	if (first + count > _ordCount)
+	{
+		return llvm::StringRef();
+	}
+
+	// Binary search in the ordinals of the library.
+	std::uint64_t low = first;
+	std::uint64_t high = first + count;
+	while (low < high)
+	{
+		std::uint64_t mid = low + (high - low) / 2;
+		std::size_t ordEntry = _ordsOffset + mid * ORD_ENTRY_SIZE;
+		std::uint32_t midOrd = read32(ordEntry);
+		if (midOrd == ord)
+		{
+			return readString(read32(ordEntry + 4));
+		}
+		else if (midOrd < ord)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	return llvm::StringRef();
+}
+
+std::uint32_t OrdinalDatabase::read32(std::size_t offset) const
+{
+	auto* data = reinterpret_cast<const std::uint8_t*>(
+			_buffer->getBufferStart() + offset
+	);
+	return static_cast<std::uint32_t>(data[0])
+			| static_cast<std::uint32_t>(data[1]) << 8
+			| static_cast<std::uint32_t>(data[2]) << 16
+			| static_cast<std::uint32_t>(data[3]) << 24;
+}
+
+/**
+ * Read the NUL-terminated string at @p offset. Strings must lie in the string
+ * section, so corrupted offsets yield empty strings.
+ */
+llvm::StringRef OrdinalDatabase::readString(std::size_t offset) const
+{
+	if (offset < _stringsOffset || offset >= _buffer->getBufferSize())
+	{
+		return llvm::StringRef();
+	}
+
+	const char* start = _buffer->getBufferStart() + offset;
+	const void* end = std::memchr(
+			start,
+			'\0',
+			_buffer->getBufferSize() - offset
+	);
+	return end
+			? llvm::StringRef(start, static_cast<const char*>(end) - start)
+			: llvm::StringRef();
+}
+
+/**
+ * Check the header and compute offsets of the sections.
+ */
+bool OrdinalDatabase::init()
+{
+	std::size_t size = _buffer->getBufferSize();
+	if (size < HEADER_SIZE
+			|| std::memcmp(_buffer->getBufferStart(), DATABASE_MAGIC, MAGIC_SIZE))
+	{
+		return false;
+	}
+
+	_libCount = read32(MAGIC_SIZE);
+	_ordCount = read32(MAGIC_SIZE + 4);
+	std::uint64_t ordsOffset = HEADER_SIZE
+			+ static_cast<std::uint64_t>(_libCount) * LIB_ENTRY_SIZE;
+	std::uint64_t stringsOffset = ordsOffset
+			+ static_cast<std::uint64_t>(_ordCount) * ORD_ENTRY_SIZE;
+	if (stringsOffset > size)
+	{
+		return false;
+	}
+
+	_ordsOffset = ordsOffset;
+	_stringsOffset = stringsOffset;
+	return true;
+}
+
+/**
+ * Find the entry of library @p libName for architecture @p arch.
+ * @param[in] arch Architecture.
+ * @param[in] libName Library name.
+ * @param[out] entry Offset of the found entry.
+ * @return @c True if the library was found, @c false otherwise.
+ */
+bool OrdinalDatabase::findLibrary(
+		const std::string& arch,
+		const std::string& libName,
+		std::size_t& entry) const
+{
+	std::string key = arch + "/" + libName;
+
+	std::size_t low = 0;
+	std::size_t high = _libCount;
+	while (low < high)
+	{
+		std::size_t mid = low + (high - low) / 2;
+		std::size_t midEntry = HEADER_SIZE + mid * LIB_ENTRY_SIZE;
+		int cmp = readString(read32(midEntry)).compare(key);
+		if (cmp == 0)
+		{
+			entry = midEntry;
+			return true;
+		}
+		else if (cmp < 0)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	return false;
+}
+
+} // namespace bin2llvmir
+} // namespace retdec
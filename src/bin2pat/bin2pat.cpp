@@ -4,13 +4,20 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
+#include <memory>
 #include <ostream>
 #include <vector>
 
+#include "retdec/ar-extractor/archive_wrapper.h"
+#include "retdec/ar-extractor/detection.h"
+#include "retdec/utils/conversion.h"
 #include "retdec/utils/filesystem.h"
 #include "retdec/utils/io/log.h"
+#include "retdec/utils/parallel.h"
 #include "retdec/utils/version.h"
 #include "retdec/patterngen/pattern_extractor/pattern_extractor.h"
 #include "yaramod/yaramod.h"
@@ -25,10 +32,27 @@
 using namespace retdec::utils;
 using namespace retdec::utils::io;
 using namespace retdec::patterngen;
+using namespace retdec::ar_extractor;
+
+/**
+ * Number of objects processed by one thread before results are merged.
+ */
+const std::size_t OBJECTS_PER_THREAD_BATCH = 64;
+
+/**
+ * Object file to process - either a whole input file or a member of
+ * an input archive that is read in place.
+ */
+struct InputObject
+{
+	std::string path;                   ///< Path used in messages and rules.
+	const std::uint8_t *data = nullptr; ///< Archive member, nullptr for file.
+	std::size_t size = 0;               ///< Size of archive member.
+};
 
 void printUsage(Logger &log)
 {
-	log << "Usage: bin2pat [-o OUTPUT_FILE] [-n NOTE]"
+	log << "Usage: bin2pat [-o OUTPUT_FILE] [-n NOTE] [-j JOBS]"
 		<< " <INPUT_FILE [INPUT_FILE...] | -l LIST_FILE>\n\n"
 		<< "-h --help\n"
 		<< "    Show this help.\n\n"
@@ -42,7 +66,12 @@ void printUsage(Logger &log)
 		<< "    If multiple notes are given, only last one is used.\n\n"
 		<< "-l --list LIST_FILE\n"
 		<< "    Optionally pass the list of input files as a text file.\n"
-		<< "    This is useful for a large number of input files.\n\n";
+		<< "    This is useful for a large number of input files.\n\n"
+		<< "-j --jobs JOBS\n"
+		<< "    Number of objects processed in parallel (default: 1).\n"
+		<< "    Output does not depend on this number.\n\n"
+		<< "Input files may be archives (.a), their members are processed\n"
+		<< "without extraction.\n\n";
 }
 
 void printErrorAndDie(
@@ -64,6 +93,7 @@ void processArgs(const std::vector<std::string> &args)
 	std::string note;
 	std::string outPath;
 	std::vector<std::string> inPaths;
+	unsigned jobs = 1;
 
 	for (std::size_t i = 0, e = args.size(); i < e; ++i) {
 		if (args[i] == "--help" || args[i] == "-h") {
@@ -93,6 +123,18 @@ void processArgs(const std::vector<std::string> &args)
 				return;
 			}
 		}
+		else if (args[i] == "-j" || args[i] == "--jobs") {
+			if (i + 1 < e) {
+				if (!strToNum(args[++i], jobs) || jobs == 0) {
+					printErrorAndDie("invalid number of jobs '" + args[i] + "'");
+					return;
+				}
+			}
+			else {
+				needValue(args[i]);
+				return;
+			}
+		}
 		else if (args[i] == "-l" || args[i] == "--list") {
 			// Ensure -l --list is not the last thing in args
 			if (&args[i] == &args.back()) {
@@ -140,35 +182,80 @@ void processArgs(const std::vector<std::string> &args)
 		return;
 	}
 
+	// Collect objects. Archives are kept open while their members are
+	// processed in place.
+	std::vector<std::unique_ptr<ArchiveWrapper>> archives;
+	std::vector<InputObject> objects;
+	for (const auto &path : inPaths) {
+		if (!isArchive(path)) {
+			objects.push_back({path});
+			continue;
+		}
+
+		bool success = false;
+		std::string errorMessage;
+		auto archive = std::make_unique<ArchiveWrapper>(
+			path, success, errorMessage);
+		std::vector<InputObject> members;
+		if (!success || !archive->forEachMember(
+				[&](const std::string &name, llvm::ArrayRef<std::uint8_t> data) {
+					members.push_back({path + "(" + name + ")",
+						data.data(), data.size()});
+				}, errorMessage)) {
+			Log::error() << Log::Error << "archive '" << path << "' was not processed.\n";
+			Log::error() << "Problem: " << errorMessage << ".\n\n";
+			continue;
+		}
+
+		objects.insert(objects.end(), members.begin(), members.end());
+		archives.push_back(std::move(archive));
+	}
+
 	// Prepare builder.
 	yaramod::YaraFileBuilder builder;
 
-	// Process files.
-	unsigned index = 0;
+	// Process objects. Patterns are extracted in parallel by batches and
+	// added to builder in the order of objects, so output is the same for
+	// any number of jobs.
 	bool atLeastOne = false;
-	for (const auto &path : inPaths) {
-		PatternExtractor extractor(path, "file_" + std::to_string(index++));
-
-		// Add rules if valid.
-		if (!extractor.isValid()) {
-			// Sometimes, non-supported files are present in archives. We will
-			// only print warning if such a file is encountered.
-			Log::error() << Log::Error << "file '" << path << "' was not processed.\n";
-			Log::error() << "Problem: " << extractor.getErrorMessage() << ".\n\n";
-			continue;
-		}
-		else {
-			atLeastOne = true;
-			extractor.addRulesToBuilder(builder, note);
-
-			// Print warnings if any.
-			const auto &warnings = extractor.getWarnings();
-			if (!warnings.empty()) {
-				Log::error() << Log::Warning << "problems with file '" << path << "'\n";
-				for (const auto &warning : warnings) {
-					Log::error() << "Problem: " << warning << ".\n";
+	const std::size_t batchSize = OBJECTS_PER_THREAD_BATCH * jobs;
+	for (std::size_t first = 0; first < objects.size(); first += batchSize) {
+		const auto count = std::min(batchSize, objects.size() - first);
+		std::vector<std::unique_ptr<PatternExtractor>> extractors(count);
+		parallelFor(count, jobs, [&](std::size_t i) {
+			const auto &object = objects[first + i];
+			const auto groupName = "file_" + std::to_string(first + i);
+			extractors[i] = object.data
+				? std::make_unique<PatternExtractor>(object.data,
+					object.size, object.path, groupName)
+				: std::make_unique<PatternExtractor>(object.path, groupName);
+		});
+
+		for (std::size_t i = 0; i < count; ++i) {
+			const auto &path = objects[first + i].path;
+			const auto &extractor = *extractors[i];
+
+			// Add rules if valid.
+			if (!extractor.isValid()) {
+				// Sometimes, non-supported files are present in archives. We
+				// will only print warning if such a file is encountered.
+				Log::error() << Log::Error << "file '" << path << "' was not processed.\n";
+				Log::error() << "Problem: " << extractor.getErrorMessage() << ".\n\n";
+				continue;
+			}
+			else {
+				atLeastOne = true;
+				extractor.addRulesToBuilder(builder, note);
+
+				// Print warnings if any.
+				const auto &warnings = extractor.getWarnings();
+				if (!warnings.empty()) {
+					Log::error() << Log::Warning << "problems with file '" << path << "'\n";
+					for (const auto &warning : warnings) {
+						Log::error() << "Problem: " << warning << ".\n";
+					}
+					Log::error() << "\n";
 				}
-				Log::error() << "\n";
 			}
 		}
 	}
@@ -128,6 +128,32 @@ void Capstone2LlvmIrTranslatorArm_impl::translateInstruction(
 	}
 }
 
+/**
+ * Instructions that change control flow or use PC depend on their address.
+ */
+bool Capstone2LlvmIrTranslatorArm_impl::isTranslationCacheable(cs_insn* i)
+{
+	if (isControlFlowInstruction(*i))
+	{
+		return false;
+	}
+
+	cs_arm* ai = &i->detail->arm;
+	for (std::size_t k = 0; k < ai->op_count; ++k)
+	{
+		auto& op = ai->operands[k];
+		if ((op.type == ARM_OP_REG && op.reg == ARM_REG_PC)
+				|| (op.type == ARM_OP_MEM
+						&& (op.mem.base == ARM_REG_PC
+						|| op.mem.index == ARM_REG_PC)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 //
 //==============================================================================
 // ARM-specific methods.
@@ -49,6 +49,7 @@ class Capstone2LlvmIrTranslatorArm_impl :
 		virtual void translateInstruction(
 				cs_insn* i,
 				llvm::IRBuilder<>& irb) override;
+		virtual bool isTranslationCacheable(cs_insn* i) override;
 //
 //==============================================================================
 // ARM-specific methods.
@@ -31,9 +31,27 @@ Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::Capstone2LlvmIrTranslator_impl(
 template <typename CInsn, typename CInsnOp>
 Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::~Capstone2LlvmIrTranslator_impl()
 {
+	clearTranslationCache();
 	closeHandle();
 }
 
+template <typename CInsn, typename CInsnOp>
+std::unique_ptr<Capstone2LlvmIrTranslator>
+Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::clone(llvm::Module* m) const
+{
+	auto c = createArch(_arch, m, _origBasicMode, _extraMode);
+	if (_basicMode != _origBasicMode)
+	{
+		c->modifyBasicMode(_basicMode);
+	}
+	c->setIgnoreUnexpectedOperands(_ignoreUnexpectedOperands);
+	c->setIgnoreUnhandledInstructions(_ignoreUnhandledInstructions);
+	c->setGeneratePseudoAsmFunctions(_generatePseudoAsmFunctions);
+	c->setUseTranslationCache(isUseTranslationCache());
+	c->setLazyFlags(isLazyFlags());
+	return c;
+}
+
 //
 //==============================================================================
 // Translator configuration methods.
@@ -58,6 +76,52 @@ void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::setGeneratePseudoAsmFunctio
 	_generatePseudoAsmFunctions = f;
 }
 
+template <typename CInsn, typename CInsnOp>
+void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::setInstructionPool(
+		CapstoneInsnPool* pool)
+{
+	_insnPool = pool;
+}
+
+template <typename CInsn, typename CInsnOp>
+void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::setUseTranslationCache(
+		bool f)
+{
+	if (f && _translationCache == nullptr)
+	{
+		_translationCache = std::make_unique<TranslationCache>(_arch);
+	}
+	else if (!f)
+	{
+		_translationCache.reset();
+	}
+}
+
+template <typename CInsn, typename CInsnOp>
+void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::clearTranslationCache()
+{
+	if (_translationCache)
+	{
+		_translationCache->clear();
+	}
+}
+
+template <typename CInsn, typename CInsnOp>
+void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::setLazyFlags(bool f)
+{
+	_lazyFlagRegisters.clear();
+	if (f)
+	{
+		for (auto r : getLazyFlagRegisters())
+		{
+			if (auto* gv = getRegister(r))
+			{
+				_lazyFlagRegisters.insert(gv);
+			}
+		}
+	}
+}
+
 template <typename CInsn, typename CInsnOp>
 bool Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::isIgnoreUnexpectedOperands() const
 {
@@ -76,6 +140,24 @@ bool Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::isGeneratePseudoAsmFunction
 	return _generatePseudoAsmFunctions;
 }
 
+template <typename CInsn, typename CInsnOp>
+CapstoneInsnPool* Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::getInstructionPool() const
+{
+	return _insnPool;
+}
+
+template <typename CInsn, typename CInsnOp>
+bool Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::isUseTranslationCache() const
+{
+	return _translationCache != nullptr;
+}
+
+template <typename CInsn, typename CInsnOp>
+bool Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::isLazyFlags() const
+{
+	return !_lazyFlagRegisters.empty();
+}
+
 //
 //==============================================================================
 // Mode query & modification methods - from Capstone2LlvmIrTranslator.
@@ -173,7 +255,7 @@ Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translate(
 	TranslationResult res;
 
 	// We want to keep all Capstone instructions -> alloc a new one each time.
-	cs_insn* insn = cs_malloc(_handle);
+	cs_insn* insn = allocateInsn();
 
 	uint64_t address = a;
 
@@ -196,7 +278,7 @@ Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translate(
 		res.insns.push_back(std::make_pair(a2l, insn));
 		res.size = (insn->address + insn->size) - a;
 
-		translateInstruction(insn, irb);
+		translateInstructionCached(insn, irb);
 
 		++res.count;
 		if (count && count == res.count)
@@ -211,7 +293,7 @@ Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translate(
 			return res;
 		}
 
-		insn = cs_malloc(_handle);
+		insn = allocateInsn();
 
 		// TODO: hack, solve better.
 		disasmRes = cs_disasm_iter(_handle, &bytes, &size, &address, insn);
@@ -223,7 +305,7 @@ Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translate(
 		}
 	}
 
-	cs_free(insn, 1);
+	freeInsn(insn);
 
 	return res;
 }
@@ -239,7 +321,7 @@ Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translateOne(
 	TranslationResultOne res;
 
 	// We want to keep all Capstone instructions -> alloc a new one each time.
-	cs_insn* insn = cs_malloc(_handle);
+	cs_insn* insn = allocateInsn();
 
 	uint64_t address = a;
 	_branchGenerated = nullptr;
@@ -257,7 +339,7 @@ Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translateOne(
 	if (disasmRes)
 	{
 		auto* a2l = generateSpecialAsm2LlvmInstr(irb, insn);
-		translateInstruction(insn, irb);
+		translateInstructionCached(insn, irb);
 
 		res.llvmInsn = a2l;
 		res.capstoneInsn = insn;
@@ -269,12 +351,35 @@ Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translateOne(
 	}
 	else
 	{
-		cs_free(insn, 1);
+		freeInsn(insn);
 	}
 
 	return res;
 }
 
+template <typename CInsn, typename CInsnOp>
+typename Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::TranslationResultOne
+Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translateDisassembled(
+		cs_insn* insn,
+		llvm::IRBuilder<>& irb)
+{
+	TranslationResultOne res;
+
+	_branchGenerated = nullptr;
+	_inCondition = false;
+
+	auto* a2l = generateSpecialAsm2LlvmInstr(irb, insn);
+	translateInstructionCached(insn, irb);
+
+	res.llvmInsn = a2l;
+	res.capstoneInsn = insn;
+	res.size = insn->size;
+	res.branchCall = _branchGenerated;
+	res.inCondition = _inCondition;
+
+	return res;
+}
+
 //
 //==============================================================================
 // Capstone related getters - from Capstone2LlvmIrTranslator.
@@ -678,6 +783,15 @@ const std::set<llvm::Function*>& Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>:
 	return _asmFunctions;
 }
 
+template <typename CInsn, typename CInsnOp>
+void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::addPseudoAsmFunction(
+		llvm::Function* f)
+{
+	auto p = std::make_pair(f->getName().str(), f->getFunctionType());
+	_insn2asmFunctions.emplace(p, f);
+	_asmFunctions.insert(f);
+}
+
 //
 //==============================================================================
 //
@@ -2265,6 +2379,170 @@ void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translatePseudoAsmGeneric(
 	}
 }
 
+/**
+ * Allocate a new Capstone instruction, either from the instruction pool
+ * (if set) or by @c cs_malloc().
+ */
+template <typename CInsn, typename CInsnOp>
+cs_insn* Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::allocateInsn()
+{
+	return _insnPool ? _insnPool->allocate() : cs_malloc(_handle);
+}
+
+/**
+ * Free Capstone instruction @a i allocated by @c allocateInsn().
+ */
+template <typename CInsn, typename CInsnOp>
+void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::freeInsn(cs_insn* i)
+{
+	if (_insnPool)
+	{
+		_insnPool->release(i);
+	}
+	else
+	{
+		cs_free(i, 1);
+	}
+}
+
+template <typename CInsn, typename CInsnOp>
+bool Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::isTranslationCacheable(
+		cs_insn*)
+{
+	return false;
+}
+
+template <typename CInsn, typename CInsnOp>
+std::vector<uint32_t> Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::getLazyFlagRegisters() const
+{
+	return {};
+}
+
+/**
+ * Translate single Capstone instruction @a i, or replay its memoized
+ * translation if the translation cache is used. If flags are lazy, flags
+ * overwritten by the translation are erased afterwards.
+ */
+template <typename CInsn, typename CInsnOp>
+void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::translateInstructionCached(
+		cs_insn* i,
+		llvm::IRBuilder<>& irb)
+{
+	auto* bb = irb.GetInsertBlock();
+	auto ip = irb.GetInsertPoint();
+	bool atBegin = ip == bb->begin();
+	auto prev = atBegin ? bb->end() : std::prev(ip);
+	// The translation stayed in the builder's basic block.
+	auto inBlock = [&]()
+	{
+		return irb.GetInsertBlock() == bb && irb.GetInsertPoint() == ip;
+	};
+
+	if (_translationCache == nullptr || !isTranslationCacheable(i))
+	{
+		translateInstruction(i, irb);
+	}
+	else
+	{
+		auto key = _translationCache->getKey(
+				i,
+				static_cast<cs_mode>(_basicMode + _extraMode));
+		if (_translationCache->replay(key, irb))
+		{
+			_insn = i;
+		}
+		else
+		{
+			translateInstruction(i, irb);
+
+			// Translations that split the block or change control flow can
+			// not be replayed.
+			if (inBlock() && _branchGenerated == nullptr && !_inCondition)
+			{
+				auto first = atBegin ? bb->begin() : std::next(prev);
+				_translationCache->record(key, first, ip);
+			}
+			else
+			{
+				_translationCache->reject(key);
+			}
+		}
+	}
+
+	if (!_lazyFlagRegisters.empty() && inBlock())
+	{
+		eraseOverwrittenFlagStores(atBegin ? bb->begin() : std::next(prev), ip);
+	}
+}
+
+/**
+ * Erase stores of lazy flag registers that are overwritten by stores in
+ * <@a first, @a end) before they could be read, i.e. without a load of the
+ * flag or a call in between. Computations of the erased flags are erased as
+ * well, if they are not used by anything else.
+ */
+template <typename CInsn, typename CInsnOp>
+void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::eraseOverwrittenFlagStores(
+		llvm::BasicBlock::iterator first,
+		llvm::BasicBlock::iterator end)
+{
+	for (auto it = first; it != end; ++it)
+	{
+		auto* s = llvm::dyn_cast<llvm::StoreInst>(&*it);
+		auto* flag = s ? s->getPointerOperand() : nullptr;
+		if (flag == nullptr
+				|| _lazyFlagRegisters.count(
+						llvm::dyn_cast<llvm::GlobalVariable>(flag)) == 0)
+		{
+			continue;
+		}
+
+		llvm::StoreInst* overwritten = nullptr;
+		for (auto* p = s->getPrevNode(); p; p = p->getPrevNode())
+		{
+			if (llvm::isa<llvm::CallInst>(p))
+			{
+				break;
+			}
+			else if (auto* l = llvm::dyn_cast<llvm::LoadInst>(p))
+			{
+				if (l->getPointerOperand() == flag)
+				{
+					break;
+				}
+			}
+			else if (auto* ps = llvm::dyn_cast<llvm::StoreInst>(p))
+			{
+				if (ps->getPointerOperand() == flag)
+				{
+					overwritten = ps;
+					break;
+				}
+			}
+		}
+		if (overwritten == nullptr)
+		{
+			continue;
+		}
+
+		std::vector<llvm::Instruction*> worklist = {overwritten};
+		while (!worklist.empty())
+		{
+			auto* insn = worklist.back();
+			worklist.pop_back();
+			for (auto& op : insn->operands())
+			{
+				auto* opInsn = llvm::dyn_cast<llvm::Instruction>(op.get());
+				if (opInsn && opInsn->hasOneUse() && !opInsn->mayHaveSideEffects())
+				{
+					worklist.push_back(opInsn);
+				}
+			}
+			insn->eraseFromParent();
+		}
+	}
+}
+
 template <typename CInsn, typename CInsnOp>
 void Capstone2LlvmIrTranslator_impl<CInsn, CInsnOp>::throwUnexpectedOperands(
 		cs_insn* i,
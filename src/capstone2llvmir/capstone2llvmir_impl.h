@@ -8,7 +8,10 @@
 #ifndef CAPSTONE2LLVMIR_CAPSTONE2LLVMIR_IMPL_H
 #define CAPSTONE2LLVMIR_CAPSTONE2LLVMIR_IMPL_H
 
+#include <memory>
+
 #include "capstone2llvmir/llvmir_utils.h"
+#include "capstone2llvmir/translation_cache.h"
 #include "retdec/capstone2llvmir/capstone2llvmir.h"
 
 namespace retdec {
@@ -37,6 +40,9 @@ class Capstone2LlvmIrTranslator_impl : virtual public Capstone2LlvmIrTranslator
 				cs_mode extra,
 				llvm::Module* m);
 		virtual ~Capstone2LlvmIrTranslator_impl();
+
+		virtual std::unique_ptr<Capstone2LlvmIrTranslator> clone(
+				llvm::Module* m) const override;
 //
 //==============================================================================
 // Translator configuration methods.
@@ -45,10 +51,17 @@ class Capstone2LlvmIrTranslator_impl : virtual public Capstone2LlvmIrTranslator
 		virtual void setIgnoreUnexpectedOperands(bool f) override;
 		virtual void setIgnoreUnhandledInstructions(bool f) override;
 		virtual void setGeneratePseudoAsmFunctions(bool f) override;
+		virtual void setInstructionPool(CapstoneInsnPool* pool) override;
+		virtual void setUseTranslationCache(bool f) override;
+		virtual void clearTranslationCache() override;
+		virtual void setLazyFlags(bool f) override;
 
 		virtual bool isIgnoreUnexpectedOperands() const override;
 		virtual bool isIgnoreUnhandledInstructions() const override;
 		virtual bool isGeneratePseudoAsmFunctions() const override;
+		virtual CapstoneInsnPool* getInstructionPool() const override;
+		virtual bool isUseTranslationCache() const override;
+		virtual bool isLazyFlags() const override;
 //
 //==============================================================================
 // Mode query & modification methods - from Capstone2LlvmIrTranslator.
@@ -77,6 +90,9 @@ class Capstone2LlvmIrTranslator_impl : virtual public Capstone2LlvmIrTranslator
 				std::size_t& size,
 				retdec::common::Address& a,
 				llvm::IRBuilder<>& irb) override;
+		virtual TranslationResultOne translateDisassembled(
+				cs_insn* insn,
+				llvm::IRBuilder<>& irb) override;
 //
 //==============================================================================
 // Capstone related getters - from Capstone2LlvmIrTranslator.
@@ -145,6 +161,7 @@ class Capstone2LlvmIrTranslator_impl : virtual public Capstone2LlvmIrTranslator
 		virtual bool isPseudoAsmFunction(llvm::Function* f) const override;
 		virtual bool isPseudoAsmFunctionCall(llvm::CallInst* c) const override;
 		virtual const std::set<llvm::Function*>& getPseudoAsmFunctions() const override;
+		virtual void addPseudoAsmFunction(llvm::Function* f) override;
 //
 //==============================================================================
 // Common implementation enums, structures, classes, etc.
@@ -268,6 +285,21 @@ class Capstone2LlvmIrTranslator_impl : virtual public Capstone2LlvmIrTranslator
 		virtual void translateInstruction(
 				cs_insn* i,
 				llvm::IRBuilder<>& irb) = 0;
+
+		/**
+		 * @return @c True if LLVM IR generated for instruction @a i may be
+		 * replayed for all the other instructions with the same encoding,
+		 * i.e. if it does not depend on the instruction's address.
+		 * Nothing is memoized by default.
+		 */
+		virtual bool isTranslationCacheable(cs_insn* i);
+
+		/**
+		 * @return Capstone flag registers whose stores may be removed if
+		 * they are overwritten before they are read (see @c setLazyFlags()).
+		 * There are no such registers by default.
+		 */
+		virtual std::vector<uint32_t> getLazyFlagRegisters() const;
 //
 //==============================================================================
 // Virtual translation initialization and environment generation methods.
@@ -596,6 +628,11 @@ class Capstone2LlvmIrTranslator_impl : virtual public Capstone2LlvmIrTranslator
 		virtual uint8_t getOperandAccess(CInsnOp& op);
 		virtual void translatePseudoAsmGeneric(cs_insn* i, CInsn* ci, llvm::IRBuilder<>& irb);
 
+		void translateInstructionCached(cs_insn* i, llvm::IRBuilder<>& irb);
+		void eraseOverwrittenFlagStores(
+				llvm::BasicBlock::iterator first,
+				llvm::BasicBlock::iterator end);
+
 		void throwUnexpectedOperands(cs_insn* i, const std::string comment = "");
 		void throwUnhandledInstructions(cs_insn* i, const std::string comment = "");
 
@@ -685,6 +722,10 @@ class Capstone2LlvmIrTranslator_impl : virtual public Capstone2LlvmIrTranslator
 		bool _ignoreUnexpectedOperands = true;
 		bool _ignoreUnhandledInstructions = true;
 		bool _generatePseudoAsmFunctions = true;
+		CapstoneInsnPool* _insnPool = nullptr;
+		std::unique_ptr<TranslationCache> _translationCache;
+		/// Flag registers materialized lazily, empty if flags are not lazy.
+		std::set<llvm::GlobalVariable*> _lazyFlagRegisters;
 };
 
 //
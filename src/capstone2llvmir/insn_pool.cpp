@@ -0,0 +1,129 @@
+/**
+ * @file src/capstone2llvmir/insn_pool.cpp
+ * @brief Pooled storage of Capstone instructions.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+#include <cstddef>
+
+#include "retdec/capstone2llvmir/insn_pool.h"
+
+namespace retdec {
+namespace capstone2llvmir {
+
+namespace {
+
+std::size_t alignDetailSize(std::size_t size)
+{
+	const std::size_t a = alignof(cs_detail);
+	return (size + a - 1) / a * a;
+}
+
+} // anonymous namespace
+
+/**
+ * @param arch Architecture of instructions allocated from the pool.
+ * @param chunkSize Number of instructions allocated at once.
+ */
+CapstoneInsnPool::CapstoneInsnPool(cs_arch arch, std::size_t chunkSize) :
+		_chunkSize(chunkSize ? chunkSize : 1),
+		_detailSize(getDetailSize(arch))
+{
+
+}
+
+/**
+ * @return Byte size of the @c cs_detail prefix used by instructions of
+ *         architecture @a arch.
+ */
+std::size_t CapstoneInsnPool::getDetailSize(cs_arch arch)
+{
+	std::size_t sz = sizeof(cs_detail);
+	switch (arch)
+	{
+		case CS_ARCH_ARM:
+			sz = offsetof(cs_detail, arm) + sizeof(cs_arm);
+			break;
+		case CS_ARCH_ARM64:
+			sz = offsetof(cs_detail, arm64) + sizeof(cs_arm64);
+			break;
+		case CS_ARCH_MIPS:
+			sz = offsetof(cs_detail, mips) + sizeof(cs_mips);
+			break;
+		case CS_ARCH_PPC:
+			sz = offsetof(cs_detail, ppc) + sizeof(cs_ppc);
+			break;
+		case CS_ARCH_X86:
+			sz = offsetof(cs_detail, x86) + sizeof(cs_x86);
+			break;
+		default:
+			break;
+	}
+	return alignDetailSize(sz);
+}
+
+std::size_t CapstoneInsnPool::getDetailSize() const
+{
+	return _detailSize;
+}
+
+/**
+ * @return Zero initialized instruction with a detail, ready to be filled by
+ *         @c cs_disasm_iter().
+ */
+cs_insn* CapstoneInsnPool::allocate()
+{
+	if (_chunks.empty() || _used == _chunkSize)
+	{
+		addChunk();
+	}
+
+	auto& c = _chunks.back();
+	cs_insn* insn = &c.insns[_used];
+	insn->detail = reinterpret_cast<cs_detail*>(
+			c.details.get() + _used * _detailSize);
+	++_used;
+	return insn;
+}
+
+/**
+ * Returns instruction @a insn to the pool. Only the last allocated
+ * instruction can be reused, other instructions are kept until the pool is
+ * destroyed. It is meant for instructions that failed to disassemble.
+ */
+void CapstoneInsnPool::release(cs_insn* insn)
+{
+	if (insn == nullptr || _chunks.empty() || _used == 0)
+	{
+		return;
+	}
+
+	auto& c = _chunks.back();
+	if (insn == &c.insns[_used - 1])
+	{
+		--_used;
+		*insn = cs_insn();
+		std::fill_n(c.details.get() + _used * _detailSize, _detailSize, 0);
+	}
+}
+
+/**
+ * @return Number of instructions allocated from the pool.
+ */
+std::size_t CapstoneInsnPool::size() const
+{
+	return _chunks.empty() ? 0 : (_chunks.size() - 1) * _chunkSize + _used;
+}
+
+void CapstoneInsnPool::addChunk()
+{
+	Chunk c;
+	c.insns.reset(new cs_insn[_chunkSize]());
+	c.details.reset(new unsigned char[_chunkSize * _detailSize]());
+	_chunks.push_back(std::move(c));
+	_used = 0;
+}
+
+} // namespace capstone2llvmir
+} // namespace retdec
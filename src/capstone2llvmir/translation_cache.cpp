@@ -0,0 +1,265 @@
+/**
+ * @file src/capstone2llvmir/translation_cache.cpp
+ * @brief Memoization of LLVM IR generated for Capstone instructions.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <map>
+
+#include <llvm/IR/Constant.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+
+#include "capstone2llvmir/translation_cache.h"
+#include "retdec/capstone2llvmir/insn_pool.h"
+
+namespace retdec {
+namespace capstone2llvmir {
+
+namespace {
+
+/// Maximal number of templates, instructions are translated as usual when
+/// it is reached.
+const std::size_t MAX_TEMPLATES = 1 << 16;
+
+const llvm::Instruction* toInstruction(const llvm::Instruction& i)
+{
+	return &i;
+}
+
+const llvm::Instruction* toInstruction(const llvm::Instruction* i)
+{
+	return i;
+}
+
+/**
+ * Clone instructions <@a first, @a end), operands that are the cloned
+ * instructions are replaced by their clones.
+ * @return Clones, or an empty vector if some operand is neither a constant,
+ *         nor a cloned instruction.
+ */
+template <typename Iterator>
+std::vector<llvm::Instruction*> cloneInstructions(Iterator first, Iterator end)
+{
+	std::vector<llvm::Instruction*> clones;
+	std::map<const llvm::Value*, llvm::Value*> old2new;
+	bool ok = true;
+
+	for (auto it = first; it != end && ok; ++it)
+	{
+		const llvm::Instruction* i = toInstruction(*it);
+		if (i->isTerminator() || llvm::isa<llvm::PHINode>(i))
+		{
+			ok = false;
+			break;
+		}
+
+		auto* c = i->clone();
+		c->setName(i->getName());
+		clones.push_back(c);
+		old2new[i] = c;
+
+		for (unsigned k = 0; k < c->getNumOperands(); ++k)
+		{
+			auto* op = c->getOperand(k);
+			auto fIt = old2new.find(op);
+			if (fIt != old2new.end())
+			{
+				c->setOperand(k, fIt->second);
+			}
+			else if (!llvm::isa<llvm::Constant>(op))
+			{
+				ok = false;
+				break;
+			}
+		}
+	}
+
+	if (!ok)
+	{
+		for (auto* c : clones)
+		{
+			c->dropAllReferences();
+		}
+		for (auto* c : clones)
+		{
+			c->deleteValue();
+		}
+		clones.clear();
+	}
+
+	return clones;
+}
+
+} // anonymous namespace
+
+/**
+ * @param arch Architecture of the translated instructions.
+ */
+TranslationCache::TranslationCache(cs_arch arch) :
+		_detailSize(CapstoneInsnPool::getDetailSize(arch))
+{
+
+}
+
+TranslationCache::~TranslationCache()
+{
+	clear();
+}
+
+/**
+ * @return Key of instruction @a i disassembled in mode @a mode. It consists
+ *         of the mode, the instruction encoding, and its arch-specific detail
+ *         (e.g. an ARM condition code that depends on an IT block).
+ */
+std::string TranslationCache::getKey(const cs_insn* i, cs_mode mode) const
+{
+	std::string key;
+	key.reserve(sizeof(mode) + sizeof(i->id) + i->size + _detailSize);
+	key.append(reinterpret_cast<const char*>(&mode), sizeof(mode));
+	key.append(reinterpret_cast<const char*>(&i->id), sizeof(i->id));
+	key.append(reinterpret_cast<const char*>(i->bytes), i->size);
+	if (i->detail)
+	{
+		key.append(reinterpret_cast<const char*>(i->detail), _detailSize);
+	}
+	return key;
+}
+
+/**
+ * Replay the template of @a key at the insert point of @a irb.
+ * @return @c True if the template was replayed, @c false if there is no
+ *         replayable template of @a key.
+ */
+bool TranslationCache::replay(const std::string& key, llvm::IRBuilder<>& irb)
+{
+	auto fIt = _templates.find(key);
+	if (fIt == _templates.end() || !fIt->second.replayable)
+	{
+		return false;
+	}
+
+	auto& t = fIt->second;
+	for (auto& c : t.constants)
+	{
+		if (c.value == nullptr)
+		{
+			// Value used by the template was deleted.
+			reject(key);
+			return false;
+		}
+	}
+
+	auto& insns = t.insns;
+	auto clones = cloneInstructions(insns.begin(), insns.end());
+	if (clones.size() != insns.size())
+	{
+		return false;
+	}
+	for (auto& c : t.constants)
+	{
+		clones[c.insn]->setOperand(c.op, c.value);
+	}
+
+	for (std::size_t k = 0; k < clones.size(); ++k)
+	{
+		irb.Insert(clones[k], insns[k]->getName());
+	}
+
+	++_hits;
+	return true;
+}
+
+/**
+ * Record instructions <@a first, @a end) generated for @a key as its template.
+ * If they can not be replayed, @a key is rejected.
+ */
+void TranslationCache::record(
+		const std::string& key,
+		llvm::BasicBlock::iterator first,
+		llvm::BasicBlock::iterator end)
+{
+	if (_templates.size() >= MAX_TEMPLATES || _templates.count(key))
+	{
+		return;
+	}
+
+	Template t;
+	t.insns = cloneInstructions(first, end);
+	t.replayable = first == end || !t.insns.empty();
+
+	for (std::size_t i = 0; i < t.insns.size(); ++i)
+	{
+		auto* insn = t.insns[i];
+		for (unsigned k = 0; k < insn->getNumOperands(); ++k)
+		{
+			if (auto* c = llvm::dyn_cast<llvm::Constant>(insn->getOperand(k)))
+			{
+				t.constants.push_back(ConstantOperand{i, k, c});
+				insn->setOperand(k, llvm::UndefValue::get(c->getType()));
+			}
+		}
+	}
+
+	_templates.emplace(key, std::move(t));
+}
+
+/**
+ * Never replay translation of instructions with @a key.
+ */
+void TranslationCache::reject(const std::string& key)
+{
+	if (_templates.size() >= MAX_TEMPLATES)
+	{
+		return;
+	}
+
+	auto& t = _templates[key];
+	deleteTemplate(t);
+	t.replayable = false;
+}
+
+/**
+ * Delete all the templates.
+ */
+void TranslationCache::clear()
+{
+	for (auto& p : _templates)
+	{
+		deleteTemplate(p.second);
+	}
+	_templates.clear();
+}
+
+/**
+ * @return Number of recorded keys (including the rejected ones).
+ */
+std::size_t TranslationCache::size() const
+{
+	return _templates.size();
+}
+
+/**
+ * @return Number of replayed templates.
+ */
+std::size_t TranslationCache::getHits() const
+{
+	return _hits;
+}
+
+void TranslationCache::deleteTemplate(Template& t)
+{
+	for (auto* i : t.insns)
+	{
+		i->dropAllReferences();
+	}
+	for (auto* i : t.insns)
+	{
+		i->deleteValue();
+	}
+	t.insns.clear();
+	t.constants.clear();
+}
+
+} // namespace capstone2llvmir
+} // namespace retdec
@@ -0,0 +1,89 @@
+/**
+ * @file src/capstone2llvmir/translation_cache.h
+ * @brief Memoization of LLVM IR generated for Capstone instructions.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef CAPSTONE2LLVMIR_TRANSLATION_CACHE_H
+#define CAPSTONE2LLVMIR_TRANSLATION_CACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/IR/ValueHandle.h>
+
+#include <capstone/capstone.h>
+
+namespace retdec {
+namespace capstone2llvmir {
+
+/**
+ * LLVM IR generated for Capstone instructions, indexed by the instruction
+ * encoding and its decoded detail.
+ *
+ * The first translation of an instruction is recorded as a template (detached
+ * copies of the generated LLVM IR instructions), all the following
+ * instructions with the same key replay the template at the builder's insert
+ * point. Constant operands of the copies are replaced by undefined values and
+ * patched on replay, so the templates are not users of the module's globals.
+ * Only translations that stay in the builder's basic block and that use no
+ * values other than constants, globals and their own instructions can be
+ * recorded. It is up to the translator to use the cache only for
+ * instructions whose translation does not depend on their address and on any
+ * translator state.
+ */
+class TranslationCache
+{
+	public:
+		explicit TranslationCache(cs_arch arch);
+		~TranslationCache();
+		TranslationCache(const TranslationCache&) = delete;
+		TranslationCache& operator=(const TranslationCache&) = delete;
+
+		std::string getKey(const cs_insn* i, cs_mode mode) const;
+
+		bool replay(const std::string& key, llvm::IRBuilder<>& irb);
+		void record(
+				const std::string& key,
+				llvm::BasicBlock::iterator first,
+				llvm::BasicBlock::iterator end);
+		void reject(const std::string& key);
+		void clear();
+
+		std::size_t size() const;
+		std::size_t getHits() const;
+
+	private:
+		/// Constant operand @c op of template instruction @c insn.
+		struct ConstantOperand
+		{
+			std::size_t insn = 0;
+			unsigned op = 0;
+			llvm::WeakTrackingVH value;
+		};
+
+		struct Template
+		{
+			/// @c False if the translation can not be replayed.
+			bool replayable = false;
+			std::vector<llvm::Instruction*> insns;
+			std::vector<ConstantOperand> constants;
+		};
+
+	private:
+		static void deleteTemplate(Template& t);
+
+	private:
+		std::size_t _detailSize = 0;
+		std::unordered_map<std::string, Template> _templates;
+		std::size_t _hits = 0;
+};
+
+} // namespace capstone2llvmir
+} // namespace retdec
+
+#endif
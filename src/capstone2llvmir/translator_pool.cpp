@@ -0,0 +1,347 @@
+/**
+ * @file src/capstone2llvmir/translator_pool.cpp
+ * @brief Translators for concurrent translation on worker threads.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <set>
+
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "retdec/capstone2llvmir/exceptions.h"
+#include "retdec/capstone2llvmir/translator_pool.h"
+
+namespace retdec {
+namespace capstone2llvmir {
+
+namespace {
+
+/// Name of the function into which workers stage LLVM IR.
+const std::string STAGING_FUNCTION_NAME = "__capstone2llvmir_staging";
+
+/**
+ * Replace uses of globals of the staged module @p staged by the globals of
+ * the same names and types from the main module @p main. Used globals which
+ * are not in the main module (e.g. new pseudo assembly functions) are moved
+ * there.
+ * @return Globals moved to the main module.
+ */
+std::vector<llvm::GlobalValue*> mapGlobals(
+		llvm::Module& staged,
+		llvm::Module& main,
+		llvm::Function* stagingFunction)
+{
+	std::vector<llvm::GlobalValue*> moved;
+
+	std::vector<llvm::GlobalVariable*> vars;
+	for (auto& gv : staged.globals())
+	{
+		vars.push_back(&gv);
+	}
+	for (auto* gv : vars)
+	{
+		if (gv->use_empty())
+		{
+			continue;
+		}
+		auto* mgv = main.getNamedGlobal(gv->getName());
+		if (mgv && mgv->getType() == gv->getType())
+		{
+			gv->replaceAllUsesWith(mgv);
+		}
+		else
+		{
+			gv->removeFromParent();
+			main.getGlobalList().push_back(gv);
+			moved.push_back(gv);
+		}
+	}
+
+	std::vector<llvm::Function*> fncs;
+	for (auto& f : staged.functions())
+	{
+		if (&f != stagingFunction)
+		{
+			fncs.push_back(&f);
+		}
+	}
+	for (auto* f : fncs)
+	{
+		if (f->use_empty())
+		{
+			continue;
+		}
+		auto* mf = main.getFunction(f->getName());
+		if (mf && mf->getFunctionType() == f->getFunctionType())
+		{
+			f->replaceAllUsesWith(mf);
+		}
+		else
+		{
+			f->removeFromParent();
+			main.getFunctionList().push_back(f);
+			moved.push_back(f);
+		}
+	}
+
+	return moved;
+}
+
+} // anonymous namespace
+
+//
+//==============================================================================
+// TranslatorPool::Worker
+//==============================================================================
+//
+
+TranslatorPool::Worker::Worker(const Capstone2LlvmIrTranslator& main)
+		:
+		_context(std::make_unique<llvm::LLVMContext>()),
+		_module(std::make_unique<llvm::Module>(
+				main.getModule()->getModuleIdentifier(),
+				*_context))
+{
+	_module->setTargetTriple(main.getModule()->getTargetTriple());
+	_module->setDataLayout(main.getModule()->getDataLayout());
+	_translator = main.clone(_module.get());
+}
+
+Capstone2LlvmIrTranslator& TranslatorPool::Worker::getTranslator()
+{
+	return *_translator;
+}
+
+/**
+ * Start staging new code.
+ * @return Builder at which the worker's translator should translate. It is
+ *         valid until @c finish() is called.
+ */
+llvm::IRBuilder<>& TranslatorPool::Worker::stage()
+{
+	if (_function)
+	{
+		throw GenericError("Code is already being staged.");
+	}
+
+	_function = llvm::Function::Create(
+			llvm::FunctionType::get(llvm::Type::getVoidTy(*_context), false),
+			llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+			STAGING_FUNCTION_NAME,
+			_module.get());
+	auto* bb = llvm::BasicBlock::Create(*_context, "", _function);
+	auto* ret = llvm::ReturnInst::Create(*_context, bb);
+	_irb = std::make_unique<llvm::IRBuilder<>>(ret);
+	return *_irb;
+}
+
+/**
+ * Take the code staged since the last @c stage() and remove it from the
+ * staging module.
+ */
+TranslatorPool::StagedCode TranslatorPool::Worker::finish()
+{
+	if (_function == nullptr)
+	{
+		throw GenericError("No code is being staged.");
+	}
+
+	StagedCode code;
+	for (auto* f : _translator->getPseudoAsmFunctions())
+	{
+		code.pseudoAsmFunctions.push_back(f->getName().str());
+	}
+	llvm::raw_string_ostream out(code.bitcode);
+	llvm::WriteBitcodeToFile(*_module, out);
+	out.flush();
+
+	_irb.reset();
+	_function->eraseFromParent();
+	_function = nullptr;
+	return code;
+}
+
+//
+//==============================================================================
+// TranslatorPool
+//==============================================================================
+//
+
+/**
+ * @param main    Translator whose clones are created, and into whose module
+ *                the staged code is merged.
+ * @param threads Number of worker translators.
+ */
+TranslatorPool::TranslatorPool(
+		Capstone2LlvmIrTranslator& main,
+		unsigned threads)
+		:
+		_main(main)
+{
+	// Clones are created here, on the committing thread, so that the main
+	// translator is never read concurrently with its use.
+	for (unsigned i = 0; i < threads; ++i)
+	{
+		_workers.emplace_back(new Worker(main));
+		_free.push_back(_workers.back().get());
+	}
+}
+
+/**
+ * Take a free worker translator. If all of them are used, wait for one.
+ * Thread-safe.
+ */
+TranslatorPool::Worker* TranslatorPool::acquire()
+{
+	if (_workers.empty())
+	{
+		throw GenericError("Translator pool has no workers.");
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_released.wait(lock, [this]() { return !_free.empty(); });
+	auto* worker = _free.back();
+	_free.pop_back();
+	return worker;
+}
+
+/**
+ * Return @p worker acquired by @c acquire() to the pool. Thread-safe.
+ */
+void TranslatorPool::release(Worker* worker)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_free.push_back(worker);
+	}
+	_released.notify_one();
+}
+
+/**
+ * Merge the staged @p code into the main module at the position of @p irb,
+ * as if it was translated there by the main translator. The builder is moved
+ * after the merged code. Globals of the staged code are mapped to the main
+ * module's globals of the same names, new pseudo assembly functions are added
+ * to the main translator.
+ * @return Special LLVM IR instructions used for LLVM IR <-> Capstone
+ *         instruction mapping (see @c TranslationResult) of the merged code, in
+ *         the order of translation.
+ */
+std::vector<llvm::StoreInst*> TranslatorPool::commit(
+		const StagedCode& code,
+		llvm::IRBuilder<>& irb)
+{
+	auto& main = *_main.getModule();
+	auto buffer = llvm::MemoryBuffer::getMemBuffer(
+			code.bitcode,
+			STAGING_FUNCTION_NAME,
+			false);
+	auto parsed = llvm::parseBitcodeFile(
+			buffer->getMemBufferRef(),
+			main.getContext());
+	if (!parsed)
+	{
+		llvm::consumeError(parsed.takeError());
+		throw GenericError("Staged code can not be parsed.");
+	}
+	auto staged = std::move(parsed.get());
+	auto* sf = staged->getFunction(STAGING_FUNCTION_NAME);
+	if (sf == nullptr || sf->empty())
+	{
+		throw GenericError("Staged code has no staging function.");
+	}
+
+	std::set<std::string> asmFunctions(
+			code.pseudoAsmFunctions.begin(),
+			code.pseudoAsmFunctions.end());
+	for (auto* gv : mapGlobals(*staged, main, sf))
+	{
+		auto* f = llvm::dyn_cast<llvm::Function>(gv);
+		if (f && asmFunctions.count(f->getName().str()))
+		{
+			_main.addPseudoAsmFunction(f);
+		}
+	}
+
+	std::vector<llvm::StoreInst*> mapping;
+	for (auto& bb : *sf)
+	{
+		for (auto& i : bb)
+		{
+			if (auto* s = _main.isSpecialAsm2LlvmInstr(&i))
+			{
+				mapping.push_back(s);
+			}
+		}
+	}
+
+	auto* bb = irb.GetInsertBlock();
+	auto pos = irb.GetInsertPoint();
+	auto* entry = &sf->getEntryBlock();
+
+	// The usual case - all the code is in one block, it is spliced at the
+	// builder's position without its final return.
+	if (sf->size() == 1)
+	{
+		bb->getInstList().splice(
+				pos,
+				entry->getInstList(),
+				entry->begin(),
+				entry->getTerminator()->getIterator());
+		irb.SetInsertPoint(bb, pos);
+		return mapping;
+	}
+
+	// The code has more blocks (e.g. if-then) - the builder's block is split
+	// at its position, the staged blocks are put between the parts, and the
+	// returns from the staged code continue in the second part.
+	llvm::BasicBlock* tail = nullptr;
+	if (pos == bb->end())
+	{
+		tail = llvm::BasicBlock::Create(
+				main.getContext(),
+				"",
+				bb->getParent(),
+				bb->getNextNode());
+	}
+	else
+	{
+		tail = bb->splitBasicBlock(pos);
+		bb->getTerminator()->eraseFromParent();
+	}
+
+	std::vector<llvm::BasicBlock*> blocks;
+	for (auto& b : *sf)
+	{
+		blocks.push_back(&b);
+	}
+	for (auto* b : blocks)
+	{
+		b->moveBefore(tail);
+		if (auto* ret = llvm::dyn_cast<llvm::ReturnInst>(b->getTerminator()))
+		{
+			llvm::BranchInst::Create(tail, ret);
+			ret->eraseFromParent();
+		}
+	}
+
+	bb->getInstList().splice(bb->end(), entry->getInstList());
+	entry->replaceAllUsesWith(bb);
+	entry->eraseFromParent();
+
+	if (tail->empty())
+	{
+		irb.SetInsertPoint(tail);
+	}
+	else
+	{
+		irb.SetInsertPoint(&tail->front());
+	}
+	return mapping;
+}
+
+} // namespace capstone2llvmir
+} // namespace retdec
@@ -239,6 +239,46 @@ void Capstone2LlvmIrTranslatorX86_impl::translateInstruction(
 	}
 }
 
+/**
+ * Instructions that change control flow or use the instruction pointer
+ * depend on their address.
+ */
+bool Capstone2LlvmIrTranslatorX86_impl::isTranslationCacheable(cs_insn* i)
+{
+	if (isControlFlowInstruction(*i))
+	{
+		return false;
+	}
+
+	auto isPc = [](unsigned r)
+	{
+		return r == X86_REG_RIP || r == X86_REG_EIP || r == X86_REG_IP;
+	};
+
+	cs_x86* xi = &i->detail->x86;
+	for (std::size_t k = 0; k < xi->op_count; ++k)
+	{
+		auto& op = xi->operands[k];
+		if ((op.type == X86_OP_REG && isPc(op.reg))
+				|| (op.type == X86_OP_MEM
+						&& (isPc(op.mem.base) || isPc(op.mem.index))))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Status flags are set by nearly every arithmetic instruction, but only few
+ * of them are ever read. The direction flag is set only on purpose.
+ */
+std::vector<uint32_t> Capstone2LlvmIrTranslatorX86_impl::getLazyFlagRegisters() const
+{
+	return {X86_REG_CF, X86_REG_PF, X86_REG_AF, X86_REG_ZF, X86_REG_SF, X86_REG_OF};
+}
+
 //
 //==============================================================================
 // x86-specific methods.
@@ -71,6 +71,8 @@ class Capstone2LlvmIrTranslatorX86_impl :
 		virtual void translateInstruction(
 				cs_insn* i,
 				llvm::IRBuilder<>& irb) override;
+		virtual bool isTranslationCacheable(cs_insn* i) override;
+		virtual std::vector<uint32_t> getLazyFlagRegisters() const override;
 //
 //==============================================================================
 // x86-specific methods.
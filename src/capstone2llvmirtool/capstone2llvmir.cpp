@@ -4,7 +4,14 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iomanip>
+#include <iterator>
+#include <new>
 
 #include <keystone/keystone.h>
 #include <llvm/IR/Module.h>
@@ -12,16 +19,51 @@
 #include <llvm/Support/raw_ostream.h>
 
 #include "retdec/common/address.h"
+#include "retdec/fileformat/format_factory.h"
 #include "retdec/utils/conversion.h"
+#include "retdec/utils/memory.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/io/log.h"
 #include "retdec/utils/version.h"
 
 #include "retdec/capstone2llvmir/capstone2llvmir.h"
+#include "retdec/capstone2llvmir/insn_pool.h"
 
 using namespace retdec::utils;
 using namespace retdec::utils::io;
 
+//
+//==============================================================================
+// Allocation counting for the benchmark mode.
+//==============================================================================
+//
+
+namespace {
+
+std::atomic<std::size_t> allocationCount(0);
+
+} // anonymous namespace
+
+void* operator new(std::size_t n)
+{
+	++allocationCount;
+	if (void* p = std::malloc(n ? n : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
 // byte ptr [0x12345678], 0x11
 std::vector<uint8_t> CODE = retdec::utils::hexStringToBytes("80 05 78 56 34 12 11 00");
 
@@ -78,6 +120,26 @@ class ProgramOptions
 				{
 					text = getParamOrDie(argc, argv, i);
 				}
+				else if (c == "-f")
+				{
+					codeFile = getParamOrDie(argc, argv, i);
+				}
+				else if (c == "-x")
+				{
+					binaryFile = getParamOrDie(argc, argv, i);
+				}
+				else if (c == "--benchmark")
+				{
+					benchmark = true;
+				}
+				else if (c == "--translation-cache")
+				{
+					translationCache = true;
+				}
+				else if (c == "--lazy-flags")
+				{
+					lazyFlags = true;
+				}
 				else if (c == "-m")
 				{
 					_basicMode = getParamOrDie(argc, argv, i);
@@ -107,6 +169,7 @@ class ProgramOptions
 				else if (c == "-o")
 				{
 					outFile = getParamOrDie(argc, argv, i);
+					_useDefaultOutFile = false;
 				}
 				else if (c == "-h")
 				{
@@ -122,6 +185,12 @@ class ProgramOptions
 			{
 				basicMode = getDefaultBasicModeFromArch(arch);
 			}
+
+			// Do not flood stdout with the benchmarked module.
+			if (benchmark && _useDefaultOutFile)
+			{
+				outFile.clear();
+			}
 		}
 
 		std::string getParamOrDie(int argc, char *argv[], int& i)
@@ -167,6 +236,8 @@ class ProgramOptions
 			Log::info() << "\t" << "base   : " << std::hex << base << " (" << _base << ")" << std::endl;
 			Log::info() << "\t" << "code   : " << tmp << " (" << _code << ")" << std::endl;
 			Log::info() << "\t" << "asm text : " << text << std::endl;
+			Log::info() << "\t" << "code file : " << codeFile << std::endl;
+			Log::info() << "\t" << "binary : " << binaryFile << std::endl;
 			Log::info() << "\t" << "b mode : " << std::hex << basicMode << " (" << _basicMode << ")" << std::endl;
 			Log::info() << "\t" << "e mode : " << std::hex << extraMode << " (" << _extraMode << ")" << std::endl;
 			Log::info() << "\t" << "out    : " << outFile << std::endl;
@@ -190,6 +261,9 @@ class ProgramOptions
 				"\t          Default value: \"" << tmp << "\"\n"
 				"\t-t asm    Assembly text to assemble, disassemble and dump.\n"
 				"\t          Most of the time, this is more convenient than -c option.\n"
+				"\t-f file   Raw binary file to translate.\n"
+				"\t-x file   ELF/PE/... file whose .text (or first code) section\n"
+				"\t          is translated. Base address is set to the section address.\n"
 				"\t-m mode   Capstone basic mode to use.\n"
 				"\t          Possible values: arm, thumb, 16, 32, 64, mips3, mips32r6,\n"
 				"\t          mips32, mips64\n"
@@ -198,7 +272,16 @@ class ProgramOptions
 				"\t          Possible values: little, big, micro, mclass, v8, v9.\n"
 				"\t          Default value: little.\n"
 				"\t-o out    Output file name where LLVM IR will be generated.\n"
-				"\t          Default value: stdout\n";
+				"\t          Default value: stdout (nothing in benchmark mode)\n"
+				"\t--benchmark\n"
+				"\t          Translate the code linearly (undecodable bytes are\n"
+				"\t          skipped) and report translation throughput, IR size,\n"
+				"\t          allocations and peak memory.\n"
+				"\t--translation-cache\n"
+				"\t          Memoize translations of repeated instructions.\n"
+				"\t--lazy-flags\n"
+				"\t          Keep only the flags which may be read before they\n"
+				"\t          are overwritten (x86 only).\n";
 
 			exit(0);
 		}
@@ -208,6 +291,11 @@ class ProgramOptions
 		uint64_t base = 0x1000;
 		std::vector<uint8_t> code = CODE;
 		std::string text;
+		std::string codeFile;
+		std::string binaryFile;
+		bool benchmark = false;
+		bool translationCache = false;
+		bool lazyFlags = false;
 		cs_mode basicMode = CS_MODE_32;
 		cs_mode extraMode = CS_MODE_LITTLE_ENDIAN;
 		std::string outFile = "-"; // "-" == stdout for llvm::raw_fd_ostream.
@@ -220,6 +308,7 @@ class ProgramOptions
 		std::string _basicMode;
 		std::string _extraMode;
 		bool _useDefaultBasicMode = true;
+		bool _useDefaultOutFile = true;
 };
 
 /**
@@ -377,8 +466,153 @@ void assemble(ProgramOptions& po)
 	}
 }
 
+/**
+ * Load code to translate from the raw binary file.
+ */
+void loadCodeFile(ProgramOptions& po)
+{
+	std::ifstream f(po.codeFile, std::ios::binary);
+	if (!f)
+	{
+		Log::error() << "Can not open file: " << po.codeFile << std::endl;
+		exit(1);
+	}
+
+	po.code.assign(
+			std::istreambuf_iterator<char>(f),
+			std::istreambuf_iterator<char>());
+}
+
+/**
+ * Load code to translate from the .text section (or the first code section)
+ * of the binary file.
+ */
+void loadBinaryFile(ProgramOptions& po)
+{
+	auto ff = retdec::fileformat::createFileFormat(po.binaryFile);
+	if (ff == nullptr || !ff->isInValidState())
+	{
+		Log::error() << "Can not load file: " << po.binaryFile << std::endl;
+		exit(1);
+	}
+
+	auto* sec = ff->getSection(".text");
+	for (auto* s : ff->getSections())
+	{
+		if (sec == nullptr && s->isCode())
+		{
+			sec = s;
+		}
+	}
+	if (sec == nullptr || !sec->getBytes(po.code) || po.code.empty())
+	{
+		Log::error() << "No code section in file: " << po.binaryFile
+				<< std::endl;
+		exit(1);
+	}
+
+	po.base = sec->getAddress();
+}
+
 using namespace retdec::capstone2llvmir;
 
+/**
+ * Number of bytes skipped if the code can not be disassembled.
+ */
+std::size_t getSkipSize(const ProgramOptions& po)
+{
+	if (po.arch == CS_ARCH_X86)
+	{
+		return 1;
+	}
+	else if (po.arch == CS_ARCH_ARM && po.basicMode == CS_MODE_THUMB)
+	{
+		return 2;
+	}
+	else
+	{
+		return 4;
+	}
+}
+
+/**
+ * Linearly translate all the code and report the translation statistics.
+ */
+void benchmark(
+		ProgramOptions& po,
+		Capstone2LlvmIrTranslator* c2l,
+		llvm::Function* f,
+		llvm::IRBuilder<>& irb)
+{
+	CapstoneInsnPool pool(po.arch);
+	c2l->setInstructionPool(&pool);
+	c2l->setUseTranslationCache(po.translationCache);
+	c2l->setLazyFlags(po.lazyFlags);
+
+	const uint8_t* bytes = po.code.data();
+	std::size_t size = po.code.size();
+	retdec::common::Address addr = po.base;
+	std::size_t skip = getSkipSize(po);
+	std::size_t insns = 0;
+	std::size_t failed = 0;
+
+	std::size_t allocs = allocationCount;
+	auto start = std::chrono::steady_clock::now();
+
+	while (size > 0)
+	{
+		auto res = c2l->translateOne(bytes, size, addr, irb);
+		if (res.failed())
+		{
+			std::size_t s = std::min(skip, size);
+			bytes += s;
+			size -= s;
+			addr += s;
+			++failed;
+		}
+		else
+		{
+			++insns;
+		}
+	}
+
+	std::chrono::duration<double> time =
+			std::chrono::steady_clock::now() - start;
+	allocs = allocationCount - allocs;
+
+	std::size_t irInsns = 0;
+	for (auto& bb : *f)
+	{
+		irInsns += bb.size();
+	}
+	double secs = time.count();
+	double perInsn = insns ? 1.0 / insns : 0.0;
+
+	Log::info() << std::endl;
+	Log::info() << "Benchmark:" << std::endl;
+	Log::info() << "\t" << "arch          : " << po.arch << std::endl;
+	Log::info() << "\t" << "b mode        : " << std::hex << po.basicMode
+			<< std::dec << std::endl;
+	Log::info() << "\t" << "e mode        : " << std::hex << po.extraMode
+			<< std::dec << std::endl;
+	Log::info() << "\t" << "bytes         : " << po.code.size() << std::endl;
+	Log::info() << "\t" << "instructions  : " << insns << std::endl;
+	Log::info() << "\t" << "failed        : " << failed << std::endl;
+	Log::info() << "\t" << "time [s]      : " << secs << std::endl;
+	Log::info() << "\t" << "insns/s       : "
+			<< (secs > 0.0 ? insns / secs : 0.0) << std::endl;
+	Log::info() << "\t" << "IR insns/insn : " << irInsns * perInsn
+			<< std::endl;
+	Log::info() << "\t" << "allocations   : " << allocs
+			<< " (" << allocs * perInsn << " per insn)" << std::endl;
+	Log::info() << "\t" << "peak memory   : "
+			<< retdec::utils::getPeakProcessMemory() << " B" << std::endl;
+	Log::info() << std::endl;
+
+	// The pool is destroyed, do not let the translator use it.
+	c2l->setInstructionPool(nullptr);
+}
+
 int main(int argc, char *argv[])
 {
 	ProgramOptions po(argc, argv);
@@ -387,6 +621,14 @@ int main(int argc, char *argv[])
 	{
 		assemble(po);
 	}
+	else if (!po.codeFile.empty())
+	{
+		loadCodeFile(po);
+	}
+	else if (!po.binaryFile.empty())
+	{
+		loadBinaryFile(po);
+	}
 
 	printVersion();
 
@@ -411,7 +653,16 @@ int main(int argc, char *argv[])
 				&module,
 				po.basicMode,
 				po.extraMode);
-		c2l->translate(po.code.data(), po.code.size(), po.base, irb);
+		if (po.benchmark)
+		{
+			benchmark(po, c2l.get(), f, irb);
+		}
+		else
+		{
+			c2l->setUseTranslationCache(po.translationCache);
+			c2l->setLazyFlags(po.lazyFlags);
+			c2l->translate(po.code.data(), po.code.size(), po.base, irb);
+		}
 	}
 	catch (const BaseError& e)
 	{
@@ -423,9 +674,12 @@ int main(int argc, char *argv[])
 		Log::error() << "Some unhandled exception" << std::endl;
 	}
 
-	std::error_code ec;
-	llvm::raw_fd_ostream out(po.outFile, ec, llvm::sys::fs::F_None);
-	module.print(out, nullptr);
+	if (!po.outFile.empty())
+	{
+		std::error_code ec;
+		llvm::raw_fd_ostream out(po.outFile, ec, llvm::sys::fs::F_None);
+		module.print(out, nullptr);
+	}
 
 	return EXIT_SUCCESS;
 }
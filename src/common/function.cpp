@@ -127,6 +127,35 @@ bool Function::operator!=(const Function& o) const
 //=============================================================================
 //
 
+FunctionContainer::FunctionContainer()
+{
+
+}
+
+FunctionContainer::FunctionContainer(const FunctionContainer& o) :
+		std::set<Function, FunctionNameCompare>(o)
+{
+	*this = o;
+}
+
+/**
+ * We need to make sure pointers in @c _addr2fnc are valid -- point
+ * to the new container, not the old one.
+ */
+FunctionContainer& FunctionContainer::operator=(const FunctionContainer& o)
+{
+	if (this != &o)
+	{
+		std::set<Function, FunctionNameCompare>::operator=(o);
+		_addr2fnc.clear();
+		for (auto& f : *this)
+		{
+			_addr2fnc.emplace(f.getStart(), &f);
+		}
+	}
+	return *this;
+}
+
 /**
  * @return @c True if container contains a function of the specified name.
  */
@@ -148,15 +177,19 @@ const Function* FunctionContainer::getFunctionByName(
 const Function* FunctionContainer::getFunctionByStartAddress(
 		const retdec::common::Address& addr) const
 {
-	for (auto& elem : *this)
+	// If there are more functions starting at the address, the one with the
+	// lowest name (i.e. the first one in the container) is returned.
+	const Function* ret = nullptr;
+	auto range = _addr2fnc.equal_range(addr);
+	for (auto it = range.first; it != range.second; ++it)
 	{
-		if (addr == elem.getStart())
+		if (ret == nullptr || *it->second < *ret)
 		{
-			return &elem;
+			ret = it->second;
 		}
 	}
 
-	return nullptr;
+	return ret;
 }
 
 const Function* FunctionContainer::getFunctionByRealName(
@@ -173,6 +206,74 @@ const Function* FunctionContainer::getFunctionByRealName(
 	return nullptr;
 }
 
+/**
+ * Insert function @a f into the underlying container. If there already is a
+ * function with the same name, the container is not modified. Otherwise,
+ * @c _addr2fnc is also updated.
+ */
+std::pair<FunctionContainer::iterator,bool> FunctionContainer::insert(
+		const Function& f)
+{
+	auto retPair = std::set<Function, FunctionNameCompare>::insert(f);
+	if (retPair.second)
+	{
+		_addr2fnc.emplace(retPair.first->getStart(), &(*retPair.first));
+	}
+	return retPair;
+}
+
+FunctionContainer::iterator FunctionContainer::insert(
+		FunctionContainer::const_iterator,
+		const Function& f)
+{
+	return insert(f).first;
+}
+
+/**
+ * Clear both underlying container and @c _addr2fnc map.
+ */
+void FunctionContainer::clear()
+{
+	std::set<Function, FunctionNameCompare>::clear();
+	_addr2fnc.clear();
+}
+
+/**
+ * Erase function with the name of @a f from both underlying container and
+ * @c _addr2fnc map.
+ */
+size_t FunctionContainer::erase(const Function& f)
+{
+	auto it = find(f);
+	if (it == end())
+	{
+		return 0;
+	}
+
+	erase(it);
+	return 1;
+}
+
+/**
+ * Erase function at @a pos from both underlying container and @c _addr2fnc
+ * map.
+ */
+FunctionContainer::iterator FunctionContainer::erase(
+		FunctionContainer::const_iterator pos)
+{
+	auto range = _addr2fnc.equal_range(pos->getStart());
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second == &(*pos))
+		{
+			_addr2fnc.erase(it);
+			break;
+		}
+	}
+
+	return std::set<Function, FunctionNameCompare>::erase(pos);
+}
+
 //
 //=============================================================================
 // FunctionSet
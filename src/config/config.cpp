@@ -4,15 +4,21 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 #include <fstream>
+#include <sstream>
+
+#include <vector>
 
 #include <rapidjson/error/en.h>
+#include <rapidjson/ostreamwrapper.h>
 #include <rapidjson/prettywriter.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/encodings.h>
+#include <rapidjson/writer.h>
 
 #include "retdec/config/config.h"
 #include "retdec/serdes/address.h"
 #include "retdec/serdes/architecture.h"
+#include "retdec/serdes/binary.h"
 #include "retdec/serdes/class.h"
 #include "retdec/serdes/file_format.h"
 #include "retdec/serdes/file_type.h"
@@ -46,11 +52,39 @@ const std::string JSON_vtables           = "vtables";
 const std::string JSON_classes           = "classes";
 const std::string JSON_patterns          = "patterns";
 
+/// Size of the buffer of the generated JSON file.
+const std::size_t JSON_FILE_BUFFER_SIZE  = 1024 * 1024;
+
 } // anonymous namespace
 
 namespace retdec {
 namespace config {
 
+namespace {
+
+std::string readFileContent(const std::string& input)
+{
+	// The reading of the input file is based on
+	// http://insanecoding.blogspot.cz/2011/11/how-to-read-in-file-in-c.html
+	std::ifstream file(input, std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		std::string msg = "Input file \"" + input + "\" can not be opened.";
+		throw FileNotFoundException(msg);
+	}
+
+	std::string content;
+	file.seekg(0, std::ios::end);
+	content.resize(file.tellg());
+	file.seekg(0, std::ios::beg);
+	file.read(&content[0], content.size());
+	file.close();
+
+	return content;
+}
+
+} // anonymous namespace
+
 Config Config::empty()
 {
 	Config config;
@@ -60,7 +94,7 @@ Config Config::empty()
 Config Config::fromFile(const std::string& path)
 {
 	Config config;
-	config.readJsonFile(path);
+	config.readFile(path);
 	return config;
 }
 
@@ -79,23 +113,27 @@ Config Config::fromJsonString(const std::string& json)
  */
 void Config::readJsonFile(const std::string& input)
 {
-	// The reading of the input file is based on
-	// http://insanecoding.blogspot.cz/2011/11/how-to-read-in-file-in-c.html
-	std::ifstream jsonFile(input, std::ios::in | std::ios::binary);
-	if (!jsonFile)
+	readJsonString(readFileContent(input));
+}
+
+/**
+ * Reads configuration file in either JSON or binary format into internal
+ * representation. The format is detected from the file content.
+ * If file can not be opened, an instance of @c FileNotFoundException is thrown.
+ * If file can not be parsed, an instance of @c ParseException is thrown.
+ * @param input Path to input configuration file.
+ */
+void Config::readFile(const std::string& input)
+{
+	auto content = readFileContent(input);
+	if (serdes::isBinary(content.data(), content.size()))
 	{
-		std::string msg = "Input file \"" + input + "\" can not be opened.";
-		throw FileNotFoundException(msg);
+		readBinaryString(content);
+	}
+	else
+	{
+		readJsonString(content);
 	}
-
-	std::string jsonContent;
-	jsonFile.seekg(0, std::ios::end);
-	jsonContent.resize(jsonFile.tellg());
-	jsonFile.seekg(0, std::ios::beg);
-	jsonFile.read(&jsonContent[0], jsonContent.size());
-	jsonFile.close();
-
-	readJsonString(jsonContent);
 }
 
 /**
@@ -111,7 +149,9 @@ std::string Config::generateJsonFile() const
 }
 
 /**
- * Generates JSON configuration file.
+ * Generates JSON configuration file. The JSON is streamed into the file, it
+ * is not built in memory first. It is pretty printed unless
+ * @c Parameters::isCompactOutputConfig() is set.
  * @param outputFilePath Path to output JSON file. If not set, use 'inputName'.
  * @return Path to generated JSON file.
  */
@@ -121,8 +161,25 @@ std::string Config::generateJsonFile(const std::string& outputFilePath) const
 			? parameters.getInputFile() + ".json"
 			: outputFilePath;
 
-	std::ofstream jsonFile( jsonName.c_str() );
-	jsonFile << generateJsonString();
+	// RapidJSON writes character by character, a large buffer keeps the
+	// number of writes to the file low.
+	std::vector<char> buffer(JSON_FILE_BUFFER_SIZE);
+	std::ofstream jsonFile;
+	jsonFile.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+	jsonFile.open(jsonName.c_str());
+
+	rapidjson::OStreamWrapper out(jsonFile);
+	if (parameters.isCompactOutputConfig())
+	{
+		serdes::JsonStreamWriter writer(out);
+		serialize(writer);
+	}
+	else
+	{
+		serdes::PrettyJsonStreamWriter writer(out);
+		serialize(writer);
+	}
+	jsonFile.close();
 
 	return jsonName;
 }
@@ -136,6 +193,54 @@ std::string Config::generateJsonString() const
 	rapidjson::StringBuffer sb;
 	rapidjson::PrettyWriter<rapidjson::StringBuffer, rapidjson::UTF8<>> writer(sb);
 
+	serialize(writer);
+
+	return sb.GetString();
+}
+
+/**
+ * Generates configuration file. Its format is binary if
+ * @c Parameters::isBinaryOutputConfig() is set, JSON otherwise.
+ * @param outputFilePath Path to output file. If not set, use 'inputName'.
+ * @return Path to generated file.
+ */
+std::string Config::generateFile(const std::string& outputFilePath) const
+{
+	if (!parameters.isBinaryOutputConfig())
+	{
+		return generateJsonFile(outputFilePath);
+	}
+
+	std::string name = outputFilePath.empty()
+			? parameters.getInputFile() + ".json"
+			: outputFilePath;
+
+	std::ofstream file(name, std::ios::out | std::ios::binary);
+	serdes::BinaryWriter writer(file);
+	serialize(writer);
+
+	return name;
+}
+
+/**
+ * Generates string containing binary representation of configuration.
+ * It holds the same information as the JSON representation, but it is
+ * considerably smaller and faster to read for large configurations.
+ * @return Binary data.
+ */
+std::string Config::generateBinaryString() const
+{
+	std::ostringstream out(std::ios::out | std::ios::binary);
+	serdes::BinaryWriter writer(out);
+
+	serialize(writer);
+
+	return out.str();
+}
+
+template <typename Writer>
+void Config::serialize(Writer& writer) const
+{
 	writer.StartObject();
 
 	serdes::serializeString(writer, JSON_date, retdec::utils::getCurrentDate());
@@ -158,8 +263,6 @@ std::string Config::generateJsonString() const
 	serdes::serializeContainer(writer, JSON_patterns, patterns);
 
 	writer.EndObject();
-
-	return sb.GetString();
 }
 
 /**
@@ -181,6 +284,28 @@ void Config::readJsonString(const std::string& json)
 		throw ParseException(errMsg, loc.first, loc.second);
 	}
 
+	deserialize(root);
+}
+
+/**
+ * Reads string containing binary representation of configuration.
+ * If data can not be parsed, an instance of @c ParseException is thrown.
+ * @param data Binary data.
+ */
+void Config::readBinaryString(const std::string& data)
+{
+	rapidjson::Document root;
+	if (!serdes::readBinary(data.data(), data.size(), root))
+	{
+		throw ParseException(
+				"Failed to parse binary configuration!", 0, 0);
+	}
+
+	deserialize(root);
+}
+
+void Config::deserialize(const rapidjson::Value& root)
+{
 	*this = Config();
 
 	auto params = root.FindMember(JSON_parameters);
@@ -16,7 +16,9 @@ namespace {
 
 const std::string JSON_verboseOut               = "verboseOut";
 const std::string JSON_keepAllFuncs             = "keepAllFuncs";
+const std::string JSON_pruneUnreachableFuncsEarly = "pruneUnreachableFuncsEarly";
 const std::string JSON_selectedDecodeOnly       = "selectedDecodeOnly";
+const std::string JSON_selectedDecodeDepth      = "selectedDecodeDepth";
 const std::string JSON_ordinalNumDir            = "ordinalNumDirectory";
 const std::string JSON_userStaticSigPaths       = "userStaticSignPaths";
 const std::string JSON_staticSigPaths           = "staticSignPaths";
@@ -36,18 +38,33 @@ const std::string JSON_inputPdbFile             = "inputPdbFile";
 const std::string JSON_outputFile               = "outputFile";
 const std::string JSON_outputBitcodeFile        = "outputBitcodeFile";
 const std::string JSON_outputAsmFile            = "outputAsmFile";
+const std::string JSON_compressOutputAsm        = "compressOutputAsm";
+const std::string JSON_binaryOutputConfig       = "binaryOutputConfig";
+const std::string JSON_compactOutputConfig      = "compactOutputConfig";
 const std::string JSON_outputLlFile             = "outputLlFile";
 const std::string JSON_outputConfigFile         = "outputConfigFile";
 const std::string JSON_outputUnpackedFile       = "outputUnpackedFile";
+const std::string JSON_profileOutFile           = "profileOutFile";
+const std::string JSON_inputBirFile             = "inputBirFile";
+const std::string JSON_outputBirFile            = "outputBirFile";
 const std::string JSON_outputFormat             = "outputFormat";
 const std::string JSON_logFile                  = "logFile";
 const std::string JSON_errFile                  = "errFile";
 
 const std::string JSON_detectStaticCode         = "detectStaticCode";
+const std::string JSON_skipStaticCodeBodies     = "skipStaticCodeBodies";
+const std::string JSON_staticCodeCacheDir       = "staticCodeCacheDirectory";
 const std::string JSON_backendDisabledOpts      = "backendDisabledOpts";
 const std::string JSON_backendEnabledOpts       = "backendEnabledOpts";
 const std::string JSON_backendCallInfoObtainer  = "backendCallInfoObtainer";
+const std::string JSON_backendAliasAnalysis    = "backendAliasAnalysis";
 const std::string JSON_backendVarRenamer        = "backendVarRenamer";
+const std::string JSON_backendCopyPropStmtLimit = "backendCopyPropStmtLimit";
+const std::string JSON_backendFunctionCostLimit = "backendFunctionCostLimit";
+const std::string JSON_backendValidation       = "backendValidation";
+const std::string JSON_backendValidationSamplePercent = "backendValidationSamplePercent";
+const std::string JSON_backendFuncCacheDir      = "backendFuncCacheDirectory";
+const std::string JSON_backendGraphThreads      = "backendGraphThreads";
 const std::string JSON_backendNoOpts            = "backendNoOpts";
 const std::string JSON_backendEmitCfg           = "backendEmitCfg";
 const std::string JSON_backendEmitCg            = "backendEmitCg";
@@ -57,8 +74,18 @@ const std::string JSON_backendNoTimeVaryingInfo = "backendNoTimeVaryingInfo";
 const std::string JSON_backendNoVarRenaming     = "backendNoVarRenaming";
 const std::string JSON_backendNoCompoundOperators = "backendNoCompoundOperators";
 const std::string JSON_backendNoSymbolicNames   = "backendNoSymbolicNames";
+const std::string JSON_backendReleaseLlvmIr     = "backendReleaseLlvmIr";
+const std::string JSON_backendBirOnly           = "backendBirOnly";
+const std::string JSON_inputBirShards           = "inputBirShards";
 
 const std::string JSON_timeout                  = "timeout";
+const std::string JSON_phaseTimeout             = "phaseTimeout";
+const std::string JSON_decoderThreads           = "decoderThreads";
+const std::string JSON_rdaThreads               = "rdaThreads";
+const std::string JSON_translationCache         = "translationCache";
+const std::string JSON_lazyFlags                = "lazyFlags";
+const std::string JSON_asyncIrWriters           = "asyncIrWriters";
+const std::string JSON_concurrentInit           = "concurrentInit";
 const std::string JSON_maxMemoryLimit           = "maxMemoryLimit";
 const std::string JSON_maxMemoryLimitHalfRam    = "maxMemoryLimitHalfRam";
 
@@ -84,6 +111,16 @@ bool Parameters::isKeepAllFunctions() const
 	return _keepAllFunctions;
 }
 
+/**
+ * @return Functions unreachable from main are removed also before the
+ * parameter and return analysis, so that the expensive analyses do not
+ * process them. It has no effect if all functions are kept.
+ */
+bool Parameters::isPruneUnreachableFunctionsEarly() const
+{
+	return _pruneUnreachableFunctionsEarly;
+}
+
 /**
  * @return Decode only parts selected through selective decompilation.
  * Otherwise, entire binary is decoded.
@@ -91,6 +128,27 @@ bool Parameters::isKeepAllFunctions() const
  */
 bool Parameters::isSelectedDecodeOnly() const { return _selectedDecodeOnly; }
 
+/**
+ * @return Translation of repeated instructions into LLVM IR is memoized.
+ */
+bool Parameters::isTranslationCache() const { return _translationCache; }
+
+/**
+ * @return Only flags which may be read are materialized in translated code.
+ */
+bool Parameters::isLazyFlags() const { return _lazyFlags; }
+
+/**
+ * @return LLVM IR and bitcode outputs are written on background threads.
+ */
+bool Parameters::isAsyncIrWriters() const { return _asyncIrWriters; }
+
+/**
+ * @return Independent analyses of the input file (compiler, static code, RTTI
+ * and crypto pattern detection, type information loading) run concurrently.
+ */
+bool Parameters::isConcurrentInit() const { return _concurrentInit; }
+
 /**
  * Find out if some functions or ranges were selected in selective decompilation.
  * @return @c True if @c selectedFunctions or @c selectedRanges not empty,
@@ -151,17 +209,67 @@ bool Parameters::isBackendNoSymbolicNames() const
 	return _backendNoSymbolicNames;
 }
 
+bool Parameters::isBackendReleaseLlvmIr() const
+{
+	return _backendReleaseLlvmIr;
+}
+
+bool Parameters::isBackendBirOnly() const
+{
+	return _backendBirOnly;
+}
+
 
 bool Parameters::isDetectStaticCode() const
 {
 	return _detectStaticCode;
 }
 
+/**
+ * @return Statically linked functions confirmed by the static code detection
+ * are only declared, their bodies are not decoded.
+ */
+bool Parameters::isSkipStaticCodeBodies() const
+{
+	return _skipStaticCodeBodies;
+}
+
+/**
+ * @return The disassembly listing (output asm file) is compressed in gzip
+ * format.
+ */
+bool Parameters::isCompressOutputAsm() const
+{
+	return _compressOutputAsm;
+}
+
+/**
+ * @return The output config file is written in the binary format instead
+ * of JSON.
+ */
+bool Parameters::isBinaryOutputConfig() const
+{
+	return _binaryOutputConfig;
+}
+
+/**
+ * @return The output config file in JSON is written without indentation.
+ */
+bool Parameters::isCompactOutputConfig() const
+{
+	return _compactOutputConfig;
+}
+
 bool Parameters::isTimeout() const
 {
 	return _timeout != 0;
 }
 
+bool Parameters::isPhaseTimeout() const
+{
+	return _phaseTimeout != 0;
+}
+
 void Parameters::setIsVerboseOutput(bool b)
 {
 	_verboseOutput = b;
@@ -171,11 +279,51 @@ void Parameters::setIsKeepAllFunctions(bool b)
 {
 	_keepAllFunctions = b;
 }
+
+void Parameters::setIsPruneUnreachableFunctionsEarly(bool b)
+{
+	_pruneUnreachableFunctionsEarly = b;
+}
 void Parameters::setIsSelectedDecodeOnly(bool b)
 {
 	_selectedDecodeOnly = b;
 }
 
+void Parameters::setSelectedDecodeDepth(uint64_t depth)
+{
+	_selectedDecodeDepth = depth;
+}
+
+void Parameters::setDecoderThreads(uint64_t threads)
+{
+	_decoderThreads = threads;
+}
+
+void Parameters::setRdaThreads(uint64_t threads)
+{
+	_rdaThreads = threads;
+}
+
+void Parameters::setIsTranslationCache(bool b)
+{
+	_translationCache = b;
+}
+
+void Parameters::setIsLazyFlags(bool b)
+{
+	_lazyFlags = b;
+}
+
+void Parameters::setIsAsyncIrWriters(bool b)
+{
+	_asyncIrWriters = b;
+}
+
+void Parameters::setIsConcurrentInit(bool b)
+{
+	_concurrentInit = b;
+}
+
 void Parameters::setOutputFile(const std::string& n)
 {
 	_outputFile = n;
@@ -191,6 +339,21 @@ void Parameters::setOutputAsmFile(const std::string& file)
 	_outputAsmFile = file;
 }
 
+void Parameters::setIsCompressOutputAsm(bool b)
+{
+	_compressOutputAsm = b;
+}
+
+void Parameters::setIsBinaryOutputConfig(bool b)
+{
+	_binaryOutputConfig = b;
+}
+
+void Parameters::setIsCompactOutputConfig(bool b)
+{
+	_compactOutputConfig = b;
+}
+
 void Parameters::setOutputLlvmirFile(const std::string& file)
 {
 	_outputLlFile = file;
@@ -206,6 +369,21 @@ void Parameters::setOutputUnpackedFile(const std::string& file)
 	_outputUnpackedFile = file;
 }
 
+void Parameters::setProfileOutFile(const std::string& file)
+{
+	_profileOutFile = file;
+}
+
+void Parameters::setInputBirFile(const std::string& file)
+{
+	_inputBirFile = file;
+}
+
+void Parameters::setOutputBirFile(const std::string& file)
+{
+	_outputBirFile = file;
+}
+
 void Parameters::setOutputFormat(const std::string& format)
 {
 	_outputFormat = format;
@@ -251,6 +429,11 @@ void Parameters::setTimeout(uint64_t seconds)
 	_timeout = seconds;
 }
 
+void Parameters::setPhaseTimeout(uint64_t seconds)
+{
+	_phaseTimeout = seconds;
+}
+
 void Parameters::setEntryPoint(const retdec::common::Address& a)
 {
 	_entryPoint = a;
@@ -280,11 +463,46 @@ void Parameters::setBackendCallInfoObtainer(const std::string& val)
 	_backendCallInfoObtainer = val;
 }
 
+void Parameters::setBackendAliasAnalysis(const std::string& val)
+{
+	_backendAliasAnalysis = val;
+}
+
 void Parameters::setBackendVarRenamer(const std::string& val)
 {
 	_backendVarRenamer = val;
 }
 
+void Parameters::setBackendCopyPropStmtLimit(uint64_t limit)
+{
+	_backendCopyPropStmtLimit = limit;
+}
+
+void Parameters::setBackendFunctionCostLimit(uint64_t limit)
+{
+	_backendFunctionCostLimit = limit;
+}
+
+void Parameters::setBackendValidation(const std::string& val)
+{
+	_backendValidation = val;
+}
+
+void Parameters::setBackendValidationSamplePercent(uint64_t percent)
+{
+	_backendValidationSamplePercent = percent;
+}
+
+void Parameters::setBackendFuncCacheDirectory(const std::string& dir)
+{
+	_backendFuncCacheDirectory = dir;
+}
+
+void Parameters::setBackendGraphThreads(uint64_t threads)
+{
+	_backendGraphThreads = threads;
+}
+
 void Parameters::setIsBackendNoOpts(bool b)
 {
 	_backendNoOpts = b;
@@ -330,11 +548,31 @@ void Parameters::setIsBackendNoSymbolicNames(bool b)
 	_backendNoSymbolicNames = b;
 }
 
+void Parameters::setIsBackendReleaseLlvmIr(bool b)
+{
+	_backendReleaseLlvmIr = b;
+}
+
+void Parameters::setIsBackendBirOnly(bool b)
+{
+	_backendBirOnly = b;
+}
+
 void Parameters::setIsDetectStaticCode(bool b)
 {
 	_detectStaticCode = b;
 }
 
+void Parameters::setIsSkipStaticCodeBodies(bool b)
+{
+	_skipStaticCodeBodies = b;
+}
+
+void Parameters::setStaticCodeCacheDirectory(const std::string& dir)
+{
+	_staticCodeCacheDirectory = dir;
+}
+
 const std::string& Parameters::getOrdinalNumbersDirectory() const
 {
 	return _ordinalNumbersDirectory;
@@ -380,6 +618,21 @@ const std::string& Parameters::getOutputUnpackedFile() const
 	return _outputUnpackedFile;
 }
 
+const std::string& Parameters::getProfileOutFile() const
+{
+	return _profileOutFile;
+}
+
+const std::string& Parameters::getInputBirFile() const
+{
+	return _inputBirFile;
+}
+
+const std::string& Parameters::getOutputBirFile() const
+{
+	return _outputBirFile;
+}
+
 const std::string& Parameters::getOutputFormat() const
 {
 	return _outputFormat;
@@ -405,6 +658,26 @@ uint64_t Parameters::getTimeout() const
 	return _timeout;
 }
 
+uint64_t Parameters::getPhaseTimeout() const
+{
+	return _phaseTimeout;
+}
+
+uint64_t Parameters::getSelectedDecodeDepth() const
+{
+	return _selectedDecodeDepth;
+}
+
+uint64_t Parameters::getDecoderThreads() const
+{
+	return _decoderThreads;
+}
+
+uint64_t Parameters::getRdaThreads() const
+{
+	return _rdaThreads;
+}
+
 retdec::common::Address Parameters::getEntryPoint() const
 {
 	return _entryPoint;
@@ -435,11 +708,51 @@ const std::string& Parameters::getBackendCallInfoObtainer() const
 	return _backendCallInfoObtainer;
 }
 
+const std::string& Parameters::getBackendAliasAnalysis() const
+{
+	return _backendAliasAnalysis;
+}
+
 const std::string& Parameters::getBackendVarRenamer() const
 {
 	return _backendVarRenamer;
 }
 
+uint64_t Parameters::getBackendCopyPropStmtLimit() const
+{
+	return _backendCopyPropStmtLimit;
+}
+
+uint64_t Parameters::getBackendFunctionCostLimit() const
+{
+	return _backendFunctionCostLimit;
+}
+
+const std::string& Parameters::getBackendValidation() const
+{
+	return _backendValidation;
+}
+
+uint64_t Parameters::getBackendValidationSamplePercent() const
+{
+	return _backendValidationSamplePercent;
+}
+
+const std::string& Parameters::getBackendFuncCacheDirectory() const
+{
+	return _backendFuncCacheDirectory;
+}
+
+uint64_t Parameters::getBackendGraphThreads() const
+{
+	return _backendGraphThreads;
+}
+
+const std::string& Parameters::getStaticCodeCacheDirectory() const
+{
+	return _staticCodeCacheDirectory;
+}
+
 void fixPath(std::string& path, fs::path root)
 {
 	fs::path p(path);
@@ -484,7 +797,9 @@ void Parameters::serialize(Writer& writer) const
 
 	serdes::serializeBool(writer, JSON_verboseOut, isVerboseOutput());
 	serdes::serializeBool(writer, JSON_keepAllFuncs, isKeepAllFunctions());
+	serdes::serializeBool(writer, JSON_pruneUnreachableFuncsEarly, isPruneUnreachableFunctionsEarly());
 	serdes::serializeBool(writer, JSON_selectedDecodeOnly, isSelectedDecodeOnly());
+	serdes::serializeUint64(writer, JSON_selectedDecodeDepth, getSelectedDecodeDepth());
 	serdes::serializeString(writer, JSON_ordinalNumDir, getOrdinalNumbersDirectory());
 
 	serdes::serializeString(writer, JSON_inputFile, getInputFile());
@@ -492,9 +807,15 @@ void Parameters::serialize(Writer& writer) const
 	serdes::serializeString(writer, JSON_outputFile, getOutputFile());
 	serdes::serializeString(writer, JSON_outputBitcodeFile, getOutputBitcodeFile());
 	serdes::serializeString(writer, JSON_outputAsmFile, getOutputAsmFile());
+	serdes::serializeBool(writer, JSON_compressOutputAsm, isCompressOutputAsm());
 	serdes::serializeString(writer, JSON_outputLlFile, getOutputLlvmirFile());
 	serdes::serializeString(writer, JSON_outputConfigFile, getOutputConfigFile());
+	serdes::serializeBool(writer, JSON_binaryOutputConfig, isBinaryOutputConfig());
+	serdes::serializeBool(writer, JSON_compactOutputConfig, isCompactOutputConfig());
 	serdes::serializeString(writer, JSON_outputUnpackedFile, getOutputUnpackedFile());
+	serdes::serializeString(writer, JSON_profileOutFile, getProfileOutFile());
+	serdes::serializeString(writer, JSON_inputBirFile, getInputBirFile());
+	serdes::serializeString(writer, JSON_outputBirFile, getOutputBirFile());
 	serdes::serializeString(writer, JSON_outputFormat, getOutputFormat());
 	serdes::serializeString(writer, JSON_logFile, getLogFile());
 	serdes::serializeString(writer, JSON_errFile, getErrFile());
@@ -502,19 +823,37 @@ void Parameters::serialize(Writer& writer) const
 	serdes::serializeString(writer, JSON_backendDisabledOpts, getBackendDisabledOpts());
 	serdes::serializeString(writer, JSON_backendEnabledOpts, getBackendEnabledOpts());
 	serdes::serializeString(writer, JSON_backendCallInfoObtainer, getBackendCallInfoObtainer());
+	serdes::serializeString(writer, JSON_backendAliasAnalysis, getBackendAliasAnalysis());
 	serdes::serializeString(writer, JSON_backendVarRenamer, getBackendVarRenamer());
+	serdes::serializeUint64(writer, JSON_backendCopyPropStmtLimit, getBackendCopyPropStmtLimit());
+	serdes::serializeUint64(writer, JSON_backendFunctionCostLimit, getBackendFunctionCostLimit());
+	serdes::serializeString(writer, JSON_backendValidation, getBackendValidation());
+	serdes::serializeUint64(writer, JSON_backendValidationSamplePercent, getBackendValidationSamplePercent());
+	serdes::serializeString(writer, JSON_backendFuncCacheDir, getBackendFuncCacheDirectory());
+	serdes::serializeUint64(writer, JSON_backendGraphThreads, getBackendGraphThreads());
 	serdes::serializeBool(writer, JSON_backendNoOpts, isBackendNoOpts());
 	serdes::serializeBool(writer, JSON_backendEmitCfg, isBackendEmitCfg());
 	serdes::serializeBool(writer, JSON_backendEmitCg, isBackendEmitCg());
 	serdes::serializeBool(writer, JSON_detectStaticCode, isDetectStaticCode());
+	serdes::serializeBool(writer, JSON_skipStaticCodeBodies, isSkipStaticCodeBodies());
+	serdes::serializeString(writer, JSON_staticCodeCacheDir, getStaticCodeCacheDirectory());
 	serdes::serializeBool(writer, JSON_backendKeepAllBrackets, isBackendKeepAllBrackets());
 	serdes::serializeBool(writer, JSON_backendKeepLibraryFuncs, isBackendKeepLibraryFuncs());
 	serdes::serializeBool(writer, JSON_backendNoTimeVaryingInfo, isBackendNoTimeVaryingInfo());
 	serdes::serializeBool(writer, JSON_backendNoVarRenaming, isBackendNoVarRenaming());
 	serdes::serializeBool(writer, JSON_backendNoCompoundOperators, isBackendNoCompoundOperators());
 	serdes::serializeBool(writer, JSON_backendNoSymbolicNames, isBackendNoSymbolicNames());
+	serdes::serializeBool(writer, JSON_backendReleaseLlvmIr, isBackendReleaseLlvmIr());
+	serdes::serializeBool(writer, JSON_backendBirOnly, isBackendBirOnly());
 
 	serdes::serializeUint64(writer, JSON_timeout, getTimeout());
+	serdes::serializeUint64(writer, JSON_phaseTimeout, getPhaseTimeout());
+	serdes::serializeUint64(writer, JSON_decoderThreads, getDecoderThreads());
+	serdes::serializeUint64(writer, JSON_rdaThreads, getRdaThreads());
+	serdes::serializeBool(writer, JSON_translationCache, isTranslationCache());
+	serdes::serializeBool(writer, JSON_lazyFlags, isLazyFlags());
+	serdes::serializeBool(writer, JSON_asyncIrWriters, isAsyncIrWriters());
+	serdes::serializeBool(writer, JSON_concurrentInit, isConcurrentInit());
 	serdes::serializeUint64(writer, JSON_maxMemoryLimit, getMaxMemoryLimit());
 	serdes::serializeBool(writer, JSON_maxMemoryLimitHalfRam, isMaxMemoryLimitHalfRam());
 
@@ -527,6 +866,7 @@ void Parameters::serialize(Writer& writer) const
 	serdes::serializeContainer(writer, JSON_selectedFunctions, selectedFunctions);
 	serdes::serializeContainer(writer, JSON_selectedNotFoundFncs, selectedNotFoundFunctions);
 	serdes::serializeContainer(writer, JSON_llvmPasses, llvmPasses);
+	serdes::serializeContainer(writer, JSON_inputBirShards, inputBirShards);
 
 	serdes::serialize(writer, JSON_entryPoint, getEntryPoint());
 	serdes::serialize(writer, JSON_mainAddress, getMainAddress());
@@ -538,6 +878,12 @@ template void Parameters::serialize(
 	rapidjson::PrettyWriter<rapidjson::StringBuffer>&) const;
 template void Parameters::serialize(
 	rapidjson::PrettyWriter<rapidjson::StringBuffer, rapidjson::ASCII<>>&) const;
+template void Parameters::serialize(
+	serdes::JsonStreamWriter&) const;
+template void Parameters::serialize(
+	serdes::PrettyJsonStreamWriter&) const;
+template void Parameters::serialize(
+	serdes::BinaryWriter&) const;
 
 /**
  * Reads JSON object (associative array) holding parameters information.
@@ -552,7 +898,9 @@ void Parameters::deserialize(const rapidjson::Value& val)
 
 	setIsVerboseOutput( serdes::deserializeBool(val, JSON_verboseOut, false) );
 	setIsKeepAllFunctions( serdes::deserializeBool(val, JSON_keepAllFuncs) );
+	setIsPruneUnreachableFunctionsEarly( serdes::deserializeBool(val, JSON_pruneUnreachableFuncsEarly) );
 	setIsSelectedDecodeOnly( serdes::deserializeBool(val, JSON_selectedDecodeOnly) );
+	setSelectedDecodeDepth( serdes::deserializeUint64(val, JSON_selectedDecodeDepth, 0) );
 	setOrdinalNumbersDirectory( serdes::deserializeString(val, JSON_ordinalNumDir) );
 
 	setInputFile( serdes::deserializeString(val, JSON_inputFile) );
@@ -560,18 +908,33 @@ void Parameters::deserialize(const rapidjson::Value& val)
 	setOutputFile( serdes::deserializeString(val, JSON_outputFile) );
 	setOutputBitcodeFile( serdes::deserializeString(val, JSON_outputBitcodeFile) );
 	setOutputAsmFile( serdes::deserializeString(val, JSON_outputAsmFile) );
+	setIsCompressOutputAsm( serdes::deserializeBool(val, JSON_compressOutputAsm) );
 	setOutputLlvmirFile( serdes::deserializeString(val, JSON_outputLlFile) );
 	setOutputConfigFile( serdes::deserializeString(val, JSON_outputConfigFile) );
+	setIsBinaryOutputConfig( serdes::deserializeBool(val, JSON_binaryOutputConfig) );
+	setIsCompactOutputConfig( serdes::deserializeBool(val, JSON_compactOutputConfig) );
 	setOutputUnpackedFile( serdes::deserializeString(val, JSON_outputUnpackedFile) );
+	setProfileOutFile( serdes::deserializeString(val, JSON_profileOutFile) );
+	setInputBirFile( serdes::deserializeString(val, JSON_inputBirFile) );
+	setOutputBirFile( serdes::deserializeString(val, JSON_outputBirFile) );
 	setOutputFormat( serdes::deserializeString(val, JSON_outputFormat) );
 	setLogFile( serdes::deserializeString(val, JSON_logFile) );
 	setErrFile( serdes::deserializeString(val, JSON_errFile) );
 
 	setIsDetectStaticCode( serdes::deserializeBool(val, JSON_detectStaticCode, true) );
+	setIsSkipStaticCodeBodies( serdes::deserializeBool(val, JSON_skipStaticCodeBodies) );
+	setStaticCodeCacheDirectory( serdes::deserializeString(val, JSON_staticCodeCacheDir) );
 	setBackendDisabledOpts( serdes::deserializeString(val, JSON_backendDisabledOpts) );
 	setBackendEnabledOpts( serdes::deserializeString(val, JSON_backendEnabledOpts) );
 	setBackendCallInfoObtainer( serdes::deserializeString(val, JSON_backendCallInfoObtainer, "optim") );
+	setBackendAliasAnalysis( serdes::deserializeString(val, JSON_backendAliasAnalysis, "simple") );
 	setBackendVarRenamer( serdes::deserializeString(val, JSON_backendVarRenamer, "readable") );
+	setBackendCopyPropStmtLimit( serdes::deserializeUint64(val, JSON_backendCopyPropStmtLimit, 0) );
+	setBackendFunctionCostLimit( serdes::deserializeUint64(val, JSON_backendFunctionCostLimit, 0) );
+	setBackendValidation( serdes::deserializeString(val, JSON_backendValidation, "full") );
+	setBackendValidationSamplePercent( serdes::deserializeUint64(val, JSON_backendValidationSamplePercent, 10) );
+	setBackendFuncCacheDirectory( serdes::deserializeString(val, JSON_backendFuncCacheDir) );
+	setBackendGraphThreads( serdes::deserializeUint64(val, JSON_backendGraphThreads, 0) );
 	setIsBackendNoOpts( serdes::deserializeBool(val, JSON_backendNoOpts, false) );
 	setIsBackendEmitCfg( serdes::deserializeBool(val, JSON_backendEmitCfg, false) );
 	setIsBackendEmitCg( serdes::deserializeBool(val, JSON_backendEmitCg, false) );
@@ -581,8 +944,17 @@ void Parameters::deserialize(const rapidjson::Value& val)
 	setIsBackendNoVarRenaming( serdes::deserializeBool(val, JSON_backendNoVarRenaming, false) );
 	setIsBackendNoCompoundOperators( serdes::deserializeBool(val, JSON_backendNoCompoundOperators, false) );
 	setIsBackendNoSymbolicNames( serdes::deserializeBool(val, JSON_backendNoSymbolicNames, false) );
+	setIsBackendReleaseLlvmIr( serdes::deserializeBool(val, JSON_backendReleaseLlvmIr, false) );
+	setIsBackendBirOnly( serdes::deserializeBool(val, JSON_backendBirOnly, false) );
 
 	setTimeout( serdes::deserializeUint64(val, JSON_timeout, 0) );
+	setPhaseTimeout( serdes::deserializeUint64(val, JSON_phaseTimeout, 0) );
+	setDecoderThreads( serdes::deserializeUint64(val, JSON_decoderThreads, 0) );
+	setRdaThreads( serdes::deserializeUint64(val, JSON_rdaThreads, 0) );
+	setIsTranslationCache( serdes::deserializeBool(val, JSON_translationCache) );
+	setIsLazyFlags( serdes::deserializeBool(val, JSON_lazyFlags) );
+	setIsAsyncIrWriters( serdes::deserializeBool(val, JSON_asyncIrWriters) );
+	setIsConcurrentInit( serdes::deserializeBool(val, JSON_concurrentInit) );
 	setMaxMemoryLimit( serdes::deserializeUint64(val, JSON_maxMemoryLimit, 0) );
 	setIsMaxMemoryLimitHalfRam( serdes::deserializeBool(val, JSON_maxMemoryLimitHalfRam, true) );
 
@@ -599,6 +971,7 @@ void Parameters::deserialize(const rapidjson::Value& val)
 	serdes::deserializeContainer(val, JSON_selectedFunctions, selectedFunctions);
 	serdes::deserializeContainer(val, JSON_selectedNotFoundFncs, selectedNotFoundFunctions);
 	serdes::deserializeContainer(val, JSON_llvmPasses, llvmPasses);
+	serdes::deserializeContainer(val, JSON_inputBirShards, inputBirShards);
 }
 
 } // namespace config
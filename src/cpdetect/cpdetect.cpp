@@ -5,7 +5,6 @@
  */
 
 #include "retdec/utils/conversion.h"
-#include "retdec/utils/binary_path.h"
 #include "retdec/utils/equality.h"
 #include "retdec/utils/filesystem.h"
 #include "retdec/utils/string.h"
@@ -200,27 +199,25 @@ retdec::cpdetect::DetectionStrength metaToStrength(
 /**
  * Constructor
  *
- * Constructor in subclass must create members @a heuristics,
- * @a internalDatabase and @a externalSuffixes
+ * @param parser Parser of input file
+ * @param params Parameters of detection
+ * @param toolInfo Into this variable detected tools are stored
+ * @param signatures Database of YARA rules, which may be shared by more
+ *    detectors
  */
 CompilerDetector::CompilerDetector(
 		retdec::fileformat::FileFormat &parser,
 		DetectParams &params,
-		ToolInformation &toolInfo)
+		ToolInformation &toolInfo,
+		const SignatureDatabase &signatures)
 		: fileParser(parser)
 		, cpParams(params)
+		, database(signatures)
 		, toolInfo(toolInfo)
 		, targetArchitecture(fileParser.getTargetArchitecture())
 		, search(fileParser)
-		, pathToShared(getThisBinaryDirectoryPath())
 {
-	externalSuffixes = EXTERNAL_DATABASE_SUFFIXES;
-
 	bool isFat = false;
-	fs::path path(pathToShared);
-	path.append(YARA_RULES_PATH);
-	std::set<std::string> formats;
-	std::set<std::string> archs;
 	switch (fileParser.getFileFormat())
 	{
 		case Format::ELF:
@@ -323,37 +320,6 @@ CompilerDetector::CompilerDetector(
 		default:
 			break;
 	}
-
-	populateInternalPaths(path, formats, archs);
-}
-
-/**
- * External databases parsing
- * @return @c true if at least one external database was detected,
- * @c false otherwise
- */
-bool CompilerDetector::getExternalDatabases()
-{
-	auto result = false;
-
-	// iterating over all files in directory
-	for(auto& subpathIt: fs::directory_iterator("."))
-	{
-		auto subpath = subpathIt.path();
-		if (fs::is_regular_file(subpath)
-				&& std::any_of(externalSuffixes.begin(), externalSuffixes.end(),
-			[&] (const auto &suffix)
-			{
-				return endsWith(subpath.string(), suffix);
-			}
-		))
-		{
-			result = true;
-			externalDatabase.push_back(subpath.string());
-		}
-	}
-
-	return result;
 }
 
 /**
@@ -436,51 +402,6 @@ void CompilerDetector::removeUnusedCompilers()
 	}
 }
 
-/**
- * Add all YARA files from the given @p dir to internal paths member.
- * Expects @p dir structure like this: formats/archs/files
- */
-void CompilerDetector::populateInternalPaths(
-		const fs::path& dir,
-		const std::set<std::string>& formats,
-		const std::set<std::string>& archs)
-{
-	if (!fs::is_directory(dir))
-	{
-		return;
-	}
-
-	for(auto& sub1It: fs::directory_iterator(dir))
-	{
-		auto sub1 = sub1It.path();
-		if (!(fs::is_directory(sub1) && endsWith(sub1.string(), formats)))
-		{
-			continue;
-		}
-
-		for(auto& sub2It: fs::directory_iterator(sub1))
-		{
-			auto sub2 = sub2It.path();
-			if (!(fs::is_directory(sub2)
-					&& (archs.empty() || endsWith(sub2.string(), archs))))
-			{
-				continue;
-			}
-
-			for(auto& sub3It: fs::directory_iterator(sub2))
-			{
-				auto sub3 = sub3It.path();
-				if (!(fs::is_regular_file(sub3) && endsWith(sub3.string(), externalSuffixes)))
-				{
-					continue;
-				}
-
-				internalPaths.push_back(sub3.string());
-			}
-		}
-	}
-}
-
 /**
  * Try detect used compiler (or packer) based on heuristics
  */
@@ -498,32 +419,15 @@ void CompilerDetector::getAllHeuristics()
  */
 ReturnCode CompilerDetector::getAllSignatures()
 {
-	YaraDetector yara;
-
-	// Add internal paths.
-	unsigned iCntr = 0;
-	for (const auto &ruleFile : internalPaths)
-	{
-		std::string nameSpace = "internal_" + std::to_string(iCntr++);
-		yara.addRuleFile(ruleFile, nameSpace);
-	}
-
-	unsigned eCntr = 0;
-	if (cpParams.external && getExternalDatabases())
-	{
-		for (const auto &item : externalDatabase)
-		{
-			std::string nameSpace = "external_" + std::to_string(eCntr++);
-			yara.addRuleFile(item, nameSpace);
-		}
-	}
-
-	yara.analyze(
-			fileParser.getPathToFile(),
+	std::vector<YaraRule> detected;
+	std::vector<YaraRule> undetected;
+	const auto *yara = database.getRules(formats, archs, cpParams.external);
+	yara->analyze(
+			fileParser.getBytes(),
+			detected,
+			undetected,
 			cpParams.searchType != SearchType::EXACT_MATCH
 	);
-	const auto &detected = yara.getDetectedRules();
-	const auto &undetected = yara.getUndetectedRules();
 	auto result = false;
 	if (cpParams.searchType == SearchType::EXACT_MATCH
 			|| (cpParams.searchType == SearchType::MOST_SIMILAR
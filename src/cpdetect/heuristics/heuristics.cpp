@@ -688,16 +688,14 @@ void Heuristics::getDwarfInfo()
 	std::vector<std::string> languages;
 	std::vector<std::size_t> modulesCounter;
 
-	// Open input file as buffer.
+	// Use the already loaded input file content as buffer.
 	//
-	llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffOrErr =
-			llvm::MemoryBuffer::getFileOrSTDIN(fileParser.getPathToFile());
-	if (buffOrErr.getError())
-	{
-		return;
-	}
-	std::unique_ptr<llvm::MemoryBuffer> bufferPtr = std::move(buffOrErr.get());
-	llvm::MemoryBufferRef buffer = *bufferPtr;
+	const auto& bytes = fileParser.getBytes();
+	llvm::MemoryBufferRef buffer(
+			llvm::StringRef(
+				reinterpret_cast<const char*>(bytes.data()),
+				bytes.size()),
+			fileParser.getPathToFile());
 
 	// Open buffer as a binary file.
 	//
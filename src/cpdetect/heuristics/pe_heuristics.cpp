@@ -4,10 +4,12 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <chrono>
 #include <initializer_list>
 #include <limits>
 #include <map>
 #include <regex>
+#include <string_view>
 
 #include <tinyxml2/tinyxml2.h>
 
@@ -102,6 +104,8 @@ const std::vector<std::string> msvcRuntimeStrings =
 	toWide(msvcRuntimeString, 4)
 };
 
+const std::string goBuildIdString = "\xFF Go build ID: ";
+
 const std::vector<PeHeaderStyle> headerStyles =
 {
 //	{"Unknown",      { 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000 }},
@@ -168,6 +172,11 @@ PeHeuristics::PeHeuristics(
 		, declaredLength(parser.getDeclaredFileLength())
 		, loadedLength(parser.getLoadedFileLength())
 {
+	// These strings are searched in large sections of most PE files, one
+	// pass over file for all of them is cheaper than search of each one.
+	auto strings = msvcRuntimeStrings;
+	strings.push_back(goBuildIdString);
+	search.indexStrings(strings);
 }
 
 /**
@@ -272,13 +281,12 @@ void PeHeuristics::getGoHeuristics()
 		return;
 	}
 
-	const auto goString = "\xFF Go build ID: ";
-	if (section->getBytes(0, 15) == goString)
+	if (section->getBytes(0, goBuildIdString.length()) == goBuildIdString)
 	{
 		addCompiler(source, DetectionStrength::MEDIUM, "gc");
 		addLanguage("Go");
 	}
-	else if (search.hasStringInSection(goString, section))
+	else if (search.hasStringInSection(goBuildIdString, section))
 	{
 		// Go build ID not on start of section
 		addCompiler(source, DetectionStrength::LOW, "gc");
@@ -592,9 +600,10 @@ void PeHeuristics::getSafeDiscHeuristics()
 {
 	const auto &content = search.getPlainString();
 	const std::string safeDiscString = "BoG_ *90.0&!!  Yy>";
-	auto pos = content.find(safeDiscString, peParser.getSizeOfHeaders() - 0x2C);
+	const std::size_t offset = peParser.getSizeOfHeaders() - 0x2C;
 
-	if (pos == peParser.getSizeOfHeaders() - 0x2C)
+	if (offset <= content.length()
+			&& content.compare(offset, safeDiscString.length(), safeDiscString) == 0)
 	{
 		addPacker(
 				DetectionMethod::SIGNATURE,
@@ -907,7 +916,9 @@ void PeHeuristics::getUpxHeuristics()
 	// format: UPX 1.0x
 	const std::string upxVer = "UPX 1.0";
 	const auto &content = search.getPlainString();
-	auto pos = content.find(upxVer);
+	// Only occurrences in the first 0x500 bytes are accepted
+	const auto header = std::string_view(content).substr(0, 0x500 + upxVer.length());
+	auto pos = header.find(upxVer);
 	if (pos < 0x500 && pos < content.length() - upxVer.length())
 	{
 		// we must decide between UPX and UPX$HiT
@@ -936,7 +947,7 @@ void PeHeuristics::getUpxHeuristics()
 	// UPX 1.08 and later
 	// format: x.xx'\0'UPX!
 	const std::size_t minPos = 5, verLen = 4;
-	pos = content.find("UPX!");
+	pos = header.find("UPX!");
 	if (pos >= minPos && pos < 0x500 && !sections.empty() && pos < sections[0]->getOffset())
 	{
 		std::string version;
@@ -989,7 +1000,7 @@ void PeHeuristics::getPeCompactHeuristics()
 	const auto patLen = pattern.length();
 
 	const auto &content = search.getPlainString();
-	const auto pos = content.find(pattern);
+	const auto pos = std::string_view(content).substr(0, 0x500 + patLen).find(pattern);
 
 	if (pos < 0x500
 			&& pos + patLen + 2 <= content.length()
@@ -2166,41 +2177,56 @@ void PeHeuristics::getFormatSpecificLanguageHeuristics()
 
 void PeHeuristics::getFormatSpecificCompilerHeuristics()
 {
-	getHeaderStyleHeuristics();
-	getSlashedSignatures();
-	getMorphineHeuristics();
-	getStarForceHeuristics();
-	getSafeDiscHeuristics();
-	getSecuROMHeuristics();
-	getMPRMMGVAHeuristics();
-	getActiveMarkHeuristics();
-	getRLPackHeuristics();
-	getPetiteHeuristics();
-	getPelockHeuristics();
-	getEzirizReactorHeuristics();
-	getUpxHeuristics();
-	getFsgHeuristics();
-	getPeCompactHeuristics();
-	getAndpakkHeuristics();
-	getEnigmaHeuristics();
-	getVBoxHeuristics();
-	getActiveDeliveryHeuristics();
-	getAdeptProtectorHeuristics();
-	getCodeLockHeuristics();
-	getNetHeuristic();
-	getExcelsiorHeuristics();
-	getVmProtectHeuristics();
-	getBorlandDelphiHeuristics();
-	getBeRoHeuristics();
-	getMsvcIntelHeuristics();
-	getStarforceHeuristic();
-	getArmadilloHeuristic();
-	getRdataHeuristic();
-	getNullsoftHeuristic();
-	getLinkerVersionHeuristic();
-	getManifestHeuristic();
-	getSevenZipHeuristics();
-	getPeSectionHeuristics();
+	// Heuristics are run in this order, because some of them use
+	// results of the previous ones
+	static const std::pair<const char*, void (PeHeuristics::*)()> heuristicList[] =
+	{
+		{"header style", &PeHeuristics::getHeaderStyleHeuristics},
+		{"slashed signatures", &PeHeuristics::getSlashedSignatures},
+		{"morphine", &PeHeuristics::getMorphineHeuristics},
+		{"star force", &PeHeuristics::getStarForceHeuristics},
+		{"safe disc", &PeHeuristics::getSafeDiscHeuristics},
+		{"securom", &PeHeuristics::getSecuROMHeuristics},
+		{"mprmmgva", &PeHeuristics::getMPRMMGVAHeuristics},
+		{"active mark", &PeHeuristics::getActiveMarkHeuristics},
+		{"rlpack", &PeHeuristics::getRLPackHeuristics},
+		{"petite", &PeHeuristics::getPetiteHeuristics},
+		{"pelock", &PeHeuristics::getPelockHeuristics},
+		{"eziriz reactor", &PeHeuristics::getEzirizReactorHeuristics},
+		{"upx", &PeHeuristics::getUpxHeuristics},
+		{"fsg", &PeHeuristics::getFsgHeuristics},
+		{"pe compact", &PeHeuristics::getPeCompactHeuristics},
+		{"andpakk", &PeHeuristics::getAndpakkHeuristics},
+		{"enigma", &PeHeuristics::getEnigmaHeuristics},
+		{"vbox", &PeHeuristics::getVBoxHeuristics},
+		{"active delivery", &PeHeuristics::getActiveDeliveryHeuristics},
+		{"adept protector", &PeHeuristics::getAdeptProtectorHeuristics},
+		{"code lock", &PeHeuristics::getCodeLockHeuristics},
+		{"net", &PeHeuristics::getNetHeuristic},
+		{"excelsior", &PeHeuristics::getExcelsiorHeuristics},
+		{"vm protect", &PeHeuristics::getVmProtectHeuristics},
+		{"borland delphi", &PeHeuristics::getBorlandDelphiHeuristics},
+		{"bero", &PeHeuristics::getBeRoHeuristics},
+		{"msvc intel", &PeHeuristics::getMsvcIntelHeuristics},
+		{"star force sections", &PeHeuristics::getStarforceHeuristic},
+		{"armadillo", &PeHeuristics::getArmadilloHeuristic},
+		{"rdata", &PeHeuristics::getRdataHeuristic},
+		{"nullsoft", &PeHeuristics::getNullsoftHeuristic},
+		{"linker version", &PeHeuristics::getLinkerVersionHeuristic},
+		{"manifest", &PeHeuristics::getManifestHeuristic},
+		{"seven zip", &PeHeuristics::getSevenZipHeuristics},
+		{"pe section", &PeHeuristics::getPeSectionHeuristics},
+	};
+
+	for (const auto &heuristic : heuristicList)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		(this->*heuristic.second)();
+		toolInfo.heuristicTimes.emplace_back(
+				heuristic.first,
+				std::chrono::duration_cast<std::chrono::microseconds>(
+						std::chrono::steady_clock::now() - start));
+	}
 }
 
 } // namespace cpdetect
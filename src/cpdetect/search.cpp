@@ -5,6 +5,8 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <functional>
 #include <map>
 
 #include "retdec/utils/container.h"
@@ -37,6 +39,30 @@ const std::map<Architecture, std::vector<Search::RelativeJump>> jumpMap =
 	},
 };
 
+/**
+ * Check if nibble of signature matches nibble of file
+ * @param fileNibble Nibble of file
+ * @param signatureNibble Nibble of signature
+ */
+bool matchesNibble(char fileNibble, char signatureNibble)
+{
+	return fileNibble == signatureNibble
+			|| signatureNibble == '-'
+			|| signatureNibble == '?'
+			|| signatureNibble == ';';
+}
+
+/**
+ * Check if nibble of signature matches any nibble of file
+ * @param signatureNibble Nibble of signature
+ */
+bool isWildcardNibble(char signatureNibble)
+{
+	return signatureNibble == '-'
+			|| signatureNibble == '?'
+			|| signatureNibble == ';';
+}
+
 } // anonymous namespace
 
 /**
@@ -163,6 +189,111 @@ bool Search::isFileSupported() const
 	return fileSupported;
 }
 
+/**
+ * Find all occurrences of indexed strings by one pass over file
+ *
+ * Strings are searched by Aho-Corasick automaton with complete transition
+ * table, so each byte of file is processed only once regardless of number
+ * of indexed strings.
+ */
+void Search::buildStringIndex() const
+{
+	stringsIndexed = true;
+	if (indexedStrings.empty())
+	{
+		return;
+	}
+
+	// Trie of all strings. State 0 is the root.
+	std::vector<std::array<std::uint32_t, 256>> next(1);
+	next[0].fill(0);
+	std::vector<std::vector<std::size_t>> outputs(1);
+	for (std::size_t i = 0, e = indexedStrings.size(); i < e; ++i)
+	{
+		std::uint32_t state = 0;
+		for (unsigned char c : indexedStrings[i])
+		{
+			if (!next[state][c])
+			{
+				next[state][c] = next.size();
+				next.emplace_back();
+				next.back().fill(0);
+				outputs.emplace_back();
+			}
+			state = next[state][c];
+		}
+		outputs[state].push_back(i);
+	}
+
+	// Breadth-first computation of failure links. Missing transitions are
+	// replaced by transitions of failure state, outputs are inherited.
+	std::vector<std::uint32_t> fail(next.size(), 0);
+	std::vector<std::uint32_t> queue;
+	for (std::uint32_t state : next[0])
+	{
+		if (state)
+		{
+			queue.push_back(state);
+		}
+	}
+	for (std::size_t q = 0; q < queue.size(); ++q)
+	{
+		const auto state = queue[q];
+		const auto &inherited = outputs[fail[state]];
+		outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+		for (std::size_t c = 0; c < 256; ++c)
+		{
+			auto &target = next[state][c];
+			if (target)
+			{
+				fail[target] = next[fail[state]][c];
+				queue.push_back(target);
+			}
+			else
+			{
+				target = next[fail[state]][c];
+			}
+		}
+	}
+
+	std::vector<std::vector<std::size_t>> offsets(indexedStrings.size());
+	std::uint32_t state = 0;
+	for (std::size_t i = 0, e = plain.size(); i < e; ++i)
+	{
+		state = next[state][static_cast<unsigned char>(plain[i])];
+		for (auto index : outputs[state])
+		{
+			offsets[index].push_back(i + 1 - indexedStrings[index].size());
+		}
+	}
+
+	for (std::size_t i = 0, e = indexedStrings.size(); i < e; ++i)
+	{
+		stringOffsets[indexedStrings[i]] = std::move(offsets[i]);
+	}
+}
+
+/**
+ * Get offsets of all occurrences of indexed string
+ * @param str Coveted string
+ * @return Sorted offsets or @c nullptr if @a str is not indexed
+ */
+const std::vector<std::size_t>* Search::getStringOffsets(
+		const std::string &str) const
+{
+	if (!hasItem(indexedStrings, str))
+	{
+		return nullptr;
+	}
+
+	if (!stringsIndexed)
+	{
+		buildStringIndex();
+	}
+
+	return &stringOffsets[str];
+}
+
 /**
  * Get content of file in hexadecimal string representation
  * @return Content of file in hexadecimal string representation
@@ -292,21 +423,54 @@ unsigned long long Search::findUnslashedSignature(
 	const auto stopIterator = stopIndex < nibbles.size()
 			? nibbles.begin() + stopIndex
 			: nibbles.end();
-	const auto it = std::search(
-			startIterator,
-			stopIterator,
+	if (startIterator >= stopIterator)
+	{
+		return 0;
+	}
+
+	const auto literalEnd = std::find_if(
 			signPattern.begin(),
 			signPattern.end(),
-			[] (const char fileNibble, const char signatureNibble)
-			{
-				return fileNibble == signatureNibble
-						|| signatureNibble == '-'
-						|| signatureNibble == '?'
-						|| signatureNibble == ';';
-			}
+			isWildcardNibble
 	);
+	if (literalEnd == signPattern.begin())
+	{
+		const auto it = std::search(
+				startIterator,
+				stopIterator,
+				signPattern.begin(),
+				signPattern.end(),
+				matchesNibble
+		);
+		return (it != stopIterator) ? countImpNibbles(signPattern) : 0;
+	}
+
+	// Find occurrences of the literal prefix of the signature by a fast
+	// substring search and compare the rest only on them
+	const std::boyer_moore_horspool_searcher<std::string::const_iterator>
+			searcher(signPattern.begin(), literalEnd);
+	const auto literalLen = static_cast<std::size_t>(literalEnd - signPattern.begin());
+	for (auto it = std::string::const_iterator(startIterator);
+			static_cast<std::size_t>(stopIterator - it) >= signPattern.length();
+			++it)
+	{
+		it = std::search(it, std::string::const_iterator(stopIterator), searcher);
+		if (static_cast<std::size_t>(stopIterator - it) < signPattern.length())
+		{
+			break;
+		}
+
+		if (std::equal(
+				it + literalLen,
+				it + signPattern.length(),
+				literalEnd,
+				matchesNibble))
+		{
+			return countImpNibbles(signPattern);
+		}
+	}
 
-	return (it != stopIterator) ? countImpNibbles(signPattern) : 0;
+	return 0;
 }
 
 /**
@@ -544,6 +708,26 @@ bool Search::areaSimilarity(
 	return result;
 }
 
+/**
+ * Search given strings by one pass over file on first query of any of them
+ * @param strs Strings which are expected to be queried
+ *
+ * Queries of other strings are not affected. Empty strings are ignored.
+ */
+void Search::indexStrings(const std::vector<std::string> &strs)
+{
+	for (const auto &str : strs)
+	{
+		if (!str.empty() && !hasItem(indexedStrings, str))
+		{
+			indexedStrings.push_back(str);
+		}
+	}
+
+	stringOffsets.clear();
+	stringsIndexed = false;
+}
+
 /**
  * Check if file contains specified substring
  * @param str Coveted substring
@@ -551,6 +735,11 @@ bool Search::areaSimilarity(
  */
 bool Search::hasString(const std::string &str) const
 {
+	if (const auto *offsets = getStringOffsets(str))
+	{
+		return !offsets->empty();
+	}
+
 	return contains(plain, str);
 }
 
@@ -579,6 +768,17 @@ bool Search::hasString(
 		std::size_t startOffset,
 		std::size_t stopOffset) const
 {
+	if (const auto *offsets = getStringOffsets(str))
+	{
+		if (startOffset > stopOffset)
+		{
+			return false;
+		}
+
+		auto it = std::lower_bound(offsets->begin(), offsets->end(), startOffset);
+		return it != offsets->end() && *it + str.length() <= stopOffset + 1;
+	}
+
 	return hasSubstringInArea(plain, str, startOffset, stopOffset);
 }
 
@@ -0,0 +1,209 @@
+/**
+ * @file src/cpdetect/signature_database.cpp
+ * @brief Database of YARA signatures shared by compiler detections.
+ * @copyright (c) 2017 Avast Software, licensed under the MIT license
+ */
+
+#include "retdec/utils/binary_path.h"
+#include "retdec/utils/string.h"
+#include "retdec/cpdetect/settings.h"
+#include "retdec/cpdetect/signature_database.h"
+#include "retdec/yaracpp/yara_detector.h"
+
+using namespace retdec::utils;
+using namespace retdec::yaracpp;
+
+namespace retdec {
+namespace cpdetect {
+
+namespace
+{
+
+/**
+ * Create key of rules for given formats, architectures and externals
+ */
+std::string createRulesKey(
+		const std::set<std::string>& formats,
+		const std::set<std::string>& archs,
+		bool external)
+{
+	std::string key;
+	for (const auto& format : formats)
+	{
+		key += format + ",";
+	}
+	key += "/";
+	for (const auto& arch : archs)
+	{
+		key += arch + ",";
+	}
+	key += external ? "/external" : "/";
+	return key;
+}
+
+} // anonymous namespace
+
+/**
+ * Constructor
+ * @param internalRulesDir Directory with internal rules. Expected structure
+ *    of directory is formats/archs/files.
+ * @param externalRulesDir Directory with external rule files
+ */
+SignatureDatabase::SignatureDatabase(
+		const fs::path& internalRulesDir,
+		const fs::path& externalRulesDir)
+		: internalDir(internalRulesDir)
+		, externalDir(externalRulesDir)
+		, suffixes(EXTERNAL_DATABASE_SUFFIXES)
+{
+
+}
+
+/**
+ * Destructor
+ */
+SignatureDatabase::~SignatureDatabase() = default;
+
+/**
+ * Find all YARA files for given formats and architectures in internal
+ * rules directory
+ * @param formats Names of formats
+ * @param archs Names of architectures, empty set means all architectures
+ * @return Paths to rule files
+ */
+std::vector<std::string> SignatureDatabase::findInternalPaths(
+		const std::set<std::string>& formats,
+		const std::set<std::string>& archs) const
+{
+	std::vector<std::string> paths;
+	if (!fs::is_directory(internalDir))
+	{
+		return paths;
+	}
+
+	for(auto& sub1It: fs::directory_iterator(internalDir))
+	{
+		auto sub1 = sub1It.path();
+		if (!(fs::is_directory(sub1) && endsWith(sub1.string(), formats)))
+		{
+			continue;
+		}
+
+		for(auto& sub2It: fs::directory_iterator(sub1))
+		{
+			auto sub2 = sub2It.path();
+			if (!(fs::is_directory(sub2)
+					&& (archs.empty() || endsWith(sub2.string(), archs))))
+			{
+				continue;
+			}
+
+			for(auto& sub3It: fs::directory_iterator(sub2))
+			{
+				auto sub3 = sub3It.path();
+				if (!(fs::is_regular_file(sub3) && endsWith(sub3.string(), suffixes)))
+				{
+					continue;
+				}
+
+				paths.push_back(sub3.string());
+			}
+		}
+	}
+
+	return paths;
+}
+
+/**
+ * Find all YARA files in external rules directory
+ * @return Paths to rule files
+ */
+std::vector<std::string> SignatureDatabase::findExternalPaths() const
+{
+	std::vector<std::string> paths;
+	if (!fs::is_directory(externalDir))
+	{
+		return paths;
+	}
+
+	for(auto& subpathIt: fs::directory_iterator(externalDir))
+	{
+		auto subpath = subpathIt.path();
+		if (fs::is_regular_file(subpath) && endsWith(subpath.string(), suffixes))
+		{
+			paths.push_back(subpath.string());
+		}
+	}
+
+	return paths;
+}
+
+/**
+ * Get compiled rules for given formats and architectures
+ * @param formats Names of formats
+ * @param archs Names of architectures, empty set means all architectures
+ * @param external If @c true, external rules are included
+ * @return Compiled rules
+ *
+ * Returned rules are owned by database and stay valid for its whole
+ * lifetime. They may be used only by the constant analysis method, which
+ * fails if rules could not be compiled.
+ */
+const YaraDetector* SignatureDatabase::getRules(
+		const std::set<std::string>& formats,
+		const std::set<std::string>& archs,
+		bool external) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto& compiled = rules[createRulesKey(formats, archs, external)];
+	if (compiled)
+	{
+		return compiled.get();
+	}
+
+	compiled = std::make_unique<YaraDetector>();
+
+	unsigned iCntr = 0;
+	for (const auto &ruleFile : findInternalPaths(formats, archs))
+	{
+		std::string nameSpace = "internal_" + std::to_string(iCntr++);
+		compiled->addRuleFile(ruleFile, nameSpace);
+	}
+
+	if (external)
+	{
+		if (!externalPaths)
+		{
+			externalPaths = std::make_unique<std::vector<std::string>>(
+					findExternalPaths());
+		}
+
+		unsigned eCntr = 0;
+		for (const auto &ruleFile : *externalPaths)
+		{
+			std::string nameSpace = "external_" + std::to_string(eCntr++);
+			compiled->addRuleFile(ruleFile, nameSpace);
+		}
+	}
+
+	compiled->compile();
+	return compiled.get();
+}
+
+/**
+ * Get database of rules distributed with RetDec
+ * @return Database shared by whole process
+ *
+ * External rules of this database are searched in the current working
+ * directory at the time of the first request for them.
+ */
+const SignatureDatabase& SignatureDatabase::getDefault()
+{
+	static const SignatureDatabase database(
+			fs::path(getThisBinaryDirectoryPath()).append(YARA_RULES_PATH));
+	return database;
+}
+
+} // namespace cpdetect
+} // namespace retdec
@@ -5,6 +5,7 @@
 */
 
 #include <cassert>
+#include <functional>
 
 #include "retdec/ctypes/annotation.h"
 #include "retdec/ctypes/context.h"
@@ -17,6 +18,45 @@
 namespace retdec {
 namespace ctypes {
 
+namespace {
+
+/**
+* @brief Combines hash @a value into @a seed.
+*/
+template<typename T>
+void hashCombine(std::size_t &seed, const T &value)
+{
+	seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+} // anonymous namespace
+
+std::size_t Context::FunctionTypeKeyHash::operator()(
+	const FunctionTypeKey &key) const
+{
+	std::size_t seed = 0;
+	hashCombine(seed, std::get<0>(key));
+	for (const auto &param : std::get<1>(key))
+	{
+		hashCombine(seed, param);
+	}
+	hashCombine(seed, std::get<2>(key));
+	hashCombine(seed, std::get<3>(key));
+	return seed;
+}
+
+std::size_t Context::ArrayTypeKeyHash::operator()(
+	const ArrayTypeKey &key) const
+{
+	std::size_t seed = 0;
+	hashCombine(seed, key.first);
+	for (auto dimension : key.second)
+	{
+		hashCombine(seed, dimension);
+	}
+	return seed;
+}
+
 /**
 * @brief Checks if context contains function.
 *
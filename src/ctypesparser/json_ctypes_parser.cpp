@@ -10,6 +10,7 @@
 #include <sstream>
 
 #include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
 
 #include "retdec/ctypes/ctypes.h"
 #include "retdec/ctypesparser/json_ctypes_parser.h"
@@ -149,6 +150,97 @@ bool safeGetBool(
 	}
 }
 
+namespace {
+
+/**
+* @brief SAX handler storing offsets of objects in @c functions and @c types.
+*/
+class JsonIndexHandler: public rapidjson::BaseReaderHandler<
+	rapidjson::UTF8<>, JsonIndexHandler>
+{
+	public:
+		using Index = std::unordered_map<std::string, std::pair<std::size_t, std::size_t>>;
+
+	public:
+		JsonIndexHandler(
+			const rapidjson::StringStream &stream,
+			Index &functions,
+			Index &types):
+			stream(stream), functions(functions), types(types) {}
+
+		bool Default()
+		{
+			return true;
+		}
+		bool Key(const char *str, rapidjson::SizeType length, bool)
+		{
+			if (depth == 1)
+			{
+				std::string key(str, length);
+				section = key == JSON_functions ? &functions
+					: key == JSON_types ? &types
+					: nullptr;
+			}
+			else if (depth == 2)
+			{
+				name.assign(str, length);
+			}
+			return true;
+		}
+		bool StartObject()
+		{
+			++depth;
+			if (depth == 2 && section)
+			{
+				(section == &functions ? hasFunctions : hasTypes) = true;
+			}
+			else if (depth == 3 && section)
+			{
+				// The stream is just behind the opening brace.
+				start = stream.Tell() - 1;
+			}
+			return true;
+		}
+		bool EndObject(rapidjson::SizeType)
+		{
+			if (depth == 3 && section)
+			{
+				section->emplace(name, std::make_pair(start, stream.Tell()));
+			}
+			else if (depth == 2)
+			{
+				section = nullptr;
+			}
+			--depth;
+			return true;
+		}
+		bool StartArray()
+		{
+			++depth;
+			return true;
+		}
+		bool EndArray(rapidjson::SizeType)
+		{
+			--depth;
+			return true;
+		}
+
+	public:
+		bool hasFunctions = false;
+		bool hasTypes = false;
+
+	private:
+		const rapidjson::StringStream &stream;
+		Index &functions;
+		Index &types;
+		Index *section = nullptr;
+		std::string name;
+		std::size_t start = 0;
+		unsigned depth = 0;
+};
+
+} // anonymous namespace
+
 /**
 * @brief Constructs a new parser.
 */
@@ -232,6 +324,149 @@ void JSONCTypesParser::parseInto(
 	parseJsonIntoModule(root, module);
 }
 
+/**
+* @brief Loads C-types from JSON representation, but parses its functions and
+*        types only when they are requested by @c parseIndexedFunction().
+*
+* @param[in] stream Input stream containing C-types in JSON.
+* @param[in] context Context the functions are parsed into.
+* @param[in] typeWidths C-types' bit widths.
+* @param[in] callConvention Function call convention.
+*
+* @throw CTypesParseError when the input JSON is invalid.
+*
+* JSON is only scanned for offsets of its functions and types, no document is
+* built. A parser can index only one JSON, the previously indexed one is
+* forgotten.
+*/
+void JSONCTypesParser::loadIndex(
+	std::istream &stream,
+	const std::shared_ptr<retdec::ctypes::Context> &context,
+	const CTypesParser::TypeWidths &typeWidths,
+	const retdec::ctypes::CallConvention &callConvention)
+{
+	assert(context && "violated precondition - context cannot be null");
+
+	this->context = context;
+	defaultCallConv = callConvention;
+	this->typeWidths = typeWidths;
+
+	// We need a clean context for each JSON because types may have different keys.
+	parserContext.clear();
+	typesMap.clear();
+	indexedTypes.clear();
+
+	indexedJson = loadJson(stream);
+	indexJson(indexedJson);
+}
+
+/**
+* @brief Returns function @a name from the JSON loaded by @c loadIndex().
+*
+* @return Function from context, if already stored, otherwise parsed function,
+*         or @c nullptr if the loaded JSON does not contain @a name.
+*
+* @throw CTypesParseError when the function in JSON is invalid.
+*/
+std::shared_ptr<retdec::ctypes::Function> JSONCTypesParser::parseIndexedFunction(
+	const std::string &name)
+{
+	auto fIt = functionsIndex.find(name);
+	if (fIt == functionsIndex.end())
+	{
+		return nullptr;
+	}
+
+	auto cachedFunc = context->getFunctionWithName(name);
+	if (cachedFunc)
+	{
+		return cachedFunc;
+	}
+
+	rapidjson::Document jsonFunction;
+	rapidjson::ParseResult res = jsonFunction.Parse(
+		indexedJson.data() + fIt->second.first,
+		fIt->second.second - fIt->second.first);
+	if (!res)
+	{
+		handleParsingFailure(res);
+	}
+	return parseFunction(jsonFunction, name);
+}
+
+/**
+* @brief Stores offsets of functions and types of @a json to maps.
+*
+* @throw CTypesParseError when the input JSON is invalid.
+*/
+void JSONCTypesParser::indexJson(const std::string &json)
+{
+	functionsIndex.clear();
+	typesIndex.clear();
+
+	rapidjson::StringStream stream(json.c_str());
+	JsonIndexHandler handler(stream, functionsIndex, typesIndex);
+	rapidjson::Reader reader;
+	rapidjson::ParseResult res = reader.Parse(stream, handler);
+	if (!res)
+	{
+		handleParsingFailure(res);
+	}
+	if (!handler.hasFunctions)
+	{
+		throw CTypesParseError(JSON_functions + " must be an object value");
+	}
+	if (!handler.hasTypes)
+	{
+		throw CTypesParseError(JSON_types + " must be an object value");
+	}
+}
+
+/**
+* @brief Returns JSON of type @a typeKey, from the whole parsed JSON or from
+*        the indexed one.
+*
+* @throw CTypesParseError when there is no such a type, or it is invalid.
+*/
+const rapidjson::Value &JSONCTypesParser::getJsonType(const std::string &typeKey)
+{
+	auto tIt = typesMap.find(typeKey);
+	if (tIt != typesMap.end())
+	{
+		return *tIt->second;
+	}
+
+	auto iIt = typesIndex.find(typeKey);
+	if (iIt == typesIndex.end())
+	{
+		throw CTypesParseError("type " + typeKey + " not found");
+	}
+
+	const rapidjson::Value &jsonType = parseIndexedEntry(iIt->second);
+	typesMap.emplace(typeKey, &jsonType);
+	return jsonType;
+}
+
+/**
+* @brief Parses JSON object at offsets @a entry of @c indexedJson.
+*
+* @throw CTypesParseError when the object is invalid.
+*/
+const rapidjson::Value &JSONCTypesParser::parseIndexedEntry(
+	const std::pair<std::size_t, std::size_t> &entry)
+{
+	auto doc = std::make_unique<rapidjson::Document>();
+	rapidjson::ParseResult res = doc->Parse(
+		indexedJson.data() + entry.first,
+		entry.second - entry.first);
+	if (!res)
+	{
+		handleParsingFailure(res);
+	}
+	indexedTypes.push_back(std::move(doc));
+	return *indexedTypes.back();
+}
+
 /**
 * @brief Loads JSON from the input stream to a string.
 */
@@ -276,6 +511,8 @@ void JSONCTypesParser::parseJsonIntoModule(
 {
 	// We need a clean context for each JSON because types may have different keys.
 	parserContext.clear();
+	functionsIndex.clear();
+	typesIndex.clear();
 	const rapidjson::Value &functions = safeGetObject(*root, JSON_functions);
 
 	addTypesToMap(safeGetObject(*root, JSON_types));
@@ -298,7 +535,7 @@ void JSONCTypesParser::addTypesToMap(const rapidjson::Value &types)
 	typesMap.clear();
 	for (auto i = types.MemberBegin(), e = types.MemberEnd(); i != e; ++i)
 	{
-		typesMap.emplace(i->name.GetString(), i);
+		typesMap.emplace(i->name.GetString(), &i->value);
 	}
 }
 
@@ -504,7 +741,7 @@ std::shared_ptr<retdec::ctypes::Type> JSONCTypesParser::getOrParseType(
 std::shared_ptr<retdec::ctypes::Type> JSONCTypesParser::parseType(
 	const std::string &typeKey)
 {
-	const rapidjson::Value &jsonType = retdec::utils::mapGetValueOrDefault(typesMap, typeKey)->value;
+	const rapidjson::Value &jsonType = getJsonType(typeKey);
 	std::string typeOfType = safeGetString(jsonType, JSON_type);
 	std::shared_ptr<retdec::ctypes::Type> parsedType;
 
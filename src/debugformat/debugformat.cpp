@@ -6,6 +6,7 @@
 
 #define LOG_ENABLED false
 
+#include <algorithm>
 #include <sstream>
 
 #include "retdec/utils/debug.h"
@@ -24,16 +25,19 @@ DebugFormat::DebugFormat()
  * @param pdbFile   Input PDB file to load debugging information from.
  * @param symtab    Symbol table.
  * @param demangler Demangled instance used for this input file.
+ * @param threads   Number of threads loading DWARF compilation units.
  */
 DebugFormat::DebugFormat(
 		retdec::loader::Image* inFile,
 		const std::string& pdbFile,
 		SymbolTable* symtab,
-		retdec::demangler::Demangler* demangler)
+		retdec::demangler::Demangler* demangler,
+		unsigned threads)
 		:
 		_symtab(symtab),
 		_inFile(inFile),
-		_demangler(demangler)
+		_demangler(demangler),
+		_threads(std::max(1u, threads))
 {
 	_pdbFile = new retdec::pdbparser::PDBFile();
 	auto s = _pdbFile->load_pdb_file(pdbFile.c_str());
@@ -53,6 +57,11 @@ DebugFormat::DebugFormat(
 		loadPdb();
 	}
 
+	// Everything needed was copied from the PDB, do not keep its (possibly
+	// huge) content in memory.
+	delete _pdbFile;
+	_pdbFile = nullptr;
+
 	loadDwarf();
 
 	loadSymtab();
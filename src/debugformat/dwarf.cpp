@@ -10,6 +10,7 @@
 
 #include "retdec/demangler/demangler.h"
 #include "retdec/utils/debug.h"
+#include "retdec/utils/parallel.h"
 #include "retdec/utils/string.h"
 #include "retdec/debugformat/debugformat.h"
 
@@ -27,17 +28,15 @@ namespace debugformat {
 
 void DebugFormat::loadDwarf()
 {
-	// Open input file as buffer.
+	// Use the already loaded input file content as buffer, the file itself
+	// may not even exist (e.g. in-memory output of the unpacker).
 	//
-	llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffOrErr =
-			llvm::MemoryBuffer::getFileOrSTDIN(
-				_inFile->getFileFormat()->getPathToFile());
-	if (buffOrErr.getError())
-	{
-		return;
-	}
-	std::unique_ptr<llvm::MemoryBuffer> bufferPtr = std::move(buffOrErr.get());
-	llvm::MemoryBufferRef buffer = *bufferPtr;
+	const auto& bytes = _inFile->getFileFormat()->getBytes();
+	llvm::MemoryBufferRef buffer(
+			llvm::StringRef(
+				reinterpret_cast<const char*>(bytes.data()),
+				bytes.size()),
+			_inFile->getFileFormat()->getPathToFile());
 
 	// Open buffer as a binary file.
 	//
@@ -65,16 +64,61 @@ void DebugFormat::loadDwarf()
 
 	// Inspect compilation unit DIEs.
 	//
+	// Units are loaded in parallel. DIEs and line tables are parsed lazily
+	// by LLVM, which is not thread-safe, so they are parsed here first.
+	// Loading of units then only reads them. Results of the units are
+	// merged in order afterwards, so they are the same as if the units
+	// were loaded one by one.
+	//
+	std::vector<llvm::DWARFDie> unitDies;
+	std::vector<DwarfUnit> units;
 	for (auto& unit : DICtx->compile_units())
 	{
 		if (auto unitDie = unit->getUnitDIE(false))
 		{
-			loadDwarf_CU(unitDie);
+			unitDies.push_back(unitDie);
+			units.emplace_back();
+			units.back().lines = DICtx->getLineTableForUnit(unit.get());
+		}
+	}
+
+	utils::parallelFor(units.size(), _threads, [&](std::size_t i)
+	{
+		loadDwarf_CU(unitDies[i], units[i]);
+	});
+
+	// Symbols and demangler are not thread-safe, finish functions here.
+	//
+	for (auto& u : units)
+	{
+		for (auto& f : u.functions)
+		{
+			auto* sym = _inFile->getFileFormat()->getSymbol(f.getStart() + 1);
+			f.setIsThumb(sym && sym->isThumbSymbol());
+
+			if (!f.getDemangledName().empty())
+			{
+				auto dn = _demangler->demangleToString(f.getDemangledName());
+				if (!dn.empty())
+				{
+					f.setDemangledName(dn);
+				}
+			}
+
+			functions.insert({f.getStart(), std::move(f)});
+		}
+		for (auto& v : u.globals)
+		{
+			globals.insert(std::move(v));
+		}
+		for (auto& t : u.types)
+		{
+			types.insert(t);
 		}
 	}
 }
 
-void DebugFormat::loadDwarf_CU(llvm::DWARFDie die)
+void DebugFormat::loadDwarf_CU(llvm::DWARFDie die, DwarfUnit& u) const
 {
 	for (auto c : die.children())
 	{
@@ -82,19 +126,19 @@ void DebugFormat::loadDwarf_CU(llvm::DWARFDie die)
 		{
 			case llvm::dwarf::DW_TAG_subprogram:
 			{
-				auto f = loadDwarf_subprogram(c);
+				auto f = loadDwarf_subprogram(c, u);
 				if (!f.getName().empty() && f.getStart().isDefined())
 				{
-					functions.insert({f.getStart(), f});
+					u.functions.push_back(std::move(f));
 				}
 				break;
 			}
 			case llvm::dwarf::DW_TAG_variable:
 			{
-				auto v = loadDwarf_variable(c);
+				auto v = loadDwarf_variable(c, u);
 				if (!v.getName().empty())
 				{
-					globals.insert(v);
+					u.globals.push_back(std::move(v));
 				}
 			}
 			default:
@@ -103,7 +147,13 @@ void DebugFormat::loadDwarf_CU(llvm::DWARFDie die)
 	}
 }
 
-retdec::common::Function DebugFormat::loadDwarf_subprogram(llvm::DWARFDie die)
+/**
+ * Demangled name of the returned function is set to its linkage name, which
+ * is demangled after all units are loaded.
+ */
+retdec::common::Function DebugFormat::loadDwarf_subprogram(
+		llvm::DWARFDie die,
+		DwarfUnit& u) const
 {
 	// Start & end address.
 	//
@@ -148,8 +198,7 @@ retdec::common::Function DebugFormat::loadDwarf_subprogram(llvm::DWARFDie die)
 	if (ln.hasValue())
 	{
 		linkageName = ln.getValue();
-		auto dn = _demangler->demangleToString(linkageName);
-		demangledName = dn.empty() ? linkageName : dn;
+		demangledName = linkageName;
 	}
 	if (name.empty() && linkageName.empty())
 	{
@@ -157,7 +206,7 @@ retdec::common::Function DebugFormat::loadDwarf_subprogram(llvm::DWARFDie die)
 	}
 
 	auto* unit = die.getDwarfUnit();
-	auto* lines = unit->getContext().getLineTableForUnit(unit);
+	auto* lines = u.lines;
 
 	retdec::common::Function dif(linkageName.empty() ? name : linkageName);
 
@@ -165,9 +214,6 @@ retdec::common::Function DebugFormat::loadDwarf_subprogram(llvm::DWARFDie die)
 	dif.setStartEnd(start, end);
 	dif.setDemangledName(demangledName);
 
-	auto* sym = _inFile->getFileFormat()->getSymbol(start + 1);
-	dif.setIsThumb(sym && sym->isThumbSymbol());
-
 	// Source file name.
 	//
 	if (auto i = llvm::dwarf::toUnsigned(die.find(llvm::dwarf::DW_AT_decl_file)))
@@ -216,7 +262,7 @@ retdec::common::Function DebugFormat::loadDwarf_subprogram(llvm::DWARFDie die)
 	{
 		if (auto odie = unit->getDIEForOffset(o.getValue()))
 		{
-			dif.returnType = loadDwarf_type(odie);
+			dif.returnType = loadDwarf_type(odie, u);
 		}
 	}
 	else
@@ -235,11 +281,11 @@ retdec::common::Function DebugFormat::loadDwarf_subprogram(llvm::DWARFDie die)
 				dif.setIsVariadic(true);
 				break;
 			case llvm::dwarf::DW_TAG_formal_parameter:
-				dif.parameters.push_back(loadDwarf_formal_parameter(c, argCntr++));
+				dif.parameters.push_back(loadDwarf_formal_parameter(c, argCntr++, u));
 				break;
 			case llvm::dwarf::DW_TAG_variable:
 			{
-				auto var = loadDwarf_variable(c);
+				auto var = loadDwarf_variable(c, u);
 				if (!var.getName().empty())
 				{
 					dif.locals.insert(var);
@@ -254,11 +300,11 @@ retdec::common::Function DebugFormat::loadDwarf_subprogram(llvm::DWARFDie die)
 	return dif;
 }
 
-std::string DebugFormat::loadDwarf_type(llvm::DWARFDie die)
+std::string DebugFormat::loadDwarf_type(llvm::DWARFDie die, DwarfUnit& u) const
 {
 	// Try to use cache.
-	auto it = dieOff2type.find({die.getDwarfUnit(), die.getOffset()});
-	if (it != dieOff2type.end())
+	auto it = u.dieOff2type.find(die.getOffset());
+	if (it != u.dieOff2type.end())
 	{
 		return it->second;
 	}
@@ -270,18 +316,16 @@ std::string DebugFormat::loadDwarf_type(llvm::DWARFDie die)
 	// If it does end up here, this will protect us from infinite recursion.
 	// Named types (e.g. structures) needs some more hacking in their
 	/// processing.
-	dieOff2type.insert(
-			{{die.getDwarfUnit(), die.getOffset()},
-			getDefaultDataType()});
+	u.dieOff2type.insert({die.getOffset(), getDefaultDataType()});
 
-	auto ret = _loadDwarf_type(die);
+	auto ret = _loadDwarf_type(die, u);
 
-	dieOff2type[{die.getDwarfUnit(), die.getOffset()}] = ret;
+	u.dieOff2type[die.getOffset()] = ret;
 
 	return ret;
 }
 
-std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die)
+std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die, DwarfUnit& u) const
 {
 	switch (die.getTag())
 	{
@@ -341,7 +385,7 @@ std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die)
 			{
 				if (auto odie = die.getDwarfUnit()->getDIEForOffset(o.getValue()))
 				{
-					return loadDwarf_type(odie) + "*";
+					return loadDwarf_type(odie, u) + "*";
 				}
 			}
 			// Default here is pointer to void.
@@ -355,7 +399,7 @@ std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die)
 			{
 				if (auto odie = die.getDwarfUnit()->getDIEForOffset(o.getValue()))
 				{
-					type = loadDwarf_type(odie);
+					type = loadDwarf_type(odie, u);
 				}
 			}
 			unsigned dimensions = 0;
@@ -399,7 +443,7 @@ std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die)
 			{
 				if (auto odie = die.getDwarfUnit()->getDIEForOffset(o.getValue()))
 				{
-					return loadDwarf_type(odie);
+					return loadDwarf_type(odie, u);
 				}
 			}
 			return getDefaultDataType();
@@ -407,25 +451,26 @@ std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die)
 		case llvm::dwarf::DW_TAG_structure_type:
 		case llvm::dwarf::DW_TAG_class_type:
 		{
-			auto it = dieOff2type.find({die.getDwarfUnit(), die.getOffset()});
+			auto it = u.dieOff2type.find(die.getOffset());
 			// Because we insert default type to cache before processing the
 			// type, we need to ignore default types in the map.
-			if (it != dieOff2type.end() && it->second != getDefaultDataType())
+			if (it != u.dieOff2type.end() && it->second != getDefaultDataType())
 			{
 				return it->second;
 			}
 
-			static unsigned anonStuctCntr = 0;
+			// Anonymous structures are named by their DIE offsets, which are
+			// unique and do not depend on the order of loading of units.
 			auto n = llvm::dwarf::toString(die.find(llvm::dwarf::DW_AT_name));
 			std::string name = n
 					? std::string("%") + n.getValue()
-					: "%anon_struct_" + std::to_string(anonStuctCntr++);
+					: "%anon_struct_" + std::to_string(die.getOffset());
 
 			// It is important to insert an entry into cache container before
 			// calling loadDwarf_type() recursively.
 			// This will prevent infinite cycle if structure contains pointer to
 			// itself.
-			dieOff2type[{die.getDwarfUnit(), die.getOffset()}] = name;
+			u.dieOff2type[die.getOffset()] = name;
 
 			std::string body;
 			for (auto c : die.children())
@@ -437,7 +482,7 @@ std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die)
 					{
 						if (auto odie = c.getDwarfUnit()->getDIEForOffset(o.getValue()))
 						{
-							elem = loadDwarf_type(odie);
+							elem = loadDwarf_type(odie, u);
 						}
 					}
 
@@ -447,7 +492,7 @@ std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die)
 			}
 			body += body.empty() ? "{" + getDefaultDataType() + "}" : "}";
 
-			types.insert(name + " = type " + body);
+			u.types.push_back(name + " = type " + body);
 			return name;
 		}
 		case llvm::dwarf::DW_TAG_subroutine_type:
@@ -457,7 +502,7 @@ std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die)
 			{
 				if (auto odie = die.getDwarfUnit()->getDIEForOffset(o.getValue()))
 				{
-					ret = loadDwarf_type(odie);
+					ret = loadDwarf_type(odie, u);
 				}
 			}
 
@@ -471,7 +516,7 @@ std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die)
 					{
 						if (auto odie = c.getDwarfUnit()->getDIEForOffset(o.getValue()))
 						{
-							param = loadDwarf_type(odie);
+							param = loadDwarf_type(odie, u);
 						}
 					}
 
@@ -491,7 +536,8 @@ std::string DebugFormat::_loadDwarf_type(llvm::DWARFDie die)
 
 retdec::common::Object DebugFormat::loadDwarf_formal_parameter(
 		llvm::DWARFDie die,
-		unsigned argCntr)
+		unsigned argCntr,
+		DwarfUnit& u) const
 {
 	std::string name = std::string("a") + std::to_string(argCntr);
 	if (auto n = llvm::dwarf::toString(die.find(
@@ -510,13 +556,15 @@ retdec::common::Object DebugFormat::loadDwarf_formal_parameter(
 	{
 		if (auto odie = die.getDwarfUnit()->getDIEForOffset(o.getValue()))
 		{
-			arg.type = loadDwarf_type(odie);
+			arg.type = loadDwarf_type(odie, u);
 		}
 	}
 	return arg;
 }
 
-retdec::common::Object DebugFormat::loadDwarf_variable(llvm::DWARFDie die)
+retdec::common::Object DebugFormat::loadDwarf_variable(
+		llvm::DWARFDie die,
+		DwarfUnit& u) const
 {
 	std::string name;
 	if (auto n = llvm::dwarf::toString(die.find(
@@ -581,7 +629,7 @@ retdec::common::Object DebugFormat::loadDwarf_variable(llvm::DWARFDie die)
 	{
 		if (auto odie = die.getDwarfUnit()->getDIEForOffset(o.getValue()))
 		{
-			var.type = loadDwarf_type(odie);
+			var.type = loadDwarf_type(odie, u);
 		}
 	}
 	return var;
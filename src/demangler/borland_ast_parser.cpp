@@ -358,7 +358,7 @@ std::shared_ptr<Node> BorlandASTParser::parseFuncNameLlvm()
 
 bool BorlandASTParser::couldBeOperator()
 {
-	std::set<std::string> operators = {
+	static const std::set<std::string> operators = {
 		"$badd$",
 		"$bsubs$",
 		"$bsub$",
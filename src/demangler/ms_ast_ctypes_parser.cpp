@@ -5,6 +5,7 @@
 */
 
 #include <cassert>
+#include <map>
 #include <sstream>
 
 #include <llvm/Demangle/MicrosoftDemangleNodes.h>
@@ -306,7 +307,7 @@ std::string MsToCtypesParser::getTypeName(llvm::ms_demangle::PrimitiveKind type)
 {
 	using PrimitiveKind = llvm::ms_demangle::PrimitiveKind;
 
-	std::map<llvm::ms_demangle::PrimitiveKind, std::string> typeMap{
+	static const std::map<llvm::ms_demangle::PrimitiveKind, std::string> typeMap{
 		{PrimitiveKind::Bool, "bool"},
 		{PrimitiveKind::Char, "char"},
 		{PrimitiveKind::Schar, "signed char"},
@@ -327,7 +328,8 @@ std::string MsToCtypesParser::getTypeName(llvm::ms_demangle::PrimitiveKind type)
 		{PrimitiveKind::Ldouble, "long double"}
 	};
 
-	return typeMap[type];
+	auto it = typeMap.find(type);
+	return it != typeMap.end() ? it->second : std::string();
 }
 
 std::shared_ptr<ctypes::FunctionType> MsToCtypesParser::parseFuncType(
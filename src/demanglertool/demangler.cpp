@@ -4,12 +4,21 @@
  * @copyright (c) 2019 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <cstdio>
 #include <string>
 #include <iostream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "retdec/demangler/demangler.h"
 
+#include "retdec/utils/conversion.h"
 #include "retdec/utils/io/log.h"
+#include "retdec/utils/parallel.h"
+#include "retdec/utils/string.h"
 #include "retdec/utils/version.h"
 
 using namespace std::string_literals;
@@ -27,7 +36,233 @@ const std::string helpmsg =
 	"Usage:\n"
 	"\tretdec-demangler [-h, --help]   | Show this help.\n"
 	"\tretdec-demangler --version      | Show RetDec version.\n"
-	"\tretdec-demangler <mangledname>  | Attempt to demangle <mangledname> using all available demanglers and print result if succeded.\n";
+	"\tretdec-demangler <mangledname>  | Attempt to demangle <mangledname> using all available demanglers and print result if succeded.\n"
+	"\tretdec-demangler --stdin [--json] [--jobs N]\n"
+	"\t                                | Demangle names read from the standard input, one per line, and print one line for each\n"
+	"\t                                | of them in the same order: the demangled name, or the input if it was not demangled.\n"
+	"\t                                | The demangler is chosen by the prefix of the name. With --json, each line is a JSON\n"
+	"\t                                | object with keys \"mangled\", \"scheme\" and \"demangled\". Names are demangled on N\n"
+	"\t                                | threads (all cores by default).\n";
+
+namespace {
+
+/**
+ * @brief Number of names read from the input before they are demangled.
+ */
+const std::size_t STREAM_BATCH_SIZE = 16 * 1024;
+
+/**
+ * @brief Maximal number of names kept in the cache of demangled names.
+ */
+const std::size_t STREAM_CACHE_SIZE = 1024 * 1024;
+
+/**
+ * @brief Result of demangling of one name in the streaming mode.
+ */
+struct DemangledName
+{
+	/// Demangler that succeeded (gcc, ms or borland), empty if none did.
+	std::string scheme;
+	/// Demangled name.
+	std::string demangled;
+};
+
+/**
+ * @brief Demanglers used by one thread of the streaming mode.
+ */
+class Demanglers
+{
+	public:
+		DemangledName demangle(const std::string& mangled);
+
+	private:
+		bool tryGcc(const std::string& mangled, DemangledName& result);
+		bool tryMs(const std::string& mangled, DemangledName& result);
+		bool tryBorland(const std::string& mangled, DemangledName& result);
+
+	private:
+		ItaniumDemangler gcc;
+		MicrosoftDemangler ms;
+		BorlandDemangler borland;
+};
+
+/**
+ * @brief Demangle the given name by the demangler of its mangling scheme.
+ *
+ * Every scheme starts its names with a different prefix, so only names
+ * without any known prefix are given to all demanglers.
+ */
+DemangledName Demanglers::demangle(const std::string& mangled)
+{
+	DemangledName result;
+
+	if (startsWith(mangled, "_Z") || startsWith(mangled, "__Z")
+			|| startsWith(mangled, "_GLOBAL__")) {
+		tryGcc(mangled, result);
+	}
+	else if (startsWith(mangled, "?")) {
+		tryMs(mangled, result);
+	}
+	else if (startsWith(mangled, "@")) {
+		tryBorland(mangled, result);
+	}
+	else {
+		tryGcc(mangled, result)
+			|| tryMs(mangled, result)
+			|| tryBorland(mangled, result);
+	}
+
+	return result;
+}
+
+bool Demanglers::tryGcc(const std::string& mangled, DemangledName& result)
+{
+	result.demangled = gcc.demangleToString(mangled);
+	result.scheme = result.demangled.empty() ? "" : "gcc";
+	return !result.demangled.empty();
+}
+
+bool Demanglers::tryMs(const std::string& mangled, DemangledName& result)
+{
+	result.demangled = ms.demangleToString(mangled);
+	result.scheme = result.demangled.empty() ? "" : "ms";
+	return !result.demangled.empty();
+}
+
+bool Demanglers::tryBorland(const std::string& mangled, DemangledName& result)
+{
+	result.demangled = borland.demangleToString(mangled);
+	result.scheme = result.demangled.empty() ? "" : "borland";
+	return !result.demangled.empty();
+}
+
+/**
+ * @brief Append the given string as a JSON string literal.
+ */
+void appendJsonString(std::string& out, const std::string& str)
+{
+	out += '"';
+	for (unsigned char c : str) {
+		switch (c) {
+			case '"': out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n"; break;
+			case '\r': out += "\\r"; break;
+			case '\t': out += "\\t"; break;
+			default:
+				if (c < 0x20) {
+					char buffer[8];
+					std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+					out += buffer;
+				}
+				else {
+					out += c;
+				}
+				break;
+		}
+	}
+	out += '"';
+}
+
+/**
+ * @brief Append one output line for the given name.
+ */
+void appendResult(
+		std::string& out,
+		const std::string& mangled,
+		const DemangledName& result,
+		bool json)
+{
+	if (!json) {
+		out += result.demangled.empty() ? mangled : result.demangled;
+	}
+	else {
+		out += "{\"mangled\":";
+		appendJsonString(out, mangled);
+		out += ",\"scheme\":";
+		if (result.scheme.empty()) {
+			out += "null";
+		}
+		else {
+			appendJsonString(out, result.scheme);
+		}
+		out += ",\"demangled\":";
+		appendJsonString(out, result.demangled);
+		out += '}';
+	}
+	out += '\n';
+}
+
+/**
+ * @brief Demangle names from the standard input.
+ *
+ * Names are read in batches. Names that are not in the cache yet are
+ * demangled in parallel, every thread with its own demanglers, and the
+ * whole batch is then printed in the input order. Symbol dumps repeat names
+ * a lot, so the cache is kept across batches until it grows too large.
+ */
+int processStream(bool json, unsigned jobs)
+{
+	std::unordered_map<std::string, DemangledName> cache;
+	std::vector<std::string> batch;
+	std::vector<const DemangledName*> batchResults;
+	std::vector<std::pair<const std::string*, DemangledName*>> pending;
+	std::string output;
+
+	std::ios::sync_with_stdio(false);
+
+	bool eof = false;
+	while (!eof) {
+		batch.clear();
+		std::string line;
+		while (batch.size() < STREAM_BATCH_SIZE) {
+			if (!std::getline(std::cin, line)) {
+				eof = true;
+				break;
+			}
+			if (!line.empty() && line.back() == '\r') {
+				line.pop_back();
+			}
+			batch.push_back(std::move(line));
+		}
+
+		if (cache.size() > STREAM_CACHE_SIZE) {
+			cache.clear();
+		}
+
+		// Names are inserted into the cache before demangling, so names
+		// repeated within the batch are demangled only once. References to
+		// elements of the map stay valid while other elements are inserted.
+		batchResults.clear();
+		pending.clear();
+		for (const auto& name : batch) {
+			auto inserted = cache.emplace(name, DemangledName());
+			if (inserted.second) {
+				pending.emplace_back(&inserted.first->first, &inserted.first->second);
+			}
+			batchResults.push_back(&inserted.first->second);
+		}
+
+		unsigned threads = std::min<std::size_t>(jobs, pending.size());
+		parallelFor(threads, threads, [&](std::size_t t) {
+			Demanglers demanglers;
+			for (std::size_t i = t; i < pending.size(); i += threads) {
+				*pending[i].second = demanglers.demangle(*pending[i].first);
+			}
+		});
+
+		output.clear();
+		for (std::size_t i = 0; i < batch.size(); ++i) {
+			appendResult(output, batch[i], *batchResults[i], json);
+		}
+		Log::info() << output;
+	}
+
+	Log::info() << std::flush;
+	return 0;
+}
+
+} // anonymous namespace
 
 /**
  * @brief Main function of the Demangler tool.
@@ -53,6 +288,27 @@ int main(int argc, char *argv[])
 		return 0;
 	}
 
+	if ("--stdin"s == argv[1])
+	{
+		bool json = false;
+		unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+		for (int i = 2; i < argc; i++) {
+			if ("--json"s == argv[i]) {
+				json = true;
+			}
+			else if ("--jobs"s == argv[i] && i + 1 < argc
+					&& strToNum(argv[i + 1], jobs) && jobs > 0) {
+				i++;
+			}
+			else {
+				Log::error() << "Invalid argument '" << argv[i] << "'.\n\n";
+				Log::info() << helpmsg;
+				return 1;
+			}
+		}
+		return processStream(json, jobs);
+	}
+
 	//process all mangled arguments
 	for (unsigned int i = 1; i < static_cast<unsigned int>(argc); i++) {
 		//demangle using all available demanglers
@@ -4,7 +4,9 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <elfio/elf_types.hpp>
+#include <limits>
 #include <map>
 #include <regex>
 
@@ -1628,9 +1630,10 @@ bool ElfFormat::getRelocationMask(unsigned relType, std::vector<std::uint8_t> &m
  * Load relocation tables which are related to @a symbolTable section
  * @param file Parser of ELF file
  * @param symbolTable Symbol table section
- * @param nameAddressMap Into this multimap is stored name and address of each stored relocation
+ * @param nameAddresses Into this vector is stored name and address of each stored relocation.
+ *    The vector is sorted and contains no duplicates.
  */
-void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *symbolTable, std::unordered_multimap<std::string, unsigned long long> &nameAddressMap)
+void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *symbolTable, std::vector<std::pair<std::string, unsigned long long>> &nameAddresses)
 {
 	Relocation relocation;
 	std::string relName;
@@ -1640,8 +1643,14 @@ void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *
 	std::vector<std::uint8_t> relocationMask;
 	std::vector<relocation_section_accessor*> relTables;
 	std::vector<section*> appSecs;
-	nameAddressMap.clear();
+	nameAddresses.clear();
 	getRelatedRelocationTables(file, symbolTable, relTables, appSecs);
+	const bool isMips64 = isMips() && elfClass == ELFCLASS64;
+	std::unique_ptr<symbol_section_accessor> mipsSymbols;
+	if(isMips64)
+	{
+		mipsSymbols = std::make_unique<symbol_section_accessor>(*file, file->sections[symbolTable->get_index()]);
+	}
 
 	for(std::size_t i = 0, addrOffset = 0, e = relTables.size(); i < e; ++i)
 	{
@@ -1654,7 +1663,7 @@ void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *
 
 		for(std::size_t j = 0, f = relTables[i]->get_loaded_entries_num(); j < f; ++j)
 		{
-			if (isMips() && elfClass == ELFCLASS64)
+			if (isMips64)
 			{
 				Elf_Word index = 0;
 				Elf64_Byte value = 0;
@@ -1664,8 +1673,7 @@ void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *
 				Elf_Xword size;
 				Elf_Half section;
 				unsigned char bind, symbolType, other;
-				symbol_section_accessor symbols(*file, file->sections[symbolTable->get_index()]);
-				symbols.get_symbol(index, relName, relValue, size, bind, symbolType, section, other);
+				mipsSymbols->get_symbol(index, relName, relValue, size, bind, symbolType, section, other);
 
 				for (int k = 0; k < 3; ++k)
 				{
@@ -1678,7 +1686,7 @@ void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *
 						}
 						appSecs[i] ? relocation.setLinkToSection(appSecs[i]->get_index()) : relocation.invalidateLinkToSection();
 						reltab->addRelocation(relocation);
-						nameAddressMap.emplace(relName, relOffset + addrOffset);
+						nameAddresses.emplace_back(relName, relOffset + addrOffset);
 					}
 				}
 			}
@@ -1697,7 +1705,7 @@ void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *
 				relocation.setLinkToSymbol(relSymbol);
 
 				reltab->addRelocation(relocation);
-				nameAddressMap.emplace(relName, relOffset + addrOffset);
+				nameAddresses.emplace_back(relName, relOffset + addrOffset);
 			}
 		}
 
@@ -1705,6 +1713,9 @@ void ElfFormat::loadRelocations(const ELFIO::elfio *file, const ELFIO::section *
 		relocationTables.push_back(reltab);
 		delete relTables[i];
 	}
+
+	std::sort(nameAddresses.begin(), nameAddresses.end());
+	nameAddresses.erase(std::unique(nameAddresses.begin(), nameAddresses.end()), nameAddresses.end());
 }
 
 /**
@@ -1733,8 +1744,8 @@ void ElfFormat::loadSymbols(const ELFIO::elfio *file, const ELFIO::symbol_sectio
 	Elf_Xword size = 0;
 	Elf64_Addr value = 0;
 	unsigned char bind = 0, type = 0, other = 0;
-	std::unordered_multimap<std::string, unsigned long long> importNameAddressMap;
-	loadRelocations(file, section, importNameAddressMap);
+	std::vector<std::pair<std::string, unsigned long long>> importNameAddresses;
+	loadRelocations(file, section, importNameAddresses);
 
 	/* check to ignore symbols from segments for telfhash this is pretty
 	   ugly and error prone, find a better way to know symbol source */
@@ -1780,18 +1791,20 @@ void ElfFormat::loadSymbols(const ELFIO::elfio *file, const ELFIO::symbol_sectio
 				{
 					importTable = new ElfImportTable();
 				}
-				auto keyIter = importNameAddressMap.equal_range(name);
-				// we create std::set from std::multimap values in order to ensure determinism
-				std::set<std::pair<std::string, unsigned long long>> addresses(keyIter.first, keyIter.second);
-				for(const auto &address : addresses)
+				// sorted relocations give imports in deterministic order
+				auto first = std::lower_bound(importNameAddresses.begin(), importNameAddresses.end(),
+						std::make_pair(name, 0ULL));
+				auto last = std::upper_bound(first, importNameAddresses.end(),
+						std::make_pair(name, std::numeric_limits<unsigned long long>::max()));
+				for(auto address = first; address != last; ++address)
 				{
 					auto import = std::make_unique<Import>();
 					import->setName(name);
-					import->setAddress(address.second);
+					import->setAddress(address->second);
 					import->setUsageType(symbolToImportUsage(symbol->getUsageType()));
 					importTable->addImport(std::move(import));
 				}
-				if(keyIter.first == keyIter.second && getSectionFromAddress(value))
+				if(first == last && getSectionFromAddress(value))
 				{
 					auto import = std::make_unique<Import>();
 					import->setName(name);
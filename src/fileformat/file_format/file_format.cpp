@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <climits>
 #include <cstdint>
 #include <cstring>
@@ -21,11 +22,11 @@
 #include "retdec/fileformat/utils/byte_array_buffer.h"
 #include "retdec/fileformat/file_format/intel_hex/intel_hex_format.h"
 #include "retdec/fileformat/file_format/raw_data/raw_data_format.h"
-#include "retdec/fileformat/types/strings/character_iterator.h"
 #include "retdec/fileformat/utils/conversions.h"
 #include "retdec/fileformat/utils/crypto.h"
 #include "retdec/fileformat/utils/file_io.h"
 #include "retdec/fileformat/utils/other.h"
+#include "retdec/fileformat/utils/unwind.h"
 #include "retdec/pelib/PeLibInc.h"
 
 using namespace retdec::utils;
@@ -111,6 +112,19 @@ bool isAddressFromRegion(const SecSeg *actualRegion, const SecSeg *newRegion, st
 	return false;
 }
 
+/**
+ * Get length of @a stream, or zero if it cannot be found out.
+ */
+std::size_t getStreamLength(std::istream &stream)
+{
+	stream.clear();
+	stream.seekg(0, std::ios::end);
+	const auto end = stream.tellg();
+	stream.clear();
+	stream.seekg(0, std::ios::beg);
+	return end == std::streampos(-1) ? 0 : static_cast<std::size_t>(end);
+}
+
 } // anonymous namespace
 
 /**
@@ -187,21 +201,48 @@ void FileFormat::init()
 	richHeader = nullptr;
 	pdbInfo = nullptr;
 	certificateTable = nullptr;
+	certificateTableLoaded = false;
+	deferredTablesLoaded = false;
+	unwindFunctionsLoaded = false;
 	tlsInfo = nullptr;
 	elfCoreInfo = nullptr;
 	fileFormat = Format::UNDETECTABLE;
-	stateIsValid = readFile(fileStream, bytes) && stateIsValid;
+
+	// Only the beginning of a large file is loaded in the bounded memory mode.
+	// It holds the headers, the rest (typically overlay) is read in chunks.
+	std::size_t loadLimit = 0;
+	if (getLoadFlags() & LoadFlags::BOUNDED_MEMORY)
+	{
+		inputFileLength = getStreamLength(fileStream);
+		if (inputFileLength > BOUNDED_MEMORY_LOAD_LIMIT)
+		{
+			loadLimit = BOUNDED_MEMORY_LOAD_LIMIT;
+		}
+	}
+	stateIsValid = readFile(fileStream, bytes, 0, loadLimit) && stateIsValid;
+	if (!loadLimit)
+	{
+		inputFileLength = bytes.size();
+	}
+
 	if (getLoadFlags() & LoadFlags::NO_FILE_HASHES)
 	{
 		crc32.clear();
 		md5.clear();
 		sha256.clear();
 	}
+	else if (isLoadedPartially())
+	{
+		retdec::fileformat::getCrc32Md5Sha256(fileStream, crc32, md5, sha256);
+	}
 	else
 	{
-		crc32 = retdec::fileformat::getCrc32(bytes.data(), bytes.size());
-		md5 = retdec::fileformat::getMd5(bytes.data(), bytes.size());
-		sha256 = retdec::fileformat::getSha256(bytes.data(), bytes.size());
+		retdec::fileformat::getCrc32Md5Sha256(
+				bytes.data(),
+				bytes.size(),
+				crc32,
+				md5,
+				sha256);
 	}
 	initStream();
 }
@@ -215,6 +256,70 @@ void FileFormat::initStream()
 	fileStream.seekg(0);
 }
 
+/**
+ * Load certificates of the file into @c certificateTable
+ *
+ * Called on the first call of @c getCertificateTable(). The default
+ * implementation loads nothing.
+ */
+void FileFormat::loadCertificates()
+{
+
+}
+
+/**
+ * Load symbol, import and export tables whose loading was postponed
+ *
+ * Called before the first access to these tables. The default
+ * implementation loads nothing, formats which load the tables eagerly
+ * do not need to override it.
+ */
+void FileFormat::loadDeferredTables()
+{
+
+}
+
+/**
+ * Load ranges of functions from unwind information
+ *
+ * Called on the first call of @c getUnwindFunctionRanges(). The default
+ * implementation parses FDEs in the ELF @c .eh_frame or the Mach-O
+ * @c __eh_frame section.
+ */
+void FileFormat::loadUnwindFunctions()
+{
+	const auto *ehFrame = getSection(".eh_frame");
+	if (!ehFrame)
+	{
+		ehFrame = getSection("__eh_frame");
+	}
+	if (!ehFrame || !ehFrame->getLoadedSize())
+	{
+		return;
+	}
+
+	const auto data = ehFrame->getBytes();
+	unwindFunctions = parseEhFrame(
+			reinterpret_cast<const std::uint8_t*>(data.data()),
+			data.size(),
+			ehFrame->getAddress(),
+			isLittleEndian(),
+			getBytesPerWord());
+}
+
+/**
+ * Load deferred symbol, import and export tables if it was not done yet
+ */
+void FileFormat::ensureDeferredTablesLoaded() const
+{
+	if (!deferredTablesLoaded)
+	{
+		auto *self = const_cast<FileFormat*>(this);
+		self->deferredTablesLoaded = true;
+		self->loadDeferredTables();
+	}
+}
+
 /**
  * @fn std::size_t FileFormat::initSectionTableHashOffsets()
  * Init offsets for calculation of section table hashes
@@ -417,30 +522,54 @@ void FileFormat::loadStrings(StringType type, std::size_t charSize)
 
 void FileFormat::loadStrings(StringType type, std::size_t charSize, const SecSeg* secSeg)
 {
-	CharacterEndianness endian = isLittleEndian() ? CharacterEndianness::Little : CharacterEndianness::Big;
+	const auto secBytes = secSeg->getBytes();
+	const auto *data = reinterpret_cast<const unsigned char*>(secBytes.data());
+	const std::size_t size = secBytes.size();
+	// Index of the printable byte in a character, all other bytes must be zero
+	const std::size_t printableIndex = isLittleEndian() ? 0 : charSize - 1;
 
-	for (auto begin = secSeg->getBytes().begin(), end = secSeg->getBytes().end(), itr = begin; itr != end;)
+	auto isValidCharacter = [&](std::size_t pos)
 	{
-		if (makeCharacterIterator(itr, begin, end, charSize).pointsToValidCharacter(endian))
+		if (pos + charSize > size || !std::isprint(data[pos + printableIndex]))
+			return false;
+
+		for (std::size_t i = 0; i < charSize; ++i)
 		{
-			auto stringBeginItr = makeCharacterIterator(itr, begin, end, charSize);
-			auto stringDataEndItr = makeCharacterIterator(end, begin, end, charSize);
-			auto stringEndItr = stringBeginItr + 1;
-			while (stringEndItr != stringDataEndItr && stringEndItr.pointsToValidCharacter(endian))
-				++stringEndItr;
+			if (i != printableIndex && data[pos + i] != 0)
+				return false;
+		}
 
-			if (static_cast<std::size_t>(stringEndItr - stringBeginItr) >= DefaultMinStringLength)
-				strings.emplace_back(type, secSeg->getOffset() + (itr - begin), secSeg->getName(), std::string{stringBeginItr, stringEndItr});
+		return true;
+	};
 
-			itr = stringEndItr.getUnderlyingIterator();
+	for (std::size_t pos = 0; pos < size;)
+	{
+		if (!isValidCharacter(pos))
+		{
+			++pos;
+			continue;
 		}
-		else
-			++itr;
+
+		const std::size_t stringBegin = pos;
+		do
+		{
+			pos += charSize;
+		} while (isValidCharacter(pos));
+
+		const std::size_t length = (pos - stringBegin) / charSize;
+		if (length < DefaultMinStringLength)
+			continue;
+
+		std::string content(length, '\0');
+		for (std::size_t i = 0; i < length; ++i)
+			content[i] = static_cast<char>(data[stringBegin + i * charSize + printableIndex]);
+
+		strings.emplace_back(type, secSeg->getOffset() + stringBegin, secSeg->getName(), std::move(content));
 	}
 }
 
 /**
- * Loads imphash from import table.
+ * Enables imphash of import table, the hashes are computed on first use.
  */
 void FileFormat::loadImpHash()
 {
@@ -449,11 +578,11 @@ void FileFormat::loadImpHash()
 		return;
 	}
 
-	importTable->computeHashes();
+	importTable->enableHashes();
 }
 
 /**
- * Loads exphash from export table.
+ * Enables exphash of export table, the hashes are computed on first use.
  */
 void FileFormat::loadExpHash()
 {
@@ -462,11 +591,11 @@ void FileFormat::loadExpHash()
 		return;
 	}
 
-	exportTable->computeHashes();
+	exportTable->enableHashes();
 }
 
 /**
- * Loads iconhash from resource table.
+ * Enables iconhash of resource table, the hashes are computed on first use.
  */
 void FileFormat::loadResourceIconHash()
 {
@@ -475,7 +604,7 @@ void FileFormat::loadResourceIconHash()
 		return;
 	}
 
-	resourceTable->computeIconHashes();
+	resourceTable->enableIconHashes();
 }
 
 /**
@@ -1024,6 +1153,7 @@ std::size_t FileFormat::getNumberOfSegments() const
  */
 std::size_t FileFormat::getNumberOfSymbolTables() const
 {
+	ensureDeferredTablesLoaded();
 	return symbolTables.size();
 }
 
@@ -1063,6 +1193,28 @@ std::size_t FileFormat::getLoadedFileLength() const
 	return loadedBytes->size();
 }
 
+/**
+ * Get length of the whole input file. It is longer than the result of
+ *    @a getFileLength() if only the beginning of the file was loaded.
+ * @return Length of input file
+ */
+std::size_t FileFormat::getInputFileLength() const
+{
+	return inputFileLength;
+}
+
+/**
+ * Find out if only the beginning of input file was loaded, because it is
+ *    longer than @c BOUNDED_MEMORY_LOAD_LIMIT and @c LoadFlags::BOUNDED_MEMORY
+ *    was used. File hashes, overlay size and overlay entropy are still
+ *    computed from the whole file.
+ * @return @c true if only a part of input file was loaded, @c false otherwise
+ */
+bool FileFormat::isLoadedPartially() const
+{
+	return inputFileLength > bytes.size();
+}
+
 /**
  * Get size of overlay. This may be zero. If size of overlay is non-zero, overlay starts
  *    at offset which is identical with result of method @a getDeclaredFileLength().
@@ -1071,7 +1223,7 @@ std::size_t FileFormat::getLoadedFileLength() const
 std::size_t FileFormat::getOverlaySize() const
 {
 	const auto declSize = getDeclaredFileLength();
-	const auto realSize = getLoadedFileLength();
+	const auto realSize = isLoadedPartially() ? getInputFileLength() : getLoadedFileLength();
 	return (realSize > declSize) ? realSize - declSize : 0;
 }
 
@@ -1084,6 +1236,18 @@ bool FileFormat::getOverlayEntropy(double &res) const
 {
 	const auto overlaySize = getOverlaySize();
 	const auto declSize = getDeclaredFileLength();
+	if (isLoadedPartially())
+	{
+		if (overlaySize == 0 || declSize == 0)
+		{
+			return false;
+		}
+		const auto ok = computeDataEntropy(fileStream, declSize, overlaySize, res);
+		fileStream.clear();
+		fileStream.seekg(0);
+		return ok;
+	}
+
 	const auto &bytes = getBytes();
 	if (overlaySize == 0 || declSize == 0 || bytes.size() < declSize + overlaySize)
 	{
@@ -1191,13 +1355,29 @@ bool FileFormat::getBytes(std::vector<std::uint8_t> &result, unsigned long long
 		return false;
 	}
 
-	numberOfBytes = offset + numberOfBytes > getLoadedFileLength() ? getLoadedFileLength() - offset : numberOfBytes;
-	result.clear();
-	result.reserve(numberOfBytes);
-	std::copy(loadedBytes->begin() + offset, loadedBytes->begin() + offset + numberOfBytes, std::back_inserter(result));
+	const auto bytesRef = getBytesRef(offset, numberOfBytes);
+	result.assign(bytesRef.begin(), bytesRef.end());
 	return true;
 }
 
+/**
+ * Get view of bytes from specified offset, without copying
+ * @param offset Start offset for read
+ * @param numberOfBytes Number of bytes for read
+ * @return View of at most @a numberOfBytes bytes (shorter if the file ends
+ *    sooner, empty if @a offset is out of the file)
+ */
+llvm::ArrayRef<std::uint8_t> FileFormat::getBytesRef(unsigned long long offset, unsigned long long numberOfBytes) const
+{
+	if (offset >= getLoadedFileLength())
+	{
+		return {};
+	}
+
+	numberOfBytes = offset + numberOfBytes > getLoadedFileLength() ? getLoadedFileLength() - offset : numberOfBytes;
+	return llvm::ArrayRef<std::uint8_t>(loadedBytes->data() + offset, numberOfBytes);
+}
+
 /**
  * Get bytes from entry point
  * @param result Read bytes
@@ -1221,6 +1401,23 @@ bool FileFormat::getEpBytes(std::vector<std::uint8_t> &result, unsigned long lon
 	return false;
 }
 
+/**
+ * Get view of bytes from entry point, without copying
+ * @param numberOfBytes Number of bytes for read
+ * @return View of at most @a numberOfBytes bytes, empty if file has no entry
+ *    point or entry point has not been detected
+ */
+llvm::ArrayRef<std::uint8_t> FileFormat::getEpBytesRef(unsigned long long numberOfBytes) const
+{
+	std::uint64_t epOffset;
+	if(stateIsValid && getEpOffset(epOffset))
+	{
+		return getBytesRef(epOffset, numberOfBytes);
+	}
+
+	return {};
+}
+
 /**
  * Get bytes from specified offset in hexadecimal string representation
  * @param result Read bytes in hexadecimal string representation
@@ -1531,6 +1728,7 @@ const DynamicTable* FileFormat::getDynamicTable(unsigned long long tabIndex) con
  */
 const ImportTable* FileFormat::getImportTable() const
 {
+	ensureDeferredTablesLoaded();
 	return importTable;
 }
 
@@ -1540,6 +1738,7 @@ const ImportTable* FileFormat::getImportTable() const
  */
 const ExportTable* FileFormat::getExportTable() const
 {
+	ensureDeferredTablesLoaded();
 	return exportTable;
 }
 
@@ -1585,6 +1784,14 @@ const PdbInfo* FileFormat::getPdbInfo() const
  */
 const CertificateTable* FileFormat::getCertificateTable() const
 {
+	// Signatures are parsed and verified only when somebody asks for them
+	if (!certificateTableLoaded)
+	{
+		auto *self = const_cast<FileFormat*>(this);
+		self->certificateTableLoaded = true;
+		self->loadCertificates();
+	}
+
 	return certificateTable;
 }
 
@@ -1701,7 +1908,8 @@ const Relocation* FileFormat::getRelocation(unsigned long long address) const
  */
 const Import* FileFormat::getImport(const std::string &name) const
 {
-	return importTable ? importTable->getImport(name) : nullptr;
+	const auto *table = getImportTable();
+	return table ? table->getImport(name) : nullptr;
 }
 
 /**
@@ -1711,7 +1919,8 @@ const Import* FileFormat::getImport(const std::string &name) const
  */
 const Import* FileFormat::getImport(unsigned long long address) const
 {
-	return importTable ? importTable->getImportOnAddress(address) : nullptr;
+	const auto *table = getImportTable();
+	return table ? table->getImportOnAddress(address) : nullptr;
 }
 
 /**
@@ -1721,7 +1930,8 @@ const Import* FileFormat::getImport(unsigned long long address) const
  */
 const Export* FileFormat::getExport(const std::string &name) const
 {
-	return exportTable ? exportTable->getExport(name) : nullptr;
+	const auto *table = getExportTable();
+	return table ? table->getExport(name) : nullptr;
 }
 
 /**
@@ -1731,7 +1941,8 @@ const Export* FileFormat::getExport(const std::string &name) const
  */
 const Export* FileFormat::getExport(unsigned long long address) const
 {
-	return exportTable ? exportTable->getExportOnAddress(address) : nullptr;
+	const auto *table = getExportTable();
+	return table ? table->getExportOnAddress(address) : nullptr;
 }
 
 /**
@@ -1779,6 +1990,23 @@ const retdec::common::RangeContainer<std::uint64_t>& FileFormat::getNonDecodable
 	return nonDecodableRanges;
 }
 
+/**
+ * Get ranges of functions described by unwind information (e.g. PE
+ * @c .pdata or ELF @c .eh_frame).
+ * @return Function ranges, unwind information is parsed on the first call.
+ */
+const std::vector<retdec::common::Range<std::uint64_t>>& FileFormat::getUnwindFunctionRanges() const
+{
+	if (!unwindFunctionsLoaded)
+	{
+		auto *self = const_cast<FileFormat*>(this);
+		self->unwindFunctionsLoaded = true;
+		self->loadUnwindFunctions();
+	}
+
+	return unwindFunctions;
+}
+
 /**
  * Get all sections
  * @return Reference to sections
@@ -1853,6 +2081,7 @@ const std::vector<Segment*> FileFormat::getSegments(std::initializer_list<std::s
  */
 const std::vector<SymbolTable*>& FileFormat::getSymbolTables() const
 {
+	ensureDeferredTablesLoaded();
 	return symbolTables;
 }
 
@@ -1983,6 +2212,27 @@ bool FileFormat::getXBytes(std::uint64_t address, std::uint64_t x, std::vector<s
 	return secSeg && secSeg->getBytes(res, address - secSeg->getAddress(), x) && res.size() == x;
 }
 
+/**
+ * Get @a x bytes long view of file content at specified address, without copying
+ * @param address Address to get the view from
+ * @param x Number of bytes for get
+ * @return View of exactly @a x bytes, or an empty view if there is no section
+ *    or segment on @a address or it does not contain all the requested bytes
+ */
+llvm::ArrayRef<std::uint8_t> FileFormat::getXBytesRef(std::uint64_t address, std::uint64_t x) const
+{
+	const auto *secSeg = getSectionOrSegmentFromAddress(address);
+	if(!secSeg || !x)
+	{
+		return {};
+	}
+
+	const auto bytesRef = secSeg->getBytes(address - secSeg->getAddress(), x);
+	return bytesRef.size() == x
+		? llvm::ArrayRef<std::uint8_t>(bytesRef.bytes_begin(), bytesRef.size())
+		: llvm::ArrayRef<std::uint8_t>();
+}
+
 bool FileFormat::setXByte(std::uint64_t address, std::uint64_t x, std::uint64_t val, retdec::utils::Endianness e/* = retdec::utils::Endianness::UNKNOWN*/)
 {
 	return false;
@@ -2128,6 +2378,23 @@ bool FileFormat::getXBytesOffset(std::uint64_t offset, std::uint64_t x, std::vec
 	return false;
 }
 
+/**
+ * Get @a x bytes long view of file content at specified offset, without copying
+ * @param offset Offset to get the view from
+ * @param x Number of bytes for get
+ * @return View of exactly @a x bytes, or an empty view if the file does not
+ *    contain all the requested bytes
+ */
+llvm::ArrayRef<std::uint8_t> FileFormat::getXBytesOffsetRef(std::uint64_t offset, std::uint64_t x) const
+{
+	if(offset + x <= getLoadedFileLength())
+	{
+		return llvm::ArrayRef<std::uint8_t>(loadedBytes->data() + offset, x);
+	}
+
+	return {};
+}
+
 /**
  * Get word located at provided offset using the specified endian or default file endian
  * @param offset Offset to get integer from
@@ -2524,13 +2791,13 @@ void FileFormat::dump(std::string &dumpFile)
 		}
 	}
 
-	if(importTable && !importTable->empty())
+	if(getImportTable() && !getImportTable()->empty())
 	{
 		getImportTable()->dump(sDump);
 		ret << sDump;
 	}
 
-	if(exportTable && !exportTable->empty())
+	if(getExportTable() && !getExportTable()->empty())
 	{
 		getExportTable()->dump(sDump);
 		ret << sDump;
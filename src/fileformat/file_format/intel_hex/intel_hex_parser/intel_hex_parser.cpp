@@ -14,6 +14,24 @@ using namespace retdec::utils;
 namespace retdec {
 namespace fileformat {
 
+namespace
+{
+
+/**
+ * Converts hexadecimal digit to its value
+ * @param c Hexadecimal digit
+ * @return Value of @a c
+ *
+ * @warning No validity control, use only on valid data
+ */
+unsigned hexDigitToInt(char c)
+{
+	// Letters have bit 6 set and their low nibble starts at 1
+	return (c & 0x0F) + (c >> 6) * 9;
+}
+
+} // anonymous namespace
+
 /**
  * operator <
  */
@@ -69,7 +87,7 @@ bool IntelHexParser::parse()
 				setCSIP(token);
 				break;
 			case IntelHexToken::REC_TYPE::RT_EOFILE:
-				sections.push_back(actualSection);
+				sections.push_back(std::move(actualSection));
 				return true;
 			case IntelHexToken::REC_TYPE::RT_ERROR:
 			default:
@@ -104,25 +122,12 @@ void IntelHexParser::handleData(const IntelHexToken &token)
 	}
 
 	const int diff = address - (actualAddress - 1);
-	if(diff == 1)
-	{
-		// Still the same section
-		for(std::vector<int>::size_type i = 0; i < token.data.size(); i += 2)
-		{
-			// Size of vector is always even
-			std::string tmp;
-			tmp.push_back(token.data[i]);
-			tmp.push_back(token.data[i+1]);
-			actualSection.data.push_back(IntelHexParser::strToInt(tmp));
-			actualAddress += 1;
-		}
-	}
-	else
+	if(diff != 1)
 	{
 		// New section
 		if(actualAddress)
 		{
-			sections.push_back(actualSection);
+			sections.push_back(std::move(actualSection));
 			++index;
 		}
 
@@ -130,16 +135,31 @@ void IntelHexParser::handleData(const IntelHexToken &token)
 		actualSection.address = address;
 		actualSection.index = index;
 		actualSection.data.clear();
+	}
 
-		for(std::vector<int>::size_type i = 0; i < token.data.size(); i += 2)
-		{
-			std::string tmp;
-			tmp.push_back(token.data[i]);
-			tmp.push_back(token.data[i+1]);
-			actualSection.data.push_back(IntelHexParser::strToInt(tmp));
-			actualAddress += 1;
-		}
+	appendData(token.data);
+}
+
+/**
+ * Decodes data of record directly to the end of actual section
+ * @param data Hexadecimal data of record
+ *
+ * @warning Size of @a data must be even (this is granted by tokenizer)
+ */
+void IntelHexParser::appendData(const std::string &data)
+{
+	const auto size = data.size() / 2;
+	auto &bytes = actualSection.data;
+	const auto offset = bytes.size();
+	bytes.resize(offset + size);
+
+	const char *src = data.data();
+	for(std::size_t i = 0; i < size; ++i, src += 2)
+	{
+		bytes[offset + i] = hexPairToByte(src);
 	}
+
+	actualAddress += size;
 }
 
 /**
@@ -265,41 +285,31 @@ std::vector<IntelHexSection> IntelHexParser::getSectionsByAlignment(unsigned lon
 	unsigned long long index = 0;
 	std::vector<IntelHexSection> result;
 
-	for(auto section : sections)
+	for(const auto &section : sections)
 	{
 		unsigned long long upperBorder = section.address + section.data.size();
 		unsigned long long nearestMult = (section.address / alignByValue + 1) * alignByValue;
 
 		if(nearestMult > upperBorder)
 		{
-			section.index = index;
 			result.push_back(section);
-			++index;
+			result.back().index = index++;
 		}
 		else
 		{
-			std::vector<unsigned char> tmp;
-			unsigned long long diff = upperBorder - nearestMult;
-
-			for(auto i = section.data.size() - diff; i < section.data.size(); ++i)
-			{
-				tmp.push_back(section.data[i]);
-			}
-
-			for(unsigned long long i = 0; i < diff; ++i)
-			{
-				section.data.pop_back();
-			}
-
-			section.index = index;
-			result.push_back(section);
-			++index;
-
-			section.data = tmp;
-			section.index = index;
-			section.address = nearestMult;
-			result.push_back(section);
-			++index;
+			auto split = section.data.end() - (upperBorder - nearestMult);
+
+			IntelHexSection lower;
+			lower.index = index++;
+			lower.address = section.address;
+			lower.data.assign(section.data.begin(), split);
+			result.push_back(std::move(lower));
+
+			IntelHexSection upper;
+			upper.index = index++;
+			upper.address = nearestMult;
+			upper.data.assign(split, section.data.end());
+			result.push_back(std::move(upper));
 		}
 	}
 
@@ -316,10 +326,31 @@ std::vector<IntelHexSection> IntelHexParser::getSectionsByAlignment(unsigned lon
 unsigned long long IntelHexParser::strToInt(const std::string &str)
 {
 	unsigned long long res = 0;
+	if(!str.empty() && str.size() <= 2 * sizeof(res) && isHexadec(str))
+	{
+		for(char c : str)
+		{
+			res = (res << 4) | hexDigitToInt(c);
+		}
+		return res;
+	}
+
 	strToNum(str, res, std::hex);
 	return res;
 }
 
+/**
+ * Converts two hexadecimal characters to byte
+ * @param str Pointer to the first of the two characters
+ * @return Byte value
+ *
+ * @warning No validity control, use only on valid data
+ */
+unsigned char IntelHexParser::hexPairToByte(const char *str)
+{
+	return static_cast<unsigned char>((hexDigitToInt(str[0]) << 4) | hexDigitToInt(str[1]));
+}
+
 /**
  * Checks whether character is hexadecimal digit
  * @param c Character to check
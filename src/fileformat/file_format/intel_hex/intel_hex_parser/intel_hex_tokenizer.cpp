@@ -15,6 +15,29 @@ using namespace retdec::utils;
 namespace retdec {
 namespace fileformat {
 
+namespace
+{
+
+/**
+ * Converts hexadecimal byte, anything other than two hexadecimal digits is
+ * left to strToNum() to keep its behavior
+ * @param str String to convert
+ * @param result Converted value
+ * @return @c true on success, @c false otherwise
+ */
+bool hexByteToNum(const std::string &str, unsigned &result)
+{
+	if(str.size() == 2 && IntelHexParser::isHexadec(str))
+	{
+		result = IntelHexParser::hexPairToByte(str.data());
+		return true;
+	}
+
+	return strToNum(str, result, std::hex);
+}
+
+} // anonymous namespace
+
 /**
  * Adds chars of string by two (one data byte) for checksum
  * @param str Input string
@@ -30,10 +53,7 @@ int IntelHexToken::addStringByTwo(const std::string &str)
 
 	for(std::string::size_type i = 0; i < str.size(); i += 2)
 	{
-		std::string tmp_str;
-		tmp_str.push_back(str[i]);
-		tmp_str.push_back(str[i+1]);
-		result = result + IntelHexParser::strToInt(tmp_str);
+		result += IntelHexParser::hexPairToByte(&str[i]);
 	}
 
 	return result;
@@ -62,13 +82,8 @@ void IntelHexToken::controlChecksum()
  */
 std::string IntelHexTokenizer::readN(unsigned n)
 {
-	std::string result;
-
-	for(unsigned i = 0; i < n; ++i)
-	{
-		result += source->get();
-	}
-
+	std::string result(n, '\0');
+	source->read(&result[0], n);
 	return result;
 }
 
@@ -101,7 +116,7 @@ IntelHexToken IntelHexTokenizer::getToken()
 
 	// Byte count
 	std::string tmp_str = readN(2);
-	if(!strToNum(tmp_str, token.byteCount, std::hex))
+	if(!hexByteToNum(tmp_str, token.byteCount))
 	{
 		return makeErrorToken("Invalid byte count sequence.");
 	}
@@ -116,7 +131,7 @@ IntelHexToken IntelHexTokenizer::getToken()
 	// Record type
 	tmp_str = readN(2);
 	// Max. type number is 5
-	if(!strToNum(tmp_str, token.recordType, std::hex) || token.recordType > 5)
+	if(!hexByteToNum(tmp_str, token.recordType) || token.recordType > 5)
 	{
 		return makeErrorToken("Invalid record type sequence.");
 	}
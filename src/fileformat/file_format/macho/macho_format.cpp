@@ -274,8 +274,6 @@ void MachOFormat::initStructures()
 		fileFormat = Format::MACHO;
 		loadCommands();
 		loadStrings();
-		loadImpHash();
-		loadExpHash();
 	}
 }
 
@@ -1096,9 +1094,15 @@ std::uint32_t MachOFormat::getFirstCommandOffset() const
 /**
  * Functions iterates over Mach-O load commands and loads useful information
  * from supported commands
+ *
+ * Commands with symbols, imports and exports are only remembered here, they
+ * are loaded by @c loadDeferredTables() when the tables are needed.
  */
 void MachOFormat::loadCommands()
 {
+	deferredCommands.clear();
+	deferredTablesLoaded = false;
+
 	for(const auto &command : file->load_commands())
 	{
 		switch(command.C.cmd)
@@ -1119,15 +1123,38 @@ void MachOFormat::loadCommands()
 				oldEntryPointCommand(command);
 				break;
 
-			case MachO::LC_SYMTAB:
-				symtabCommand();
-				break;
-
 			case MachO::LC_LOAD_DYLIB:
 			case MachO::LC_PREBOUND_DYLIB:
 				loadDylibCommand(command);
 				break;
 
+			case MachO::LC_SYMTAB:
+			case MachO::LC_DYSYMTAB:
+			case LC_DYLD_INFO:
+			case LC_DYLD_INFO | LC_REQ_DYLD:
+				deferredCommands.push_back(command);
+				break;
+
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Load symbol table, imports and exports from the commands remembered by
+ * @c loadCommands(). Commands are processed in their order in the file.
+ */
+void MachOFormat::loadDeferredTables()
+{
+	for(const auto &command : deferredCommands)
+	{
+		switch(command.C.cmd)
+		{
+			case MachO::LC_SYMTAB:
+				symtabCommand();
+				break;
+
 			// Imports and exports before Mac OS 10.6
 			case MachO::LC_DYSYMTAB:
 				dySymtabCommand();
@@ -1143,6 +1170,10 @@ void MachOFormat::loadCommands()
 				break;
 		}
 	}
+
+	deferredCommands.clear();
+	loadImpHash();
+	loadExpHash();
 }
 
 void MachOFormat::dumpCommands(std::ostream &outStream)
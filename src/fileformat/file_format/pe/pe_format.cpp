@@ -602,6 +602,7 @@ void PeFormat::initStructures(const std::string & dllListFile)
 {
 	formatParser = nullptr;
 	errorLoadingDllList = false;
+	dotnetTypesDetected = false;
 
 	// If we got an override list of dependency DLLs, we load them into the map
 	initDllList(dllListFile);
@@ -612,7 +613,9 @@ void PeFormat::initStructures(const std::string & dllListFile)
 	{
 		try
 		{
-			if(file->loadPeHeaders(bytes) == ERROR_NONE)
+			// The image pages are views of the loaded bytes, which live as
+			// long as this format.
+			if(file->loadPeHeaders(bytes, false, true) == ERROR_NONE)
 				stateIsValid = true;
 
 			file->readCoffSymbolTable(bytes);
@@ -649,13 +652,15 @@ void PeFormat::initStructures(const std::string & dllListFile)
 		loadExports();
 		loadPdbInfo();
 		loadResources();
-		loadCertificates();
 		loadTlsInformation();
 		loadDotnetHeaders();
 		loadVisualBasicHeader();
 		computeSectionTableHashes();
 		loadStrings();
-		scanForAnomalies();
+		if (!(getLoadFlags() & LoadFlags::NO_ANOMALIES))
+		{
+			scanForAnomalies();
+		}
 	}
 }
 
@@ -2016,6 +2021,11 @@ static std::vector<DigitalSignature> authenticodeToSignatures(AuthenticodeArray*
  */
 void PeFormat::loadCertificates()
 {
+	if (!stateIsValid || (getLoadFlags() & LoadFlags::NO_CERTIFICATES))
+	{
+		return;
+	}
+
 	const SecurityDirectory& securityDir = file->securityDir();
 	if (securityDir.calcNumberOfCertificates() == 0)
 	{
@@ -2059,6 +2069,52 @@ void PeFormat::loadCertificates()
 	}
 }
 
+/**
+ * Load ranges of functions from RUNTIME_FUNCTION entries in the exception
+ * directory (.pdata) of x64 files
+ *
+ * Entries whose unwind information is chained to another entry describe
+ * only parts of functions and are skipped.
+ */
+void PeFormat::loadUnwindFunctions()
+{
+	const std::uint64_t entrySize = 12;
+	const std::uint64_t unwFlagChainInfo = 0x04;
+
+	std::uint64_t imageBase = 0, addr = 0, size = 0;
+	if (getTargetArchitecture() != Architecture::X86_64
+			|| !getImageBaseAddress(imageBase)
+			|| !getDataDirectoryAbsolute(PELIB_IMAGE_DIRECTORY_ENTRY_EXCEPTION, addr, size)
+			|| size < entrySize)
+	{
+		return;
+	}
+
+	for (std::uint64_t entry = addr; entry + entrySize <= addr + size; entry += entrySize)
+	{
+		std::uint64_t begin = 0, end = 0, unwindInfo = 0, flags = 0;
+		if (!get4Byte(entry, begin)
+				|| !get4Byte(entry + 4, end)
+				|| !get4Byte(entry + 8, unwindInfo))
+		{
+			break;
+		}
+		if (begin == 0 && end == 0)
+		{
+			break;
+		}
+		if (end <= begin
+				|| (unwindInfo & 1)
+				|| !get1Byte(imageBase + unwindInfo, flags)
+				|| ((flags >> 3) & unwFlagChainInfo))
+		{
+			continue;
+		}
+
+		unwindFunctions.emplace_back(imageBase + begin, imageBase + end);
+	}
+}
+
 /**
  * Load thread-local storage information
  */
@@ -2194,7 +2250,7 @@ void PeFormat::loadDotnetHeaders()
 
 	detectModuleVersionId();
 	detectTypeLibId();
-	detectDotnetTypes();
+	computeTypeRefHashes();
 }
 
 /**
@@ -2754,7 +2810,7 @@ void PeFormat::detectTypeLibId()
 		if (customAttributeRow->type.getIndex() == guidMemberRef)
 		{
 			// Its value is the TypeLib we are looking for
-			auto typeLibData = blobStream->getElement(customAttributeRow->value.getIndex());
+			auto typeLibData = blobStream->getElementRef(customAttributeRow->value.getIndex());
 			if (typeLibData.size() < 3)
 			{
 				continue;
@@ -2777,20 +2833,22 @@ void PeFormat::detectTypeLibId()
 
 /**
  * Detects and reconstructs .NET types such as classes, methods, fields, properties etc.
+ *
+ * Reconstruction walks all signatures in the blob stream, so it is postponed
+ * until the classes are requested for the first time.
  */
 void PeFormat::detectDotnetTypes()
 {
-	DotnetTypeReconstructor reconstructor(metadataStream.get(), stringStream.get(), blobStream.get());
-
+	dotnetTypesDetected = true;
 	definedClasses.clear();
 	importedClasses.clear();
+
+	DotnetTypeReconstructor reconstructor(metadataStream.get(), stringStream.get(), blobStream.get());
 	if (reconstructor.reconstruct())
 	{
 		definedClasses = reconstructor.getDefinedClasses();
 		importedClasses = reconstructor.getReferencedClasses();
 	}
-
-	computeTypeRefHashes();
 }
 
 /**
@@ -3733,11 +3791,19 @@ const std::string& PeFormat::getTypeLibId() const
 
 const std::vector<std::shared_ptr<DotnetClass>>& PeFormat::getDefinedDotnetClasses() const
 {
+	if (!dotnetTypesDetected)
+	{
+		const_cast<PeFormat*>(this)->detectDotnetTypes();
+	}
 	return definedClasses;
 }
 
 const std::vector<std::shared_ptr<DotnetClass>>& PeFormat::getImportedDotnetClasses() const
 {
+	if (!dotnetTypesDetected)
+	{
+		const_cast<PeFormat*>(this)->detectDotnetTypes();
+	}
 	return importedClasses;
 }
 
@@ -21,6 +21,18 @@ BlobStream::BlobStream(std::vector<std::uint8_t> data, std::uint64_t streamOffse
  * @return Element data if it exists, otherwise empty sequence.
  */
 std::vector<std::uint8_t> BlobStream::getElement(std::size_t offset) const
+{
+	auto element = getElementRef(offset);
+	return { element.begin(), element.end() };
+}
+
+/**
+ * Returns the element at the specified offset in the blob without copying it.
+ * @param offset Offset of the element.
+ * @return View of the element data if it exists, otherwise empty view. The view
+ *    is valid as long as the stream exists.
+ */
+llvm::ArrayRef<std::uint8_t> BlobStream::getElementRef(std::size_t offset) const
 {
 	// Adapted from YARA
 	// https://github.com/VirusTotal/yara/blob/v4.1.2/libyara/modules/dotnet/dotnet.c#L130
@@ -41,7 +53,7 @@ std::vector<std::uint8_t> BlobStream::getElement(std::size_t offset) const
 		offset += 1;
 		if (offset + len <= data.size())
 		{
-			return { data.begin() + offset, data.begin() + offset + len };
+			return llvm::ArrayRef<std::uint8_t>(data).slice(offset, len);
 		}
 	}
 	// If first 2 bits are 10, length is stored in 2 bytes
@@ -56,7 +68,7 @@ std::vector<std::uint8_t> BlobStream::getElement(std::size_t offset) const
 		}
 		if (offset + len <= data.size())
 		{
-			return { data.begin() + offset, data.begin() + offset + len };
+			return llvm::ArrayRef<std::uint8_t>(data).slice(offset, len);
 		}
 	}
 	// If first 3 bits are 110, length is stored in 4 bytes
@@ -74,7 +86,7 @@ std::vector<std::uint8_t> BlobStream::getElement(std::size_t offset) const
 		}
 		if (offset + len <= data.size())
 		{
-			return { data.begin() + offset, data.begin() + offset + len };
+			return llvm::ArrayRef<std::uint8_t>(data).slice(offset, len);
 		}
 	}
 
@@ -34,6 +34,12 @@ std::size_t ExportTable::getNumberOfExports() const
  */
 const std::string& ExportTable::getExphashCrc32() const
 {
+	if(hashesEnabled && expHashCrc32.empty())
+	{
+		const auto &bytes = getExpHashInput();
+		expHashCrc32 = getCrc32(bytes.data(), bytes.size());
+	}
+
 	return expHashCrc32;
 }
 
@@ -43,6 +49,12 @@ const std::string& ExportTable::getExphashCrc32() const
  */
 const std::string& ExportTable::getExphashMd5() const
 {
+	if(hashesEnabled && expHashMd5.empty())
+	{
+		const auto &bytes = getExpHashInput();
+		expHashMd5 = getMd5(bytes.data(), bytes.size());
+	}
+
 	return expHashMd5;
 }
 
@@ -52,6 +64,12 @@ const std::string& ExportTable::getExphashMd5() const
  */
 const std::string& ExportTable::getExphashSha256() const
 {
+	if(hashesEnabled && expHashSha256.empty())
+	{
+		const auto &bytes = getExpHashInput();
+		expHashSha256 = getSha256(bytes.data(), bytes.size());
+	}
+
 	return expHashSha256;
 }
 
@@ -125,12 +143,19 @@ ExportTable::exportsIterator ExportTable::end() const
 }
 
 /**
- * Compute export hashes - CRC32, MD5, SHA256.
+ * Get cached data exphashes are computed from
+ * @return Sorted names of exports separated by comma
  */
-void ExportTable::computeHashes()
+const std::vector<std::uint8_t>& ExportTable::getExpHashInput() const
 {
+	if(expHashInputValid)
+	{
+		return expHashInput;
+	}
+
 	std::vector<std::string> funcNames;
-	std::vector<std::uint8_t> expHashBytes;
+	auto &expHashBytes = expHashInput;
+	expHashBytes.clear();
 
 	for(const auto& newExport : exports)
 	{
@@ -173,9 +198,31 @@ void ExportTable::computeHashes()
 		}
 	}
 
-	expHashCrc32 = getCrc32(expHashBytes.data(), expHashBytes.size());
-	expHashMd5 = getMd5(expHashBytes.data(), expHashBytes.size());
-	expHashSha256 = getSha256(expHashBytes.data(), expHashBytes.size());
+	expHashInputValid = true;
+	return expHashInput;
+}
+
+/**
+ * Drop computed exphashes, they are computed again on next use
+ */
+void ExportTable::invalidateHashes()
+{
+	expHashInputValid = false;
+	expHashInput.clear();
+	expHashCrc32.clear();
+	expHashMd5.clear();
+	expHashSha256.clear();
+}
+
+/**
+ * Enable export hashes - CRC32, MD5, SHA256.
+ *
+ * Each hash is computed on the first call of its getter.
+ */
+void ExportTable::enableHashes()
+{
+	hashesEnabled = true;
+	invalidateHashes();
 }
 
 /**
@@ -184,6 +231,7 @@ void ExportTable::computeHashes()
 void ExportTable::clear()
 {
 	exports.clear();
+	invalidateHashes();
 }
 
 /**
@@ -193,6 +241,7 @@ void ExportTable::clear()
 void ExportTable::addExport(Export &newExport)
 {
 	exports.push_back(newExport);
+	invalidateHashes();
 }
 
 /**
@@ -4,10 +4,8 @@
  * @copyright (c) 2021 Avast Software, licensed under the MIT license
  */
 
-#include "retdec/fileformat/utils/crypto.h"
 #include "retdec/utils/string.h"
 #include "retdec/fileformat/types/import_table/elf_import_table.h"
-#include <tlsh/tlsh.h>
 
 #include <algorithm>
 #include <unordered_set>>
@@ -19,7 +17,11 @@ using namespace retdec::utils;
 namespace retdec {
 namespace fileformat {
 
-void ElfImportTable::computeHashes()
+/**
+ * Get data imphashes are computed from
+ * @return Sorted names of imported symbols separated by comma
+ */
+std::string ElfImportTable::getImpHashInput() const
 {
 	std::vector<std::string> imported_symbols;
 	imported_symbols.reserve(imports.size());
@@ -40,21 +42,7 @@ void ElfImportTable::computeHashes()
 		impHashString.append(symbol);
 	}
 
-	if (impHashString.size()) {
-		auto data = reinterpret_cast<const uint8_t*>(impHashString.data());
-
-		Tlsh tlsh;
-		tlsh.update(data, impHashString.size());
-
-		tlsh.final();
-		/* this prepends the hash with 'T' + number of the version */
-		const int show_version = 1;
-		impHashTlsh = tlsh.getHash(show_version);
-
-		impHashCrc32 = getCrc32(data, impHashString.size());
-		impHashMd5 = getMd5(data, impHashString.size());
-		impHashSha256 = getSha256(data, impHashString.size());
-	}
+	return impHashString;
 }
 
 } // namespace fileformat
@@ -104,6 +104,12 @@ std::size_t ImportTable::getNumberOfImportsInLibraryCaseInsensitive(const std::s
  */
 const std::string& ImportTable::getImphashCrc32() const
 {
+	const auto &bytes = getCachedImpHashInput();
+	if(impHashCrc32.empty() && !bytes.empty())
+	{
+		impHashCrc32 = getCrc32(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+	}
+
 	return impHashCrc32;
 }
 
@@ -113,6 +119,12 @@ const std::string& ImportTable::getImphashCrc32() const
  */
 const std::string& ImportTable::getImphashMd5() const
 {
+	const auto &bytes = getCachedImpHashInput();
+	if(impHashMd5.empty() && !bytes.empty())
+	{
+		impHashMd5 = getMd5(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+	}
+
 	return impHashMd5;
 }
 
@@ -122,10 +134,32 @@ const std::string& ImportTable::getImphashMd5() const
  */
 const std::string& ImportTable::getImphashSha256() const
 {
+	const auto &bytes = getCachedImpHashInput();
+	if(impHashSha256.empty() && !bytes.empty())
+	{
+		impHashSha256 = getSha256(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+	}
+
 	return impHashSha256;
 }
 
-const std::string& ImportTable::getImpHashTlsh() const {
+/**
+ * Get imphash as TLSH
+ * @return Imphash as TLSH
+ */
+const std::string& ImportTable::getImpHashTlsh() const
+{
+	const auto &bytes = getCachedImpHashInput();
+	if(impHashTlsh.empty() && !bytes.empty())
+	{
+		Tlsh tlsh;
+		tlsh.update(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+		tlsh.final();
+		/* this prepends the hash with 'T' + number of the version */
+		const int show_version = 1;
+		impHashTlsh = tlsh.getHash(show_version);
+	}
+
 	return impHashTlsh;
 }
 
@@ -213,9 +247,11 @@ ImportTable::importsIterator ImportTable::end() const
 }
 
 /**
- * Compute import hashes - CRC32, MD5, SHA256, TLSH.
+ * Get data imphashes are computed from
+ * @return Names of imports in format DllName1.SymbolName1[,DllName2.SymbolName2[,...]]
+ *    or empty string if imphash cannot be computed
  */
-void ImportTable::computeHashes()
+std::string ImportTable::getImpHashInput() const
 {
 	std::string impHashBytes;
 
@@ -276,20 +312,47 @@ void ImportTable::computeHashes()
 		//}
 	}
 
-	if (impHashBytes.size()) {
-		auto data = reinterpret_cast<const uint8_t*>(impHashBytes.data());
-
-		Tlsh tlsh;
-		tlsh.update(data, impHashBytes.size());
-		tlsh.final();
-		/* this prepends the hash with 'T' + number of the version */
-		const int show_version = 1;
-		impHashTlsh = tlsh.getHash(show_version);
+	return impHashBytes;
+}
 
-		impHashCrc32 = getCrc32(data, impHashBytes.size());
-		impHashMd5 = getMd5(data, impHashBytes.size());
-		impHashSha256 = getSha256(data, impHashBytes.size());
+/**
+ * Get cached data imphashes are computed from
+ * @return Data imphashes are computed from or empty string if hashes are
+ *    not enabled
+ */
+const std::string& ImportTable::getCachedImpHashInput() const
+{
+	if(!impHashInputValid)
+	{
+		impHashInput = hashesEnabled ? getImpHashInput() : std::string();
+		impHashInputValid = true;
 	}
+
+	return impHashInput;
+}
+
+/**
+ * Drop computed imphashes, they are computed again on next use
+ */
+void ImportTable::invalidateHashes()
+{
+	impHashInputValid = false;
+	impHashInput.clear();
+	impHashCrc32.clear();
+	impHashMd5.clear();
+	impHashSha256.clear();
+	impHashTlsh.clear();
+}
+
+/**
+ * Enable import hashes - CRC32, MD5, SHA256, TLSH.
+ *
+ * Each hash is computed on the first call of its getter.
+ */
+void ImportTable::enableHashes()
+{
+	hashesEnabled = true;
+	invalidateHashes();
 }
 
 /**
@@ -299,9 +362,7 @@ void ImportTable::clear()
 {
 	libraries.clear();
 	imports.clear();
-	impHashCrc32.clear();
-	impHashMd5.clear();
-	impHashSha256.clear();
+	invalidateHashes();
 }
 
 /**
@@ -316,6 +377,7 @@ void ImportTable::addLibrary(std::string name, bool isMissingDependency)
 	if(isMissingDependency)
 		missingDeps.push_back(name);
 	libraries.push_back(name);
+	invalidateHashes();
 }
 
 /**
@@ -325,6 +387,7 @@ void ImportTable::addLibrary(std::string name, bool isMissingDependency)
 void ImportTable::addImport(std::unique_ptr<Import>&& import)
 {
 	imports.push_back(std::move(import));
+	invalidateHashes();
 }
 
 /**
@@ -61,15 +61,17 @@ bool BitmapImage::parsePngFormat(const ResourceIcon &icon)
 	};
 
 	// Flip it height wise, as existing DIB format has height flipped compared to PNG
+	image.reserve(image.size() + y);
 	for (int i = y - 1; i >= 0; --i)
 	{
 		std::vector<BitmapPixel> row;
+		row.reserve(x);
 		for (int j = 0; j < x; j++)
 		{
 			int offset = (i * x + j) * 4;
 			row.emplace_back(data[offset], data[offset + 1], data[offset + 2], data[offset + 3]);
 		}
-		this->image.push_back(row);
+		image.push_back(std::move(row));
 	}
 
 	return true;
@@ -342,6 +342,15 @@ const Resource* ResourceTable::getResourceWithLanguage(std::size_t rId) const
  */
 const std::string& ResourceTable::getResourceIconhashCrc32() const
 {
+	if(iconHashesEnabled && iconHashCrc32.empty())
+	{
+		const auto &bytes = getIconHashInput();
+		if(!bytes.empty())
+		{
+			iconHashCrc32 = getCrc32(bytes.data(), bytes.size());
+		}
+	}
+
 	return iconHashCrc32;
 }
 
@@ -351,6 +360,15 @@ const std::string& ResourceTable::getResourceIconhashCrc32() const
  */
 const std::string& ResourceTable::getResourceIconhashMd5() const
 {
+	if(iconHashesEnabled && iconHashMd5.empty())
+	{
+		const auto &bytes = getIconHashInput();
+		if(!bytes.empty())
+		{
+			iconHashMd5 = getMd5(bytes.data(), bytes.size());
+		}
+	}
+
 	return iconHashMd5;
 }
 
@@ -360,6 +378,15 @@ const std::string& ResourceTable::getResourceIconhashMd5() const
  */
 const std::string& ResourceTable::getResourceIconhashSha256() const
 {
+	if(iconHashesEnabled && iconHashSha256.empty())
+	{
+		const auto &bytes = getIconHashInput();
+		if(!bytes.empty())
+		{
+			iconHashSha256 = getSha256(bytes.data(), bytes.size());
+		}
+	}
+
 	return iconHashSha256;
 }
 
@@ -369,6 +396,16 @@ const std::string& ResourceTable::getResourceIconhashSha256() const
  */
 const std::string& ResourceTable::getResourceIconPerceptualAvgHash() const
 {
+	if(iconHashesEnabled && !iconPerceptualAvgHashValid)
+	{
+		// Decoding of the icon is expensive, it is done only if the hash is used.
+		if(!getIconHashInput().empty())
+		{
+			iconPerceptualAvgHash = computePerceptualAvgHash(*getIconForIconHash());
+		}
+		iconPerceptualAvgHashValid = true;
+	}
+
 	return iconPerceptualAvgHash;
 }
 
@@ -495,27 +532,50 @@ ResourceTable::resourcesIterator ResourceTable::end() const
 }
 
 /**
- * Compute icon hashes - CRC32, MD5, SHA256.
+ * Get data iconhashes are computed from, i.e. bytes of the prior icon
+ * @return Bytes of the prior icon, empty if there is no such icon
  */
-void ResourceTable::computeIconHashes()
+const std::vector<std::uint8_t>& ResourceTable::getIconHashInput() const
 {
-	std::vector<std::uint8_t> iconHashBytes;
-
-	auto priorIcon = getIconForIconHash();
-	if(!priorIcon)
+	if(iconHashInputValid)
 	{
-		return;
+		return iconHashInput;
 	}
 
-	if (!priorIcon->getBytes(iconHashBytes))
+	iconHashInput.clear();
+	auto priorIcon = getIconForIconHash();
+	if(priorIcon && !priorIcon->getBytes(iconHashInput))
 	{
-		return;
+		iconHashInput.clear();
 	}
 
-	iconHashCrc32 = getCrc32(iconHashBytes.data(), iconHashBytes.size());
-	iconHashMd5 = getMd5(iconHashBytes.data(), iconHashBytes.size());
-	iconHashSha256 = getSha256(iconHashBytes.data(), iconHashBytes.size());
-	iconPerceptualAvgHash = computePerceptualAvgHash(*priorIcon);
+	iconHashInputValid = true;
+	return iconHashInput;
+}
+
+/**
+ * Drop computed iconhashes, they are computed again on next use
+ */
+void ResourceTable::invalidateIconHashes()
+{
+	iconHashInputValid = false;
+	iconHashInput.clear();
+	iconHashCrc32.clear();
+	iconHashMd5.clear();
+	iconHashSha256.clear();
+	iconPerceptualAvgHashValid = false;
+	iconPerceptualAvgHash.clear();
+}
+
+/**
+ * Enable icon hashes - CRC32, MD5, SHA256 and perceptual AvgHash.
+ *
+ * Each hash is computed on the first call of its getter.
+ */
+void ResourceTable::enableIconHashes()
+{
+	iconHashesEnabled = true;
+	invalidateIconHashes();
 }
 
 /**
@@ -810,6 +870,7 @@ bool ResourceTable::parseVarString(const std::vector<std::uint8_t> &bytes, std::
 void ResourceTable::clear()
 {
 	table.clear();
+	invalidateIconHashes();
 }
 
 /**
@@ -837,6 +898,7 @@ void ResourceTable::addResourceVersion(Resource *ver)
 void ResourceTable::addResourceIcon(ResourceIcon *icon)
 {
 	icons.push_back(icon);
+	invalidateIconHashes();
 }
 
 /**
@@ -846,6 +908,7 @@ void ResourceTable::addResourceIcon(ResourceIcon *icon)
 void ResourceTable::addResourceIconGroup(ResourceIconGroup *iGroup)
 {
 	iconGroups.push_back(iGroup);
+	invalidateIconHashes();
 }
 
 /**
@@ -906,6 +969,8 @@ void ResourceTable::linkResourceIconGroups()
 			}
 		}
 	}
+
+	invalidateIconHashes();
 }
 
 /**
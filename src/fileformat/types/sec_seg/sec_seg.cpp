@@ -27,9 +27,7 @@ namespace fileformat {
 void SecSeg::computeHashes()
 {
 	const auto *hashData = reinterpret_cast<const unsigned char*>(bytes.data());
-	crc32 = retdec::fileformat::getCrc32(hashData, bytes.size());
-	md5 = retdec::fileformat::getMd5(hashData, bytes.size());
-	sha256 = retdec::fileformat::getSha256(hashData, bytes.size());
+	retdec::fileformat::getCrc32Md5Sha256(hashData, bytes.size(), crc32, md5, sha256);
 }
 
 /**
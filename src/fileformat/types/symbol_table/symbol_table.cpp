@@ -4,6 +4,8 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+
 #include "retdec/utils/conversion.h"
 #include "retdec/fileformat/types/symbol_table/symbol_table.h"
 
@@ -12,6 +14,36 @@ using namespace retdec::utils;
 namespace retdec {
 namespace fileformat {
 
+/**
+ * Find the first stored symbol with address @a addr
+ * @param addr Address of selected symbol
+ * @return Position of the symbol in table or number of symbols if there is
+ *    no symbol with address @a addr
+ *
+ * The sorted index of symbol addresses is built on the first lookup after
+ * the table was changed.
+ */
+std::size_t SymbolTable::findSymbolOnAddress(unsigned long long addr) const
+{
+	if(!addressIndexValid)
+	{
+		addressIndex.clear();
+		for(std::size_t i = 0, e = table.size(); i < e; ++i)
+		{
+			unsigned long long a;
+			if(table[i]->getAddress(a))
+			{
+				addressIndex.emplace_back(a, i);
+			}
+		}
+		std::sort(addressIndex.begin(), addressIndex.end());
+		addressIndexValid = true;
+	}
+
+	auto itr = std::lower_bound(addressIndex.begin(), addressIndex.end(), std::make_pair(addr, std::size_t(0)));
+	return itr != addressIndex.end() && itr->first == addr ? itr->second : table.size();
+}
+
 /**
  * Get number of symbols in table
  * @return Number of symbols in table
@@ -56,16 +88,8 @@ const Symbol* SymbolTable::getSymbol(const std::string &name) const
  */
 const Symbol* SymbolTable::getSymbolOnAddress(unsigned long long addr) const
 {
-	for(const auto &s : table)
-	{
-		unsigned long long a;
-		if(s->getAddress(a) && a == addr)
-		{
-			return s.get();
-		}
-	}
-
-	return nullptr;
+	const auto pos = findSymbolOnAddress(addr);
+	return pos < table.size() ? table[pos].get() : nullptr;
 }
 
 /**
@@ -130,16 +154,8 @@ Symbol* SymbolTable::getSymbol(const std::string &name)
  */
 Symbol* SymbolTable::getSymbolOnAddress(unsigned long long addr)
 {
-	for(auto &s : table)
-	{
-		unsigned long long a;
-		if(s->getAddress(a) && a == addr)
-		{
-			return s.get();
-		}
-	}
-
-	return nullptr;
+	const auto pos = findSymbolOnAddress(addr);
+	return pos < table.size() ? table[pos].get() : nullptr;
 }
 
 /**
@@ -202,6 +218,7 @@ SymbolTable::symbolsIterator SymbolTable::end()
 void SymbolTable::clear()
 {
 	table.clear();
+	addressIndexValid = false;
 }
 
 /**
@@ -211,6 +228,7 @@ void SymbolTable::clear()
 void SymbolTable::addSymbol(const std::shared_ptr<Symbol> &symbol)
 {
 	table.push_back(symbol);
+	addressIndexValid = false;
 }
 
 /**
@@ -220,6 +238,7 @@ void SymbolTable::addSymbol(const std::shared_ptr<Symbol> &symbol)
 void SymbolTable::addSymbol(std::shared_ptr<Symbol> &&symbol)
 {
 	table.push_back(std::move(symbol));
+	addressIndexValid = false;
 }
 
 /**
@@ -4,6 +4,7 @@
  * @copyright (c) 2020 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <climits>
 #include <cmath>
 #include <vector>
@@ -18,6 +19,54 @@
 namespace retdec {
 namespace fileformat {
 
+namespace {
+
+/// Size of the chunks in which data are fed to the hash functions. The chunk
+/// stays in cache while all the hash functions read it.
+const std::uint64_t HASH_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * CRC32, MD5 and SHA256 computed together from data added in chunks.
+ */
+class Crc32Md5Sha256
+{
+	public:
+		Crc32Md5Sha256()
+		{
+			MD5_Init(&md5Ctx);
+			SHA256_Init(&sha256Ctx);
+		}
+
+		void add(const unsigned char *data, std::uint64_t length)
+		{
+			crcCtx.add(data, length);
+			MD5_Update(&md5Ctx, data, length);
+			SHA256_Update(&sha256Ctx, data, length);
+		}
+
+		void finish(std::string &crc32, std::string &md5, std::string &sha256)
+		{
+			crc32 = crcCtx.getHash();
+
+			std::vector<unsigned char> digest(MD5_DIGEST_LENGTH);
+			MD5_Final(digest.data(), &md5Ctx);
+			md5.clear();
+			retdec::utils::bytesToHexString(digest, md5, 0, 0, false);
+
+			digest.resize(SHA256_DIGEST_LENGTH);
+			SHA256_Final(digest.data(), &sha256Ctx);
+			sha256.clear();
+			retdec::utils::bytesToHexString(digest, sha256, 0, 0, false);
+		}
+
+	private:
+		retdec::utils::CRC32 crcCtx;
+		MD5_CTX md5Ctx;
+		SHA256_CTX sha256Ctx;
+};
+
+} // anonymous namespace
+
 /**
  * @brief Count CRC32 of @a data.
  * @param[in] data Input data.
@@ -78,5 +127,75 @@ std::string getSha256(const unsigned char *data, std::uint64_t length)
 	return sha;
 }
 
+/**
+ * @brief Count CRC32, MD5 and SHA256 of @a data in a single pass.
+ * @param[in] data Input data.
+ * @param[in] length Length of input data.
+ * @param[out] crc32 CRC32 of input data.
+ * @param[out] md5 MD5 of input data.
+ * @param[out] sha256 SHA256 of input data.
+ *
+ * The results are the same as from @c getCrc32(), @c getMd5() and
+ * @c getSha256(), but large inputs are read from memory only once.
+ */
+void getCrc32Md5Sha256(
+		const unsigned char *data,
+		std::uint64_t length,
+		std::string &crc32,
+		std::string &md5,
+		std::string &sha256)
+{
+	Crc32Md5Sha256 hashes;
+	for (std::uint64_t offset = 0; offset < length; offset += HASH_CHUNK_SIZE)
+	{
+		hashes.add(data + offset, std::min(HASH_CHUNK_SIZE, length - offset));
+	}
+	hashes.finish(crc32, md5, sha256);
+}
+
+/**
+ * @brief Count CRC32, MD5 and SHA256 of the whole @a stream in a single pass.
+ * @param[in] stream Input stream. It is read in chunks, so it does not have to
+ *            fit into memory.
+ * @param[out] crc32 CRC32 of input data.
+ * @param[out] md5 MD5 of input data.
+ * @param[out] sha256 SHA256 of input data.
+ * @return @c true if the whole stream was read, @c false otherwise (the
+ *         hashes are empty then).
+ */
+bool getCrc32Md5Sha256(
+		std::istream &stream,
+		std::string &crc32,
+		std::string &md5,
+		std::string &sha256)
+{
+	crc32.clear();
+	md5.clear();
+	sha256.clear();
+
+	stream.clear();
+	stream.seekg(0, std::ios::beg);
+	if (!stream.good())
+	{
+		return false;
+	}
+
+	Crc32Md5Sha256 hashes;
+	std::vector<char> chunk(HASH_CHUNK_SIZE);
+	while (stream.read(chunk.data(), chunk.size()) || stream.gcount() > 0)
+	{
+		hashes.add(
+				reinterpret_cast<const unsigned char*>(chunk.data()),
+				static_cast<std::uint64_t>(stream.gcount()));
+	}
+	if (!stream.eof())
+	{
+		return false;
+	}
+
+	hashes.finish(crc32, md5, sha256);
+	return true;
+}
+
 } // namespace fileformat
 } // namespace retdec
@@ -4,11 +4,14 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <fstream>
 #include <map>
 #include <memory>
 #include <system_error>
 
+#include <elfio/elf_types.hpp>
+#include <llvm/BinaryFormat/MachO.h>
 #include <llvm/Object/COFF.h>
 #include <llvm/Support/Host.h>
 
@@ -105,6 +108,17 @@ const std::map<std::pair<std::size_t, std::string>, Format> unknownFormatMap =
 	{{257, "ustar"}, Format::UNKNOWN} // tar
 };
 
+/**
+ * Number of bytes from the beginning of the input which are used for the
+ * detection of its format.
+ */
+const std::size_t HEADER_WINDOW_SIZE = 0x1000;
+
+const std::size_t PE_NT_HEADERS_OFFSET_OFFSET = 0x3C;
+const std::size_t PE_FILE_HEADER_SIZE = 20;
+const std::size_t PE_MAX_OPTIONAL_HEADER_SIZE = 0xF0;
+const std::size_t PE_SECTION_HEADER_SIZE = 40;
+
 void resetStream(std::istream& stream)
 {
 	stream.clear();
@@ -119,6 +133,68 @@ std::uint64_t streamSize(std::istream& stream)
 	return sz;
 }
 
+/**
+ * Read at most @a size bytes from the input stream
+ * @param stream Input stream
+ * @param offset Offset of the first byte to read
+ * @param size Maximal number of bytes to read
+ * @param[out] result Read bytes. Shorter than @a size if the stream ends sooner.
+ * @return @c false if reading failed, @c true otherwise
+ */
+bool readBytes(
+		std::istream& stream,
+		std::uint64_t offset,
+		std::size_t size,
+		std::string& result)
+{
+	try
+	{
+		result.resize(size);
+		stream.clear();
+		stream.seekg(offset, std::ios::beg);
+		stream.read(&result[0], size);
+		result.resize(stream.gcount());
+		stream.clear();
+	}
+	catch(...)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Read unsigned integer from the buffer
+ * @param data Buffer
+ * @param offset Offset of the integer in the buffer
+ * @param size Size of the integer in bytes
+ * @param isBigEndian Is the integer stored in big endian?
+ * @param[out] result Read integer
+ * @return @c false if the integer is not whole in the buffer, @c true otherwise
+ */
+bool readInteger(
+		const std::string& data,
+		std::size_t offset,
+		std::size_t size,
+		bool isBigEndian,
+		std::uint64_t& result)
+{
+	if (offset > data.size() || data.size() - offset < size)
+	{
+		return false;
+	}
+
+	result = 0;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		std::uint64_t byte = static_cast<std::uint8_t>(data[offset + i]);
+		result |= byte << (8 * (isBigEndian ? size - 1 - i : i));
+	}
+
+	return true;
+}
+
 /**
  * Check if input file contains PE signature
  * @param stream Input stream
@@ -135,32 +211,20 @@ bool isPe(std::istream& stream)
 
 /**
  * Check if file is Java class
- * @param stream Input stream
+ * @param header Leading bytes of input file
  * @return @c true if input file is Java class file, @c false otherwise
  */
-bool isJava(std::istream& stream)
+bool isJava(const std::string& header)
 {
-	resetStream(stream);
-
-	if (!stream)
-	{
-		return false;
-	}
-
-	std::uint32_t magic = 0;
-	stream.read(reinterpret_cast<char*>(&magic), 4);
+	std::uint64_t magic = 0;
+	readInteger(header, 0, 4, true, magic);
 
 	// Same for both Java and fat Mach-O
 	if (magic == 0xcafebabe || magic == 0xbebafeca)
 	{
-		std::uint32_t fatCount = 0;
-		stream.read(reinterpret_cast<char*>(&fatCount), 4);
-
-		if (sys::IsLittleEndianHost)
-		{
-			// Both are in big endian std::uint8_t order
-			fatCount = sys::SwapByteOrder_32(fatCount);
-		}
+		// Both are in big endian std::uint8_t order
+		std::uint64_t fatCount = 0;
+		readInteger(header, 4, 4, true, fatCount);
 
 		// Mach-O currently supports up to 18 architectures
 		// Java version starts at 39. However file utility uses value 30
@@ -172,28 +236,16 @@ bool isJava(std::istream& stream)
 
 /**
  * Check if file is strange format with Mach-O magic.
- * @param stream Input stream
+ * @param header Leading bytes of input file
  * @return @c true if input file is likely not Mach-O, @c false otherwise
  */
-bool isStrangeFeedface(std::istream& stream)
+bool isStrangeFeedface(const std::string& header)
 {
-	resetStream(stream);
-
-	if (!stream)
+	// All such files found were in little endian std::uint8_t order
+	std::uint64_t ints[4] = {};
+	for (std::size_t i = 0; i < 4; ++i)
 	{
-		return false;
-	}
-
-	std::uint32_t ints[4];
-	stream.read(reinterpret_cast<char*>(&ints), 16);
-
-	if (sys::IsBigEndianHost)
-	{
-		// All such files found were in little endian std::uint8_t order
-		for (int i = 0; i < 4; ++i)
-		{
-			ints[i] = sys::SwapByteOrder_32(ints[i]);
-		}
+		readInteger(header, 4 * i, 4, false, ints[i]);
 	}
 
 	if (ints[0] == 0xfeedface && ints[1] == 0x10 && ints[2] == 0x02)
@@ -206,74 +258,54 @@ bool isStrangeFeedface(std::istream& stream)
 	return false;
 }
 
-} // anonymous namespace
-
-Format detectFileFormat(std::istream &inputStream, bool isRaw)
+/**
+ * Detect file format from the leading bytes of input file
+ * @param header Leading bytes of input file
+ * @param fileSize Size of input file
+ * @return Detected file format. PE has to be verified by the caller.
+ */
+Format detectFormatFromHeader(std::string header, std::uint64_t fileSize)
 {
-	if (isRaw)
+	std::size_t magicSize = 0;
+	for(const auto &item : unknownFormatMap)
 	{
-		return Format::RAW_DATA;
+		magicSize = std::max(magicSize, item.first.first + item.first.second.length());
+	}
+	for(const auto &item : magicFormatMap)
+	{
+		magicSize = std::max(magicSize, item.first.first + item.first.second.length());
+	}
+
+	// Magics of short files are compared as if the files were padded by zeros.
+	if (header.size() < magicSize)
+	{
+		header.resize(magicSize);
 	}
 
 	// Try unknown formats.
 	//
-	resetStream(inputStream);
-	std::size_t umagicSize = 0;
 	for(const auto &item : unknownFormatMap)
 	{
-		umagicSize = std::max(umagicSize, item.first.first + item.first.second.length());
-	}
-	std::string umagic;
-	try
-	{
-		umagic.resize(umagicSize);
-		inputStream.read(&umagic[0], umagicSize);
-		for(const auto &item : unknownFormatMap)
+		if(hasSubstringOnPosition(header, item.first.second, item.first.first))
 		{
-			if(hasSubstringOnPosition(umagic, item.first.second, item.first.first))
-			{
-				return Format::UNKNOWN;
-			}
+			return Format::UNKNOWN;
 		}
 	}
-	catch(...)
-	{
-		// ignore
-	}
 
 	// Try known formats.
 	//
-	resetStream(inputStream);
-	std::size_t magicSize = 0;
-	for(const auto &item : magicFormatMap)
-	{
-		magicSize = std::max(magicSize, item.first.first + item.first.second.length());
-	}
-	std::string magic;
-	try
-	{
-		magic.resize(magicSize);
-		inputStream.read(&magic[0], magicSize);
-	}
-	catch(...)
-	{
-		return Format::UNDETECTABLE;
-	}
-
 	for(const auto &item : magicFormatMap)
 	{
-		if(hasSubstringOnPosition(magic, item.first.second, item.first.first))
+		if(hasSubstringOnPosition(header, item.first.second, item.first.first))
 		{
 			switch(item.second)
 			{
-				case Format::PE:
-					return isPe(inputStream) ? Format::PE : Format::UNKNOWN;
 				case Format::COFF:
-					if (streamSize(inputStream) < COFF_FILE_HEADER_BYTE_SIZE)
+					if (fileSize < COFF_FILE_HEADER_BYTE_SIZE)
 						return Format::UNKNOWN;
 					return Format::COFF;
 				case Format::MACHO:
-					if (isStrangeFeedface(inputStream) || isJava(inputStream))
+					if (isStrangeFeedface(header) || isJava(header))
 					{
 						// Java class and some other format use Mach-O magics
 						return Format::UNKNOWN;
@@ -288,6 +320,331 @@ Format detectFileFormat(std::istream &inputStream, bool isRaw)
 	return Format::UNKNOWN;
 }
 
+Architecture getCoffArchitecture(std::uint64_t machine)
+{
+	switch(machine)
+	{
+		case PELIB_IMAGE_FILE_MACHINE_I386:
+		case PELIB_IMAGE_FILE_MACHINE_I486:
+		case PELIB_IMAGE_FILE_MACHINE_PENTIUM:
+			return Architecture::X86;
+		case PELIB_IMAGE_FILE_MACHINE_AMD64:
+			return Architecture::X86_64;
+		case PELIB_IMAGE_FILE_MACHINE_R3000_BIG:
+		case PELIB_IMAGE_FILE_MACHINE_R3000_LITTLE:
+		case PELIB_IMAGE_FILE_MACHINE_R4000:
+		case PELIB_IMAGE_FILE_MACHINE_R10000:
+		case PELIB_IMAGE_FILE_MACHINE_WCEMIPSV2:
+		case PELIB_IMAGE_FILE_MACHINE_MIPS16:
+		case PELIB_IMAGE_FILE_MACHINE_MIPSFPU:
+		case PELIB_IMAGE_FILE_MACHINE_MIPSFPU16:
+			return Architecture::MIPS;
+		case PELIB_IMAGE_FILE_MACHINE_ARM:
+		case PELIB_IMAGE_FILE_MACHINE_THUMB:
+		case PELIB_IMAGE_FILE_MACHINE_ARMNT:
+		case PELIB_IMAGE_FILE_MACHINE_ARM64:
+			return Architecture::ARM;
+		case PELIB_IMAGE_FILE_MACHINE_POWERPC:
+		case PELIB_IMAGE_FILE_MACHINE_POWERPCFP:
+			return Architecture::POWERPC;
+		default:
+			return Architecture::UNKNOWN;
+	}
+}
+
+std::size_t getCoffBitness(std::uint64_t machine)
+{
+	switch(machine)
+	{
+		case PELIB_IMAGE_FILE_MACHINE_AMD64:
+		case PELIB_IMAGE_FILE_MACHINE_ARM64:
+		case PELIB_IMAGE_FILE_MACHINE_IA64:
+		case PELIB_IMAGE_FILE_MACHINE_ALPHA64:
+			return 64;
+		default:
+			return getCoffArchitecture(machine) == Architecture::UNKNOWN ? 0 : 32;
+	}
+}
+
+/**
+ * Fill summary of PE file. Only the DOS header, NT headers and section table
+ * are read from the input.
+ * @param stream Input stream
+ * @param header Leading bytes of input file
+ * @param fileSize Size of input file
+ * @param[out] summary Summary to fill
+ * @return @c false if input file does not contain valid PE signature
+ */
+bool summarizePe(
+		std::istream& stream,
+		const std::string& header,
+		std::uint64_t fileSize,
+		FormatSummary& summary)
+{
+	std::uint64_t ntOffset = 0;
+	if (!readInteger(header, PE_NT_HEADERS_OFFSET_OFFSET, 4, false, ntOffset)
+			|| (ntOffset & 3)
+			|| ntOffset >= fileSize)
+	{
+		return false;
+	}
+
+	// NT headers are usually in the header window but e_lfanew can point anywhere
+	auto readRange = [&](std::uint64_t offset, std::size_t size, std::string& result)
+	{
+		if (offset + size <= header.size())
+		{
+			result = header.substr(offset, size);
+			return true;
+		}
+		return readBytes(stream, offset, size, result);
+	};
+
+	std::string ntHeaders;
+	std::uint64_t signature = 0;
+	if (!readRange(ntOffset, 4 + PE_FILE_HEADER_SIZE + PE_MAX_OPTIONAL_HEADER_SIZE, ntHeaders)
+			|| !readInteger(ntHeaders, 0, 4, false, signature)
+			|| signature != PELIB_IMAGE_NT_SIGNATURE)
+	{
+		return false;
+	}
+
+	summary.endianness = Endianness::LITTLE;
+
+	std::uint64_t machine = 0, numberOfSections = 0, optionalHeaderSize = 0;
+	if (!readInteger(ntHeaders, 4, 2, false, machine)
+			|| !readInteger(ntHeaders, 6, 2, false, numberOfSections)
+			|| !readInteger(ntHeaders, 20, 2, false, optionalHeaderSize))
+	{
+		// Cut NT headers, the file is still recognized as PE
+		return true;
+	}
+	summary.architecture = getCoffArchitecture(machine);
+
+	const std::size_t optionalHeader = 4 + PE_FILE_HEADER_SIZE;
+	std::uint64_t magic = 0, entryPointRva = 0, imageBase = 0;
+	readInteger(ntHeaders, optionalHeader, 2, false, magic);
+	if (magic == PELIB_IMAGE_NT_OPTIONAL_HDR32_MAGIC)
+	{
+		summary.bitness = 32;
+		summary.hasEntryPoint = readInteger(ntHeaders, optionalHeader + 16, 4, false, entryPointRva)
+				&& readInteger(ntHeaders, optionalHeader + 28, 4, false, imageBase);
+		summary.entryPoint = (imageBase + entryPointRva) & 0xFFFFFFFF;
+	}
+	else if (magic == PELIB_IMAGE_NT_OPTIONAL_HDR64_MAGIC)
+	{
+		summary.bitness = 64;
+		summary.hasEntryPoint = readInteger(ntHeaders, optionalHeader + 16, 4, false, entryPointRva)
+				&& readInteger(ntHeaders, optionalHeader + 24, 8, false, imageBase);
+		summary.entryPoint = imageBase + entryPointRva;
+	}
+	if (!summary.hasEntryPoint)
+	{
+		summary.entryPoint = 0;
+	}
+
+	std::string sectionTable;
+	if (!readRange(
+			ntOffset + optionalHeader + optionalHeaderSize,
+			numberOfSections * PE_SECTION_HEADER_SIZE,
+			sectionTable))
+	{
+		return true;
+	}
+
+	bool entryPointInSection = false;
+	std::uint64_t endOfRawData = 0;
+	for (std::size_t offset = 0;
+			offset + PE_SECTION_HEADER_SIZE <= sectionTable.size();
+			offset += PE_SECTION_HEADER_SIZE)
+	{
+		std::uint64_t virtualSize = 0, virtualAddress = 0, rawSize = 0, rawOffset = 0, flags = 0;
+		readInteger(sectionTable, offset + 8, 4, false, virtualSize);
+		readInteger(sectionTable, offset + 12, 4, false, virtualAddress);
+		readInteger(sectionTable, offset + 16, 4, false, rawSize);
+		readInteger(sectionTable, offset + 20, 4, false, rawOffset);
+		readInteger(sectionTable, offset + 36, 4, false, flags);
+
+		if (rawSize)
+		{
+			endOfRawData = std::max(endOfRawData, rawOffset + rawSize);
+		}
+
+		if (sectionTable.compare(offset, 3, "UPX") == 0)
+		{
+			summary.isPackedHint = true;
+		}
+
+		// Code unpacked at runtime usually starts in a section which
+		// is both writable and executable, or which has no data in the file
+		if (summary.hasEntryPoint
+				&& entryPointRva >= virtualAddress
+				&& entryPointRva < virtualAddress + std::max(virtualSize, rawSize))
+		{
+			entryPointInSection = true;
+			const std::uint64_t wx = PELIB_IMAGE_SCN_MEM_WRITE | PELIB_IMAGE_SCN_MEM_EXECUTE;
+			if (rawSize == 0 || (flags & wx) == wx)
+			{
+				summary.isPackedHint = true;
+			}
+		}
+	}
+
+	if (summary.hasEntryPoint && entryPointRva && numberOfSections && !entryPointInSection)
+	{
+		summary.isPackedHint = true;
+	}
+
+	if (endOfRawData && endOfRawData < fileSize)
+	{
+		summary.hasOverlay = true;
+		summary.overlayOffset = endOfRawData;
+	}
+
+	return true;
+}
+
+void summarizeCoff(const std::string& header, FormatSummary& summary)
+{
+	// Big object files start with 0x0000 0xFFFF followed by version and machine
+	std::uint64_t machine = 0, sig = 0;
+	readInteger(header, 0, 4, false, sig);
+	readInteger(header, sig == 0xFFFF0000 ? 6 : 0, 2, false, machine);
+
+	summary.endianness = Endianness::LITTLE;
+	summary.architecture = getCoffArchitecture(machine);
+	summary.bitness = getCoffBitness(machine);
+}
+
+void summarizeElf(const std::string& header, FormatSummary& summary)
+{
+	std::uint64_t elfClass = 0, elfData = 0;
+	readInteger(header, EI_CLASS, 1, false, elfClass);
+	readInteger(header, EI_DATA, 1, false, elfData);
+	if (elfData != ELFDATA2LSB && elfData != ELFDATA2MSB)
+	{
+		return;
+	}
+
+	const bool isBigEndian = elfData == ELFDATA2MSB;
+	summary.endianness = isBigEndian ? Endianness::BIG : Endianness::LITTLE;
+
+	std::uint64_t type = 0, machine = 0;
+	readInteger(header, 16, 2, isBigEndian, type);
+	readInteger(header, 18, 2, isBigEndian, machine);
+	switch (machine)
+	{
+		case EM_386:
+		case EM_486:
+			summary.architecture = Architecture::X86;
+			break;
+		case EM_X86_64:
+			summary.architecture = Architecture::X86_64;
+			break;
+		case EM_MIPS:
+		case EM_MIPS_RS3_LE:
+		case EM_MIPS_X:
+			summary.architecture = Architecture::MIPS;
+			break;
+		case EM_ARM:
+		case EM_AARCH64:
+			summary.architecture = Architecture::ARM;
+			break;
+		case EM_PPC:
+		case EM_PPC64:
+			summary.architecture = Architecture::POWERPC;
+			break;
+		default:
+			break;
+	}
+
+	std::uint64_t sectionCount = 0;
+	if (elfClass == ELFCLASS32)
+	{
+		summary.bitness = 32;
+		summary.hasEntryPoint = readInteger(header, 24, 4, isBigEndian, summary.entryPoint);
+		readInteger(header, 48, 2, isBigEndian, sectionCount);
+	}
+	else if (elfClass == ELFCLASS64)
+	{
+		summary.bitness = 64;
+		summary.hasEntryPoint = readInteger(header, 24, 8, isBigEndian, summary.entryPoint);
+		readInteger(header, 60, 2, isBigEndian, sectionCount);
+	}
+
+	// Packers usually strip the section header table of executables
+	summary.isPackedHint = (type == ET_EXEC || type == ET_DYN) && sectionCount == 0;
+}
+
+void summarizeMachO(const std::string& header, FormatSummary& summary)
+{
+	std::uint64_t magic = 0;
+	readInteger(header, 0, 4, false, magic);
+	switch (magic)
+	{
+		case MachO::MH_MAGIC:
+		case MachO::MH_MAGIC_64:
+			summary.endianness = Endianness::LITTLE;
+			break;
+		case MachO::MH_CIGAM:
+		case MachO::MH_CIGAM_64:
+			summary.endianness = Endianness::BIG;
+			break;
+		default:
+			// Universal binary, architecture depends on the chosen object
+			summary.endianness = Endianness::BIG;
+			return;
+	}
+	summary.bitness = (magic == MachO::MH_MAGIC_64 || magic == MachO::MH_CIGAM_64) ? 64 : 32;
+
+	std::uint64_t cpuType = 0;
+	readInteger(header, 4, 4, summary.endianness == Endianness::BIG, cpuType);
+	switch (cpuType)
+	{
+		case MachO::CPU_TYPE_X86:
+			summary.architecture = Architecture::X86;
+			break;
+		case MachO::CPU_TYPE_X86_64:
+			summary.architecture = Architecture::X86_64;
+			break;
+		case MachO::CPU_TYPE_MC98000: // Old Motorola PowerPC
+		case MachO::CPU_TYPE_POWERPC:
+		case MachO::CPU_TYPE_POWERPC64:
+			summary.architecture = Architecture::POWERPC;
+			break;
+		case MachO::CPU_TYPE_ARM:
+		case MachO::CPU_TYPE_ARM64:
+			summary.architecture = Architecture::ARM;
+			break;
+		default:
+			break;
+	}
+}
+
+} // anonymous namespace
+
+Format detectFileFormat(std::istream &inputStream, bool isRaw)
+{
+	if (isRaw)
+	{
+		return Format::RAW_DATA;
+	}
+
+	std::string header;
+	if (!readBytes(inputStream, 0, HEADER_WINDOW_SIZE, header))
+	{
+		return Format::UNDETECTABLE;
+	}
+
+	auto format = detectFormatFromHeader(header, streamSize(inputStream));
+	if (format == Format::PE && !isPe(inputStream))
+	{
+		return Format::UNKNOWN;
+	}
+
+	return format;
+}
+
 /**
  * Detects file format of input file
  * @param filePath Path to input file
@@ -313,5 +670,75 @@ Format detectFileFormat(const std::uint8_t* data, std::size_t size, bool isRaw)
 	return detectFileFormat(istream, isRaw);
 }
 
+/**
+ * Detects file format of input stream together with basic information from
+ * its headers. Unlike creating the whole file format, only a bounded window
+ * of the headers is read from the input.
+ * @param inputStream Input stream
+ * @param isRaw Is the input is a raw binary?
+ * @return Summary of the input. Entry point is not detected for Mach-O and
+ *    COFF files, overlay is detected only for PE files.
+ */
+FormatSummary detectFileFormatSummary(std::istream &inputStream, bool isRaw)
+{
+	FormatSummary summary;
+	if (isRaw)
+	{
+		summary.format = Format::RAW_DATA;
+		return summary;
+	}
+
+	std::string header;
+	if (!readBytes(inputStream, 0, HEADER_WINDOW_SIZE, header))
+	{
+		return summary;
+	}
+
+	const auto fileSize = streamSize(inputStream);
+	summary.format = detectFormatFromHeader(header, fileSize);
+	switch (summary.format)
+	{
+		case Format::PE:
+			if (!summarizePe(inputStream, header, fileSize, summary))
+			{
+				summary = FormatSummary();
+				summary.format = Format::UNKNOWN;
+			}
+			break;
+		case Format::COFF:
+			summarizeCoff(header, summary);
+			break;
+		case Format::ELF:
+			summarizeElf(header, summary);
+			break;
+		case Format::MACHO:
+			summarizeMachO(header, summary);
+			break;
+		default:
+			break;
+	}
+
+	return summary;
+}
+
+FormatSummary detectFileFormatSummary(const std::string &filePath, bool isRaw)
+{
+	std::ifstream stream(filePath, std::ifstream::in | std::ifstream::binary);
+	if(!stream.is_open())
+	{
+		return FormatSummary();
+	}
+
+	return detectFileFormatSummary(stream, isRaw);
+}
+
+FormatSummary detectFileFormatSummary(const std::uint8_t* data, std::size_t size, bool isRaw)
+{
+	byte_array_buffer bab(data, size);
+	std::istream istream(&bab);
+
+	return detectFileFormatSummary(istream, isRaw);
+}
+
 } // namespace fileformat
 } // namespace retdec
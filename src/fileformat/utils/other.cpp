@@ -4,6 +4,7 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <map>
@@ -21,6 +22,46 @@ namespace fileformat {
 namespace
 {
 
+/// Size of the chunks in which entropy of streamed data is computed.
+const std::size_t ENTROPY_CHUNK_SIZE = 1024 * 1024;
+
+/// Byte counts in four interleaved tables. Runs of the same byte (e.g. zero
+/// padding) would otherwise make every increment wait for the previous store
+/// to the same counter.
+using ByteHistograms = std::array<std::array<std::uint64_t, 256>, 4>;
+
+void countBytes(ByteHistograms &histograms, const std::uint8_t *data, std::size_t dataLen)
+{
+	std::size_t i = 0;
+	for (; i + 4 <= dataLen; i += 4)
+	{
+		histograms[0][data[i]]++;
+		histograms[1][data[i + 1]]++;
+		histograms[2][data[i + 2]]++;
+		histograms[3][data[i + 3]]++;
+	}
+	for (; i < dataLen; i++)
+	{
+		histograms[0][data[i]]++;
+	}
+}
+
+double computeHistogramEntropy(const ByteHistograms &histograms, std::uint64_t dataLen)
+{
+	double entropy = 0;
+	for (std::size_t b = 0; b < 256; b++)
+	{
+		auto frequency = histograms[0][b] + histograms[1][b]
+				+ histograms[2][b] + histograms[3][b];
+		if (frequency)
+		{
+			double probability = static_cast<double>(frequency) / dataLen;
+			entropy -= probability * std::log2(probability);
+		}
+	}
+	return entropy;
+}
+
 const std::map<Format, std::string> formatMap =
 {
 	{Format::PE, "PE"},
@@ -488,29 +529,52 @@ std::string codePageToStr(std::size_t cpage)
  */
 double computeDataEntropy(const std::uint8_t *data, std::size_t dataLen)
 {
-	std::array<std::size_t, 256> histogram{};
-	double entropy = 0;
-
 	if (!data)
 	{
 		return 0;
 	}
 
-	for (std::size_t i = 0; i < dataLen; i++)
+	ByteHistograms histograms{};
+	countBytes(histograms, data, dataLen);
+	return computeHistogramEntropy(histograms, dataLen);
+}
+
+/*
+ * Compute entropy of data in the given part of a stream. The data are read in
+ * chunks, so they do not have to fit into memory.
+ * @param stream Stream to read the data from
+ * @param offset Offset of the data in @a stream
+ * @param size Size of the data
+ * @param res Variable to store the entropy in <0,8> to
+ * @return @c true if all the data were read, @c false otherwise
+ */
+bool computeDataEntropy(std::istream &stream, std::uint64_t offset, std::uint64_t size, double &res)
+{
+	stream.clear();
+	stream.seekg(offset, std::ios::beg);
+	if (!stream.good())
 	{
-		histogram[data[i]]++;
+		return false;
 	}
 
-	for (auto frequency : histogram)
+	ByteHistograms histograms{};
+	std::vector<char> chunk(ENTROPY_CHUNK_SIZE);
+	std::uint64_t counted = 0;
+	while (counted < size)
 	{
-		if (frequency)
+		const auto toRead = std::min<std::uint64_t>(chunk.size(), size - counted);
+		stream.read(chunk.data(), toRead);
+		const auto read = static_cast<std::uint64_t>(stream.gcount());
+		if (read == 0)
 		{
-			double probability = static_cast<double>(frequency) / dataLen;
-			entropy -= probability * std::log2(probability);
+			return false;
 		}
+		countBytes(histograms, reinterpret_cast<const std::uint8_t*>(chunk.data()), read);
+		counted += read;
 	}
 
-	return entropy;
+	res = computeHistogramEntropy(histograms, size);
+	return true;
 }
 
 } // namespace fileformat
@@ -0,0 +1,308 @@
+/**
+ * @file src/fileformat/utils/unwind.cpp
+ * @brief Function ranges from unwind information.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <map>
+#include <string>
+
+#include "retdec/fileformat/utils/unwind.h"
+
+namespace retdec {
+namespace fileformat {
+
+namespace
+{
+
+// Pointer encodings (DW_EH_PE_*) used in .eh_frame.
+const std::uint8_t DW_EH_PE_omit = 0xff;
+const std::uint8_t DW_EH_PE_absptr = 0x00;
+const std::uint8_t DW_EH_PE_uleb128 = 0x01;
+const std::uint8_t DW_EH_PE_udata2 = 0x02;
+const std::uint8_t DW_EH_PE_udata4 = 0x03;
+const std::uint8_t DW_EH_PE_udata8 = 0x04;
+const std::uint8_t DW_EH_PE_sleb128 = 0x09;
+const std::uint8_t DW_EH_PE_sdata2 = 0x0a;
+const std::uint8_t DW_EH_PE_sdata4 = 0x0b;
+const std::uint8_t DW_EH_PE_sdata8 = 0x0c;
+const std::uint8_t DW_EH_PE_pcrel = 0x10;
+
+/**
+ * Sequential reader of .eh_frame records. Every read fails once the end of
+ * the data is reached.
+ */
+class Reader
+{
+	public:
+		Reader(const std::uint8_t *data, std::size_t size, bool littleEndian, std::size_t wordSize)
+			: data(data), size(size), littleEndian(littleEndian), wordSize(wordSize)
+		{
+		}
+
+		bool read(std::size_t n, std::uint64_t &res)
+		{
+			if (n > size - pos || n > sizeof(res))
+			{
+				return false;
+			}
+			res = 0;
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				std::uint64_t b = data[pos + (littleEndian ? i : n - 1 - i)];
+				res |= b << (8 * i);
+			}
+			pos += n;
+			return true;
+		}
+
+		bool readSigned(std::size_t n, std::uint64_t &res)
+		{
+			if (!read(n, res))
+			{
+				return false;
+			}
+			if (n < sizeof(res) && (res >> (8 * n - 1)) & 1)
+			{
+				res |= ~std::uint64_t(0) << (8 * n);
+			}
+			return true;
+		}
+
+		bool readLeb128(bool isSigned, std::uint64_t &res)
+		{
+			res = 0;
+			unsigned shift = 0;
+			std::uint64_t b = 0;
+			do
+			{
+				if (!read(1, b))
+				{
+					return false;
+				}
+				if (shift < 64)
+				{
+					res |= (b & 0x7f) << shift;
+				}
+				shift += 7;
+			} while (b & 0x80);
+
+			if (isSigned && shift < 64 && (b & 0x40))
+			{
+				res |= ~std::uint64_t(0) << shift;
+			}
+			return true;
+		}
+
+		bool readString(std::string &res)
+		{
+			res.clear();
+			std::uint64_t c = 0;
+			while (read(1, c))
+			{
+				if (c == 0)
+				{
+					return true;
+				}
+				res += static_cast<char>(c);
+			}
+			return false;
+		}
+
+		/**
+		 * Read pointer in the given encoding. Only absolute and PC-relative
+		 * pointers can be read, @a address is the address of the data.
+		 */
+		bool readPointer(std::uint8_t encoding, std::uint64_t address, std::uint64_t &res)
+		{
+			const auto fieldAddress = address + pos;
+			bool ok = false;
+			switch (encoding & 0x0f)
+			{
+				case DW_EH_PE_absptr: ok = read(wordSize, res); break;
+				case DW_EH_PE_uleb128: ok = readLeb128(false, res); break;
+				case DW_EH_PE_udata2: ok = read(2, res); break;
+				case DW_EH_PE_udata4: ok = read(4, res); break;
+				case DW_EH_PE_udata8: ok = read(8, res); break;
+				case DW_EH_PE_sleb128: ok = readLeb128(true, res); break;
+				case DW_EH_PE_sdata2: ok = readSigned(2, res); break;
+				case DW_EH_PE_sdata4: ok = readSigned(4, res); break;
+				case DW_EH_PE_sdata8: ok = readSigned(8, res); break;
+				default: return false;
+			}
+			if (!ok)
+			{
+				return false;
+			}
+
+			switch (encoding & 0x70)
+			{
+				case 0: break;
+				case DW_EH_PE_pcrel: res += fieldAddress; break;
+				default: return false;
+			}
+			if (wordSize < sizeof(res))
+			{
+				res &= (std::uint64_t(1) << (8 * wordSize)) - 1;
+			}
+			return true;
+		}
+
+		/**
+		 * Read the size of data in the given pointer encoding, relative and
+		 * indirect flags do not apply to it.
+		 */
+		bool readRange(std::uint8_t encoding, std::uint64_t &res)
+		{
+			return readPointer(encoding & 0x0f, 0, res);
+		}
+
+	public:
+		const std::uint8_t *data = nullptr;
+		std::size_t size = 0;
+		std::size_t pos = 0;
+		bool littleEndian = true;
+		std::size_t wordSize = 4;
+};
+
+/**
+ * Parse CIE at the reader's position (after its ID) ending at @a end.
+ * @return Pointer encoding of FDEs which use the CIE.
+ */
+bool parseCie(Reader &r, std::size_t end, std::uint64_t address, std::uint8_t &fdeEncoding)
+{
+	std::uint64_t version = 0, tmp = 0;
+	std::string augmentation;
+	if (!r.read(1, version) || !r.readString(augmentation))
+	{
+		return false;
+	}
+	// Code alignment, data alignment and return address register.
+	if (!r.readLeb128(false, tmp) || !r.readLeb128(true, tmp)
+			|| !(version == 1 ? r.read(1, tmp) : r.readLeb128(false, tmp)))
+	{
+		return false;
+	}
+
+	fdeEncoding = DW_EH_PE_absptr;
+	if (augmentation.empty() || augmentation[0] != 'z')
+	{
+		return augmentation.empty();
+	}
+	if (!r.readLeb128(false, tmp))
+	{
+		return false;
+	}
+	for (std::size_t i = 1; i < augmentation.size() && r.pos < end; ++i)
+	{
+		std::uint64_t enc = 0;
+		switch (augmentation[i])
+		{
+			case 'R':
+				if (!r.read(1, enc))
+					return false;
+				fdeEncoding = enc;
+				break;
+			case 'P':
+				if (!r.read(1, enc) || !r.readPointer(enc & 0x7f, address, tmp))
+					return false;
+				break;
+			case 'L':
+				if (!r.read(1, enc))
+					return false;
+				break;
+			case 'S':
+			case 'B':
+				break;
+			default:
+				// Unknown augmentation, FDE encoding may follow it.
+				return false;
+		}
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+/**
+ * Get ranges of functions described by FDEs in .eh_frame data
+ * @param data Content of .eh_frame
+ * @param size Size of @a data
+ * @param address Address of @a data
+ * @param littleEndian @c true if the data are in little endian
+ * @param wordSize Size of pointer in bytes
+ * @return Ranges of functions in the order of FDEs
+ *
+ * FDEs whose CIE uses an unsupported augmentation or pointer encoding are
+ * skipped. Parsing stops at a terminator or at a malformed record.
+ */
+std::vector<retdec::common::Range<std::uint64_t>> parseEhFrame(
+		const std::uint8_t *data,
+		std::size_t size,
+		std::uint64_t address,
+		bool littleEndian,
+		std::size_t wordSize)
+{
+	std::vector<retdec::common::Range<std::uint64_t>> res;
+	if (data == nullptr || wordSize == 0 || wordSize > 8)
+	{
+		return res;
+	}
+
+	// Offsets of CIEs and encodings of their FDEs. Invalid CIEs are absent.
+	std::map<std::size_t, std::uint8_t> cies;
+	Reader r(data, size, littleEndian, wordSize);
+	while (r.pos < size)
+	{
+		const auto start = r.pos;
+		std::uint64_t length = 0;
+		if (!r.read(4, length) || length == 0)
+		{
+			break;
+		}
+		if (length == 0xffffffff && !r.read(8, length))
+		{
+			break;
+		}
+		if (length > size - r.pos)
+		{
+			break;
+		}
+		const auto idPos = r.pos;
+		const auto end = r.pos + length;
+
+		std::uint64_t id = 0;
+		if (r.read(4, id))
+		{
+			if (id == 0)
+			{
+				std::uint8_t enc = DW_EH_PE_absptr;
+				if (parseCie(r, end, address, enc))
+				{
+					cies[start] = enc;
+				}
+			}
+			else if (id <= idPos)
+			{
+				auto cie = cies.find(idPos - id);
+				std::uint64_t begin = 0, range = 0;
+				if (cie != cies.end()
+						&& cie->second != DW_EH_PE_omit
+						&& r.readPointer(cie->second, address, begin)
+						&& r.readRange(cie->second, range)
+						&& range > 0
+						&& begin + range > begin)
+				{
+					res.emplace_back(begin, begin + range);
+				}
+			}
+		}
+
+		r.pos = end;
+	}
+
+	return res;
+}
+
+} // namespace fileformat
+} // namespace retdec
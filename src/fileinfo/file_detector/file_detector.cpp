@@ -5,6 +5,7 @@
  */
 
 #include <memory>
+#include <utility>
 
 #include <tinyxml2/tinyxml2.h>
 
@@ -34,6 +35,8 @@ FileDetector::FileDetector(
 		, fileConfig(nullptr)
 		, fileParser(nullptr)
 		, loadFlags(loadFlags)
+		, fields(FIELDS_ALL)
+		, timeBudget(0)
 		, loaded(false)
 {
 	fileInfo.setPathToFile(pathToInputFile);
@@ -325,6 +328,31 @@ void FileDetector::setConfigFile(retdec::config::Config &config)
 			config.parameters.getSectionVMA());
 }
 
+/**
+ * Select parts of information which are computed by getAllInformation()
+ * @param analysisFields Parts of information to compute
+ *
+ * Basic information about file (format, class, architecture, type,
+ * endianness and word size) is computed always.
+ */
+void FileDetector::setAnalysisFields(AnalysisFields analysisFields)
+{
+	fields = analysisFields;
+}
+
+/**
+ * Limit time spent in getAllInformation()
+ * @param budget Time budget, zero means unlimited
+ *
+ * The budget is checked before each part of information is computed.
+ * Once it is exceeded, remaining parts are skipped and a warning is
+ * added to messages. A part which is already running is not interrupted.
+ */
+void FileDetector::setTimeBudget(std::chrono::milliseconds budget)
+{
+	timeBudget = budget;
+}
+
 /**
  * Get all supported information about binary file
  */
@@ -338,21 +366,44 @@ void FileDetector::getAllInformation()
 		detectFileType();
 		getEndianness();
 		getArchitectureBitSize();
-		getCompilerInformation();
-		getRichHeaderInfo();
-		getOverlayInfo();
-		getPdbInfo();
-		getResourceInfo();
-		getManifestInfo();
-		getImports();
-		getExports();
-		getHashes();
-		getAdditionalInfo();
-		getCertificates();
-		getTlsInfo();
-		getLoaderInfo();
-		getStrings();
-		getAnomalies();
+
+		const std::pair<AnalysisFields, void (FileDetector::*)()> getters[] =
+		{
+			{FIELDS_COMPILER, &FileDetector::getCompilerInformation},
+			{FIELDS_RICH_HEADER, &FileDetector::getRichHeaderInfo},
+			{FIELDS_OVERLAY, &FileDetector::getOverlayInfo},
+			{FIELDS_PDB, &FileDetector::getPdbInfo},
+			{FIELDS_RESOURCES, &FileDetector::getResourceInfo},
+			{FIELDS_MANIFEST, &FileDetector::getManifestInfo},
+			{FIELDS_IMPORTS, &FileDetector::getImports},
+			{FIELDS_EXPORTS, &FileDetector::getExports},
+			{FIELDS_HASHES, &FileDetector::getHashes},
+			{FIELDS_DETAILS, &FileDetector::getAdditionalInfo},
+			{FIELDS_CERTIFICATES, &FileDetector::getCertificates},
+			{FIELDS_TLS, &FileDetector::getTlsInfo},
+			{FIELDS_LOADER, &FileDetector::getLoaderInfo},
+			{FIELDS_STRINGS, &FileDetector::getStrings},
+			{FIELDS_ANOMALIES, &FileDetector::getAnomalies}
+		};
+
+		const auto deadline = std::chrono::steady_clock::now() + timeBudget;
+		for(const auto &getter : getters)
+		{
+			if(!(fields & getter.first))
+			{
+				continue;
+			}
+
+			if(timeBudget.count() && std::chrono::steady_clock::now() >= deadline)
+			{
+				fileInfo.messages.push_back("Warning: Time budget of "
+					+ std::to_string(timeBudget.count())
+					+ " ms exceeded, some information was not computed.");
+				break;
+			}
+
+			(this->*getter.second)();
+		}
 	}
 }
 
@@ -7,6 +7,8 @@
 #ifndef FILEINFO_FILE_DETECTOR_FILE_DETECTOR_H
 #define FILEINFO_FILE_DETECTOR_FILE_DETECTOR_H
 
+#include <chrono>
+
 #include "retdec/config/config.h"
 #include "retdec/utils/non_copyable.h"
 #include "fileinfo/file_information/file_information.h"
@@ -14,6 +16,30 @@
 namespace retdec {
 namespace fileinfo {
 
+/**
+ * Parts of information about file which can be selected for computation
+ */
+enum AnalysisFields : unsigned
+{
+	FIELDS_NONE         = 0,
+	FIELDS_COMPILER     = 1 << 0,
+	FIELDS_RICH_HEADER  = 1 << 1,
+	FIELDS_OVERLAY      = 1 << 2,
+	FIELDS_PDB          = 1 << 3,
+	FIELDS_RESOURCES    = 1 << 4,
+	FIELDS_MANIFEST     = 1 << 5,
+	FIELDS_IMPORTS      = 1 << 6,
+	FIELDS_EXPORTS      = 1 << 7,
+	FIELDS_HASHES       = 1 << 8,
+	FIELDS_DETAILS      = 1 << 9,  ///< format specific information
+	FIELDS_CERTIFICATES = 1 << 10,
+	FIELDS_TLS          = 1 << 11,
+	FIELDS_LOADER       = 1 << 12,
+	FIELDS_STRINGS      = 1 << 13,
+	FIELDS_ANOMALIES    = 1 << 14,
+	FIELDS_ALL          = (1 << 15) - 1
+};
+
 /**
  * FileDetector - find info about binary file
  */
@@ -45,6 +71,8 @@ class FileDetector : private retdec::utils::NonCopyable
 		retdec::config::Config *fileConfig;                         ///< configuration of input file
 		std::shared_ptr<retdec::fileformat::FileFormat> fileParser; ///< parser of input file
 		retdec::fileformat::LoadFlags loadFlags;                    ///< load flags for configurable running
+		AnalysisFields fields;                                      ///< parts of information to compute
+		std::chrono::milliseconds timeBudget;                       ///< time for getAllInformation(), zero means unlimited
 		bool loaded;                                                ///< internal state of instance
 
 		/// @name Pure virtual detection methods
@@ -64,6 +92,8 @@ class FileDetector : private retdec::utils::NonCopyable
 		virtual ~FileDetector() = default;
 
 		void setConfigFile(retdec::config::Config &config);
+		void setAnalysisFields(AnalysisFields analysisFields);
+		void setTimeBudget(std::chrono::milliseconds budget);
 		void getAllInformation();
 		const retdec::fileformat::FileFormat* getFileParser() const;
 };
@@ -49,6 +49,11 @@ void serializeString(
 			serializeIfValueEmpty);
 }
 
+/**
+ * Size of buffered part of JSON document at which the part is written out
+ */
+const std::size_t FLUSH_SIZE = 0x10000;
+
 /**
  * Present information from simple getter
  * @param getter Instance of SimpleGetter class
@@ -1219,6 +1224,7 @@ void JsonPresentation::presentIterativeSubtitleStructure(
 		getter.getFlags(structIndex, i, flags, flagsDesc);
 		presentFlags(writer, "flags", flags, flagsDesc);
 		writer.EndObject();
+		flushBuffer(false);
 	}
 	if (!genArray)
 	{
@@ -1310,9 +1316,60 @@ void presentPeTimestamps(JsonPresentation::Writer& writer, FileInformation& file
 	writer.EndObject();
 }
 
-bool JsonPresentation::present()
+/**
+ * Write out buffered part of JSON document
+ * @param force If @c false, the part is written only if it is large enough
+ *
+ * Line breaks and indentation are emitted by writer only between tokens,
+ * so they can be dropped here when single-line document is requested.
+ */
+void JsonPresentation::flushBuffer(bool force) const
+{
+	if(!buffer || (!force && buffer->GetSize() < FLUSH_SIZE))
+	{
+		return;
+	}
+
+	std::string part(buffer->GetString(), buffer->GetSize());
+	buffer->Clear();
+
+	if(singleLine)
+	{
+		std::size_t length = 0;
+		for(char c : part)
+		{
+			if(c == '\n')
+			{
+				skipIndentation = true;
+			}
+			else if(!skipIndentation || c != ' ')
+			{
+				skipIndentation = false;
+				part[length++] = c;
+			}
+		}
+		part.resize(length);
+	}
+
+	if(output)
+	{
+		output->append(part);
+	}
+	else
+	{
+		Log::info() << part;
+	}
+}
+
+/**
+ * Write JSON document with information about file to the chosen output,
+ * the document is written out in parts as it is being created
+ */
+void JsonPresentation::writeDocument()
 {
 	rapidjson::StringBuffer sb;
+	buffer = &sb;
+	skipIndentation = false;
 	Writer writer(sb);
 	writer.StartObject();
 
@@ -1392,8 +1449,30 @@ bool JsonPresentation::present()
 	presentIterativeSubtitle(writer, StringsJsonGetter(fileinfo));
 
 	writer.EndObject();
-	Log::info() << sb.GetString() << std::endl;
+	flushBuffer(true);
+	buffer = nullptr;
+}
 
+/**
+ * Create JSON document with information about file
+ * @param oneLine @c true if the whole document should be on one line
+ * @return JSON document
+ */
+std::string JsonPresentation::getJson(bool oneLine)
+{
+	std::string result;
+	output = &result;
+	singleLine = oneLine;
+	writeDocument();
+	output = nullptr;
+	singleLine = false;
+	return result;
+}
+
+bool JsonPresentation::present()
+{
+	writeDocument();
+	Log::info() << std::endl;
 	return true;
 }
 
@@ -30,6 +30,13 @@ class JsonPresentation : public FilePresentation
 	private:
 		bool verbose;      ///< @c true - print all information about file
 		bool analysisTime; ///< @c true - print when the analysis was done
+		rapidjson::StringBuffer *buffer = nullptr; ///< not yet written out part of document
+		std::string *output = nullptr;             ///< output of document, standard output if @c nullptr
+		bool singleLine = false;                   ///< @c true - write document on one line
+		mutable bool skipIndentation = false;      ///< @c true - line break was just dropped
+
+		void flushBuffer(bool force) const;
+		void writeDocument();
 
 		/// @name Auxiliary presentation methods
 		/// @{
@@ -66,6 +73,7 @@ class JsonPresentation : public FilePresentation
 	public:
 		JsonPresentation(FileInformation &fileinfo_, bool verbose_, bool analysisTime_);
 
+		std::string getJson(bool oneLine = false);
 		virtual bool present() override;
 };
 
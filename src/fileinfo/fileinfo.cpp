@@ -4,14 +4,19 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <map>
+#include <mutex>
 #include <regex>
+#include <thread>
 
 #include <rapidjson/document.h>
 #include <llvm/Support/ErrorHandling.h>
 
 #include "retdec/utils/binary_path.h"
 #include "retdec/utils/conversion.h"
+#include "retdec/utils/filesystem.h"
 #include "retdec/utils/memory.h"
+#include "retdec/utils/parallel.h"
 #include "retdec/utils/io/log.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/time.h"
@@ -70,6 +75,8 @@ struct ProgParams
 	std::set<std::string> yaraCryptoPaths;
 	///< paths to YARA other rules
 	std::set<std::string> yaraOtherPaths;
+	///< parts of file scanned by YARA rules (empty means whole file)
+	std::set<std::string> yaraRegions;
 	std::size_t maxMemory = 0;
 	/// limit maximal memory to half of system RAM
 	bool maxMemoryHalfRAM = false;
@@ -79,6 +86,16 @@ struct ProgParams
 	LoadFlags loadFlags = LoadFlags::NONE;
 	/// flag whether to include analysis time into the output
 	bool analysisTime = false;
+	/// parts of information to compute and print
+	AnalysisFields fields = FIELDS_ALL;
+	/// directory or file with list of input files for batch mode
+	std::string batchInput;
+	/// number of threads in batch mode (0 means number of CPUs)
+	unsigned jobs = 0;
+	/// print results of batch mode as they are completed
+	bool unordered = false;
+	/// time budget for analysis of one file in milliseconds (0 means no limit)
+	std::size_t timeBudget = 0;
 
 	friend std::ostream& operator<<(std::ostream& os, const ProgParams& pp);
 };
@@ -100,6 +117,11 @@ std::ostream& operator<<(std::ostream& os, const ProgParams& pp)
 	os << "ep bytes count     : " << pp.epBytesCount << "\n";
 	os << "load flags         : " << pp.loadFlags << "\n";
 	os << "analysis time      : " << pp.analysisTime << "\n";
+	os << "analysis fields    : " << std::hex << pp.fields << std::dec << "\n";
+	os << "batch input        : " << pp.batchInput << "\n";
+	os << "jobs               : " << pp.jobs << "\n";
+	os << "unordered          : " << pp.unordered << "\n";
+	os << "time budget        : " << pp.timeBudget << "\n";
 
 	os << "yara malware rules : " << "\n";
 	for (auto& r : pp.yaraMalwarePaths)
@@ -110,10 +132,89 @@ std::ostream& operator<<(std::ostream& os, const ProgParams& pp)
 	os << "yara other rules   : " << "\n";
 	for (auto& r : pp.yaraOtherPaths)
 		os << "\t" << r << "\n";
+	os << "yara regions       : " << "\n";
+	for (auto& r : pp.yaraRegions)
+		os << "\t" << r << "\n";
 
 	return os;
 }
 
+/**
+ * Names of parts of information selectable by the --fields option
+ */
+const std::map<std::string, AnalysisFields> fieldNames =
+{
+	{"all", FIELDS_ALL},
+	{"compiler", FIELDS_COMPILER},
+	{"rich", FIELDS_RICH_HEADER},
+	{"overlay", FIELDS_OVERLAY},
+	{"pdb", FIELDS_PDB},
+	{"resources", FIELDS_RESOURCES},
+	{"manifest", FIELDS_MANIFEST},
+	{"imports", FIELDS_IMPORTS},
+	{"exports", FIELDS_EXPORTS},
+	{"hashes", FIELDS_HASHES},
+	{"details", FIELDS_DETAILS},
+	{"certificates", FIELDS_CERTIFICATES},
+	{"tls", FIELDS_TLS},
+	{"loader", FIELDS_LOADER},
+	{"strings", FIELDS_STRINGS},
+	{"anomalies", FIELDS_ANOMALIES}
+};
+
+/**
+ * Parse comma separated list of field names
+ * @param value List to parse
+ * @param fields Parsed fields
+ * @return @c true if all names are valid, @c false otherwise
+ */
+bool parseFields(const std::string &value, AnalysisFields &fields)
+{
+	unsigned result = FIELDS_NONE;
+
+	for(const auto &name : split(value))
+	{
+		auto it = fieldNames.find(name);
+		if(it == fieldNames.end())
+		{
+			return false;
+		}
+
+		result |= it->second;
+	}
+
+	fields = static_cast<AnalysisFields>(result);
+	return true;
+}
+
+/**
+ * Do not load parts of file which are not going to be presented
+ * @param params Parameters with selected fields and load flags to update
+ */
+void applyFieldsToLoadFlags(ProgParams &params)
+{
+	unsigned flags = params.loadFlags;
+
+	if(!(params.fields & FIELDS_HASHES))
+	{
+		flags |= LoadFlags::NO_FILE_HASHES | LoadFlags::NO_VERBOSE_HASHES;
+	}
+	if(!(params.fields & FIELDS_CERTIFICATES))
+	{
+		flags |= LoadFlags::NO_CERTIFICATES;
+	}
+	if(!(params.fields & FIELDS_ANOMALIES))
+	{
+		flags |= LoadFlags::NO_ANOMALIES;
+	}
+	if(!(params.fields & FIELDS_STRINGS))
+	{
+		flags &= ~LoadFlags::DETECT_STRINGS;
+	}
+
+	params.loadFlags = static_cast<LoadFlags>(flags);
+}
+
 /**
  * LLVM fatal error handler information
  */
@@ -190,6 +291,9 @@ void printHelp()
 				<< "                          and functions.\n"
 				<< "    --other=fileOrDir, -o=fileOrDir\n"
 				<< "                          Path to other YARA rules.\n"
+				<< "    --yara-regions=list   Scan only the selected parts of the file by rules from\n"
+				<< "                          this group (comma separated): overlay, resources or\n"
+				<< "                          names of sections. Whole file assumed if not specified.\n"
 				<< "\n"
 				<< "Options for specifying output format:\n"
 				<< "  From this group, only one option can be used. If no option is used, program\n"
@@ -204,6 +308,19 @@ void printHelp()
 				<< "                          Either all hashes or only file/verbose hashes.\n"
 				<< "                          All assumed if no argument specified.\n"
 				<< "    --ep-bytes=N          Number of bytes to load from entry point. (Default: " << EP_BYTES_SIZE << ")\n"
+				<< "    --bounded-memory      Load only the first " << BOUNDED_MEMORY_LOAD_LIMIT / (1024 * 1024) << " MiB of larger files. File hashes,\n"
+				<< "                          overlay size and overlay entropy are computed from the\n"
+				<< "                          whole file read in chunks, other information (e.g. YARA\n"
+				<< "                          regions, strings) only from the loaded part.\n"
+				<< "    --fields=list         Compute and print only the selected parts of information\n"
+				<< "                          (comma separated): all, compiler, rich, overlay, pdb,\n"
+				<< "                          resources, manifest, imports, exports, hashes, details,\n"
+				<< "                          certificates, tls, loader, strings, anomalies.\n"
+				<< "                          Basic information about the file is always printed.\n"
+				<< "                          All assumed if not specified.\n"
+				<< "    --time-budget=N       Stop computing further information about the file\n"
+				<< "                          after N milliseconds (0 means no limit). Skipped\n"
+				<< "                          information is reported by a warning.\n"
 				<< "\n"
 				<< "Other options for specifying output:\n"
 				<< "    --verbose, -v         Print more information about input file.\n"
@@ -227,7 +344,16 @@ void printHelp()
 				<< "\n"
 				<< "Options for specifying list of available DLLs:\n"
 				<< "    --dlls=filename\n"
-				<< "                          Load the list of present DLLs from the file.\n";
+				<< "                          Load the list of present DLLs from the file.\n"
+				<< "\n"
+				<< "Options for batch processing:\n"
+				<< "  Input file must not be specified in batch mode. Output is in JSON format,\n"
+				<< "  one document per line in the order of input files.\n"
+				<< "    --batch=dirOrFile     Analyze all files in the directory (recursively) or\n"
+				<< "                          all files listed in the file (one path per line).\n"
+				<< "    --jobs=N              Number of files analyzed in parallel.\n"
+				<< "                          (Default: number of CPUs)\n"
+				<< "    --unordered           Print results as soon as they are completed.\n";
 }
 
 std::string getParamOrDie(const std::vector<std::string> &argv, std::size_t &i)
@@ -438,8 +564,19 @@ bool doConfigString(
 		}
 	}
 
+	if (root.HasMember("fields"))
+	{
+		if (!root["fields"].IsString()
+				|| !parseFields(root["fields"].GetString(), params.fields))
+		{
+			Log::error() << Log::Error << "JSON config: \"fields\" has bad value!\n";
+			return false;
+		}
+	}
+
 	params.epBytesCount = retdec::serdes::deserializeUint64(root, "epBytes", params.epBytesCount);
 	params.maxMemory = retdec::serdes::deserializeUint64(root, "maxMemory", params.maxMemory);
+	params.timeBudget = retdec::serdes::deserializeUint64(root, "timeBudget", params.timeBudget);
 
 	return true;
 }
@@ -520,7 +657,7 @@ bool doParams(int argc, char **_argv, ProgParams &params)
 	std::set<std::string> withArgs = {
 			"malware", "m", "crypto", "C", "other", "o", "config",
 			"fileinfo-config", "c", "no-hashes", "max-memory", "ep-bytes",
-			"dlls"
+			"dlls", "fields", "batch", "jobs", "time-budget", "yara-regions"
 	};
 	for (int i = 1; i < argc; ++i)
 	{
@@ -641,6 +778,13 @@ bool doParams(int argc, char **_argv, ProgParams &params)
 		{
 			params.yaraOtherPaths.insert(getParamOrDie(argv, i));
 		}
+		else if (c == "--yara-regions")
+		{
+			for (const auto& name : split(getParamOrDie(argv, i)))
+			{
+				params.yaraRegions.insert(name);
+			}
+		}
 		else if (c == "--max-memory")
 		{
 			auto maxMemoryString = getParamOrDie(argv, i);
@@ -653,6 +797,11 @@ bool doParams(int argc, char **_argv, ProgParams &params)
 		{
 			params.maxMemoryHalfRAM = true;
 		}
+		else if (c == "--bounded-memory")
+		{
+			params.loadFlags = static_cast<LoadFlags>(params.loadFlags
+					| LoadFlags::BOUNDED_MEMORY);
+		}
 		else if (c == "--no-hashes")
 		{
 			std::string value;
@@ -691,6 +840,29 @@ bool doParams(int argc, char **_argv, ProgParams &params)
 			if (!strToNum(epBytesCountString, params.epBytesCount))
 				return false;
 		}
+		else if (c == "--fields")
+		{
+			if (!parseFields(getParamOrDie(argv, i), params.fields))
+				return false;
+		}
+		else if (c == "--batch")
+		{
+			params.batchInput = getParamOrDie(argv, i);
+		}
+		else if (c == "--jobs")
+		{
+			if (!strToNum(getParamOrDie(argv, i), params.jobs))
+				return false;
+		}
+		else if (c == "--time-budget")
+		{
+			if (!strToNum(getParamOrDie(argv, i), params.timeBudget))
+				return false;
+		}
+		else if (c == "--unordered")
+		{
+			params.unordered = true;
+		}
 		else if (c == "--dlls")
 		{
 			auto dllListFile = getParamOrDie(argv, i);
@@ -707,11 +879,16 @@ bool doParams(int argc, char **_argv, ProgParams &params)
 		}
 	}
 
-	if(params.filePath.empty())
+	if(params.batchInput.empty() == params.filePath.empty())
+	{
+		return false;
+	}
+	if(!params.batchInput.empty() && params.generateConfigFile)
 	{
 		return false;
 	}
 
+	applyFieldsToLoadFlags(params);
 	return true;
 }
 
@@ -733,60 +910,27 @@ void limitMaximalMemoryIfRequested(const ProgParams& params)
 	}
 }
 
-} // anonymous namespace
-
 /**
- * Main function
- * @param argc Number of parameters
- * @param argv Vector of parameters
- * @return Program status
+ * Get all information about one input file
+ * @param params Program parameters
+ * @param filePath Path to input file
+ * @param fileinfo Instance for storing information about input file
+ * @param config Config of input file or @c nullptr if it is not used
+ * @return Detector which was used for the analysis. It must outlive
+ *    @a fileinfo presentation because @a fileinfo refers to its data.
  */
-int main(int argc, char* argv[])
+std::unique_ptr<FileDetector> analyzeFile(
+		const ProgParams& params,
+		const std::string& filePath,
+		FileInformation& fileinfo,
+		retdec::config::Config* config)
 {
-	ProgParams params;
-	if(!doConfigFile(params))
-	{
-		Log::error() << getErrorMessage(ReturnCode::ARG) << "\n\n";
-		printHelp();
-		return static_cast<int>(ReturnCode::ARG);
-	}
-
-	if(!doParams(argc, argv, params))
-	{
-		Log::error() << getErrorMessage(ReturnCode::ARG) << "\n\n";
-		printHelp();
-		return static_cast<int>(ReturnCode::ARG);
-	}
-
-	limitMaximalMemoryIfRequested(params);
-
-	bool useConfig = true;
-	retdec::config::Config config;
-	if(params.generateConfigFile && !params.configFile.empty())
-	{
-		try
-		{
-			config.readJsonFile(params.configFile);
-		}
-		catch (const retdec::config::FileNotFoundException&)
-		{
-			useConfig = false;
-		}
-		catch (const retdec::config::ParseException&)
-		{
-			useConfig = false;
-		}
-	}
-
 	DetectParams searchPar(params.searchMode, params.internalDatabase, params.externalDatabase, params.epBytesCount);
-	const auto fileFormat = detectFileFormat(params.filePath, useConfig && config.fileFormat.isRaw());
-	FileInformation fileinfo;
-	FileDetector *fileDetector = nullptr;
-	fileinfo.setPathToFile(params.filePath);
+	const auto fileFormat = detectFileFormat(filePath, config && config->fileFormat.isRaw());
+	std::unique_ptr<FileDetector> fileDetector;
+	fileinfo.setPathToFile(filePath);
 	fileinfo.setAnalysisTime(timestampToDate(getCurrentTimestamp()));
 	fileinfo.setFileFormatEnum(fileFormat);
-	ErrorHandlerInfo hInfo { &params, &fileinfo };
-	llvm::install_fatal_error_handler(fatalErrorHandler, &hInfo);
 	switch(fileFormat)
 	{
 		case Format::UNDETECTABLE:
@@ -796,7 +940,7 @@ int main(int argc, char* argv[])
 		}
 		default:
 		{
-			fileDetector = createFileDetector(params.filePath, params.dllListFile, fileFormat, fileinfo, searchPar, params.loadFlags);
+			fileDetector.reset(createFileDetector(filePath, params.dllListFile, fileFormat, fileinfo, searchPar, params.loadFlags));
 			if(fileDetector)
 			{
 				if(!fileDetector->getFileParser()->isInValidState())
@@ -804,7 +948,7 @@ int main(int argc, char* argv[])
 					// Check if Mach-O is archive.
 					if (fileFormat == Format::MACHO)
 					{
-						auto machoDetecor = static_cast<MachODetector*>(fileDetector);
+						auto machoDetecor = static_cast<MachODetector*>(fileDetector.get());
 						if (machoDetecor->isMachoUniversalArchive())
 						{
 							fileinfo.setStatus(ReturnCode::MACHO_AR_DETECTED);
@@ -816,15 +960,17 @@ int main(int argc, char* argv[])
 					break;
 				}
 
-				if(useConfig)
+				if(config)
 				{
-					fileDetector->setConfigFile(config);
+					fileDetector->setConfigFile(*config);
 				}
+				fileDetector->setAnalysisFields(params.fields);
+				fileDetector->setTimeBudget(std::chrono::milliseconds(params.timeBudget));
 				fileDetector->getAllInformation();
 			}
 			else
 			{
-				if(isArchive(params.filePath))
+				if(isArchive(filePath))
 				{
 					fileinfo.setStatus(ReturnCode::ARCHIVE_DETECTED);
 				}
@@ -837,10 +983,170 @@ int main(int argc, char* argv[])
 			patternDetector.addFilePaths("malware", params.yaraMalwarePaths);
 			patternDetector.addFilePaths("crypto", params.yaraCryptoPaths);
 			patternDetector.addFilePaths("other", params.yaraOtherPaths);
+			patternDetector.setRegions(params.yaraRegions);
 			patternDetector.analyze();
 		}
 	}
 
+	return fileDetector;
+}
+
+/**
+ * Get input files of batch mode
+ * @param batchInput Directory with input files or file with list of them
+ * @param files Paths to input files
+ * @return @c true on success, @c false otherwise
+ */
+bool getBatchFiles(const std::string& batchInput, std::vector<std::string>& files)
+{
+	std::error_code ec;
+	if (fs::is_directory(batchInput, ec))
+	{
+		for (fs::recursive_directory_iterator it(batchInput, ec), end;
+				!ec && it != end;
+				it.increment(ec))
+		{
+			if (fs::is_regular_file(it->path(), ec))
+			{
+				files.push_back(it->path().string());
+			}
+		}
+		std::sort(files.begin(), files.end());
+		return !ec;
+	}
+
+	std::ifstream list(batchInput);
+	if (!list)
+	{
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(list, line))
+	{
+		line = trim(line);
+		if (!line.empty())
+		{
+			files.push_back(line);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Analyze all input files of batch mode in parallel and print results in
+ * JSON format, one document per line
+ * @param params Program parameters
+ * @return Program status
+ */
+ReturnCode processBatch(const ProgParams& params)
+{
+	std::vector<std::string> files;
+	if (!getBatchFiles(params.batchInput, files))
+	{
+		return ReturnCode::FILE_NOT_EXIST;
+	}
+
+	std::mutex outputMutex;
+	std::map<std::size_t, std::string> pendingOutputs;
+	std::size_t nextOutput = 0;
+	const unsigned jobs = params.jobs
+			? params.jobs
+			: std::max(1u, std::thread::hardware_concurrency());
+
+	parallelFor(files.size(), jobs, [&](std::size_t i)
+	{
+		std::string output;
+		{
+			FileInformation fileinfo;
+			retdec::config::Config config;
+			auto fileDetector = analyzeFile(params, files[i], fileinfo, &config);
+			output = JsonPresentation(fileinfo, params.verbose, params.analysisTime).getJson(true);
+		}
+
+		std::lock_guard<std::mutex> lock(outputMutex);
+		if (params.unordered)
+		{
+			Log::info() << output << "\n";
+			return;
+		}
+
+		// Files are taken in order, so only outputs of files which are
+		// still being analyzed by other threads wait here.
+		pendingOutputs.emplace(i, std::move(output));
+		for (auto it = pendingOutputs.find(nextOutput);
+				it != pendingOutputs.end();
+				it = pendingOutputs.find(++nextOutput))
+		{
+			Log::info() << it->second << "\n";
+			pendingOutputs.erase(it);
+		}
+	});
+
+	Log::info() << std::flush;
+	return ReturnCode::OK;
+}
+
+} // anonymous namespace
+
+/**
+ * Main function
+ * @param argc Number of parameters
+ * @param argv Vector of parameters
+ * @return Program status
+ */
+int main(int argc, char* argv[])
+{
+	ProgParams params;
+	if(!doConfigFile(params))
+	{
+		Log::error() << getErrorMessage(ReturnCode::ARG) << "\n\n";
+		printHelp();
+		return static_cast<int>(ReturnCode::ARG);
+	}
+
+	if(!doParams(argc, argv, params))
+	{
+		Log::error() << getErrorMessage(ReturnCode::ARG) << "\n\n";
+		printHelp();
+		return static_cast<int>(ReturnCode::ARG);
+	}
+
+	limitMaximalMemoryIfRequested(params);
+
+	if(!params.batchInput.empty())
+	{
+		return static_cast<int>(processBatch(params));
+	}
+
+	bool useConfig = true;
+	retdec::config::Config config;
+	if(params.generateConfigFile && !params.configFile.empty())
+	{
+		try
+		{
+			config.readJsonFile(params.configFile);
+		}
+		catch (const retdec::config::FileNotFoundException&)
+		{
+			useConfig = false;
+		}
+		catch (const retdec::config::ParseException&)
+		{
+			useConfig = false;
+		}
+	}
+
+	FileInformation fileinfo;
+	ErrorHandlerInfo hInfo { &params, &fileinfo };
+	llvm::install_fatal_error_handler(fatalErrorHandler, &hInfo);
+	std::unique_ptr<FileDetector> fileDetector = analyzeFile(
+			params,
+			params.filePath,
+			fileinfo,
+			useConfig ? &config : nullptr);
+
 	// print results on standard output
 	if(params.plainText)
 	{
@@ -863,6 +1169,5 @@ int main(int argc, char* argv[])
 		}
 	}
 
-	delete fileDetector;
 	return isFatalError(res) ? static_cast<int>(res) : static_cast<int>(ReturnCode::OK);
 }
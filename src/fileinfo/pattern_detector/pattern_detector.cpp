@@ -4,6 +4,7 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <regex>
 
 #include "retdec/utils/conversion.h"
@@ -331,39 +332,132 @@ void PatternDetector::addFilePaths(const std::string &category, const std::set<s
 	}
 }
 
+/**
+ * Restrict analysis to selected parts of input file
+ * @param names Names of parts to scan. Supported names are @c overlay,
+ *    @c resources and names of sections. Empty set means whole file.
+ */
+void PatternDetector::setRegions(const std::set<std::string> &names)
+{
+	regions = names;
+}
+
+/**
+ * Get file ranges of selected parts of input file
+ * @return Sorted and disjoint pairs of file offset and size
+ */
+std::vector<std::pair<std::size_t, std::size_t>> PatternDetector::getRegionRanges() const
+{
+	std::vector<std::pair<std::size_t, std::size_t>> ranges;
+	if(!fileParser || !fileParser->isInValidState())
+	{
+		return ranges;
+	}
+
+	const auto fileSize = fileParser->getBytes().size();
+	const auto addRange = [&](std::size_t offset, std::size_t size)
+	{
+		if(offset < fileSize && size)
+		{
+			ranges.emplace_back(offset, std::min(size, fileSize - offset));
+		}
+	};
+
+	if(regions.count("overlay"))
+	{
+		addRange(fileParser->getDeclaredFileLength(), fileParser->getOverlaySize());
+	}
+	if(regions.count("resources") && fileParser->getResourceTable())
+	{
+		for(const auto &res : *fileParser->getResourceTable())
+		{
+			addRange(res->getOffset(), res->getSizeInFile());
+		}
+	}
+	for(const auto *sec : fileParser->getSections())
+	{
+		if(sec && regions.count(sec->getName()))
+		{
+			addRange(sec->getOffset(), sec->getSizeInFile());
+		}
+	}
+
+	// Overlapping parts (e.g. resources inside of their section) must not
+	// be scanned twice, otherwise their matches would be reported twice.
+	std::sort(ranges.begin(), ranges.end());
+	std::vector<std::pair<std::size_t, std::size_t>> merged;
+	for(const auto &range : ranges)
+	{
+		if(!merged.empty() && range.first <= merged.back().first + merged.back().second)
+		{
+			auto &last = merged.back();
+			last.second = std::max(last.second, range.first + range.second - last.first);
+		}
+		else
+		{
+			merged.push_back(range);
+		}
+	}
+
+	return merged;
+}
+
 /**
  * Analyze input file and try to find YARA patterns
+ *
+ * Rules of all categories are compiled together, each category into its own
+ * namespace, so input file is scanned only once.
  */
 void PatternDetector::analyze()
 {
+	YaraDetector yara;
 	for(const auto &category : categories)
 	{
-		YaraDetector yara;
-
 		for(const auto &item : category.second)
 		{
-			yara.addRuleFile(item);
+			yara.addRuleFile(item, category.first);
 		}
+	}
 
-		yara.analyze(fileinfo.getPathToFile());
-
-		for(const auto &rule : yara.getDetectedRules())
+	if(!categories.empty())
+	{
+		if(regions.empty())
 		{
-			if(category.first == "crypto")
-			{
-				saveCryptoRule(rule);
-			}
-			else if(category.first == "malware")
+			yara.analyze(fileinfo.getPathToFile());
+		}
+		else
+		{
+			// Regions start at their file offsets, so offsets of matches
+			// are the same as if the whole file was scanned.
+			std::vector<YaraDetector::MemoryRegion> memoryRegions;
+			for(const auto &range : getRegionRanges())
 			{
-				saveMalwareRule(rule);
+				memoryRegions.push_back({range.first, fileParser->getBytes().data() + range.first, range.second});
 			}
-			else
+			if(!memoryRegions.empty())
 			{
-				saveOtherRule(rule);
+				yara.analyze(memoryRegions);
 			}
 		}
 	}
 
+	for(const auto &rule : yara.getDetectedRules())
+	{
+		const auto &category = rule.getNamespace();
+		if(category == "crypto")
+		{
+			saveCryptoRule(rule);
+		}
+		else if(category == "malware")
+		{
+			saveMalwareRule(rule);
+		}
+		else
+		{
+			saveOtherRule(rule);
+		}
+	}
+
 	fileinfo.removeRedundantCryptoRules();
 	fileinfo.sortCryptoPatternMatches();
 	fileinfo.sortMalwarePatternMatches();
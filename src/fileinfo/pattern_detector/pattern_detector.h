@@ -32,6 +32,7 @@ class PatternDetector
 		const retdec::fileformat::FileFormat *fileParser;                             ///< parser of input file
 		FileInformation &fileinfo;                                             ///< information about input file
 		std::vector<std::pair<std::string, std::set<std::string>>> categories; ///< paths to YARA rules
+		std::set<std::string> regions;                                         ///< names of scanned parts of file
 
 		/// @name Iterators
 		/// @{
@@ -45,6 +46,7 @@ class PatternDetector
 		void saveCryptoRule(const yaracpp::YaraRule &rule);
 		void saveMalwareRule(const yaracpp::YaraRule &rule);
 		void saveOtherRule(const yaracpp::YaraRule &rule);
+		std::vector<std::pair<std::size_t, std::size_t>> getRegionRanges() const;
 		/// @}
 	public:
 		PatternDetector(const retdec::fileformat::FileFormat *fparser, FileInformation &finfo);
@@ -52,6 +54,7 @@ class PatternDetector
 		/// @name Detection methods
 		/// @{
 		void addFilePaths(const std::string &category, const std::set<std::string> &paths);
+		void setRegions(const std::set<std::string> &names);
 		void analyze();
 		/// @}
 };
@@ -4,11 +4,14 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <cctype>
+#include <thread>
 #include <vector>
 
 #include "retdec/fileformat/format_factory.h"
 #include "retdec/utils/conversion.h"
+#include "retdec/utils/parallel.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/io/log.h"
 #include "retdec/utils/version.h"
@@ -57,6 +60,9 @@ void printUsage()
 	"  -o --offset OFFSET\n"
 	"    Specify starting offset for signature creation. OFFSET must be\n"
 	"    hexadecimal number. Default value is entry point offset.\n\n"
+	"  -j --jobs NUMBER\n"
+	"    Number of files parsed in parallel. Default value is the number\n"
+	"    of hardware threads. Output does not depend on this number.\n\n"
 	"Output options:\n"
 	"  -a --add FILENAME, \n"
 	"    Append signature to FILENAME file.\n\n";
@@ -86,6 +92,7 @@ struct Options
 		long long unsigned size = 100; ///< maximum size of pattern (bytes)
 		std::uint64_t offset;     ///< value of search offset
 		bool isOffset = false;         ///< @c true if user provided offset
+		unsigned jobs = 0;             ///< number of parsing threads (0 = auto)
 };
 
 /**
@@ -162,6 +169,7 @@ bool doParams(
 		"s",    "size",
 		"o",    "offset",
 		"a",    "add",
+		"j",    "jobs",
 		"source"
 	};
 
@@ -235,6 +243,14 @@ bool doParams(
 				return false;
 			}
 		}
+		else if (c == "-j" || c == "--jobs")
+		{
+			const auto arg = getParamOrDie(argv, i);
+			if (!strToNum(arg, options.jobs) || options.jobs < 1)
+			{
+				return false;
+			}
+		}
 		else if (c == "-r" || c == "--rule-name")
 		{
 			options.rule = getParamOrDie(argv, i);
@@ -273,72 +289,105 @@ bool doParams(
 }
 
 /**
- * Get length of shortest string in given vector.
- * @param inputs vector of strings
- * @return length of shortest string or 0
+ * Data collected from one input file.
+ */
+struct Sample
+{
+	bool parsed = false;             ///< @c true if file format was recognized
+	Format format = Format::UNKNOWN; ///< format of file
+	std::string content;             ///< hex bytes at search offset
+	std::string problem;             ///< reason for skipping the file
+};
+
+/**
+ * Parse file and collect its bytes at search offset.
+ * @param path path to file
+ * @param options application options
+ * @return collected data, @c problem is set if data are unusable
  *
- * If input vector is empty, function returns 0.
+ * The parser is destroyed before returning, so only the (short) content of
+ * each file is kept in memory. The function may be called from several
+ * threads at once.
  */
-std::size_t getShortestLength(
-		const std::vector<std::string> &inputs)
+Sample parseSample(
+		const std::string& path,
+		const Options& options)
 {
-	if (inputs.empty())
+	Sample sample;
+
+	auto fileParser = createFileFormat(path);
+	if (!fileParser)
 	{
-		return 0;
+		sample.problem = "invalid file";
+		return sample;
 	}
+	sample.parsed = true;
+	sample.format = fileParser->getFileFormat();
 
-	auto min = std::numeric_limits<std::size_t>::max();
-	for (const auto& input :inputs)
+	auto offset = options.offset;
+	if (!options.isOffset && !fileParser->getEpOffset(offset))
 	{
-		const auto& length = input.length();
-		if (length < min)
-		{
-			min = length;
-		}
+		sample.problem = "EP problem";
+	}
+	else if (!fileParser->getHexBytes(sample.content, offset, options.size))
+	{
+		sample.problem = "data problem";
 	}
 
-	return min;
+	return sample;
 }
 
 /**
- * Creates signature pattern from vector of strings
- * @param contents Vector of bytes from files
- * @return created signature
+ * Fold content of one more file into signature pattern.
+ * @param pattern pattern of previously folded files (empty for first file)
+ * @param content hex bytes of file
+ * @param first @c true if @a content is from the first file
+ *
+ * Pattern is shortened to the shorter of both strings and nibbles which
+ * differ are replaced by '?'.
  */
-std::string createSignature(const std::vector<std::string> &contents)
+void foldIntoSignature(
+		std::string& pattern,
+		const std::string& content,
+		bool first)
 {
-	const auto length = getShortestLength(contents);
-	if (!length)
+	if (first)
 	{
-		// No data are available.
-		return std::string();
+		pattern = content;
+		return;
 	}
 
-	std::string pattern;
-	for (std::size_t i = 0; i < length; ++i)
+	if (content.length() < pattern.length())
 	{
-		bool insignificant = false;
-		for (std::size_t j = 1, f = contents.size(); j < f; ++j)
+		pattern.resize(content.length());
+	}
+
+	for (std::size_t i = 0, e = pattern.length(); i < e; ++i)
+	{
+		if (pattern[i] != content[i])
 		{
-			if (contents[0][i] != contents[j][i])
-			{
-				insignificant = true;
-				break;
-			}
+			pattern[i] = '?';
 		}
-
-		// Add nibble or '?' if nibbles differ.
-		pattern += !insignificant ? contents[0][i] : '?';
 	}
+}
 
-	// Remove trailing insignificant nibbles.
-	std::size_t index = length - 1;
-	while (index > 0 && pattern[index] == '?')
+/**
+ * Finish signature pattern created by @c foldIntoSignature().
+ * @param pattern folded pattern
+ * @return created signature
+ */
+std::string finishSignature(std::string pattern)
+{
+	if (pattern.empty())
 	{
-		pattern.erase(index, 1);
-		--index;
+		// No data are available.
+		return std::string();
 	}
 
+	// Remove trailing insignificant nibbles.
+	auto last = pattern.find_last_not_of('?');
+	pattern.resize(last == std::string::npos ? 1 : last + 1);
+
 	// Pattern length has to be even number.
 	if (pattern.length() % 2)
 	{
@@ -463,56 +512,59 @@ int main(int argc, char** argv) {
 		return printError("invalid arguments");
 	}
 
+	// Files are parsed in parallel. Results are folded into signature in
+	// order of input files, so output is the same for any number of jobs.
+	const unsigned jobs = options.jobs
+			? options.jobs
+			: std::max(1u, std::thread::hardware_concurrency());
+	std::vector<Sample> samples(options.input.size());
+	parallelFor(samples.size(), jobs, [&](std::size_t i)
+	{
+		samples[i] = parseSample(options.input[i], options);
+	});
+
 	Format format = Format::UNKNOWN;
-	std::vector<std::string> contents;
-	for (const auto& path : options.input)
+	std::string pattern;
+	std::size_t folded = 0;
+	for (std::size_t i = 0; i < samples.size(); ++i)
 	{
-		auto fileParser = createFileFormat(path);
-		if (!fileParser)
+		const auto& path = options.input[i];
+		const auto& sample = samples[i];
+		if (!sample.parsed)
 		{
-			printWarning("skipping '" + path + "' - invalid file");
+			printWarning("skipping '" + path + "' - " + sample.problem);
 			continue;
 		}
 
 		// Format must be same for all files.
-		auto actualFormat = fileParser->getFileFormat();
 		if (format == Format::UNKNOWN)
 		{
 			// Set format from first file.
-			format = actualFormat;
+			format = sample.format;
 		}
-		if (format != actualFormat)
+		if (format != sample.format)
 		{
 			// Ignore files with other formats.
 			printWarning("skipping '" + path + "' - format mismatch");
 			continue;
 		}
 
-		if (!options.isOffset && !fileParser->getEpOffset(options.offset))
+		if (!sample.problem.empty())
 		{
-			printWarning("skipping '" + path + "' - EP problem");
+			printWarning("skipping '" + path + "' - " + sample.problem);
 			continue;
 		}
 
-		std::string content;
-		if (!fileParser->getHexBytes(content, options.offset, options.size))
-		{
-			printWarning("skipping '" + path + "' - data problem");
-			continue;
-		}
-		else
-		{
-			contents.push_back(content);
-		}
+		foldIntoSignature(pattern, sample.content, folded++ == 0);
 	}
 
-	if (contents.empty())
+	if (!folded)
 	{
 		return printError("no valid data collected");
 	}
 
 	// create signature
-	const auto signature = createSignature(contents);
+	const auto signature = finishSignature(pattern);
 	if (signature.empty())
 	{
 		return printError("no common data found for input files");
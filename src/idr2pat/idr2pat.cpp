@@ -4,7 +4,9 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <istream>
@@ -30,70 +32,142 @@ using namespace yaramod;
 using Relocation = std::pair<std::uint32_t, std::string>;
 
 /**
- * Get one WORD from input stream.
+ * Buffered reader of KB file.
  *
- * @param result where to store result
- * @param inputStream stream with correct position
- * @return @c true if value was read, @c false otherwise
+ * KB is read in large chunks instead of by single values. Seeks inside the
+ * current chunk (functions are usually stored one after another) do not
+ * touch the underlying stream at all.
  */
-bool getWord(
-		std::uint16_t &result,
-		std::ifstream &inputStream)
+class KbReader
 {
-	inputStream.read(reinterpret_cast<char*>(&result), sizeof(std::uint16_t));
-	return inputStream.good();
-}
+	public:
+		KbReader(std::istream &inputStream, std::size_t capacity = 1 << 20)
+			: _inputStream(inputStream), _buffer(capacity) {}
+
+		/**
+		 * Move to absolute position @a pos and reset error state.
+		 */
+		void seek(std::uint64_t pos)
+		{
+			_good = true;
+			if (pos >= _bufferStart && pos <= _bufferStart + _bufferSize) {
+				_cursor = pos - _bufferStart;
+			}
+			else {
+				_bufferStart = pos;
+				_bufferSize = 0;
+				_cursor = 0;
+			}
+		}
 
-/**
- * Get one DWORD from input stream.
- *
- * @param result where to store result
- * @param inputStream stream with correct position
- * @return @c true if value was read, @c false otherwise
- */
-bool getDword(
-		std::uint32_t &result,
-		std::ifstream &inputStream)
-{
-	inputStream.read(reinterpret_cast<char*>(&result), sizeof(std::uint32_t));
-	return inputStream.good();
-}
+		/**
+		 * Move to position @a offset bytes before the end of file.
+		 */
+		void seekFromEnd(std::uint64_t offset)
+		{
+			_inputStream.clear();
+			_inputStream.seekg(0, std::ios_base::end);
+			const std::uint64_t size = _inputStream.tellg();
+			seek(size >= offset ? size - offset : 0);
+		}
 
-/**
- * Get zero terminated string with size information from input stream.
- *
- * @param result where to store result
- * @param inputStream stream with correct position
- * @return @c true if value was read, @c false otherwise
- */
-bool getString(
-		std::string &result,
-		std::ifstream &inputStream)
-{
-	std::uint16_t size = 0;
-	if (!getWord(size, inputStream)) {
-		return false;
-	}
+		/**
+		 * Skip @a n bytes at actual position.
+		 */
+		void skip(std::size_t n)
+		{
+			seek(position() + n);
+		}
 
-	result.resize(size);
-	inputStream.read(&result[0], size);
+		std::uint64_t position() const
+		{
+			return _bufferStart + _cursor;
+		}
 
-	inputStream.get(); // Eat terminating character.
-	return inputStream.good();
-}
+		/**
+		 * Read @a n bytes to @a result.
+		 *
+		 * @return @c true if all bytes were read, @c false otherwise
+		 */
+		bool read(void *result, std::size_t n)
+		{
+			auto *out = static_cast<char*>(result);
+			while (n && _good) {
+				if (_cursor == _bufferSize && !fill()) {
+					_good = false;
+					break;
+				}
+
+				const auto chunk = std::min(n, _bufferSize - _cursor);
+				std::memcpy(out, &_buffer[_cursor], chunk);
+				_cursor += chunk;
+				out += chunk;
+				n -= chunk;
+			}
+
+			return _good;
+		}
 
-/**
- * Skip N bytes in input stream at actual position.
- *
- * @param N number of bytes to skip
- * @param inputStream stream with correct position
- */
-void skip(
-		const std::size_t &N,
-		std::ifstream &inputStream)
-{
-	inputStream.seekg(inputStream.tellg() + std::istream::pos_type(N));
-}
+		bool getWord(std::uint16_t &result)
+		{
+			return read(&result, sizeof(result));
+		}
+
+		bool getDword(std::uint32_t &result)
+		{
+			return read(&result, sizeof(result));
+		}
+
+		/**
+		 * Get zero terminated string with size information.
+		 */
+		bool getString(std::string &result)
+		{
+			std::uint16_t size = 0;
+			if (!getWord(size)) {
+				return false;
+			}
+
+			result.resize(size);
+			if (size && !read(&result[0], size)) {
+				return false;
+			}
+
+			char terminator;
+			return read(&terminator, 1);
+		}
+
+		/**
+		 * @return @c false if any read since the last seek failed
+		 */
+		explicit operator bool() const
+		{
+			return _good;
+		}
+
+	private:
+		/**
+		 * Load the next chunk of file (from actual position).
+		 */
+		bool fill()
+		{
+			_bufferStart = position();
+			_cursor = 0;
+			_inputStream.clear();
+			_inputStream.seekg(_bufferStart);
+			_inputStream.read(_buffer.data(), _buffer.size());
+			_bufferSize = _inputStream.gcount();
+			return _bufferSize > 0;
+		}
+
+	private:
+		std::istream &_inputStream;
+		std::vector<char> _buffer;
+		std::uint64_t _bufferStart = 0; ///< file offset of buffer
+		std::size_t _bufferSize = 0;    ///< number of valid bytes in buffer
+		std::size_t _cursor = 0;        ///< position in buffer
+		bool _good = true;
+};
 
 /**
  * Get string from relocations.
@@ -122,37 +196,37 @@ std::string getRelocationsAsString(
 /**
  * Read one function or procedure from KB.
  *
- * @param inputStream stream with correct position
+ * @param reader reader with correct position
  * @param index index of function
  */
 void readFunction(
-		std::ifstream &inputStream,
+		KbReader &reader,
 		const std::size_t &index)
 {
 	// Skip (for now) unused fields.
-	skip(2, inputStream);
+	reader.skip(2);
 
 	// Read function name.
 	std::string name;
-	getString(name, inputStream);
+	reader.getString(name);
 
 	// Skip (for now) unused fields.
-	skip(8, inputStream);
+	reader.skip(8);
 
 	// Skip (for now) unused string.
 	std::string returnType;
-	getString(returnType, inputStream);
+	reader.getString(returnType);
 
 	// Skip (for now) unused fields.
-	skip(4, inputStream);
+	reader.skip(4);
 
 	// Read dump size.
 	std::uint32_t size = 0;
-	getDword(size, inputStream);
+	reader.getDword(size);
 
 	// Read number of fix-ups.
 	std::uint32_t fixCount = 0;
-	getDword(fixCount, inputStream);
+	reader.getDword(fixCount);
 
 	// Skip empty names and dumps.
 	if (!size || name.empty()) {
@@ -161,20 +235,20 @@ void readFunction(
 
 	// Read dump and relocation map (same size).
 	std::vector<std::uint8_t> dump(size);
-	inputStream.read(reinterpret_cast<char*>(&dump[0]), size);
+	reader.read(dump.data(), size);
 	std::vector<std::uint8_t> relocationMap(size);
-	inputStream.read(reinterpret_cast<char*>(&relocationMap[0]), size);
+	reader.read(relocationMap.data(), size);
 
 	// Read relocations.
 	std::set<std::string> usedNames;
 	std::vector<Relocation> relocations;
 	for (std::size_t i = 0; i < fixCount; ++i) {
 		// Skip (for now) unused fields.
-		skip(1, inputStream);
+		reader.skip(1);
 
 		// Read offset and check for position validity.
 		std::uint32_t fixOffset = 0;
-		getDword(fixOffset, inputStream);
+		reader.getDword(fixOffset);
 		if (fixOffset >= size) {
 			// This happens sometimes - safe to ignore.
 			continue;
@@ -182,7 +256,7 @@ void readFunction(
 
 		// Read name and check for duplicates.
 		std::string fixName;
-		getString(fixName, inputStream);
+		reader.getString(fixName);
 		// Create relocation and remember name.
 		const auto& [_, inserted] = usedNames.insert(fixName);
 		if (inserted) {
@@ -191,7 +265,7 @@ void readFunction(
 	}
 
 	// Check buffer state before writing rule.
-	if (!inputStream) {
+	if (!reader) {
 		return;
 	}
 
@@ -226,68 +300,67 @@ void readFunction(
 /**
  * Read database and print function rules.
  *
- * @param inputStream source input stream
+ * @param reader source reader
  * @param errorMessage possible error message if @c false is returned
  * @return @c true if information was read correctly, @c false otherwise
  */
 bool readDatabase(
-		std::ifstream &inputStream,
+		KbReader &reader,
 		std::string &errorMessage)
 {
 	// Position of section offsets - last 4 bytes.
-	inputStream.seekg(-4, std::ios_base::end);
+	reader.seekFromEnd(4);
 
 	// Read entry point position.
 	std::uint32_t entryPoint;
-	getDword(entryPoint, inputStream);
+	reader.getDword(entryPoint);
 
-	// Reset eof bit and go to the entry point.
-	inputStream.clear();
-	inputStream.seekg(entryPoint);
+	// Go to the entry point.
+	reader.seek(entryPoint);
 
 	// Skip (for now) unused fields.
 	std::uint32_t toSkip;
 	// Module definitions.
-	getDword(toSkip, inputStream);
-	skip(toSkip * 16 + 4, inputStream);
+	reader.getDword(toSkip);
+	reader.skip(toSkip * 16 + 4);
 	// Constants definitions.
-	getDword(toSkip, inputStream);
-	skip(toSkip * 16 + 4, inputStream);
+	reader.getDword(toSkip);
+	reader.skip(toSkip * 16 + 4);
 	// Types definitions.
-	getDword(toSkip, inputStream);
-	skip(toSkip * 16 + 4, inputStream);
+	reader.getDword(toSkip);
+	reader.skip(toSkip * 16 + 4);
 	// Variables definitions.
-	getDword(toSkip, inputStream);
-	skip(toSkip * 16 + 4, inputStream);
+	reader.getDword(toSkip);
+	reader.skip(toSkip * 16 + 4);
 	// String definitions.
-	getDword(toSkip, inputStream);
-	skip(toSkip * 16 + 4, inputStream);
+	reader.getDword(toSkip);
+	reader.skip(toSkip * 16 + 4);
 
 	// Read function offsets.
 	std::uint32_t functionCount;
-	getDword(functionCount, inputStream);
+	reader.getDword(functionCount);
 
 	// Skip (for now) unused fields.
-	skip(4, inputStream);
+	reader.skip(4);
 
 	// Read function offsets.
 	std::vector<std::uint32_t> functionOffsets(functionCount);
 	for (std::size_t i = 0; i < functionCount; ++i) {
-		getDword(functionOffsets[i], inputStream);
-		skip(12, inputStream);
+		reader.getDword(functionOffsets[i]);
+		reader.skip(12);
 	}
 
 	// Check buffer.
-	if (!inputStream) {
+	if (!reader) {
 		errorMessage = "could not read function offsets";
 		return false;
 	}
 
-	// Read functions.
+	// Read functions. Each rule is printed as soon as its function is read.
 	std::size_t functionIndex = 0;
 	for (const auto &offset : functionOffsets) {
-		inputStream.seekg(offset);
-		readFunction(inputStream, functionIndex++);
+		reader.seek(offset);
+		readFunction(reader, functionIndex++);
 	}
 
 	return true;
@@ -321,14 +394,15 @@ int main(int argc, char** argv)
 		return printError("could not open input file");
 	}
 
+	KbReader reader(inputFile);
 	char magic[25] = {};
-	inputFile.read(magic, 24);
+	reader.read(magic, 24);
 	if (std::string(magic) != "IDR Knowledge Base File") {
 		return printError("file is not IDR database file");
 	}
 
 	std::string errorMessage;
-	if (!readDatabase(inputFile, errorMessage)) {
+	if (!readDatabase(reader, errorMessage)) {
 		return printError(errorMessage);
 	}
 
@@ -2221,7 +2221,7 @@ void GlobalExecutionContext::setMemory(
 		memoryStores.push_back(addr);
 	}
 
-	memory[addr] = val;
+	memory[addr] = std::move(val);
 }
 
 llvm::GenericValue GlobalExecutionContext::getGlobal(
@@ -2248,12 +2248,12 @@ void GlobalExecutionContext::setGlobal(
 		globalsStores.push_back(g);
 	}
 
-	globals[g] = val;
+	globals[g] = std::move(val);
 }
 
 void GlobalExecutionContext::setValue(llvm::Value* v, llvm::GenericValue val)
 {
-	values[v] = val;
+	values[v] = std::move(val);
 }
 
 llvm::GenericValue GlobalExecutionContext::getOperandValue(
@@ -2358,6 +2358,87 @@ llvm::GenericValue LlvmIrEmulator::runFunction(
 	return _exitValue;
 }
 
+LlvmIrEmulator::Snapshot::Snapshot(const LlvmIrEmulator& emu) :
+		_globalEc(emu._globalEc),
+		_exitValue(emu._exitValue),
+		_visitedInsns(emu._visitedInsns),
+		_visitedBbs(emu._visitedBbs),
+		_calls(emu._calls),
+		_ecStackRetiredSize(emu._ecStackRetired.size())
+{
+
+}
+
+/**
+ * Save the current state of the emulation. It can be taken only between
+ * emulations, i.e. not from inside of the emulated code.
+ */
+LlvmIrEmulator::Snapshot LlvmIrEmulator::saveSnapshot() const
+{
+	assert(_ecStack.empty());
+	return Snapshot(*this);
+}
+
+/**
+ * Restore the emulation state saved by @c saveSnapshot() of this emulator.
+ * Stack frames retired after the snapshot was taken are dropped, together
+ * with their allocas.
+ */
+void LlvmIrEmulator::restoreSnapshot(const Snapshot& s)
+{
+	assert(_ecStack.empty());
+
+	_globalEc = s._globalEc;
+	_exitValue = s._exitValue;
+	_visitedInsns = s._visitedInsns;
+	_visitedBbs = s._visitedBbs;
+	_calls = s._calls;
+	while (_ecStackRetired.size() > s._ecStackRetiredSize)
+	{
+		_ecStackRetired.pop_back();
+	}
+}
+
+/**
+ * Emulate function @a f once for every vector of arguments in @a argVals.
+ * Every emulation starts from the state the emulator was in when this was
+ * called, and the emulator is returned to that state at the end. The
+ * emulator is prepared only once for all of them, so this is much cheaper
+ * than creating a new emulator for every vector of arguments.
+ * @param f Function to emulate.
+ * @param argVals Arguments of the individual emulations.
+ * @param afterRun If set, it is called with the index of the emulation right
+ *        after it finishes, so that its results (globals, memory, calls,
+ *        ...) can be queried before they are thrown away.
+ * @return Exit values of the individual emulations.
+ */
+std::vector<llvm::GenericValue> LlvmIrEmulator::runFunctionBatch(
+		llvm::Function* f,
+		const std::vector<std::vector<llvm::GenericValue>>& argVals,
+		const std::function<void(std::size_t)>& afterRun)
+{
+	std::vector<GenericValue> ret;
+	ret.reserve(argVals.size());
+
+	auto initial = saveSnapshot();
+	for (std::size_t i = 0; i < argVals.size(); ++i)
+	{
+		if (i > 0)
+		{
+			restoreSnapshot(initial);
+		}
+
+		ret.push_back(runFunction(f, argVals[i]));
+		if (afterRun)
+		{
+			afterRun(i);
+		}
+	}
+	restoreSnapshot(initial);
+
+	return ret;
+}
+
 /**
  * Right now, this can not handle variadic functions. We probably will not
  * need them anyway, but if we did, it is handled in the LLVM interpreter.
@@ -2637,7 +2718,7 @@ void LlvmIrEmulator::popStackAndReturnValueToCaller(
 		llvm::Type* retT,
 		llvm::GenericValue res)
 {
-	_ecStackRetired.emplace_back(_ecStack.back());
+	_ecStackRetired.emplace_back(std::move(_ecStack.back()));
 	_ecStack.pop_back();
 
 	// Finished main. Put result into exit code...
@@ -0,0 +1,546 @@
+/**
+* @file src/llvmir2hll/analysis/alias_analysis/alias_analyses/steensgaard_alias_analysis.cpp
+* @brief Implementation of SteensgaardAliasAnalysis.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "retdec/llvmir2hll/analysis/alias_analysis/alias_analyses/steensgaard_alias_analysis.h"
+#include "retdec/llvmir2hll/analysis/alias_analysis/alias_analysis_factory.h"
+#include "retdec/llvmir2hll/ir/add_op_expr.h"
+#include "retdec/llvmir2hll/ir/address_op_expr.h"
+#include "retdec/llvmir2hll/ir/array_index_op_expr.h"
+#include "retdec/llvmir2hll/ir/assign_op_expr.h"
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/call_expr.h"
+#include "retdec/llvmir2hll/ir/cast_expr.h"
+#include "retdec/llvmir2hll/ir/comma_op_expr.h"
+#include "retdec/llvmir2hll/ir/const_symbol.h"
+#include "retdec/llvmir2hll/ir/constant.h"
+#include "retdec/llvmir2hll/ir/deref_op_expr.h"
+#include "retdec/llvmir2hll/ir/for_loop_stmt.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/global_var_def.h"
+#include "retdec/llvmir2hll/ir/int_to_ptr_cast_expr.h"
+#include "retdec/llvmir2hll/ir/module.h"
+#include "retdec/llvmir2hll/ir/pointer_type.h"
+#include "retdec/llvmir2hll/ir/return_stmt.h"
+#include "retdec/llvmir2hll/ir/statement.h"
+#include "retdec/llvmir2hll/ir/struct_index_op_expr.h"
+#include "retdec/llvmir2hll/ir/sub_op_expr.h"
+#include "retdec/llvmir2hll/ir/ternary_op_expr.h"
+#include "retdec/llvmir2hll/ir/var_def_stmt.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
+#include "retdec/utils/container.h"
+
+using retdec::utils::addToSet;
+using retdec::utils::hasItem;
+
+namespace retdec {
+namespace llvmir2hll {
+
+REGISTER_AT_FACTORY("steensgaard", STEENSGAARD_ALIAS_ANALYSIS_ID,
+	AliasAnalysisFactory, SteensgaardAliasAnalysis::create);
+
+namespace {
+
+/// The empty set of variables.
+const VarSet EMPTY_VAR_SET = VarSet();
+
+/**
+* @brief Collects variables whose address is taken in initializers of global
+*        variables.
+*/
+class AddressedVarsCollector: private OrderedAllVisitor {
+public:
+	/**
+	* @brief Adds all variables whose address is taken in @a expr to @a vars.
+	*/
+	static void collect(ShPtr<Expression> expr, VarSet &vars) {
+		AddressedVarsCollector collector(vars);
+		expr->accept(&collector);
+	}
+
+private:
+	explicit AddressedVarsCollector(VarSet &vars):
+		OrderedAllVisitor(), vars(vars) {}
+
+	using OrderedAllVisitor::visit;
+	virtual void visit(ShPtr<AddressOpExpr> expr) override {
+		if (ShPtr<Variable> var = cast<Variable>(expr->getOperand())) {
+			vars.insert(var);
+		} else {
+			OrderedAllVisitor::visit(expr);
+		}
+	}
+
+private:
+	/// Where the found variables are stored.
+	VarSet &vars;
+};
+
+} // anonymous namespace
+
+/**
+* @brief Points-to classes of a single function.
+*
+* Every variable and every pointed-to memory location is a node identified by
+* an integer. Nodes are grouped into classes by a union-find structure and
+* every class has at most one pointee class. Node @c UNKNOWN_NODE stands for
+* memory reachable from outside of the function; it points to itself.
+*/
+class SteensgaardAliasAnalysis::PointsToGraph: private OrderedAllVisitor {
+public:
+	PointsToGraph(ShPtr<Function> func);
+
+	const VarSet &mayPointTo(ShPtr<Variable> var) const;
+
+	/**
+	* @brief Returns the variables whose address is taken in the function.
+	*/
+	const VarSet &getAddressedVars() const { return addressedVars; }
+
+private:
+	/// A node that is not present.
+	static constexpr std::size_t NO_NODE =
+		std::numeric_limits<std::size_t>::max();
+
+	/// Memory reachable from outside of the function.
+	static constexpr std::size_t UNKNOWN_NODE = 0;
+
+private:
+	std::size_t createNode();
+	std::size_t getNode(ShPtr<Variable> var);
+	std::size_t find(std::size_t node);
+	std::size_t join(std::size_t node1, std::size_t node2);
+	std::size_t getPointee(std::size_t node);
+	std::size_t getTarget(ShPtr<Expression> expr);
+	void assign(ShPtr<Expression> lhs, ShPtr<Expression> rhs);
+	void escape(std::size_t node);
+
+	/// @name Visitor Interface
+	/// @{
+	using OrderedAllVisitor::visit;
+	virtual void visit(ShPtr<AssignStmt> stmt) override;
+	virtual void visit(ShPtr<VarDefStmt> stmt) override;
+	virtual void visit(ShPtr<ForLoopStmt> stmt) override;
+	virtual void visit(ShPtr<ReturnStmt> stmt) override;
+	virtual void visit(ShPtr<AddressOpExpr> expr) override;
+	virtual void visit(ShPtr<AssignOpExpr> expr) override;
+	virtual void visit(ShPtr<CallExpr> expr) override;
+	/// @}
+
+private:
+	/// The analyzed function.
+	ShPtr<Function> func;
+
+	/// Parent of every node in the union-find structure. After the function
+	/// has been analyzed, every node points directly to the representative of
+	/// its class.
+	std::vector<std::size_t> parents;
+
+	/// Ranks of the nodes in the union-find structure.
+	std::vector<std::size_t> ranks;
+
+	/// Pointee of every class, indexed by the representative of the class.
+	std::vector<std::size_t> pointees;
+
+	/// Node of every variable appearing in the function.
+	std::unordered_map<ShPtr<Variable>, std::size_t> varNodes;
+
+	/// Variables whose address is taken in the function.
+	VarSet addressedVars;
+
+	/// Variables in a class, indexed by the representative of the class.
+	mutable std::unordered_map<std::size_t, VarSet> classVars;
+};
+
+/**
+* @brief Analyzes the given function.
+*
+* @par Preconditions
+*  - @a func is a definition
+*/
+SteensgaardAliasAnalysis::PointsToGraph::PointsToGraph(ShPtr<Function> func):
+		OrderedAllVisitor(true, true), func(func) {
+	createNode(); // UNKNOWN_NODE
+	pointees[UNKNOWN_NODE] = UNKNOWN_NODE;
+
+	for (const auto &param : func->getParams()) {
+		getNode(param);
+	}
+	visitStmt(func->getBody());
+
+	// Queries only read the representatives, so make every node point
+	// directly to its representative.
+	for (std::size_t node = 0, e = parents.size(); node < e; ++node) {
+		find(node);
+	}
+}
+
+/**
+* @brief Returns the set of variables to which @a var may point to.
+*/
+const VarSet &SteensgaardAliasAnalysis::PointsToGraph::mayPointTo(
+		ShPtr<Variable> var) const {
+	auto varNodeIter = varNodes.find(var);
+	if (varNodeIter == varNodes.end()) {
+		// The variable is not used in the function.
+		return EMPTY_VAR_SET;
+	}
+
+	std::size_t pointee = pointees[parents[varNodeIter->second]];
+	if (pointee == NO_NODE) {
+		// The variable is never assigned an address.
+		return EMPTY_VAR_SET;
+	}
+
+	std::size_t target = parents[pointee];
+	if (target == parents[UNKNOWN_NODE]) {
+		// The variable may point anywhere.
+		return addressedVars;
+	}
+
+	auto classVarsIter = classVars.find(target);
+	if (classVarsIter != classVars.end()) {
+		return classVarsIter->second;
+	}
+	VarSet &vars(classVars[target]);
+	for (const auto &addressedVar : addressedVars) {
+		if (parents[varNodes.find(addressedVar)->second] == target) {
+			vars.insert(addressedVar);
+		}
+	}
+	return vars;
+}
+
+/**
+* @brief Creates a new node forming a class of its own.
+*/
+std::size_t SteensgaardAliasAnalysis::PointsToGraph::createNode() {
+	std::size_t node = parents.size();
+	parents.push_back(node);
+	ranks.push_back(0);
+	pointees.push_back(NO_NODE);
+	return node;
+}
+
+/**
+* @brief Returns the node of @a var, creating it if needed.
+*
+* Parameters and variables that are not local to the function may point to
+* memory reachable from outside of the function.
+*/
+std::size_t SteensgaardAliasAnalysis::PointsToGraph::getNode(
+		ShPtr<Variable> var) {
+	auto varNodeIter = varNodes.find(var);
+	if (varNodeIter != varNodes.end()) {
+		return varNodeIter->second;
+	}
+
+	std::size_t node = createNode();
+	if (!func->hasLocalVar(var)) {
+		pointees[node] = UNKNOWN_NODE;
+	}
+	varNodes.emplace(var, node);
+	return node;
+}
+
+/**
+* @brief Returns the representative of the class of @a node.
+*/
+std::size_t SteensgaardAliasAnalysis::PointsToGraph::find(std::size_t node) {
+	std::size_t root = node;
+	while (parents[root] != root) {
+		root = parents[root];
+	}
+	while (parents[node] != root) {
+		node = std::exchange(parents[node], root);
+	}
+	return root;
+}
+
+/**
+* @brief Merges the classes of @a node1 and @a node2, including their
+*        pointees, and returns the representative of the merged class.
+*/
+std::size_t SteensgaardAliasAnalysis::PointsToGraph::join(std::size_t node1,
+		std::size_t node2) {
+	node1 = find(node1);
+	node2 = find(node2);
+	if (node1 == node2) {
+		return node1;
+	}
+
+	if (ranks[node1] < ranks[node2]) {
+		std::swap(node1, node2);
+	}
+	parents[node2] = node1;
+	if (ranks[node1] == ranks[node2]) {
+		++ranks[node1];
+	}
+
+	std::size_t pointee1 = pointees[node1];
+	std::size_t pointee2 = pointees[node2];
+	if (pointee1 == NO_NODE) {
+		pointees[node1] = pointee2;
+	} else if (pointee2 != NO_NODE) {
+		join(pointee1, pointee2);
+	}
+	return find(node1);
+}
+
+/**
+* @brief Returns the class to which the class of @a node points, creating it
+*        if needed.
+*/
+std::size_t SteensgaardAliasAnalysis::PointsToGraph::getPointee(
+		std::size_t node) {
+	node = find(node);
+	if (pointees[node] == NO_NODE) {
+		// Create the node first as it may reallocate the vector.
+		std::size_t pointee = createNode();
+		pointees[node] = pointee;
+	}
+	return find(pointees[node]);
+}
+
+/**
+* @brief Returns the class of memory to which the value of @a expr may point.
+*/
+std::size_t SteensgaardAliasAnalysis::PointsToGraph::getTarget(
+		ShPtr<Expression> expr) {
+	if (ShPtr<Variable> var = cast<Variable>(expr)) {
+		return getPointee(getNode(var));
+	} else if (ShPtr<AddressOpExpr> addressOpExpr = cast<AddressOpExpr>(expr)) {
+		ShPtr<Expression> operand(addressOpExpr->getOperand());
+		if (ShPtr<Variable> var = cast<Variable>(operand)) {
+			return getNode(var);
+		} else if (ShPtr<DerefOpExpr> derefOpExpr = cast<DerefOpExpr>(operand)) {
+			return getTarget(derefOpExpr->getOperand());
+		}
+		return UNKNOWN_NODE;
+	} else if (ShPtr<DerefOpExpr> derefOpExpr = cast<DerefOpExpr>(expr)) {
+		return getPointee(getTarget(derefOpExpr->getOperand()));
+	} else if (isa<IntToPtrCastExpr>(expr)) {
+		return UNKNOWN_NODE;
+	} else if (ShPtr<CastExpr> castExpr = cast<CastExpr>(expr)) {
+		return getTarget(castExpr->getOperand());
+	} else if (ShPtr<AddOpExpr> addOpExpr = cast<AddOpExpr>(expr)) {
+		// Pointer arithmetic does not leave the pointed-to object.
+		return join(getTarget(addOpExpr->getFirstOperand()),
+			getTarget(addOpExpr->getSecondOperand()));
+	} else if (ShPtr<SubOpExpr> subOpExpr = cast<SubOpExpr>(expr)) {
+		return join(getTarget(subOpExpr->getFirstOperand()),
+			getTarget(subOpExpr->getSecondOperand()));
+	} else if (ShPtr<TernaryOpExpr> ternaryOpExpr = cast<TernaryOpExpr>(expr)) {
+		return join(getTarget(ternaryOpExpr->getTrueValue()),
+			getTarget(ternaryOpExpr->getFalseValue()));
+	} else if (ShPtr<CommaOpExpr> commaOpExpr = cast<CommaOpExpr>(expr)) {
+		return getTarget(commaOpExpr->getSecondOperand());
+	} else if (ShPtr<AssignOpExpr> assignOpExpr = cast<AssignOpExpr>(expr)) {
+		return getTarget(assignOpExpr->getSecondOperand());
+	} else if (ShPtr<ConstSymbol> constSymbol = cast<ConstSymbol>(expr)) {
+		return getTarget(constSymbol->getValue());
+	} else if (isa<CallExpr>(expr) || isa<ArrayIndexOpExpr>(expr) ||
+			isa<StructIndexOpExpr>(expr)) {
+		// We do not track the contents of calls, arrays, and structures.
+		return UNKNOWN_NODE;
+	}
+
+	// The remaining constants and operators do not produce addresses.
+	return createNode();
+}
+
+/**
+* @brief Records that the value of @a rhs is stored into @a lhs.
+*/
+void SteensgaardAliasAnalysis::PointsToGraph::assign(ShPtr<Expression> lhs,
+		ShPtr<Expression> rhs) {
+	std::size_t target = getTarget(rhs);
+	if (ShPtr<Variable> var = cast<Variable>(lhs)) {
+		join(getPointee(getNode(var)), target);
+	} else if (ShPtr<DerefOpExpr> derefOpExpr = cast<DerefOpExpr>(lhs)) {
+		join(getPointee(getTarget(derefOpExpr->getOperand())), target);
+	} else {
+		escape(target);
+	}
+}
+
+/**
+* @brief Records that the memory in the class of @a node becomes reachable
+*        from outside of the function.
+*
+* The outside code may store anything into that memory.
+*/
+void SteensgaardAliasAnalysis::PointsToGraph::escape(std::size_t node) {
+	join(getPointee(node), UNKNOWN_NODE);
+}
+
+void SteensgaardAliasAnalysis::PointsToGraph::visit(ShPtr<AssignStmt> stmt) {
+	assign(stmt->getLhs(), stmt->getRhs());
+	OrderedAllVisitor::visit(stmt);
+}
+
+void SteensgaardAliasAnalysis::PointsToGraph::visit(ShPtr<VarDefStmt> stmt) {
+	if (ShPtr<Expression> init = stmt->getInitializer()) {
+		assign(stmt->getVar(), init);
+	}
+	OrderedAllVisitor::visit(stmt);
+}
+
+void SteensgaardAliasAnalysis::PointsToGraph::visit(ShPtr<ForLoopStmt> stmt) {
+	assign(stmt->getIndVar(), stmt->getStartValue());
+	OrderedAllVisitor::visit(stmt);
+}
+
+void SteensgaardAliasAnalysis::PointsToGraph::visit(ShPtr<ReturnStmt> stmt) {
+	if (ShPtr<Expression> retVal = stmt->getRetVal()) {
+		escape(getTarget(retVal));
+	}
+	OrderedAllVisitor::visit(stmt);
+}
+
+void SteensgaardAliasAnalysis::PointsToGraph::visit(
+		ShPtr<AddressOpExpr> expr) {
+	if (ShPtr<Variable> var = cast<Variable>(expr->getOperand())) {
+		addressedVars.insert(var);
+		getNode(var);
+	}
+	OrderedAllVisitor::visit(expr);
+}
+
+void SteensgaardAliasAnalysis::PointsToGraph::visit(
+		ShPtr<AssignOpExpr> expr) {
+	assign(expr->getFirstOperand(), expr->getSecondOperand());
+	OrderedAllVisitor::visit(expr);
+}
+
+void SteensgaardAliasAnalysis::PointsToGraph::visit(ShPtr<CallExpr> expr) {
+	for (const auto &arg : expr->getArgs()) {
+		escape(getTarget(arg));
+	}
+	OrderedAllVisitor::visit(expr);
+}
+
+/**
+* @brief Constructs a new analysis.
+*/
+SteensgaardAliasAnalysis::SteensgaardAliasAnalysis(): AliasAnalysis(),
+	funcGraphs(), allAddressedVars(), wholeModuleAnalyzed(false),
+	varFuncMap() {}
+
+SteensgaardAliasAnalysis::~SteensgaardAliasAnalysis() = default;
+
+/**
+* @brief Creates a new alias analysis.
+*/
+ShPtr<AliasAnalysis> SteensgaardAliasAnalysis::create() {
+	return ShPtr<SteensgaardAliasAnalysis>(new SteensgaardAliasAnalysis());
+}
+
+std::string SteensgaardAliasAnalysis::getId() const {
+	return STEENSGAARD_ALIAS_ANALYSIS_ID;
+}
+
+void SteensgaardAliasAnalysis::init(ShPtr<Module> module) {
+	AliasAnalysis::init(module);
+
+	// The functions themselves are analyzed upon the first query.
+	funcGraphs.clear();
+	allAddressedVars.clear();
+	wholeModuleAnalyzed = false;
+
+	varFuncMap.clear();
+	for (auto i = module->func_definition_begin(),
+			e = module->func_definition_end(); i != e; ++i) {
+		for (const auto &var : (*i)->getLocalVars(true)) {
+			varFuncMap[var] = *i;
+		}
+	}
+}
+
+const VarSet &SteensgaardAliasAnalysis::mayPointTo(
+		ShPtr<Variable> var) const {
+	if (!isa<PointerType>(var->getType())) {
+		// Assumption: a non-pointer variable never points to any variable.
+		return EMPTY_VAR_SET;
+	}
+
+	auto funcOfVarIter = varFuncMap.find(var);
+	if (hasItem(globalVars, var) || funcOfVarIter == varFuncMap.end()) {
+		// Assumption: a global pointer may point to any variable that has its
+		// address taken. The same holds for pointers we know nothing about.
+		analyzeWholeModule();
+		return allAddressedVars;
+	}
+
+	return getPointsToGraph(funcOfVarIter->second).mayPointTo(var);
+}
+
+ShPtr<Variable> SteensgaardAliasAnalysis::pointsTo(ShPtr<Variable> var) const {
+	// A singleton points-to class does not mean that the pointer always
+	// points to the variable (it may be, e.g., uninitialized), so we never
+	// return anything.
+	return ShPtr<Variable>();
+}
+
+bool SteensgaardAliasAnalysis::mayBePointed(ShPtr<Variable> var) const {
+	// Assumption: a variable may be pointed if and only if its address is
+	// taken. The address of a local variable can be taken only in its
+	// function.
+	auto funcOfVarIter = varFuncMap.find(var);
+	if (funcOfVarIter != varFuncMap.end()) {
+		return hasItem(getPointsToGraph(funcOfVarIter->second).getAddressedVars(),
+			var);
+	}
+
+	analyzeWholeModule();
+	return hasItem(allAddressedVars, var);
+}
+
+/**
+* @brief Returns the points-to graph of @a func, analyzing the function if it
+*        has not been analyzed yet.
+*/
+const SteensgaardAliasAnalysis::PointsToGraph &
+		SteensgaardAliasAnalysis::getPointsToGraph(ShPtr<Function> func) const {
+	UPtr<PointsToGraph> &graph(funcGraphs[func]);
+	if (!graph) {
+		graph = std::make_unique<PointsToGraph>(func);
+	}
+	return *graph;
+}
+
+/**
+* @brief Analyzes all functions and initializers of global variables in the
+*        module.
+*/
+void SteensgaardAliasAnalysis::analyzeWholeModule() const {
+	if (wholeModuleAnalyzed) {
+		return;
+	}
+
+	for (auto i = module->global_var_begin(), e = module->global_var_end();
+			i != e; ++i) {
+		if (ShPtr<Expression> init = (*i)->getInitializer()) {
+			AddressedVarsCollector::collect(init, allAddressedVars);
+		}
+	}
+
+	for (auto i = module->func_definition_begin(),
+			e = module->func_definition_end(); i != e; ++i) {
+		addToSet(getPointsToGraph(*i).getAddressedVars(), allAddressedVars);
+	}
+
+	wholeModuleAnalyzed = true;
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
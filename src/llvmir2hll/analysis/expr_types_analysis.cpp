@@ -44,10 +44,16 @@ ExprTypesAnalysis::ExprTypesAnalysis():
 */
 void ExprTypesAnalysis::addTagToExpr(ShPtr<Expression> expr, ExprTag tag) {
 	if (isa<IntType>(expr->getType())) {
-		// Note: If there is no vector for expr in exprTagsMap, it is created
-		//       automatically upon calling exprTagsMap[expr]. Therefore, we do
-		//       not have to check its existence prior to pushing the tag.
-		exprTagsMap[expr].push_back(tag);
+		// Note: If there are no counts for expr in exprTagsMap, they are
+		//       created automatically upon calling exprTagsMap[expr].
+		//       Therefore, we do not have to check their existence prior to
+		//       counting the tag.
+		TagCounts &counts(exprTagsMap[expr]);
+		if (tag == ExprTag::Signed) {
+			counts.signedCount++;
+		} else {
+			counts.unsignedCount++;
+		}
 	}
 }
 
@@ -57,15 +63,14 @@ void ExprTypesAnalysis::addTagToExpr(ShPtr<Expression> expr, ExprTag tag) {
 * @param[in] expr Expression.
 * @param[in] tag Counted tag (Signed or Unsigned).
 */
-std::size_t ExprTypesAnalysis::getCountOfTag(ShPtr<Expression> expr, ExprTag tag) {
-	std::size_t count = 0;
-	TagVector &tagsForExpr(exprTagsMap[expr]);
-	for (std::size_t i = 0, e = tagsForExpr.size(); i < e; ++i) {
-		if (tagsForExpr[i] == tag) {
-			count++;
-		}
+std::size_t ExprTypesAnalysis::getCountOfTag(ShPtr<Expression> expr,
+		ExprTag tag) const {
+	auto i = exprTagsMap.find(expr);
+	if (i == exprTagsMap.end()) {
+		return 0;
 	}
-	return count;
+	return tag == ExprTag::Signed ? i->second.signedCount :
+		i->second.unsignedCount;
 }
 
 /**
@@ -79,8 +84,11 @@ ShPtr<ExprTypesAnalysis> ExprTypesAnalysis::create() {
 * @brief Fixes some types to correct type.
 *
 * @param[in] module Searched module.
+*
+* The returned map is valid until the next call of this function.
 */
-ExprTypesAnalysis::ExprTagsMap ExprTypesAnalysis::analyzeExprTypes(ShPtr<Module> module) {
+const ExprTypesAnalysis::ExprTagsMap &ExprTypesAnalysis::analyzeExprTypes(
+		ShPtr<Module> module) {
 	exprTagsMap.clear();
 	// Obtain types from module.
 	// Global variables.
@@ -84,6 +84,10 @@ using retdec::utils::hasItem;
 namespace retdec {
 namespace llvmir2hll {
 
+// Every cached result takes at most a few kilobytes, so the default limit keeps
+// the cache under a few hundreds of megabytes even on huge modules.
+const std::size_t ValueAnalysis::DEFAULT_MAX_CACHE_SIZE = 100000;
+
 /**
 * @brief Constructs a new ValueData object.
 */
@@ -557,8 +561,8 @@ void ValueData::clear() {
 * See the description of create() for more information.
 */
 ValueAnalysis::ValueAnalysis(ShPtr<AliasAnalysis> aliasAnalysis,
-		bool enableCaching):
-	OrderedAllVisitor(false, false), Caching(enableCaching),
+		bool enableCaching, std::size_t maxCacheSize):
+	OrderedAllVisitor(false, false), Caching(enableCaching, maxCacheSize),
 	aliasAnalysis(aliasAnalysis), valueData(), writing(false),
 	removingFromCache(false) {}
 
@@ -680,15 +684,19 @@ bool ValueAnalysis::mayBePointed(ShPtr<Variable> var) const {
 *                          disableCaching() is called. This may speed up
 *                          subsequent calls to getValueData() if the same
 *                          values are passed to getValueData().
+* @param[in] maxCacheSize Maximal number of cached results. When the cache is
+*                         full, the least recently used results are evicted.
+*                         Zero means that the cache is unbounded.
 *
 * @par Preconditions
 *  - @a aliasAnalysis has been initialized
 */
 ShPtr<ValueAnalysis> ValueAnalysis::create(ShPtr<AliasAnalysis> aliasAnalysis,
-		bool enableCaching) {
+		bool enableCaching, std::size_t maxCacheSize) {
 	PRECONDITION(aliasAnalysis->isInitialized(), "it is not initialized");
 
-	return ShPtr<ValueAnalysis>(new ValueAnalysis(aliasAnalysis, enableCaching));
+	return ShPtr<ValueAnalysis>(new ValueAnalysis(aliasAnalysis, enableCaching,
+		maxCacheSize));
 }
 
 /**
@@ -117,7 +117,7 @@ UPtr<JSONConfig> JSONConfig::fromFile(const std::string &path) {
 	auto config = UPtr<JSONConfig>(new JSONConfig());
 	config->impl->path = path;
 	try {
-		config->impl->config.readJsonFile(path);
+		config->impl->config.readFile(path);
 	} catch (const retdec::config::FileNotFoundException &ex) {
 		throw JSONConfigFileNotFoundError(ex.what());
 	} catch (const retdec::config::Exception &ex) {
@@ -151,7 +151,7 @@ UPtr<JSONConfig> JSONConfig::empty() {
 }
 
 void JSONConfig::saveTo(const std::string &path) {
-	impl->config.generateJsonFile(path);
+	impl->config.generateFile(path);
 }
 
 void JSONConfig::dump() {
@@ -265,6 +265,19 @@ void JSONConfig::markFuncAsStaticallyLinked(const std::string &func) {
 	}
 }
 
+StringSet JSONConfig::getDegradationsOfFunc(const std::string &func) const {
+	const auto &f = impl->getConfigFunctionByNameOrEmptyFunction(func);
+	return f.degradations;
+}
+
+void JSONConfig::markFuncAsDegraded(const std::string &func,
+		const std::string &degradation) {
+	auto f = impl->getConfigFunctionByName(func);
+	if (f) {
+		f->degradations.insert(degradation);
+	}
+}
+
 std::string JSONConfig::getDeclarationStringForFunc(const std::string &func) const {
 	const auto &f = impl->getConfigFunctionByNameOrEmptyFunction(func);
 	return trim(f.getDeclarationString());
@@ -277,7 +290,8 @@ std::string JSONConfig::getCommentForFunc(const std::string &func) const {
 
 StringSet JSONConfig::getDetectedCryptoPatternsForFunc(const std::string &func) const {
 	const auto &f = impl->getConfigFunctionByNameOrEmptyFunction(func);
-	return f.usedCryptoConstants;
+	return StringSet(
+		f.usedCryptoConstants.begin(), f.usedCryptoConstants.end());
 }
 
 std::string JSONConfig::getWrappedFunc(const std::string &func) const {
@@ -171,6 +171,10 @@ void ArithmExprEvaluator::visit(ShPtr<DerefOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<NotOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -198,6 +202,10 @@ void ArithmExprEvaluator::visit(ShPtr<NotOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<NegOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -224,6 +232,10 @@ void ArithmExprEvaluator::visit(ShPtr<NegOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<EqOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -255,6 +267,10 @@ void ArithmExprEvaluator::visit(ShPtr<EqOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<NeqOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -286,6 +302,10 @@ void ArithmExprEvaluator::visit(ShPtr<NeqOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<LtEqOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -314,6 +334,10 @@ void ArithmExprEvaluator::visit(ShPtr<LtEqOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<GtEqOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -342,6 +366,10 @@ void ArithmExprEvaluator::visit(ShPtr<GtEqOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<LtOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -369,6 +397,10 @@ void ArithmExprEvaluator::visit(ShPtr<LtOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<GtOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -396,6 +428,10 @@ void ArithmExprEvaluator::visit(ShPtr<GtOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<AddOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -426,6 +462,10 @@ void ArithmExprEvaluator::visit(ShPtr<AddOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<SubOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -456,6 +496,10 @@ void ArithmExprEvaluator::visit(ShPtr<SubOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<MulOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -486,6 +530,10 @@ void ArithmExprEvaluator::visit(ShPtr<MulOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<ModOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -514,6 +562,10 @@ void ArithmExprEvaluator::visit(ShPtr<ModOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<DivOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -544,6 +596,10 @@ void ArithmExprEvaluator::visit(ShPtr<DivOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<AndOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -575,6 +631,10 @@ void ArithmExprEvaluator::visit(ShPtr<AndOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<OrOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -606,6 +666,10 @@ void ArithmExprEvaluator::visit(ShPtr<OrOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<BitAndOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -629,6 +693,10 @@ void ArithmExprEvaluator::visit(ShPtr<BitAndOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<BitOrOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -652,6 +720,10 @@ void ArithmExprEvaluator::visit(ShPtr<BitOrOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<BitXorOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -675,6 +747,10 @@ void ArithmExprEvaluator::visit(ShPtr<BitXorOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<BitShlOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -701,6 +777,10 @@ void ArithmExprEvaluator::visit(ShPtr<BitShlOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<BitShrOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -737,6 +817,10 @@ void ArithmExprEvaluator::visit(ShPtr<BitShrOpExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<TernaryOpExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -765,6 +849,10 @@ void ArithmExprEvaluator::visit(ShPtr<CallExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<BitCastExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -775,6 +863,10 @@ void ArithmExprEvaluator::visit(ShPtr<BitCastExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<ExtCastExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -785,6 +877,10 @@ void ArithmExprEvaluator::visit(ShPtr<ExtCastExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<TruncCastExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -795,6 +891,10 @@ void ArithmExprEvaluator::visit(ShPtr<TruncCastExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<FPToIntCastExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
@@ -805,6 +905,10 @@ void ArithmExprEvaluator::visit(ShPtr<FPToIntCastExpr> expr) {
 }
 
 void ArithmExprEvaluator::visit(ShPtr<IntToFPCastExpr> expr) {
+	if (!canBeEvaluated) {
+		return;
+	}
+
 	OrderedAllVisitor::visit(expr);
 
 	if (canBeEvaluated) {
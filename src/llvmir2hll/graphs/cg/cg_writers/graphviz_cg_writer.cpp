@@ -4,6 +4,9 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <map>
+#include <vector>
+
 #include "retdec/llvmir2hll/graphs/cg/cg.h"
 #include "retdec/llvmir2hll/graphs/cg/cg_writer_factory.h"
 #include "retdec/llvmir2hll/graphs/cg/cg_writers/graphviz_cg_writer.h"
@@ -91,6 +94,19 @@ bool GraphvizCGWriter::emitCG() {
 	// If there is debug information available, generate each function into a
 	// cluster (subgraph) that corresponds to its module.
 	if (!moduleNames.empty()) {
+		// Group the callers by their modules in a single pass over the CG
+		// (functions without an assigned module are emitted at the end).
+		std::map<std::string, std::vector<CG::caller_iterator>> moduleCallers;
+		std::vector<CG::caller_iterator> callersWithoutModule;
+		for (auto i = cg->caller_begin(), e = cg->caller_end(); i != e; ++i) {
+			auto moduleName = module->getDebugModuleNameForFunc(i->first);
+			if (!moduleName.empty()) {
+				moduleCallers[moduleName].push_back(i);
+			} else {
+				callersWithoutModule.push_back(i);
+			}
+		}
+
 		// For every module name...
 		for (const auto &moduleName : moduleNames) {
 			out << INDENT << "subgraph " << UtilsGraphviz::createNodeName(
@@ -101,21 +117,17 @@ bool GraphvizCGWriter::emitCG() {
 			out << "\n";
 
 			// Emit nodes for functions which are in this module.
-			for (auto i = cg->caller_begin(), e = cg->caller_end(); i != e; ++i) {
-				if (module->getDebugModuleNameForFunc(i->first) == moduleName) {
-					out << INDENT;
-					emitNode(i->first, i->second);
-				}
+			for (auto i : moduleCallers[moduleName]) {
+				out << INDENT;
+				emitNode(i->first, i->second);
 			}
 			out << INDENT << "}\n";
 			out << "\n";
 		}
 
 		// Emit nodes for functions which do not have an assigned module.
-		for (auto i = cg->caller_begin(), e = cg->caller_end(); i != e; ++i) {
-			if (!module->hasAssignedDebugModuleName(i->first)) {
-				emitNode(i->first, i->second);
-			}
+		for (auto i : callersWithoutModule) {
+			emitNode(i->first, i->second);
 		}
 		out << "\n";
 	} else {
@@ -39,6 +39,7 @@
 #include "retdec/llvmir2hll/utils/string.h"
 #include "retdec/utils/container.h"
 #include "retdec/utils/conversion.h"
+#include "retdec/utils/instrumentation.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/time.h"
 
@@ -221,6 +222,8 @@ void HLLWriter::setOptionUseCompoundOperators(bool use) {
 * override this function.
 */
 bool HLLWriter::emitTargetCode(ShPtr<Module> module) {
+	RETDEC_SCOPED_TIMER("writer.emitTargetCode");
+
 	this->module = module;
 	bool codeEmitted = false;
 
@@ -512,7 +515,8 @@ bool HLLWriter::emitFunctionsHeader() {
 * @return @c true if some code has been emitted, @c false otherwise.
 *
 * By default (if it is not overridden), it tries to sort the functions in the
-* module and calls emitFunction() on each of them.
+* module and calls emitFunction() on each of them. The output is flushed after
+* every function, so the emitted code is not kept in memory.
 */
 bool HLLWriter::emitFunctions() {
 	FuncVector funcs(module->func_definition_begin(), module->func_definition_end());
@@ -524,6 +528,7 @@ bool HLLWriter::emitFunctions() {
 			out->newLine();
 		}
 		somethingEmitted |= emitFunction(func);
+		out->flush();
 	}
 	return somethingEmitted;
 }
@@ -541,6 +546,9 @@ bool HLLWriter::emitFunctions() {
 */
 bool HLLWriter::emitFunction(ShPtr<Function> func) {
 	PRECONDITION_NON_NULL(func);
+	RETDEC_SCOPED_TIMER_VAR(timer, "writer.emitFunction");
+	RETDEC_TIMER_ARG(timer, "function", func->getName());
+	RETDEC_TIMER_ARG(timer, "address", func->getStartAddress().toHexPrefixString());
 
 	currFunc = func;
 	currFuncGotoLabelCounter = 0;
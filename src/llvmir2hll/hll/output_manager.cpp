@@ -19,6 +19,15 @@ void OutputManager::finalize()
 
 }
 
+/**
+ * Writes all the tokens generated so far into the underlying stream so that
+ * they do not have to be kept in memory until finalize() is called.
+ */
+void OutputManager::flush()
+{
+
+}
+
 void OutputManager::setCommentPrefix(const std::string& prefix)
 {
 	_commentPrefix = prefix;
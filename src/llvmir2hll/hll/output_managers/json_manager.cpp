@@ -79,7 +79,16 @@ void JsonOutputManager<Writer>::finalize()
 
 	writer.EndObject();
 
+	flush();
+}
+
+template <typename Writer>
+void JsonOutputManager<Writer>::flush()
+{
+	// The writer only appends to the buffer, so the already generated part
+	// of the JSON document can be written out and dropped at any time.
 	_out << sb.GetString();
+	sb.Clear();
 }
 
 template <typename Writer>
@@ -16,6 +16,11 @@ PlainOutputManager::PlainOutputManager(llvm::raw_ostream& out) :
 
 }
 
+void PlainOutputManager::flush()
+{
+	_out.flush();
+}
+
 void PlainOutputManager::newLine()
 {
 	_out << "\n";
@@ -69,6 +69,8 @@ bool FloatType::existsFloatType() const {
 ShPtr<FloatType> FloatType::create(unsigned size) {
 	PRECONDITION(size > 0, "invalid size " << size);
 
+	std::lock_guard<std::mutex> lock(createdTypesMutex);
+
 	// To reduce the amount of created types, we use a set of already created
 	// float types of the given size. If the wanted type has already been
 	// created, reuse it.
@@ -89,6 +91,7 @@ void FloatType::accept(Visitor *v) {
 
 // Static variables and constants definitions.
 std::map<unsigned, ShPtr<FloatType>> FloatType::createdTypes;
+std::mutex FloatType::createdTypesMutex;
 
 } // namespace llvmir2hll
 } // namespace retdec
@@ -451,6 +451,37 @@ void Module::markFuncAsStaticallyLinked(ShPtr<Function> func) {
 	config->markFuncAsStaticallyLinked(func->getInitialName());
 }
 
+/**
+* @brief Returns all function definitions whose decompilation took a cheaper
+*        path because they were too costly.
+*/
+FuncSet Module::getDegradedFuncs() const {
+	return getFuncsSatisfyingPredicate(
+		[this](auto func) {
+			return func->isDefinition() &&
+				!config->getDegradationsOfFunc(func->getInitialName()).empty();
+		}
+	);
+}
+
+/**
+* @brief Returns the cheaper paths that the decompilation of @a func took.
+*
+* See Config::getDegradationsOfFunc() for more details.
+*/
+StringSet Module::getDegradationsOfFunc(ShPtr<Function> func) const {
+	return config->getDegradationsOfFunc(func->getInitialName());
+}
+
+/**
+* @brief Records that the decompilation of @a func took the cheaper path
+*        @a degradation.
+*/
+void Module::markFuncAsDegraded(ShPtr<Function> func,
+		const std::string &degradation) {
+	config->markFuncAsDegraded(func->getInitialName(), degradation);
+}
+
 /**
 * @brief Are there any dynamically linked functions in the module?
 */
@@ -4,6 +4,8 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <atomic>
+
 #include "retdec/llvmir2hll/ir/statement.h"
 #include "retdec/llvmir2hll/ir/value.h"
 #include "retdec/llvmir2hll/support/debug.h"
@@ -26,8 +28,16 @@ std::string getTextRepr(ValuePtr value) {
 	return value ? value->getTextRepr() : "(null)";
 }
 
+/// ID of the next created value.
+std::atomic<std::uint64_t> nextValueId(0);
+
 } // anonymous namespace
 
+/**
+* @brief Constructs a new value with a fresh ID.
+*/
+Value::Value(): id(nextValueId.fetch_add(1, std::memory_order_relaxed)) {}
+
 ShPtr<Value> Value::getSelf() {
 	return shared_from_this();
 }
@@ -18,7 +18,8 @@ namespace llvmir2hll {
 * See create() for more information.
 */
 Variable::Variable(const std::string &name, ShPtr<Type> type, Address a):
-	initialName(name), name(name), type(type), internal(true), address(a) {}
+	initialName(name), name(initialName), type(type), internal(true),
+	address(a) {}
 
 ShPtr<Value> Variable::clone() {
 	// Variables are not cloned (see the description of Value::clone()).
@@ -26,7 +27,8 @@ ShPtr<Value> Variable::clone() {
 }
 
 bool Variable::isEqualTo(ShPtr<Value> otherValue) const {
-	// Both types, names, and internal status have to be equal.
+	// Both types, names, and internal status have to be equal. Names are
+	// interned, so comparing them is cheap.
 	if (ShPtr<Variable> otherVariable = cast<Variable>(otherValue)) {
 		return initialName == otherVariable->initialName &&
 			name == otherVariable->name &&
@@ -48,14 +50,14 @@ void Variable::replace(ShPtr<Expression> oldExpr, ShPtr<Expression> newExpr) {
 * This is the name that was assigned to the variable before any renaming.
 */
 const std::string &Variable::getInitialName() const {
-	return initialName;
+	return initialName.str();
 }
 
 /**
 * @brief Returns the name of the variable.
 */
 const std::string &Variable::getName() const {
-	return name;
+	return name.str();
 }
 
 Address Variable::getAddress() const {
@@ -115,7 +117,7 @@ bool Variable::isExternal() const {
 */
 ShPtr<Variable> Variable::copy() const {
 	ShPtr<Variable> varCopy(Variable::create(initialName, type));
-	varCopy->setName(name);
+	varCopy->name = name;
 	varCopy->internal = internal;
 	return varCopy;
 }
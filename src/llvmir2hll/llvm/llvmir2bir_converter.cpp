@@ -19,6 +19,7 @@
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/llvmir2hll/utils/ir.h"
 #include "retdec/llvmir2hll/utils/string.h"
+#include "retdec/utils/cancellation.h"
 #include "retdec/utils/io/log.h"
 
 using namespace retdec::utils::io;
@@ -33,6 +34,7 @@ namespace llvmir2hll {
 */
 LLVMIR2BIRConverter::LLVMIR2BIRConverter(llvm::Pass *basePass):
 	basePass(basePass), optionStrictFPUSemantics(false),
+	optionReleaseLLVMFuncBodies(false), optionFuncCostLimit(0),
 	enableDebug(false), converter(),
 	llvmModule(nullptr), resModule(), structConverter(), variablesManager() {}
 
@@ -58,6 +60,33 @@ void LLVMIR2BIRConverter::setOptionStrictFPUSemantics(bool strict) {
 	optionStrictFPUSemantics = strict;
 }
 
+/**
+* @brief Enables/disables releasing of bodies of LLVM functions after their
+*        conversion.
+*
+* @param[in] release If @c true, the body of every converted LLVM function is
+*                    deleted right after the function has been converted,
+*                    which turns the function into a declaration. This lowers
+*                    the peak memory usage, but the input LLVM module must not
+*                    be used after the conversion.
+*/
+void LLVMIR2BIRConverter::setOptionReleaseLLVMFuncBodies(bool release) {
+	optionReleaseLLVMFuncBodies = release;
+}
+
+/**
+* @brief Sets the limit of the estimated cost of functions that are fully
+*        structured.
+*
+* @param[in] limit Functions whose estimated cost is above @a limit are
+*                  structured only by gotos and marked as degraded by
+*                  "structuredByGotos" in the module config. Zero means no
+*                  limit.
+*/
+void LLVMIR2BIRConverter::setOptionFuncCostLimit(std::uint64_t limit) {
+	optionFuncCostLimit = limit;
+}
+
 /**
 * @brief Converts the given LLVM module into a module in BIR.
 *
@@ -85,6 +114,7 @@ ShPtr<Module> LLVMIR2BIRConverter::convert(llvm::Module *llvmModule,
 	structConverter = std::make_unique<StructureConverter>(basePass, converter, resModule);
 
 	converter->setOptionStrictFPUSemantics(optionStrictFPUSemantics);
+	structConverter->setOptionFuncCostLimit(optionFuncCostLimit);
 
 	convertAndAddFuncsDeclarations();
 	convertAndAddGlobalVariables();
@@ -201,16 +231,42 @@ void LLVMIR2BIRConverter::updateFuncToDefinition(llvm::Function &func) {
 		Log::phase("converting function " + name.str(), Log::SubPhase);
 	}
 
-	auto birFunc = resModule->getFuncByName(name);
-	if (birFunc) {
+	// Looking the function up by its name would be linear in the number of
+	// functions in the module, which makes the conversion of large modules
+	// quadratic.
+	auto birFuncIt = convertedFuncs.find(&func);
+	if (birFuncIt != convertedFuncs.end()) {
+		auto birFunc = birFuncIt->second;
+
 		// Clear local variables before conversion.
 		variablesManager->reset();
 
 		birFunc->setParams(convertFuncParams(func));
 		birFunc->setBody(structConverter->convertFuncBody(func));
+		if (structConverter->wasReductionSkipped()) {
+			resModule->markFuncAsDegraded(birFunc, "structuredByGotos");
+		}
+		if (enableDebug) {
+			Log::info() << Log::SubSubPhase << "structuring of cost "
+				<< structConverter->getFuncCost() << " took "
+				<< structConverter->getNumOfReductionPasses() << " pass(es) and "
+				<< structConverter->getNumOfReductions() << " reduction(s)"
+				<< (structConverter->wasReductionSkipped()
+					? " (structured by gotos)" : "")
+				<< std::endl;
+		}
 		birFunc->setLocalVars(variablesManager->getLocalVars());
 
 		generateVarDefinitions(birFunc);
+
+		// Bodies are released also when the decompilation is short of
+		// memory. The back-end is the last pass and the output writers work
+		// on their own copies of the module, so nothing needs them anymore.
+		if (optionReleaseLLVMFuncBodies || utils::isMemoryLimitExceeded()) {
+			// All the information from the body (including debug locations)
+			// is already in BIR.
+			func.deleteBody();
+		}
 	}
 }
 
@@ -252,9 +308,12 @@ bool LLVMIR2BIRConverter::shouldBeConvertedAndAdded(
 *        them into the resulting module.
 */
 void LLVMIR2BIRConverter::convertAndAddFuncsDeclarations() {
+	convertedFuncs.clear();
 	for (auto &func: llvmModule->functions()) {
 		if (shouldBeConvertedAndAdded(func)) {
-			resModule->addFunc(convertFuncDeclaration(func));
+			auto birFunc = convertFuncDeclaration(func);
+			resModule->addFunc(birFunc);
+			convertedFuncs.emplace(&func, birFunc);
 		}
 	}
 }
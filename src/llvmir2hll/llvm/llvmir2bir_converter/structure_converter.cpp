@@ -9,6 +9,7 @@
 #include <llvm/Analysis/LoopInfo.h>
 #include <llvm/Analysis/ScalarEvolution.h>
 #include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/InstrTypes.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/Pass.h>
@@ -35,6 +36,7 @@
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/llvmir2hll/support/expression_negater.h"
 #include "retdec/llvmir2hll/utils/ir.h"
+#include "retdec/utils/cancellation.h"
 #include "retdec/utils/container.h"
 
 using namespace std::placeholders;
@@ -81,18 +83,31 @@ StructureConverter::StructureConverter(llvm::Pass *basePass,
 * @brief Converts body of the given LLVM function @a func into a sequence
 *        of statements in BIR which include conditional statements and loops.
 *
+* When the phase budget of the current cancellation token is spent, the
+* reduction of the CFG is stopped and the rest is structured by gotos. When the
+* estimated cost of @a func is above the limit set by setOptionFuncCostLimit(),
+* the CFG is not reduced at all and the whole function is structured by gotos.
+*
 * @par Preconditions
 *  - @a func is not a function declaration
 */
 ShPtr<Statement> StructureConverter::convertFuncBody(llvm::Function &func) {
 	PRECONDITION(!func.isDeclaration(), "func cannot be a declaration");
 
+	numOfReductionPasses = 0;
+	numOfReductions = 0;
+
 	initialiazeLLVMAnalyses(func);
+	funcCost = computeFuncCost(func);
+	reductionSkipped = funcCostLimit != 0 && funcCost > funcCostLimit;
+
 	auto cfg = createCFG(func.getEntryBlock());
 	detectBackEdges(cfg);
 
-	while (cfg->getSuccNum() != 0 && reduceCFG(cfg)) {
+	while (cfg->getSuccNum() != 0 && !reductionSkipped
+			&& !utils::isPhaseBudgetExpired() && reduceCFG(cfg)) {
 		// Keep looping until the CFG is reduced.
+		utils::throwIfCancellationRequested();
 	}
 
 	if (cfg->getSuccNum() != 0) {
@@ -318,6 +333,53 @@ ShPtr<Statement> StructureConverter::replaceBreakOrContinueOutsideLoop(ShPtr<Sta
 	return statement;
 }
 
+/**
+* @brief Returns the number of passes over the control-flow graph done during
+*        the last call of convertFuncBody().
+*
+* Every pass traverses the whole (sub)graph and tries to reduce its nodes.
+* Passes that reduce loops are counted as well.
+*/
+std::size_t StructureConverter::getNumOfReductionPasses() const {
+	return numOfReductionPasses;
+}
+
+/**
+* @brief Returns the number of nodes reduced during the last call of
+*        convertFuncBody().
+*/
+std::size_t StructureConverter::getNumOfReductions() const {
+	return numOfReductions;
+}
+
+/**
+* @brief Returns the estimated cost of the function converted by the last call
+*        of convertFuncBody() (see computeFuncCost()).
+*/
+std::uint64_t StructureConverter::getFuncCost() const {
+	return funcCost;
+}
+
+/**
+* @brief Returns @c true if the last call of convertFuncBody() skipped the
+*        reduction of the CFG because the function was too costly.
+*/
+bool StructureConverter::wasReductionSkipped() const {
+	return reductionSkipped;
+}
+
+/**
+* @brief Sets the limit of the estimated cost of functions whose CFG is
+*        reduced.
+*
+* @param[in] limit Functions whose cost (see computeFuncCost()) is above
+*                  @a limit are structured only by gotos, which is linear in
+*                  their size. Zero means no limit.
+*/
+void StructureConverter::setOptionFuncCostLimit(std::uint64_t limit) {
+	funcCostLimit = limit;
+}
+
 /**
 * @brief Creates control-flow graph of the function from the given root basic
 *        block @a root.
@@ -400,6 +462,7 @@ void StructureConverter::detectBackEdges(ShPtr<CFGNode> cfg) const {
 bool StructureConverter::reduceCFG(ShPtr<CFGNode> cfg) {
 	PRECONDITION_NON_NULL(cfg);
 
+	++numOfReductionPasses;
 	return BFSTraverse(cfg, [this](const auto &node) {
 		return this->inspectCFGNode(node);
 	});
@@ -417,6 +480,26 @@ bool StructureConverter::reduceCFG(ShPtr<CFGNode> cfg) {
 bool StructureConverter::inspectCFGNode(ShPtr<CFGNode> node) {
 	PRECONDITION_NON_NULL(node);
 
+	if (tryToReduceCFGNode(node)) {
+		++numOfReductions;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+* @brief Tries to reduce the given CFG node @a node and its neighboring nodes
+*        to any control-flow statement.
+*
+* @returns Returns @c true if the node have been reduced.
+*
+* @par Preconditions
+*  - @a node is non-null
+*/
+bool StructureConverter::tryToReduceCFGNode(ShPtr<CFGNode> node) {
+	PRECONDITION_NON_NULL(node);
+
 	if (isLoopHeader(node) && !hasItem(statementsOnStack, node) &&
 			(statementsStack.empty() || statementsStack.top() != node)) {
 		loopHeaders.emplace(getLoopFor(node), node);
@@ -659,6 +742,35 @@ bool StructureConverter::existsPathWithoutLoopsBetween(const ShPtr<CFGNode> &nod
 	return BFSFindFirst(node1, predicate) != nullptr;
 }
 
+/**
+* @brief Returns all nodes reachable from the given node @a node without
+*        following back edges (including @a node itself).
+*
+* The result is cached in @c reachableNodesCache, so it has to be cleared
+* whenever the control-flow graph is modified.
+*
+* @par Preconditions
+*  - @a node is non-null
+*/
+const CFGNode::CFGNodeSet &StructureConverter::getReachableNodes(
+		const ShPtr<CFGNode> &node) const {
+	PRECONDITION_NON_NULL(node);
+
+	auto it = reachableNodesCache.find(node);
+	if (it != reachableNodesCache.end()) {
+		return it->second;
+	}
+
+	CFGNodeQueue toBeVisited({node});
+	CFGNode::CFGNodeSet visited{node};
+	while (!toBeVisited.empty()) {
+		auto currNode = popFromQueue(toBeVisited);
+		addUnvisitedSuccessorsToQueue(currNode, toBeVisited, visited);
+	}
+
+	return reachableNodesCache.emplace(node, std::move(visited)).first->second;
+}
+
 /**
 * @brief Determines whether the given node @a node can be reduced with following
 *        node as a sequence.
@@ -1613,8 +1725,12 @@ void StructureConverter::completelyReduceLoop(ShPtr<CFGNode> loopNode) {
 		return this->inspectCFGNode(node);
 	};
 
-	while (!hasItem(reducedLoops, loop) && BFSTraverse(loopNode, func)) {
+	while (!hasItem(reducedLoops, loop)) {
 		// Keep looping until the loop is reduced.
+		++numOfReductionPasses;
+		if (!BFSTraverse(loopNode, func)) {
+			break;
+		}
 	}
 
 	if (!hasItem(reducedLoops, loop)) {
@@ -1658,9 +1774,16 @@ ShPtr<CFGNode> StructureConverter::getSwitchSuccessor(
 		const ShPtr<CFGNode> &switchNode) const {
 	PRECONDITION_NON_NULL(switchNode);
 
-	return BFSFindFirst(switchNode, [this, &switchNode](const auto &node) {
-		return this->isNodeAfterAllSwitchClauses(node, switchNode);
-	});
+	// The graph is not modified during the search, so nodes reachable from
+	// the clauses can be computed only once for all the candidates.
+	reachableNodesCache.clear();
+	auto switchSucc = BFSFindFirst(switchNode,
+		[this, &switchNode](const auto &node) {
+			return this->isNodeAfterAllSwitchClauses(node, switchNode);
+		}
+	);
+	reachableNodesCache.clear();
+	return switchSucc;
 }
 
 /**
@@ -1708,7 +1831,7 @@ bool StructureConverter::isNodeAfterSwitchClause(const ShPtr<CFGNode> &node,
 		return true;
 	}
 
-	return existsPathWithoutLoopsBetween(clauseNode, node);
+	return hasItem(getReachableNodes(clauseNode), node);
 }
 
 /**
@@ -2260,6 +2383,26 @@ void StructureConverter::initialiazeLLVMAnalyses(llvm::Function &func) {
 	scalarEvolution = &basePass->getAnalysis<llvm::ScalarEvolutionWrapperPass>(func).getSE();
 }
 
+/**
+* @brief Estimates the cost of structuring @a func.
+*
+* The cost is the number of instructions, basic blocks, and CFG edges, which
+* is multiplied by one plus the maximal loop depth because every loop level
+* makes the reduction traverse the nodes of the loop again.
+*
+* @par Preconditions
+*  - LLVM analyses have been initialized for @a func
+*/
+std::uint64_t StructureConverter::computeFuncCost(llvm::Function &func) const {
+	std::uint64_t size = 0;
+	unsigned maxLoopDepth = 0;
+	for (auto &bb: func) {
+		size += 1 + bb.size() + llvm::succ_size(&bb);
+		maxLoopDepth = std::max(maxLoopDepth, loopInfo->getLoopDepth(&bb));
+	}
+	return size * (1 + maxLoopDepth);
+}
+
 /**
 * @brief Returns the innermost loop for the given node @a node. If node is not
 *        inside loop, returns nulptr.
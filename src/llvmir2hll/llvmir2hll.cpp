@@ -2,9 +2,14 @@
 #include <algorithm>
 #include <fstream>
 #include <memory>
+#include <sstream>
+#include <vector>
 
 #include "retdec/llvmir2hll/llvmir2hll.h"
+#include "retdec/utils/cancellation.h"
 #include "retdec/utils/io/log.h"
+#include "retdec/utils/parallel.h"
+#include "retdec/utils/version.h"
 
 using namespace llvm;
 using namespace retdec::utils::io;
@@ -22,7 +27,6 @@ using retdec::utils::strToNum;
 //
 std::string TargetHLL = "c";
 std::string oArithmExprEvaluator = "c";
-bool ValidateModule = true;
 bool StrictFPUSemantics = false;
 std::string ForcedModuleName = "";
 // This could be implemented, but it would have to be across all parts
@@ -34,7 +38,6 @@ std::string oCFGWriter = "dot";
 std::string oCGWriter = "dot";
 std::string VarNameGenPrefix = "";
 std::string oVarNameGen = "fruit"; // fruit|num|word
-std::string oAliasAnalysis = "simple"; // simple|basic
 std::string FindPatterns = ""; // all TODO: enable?
 std::string oSemantics = "";
 
@@ -157,13 +160,115 @@ bool LlvmIr2Hll::runOnModule(llvm::Module &m)
 		return false;
 	}
 
+	if (!globalConfig->parameters.inputBirShards.empty())
+	{
+		Log::phase("merging of BIR shards");
+		decompilationShouldContinue = loadMergedBIR();
+	}
+	else if (globalConfig->parameters.getInputBirFile().empty())
+	{
+		decompilationShouldContinue = convertLLVMIRToOptimizedBIR();
+	}
+	else
+	{
+		Log::phase("loading of BIR");
+		decompilationShouldContinue = loadBIR();
+	}
+	if (!decompilationShouldContinue)
+	{
+		return false;
+	}
+
+	// The module is emitted by another run, which merges the snapshots.
+	if (globalConfig->parameters.isBackendBirOnly())
+	{
+		Log::phase("cleanup");
+		cleanup();
+		return false;
+	}
+
+	if (!globalConfig->parameters.isBackendNoVarRenaming())
+	{
+		Log::phase("variable renaming [" + varRenamer->getId() + "]");
+		renameVariables();
+	}
+
+	if (!globalConfig->parameters.isBackendNoSymbolicNames())
+	{
+		Log::phase("converting constants to symbolic names");
+		convertConstantsToSymbolicNames();
+	}
+
+	if (globalConfig->parameters.getBackendValidation() != "off")
+	{
+		Log::phase("module validation");
+		validateResultingModule();
+	}
+
+	if (!FindPatterns.empty())
+	{
+		Log::phase("finding patterns");
+		findPatterns();
+	}
+
+	if (globalConfig->parameters.isBackendEmitCfg())
+	{
+		Log::phase("emission of control-flow graphs");
+		emitCFGs();
+	}
+
+	if (globalConfig->parameters.isBackendEmitCg())
+	{
+		Log::phase("emission of a call graph");
+		emitCG();
+	}
+
+	Log::phase("emission of the target code [" + hllWriter->getId() + "]");
+	emitTargetHLLCode();
+
+	Log::phase("finalization");
+	finalize();
+
+	Log::phase("cleanup");
+	cleanup();
+
+	return false;
+}
+
+/**
+* @brief Converts the LLVM IR module into a BIR module and optimizes it.
+*
+* If requested, the optimized module is saved into a BIR snapshot, from which
+* it can be loaded by loadBIR().
+*
+* @return @c true if the decompilation should continue, @c false otherwise.
+*/
+bool LlvmIr2Hll::convertLLVMIRToOptimizedBIR()
+{
+	// The keys have to be computed before the conversion because it may
+	// release bodies of LLVM functions.
+	if (!globalConfig->parameters.isBackendNoOpts()
+			&& !globalConfig->parameters.getBackendFuncCacheDirectory().empty())
+	{
+		Log::phase("computing keys of functions for the cache", Log::SubPhase);
+		createFuncResultCache();
+	}
+
 	Log::phase("conversion of LLVM IR into BIR");
-	decompilationShouldContinue = convertLLVMIRToBIR();
+	utils::startCancellationPhase();
+	bool decompilationShouldContinue = convertLLVMIRToBIR();
 	if (!decompilationShouldContinue)
 	{
 		return false;
 	}
 
+	// Names of variables obtained from debug information are specific to the
+	// input, so they must not be shared through the cache.
+	if (resModule->isDebugInfoAvailable())
+	{
+		funcResultCache.reset();
+	}
+
 	if (!globalConfig->parameters.isBackendKeepLibraryFuncs())
 	{
 		Log::phase("removing functions from standard libraries");
@@ -192,59 +297,139 @@ bool LlvmIr2Hll::runOnModule(llvm::Module &m)
 
 	if (!globalConfig->parameters.isBackendNoOpts())
 	{
+		llvmir2hll::FuncSet restoredFuncs;
+		if (funcResultCache)
+		{
+			Log::phase("restoring optimized functions from the cache");
+			restoredFuncs = restoreCachedFuncs();
+		}
+
 		Log::phase("alias analysis [" + aliasAnalysis->getId() + "]");
 		initAliasAnalysis();
 
 		Log::phase("optimizations");
-		runOptimizations();
+		utils::startCancellationPhase();
+		runOptimizations(restoredFuncs);
 	}
 
-	if (!globalConfig->parameters.isBackendNoVarRenaming())
+	if (!globalConfig->parameters.getOutputBirFile().empty())
 	{
-		Log::phase("variable renaming [" + varRenamer->getId() + "]");
-		renameVariables();
+		Log::phase("saving of BIR");
+		return saveBIR();
 	}
 
-	if (!globalConfig->parameters.isBackendNoSymbolicNames())
-	{
-		Log::phase("converting constants to symbolic names");
-		convertConstantsToSymbolicNames();
-	}
+	return true;
+}
 
-	if (ValidateModule)
+/**
+* @brief Loads the optimized BIR module from the input BIR snapshot instead of
+*        converting and optimizing the LLVM IR module.
+*
+* @return @c true if the decompilation should continue, @c false otherwise.
+*/
+bool LlvmIr2Hll::loadBIR()
+{
+	const auto& birFile = globalConfig->parameters.getInputBirFile();
+	std::ifstream in(birFile, std::ios::binary);
+	if (in)
 	{
-		Log::phase("module validation");
-		validateResultingModule();
+		resModule = llvmir2hll::BIRSnapshot::load(
+				in,
+				llvmModule,
+				semantics,
+				config
+		);
 	}
-
-	if (!FindPatterns.empty())
+	if (!resModule)
 	{
-		Log::phase("finding patterns");
-		findPatterns();
+		Log::error() << Log::Error
+			<< "Loading of BIR from " << birFile << " failed." << std::endl;
+		return false;
 	}
 
-	if (globalConfig->parameters.isBackendEmitCfg())
+	initLoadedBIR();
+	return true;
+}
+
+/**
+* @brief Loads the optimized BIR module by merging the input BIR shards, i.e.
+*        snapshots of modules optimized from parts of the LLVM IR module.
+*
+* @return @c true if the decompilation should continue, @c false otherwise.
+*/
+bool LlvmIr2Hll::loadMergedBIR()
+{
+	const auto& shardFiles = globalConfig->parameters.inputBirShards;
+	std::vector<std::unique_ptr<std::ifstream>> ins;
+	std::vector<std::istream*> inPtrs;
+	for (const auto& shardFile : shardFiles)
 	{
-		Log::phase("emission of control-flow graphs");
-		emitCFGs();
+		ins.push_back(std::make_unique<std::ifstream>(
+				shardFile,
+				std::ios::binary
+		));
+		if (!*ins.back())
+		{
+			Log::error() << Log::Error
+				<< "Loading of BIR from " << shardFile << " failed."
+				<< std::endl;
+			return false;
+		}
+		inPtrs.push_back(ins.back().get());
 	}
 
-	if (globalConfig->parameters.isBackendEmitCg())
+	resModule = llvmir2hll::BIRSnapshot::loadMerged(
+			inPtrs,
+			llvmModule,
+			semantics,
+			config
+	);
+	if (!resModule)
 	{
-		Log::phase("emission of a call graph");
-		emitCG();
+		Log::error() << Log::Error
+			<< "Merging of " << shardFiles.size() << " BIR shards failed."
+			<< std::endl;
+		return false;
 	}
 
-	Log::phase("emission of the target code [" + hllWriter->getId() + "]");
-	emitTargetHLLCode();
-
-	Log::phase("finalization");
-	finalize();
+	initLoadedBIR();
+	return true;
+}
 
-	Log::phase("cleanup");
-	cleanup();
+/**
+* @brief Prepares a loaded BIR module for the phases that follow the
+*        optimizations.
+*/
+void LlvmIr2Hll::initLoadedBIR()
+{
+	// Pattern finders need the alias analysis, which is otherwise initialized
+	// before the optimizations.
+	if (!globalConfig->parameters.isBackendNoOpts())
+	{
+		initAliasAnalysis();
+	}
+}
 
-	return false;
+/**
+* @brief Saves the optimized BIR module into the output BIR snapshot.
+*
+* A failure is not fatal, the decompilation continues without the snapshot.
+* The only exception is when nothing but the snapshot is produced.
+*
+* @return @c true if the decompilation should continue, @c false otherwise.
+*/
+bool LlvmIr2Hll::saveBIR()
+{
+	const auto& birFile = globalConfig->parameters.getOutputBirFile();
+	std::ofstream out(birFile, std::ios::binary);
+	if (!out || !llvmir2hll::BIRSnapshot::save(resModule, out))
+	{
+		bool birOnly = globalConfig->parameters.isBackendBirOnly();
+		Log::error() << (birOnly ? Log::Error : Log::Warning)
+			<< "Saving of BIR into " << birFile << " failed." << std::endl;
+		return !birOnly;
+	}
+	return true;
 }
 
 /**
@@ -299,11 +484,12 @@ bool LlvmIr2Hll::initialize(llvm::Module &m)
 
 	// Instantiate the requested alias analysis and make sure it exists.
 	Log::phase(
-		"creating the used alias analysis [" + oAliasAnalysis + "]",
+		"creating the used alias analysis ["
+		+ globalConfig->parameters.getBackendAliasAnalysis() + "]",
 		Log::SubPhase
 	);
 	aliasAnalysis = llvmir2hll::AliasAnalysisFactory::getInstance().createObject(
-		oAliasAnalysis
+		globalConfig->parameters.getBackendAliasAnalysis()
 	);
 	if (!aliasAnalysis)
 	{
@@ -511,6 +697,12 @@ bool LlvmIr2Hll::convertLLVMIRToBIR()
 	auto llvm2BIRConverter = llvmir2hll::LLVMIR2BIRConverter::create(this);
 	// Options
 	llvm2BIRConverter->setOptionStrictFPUSemantics(StrictFPUSemantics);
+	llvm2BIRConverter->setOptionReleaseLLVMFuncBodies(
+			globalConfig->parameters.isBackendReleaseLlvmIr()
+	);
+	llvm2BIRConverter->setOptionFuncCostLimit(
+			globalConfig->parameters.getBackendFunctionCostLimit()
+	);
 
 	std::string moduleName = ForcedModuleName.empty()
 			? llvmModule->getModuleIdentifier()
@@ -582,6 +774,58 @@ void LlvmIr2Hll::obtainDebugInfo()
 	llvmir2hll::LLVMDebugInfoObtainer::obtainVarNames(resModule);
 }
 
+/**
+* @brief Creates the cache of optimized functions and computes keys of
+*        functions in the input LLVM module.
+*
+* The context of the keys contains everything that influences the optimized
+* functions besides their code.
+*/
+void LlvmIr2Hll::createFuncResultCache()
+{
+	const auto &params = globalConfig->parameters;
+	const auto &arch = globalConfig->architecture;
+	std::string context = utils::version::getVersionStringLong()
+		+ "\narch: " + arch.getName()
+		+ " " + std::to_string(arch.getBitSize())
+		+ (arch.isEndianBig() ? " big" : " little")
+		+ "\nsemantics: " + oSemantics
+		+ "\nhll: " + TargetHLL
+		+ "\nenabled opts: " + params.getBackendEnabledOpts()
+		+ "\ndisabled opts: " + params.getBackendDisabledOpts()
+		+ "\ncall info obtainer: " + params.getBackendCallInfoObtainer()
+		+ "\nalias analysis: " + params.getBackendAliasAnalysis()
+		+ "\ncopy propagation limit: "
+			+ std::to_string(params.getBackendCopyPropStmtLimit())
+		+ "\nfunction cost limit: "
+			+ std::to_string(params.getBackendFunctionCostLimit())
+		+ "\nkeep library functions: "
+			+ std::to_string(params.isBackendKeepLibraryFuncs())
+		+ "\nstrict FPU semantics: " + std::to_string(StrictFPUSemantics)
+		+ "\ndebug: " + std::to_string(Debug);
+
+	funcResultCache = std::make_unique<llvmir2hll::FuncResultCache>(
+			params.getBackendFuncCacheDirectory(),
+			context
+	);
+	funcResultCache->computeKeys(*llvmModule);
+}
+
+/**
+* @brief Restores optimized functions of the resulting module from the cache.
+*
+* @return Functions that have been restored.
+*/
+llvmir2hll::FuncSet LlvmIr2Hll::restoreCachedFuncs()
+{
+	llvmir2hll::FuncSet restoredFuncs(funcResultCache->restore(resModule));
+	Log::phase(
+		"restored " + std::to_string(restoredFuncs.size()) + " function(s)",
+		Log::SubPhase
+	);
+	return restoredFuncs;
+}
+
 /**
 * @brief Initializes the alias analysis.
 */
@@ -592,8 +836,15 @@ void LlvmIr2Hll::initAliasAnalysis()
 
 /**
 * @brief Runs the optimizations over the resulting module.
+*
+* @param[in] restoredFuncs Functions restored from the cache, which are
+*                          already optimized.
+*
+* When the cache of optimized functions is used, the newly optimized functions
+* are stored into it, unless the optimizations ran out of resources (their
+* results might be worse than usual).
 */
-void LlvmIr2Hll::runOptimizations()
+void LlvmIr2Hll::runOptimizations(const llvmir2hll::FuncSet &restoredFuncs)
 {
 	ShPtr<llvmir2hll::OptimizerManager> optManager(
 			new llvmir2hll::OptimizerManager(
@@ -603,10 +854,22 @@ void LlvmIr2Hll::runOptimizations()
 					llvmir2hll::ValueAnalysis::create(aliasAnalysis, true),
 					cio,
 					arithmExprEvaluator,
-					Debug
+					Debug,
+					globalConfig->parameters.getBackendCopyPropStmtLimit()
 			)
 	);
+	optManager->skipFuncs(restoredFuncs);
 	optManager->optimize(resModule);
+
+	if (funcResultCache && !optManager->ranOutOfResources())
+	{
+		std::size_t storedFuncs = funcResultCache->store(resModule);
+		Log::phase(
+			"stored " + std::to_string(storedFuncs)
+				+ " function(s) into the cache",
+			Log::SubPhase
+		);
+	}
 }
 
 /**
@@ -631,6 +894,32 @@ void LlvmIr2Hll::convertConstantsToSymbolicNames()
 */
 void LlvmIr2Hll::validateResultingModule()
 {
+	// In the sampled validation, validate only every n-th function so that
+	// the given percentage of functions, spread over the whole module, gets
+	// validated.
+	bool sampled = globalConfig->parameters.getBackendValidation() == "sampled";
+	llvmir2hll::FuncSet sampledFuncs;
+	if (sampled)
+	{
+		auto percent = globalConfig->parameters.getBackendValidationSamplePercent();
+		std::size_t n = 0;
+		for (auto i = resModule->func_definition_begin(),
+				e = resModule->func_definition_end();
+				i != e;
+				++i, ++n)
+		{
+			if ((n * percent) % 100 < percent)
+			{
+				sampledFuncs.insert(*i);
+			}
+		}
+		Log::phase(
+			"validating " + std::to_string(sampledFuncs.size()) + " of "
+			+ std::to_string(n) + " functions",
+			Log::SubPhase
+		);
+	}
+
 	// Run all the registered validators over the resulting module, sorted by
 	// name.
 	llvmir2hll::StringVector regValidatorIDs(
@@ -643,6 +932,10 @@ void LlvmIr2Hll::validateResultingModule()
 		ShPtr<llvmir2hll::Validator> validator(
 				llvmir2hll::ValidatorFactory::getInstance().createObject(id)
 		);
+		if (sampled)
+		{
+			validator->restrictToFuncs(sampledFuncs);
+		}
 		validator->validate(resModule, true);
 	}
 }
@@ -736,41 +1029,72 @@ void LlvmIr2Hll::emitCFGs()
 	// writer's name for this purpose).
 	std::string fileExt(oCFGWriter);
 
-	// For each function in the resulting module...
-	for (auto i = resModule->func_definition_begin(),
-			e = resModule->func_definition_end();
-			i != e;
-			++i)
+	llvmir2hll::FuncVector funcs(
+			resModule->func_definition_begin(),
+			resModule->func_definition_end()
+	);
+	const unsigned threads = std::max<uint64_t>(
+			1, globalConfig->parameters.getBackendGraphThreads());
+
+	// CFGs are built on this thread by batches because the builder creates
+	// expressions (edge labels) observing the ones in the module, which may be
+	// shared by several functions. The CFGs are then emitted into memory and
+	// written into their files in parallel, which only reads them.
+	const std::size_t batchSize = 16 * threads;
+	for (std::size_t first = 0; first < funcs.size(); first += batchSize)
 	{
-		// Open the output file.
-		std::string fileName(
-				globalConfig->parameters.getOutputFile()
-				+ ".cfg." + (*i)->getName() + "." + fileExt
-		);
-		std::ofstream out(fileName.c_str());
-		if (!out)
+		const auto count = std::min(batchSize, funcs.size() - first);
+		std::vector<ShPtr<llvmir2hll::CFG>> cfgs;
+		cfgs.reserve(count);
+		for (std::size_t i = 0; i < count; ++i)
 		{
-			Log::error() << Log::Error
-				<< "Cannot open " + fileName + " for writing."
-				<< std::endl;
-			return;
+			cfgs.push_back(cfgBuilder->getCFG(funcs[first + i]));
+		}
+
+		std::vector<std::string> failedFiles(count);
+		retdec::utils::parallelFor(count, threads, [&](std::size_t i)
+		{
+			std::string fileName(
+					globalConfig->parameters.getOutputFile()
+					+ ".cfg." + funcs[first + i]->getName() + "." + fileExt
+			);
+
+			std::ostringstream dot;
+			auto& cfgwf = llvmir2hll::CFGWriterFactory::getInstance();
+			ShPtr<llvmir2hll::CFGWriter> writer(
+					cfgwf.createObject<ShPtr<llvmir2hll::CFG>, std::ostream &>(
+							oCFGWriter,
+							ShPtr<llvmir2hll::CFG>(cfgs[i]),
+							dot
+					)
+			);
+			ASSERT_MSG(
+					writer,
+					"instantiation of the requested CFG writer `"
+					<< oCFGWriter << "` failed"
+			);
+			writer->emitCFG();
+
+			std::ofstream out(fileName.c_str());
+			if (!out)
+			{
+				failedFiles[i] = fileName;
+				return;
+			}
+			const auto text = dot.str();
+			out.write(text.data(), text.size());
+		});
+
+		for (const auto& fileName : failedFiles)
+		{
+			if (!fileName.empty())
+			{
+				Log::error() << Log::Error
+					<< "Cannot open " + fileName + " for writing."
+					<< std::endl;
+				return;
+			}
 		}
-		// Create a CFG for the current function and emit it into the opened
-		// file.
-		auto& cfgwf = llvmir2hll::CFGWriterFactory::getInstance();
-		ShPtr<llvmir2hll::CFGWriter> writer(
-				cfgwf.createObject<ShPtr<llvmir2hll::CFG>, std::ostream &>(
-						oCFGWriter,
-						cfgBuilder->getCFG(*i),
-						out
-				)
-		);
-		ASSERT_MSG(
-				writer,
-				"instantiation of the requested CFG writer `"
-				<< oCFGWriter << "` failed"
-		);
-		writer->emitCFG();
 	}
 }
 
@@ -817,11 +1141,16 @@ void LlvmIr2Hll::emitCG()
 		return;
 	}
 
-	// Create a CG for the current module and emit it into the opened file.
+	// Create a CG for the current module (unless pattern finding has just
+	// created it) and emit it into the opened file.
+	if (!resModuleCG)
+	{
+		resModuleCG = llvmir2hll::CGBuilder::getCG(resModule);
+	}
 	auto& cgwf = llvmir2hll::CGWriterFactory::getInstance();
 	ShPtr<llvmir2hll::CGWriter> writer(
 			cgwf.createObject<ShPtr<llvmir2hll::CG>, std::ostream &>(
-			oCGWriter, llvmir2hll::CGBuilder::getCG(resModule), out
+			oCGWriter, ShPtr<llvmir2hll::CG>(resModuleCG), out
 	));
 	ASSERT_MSG(
 			writer,
@@ -876,8 +1205,10 @@ LlvmIr2Hll::instantiatePatternFinders(
 	ShPtr<llvmir2hll::ValueAnalysis> va(
 			llvmir2hll::ValueAnalysis::create(aliasAnalysis, true));
 
-	// Re-initialize cio to be sure its up-to-date.
-	cio->init(llvmir2hll::CGBuilder::getCG(resModule), va);
+	// Re-initialize cio to be sure its up-to-date. Pattern finders do not
+	// modify the module, so the CG is reused when emitting it.
+	resModuleCG = llvmir2hll::CGBuilder::getCG(resModule);
+	cio->init(resModuleCG, va);
 
 	llvmir2hll::PatternFinderRunner::PatternFinders pfs;
 	for (const auto &pfId : pfsIds)
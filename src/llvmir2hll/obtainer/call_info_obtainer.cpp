@@ -5,6 +5,10 @@
 */
 
 #include <cstddef>
+#include <queue>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "retdec/llvmir2hll/analysis/value_analysis.h"
 #include "retdec/llvmir2hll/graphs/cfg/cfg_builders/non_recursive_cfg_builder.h"
@@ -19,8 +23,6 @@
 
 using namespace retdec::utils::io;
 using retdec::utils::hasItem;
-using retdec::utils::setDifference;
-using retdec::utils::setUnion;
 
 namespace retdec {
 namespace llvmir2hll {
@@ -73,12 +75,22 @@ ShPtr<CG> CallInfoObtainer::getCG() const {
 /**
 * @brief Returns the CFG for @a func after the obtainer has been initialized.
 *
-* If the obtainer hasn't been initialized or there is no CFG for @a func, it
+* If the obtainer hasn't been initialized or @a func is not in the module, it
 * returns the null pointer.
+*
+* The CFG is built upon the first request and reused until the next call to
+* init().
 */
 ShPtr<CFG> CallInfoObtainer::getCFGForFunc(ShPtr<Function> func) const {
 	auto i = funcCFGMap.find(func);
-	return i != funcCFGMap.end() ? i->second : ShPtr<CFG>();
+	if (i == funcCFGMap.end()) {
+		return ShPtr<CFG>();
+	}
+
+	if (!i->second) {
+		i->second = cfgBuilder->getCFG(func);
+	}
+	return i->second;
 }
 
 /**
@@ -107,10 +119,10 @@ void CallInfoObtainer::init(ShPtr<CG> cg, ShPtr<ValueAnalysis> va) {
 	module = cg->getCorrespondingModule();
 	funcCFGMap.clear();
 
-	// To speedup the initialization, compute and store the CFG for each
-	// function.
+	// CFGs are computed lazily in getCFGForFunc() because many functions
+	// never need one.
 	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
-		funcCFGMap[*i] = cfgBuilder->getCFG(*i);
+		funcCFGMap[*i] = ShPtr<CFG>();
 	}
 }
 
@@ -131,22 +143,9 @@ ShPtr<CallInfoObtainer::FuncInfoCompOrder> CallInfoObtainer::getFuncInfoCompOrde
 		ShPtr<CG> cg) {
 	ShPtr<FuncInfoCompOrder> fico(new FuncInfoCompOrder());
 
-	// Below, remainingFuncs contains functions which haven't been added into
-	// the computation order. In computedFuncs, we store functions which have
-	// been added into the computation order. Our algorithm terminates when
-	// remainingFuncs is empty.
-	//
-	// In the initialization, we add all function declarations into fico->order
-	// and into computedFuncs because they have to be computed before FuncInfos
-	// for function definitions are computed.
-	FuncSet remainingFuncs(
-		module->func_definition_begin(),
-		module->func_definition_end()
-	);
-	FuncSet computedFuncs(
-		module->func_declaration_begin(),
-		module->func_declaration_end()
-	);
+	// All function declarations are put at the beginning of the order because
+	// they have to be computed before FuncInfos for function definitions are
+	// computed.
 	fico->order.assign(
 		module->func_declaration_begin(),
 		module->func_declaration_end()
@@ -154,112 +153,93 @@ ShPtr<CallInfoObtainer::FuncInfoCompOrder> CallInfoObtainer::getFuncInfoCompOrde
 
 	fico->sccs = computeSCCs();
 
-	// The main algorithm.
-	while (!remainingFuncs.empty()) {
-		// Keep including functions which call just functions from
-		// computedFuncs into fico->order until fico->order is unchanged.
-		std::size_t oldFicoOrderSize;
-		do {
-			oldFicoOrderSize = fico->order.size();
-			// Since remainingFuncs may be modified during the following
-			// iteration over it, iterate over a copy of it.
-			FuncSet remainingFuncsCopy(remainingFuncs);
-			for (const auto &func : remainingFuncsCopy) {
-				if (callsJustComputedFuncs(func, computedFuncs)) {
-					fico->order.push_back(func);
-					remainingFuncs.erase(func);
-					computedFuncs.insert(func);
+	// The order is computed as a topological order of the condensation of
+	// the call graph (restricted to function definitions), i.e. of the graph
+	// in which every SCC is contracted into a single node. Every function
+	// that is not a member of an SCC forms a node on its own. A node can be
+	// included into the order when all the nodes it calls have already been
+	// included. Since the nodes are processed from a worklist, every node is
+	// inspected only once.
+	std::vector<FuncSet> nodes;
+	std::unordered_map<ShPtr<Function>, std::size_t> funcNodes;
+	for (const auto &scc : fico->sccs) {
+		for (const auto &func : scc) {
+			funcNodes.emplace(func, nodes.size());
+		}
+		nodes.push_back(scc);
+	}
+	for (auto i = module->func_definition_begin(),
+			e = module->func_definition_end(); i != e; ++i) {
+		if (funcNodes.emplace(*i, nodes.size()).second) {
+			nodes.push_back(FuncSet{*i});
+		}
+	}
+
+	std::vector<std::size_t> numOfUncomputedCallees(nodes.size(), 0);
+	std::vector<std::vector<std::size_t>> callers(nodes.size());
+	for (std::size_t node = 0; node < nodes.size(); ++node) {
+		std::set<std::size_t> calleeNodes;
+		for (const auto &func : nodes[node]) {
+			for (const auto &callee : cg->getCalledFuncs(func)->callees) {
+				auto calleeNodeIt = funcNodes.find(callee);
+				// Declarations have already been included into the order.
+				if (calleeNodeIt != funcNodes.end() &&
+						calleeNodeIt->second != node) {
+					calleeNodes.insert(calleeNodeIt->second);
 				}
 			}
-		} while (oldFicoOrderSize < fico->order.size());
-
-		if (!remainingFuncs.empty()) {
-			// There has to be an SCC. We find a next SCC, include a member of
-			// it into fico->order, mark all functions in the SCC as computed,
-			// and move to the next iteration.
-			SCCWithRepresent sccWithRepresent(findNextSCC(fico->sccs,
-				computedFuncs, remainingFuncs));
-			fico->order.push_back(sccWithRepresent.represent);
-			for (auto i = sccWithRepresent.scc.begin(),
-					e = sccWithRepresent.scc.end(); i != e; ++i) {
-				computedFuncs.insert(*i);
-				remainingFuncs.erase(*i);
-			}
+		}
+		numOfUncomputedCallees[node] = calleeNodes.size();
+		for (auto calleeNode : calleeNodes) {
+			callers[calleeNode].push_back(node);
 		}
 	}
 
-	return fico;
-}
-
-/**
-* @brief Returns @c true if @a func calls just functions from @a computedFuncs,
-*        @c false otherwise.
-*/
-bool CallInfoObtainer::callsJustComputedFuncs(ShPtr<Function> func,
-		const FuncSet &computedFuncs) const {
-	ShPtr<CG::CalledFuncs> calledFuncs(cg->getCalledFuncs(func));
-	for (const auto &callee : calledFuncs->callees) {
-		if (!hasItem(computedFuncs, callee)) {
-			return false;
+	std::queue<std::size_t> readyNodes;
+	for (std::size_t node = 0; node < nodes.size(); ++node) {
+		if (numOfUncomputedCallees[node] == 0) {
+			readyNodes.push(node);
 		}
 	}
-	return true;
-}
 
-/**
-* @brief Finds a next SCC and its represent and returns them.
-*
-* @param[in] sccs All SCCs in the call graph.
-* @param[in] computedFuncs Functions that already have been included in
-*                          FuncInfoCompOrder::order.
-* @param[in] remainingFuncs Functions that haven't been included in
-*                           FuncInfoCompOrder::order.
-*
-* @par Preconditions
-*  - @a remainingFuncs is non-empty
-*  - @a remainingFuncs doesn't contain a function which calls just functions
-*    from @a computedFuncs.
-*/
-CallInfoObtainer::SCCWithRepresent CallInfoObtainer::findNextSCC(
-		const FuncVectorSet &sccs, const FuncSet &computedFuncs,
-		const FuncSet &remainingFuncs) const {
-	PRECONDITION(!remainingFuncs.empty(), "it should not be empty");
-
-	//
-	// We try to locate an SCC whose members call just the functions in
-	// the SCC or in computedFuncs. Then, if the found SCC contains a function
-	// from remainingFuncs, return the function.
-	//
-	// For every SCC...
-	for (const auto &scc : sccs) {
-		bool sccFound = true;
-		ShPtr<Function> funcFromRemainingFuncs;
-		// For every function in the SCC...
-		for (const auto &func : scc) {
-			// Check whether the function calls just the functions in the SCC
-			// or in computedFuncs.
-			ShPtr<CG::CalledFuncs> calledFuncs(cg->getCalledFuncs(func));
-			FuncSet mayCall(setUnion(scc, computedFuncs));
-			if (!setDifference(calledFuncs->callees, mayCall).empty()) {
-				sccFound = false;
-			} else {
-				// Have we encountered a function from remainingFuncs?
-				if (hasItem(remainingFuncs, func)) {
-					funcFromRemainingFuncs = func;
-				}
+	std::vector<bool> computedNodes(nodes.size(), false);
+	std::size_t numOfComputedNodes = 0;
+	std::size_t nextUncomputedNode = 0;
+	while (numOfComputedNodes < nodes.size()) {
+		if (readyNodes.empty()) {
+			// This should not happen because the condensation of a graph is
+			// acyclic. Nevertheless, to guarantee termination, pick the
+			// first node that has not yet been computed.
+			Log::error() << Log::Warning
+				<< "[SCCComputer] No viable SCC has been found." << std::endl;
+			while (computedNodes[nextUncomputedNode]) {
+				++nextUncomputedNode;
 			}
+			readyNodes.push(nextUncomputedNode);
+			numOfUncomputedCallees[nextUncomputedNode] = 0;
 		}
-		if (sccFound && funcFromRemainingFuncs) {
-			return SCCWithRepresent(scc, funcFromRemainingFuncs);
+
+		auto node = readyNodes.front();
+		readyNodes.pop();
+		if (computedNodes[node]) {
+			continue;
+		}
+		computedNodes[node] = true;
+		++numOfComputedNodes;
+
+		// All members of an SCC are computed at once, so it suffices to
+		// include one of them into the order.
+		fico->order.push_back(*nodes[node].rbegin());
+
+		for (auto caller : callers[node]) {
+			if (numOfUncomputedCallees[caller] > 0 &&
+					--numOfUncomputedCallees[caller] == 0) {
+				readyNodes.push(caller);
+			}
 		}
 	}
 
-	// TODO Can this happen?
-	Log::error() << Log::Warning << "[SCCComputer] No viable SCC has been found." << std::endl;
-	FuncSet scc;
-	ShPtr<Function> func(*(remainingFuncs.begin()));
-	scc.insert(func);
-	return SCCWithRepresent(scc, func);
+	return fico;
 }
 
 /**
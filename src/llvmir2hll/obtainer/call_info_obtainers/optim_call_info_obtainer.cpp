@@ -4,6 +4,8 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <unordered_map>
+
 #include "retdec/llvmir2hll/graphs/cfg/cfg_traversals/optim_func_info_cfg_traversal.h"
 #include "retdec/llvmir2hll/graphs/cg/cg.h"
 #include "retdec/llvmir2hll/ir/call_expr.h"
@@ -190,6 +192,15 @@ void OptimCallInfoObtainer::computeAllFuncInfos() {
 	// Obtain the order in which function information should be computed.
 	ShPtr<FuncInfoCompOrder> fico(getFuncInfoCompOrder(cg));
 
+	// Map every function from an SCC to its SCC so we do not have to go
+	// through all the SCCs for every function in the order.
+	std::unordered_map<ShPtr<Function>, const FuncSet *> funcSCCs;
+	for (const auto &scc : fico->sccs) {
+		for (const auto &func : scc) {
+			funcSCCs.emplace(func, &scc);
+		}
+	}
+
 	// Compute the information from the obtained order.
 	for (const auto &func : fico->order) {
 		// Based on the description of CallInfoObtainer::FuncInfoOrder, we
@@ -197,11 +208,9 @@ void OptimCallInfoObtainer::computeAllFuncInfos() {
 		// SCC that contains it.
 		computeFuncInfo(func);
 
-		// For each SCC in the order...
-		for (const auto &scc : fico->sccs) {
-			if (hasItem(scc, func)) {
-				computeFuncInfos(scc);
-			}
+		auto sccIt = funcSCCs.find(func);
+		if (sccIt != funcSCCs.end()) {
+			computeFuncInfos(*sccIt->second);
 		}
 	}
 }
@@ -278,7 +287,7 @@ ShPtr<OptimFuncInfo> OptimCallInfoObtainer::computeFuncInfoDeclaration(
 ShPtr<OptimFuncInfo> OptimCallInfoObtainer::computeFuncInfoDefinition(
 		ShPtr<Function> func) {
 	return OptimFuncInfoCFGTraversal::getOptimFuncInfo(module,
-		ucast<OptimCallInfoObtainer>(shared_from_this()), va, funcCFGMap[func]);
+		ucast<OptimCallInfoObtainer>(shared_from_this()), va, getCFGForFunc(func));
 }
 
 /**
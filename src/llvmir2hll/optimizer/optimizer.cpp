@@ -4,9 +4,13 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include "retdec/llvmir2hll/ir/function.h"
 #include "retdec/llvmir2hll/ir/module.h"
 #include "retdec/llvmir2hll/optimizer/optimizer.h"
 #include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/utils/container.h"
+
+using retdec::utils::hasItem;
 
 namespace retdec {
 namespace llvmir2hll {
@@ -43,6 +47,29 @@ ShPtr<Module> Optimizer::optimize() {
 	return module;
 }
 
+/**
+* @brief Restricts the optimization to the given functions.
+*
+* Other functions in the module are left untouched. The restriction is
+* honored by FuncOptimizer::doOptimization() and by optimizers that check
+* shouldBeOptimized() themselves. Only optimizations whose results for a
+* function do not depend on other functions should be restricted.
+*/
+void Optimizer::restrictToFuncs(const FuncSet &funcs) {
+	funcsToOptimize = funcs;
+	restrictedToFuncs = true;
+}
+
+/**
+* @brief Returns @c true if @a func should be optimized, @c false otherwise.
+*
+* If the optimization has not been restricted by restrictToFuncs(), all
+* functions should be optimized.
+*/
+bool Optimizer::shouldBeOptimized(ShPtr<Function> func) const {
+	return !restrictedToFuncs || hasItem(funcsToOptimize, func);
+}
+
 /**
 * @brief Performs pre-optimization matters.
 *
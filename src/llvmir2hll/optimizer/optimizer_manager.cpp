@@ -5,11 +5,15 @@
 */
 
 #include <chrono>
+#include <iomanip>
+#include <sstream>
 #include <thread>
 
 #include "retdec/llvmir2hll/analysis/value_analysis.h"
 #include "retdec/llvmir2hll/graphs/cg/cg_builder.h"
 #include "retdec/llvmir2hll/hll/hll_writer.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/module.h"
 #include "retdec/llvmir2hll/obtainer/call_info_obtainer.h"
 #include "retdec/llvmir2hll/optimizer/optimizer_manager.h"
 #include "retdec/llvmir2hll/optimizer/optimizers/bit_op_to_log_op_optimizer.h"
@@ -45,7 +49,10 @@
 #include "retdec/llvmir2hll/optimizer/optimizers/while_true_to_ufor_loop_optimizer.h"
 #include "retdec/llvmir2hll/optimizer/optimizers/while_true_to_while_cond_optimizer.h"
 #include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/func_fingerprinter.h"
+#include "retdec/utils/cancellation.h"
 #include "retdec/utils/container.h"
+#include "retdec/utils/instrumentation.h"
 #include "retdec/utils/string.h"
 #include "retdec/utils/system.h"
 #include "retdec/utils/io/log.h"
@@ -63,6 +70,14 @@ namespace {
 /// Suffix of all optimizers.
 const std::string OPT_SUFFIX = "Optimizer";
 
+/// Optimizations that are not run on degraded functions (see
+/// Module::getDegradedFuncs()). Their run time grows faster than linearly with
+/// the size of a function.
+const StringSet OPTS_SKIPPED_ON_DEGRADED_FUNCS = {
+	"CopyPropagation",
+	"DeadLocalAssign",
+};
+
 /**
 * @brief Trims the optional suffix "Optimizer" from all optimization names in
 *        @a opts.
@@ -97,6 +112,9 @@ StringSet trimOptimizerSuffix(const StringSet &opts) {
 * @param[in] cio Call info obtainer.
 * @param[in] arithmExprEvaluator Used evaluator of arithmetical expressions.
 * @param[in] enableDebug Enables emission of debug messages.
+* @param[in] copyPropStmtLimit Functions with more statements than this are
+*                              optimized only by SimpleCopyPropagationOptimizer.
+*                              Zero means no limit.
 *
 * To perform the actual optimizations, call optimize(). To get a list of
 * available optimizations and their names, see our wiki.
@@ -116,21 +134,38 @@ StringSet trimOptimizerSuffix(const StringSet &opts) {
 OptimizerManager::OptimizerManager(const StringSet &enabledOpts,
 	const StringSet &disabledOpts, ShPtr<HLLWriter> hllWriter,
 	ShPtr<ValueAnalysis> va, ShPtr<CallInfoObtainer> cio,
-	ShPtr<ArithmExprEvaluator> arithmExprEvaluator, bool enableDebug):
+	ShPtr<ArithmExprEvaluator> arithmExprEvaluator, bool enableDebug,
+	std::size_t copyPropStmtLimit):
 		enabledOpts(trimOptimizerSuffix(enabledOpts)),
 		disabledOpts(trimOptimizerSuffix(disabledOpts)),
 		hllWriter(hllWriter), va(va), cio(cio),
 		arithmExprEvaluator(arithmExprEvaluator),
-		enableDebug(enableDebug),
-		recoverFromOutOfMemory(true), backendRunOpts() {
+		enableDebug(enableDebug), copyPropStmtLimit(copyPropStmtLimit),
+		recoverFromOutOfMemory(true) {
 			PRECONDITION_NON_NULL(hllWriter);
 			PRECONDITION_NON_NULL(va);
 			PRECONDITION_NON_NULL(cio);
 			PRECONDITION_NON_NULL(arithmExprEvaluator);
 		}
 
+/**
+* @brief Prevents the given functions from being optimized.
+*
+* This is useful for functions that are already optimized (e.g. when they have
+* been restored from a cache). The functions are skipped by all optimizations
+* that can be restricted to some functions (see Optimizer::restrictToFuncs()).
+*/
+void OptimizerManager::skipFuncs(const FuncSet &funcs) {
+	skippedFuncs = funcs;
+}
+
 /**
 * @brief Runs the optimizations over @a m.
+*
+* After each optimization, the manager finds out which functions have been
+* modified by it. Optimizations that are run repeatedly (see rerun()) are then
+* run only over the functions that have been modified since their last run,
+* and they are skipped when there are no such functions.
 */
 void OptimizerManager::optimize(ShPtr<Module> m) {
 	// All optimizations should be run in order from the one that eliminates
@@ -140,6 +175,9 @@ void OptimizerManager::optimize(ShPtr<Module> m) {
 	// Of course, if some optimization depend on another one, the order is
 	// clear.
 
+	updateFuncStates(m);
+	degradedFuncs = m->getDegradedFuncs();
+
 	//
 	// Perform HLL-independent optimizations.
 	//
@@ -158,7 +196,7 @@ void OptimizerManager::optimize(ShPtr<Module> m) {
 	run<UnusedGlobalVarOptimizer>(m);
 	run<DeadLocalAssignOptimizer>(m, va);
 	run<SimpleCopyPropagationOptimizer>(m, va, cio);
-	run<CopyPropagationOptimizer>(m, va, cio);
+	run<CopyPropagationOptimizer>(m, va, cio, copyPropStmtLimit);
 
 	// SimplifyArithmExprOptimizer should be run before loop optimizations.
 	run<SimplifyArithmExprOptimizer>(m, arithmExprEvaluator);
@@ -201,17 +239,17 @@ void OptimizerManager::optimize(ShPtr<Module> m) {
 	run<DerefAddressOptimizer>(m);
 	run<EmptyArrayToStringOptimizer>(m);
 	run<BitOpToLogOpOptimizer>(m, va);
-	run<SimplifyArithmExprOptimizer>(m, arithmExprEvaluator);
+	rerun<SimplifyArithmExprOptimizer>(m, arithmExprEvaluator);
 
 	// Data-flow optimizations.
 	// Run the CopyPropagationOptimizer once more to produce more readable
-	// output. However, do this only if an optimization different than
-	// CopyPropagation was run; otherwise, it makes no sense to run it again.
+	// output. However, do this only if a function has been modified since its
+	// first run; otherwise, it makes no sense to run it again.
 	if (shouldSecondCopyPropagationBeRun()) {
 		run<UnusedGlobalVarOptimizer>(m);
 		run<DeadLocalAssignOptimizer>(m, va);
 		run<SimpleCopyPropagationOptimizer>(m, va, cio);
-		run<CopyPropagationOptimizer>(m, va, cio);
+		run<CopyPropagationOptimizer>(m, va, cio, copyPropStmtLimit);
 	}
 
 	// This is best to be run after DeadLocalAssignOptimizer and
@@ -228,12 +266,12 @@ void OptimizerManager::optimize(ShPtr<Module> m) {
 	run<VarDefForLoopOptimizer>(m);
 	run<VarDefStmtOptimizer>(m, va);
 
-	run<EmptyStmtOptimizer>(m);
-	run<GotoStmtOptimizer>(m);
+	rerun<EmptyStmtOptimizer>(m);
+	rerun<GotoStmtOptimizer>(m);
 
 	// SimplifyArithmExprOptimizer should be run at the end to produce the most
 	// readable output.
-	run<SimplifyArithmExprOptimizer>(m, arithmExprEvaluator);
+	rerun<SimplifyArithmExprOptimizer>(m, arithmExprEvaluator);
 
 	// DeadCodeOptimizer should be run at the end because it is better when
 	// SimplifyArithmExprOptimizer optimizes expressions in conditions and then
@@ -250,6 +288,15 @@ void OptimizerManager::optimize(ShPtr<Module> m) {
 	run<CArrayArgOptimizer>(m);
 }
 
+/**
+* @brief Returns @c true if some optimizations have not been run, or have been
+*        interrupted, because they ran out of time or memory, @c false
+*        otherwise.
+*/
+bool OptimizerManager::ranOutOfResources() const {
+	return phaseBudgetExpired || recoveredFromOutOfMemory;
+}
+
 /**
 * @brief Returns @c true if the optimization with @a optId should be run, @c
 *        false otherwise.
@@ -269,16 +316,104 @@ bool OptimizerManager::optShouldBeRun(const std::string &optId) const {
 }
 
 /**
-* @brief Runs the given optimizer provided that it should be run.
+* @brief Runs the given optimizer over @a m provided that it should be run.
+*
+* When the phase budget of the current cancellation token is spent, the
+* remaining optimizations are skipped.
+*
+* If @a onlyOnModifiedFuncs is @c true and the optimizer has already been run,
+* it is restricted to the functions that have been modified since its last run.
+* Expensive optimizers are not run on functions that were too costly to be
+* structured, which is recorded into the module config. When there are no
+* functions left, the optimizer is not run at all.
 */
-void OptimizerManager::runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimizer) {
+void OptimizerManager::runOptimizerProvidedItShouldBeRun(ShPtr<Module> m,
+		ShPtr<Optimizer> optimizer, bool onlyOnModifiedFuncs) {
+	retdec::utils::throwIfCancellationRequested();
+
 	const std::string OPT_ID = optimizer->getId();
 	if (!optShouldBeRun(OPT_ID)) {
 		return;
 	}
 
+	if (retdec::utils::isPhaseBudgetExpired()) {
+		if (!phaseBudgetExpired) {
+			Log::error() << Log::Warning << "optimizations ran out of "
+				<< (retdec::utils::isMemoryLimitExceeded() ? "memory" : "time")
+				<< ", skipping " << OPT_ID << " and all the following ones"
+				<< std::endl;
+			phaseBudgetExpired = true;
+		}
+		return;
+	}
+
+	FuncSet funcsToOptimize;
+	bool restricted = false;
+	if (onlyOnModifiedFuncs) {
+		auto lastRun = lastRuns.find(OPT_ID);
+		if (lastRun != lastRuns.end()) {
+			funcsToOptimize = getFuncsModifiedSince(lastRun->second);
+			if (funcsToOptimize.empty()) {
+				// Nothing has changed since the last run, so running the
+				// optimization again would not change anything either.
+				if (enableDebug) {
+					Log::phase("skipping "s + OPT_ID + OPT_SUFFIX +
+						" (no modified functions)", Log::SubPhase);
+				}
+				return;
+			}
+			restricted = true;
+		}
+	}
+
+	bool skipDegradedFuncs = !degradedFuncs.empty() &&
+		hasItem(OPTS_SKIPPED_ON_DEGRADED_FUNCS, OPT_ID);
+	if (!restricted && (skipDegradedFuncs || !skippedFuncs.empty())) {
+		for (auto i = m->func_definition_begin(),
+				e = m->func_definition_end(); i != e; ++i) {
+			funcsToOptimize.insert(*i);
+		}
+		restricted = true;
+	}
+
+	if (!skippedFuncs.empty()) {
+		for (const auto &func : skippedFuncs) {
+			funcsToOptimize.erase(func);
+		}
+		if (funcsToOptimize.empty()) {
+			if (enableDebug) {
+				Log::phase("skipping "s + OPT_ID + OPT_SUFFIX +
+					" (only skipped functions)", Log::SubPhase);
+			}
+			return;
+		}
+	}
+
+	if (skipDegradedFuncs) {
+		for (const auto &func : degradedFuncs) {
+			if (funcsToOptimize.erase(func) != 0) {
+				m->markFuncAsDegraded(func, "skipped"s + OPT_ID + OPT_SUFFIX);
+			}
+		}
+		if (funcsToOptimize.empty()) {
+			if (enableDebug) {
+				Log::phase("skipping "s + OPT_ID + OPT_SUFFIX +
+					" (only degraded functions)", Log::SubPhase);
+			}
+			return;
+		}
+	}
+
+	if (restricted) {
+		optimizer->restrictToFuncs(funcsToOptimize);
+	}
+
 	printOptimization(OPT_ID);
 
+	RETDEC_SCOPED_TIMER(retdec::utils::instrumentation::isEnabled()
+		? retdec::utils::instrumentation::intern("optimizer." + OPT_ID)
+		: nullptr);
+	auto startTime = std::chrono::steady_clock::now();
 	if (recoverFromOutOfMemory) {
 		// Some optimizations, most notable CopyPropagation, may run out of
 		// memory on huge inputs. We try to recover from such situations by
@@ -290,14 +425,19 @@ void OptimizerManager::runOptimizerProvidedItShouldBeRun(ShPtr<Optimizer> optimi
 			optimizer->optimize();
 		} catch (const std::bad_alloc &) {
 			Log::error() << Log::Warning << "out of memory; trying to recover" << std::endl;
+			recoveredFromOutOfMemory = true;
 			std::this_thread::sleep_for(std::chrono::seconds(1));
 		}
 	} else {
 		// Just run the optimizer and let std::bad_alloc propagate.
 		optimizer->optimize();
 	}
+	std::chrono::duration<double> runTime(
+		std::chrono::steady_clock::now() - startTime);
 
-	backendRunOpts.insert(OPT_ID);
+	lastRuns[OPT_ID] = ++numOfRunOpts;
+	std::size_t numOfModifiedFuncs = updateFuncStates(m);
+	printOptimizationStats(OPT_ID, runTime.count(), numOfModifiedFuncs);
 }
 
 /**
@@ -312,6 +452,27 @@ void OptimizerManager::printOptimization(const std::string &optId) const {
 	}
 }
 
+/**
+* @brief Prints statistics about the just finished optimization with @a optId.
+*
+* @param[in] optId ID of the optimization.
+* @param[in] seconds How long the optimization took.
+* @param[in] numOfModifiedFuncs Number of functions modified by the
+*                               optimization.
+*
+* If @c enableDebug is @c false, this function does nothing.
+*/
+void OptimizerManager::printOptimizationStats(const std::string &optId,
+		double seconds, std::size_t numOfModifiedFuncs) const {
+	if (enableDebug) {
+		std::ostringstream formattedTime;
+		formattedTime << std::fixed << std::setprecision(2) << seconds;
+		Log::info() << Log::SubSubPhase << optId << OPT_SUFFIX << " took "
+			<< formattedTime.str() << "s and modified " << numOfModifiedFuncs
+			<< " function(s)" << std::endl;
+	}
+}
+
 /**
 * @brief Returns @c true if a second pass of CopyPropagation should be run,
 *        @c false otherwise.
@@ -327,14 +488,57 @@ bool OptimizerManager::shouldSecondCopyPropagationBeRun() const {
 		// It is disabled.
 		return false;
 	}
-	//  (2) if CopyPropagation was run, then check that at least one different
-	//      optimization was run.
-	if (hasItem(backendRunOpts, COPY_PROP_ID)) {
-		return backendRunOpts.size() > 1;
+	//  (2) if CopyPropagation was run, then check that at least one function
+	//      has been modified since then (otherwise, the data-flow
+	//      optimizations have already reached a fixpoint).
+	auto lastRun = lastRuns.find(COPY_PROP_ID);
+	if (lastRun != lastRuns.end()) {
+		return !getFuncsModifiedSince(lastRun->second).empty();
 	}
 	return true;
 }
 
+/**
+* @brief Recomputes the states of all functions in @a m.
+*
+* Functions whose fingerprint has changed (or which are new) are marked as
+* modified by the last run optimization.
+*
+* @return Number of modified functions.
+*/
+std::size_t OptimizerManager::updateFuncStates(ShPtr<Module> m) {
+	std::size_t numOfModifiedFuncs = 0;
+	std::unordered_map<ShPtr<Function>, FuncState> newFuncStates;
+	for (auto i = m->func_begin(), e = m->func_end(); i != e; ++i) {
+		auto fingerprint = FuncFingerprinter::fingerprint(*i);
+		auto oldState = funcStates.find(*i);
+		if (oldState != funcStates.end() &&
+				oldState->second.fingerprint == fingerprint) {
+			newFuncStates.emplace(*i, oldState->second);
+		} else {
+			newFuncStates.emplace(*i, FuncState{fingerprint, numOfRunOpts});
+			++numOfModifiedFuncs;
+		}
+	}
+	funcStates = std::move(newFuncStates);
+	return numOfModifiedFuncs;
+}
+
+/**
+* @brief Returns the functions that have been modified after the first @a
+*        numOfRunOptsSoFar optimizations were run.
+*/
+FuncSet OptimizerManager::getFuncsModifiedSince(
+		std::size_t numOfRunOptsSoFar) const {
+	FuncSet modifiedFuncs;
+	for (const auto &p : funcStates) {
+		if (p.second.lastModification > numOfRunOptsSoFar) {
+			modifiedFuncs.insert(p.first);
+		}
+	}
+	return modifiedFuncs;
+}
+
 /**
 * @brief Runs the given optimization (specified in the template parameter) over
 *        @a m with the given arguments.
@@ -353,7 +557,29 @@ template<typename Optimization, typename... Args>
 void OptimizerManager::run(ShPtr<Module> m, Args &&... args) {
 	auto optimizer = std::make_shared<Optimization>(m,
 		std::forward<Args>(args)...);
-	runOptimizerProvidedItShouldBeRun(optimizer);
+	runOptimizerProvidedItShouldBeRun(m, optimizer, false);
+}
+
+/**
+* @brief Runs the given optimization (specified in the template parameter) over
+*        the functions in @a m that have been modified since its last run.
+*
+* @tparam Optimization Optimization to be performed.
+*
+* @param[in] m Module to be optimized.
+* @param[in] args Arguments to be passed to the optimization.
+*
+* If the optimization has not been run yet, it is run over the whole module,
+* just like in run(). If no function has been modified since its last run, it
+* is not run at all. This assumes that running the optimization over its own
+* output does not change anything, so use it only for such optimizations whose
+* results for a function also do not depend on other functions.
+*/
+template<typename Optimization, typename... Args>
+void OptimizerManager::rerun(ShPtr<Module> m, Args &&... args) {
+	auto optimizer = std::make_shared<Optimization>(m,
+		std::forward<Args>(args)...);
+	runOptimizerProvidedItShouldBeRun(m, optimizer, true);
 }
 
 } // namespace llvmir2hll
@@ -33,7 +33,9 @@
 #include "retdec/llvmir2hll/ir/while_loop_stmt.h"
 #include "retdec/llvmir2hll/obtainer/call_info_obtainer.h"
 #include "retdec/llvmir2hll/optimizer/optimizers/copy_propagation_optimizer.h"
+#include "retdec/llvmir2hll/optimizer/optimizers/simple_copy_propagation_optimizer.h"
 #include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/statements_counter.h"
 #include "retdec/llvmir2hll/utils/ir.h"
 #include "retdec/utils/container.h"
 
@@ -200,17 +202,20 @@ auto ordered(const DefUseChains::DefUseChain &du) {
 * @param[in] module Module to be optimized.
 * @param[in] va Analysis of values.
 * @param[in] cio Obtainer of information about function calls.
+* @param[in] stmtLimit Functions with more statements than this are optimized
+*                      by SimpleCopyPropagationOptimizer. Zero means no limit.
 *
 * @par Preconditions
 *  - @a module, @a va, and @a cio are non-null
 */
 CopyPropagationOptimizer::CopyPropagationOptimizer(ShPtr<Module> module,
-	ShPtr<ValueAnalysis> va, ShPtr<CallInfoObtainer> cio):
+	ShPtr<ValueAnalysis> va, ShPtr<CallInfoObtainer> cio,
+	std::size_t stmtLimit):
 		FuncOptimizer(module), cfgBuilder(NonRecursiveCFGBuilder::create()),
 		va(va), cio(cio), vuv(), dua(), uda(),
 		ducs(), udcs(), globalVars(module->getGlobalVars()),
 		toEntirelyRemoveStmts(), toRemoveStmtsPreserveCalls(), modifiedStmts(),
-		codeChanged(false) {
+		codeChanged(false), stmtLimit(stmtLimit) {
 			PRECONDITION_NON_NULL(module);
 			PRECONDITION_NON_NULL(va);
 			PRECONDITION_NON_NULL(cio);
@@ -230,6 +235,11 @@ void CopyPropagationOptimizer::doOptimization() {
 }
 
 void CopyPropagationOptimizer::runOnFunction(ShPtr<Function> func) {
+	if (stmtLimit > 0 && StatementsCounter::count(func->getBody()) > stmtLimit) {
+		runSimpleCopyPropagation(func);
+		return;
+	}
+
 	auto currCFG = cfgBuilder->getCFG(func);
 
 	// Keep optimizing until there are no changes.
@@ -255,6 +265,19 @@ void CopyPropagationOptimizer::runOnFunction(ShPtr<Function> func) {
 	} while (codeChanged);
 }
 
+/**
+* @brief Optimizes @a func by SimpleCopyPropagationOptimizer.
+*
+* This is used for functions that are too large to be optimized by this
+* optimizer.
+*/
+void CopyPropagationOptimizer::runSimpleCopyPropagation(ShPtr<Function> func) {
+	auto simpleCopyPropagation = std::make_shared<
+		SimpleCopyPropagationOptimizer>(module, va, cio);
+	simpleCopyPropagation->restrictToFuncs({func});
+	simpleCopyPropagation->optimize();
+}
+
 /**
 * @brief Performs the copy propagation optimization.
 *
@@ -725,7 +748,8 @@ void CopyPropagationOptimizer::handleCaseSingleUse(ShPtr<Statement> stmt,
 		// (ii), and (i) and (ii) do not contain function calls or dereferences
 		// (the reason is that they may changed the value of lemon, if it is a
 		// global variable). Note that (iii) can contain any statements.
-		const auto &readVarsInLastDef = va->getValueData(lastDef)->getDirReadVars();
+		auto lastDefData = va->getValueData(lastDef);
+		const auto &readVarsInLastDef = lastDefData->getDirReadVars();
 		if (!NoVarDefCFGTraversal::noVarIsDefinedBetweenStmts(use, lhsUseDefs,
 				readVarsInLastDef, ducs->cfg, va)) {
 			LOG << "\t" << "end 18" << std::endl;
@@ -919,7 +943,8 @@ void CopyPropagationOptimizer::handleCaseInductionVariable(
 
 	// Variable we are going to use to replace the old definition, cannot be
 	// redefined between the old definition and its use.
-	const auto &readVarsInStmt = va->getValueData(defStmt)->getDirReadVars();
+	auto defStmtData = va->getValueData(defStmt);
+	const auto &readVarsInStmt = defStmtData->getDirReadVars();
 	for (auto& use : uses) {
 		if (VarDefCFGTraversal::isVarDefBetweenStmts(readVarsInStmt, defStmt, use,
 				ducs->cfg, va)) {
@@ -1256,7 +1281,7 @@ void CopyPropagationOptimizer::handleCaseMoreThanOneUse(
 
 	// Variable we are going to use to replace the old definition, cannot be
 	// redefined between the old definition and its use.
-	const auto &readVarsInStmt = va->getValueData(stmt)->getDirReadVars();
+	const auto &readVarsInStmt = stmtData->getDirReadVars();
 	for (auto& use : uses) {
 		if (VarDefCFGTraversal::isVarDefBetweenStmts(readVarsInStmt, stmt, use,
 				ducs->cfg, va)) {
@@ -29,6 +29,9 @@
 #include "retdec/llvmir2hll/optimizer/optimizers/simplify_arithm_expr_optimizer.h"
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/llvmir2hll/support/types.h"
+#include "retdec/utils/container.h"
+
+using retdec::utils::hasItem;
 
 namespace retdec {
 namespace llvmir2hll {
@@ -59,6 +62,7 @@ void SimplifyArithmExprOptimizer::doOptimization() {
 	for (auto i = module->global_var_begin(), e = module->global_var_end();
 			i != e; ++i) {
 		// Keep optimizing until there are no changes.
+		unchangedExprs.clear();
 		do {
 			codeChanged = false;
 			if (ShPtr<Expression> init = (*i)->getInitializer()) {
@@ -70,7 +74,12 @@ void SimplifyArithmExprOptimizer::doOptimization() {
 	// Visit all functions.
 	for (auto i = module->func_definition_begin(),
 			e = module->func_definition_end(); i != e; ++i) {
+		if (!shouldBeOptimized(*i)) {
+			continue;
+		}
+
 		// Keep optimizing until there are no changes.
+		unchangedExprs.clear();
 		do {
 			codeChanged = false;
 			restart();
@@ -153,12 +162,27 @@ void SimplifyArithmExprOptimizer::visit(ShPtr<TernaryOpExpr> expr) {
 * If something was optimized in sub-optimizations, @c codeChanged is set to
 * @c true.
 *
+* Sub-optimizers inspect only @a expr and its operands. Therefore, when none of
+* them has changed @a expr, they will not change it in the following passes
+* over the same function either, so @a expr is skipped in these passes.
+*
 * @param[in] expr An expression to optimize.
 */
 void SimplifyArithmExprOptimizer::tryOptimizeInSubOptimizations(
 		ShPtr<Expression> expr) {
+	if (hasItem(unchangedExprs, expr)) {
+		return;
+	}
+
+	bool exprChanged = false;
 	for (const auto &subOptim : subOptims) {
-		codeChanged |= subOptim->tryOptimize(expr);
+		exprChanged |= subOptim->tryOptimize(expr);
+	}
+
+	if (exprChanged) {
+		codeChanged = true;
+	} else {
+		unchangedExprs.insert(expr);
 	}
 }
 
@@ -8,6 +8,7 @@
 #include "retdec/llvmir2hll/ir/function.h"
 #include "retdec/llvmir2hll/ir/statement.h"
 #include "retdec/llvmir2hll/ir/var_def_stmt.h"
+#include "retdec/llvmir2hll/ir/variable.h"
 #include "retdec/llvmir2hll/optimizer/optimizers/var_def_for_loop_optimizer.h"
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/utils/container.h"
@@ -31,5 +31,31 @@ APICallSeqFinder::APICallSeqFinder(ShPtr<ValueAnalysis> va,
 	PRECONDITION(cio->isInitialized(), "it is not initialized");
 }
 
+/**
+* @brief Tries to find all the given sequences of API calls, starting at @a
+*        stmt.
+*
+* The parameters are the same as in findPatterns(), except that @a infos may
+* contain several sequences. The returned patterns are ordered in the same way
+* as the sequences in @a infos.
+*
+* The default implementation calls findPatterns() for every sequence. Concrete
+* finders may override it to match all the sequences together.
+*
+* @par Preconditions
+*  - @a call, @a stmt, @a func, and @a module are non-null
+*/
+APICallSeqFinder::Patterns APICallSeqFinder::findPatternsForSeqs(
+		const std::vector<APICallInfoSeq> &infos, ShPtr<CallExpr> call,
+		ShPtr<Statement> stmt, ShPtr<Function> func, ShPtr<Module> module) {
+	Patterns foundPatterns;
+	for (const auto &info : infos) {
+		Patterns patterns(findPatterns(info, call, stmt, func, module));
+		foundPatterns.insert(foundPatterns.end(), patterns.begin(),
+			patterns.end());
+	}
+	return foundPatterns;
+}
+
 } // namespace llvmir2hll
 } // namespace retdec
@@ -35,6 +35,36 @@ BasicBlockAPICallSeqFinder::BasicBlockAPICallSeqFinder(ShPtr<ValueAnalysis> va,
 BasicBlockAPICallSeqFinder::Patterns BasicBlockAPICallSeqFinder::findPatterns(
 		const APICallInfoSeq &info, ShPtr<CallExpr> call, ShPtr<Statement> stmt,
 		ShPtr<Function> func, ShPtr<Module> module) {
+	std::vector<APICallSeqData> seqsData(1, APICallSeqData(info));
+	return findPatternsInBlock(seqsData, call, stmt, func);
+}
+
+/**
+* @brief Tries to find all the given sequences of API calls within the basic
+*        block of @a stmt.
+*
+* All the sequences are matched during a single pass over the basic block.
+*/
+BasicBlockAPICallSeqFinder::Patterns BasicBlockAPICallSeqFinder::findPatternsForSeqs(
+		const std::vector<APICallInfoSeq> &infos, ShPtr<CallExpr> call,
+		ShPtr<Statement> stmt, ShPtr<Function> func, ShPtr<Module> module) {
+	std::vector<APICallSeqData> seqsData;
+	seqsData.reserve(infos.size());
+	for (const auto &info : infos) {
+		seqsData.emplace_back(info);
+	}
+	return findPatternsInBlock(seqsData, call, stmt, func);
+}
+
+/**
+* @brief Tries to complete the sequences in @a seqsData by the statements that
+*        follow @a stmt in its basic block.
+*
+* The returned patterns are ordered in the same way as @a seqsData.
+*/
+BasicBlockAPICallSeqFinder::Patterns BasicBlockAPICallSeqFinder::findPatternsInBlock(
+		std::vector<APICallSeqData> &seqsData, ShPtr<CallExpr> call,
+		ShPtr<Statement> stmt, ShPtr<Function> func) {
 	PRECONDITION_NON_NULL(call);
 	PRECONDITION_NON_NULL(stmt);
 	PRECONDITION_NON_NULL(func);
@@ -46,20 +76,42 @@ BasicBlockAPICallSeqFinder::Patterns BasicBlockAPICallSeqFinder::findPatterns(
 	ASSERT_MSG(nodeForStmt, "statement `" << stmt << "` does not exist in the CFG");
 	auto stmtIter = stmtInNode.second;
 
-	// Try to find a pattern matching the given sequence of information.
-	APICallSeqData data(info);
-	data.apply(*stmtIter, call);
-	while (++stmtIter != nodeForStmt->stmt_end() && !data.atEnd()) {
+	// Try to find patterns matching the given sequences of information. The
+	// block is traversed only once, advancing all the unfinished sequences at
+	// every statement.
+	std::size_t unfinishedSeqs = 0;
+	for (auto &data : seqsData) {
+		data.apply(*stmtIter, call);
+		if (!data.atEnd()) {
+			++unfinishedSeqs;
+		}
+	}
+	while (unfinishedSeqs > 0 && ++stmtIter != nodeForStmt->stmt_end()) {
 		ShPtr<ValueData> stmtData(va->getValueData(*stmtIter));
-		for (auto i = stmtData->call_begin(), e = stmtData->call_end();
-				i != e; ++i) {
-			if (data.matches(*i)) {
-				data.apply(*stmtIter, *i);
+		for (auto &data : seqsData) {
+			if (data.atEnd()) {
+				continue;
+			}
+
+			for (auto i = stmtData->call_begin(), e = stmtData->call_end();
+					i != e; ++i) {
+				if (data.matches(*i)) {
+					data.apply(*stmtIter, *i);
+				}
 			}
+			if (data.atEnd()) {
+				--unfinishedSeqs;
+			}
+		}
+	}
+
+	Patterns patterns;
+	for (const auto &data : seqsData) {
+		if (data.patternIsComplete()) {
+			patterns.push_back(data.getPattern());
 		}
 	}
-	return data.patternIsComplete() ?
-		Patterns(1, data.getPattern()) : Patterns();
+	return patterns;
 }
 
 } // namespace llvmir2hll
@@ -6,6 +6,7 @@
 
 #include <map>
 #include <optional>
+#include <vector>
 
 #include "retdec/llvmir2hll/analysis/value_analysis.h"
 #include "retdec/llvmir2hll/ir/call_expr.h"
@@ -40,11 +41,11 @@ namespace {
 /// List of patterns.
 using Patterns = PatternFinder::Patterns;
 
-/// Mapping of a function name into a sequence of information about API calls
+/// Mapping of a function name into sequences of information about API calls
 /// that begin with that function.
-// Note: Since many patterns may begin with the same function, we use a
-// multimap rather than a map.
-using APICallInfoSeqMap = std::multimap<std::string, APICallInfoSeq>;
+// Note: Since many patterns may begin with the same function, all of them are
+// kept under a single key so they can be matched together.
+using APICallInfoSeqMap = std::map<std::string, std::vector<APICallInfoSeq>>;
 
 /**
 * @brief Parses @a seqTextRepr into APICallInfoSeq and adds it to @a map under
@@ -55,7 +56,7 @@ void parseAndAddAPICallInfoSeqToMap(APICallInfoSeqMap &map,
 	static ShPtr<APICallInfoSeqParser> parser(APICallInfoSeqParser::create());
 	std::optional<APICallInfoSeq> seq(parser->parse(seqTextRepr));
 	if (seq) {
-		map.insert(std::make_pair(funcName, seq.value()));
+		map[funcName].push_back(seq.value());
 	} else {
 		Log::error() << Log::Error
 			<< "APICallInfoSeqParser failed to parse the following pattern: "
@@ -1136,15 +1137,16 @@ PatternFinder::Patterns APICallSeqPatternFinder::findPatterns(
 			continue;
 		}
 
-		// For every matching APICallInfoSeq...
-		auto foundInfos = API_CALL_INFO_SEQ_MAP.equal_range(calledFuncName);
-		while (foundInfos.first != foundInfos.second) {
-			Patterns patterns(acf->findPatterns(foundInfos.first->second,
-				call.call, call.stmt, call.func, call.module));
-			for (const auto &pattern : patterns) {
-				foundPatterns.push_back(pattern);
-			}
-			++foundInfos.first;
+		// Match all the APICallInfoSeqs that begin with the called function
+		// at once.
+		auto foundInfos = API_CALL_INFO_SEQ_MAP.find(calledFuncName);
+		if (foundInfos == API_CALL_INFO_SEQ_MAP.end()) {
+			continue;
+		}
+		Patterns patterns(acf->findPatternsForSeqs(foundInfos->second,
+			call.call, call.stmt, call.func, call.module));
+		for (const auto &pattern : patterns) {
+			foundPatterns.push_back(pattern);
 		}
 	}
 	return foundPatterns;
@@ -1959,9 +1959,6 @@ const StringStringUMap &initFuncCHeaderMap() {
 	return m;
 }
 
-/// Mapping of function names to their corresponding header files.
-const StringStringUMap &FUNC_C_HEADER_MAP(initFuncCHeaderMap());
-
 } // anonymous namespace
 
 /**
@@ -1970,6 +1967,8 @@ const StringStringUMap &FUNC_C_HEADER_MAP(initFuncCHeaderMap());
 * See its description for more details.
 */
 std::optional<std::string> getCHeaderFileForFunc(const std::string &funcName) {
+	// Mapping of function names to their corresponding header files.
+	static const StringStringUMap &FUNC_C_HEADER_MAP(initFuncCHeaderMap());
 	return getCHeaderFileForFuncFromMap(funcName, FUNC_C_HEADER_MAP);
 }
 
@@ -2184,9 +2184,6 @@ const FuncParamNamesMap &initFuncParamNamesMap() {
 	return funcParamNamesMap;
 }
 
-/// Mapping of function parameter positions into the names of parameters.
-const FuncParamNamesMap static FUNC_PARAM_NAMES_MAP(initFuncParamNamesMap());
-
 } // anonymous namespace
 
 /**
@@ -2196,6 +2193,8 @@ const FuncParamNamesMap static FUNC_PARAM_NAMES_MAP(initFuncParamNamesMap());
 */
 std::optional<std::string> getNameOfParam(const std::string &funcName,
 		unsigned paramPos) {
+	// Mapping of function parameter positions into the names of parameters.
+	static const FuncParamNamesMap &FUNC_PARAM_NAMES_MAP(initFuncParamNamesMap());
 	return getNameOfParamFromMap(funcName, paramPos, FUNC_PARAM_NAMES_MAP);
 }
 
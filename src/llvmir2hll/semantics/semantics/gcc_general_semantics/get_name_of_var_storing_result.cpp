@@ -41,9 +41,6 @@ const StringStringUMap &initFuncVarNameMap() {
 	return m;
 }
 
-/// Mapping of function names to their corresponding names of variables.
-const StringStringUMap &FUNC_VAR_NAME_MAP(initFuncVarNameMap());
-
 } // anonymous namespace
 
 /**
@@ -52,6 +49,8 @@ const StringStringUMap &FUNC_VAR_NAME_MAP(initFuncVarNameMap());
 * See its description for more details.
 */
 std::optional<std::string> getNameOfVarStoringResult(const std::string &funcName) {
+	// Mapping of function names to their corresponding names of variables.
+	static const StringStringUMap &FUNC_VAR_NAME_MAP(initFuncVarNameMap());
 	return getNameOfVarStoringResultFromMap(funcName, FUNC_VAR_NAME_MAP);
 }
 
@@ -631,9 +631,6 @@ const FuncParamNamesMap &initFuncParamNamesMap() {
 	return funcParamNamesMap;
 }
 
-/// Mapping of function parameter positions into the names of parameters.
-const FuncParamNamesMap &FUNC_PARAM_NAMES_MAP(initFuncParamNamesMap());
-
 } // anonymous namespace
 
 /**
@@ -643,6 +640,8 @@ const FuncParamNamesMap &FUNC_PARAM_NAMES_MAP(initFuncParamNamesMap());
 */
 std::optional<std::string> getNameOfParam(const std::string &funcName,
 		unsigned paramPos) {
+	// Mapping of function parameter positions into the names of parameters.
+	static const FuncParamNamesMap &FUNC_PARAM_NAMES_MAP(initFuncParamNamesMap());
 	return getNameOfParamFromMap(funcName, paramPos, FUNC_PARAM_NAMES_MAP);
 }
 
@@ -85,9 +85,6 @@ const FuncParamsMap &initFuncParamsMap() {
 	return funcParamsMap;
 }
 
-/// Mapping of function names into symbolic names of their parameters.
-const FuncParamsMap &FUNC_PARAMS_MAP(initFuncParamsMap());
-
 } // anonymous namespace
 
 /**
@@ -97,6 +94,8 @@ const FuncParamsMap &FUNC_PARAMS_MAP(initFuncParamsMap());
 */
 std::optional<IntStringMap> getSymbolicNamesForParam(const std::string &funcName,
 		unsigned paramPos) {
+	// Mapping of function names into symbolic names of their parameters.
+	static const FuncParamsMap &FUNC_PARAMS_MAP(initFuncParamsMap());
 	return getSymbolicNamesForParamFromMap(funcName, paramPos, FUNC_PARAMS_MAP);
 }
 
@@ -0,0 +1,2290 @@
+/**
+* @file src/llvmir2hll/support/bir_snapshot.cpp
+* @brief Implementation of BIRSnapshot.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <llvm/ADT/APFloat.h>
+#include <llvm/ADT/APSInt.h>
+
+#include "retdec/llvmir2hll/ir/add_op_expr.h"
+#include "retdec/llvmir2hll/ir/address_op_expr.h"
+#include "retdec/llvmir2hll/ir/and_op_expr.h"
+#include "retdec/llvmir2hll/ir/array_index_op_expr.h"
+#include "retdec/llvmir2hll/ir/array_type.h"
+#include "retdec/llvmir2hll/ir/assign_op_expr.h"
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/bit_and_op_expr.h"
+#include "retdec/llvmir2hll/ir/bit_cast_expr.h"
+#include "retdec/llvmir2hll/ir/bit_or_op_expr.h"
+#include "retdec/llvmir2hll/ir/bit_shl_op_expr.h"
+#include "retdec/llvmir2hll/ir/bit_shr_op_expr.h"
+#include "retdec/llvmir2hll/ir/bit_xor_op_expr.h"
+#include "retdec/llvmir2hll/ir/break_stmt.h"
+#include "retdec/llvmir2hll/ir/call_expr.h"
+#include "retdec/llvmir2hll/ir/call_stmt.h"
+#include "retdec/llvmir2hll/ir/comma_op_expr.h"
+#include "retdec/llvmir2hll/ir/const_array.h"
+#include "retdec/llvmir2hll/ir/const_bool.h"
+#include "retdec/llvmir2hll/ir/const_float.h"
+#include "retdec/llvmir2hll/ir/const_int.h"
+#include "retdec/llvmir2hll/ir/const_null_pointer.h"
+#include "retdec/llvmir2hll/ir/const_string.h"
+#include "retdec/llvmir2hll/ir/const_struct.h"
+#include "retdec/llvmir2hll/ir/const_symbol.h"
+#include "retdec/llvmir2hll/ir/continue_stmt.h"
+#include "retdec/llvmir2hll/ir/deref_op_expr.h"
+#include "retdec/llvmir2hll/ir/div_op_expr.h"
+#include "retdec/llvmir2hll/ir/empty_stmt.h"
+#include "retdec/llvmir2hll/ir/eq_op_expr.h"
+#include "retdec/llvmir2hll/ir/ext_cast_expr.h"
+#include "retdec/llvmir2hll/ir/float_type.h"
+#include "retdec/llvmir2hll/ir/for_loop_stmt.h"
+#include "retdec/llvmir2hll/ir/fp_to_int_cast_expr.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/function_type.h"
+#include "retdec/llvmir2hll/ir/global_var_def.h"
+#include "retdec/llvmir2hll/ir/goto_stmt.h"
+#include "retdec/llvmir2hll/ir/gt_eq_op_expr.h"
+#include "retdec/llvmir2hll/ir/gt_op_expr.h"
+#include "retdec/llvmir2hll/ir/if_stmt.h"
+#include "retdec/llvmir2hll/ir/int_to_fp_cast_expr.h"
+#include "retdec/llvmir2hll/ir/int_to_ptr_cast_expr.h"
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "retdec/llvmir2hll/ir/lt_eq_op_expr.h"
+#include "retdec/llvmir2hll/ir/lt_op_expr.h"
+#include "retdec/llvmir2hll/ir/mod_op_expr.h"
+#include "retdec/llvmir2hll/ir/module.h"
+#include "retdec/llvmir2hll/ir/mul_op_expr.h"
+#include "retdec/llvmir2hll/ir/neg_op_expr.h"
+#include "retdec/llvmir2hll/ir/neq_op_expr.h"
+#include "retdec/llvmir2hll/ir/not_op_expr.h"
+#include "retdec/llvmir2hll/ir/or_op_expr.h"
+#include "retdec/llvmir2hll/ir/pointer_type.h"
+#include "retdec/llvmir2hll/ir/ptr_to_int_cast_expr.h"
+#include "retdec/llvmir2hll/ir/return_stmt.h"
+#include "retdec/llvmir2hll/ir/statement.h"
+#include "retdec/llvmir2hll/ir/string_type.h"
+#include "retdec/llvmir2hll/ir/struct_index_op_expr.h"
+#include "retdec/llvmir2hll/ir/struct_type.h"
+#include "retdec/llvmir2hll/ir/sub_op_expr.h"
+#include "retdec/llvmir2hll/ir/switch_stmt.h"
+#include "retdec/llvmir2hll/ir/ternary_op_expr.h"
+#include "retdec/llvmir2hll/ir/trunc_cast_expr.h"
+#include "retdec/llvmir2hll/ir/ufor_loop_stmt.h"
+#include "retdec/llvmir2hll/ir/unknown_type.h"
+#include "retdec/llvmir2hll/ir/unreachable_stmt.h"
+#include "retdec/llvmir2hll/ir/var_def_stmt.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/ir/void_type.h"
+#include "retdec/llvmir2hll/ir/while_loop_stmt.h"
+#include "retdec/llvmir2hll/support/bir_snapshot.h"
+#include "retdec/llvmir2hll/support/debug.h"
+#include "retdec/llvmir2hll/support/visitor.h"
+#include "retdec/utils/container.h"
+
+using retdec::utils::mapGetValueOrDefault;
+using retdec::utils::mapHasKey;
+
+namespace retdec {
+namespace llvmir2hll {
+
+namespace {
+
+/// Magic bytes at the beginning of every snapshot.
+const std::string SNAPSHOT_MAGIC = "RDBS";
+
+/// Magic bytes at the beginning of every snapshot of a single function.
+const std::string FUNC_SNAPSHOT_MAGIC = "RDBF";
+
+/// Version of the snapshot format. It has to be increased whenever the format
+/// changes, snapshots of other versions are refused.
+const std::uint64_t SNAPSHOT_VERSION = 2;
+
+/// Maximal bit width of a stored integer.
+const std::uint64_t MAX_INT_BIT_WIDTH = 1 << 16;
+
+/**
+* @brief Error in a snapshot that is being saved or loaded.
+*/
+class SnapshotError: public std::runtime_error {
+public:
+	explicit SnapshotError(const std::string &what): std::runtime_error(what) {}
+};
+
+/**
+* @brief Tags of the stored statements, expressions, and types.
+*/
+enum class Tag: std::uint8_t {
+	Null, ///< A missing (null) expression.
+	End,  ///< The end of a list of statements.
+
+	// Statements.
+	AssignStmt,
+	BreakStmt,
+	CallStmt,
+	ContinueStmt,
+	EmptyStmt,
+	ForLoopStmt,
+	UForLoopStmt,
+	GotoStmt,
+	IfStmt,
+	ReturnStmt,
+	SwitchStmt,
+	UnreachableStmt,
+	VarDefStmt,
+	WhileLoopStmt,
+
+	// Expressions.
+	AddOpExpr,
+	AddressOpExpr,
+	AndOpExpr,
+	ArrayIndexOpExpr,
+	AssignOpExpr,
+	BitAndOpExpr,
+	BitOrOpExpr,
+	BitShlOpExpr,
+	BitShrOpExpr,
+	BitXorOpExpr,
+	CallExpr,
+	CommaOpExpr,
+	DerefOpExpr,
+	DivOpExpr,
+	EqOpExpr,
+	GtEqOpExpr,
+	GtOpExpr,
+	LtEqOpExpr,
+	LtOpExpr,
+	ModOpExpr,
+	MulOpExpr,
+	NegOpExpr,
+	NeqOpExpr,
+	NotOpExpr,
+	OrOpExpr,
+	StructIndexOpExpr,
+	SubOpExpr,
+	TernaryOpExpr,
+	Variable,
+	BitCastExpr,
+	ExtCastExpr,
+	FPToIntCastExpr,
+	IntToFPCastExpr,
+	IntToPtrCastExpr,
+	PtrToIntCastExpr,
+	TruncCastExpr,
+	ConstArray,
+	ConstBool,
+	ConstFloat,
+	ConstInt,
+	ConstNullPointer,
+	ConstString,
+	ConstStruct,
+	ConstSymbol,
+
+	// Types.
+	ArrayType,
+	FloatType,
+	IntType,
+	PointerType,
+	StringType,
+	StructType,
+	FunctionType,
+	VoidType,
+	UnknownType
+};
+
+/**
+* @brief Kinds of entries in the table of variables.
+*/
+enum class VarKind: std::uint8_t {
+	Variable,      ///< An ordinary variable.
+	Function,      ///< A variable corresponding to a function.
+	GlobalVariable ///< A global variable.
+};
+
+/**
+* @brief Returns the supported semantics of floating-point constants.
+*
+* A semantics is stored as its index in the returned vector.
+*/
+std::vector<const llvm::fltSemantics *> getFloatSemantics() {
+	return {
+		&llvm::APFloat::IEEEhalf(),
+		&llvm::APFloat::IEEEsingle(),
+		&llvm::APFloat::IEEEdouble(),
+		&llvm::APFloat::x87DoubleExtended(),
+		&llvm::APFloat::IEEEquad(),
+		&llvm::APFloat::PPCDoubleDouble()
+	};
+}
+
+/**
+* @brief A buffer into which a snapshot is written.
+*
+* Unsigned numbers are written as variable-length numbers (7 bits per byte),
+* strings are prefixed by their length.
+*/
+class OutBuffer {
+public:
+	void writeByte(std::uint8_t b) {
+		data.push_back(static_cast<char>(b));
+	}
+
+	void writeUint(std::uint64_t u) {
+		while (u >= 0x80) {
+			writeByte(static_cast<std::uint8_t>(u | 0x80));
+			u >>= 7;
+		}
+		writeByte(static_cast<std::uint8_t>(u));
+	}
+
+	void writeBool(bool b) {
+		writeByte(b ? 1 : 0);
+	}
+
+	void writeTag(Tag tag) {
+		writeByte(static_cast<std::uint8_t>(tag));
+	}
+
+	void writeString(const std::string &str) {
+		writeUint(str.size());
+		data.append(str);
+	}
+
+	void writeAddress(Address a) {
+		// The undefined address (the maximal value) is stored as zero.
+		writeUint(static_cast<std::uint64_t>(a) + 1);
+	}
+
+	void writeAPInt(const llvm::APInt &value) {
+		writeUint(value.getBitWidth());
+		for (unsigned i = 0, e = value.getNumWords(); i < e; ++i) {
+			writeUint(value.getRawData()[i]);
+		}
+	}
+
+	void append(const OutBuffer &other) {
+		data.append(other.data);
+	}
+
+	void appendRaw(const std::string &str) {
+		data.append(str);
+	}
+
+	const std::string &getData() const {
+		return data;
+	}
+
+private:
+	/// Written data.
+	std::string data;
+};
+
+/**
+* @brief A buffer from which a snapshot is read.
+*
+* All the reading functions throw SnapshotError when the data are malformed.
+*/
+class InBuffer {
+public:
+	explicit InBuffer(std::string data): data(std::move(data)), pos(0) {}
+
+	bool atEnd() const {
+		return pos == data.size();
+	}
+
+	std::size_t getRemainingSize() const {
+		return data.size() - pos;
+	}
+
+	std::uint8_t readByte() {
+		if (atEnd()) {
+			throw SnapshotError("unexpected end of data");
+		}
+		return static_cast<std::uint8_t>(data[pos++]);
+	}
+
+	std::uint64_t readUint() {
+		std::uint64_t u = 0;
+		for (unsigned shift = 0; shift < 64; shift += 7) {
+			std::uint8_t b = readByte();
+			u |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+			if (!(b & 0x80)) {
+				return u;
+			}
+		}
+		throw SnapshotError("invalid number");
+	}
+
+	bool readBool() {
+		return readByte() != 0;
+	}
+
+	Tag readTag() {
+		std::uint8_t b = readByte();
+		if (b > static_cast<std::uint8_t>(Tag::UnknownType)) {
+			throw SnapshotError("invalid tag");
+		}
+		return static_cast<Tag>(b);
+	}
+
+	std::string readRaw(std::size_t size) {
+		if (size > getRemainingSize()) {
+			throw SnapshotError("unexpected end of data");
+		}
+		std::string str(data, pos, size);
+		pos += size;
+		return str;
+	}
+
+	std::string readString() {
+		return readRaw(readUint());
+	}
+
+	Address readAddress() {
+		return Address(readUint() - 1);
+	}
+
+	llvm::APInt readAPInt() {
+		std::uint64_t bitWidth = readUint();
+		if (bitWidth == 0 || bitWidth > MAX_INT_BIT_WIDTH) {
+			throw SnapshotError("invalid bit width");
+		}
+		std::vector<std::uint64_t> words((bitWidth + 63) / 64);
+		for (auto &word : words) {
+			word = readUint();
+		}
+		return llvm::APInt(static_cast<unsigned>(bitWidth), words);
+	}
+
+	/**
+	* @brief Reads an index into a table of the given @a size.
+	*/
+	std::size_t readIndex(std::size_t size) {
+		std::uint64_t index = readUint();
+		if (index >= size) {
+			throw SnapshotError("invalid reference");
+		}
+		return index;
+	}
+
+	/**
+	* @brief Reads the number of items that follow, each of which takes at
+	*        least one byte.
+	*/
+	std::size_t readCount() {
+		std::uint64_t count = readUint();
+		if (count > getRemainingSize()) {
+			throw SnapshotError("invalid number of items");
+		}
+		return count;
+	}
+
+	/**
+	* @brief Reads a value of a scoped enumeration with the given number of
+	*        enumerators (their values have to be 0, 1, ...).
+	*/
+	template<typename Enum>
+	Enum readEnum(std::size_t numOfEnumerators) {
+		return static_cast<Enum>(readIndex(numOfEnumerators));
+	}
+
+private:
+	/// Read data.
+	const std::string data;
+
+	/// Position of the next byte to be read.
+	std::size_t pos;
+};
+
+/**
+* @brief Writer of snapshots.
+*
+* The global variables and functions are written first, and variables and
+* types are collected meanwhile. A variable is referred to by the index of its
+* first occurrence. The table of variables, which is written before the
+* global variables and functions, is sorted by the identifiers of variables,
+* i.e. in the order in which they have been created. Types are referred to by
+* their index in the table of types, in which every type follows all the
+* types it contains.
+*
+* When only a single function is written, the snapshot starts with its name
+* and address range instead of the identifier of the module, and it contains
+* no global variables and no other functions.
+*/
+class SnapshotWriter: public Visitor {
+public:
+	explicit SnapshotWriter(ShPtr<Module> module,
+		ShPtr<Function> onlyFunc = nullptr);
+
+	std::string write();
+
+private:
+	void writeGlobalVars();
+	void writeFuncs();
+	void writeFunc(ShPtr<Function> func);
+	void writeVarTable(OutBuffer &table);
+	void writeDebugNames(OutBuffer &names);
+
+	std::size_t getTypeIndex(ShPtr<Type> type);
+	std::size_t getVarIndex(ShPtr<Variable> var);
+	std::size_t getStmtRef(ShPtr<Statement> stmt);
+
+	void writeType(ShPtr<Type> type);
+	void writeVar(ShPtr<Variable> var);
+	void writeVars(const VarVector &vars);
+	void writeExpr(ShPtr<Expression> expr);
+	void writeStmts(ShPtr<Statement> stmt);
+	void writeStmtHeader(Tag tag, ShPtr<Statement> stmt);
+	void writeBinaryOpExpr(Tag tag, ShPtr<BinaryOpExpr> expr);
+	void writeUnaryOpExpr(Tag tag, ShPtr<UnaryOpExpr> expr);
+	void writeCastExpr(Tag tag, ShPtr<CastExpr> expr);
+
+	template<typename Enum>
+	void writeEnum(Enum value) {
+		out.writeUint(static_cast<std::uint64_t>(value));
+	}
+
+	/// @name Visitor Interface
+	/// @{
+	virtual void visit(ShPtr<GlobalVarDef> varDef) override;
+	virtual void visit(ShPtr<Function> func) override;
+	// Statements
+	virtual void visit(ShPtr<AssignStmt> stmt) override;
+	virtual void visit(ShPtr<BreakStmt> stmt) override;
+	virtual void visit(ShPtr<CallStmt> stmt) override;
+	virtual void visit(ShPtr<ContinueStmt> stmt) override;
+	virtual void visit(ShPtr<EmptyStmt> stmt) override;
+	virtual void visit(ShPtr<ForLoopStmt> stmt) override;
+	virtual void visit(ShPtr<UForLoopStmt> stmt) override;
+	virtual void visit(ShPtr<GotoStmt> stmt) override;
+	virtual void visit(ShPtr<IfStmt> stmt) override;
+	virtual void visit(ShPtr<ReturnStmt> stmt) override;
+	virtual void visit(ShPtr<SwitchStmt> stmt) override;
+	virtual void visit(ShPtr<UnreachableStmt> stmt) override;
+	virtual void visit(ShPtr<VarDefStmt> stmt) override;
+	virtual void visit(ShPtr<WhileLoopStmt> stmt) override;
+	// Expressions
+	virtual void visit(ShPtr<AddOpExpr> expr) override;
+	virtual void visit(ShPtr<AddressOpExpr> expr) override;
+	virtual void visit(ShPtr<AndOpExpr> expr) override;
+	virtual void visit(ShPtr<ArrayIndexOpExpr> expr) override;
+	virtual void visit(ShPtr<AssignOpExpr> expr) override;
+	virtual void visit(ShPtr<BitAndOpExpr> expr) override;
+	virtual void visit(ShPtr<BitOrOpExpr> expr) override;
+	virtual void visit(ShPtr<BitShlOpExpr> expr) override;
+	virtual void visit(ShPtr<BitShrOpExpr> expr) override;
+	virtual void visit(ShPtr<BitXorOpExpr> expr) override;
+	virtual void visit(ShPtr<CallExpr> expr) override;
+	virtual void visit(ShPtr<CommaOpExpr> expr) override;
+	virtual void visit(ShPtr<DerefOpExpr> expr) override;
+	virtual void visit(ShPtr<DivOpExpr> expr) override;
+	virtual void visit(ShPtr<EqOpExpr> expr) override;
+	virtual void visit(ShPtr<GtEqOpExpr> expr) override;
+	virtual void visit(ShPtr<GtOpExpr> expr) override;
+	virtual void visit(ShPtr<LtEqOpExpr> expr) override;
+	virtual void visit(ShPtr<LtOpExpr> expr) override;
+	virtual void visit(ShPtr<ModOpExpr> expr) override;
+	virtual void visit(ShPtr<MulOpExpr> expr) override;
+	virtual void visit(ShPtr<NegOpExpr> expr) override;
+	virtual void visit(ShPtr<NeqOpExpr> expr) override;
+	virtual void visit(ShPtr<NotOpExpr> expr) override;
+	virtual void visit(ShPtr<OrOpExpr> expr) override;
+	virtual void visit(ShPtr<StructIndexOpExpr> expr) override;
+	virtual void visit(ShPtr<SubOpExpr> expr) override;
+	virtual void visit(ShPtr<TernaryOpExpr> expr) override;
+	virtual void visit(ShPtr<Variable> var) override;
+	// Casts
+	virtual void visit(ShPtr<BitCastExpr> expr) override;
+	virtual void visit(ShPtr<ExtCastExpr> expr) override;
+	virtual void visit(ShPtr<FPToIntCastExpr> expr) override;
+	virtual void visit(ShPtr<IntToFPCastExpr> expr) override;
+	virtual void visit(ShPtr<IntToPtrCastExpr> expr) override;
+	virtual void visit(ShPtr<PtrToIntCastExpr> expr) override;
+	virtual void visit(ShPtr<TruncCastExpr> expr) override;
+	// Constants
+	virtual void visit(ShPtr<ConstArray> constant) override;
+	virtual void visit(ShPtr<ConstBool> constant) override;
+	virtual void visit(ShPtr<ConstFloat> constant) override;
+	virtual void visit(ShPtr<ConstInt> constant) override;
+	virtual void visit(ShPtr<ConstNullPointer> constant) override;
+	virtual void visit(ShPtr<ConstString> constant) override;
+	virtual void visit(ShPtr<ConstStruct> constant) override;
+	virtual void visit(ShPtr<ConstSymbol> constant) override;
+	// Types
+	virtual void visit(ShPtr<ArrayType> type) override;
+	virtual void visit(ShPtr<FloatType> type) override;
+	virtual void visit(ShPtr<IntType> type) override;
+	virtual void visit(ShPtr<PointerType> type) override;
+	virtual void visit(ShPtr<StringType> type) override;
+	virtual void visit(ShPtr<StructType> type) override;
+	virtual void visit(ShPtr<FunctionType> type) override;
+	virtual void visit(ShPtr<VoidType> type) override;
+	virtual void visit(ShPtr<UnknownType> type) override;
+	/// @}
+
+private:
+	/// The written module.
+	ShPtr<Module> module;
+
+	/// The only written function (the null pointer if the whole module is
+	/// written).
+	ShPtr<Function> onlyFunc;
+
+	/// Global variables and functions.
+	OutBuffer out;
+
+	/// Table of types.
+	OutBuffer types;
+
+	/// Number of types in the table of types.
+	std::size_t numOfTypes;
+
+	/// Indexes of types in the table of types.
+	std::map<ShPtr<Type>, std::size_t> typeIndexes;
+
+	/// Types whose contained types are being written.
+	std::set<ShPtr<Type>> typesBeingWritten;
+
+	/// Variables in the order of their first occurrence.
+	VarVector vars;
+
+	/// Indexes of variables into @c vars.
+	std::map<ShPtr<Variable>, std::size_t> varIndexes;
+
+	/// Functions of the module by their variables.
+	std::map<ShPtr<Variable>, ShPtr<Function>> funcsByVar;
+
+	/// References to statements that are targets of goto statements.
+	std::map<ShPtr<Statement>, std::size_t> stmtRefs;
+};
+
+/**
+* @brief Constructs a writer of the given module.
+*/
+SnapshotWriter::SnapshotWriter(ShPtr<Module> module,
+		ShPtr<Function> onlyFunc):
+	module(module), onlyFunc(onlyFunc), numOfTypes(0) {}
+
+/**
+* @brief Writes the module and returns the snapshot.
+*
+* @throw SnapshotError if the module cannot be written.
+*/
+std::string SnapshotWriter::write() {
+	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
+		funcsByVar.emplace((*i)->getAsVar(), *i);
+	}
+
+	writeGlobalVars();
+	writeFuncs();
+
+	OutBuffer varTable;
+	writeVarTable(varTable);
+
+	OutBuffer debugNames;
+	writeDebugNames(debugNames);
+
+	OutBuffer snapshot;
+	if (onlyFunc) {
+		snapshot.appendRaw(FUNC_SNAPSHOT_MAGIC);
+		snapshot.writeUint(SNAPSHOT_VERSION);
+		AddressRange range(module->getAddressRangeForFunc(onlyFunc));
+		snapshot.writeString(onlyFunc->getName());
+		snapshot.writeAddress(range.getStart());
+		snapshot.writeAddress(range.getEnd());
+	} else {
+		snapshot.appendRaw(SNAPSHOT_MAGIC);
+		snapshot.writeUint(SNAPSHOT_VERSION);
+		snapshot.writeString(module->getIdentifier(false));
+	}
+	snapshot.writeUint(numOfTypes);
+	snapshot.append(types);
+	snapshot.writeUint(vars.size());
+	snapshot.append(varTable);
+	snapshot.append(out);
+	snapshot.append(debugNames);
+	return snapshot.getData();
+}
+
+void SnapshotWriter::writeGlobalVars() {
+	if (onlyFunc) {
+		out.writeUint(0);
+		return;
+	}
+
+	out.writeUint(std::distance(module->global_var_begin(),
+		module->global_var_end()));
+	for (auto i = module->global_var_begin(), e = module->global_var_end();
+			i != e; ++i) {
+		writeVar((*i)->getVar());
+		writeExpr((*i)->getInitializer());
+	}
+}
+
+void SnapshotWriter::writeFuncs() {
+	if (onlyFunc) {
+		out.writeUint(1);
+		writeFunc(onlyFunc);
+		return;
+	}
+
+	out.writeUint(std::distance(module->func_begin(), module->func_end()));
+	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
+		writeFunc(*i);
+	}
+}
+
+void SnapshotWriter::writeFunc(ShPtr<Function> func) {
+	writeVar(func->getAsVar());
+	writeVars(func->getParams());
+	VarSet localVars(func->getLocalVars());
+	writeVars(VarVector(localVars.begin(), localVars.end()));
+	ShPtr<Statement> body(func->getBody());
+	out.writeBool(body != nullptr);
+	if (body) {
+		writeStmts(body);
+	}
+}
+
+/**
+* @brief Writes the table of all the written variables into @a table.
+*
+* Variables corresponding to functions of the module carry the signatures of
+* the functions, whose types are updated from their parameters.
+*/
+void SnapshotWriter::writeVarTable(OutBuffer &table) {
+	std::vector<std::size_t> order(vars.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(),
+		[this](std::size_t i, std::size_t j) {
+			return vars[i]->getId() < vars[j]->getId();
+		}
+	);
+
+	for (std::size_t index : order) {
+		ShPtr<Variable> var(vars[index]);
+		table.writeUint(index);
+		auto funcIt = funcsByVar.find(var);
+		if (funcIt != funcsByVar.end()) {
+			table.writeByte(static_cast<std::uint8_t>(VarKind::Function));
+			table.writeString(var->getInitialName());
+			table.writeString(var->getName());
+			table.writeUint(getTypeIndex(funcIt->second->getRetType()));
+			table.writeBool(funcIt->second->isVarArg());
+		} else {
+			table.writeByte(static_cast<std::uint8_t>(
+				module->isGlobalVar(var) ? VarKind::GlobalVariable :
+					VarKind::Variable));
+			table.writeString(var->getInitialName());
+			table.writeString(var->getName());
+			table.writeUint(getTypeIndex(var->getType()));
+		}
+		table.writeBool(var->isInternal());
+		table.writeAddress(var->getAddress());
+	}
+}
+
+void SnapshotWriter::writeDebugNames(OutBuffer &names) {
+	std::vector<std::size_t> indexes;
+	for (std::size_t i = 0; i < vars.size(); ++i) {
+		if (module->hasAssignedDebugName(vars[i])) {
+			indexes.push_back(i);
+		}
+	}
+
+	names.writeUint(indexes.size());
+	for (std::size_t index : indexes) {
+		names.writeUint(index);
+		names.writeString(module->getDebugNameForVar(vars[index]));
+	}
+}
+
+/**
+* @brief Returns the index of @a type in the table of types.
+*
+* If the type has not been written yet, it is written, after all the types it
+* contains.
+*/
+std::size_t SnapshotWriter::getTypeIndex(ShPtr<Type> type) {
+	if (!type) {
+		throw SnapshotError("missing type");
+	}
+
+	auto it = typeIndexes.find(type);
+	if (it != typeIndexes.end()) {
+		return it->second;
+	}
+
+	if (!typesBeingWritten.insert(type).second) {
+		throw SnapshotError("recursive type");
+	}
+	type->accept(this);
+	typesBeingWritten.erase(type);
+
+	std::size_t index = numOfTypes++;
+	typeIndexes.emplace(type, index);
+	return index;
+}
+
+std::size_t SnapshotWriter::getVarIndex(ShPtr<Variable> var) {
+	auto it = varIndexes.find(var);
+	if (it != varIndexes.end()) {
+		return it->second;
+	}
+
+	std::size_t index = vars.size();
+	vars.push_back(var);
+	varIndexes.emplace(var, index);
+	return index;
+}
+
+std::size_t SnapshotWriter::getStmtRef(ShPtr<Statement> stmt) {
+	return stmtRefs.emplace(stmt, stmtRefs.size()).first->second;
+}
+
+void SnapshotWriter::writeType(ShPtr<Type> type) {
+	out.writeUint(getTypeIndex(type));
+}
+
+void SnapshotWriter::writeVar(ShPtr<Variable> var) {
+	out.writeUint(getVarIndex(var));
+}
+
+void SnapshotWriter::writeVars(const VarVector &vars) {
+	out.writeUint(vars.size());
+	for (const auto &var : vars) {
+		writeVar(var);
+	}
+}
+
+/**
+* @brief Writes @a expr, which may be null.
+*/
+void SnapshotWriter::writeExpr(ShPtr<Expression> expr) {
+	if (expr) {
+		expr->accept(this);
+	} else {
+		out.writeTag(Tag::Null);
+	}
+}
+
+/**
+* @brief Writes @a stmt and all its successors.
+*/
+void SnapshotWriter::writeStmts(ShPtr<Statement> stmt) {
+	for (; stmt; stmt = stmt->getSuccessor()) {
+		stmt->accept(this);
+	}
+	out.writeTag(Tag::End);
+}
+
+/**
+* @brief Writes the tag and the attributes that all statements have.
+*
+* Targets of goto statements are given a reference, by which the goto
+* statements refer to them.
+*/
+void SnapshotWriter::writeStmtHeader(Tag tag, ShPtr<Statement> stmt) {
+	out.writeTag(tag);
+	out.writeAddress(stmt->getAddress());
+	out.writeString(stmt->getLabel());
+	out.writeString(stmt->getMetadata());
+	if (stmt->isGotoTarget() || mapHasKey(stmtRefs, stmt)) {
+		out.writeUint(getStmtRef(stmt) + 1);
+	} else {
+		out.writeUint(0);
+	}
+}
+
+void SnapshotWriter::writeBinaryOpExpr(Tag tag, ShPtr<BinaryOpExpr> expr) {
+	out.writeTag(tag);
+	writeExpr(expr->getFirstOperand());
+	writeExpr(expr->getSecondOperand());
+}
+
+void SnapshotWriter::writeUnaryOpExpr(Tag tag, ShPtr<UnaryOpExpr> expr) {
+	out.writeTag(tag);
+	writeExpr(expr->getOperand());
+}
+
+void SnapshotWriter::writeCastExpr(Tag tag, ShPtr<CastExpr> expr) {
+	out.writeTag(tag);
+	writeExpr(expr->getOperand());
+	writeType(expr->getType());
+}
+
+void SnapshotWriter::visit(ShPtr<GlobalVarDef> varDef) {
+	// Global variables are written in writeGlobalVars().
+}
+
+void SnapshotWriter::visit(ShPtr<Function> func) {
+	// Functions are written in writeFuncs().
+}
+
+void SnapshotWriter::visit(ShPtr<AssignStmt> stmt) {
+	writeStmtHeader(Tag::AssignStmt, stmt);
+	writeExpr(stmt->getLhs());
+	writeExpr(stmt->getRhs());
+}
+
+void SnapshotWriter::visit(ShPtr<BreakStmt> stmt) {
+	writeStmtHeader(Tag::BreakStmt, stmt);
+}
+
+void SnapshotWriter::visit(ShPtr<CallStmt> stmt) {
+	writeStmtHeader(Tag::CallStmt, stmt);
+	writeExpr(stmt->getCall());
+}
+
+void SnapshotWriter::visit(ShPtr<ContinueStmt> stmt) {
+	writeStmtHeader(Tag::ContinueStmt, stmt);
+}
+
+void SnapshotWriter::visit(ShPtr<EmptyStmt> stmt) {
+	writeStmtHeader(Tag::EmptyStmt, stmt);
+}
+
+void SnapshotWriter::visit(ShPtr<ForLoopStmt> stmt) {
+	writeStmtHeader(Tag::ForLoopStmt, stmt);
+	writeVar(stmt->getIndVar());
+	writeExpr(stmt->getStartValue());
+	writeExpr(stmt->getEndCond());
+	writeExpr(stmt->getStep());
+	writeStmts(stmt->getBody());
+}
+
+void SnapshotWriter::visit(ShPtr<UForLoopStmt> stmt) {
+	writeStmtHeader(Tag::UForLoopStmt, stmt);
+	writeExpr(stmt->getInit());
+	writeExpr(stmt->getCond());
+	writeExpr(stmt->getStep());
+	out.writeBool(stmt->isInitDefinition());
+	writeStmts(stmt->getBody());
+}
+
+void SnapshotWriter::visit(ShPtr<GotoStmt> stmt) {
+	writeStmtHeader(Tag::GotoStmt, stmt);
+	out.writeUint(getStmtRef(stmt->getTarget()));
+}
+
+void SnapshotWriter::visit(ShPtr<IfStmt> stmt) {
+	writeStmtHeader(Tag::IfStmt, stmt);
+	out.writeUint(std::distance(stmt->clause_begin(), stmt->clause_end()));
+	for (auto i = stmt->clause_begin(), e = stmt->clause_end(); i != e; ++i) {
+		writeExpr(i->first);
+		writeStmts(i->second);
+	}
+	out.writeBool(stmt->hasElseClause());
+	if (stmt->hasElseClause()) {
+		writeStmts(stmt->getElseClause());
+	}
+}
+
+void SnapshotWriter::visit(ShPtr<ReturnStmt> stmt) {
+	writeStmtHeader(Tag::ReturnStmt, stmt);
+	writeExpr(stmt->getRetVal());
+}
+
+void SnapshotWriter::visit(ShPtr<SwitchStmt> stmt) {
+	writeStmtHeader(Tag::SwitchStmt, stmt);
+	writeExpr(stmt->getControlExpr());
+	out.writeUint(std::distance(stmt->clause_begin(), stmt->clause_end()));
+	for (auto i = stmt->clause_begin(), e = stmt->clause_end(); i != e; ++i) {
+		// The default clause has no condition.
+		writeExpr(i->first);
+		writeStmts(i->second);
+	}
+}
+
+void SnapshotWriter::visit(ShPtr<UnreachableStmt> stmt) {
+	writeStmtHeader(Tag::UnreachableStmt, stmt);
+}
+
+void SnapshotWriter::visit(ShPtr<VarDefStmt> stmt) {
+	writeStmtHeader(Tag::VarDefStmt, stmt);
+	writeVar(stmt->getVar());
+	writeExpr(stmt->getInitializer());
+}
+
+void SnapshotWriter::visit(ShPtr<WhileLoopStmt> stmt) {
+	writeStmtHeader(Tag::WhileLoopStmt, stmt);
+	writeExpr(stmt->getCondition());
+	writeStmts(stmt->getBody());
+}
+
+void SnapshotWriter::visit(ShPtr<AddOpExpr> expr) {
+	writeBinaryOpExpr(Tag::AddOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<AddressOpExpr> expr) {
+	writeUnaryOpExpr(Tag::AddressOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<AndOpExpr> expr) {
+	writeBinaryOpExpr(Tag::AndOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<ArrayIndexOpExpr> expr) {
+	writeBinaryOpExpr(Tag::ArrayIndexOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<AssignOpExpr> expr) {
+	writeBinaryOpExpr(Tag::AssignOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<BitAndOpExpr> expr) {
+	writeBinaryOpExpr(Tag::BitAndOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<BitOrOpExpr> expr) {
+	writeBinaryOpExpr(Tag::BitOrOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<BitShlOpExpr> expr) {
+	writeBinaryOpExpr(Tag::BitShlOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<BitShrOpExpr> expr) {
+	writeBinaryOpExpr(Tag::BitShrOpExpr, expr);
+	writeEnum(expr->getVariant());
+}
+
+void SnapshotWriter::visit(ShPtr<BitXorOpExpr> expr) {
+	writeBinaryOpExpr(Tag::BitXorOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<CallExpr> expr) {
+	out.writeTag(Tag::CallExpr);
+	writeExpr(expr->getCalledExpr());
+	out.writeUint(expr->getNumOfArgs());
+	for (const auto &arg : expr->getArgs()) {
+		writeExpr(arg);
+	}
+}
+
+void SnapshotWriter::visit(ShPtr<CommaOpExpr> expr) {
+	writeBinaryOpExpr(Tag::CommaOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<DerefOpExpr> expr) {
+	writeUnaryOpExpr(Tag::DerefOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<DivOpExpr> expr) {
+	writeBinaryOpExpr(Tag::DivOpExpr, expr);
+	writeEnum(expr->getVariant());
+}
+
+void SnapshotWriter::visit(ShPtr<EqOpExpr> expr) {
+	writeBinaryOpExpr(Tag::EqOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<GtEqOpExpr> expr) {
+	writeBinaryOpExpr(Tag::GtEqOpExpr, expr);
+	writeEnum(expr->getVariant());
+}
+
+void SnapshotWriter::visit(ShPtr<GtOpExpr> expr) {
+	writeBinaryOpExpr(Tag::GtOpExpr, expr);
+	writeEnum(expr->getVariant());
+}
+
+void SnapshotWriter::visit(ShPtr<LtEqOpExpr> expr) {
+	writeBinaryOpExpr(Tag::LtEqOpExpr, expr);
+	writeEnum(expr->getVariant());
+}
+
+void SnapshotWriter::visit(ShPtr<LtOpExpr> expr) {
+	writeBinaryOpExpr(Tag::LtOpExpr, expr);
+	writeEnum(expr->getVariant());
+}
+
+void SnapshotWriter::visit(ShPtr<ModOpExpr> expr) {
+	writeBinaryOpExpr(Tag::ModOpExpr, expr);
+	writeEnum(expr->getVariant());
+}
+
+void SnapshotWriter::visit(ShPtr<MulOpExpr> expr) {
+	writeBinaryOpExpr(Tag::MulOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<NegOpExpr> expr) {
+	writeUnaryOpExpr(Tag::NegOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<NeqOpExpr> expr) {
+	writeBinaryOpExpr(Tag::NeqOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<NotOpExpr> expr) {
+	writeUnaryOpExpr(Tag::NotOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<OrOpExpr> expr) {
+	writeBinaryOpExpr(Tag::OrOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<StructIndexOpExpr> expr) {
+	writeBinaryOpExpr(Tag::StructIndexOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<SubOpExpr> expr) {
+	writeBinaryOpExpr(Tag::SubOpExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<TernaryOpExpr> expr) {
+	out.writeTag(Tag::TernaryOpExpr);
+	writeExpr(expr->getCondition());
+	writeExpr(expr->getTrueValue());
+	writeExpr(expr->getFalseValue());
+}
+
+void SnapshotWriter::visit(ShPtr<Variable> var) {
+	out.writeTag(Tag::Variable);
+	writeVar(var);
+}
+
+void SnapshotWriter::visit(ShPtr<BitCastExpr> expr) {
+	writeCastExpr(Tag::BitCastExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<ExtCastExpr> expr) {
+	writeCastExpr(Tag::ExtCastExpr, expr);
+	writeEnum(expr->getVariant());
+}
+
+void SnapshotWriter::visit(ShPtr<FPToIntCastExpr> expr) {
+	writeCastExpr(Tag::FPToIntCastExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<IntToFPCastExpr> expr) {
+	writeCastExpr(Tag::IntToFPCastExpr, expr);
+	writeEnum(expr->getVariant());
+}
+
+void SnapshotWriter::visit(ShPtr<IntToPtrCastExpr> expr) {
+	writeCastExpr(Tag::IntToPtrCastExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<PtrToIntCastExpr> expr) {
+	writeCastExpr(Tag::PtrToIntCastExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<TruncCastExpr> expr) {
+	writeCastExpr(Tag::TruncCastExpr, expr);
+}
+
+void SnapshotWriter::visit(ShPtr<ConstArray> constant) {
+	out.writeTag(Tag::ConstArray);
+	writeType(constant->getType());
+	out.writeBool(constant->isInitialized());
+	if (constant->isInitialized()) {
+		const auto &value(constant->getInitializedValue());
+		out.writeUint(value.size());
+		for (const auto &item : value) {
+			writeExpr(item);
+		}
+	}
+}
+
+void SnapshotWriter::visit(ShPtr<ConstBool> constant) {
+	out.writeTag(Tag::ConstBool);
+	out.writeBool(constant->getValue());
+}
+
+void SnapshotWriter::visit(ShPtr<ConstFloat> constant) {
+	llvm::APFloat value(constant->getValue());
+	auto semantics(getFloatSemantics());
+	auto it = std::find(semantics.begin(), semantics.end(),
+		&value.getSemantics());
+	if (it == semantics.end()) {
+		throw SnapshotError("unsupported floating-point semantics");
+	}
+
+	out.writeTag(Tag::ConstFloat);
+	out.writeUint(it - semantics.begin());
+	out.writeAPInt(value.bitcastToAPInt());
+}
+
+void SnapshotWriter::visit(ShPtr<ConstInt> constant) {
+	llvm::APSInt value(constant->getValue());
+	out.writeTag(Tag::ConstInt);
+	out.writeBool(value.isUnsigned());
+	out.writeAPInt(value);
+}
+
+void SnapshotWriter::visit(ShPtr<ConstNullPointer> constant) {
+	out.writeTag(Tag::ConstNullPointer);
+	writeType(constant->getType());
+}
+
+void SnapshotWriter::visit(ShPtr<ConstString> constant) {
+	ConstString::UnderlyingStringType value(constant->getValue());
+	out.writeTag(Tag::ConstString);
+	out.writeUint(constant->getCharSize());
+	out.writeUint(value.size());
+	for (auto c : value) {
+		out.writeUint(c);
+	}
+}
+
+void SnapshotWriter::visit(ShPtr<ConstStruct> constant) {
+	ConstStruct::Type value(constant->getValue());
+	out.writeTag(Tag::ConstStruct);
+	writeType(constant->getType());
+	out.writeUint(value.size());
+	for (const auto &item : value) {
+		writeExpr(item.first);
+		writeExpr(item.second);
+	}
+}
+
+void SnapshotWriter::visit(ShPtr<ConstSymbol> constant) {
+	out.writeTag(Tag::ConstSymbol);
+	out.writeString(constant->getName());
+	writeExpr(constant->getValue());
+}
+
+void SnapshotWriter::visit(ShPtr<ArrayType> type) {
+	std::size_t elemType = getTypeIndex(type->getContainedType());
+	ArrayType::Dimensions dims(type->getDimensions());
+	types.writeTag(Tag::ArrayType);
+	types.writeUint(elemType);
+	types.writeUint(dims.size());
+	for (auto dim : dims) {
+		types.writeUint(dim);
+	}
+}
+
+void SnapshotWriter::visit(ShPtr<FloatType> type) {
+	types.writeTag(Tag::FloatType);
+	types.writeUint(type->getSize());
+}
+
+void SnapshotWriter::visit(ShPtr<IntType> type) {
+	types.writeTag(Tag::IntType);
+	types.writeUint(type->getSize());
+	types.writeBool(type->isSigned());
+}
+
+void SnapshotWriter::visit(ShPtr<PointerType> type) {
+	std::size_t containedType = getTypeIndex(type->getContainedType());
+	types.writeTag(Tag::PointerType);
+	types.writeUint(containedType);
+}
+
+void SnapshotWriter::visit(ShPtr<StringType> type) {
+	types.writeTag(Tag::StringType);
+	types.writeUint(type->getCharSize());
+}
+
+void SnapshotWriter::visit(ShPtr<StructType> type) {
+	std::vector<std::size_t> elemTypes;
+	for (const auto &elemType : type->getElementTypes()) {
+		elemTypes.push_back(getTypeIndex(elemType));
+	}
+	types.writeTag(Tag::StructType);
+	types.writeString(type->getName());
+	types.writeUint(elemTypes.size());
+	for (auto elemType : elemTypes) {
+		types.writeUint(elemType);
+	}
+}
+
+void SnapshotWriter::visit(ShPtr<FunctionType> type) {
+	std::size_t retType = getTypeIndex(type->getRetType());
+	std::vector<std::size_t> paramTypes;
+	for (auto i = type->param_begin(), e = type->param_end(); i != e; ++i) {
+		paramTypes.push_back(getTypeIndex(*i));
+	}
+	types.writeTag(Tag::FunctionType);
+	types.writeUint(retType);
+	types.writeBool(type->isVarArg());
+	types.writeUint(paramTypes.size());
+	for (auto paramType : paramTypes) {
+		types.writeUint(paramType);
+	}
+}
+
+void SnapshotWriter::visit(ShPtr<VoidType> type) {
+	types.writeTag(Tag::VoidType);
+}
+
+void SnapshotWriter::visit(ShPtr<UnknownType> type) {
+	types.writeTag(Tag::UnknownType);
+}
+
+/**
+* @brief Functions, global variables, and named structures of a module that
+*        is being merged from several snapshots, by their names.
+*/
+struct MergedEntities {
+	std::map<std::string, ShPtr<Function>> funcs;
+	std::map<std::string, ShPtr<Variable>> globalVars;
+	std::map<std::string, ShPtr<Type>> structTypes;
+};
+
+/**
+* @brief Reader of snapshots.
+*
+* It reads what SnapshotWriter has written. Goto statements are created with
+* a placeholder target, which is replaced after all statements are read.
+*
+* A snapshot of a single function is read into an existing function, whose
+* parameters, local variables, and body are replaced only after the whole
+* snapshot has been read. Addresses within the address range of the saved
+* function are moved into the address range of the existing function.
+*/
+class SnapshotReader {
+public:
+	SnapshotReader(std::string data, const llvm::Module *llvmModule,
+		ShPtr<Semantics> semantics, ShPtr<Config> config,
+		ShPtr<Module> mergeInto = nullptr, MergedEntities *merged = nullptr);
+	SnapshotReader(std::string data, ShPtr<Module> module,
+		ShPtr<Function> intoFunc, MergedEntities *existing,
+		const std::map<std::string, ShPtr<Function>> *renamedFuncs);
+
+	ShPtr<Module> read();
+
+private:
+	void readHeader();
+	void readTypes();
+	void readVarTable();
+	void readGlobalVars();
+	void readFuncs();
+	void readDebugNames();
+	void resolveGotoTargets();
+	void replaceIntoFunc();
+
+	ShPtr<Function> getExistingFunc(const std::string &name) const;
+	ShPtr<Variable> getExistingGlobalVar(const std::string &name) const;
+	Address relocate(Address a) const;
+	std::string relocateAddressesIn(const std::string &str) const;
+
+	ShPtr<Type> readType();
+	ShPtr<Type> readTypeRecord(Tag tag);
+	ShPtr<Type> mergeType(ShPtr<Type> type);
+	ShPtr<Variable> readVar();
+	VarVector readVars();
+	ShPtr<Expression> readExpr();
+	ShPtr<Expression> readNonNullExpr();
+	ShPtr<Expression> readExprRecord(Tag tag);
+	ShPtr<Statement> readStmts();
+	ShPtr<Statement> readNonEmptyStmts();
+	ShPtr<Statement> readStmt(Tag tag);
+	ShPtr<Statement> readStmtRecord(Tag tag, Address a);
+
+	template<typename T>
+	ShPtr<T> readAs(ShPtr<T> value) {
+		if (!value) {
+			throw SnapshotError("unexpected kind of value");
+		}
+		return value;
+	}
+
+	template<typename OpExpr>
+	ShPtr<Expression> readBinaryOpExpr() {
+		ShPtr<Expression> op1(readNonNullExpr());
+		ShPtr<Expression> op2(readNonNullExpr());
+		return OpExpr::create(op1, op2);
+	}
+
+	template<typename OpExpr>
+	ShPtr<Expression> readBinaryOpExprWithVariant(std::size_t numOfVariants) {
+		ShPtr<Expression> op1(readNonNullExpr());
+		ShPtr<Expression> op2(readNonNullExpr());
+		auto variant = in.readEnum<typename OpExpr::Variant>(numOfVariants);
+		return OpExpr::create(op1, op2, variant);
+	}
+
+	template<typename OpExpr>
+	ShPtr<Expression> readUnaryOpExpr() {
+		return OpExpr::create(readNonNullExpr());
+	}
+
+	template<typename CastExpr>
+	ShPtr<Expression> readCastExpr() {
+		ShPtr<Expression> op(readNonNullExpr());
+		ShPtr<Type> dstType(readType());
+		return CastExpr::create(op, dstType);
+	}
+
+	template<typename CastExpr>
+	ShPtr<Expression> readCastExprWithVariant(std::size_t numOfVariants) {
+		ShPtr<Expression> op(readNonNullExpr());
+		ShPtr<Type> dstType(readType());
+		auto variant = in.readEnum<typename CastExpr::Variant>(numOfVariants);
+		return CastExpr::create(op, dstType, variant);
+	}
+
+private:
+	/// Read data.
+	InBuffer in;
+
+	/// The LLVM module from which the saved module has been created.
+	const llvm::Module *llvmModule;
+
+	/// The used semantics.
+	ShPtr<Semantics> semantics;
+
+	/// The used config.
+	ShPtr<Config> config;
+
+	/// The read module.
+	ShPtr<Module> module;
+
+	/// Entities already read into @c module from other snapshots, or all
+	/// entities of @c module when a single function is read (the null
+	/// pointer otherwise).
+	MergedEntities *merged;
+
+	/// The function into which a single function is read (the null pointer
+	/// if a module is read).
+	ShPtr<Function> intoFunc;
+
+	/// Name of the read function in the saved module.
+	std::string savedFuncName;
+
+	/// Functions to be used instead of the functions of the given names in
+	/// the saved module (the null pointer if a module is read).
+	const std::map<std::string, ShPtr<Function>> *renamedFuncs;
+
+	/// Start address of the read function in the saved module.
+	Address savedFuncStart;
+
+	/// End address of the read function in the saved module.
+	Address savedFuncEnd;
+
+	/// Parameters of the read function.
+	VarVector readFuncParams;
+
+	/// Local variables of the read function.
+	VarVector readFuncLocalVars;
+
+	/// Body of the read function.
+	ShPtr<Statement> readFuncBody;
+
+	/// Table of types.
+	std::vector<ShPtr<Type>> types;
+
+	/// Table of variables (by the index of their first occurrence).
+	VarVector vars;
+
+	/// Functions by the indexes of their variables.
+	std::map<std::size_t, ShPtr<Function>> funcsByVarIndex;
+
+	/// When merging, whether the variables of functions read from another
+	/// snapshot are internal and their addresses, as stored in this snapshot
+	/// (by the indexes of the variables).
+	std::map<std::size_t, std::pair<bool, Address>> mergedFuncVarAttrs;
+
+	/// Statements by their references.
+	std::map<std::size_t, ShPtr<Statement>> stmtsByRef;
+
+	/// Goto statements and references to their targets.
+	std::vector<std::pair<ShPtr<GotoStmt>, std::size_t>> gotoTargetRefs;
+};
+
+SnapshotReader::SnapshotReader(std::string data,
+		const llvm::Module *llvmModule, ShPtr<Semantics> semantics,
+		ShPtr<Config> config, ShPtr<Module> mergeInto,
+		MergedEntities *merged):
+	in(std::move(data)), llvmModule(llvmModule), semantics(semantics),
+	config(config), module(mergeInto), merged(merged),
+	renamedFuncs(nullptr) {}
+
+/**
+* @brief Constructs a reader of a snapshot of a single function, which is
+*        read into the function @a intoFunc of @a module.
+*
+* @a existing has to contain all the functions and global variables of
+* @a module. Functions in @a renamedFuncs are used instead of the functions of
+* the given names in the saved module.
+*/
+SnapshotReader::SnapshotReader(std::string data, ShPtr<Module> module,
+		ShPtr<Function> intoFunc, MergedEntities *existing,
+		const std::map<std::string, ShPtr<Function>> *renamedFuncs):
+	in(std::move(data)), llvmModule(nullptr), module(module),
+	merged(existing), intoFunc(intoFunc), renamedFuncs(renamedFuncs) {}
+
+/**
+* @brief Reads the module.
+*
+* @throw SnapshotError if the snapshot is malformed.
+*/
+ShPtr<Module> SnapshotReader::read() {
+	readHeader();
+	readTypes();
+	readVarTable();
+	readGlobalVars();
+	readFuncs();
+	readDebugNames();
+	resolveGotoTargets();
+
+	if (!in.atEnd()) {
+		throw SnapshotError("unexpected data at the end");
+	}
+
+	if (intoFunc) {
+		replaceIntoFunc();
+	}
+	return module;
+}
+
+void SnapshotReader::readHeader() {
+	const std::string &magic(intoFunc ? FUNC_SNAPSHOT_MAGIC : SNAPSHOT_MAGIC);
+	if (in.readRaw(magic.size()) != magic) {
+		throw SnapshotError("not a snapshot");
+	}
+	if (in.readUint() != SNAPSHOT_VERSION) {
+		throw SnapshotError("unsupported version");
+	}
+
+	if (intoFunc) {
+		savedFuncName = in.readString();
+		savedFuncStart = in.readAddress();
+		savedFuncEnd = in.readAddress();
+		return;
+	}
+
+	std::string identifier(in.readString());
+	if (!module) {
+		module = std::make_shared<Module>(llvmModule, identifier,
+			semantics, config);
+	}
+}
+
+void SnapshotReader::readTypes() {
+	std::size_t count = in.readCount();
+	for (std::size_t i = 0; i < count; ++i) {
+		types.push_back(mergeType(readTypeRecord(in.readTag())));
+	}
+}
+
+/**
+* @brief When merging, returns the structure of the same name as @a type that
+*        has been read from another snapshot, if any.
+*
+* Otherwise, @a type is returned.
+*/
+ShPtr<Type> SnapshotReader::mergeType(ShPtr<Type> type) {
+	ShPtr<StructType> structType(cast<StructType>(type));
+	if (!merged || !structType || !structType->hasName()) {
+		return type;
+	}
+	return merged->structTypes.emplace(structType->getName(),
+		type).first->second;
+}
+
+/**
+* @brief Reads the table of variables and creates the variables, and the
+*        functions they correspond to, in the order of the table.
+*
+* When merging, functions and global variables that have been read from
+* another snapshot are reused instead of being created again.
+*/
+void SnapshotReader::readVarTable() {
+	std::size_t count = in.readCount();
+	vars.resize(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		std::size_t index = in.readIndex(count);
+		if (vars[index]) {
+			throw SnapshotError("duplicate variable");
+		}
+
+		auto kind = in.readEnum<VarKind>(3);
+		std::string initialName(in.readString());
+		std::string name(in.readString());
+		ShPtr<Variable> var;
+		ShPtr<Variable> mergedVar;
+		if (kind == VarKind::Function) {
+			ShPtr<Type> retType(readType());
+			bool isVarArg = in.readBool();
+			ShPtr<Function> func(getExistingFunc(name));
+			if (func) {
+				mergedVar = func->getAsVar();
+			} else {
+				func = Function::create(module, retType, initialName,
+					VarVector(), VarSet(), nullptr, isVarArg);
+			}
+			funcsByVarIndex.emplace(index, func);
+			var = func->getAsVar();
+		} else {
+			ShPtr<Type> type(readType());
+			if (kind == VarKind::GlobalVariable) {
+				mergedVar = getExistingGlobalVar(name);
+			}
+			var = mergedVar ? mergedVar : Variable::create(initialName, type);
+		}
+		bool isInternal = in.readBool();
+		Address address(in.readAddress());
+		if (mergedVar && kind == VarKind::Function) {
+			mergedFuncVarAttrs.emplace(index,
+				std::make_pair(isInternal, address));
+		} else if (!mergedVar) {
+			var->setName(name);
+			if (!isInternal) {
+				var->markAsExternal();
+			}
+			var->setAddress(relocate(address));
+			if (merged && kind == VarKind::Function) {
+				merged->funcs.emplace(name, funcsByVarIndex[index]);
+			} else if (merged && kind == VarKind::GlobalVariable) {
+				merged->globalVars.emplace(name, var);
+			}
+		}
+		vars[index] = var;
+	}
+}
+
+void SnapshotReader::readGlobalVars() {
+	std::size_t count = in.readCount();
+	for (std::size_t i = 0; i < count; ++i) {
+		ShPtr<Variable> var(readVar());
+		ShPtr<Expression> init(readExpr());
+		// A global variable read from another snapshot is already there.
+		if (!module->isGlobalVar(var)) {
+			module->addGlobalVar(var, init);
+		}
+	}
+}
+
+void SnapshotReader::readFuncs() {
+	std::size_t count = in.readCount();
+	for (std::size_t i = 0; i < count; ++i) {
+		std::size_t index = in.readIndex(vars.size());
+		auto funcIt = funcsByVarIndex.find(index);
+		if (funcIt == funcsByVarIndex.end()) {
+			throw SnapshotError("invalid function");
+		}
+		ShPtr<Function> func(funcIt->second);
+
+		VarVector params(readVars());
+		VarVector localVars(readVars());
+		ShPtr<Statement> body;
+		if (in.readBool()) {
+			body = readNonEmptyStmts();
+		}
+
+		if (intoFunc) {
+			if (func != intoFunc || !body || readFuncBody) {
+				throw SnapshotError("invalid function");
+			}
+			readFuncParams = params;
+			readFuncLocalVars = localVars;
+			readFuncBody = body;
+			continue;
+		}
+
+		// A function read from another snapshot is already there. Only its
+		// declaration may have been read, in which case it is completed
+		// from its definition.
+		bool isInModule = module->getFuncByName(func->getName()) == func;
+		if (isInModule && (!body || func->isDefinition())) {
+			continue;
+		}
+
+		// Parameters are included into the local variables when they are set,
+		// so they have to be set after the local variables.
+		func->setLocalVars(VarSet(localVars.begin(), localVars.end()));
+		func->setParams(params);
+		func->setBody(body);
+		if (!isInModule) {
+			module->addFunc(func);
+		} else {
+			// The declaration may differ from the definition (e.g. it may be
+			// external), so the definition takes precedence.
+			auto attrsIt = mergedFuncVarAttrs.find(index);
+			if (attrsIt != mergedFuncVarAttrs.end()) {
+				if (attrsIt->second.first) {
+					func->getAsVar()->markAsInternal();
+				} else {
+					func->getAsVar()->markAsExternal();
+				}
+				func->getAsVar()->setAddress(attrsIt->second.second);
+			}
+		}
+	}
+}
+
+void SnapshotReader::readDebugNames() {
+	std::size_t count = in.readCount();
+	for (std::size_t i = 0; i < count; ++i) {
+		ShPtr<Variable> var(readVar());
+		module->addDebugNameForVar(var, in.readString());
+	}
+}
+
+void SnapshotReader::resolveGotoTargets() {
+	for (const auto &gotoAndRef : gotoTargetRefs) {
+		auto targetIt = stmtsByRef.find(gotoAndRef.second);
+		if (targetIt == stmtsByRef.end()) {
+			throw SnapshotError("invalid target of a goto statement");
+		}
+		gotoAndRef.first->setTarget(targetIt->second);
+	}
+}
+
+/**
+* @brief Replaces the parameters, local variables, and body of @c intoFunc
+*        with those of the read function.
+*/
+void SnapshotReader::replaceIntoFunc() {
+	if (!readFuncBody) {
+		throw SnapshotError("missing function");
+	}
+
+	// Parameters are included into the local variables when they are set,
+	// so they have to be set after the local variables.
+	intoFunc->setLocalVars(VarSet(readFuncLocalVars.begin(),
+		readFuncLocalVars.end()));
+	intoFunc->setParams(readFuncParams);
+	intoFunc->setBody(readFuncBody);
+}
+
+/**
+* @brief Returns the function named @a name that is already in @c module, or
+*        the null pointer if there is none.
+*
+* When a single function is read, the function named as the read function in
+* the saved module is @c intoFunc, other functions may be renamed (see
+* @c renamedFuncs), and all of them have to exist.
+*/
+ShPtr<Function> SnapshotReader::getExistingFunc(
+		const std::string &name) const {
+	if (intoFunc && name == savedFuncName) {
+		return intoFunc;
+	}
+	if (renamedFuncs) {
+		auto funcIt = renamedFuncs->find(name);
+		if (funcIt != renamedFuncs->end()) {
+			return funcIt->second;
+		}
+	}
+
+	ShPtr<Function> func(merged ?
+		mapGetValueOrDefault(merged->funcs, name) : nullptr);
+	if (!func && intoFunc) {
+		throw SnapshotError("unknown function " + name);
+	}
+	return func;
+}
+
+/**
+* @brief Returns the global variable named @a name that is already in
+*        @c module, or the null pointer if there is none.
+*
+* When a single function is read, the global variable has to exist.
+*/
+ShPtr<Variable> SnapshotReader::getExistingGlobalVar(
+		const std::string &name) const {
+	ShPtr<Variable> var(merged ?
+		mapGetValueOrDefault(merged->globalVars, name) : nullptr);
+	if (!var && intoFunc) {
+		throw SnapshotError("unknown global variable " + name);
+	}
+	return var;
+}
+
+/**
+* @brief When a single function is read, moves @a a from the address range of
+*        the saved function into the address range of @c intoFunc.
+*
+* Other addresses are returned unchanged.
+*/
+Address SnapshotReader::relocate(Address a) const {
+	if (!intoFunc || !a.isDefined() || !savedFuncStart.isDefined() ||
+			!savedFuncEnd.isDefined() || savedFuncStart == savedFuncEnd ||
+			a < savedFuncStart || a > savedFuncEnd) {
+		return a;
+	}
+
+	AddressRange range(module->getAddressRangeForFunc(intoFunc));
+	if (range == NO_ADDRESS_RANGE || !range.getStart().isDefined()) {
+		return a;
+	}
+	return range.getStart() + (a - savedFuncStart);
+}
+
+/**
+* @brief Relocates (see relocate()) all hexadecimal addresses prefixed with
+*        @c 0x in @a str, e.g. in labels or metadata.
+*/
+std::string SnapshotReader::relocateAddressesIn(const std::string &str) const {
+	if (!intoFunc) {
+		return str;
+	}
+
+	std::string result;
+	std::size_t pos = 0;
+	for (std::size_t i = str.find("0x"); i != std::string::npos;
+			i = str.find("0x", pos)) {
+		std::size_t end = std::min(
+			str.find_first_not_of("0123456789abcdefABCDEF", i + 2),
+			str.size());
+		result.append(str, pos, i - pos);
+		pos = end;
+		// At most 16 digits fit into an address.
+		if (end == i + 2 || end - i - 2 > 16) {
+			result.append(str, i, end - i);
+			continue;
+		}
+
+		Address a(std::stoull(str.substr(i + 2, end - i - 2), nullptr, 16));
+		Address relocated(relocate(a));
+		result += relocated == a ? str.substr(i, end - i) :
+			relocated.toHexPrefixString();
+	}
+	result.append(str, pos, std::string::npos);
+	return result;
+}
+
+ShPtr<Type> SnapshotReader::readType() {
+	return types[in.readIndex(types.size())];
+}
+
+ShPtr<Type> SnapshotReader::readTypeRecord(Tag tag) {
+	switch (tag) {
+		case Tag::ArrayType: {
+			ShPtr<Type> elemType(readType());
+			ArrayType::Dimensions dims(in.readCount());
+			for (auto &dim : dims) {
+				dim = in.readUint();
+			}
+			return ArrayType::create(elemType, dims);
+		}
+		case Tag::FloatType:
+			return FloatType::create(in.readUint());
+		case Tag::IntType: {
+			unsigned size = in.readUint();
+			return IntType::create(size, in.readBool());
+		}
+		case Tag::PointerType:
+			return PointerType::create(readType());
+		case Tag::StringType:
+			return StringType::create(in.readUint());
+		case Tag::StructType: {
+			std::string name(in.readString());
+			StructType::ElementTypes elemTypes(in.readCount());
+			for (auto &elemType : elemTypes) {
+				elemType = readType();
+			}
+			return StructType::create(elemTypes, name);
+		}
+		case Tag::FunctionType: {
+			ShPtr<FunctionType> type(FunctionType::create(readType()));
+			type->setVarArg(in.readBool());
+			std::size_t numOfParams = in.readCount();
+			for (std::size_t i = 0; i < numOfParams; ++i) {
+				type->addParam(readType());
+			}
+			return type;
+		}
+		case Tag::VoidType:
+			return VoidType::create();
+		case Tag::UnknownType:
+			return UnknownType::create();
+		default:
+			throw SnapshotError("invalid type");
+	}
+}
+
+ShPtr<Variable> SnapshotReader::readVar() {
+	return vars[in.readIndex(vars.size())];
+}
+
+VarVector SnapshotReader::readVars() {
+	VarVector result(in.readCount());
+	for (auto &var : result) {
+		var = readVar();
+	}
+	return result;
+}
+
+/**
+* @brief Reads an expression, which may be null.
+*/
+ShPtr<Expression> SnapshotReader::readExpr() {
+	Tag tag = in.readTag();
+	return tag == Tag::Null ? nullptr : readExprRecord(tag);
+}
+
+ShPtr<Expression> SnapshotReader::readNonNullExpr() {
+	return readAs(readExpr());
+}
+
+ShPtr<Expression> SnapshotReader::readExprRecord(Tag tag) {
+	switch (tag) {
+		case Tag::AddOpExpr:
+			return readBinaryOpExpr<AddOpExpr>();
+		case Tag::AddressOpExpr:
+			return readUnaryOpExpr<AddressOpExpr>();
+		case Tag::AndOpExpr:
+			return readBinaryOpExpr<AndOpExpr>();
+		case Tag::ArrayIndexOpExpr:
+			return readBinaryOpExpr<ArrayIndexOpExpr>();
+		case Tag::AssignOpExpr:
+			return readBinaryOpExpr<AssignOpExpr>();
+		case Tag::BitAndOpExpr:
+			return readBinaryOpExpr<BitAndOpExpr>();
+		case Tag::BitOrOpExpr:
+			return readBinaryOpExpr<BitOrOpExpr>();
+		case Tag::BitShlOpExpr:
+			return readBinaryOpExpr<BitShlOpExpr>();
+		case Tag::BitShrOpExpr:
+			return readBinaryOpExprWithVariant<BitShrOpExpr>(2);
+		case Tag::BitXorOpExpr:
+			return readBinaryOpExpr<BitXorOpExpr>();
+		case Tag::CallExpr: {
+			ShPtr<Expression> calledExpr(readNonNullExpr());
+			ExprVector args(in.readCount());
+			for (auto &arg : args) {
+				arg = readNonNullExpr();
+			}
+			return CallExpr::create(calledExpr, args);
+		}
+		case Tag::CommaOpExpr:
+			return readBinaryOpExpr<CommaOpExpr>();
+		case Tag::DerefOpExpr:
+			return readUnaryOpExpr<DerefOpExpr>();
+		case Tag::DivOpExpr:
+			return readBinaryOpExprWithVariant<DivOpExpr>(3);
+		case Tag::EqOpExpr:
+			return readBinaryOpExpr<EqOpExpr>();
+		case Tag::GtEqOpExpr:
+			return readBinaryOpExprWithVariant<GtEqOpExpr>(2);
+		case Tag::GtOpExpr:
+			return readBinaryOpExprWithVariant<GtOpExpr>(2);
+		case Tag::LtEqOpExpr:
+			return readBinaryOpExprWithVariant<LtEqOpExpr>(2);
+		case Tag::LtOpExpr:
+			return readBinaryOpExprWithVariant<LtOpExpr>(2);
+		case Tag::ModOpExpr:
+			return readBinaryOpExprWithVariant<ModOpExpr>(3);
+		case Tag::MulOpExpr:
+			return readBinaryOpExpr<MulOpExpr>();
+		case Tag::NegOpExpr:
+			return readUnaryOpExpr<NegOpExpr>();
+		case Tag::NeqOpExpr:
+			return readBinaryOpExpr<NeqOpExpr>();
+		case Tag::NotOpExpr:
+			return readUnaryOpExpr<NotOpExpr>();
+		case Tag::OrOpExpr:
+			return readBinaryOpExpr<OrOpExpr>();
+		case Tag::StructIndexOpExpr: {
+			ShPtr<Expression> base(readNonNullExpr());
+			ShPtr<ConstInt> fieldNumber(readAs(cast<ConstInt>(readExpr())));
+			return StructIndexOpExpr::create(base, fieldNumber);
+		}
+		case Tag::SubOpExpr:
+			return readBinaryOpExpr<SubOpExpr>();
+		case Tag::TernaryOpExpr: {
+			ShPtr<Expression> cond(readNonNullExpr());
+			ShPtr<Expression> trueValue(readNonNullExpr());
+			ShPtr<Expression> falseValue(readNonNullExpr());
+			return TernaryOpExpr::create(cond, trueValue, falseValue);
+		}
+		case Tag::Variable:
+			return readVar();
+		case Tag::BitCastExpr:
+			return readCastExpr<BitCastExpr>();
+		case Tag::ExtCastExpr:
+			return readCastExprWithVariant<ExtCastExpr>(3);
+		case Tag::FPToIntCastExpr:
+			return readCastExpr<FPToIntCastExpr>();
+		case Tag::IntToFPCastExpr:
+			return readCastExprWithVariant<IntToFPCastExpr>(2);
+		case Tag::IntToPtrCastExpr:
+			return readCastExpr<IntToPtrCastExpr>();
+		case Tag::PtrToIntCastExpr:
+			return readCastExpr<PtrToIntCastExpr>();
+		case Tag::TruncCastExpr:
+			return readCastExpr<TruncCastExpr>();
+		case Tag::ConstArray: {
+			ShPtr<ArrayType> type(readAs(cast<ArrayType>(readType())));
+			if (!in.readBool()) {
+				return ConstArray::createUninitialized(type);
+			}
+			ConstArray::ArrayValue value(in.readCount());
+			for (auto &item : value) {
+				item = readNonNullExpr();
+			}
+			return ConstArray::create(value, type);
+		}
+		case Tag::ConstBool:
+			return ConstBool::create(in.readBool());
+		case Tag::ConstFloat: {
+			auto semantics(getFloatSemantics());
+			std::size_t index = in.readIndex(semantics.size());
+			llvm::APInt bits(in.readAPInt());
+			if (bits.getBitWidth() !=
+					llvm::APFloat::getSizeInBits(*semantics[index])) {
+				throw SnapshotError("invalid floating-point constant");
+			}
+			return ConstFloat::create(llvm::APFloat(*semantics[index], bits));
+		}
+		case Tag::ConstInt: {
+			bool isUnsigned = in.readBool();
+			return ConstInt::create(llvm::APSInt(in.readAPInt(), isUnsigned));
+		}
+		case Tag::ConstNullPointer:
+			return ConstNullPointer::create(
+				readAs(cast<PointerType>(readType())));
+		case Tag::ConstString: {
+			std::size_t charSize = in.readUint();
+			ConstString::UnderlyingStringType value(in.readCount(), 0);
+			for (auto &c : value) {
+				c = in.readUint();
+			}
+			return ConstString::create(value, charSize);
+		}
+		case Tag::ConstStruct: {
+			ShPtr<StructType> type(readAs(cast<StructType>(readType())));
+			ConstStruct::Type value(in.readCount());
+			for (auto &item : value) {
+				item.first = readAs(cast<ConstInt>(readExpr()));
+				item.second = readNonNullExpr();
+			}
+			return ConstStruct::create(value, type);
+		}
+		case Tag::ConstSymbol: {
+			std::string name(in.readString());
+			return ConstSymbol::create(name, readAs(cast<Constant>(readExpr())));
+		}
+		default:
+			throw SnapshotError("invalid expression");
+	}
+}
+
+/**
+* @brief Reads a list of statements, which may be empty, and returns its first
+*        statement.
+*/
+ShPtr<Statement> SnapshotReader::readStmts() {
+	ShPtr<Statement> first;
+	ShPtr<Statement> last;
+	for (Tag tag = in.readTag(); tag != Tag::End; tag = in.readTag()) {
+		ShPtr<Statement> stmt(readStmt(tag));
+		if (last) {
+			last->setSuccessor(stmt);
+		} else {
+			first = stmt;
+		}
+		last = stmt;
+	}
+	return first;
+}
+
+ShPtr<Statement> SnapshotReader::readNonEmptyStmts() {
+	return readAs(readStmts());
+}
+
+ShPtr<Statement> SnapshotReader::readStmt(Tag tag) {
+	Address a(relocate(in.readAddress()));
+	std::string label(relocateAddressesIn(in.readString()));
+	std::string metadata(relocateAddressesIn(in.readString()));
+	std::size_t ref = in.readUint();
+
+	ShPtr<Statement> stmt(readStmtRecord(tag, a));
+	if (!label.empty()) {
+		stmt->setLabel(label);
+	}
+	if (!metadata.empty()) {
+		stmt->setMetadata(metadata);
+	}
+	if (ref != 0 && !stmtsByRef.emplace(ref - 1, stmt).second) {
+		throw SnapshotError("duplicate target of goto statements");
+	}
+	return stmt;
+}
+
+ShPtr<Statement> SnapshotReader::readStmtRecord(Tag tag, Address a) {
+	switch (tag) {
+		case Tag::AssignStmt: {
+			ShPtr<Expression> lhs(readNonNullExpr());
+			ShPtr<Expression> rhs(readNonNullExpr());
+			return AssignStmt::create(lhs, rhs, nullptr, a);
+		}
+		case Tag::BreakStmt:
+			return BreakStmt::create(a);
+		case Tag::CallStmt:
+			return CallStmt::create(readAs(cast<CallExpr>(readExpr())),
+				nullptr, a);
+		case Tag::ContinueStmt:
+			return ContinueStmt::create(a);
+		case Tag::EmptyStmt:
+			return EmptyStmt::create(nullptr, a);
+		case Tag::ForLoopStmt: {
+			ShPtr<Variable> indVar(readVar());
+			ShPtr<Expression> startValue(readNonNullExpr());
+			ShPtr<Expression> endCond(readNonNullExpr());
+			ShPtr<Expression> step(readNonNullExpr());
+			ShPtr<Statement> body(readNonEmptyStmts());
+			return ForLoopStmt::create(indVar, startValue, endCond, step,
+				body, nullptr, a);
+		}
+		case Tag::UForLoopStmt: {
+			ShPtr<Expression> init(readExpr());
+			ShPtr<Expression> cond(readExpr());
+			ShPtr<Expression> step(readExpr());
+			bool isInitDefinition = in.readBool();
+			ShPtr<Statement> body(readNonEmptyStmts());
+			ShPtr<UForLoopStmt> loop(UForLoopStmt::create(init, cond, step,
+				body, nullptr, a));
+			if (isInitDefinition) {
+				loop->markInitAsDefinition();
+			}
+			return loop;
+		}
+		case Tag::GotoStmt: {
+			// The target may not have been read yet.
+			ShPtr<GotoStmt> gotoStmt(GotoStmt::create(EmptyStmt::create(), a));
+			gotoTargetRefs.emplace_back(gotoStmt, in.readUint());
+			return gotoStmt;
+		}
+		case Tag::IfStmt: {
+			std::size_t numOfClauses = in.readCount();
+			if (numOfClauses == 0) {
+				throw SnapshotError("if statement without clauses");
+			}
+			ShPtr<Expression> cond(readNonNullExpr());
+			ShPtr<Statement> body(readNonEmptyStmts());
+			ShPtr<IfStmt> ifStmt(IfStmt::create(cond, body, nullptr, a));
+			for (std::size_t i = 1; i < numOfClauses; ++i) {
+				ShPtr<Expression> clauseCond(readNonNullExpr());
+				ifStmt->addClause(clauseCond, readNonEmptyStmts());
+			}
+			if (in.readBool()) {
+				ifStmt->setElseClause(readNonEmptyStmts());
+			}
+			return ifStmt;
+		}
+		case Tag::ReturnStmt:
+			return ReturnStmt::create(readExpr(), nullptr, a);
+		case Tag::SwitchStmt: {
+			ShPtr<SwitchStmt> switchStmt(SwitchStmt::create(readNonNullExpr(),
+				nullptr, a));
+			std::size_t numOfClauses = in.readCount();
+			for (std::size_t i = 0; i < numOfClauses; ++i) {
+				ShPtr<Expression> expr(readExpr());
+				if (!expr && switchStmt->hasDefaultClause()) {
+					throw SnapshotError("duplicate default clause");
+				}
+				switchStmt->addClause(expr, readNonEmptyStmts());
+			}
+			return switchStmt;
+		}
+		case Tag::UnreachableStmt:
+			return UnreachableStmt::create(a);
+		case Tag::VarDefStmt: {
+			ShPtr<Variable> var(readVar());
+			return VarDefStmt::create(var, readExpr(), nullptr, a);
+		}
+		case Tag::WhileLoopStmt: {
+			ShPtr<Expression> cond(readNonNullExpr());
+			return WhileLoopStmt::create(cond, readNonEmptyStmts(), nullptr, a);
+		}
+		default:
+			throw SnapshotError("invalid statement");
+	}
+}
+
+} // anonymous namespace
+
+/**
+* @brief Saves @a module into @a out.
+*
+* @return @c true if the module has been saved, @c false otherwise (the module
+*         contains something that cannot be saved, or writing failed).
+*
+* @par Preconditions
+*  - @a module is non-null
+*/
+bool BIRSnapshot::save(ShPtr<Module> module, std::ostream &out) {
+	PRECONDITION_NON_NULL(module);
+
+	std::string snapshot;
+	try {
+		snapshot = SnapshotWriter(module).write();
+	} catch (const SnapshotError &) {
+		return false;
+	}
+	out.write(snapshot.data(), snapshot.size());
+	return static_cast<bool>(out);
+}
+
+/**
+* @brief Loads a module saved by save() from @a in.
+*
+* @param[in] in Stream with the snapshot.
+* @param[in] llvmModule LLVM module from which the saved module was created.
+* @param[in] semantics The used semantics.
+* @param[in] config The used config.
+*
+* @return The loaded module, or the null pointer if the snapshot is malformed
+*         or was saved by a different version.
+*
+* @par Preconditions
+*  - @a llvmModule, @a semantics, and @a config are non-null
+*/
+ShPtr<Module> BIRSnapshot::load(std::istream &in,
+		const llvm::Module *llvmModule, ShPtr<Semantics> semantics,
+		ShPtr<Config> config) {
+	PRECONDITION_NON_NULL(llvmModule);
+	PRECONDITION_NON_NULL(semantics);
+	PRECONDITION_NON_NULL(config);
+
+	std::string data(std::istreambuf_iterator<char>(in), {});
+	try {
+		return SnapshotReader(std::move(data), llvmModule, semantics,
+			config).read();
+	} catch (const SnapshotError &) {
+		return nullptr;
+	}
+}
+
+/**
+* @brief Loads a module merged from snapshots of several parts of it.
+*
+* @param[in] ins Streams with the snapshots.
+* @param[in] llvmModule LLVM module from which the whole module was created.
+* @param[in] semantics The used semantics.
+* @param[in] config The used config.
+*
+* The snapshots are expected to have been saved from modules created from
+* parts of @a llvmModule that share its global variables and function
+* declarations, but each of which defines a different subset of its
+* functions. Functions, global variables, and named structures of the same
+* name are merged into a single one, and a function that is only declared in
+* one snapshot gets the body it has in another one. Functions are added in the
+* order in which they first appear in the snapshots.
+*
+* @return The merged module, or the null pointer if there are no snapshots or
+*         any of them is malformed or was saved by a different version.
+*
+* @par Preconditions
+*  - @a llvmModule, @a semantics, and @a config are non-null
+*  - all streams in @a ins are non-null
+*/
+ShPtr<Module> BIRSnapshot::loadMerged(const std::vector<std::istream *> &ins,
+		const llvm::Module *llvmModule, ShPtr<Semantics> semantics,
+		ShPtr<Config> config) {
+	PRECONDITION_NON_NULL(llvmModule);
+	PRECONDITION_NON_NULL(semantics);
+	PRECONDITION_NON_NULL(config);
+
+	ShPtr<Module> module;
+	MergedEntities merged;
+	for (std::istream *in : ins) {
+		PRECONDITION_NON_NULL(in);
+
+		std::string data(std::istreambuf_iterator<char>(*in), {});
+		try {
+			module = SnapshotReader(std::move(data), llvmModule, semantics,
+				config, module, &merged).read();
+		} catch (const SnapshotError &) {
+			return nullptr;
+		}
+	}
+	return module;
+}
+
+/**
+* @brief Saves the function @a func of @a module into @a out.
+*
+* The snapshot contains only @a func, not the global variables or other
+* functions it refers to. Such a snapshot can be loaded into a function of
+* another module by loadFuncs().
+*
+* @return @c true if the function has been saved, @c false otherwise (the
+*         function contains something that cannot be saved, or writing
+*         failed).
+*
+* @par Preconditions
+*  - @a module and @a func are non-null
+*  - @a func is a definition in @a module
+*/
+bool BIRSnapshot::saveFunc(ShPtr<Module> module, ShPtr<Function> func,
+		std::ostream &out) {
+	PRECONDITION_NON_NULL(module);
+	PRECONDITION_NON_NULL(func);
+	PRECONDITION(func->isDefinition(), "it is a declaration");
+
+	std::string snapshot;
+	try {
+		snapshot = SnapshotWriter(module, func).write();
+	} catch (const SnapshotError &) {
+		return false;
+	}
+	out.write(snapshot.data(), snapshot.size());
+	return static_cast<bool>(out);
+}
+
+/**
+* @brief Loads functions saved by saveFunc() into functions of @a module.
+*
+* @param[in] module Module into whose functions the snapshots are loaded.
+* @param[in] snapshots Snapshots and functions of @a module into which they
+*                      are loaded.
+*
+* The parameters, local variables, and body of each function are replaced by
+* those from its snapshot. Other functions and global variables that a saved
+* function refers to are looked up by name in @a module (unless they are given
+* in FuncSnapshot::funcs), and calls of the saved function itself become calls
+* of the function into which it is loaded.
+* Addresses within the address range of the saved function (in statements,
+* labels, and metadata) are moved into the address range of the function into
+* which it is loaded. A snapshot that cannot be loaded (e.g. because it refers
+* to a function that is not in @a module) leaves its function untouched.
+*
+* @return Functions into which their snapshots have been loaded.
+*
+* @par Preconditions
+*  - @a module is non-null
+*  - all functions and streams in @a snapshots are non-null, and the functions
+*    are in @a module
+*/
+FuncSet BIRSnapshot::loadFuncs(ShPtr<Module> module,
+		const std::vector<FuncSnapshot> &snapshots) {
+	PRECONDITION_NON_NULL(module);
+
+	MergedEntities existing;
+	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
+		existing.funcs.emplace((*i)->getName(), *i);
+	}
+	for (auto i = module->global_var_begin(), e = module->global_var_end();
+			i != e; ++i) {
+		existing.globalVars.emplace((*i)->getVar()->getName(), (*i)->getVar());
+	}
+
+	FuncSet loaded;
+	for (const auto &snapshot : snapshots) {
+		PRECONDITION_NON_NULL(snapshot.func);
+		PRECONDITION_NON_NULL(snapshot.in);
+
+		std::string data(std::istreambuf_iterator<char>(*snapshot.in), {});
+		try {
+			SnapshotReader(std::move(data), module, snapshot.func, &existing,
+				&snapshot.funcs).read();
+			loaded.insert(snapshot.func);
+		} catch (const SnapshotError &) {
+			continue;
+		}
+	}
+	return loaded;
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
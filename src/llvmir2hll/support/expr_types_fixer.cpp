@@ -49,83 +49,73 @@ ExprTypesFixer::ExprTypesFixer():
 */
 void ExprTypesFixer::setProbablyTypes(ShPtr<Module> module) {
 	// Create Analysis of integer types.
+	//
+	// The analysis is run only once. It marks all the visited statements as
+	// accessed, so running it again after the types were changed found no
+	// tags, and it only walked the whole module for nothing.
 	ShPtr<ExprTypesAnalysis> exprTypesAnalysis(ExprTypesAnalysis::create());
-	bool changed = true;
-	while (changed) {
-		changed = false;
-		// The analysis returns statistics about variables in map.
-		ExprTypesAnalysis::ExprTagsMap exprTagsMap =
-				exprTypesAnalysis->analyzeExprTypes(module);
-		// Check statistics about all variables and fix their types to correct
-		// signed if expected.
-		for (const auto &p : exprTagsMap) {
-			ShPtr<Expression> expr = p.first;
-			// Get statistics about expression - how many times it is used as
-			// signed.
-			std::size_t isSigned = exprTypesAnalysis->getCountOfTag(
-				expr, ExprTypesAnalysis::ExprTag::Signed);
-			// Get statistics about expression - how many times it is used as
-			// unsigned.
-			std::size_t isUnsigned = exprTypesAnalysis->getCountOfTag(
-				expr, ExprTypesAnalysis::ExprTag::Unsigned);
-			// We can change the type of a variable.
-			if (ShPtr<Variable> var = cast<Variable>(expr)) {
+	// The analysis returns statistics about variables in map.
+	const ExprTypesAnalysis::ExprTagsMap &exprTagsMap(
+		exprTypesAnalysis->analyzeExprTypes(module));
+	// Check statistics about all variables and fix their types to correct
+	// signed if expected.
+	for (const auto &p : exprTagsMap) {
+		ShPtr<Expression> expr = p.first;
+		// Get statistics about expression - how many times it is used as
+		// signed and unsigned.
+		std::size_t isSigned = p.second.signedCount;
+		std::size_t isUnsigned = p.second.unsignedCount;
+		// We can change the type of a variable.
+		if (ShPtr<Variable> var = cast<Variable>(expr)) {
+			if (ShPtr<IntType> type = cast<IntType>(var->getType())) {
+				// Evaluation of statistics and fixing of type.
+				if ((isSigned > isUnsigned) && type->isUnsigned()) {
+					var->setType(IntType::create(type->getSize(), true));
+				} else if ((isSigned <= isUnsigned) && type->isSigned()) {
+					var->setType(IntType::create(type->getSize(), false));
+				}
+			}
+		// We can change the type of a constant.
+		} else if (ShPtr<ConstInt> constant = cast<ConstInt>(expr)) {
+			if (ShPtr<IntType> type = cast<IntType>(constant->getType())) {
+				// Evaluation of statistics and fixing of type.
+				if ((isSigned > isUnsigned) && constant->isUnsigned()) {
+					llvm::APSInt val = constant->getValue();
+					val.setIsSigned(true);
+					Expression::replaceExpression(expr,
+						ConstInt::create(val));
+				} else if ((isSigned <= isUnsigned) && constant->isSigned()) {
+					llvm::APSInt val = constant->getValue();
+					val.setIsUnsigned(true);
+					Expression::replaceExpression(expr,
+						ConstInt::create(val));
+				}
+			}
+		// We can change the type of a CalledExpr of CallExpr.
+		} else if (ShPtr<CallExpr> callExpr = cast<CallExpr>(expr)) {
+			if (ShPtr<Variable> var = cast<Variable>(callExpr->getCalledExpr())) {
+				// We are finding a local function.
+				bool found = false;
+				// Searched function.
+				ShPtr<Function> func = module->getFuncByName(var->getName());
+				if (func) {
+					found = true;
+				}
 				if (ShPtr<IntType> type = cast<IntType>(var->getType())) {
-					// Evaluation of statistics and fixing of type.
+					// Evaluation of statistics and fixing of the type.
 					if ((isSigned > isUnsigned) && type->isUnsigned()) {
-						changed = true;
 						var->setType(IntType::create(type->getSize(), true));
+						// If the called expression is a function, we have
+						// to change its type, too.
+						if (found) {
+							func->setRetType(IntType::create(type->getSize(), true));
+						}
 					} else if ((isSigned <= isUnsigned) && type->isSigned()) {
-						changed = true;
 						var->setType(IntType::create(type->getSize(), false));
-					}
-				}
-			// We can change the type of a constant.
-			} else if (ShPtr<ConstInt> constant = cast<ConstInt>(expr)) {
-				if (ShPtr<IntType> type = cast<IntType>(constant->getType())) {
-					// Evaluation of statistics and fixing of type.
-					if ((isSigned > isUnsigned) && constant->isUnsigned()) {
-						changed = true;
-						llvm::APSInt val = constant->getValue();
-						val.setIsSigned(true);
-						Expression::replaceExpression(expr,
-							ConstInt::create(val));
-					} else if ((isSigned <= isUnsigned) && constant->isSigned()) {
-						changed = true;
-						llvm::APSInt val = constant->getValue();
-						val.setIsUnsigned(true);
-						Expression::replaceExpression(expr,
-							ConstInt::create(val));
-					}
-				}
-			// We can change the type of a CalledExpr of CallExpr.
-			} else if (ShPtr<CallExpr> callExpr = cast<CallExpr>(expr)) {
-				if (ShPtr<Variable> var = cast<Variable>(callExpr->getCalledExpr())) {
-					// We are finding a local function.
-					bool found = false;
-					// Searched function.
-					ShPtr<Function> func = module->getFuncByName(var->getName());
-					if (func) {
-						found = true;
-					}
-					if (ShPtr<IntType> type = cast<IntType>(var->getType())) {
-						// Evaluation of statistics and fixing of the type.
-						if ((isSigned > isUnsigned) && type->isUnsigned()) {
-							changed = true;
-							var->setType(IntType::create(type->getSize(), true));
-							// If the called expression is a function, we have
-							// to change its type, too.
-							if (found) {
-								func->setRetType(IntType::create(type->getSize(), true));
-							}
-						} else if ((isSigned <= isUnsigned) && type->isSigned()) {
-							changed = true;
-							var->setType(IntType::create(type->getSize(), false));
-							// If the called expression is a function, we have
-							// to change its type, too.
-							if (found) {
-								func->setRetType(IntType::create(type->getSize(), false));
-							}
+						// If the called expression is a function, we have
+						// to change its type, too.
+						if (found) {
+							func->setRetType(IntType::create(type->getSize(), false));
 						}
 					}
 				}
@@ -0,0 +1,77 @@
+/**
+* @file src/llvmir2hll/support/func_fingerprinter.cpp
+* @brief Implementation of FuncFingerprinter.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <functional>
+#include <string>
+
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/statement.h"
+#include "retdec/llvmir2hll/support/func_fingerprinter.h"
+#include "retdec/llvmir2hll/support/types.h"
+#include "retdec/utils/container.h"
+
+using retdec::utils::hasItem;
+
+namespace retdec {
+namespace llvmir2hll {
+
+/**
+* @brief Constructs a new fingerprinter.
+*/
+FuncFingerprinter::FuncFingerprinter(): OrderedAllVisitor(), fp(0) {}
+
+/**
+* @brief Returns the fingerprint of @a func.
+*
+* Two calls return the same fingerprint if and only if (up to hash collisions)
+* the function has not been changed between them. For function declarations,
+* only their signature is taken into account.
+*
+* @par Preconditions
+*  - @a func is non-null
+*/
+std::size_t FuncFingerprinter::fingerprint(ShPtr<Function> func) {
+	ShPtr<FuncFingerprinter> fingerprinter(new FuncFingerprinter());
+	return fingerprinter->fingerprintInternal(func);
+}
+
+/**
+* @brief Internal implementation of fingerprint().
+*
+* See the description of fingerprint() for more info.
+*/
+std::size_t FuncFingerprinter::fingerprintInternal(ShPtr<Function> func) {
+	fp = 0;
+	addToFingerprint(std::hash<std::string>()(func->getTextRepr()));
+	if (ShPtr<Statement> body = func->getBody()) {
+		visitStmt(body);
+	}
+	return fp;
+}
+
+/**
+* @brief Combines @a value into the computed fingerprint.
+*/
+void FuncFingerprinter::addToFingerprint(std::size_t value) {
+	fp ^= value + 0x9e3779b9 + (fp << 6) + (fp >> 2);
+}
+
+void FuncFingerprinter::visitStmt(ShPtr<Statement> stmt, bool visitSuccessors,
+		bool visitNestedStmts) {
+	if (!stmt || hasItem(accessedStmts, stmt)) {
+		return;
+	}
+
+	// The ID of the statement reflects the structure of the body (replaced
+	// statements get new IDs) and the textual representation reflects the
+	// expressions in the statement.
+	addToFingerprint(stmt->getId());
+	addToFingerprint(std::hash<std::string>()(stmt->getTextRepr()));
+	OrderedAllVisitor::visitStmt(stmt, visitSuccessors, visitNestedStmts);
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
@@ -0,0 +1,393 @@
+/**
+* @file src/llvmir2hll/support/func_result_cache.cpp
+* @brief Implementation of FuncResultCache.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <fstream>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/InlineAsm.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/module.h"
+#include "retdec/llvmir2hll/llvm/llvm_support.h"
+#include "retdec/llvmir2hll/support/bir_snapshot.h"
+#include "retdec/llvmir2hll/support/func_result_cache.h"
+#include "retdec/utils/container.h"
+#include "retdec/utils/filesystem.h"
+
+using retdec::utils::hasItem;
+using retdec::utils::mapGetValueOrDefault;
+
+namespace retdec {
+namespace llvmir2hll {
+
+namespace {
+
+/// The first line of every entry.
+const std::string ENTRY_MAGIC = "RDFC";
+
+/// Suffix of entries.
+const std::string ENTRY_SUFFIX = ".bir";
+
+/**
+* @brief Prints @a type into @a out.
+*
+* @return @c false if the type contains a named structure, whose name may
+*         differ between inputs, @c true otherwise.
+*/
+bool printType(llvm::Type *type, llvm::raw_ostream &out) {
+	std::string str;
+	llvm::raw_string_ostream strOut(str);
+	type->print(strOut);
+	strOut.flush();
+	out << str;
+	return str.find('%') == std::string::npos;
+}
+
+/**
+* @brief Returns @c true if @a constant refers to a global value (a global
+*        variable or a function), @c false otherwise.
+*/
+bool refersToGlobalValue(const llvm::Constant *constant) {
+	if (llvm::isa<llvm::GlobalValue>(constant)) {
+		return true;
+	}
+
+	for (const auto &op : constant->operands()) {
+		auto opConstant = llvm::dyn_cast<llvm::Constant>(op);
+		if (opConstant && refersToGlobalValue(opConstant)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // anonymous namespace
+
+/**
+* @brief Constructs a cache of entries in the given directory.
+*
+* @param[in] dir Directory with the entries. It is created when the first
+*                entry is stored.
+* @param[in] context Description of everything besides the functions
+*                    themselves that influences the optimized functions.
+*/
+FuncResultCache::FuncResultCache(const std::string &dir,
+		const std::string &context): dir(dir), context(context) {}
+
+/**
+* @brief Computes the keys of all functions defined in @a llvmModule.
+*
+* It has to be called before the LLVM module is converted.
+*/
+void FuncResultCache::computeKeys(const llvm::Module &llvmModule) {
+	for (const auto &func : llvmModule) {
+		if (!func.isDeclaration()) {
+			std::string key(computeKey(func));
+			if (!key.empty()) {
+				keysByName.emplace(func.getName().str(), key);
+			}
+		}
+	}
+}
+
+/**
+* @brief Returns the key of the function named @a funcName in the LLVM module.
+*
+* If the function cannot be cached, the empty string is returned.
+*/
+std::string FuncResultCache::getKey(const std::string &funcName) const {
+	return mapGetValueOrDefault(keysByName, funcName);
+}
+
+/**
+* @brief Restores the functions of @a module whose keys are in the cache.
+*
+* The parameters, local variables, and bodies of the restored functions are
+* replaced by those from the cache, so they do not have to be optimized.
+* Functions that are only declared in @a module (e.g. removed functions from
+* standard libraries) are not restored.
+*
+* @return The restored functions.
+*/
+FuncSet FuncResultCache::restore(ShPtr<Module> module) {
+	// The called functions are looked up by their keys. A key shared by
+	// several functions does not tell which of them should be called.
+	std::map<std::string, ShPtr<Function>> funcsByKey;
+	std::set<std::string> ambiguousKeys;
+	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
+		std::string key(getKey((*i)->getInitialName()));
+		if (!key.empty() && !funcsByKey.emplace(key, *i).second) {
+			ambiguousKeys.insert(key);
+		}
+	}
+
+	std::vector<std::unique_ptr<std::ifstream>> ins;
+	std::vector<BIRSnapshot::FuncSnapshot> snapshots;
+	for (auto i = module->func_definition_begin(),
+			e = module->func_definition_end(); i != e; ++i) {
+		std::string key(getKey((*i)->getInitialName()));
+		if (key.empty()) {
+			continue;
+		}
+
+		auto in = std::make_unique<std::ifstream>(getEntryPath(key),
+			std::ios::binary);
+		std::string magic;
+		std::size_t numOfCallees = 0;
+		if (!std::getline(*in, magic) || magic != ENTRY_MAGIC ||
+				!(*in >> numOfCallees) || in->get() != '\n') {
+			continue;
+		}
+
+		BIRSnapshot::FuncSnapshot snapshot{*i, in.get(), {}};
+		bool calleesFound = true;
+		for (std::size_t j = 0; j < numOfCallees; ++j) {
+			std::string calleeName;
+			std::string calleeKey;
+			ShPtr<Function> callee;
+			if (*in >> calleeName >> calleeKey && in->get() == '\n' &&
+					!hasItem(ambiguousKeys, calleeKey)) {
+				callee = mapGetValueOrDefault(funcsByKey, calleeKey);
+			}
+			if (!callee) {
+				calleesFound = false;
+				break;
+			}
+			snapshot.funcs.emplace(calleeName, callee);
+		}
+		if (calleesFound) {
+			snapshots.push_back(std::move(snapshot));
+			ins.push_back(std::move(in));
+		}
+	}
+
+	restoredFuncs = BIRSnapshot::loadFuncs(module, snapshots);
+	return restoredFuncs;
+}
+
+/**
+* @brief Stores the optimized functions of @a module that have a key and that
+*        have not been restored from the cache.
+*
+* Entries that already exist are kept.
+*
+* @return Number of stored functions.
+*/
+std::size_t FuncResultCache::store(ShPtr<Module> module) {
+	std::map<std::string, ShPtr<Function>> funcsByName;
+	for (auto i = module->func_begin(), e = module->func_end(); i != e; ++i) {
+		funcsByName.emplace((*i)->getInitialName(), *i);
+	}
+
+	std::error_code ec;
+	fs::create_directories(dir, ec);
+
+	std::size_t numOfStoredFuncs = 0;
+	for (auto i = module->func_definition_begin(),
+			e = module->func_definition_end(); i != e; ++i) {
+		ShPtr<Function> func(*i);
+		std::string key(getKey(func->getInitialName()));
+		if (key.empty() || hasItem(restoredFuncs, func)) {
+			continue;
+		}
+		fs::path entryPath(getEntryPath(key));
+		if (fs::exists(entryPath, ec)) {
+			continue;
+		}
+
+		// Called functions are stored by their names in the module, under
+		// which they appear in the snapshot, together with their keys, under
+		// which they are looked up when the function is restored.
+		std::ostringstream entry;
+		entry << ENTRY_MAGIC << '\n';
+		const auto &callees(calleeKeys[func->getInitialName()]);
+		entry << callees.size() << '\n';
+		bool calleesFound = true;
+		for (const auto &calleeAndKey : callees) {
+			ShPtr<Function> callee(mapGetValueOrDefault(funcsByName,
+				calleeAndKey.first));
+			if (!callee || callee->getName().find_first_of(" \t\r\n") !=
+					std::string::npos) {
+				calleesFound = false;
+				break;
+			}
+			entry << callee->getName() << ' ' << calleeAndKey.second << '\n';
+		}
+		if (!calleesFound || !BIRSnapshot::saveFunc(module, func, entry)) {
+			continue;
+		}
+
+		// More processes may store the same function at once, so the entry
+		// is written under a unique name and then atomically renamed.
+		fs::path tmpPath(entryPath);
+		tmpPath += "." + std::to_string(std::random_device()()) + ".tmp";
+		std::ofstream out(tmpPath, std::ios::binary);
+		out << entry.str();
+		out.close();
+		if (out) {
+			fs::rename(tmpPath, entryPath, ec);
+			if (!ec) {
+				++numOfStoredFuncs;
+			}
+		}
+		fs::remove(tmpPath, ec);
+	}
+	return numOfStoredFuncs;
+}
+
+/**
+* @brief Computes the key of the defined function @a func.
+*
+* The empty string is returned if @a func cannot be cached.
+*/
+std::string FuncResultCache::computeKey(const llvm::Function &func) {
+	auto keyIt = keys.find(&func);
+	if (keyIt != keys.end()) {
+		return keyIt->second;
+	}
+	// A function whose key is being computed is recursive with one of the
+	// functions it calls, so it cannot be cached.
+	keys.emplace(&func, std::string());
+
+	// Arguments, basic blocks, and instructions are identified by their
+	// order, and addresses of instructions are replaced by their offsets from
+	// the first address.
+	std::map<const llvm::Value *, std::size_t> localIds;
+	Address startAddress;
+	for (const auto &arg : func.args()) {
+		localIds.emplace(&arg, localIds.size());
+	}
+	for (const auto &bb : func) {
+		localIds.emplace(&bb, localIds.size());
+		for (const auto &inst : bb) {
+			localIds.emplace(&inst, localIds.size());
+			if (!startAddress.isDefined()) {
+				startAddress = LLVMSupport::getInstAddress(&inst);
+			}
+		}
+	}
+
+	std::map<std::string, std::string> callees;
+	std::string desc;
+	llvm::raw_string_ostream out(desc);
+	out << context << '\n';
+	bool cacheable = printType(func.getFunctionType(), out);
+	auto printOperand = [&](const llvm::Value *value) {
+		out << ' ';
+		auto localIt = localIds.find(value);
+		if (localIt != localIds.end()) {
+			out << '%' << localIt->second;
+			return true;
+		}
+
+		if (auto callee = llvm::dyn_cast<llvm::Function>(value)) {
+			if (callee == &func) {
+				out << "<self>";
+				return true;
+			}
+			if (callee->isDeclaration()) {
+				out << '@' << callee->getName() << ':';
+				return printType(callee->getFunctionType(), out);
+			}
+			std::string calleeKey(computeKey(*callee));
+			callees.emplace(callee->getName().str(), calleeKey);
+			out << '#' << calleeKey;
+			return !calleeKey.empty();
+		}
+
+		auto constant = llvm::dyn_cast<llvm::Constant>(value);
+		if ((constant && !refersToGlobalValue(constant)) ||
+				llvm::isa<llvm::InlineAsm>(value)) {
+			// The type is printed separately because of named structures.
+			value->printAsOperand(out, /* PrintType */ false);
+			out << ':';
+			return printType(value->getType(), out);
+		}
+
+		// Global variables, metadata, etc.
+		return false;
+	};
+	for (auto i = func.begin(), e = func.end(); i != e && cacheable; ++i) {
+		out << "bb\n";
+		for (const auto &inst : *i) {
+			out << inst.getOpcodeName() << ' ';
+			cacheable &= printType(inst.getType(), out);
+
+			Address address(LLVMSupport::getInstAddress(&inst));
+			if (address.isDefined()) {
+				out << " +" << (address - startAddress);
+			}
+			if (auto cmp = llvm::dyn_cast<llvm::CmpInst>(&inst)) {
+				out << " pred " << cmp->getPredicate();
+			} else if (auto gep = llvm::dyn_cast<llvm::GetElementPtrInst>(&inst)) {
+				out << (gep->isInBounds() ? " inbounds " : " ");
+				cacheable &= printType(gep->getSourceElementType(), out);
+			} else if (auto alloca = llvm::dyn_cast<llvm::AllocaInst>(&inst)) {
+				out << ' ';
+				cacheable &= printType(alloca->getAllocatedType(), out);
+			} else if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+				out << (load->isVolatile() ? " volatile" : "");
+			} else if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+				out << (store->isVolatile() ? " volatile" : "");
+			} else if (auto phi = llvm::dyn_cast<llvm::PHINode>(&inst)) {
+				for (const auto *bb : phi->blocks()) {
+					out << " from %" << localIds[bb];
+				}
+			} else if (auto ev = llvm::dyn_cast<llvm::ExtractValueInst>(&inst)) {
+				for (unsigned index : ev->indices()) {
+					out << " [" << index << ']';
+				}
+			} else if (auto iv = llvm::dyn_cast<llvm::InsertValueInst>(&inst)) {
+				for (unsigned index : iv->indices()) {
+					out << " [" << index << ']';
+				}
+			} else if (auto sv = llvm::dyn_cast<llvm::ShuffleVectorInst>(&inst)) {
+				for (int index : sv->getShuffleMask()) {
+					out << " <" << index << '>';
+				}
+			}
+
+			for (const auto &op : inst.operands()) {
+				cacheable &= printOperand(op.get());
+			}
+			out << '\n';
+		}
+	}
+	out.flush();
+	if (!cacheable) {
+		return std::string();
+	}
+
+	llvm::MD5 hash;
+	hash.update(desc);
+	llvm::MD5::MD5Result result;
+	hash.final(result);
+	std::string key(result.digest().str());
+
+	keys[&func] = key;
+	calleeKeys[func.getName().str()] = std::move(callees);
+	return key;
+}
+
+/**
+* @brief Returns the path to the entry with the given key.
+*/
+std::string FuncResultCache::getEntryPath(const std::string &key) const {
+	return (fs::path(dir) / (key + ENTRY_SUFFIX)).string();
+}
+
+} // namespace llvmir2hll
+} // namespace retdec
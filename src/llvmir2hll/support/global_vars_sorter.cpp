@@ -5,7 +5,10 @@
 */
 
 #include <algorithm>
-#include <map>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include "retdec/llvmir2hll/ir/expression.h"
 #include "retdec/llvmir2hll/ir/global_var_def.h"
@@ -13,11 +16,8 @@
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/llvmir2hll/support/global_vars_sorter.h"
 #include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
-#include "retdec/utils/container.h"
 #include "retdec/utils/non_copyable.h"
 
-using retdec::utils::hasItem;
-
 namespace retdec {
 namespace llvmir2hll {
 
@@ -25,114 +25,149 @@ namespace {
 
 /**
 * @brief Sorter of global variables according to their interdependencies.
+*
+* The variables are sorted topologically (Kahn's algorithm) over a dependency
+* graph whose nodes are the indexes of the variables in the input vector.
+* Among the variables whose dependencies have already been emitted, the one
+* with the smallest key is emitted first. Variables without dependencies have
+* smaller keys than variables with dependencies; otherwise, the keys are
+* ordered by the initial names of the variables.
+*
+* The initial names are used instead of the current names to make the
+* variables and their comments (address, original name) appear in a sorted
+* order. That is, instead of
+*
+*   int32_t abaca = 0; // gpr2
+*   int32_t * apple; // 0x804cf40
+*   int32_t apricot = 0; // gpr0
+*
+* we want
+*
+*   int32_t * apple; // 0x804cf40
+*   int32_t apricot = 0; // gpr0
+*   int32_t abaca = 0; // gpr2
+*
+* We use the fact that frontend generates global variables grouped by their
+* type. For example, global variables corresponding to registers are emitted
+* in one group, other variables into other groups. Variables are renamed
+* before HLL emission, and during such renaming, the original groups may be
+* lost. This would result into a mixed order, as shown above.
 */
 class InterdependencySorter: private OrderedAllVisitor,
 		private retdec::utils::NonCopyable {
-	friend class LessThanKey;
-
-private:
+public:
 	/**
-	* @brief Key to be used to sort sequences of ShPtr<GlobalVarDefVector>.
+	* @brief Implementation of GlobalVarsSorter::sortByInterdependencies().
 	*/
-	struct LessThanKey {
-		explicit LessThanKey(ShPtr<InterdependencySorter> sorter): sorter(sorter) {}
-
-		/**
-		* @brief Returns @c true iff <tt>p1 < p2</tt>.
-		*/
-		bool operator() (const ShPtr<GlobalVarDef> &p1,
-				const ShPtr<GlobalVarDef> &p2) {
-			// p1: int a;
-			// p2: int b = /* a appears here */;
-			//
-			// p1 < p2
-			if (hasItem(sorter->varToUsedVarsMap[p2->getVar()], p1->getVar())) {
-				return true;
-			}
+	static GlobalVarDefVector sort(const GlobalVarDefVector &globalVars) {
+		InterdependencySorter sorter(globalVars);
+		return sorter.sortTopologically();
+	}
 
-			// p1: int b = /* a appears here */;
-			// p2: int a;
-			//
-			// !(p1 < p2)
-			if (hasItem(sorter->varToUsedVarsMap[p1->getVar()], p2->getVar())) {
-				return false;
-			}
+private:
+	/// Indexes of global variables in the sorted vector.
+	using Indexes = std::vector<std::size_t>;
 
-			// p1: int a;
-			// p2: int b = /* some variables other than a */;
-			//
-			// p1 < p2
-			if (sorter->varToUsedVarsMap[p1->getVar()].empty() &&
-				!sorter->varToUsedVarsMap[p2->getVar()].empty() &&
-					!hasItem(sorter->varToUsedVarsMap[p2->getVar()], p1->getVar())) {
-				return true;
-			}
+private:
+	explicit InterdependencySorter(const GlobalVarDefVector &globalVars):
+			globalVars(globalVars), dependents(globalVars.size()),
+			depsCount(globalVars.size(), 0), ranks(globalVars.size(), 0) {
+		std::unordered_map<ShPtr<Variable>, std::size_t> varToIndex;
+		for (std::size_t i = 0, e = globalVars.size(); i < e; ++i) {
+			varToIndex.emplace(globalVars[i]->getVar(), i);
+		}
 
-			// p1: int b = /* some variables other than a */;
-			// p2: int a;
-			//
-			// !(p1 < p2)
-			if (sorter->varToUsedVarsMap[p2->getVar()].empty() &&
-				!sorter->varToUsedVarsMap[p1->getVar()].empty() &&
-					!hasItem(sorter->varToUsedVarsMap[p1->getVar()], p2->getVar())) {
-				return false;
+		// Compute the dependencies from the variables used in the
+		// initializers. Variables that are not being sorted and
+		// self-references do not restrict the order.
+		for (std::size_t i = 0, e = globalVars.size(); i < e; ++i) {
+			usedVarsInLastInit.clear();
+			if (ShPtr<Expression> init = globalVars[i]->getInitializer()) {
+				init->accept(this);
+			}
+			for (const auto &var : usedVarsInLastInit) {
+				auto it = varToIndex.find(var);
+				if (it != varToIndex.end() && it->second != i) {
+					dependents[it->second].push_back(i);
+					++depsCount[i];
+				}
 			}
-
-			// p1: int a;
-			// p2: int b;
-			//
-			// The '<' relation is decided by using the original names of the
-			// variables. We use the original names instead of the current
-			// names to make the variables and their comments (address,
-			// original name) appear in a sorted order. That is, instead of
-			//
-			//   int32_t abaca = 0; // gpr2
-			//   int32_t * apple; // 0x804cf40
-			//   int32_t apricot = 0; // gpr0
-			//
-			// we want
-			//
-			//   int32_t * apple; // 0x804cf40
-			//   int32_t apricot = 0; // gpr0
-			//   int32_t abaca = 0; // gpr2
-			//
-			// We use the fact that frontend generates global variables grouped
-			// by their type. For example, global variables corresponding to
-			// registers are emitted in one group, other variables into other
-			// groups.
-			//
-			// The reason why we need to sort the variables by using the
-			// initial names is that variables are renamed before HLL emission,
-			// and during such renaming, the original groups may be lost. This
-			// would result into a mixed order, as shown above.
-			return p1->getVar()->getInitialName() < p2->getVar()->getInitialName();
 		}
 
-		ShPtr<InterdependencySorter> sorter;
-	};
+		computeRanks();
+	}
 
-public:
 	/**
-	* @brief Implementation of GlobalVarsSorter::sortByInterdependencies().
+	* @brief Computes the rank of every variable so that variables with
+	*        a lower rank are emitted first when possible.
 	*/
-	static GlobalVarDefVector sort(const GlobalVarDefVector &globalVars) {
-		ShPtr<InterdependencySorter> sorter(new InterdependencySorter(globalVars));
-
-		GlobalVarDefVector sorted(globalVars);
-		std::sort(sorted.begin(), sorted.end(), LessThanKey(sorter));
-		return sorted;
+	void computeRanks() {
+		Indexes byKey(globalVars.size());
+		std::iota(byKey.begin(), byKey.end(), 0);
+		std::stable_sort(byKey.begin(), byKey.end(),
+			[this](std::size_t i1, std::size_t i2) {
+				bool i1HasDeps = depsCount[i1] > 0;
+				bool i2HasDeps = depsCount[i2] > 0;
+				if (i1HasDeps != i2HasDeps) {
+					return i2HasDeps;
+				}
+				return globalVars[i1]->getVar()->getInitialName() <
+					globalVars[i2]->getVar()->getInitialName();
+			}
+		);
+		for (std::size_t rank = 0, e = byKey.size(); rank < e; ++rank) {
+			ranks[byKey[rank]] = rank;
+		}
+		varsByRank = std::move(byKey);
 	}
 
-private:
-	explicit InterdependencySorter(const GlobalVarDefVector &globalVars) {
-		// Compute used variables in the initializers of all global variables.
-		for (const auto &varInitPair : globalVars) {
-			usedVarsInLastInit.clear();
-			if (ShPtr<Expression> init = varInitPair->getInitializer()) {
-				init->accept(this);
+	/**
+	* @brief Sorts the variables by using their dependencies and ranks.
+	*
+	* When the remaining variables form a dependency loop, the one with the
+	* lowest rank is emitted regardless of its unsatisfied dependencies, so
+	* the result is always complete and deterministic.
+	*/
+	GlobalVarDefVector sortTopologically() {
+		auto byRank = [this](std::size_t i1, std::size_t i2) {
+			return ranks[i1] > ranks[i2];
+		};
+		std::priority_queue<std::size_t, Indexes, decltype(byRank)> ready(byRank);
+		for (std::size_t i = 0, e = globalVars.size(); i < e; ++i) {
+			if (depsCount[i] == 0) {
+				ready.push(i);
+			}
+		}
+
+		GlobalVarDefVector sorted;
+		sorted.reserve(globalVars.size());
+		std::vector<bool> emitted(globalVars.size(), false);
+		std::size_t nextByRank = 0;
+		while (sorted.size() < globalVars.size()) {
+			std::size_t i;
+			if (!ready.empty()) {
+				i = ready.top();
+				ready.pop();
+				if (emitted[i]) {
+					continue;
+				}
+			} else {
+				// A dependency loop; break it.
+				while (emitted[varsByRank[nextByRank]]) {
+					++nextByRank;
+				}
+				i = varsByRank[nextByRank];
+			}
+
+			emitted[i] = true;
+			sorted.push_back(globalVars[i]);
+			for (auto dependent : dependents[i]) {
+				if (--depsCount[dependent] == 0 && !emitted[dependent]) {
+					ready.push(dependent);
+				}
 			}
-			varToUsedVarsMap[varInitPair->getVar()] = usedVarsInLastInit;
 		}
+		return sorted;
 	}
 
 	/// @name Visitor Interface
@@ -144,12 +179,23 @@ private:
 	/// @}
 
 private:
+	/// Global variables to be sorted.
+	const GlobalVarDefVector &globalVars;
+
 	/// Used variables in the last initializer.
 	VarSet usedVarsInLastInit;
 
-	/// Mapping of a variable into the set of variables used in in its
-	/// initializer.
-	std::map<ShPtr<Variable>, VarSet> varToUsedVarsMap;
+	/// For every variable, indexes of the variables whose initializers use it.
+	std::vector<Indexes> dependents;
+
+	/// For every variable, the number of its not yet emitted dependencies.
+	Indexes depsCount;
+
+	/// For every variable, its rank (see computeRanks()).
+	Indexes ranks;
+
+	/// Indexes of the variables ordered by their ranks.
+	Indexes varsByRank;
 };
 
 } // anonymous namespace
@@ -167,9 +213,9 @@ private:
 * @endcode
 * then they are ordered in this way because of their interdependencies.
 *
-* @par Preconditions
-*  - the variables can be sorted in this way, i.e. there are no dependency
-*    loops that would prevent the variables from being sorted
+* The sorting runs in <tt>O(n log n + d)</tt> time, where @c n is the number of
+* variables and @c d is the number of their interdependencies. Dependency loops
+* (e.g. <tt>void *a = &b; void *b = &a;</tt>) are broken deterministically.
 */
 GlobalVarDefVector GlobalVarsSorter::sortByInterdependencies(
 		const GlobalVarDefVector &globalVars) {
@@ -5,14 +5,14 @@
 */
 
 #include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include "retdec/llvmir2hll/ir/array_type.h"
 #include "retdec/llvmir2hll/ir/struct_type.h"
-#include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/llvmir2hll/support/struct_types_sorter.h"
-#include "retdec/utils/container.h"
-
-using retdec::utils::hasItem;
 
 namespace retdec {
 namespace llvmir2hll {
@@ -77,65 +77,74 @@ public:
 * @brief Sorts @c types by using their names.
 */
 void sortByName(StructTypeVector &types) {
-	std::sort(types.begin(), types.end(), ByNameComp());
+	std::stable_sort(types.begin(), types.end(), ByNameComp());
 }
 
 /**
-* @brief Checks whether the given structure has satisfied all the given
-*        dependencies.
+* @brief Sorts @c types by using their @a dependencies.
+*
+* The types are sorted topologically (Kahn's algorithm) over their indexes in
+* @a types. Whenever several types have all their dependencies satisfied, the
+* one that appears first in @a types is taken, so the original order is kept
+* as much as possible. Dependencies on types that are not in @a types and
+* self-dependencies are ignored. A dependency loop, which is not valid in C, is
+* broken by taking the first remaining type in @a types.
 */
-bool hasAllDependenciesSatisfied(ShPtr<StructType> st,
-		const StructTypeSet &stDeps,
-		const StructTypeVector &sortedTypes) {
-	for (const auto &stDep : stDeps) {
-		if (!hasItem(sortedTypes, stDep)) {
-			return false;
-		}
+void sortByDependencies(StructTypeVector &types, const Dependencies &dependencies) {
+	using Indexes = std::vector<std::size_t>;
+
+	std::unordered_map<ShPtr<StructType>, std::size_t> typeToIndex;
+	for (std::size_t i = 0, e = types.size(); i < e; ++i) {
+		typeToIndex.emplace(types[i], i);
 	}
-	return true;
-}
 
-/**
-* @brief Returns the next structure to be included into @a sortedTypes based on
-*        @a remainingTypes.
-*/
-ShPtr<StructType> getNextStructToInclude(const Dependencies &dependencies,
-		const StructTypeVector &remainingTypes,
-		const StructTypeVector &sortedTypes) {
-	for (const auto &type: remainingTypes) {
-		const StructTypeSet &stDeps(dependencies.find(type)->second);
-		if (hasAllDependenciesSatisfied(type, stDeps, sortedTypes)) {
-			return type;
+	std::vector<Indexes> dependents(types.size());
+	Indexes depsCount(types.size(), 0);
+	for (std::size_t i = 0, e = types.size(); i < e; ++i) {
+		for (const auto &dep : dependencies.find(types[i])->second) {
+			auto it = typeToIndex.find(dep);
+			if (it != typeToIndex.end() && it->second != i) {
+				dependents[it->second].push_back(i);
+				++depsCount[i];
+			}
 		}
 	}
 
-	FAIL("There is no next structure to be included"
-		" (perhaps a circular dependency?).");
-	return ShPtr<StructType>();
-}
-
-/**
-* @brief Removes @a st from @a types.
-*/
-void removeFromVector(ShPtr<StructType> st, StructTypeVector &types) {
-	types.erase(std::remove(types.begin(), types.end(), st), types.end());
-}
+	// The smallest index has the highest priority.
+	std::priority_queue<std::size_t, Indexes, std::greater<std::size_t>> ready;
+	for (std::size_t i = 0, e = types.size(); i < e; ++i) {
+		if (depsCount[i] == 0) {
+			ready.push(i);
+		}
+	}
 
-/**
-* @brief Sorts @c types by using their @a dependencies.
-*/
-void sortByDependencies(StructTypeVector &types, const Dependencies &dependencies) {
-	StructTypeVector remainingTypes(types);
 	StructTypeVector sortedTypes;
+	sortedTypes.reserve(types.size());
+	std::vector<bool> included(types.size(), false);
+	std::size_t firstRemaining = 0;
+	while (sortedTypes.size() < types.size()) {
+		std::size_t i;
+		if (!ready.empty()) {
+			i = ready.top();
+			ready.pop();
+		} else {
+			// A dependency loop; break it.
+			while (included[firstRemaining]) {
+				++firstRemaining;
+			}
+			i = firstRemaining;
+		}
 
-	while (!remainingTypes.empty()) {
-		ShPtr<StructType> st(getNextStructToInclude(dependencies,
-			remainingTypes, sortedTypes));
-		sortedTypes.push_back(st);
-		removeFromVector(st, remainingTypes);
+		included[i] = true;
+		sortedTypes.push_back(types[i]);
+		for (auto dependent : dependents[i]) {
+			if (--depsCount[dependent] == 0 && !included[dependent]) {
+				ready.push(dependent);
+			}
+		}
 	}
 
-	types = sortedTypes;
+	types = std::move(sortedTypes);
 }
 
 } // anonymous namespace
@@ -161,9 +170,8 @@ void sortByDependencies(StructTypeVector &types, const Dependencies &dependencie
 * Before the structures are compared based on dependencies, they are sorted by
 * their names. This results into a more deterministic output.
 *
-* @par Preconditions
-*  - the structures can be sorted, i.e. there are no dependency loops that
-*    would prevent the structures from being sorted (standard C behavior)
+* The sorting runs in <tt>O(n log n + d)</tt> time, where @c n is the number of
+* structures and @c d is the number of their dependencies.
 */
 StructTypeVector StructTypesSorter::sort(const StructTypeSet &types) {
 	StructTypeVector typesVector(toVector(types));
@@ -78,9 +78,6 @@
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/llvmir2hll/support/smart_ptr.h"
 #include "retdec/llvmir2hll/support/visitors/ordered_all_visitor.h"
-#include "retdec/utils/container.h"
-
-using retdec::utils::hasItem;
 
 namespace retdec {
 namespace llvmir2hll {
@@ -570,10 +567,10 @@ void OrderedAllVisitor::visit(ShPtr<UnknownType> type) {
 */
 void OrderedAllVisitor::visitStmt(ShPtr<Statement> stmt, bool visitSuccessors,
 		bool visitNestedStmts) {
-	if (stmt && !hasItem(accessedStmts, stmt)) {
+	// A single insertion both checks and marks the statement as accessed.
+	if (stmt && accessedStmts.insert(stmt).second) {
 		this->visitSuccessors = visitSuccessors;
 		this->visitNestedStmts = visitNestedStmts;
-		accessedStmts.insert(stmt);
 		stmt->accept(this);
 	}
 }
@@ -598,11 +595,7 @@ void OrderedAllVisitor::restart(bool visitSuccessors, bool visitNestedStmts) {
 * @return @c true if @a type has already been accessed, @c false otherwise.
 */
 bool OrderedAllVisitor::makeAccessedAndCheckIfAccessed(ShPtr<Type> type) {
-	if (hasItem(accessedTypes, type)) {
-		return true;
-	}
-	accessedTypes.insert(type);
-	return false;
+	return !accessedTypes.insert(type).second;
 }
 
 } // namespace llvmir2hll
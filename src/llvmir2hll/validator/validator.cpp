@@ -10,6 +10,9 @@
 #include "retdec/llvmir2hll/ir/variable.h"
 #include "retdec/llvmir2hll/support/debug.h"
 #include "retdec/llvmir2hll/validator/validator.h"
+#include "retdec/utils/container.h"
+
+using retdec::utils::hasItem;
 
 namespace retdec {
 namespace llvmir2hll {
@@ -17,7 +20,8 @@ namespace llvmir2hll {
 /**
 * @brief Constructs a new validator.
 */
-Validator::Validator(): module(), func(), moduleIsCorrect(true) {}
+Validator::Validator(): module(), func(), moduleIsCorrect(true),
+	funcsToValidate(), restrictedToFuncs(false) {}
 
 /**
 * @brief Validates the given module.
@@ -47,6 +51,17 @@ bool Validator::validate(ShPtr<Module> module, bool printMessageOnError) {
 	return moduleIsCorrect;
 }
 
+/**
+* @brief Restricts the validation of functions to @a funcs.
+*
+* traverseAllFunctions() then skips functions that are not in @a funcs. Global
+* variables are still validated.
+*/
+void Validator::restrictToFuncs(const FuncSet &funcs) {
+	funcsToValidate = funcs;
+	restrictedToFuncs = true;
+}
+
 /**
 * @brief Traverses all global variables in the current module and calls @c
 *        accept() on every one of them.
@@ -63,11 +78,16 @@ void Validator::traverseAllGlobalVariables() {
 *        every one of them.
 *
 * Furthermore, before traversing a function, it sets the data member @c func to
-* the traversed function.
+* the traversed function. If the validation has been restricted by
+* restrictToFuncs(), only the given functions are traversed.
 */
 void Validator::traverseAllFunctions() {
 	for (auto i = module->func_definition_begin(),
 			e = module->func_definition_end(); i != e; ++i) {
+		if (restrictedToFuncs && !hasItem(funcsToValidate, *i)) {
+			continue;
+		}
+
 		func = *i;
 		func->accept(this);
 	}
@@ -24,12 +24,10 @@
 #include "retdec/llvmir2hll/var_renamer/var_renamer_factory.h"
 #include "retdec/llvmir2hll/var_renamer/var_renamers/readable_var_renamer.h"
 #include "retdec/utils/array.h"
-#include "retdec/utils/container.h"
 #include "retdec/utils/conversion.h"
 
 using namespace std::string_literals;
 
-using retdec::utils::addToSet;
 using retdec::utils::arraySize;
 
 namespace retdec {
@@ -182,7 +180,8 @@ void ReadableVarRenamer::renameInductionVars(ShPtr<Function> func) {
 	// We have to insert the names of induction variables to the set of
 	// assigned names of local variables in the current function to prevent
 	// name clashes.
-	addToSet(indVarsNamesInCurrFunc, localVarsNames[func]);
+	localVarsNames[func].insert(indVarsNamesInCurrFunc.begin(),
+		indVarsNamesInCurrFunc.end());
 	renamingInductionVars = false;
 }
 
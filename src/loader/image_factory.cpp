@@ -64,14 +64,46 @@ std::unique_ptr<Image> createImageImpl(const std::shared_ptr<retdec::fileformat:
  *
  * @param filePath Path to input file.
  * @param isRaw Is the input a raw binary file format?
+ * @param loadFlags Flags selecting the parts of the file format to load.
  *
  * @return Pointer to instance of Image class or @c nullptr if any error
  */
-std::unique_ptr<Image> createImage(const std::string& filePath, bool isRaw)
+std::unique_ptr<Image> createImage(
+		const std::string& filePath,
+		bool isRaw,
+		retdec::fileformat::LoadFlags loadFlags)
 {
 	std::unique_ptr<retdec::fileformat::FileFormat> fileFormat = retdec::fileformat::createFileFormat(
 			filePath,
-			isRaw);
+			isRaw,
+			loadFlags);
+	std::shared_ptr<retdec::fileformat::FileFormat> fileFormatShared(std::move(fileFormat)); // Obtain ownership.
+	return createImageImpl(fileFormatShared);
+}
+
+/**
+ * Create instance of Image class from the content of a file held in memory.
+ * If the input cannot be loaded, function will return @c nullptr.
+ * Loaded image becomes owner of the created @c FileFormat.
+ *
+ * @param data Content of the input file.
+ * @param size Size of @p data.
+ * @param isRaw Is the input a raw binary file format?
+ * @param loadFlags Flags selecting the parts of the file format to load.
+ *
+ * @return Pointer to instance of Image class or @c nullptr if any error
+ */
+std::unique_ptr<Image> createImage(
+		const std::uint8_t* data,
+		std::size_t size,
+		bool isRaw,
+		retdec::fileformat::LoadFlags loadFlags)
+{
+	std::unique_ptr<retdec::fileformat::FileFormat> fileFormat = retdec::fileformat::createFileFormat(
+			data,
+			size,
+			isRaw,
+			loadFlags);
 	std::shared_ptr<retdec::fileformat::FileFormat> fileFormatShared(std::move(fileFormat)); // Obtain ownership.
 	return createImageImpl(fileFormatShared);
 }
@@ -79,7 +79,7 @@ bool CoffImage::load()
 		nextFreeAddress = address + section->getLoadedSize();
 	}
 
-	applyRelocations();
+	addRelocations();
 	setBaseAddress(0);
 
 	return true;
@@ -98,7 +98,11 @@ Segment* CoffImage::addSegment(const retdec::fileformat::Section* section, std::
 	return insertSegment(std::make_unique<Segment>(section, address, memSize, std::move(dataSource)));
 }
 
-void CoffImage::applyRelocations()
+/**
+ * Adds relocations to the image. They are applied lazily, when the data they
+ * patch are accessed.
+ */
+void CoffImage::addRelocations()
 {
 	for (const auto* relTable : getFileFormat()->getRelocationTables())
 	{
@@ -117,7 +121,7 @@ void CoffImage::applyRelocations()
 			if (!sym->getAddress(symbolAddress))
 				continue;
 
-			resolveRelocation(rel, *sym);
+			addRelocation(rel, *sym, 4);
 		}
 	}
 }
@@ -275,8 +275,8 @@ bool ElfImage::loadRelocatableFile()
 
 	createExternSegment();
 
-	// Apply relocations
-	applyRelocations();
+	// Relocations are applied lazily, when the data they patch are accessed
+	addRelocations();
 
 	return true;
 }
@@ -562,10 +562,22 @@ void ElfImage::fixBssSegments()
 			bssSegment->resize(nextSegment->getAddress() - bssSegment->getAddress());
 		}
 	}
+
+	invalidateSegmentIndex();
 }
 
-void ElfImage::applyRelocations()
+/**
+ * Adds relocations to the image. They are applied lazily, when the data they
+ * patch are accessed, except for architectures which pair their relocations
+ * (MIPS and PowerPC HI16/LO16). Those are applied right away, in the order of
+ * the relocation table.
+ */
+void ElfImage::addRelocations()
 {
+	auto arch = getFileFormat()->getTargetArchitecture();
+	bool isPaired = arch == retdec::fileformat::Architecture::MIPS
+			|| arch == retdec::fileformat::Architecture::POWERPC;
+
 	for (auto& relTable : getFileFormat()->getRelocationTables())
 	{
 		if (relTable->getLinkToSymbolTable() >= getFileFormat()->getNumberOfSymbolTables())
@@ -590,7 +602,10 @@ void ElfImage::applyRelocations()
 			// if (sym->getType() == retdec::fileformat::Symbol::Type::EXTERN)
 			// 	continue;
 
-			resolveRelocation(rel, *sym);
+			if (isPaired)
+				resolveRelocation(rel, *sym);
+			else
+				addRelocation(rel, *sym, 4);
 		}
 	}
 }
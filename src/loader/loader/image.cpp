@@ -4,6 +4,7 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <climits>
 #include <cstring>
 
@@ -18,6 +19,7 @@ namespace retdec {
 namespace loader {
 
 Image::Image(const std::shared_ptr<retdec::fileformat::FileFormat>& fileFormat) : _fileFormat(fileFormat), _segments(),
+	_relocations([this](const auto& rel, const auto& sym) { resolveRelocation(rel, sym); }),
 	_baseAddress(0), _namelessSegNameGen("seg", '0', 4), _statusMessage()
 {
 }
@@ -336,6 +338,14 @@ bool Image::getXByte(std::uint64_t address, std::uint64_t x, std::uint64_t& res,
 		return false;
 	}
 
+	// Read directly from the segment data when possible. Only reads that
+	// touch a part of the segment without data need a zero-filled copy.
+	auto dataRef = seg->getBytesRef(address - seg->getAddress(), x);
+	if (x && dataRef.size() == x)
+	{
+		return createValueFromBytes(dataRef.data(), dataRef.size(), res, e);
+	}
+
 	std::vector<std::uint8_t> data;
 	if (!seg->getBytes(data, address - seg->getAddress(), x) || data.size() != x)
 	{
@@ -371,6 +381,22 @@ bool Image::getXBytes(std::uint64_t address, std::uint64_t x, std::vector<std::u
 	return true;
 }
 
+/**
+ * Get @a x bytes long view of the image content at specified address, without copying
+ *
+ * @param address Address to get the view from
+ * @param x       Number of bytes for get
+ *
+ * @return View of exactly @a x bytes, or an empty view if there is no segment on
+ *    @a address or the range crosses the segment end or a part of the segment
+ *    without data. Use getXBytes() to read such ranges.
+ */
+llvm::ArrayRef<std::uint8_t> Image::getXBytesRef(std::uint64_t address, std::uint64_t x) const
+{
+	const auto *seg = getSegmentFromAddress(address);
+	return seg ? seg->getBytesRef(address - seg->getAddress(), x) : llvm::ArrayRef<std::uint8_t>();
+}
+
 bool Image::setXByte(std::uint64_t address, std::uint64_t x, std::uint64_t val, retdec::utils::Endianness e/* = retdec::utils::Endianness::UNKNOWN*/)
 {
 	const auto *seg = getSegmentFromAddress(address);
@@ -435,14 +461,61 @@ const retdec::fileformat::LoaderErrorInfo & Image::getLoaderErrorInfo() const
 	return getFileFormat()->getLoaderErrorInfo();
 }
 
+/**
+ * Applies all relocations at once. Relocations are otherwise applied lazily,
+ * when the bytes they patch are accessed for the first time. Applying them
+ * eagerly is needed before the image data are read from several threads or
+ * directly through the file format.
+ */
+void Image::resolveRelocations()
+{
+	_relocations.resolveAll();
+}
+
+/**
+ * Returns whether there are relocations which were not applied yet.
+ *
+ * @return True if there are pending relocations, otherwise false.
+ */
+bool Image::hasPendingRelocations() const
+{
+	return _relocations.hasPending();
+}
+
+/**
+ * Adds a relocation which is applied by resolveRelocation() when any of the
+ * bytes it patches is accessed.
+ *
+ * @param rel Relocation.
+ * @param sym Symbol the relocation refers to.
+ * @param size Number of bytes patched by the relocation, starting at its address.
+ */
+void Image::addRelocation(const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol& sym, std::uint64_t size)
+{
+	_relocations.add(rel, sym, size);
+}
+
+/**
+ * Applies a single relocation to the image data. Images which support
+ * relocations override this method.
+ *
+ * @param rel Relocation.
+ * @param sym Symbol the relocation refers to.
+ */
+void Image::resolveRelocation(const retdec::fileformat::Relocation& /*rel*/, const retdec::fileformat::Symbol& /*sym*/)
+{
+}
+
 Segment* Image::insertSegment(std::unique_ptr<Segment> segment)
 {
 	_segments.push_back(std::move(segment));
+	invalidateSegmentIndex();
 
 	// We have used move constructor, segment is no longer valid pointer
 	// Now give segment name
 	Segment* retSegment = _segments.back().get();
 	nameSegment(retSegment);
+	retSegment->setRelocationIndex(&_relocations);
 	return retSegment;
 }
 
@@ -453,6 +526,7 @@ void Image::removeSegment(Segment* segment)
 		if (itr->get() == segment)
 		{
 			_segments.erase(itr);
+			invalidateSegmentIndex();
 			return;
 		}
 	}
@@ -472,6 +546,17 @@ void Image::sortSegments()
 			{
 				return seg1->getAddress() < seg2->getAddress();
 			});
+	invalidateSegmentIndex();
+}
+
+/**
+ * Marks the address index of segments as outdated. It is rebuilt on the next
+ * lookup by address. Must be called whenever address range of any segment
+ * changes.
+ */
+void Image::invalidateSegmentIndex()
+{
+	_segmentIndexValid = false;
 }
 
 const Segment* Image::_getSegment(std::size_t index) const
@@ -506,13 +591,52 @@ const Segment* Image::_getSegmentWithIndex(std::size_t index) const
 
 const Segment* Image::_getSegmentFromAddress(std::uint64_t address) const
 {
-	for (const auto& segment : getSegments())
+	if (!_segmentIndexValid)
+		_buildSegmentIndex();
+
+	// Segments may overlap, so all the segments starting at or before the
+	// address that may still reach it are checked. The one inserted first wins.
+	auto itr = std::upper_bound(_segmentIndex.begin(), _segmentIndex.end(), address,
+			[](std::uint64_t addr, const SegmentIndexEntry& entry)
+			{
+				return addr < entry.address;
+			});
+
+	const Segment* result = nullptr;
+	std::size_t resultPosition = 0;
+	while (itr != _segmentIndex.begin())
 	{
-		if (segment->containsAddress(address))
-			return segment.get();
+		--itr;
+		if (itr->maxEnd <= address)
+			break;
+
+		const auto* segment = _segments[itr->position].get();
+		if (segment->containsAddress(address) && (!result || itr->position < resultPosition))
+		{
+			result = segment;
+			resultPosition = itr->position;
+		}
 	}
 
-	return nullptr;
+	return result;
+}
+
+void Image::_buildSegmentIndex() const
+{
+	_segmentIndex.clear();
+	_segmentIndex.reserve(_segments.size());
+	for (std::size_t i = 0; i < _segments.size(); ++i)
+		_segmentIndex.push_back({_segments[i]->getAddress(), _segments[i]->getEndAddress(), i});
+
+	std::sort(_segmentIndex.begin(), _segmentIndex.end(), [](const SegmentIndexEntry& e1, const SegmentIndexEntry& e2)
+			{
+				return e1.address < e2.address;
+			});
+
+	for (std::size_t i = 1; i < _segmentIndex.size(); ++i)
+		_segmentIndex[i].maxEnd = std::max(_segmentIndex[i].maxEnd, _segmentIndex[i - 1].maxEnd);
+
+	_segmentIndexValid = true;
 }
 
 } // namespace loader
@@ -61,8 +61,8 @@ bool PeImage::load()
 	// If no sections found, map the whole file into one big segment.
 	if (sections.empty())
 	{
-		std::vector<std::uint8_t> bytes;
-		if (!readFile(peFormat->getPathToFile(), bytes))
+		std::vector<std::uint8_t> bytes = peFormat->getBytes();
+		if (bytes.empty())
 			return false;
 
 		if (addSingleSegment(imageBase, bytes) == nullptr)
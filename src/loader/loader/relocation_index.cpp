@@ -0,0 +1,168 @@
+/**
+ * @file src/loader/loader/relocation_index.cpp
+ * @brief Definition of index of lazily applied relocations.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "retdec/loader/loader/relocation_index.h"
+
+namespace retdec {
+namespace loader {
+
+/**
+ * Constructor.
+ *
+ * @param resolver Function applying a relocation to the image data.
+ */
+RelocationIndex::RelocationIndex(Resolver resolver) : _resolver(std::move(resolver))
+{
+}
+
+/**
+ * Adds a relocation to be applied when any of the bytes it patches is accessed.
+ * Both @a rel and @a sym must outlive the index.
+ *
+ * @param rel Relocation.
+ * @param sym Symbol the relocation refers to.
+ * @param size Number of bytes patched by the relocation, starting at its address.
+ */
+void RelocationIndex::add(const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol& sym, std::uint64_t size)
+{
+	std::uint64_t start = rel.getAddress();
+	std::uint64_t end = start + size < start ? std::numeric_limits<std::uint64_t>::max() : start + size;
+	_entries.push_back({start, end, _entries.size(), &rel, &sym});
+	_indexValid = false;
+	++_pending;
+}
+
+/**
+ * Applies all pending relocations which patch any byte in the given range.
+ *
+ * @param address Start address of the range.
+ * @param size Size of the range.
+ */
+void RelocationIndex::resolve(std::uint64_t address, std::uint64_t size)
+{
+	// Relocations read and write the image data through the same methods as
+	// everyone else, they must not trigger resolution recursively.
+	if (_pending == 0 || _resolving || size == 0)
+		return;
+
+	buildIndex();
+
+	std::uint64_t start = address;
+	std::uint64_t end = address + size < address ? std::numeric_limits<std::uint64_t>::max() : address + size;
+
+	// Relocations overlapping the range may patch bytes outside of it, which
+	// may be patched also by other relocations. Extend the range until it
+	// covers all of them, so they are applied in their original order.
+	std::vector<Entry*> toApply;
+	bool extended = true;
+	while (extended)
+	{
+		toApply.clear();
+		std::uint64_t newStart = start;
+		std::uint64_t newEnd = end;
+
+		auto hi = std::lower_bound(_entries.begin(), _entries.end(), end,
+				[](const Entry& e, std::uint64_t addr) { return e.start < addr; });
+		for (auto i = static_cast<std::size_t>(hi - _entries.begin()); i > 0 && _maxEnds[i - 1] > start; --i)
+		{
+			auto& entry = _entries[i - 1];
+			if (entry.rel && entry.end > start)
+			{
+				toApply.push_back(&entry);
+				newStart = std::min(newStart, entry.start);
+				newEnd = std::max(newEnd, entry.end);
+			}
+		}
+
+		extended = newStart != start || newEnd != end;
+		start = newStart;
+		end = newEnd;
+	}
+
+	apply(toApply);
+}
+
+/**
+ * Applies all pending relocations.
+ */
+void RelocationIndex::resolveAll()
+{
+	if (_pending == 0 || _resolving)
+		return;
+
+	std::vector<Entry*> toApply;
+	toApply.reserve(_pending);
+	for (auto& entry : _entries)
+	{
+		if (entry.rel)
+			toApply.push_back(&entry);
+	}
+
+	apply(toApply);
+}
+
+/**
+ * Returns whether there are any relocations which were not applied yet.
+ *
+ * @return True if there are pending relocations, otherwise false.
+ */
+bool RelocationIndex::hasPending() const
+{
+	return _pending != 0;
+}
+
+/**
+ * Returns the number of relocations which were not applied yet.
+ *
+ * @return Number of pending relocations.
+ */
+std::size_t RelocationIndex::getNumberOfPending() const
+{
+	return _pending;
+}
+
+void RelocationIndex::buildIndex()
+{
+	if (_indexValid)
+		return;
+
+	std::sort(_entries.begin(), _entries.end(),
+			[](const Entry& a, const Entry& b) {
+				return a.start < b.start || (a.start == b.start && a.order < b.order);
+			});
+
+	_maxEnds.resize(_entries.size());
+	std::uint64_t maxEnd = 0;
+	for (std::size_t i = 0; i < _entries.size(); ++i)
+	{
+		maxEnd = std::max(maxEnd, _entries[i].end);
+		_maxEnds[i] = maxEnd;
+	}
+
+	_indexValid = true;
+}
+
+void RelocationIndex::apply(std::vector<Entry*>& entries)
+{
+	std::sort(entries.begin(), entries.end(),
+			[](const Entry* a, const Entry* b) { return a->order < b->order; });
+
+	_resolving = true;
+	for (auto* entry : entries)
+	{
+		const auto* rel = entry->rel;
+		entry->rel = nullptr;
+		--_pending;
+		_resolver(*rel, *entry->sym);
+	}
+	_resolving = false;
+}
+
+} // namespace loader
+} // namespace retdec
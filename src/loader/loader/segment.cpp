@@ -19,7 +19,8 @@ Segment::Segment(const retdec::fileformat::SecSeg* secSeg, std::uint64_t address
 }
 
 Segment::Segment(const Segment& segment) : _secSeg(segment._secSeg), _address(segment._address), _size(segment._size),
-	_dataSource(segment._dataSource ? std::make_unique<SegmentDataSource>(*segment._dataSource.get()) : nullptr), _name(segment._name)
+	_dataSource(segment._dataSource ? std::make_unique<SegmentDataSource>(*segment._dataSource.get()) : nullptr), _name(segment._name),
+	_relocations(segment._relocations)
 {
 }
 
@@ -122,6 +123,7 @@ const retdec::common::RangeContainer<std::uint64_t>& Segment::getNonDecodableAdd
  */
 std::pair<const std::uint8_t*, std::uint64_t> Segment::getRawData() const
 {
+	resolveRelocations(0, getPhysicalSize());
 	return _dataSource ? std::make_pair(_dataSource->getData(), getPhysicalSize()) : std::make_pair(nullptr, 0) ;
 }
 
@@ -196,7 +198,10 @@ bool Segment::getBytes(std::vector<unsigned char>& result, std::uint64_t address
 	result.clear();
 
 	if (_dataSource)
+	{
+		resolveRelocations(addressOffset, size);
 		_dataSource->loadData(addressOffset, size, result);
+	}
 
 	// Data source may contain less data than we are representing with this segment
 	//   so we just fill the rest with zeroes.
@@ -207,6 +212,26 @@ bool Segment::getBytes(std::vector<unsigned char>& result, std::uint64_t address
 	return true;
 }
 
+/**
+ * Get content of segment as a view of its data, without copying.
+ *
+ * @param addressOffset First byte of the segment to be read (0 means first byte of segment).
+ * @param size Number of bytes for read.
+ *
+ * @return View of exactly @a size bytes. If the range crosses the end of the
+ *    segment or a part of it that is not backed by data (e.g. uninitialized
+ *    data that getBytes() fills with zeroes), an empty view is returned.
+ */
+llvm::ArrayRef<std::uint8_t> Segment::getBytesRef(std::uint64_t addressOffset, std::uint64_t size) const
+{
+	if (!_dataSource || addressOffset >= getSize() || size > getSize() - addressOffset)
+		return {};
+
+	resolveRelocations(addressOffset, size);
+	auto dataRef = _dataSource->getDataRef(addressOffset, size);
+	return dataRef.size() == size ? dataRef : llvm::ArrayRef<std::uint8_t>();
+}
+
 /**
  * Get content of segment as bits in string representation.
  *
@@ -245,7 +270,11 @@ bool Segment::setBytes(const std::vector<unsigned char>& value, std::uint64_t ad
 
 	std::size_t size = addressOffset + value.size() > getSize() ? getSize() - addressOffset : value.size();
 	if (_dataSource != nullptr)
+	{
+		// Pending relocations must not be applied over the new data later.
+		resolveRelocations(addressOffset, size);
 		_dataSource->saveData(addressOffset, size, value);
+	}
 
 	return true;
 }
@@ -310,5 +339,23 @@ void Segment::addNonDecodableRange(retdec::common::Range<std::uint64_t> range)
 	_nonDecodableRanges.insert(std::move(range));
 }
 
+/**
+ * Sets the relocations which are applied to the segment data when they are
+ * accessed for the first time. Relocations are indexed by addresses, so they
+ * may be shared by all segments of an image.
+ *
+ * @param relocations Relocations or @c nullptr if there are none.
+ */
+void Segment::setRelocationIndex(RelocationIndex* relocations)
+{
+	_relocations = relocations;
+}
+
+void Segment::resolveRelocations(std::uint64_t addressOffset, std::uint64_t size) const
+{
+	if (_relocations)
+		_relocations->resolve(getAddress() + addressOffset, size);
+}
+
 } // namespace loader
 } // namespace retdec
@@ -67,6 +67,21 @@ bool SegmentDataSource::shrink(std::uint64_t newOffset, std::uint64_t newSize)
 	return true;
 }
 
+/**
+ * Returns a view of at most @a loadSize bytes of the data starting at @a loadOffset.
+ *
+ * The view points directly into the data, so no copy is made. It is shorter than
+ * @a loadSize if the data end sooner and empty if @a loadOffset is out of the data.
+ */
+llvm::ArrayRef<std::uint8_t> SegmentDataSource::getDataRef(std::uint64_t loadOffset, std::uint64_t loadSize) const
+{
+	if (!isDataSet() || loadOffset >= getDataSize())
+		return {};
+
+	loadSize = loadOffset + loadSize >= getDataSize() ? getDataSize() - loadOffset : loadSize;
+	return llvm::ArrayRef<std::uint8_t>(getData() + loadOffset, loadSize);
+}
+
 bool SegmentDataSource::loadData(std::uint64_t loadOffset, std::uint64_t loadSize, std::vector<std::uint8_t>& data) const
 {
 	data.clear();
@@ -77,8 +92,8 @@ bool SegmentDataSource::loadData(std::uint64_t loadOffset, std::uint64_t loadSiz
 	if (loadOffset >= getDataSize())
 		return false;
 
-	loadSize = loadOffset + loadSize >= getDataSize() ? getDataSize() - loadOffset : loadSize;
-	std::copy(_data.data() + loadOffset, _data.data() + loadOffset + loadSize, std::back_inserter(data));
+	auto dataRef = getDataRef(loadOffset, loadSize);
+	data.assign(dataRef.begin(), dataRef.end());
 	return true;
 }
 
@@ -176,6 +176,79 @@ bool BreakMachOUniversal::getByArchFamily(
 	return false;
 }
 
+/**
+ * Get Mach-O Universal object iterator by architecture family name
+ * @param familyName family name
+ * @param res reference for storing result
+ * @return @c true if object of @p familyName was found, @c false otherwise
+ */
+bool BreakMachOUniversal::getByFamilyName(
+		const std::string &familyName,
+		llvm::object::MachOUniversalBinary::object_iterator &res)
+{
+	if(familyName == "x86")
+	{
+		return getByArchFamily(CPU_TYPE_X86, res);
+	}
+	else if(familyName == "arm" || familyName == "thumb")
+	{
+		// Same family
+		return getByArchFamily(CPU_TYPE_ARM, res);
+	}
+	else if(familyName == "powerpc")
+	{
+		return getByArchFamily(CPU_TYPE_POWERPC, res);
+	}
+	else if(familyName == "x86-64")
+	{
+		return getByArchFamily(CPU_TYPE_X86_64, res);
+	}
+	else if(familyName == "arm64")
+	{
+		return getByArchFamily(CPU_TYPE_ARM64, res);
+	}
+	else if(familyName == "powerpc64")
+	{
+		return getByArchFamily(CPU_TYPE_POWERPC64, res);
+	}
+	else if(familyName == "sparc")
+	{
+		return getByArchFamily(CPU_TYPE_SPARC, res);
+	}
+	else if(familyName == "mc98000")
+	{
+		return getByArchFamily(CPU_TYPE_MC98000, res);
+	}
+
+	return false;
+}
+
+/**
+ * Get Mach-O Universal object iterator with best architecture for
+ * decompilation
+ * @param res reference for storing result
+ * @return @c true if some object was found, @c false otherwise
+ */
+bool BreakMachOUniversal::getBest(
+		llvm::object::MachOUniversalBinary::object_iterator &res)
+{
+	if(!file->getNumberOfObjects())
+	{
+		return false;
+	}
+
+	if(getByArchFamily(CPU_TYPE_X86, res)
+			|| getByArchFamily(CPU_TYPE_ARM, res)
+			|| getByArchFamily(CPU_TYPE_POWERPC, res))
+	{
+		return true;
+	}
+
+	// If none of above, just pick first.
+	res = file->begin_objects();
+	return true;
+}
+
 /**
  * Extract object by iterator
  * @param it object iterator
@@ -468,15 +541,7 @@ bool BreakMachOUniversal::extractBestArchive(
 	}
 
 	auto obj = file->begin_objects();
-	if(getByArchFamily(CPU_TYPE_X86, obj)
-			|| getByArchFamily(CPU_TYPE_ARM, obj)
-			|| getByArchFamily(CPU_TYPE_POWERPC, obj))
-	{
-		return extract(obj, outPath);
-	}
-
-	// If none of above, just pick first.
-	return extract(obj, outPath);
+	return getBest(obj) && extract(obj, outPath);
 }
 
 /**
@@ -522,91 +587,132 @@ bool BreakMachOUniversal::extractArchiveForFamily(
 	}
 
 	auto obj = file->begin_objects();
-	if(familyName == "x86")
-	{
-		if(getByArchFamily(CPU_TYPE_X86, obj))
-		{
-			return extract(obj, outPath);
-		}
-	}
-	else if(familyName == "arm" || familyName == "thumb")
-	{
-		// Same family
-		if(getByArchFamily(CPU_TYPE_ARM, obj))
-		{
-			return extract(obj, outPath);
-		}
-	}
-	else if(familyName == "powerpc")
+	return getByFamilyName(familyName, obj) && extract(obj, outPath);
+}
+
+/**
+ * Extract archive by architecture
+ * @param machoArchName Mach-O specific architecture string
+ * @param outPath path to output file
+ * @return @c true if extraction was successful, @c false otherwise
+ */
+bool BreakMachOUniversal::extractArchiveForArchitecture(
+		const std::string &machoArchName,
+		const std::string &outPath)
+{
+	if(!file)
 	{
-		if(getByArchFamily(CPU_TYPE_POWERPC, obj))
-		{
-			return extract(obj, outPath);
-		}
+		return false;
 	}
-	else if(familyName == "x86-64")
+
+	for(auto i = file->begin_objects(), e = file->end_objects(); i != e; ++i)
 	{
-		if(getByArchFamily(CPU_TYPE_X86_64, obj))
+		if(machoArchName == getArchName(i))
 		{
-			return extract(obj, outPath);
+			return extract(i, outPath);
 		}
 	}
-	else if(familyName == "arm64")
+
+	return false;
+}
+
+/**
+ * Get position of archive with best architecture for decompilation
+ * @param offset offset of archive in the input file
+ * @param size size of archive
+ * @return @c true if archive was found, @c false otherwise
+ *
+ * Archive can be accessed in place at @p offset from getFileBufferStart().
+ */
+bool BreakMachOUniversal::getBestArchiveRange(
+		std::uint64_t &offset,
+		std::uint64_t &size)
+{
+	if(!file)
 	{
-		if(getByArchFamily(CPU_TYPE_ARM64, obj))
-		{
-			return extract(obj, outPath);
-		}
+		return false;
 	}
-	else if(familyName == "powerpc64")
+
+	auto obj = file->begin_objects();
+	if(!getBest(obj))
 	{
-		if(getByArchFamily(CPU_TYPE_POWERPC64, obj))
-		{
-			return extract(obj, outPath);
-		}
+		return false;
 	}
-	else if(familyName == "sparc")
+
+	offset = obj->getOffset();
+	size = obj->getSize();
+	return true;
+}
+
+/**
+ * Get position of archive by architecture family
+ * @param familyName family name
+ * @param offset offset of archive in the input file
+ * @param size size of archive
+ * @return @c true if archive was found, @c false otherwise
+ *
+ * Archive can be accessed in place at @p offset from getFileBufferStart().
+ */
+bool BreakMachOUniversal::getArchiveRangeForFamily(
+		const std::string &familyName,
+		std::uint64_t &offset,
+		std::uint64_t &size)
+{
+	if(!file)
 	{
-		if(getByArchFamily(CPU_TYPE_SPARC, obj))
-		{
-			return extract(obj, outPath);
-		}
+		return false;
 	}
-	else if(familyName == "mc98000")
+
+	auto obj = file->begin_objects();
+	if(!getByFamilyName(familyName, obj))
 	{
-		if(getByArchFamily(CPU_TYPE_MC98000, obj))
-		{
-			return extract(obj, outPath);
-		}
+		return false;
 	}
 
-	return false;
+	offset = obj->getOffset();
+	size = obj->getSize();
+	return true;
 }
 
 /**
- * Extract archive by architecture
- * @param machoArchName Mach-O specific architecture string
- * @param outPath path to output file
- * @return @c true if extraction was successful, @c false otherwise
+ * Get position and architecture name of archive with index
+ * @param index index of archive
+ * @param archName architecture name of archive (e.g. x86_64)
+ * @param offset offset of archive in the input file
+ * @param size size of archive
+ * @return @c true if archive was found, @c false otherwise
+ *
+ * Archive can be accessed in place at @p offset from getFileBufferStart().
  */
-bool BreakMachOUniversal::extractArchiveForArchitecture(
-		const std::string &machoArchName,
-		const std::string &outPath)
+bool BreakMachOUniversal::getArchiveRangeWithIndex(
+		unsigned index,
+		std::string &archName,
+		std::uint64_t &offset,
+		std::uint64_t &size)
 {
-	if(!file)
+	if(!file || index >= file->getNumberOfObjects())
 	{
 		return false;
 	}
 
-	for(auto i = file->begin_objects(), e = file->end_objects(); i != e; ++i)
+	auto obj = file->begin_objects();
+	for(unsigned i = 0; i < index; ++i)
 	{
-		if(machoArchName == getArchName(i))
-		{
-			return extract(i, outPath);
-		}
+		++obj;
 	}
 
-	return false;
+	archName = getArchName(obj);
+	offset = obj->getOffset();
+	size = obj->getSize();
+	return true;
+}
+
+/**
+ * Get number of archives in the universal binary
+ */
+unsigned BreakMachOUniversal::getNumberOfArchives()
+{
+	return file ? file->getNumberOfObjects() : 0;
 }
 
 } // namespace macho_extractor
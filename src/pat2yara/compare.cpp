@@ -4,6 +4,8 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <unordered_map>
+
 #include "pat2yara/compare.h"
 #include "pat2yara/utils.h"
 #include "yaramod/types/hex_string.h"
@@ -13,6 +15,9 @@ using namespace yaramod;
 
 namespace {
 
+/// Number of leading pattern nibbles used as key when looking for relations.
+const std::size_t PATTERN_KEY_NIBBLES = 16;
+
 /**
  * Compare references.
  *
@@ -191,6 +196,47 @@ bool sortNamesPredicate(
 	return first < other;
 }
 
+/**
+ * Get key of rule for looking up its possible relations.
+ *
+ * Patterns are compared with wild-cards matching anything and with shorter
+ * pattern matching prefix of the longer one. Related rules therefore have
+ * the same leading nibbles only if there are no wild-cards among them in
+ * either pattern. Rules without such nibbles get no key and may be related
+ * to any other rule. All rules without pattern share the empty key.
+ *
+ * @param rule input rule
+ * @param key will be set to the key of rule
+ *
+ * @return @c true if rule has key, @c false otherwise
+ */
+bool getRelationKey(
+	const Rule* rule,
+	std::string &key)
+{
+	key.clear();
+
+	const auto pattern = getHexPattern(rule, "$1");
+	if (!pattern) {
+		return true;
+	}
+
+	const auto &units = pattern->getUnits();
+	if (units.size() < PATTERN_KEY_NIBBLES) {
+		return false;
+	}
+
+	for (std::size_t i = 0; i < PATTERN_KEY_NIBBLES; ++i) {
+		if (!units[i]->isNibble()) {
+			return false;
+		}
+		key += static_cast<char>('a'
+			+ std::static_pointer_cast<HexStringNibble>(units[i])->getValue());
+	}
+
+	return true;
+}
+
 } // anonymous namespace
 
 /**
@@ -350,19 +396,52 @@ std::vector<RuleRelations> getRuleRelationsFromRules(
 {
 	std::vector<RuleRelations> results;
 
+	// Indexes of results by keys of their rules. Rules are compared only
+	// with rules with the same key and with rules without key, in the order
+	// in which the results were created.
+	std::unordered_map<std::string, std::vector<std::size_t>> keyed;
+	std::vector<std::size_t> unkeyed;
+
+	const std::vector<std::size_t> noIndexes;
+
+	std::string key;
 	for (const auto &rule : rules) {
 		// Look for related rules.
 		bool foundRelation = false;
-		for (auto &relation : results) {
-			if (relation.add(rule.get())) {
-				// Related rule was found.
-				foundRelation = true;
-				break;
+		bool hasKey = getRelationKey(rule.get(), key);
+		if (hasKey) {
+			auto found = keyed.find(key);
+			const auto &sameKey = found != keyed.end() ? found->second
+				: noIndexes;
+
+			auto sameIt = sameKey.begin();
+			auto unkeyedIt = unkeyed.cbegin();
+			while (!foundRelation
+					&& (sameIt != sameKey.end() || unkeyedIt != unkeyed.cend())) {
+				auto &it = unkeyedIt == unkeyed.cend()
+						|| (sameIt != sameKey.end() && *sameIt < *unkeyedIt)
+					? sameIt : unkeyedIt;
+				foundRelation = results[*it++].add(rule.get());
+			}
+		}
+		else {
+			for (auto &relation : results) {
+				if (relation.add(rule.get())) {
+					// Related rule was found.
+					foundRelation = true;
+					break;
+				}
 			}
 		}
 
 		// Create new entry if no related rule was found.
 		if (!foundRelation) {
+			if (hasKey) {
+				keyed[key].push_back(results.size());
+			}
+			else {
+				unkeyed.push_back(results.size());
+			}
 			results.emplace_back(RuleRelations(rule.get()));
 		}
 	}
@@ -49,6 +49,9 @@ void printUsage(Logger& log)
 	"    Ignore NOPs with OPCODE when computing (pure) size.\n\n"
 	"--delphi\n"
 	"    Set special Delphi processing on.\n"
+	"-j --jobs JOBS\n"
+	"    Number of input files processed in parallel (default: 1).\n"
+	"    Output does not depend on this number.\n"
 	"-h --help\n"
 	"    Show this help.\n"
 	"--version\n"
@@ -144,6 +147,11 @@ int processArguments(std::vector<std::string> &args)
 				return dieWithError("invalid --min-pure argument value");
 			}
 		}
+		else if (args[i] == "--jobs" || args[i] == "-j") {
+			if (!argumentToSize(args, options.jobs, ++i)) {
+				return dieWithError("invalid --jobs argument value");
+			}
+		}
 		else if (args[i] == "--ignore-nops") {
 			options.ignoreNops = true;
 			if (!argumentToSize(args, options.nopOpcode, ++i)) {
@@ -4,11 +4,15 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <iterator>
+
 #include "pat2yara/compare.h"
 #include "pat2yara/logic.h"
 #include "pat2yara/modifications.h"
 #include "pat2yara/processing.h"
 #include "pat2yara/utils.h"
+#include "retdec/utils/parallel.h"
 #include "yaramod/builder/yara_expression_builder.h"
 #include "yaramod/builder/yara_file_builder.h"
 #include "yaramod/builder/yara_rule_builder.h"
@@ -22,20 +26,30 @@ namespace
 // Yara library pattern size limit.
 const std::size_t YARA_PATTERN_LIMIT = 4096;
 
+/**
+ * Rules created from one input file.
+ */
+struct FileRules
+{
+	std::unique_ptr<Rule> architectureRule;      ///< Architecture info rule.
+	std::vector<std::unique_ptr<Rule>> rules;    ///< Filtered rules.
+	std::vector<std::unique_ptr<Rule>> logRules; ///< Thrown away rules.
+};
+
 /**
  * Filter rules from file.
  *
  * @param file input YaraFile
  * @param fIndex input file index
  * @param options filter options
- * @param logBuilder log-file builder
+ * @param logRules container for log-file rules
  * @param rules container for results
  */
 void filterRulesFromFile(
 	const std::unique_ptr<YaraFile> &file,
 	const std::size_t fIndex,
 	const ProcessingOptions &options,
-	YaraFileBuilder &logBuilder,
+	std::vector<std::unique_ptr<Rule>> &logRules,
 	std::vector<std::unique_ptr<Rule>> &rules)
 {
 	for (const auto &rule : file->getRules())
@@ -44,7 +58,7 @@ void filterRulesFromFile(
 		const auto hPattern = getHexPattern(rule.get(), "$1");
 		if (!hPattern) {
 			if (options.logOn) {
-				logBuilder.withRule(createLogRule(rule.get(),
+				logRules.push_back(createLogRule(rule.get(),
 					"missing pattern"));
 			}
 			continue;
@@ -60,7 +74,7 @@ void filterRulesFromFile(
 		if (options.minSize &&
 				getHexStringSize(hPattern) - trailing < options.minSize) {
 			if (options.logOn) {
-				logBuilder.withRule(createLogRule(rule.get(),
+				logRules.push_back(createLogRule(rule.get(),
 					"pattern too small"));
 			}
 			continue;
@@ -73,7 +87,7 @@ void filterRulesFromFile(
 		if (pureSize < 4) {
 			// Rules with almost no invariable bytes.
 			if (options.logOn) {
-				logBuilder.withRule(createLogRule(rule.get(),
+				logRules.push_back(createLogRule(rule.get(),
 					"not enough pure information"));
 			}
 			continue;
@@ -81,7 +95,7 @@ void filterRulesFromFile(
 
 		if (pureSize + relocationInfo < options.minPure + trailing) {
 			if (options.logOn) {
-				logBuilder.withRule(createLogRule(rule.get(),
+				logRules.push_back(createLogRule(rule.get(),
 					"not enough pure information"));
 			}
 			continue;
@@ -90,7 +104,7 @@ void filterRulesFromFile(
 		// Filter out functions with problematic names.
 		if (nameFilter(rule.get())) {
 			if (options.logOn) {
-				logBuilder.withRule(createLogRule(rule.get(),
+				logRules.push_back(createLogRule(rule.get(),
 					"problematic function name"));
 			}
 			continue;
@@ -132,6 +146,10 @@ bool ProcessingOptions::validate(
 		error = "no input file";
 		return false;
 	}
+	if (!jobs) {
+		error = "--jobs value must be greater than zero";
+		return false;
+	}
 	if (minSize > maxSize) {
 		error = "--min-size value is greater than --max-size value";
 		return false;
@@ -147,6 +165,10 @@ bool ProcessingOptions::validate(
 /**
  * Process all input files.
  *
+ * Input files are independent until their rules are compared, so they are
+ * parsed and filtered in parallel. Their rules are then merged in the order
+ * of input files, so output is the same for any number of jobs.
+ *
  * @param fileBuilder output file builder
  * @param logBuilder log-file builder
  * @param options filter options
@@ -156,28 +178,43 @@ void processFiles(
 	YaraFileBuilder &logBuilder,
 	const ProcessingOptions &options)
 {
-	bool firstFile = true;
-	std::vector<std::unique_ptr<Rule>> rules;
-
-	Yaramod ym;
+	std::vector<FileRules> fileRules(options.input.size());
+	retdec::utils::parallelFor(options.input.size(), options.jobs,
+		[&](std::size_t i) {
+			// Parser is expensive to create, every thread has its own.
+			thread_local Yaramod ym;
 
-	std::size_t counter = 0;
-	for (const auto &file : options.input) {
-		// Parse file.
-		auto yaraFile = ym.parseFile(file);
+			// Parse file. Its rules are copied by filtering, so the parsed
+			// file is not kept.
+			auto yaraFile = ym.parseFile(options.input[i]);
 
-		// Add architecture info rule.
-		if (firstFile) {
 			auto &originalRules = yaraFile->getRules();
 			if (!originalRules.empty()) {
-				fileBuilder.withRule(createArchitectureRule(originalRules[0].get()));
-				firstFile = false;
+				fileRules[i].architectureRule = createArchitectureRule(
+					originalRules[0].get());
 			}
+
+			// Filter out input rules.
+			filterRulesFromFile(yaraFile, i, options, fileRules[i].logRules,
+				fileRules[i].rules);
+		});
+
+	bool firstFile = true;
+	std::vector<std::unique_ptr<Rule>> rules;
+	for (auto &file : fileRules) {
+		// Add architecture info rule.
+		if (firstFile && file.architectureRule) {
+			fileBuilder.withRule(std::move(file.architectureRule));
+			firstFile = false;
 		}
 
-		// Filter out input rules.
-		filterRulesFromFile(yaraFile, counter++, options, logBuilder, rules);
+		for (auto &rule : file.logRules) {
+			logBuilder.withRule(std::move(rule));
+		}
+		std::move(file.rules.begin(), file.rules.end(),
+			std::back_inserter(rules));
 	}
+	fileRules.clear();
 
 	for (const auto &ruleRelations : getRuleRelationsFromRules(rules)) {
 		if (ruleRelations.hasEquals()) {
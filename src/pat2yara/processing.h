@@ -39,6 +39,8 @@ struct ProcessingOptions
 		bool logOn = false;             ///< Log-file on/off.
 		std::vector<std::string> input; ///< Input files.
 
+		std::size_t jobs = 1; ///< Number of files processed in parallel.
+
 		bool validate(std::string &error);
 };
 
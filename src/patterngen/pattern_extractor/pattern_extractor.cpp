@@ -456,7 +456,7 @@ void PatternExtractor::addPattern(
 			inputFile->getWordLength());
 		pattern.setName(name);
 		pattern.setArchitectureName(getArchAsString());
-		pattern.setSourcePath(inputFile->getPathToFile());
+		pattern.setSourcePath(sourcePath);
 		pattern.setRuleName(groupName + "_" + std::to_string(patterns.size()));
 
 		// Add relocations.
@@ -526,9 +526,37 @@ PatternExtractor::PatternExtractor(
 	const std::string &filePath,
 	const std::string &groupName)
 	: inputFile(createFileFormat(filePath, false, loadFlags)),
+	sourcePath(filePath),
 	groupName(groupName)
 {
 	stateValid = processFile();
+
+	// Patterns hold copies of all needed data.
+	inputFile.reset();
+}
+
+/**
+ * Constructor.
+ *
+ * Data are processed in place, so they may be for example a member of an
+ * archive that was not extracted. They are not used after construction.
+ *
+ * @param data content of file to process
+ * @param size size of @p data
+ * @param sourcePath path to file used in rules
+ * @param groupName optional prefix for rule names (default: 'unknown_group')
+ */
+PatternExtractor::PatternExtractor(
+	const std::uint8_t *data,
+	std::size_t size,
+	const std::string &sourcePath,
+	const std::string &groupName)
+	: inputFile(createFileFormat(data, size, false, loadFlags)),
+	sourcePath(sourcePath),
+	groupName(groupName)
+{
+	stateValid = processFile();
+	inputFile.reset();
 }
 
 PatternExtractor::~PatternExtractor() = default;
@@ -4,11 +4,22 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <climits>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 
 #include "retdec/pdbparser/pdb_file.h"
+#include "retdec/utils/os.h"
+
+#ifdef OS_WINDOWS
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -20,7 +31,9 @@ namespace pdbparser {
 // =================================================================
 
 /**
- * Loads PDB file into memory and separates all streams.
+ * Maps PDB file into memory and separates all streams.
+ * Streams are not read yet, pages of the file are loaded by the system when
+ * they are accessed for the first time.
  * Must be called before using of any method.
  * Can be called only once.
  * @param filename Name of PDB file to load.
@@ -31,22 +44,15 @@ PDBFileState PDBFile::load_pdb_file(const char *filename)
 	if (pdb_loaded)
 		return PDB_STATE_ALREADY_LOADED;
 
-	// Load PDB file into memory
+	// Map PDB file into memory
 	pdb_filename = filename;
-	FILE *fp = fopen(filename,"rb");
-	if (fp == nullptr)
+	if (!map_pdb_file(filename))
 	{
 		return PDB_STATE_ERR_FILE_OPEN;
 	}
-	fseek(fp, 0, SEEK_END);  // Determine file size
-	pdb_file_size = ftell(fp);
-	fseek(fp, 0, SEEK_SET);
-	pdb_file_data = new char[pdb_file_size]; // Allocate memory
-	size_t result = fread(pdb_file_data,1,pdb_file_size,fp); // Read the file
-	fclose(fp);
-	if (result != pdb_file_size)
+	if (pdb_file_size < sizeof(PDB_HEADER))
 	{
-		return PDB_STATE_ERR_FILE_OPEN;
+		return PDB_STATE_INVALID_FILE;
 	}
 
 	// Get the version of PDB file and parse it
@@ -66,7 +72,7 @@ PDBFileState PDBFile::load_pdb_file(const char *filename)
 		// Get pointer to PDB info header
 		if (streams.size() > PDB_STREAM_PDB)
 		{
-			pdb_info_v700 = reinterpret_cast<PDBInfo70 *>(streams[PDB_STREAM_PDB].data);
+			pdb_info_v700 = reinterpret_cast<PDBInfo70 *>(get_stream(PDB_STREAM_PDB)->data);
 		}
 		else
 		{
@@ -96,7 +102,7 @@ void PDBFile::initialize(uint64_t image_base)
 	}
 
 	// Initialize types
-	pdb_types = new PDBTypes(&streams[PDB_STREAM_TPI]);
+	pdb_types = new PDBTypes(get_stream(PDB_STREAM_TPI));
 	pdb_types->parse_types();
 
 	// Check if DBI stream is present
@@ -105,8 +111,8 @@ void PDBFile::initialize(uint64_t image_base)
 	if (dbi_present)
 	{
 		// Get DBI stream
-		unsigned int pdb_dbi_size = streams[PDB_STREAM_DBI].size;
-		char * pdb_dbi_data = streams[PDB_STREAM_DBI].data;
+		unsigned int pdb_dbi_size = get_stream(PDB_STREAM_DBI)->size;
+		char * pdb_dbi_data = get_stream(PDB_STREAM_DBI)->data;
 
 		// Get pointer to DBI header
 		dbi_header_v700 = reinterpret_cast<NewDBIHdr *>(pdb_dbi_data);
@@ -129,12 +135,34 @@ void PDBFile::initialize(uint64_t image_base)
 		int pdb_gsi_num = dbi_header_v700->snGSSyms;
 		int pdb_psi_num = dbi_header_v700->snPSSyms;
 		int pdb_sym_num = dbi_header_v700->snSymRecs;
-		pdb_symbols = new PDBSymbols(&streams[pdb_gsi_num],&streams[pdb_psi_num],&streams[pdb_sym_num],modules,sections,pdb_types);
+		pdb_symbols = new PDBSymbols(get_stream(pdb_gsi_num),get_stream(pdb_psi_num),get_stream(pdb_sym_num),modules,sections,pdb_types);
 		pdb_symbols->parse_symbols();
 	}
 	pdb_initialized = true;
 }
 
+/**
+ * Gets stream with the given number.
+ * Non-linear stream is extracted into linear memory when it is requested for
+ * the first time, so streams that are never used are never copied.
+ * Can be called after load_pdb_file() was executed.
+ * @param num Number of stream
+ * @return Stream or nullptr if there is no such stream
+ */
+PDBStream * PDBFile::get_stream(unsigned int num)
+{
+	if (num >= num_streams)
+		return nullptr;
+
+	PDBStream *stream = &streams[num];
+	if (!stream->unused && stream->data == nullptr)
+	{
+		int pages_per_stream = (stream->size + page_size - 1) / page_size;
+		stream->data = extract_stream(stream->pages, pages_per_stream);
+	}
+	return stream;
+}
+
 /**
  * Saves all streams into separate files.
  * File names consist of input PDB file name and extension .xxx as stream number
@@ -154,7 +182,7 @@ bool PDBFile::save_streams_to_files(void)
 		if (fs == nullptr)
 			return false;
 		if (!streams[i].unused)
-			fwrite(streams[i].data,1,streams[i].size,fs);
+			fwrite(get_stream(i)->data,1,streams[i].size,fs);
 		fclose(fs);
 	}
 	return true;
@@ -240,7 +268,7 @@ void PDBFile::dump_FPO(void)
 		return;
 	}
 
-	PDBStream *pdb_fpo_stream = &streams[pdb_fpo_num];
+	PDBStream *pdb_fpo_stream = get_stream(pdb_fpo_num);
 	int fpoSize = pdb_fpo_stream->size;
 	PDB_FPO_DATA *fpo = reinterpret_cast<PDB_FPO_DATA *>(pdb_fpo_stream->data);
 
@@ -282,7 +310,7 @@ void PDBFile::dump_PE_sections(void)
 		return;
 	}
 
-	PDBStream *pdb_sect_stream = &streams[pdb_sec_num];
+	PDBStream *pdb_sect_stream = get_stream(pdb_sec_num);
 	PDB_PVOID pSect = pdb_sect_stream->data;
 	unsigned long sectSize = pdb_sect_stream->size;
 
@@ -305,12 +333,13 @@ void PDBFile::dump_PE_sections(void)
  */
 PDBFile::~PDBFile()
 {
-	if (pdb_file_data)
-		delete [] pdb_file_data;
 	// Delete all non-linear (copied) streams
 	for (unsigned int i = 0; i < num_streams;i++)
 		if (!streams[i].unused && !streams[i].linear)
 			delete [] streams[i].data;
+	if (pdb_root_dir_copied)
+		delete [] reinterpret_cast<char *>(pdb_root_dir);
+	unmap_pdb_file();
 	if (pdb_types)
 		delete pdb_types;
 	if (pdb_symbols)
@@ -353,6 +382,69 @@ char *PDBFile::extract_stream(PDB_DWORD *pages, int num_pages)
 	return stream_data;
 }
 
+/**
+ * Maps PDB file into memory.
+ * Mapping is private, so the file is never changed.
+ * @param filename Name of PDB file
+ * @return Mapping was successful
+ */
+bool PDBFile::map_pdb_file(const char *filename)
+{
+#ifdef OS_WINDOWS
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 || size.QuadPart > UINT_MAX)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr)
+		return false;
+	void *data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if (data == nullptr)
+		return false;
+	pdb_file_size = static_cast<unsigned int>(size.QuadPart);
+#else
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0 || static_cast<uint64_t>(st.st_size) > UINT_MAX)
+	{
+		close(fd);
+		return false;
+	}
+	void *data = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		return false;
+	pdb_file_size = static_cast<unsigned int>(st.st_size);
+#endif
+	pdb_file_data = static_cast<char *>(data);
+	return true;
+}
+
+/**
+ * Unmaps PDB file from memory.
+ */
+void PDBFile::unmap_pdb_file(void)
+{
+	if (pdb_file_data == nullptr)
+		return;
+#ifdef OS_WINDOWS
+	UnmapViewOfFile(pdb_file_data);
+#else
+	munmap(pdb_file_data, pdb_file_size);
+#endif
+	pdb_file_data = nullptr;
+}
+
 /**
  * Separates all streams from PDB file version 2.00.
  * Vector "streams" is filled here.
@@ -386,7 +478,10 @@ PDBFileState PDBFile::load_pdb_v700(void)
 	if (stream_is_linear(root_dir_indexes, pages_per_root))
 		pdb_root_dir = reinterpret_cast<PDB_ROOT *>(pdb_file_data + root_dir_indexes[0] * page_size);
 	else
+	{
 		pdb_root_dir = reinterpret_cast<PDB_ROOT *>(extract_stream(root_dir_indexes, pages_per_root));
+		pdb_root_dir_copied = true;
+	}
 
 	// Get streams
 	num_streams = pdb_root_dir->V700.dNumStreams;
@@ -396,7 +491,7 @@ PDBFileState PDBFile::load_pdb_v700(void)
 	streams.resize(num_streams);
 	int cur_pagedir_index = num_streams + 0;  // Skip dwords with stream sizes
 
-	// Extract each stream
+	// Locate each stream
 	for (unsigned int i = 0; i < num_streams;i++)
 	{
 		streams[i].size = pdb_root_dir->V700.adStreamSizes[i];
@@ -406,22 +501,25 @@ PDBFileState PDBFile::load_pdb_v700(void)
 			streams[i].unused = true;
 			streams[i].linear = false;
 			streams[i].data = nullptr;
+			streams[i].pages = nullptr;
 		}
 		// Stream is not empty
 		else
 		{
 			streams[i].unused = false;
+			streams[i].pages = &pdb_root_dir->V700.adStreamSizes[cur_pagedir_index];
 			int pages_per_stream = (streams[i].size + page_size - 1) / page_size;
 			// Stream is linear in pdb file, we just get a pointer to it
-			if (stream_is_linear(&pdb_root_dir->V700.adStreamSizes[cur_pagedir_index], pages_per_stream))
+			if (stream_is_linear(streams[i].pages, pages_per_stream))
 			{
-				streams[i].data = pdb_file_data + pdb_root_dir->V700.adStreamSizes[cur_pagedir_index] * page_size;
+				streams[i].data = pdb_file_data + streams[i].pages[0] * page_size;
 				streams[i].linear = true;
 			}
-			// Stream is not linear in pdb file, we must copy it to linear memory
+			// Stream is not linear in pdb file, it is copied to linear memory
+			// by get_stream() when it is used
 			else
 			{
-				streams[i].data = extract_stream(&pdb_root_dir->V700.adStreamSizes[cur_pagedir_index], pages_per_stream);
+				streams[i].data = nullptr;
 				streams[i].linear = false;
 			}
 			cur_pagedir_index += pages_per_stream;  // Increase index to next stream
@@ -437,7 +535,7 @@ PDBFileState PDBFile::load_pdb_v700(void)
 void PDBFile::parse_modules(void)
 {
 	// Get DBI stream size and data
-	PDBStream * pdb_dbi_stream = &streams[PDB_STREAM_DBI];
+	PDBStream * pdb_dbi_stream = get_stream(PDB_STREAM_DBI);
 	unsigned int pdb_dbi_size = pdb_dbi_stream->size;
 	char * pdb_dbi_data = pdb_dbi_stream->data;
 
@@ -473,7 +571,7 @@ void PDBFile::parse_modules(void)
 		}
 
 		// Add module into vector
-		PDBStream *s = (entry->sn == 0xffff)?nullptr:&streams[entry->sn]; // Get module stream
+		PDBStream *s = (entry->sn == 0xffff)?nullptr:get_stream(entry->sn); // Get module stream
 		PDBModule new_module =
 		{
 			reinterpret_cast<char *>(entry->rgch),  // name
@@ -497,7 +595,7 @@ void PDBFile::parse_sections(uint64_t image_base)
 		return;
 
 	// Get stream with section info
-	PDBStream * pdb_sect_stream = &streams[pdb_sec_num];
+	PDBStream * pdb_sect_stream = get_stream(pdb_sec_num);
 	unsigned int pdb_sect_size = pdb_sect_stream->size;
 	char * pdb_sect_data = pdb_sect_stream->data;
 
@@ -288,6 +288,21 @@ namespace PeLib
 			return ERROR_OPENING_FILE;
 		}
 
+		int ret = write(static_cast<std::ostream&>(ofFile), uiOffset, uiRva);
+
+		ofFile.close();
+
+		return ret;
+	}
+
+	/**
+	* Writes the current export directory to a stream.
+	* @param ofFile Output stream (e.g. opened file).
+	* @param uiOffset File offset the directory will be written to.
+	* @param uiRva RVA of the directory.
+	**/
+	int ExportDirectory::write(std::ostream& ofFile, unsigned int uiOffset, unsigned int uiRva) const
+	{
 		ofFile.seekp(uiOffset, std::ios::beg);
 
 		std::vector<unsigned char> vBuffer;
@@ -295,8 +310,6 @@ namespace PeLib
 
 		ofFile.write(reinterpret_cast<const char*>(vBuffer.data()), static_cast<unsigned int>(vBuffer.size()));
 
-		ofFile.close();
-
 		return ERROR_NONE;
 	}
 
@@ -222,9 +222,9 @@ std::uint32_t PeLib::ImageLoader::stringLength(
 					std::uint32_t rvaEndPage = (pageIndex + 1) * PELIB_PAGE_SIZE;
 
 					// If zero page, means this is a zeroed page. This is the end of the string.
-					if(page.buffer.empty())
+					if(page.data() == nullptr)
 						break;
-					dataBegin = dataPtr = page.buffer.data() + (rva & (PELIB_PAGE_SIZE - 1));
+					dataBegin = dataPtr = page.data() + (rva & (PELIB_PAGE_SIZE - 1));
 
 					// Perhaps the last page loaded?
 					if(rvaEndPage > rvaEnd)
@@ -412,7 +412,7 @@ std::uint32_t PeLib::ImageLoader::dumpImage(const char * fileName)
 		// Write each page to the file
 		for(auto & page : pages)
 		{
-			dataToWrite = (char *)(page.buffer.size() ? page.buffer.data() : zeroPage);
+			dataToWrite = (char *)(page.data() ? page.data() : zeroPage);
 			fs.write(dataToWrite, PELIB_PAGE_SIZE);
 			bytesWritten += PELIB_PAGE_SIZE;
 		}
@@ -1171,9 +1171,9 @@ void PeLib::ImageLoader::readFromPage(
 	std::size_t bytesInPage)
 {
 	// Is it a page with actual data?
-	if(page.buffer.size())
+	if(page.data() != nullptr)
 	{
-		memcpy(buffer, page.buffer.data() + offsetInPage, bytesInPage);
+		memcpy(buffer, page.data() + offsetInPage, bytesInPage);
 	}
 	else
 	{
@@ -2228,7 +2228,7 @@ int PeLib::ImageLoader::captureImageSections(ByteBuffer & fileData, std::uint32_
 			sizeOfHeaders = AlignToSize(sizeOfHeaders, optionalHeader.SectionAlignment);
 
 		// Capture the file header
-		virtualAddress = captureImageSection(fileData, virtualAddress, sizeOfHeaders, 0, sizeOfHeaders, PELIB_IMAGE_SCN_MEM_READ, true);
+		virtualAddress = captureImageSection(fileData, virtualAddress, sizeOfHeaders, 0, sizeOfHeaders, PELIB_IMAGE_SCN_MEM_READ, loadFlags, true);
 		if(virtualAddress == 0)
 			return ERROR_INVALID_FILE;
 
@@ -2247,7 +2247,8 @@ int PeLib::ImageLoader::captureImageSections(ByteBuffer & fileData, std::uint32_
 												 sectionHeader.VirtualSize,
 												 pointerToRawData,
 												 sectionHeader.SizeOfRawData,
-												 sectionHeader.Characteristics);
+												 sectionHeader.Characteristics,
+												 loadFlags);
 
 				// There must not be a Virtual Address overflow,
 				// nor the end of the section must be beyond the end of the image
@@ -2285,7 +2286,7 @@ int PeLib::ImageLoader::captureImageSections(ByteBuffer & fileData, std::uint32_
 		pages.resize((sizeOfImage + PELIB_PAGE_SIZE - 1) / PELIB_PAGE_SIZE);
 
 		// Capture the file as-is
-		virtualAddress = captureImageSection(fileData, 0, sizeOfImage, 0, sizeOfImage, PELIB_IMAGE_SCN_MEM_WRITE | PELIB_IMAGE_SCN_MEM_READ | PELIB_IMAGE_SCN_MEM_EXECUTE, true);
+		virtualAddress = captureImageSection(fileData, 0, sizeOfImage, 0, sizeOfImage, PELIB_IMAGE_SCN_MEM_WRITE | PELIB_IMAGE_SCN_MEM_READ | PELIB_IMAGE_SCN_MEM_EXECUTE, loadFlags, true);
 		if(virtualAddress == 0)
 			return ERROR_INVALID_FILE;
 	}
@@ -2497,6 +2498,7 @@ std::uint32_t PeLib::ImageLoader::captureImageSection(
 	std::uint32_t pointerToRawData,
 	std::uint32_t sizeOfRawData,
 	std::uint32_t characteristics,
+	std::uint32_t loadFlags,
 	bool isImageHeader)
 {
 	std::uint8_t * fileBegin = fileData.data();
@@ -2576,8 +2578,12 @@ std::uint32_t PeLib::ImageLoader::captureImageSection(
 					if((rawDataPtr + bytesToCopy) > rawDataEnd)
 						bytesToCopy = (rawDataEnd - rawDataPtr);
 
-					// Initialize the page with valid data
-					filePage.setValidPage(rawDataPtr, bytesToCopy);
+					// Initialize the page with valid data. A whole page of file data
+					// is only viewed if allowed, a partial one needs zero-fill.
+					if((loadFlags & IoFlagMapFileData) && bytesToCopy == PELIB_PAGE_SIZE)
+						filePage.setViewPage(rawDataPtr);
+					else
+						filePage.setValidPage(rawDataPtr, bytesToCopy);
 				}
 				else
 				{
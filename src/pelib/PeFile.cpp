@@ -33,9 +33,14 @@ namespace PeLib
 		return m_imageLoader.Load(m_iStream, loadHeadersOnly);
 	}
 
-	int PeFileT::loadPeHeaders(ByteBuffer & fileData, bool loadHeadersOnly)
-	{
-		return m_imageLoader.Load(fileData, loadHeadersOnly);
+	int PeFileT::loadPeHeaders(ByteBuffer & fileData, bool loadHeadersOnly, bool mapFileData)
+	{
+		std::uint32_t loadFlags = 0;
+		if(loadHeadersOnly)
+			loadFlags |= IoFlagHeadersOnly;
+		if(mapFileData)
+			loadFlags |= IoFlagMapFileData;
+		return m_imageLoader.Load(fileData, loadFlags);
 	}
 
 	/// returns PEFILE64 or PEFILE32
@@ -40,6 +40,7 @@ namespace PeLib
 			child = new ResourceLeaf;
 			child->uiElementRva = rhs.child->getElementRva();
 			static_cast<ResourceLeaf*>(child)->m_data = oldnode->m_data;
+			static_cast<ResourceLeaf*>(child)->m_dataLoader = oldnode->m_dataLoader;
 			static_cast<ResourceLeaf*>(child)->entry = oldnode->entry;
 		}
 		else
@@ -67,6 +68,7 @@ namespace PeLib
 				child = new ResourceLeaf;
 				child->uiElementRva = rhs.child->getElementRva();
 				static_cast<ResourceLeaf*>(child)->m_data = oldnode->m_data;
+				static_cast<ResourceLeaf*>(child)->m_dataLoader = oldnode->m_dataLoader;
 				static_cast<ResourceLeaf*>(child)->entry = oldnode->entry;
 			}
 			else
@@ -326,6 +328,7 @@ namespace PeLib
 
 		// Clear the resource data
 		m_data.clear();
+		m_dataLoader = nullptr;
 
 		// No data or invalid leaf
 		if(entry.OffsetToData == 0 && entry.Size == 0)
@@ -339,9 +342,9 @@ namespace PeLib
 		if((uiRsrcRva + entry.OffsetToData) < uiRsrcRva || (uiRsrcRva + entry.OffsetToData + entry.Size) < uiRsrcRva)
 			return ERROR_NONE;
 
-		// Load the resource data
-		m_data.resize(entry.Size);
-		imageLoader.readImage(m_data.data(), entry.OffsetToData, entry.Size);
+		// The resource data are read only when somebody asks for them.
+		// Resource-heavy files would otherwise hold a second copy of all of them.
+		m_dataLoader = &imageLoader;
 
 		// Add the data range to the occupied map
 		if(entry.Size > 0)
@@ -357,6 +360,8 @@ namespace PeLib
 	**/
 	void ResourceLeaf::rebuild(OutputBuffer& obBuffer, unsigned int uiOffset, unsigned int uiRva, const std::string&) const
 	{
+		loadData();
+
 //		Log::debug() << std::hex << pad << "Leaf: " << uiOffset << std::endl;
 
 //		obBuffer << entry.OffsetToData;
@@ -387,6 +392,8 @@ namespace PeLib
 	 */
 	void ResourceLeaf::recalculate(unsigned int& uiCurrentOffset, unsigned int uiNewRva)
 	{
+		// The data must be read before their offset changes
+		loadData();
 		uiCurrentOffset += PELIB_IMAGE_RESOURCE_DATA_ENTRY::size();
 		setOffsetToData(uiCurrentOffset + uiNewRva);
 		uiCurrentOffset += getSize();
@@ -394,6 +401,7 @@ namespace PeLib
 
 	void ResourceLeaf::makeValid()
 	{
+		loadData();
 		entry.Size = static_cast<unsigned int>(m_data.size());
 	}
 
@@ -410,6 +418,7 @@ namespace PeLib
 	**/
 	std::vector<std::uint8_t> ResourceLeaf::getData() const
 	{
+		loadData();
 		return m_data;
 	}
 
@@ -420,6 +429,20 @@ namespace PeLib
 	void ResourceLeaf::setData(const std::vector<std::uint8_t>& vData)
 	{
 		m_data = vData;
+		m_dataLoader = nullptr;
+	}
+
+	/**
+	* Reads the raw data of a resource leaf from the image, unless they were already read or set.
+	**/
+	void ResourceLeaf::loadData() const
+	{
+		if (m_dataLoader == nullptr)
+			return;
+
+		m_data.resize(entry.Size);
+		m_dataLoader->readImage(m_data.data(), entry.OffsetToData, entry.Size);
+		m_dataLoader = nullptr;
 	}
 
 	/**
@@ -465,6 +488,7 @@ namespace PeLib
 	**/
 	void ResourceLeaf::setOffsetToData(std::uint32_t dwValue)
 	{
+		loadData();
 		entry.OffsetToData = dwValue;
 	}
 
@@ -474,6 +498,7 @@ namespace PeLib
 	**/
 	void ResourceLeaf::setSize(std::uint32_t dwValue)
 	{
+		loadData();
 		entry.Size = dwValue;
 	}
 
@@ -1153,6 +1178,21 @@ namespace PeLib
 			return ERROR_OPENING_FILE;
 		}
 
+		int ret = write(static_cast<std::ostream&>(ofFile), uiOffset, uiRva);
+
+		ofFile.close();
+
+		return ret;
+	}
+
+	/**
+	* Writes the current resource directory to a stream.
+	* @param ofFile Output stream (e.g. opened file).
+	* @param uiOffset File offset the directory will be written to.
+	* @param uiRva RVA of the directory.
+	**/
+	int ResourceDirectory::write(std::ostream& ofFile, unsigned int uiOffset, unsigned int uiRva) const
+	{
 		ofFile.seekp(uiOffset, std::ios::beg);
 
 		std::vector<unsigned char> vBuffer;
@@ -1160,8 +1200,6 @@ namespace PeLib
 
 		ofFile.write(reinterpret_cast<const char*>(vBuffer.data()), static_cast<unsigned int>(vBuffer.size()));
 
-		ofFile.close();
-
 		return ERROR_NONE;
 	}
 
@@ -1582,6 +1620,7 @@ namespace PeLib
 		currNode = static_cast<ResourceNode*>(currNode->children[uiResIndex].child);
 		ResourceLeaf* currLeaf = static_cast<ResourceLeaf*>(currNode->children[0].child);
 
+		currLeaf->loadData();
 		data.assign(currLeaf->m_data.begin(), currLeaf->m_data.end());
 	}
 
@@ -1643,7 +1682,7 @@ namespace PeLib
 		ResourceNode* currNode = static_cast<ResourceNode*>(m_rnRoot.children[uiResTypeIndex].child);
 		currNode = static_cast<ResourceNode*>(currNode->children[uiResIndex].child);
 		ResourceLeaf* currLeaf = static_cast<ResourceLeaf*>(currNode->children[0].child);
-		currLeaf->m_data.assign(data.begin(), data.end());
+		currLeaf->setData(data);
 	}
 
 	/**
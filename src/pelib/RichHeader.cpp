@@ -853,14 +853,8 @@ namespace
 	void RichHeader::read(InputBuffer& inputbuffer, std::size_t uiSize, bool ignoreInvalidKey)
 	{
 		init();
-		std::vector<std::uint32_t> rich;
-
-		for (std::size_t i = 0, e = uiSize / sizeof(std::uint32_t); i < e; ++i)
-		{
-			std::uint32_t actInput;
-			inputbuffer >> actInput;
-			rich.push_back(actInput);
-		}
+		std::vector<std::uint32_t> rich(uiSize / sizeof(std::uint32_t));
+		inputbuffer.readArray(rich.data(), rich.size());
 
 		std::uint32_t sign[] = {0x68636952}; // "Rich"
 		auto lastPos = rich.end();
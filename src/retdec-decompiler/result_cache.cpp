@@ -0,0 +1,497 @@
+/**
+ * @file src/retdec-decompiler/result_cache.cpp
+ * @brief On-disk cache of decompilation results.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <functional>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "retdec/fileformat/utils/crypto.h"
+#include "retdec/utils/file_io.h"
+#include "retdec/utils/io/log.h"
+#include "retdec/utils/version.h"
+#include "retdec-decompiler/result_cache.h"
+
+using namespace retdec::utils::io;
+
+namespace retdec {
+namespace decompiler {
+
+namespace {
+
+/// @name Files of the front-end entry.
+/// @{
+const std::string FRONTEND_CONFIG = "config.json";
+const std::string FRONTEND_BITCODE = "module.bc";
+const std::string FRONTEND_LLVMIR = "module.ll";
+const std::string FRONTEND_ASM = "module.dsm";
+/// Extension of the BIR snapshots, which are named by their keys.
+const std::string FRONTEND_BIR_EXTENSION = ".bir";
+/// @}
+
+/// Extension of the state entries, which are named by their keys. They hold
+/// the @c FRONTEND_CONFIG and @c FRONTEND_BITCODE files.
+const std::string STATE_EXTENSION = ".state";
+
+/// @name Files of the result entry.
+/// @{
+const std::string RESULT_OUTPUT = "output";
+const std::string RESULT_CONFIG = "config.json";
+/// @}
+
+std::string getSha256(const std::string& str)
+{
+	return retdec::fileformat::getSha256(
+			reinterpret_cast<const unsigned char*>(str.data()),
+			str.size());
+}
+
+/**
+ * Reset the parameters which do not influence the decompilation results,
+ * e.g. paths to the input and output files.
+ */
+void resetIrrelevantParameters(retdec::config::Parameters& params)
+{
+	params.setInputFile("");
+	params.setOutputFile("");
+	params.setOutputBitcodeFile("");
+	params.setOutputAsmFile("");
+	params.setOutputLlvmirFile("");
+	params.setOutputConfigFile("");
+	params.setOutputUnpackedFile("");
+	params.setLogFile("");
+	params.setErrFile("");
+	params.setProfileOutFile("");
+	params.setInputBirFile("");
+	params.setOutputBirFile("");
+	params.setIsVerboseOutput(false);
+	params.setTimeout(0);
+	params.setDecoderThreads(0);
+	params.setRdaThreads(0);
+	params.setIsTranslationCache(false);
+	params.setIsAsyncIrWriters(false);
+	params.setIsConcurrentInit(false);
+	params.setMaxMemoryLimit(0);
+	params.setIsMaxMemoryLimitHalfRam(false);
+	params.setBackendFuncCacheDirectory("");
+	params.setBackendGraphThreads(0);
+}
+
+/**
+ * Reset the back-end parameters which do not influence the optimized BIR,
+ * i.e. those which influence only its emission.
+ */
+void resetEmissionParameters(retdec::config::Parameters& params)
+{
+	retdec::config::Parameters defaults;
+	params.setOutputFormat(defaults.getOutputFormat());
+	params.setBackendVarRenamer(defaults.getBackendVarRenamer());
+	params.setBackendValidation(defaults.getBackendValidation());
+	params.setBackendValidationSamplePercent(defaults.getBackendValidationSamplePercent());
+	params.setIsBackendEmitCfg(defaults.isBackendEmitCfg());
+	params.setIsBackendEmitCg(defaults.isBackendEmitCg());
+	params.setIsBackendKeepAllBrackets(defaults.isBackendKeepAllBrackets());
+	params.setIsBackendNoTimeVaryingInfo(defaults.isBackendNoTimeVaryingInfo());
+	params.setIsBackendNoVarRenaming(defaults.isBackendNoVarRenaming());
+	params.setIsBackendNoCompoundOperators(defaults.isBackendNoCompoundOperators());
+	params.setIsBackendNoSymbolicNames(defaults.isBackendNoSymbolicNames());
+	params.setIsBackendReleaseLlvmIr(defaults.isBackendReleaseLlvmIr());
+}
+
+/**
+ * Reset the parameters which influence only the back-end.
+ */
+void resetBackendParameters(retdec::config::Parameters& params)
+{
+	resetEmissionParameters(params);
+
+	retdec::config::Parameters defaults;
+	params.setBackendDisabledOpts(defaults.getBackendDisabledOpts());
+	params.setBackendEnabledOpts(defaults.getBackendEnabledOpts());
+	params.setBackendCallInfoObtainer(defaults.getBackendCallInfoObtainer());
+	params.setBackendAliasAnalysis(defaults.getBackendAliasAnalysis());
+	params.setBackendCopyPropStmtLimit(defaults.getBackendCopyPropStmtLimit());
+	params.setBackendFunctionCostLimit(defaults.getBackendFunctionCostLimit());
+	params.setIsBackendNoOpts(defaults.isBackendNoOpts());
+	params.setIsBackendKeepLibraryFuncs(defaults.isBackendKeepLibraryFuncs());
+}
+
+/**
+ * Reset the parts of @a config which are applied to a restored state entry:
+ * the selection, and the names and comments of the functions with start
+ * addresses. Such functions are identified by the addresses instead.
+ */
+void resetStateEdits(retdec::config::Config& config)
+{
+	config.parameters.selectedFunctions.clear();
+	config.parameters.selectedNotFoundFunctions.clear();
+	config.parameters.selectedRanges.clear();
+
+	retdec::common::FunctionContainer functions;
+	for (auto f : config.functions)
+	{
+		if (f.getStart().isDefined())
+		{
+			f.setName(f.getStart().toHexPrefixString());
+			f.setComment("");
+		}
+		functions.insert(f);
+	}
+	config.functions = functions;
+}
+
+std::string computeKey(
+		const std::string& inputIdentity,
+		const retdec::config::Config& config)
+{
+	return getSha256(
+			retdec::utils::version::getVersionStringLong() + "\n"
+			+ inputIdentity + "\n"
+			+ config.generateJsonString());
+}
+
+/**
+ * Copy @a from to @a to, if both are given and @a from exists.
+ */
+void copyIfExists(const fs::path& from, const fs::path& to)
+{
+	if (from.empty() || to.empty() || !fs::exists(from))
+	{
+		return;
+	}
+	fs::copy_file(from, to, fs::copy_options::overwrite_existing);
+}
+
+/**
+ * Returns a unique temporary path next to @a path.
+ */
+fs::path getTemporaryPath(const fs::path& path)
+{
+	std::random_device rd;
+	std::stringstream ss;
+	ss << path.string() << ".tmp-" << std::hex
+			<< std::hash<std::thread::id>()(std::this_thread::get_id())
+			<< "-" << rd();
+	return ss.str();
+}
+
+/**
+ * Atomically move the entry prepared in @a tmp to @a entry.
+ * If another process was faster, its entry is kept.
+ */
+void commitEntry(const fs::path& tmp, const fs::path& entry)
+{
+	std::error_code ec;
+	fs::rename(tmp, entry, ec);
+	if (ec)
+	{
+		fs::remove_all(tmp, ec);
+	}
+}
+
+} // anonymous namespace
+
+/**
+ * @param cacheDir Directory holding the cache. It is created if needed.
+ * @param config Effective configuration of the decompilation. It must be
+ *        given before the decompilation starts, since it is modified by it.
+ * @param inputIdentity Identity of the input, see @c getInputIdentity().
+ */
+ResultCache::ResultCache(
+		const std::string& cacheDir,
+		const retdec::config::Config& config,
+		const std::string& inputIdentity)
+{
+	auto c = config;
+	resetIrrelevantParameters(c.parameters);
+	_resultKey = computeKey(inputIdentity, c);
+
+	resetEmissionParameters(c.parameters);
+	auto birKey = computeKey(inputIdentity, c);
+
+	resetBackendParameters(c.parameters);
+	_frontendKey = computeKey(inputIdentity, c);
+
+	resetStateEdits(c);
+	_stateKey = computeKey(inputIdentity, c);
+
+	_frontendDir = fs::path(cacheDir) / _frontendKey;
+	_resultDir = _frontendDir / _resultKey;
+	_birFile = _frontendDir / (birKey + FRONTEND_BIR_EXTENSION);
+	_stateDir = fs::path(cacheDir) / (_stateKey + STATE_EXTENSION);
+	_storeState = !config.parameters.isSomethingSelected();
+}
+
+/**
+ * Returns identity of the input for the cache keys, i.e. hash of
+ * @a inputFile content combined with program @a options that select what
+ * is decompiled (e.g. archive member). Returns an empty string if the file
+ * cannot be read.
+ */
+std::string ResultCache::getInputIdentity(
+		const std::string& inputFile,
+		const std::string& options)
+{
+	std::vector<std::uint8_t> content;
+	if (!retdec::utils::readFile(inputFile, content))
+	{
+		return std::string();
+	}
+	return retdec::fileformat::getSha256(content.data(), content.size())
+			+ "\n" + options;
+}
+
+/**
+ * If the final result is cached, copy it to the output files in @a params.
+ * @return @c true if the result was restored, @c false otherwise.
+ */
+bool ResultCache::restoreResult(const retdec::config::Parameters& params) const
+{
+	try
+	{
+		if (!fs::exists(_resultDir / RESULT_OUTPUT))
+		{
+			return false;
+		}
+
+		copyIfExists(_resultDir / RESULT_OUTPUT, params.getOutputFile());
+		copyIfExists(_resultDir / RESULT_CONFIG, params.getOutputConfigFile());
+		copyIfExists(_frontendDir / FRONTEND_BITCODE, params.getOutputBitcodeFile());
+		copyIfExists(_frontendDir / FRONTEND_LLVMIR, params.getOutputLlvmirFile());
+		copyIfExists(_frontendDir / FRONTEND_ASM, params.getOutputAsmFile());
+		return true;
+	}
+	catch (const fs::filesystem_error& e)
+	{
+		Log::error() << Log::Warning << "failed to restore result from cache: "
+				<< e.what() << std::endl;
+		return false;
+	}
+}
+
+/**
+ * If the front-end result is cached, replace @a config by the cached one,
+ * keeping its parameters, and copy the front-end outputs to the output files.
+ * The decompilation can then be resumed from @c getFrontendBitcode().
+ * @return @c true if the front-end result was restored, @c false otherwise.
+ */
+bool ResultCache::restoreFrontend(retdec::config::Config& config) const
+{
+	try
+	{
+		if (!fs::exists(_frontendDir / FRONTEND_CONFIG)
+				|| !fs::exists(_frontendDir / FRONTEND_BITCODE))
+		{
+			return false;
+		}
+
+		auto cached = retdec::config::Config::fromFile(
+				(_frontendDir / FRONTEND_CONFIG).string());
+		cached.parameters = config.parameters;
+
+		auto& params = cached.parameters;
+		copyIfExists(_frontendDir / FRONTEND_BITCODE, params.getOutputBitcodeFile());
+		copyIfExists(_frontendDir / FRONTEND_LLVMIR, params.getOutputLlvmirFile());
+		copyIfExists(_frontendDir / FRONTEND_ASM, params.getOutputAsmFile());
+
+		config = std::move(cached);
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		Log::error() << Log::Warning << "failed to restore front-end from cache: "
+				<< e.what() << std::endl;
+		return false;
+	}
+}
+
+std::string ResultCache::getFrontendBitcode() const
+{
+	return (_frontendDir / FRONTEND_BITCODE).string();
+}
+
+/**
+ * If the optimized BIR for the back-end options in @a params is cached, set
+ * it as the input BIR in @a params, so the back-end does not have to convert
+ * and optimize the restored bitcode again. It is meant to be used after
+ * @c restoreFrontend().
+ * @return @c true if the BIR was restored, @c false otherwise.
+ */
+bool ResultCache::restoreBir(retdec::config::Parameters& params) const
+{
+	std::error_code ec;
+	if (!fs::exists(_birFile, ec))
+	{
+		return false;
+	}
+
+	params.setInputBirFile(_birFile.string());
+	return true;
+}
+
+/**
+ * If a state entry matches @a config, replace @a config by the cached one,
+ * keeping its parameters, and apply the edits of @a config to it: functions
+ * which have different names in @a config than in the cached config are
+ * renamed, and their comments are taken over. The decompilation can then be
+ * resumed from @c getStateBitcode(), whose functions have to be renamed
+ * according to @a renames (old name -> new name) first. The selection in the
+ * parameters is applied by the resumed decompilation.
+ * @return @c true if the state was restored, @c false otherwise, e.g. if a
+ *         new name is already used by another function.
+ */
+bool ResultCache::restoreState(
+		retdec::config::Config& config,
+		std::map<std::string, std::string>& renames) const
+{
+	try
+	{
+		if (!fs::exists(_stateDir / FRONTEND_CONFIG)
+				|| !fs::exists(_stateDir / FRONTEND_BITCODE))
+		{
+			return false;
+		}
+
+		auto cached = retdec::config::Config::fromFile(
+				(_stateDir / FRONTEND_CONFIG).string());
+		cached.parameters = config.parameters;
+
+		std::map<std::string, std::string> edits;
+		for (auto& f : config.functions)
+		{
+			if (f.getStart().isUndefined())
+			{
+				continue;
+			}
+			auto* cf = cached.functions.getFunctionByStartAddress(f.getStart());
+			if (cf == nullptr)
+			{
+				continue;
+			}
+
+			auto edited = *cf;
+			edited.setComment(f.getComment());
+			if (cf->getName() != f.getName())
+			{
+				if (cached.functions.hasFunction(f.getName()))
+				{
+					return false;
+				}
+				edits[cf->getName()] = f.getName();
+				edited.setName(f.getName());
+			}
+			cached.functions.erase(*cf);
+			cached.functions.insert(edited);
+		}
+
+		renames = std::move(edits);
+		config = std::move(cached);
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		Log::error() << Log::Warning << "failed to restore state from cache: "
+				<< e.what() << std::endl;
+		return false;
+	}
+}
+
+std::string ResultCache::getStateBitcode() const
+{
+	return (_stateDir / FRONTEND_BITCODE).string();
+}
+
+/**
+ * Store results of a successful decompilation, which were written into the
+ * output files in @a params. Existing entries are kept.
+ */
+void ResultCache::store(const retdec::config::Parameters& params) const
+{
+	try
+	{
+		if (!fs::exists(_frontendDir))
+		{
+			fs::create_directories(_frontendDir.parent_path());
+			auto tmp = getTemporaryPath(_frontendDir);
+			fs::create_directories(tmp);
+			copyIfExists(params.getOutputConfigFile(), tmp / FRONTEND_CONFIG);
+			copyIfExists(params.getOutputBitcodeFile(), tmp / FRONTEND_BITCODE);
+			copyIfExists(params.getOutputLlvmirFile(), tmp / FRONTEND_LLVMIR);
+			copyIfExists(params.getOutputAsmFile(), tmp / FRONTEND_ASM);
+			if (!fs::exists(tmp / FRONTEND_CONFIG)
+					|| !fs::exists(tmp / FRONTEND_BITCODE))
+			{
+				fs::remove_all(tmp);
+				return;
+			}
+			commitEntry(tmp, _frontendDir);
+		}
+
+		if (_storeState && !fs::exists(_stateDir))
+		{
+			auto tmp = getTemporaryPath(_stateDir);
+			fs::create_directories(tmp);
+			copyIfExists(_frontendDir / FRONTEND_CONFIG, tmp / FRONTEND_CONFIG);
+			copyIfExists(_frontendDir / FRONTEND_BITCODE, tmp / FRONTEND_BITCODE);
+			if (fs::exists(tmp / FRONTEND_CONFIG)
+					&& fs::exists(tmp / FRONTEND_BITCODE))
+			{
+				commitEntry(tmp, _stateDir);
+			}
+			else
+			{
+				fs::remove_all(tmp);
+			}
+		}
+
+		if (!fs::exists(_birFile)
+				&& !params.getOutputBirFile().empty()
+				&& fs::exists(params.getOutputBirFile()))
+		{
+			auto tmp = getTemporaryPath(_birFile);
+			fs::copy_file(params.getOutputBirFile(), tmp);
+			commitEntry(tmp, _birFile);
+		}
+
+		if (!fs::exists(_resultDir))
+		{
+			auto tmp = getTemporaryPath(_resultDir);
+			fs::create_directories(tmp);
+			copyIfExists(params.getOutputFile(), tmp / RESULT_OUTPUT);
+			copyIfExists(params.getOutputConfigFile(), tmp / RESULT_CONFIG);
+			if (!fs::exists(tmp / RESULT_OUTPUT))
+			{
+				fs::remove_all(tmp);
+				return;
+			}
+			commitEntry(tmp, _resultDir);
+		}
+	}
+	catch (const fs::filesystem_error& e)
+	{
+		Log::error() << Log::Warning << "failed to store result into cache: "
+				<< e.what() << std::endl;
+	}
+}
+
+const std::string& ResultCache::getFrontendKey() const
+{
+	return _frontendKey;
+}
+
+const std::string& ResultCache::getResultKey() const
+{
+	return _resultKey;
+}
+
+const std::string& ResultCache::getStateKey() const
+{
+	return _stateKey;
+}
+
+} // namespace decompiler
+} // namespace retdec
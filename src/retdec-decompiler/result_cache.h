@@ -0,0 +1,91 @@
+/**
+ * @file src/retdec-decompiler/result_cache.h
+ * @brief On-disk cache of decompilation results.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#ifndef RETDEC_DECOMPILER_RESULT_CACHE_H
+#define RETDEC_DECOMPILER_RESULT_CACHE_H
+
+#include <map>
+#include <string>
+
+#include "retdec/config/config.h"
+#include "retdec/utils/filesystem.h"
+
+namespace retdec {
+namespace decompiler {
+
+/**
+ * @brief Content-addressed cache of decompilation results.
+ *
+ * Results are stored under keys computed from the input file content, the
+ * effective configuration and the RetDec version. Output paths are not
+ * part of the keys. There are two levels of entries:
+ *   - Front-end entry: the output config, the LLVM IR bitcode written at the
+ *     end of the front-end, the LLVM IR and the disassembly. It does not
+ *     depend on the back-end options, so a different output format or
+ *     back-end option can resume the decompilation from the bitcode.
+ *     It also holds BIR snapshots of the optimized back-end IR, one for each
+ *     combination of the back-end options which influence the
+ *     optimizations. Options which influence only the emission of the
+ *     output (e.g. the output format or variable renamer) can resume the
+ *     decompilation from such a snapshot.
+ *   - Result entry: the final output and config. It is a subdirectory of the
+ *     front-end entry.
+ *   - State entry: the output config and the front-end bitcode of a
+ *     decompilation of the whole input. Its key does not contain the
+ *     selected functions and ranges, nor the names and comments of the
+ *     functions given in the input config by their start addresses. A
+ *     re-run which only renames such functions or selects a part of the
+ *     input (the usual edits of an analysis) resumes from it: the renames
+ *     are applied to the restored config and module, and bodies of the
+ *     functions which are not selected are removed. Only the back-end is
+ *     run then.
+ *
+ * Entries are created under temporary names and atomically renamed, so the
+ * cache can be shared by concurrently running decompilations. Cache errors
+ * never break the decompilation, the cache is just not used.
+ */
+class ResultCache
+{
+	public:
+		ResultCache(
+				const std::string& cacheDir,
+				const retdec::config::Config& config,
+				const std::string& inputIdentity);
+
+		bool restoreResult(const retdec::config::Parameters& params) const;
+		bool restoreFrontend(retdec::config::Config& config) const;
+		std::string getFrontendBitcode() const;
+		bool restoreBir(retdec::config::Parameters& params) const;
+		bool restoreState(
+				retdec::config::Config& config,
+				std::map<std::string, std::string>& renames) const;
+		std::string getStateBitcode() const;
+		void store(const retdec::config::Parameters& params) const;
+
+		const std::string& getFrontendKey() const;
+		const std::string& getResultKey() const;
+		const std::string& getStateKey() const;
+
+		static std::string getInputIdentity(
+				const std::string& inputFile,
+				const std::string& options);
+
+	private:
+		fs::path _frontendDir;
+		fs::path _resultDir;
+		fs::path _birFile;
+		fs::path _stateDir;
+		/// Only decompilations of the whole input are stored as states.
+		bool _storeState = false;
+		std::string _frontendKey;
+		std::string _resultKey;
+		std::string _stateKey;
+};
+
+} // namespace decompiler
+} // namespace retdec
+
+#endif
@@ -4,10 +4,30 @@
  * @copyright (c) 2020 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <fstream>
 #include <future>
 #include <chrono>
+#include <iostream>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
 #include <thread>
+#include <vector>
+
+#include "retdec/utils/os.h"
+
+#ifdef OS_POSIX
+	#include <cerrno>
+	#include <csignal>
+	#include <poll.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
 
 #include <llvm/ADT/Triple.h>
 #include <llvm/Analysis/LoopInfo.h>
@@ -35,6 +55,8 @@
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Target/TargetMachine.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
 
 #include "retdec/ar-extractor/archive_wrapper.h"
 #include "retdec/ar-extractor/detection.h"
@@ -43,17 +65,31 @@
 #include "retdec/macho-extractor/break_fat.h"
 #include "retdec/unpackertool/unpackertool.h"
 #include "retdec/utils/binary_path.h"
+#include "retdec/utils/cancellation.h"
+#include "retdec/utils/file_io.h"
 #include "retdec/utils/filesystem.h"
+#include "retdec/utils/instrumentation.h"
 #include "retdec/utils/io/log.h"
 #include "retdec/utils/memory.h"
+#include "retdec/utils/parallel.h"
 #include "retdec/utils/string.h"
+#include "retdec/utils/system.h"
 #include "retdec/utils/version.h"
+#include "retdec-decompiler/result_cache.h"
 
 using namespace retdec::utils::io;
 
 const int EXIT_TIMEOUT = 137;
 const int EXIT_BAD_ALLOC = 135;
 
+/// How long a timed out decompilation is waited for to reach its next
+/// cancellation point, before it is left running.
+const auto CANCELLATION_GRACE_PERIOD = std::chrono::seconds(10);
+
+/// Percentage of the memory limit from which the decompilation degrades (as
+/// if its phases ran out of time) to avoid hitting the limit itself.
+const std::size_t SOFT_MEMORY_LIMIT_PERCENT = 75;
+
 //
 //==============================================================================
 // Program options
@@ -73,16 +109,68 @@ class ProgramOptions
 		std::string arExtractPath;
 		std::string arName;
 		std::optional<uint64_t> arIdx;
+		/// Decompile all the objects from the input archive.
+		bool arAll = false;
+		/// Number of objects decompiled in parallel with @c arAll.
+		unsigned arJobs = 1;
+		/// Object of the input archive decompiled by the archive mode.
+		/// It is viewed in place in the buffer of the archive.
+		const char* arObjectData = nullptr;
+		std::size_t arObjectSize = 0;
+
+		/// Decompile all the slices of the input Mach-O universal binary.
+		bool allSlices = false;
+		/// Slice of the input Mach-O universal binary decompiled by the
+		/// all-slices mode. It is viewed in place in the buffer of the binary.
+		const char* sliceData = nullptr;
+		std::size_t sliceSize = 0;
+		/// Architecture name of @c sliceData.
+		std::string sliceName;
 
 		bool cleanup = false;
 		std::set<std::string> toClean;
 
+		/// Directory of the result cache (no caching if empty).
+		std::string cacheDir;
+
+		/// Directory shared by the steps of a sharded decompilation (no
+		/// sharding if empty).
+		std::string shardDir;
+		/// Run the front-end and split its result into this many shards.
+		unsigned shardCount = 0;
+		/// Run the back-end on this shard.
+		std::optional<unsigned> shardIndex;
+		/// Merge the back-end results of all the shards and emit them.
+		bool shardMerge = false;
+
+		/// Output file of the instrumentation trace (no tracing if empty).
+		std::string traceOutFile;
+
+		/// Job file for the batch mode ("-" for the standard input).
+		std::string batchFile;
+		/// Decompile the batch jobs in this many forked worker processes
+		/// (in this process if zero).
+		unsigned batchWorkers = 0;
+		/// Pin the batch workers to the CPUs of NUMA nodes.
+		bool batchPinWorkers = false;
+		/// Jobs run in this process before the workers are forked, so that
+		/// the workers share the databases they load.
+		std::string batchWarmupFile;
+		/// These options belong to a single job of the batch mode.
+		/// Errors must not terminate the whole process in such a case.
+		bool inBatchJob = false;
+
 	public:
 		ProgramOptions(
 				int argc,
 				char *argv[],
 				retdec::config::Config& c,
 				retdec::config::Parameters& p);
+		ProgramOptions(
+				const std::string& progName,
+				const std::list<std::string>& args,
+				retdec::config::Config& c,
+				retdec::config::Parameters& p);
 
 		void load();
 
@@ -119,6 +207,19 @@ ProgramOptions::ProgramOptions(
 	}
 }
 
+ProgramOptions::ProgramOptions(
+		const std::string& progName,
+		const std::list<std::string>& args,
+		retdec::config::Config& c,
+		retdec::config::Parameters& p)
+		: programName(progName)
+		, config(c)
+		, params(p)
+		, _argv(args)
+{
+
+}
+
 void ProgramOptions::load()
 {
 	for (auto i = _argv.begin(); i != _argv.end();)
@@ -174,6 +275,10 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	}
 	else if (isParam(i, "", "--version"))
 	{
+		if (inBatchJob)
+		{
+			throw std::runtime_error("[--version] not allowed in batch jobs");
+		}
 		Log::info() << retdec::utils::version::getVersionStringLong() << "\n";
 		exit(EXIT_SUCCESS);
 	}
@@ -293,6 +398,18 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 		params.setMaxMemoryLimit(0);
 		params.setIsMaxMemoryLimitHalfRam(false);
 	}
+	else if (isParam(i, "", "--profile-out"))
+	{
+		params.setProfileOutFile(getParamOrDie(i));
+	}
+	else if (isParam(i, "", "--trace-out"))
+	{
+		if (inBatchJob)
+		{
+			throw std::runtime_error("[--trace-out] not allowed in batch jobs");
+		}
+		traceOutFile = getParamOrDie(i);
+	}
 	else if (isParam(i, "-o", "--output"))
 	{
 		std::string out = getParamOrDie(i);
@@ -310,10 +427,26 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 		params.setOutputUnpackedFile(out + "-unpacked");
 		arExtractPath = out + "-extracted";
 	}
+	else if (isParam(i, "", "--compress-dsm"))
+	{
+		params.setIsCompressOutputAsm(true);
+	}
+	else if (isParam(i, "", "--binary-config"))
+	{
+		params.setIsBinaryOutputConfig(true);
+	}
+	else if (isParam(i, "", "--compact-config"))
+	{
+		params.setIsCompactOutputConfig(true);
+	}
 	else if (isParam(i, "-k", "--keep-unreachable-funcs"))
 	{
 		params.setIsKeepAllFunctions(true);
 	}
+	else if (isParam(i, "", "--prune-unreachable-funcs-early"))
+	{
+		params.setIsPruneUnreachableFunctionsEarly(true);
+	}
 	else if (isParam(i, "-p", "--pdb"))
 	{
 		std::string pdb = checkFile(getParamOrDie(i), "[-p|--pdb]");
@@ -355,6 +488,21 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	{
 		params.setIsSelectedDecodeOnly(true);
 	}
+	else if (isParam(i, "", "--select-decode-depth"))
+	{
+		auto d = getParamOrDie(i);
+		try
+		{
+			params.setIsSelectedDecodeOnly(true);
+			params.setSelectedDecodeDepth(std::stoull(d));
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--select-decode-depth] invalid depth value: " + d
+			);
+		}
+	}
 	else if (isParam(i, "", "--raw-section-vma"))
 	{
 		auto val = getParamOrDie(i);
@@ -383,6 +531,51 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	{
 		cleanup = true;
 	}
+	else if (isParam(i, "", "--cache-dir"))
+	{
+		cacheDir = getParamOrDie(i);
+	}
+	else if (isParam(i, "", "--shard-dir"))
+	{
+		shardDir = getParamOrDie(i);
+	}
+	else if (isParam(i, "", "--shards"))
+	{
+		auto n = getParamOrDie(i);
+		try
+		{
+			shardCount = std::stoul(n);
+		}
+		catch (...)
+		{
+			shardCount = 0;
+		}
+		if (shardCount == 0)
+		{
+			throw std::runtime_error(
+				"[--shards] invalid number of shards: " + n
+			);
+		}
+	}
+	else if (isParam(i, "", "--shard-merge"))
+	{
+		shardMerge = true;
+	}
+	// Has to follow the other options starting with "--shard".
+	else if (isParam(i, "", "--shard"))
+	{
+		auto val = getParamOrDie(i);
+		try
+		{
+			shardIndex = std::stoul(val);
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--shard] invalid index: " + val
+			);
+		}
+	}
 	else if (isParam(i, "", "--config"))
 	{
 		getParamOrDie(i);
@@ -392,6 +585,10 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	{
 		params.setIsDetectStaticCode(false);
 	}
+	else if (isParam(i, "", "--skip-static-code-bodies"))
+	{
+		params.setIsSkipStaticCodeBodies(true);
+	}
 	else if (isParam(i, "", "--backend-disabled-opts"))
 	{
 		params.setBackendDisabledOpts(getParamOrDie(i));
@@ -411,6 +608,17 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 		}
 		params.setBackendCallInfoObtainer(n);
 	}
+	else if (isParam(i, "", "--backend-aliases"))
+	{
+		auto n = getParamOrDie(i);
+		if (!(n == "simple" || n == "steensgaard"))
+		{
+			throw std::runtime_error(
+				"[--backend-aliases] unknown name: " + n
+			);
+		}
+		params.setBackendAliasAnalysis(n);
+	}
 	else if (isParam(i, "", "--backend-var-renamer"))
 	{
 		auto s = getParamOrDie(i);
@@ -426,6 +634,82 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 		}
 		params.setBackendVarRenamer(s);
 	}
+	else if (isParam(i, "", "--backend-copy-prop-stmt-limit"))
+	{
+		auto n = getParamOrDie(i);
+		try
+		{
+			params.setBackendCopyPropStmtLimit(std::stoull(n));
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--backend-copy-prop-stmt-limit] invalid number of statements: " + n
+			);
+		}
+	}
+	else if (isParam(i, "", "--backend-function-cost-limit"))
+	{
+		auto n = getParamOrDie(i);
+		try
+		{
+			params.setBackendFunctionCostLimit(std::stoull(n));
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--backend-function-cost-limit] invalid cost: " + n
+			);
+		}
+	}
+	else if (isParam(i, "", "--backend-validation"))
+	{
+		auto l = getParamOrDie(i);
+		if (!(l == "full" || l == "sampled" || l == "off"))
+		{
+			throw std::runtime_error(
+				"[--backend-validation] unknown level: " + l
+			);
+		}
+		params.setBackendValidation(l);
+	}
+	else if (isParam(i, "", "--backend-graph-threads"))
+	{
+		auto n = getParamOrDie(i);
+		try
+		{
+			params.setBackendGraphThreads(std::stoull(n));
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--backend-graph-threads] invalid number of threads: " + n
+			);
+		}
+	}
+	else if (isParam(i, "", "--backend-validation-sample"))
+	{
+		auto n = getParamOrDie(i);
+		try
+		{
+			auto percent = std::stoull(n);
+			if (percent > 100)
+			{
+				throw std::out_of_range(n);
+			}
+			params.setBackendValidationSamplePercent(percent);
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--backend-validation-sample] invalid percentage: " + n
+			);
+		}
+	}
+	else if (isParam(i, "", "--backend-func-cache-dir"))
+	{
+		params.setBackendFuncCacheDirectory(getParamOrDie(i));
+	}
 	else if (isParam(i, "", "--backend-no-opts"))
 	{
 		params.setIsBackendNoOpts(true);
@@ -462,12 +746,16 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	{
 		params.setIsBackendNoSymbolicNames(true);
 	}
+	else if (isParam(i, "", "--backend-release-llvm-ir"))
+	{
+		params.setIsBackendReleaseLlvmIr(true);
+	}
 	else if (isParam(i, "", "--ar-index"))
 	{
-		if (!arName.empty())
+		if (!arName.empty() || arAll)
 		{
 			throw std::runtime_error(
-				"[--ar-index] and [--ar-name] are mutually exclusive, "
+				"[--ar-index], [--ar-name] and [--ar-all] are mutually exclusive, "
 				"use only one"
 			);
 		}
@@ -486,21 +774,68 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 	}
 	else if (isParam(i, "", "--ar-name"))
 	{
-		if (arIdx.has_value())
+		if (arIdx.has_value() || arAll)
 		{
 			throw std::runtime_error(
-				"[--ar-name] and [--ar-index] are mutually exclusive, "
+				"[--ar-index], [--ar-name] and [--ar-all] are mutually exclusive, "
 				"use only one"
 			);
 		}
 
 		arName = getParamOrDie(i);
 	}
+	else if (isParam(i, "", "--ar-all"))
+	{
+		if (inBatchJob)
+		{
+			throw std::runtime_error("[--ar-all] not allowed in batch jobs");
+		}
+		if (arIdx.has_value() || !arName.empty())
+		{
+			throw std::runtime_error(
+				"[--ar-index], [--ar-name] and [--ar-all] are mutually exclusive, "
+				"use only one"
+			);
+		}
+
+		arAll = true;
+	}
+	else if (isParam(i, "", "--all-slices"))
+	{
+		if (inBatchJob)
+		{
+			throw std::runtime_error("[--all-slices] not allowed in batch jobs");
+		}
+
+		allSlices = true;
+	}
+	else if (isParam(i, "", "--ar-jobs"))
+	{
+		auto n = getParamOrDie(i);
+		try
+		{
+			arJobs = std::stoul(n);
+		}
+		catch (...)
+		{
+			arJobs = 0;
+		}
+		if (arJobs == 0)
+		{
+			throw std::runtime_error(
+				"[--ar-jobs] invalid number of jobs: " + n
+			);
+		}
+	}
 	else if (isParam(i, "", "--static-code-sigfile"))
 	{
 		auto file = checkFile(getParamOrDie(i), "[--static-code-sigfile]");
 		params.userStaticSignaturePaths.insert(file);
 	}
+	else if (isParam(i, "", "--static-code-cache-dir"))
+	{
+		params.setStaticCodeCacheDirectory(getParamOrDie(i));
+	}
 	else if (isParam(i, "", "--timeout"))
 	{
 		auto t = getParamOrDie(i);
@@ -515,10 +850,124 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
 			);
 		}
 	}
+	else if (isParam(i, "", "--phase-timeout"))
+	{
+		auto t = getParamOrDie(i);
+		try
+		{
+			params.setPhaseTimeout(std::stoull(t));
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--phase-timeout] invalid timeout value: " + t
+			);
+		}
+	}
+	else if (isParam(i, "", "--decoder-threads"))
+	{
+		auto n = getParamOrDie(i);
+		try
+		{
+			params.setDecoderThreads(std::stoull(n));
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--decoder-threads] invalid number of threads: " + n
+			);
+		}
+	}
+	else if (isParam(i, "", "--rda-threads"))
+	{
+		auto n = getParamOrDie(i);
+		try
+		{
+			params.setRdaThreads(std::stoull(n));
+		}
+		catch (...)
+		{
+			throw std::runtime_error(
+				"[--rda-threads] invalid number of threads: " + n
+			);
+		}
+	}
+	else if (isParam(i, "", "--translation-cache"))
+	{
+		params.setIsTranslationCache(true);
+	}
+	else if (isParam(i, "", "--lazy-flags"))
+	{
+		params.setIsLazyFlags(true);
+	}
+	else if (isParam(i, "", "--async-ir-writers"))
+	{
+		params.setIsAsyncIrWriters(true);
+	}
+	else if (isParam(i, "", "--concurrent-init"))
+	{
+		params.setIsConcurrentInit(true);
+	}
 	else if (isParam(i, "-s", "--silent"))
 	{
 		params.setIsVerboseOutput(false);
 	}
+	else if (isParam(i, "", "--batch"))
+	{
+		if (inBatchJob)
+		{
+			throw std::runtime_error("[--batch] not allowed in batch jobs");
+		}
+		batchFile = getParamOrDie(i);
+		if (batchFile != "-")
+		{
+			batchFile = checkFile(batchFile, "[--batch]");
+		}
+	}
+	else if (isParam(i, "", "--batch-workers"))
+	{
+		if (inBatchJob)
+		{
+			throw std::runtime_error(
+				"[--batch-workers] not allowed in batch jobs"
+			);
+		}
+		auto n = getParamOrDie(i);
+		try
+		{
+			batchWorkers = std::stoul(n);
+		}
+		catch (...)
+		{
+			batchWorkers = 0;
+		}
+		if (batchWorkers == 0)
+		{
+			throw std::runtime_error(
+				"[--batch-workers] invalid number of workers: " + n
+			);
+		}
+	}
+	else if (isParam(i, "", "--batch-pin-workers"))
+	{
+		if (inBatchJob)
+		{
+			throw std::runtime_error(
+				"[--batch-pin-workers] not allowed in batch jobs"
+			);
+		}
+		batchPinWorkers = true;
+	}
+	else if (isParam(i, "", "--batch-warmup"))
+	{
+		if (inBatchJob)
+		{
+			throw std::runtime_error(
+				"[--batch-warmup] not allowed in batch jobs"
+			);
+		}
+		batchWarmupFile = checkFile(getParamOrDie(i), "[--batch-warmup]");
+	}
 	// Input file is the only argument that does not have -x or --xyz
 	// before it. But only one input is expected.
 	else if (params.getInputFile().empty())
@@ -536,20 +985,95 @@ void ProgramOptions::loadOption(std::list<std::string>::iterator& i)
  */
 void ProgramOptions::afterLoad()
 {
-	auto in = params.getInputFile();
-	if (params.getOutputAsmFile().empty())
-		params.setOutputAsmFile(in + ".dsm");
-	if (params.getOutputBitcodeFile().empty())
-		params.setOutputBitcodeFile(in + ".bc");
-	if (params.getOutputLlvmirFile().empty())
-		params.setOutputLlvmirFile(in + ".ll");
-	if (params.getOutputConfigFile().empty())
-		params.setOutputConfigFile(in + ".config.json");
-	if (params.getOutputFile().empty())
+	int shardSteps = (shardCount != 0) + shardIndex.has_value() + shardMerge;
+	if (shardSteps > 1)
 	{
-		if (params.getOutputFormat() == "plain")
-			params.setOutputFile(in + ".c");
-		else
+		throw std::runtime_error(
+			"[--shards], [--shard] and [--shard-merge] are mutually "
+			"exclusive, use only one"
+		);
+	}
+	if (shardDir.empty() != (shardSteps == 0))
+	{
+		throw std::runtime_error(
+			"[--shard-dir] must be used with one of [--shards], [--shard] "
+			"and [--shard-merge]"
+		);
+	}
+	if (!shardDir.empty()
+			&& (!batchFile.empty() || !cacheDir.empty() || arAll || allSlices))
+	{
+		throw std::runtime_error(
+			"[--shard-dir] cannot be used with [--batch], [--cache-dir], "
+			"[--ar-all] or [--all-slices]"
+		);
+	}
+
+	if (batchFile.empty() && (batchWorkers || !batchWarmupFile.empty()))
+	{
+		throw std::runtime_error(
+			"[--batch-workers] and [--batch-warmup] must be used with [--batch]"
+		);
+	}
+	if (batchPinWorkers && !batchWorkers)
+	{
+		throw std::runtime_error(
+			"[--batch-pin-workers] must be used with [--batch-workers]"
+		);
+	}
+	if (batchWorkers && !traceOutFile.empty())
+	{
+		throw std::runtime_error(
+			"[--trace-out] cannot be used with [--batch-workers]"
+		);
+	}
+
+	// Input and outputs are defined by the individual jobs in the batch mode.
+	if (!batchFile.empty())
+	{
+		if (arAll || allSlices)
+		{
+			throw std::runtime_error(
+				"[--batch], [--ar-all] and [--all-slices] are mutually "
+				"exclusive, use only one"
+			);
+		}
+		if (!params.getInputFile().empty())
+		{
+			throw std::runtime_error(
+				"[--batch] INPUT_FILE must be specified in the batch jobs"
+			);
+		}
+		return;
+	}
+
+	if (allSlices && arAll)
+	{
+		throw std::runtime_error(
+			"[--ar-all] and [--all-slices] are mutually exclusive, use only one"
+		);
+	}
+	if (allSlices && config.architecture.isKnown())
+	{
+		throw std::runtime_error(
+			"[--arch] and [--all-slices] are mutually exclusive, use only one"
+		);
+	}
+
+	auto in = params.getInputFile();
+	if (params.getOutputAsmFile().empty())
+		params.setOutputAsmFile(in + ".dsm");
+	if (params.getOutputBitcodeFile().empty())
+		params.setOutputBitcodeFile(in + ".bc");
+	if (params.getOutputLlvmirFile().empty())
+		params.setOutputLlvmirFile(in + ".ll");
+	if (params.getOutputConfigFile().empty())
+		params.setOutputConfigFile(in + ".config.json");
+	if (params.getOutputFile().empty())
+	{
+		if (params.getOutputFormat() == "plain")
+			params.setOutputFile(in + ".c");
+		else
 			params.setOutputFile(in + ".c.json");
 	}
 	if (params.getOutputUnpackedFile().empty())
@@ -612,6 +1136,13 @@ std::string ProgramOptions::checkFile(
 
 void ProgramOptions::printHelpAndDie()
 {
+	if (inBatchJob)
+	{
+		throw std::runtime_error(
+			"invalid batch job arguments, see " + programName + " --help"
+		);
+	}
+
 	Log::info() << programName << R"(:
 Mandatory arguments:
 	INPUT_FILE File to decompile.
@@ -619,16 +1150,37 @@ General arguments:
 	[-o|--output FILE] Output file (default: INPUT_FILE.c if OUTPUT_FORMAT is plain, INPUT_FILE.c.json if OUTPUT_FORMAT is json|json-human).
 	[-s|--silent] Turns off informative output of the decompilation.
 	[-f|--output-format OUTPUT_FORMAT] Output format [plain|json|json-human] (default: plain).
+	[--compress-dsm] Write the disassembly listing (the .dsm file) compressed in gzip format.
+	[--binary-config] Write the output config (the .config.json file) in a compact binary format instead of JSON.
+	[--compact-config] Write the output config (the .config.json file) as JSON without indentation.
 	[-m|--mode MODE] Force the type of decompilation mode [bin|raw] (default: bin).
 	[-p|--pdb FILE] File with PDB debug information.
 	[-k|--keep-unreachable-funcs] Keep functions that are unreachable from the main function.
+	[--prune-unreachable-funcs-early] Remove functions that are unreachable from the main function already before
+	                                  the parameter and return analysis, so that it does not analyse them.
 	[--cleanup] Removes temporary files created during the decompilation.
+	[--cache-dir DIR] Cache of decompilation results. Identical decompilations (input file content, configuration, RetDec version)
+	                  reuse the cached outputs, decompilations differing only in the backend arguments reuse the cached front-end result.
+	                  Decompilations differing only in the selection ([--select-*]) or in the names and comments of the functions
+	                  given in the config by their addresses run only the back-end on the state of a decompilation of the whole input.
+Sharded decompilation arguments:
+	[--shard-dir DIR] Decompile in steps run by separate invocations (e.g. on several machines sharing DIR), which split the
+	                  back-end work by functions. Every step is given the same INPUT_FILE and arguments, and one of:
+	[--shards N] Run the front-end and split its result into N shards of functions in DIR.
+	[--shard K] Run the back-end on the functions of the zero-based shard K and save its result into DIR.
+	            Functions are optimized without the bodies of functions in other shards, so the results may differ
+	            from a decompilation in a single invocation.
+	[--shard-merge] Merge the back-end results of all the shards in DIR and emit the outputs.
 	[--config] Specify JSON decompilation configuration file.
 	[--disable-static-code-detection] Prevents detection of statically linked code.
+	[--skip-static-code-bodies] Only declares the detected statically linked functions (with signatures from the type
+	                            information), their code is not decoded. Functions around the entry point are decoded for main detection.
 Selective decompilation arguments:
 	[--select-ranges RANGES] Specify a comma separated list of ranges to decompile (example: 0x100-0x200,0x300-0x400,0x500-0x600).
 	[--select-functions FUNCS] Specify a comma separated list of functions to decompile (example: fnc1,fnc2,fnc3).
 	[--select-decode-only] Decode only selected parts (functions/ranges). Faster decompilation, but worse results.
+	[--select-decode-depth DEPTH] Like --select-decode-only, but also decode functions called from the selected parts,
+	                              up to DEPTH calls deep. Other functions are left undecoded and treated as stubs.
 Raw or Intel HEX decompilation arguments:
 	[-a|--arch ARCH] Specify target architecture [mips|pic32|arm|thumb|arm64|powerpc|x86|x86-64].
 	                 Required if it cannot be autodetected from the input (e.g. raw mode, Intel HEX).
@@ -638,28 +1190,84 @@ Raw or Intel HEX decompilation arguments:
 	                     Required if it cannot be autodetected from the input (e.g. raw mode).
 	[--raw-section-vma ADDRESS] Virtual address where section created from the raw binary will be placed.
 	[--raw-entry-point ADDRESS] Entry point address used for raw binary (default: architecture dependent).
+Mach-O universal binary decompilation arguments:
+	[--all-slices] Decompile all the architecture slices of the input in parallel in this process. Outputs of the slice
+	               are named as the outputs of the input with ".ARCH" inserted before their suffixes (e.g. prog.x86_64.c),
+	               and "<output without suffix>.index.json" lists all the slices with their exit codes.
 Archive decompilation arguments:
 	[--ar-index INDEX] Pick file from archive for decompilation by its zero-based index.
 	[--ar-name NAME] Pick file from archive for decompilation by its name.
+	[--ar-all] Decompile all the files from archive in this process. Outputs of the file with one-based index N
+	           are named as the outputs of the archive with ".file_N" inserted before their suffixes
+	           (e.g. lib.a.file_1.c), and "<output without suffix>.index.json" lists all the files with their exit codes.
+	[--ar-jobs N] Decompile N files from archive in parallel with --ar-all (default: 1).
 	[--static-code-sigfile FILE] Adds additional signature file for static code detection.
+	[--static-code-cache-dir DIR] Caches compiled static code signatures in DIR and reuses them in later runs.
 Backend arguments:
 	[--backend-disabled-opts LIST] Prevents the optimizations from the given comma-separated list of optimizations to be run.
 	[--backend-enabled-opts LIST] Runs only the optimizations from the given comma-separated list of optimizations.
 	[--backend-call-info-obtainer NAME] Name of the obtainer of information about function calls [optim|pessim] (Default: optim).
+	[--backend-aliases NAME] Name of the used alias analysis [simple|steensgaard] (Default: simple).
 	[--backend-var-renamer STYLE] Used renamer of variables [address|hungarian|readable|simple|unified] (Default: readable).
+	[--backend-copy-prop-stmt-limit N] Optimize functions with more than N statements only by the simple copy propagation (default: 0, i.e. no limit).
+	[--backend-function-cost-limit N] Structure functions whose estimated cost ((instructions + blocks + edges) * (1 + loop depth)) is above N only by gotos and skip the most expensive optimizations on them (default: 0, i.e. no limit).
+	[--backend-validation LEVEL] Validation of the resulting module [full|sampled|off] (Default: full).
+	[--backend-validation-sample PERCENT] Percentage of functions validated by the sampled validation (Default: 10).
+	[--backend-func-cache-dir DIR] Caches optimized functions in DIR and reuses them in later runs, also on other inputs
+	                               (only functions without references to global variables are cached).
 	[--backend-no-opts] Disables backend optimizations.
 	[--backend-emit-cfg] Emits a CFG for each function in the backend IR (in the .dot format).
 	[--backend-emit-cg] Emits a CG for the decompiled module in the backend IR (in the .dot format).
+	[--backend-graph-threads N] Emit CFGs of functions on N threads (default: 0, i.e. on a single thread).
+	                            The results do not depend on N.
 	[--backend-keep-all-brackets] Keeps all brackets in the generated code.
 	[--backend-keep-library-funcs] Keep functions from standard libraries.
 	[--backend-no-time-varying-info] Do not emit time-varying information, like dates.
 	[--backend-no-var-renaming] Disables renaming of variables in the backend.
 	[--backend-no-compound-operators] Do not emit compound operators (like +=) instead of assignments.
 	[--backend-no-symbolic-names] Disables the conversion of constant arguments to their symbolic names.
+	[--backend-release-llvm-ir] Releases the LLVM IR of every function as soon as it is converted in the backend
+	                            (lowers the peak memory usage; no pass may use the LLVM IR after the backend).
 Decompilation process arguments:
-	[--timeout SECONDS]
+	[--timeout SECONDS] Stops the decompilation after the given number of seconds.
+	[--phase-timeout SECONDS] Time budget of a single decompilation phase. Phases that run out of it finish early
+	                          in a cheaper way (e.g. less code is decoded, fewer optimizations are run), which may worsen the results.
 	[--max-memory MAX_MEMORY] Limits the maximal memory used by the given number of bytes.
+	                          Above 75% of the limit, phases finish early as with --phase-timeout, and LLVM IR
+	                          of functions is released once they are converted in the backend.
 	[--no-memory-limit] Disables the default memory limit (half of system RAM).
+	[--decoder-threads N] Disassemble code speculatively on N worker threads during decoding (default: 0, i.e. disabled).
+	                      The results do not depend on N.
+	[--rda-threads N] Compute reaching definitions of functions, and collect data for parameter and return
+	                  analysis, on N threads (default: 0, i.e. on a single thread). The results do not depend on N.
+	[--translation-cache] Memoize translation of repeated x86 and ARM instructions into LLVM IR and replay it.
+	[--lazy-flags] Keep only the x86 flags which may be read before they are overwritten in translated code.
+	[--async-ir-writers] Write the .ll and .bc outputs on background threads while the back-end runs.
+	                     The threads work on a copy of the module, which needs additional memory.
+	[--concurrent-init] Run the independent analyses of the input file (compiler, static code, RTTI and crypto pattern
+	                    detection, type information loading) concurrently before decoding. The results are the same.
+	[--profile-out FILE] Writes wall time, CPU time, memory usage and IR size of every pass into FILE (in the JSON format).
+	[--trace-out FILE] Writes a timeline of phases, passes, back-end optimizations, instrumented scopes and
+	                   counters of the whole process into FILE (in the Chrome trace event format, viewable in
+	                   chrome://tracing or Perfetto). Has no effect in builds without RETDEC_INSTRUMENTATION.
+Batch mode arguments:
+	[--batch FILE] Decompile all the jobs from FILE (or the standard input if FILE is '-') in this process.
+	               Each line holds arguments of one decompilation (INPUT_FILE and any arguments above except --batch, --help and --version).
+	               Other arguments given together with --batch are defaults for all the jobs.
+	               Type databases and initialized passes are shared by all the jobs.
+	               After each job, line "retdec-batch-job: JOB_NUMBER EXIT_CODE" is printed to the standard output.
+	[--batch-workers N] Decompile the jobs in N worker processes forked from this process (POSIX systems only).
+	                    Each worker takes the next job when it finishes its previous one, so the results are
+	                    printed in the order of completion. The memory limit of a job applies to its worker.
+	                    A worker that crashes or does not stop after its timeout is killed and replaced.
+	                    Thread counts of a job (e.g. --decoder-threads) are bounded by the CPUs available to its worker.
+	[--batch-pin-workers] Pin the workers to NUMA nodes in turns (Linux only). A worker runs only on the CPUs
+	                      of its node, so its memory is allocated there, and its jobs do not compete for memory
+	                      bandwidth of the other nodes.
+	[--batch-warmup FILE] Run the jobs from FILE (in the --batch format) before the jobs from --batch.
+	                      With --batch-workers, they run before the workers are forked, which then share
+	                      the databases loaded by them (e.g. types of the used languages).
+	                      After each of them, line "retdec-batch-warmup: JOB_NUMBER EXIT_CODE" is printed.
 LLVM IR debug arguments:
 	[--print-after-all] Dump LLVM IR to stderr after every LLVM pass.
 	[--print-before-all] Dump LLVM IR to stderr before every LLVM pass.
@@ -752,6 +1360,19 @@ void limitMaximalMemoryIfRequested(const retdec::config::Parameters& params)
 	}
 }
 
+/**
+ * Get the soft memory limit of the decompilation: @c SOFT_MEMORY_LIMIT_PERCENT
+ * of the limit set by limitMaximalMemoryIfRequested(), or zero if memory is
+ * not limited.
+ */
+std::size_t getSoftMemoryLimit(const retdec::config::Parameters& params)
+{
+	auto limit = params.isMaxMemoryLimitHalfRam()
+			? retdec::utils::getTotalSystemMemory() / 2
+			: params.getMaxMemoryLimit();
+	return limit / 100 * SOFT_MEMORY_LIMIT_PERCENT;
+}
+
 //
 //==============================================================================
 // Decompilation.
@@ -777,10 +1398,12 @@ void setLogsFrom(const retdec::config::Parameters& params)
 
 	Logger::Ptr outLog = nullptr;
 
+	// Log files are written on a background thread, so that verbose logging
+	// does not slow the decompilation down.
 	outLog.reset(
 		logFile.empty()
 			? new Logger(std::cout, verbose)
-			: new FileLogger(logFile, verbose)
+			: new AsyncLogger(logFile, verbose)
 	);
 
 	Log::set(Log::Type::Info, std::move(outLog));
@@ -790,39 +1413,136 @@ void setLogsFrom(const retdec::config::Parameters& params)
 	}
 }
 
+/**
+ * Decompile the given input data, or the input file if there are no data.
+ */
+int decompileInput(
+		retdec::config::Config& config,
+		ProgramOptions& po,
+		const char* inputData,
+		std::size_t inputSize)
+{
+	// The unpacker works on files only, so an extracted object is written
+	// to disk only if there is something to unpack. Otherwise, it is
+	// decompiled right from the input file buffer.
+	//
+	if (inputData)
+	{
+		auto* data = reinterpret_cast<const std::uint8_t*>(inputData);
+		if (!retdec::unpackertool::isPacked(data, inputSize))
+		{
+			return retdec::decompile(config, data, inputSize);
+		}
+
+		std::vector<std::uint8_t> extracted(data, data + inputSize);
+		if (!retdec::utils::writeFile(po.arExtractPath, extracted))
+		{
+			throw std::runtime_error(
+					"failed to write extracted file: " + po.arExtractPath
+			);
+		}
+		config.parameters.setInputFile(po.arExtractPath);
+		po.toClean.insert(po.arExtractPath);
+	}
+
+	// Unpacking
+	//
+
+	// The unpacked file is handed over to the decompilation in memory.
+	// It is written to disk only if it is not going to be cleaned up anyway.
+	//
+	Log::phase("Unpacking");
+	std::vector<std::uint8_t> unpackedData;
+	auto unpackCode = retdec::unpackertool::unpack(
+			config.parameters.getInputFile(),
+			unpackedData
+	);
+	if (unpackCode == 0) // EXIT_CODE_OK
+	{
+		if (!po.cleanup)
+		{
+			if (!retdec::utils::writeFile(
+					config.parameters.getOutputUnpackedFile(),
+					unpackedData))
+			{
+				Log::error() << "Unable to write unpacked file '"
+						<< config.parameters.getOutputUnpackedFile() << "'."
+						<< std::endl;
+			}
+			config.parameters.setInputFile(
+					config.parameters.getOutputUnpackedFile()
+			);
+		}
+
+		// Decompilation.
+		//
+		return retdec::decompile(config, unpackedData);
+	}
+
+	// Decompilation.
+	//
+	return retdec::decompile(config);
+}
+
 int decompile(retdec::config::Config& config, ProgramOptions& po)
 {
-	setLogsFrom(config.parameters);
+	// Objects of the archive mode are already extracted. Logs are shared by
+	// all of them and set up only once by the archive mode.
+	//
+	if (po.arObjectData)
+	{
+		return decompileInput(config, po, po.arObjectData, po.arObjectSize);
+	}
+
+	// Slices of the all-slices mode are already extracted and share logs
+	// in the same way.
+	//
+	if (!po.sliceData)
+	{
+		setLogsFrom(config.parameters);
+	}
+
+	// Extracted Mach-O slices and archive objects are not written to disk,
+	// they are viewed in place as ranges of the input file buffer.
+	//
+	const char* inputData = po.sliceData;
+	std::size_t inputSize = po.sliceSize;
 
 	// Macho-O extraction.
 	//
-	retdec::macho_extractor::BreakMachOUniversal fat(
-			config.parameters.getInputFile()
-	);
-	if (fat.isValid())
+	std::unique_ptr<retdec::macho_extractor::BreakMachOUniversal> fat;
+	if (!po.sliceData)
+	{
+		fat = std::make_unique<retdec::macho_extractor::BreakMachOUniversal>(
+				config.parameters.getInputFile()
+		);
+	}
+	if (fat && fat->isValid())
 	{
 		Log::phase("Mach-O extraction");
 
-		auto extractedFile = po.arExtractPath + "_m";
+		std::uint64_t offset = 0;
+		std::uint64_t size = 0;
 
 		if (config.architecture.isKnown())
 		{
-			if (!fat.extractArchiveForFamily(
+			if (!fat->getArchiveRangeForFamily(
 					config.architecture.getName(),
-					extractedFile))
+					offset,
+					size))
 			{
 				std::stringstream ss;
 				ss << "Invalid --arch option '"
 						<< config.architecture.getName()
 						<< "'. File contains these architecture families:"
 						<< std::endl;
-				fat.listArchitectures(ss);
+				fat->listArchitectures(ss);
 				throw std::runtime_error(ss.str());
 			}
 		}
 		else
 		{
-			if (!fat.extractBestArchive(extractedFile))
+			if (!fat->getBestArchiveRange(offset, size))
 			{
 				throw std::runtime_error(
 						"Mach-O extraction: extractBestArchive() failed."
@@ -831,24 +1551,29 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 			}
 		}
 
-		config.parameters.setInputFile(extractedFile);
-		po.toClean.insert(extractedFile);
+		inputData = fat->getFileBufferStart() + offset;
+		inputSize = size;
 	}
 
 	// Archive extraction.
 	//
+	bool ok = true;
+	std::string errMsg;
+	auto arw = inputData
+			? std::make_unique<retdec::ar_extractor::ArchiveWrapper>(
+					inputData,
+					inputSize,
+					ok,
+					errMsg)
+			: std::make_unique<retdec::ar_extractor::ArchiveWrapper>(
+					config.parameters.getInputFile(),
+					ok,
+					errMsg);
+
 	if (po.arIdx || !po.arName.empty())
 	{
 		Log::phase("Archive extraction");
 
-		bool ok = true;
-		std::string errMsg;
-		retdec::ar_extractor::ArchiveWrapper arw(
-				config.parameters.getInputFile(),
-				ok,
-				errMsg
-		);
-
 		if (!ok)
 		{
 			throw std::runtime_error(
@@ -856,9 +1581,12 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 			);
 		}
 
+		std::size_t offset = 0;
+		std::size_t size = 0;
+
 		if (po.arIdx)
 		{
-			if (!arw.extractByIndex(po.arIdx.value(), errMsg, po.arExtractPath))
+			if (!arw->getObjectRangeByIndex(po.arIdx.value(), offset, size, errMsg))
 			{
 				throw std::runtime_error(
 						"failed to extract archive: " + errMsg + "\n"
@@ -866,14 +1594,14 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 						+ std::to_string(po.arIdx.value())
 						+ "' was not found in the input archive."
 						  " Valid indexes are 0-"
-						+ std::to_string(arw.getNumberOfObjects()-1)
+						+ std::to_string(arw->getNumberOfObjects()-1)
 						+ ".\n"
 				);
 			}
 		}
 		else if (!po.arName.empty())
 		{
-			if (!arw.extractByName(po.arName, errMsg, po.arExtractPath))
+			if (!arw->getObjectRangeByName(po.arName, offset, size, errMsg))
 			{
 				throw std::runtime_error(
 						"failed to extract archive: " + errMsg + "\n"
@@ -883,25 +1611,18 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 			}
 		}
 
-		config.parameters.setInputFile(po.arExtractPath);
-		po.toClean.insert(po.arExtractPath);
+		inputData = arw->getBufferStart() + offset;
+		inputSize = size;
 	}
 	else
 	{
-		bool ok = true;
-		std::string errMsg;
-		retdec::ar_extractor::ArchiveWrapper arw(
-				config.parameters.getInputFile(),
-				ok,
-				errMsg
-		);
-		if (ok && arw.isThinArchive())
+		if (ok && arw->isThinArchive())
 		{
 			Log::error() << "This file is an archive!" << std::endl;
 			Log::error() << "Error: File is a thin archive and cannot be decompiled." << std::endl;
 			return EXIT_FAILURE;
 		}
-		else if (ok && arw.isEmptyArchive())
+		else if (ok && arw->isEmptyArchive())
 		{
 			Log::error() << "This file is an archive!" << std::endl;
 			Log::error() << "Error: The input archive is empty." << std::endl;
@@ -912,14 +1633,17 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 			Log::error() << "This file is an archive!" << std::endl;
 
 			std::string result;
-			if (arw.getPlainTextList(result, errMsg, false, true))
+			if (arw->getPlainTextList(result, errMsg, false, true))
 			{
 				Log::error() << result << std::endl;
 			}
 			return EXIT_FAILURE;
 		}
 
-		if (!ok && retdec::ar_extractor::isArchive(config.parameters.getInputFile()))
+		bool isArchiveFile = inputData
+				? retdec::ar_extractor::isArchive(inputData, inputSize)
+				: retdec::ar_extractor::isArchive(config.parameters.getInputFile());
+		if (!ok && isArchiveFile)
 		{
 			Log::error() << "This file is an archive!" << std::endl;
 			Log::error() << "Error: The input archive has invalid format." << std::endl;
@@ -927,33 +1651,191 @@ int decompile(retdec::config::Config& config, ProgramOptions& po)
 		}
 	}
 
-	// Unpacking
-	//
+	return decompileInput(config, po, inputData, inputSize);
+}
 
-	Log::phase("Unpacking");
-	std::vector<std::string> unpackArgs;
-	unpackArgs.push_back("whatever_program_name");
-	unpackArgs.push_back(config.parameters.getInputFile());
-	unpackArgs.push_back("--output");
-	unpackArgs.push_back(config.parameters.getOutputUnpackedFile());
-	char* uargv[4] = {
-			unpackArgs[0].data(),
-			unpackArgs[1].data(),
-			unpackArgs[2].data(),
-			unpackArgs[3].data()
+/**
+ * Make the back-end save its optimized BIR next to the output, so it can be
+ * stored into the result cache.
+ */
+void setOutputBirFile(retdec::config::Config& config, ProgramOptions& po)
+{
+	auto out = config.parameters.getOutputFile();
+	if (out.empty())
+	{
+		return;
+	}
+
+	config.parameters.setOutputBirFile(out + ".bir");
+	po.toClean.insert(config.parameters.getOutputBirFile());
+}
+
+/**
+ * Run one step of a sharded decompilation in @c po.shardDir.
+ */
+int decompileSharded(retdec::config::Config& config, ProgramOptions& po)
+{
+	fs::path dir(po.shardDir);
+	auto bitcodeFile = (dir / "module.bc").string();
+	auto configFile = (dir / "config.json").string();
+	auto shardFile = [&dir](std::size_t i, const std::string& suffix)
+	{
+		return (dir / ("shard-" + std::to_string(i) + suffix)).string();
 	};
-	auto unpackCode = retdec::unpackertool::_main(4, uargv);
-	if (unpackCode == 0) // EXIT_CODE_OK
+
+	if (po.shardCount)
+	{
+		// Only the front-end is run here, it ends by writing the bitcode.
+		auto& passes = config.parameters.llvmPasses;
+		auto writer = std::find(passes.rbegin(), passes.rend(), "retdec-write-bc");
+		if (writer == passes.rend())
+		{
+			throw std::runtime_error(
+				"[--shards] cannot split decompilation without pass: "
+				"retdec-write-bc"
+			);
+		}
+		passes.erase(writer.base(), passes.end());
+		passes.push_back("retdec-write-config");
+
+		fs::create_directories(dir);
+		config.parameters.setOutputBitcodeFile(bitcodeFile);
+		config.parameters.setOutputConfigFile(configFile);
+		int ret = decompile(config, po);
+		if (ret != EXIT_SUCCESS)
+		{
+			return ret;
+		}
+
+		std::vector<std::string> shardFiles;
+		for (unsigned i = 0; i < po.shardCount; ++i)
+		{
+			shardFiles.push_back(shardFile(i, ".bc"));
+		}
+		retdec::splitBitcode(bitcodeFile, shardFiles);
+		return EXIT_SUCCESS;
+	}
+
+	try
 	{
-		config.parameters.setInputFile(
-				config.parameters.getOutputUnpackedFile()
+		auto frontend = retdec::config::Config::fromFile(configFile);
+		frontend.parameters = config.parameters;
+		config = std::move(frontend);
+	}
+	catch (const retdec::config::ParseException& e)
+	{
+		throw std::runtime_error(
+			"[--shard-dir] loading of config failed: "
+			+ std::string(e.what())
 		);
-		po.toClean.insert(config.parameters.getOutputUnpackedFile());
 	}
 
-	// Decompilation.
-	//
-	return retdec::decompile(config);
+	if (po.shardIndex)
+	{
+		auto shard = shardFile(po.shardIndex.value(), ".bc");
+		if (!fs::exists(shard))
+		{
+			throw std::runtime_error("[--shard] no such shard: " + shard);
+		}
+		config.parameters.setIsBackendBirOnly(true);
+		config.parameters.setOutputBirFile(
+				shardFile(po.shardIndex.value(), ".bir"));
+		return retdec::decompileBitcode(config, shard);
+	}
+
+	for (std::size_t i = 0; fs::exists(shardFile(i, ".bc")); ++i)
+	{
+		auto bir = shardFile(i, ".bir");
+		if (!fs::exists(bir))
+		{
+			throw std::runtime_error(
+				"[--shard-merge] shard " + std::to_string(i)
+				+ " was not decompiled: " + bir
+			);
+		}
+		config.parameters.inputBirShards.push_back(bir);
+	}
+	if (config.parameters.inputBirShards.empty())
+	{
+		throw std::runtime_error(
+			"[--shard-merge] no shards in: " + po.shardDir
+		);
+	}
+	return retdec::decompileBitcode(config, bitcodeFile);
+}
+
+/**
+ * Decompile with respect to the result cache, if it is enabled.
+ */
+int decompileWithCache(retdec::config::Config& config, ProgramOptions& po)
+{
+	if (!po.shardDir.empty())
+	{
+		return decompileSharded(config, po);
+	}
+	if (po.cacheDir.empty())
+	{
+		return decompile(config, po);
+	}
+
+	std::string options = "mode=" + po.mode
+			+ ";ar-index=" + (po.arIdx ? std::to_string(po.arIdx.value()) : "")
+			+ ";ar-name=" + po.arName
+			+ ";slice=" + po.sliceName;
+	auto identity = retdec::decompiler::ResultCache::getInputIdentity(
+			config.parameters.getInputFile(),
+			options
+	);
+	if (identity.empty())
+	{
+		return decompile(config, po);
+	}
+
+	// The keys are computed right away, the decompilation modifies config.
+	retdec::decompiler::ResultCache cache(po.cacheDir, config, identity);
+
+	if (cache.restoreResult(config.parameters))
+	{
+		if (!po.arObjectData && !po.sliceData)
+		{
+			setLogsFrom(config.parameters);
+		}
+		Log::phase("Result restored from cache: " + cache.getResultKey());
+		return EXIT_SUCCESS;
+	}
+
+	int ret = EXIT_SUCCESS;
+	std::map<std::string, std::string> renames;
+	if (cache.restoreFrontend(config))
+	{
+		if (!cache.restoreBir(config.parameters))
+		{
+			setOutputBirFile(config, po);
+		}
+		ret = retdec::decompileBitcode(config, cache.getFrontendBitcode());
+	}
+	else if (cache.restoreState(config, renames))
+	{
+		// The results are not stored, they are not the same as those of a
+		// decompilation of the selection from scratch. The front-end outputs
+		// (bitcode, LLVM IR, disassembly) are not written.
+		return retdec::decompileBitcode(
+				config,
+				cache.getStateBitcode(),
+				nullptr,
+				renames);
+	}
+	else
+	{
+		setOutputBirFile(config, po);
+		ret = decompile(config, po);
+	}
+
+	if (ret == EXIT_SUCCESS)
+	{
+		cache.store(config.parameters);
+	}
+	return ret;
 }
 
 //
@@ -977,66 +1859,62 @@ void cleanup(ProgramOptions& po)
 
 //
 //==============================================================================
-// Main.
+// Run.
 //==============================================================================
 //
 
-int main(int argc, char **argv)
+/**
+ * Run the decompilation according to @a config and @a po with respect to the
+ * requested timeouts, and handle all the expected errors.
+ *
+ * The decompilation is cancelled when it times out. It stops at its next
+ * cancellation point. If it does not get there in
+ * @c CANCELLATION_GRACE_PERIOD, its thread is left running.
+ *
+ * @param[out] timedOut Set to @c true if the decompilation timed out and its
+ *             thread was left running.
+ * @return Exit code of the decompilation.
+ */
+int runDecompilation(
+		retdec::config::Config& config,
+		ProgramOptions& po,
+		bool& timedOut)
 {
-	// Set LLVM debug.
-	//
-	llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
-	llvm::PrettyStackTraceProgram X(argc, argv);
-	llvm::llvm_shutdown_obj Y; // Call llvm_shutdown() on exit.
-	llvm::EnableDebugBuffering = true;
+	int ret = 0;
+	timedOut = false;
 
-	// Load the default config parameters.
-	//
-	retdec::config::Config config;
-	auto binpath = retdec::utils::getThisBinaryDirectoryPath();
-	fs::path configPath(fs::canonical(binpath).parent_path());
-	configPath.append("share");
-	configPath.append("retdec");
-	configPath.append("decompiler-config.json");
-	if (fs::exists(configPath))
+	// Shared with the decompilation thread, which may outlive this function.
+	auto token = std::make_shared<retdec::utils::CancellationToken>();
+	if (config.parameters.isPhaseTimeout())
 	{
-		config = retdec::config::Config::fromFile(configPath.string());
-		config.parameters.fixRelativePaths(fs::canonical(configPath).parent_path().string());
+		token->setPhaseBudget(
+				std::chrono::seconds(config.parameters.getPhaseTimeout()));
 	}
+	token->setMemoryLimit(getSoftMemoryLimit(config.parameters));
 
-	// Parse program arguments.
-	//
-	ProgramOptions po(argc, argv, config, config.parameters);
 	try
 	{
-		po.load();
-	}
-	catch (const std::runtime_error& e)
-	{
-		Log::error() << Log::Error << e.what() << std::endl;
-		return EXIT_FAILURE;
-	}
-
-	// Limit program memory.
-	//
-	limitMaximalMemoryIfRequested(config.parameters);
-
+		if (config.parameters.isTimeout())
+		{
+			auto timeout = std::chrono::seconds(config.parameters.getTimeout());
+			token->setDeadline(
+					retdec::utils::CancellationToken::Clock::now() + timeout);
 
-	// Decompile.
-	//
-	int ret = 0;
-	try
-	{
-		std::stringstream buffer;
-		if (config.parameters.isTimeout())
-		{
-			std::packaged_task<
-					int(retdec::config::Config&,
-					ProgramOptions&)> task(decompile);
+			std::packaged_task<int()> task([&config, &po, token]()
+			{
+				retdec::utils::CancellationScope scope(*token);
+				return decompileWithCache(config, po);
+			});
 			auto future = task.get_future();
-			std::thread thr(std::move(task), std::ref(config), std::ref(po));
-			auto timeout = std::chrono::seconds(config.parameters.getTimeout());
-			if (future.wait_for(timeout) != std::future_status::timeout)
+			std::thread thr(std::move(task));
+			if (future.wait_for(timeout) == std::future_status::timeout)
+			{
+				token->cancel();
+				Log::error() << "timeout after: " << config.parameters.getTimeout()
+						<< " seconds" << std::endl;
+			}
+			if (future.wait_for(CANCELLATION_GRACE_PERIOD)
+					!= std::future_status::timeout)
 			{
 				thr.join();
 				ret = future.get(); // this will propagate exception
@@ -1044,16 +1922,20 @@ int main(int argc, char **argv)
 			else
 			{
 				thr.detach(); // we leave the thread still running
-				Log::error() << "timeout after: " << config.parameters.getTimeout()
-						<< " seconds" << std::endl;
 				ret = EXIT_TIMEOUT;
+				timedOut = true;
 			}
 		}
 		else
 		{
-			ret = decompile(config, po);
+			retdec::utils::CancellationScope scope(*token);
+			ret = decompileWithCache(config, po);
 		}
 	}
+	catch (const retdec::utils::OperationCancelled&)
+	{
+		ret = EXIT_TIMEOUT;
+	}
 	catch (const std::runtime_error& e)
 	{
 		Log::error() << Log::Error << e.what() << std::endl;
@@ -1065,7 +1947,1064 @@ int main(int argc, char **argv)
 		ret = EXIT_BAD_ALLOC;
 	}
 
-	cleanup(po);
+	return ret;
+}
+
+//
+//==============================================================================
+// Batch mode.
+//==============================================================================
+//
+
+/**
+ * Split a batch job line into arguments.
+ * Arguments are separated by white spaces, double quotes can be used to
+ * specify arguments containing white spaces.
+ */
+std::list<std::string> splitBatchJobLine(const std::string& line)
+{
+	std::list<std::string> ret;
+
+	std::string arg;
+	bool inArg = false;
+	bool inQuotes = false;
+	for (char c : line)
+	{
+		if (c == '"')
+		{
+			inQuotes = !inQuotes;
+			inArg = true;
+		}
+		else if (std::isspace(static_cast<unsigned char>(c)) && !inQuotes)
+		{
+			if (inArg)
+			{
+				ret.push_back(arg);
+				arg.clear();
+				inArg = false;
+			}
+		}
+		else
+		{
+			arg += c;
+			inArg = true;
+		}
+	}
+	if (inArg)
+	{
+		ret.push_back(arg);
+	}
+
+	return ret;
+}
+
+/**
+ * Read the next job from the batch file @a in. Empty lines and lines starting
+ * with '#' are skipped.
+ * @param[out] line Line of the job.
+ * @param[out] args Arguments of the job.
+ * @return @c false if there are no more jobs.
+ */
+bool readBatchJob(
+		std::istream& in,
+		std::string& line,
+		std::list<std::string>& args)
+{
+	while (std::getline(in, line))
+	{
+		args = splitBatchJobLine(line);
+		if (!args.empty() && !retdec::utils::startsWith(args.front(), "#"))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Bound the thread counts of @a params by the number of CPUs this process may
+ * run on. More threads would only compete for the CPUs.
+ */
+void boundThreadsToAvailableCpus(retdec::config::Parameters& params)
+{
+	uint64_t cpus = retdec::utils::getAvailableCpuCount();
+	params.setDecoderThreads(std::min(params.getDecoderThreads(), cpus));
+	params.setRdaThreads(std::min(params.getRdaThreads(), cpus));
+	params.setBackendGraphThreads(
+			std::min(params.getBackendGraphThreads(), cpus));
+}
+
+/**
+ * Decompile one batch job given by its arguments @a args. The job starts from
+ * a copy of @a defaultConfig.
+ * @param inWorker The job runs in a worker process. The memory limit of the
+ *                 job is applied to the process, and the thread counts of the
+ *                 job are bounded by the CPUs available to it.
+ * @param[out] timedOut Set to @c true if the job timed out and its thread was
+ *             left running.
+ * @return Exit code of the job.
+ */
+int runBatchJob(
+		const retdec::config::Config& defaultConfig,
+		ProgramOptions& po,
+		const std::list<std::string>& args,
+		bool inWorker,
+		bool& timedOut)
+{
+	// A timed out decompilation may still use them, so they are not destroyed
+	// in such a case.
+	auto config = std::make_unique<retdec::config::Config>(defaultConfig);
+	auto jpo = std::make_unique<ProgramOptions>(
+			po.programName,
+			args,
+			*config,
+			config->parameters);
+	jpo->inBatchJob = true;
+	jpo->cleanup = po.cleanup;
+	jpo->cacheDir = po.cacheDir;
+
+	int ret = EXIT_SUCCESS;
+	timedOut = false;
+	try
+	{
+		jpo->load();
+		if (inWorker)
+		{
+			limitMaximalMemoryIfRequested(config->parameters);
+			boundThreadsToAvailableCpus(config->parameters);
+		}
+		ret = runDecompilation(*config, *jpo, timedOut);
+	}
+	catch (const std::runtime_error& e)
+	{
+		Log::error() << Log::Error << e.what() << std::endl;
+		ret = EXIT_FAILURE;
+	}
+
+	if (timedOut)
+	{
+		config.release();
+		jpo.release();
+	}
+	else
+	{
+		cleanup(*jpo);
+	}
+	return ret;
+}
+
+/**
+ * Decompile all the jobs from @a in in this process, one after another.
+ * After each job, line "retdec-@a kind: JOB_NUMBER EXIT_CODE" is printed to
+ * the standard output.
+ * @param[out] timedOut Set to @c true if the jobs were stopped by a job which
+ *             timed out and whose thread was left running.
+ */
+int runBatchJobs(
+		const retdec::config::Config& defaultConfig,
+		ProgramOptions& po,
+		std::istream& in,
+		const std::string& kind,
+		bool& timedOut)
+{
+	int ret = EXIT_SUCCESS;
+	std::size_t jobNumber = 0;
+	std::string line;
+	std::list<std::string> args;
+	while (readBatchJob(in, line, args))
+	{
+		++jobNumber;
+		int jobRet = runBatchJob(defaultConfig, po, args, false, timedOut);
+
+		std::cout << "retdec-" << kind << ": " << jobNumber << " " << jobRet
+				<< std::endl;
+
+		if (jobRet != EXIT_SUCCESS)
+		{
+			ret = EXIT_FAILURE;
+		}
+
+		// Timed out decompilation that did not stop in time is still running
+		// and using the process-wide state. No other job can be safely
+		// started.
+		if (timedOut)
+		{
+			Log::error() << Log::Error
+					<< "batch stopped after a timed out job" << std::endl;
+			return EXIT_TIMEOUT;
+		}
+	}
+
+	return ret;
+}
+
+#ifdef OS_POSIX
+
+/**
+ * Worker process of the batch mode and the parent's end of its pipes.
+ */
+struct BatchWorker
+{
+	pid_t pid = -1;
+	/// Parent's end of the pipe of job lines to the worker.
+	int jobFd = -1;
+	/// Parent's end of the pipe of job results from the worker.
+	int resultFd = -1;
+	/// Number of the job the worker decompiles (zero if it is idle).
+	std::size_t jobNumber = 0;
+	/// The worker is killed if its job does not finish until then.
+	std::optional<std::chrono::steady_clock::time_point> deadline;
+};
+
+/**
+ * Read a line (without its '\n') from @a fd.
+ * @return @c false if the end of @a fd was reached before a whole line.
+ */
+bool readLineFrom(int fd, std::string& line)
+{
+	line.clear();
+	char c = 0;
+	while (true)
+	{
+		auto n = read(fd, &c, 1);
+		if (n < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (n <= 0)
+		{
+			return false;
+		}
+		if (c == '\n')
+		{
+			return true;
+		}
+		line += c;
+	}
+}
+
+/**
+ * Write the whole @a data to @a fd.
+ */
+bool writeTo(int fd, const std::string& data)
+{
+	std::size_t written = 0;
+	while (written < data.size())
+	{
+		auto n = write(fd, data.data() + written, data.size() - written);
+		if (n < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (n <= 0)
+		{
+			return false;
+		}
+		written += n;
+	}
+	return true;
+}
+
+/**
+ * Main loop of a worker process: decompile the job lines from @a jobFd and
+ * write "EXIT_CODE RESTART" lines to @a resultFd. The worker exits when there
+ * are no more jobs, or when it should be replaced by a fresh one (RESTART is
+ * 1) because a job left it in a bad state - a thread still running after a
+ * timeout, or memory exhausted.
+ */
+[[noreturn]] void runBatchWorker(
+		const retdec::config::Config& defaultConfig,
+		ProgramOptions& po,
+		int jobFd,
+		int resultFd)
+{
+	std::string line;
+	while (readLineFrom(jobFd, line))
+	{
+		bool timedOut = false;
+		int ret = runBatchJob(
+				defaultConfig,
+				po,
+				splitBatchJobLine(line),
+				true,
+				timedOut);
+		bool restart = timedOut || ret == EXIT_BAD_ALLOC;
+
+		std::cout.flush();
+		std::cerr.flush();
+		if (!writeTo(resultFd, std::to_string(ret) + (restart ? " 1\n" : " 0\n"))
+				|| restart)
+		{
+			break;
+		}
+	}
+
+	std::cout.flush();
+	std::cerr.flush();
+	// Nothing inherited from the parent (e.g. static objects) is destroyed.
+	_exit(EXIT_SUCCESS);
+}
+
+/**
+ * Fork a new worker process into @a worker.
+ * @param workers All the workers. The new worker closes the parent's ends of
+ *                their pipes.
+ * @param cpus    CPUs to pin the new worker to (not pinned if empty).
+ */
+bool startBatchWorker(
+		const retdec::config::Config& defaultConfig,
+		ProgramOptions& po,
+		std::vector<BatchWorker>& workers,
+		BatchWorker& worker,
+		const std::vector<unsigned>& cpus)
+{
+	int jobPipe[2];
+	int resultPipe[2];
+	if (pipe(jobPipe) != 0)
+	{
+		return false;
+	}
+	if (pipe(resultPipe) != 0)
+	{
+		close(jobPipe[0]);
+		close(jobPipe[1]);
+		return false;
+	}
+
+	// Buffered outputs would be written by both the processes otherwise.
+	std::cout.flush();
+	std::cerr.flush();
+
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		close(jobPipe[0]);
+		close(jobPipe[1]);
+		close(resultPipe[0]);
+		close(resultPipe[1]);
+		return false;
+	}
+	if (pid == 0)
+	{
+		for (auto& w : workers)
+		{
+			if (w.pid > 0)
+			{
+				close(w.jobFd);
+				close(w.resultFd);
+			}
+		}
+		close(jobPipe[1]);
+		close(resultPipe[0]);
+		if (!cpus.empty() && !retdec::utils::setCpuAffinity(cpus))
+		{
+			Log::error() << Log::Warning
+					<< "failed to pin a batch worker to its CPUs" << std::endl;
+		}
+		runBatchWorker(defaultConfig, po, jobPipe[0], resultPipe[1]);
+	}
+
+	close(jobPipe[0]);
+	close(resultPipe[1]);
+	worker.pid = pid;
+	worker.jobFd = jobPipe[1];
+	worker.resultFd = resultPipe[0];
+	worker.jobNumber = 0;
+	worker.deadline.reset();
+	return true;
+}
+
+/**
+ * Stop @a worker and wait for its exit.
+ * @param kill Kill the worker. Otherwise, it exits when it finishes its job.
+ * @return Wait status of the worker.
+ */
+int stopBatchWorker(BatchWorker& worker, bool kill)
+{
+	close(worker.jobFd);
+	if (kill)
+	{
+		::kill(worker.pid, SIGKILL);
+	}
+	int status = 0;
+	while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+	{
+	}
+	close(worker.resultFd);
+	worker.pid = -1;
+	return status;
+}
+
+/**
+ * Get the time after which the worker decompiling the job given by @a args is
+ * killed: its timeout and twice the grace period in which it should stop by
+ * itself. The job has no deadline if it has no timeout.
+ */
+std::optional<std::chrono::steady_clock::time_point> getBatchJobDeadline(
+		const retdec::config::Config& defaultConfig,
+		ProgramOptions& po,
+		const std::list<std::string>& args)
+{
+	retdec::config::Config config = defaultConfig;
+	ProgramOptions jpo(po.programName, args, config, config.parameters);
+	jpo.inBatchJob = true;
+	try
+	{
+		jpo.load();
+	}
+	catch (const std::runtime_error&)
+	{
+		// The worker reports the error.
+		return std::nullopt;
+	}
+	if (!config.parameters.isTimeout())
+	{
+		return std::nullopt;
+	}
+	return std::chrono::steady_clock::now()
+			+ std::chrono::seconds(config.parameters.getTimeout())
+			+ 2 * CANCELLATION_GRACE_PERIOD;
+}
+
+/**
+ * Decompile all the jobs from @a in in @c po.batchWorkers forked worker
+ * processes. Each worker gets the next job when it finishes its previous one.
+ * The workers share (copy-on-write) everything this process loaded before, so
+ * the databases do not have to be loaded by each of them. A worker which
+ * crashes, or does not stop after the timeout of its job, is killed and its
+ * job fails. Workers that exit are replaced by new ones. With
+ * @c po.batchPinWorkers, the i-th worker is pinned to the CPUs of NUMA node
+ * (i mod number of nodes).
+ */
+int runBatchWorkers(
+		const retdec::config::Config& defaultConfig,
+		ProgramOptions& po,
+		std::istream& in)
+{
+	// Results of the workers that exited are read from closed pipes.
+	std::signal(SIGPIPE, SIG_IGN);
+
+	// Thread of an asynchronous log (if any) would not exist in the workers.
+	Log::set(Log::Type::Info, Logger::Ptr(new Logger(std::cout)));
+
+	int ret = EXIT_SUCCESS;
+	std::vector<BatchWorker> workers(po.batchWorkers);
+	std::vector<std::vector<unsigned>> workerCpus(po.batchWorkers);
+	if (po.batchPinWorkers)
+	{
+		auto nodes = retdec::utils::getCpusByNumaNode();
+		for (std::size_t i = 0; i < workerCpus.size(); ++i)
+		{
+			workerCpus[i] = nodes[i % nodes.size()];
+		}
+	}
+	std::size_t jobNumber = 0;
+	bool moreJobs = true;
+
+	auto finishJob = [&ret](BatchWorker& w, int jobRet)
+	{
+		std::cout << "retdec-batch-job: " << w.jobNumber << " " << jobRet
+				<< std::endl;
+		if (jobRet != EXIT_SUCCESS)
+		{
+			ret = EXIT_FAILURE;
+		}
+		w.jobNumber = 0;
+		w.deadline.reset();
+	};
+
+	while (true)
+	{
+		// Give jobs to the idle workers.
+		for (auto& w : workers)
+		{
+			if (!moreJobs || w.jobNumber)
+			{
+				continue;
+			}
+			std::string line;
+			std::list<std::string> args;
+			if (!readBatchJob(in, line, args))
+			{
+				moreJobs = false;
+				break;
+			}
+			auto& cpus = workerCpus[&w - workers.data()];
+			if (w.pid < 0
+					&& !startBatchWorker(defaultConfig, po, workers, w, cpus))
+			{
+				Log::error() << Log::Error
+						<< "failed to start a batch worker" << std::endl;
+				moreJobs = false;
+				ret = EXIT_FAILURE;
+				break;
+			}
+			w.jobNumber = ++jobNumber;
+			w.deadline = getBatchJobDeadline(defaultConfig, po, args);
+			if (!writeTo(w.jobFd, line + "\n"))
+			{
+				stopBatchWorker(w, true);
+				Log::error() << Log::Error << "batch worker of job "
+						<< w.jobNumber << " exited unexpectedly" << std::endl;
+				finishJob(w, EXIT_FAILURE);
+			}
+		}
+
+		// Wait for the results of the busy workers.
+		std::vector<pollfd> fds;
+		std::vector<BatchWorker*> busy;
+		std::optional<std::chrono::steady_clock::time_point> deadline;
+		for (auto& w : workers)
+		{
+			if (w.jobNumber)
+			{
+				fds.push_back({w.resultFd, POLLIN, 0});
+				busy.push_back(&w);
+				if (w.deadline && (!deadline || *w.deadline < *deadline))
+				{
+					deadline = w.deadline;
+				}
+			}
+		}
+		if (busy.empty())
+		{
+			break;
+		}
+
+		int timeout = -1;
+		if (deadline)
+		{
+			auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+					*deadline - std::chrono::steady_clock::now()).count();
+			// Woken up at least once a minute, so that the timeout fits.
+			timeout = static_cast<int>(std::clamp<long long>(left, 0, 60000));
+		}
+		if (poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR)
+		{
+			Log::error() << Log::Error << "failed to wait for batch workers"
+					<< std::endl;
+			ret = EXIT_FAILURE;
+			break;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		for (std::size_t i = 0; i < busy.size(); ++i)
+		{
+			auto& w = *busy[i];
+			if (fds[i].revents)
+			{
+				std::string result;
+				if (readLineFrom(w.resultFd, result))
+				{
+					int jobRet = EXIT_FAILURE;
+					int restart = 0;
+					std::istringstream(result) >> jobRet >> restart;
+					finishJob(w, jobRet);
+					if (restart)
+					{
+						stopBatchWorker(w, false);
+					}
+					continue;
+				}
+
+				int status = stopBatchWorker(w, false);
+				Log::error() << Log::Error << "batch worker of job "
+						<< w.jobNumber;
+				if (WIFSIGNALED(status))
+				{
+					Log::error() << " killed by signal " << WTERMSIG(status);
+				}
+				else
+				{
+					Log::error() << " exited unexpectedly";
+				}
+				Log::error() << std::endl;
+				finishJob(w, EXIT_FAILURE);
+			}
+			else if (w.deadline && now >= *w.deadline)
+			{
+				stopBatchWorker(w, true);
+				Log::error() << Log::Error << "batch worker of job "
+						<< w.jobNumber << " killed after its timeout"
+						<< std::endl;
+				finishJob(w, EXIT_TIMEOUT);
+			}
+		}
+	}
+
+	for (auto& w : workers)
+	{
+		if (w.pid > 0)
+		{
+			stopBatchWorker(w, w.jobNumber != 0);
+		}
+	}
+
+	return ret;
+}
+
+#endif
+
+/**
+ * Decompile all the jobs from the batch file, in this process or in
+ * @c po.batchWorkers worker processes. Each job starts from a copy of
+ * @a defaultConfig. The warm-up jobs (if any) run in this process first.
+ */
+int runBatch(const retdec::config::Config& defaultConfig, ProgramOptions& po)
+{
+	std::ifstream file;
+	std::istream* in = &std::cin;
+	if (po.batchFile != "-")
+	{
+		file.open(po.batchFile);
+		if (!file)
+		{
+			Log::error() << Log::Error << "[--batch] failed to open: "
+					<< po.batchFile << std::endl;
+			return EXIT_FAILURE;
+		}
+		in = &file;
+	}
+
+	int ret = EXIT_SUCCESS;
+	bool timedOut = false;
+	if (!po.batchWarmupFile.empty())
+	{
+		std::ifstream warmup(po.batchWarmupFile);
+		if (!warmup)
+		{
+			Log::error() << Log::Error << "[--batch-warmup] failed to open: "
+					<< po.batchWarmupFile << std::endl;
+			return EXIT_FAILURE;
+		}
+		ret = runBatchJobs(defaultConfig, po, warmup, "batch-warmup", timedOut);
+		if (timedOut)
+		{
+			return ret;
+		}
+	}
+
+	if (po.batchWorkers == 0)
+	{
+		int jobsRet = runBatchJobs(defaultConfig, po, *in, "batch-job", timedOut);
+		return jobsRet != EXIT_SUCCESS ? jobsRet : ret;
+	}
+
+#ifdef OS_POSIX
+	int jobsRet = runBatchWorkers(defaultConfig, po, *in);
+	return jobsRet != EXIT_SUCCESS ? jobsRet : ret;
+#else
+	Log::error() << Log::Error
+			<< "[--batch-workers] not supported on this system" << std::endl;
+	return EXIT_FAILURE;
+#endif
+}
+
+//
+//==============================================================================
+// Archive and all-slices modes.
+//==============================================================================
+//
+
+/**
+ * Object of the input archive, or slice of the input Mach-O universal binary,
+ * decompiled by the archive or the all-slices mode.
+ */
+struct ArchiveObject
+{
+	std::string name;
+	llvm::ArrayRef<std::uint8_t> data;
+	/// Config and options of the object. A timed out decompilation may
+	/// still use them, so they live until the whole archive is done.
+	std::unique_ptr<retdec::config::Config> config;
+	std::unique_ptr<ProgramOptions> po;
+	/// Exit code of the decompilation, none if it was not started.
+	std::optional<int> ret;
+	bool timedOut = false;
+};
+
+/**
+ * Insert @a infix into @a path before its @a suffix (or append it if there is
+ * no such suffix).
+ */
+std::string getObjectPath(
+		const std::string& path,
+		const std::string& suffix,
+		const std::string& infix)
+{
+	if (retdec::utils::endsWith(path, suffix))
+	{
+		return path.substr(0, path.size() - suffix.size()) + infix + suffix;
+	}
+	return path + infix;
+}
+
+/**
+ * Write the index of all the archive objects, their outputs and exit codes
+ * into @a path.
+ */
+bool writeArchiveIndex(
+		const std::string& path,
+		const std::string& archive,
+		const std::vector<ArchiveObject>& objects)
+{
+	rapidjson::StringBuffer sb;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(sb);
+
+	writer.StartObject();
+	writer.Key("archive");
+	writer.String(archive);
+	writer.Key("objects");
+	writer.StartArray();
+	for (std::size_t i = 0; i < objects.size(); ++i)
+	{
+		auto& o = objects[i];
+		writer.StartObject();
+		writer.Key("index");
+		writer.Uint64(i);
+		writer.Key("name");
+		writer.String(o.name);
+		writer.Key("output");
+		writer.String(o.config->parameters.getOutputFile());
+		writer.Key("exitCode");
+		if (o.ret)
+		{
+			writer.Int(o.ret.value());
+		}
+		else
+		{
+			writer.Null();
+		}
+		writer.EndObject();
+	}
+	writer.EndArray();
+	writer.EndObject();
+
+	std::ofstream out(path);
+	out << sb.GetString() << std::endl;
+	return static_cast<bool>(out);
+}
+
+/**
+ * Create the config and options of @a o from @a defaultConfig and @a po.
+ * The outputs of @a o are the outputs of the input with @a infix inserted
+ * before their suffixes.
+ */
+void setUpObject(
+		ArchiveObject& o,
+		const retdec::config::Config& defaultConfig,
+		const ProgramOptions& po,
+		const std::string& infix)
+{
+	o.config = std::make_unique<retdec::config::Config>(defaultConfig);
+	auto& p = o.config->parameters;
+	std::string outSuffix = p.getOutputFormat() == "plain" ? ".c" : ".c.json";
+	p.setOutputFile(getObjectPath(p.getOutputFile(), outSuffix, infix));
+	p.setOutputAsmFile(getObjectPath(p.getOutputAsmFile(), ".dsm", infix));
+	p.setOutputBitcodeFile(getObjectPath(p.getOutputBitcodeFile(), ".bc", infix));
+	p.setOutputLlvmirFile(getObjectPath(p.getOutputLlvmirFile(), ".ll", infix));
+	p.setOutputConfigFile(getObjectPath(p.getOutputConfigFile(), ".config.json", infix));
+	p.setOutputUnpackedFile(getObjectPath(p.getOutputUnpackedFile(), "-unpacked", infix));
+	if (!p.getProfileOutFile().empty())
+	{
+		p.setProfileOutFile(getObjectPath(p.getProfileOutFile(), ".json", infix));
+	}
+
+	o.po = std::make_unique<ProgramOptions>(
+			po.programName,
+			std::list<std::string>(),
+			*o.config,
+			p);
+	o.po->mode = po.mode;
+	o.po->bitSize = po.bitSize;
+	o.po->arExtractPath = getObjectPath(po.arExtractPath, "-extracted", infix);
+	o.po->cleanup = po.cleanup;
+	o.po->cacheDir = po.cacheDir;
+}
+
+/**
+ * Decompile all the set up @a objects on @a jobs threads.
+ *
+ * After each object, line "retdec-@a kind: INDEX EXIT_CODE" is printed to the
+ * standard output, and the index of all the objects is written at the end.
+ */
+int decompileObjects(
+		const retdec::config::Parameters& params,
+		std::vector<ArchiveObject>& objects,
+		unsigned jobs,
+		const std::string& kind)
+{
+	// Timed out decompilation that did not stop in time is still running, so
+	// no other object is started after it, as in the batch mode.
+	std::atomic<bool> stopped(false);
+	std::mutex outputMutex;
+	retdec::utils::parallelFor(objects.size(), jobs, [&](std::size_t i)
+	{
+		if (stopped)
+		{
+			return;
+		}
+
+		auto& o = objects[i];
+		o.ret = runDecompilation(*o.config, *o.po, o.timedOut);
+		if (o.timedOut)
+		{
+			stopped = true;
+		}
+		else
+		{
+			cleanup(*o.po);
+		}
+
+		std::lock_guard<std::mutex> lock(outputMutex);
+		std::cout << "retdec-" << kind << ": " << i << " " << o.ret.value()
+				<< std::endl;
+	});
+
+	std::string outSuffix = params.getOutputFormat() == "plain" ? ".c" : ".c.json";
+	auto indexPath = params.getOutputFile();
+	if (retdec::utils::endsWith(indexPath, outSuffix))
+	{
+		indexPath.resize(indexPath.size() - outSuffix.size());
+	}
+	indexPath += ".index.json";
+	if (!writeArchiveIndex(indexPath, params.getInputFile(), objects))
+	{
+		Log::error() << Log::Error << "failed to write index: "
+				<< indexPath << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (stopped)
+	{
+		Log::error() << Log::Error
+				<< "decompilation stopped after a timed out " << kind
+				<< std::endl;
+		return EXIT_TIMEOUT;
+	}
+	for (auto& o : objects)
+	{
+		if (o.ret != EXIT_SUCCESS)
+		{
+			return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
+
+/**
+ * Decompile all the objects from the input archive in this process.
+ *
+ * The archive is read only once and its objects are decompiled right from its
+ * buffer, on @c po.arJobs threads. Each object starts from a copy of
+ * @a defaultConfig, its outputs are the outputs of the archive with ".file_N"
+ * inserted before their suffixes, N is the one-based index of the object.
+ * Type databases and initialized passes are shared by
+ * all the objects. After each object, line
+ * "retdec-archive-object: INDEX EXIT_CODE" is printed to the standard output,
+ * and the index of all the objects is written at the end.
+ */
+int runArchive(const retdec::config::Config& defaultConfig, ProgramOptions& po)
+{
+	auto& params = defaultConfig.parameters;
+	setLogsFrom(params);
+
+	bool ok = true;
+	std::string errMsg;
+	retdec::ar_extractor::ArchiveWrapper arw(params.getInputFile(), ok, errMsg);
+	if (!ok)
+	{
+		Log::error() << Log::Error
+				<< "[--ar-all] failed to create archive wrapper: " << errMsg
+				<< std::endl;
+		return EXIT_FAILURE;
+	}
+	if (arw.isThinArchive())
+	{
+		Log::error() << "Error: File is a thin archive and cannot be decompiled." << std::endl;
+		return EXIT_FAILURE;
+	}
+	if (arw.isEmptyArchive())
+	{
+		Log::error() << "Error: The input archive is empty." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<ArchiveObject> objects;
+	if (!arw.forEachMember(
+			[&objects](const std::string& name, llvm::ArrayRef<std::uint8_t> data)
+			{
+				objects.emplace_back();
+				objects.back().name = name;
+				objects.back().data = data;
+			},
+			errMsg))
+	{
+		Log::error() << Log::Error
+				<< "[--ar-all] failed to read archive: " << errMsg
+				<< std::endl;
+		return EXIT_FAILURE;
+	}
+
+	for (std::size_t i = 0; i < objects.size(); ++i)
+	{
+		auto& o = objects[i];
+		setUpObject(o, defaultConfig, po, ".file_" + std::to_string(i + 1));
+		o.po->arIdx = i;
+		o.po->arObjectData = reinterpret_cast<const char*>(o.data.data());
+		o.po->arObjectSize = o.data.size();
+	}
+
+	return decompileObjects(params, objects, po.arJobs, "archive-object");
+}
+
+/**
+ * Decompile all the slices of the input Mach-O universal binary in this
+ * process.
+ *
+ * The binary is read only once and its slices are decompiled in parallel
+ * right from its buffer. Each slice starts from a copy of @a defaultConfig,
+ * its outputs are the outputs of the binary with ".ARCH" inserted before their
+ * suffixes. Slices that are archives are handled as the input archive of the
+ * single-slice mode (@c --ar-index and @c --ar-name pick an object from each
+ * of them). Type databases and initialized passes are shared by all the
+ * slices. After each slice, line "retdec-slice: INDEX EXIT_CODE" is printed to
+ * the standard output, and the index of all the slices is written at the end.
+ */
+int runSlices(const retdec::config::Config& defaultConfig, ProgramOptions& po)
+{
+	auto& params = defaultConfig.parameters;
+	setLogsFrom(params);
+
+	retdec::macho_extractor::BreakMachOUniversal fat(params.getInputFile());
+	if (!fat.isValid())
+	{
+		Log::error() << Log::Error
+				<< "[--all-slices] the input is not a Mach-O universal binary"
+				<< std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<ArchiveObject> slices(fat.getNumberOfArchives());
+	for (unsigned i = 0; i < slices.size(); ++i)
+	{
+		auto& s = slices[i];
+		std::uint64_t offset = 0;
+		std::uint64_t size = 0;
+		if (!fat.getArchiveRangeWithIndex(i, s.name, offset, size))
+		{
+			Log::error() << Log::Error
+					<< "[--all-slices] failed to read slice " << i << std::endl;
+			return EXIT_FAILURE;
+		}
+		s.data = llvm::ArrayRef<std::uint8_t>(
+				reinterpret_cast<const std::uint8_t*>(
+						fat.getFileBufferStart() + offset),
+				size);
+
+		// Architectures are unique in a universal binary, but not all of
+		// them have names, so the index keeps the outputs apart.
+		auto infix = "." + s.name;
+		for (unsigned j = 0; j < i; ++j)
+		{
+			if (slices[j].name == s.name)
+			{
+				infix += "_" + std::to_string(i + 1);
+				break;
+			}
+		}
+
+		setUpObject(s, defaultConfig, po, infix);
+		s.po->arIdx = po.arIdx;
+		s.po->arName = po.arName;
+		s.po->sliceData = reinterpret_cast<const char*>(s.data.data());
+		s.po->sliceSize = s.data.size();
+		s.po->sliceName = s.name;
+	}
+
+	return decompileObjects(params, slices, slices.size(), "slice");
+}
+
+//
+//==============================================================================
+// Main.
+//==============================================================================
+//
+
+int main(int argc, char **argv)
+{
+	// Set LLVM debug.
+	//
+	llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
+	llvm::PrettyStackTraceProgram X(argc, argv);
+	llvm::llvm_shutdown_obj Y; // Call llvm_shutdown() on exit.
+	llvm::EnableDebugBuffering = true;
+
+	// Load the default config parameters.
+	//
+	retdec::config::Config config;
+	auto binpath = retdec::utils::getThisBinaryDirectoryPath();
+	fs::path configPath(fs::canonical(binpath).parent_path());
+	configPath.append("share");
+	configPath.append("retdec");
+	configPath.append("decompiler-config.json");
+	if (fs::exists(configPath))
+	{
+		config = retdec::config::Config::fromFile(configPath.string());
+		config.parameters.fixRelativePaths(fs::canonical(configPath).parent_path().string());
+	}
+
+	// Parse program arguments.
+	//
+	ProgramOptions po(argc, argv, config, config.parameters);
+	try
+	{
+		po.load();
+	}
+	catch (const std::runtime_error& e)
+	{
+		Log::error() << Log::Error << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// Limit program memory.
+	//
+	limitMaximalMemoryIfRequested(config.parameters);
+
+	if (!po.traceOutFile.empty())
+	{
+		retdec::utils::instrumentation::setEnabled(true);
+		retdec::utils::instrumentation::setTracing(true);
+	}
+
+	// Decompile.
+	//
+	int ret = EXIT_SUCCESS;
+	if (!po.batchFile.empty())
+	{
+		ret = runBatch(config, po);
+	}
+	else if (po.arAll)
+	{
+		ret = runArchive(config, po);
+	}
+	else if (po.allSlices)
+	{
+		ret = runSlices(config, po);
+	}
+	else
+	{
+		bool timedOut = false;
+		ret = runDecompilation(config, po, timedOut);
+		cleanup(po);
+	}
+
+	if (!po.traceOutFile.empty()
+			&& !retdec::utils::instrumentation::writeChromeTrace(po.traceOutFile))
+	{
+		Log::error() << Log::Warning << "failed to write trace into: "
+				<< po.traceOutFile << std::endl;
+	}
 
 	return ret;
 }
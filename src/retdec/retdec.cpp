@@ -4,6 +4,7 @@
  * @copyright (c) 2019 Avast Software, licensed under the MIT license
  */
 
+#include <llvm/ADT/Hashing.h>
 #include <llvm/ADT/Triple.h>
 #include <llvm/Analysis/CallGraph.h>
 #include <llvm/Analysis/CallGraphSCCPass.h>
@@ -12,6 +13,7 @@
 #include <llvm/Analysis/ScalarEvolution.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/CodeGen/CommandFlags.inc>
 #include <llvm/IR/CFG.h>
 #include <llvm/IR/DataLayout.h>
@@ -40,16 +42,37 @@
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "retdec/bin2llvmir/analyses/reaching_definitions.h"
+#include "retdec/bin2llvmir/optimizations/constants/constants.h"
 #include "retdec/bin2llvmir/optimizations/decoder/decoder.h"
+#include "retdec/bin2llvmir/optimizations/idioms/idioms.h"
+#include "retdec/bin2llvmir/optimizations/inst_opt_rda/inst_opt_rda_pass.h"
+#include "retdec/bin2llvmir/optimizations/param_return/param_return.h"
 #include "retdec/bin2llvmir/optimizations/provider_init/provider_init.h"
+#include "retdec/bin2llvmir/optimizations/stack/stack.h"
 #include "retdec/bin2llvmir/providers/asm_instruction.h"
 #include "retdec/bin2llvmir/providers/config.h"
+#include "retdec/bin2llvmir/utils/async_writers.h"
 
 #include "retdec/llvmir2hll/llvmir2hll.h"
 
 #include "retdec/config/config.h"
 #include "retdec/retdec/retdec.h"
+#include "retdec/utils/cancellation.h"
+#include "retdec/utils/conversion.h"
+#include "retdec/utils/instrumentation.h"
 #include "retdec/utils/memory.h"
+#include "retdec/utils/string.h"
+#include "retdec/utils/time.h"
 #include "retdec/utils/io/log.h"
 
 using namespace retdec::utils::io;
@@ -265,19 +288,19 @@ common::Function fillFunction(
 	return ret;
 }
 
-void fillFunctions(
+/**
+ * Create functions for all the functions in @a module one by one, and pass
+ * each of them to @a cb right after it is created.
+ * @return @c false if @a cb stopped the iteration, @c true otherwise.
+ */
+bool forEachFunction(
 		llvm::Module& module,
-		retdec::common::FunctionSet* fs)
+		const FunctionCallback& cb)
 {
-	if (fs == nullptr)
-	{
-		return;
-	}
-
 	auto* config = bin2llvmir::ConfigProvider::getConfig(&module);
 	if (config == nullptr)
 	{
-		return;
+		return true;
 	}
 
 	for (llvm::Function& f : module.functions())
@@ -287,20 +310,47 @@ void fillFunctions(
 			|| bin2llvmir::AsmInstruction::getFunctionAddress(&f).isUndefined())
 		{
 			auto sa = config->getFunctionAddress(&f);
-			if (sa.isDefined())
+			if (sa.isDefined()
+					&& !cb(common::Function(sa, sa, f.getName())))
 			{
-				fs->emplace(common::Function(sa, sa, f.getName()));
+				return false;
 			}
 			continue;
 		}
 
-		fs->emplace(fillFunction(config, f));
+		if (!cb(fillFunction(config, f)))
+		{
+			return false;
+		}
 	}
+
+	return true;
 }
 
-LlvmModuleContextPair disassemble(
-		const std::string& inputPath,
+void fillFunctions(
+		llvm::Module& module,
 		retdec::common::FunctionSet* fs)
+{
+	if (fs == nullptr)
+	{
+		return;
+	}
+
+	forEachFunction(module, [fs](common::Function&& f)
+	{
+		fs->emplace(std::move(f));
+		return true;
+	});
+}
+
+/**
+ * Decode the input file into a new LLVM module. If @a inputData are set,
+ * they are decoded instead of the content of the input file.
+ */
+LlvmModuleContextPair decodeInput(
+		const std::string& inputPath,
+		const std::uint8_t* inputData = nullptr,
+		std::size_t inputDataSize = 0)
 {
 	auto context = std::make_unique<llvm::LLVMContext>();
 	auto module = createLlvmModule(*context);
@@ -312,42 +362,326 @@ LlvmModuleContextPair disassemble(
 	// are about to build.
 	llvm::legacy::PassManager pm;
 
-	pm.add(new bin2llvmir::ProviderInitialization(&c));
+	auto* init = new bin2llvmir::ProviderInitialization(&c);
+	init->setInputData(inputData, inputDataSize);
+	pm.add(init);
 	pm.add(new bin2llvmir::Decoder());
 
 	// Now that we have all of the passes ready, run them.
 	pm.run(*module);
 
-	fillFunctions(*module, fs);
-
 	return LlvmModuleContextPair{std::move(module), std::move(context)};
 }
 
+LlvmModuleContextPair disassemble(
+		const std::string& inputPath,
+		retdec::common::FunctionSet* fs)
+{
+	auto ret = decodeInput(inputPath);
+	fillFunctions(*ret.module, fs);
+	return ret;
+}
+
+LlvmModuleContextPair disassemble(
+		const std::uint8_t* data,
+		std::size_t size,
+		retdec::common::FunctionSet* fs)
+{
+	auto ret = decodeInput(std::string(), data, size);
+	fillFunctions(*ret.module, fs);
+	return ret;
+}
+
+bool disassemble(
+		const std::string& inputPath,
+		const FunctionCallback& cb)
+{
+	auto decoded = decodeInput(inputPath);
+	return forEachFunction(*decoded.module, cb);
+}
+
+bool disassemble(
+		const std::uint8_t* data,
+		std::size_t size,
+		const FunctionCallback& cb)
+{
+	auto decoded = decodeInput(std::string(), data, size);
+	return forEachFunction(*decoded.module, cb);
+}
+
 //==============================================================================
 // decompiler
 //==============================================================================
 
 /**
  * Call a bunch of LLVM initialization functions, same as the original opt.
+ * The registry is process-wide, so this is done only once per process, no
+ * matter how many decompilations are run.
  */
 llvm::PassRegistry& initializeLlvmPasses()
 {
-	// Initialize passes
-	llvm::PassRegistry& Registry = *llvm::PassRegistry::getPassRegistry();
-	initializeCore(Registry);
-	initializeScalarOpts(Registry);
-	initializeIPO(Registry);
-	initializeAnalysis(Registry);
-	initializeTransformUtils(Registry);
-	initializeInstCombine(Registry);
-	initializeTarget(Registry);
+	static llvm::PassRegistry& Registry = []() -> llvm::PassRegistry&
+	{
+		// Initialize passes
+		llvm::PassRegistry& r = *llvm::PassRegistry::getPassRegistry();
+		initializeCore(r);
+		initializeScalarOpts(r);
+		initializeIPO(r);
+		initializeAnalysis(r);
+		initializeTransformUtils(r);
+		initializeInstCombine(r);
+		initializeTarget(r);
+		return r;
+	}();
 	return Registry;
 }
 
+/**
+ * Collects per-pass timing and memory information about one decompilation.
+ * Each profiled pass is surrounded by @c start() and @c stop() calls.
+ *
+ * CPU time and resident memory are process-wide quantities. When several
+ * decompilations run concurrently, their values include the other threads.
+ * So do the totals of instrumentation timers and counters, whose collection
+ * is enabled by the profiler.
+ */
+class PassProfiler
+{
+	public:
+		struct IrSize
+		{
+			std::size_t functions = 0;
+			std::size_t basicBlocks = 0;
+			std::size_t instructions = 0;
+		};
+
+		struct Record
+		{
+			std::string name;
+			std::string argument;
+			double wallTime = 0.0;
+			double cpuTime = 0.0;
+			std::size_t rssBefore = 0;
+			std::size_t rssAfter = 0;
+			IrSize irBefore;
+			IrSize irAfter;
+			/// Pass specific counters.
+			std::vector<std::pair<std::string, std::uint64_t>> counters;
+		};
+
+	public:
+		PassProfiler()
+				: _wallStart(std::chrono::steady_clock::now())
+				, _cpuStart(utils::getElapsedTime())
+		{
+			utils::instrumentation::setEnabled(true);
+			_instrumentationStart = utils::instrumentation::collect();
+		}
+
+		void start(
+				const std::string& name,
+				const std::string& argument,
+				Module& M)
+		{
+			Record r;
+			r.name = name;
+			r.argument = argument;
+			r.irBefore = getIrSize(M);
+			r.rssBefore = utils::getCurrentProcessMemory();
+			_records.push_back(std::move(r));
+
+			_passCpuStart = utils::getElapsedTime();
+			_passWallStart = std::chrono::steady_clock::now();
+		}
+
+		void stop(Module& M)
+		{
+			auto wallEnd = std::chrono::steady_clock::now();
+			auto cpuEnd = utils::getElapsedTime();
+
+			if (_records.empty())
+			{
+				return;
+			}
+			auto& r = _records.back();
+			r.wallTime = std::chrono::duration<double>(
+					wallEnd - _passWallStart).count();
+			r.cpuTime = cpuEnd - _passCpuStart;
+			r.rssAfter = utils::getCurrentProcessMemory();
+			r.irAfter = getIrSize(M);
+		}
+
+		/**
+		 * Add a pass specific counter to the last profiled pass.
+		 */
+		void addCounter(const std::string& name, std::uint64_t value)
+		{
+			if (!_records.empty())
+			{
+				_records.back().counters.emplace_back(name, value);
+			}
+		}
+
+		/**
+		 * Write the collected profile in JSON format into @a outFile.
+		 * @return @c true if the profile was written, @c false otherwise.
+		 */
+		bool write(const std::string& outFile) const
+		{
+			std::ofstream out(outFile);
+			if (!out)
+			{
+				return false;
+			}
+
+			rapidjson::StringBuffer sb;
+			rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(sb);
+
+			writer.StartObject();
+
+			writer.String("passes");
+			writer.StartArray();
+			for (auto& r : _records)
+			{
+				writer.StartObject();
+				writer.String("name");
+				writer.String(r.name.c_str());
+				writer.String("argument");
+				writer.String(r.argument.c_str());
+				writer.String("wallTime");
+				writer.Double(r.wallTime);
+				writer.String("cpuTime");
+				writer.Double(r.cpuTime);
+				writer.String("rssBefore");
+				writer.Uint64(r.rssBefore);
+				writer.String("rssAfter");
+				writer.Uint64(r.rssAfter);
+				writer.String("rssDelta");
+				writer.Int64(static_cast<int64_t>(r.rssAfter)
+						- static_cast<int64_t>(r.rssBefore));
+				writer.String("irBefore");
+				writeIrSize(writer, r.irBefore);
+				writer.String("irAfter");
+				writeIrSize(writer, r.irAfter);
+				if (!r.counters.empty())
+				{
+					writer.String("counters");
+					writer.StartObject();
+					for (auto& c : r.counters)
+					{
+						writer.String(c.first.c_str());
+						writer.Uint64(c.second);
+					}
+					writer.EndObject();
+				}
+				writer.EndObject();
+			}
+			writer.EndArray();
+
+			writer.String("total");
+			writer.StartObject();
+			writer.String("wallTime");
+			writer.Double(std::chrono::duration<double>(
+					std::chrono::steady_clock::now() - _wallStart).count());
+			writer.String("cpuTime");
+			writer.Double(utils::getElapsedTime() - _cpuStart);
+			writer.String("peakRss");
+			writer.Uint64(utils::getPeakProcessMemory());
+			writer.EndObject();
+
+			writer.String("instrumentation");
+			writeInstrumentation(
+					writer,
+					utils::instrumentation::collect() - _instrumentationStart);
+
+			writer.EndObject();
+
+			out << sb.GetString() << std::endl;
+			return static_cast<bool>(out);
+		}
+
+	private:
+		static IrSize getIrSize(Module& M)
+		{
+			IrSize ret;
+			for (auto& f : M)
+			{
+				if (f.isDeclaration())
+				{
+					continue;
+				}
+				++ret.functions;
+				for (auto& bb : f)
+				{
+					++ret.basicBlocks;
+					ret.instructions += bb.size();
+				}
+			}
+			return ret;
+		}
+
+		template <typename Writer>
+		static void writeIrSize(Writer& writer, const IrSize& s)
+		{
+			writer.StartObject();
+			writer.String("functions");
+			writer.Uint64(s.functions);
+			writer.String("basicBlocks");
+			writer.Uint64(s.basicBlocks);
+			writer.String("instructions");
+			writer.Uint64(s.instructions);
+			writer.EndObject();
+		}
+
+		template <typename Writer>
+		static void writeInstrumentation(
+				Writer& writer,
+				const utils::instrumentation::Stats& s)
+		{
+			writer.StartObject();
+			writer.String("timers");
+			writer.StartObject();
+			for (auto& t : s.timers)
+			{
+				writer.String(t.first.c_str());
+				writer.StartObject();
+				writer.String("count");
+				writer.Uint64(t.second.count);
+				writer.String("totalTime");
+				writer.Double(t.second.totalNs / 1e9);
+				writer.String("maxTime");
+				writer.Double(t.second.maxNs / 1e9);
+				writer.EndObject();
+			}
+			writer.EndObject();
+			writer.String("counters");
+			writer.StartObject();
+			for (auto& c : s.counters)
+			{
+				writer.String(c.first.c_str());
+				writer.Uint64(c.second);
+			}
+			writer.EndObject();
+			writer.EndObject();
+		}
+
+	private:
+		std::chrono::steady_clock::time_point _wallStart;
+		double _cpuStart = 0.0;
+		utils::instrumentation::Stats _instrumentationStart;
+		std::chrono::steady_clock::time_point _passWallStart;
+		double _passCpuStart = 0.0;
+		std::vector<Record> _records;
+};
+
 /**
  * This pass just prints phase information about other, subsequent passes.
  * In pass manager, tt should be placed right before the pass which phase info
  * it is printing.
+ * It is also a cancellation point, and it starts a new cancellation phase
+ * for the subsequent pass.
+ * Reaching definitions shared by bin2llvmir passes are dropped before passes
+ * that do not keep them up to date.
  */
 class ModulePassPrinter : public ModulePass
 {
@@ -357,23 +691,44 @@ class ModulePassPrinter : public ModulePass
 		std::string PhaseArg;
 		std::string PassName;
 
-		static std::string LastPhase;
+		PassProfiler* Profiler = nullptr;
+		bool SharesRda = false;
+
+		static thread_local std::string LastPhase;
 		inline static const std::string LlvmAggregatePhaseName = "LLVM";
 
 	public:
 		ModulePassPrinter(
 				const std::string& phaseName,
-				const std::string& phaseArg)
+				const std::string& phaseArg,
+				PassProfiler* profiler = nullptr,
+				bool sharesRda = false)
 				: ModulePass(ID)
 				, PhaseName(phaseName)
 				, PhaseArg(phaseArg)
 				, PassName("ModulePass Printer: " + PhaseName)
+				, Profiler(profiler)
+				, SharesRda(sharesRda)
 		{
 
 		}
 
 		bool runOnModule(Module &M) override
 		{
+			utils::throwIfCancellationRequested();
+			utils::startCancellationPhase();
+
+			if (!SharesRda)
+			{
+				bin2llvmir::ReachingDefinitionsProvider::invalidate(&M);
+			}
+
+			if (Profiler)
+			{
+				Profiler->start(PhaseName, PhaseArg, M);
+			}
+			RETDEC_TRACE_BEGIN(utils::instrumentation::intern(PhaseArg));
+
 			if (utils::startsWith(PhaseArg, "retdec"))
 			{
 				Log::phase(PhaseName);
@@ -406,21 +761,136 @@ class ModulePassPrinter : public ModulePass
 		}
 };
 char ModulePassPrinter::ID = 0;
-std::string ModulePassPrinter::LastPhase;
+thread_local std::string ModulePassPrinter::LastPhase;
+
+/**
+ * This pass closes the profiling record and the trace span opened by the
+ * @c ModulePassPrinter. In pass manager, it should be placed right after the
+ * profiled pass.
+ */
+class ModulePassProfilerEnd : public ModulePass
+{
+	public:
+		static char ID;
+		PassProfiler* Profiler = nullptr;
+		Pass* Profiled = nullptr;
+		const PassInfo* ProfiledInfo = nullptr;
+
+	public:
+		ModulePassProfilerEnd(
+				PassProfiler* profiler,
+				Pass* profiled,
+				const PassInfo* profiledInfo)
+				: ModulePass(ID)
+				, Profiler(profiler)
+				, Profiled(profiled)
+				, ProfiledInfo(profiledInfo)
+		{
+
+		}
+
+		bool runOnModule(Module &M) override
+		{
+			RETDEC_TRACE_END();
+			if (Profiler)
+			{
+				Profiler->stop(M);
+				addCounters();
+			}
+			return false;
+		}
+
+		llvm::StringRef getPassName() const override
+		{
+			return "ModulePass Profiler End";
+		}
+
+		void getAnalysisUsage(AnalysisUsage &AU) const override
+		{
+			AU.setPreservesAll();
+		}
+
+	private:
+		/**
+		 * Add counters of passes that collect them to the profile.
+		 */
+		void addCounters()
+		{
+			if (ProfiledInfo->getTypeInfo() == &bin2llvmir::Decoder::ID)
+			{
+				auto* d = static_cast<bin2llvmir::Decoder*>(Profiled);
+				auto& s = d->getJumpTargetStatistics();
+				Profiler->addCounter("jumpTargetsPushed", s.pushed);
+				Profiler->addCounter("jumpTargetsDuplicates", s.duplicates);
+				Profiler->addCounter("jumpTargetsRejected", s.rejected);
+				Profiler->addCounter("jumpTargetsPopped", s.popped);
+
+				auto& ds = d->getStatistics();
+				Profiler->addCounter("decodedInstructions", ds.decodedInstructions);
+				Profiler->addCounter("decodedBytes", ds.decodedBytes);
+				Profiler->addCounter("skippedBytes", ds.skippedBytes);
+				Profiler->addCounter("dryRuns", ds.dryRuns);
+				Profiler->addCounter("dryRunRejections", ds.dryRunRejections);
+				Profiler->addCounter("pseudoCallsResolved", ds.pseudoCallsResolved);
+				Profiler->addCounter("pseudoCallsRemoved", ds.pseudoCallsRemoved);
+				Profiler->addCounter("delaySlotFixups", ds.delaySlotFixups);
+				Profiler->addCounter("functionSplits", ds.functionSplits);
+				for (auto& p : ds.jumpTargetTypes)
+				{
+					auto t = bin2llvmir::JumpTarget::typeToString(p.first);
+					Profiler->addCounter("decoded." + t, p.second.decoded);
+					Profiler->addCounter("decodeTimeUs." + t, p.second.time);
+				}
+			}
+			else if (ProfiledInfo->getTypeInfo() == &bin2llvmir::Idioms::ID)
+			{
+				auto* i = static_cast<bin2llvmir::Idioms*>(Profiled);
+				for (auto& p : i->getStatistics())
+				{
+					Profiler->addCounter("idiomHits." + p.first, p.second.hits);
+					Profiler->addCounter("idiomTimeNs." + p.first, p.second.time);
+				}
+			}
+		}
+};
+char ModulePassProfilerEnd::ID = 0;
+
+/**
+ * @return @c True if the pass identified by @a PI uses the shared
+ *         @c ReachingDefinitionsProvider analysis and invalidates all the
+ *         functions it modifies.
+ */
+static bool sharesRda(const PassInfo* PI)
+{
+	auto* id = PI->getTypeInfo();
+	return id == &bin2llvmir::StackAnalysis::ID
+			|| id == &bin2llvmir::ConstantsAnalysis::ID
+			|| id == &bin2llvmir::ParamReturn::ID
+			|| id == &bin2llvmir::InstructionRdaOptimizer::ID;
+}
 
 /**
  * Add the pass to the pass manager - no verification.
+ * If @a profiler is given, the pass is also profiled. If tracing is enabled,
+ * the pass is traced as a span.
  */
 static inline void addPass(
 		legacy::PassManagerBase& PM,
 		Pass* P,
-		const PassInfo* PI)
+		const PassInfo* PI,
+		PassProfiler* profiler = nullptr)
 {
 	PM.add(new ModulePassPrinter(
 			PI->getPassName().str(),
-			PI->getPassArgument().str()
+			PI->getPassArgument().str(),
+			profiler,
+			sharesRda(PI)
 	));
 	PM.add(P);
+	if (profiler || utils::instrumentation::isTracing())
+	{
+		PM.add(new ModulePassProfilerEnd(profiler, P, PI));
+	}
 
 // if (!PI->isAnalysis())
 // PM.add(P->createPrinterPass(
@@ -460,62 +930,747 @@ void setLogsFrom(const retdec::config::Parameters& params)
 	}
 }
 
-bool decompile(retdec::config::Config& config, std::string* outString)
+namespace {
+
+/// Argument of the pass writing the bitcode at the end of the front-end.
+const std::string BitcodeWriterPassArg = "retdec-write-bc";
+/// Argument of the pass removing bodies of the functions which are not
+/// selected.
+const std::string SelectFunctionsPassArg = "retdec-select-fncs";
+/// Argument of the pass removing functions unreachable from main.
+const std::string UnreachableFuncsPassArg = "retdec-unreachable-funcs";
+/// Argument of the pass before which unreachable functions are removed when
+/// they are pruned early.
+const std::string ParamReturnPassArg = "retdec-param-return";
+/// Prefix of the pseudo pass that starts a group of passes repeated until
+/// they do not change the module, at most the number of times following the
+/// prefix (e.g. "retdec-repeat:4").
+const std::string RepeatBeginPassArg = "retdec-repeat:";
+/// Pseudo pass that ends the group started by @c RepeatBeginPassArg.
+const std::string RepeatEndPassArg = "retdec-repeat-end";
+
+/**
+ * Consecutive passes run by one pass manager.
+ */
+struct PassGroup
 {
-	setLogsFrom(config.parameters);
+	std::vector<std::string> passes;
+	/// The passes are run again while they change the module, but at most
+	/// this number of times in total.
+	unsigned maxRuns = 1;
+};
 
-	Log::phase("Initialization");
-	auto& passRegistry = initializeLlvmPasses();
+/**
+ * Split @a passes into groups by the repeat pseudo passes. Passes outside of
+ * them form groups that are run only once.
+ */
+std::vector<PassGroup> splitPassGroups(const std::vector<std::string>& passes)
+{
+	std::vector<PassGroup> ret(1);
+	bool inRepeat = false;
+	for (auto& p : passes)
+	{
+		if (utils::startsWith(p, RepeatBeginPassArg))
+		{
+			unsigned maxRuns = 0;
+			auto n = p.substr(RepeatBeginPassArg.size());
+			if (inRepeat
+					|| !utils::strToNum(n, maxRuns)
+					|| maxRuns == 0)
+			{
+				throw std::runtime_error("invalid pass: " + p);
+			}
+			ret.emplace_back();
+			ret.back().maxRuns = maxRuns;
+			inRepeat = true;
+		}
+		else if (p == RepeatEndPassArg)
+		{
+			if (!inRepeat)
+			{
+				throw std::runtime_error("unmatched pass: " + p);
+			}
+			ret.emplace_back();
+			inRepeat = false;
+		}
+		else
+		{
+			ret.back().passes.push_back(p);
+		}
+	}
+	if (inRepeat)
+	{
+		throw std::runtime_error(
+				"missing pass: " + RepeatEndPassArg);
+	}
+	return ret;
+}
 
-	// limitMaximalMemoryIfRequested(params);
-	// PrintAfterAll = true;
+/**
+ * @return Fingerprint of the body of @a f. Instructions are compared by
+ *         their identities, opcodes, types, flags and operands, so a body
+ *         whose fingerprint did not change was not modified in any way that
+ *         matters to further optimizations. Metadata are not considered.
+ */
+llvm::hash_code getBodyFingerprint(const llvm::Function& f)
+{
+	llvm::hash_code ret = llvm::hash_value(f.size());
+	for (auto& bb : f)
+	{
+		ret = llvm::hash_combine(ret, &bb);
+		for (auto& i : bb)
+		{
+			ret = llvm::hash_combine(
+					ret,
+					&i,
+					i.getOpcode(),
+					i.getType(),
+					i.getRawSubclassOptionalData());
+			for (auto* op : i.operand_values())
+			{
+				ret = llvm::hash_combine(ret, op);
+			}
+			if (auto* cmp = llvm::dyn_cast<llvm::CmpInst>(&i))
+			{
+				ret = llvm::hash_combine(ret, cmp->getPredicate());
+			}
+			else if (auto* phi = llvm::dyn_cast<llvm::PHINode>(&i))
+			{
+				for (auto* pred : phi->blocks())
+				{
+					ret = llvm::hash_combine(ret, pred);
+				}
+			}
+		}
+	}
+	return ret;
+}
 
-	auto context = std::make_unique<llvm::LLVMContext>();
-	auto module = createLlvmModule(*context);
+/**
+ * @return Fingerprint of everything function passes may see outside of the
+ *         function they optimize: global variables and their initializers,
+ *         and the set of functions with their linkages and attributes.
+ */
+llvm::hash_code getContextFingerprint(const llvm::Module& m)
+{
+	llvm::hash_code ret = llvm::hash_value(m.global_size());
+	for (auto& gv : m.globals())
+	{
+		ret = llvm::hash_combine(
+				ret,
+				&gv,
+				gv.getLinkage(),
+				gv.isConstant(),
+				gv.hasInitializer() ? gv.getInitializer() : nullptr);
+	}
+	ret = llvm::hash_combine(ret, m.size());
+	for (auto& f : m)
+	{
+		ret = llvm::hash_combine(
+				ret,
+				&f,
+				f.getLinkage(),
+				f.isDeclaration(),
+				f.getAttributes().getRawPointer());
+	}
+	return ret;
+}
 
-	// Create a PassManager to hold and optimize the collection of passes we
-	// are about to build.
-	llvm::legacy::PassManager pm;
+/**
+ * Fingerprint of a module that tells which functions were changed.
+ */
+struct ModuleFingerprint
+{
+	llvm::hash_code context;
+	std::map<const llvm::Function*, llvm::hash_code> bodies;
 
+	explicit ModuleFingerprint(const llvm::Module& m)
+			: context(getContextFingerprint(m))
+	{
+		for (auto& f : m)
+		{
+			if (!f.isDeclaration())
+			{
+				bodies.emplace(&f, getBodyFingerprint(f));
+			}
+		}
+	}
+};
+
+/**
+ * @return All functions of @a m with bodies.
+ */
+std::vector<llvm::Function*> getDefinedFunctions(llvm::Module& m)
+{
+	std::vector<llvm::Function*> ret;
+	for (auto& f : m)
+	{
+		if (!f.isDeclaration())
+		{
+			ret.push_back(&f);
+		}
+	}
+	return ret;
+}
+
+/**
+ * @return Functions of @a m whose bodies differ in @a before and @a after,
+ *         or all functions of @a m if their context differs.
+ */
+std::vector<llvm::Function*> getChangedFunctions(
+		llvm::Module& m,
+		const ModuleFingerprint& before,
+		const ModuleFingerprint& after)
+{
+	if (before.context != after.context)
+	{
+		return getDefinedFunctions(m);
+	}
+
+	std::vector<llvm::Function*> ret;
+	for (auto& f : after.bodies)
+	{
+		auto b = before.bodies.find(f.first);
+		if (b == before.bodies.end() || b->second != f.second)
+		{
+			ret.push_back(const_cast<llvm::Function*>(f.first));
+		}
+	}
+	return ret;
+}
+
+/**
+ * @return @a passes with unreachable functions removed also before the
+ * parameter and return analysis, if it is requested by @a config and the
+ * functions are removed at all.
+ */
+std::vector<std::string> addEarlyUnreachableFuncs(
+		const retdec::config::Config& config,
+		const std::vector<std::string>& passes)
+{
+	auto ret = passes;
+	if (!config.parameters.isPruneUnreachableFunctionsEarly()
+			|| std::find(ret.begin(), ret.end(), UnreachableFuncsPassArg)
+					== ret.end())
+	{
+		return ret;
+	}
+
+	auto pr = std::find(ret.begin(), ret.end(), ParamReturnPassArg);
+	if (pr != ret.end())
+	{
+		ret.insert(pr, UnreachableFuncsPassArg);
+	}
+	return ret;
+}
+
+/**
+ * Add the TargetLibraryInfo pass for @a module to @a pm.
+ */
+template <typename PassManager>
+void addTargetLibraryInfo(PassManager& pm, llvm::Module& module)
+{
 	// Without this LLVM does more opts than we would like it to.
 	// e.g. printf() call -> puts() call
 	//
 	// Add an appropriate TargetLibraryInfo pass for the module's triple.
-	Triple ModuleTriple(module->getTargetTriple());
+	Triple ModuleTriple(module.getTargetTriple());
 	TargetLibraryInfoImpl TLII(ModuleTriple);
 	// The -disable-simplify-libcalls flag actually disables all builtin optzns.
 	TLII.disableAllFunctions();
 	pm.add(new TargetLibraryInfoWrapperPass(TLII));
+}
 
-	for (auto& p : config.parameters.llvmPasses)
+/**
+ * Run @a passes only over @a functions of @a module.
+ *
+ * Function passes (including loop passes and immutable analyses) are grouped
+ * into segments, which are run by a function pass manager over the given
+ * functions one by one. Module passes in between the segments are run over
+ * the whole module. If such a pass changes the context of the functions
+ * (see @c getContextFingerprint()), the following segments are run over all
+ * the functions.
+ */
+void runPassesOnFunctions(
+		llvm::Module& module,
+		const std::vector<std::string>& passes,
+		std::vector<llvm::Function*> functions,
+		PassProfiler* profiler)
+{
+	auto& passRegistry = initializeLlvmPasses();
+
+	std::size_t i = 0;
+	while (i < passes.size())
 	{
-		if (auto* info = passRegistry.getPassInfo(p))
+		utils::throwIfCancellationRequested();
+		utils::startCancellationPhase();
+		bin2llvmir::ReachingDefinitionsProvider::invalidate(&module);
+
+		auto* info = passRegistry.getPassInfo(passes[i]);
+		auto* pass = info->createPass();
+
+		if (pass->getPassKind() == PT_Module && !pass->getAsImmutablePass())
 		{
-			auto* pass = info->createPass();
-			addPass(pm, pass, info);
+			auto context = getContextFingerprint(module);
+
+			llvm::legacy::PassManager pm;
+			addTargetLibraryInfo(pm, module);
+			addPass(pm, pass, info, profiler);
+			pm.run(module);
+			++i;
+
+			if (getContextFingerprint(module) != context)
+			{
+				functions = getDefinedFunctions(module);
+			}
+			continue;
+		}
 
-			if (info->getTypeInfo() == &bin2llvmir::ProviderInitialization::ID)
+		llvm::legacy::FunctionPassManager fpm(&module);
+		addTargetLibraryInfo(fpm, module);
+		std::string segment;
+		for (;;)
+		{
+			fpm.add(pass);
+			segment += (segment.empty() ? "" : ",") + passes[i];
+			if (++i == passes.size())
 			{
-				auto* p = static_cast<bin2llvmir::ProviderInitialization*>(pass);
-				p->setConfig(&config);
+				break;
 			}
-			if (info->getTypeInfo() == &llvmir2hll::LlvmIr2Hll::ID)
+			info = passRegistry.getPassInfo(passes[i]);
+			pass = info->createPass();
+			if (pass->getPassKind() == PT_Module && !pass->getAsImmutablePass())
 			{
-				auto* p = static_cast<llvmir2hll::LlvmIr2Hll*>(pass);
-				p->setConfig(&config);
-				p->setOutputString(outString);
+				// It is created again by the next iteration.
+				delete pass;
+				break;
 			}
 		}
-		else
+
+		if (profiler)
+		{
+			profiler->start("Function passes", segment, module);
+		}
+		RETDEC_TRACE_BEGIN(utils::instrumentation::intern(segment));
+		fpm.doInitialization();
+		for (auto* f : functions)
 		{
-			throw std::runtime_error("cannot create pass: " + p);
+			RETDEC_SCOPED_TIMER_VAR(timer, "passes.function");
+			RETDEC_TIMER_ARG(timer, "function", f->getName().str());
+			RETDEC_TIMER_ARG(timer, "instructions",
+					std::uint64_t(f->getInstructionCount()));
+			fpm.run(*f);
+		}
+		fpm.doFinalization();
+		RETDEC_TRACE_END();
+		if (profiler)
+		{
+			profiler->stop(module);
+			profiler->addCounter("functions", functions.size());
 		}
 	}
+}
 
-	// Now that we have all of the passes ready, run them.
-	pm.run(*module);
+/**
+ * Run passes of @a group over @a module.
+ *
+ * Repeated groups are run again until they do not change the module, but at
+ * most @c PassGroup::maxRuns times. Every further run is restricted to the
+ * functions changed by the previous run: the passes are deterministic, so
+ * they would not change the other functions again anyway.
+ */
+void runPassGroup(
+		retdec::config::Config& config,
+		llvm::Module& module,
+		const PassGroup& group,
+		PassProfiler* profiler,
+		const std::uint8_t* inputData,
+		std::size_t inputDataSize,
+		std::string* outString)
+{
+	if (group.passes.empty())
+	{
+		return;
+	}
+
+	auto& passRegistry = initializeLlvmPasses();
+
+	// Create a PassManager to hold and optimize the collection of passes we
+	// are about to build.
+	llvm::legacy::PassManager pm;
+	addTargetLibraryInfo(pm, module);
+
+	for (auto& p : group.passes)
+	{
+		auto* info = passRegistry.getPassInfo(p);
+		auto* pass = info->createPass();
+		addPass(pm, pass, info, profiler);
+
+		if (info->getTypeInfo() == &bin2llvmir::ProviderInitialization::ID)
+		{
+			auto* p = static_cast<bin2llvmir::ProviderInitialization*>(pass);
+			p->setConfig(&config);
+			p->setInputData(inputData, inputDataSize);
+		}
+		if (info->getTypeInfo() == &llvmir2hll::LlvmIr2Hll::ID)
+		{
+			auto* p = static_cast<llvmir2hll::LlvmIr2Hll*>(pass);
+			p->setConfig(&config);
+			p->setOutputString(outString);
+		}
+	}
+
+	if (group.maxRuns == 1)
+	{
+		pm.run(module);
+		return;
+	}
+
+	ModuleFingerprint before(module);
+	pm.run(module);
+	for (unsigned run = 1; ; ++run)
+	{
+		ModuleFingerprint after(module);
+		auto changed = getChangedFunctions(module, before, after);
+		Log::phase(
+				"repeated passes: run " + std::to_string(run) + " changed "
+						+ std::to_string(changed.size()) + " function(s)",
+				Log::SubPhase);
+		if (changed.empty() || run == group.maxRuns)
+		{
+			break;
+		}
+
+		before = std::move(after);
+		runPassesOnFunctions(module, group.passes, changed, profiler);
+	}
+}
+
+/**
+ * Run @a passes over @a module.
+ */
+bool runPasses(
+		retdec::config::Config& config,
+		llvm::Module& module,
+		const std::vector<std::string>& passes,
+		const std::uint8_t* inputData,
+		std::size_t inputDataSize,
+		std::string* outString)
+{
+	auto groups = splitPassGroups(addEarlyUnreachableFuncs(config, passes));
+
+	// Fail before anything is run.
+	auto& passRegistry = initializeLlvmPasses();
+	for (auto& group : groups)
+	{
+		for (auto& p : group.passes)
+		{
+			if (passRegistry.getPassInfo(p) == nullptr)
+			{
+				throw std::runtime_error("cannot create pass: " + p);
+			}
+		}
+	}
+
+	std::unique_ptr<PassProfiler> profiler;
+	auto& profileOutFile = config.parameters.getProfileOutFile();
+	if (!profileOutFile.empty())
+	{
+		profiler = std::make_unique<PassProfiler>();
+	}
+
+	// Output writers may still run on background threads when the passes
+	// end, they have to finish even if some pass failed.
+	try
+	{
+		for (auto& group : groups)
+		{
+			runPassGroup(
+					config,
+					module,
+					group,
+					profiler.get(),
+					inputData,
+					inputDataSize,
+					outString);
+		}
+	}
+	catch (...)
+	{
+		try
+		{
+			bin2llvmir::AsyncWriters::wait();
+		}
+		catch (...)
+		{
+			// The original failure is reported.
+		}
+		throw;
+	}
+	bin2llvmir::AsyncWriters::wait();
+
+	if (profiler && !profiler->write(profileOutFile))
+	{
+		Log::error() << Log::Warning << "failed to write profile into: "
+				<< profileOutFile << std::endl;
+	}
 
 	return EXIT_SUCCESS;
 }
 
+/**
+ * Fill the outputs of a decompilation of @a module other than the HLL code
+ * into @a result.
+ */
+void fillResult(llvm::Module& module, bool llvmIr, DecompilationResult* result)
+{
+	if (auto* c = bin2llvmir::ConfigProvider::getConfig(&module))
+	{
+		result->config = c->getConfig().generateJsonString();
+	}
+
+	if (llvmIr)
+	{
+		llvm::raw_string_ostream os(result->llvmIr);
+		bool ShouldPreserveUseListOrder = true;
+		module.print(os, nullptr, ShouldPreserveUseListOrder);
+		os.flush();
+	}
+}
+
+/**
+ * Disable all outputs of @a config written into files, including logs and
+ * caches.
+ */
+void clearOutputFiles(retdec::config::Config& config)
+{
+	auto& params = config.parameters;
+	params.setOutputFile(std::string());
+	params.setOutputBitcodeFile(std::string());
+	params.setOutputAsmFile(std::string());
+	params.setOutputLlvmirFile(std::string());
+	params.setOutputConfigFile(std::string());
+	params.setOutputUnpackedFile(std::string());
+	params.setProfileOutFile(std::string());
+	params.setLogFile(std::string());
+	params.setErrFile(std::string());
+	params.setStaticCodeCacheDirectory(std::string());
+	params.setBackendFuncCacheDirectory(std::string());
+	params.setIsBackendEmitCfg(false);
+	params.setIsBackendEmitCg(false);
+}
+
+bool decompileImpl(
+		retdec::config::Config& config,
+		const std::uint8_t* inputData,
+		std::size_t inputDataSize,
+		std::string* outString,
+		DecompilationResult* result = nullptr,
+		bool llvmIr = false)
+{
+	setLogsFrom(config.parameters);
+
+	Log::phase("Initialization");
+
+	// limitMaximalMemoryIfRequested(params);
+	// PrintAfterAll = true;
+
+	auto context = std::make_unique<llvm::LLVMContext>();
+	auto module = createLlvmModule(*context);
+
+	auto ret = runPasses(
+			config,
+			*module,
+			config.parameters.llvmPasses,
+			inputData,
+			inputDataSize,
+			outString);
+
+	if (result)
+	{
+		fillResult(*module, llvmIr, result);
+	}
+
+	return ret;
+}
+
+} // anonymous namespace
+
+bool decompile(retdec::config::Config& config, std::string* outString)
+{
+	return decompileImpl(config, nullptr, 0, outString);
+}
+
+bool decompile(
+		retdec::config::Config& config,
+		const std::vector<std::uint8_t>& inputData,
+		std::string* outString)
+{
+	return decompileImpl(
+			config,
+			inputData.data(),
+			inputData.size(),
+			outString);
+}
+
+bool decompile(
+		retdec::config::Config& config,
+		const std::uint8_t* data,
+		std::size_t size,
+		std::string* outString)
+{
+	return decompileImpl(config, data, size, outString);
+}
+
+bool decompile(
+		const retdec::config::Config& config,
+		const std::uint8_t* data,
+		std::size_t size,
+		DecompilationResult* result,
+		bool llvmIr)
+{
+	if (result == nullptr)
+	{
+		throw std::runtime_error("decompilation result not set");
+	}
+	// Without data, the input file would be read.
+	if (data == nullptr || size == 0)
+	{
+		throw std::runtime_error("empty input data");
+	}
+
+	auto c = config;
+	clearOutputFiles(c);
+	if (llvmIr)
+	{
+		// The backend would release function bodies before they are printed.
+		c.parameters.setIsBackendReleaseLlvmIr(false);
+	}
+	*result = DecompilationResult();
+	return decompileImpl(c, data, size, &result->hll, result, llvmIr);
+}
+
+bool decompile(
+		const retdec::config::Config& config,
+		std::istream& input,
+		DecompilationResult* result,
+		bool llvmIr)
+{
+	std::vector<std::uint8_t> data(
+			(std::istreambuf_iterator<char>(input)),
+			std::istreambuf_iterator<char>());
+	return decompile(config, data.data(), data.size(), result, llvmIr);
+}
+
+bool decompileBitcode(
+		retdec::config::Config& config,
+		const std::string& bitcodeFile,
+		std::string* outString,
+		const std::map<std::string, std::string>& renames)
+{
+	setLogsFrom(config.parameters);
+
+	Log::phase("Initialization");
+
+	auto& passes = config.parameters.llvmPasses;
+	auto writer = std::find(passes.rbegin(), passes.rend(), BitcodeWriterPassArg);
+	if (writer == passes.rend())
+	{
+		throw std::runtime_error(
+				"cannot resume decompilation without pass: "
+				+ BitcodeWriterPassArg
+		);
+	}
+	std::vector<std::string> remaining(writer.base(), passes.end());
+
+	auto context = std::make_unique<llvm::LLVMContext>();
+	llvm::SMDiagnostic err;
+	auto module = llvm::parseIRFile(bitcodeFile, err, *context);
+	if (module == nullptr)
+	{
+		throw std::runtime_error("failed to load bitcode: " + bitcodeFile);
+	}
+
+	for (auto& r : renames)
+	{
+		if (auto* f = module->getFunction(r.first))
+		{
+			f->setName(r.second);
+		}
+	}
+
+	// The bitcode may be of a decompilation of the whole input. Selecting
+	// again what was already selected does not change anything.
+	if (config.parameters.isSomethingSelected())
+	{
+		remaining.insert(remaining.begin(), SelectFunctionsPassArg);
+	}
+
+	return runPasses(config, *module, remaining, nullptr, 0, outString);
+}
+
+void splitBitcode(
+		const std::string& bitcodeFile,
+		const std::vector<std::string>& shardFiles)
+{
+	if (shardFiles.empty())
+	{
+		throw std::runtime_error("no shards to split bitcode into");
+	}
+
+	auto context = std::make_unique<llvm::LLVMContext>();
+	llvm::SMDiagnostic err;
+	auto module = llvm::parseIRFile(bitcodeFile, err, *context);
+	if (module == nullptr)
+	{
+		throw std::runtime_error("failed to load bitcode: " + bitcodeFile);
+	}
+
+	auto funcs = getDefinedFunctions(*module);
+	std::size_t total = 0;
+	for (auto* f : funcs)
+	{
+		total += f->getInstructionCount();
+	}
+
+	// A function goes into the shard in which its first instruction would be
+	// if the instructions were split evenly.
+	std::map<const llvm::Function*, std::size_t> shards;
+	std::size_t preceding = 0;
+	for (auto* f : funcs)
+	{
+		shards[f] = total == 0
+				? 0
+				: std::min(
+						preceding * shardFiles.size() / total,
+						shardFiles.size() - 1);
+		preceding += f->getInstructionCount();
+	}
+
+	for (std::size_t i = 0; i < shardFiles.size(); ++i)
+	{
+		llvm::ValueToValueMapTy vmap;
+		auto shard = llvm::CloneModule(
+				*module,
+				vmap,
+				[&shards, i](const llvm::GlobalValue* gv)
+				{
+					auto* f = llvm::dyn_cast<llvm::Function>(gv);
+					return f == nullptr || shards[f] == i;
+				}
+		);
+
+		std::error_code ec;
+		llvm::raw_fd_ostream out(shardFiles[i], ec, llvm::sys::fs::F_None);
+		if (ec)
+		{
+			throw std::runtime_error(
+					"failed to write bitcode shard: " + shardFiles[i]
+			);
+		}
+		bool ShouldPreserveUseListOrder = true;
+		llvm::WriteBitcodeToFile(*shard, out, ShouldPreserveUseListOrder);
+	}
+}
+
 } // namespace retdec
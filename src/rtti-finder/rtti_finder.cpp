@@ -12,21 +12,23 @@ namespace retdec {
 namespace rtti_finder {
 
 /**
- * Find GCC/Clang C++ vtables and RTTI from file.
+ * Find GCC/Clang C++ vtables and RTTI from file, data segments are searched
+ * on @a threads threads.
  * Fill @c _vtablesGcc and @c __rttiGcc;
  */
-void RttiFinder::findGcc(const retdec::loader::Image* img)
+void RttiFinder::findGcc(const retdec::loader::Image* img, unsigned threads)
 {
-	findGccVtables(img, _vtablesGcc, _rttiGcc);
+	findGccVtables(img, _vtablesGcc, _rttiGcc, threads);
 }
 
 /**
- * Find MSVC C++ vtables and RTTI from file.
+ * Find MSVC C++ vtables and RTTI from file, data segments are searched on
+ * @a threads threads.
  * Fill @c vtablesMsvc and @c _rttiMsvc.
  */
-void RttiFinder::findMsvc(const retdec::loader::Image* img)
+void RttiFinder::findMsvc(const retdec::loader::Image* img, unsigned threads)
 {
-	findMsvcVtables(img, _vtablesMsvc, _rttiMsvc);
+	findMsvcVtables(img, _vtablesMsvc, _rttiMsvc, threads);
 }
 
 /**
@@ -4,12 +4,14 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
 #include <iostream>
 
 #include "retdec/loader/loader/image.h"
 #include "retdec/rtti-finder/rtti/rtti_gcc_parser.h"
 #include "retdec/rtti-finder/rtti/rtti_msvc_parser.h"
 #include "retdec/rtti-finder/vtable/vtable_finder.h"
+#include "retdec/utils/parallel.h"
 
 #define LOG \
 	if (!debug_enabled) {} \
@@ -67,6 +69,201 @@ void findPossibleVtables(
 	}
 }
 
+/**
+ * Sorted address ranges of segments that pointers may point to, i.e. ranges
+ * with @c Image::hasDataOnAddress().
+ */
+using DataRanges = std::vector<std::pair<std::uint64_t, std::uint64_t>>;
+
+bool isInDataRanges(const DataRanges& ranges, std::uint64_t val)
+{
+	if (ranges.empty()
+			|| val < ranges.front().first
+			|| val >= ranges.back().second)
+	{
+		return false;
+	}
+
+	auto it = std::upper_bound(
+			ranges.begin(),
+			ranges.end(),
+			val,
+			[](std::uint64_t v, const std::pair<std::uint64_t, std::uint64_t>& r)
+			{
+				return v < r.first;
+			});
+	return it != ranges.begin() && val < (--it)->second;
+}
+
+/**
+ * Same as @c findPossibleVtables() for segment @a seg, but it reads words
+ * directly from the segment's data. All the words of the segment are first
+ * checked for being pointers in one pass, the search then uses only these
+ * results. It must be used only if segments do not overlap, @a ranges are
+ * ranges of their data, and bytes have 8 bits.
+ */
+void findPossibleVtablesInSegment(
+		const retdec::loader::Image* img,
+		const retdec::loader::Segment* seg,
+		const DataRanges& ranges,
+		bool gcc,
+		std::vector<retdec::common::Address>& possibleVtables)
+{
+	const std::size_t wordSz = img->getBytesPerWord();
+	const bool little = img->isLittleEndian();
+	const auto size = seg->getSize();
+	const std::size_t words = size / wordSz;
+	auto raw = seg->getRawData();
+	const std::size_t physWords = raw.first ? raw.second / wordSz : 0;
+	const bool partialWord = raw.first && raw.second % wordSz;
+	const std::size_t readWords = std::min(
+			words,
+			physWords + (partialWord ? 1 : 0));
+
+	std::vector<std::uint8_t> isZero(readWords);
+	std::vector<std::uint8_t> isPtr(readWords);
+	for (std::size_t i = 0; i < physWords; ++i)
+	{
+		const std::uint8_t* b = raw.first + i * wordSz;
+		std::uint64_t val = 0;
+		for (std::size_t k = 0; k < wordSz; ++k)
+		{
+			val |= static_cast<std::uint64_t>(b[k])
+					<< (8 * (little ? k : wordSz - k - 1));
+		}
+		isZero[i] = val == 0;
+		isPtr[i] = isInDataRanges(ranges, val);
+	}
+	if (physWords < readWords)
+	{
+		std::uint64_t val = 0;
+		img->getWord(seg->getAddress() + physWords * wordSz, val);
+		isZero[physWords] = val == 0;
+		isPtr[physWords] = isInDataRanges(ranges, val);
+	}
+
+	// Words behind the physical data are zeros, items behind the segment are
+	// read from the image.
+	//
+	const bool zeroIsPtr = isInDataRanges(ranges, 0);
+	auto isPointer = [&](std::size_t i) -> bool
+	{
+		if (i < readWords)
+		{
+			return isPtr[i];
+		}
+		return i < words
+				? zeroIsPtr
+				: img->isPointer(seg->getAddress() + i * wordSz);
+	};
+
+	std::size_t i = 0;
+	while ((i + 1) * wordSz < size)
+	{
+		if (i >= readWords && !zeroIsPtr && i + 2 < words)
+		{
+			// Nothing but zeros up to the segment end.
+			i = words - 2;
+			continue;
+		}
+
+		if (i >= words
+				|| (gcc && i < readWords && !isZero[i])
+				|| !isPointer(i + 1)
+				|| !isPointer(i + 2))
+		{
+			++i;
+			continue;
+		}
+
+		possibleVtables.push_back(seg->getAddress() + (i + 2) * wordSz);
+		i += 2;
+	}
+}
+
+/**
+ * Find possible vtables in all the data segments of @a img in parallel, on
+ * @a threads threads. The result is the same as of @c findPossibleVtables(),
+ * to which this falls back if segments overlap, or if bytes are not 8 bits
+ * long.
+ */
+void findPossibleVtables(
+		const retdec::loader::Image* img,
+		std::set<retdec::common::Address>& possibleVtables,
+		bool gcc,
+		unsigned threads)
+{
+	std::vector<const retdec::loader::Segment*> segs;
+	for (auto& seg : img->getSegments())
+	{
+		segs.push_back(seg.get());
+	}
+	std::sort(segs.begin(), segs.end(), [](auto* s1, auto* s2)
+	{
+		return s1->getAddress() < s2->getAddress();
+	});
+
+	bool overlap = false;
+	DataRanges ranges;
+	for (std::size_t i = 0; i < segs.size(); ++i)
+	{
+		auto* seg = segs[i];
+		if (i > 0 && seg->getAddress() < segs[i-1]->getEndAddress())
+		{
+			overlap = true;
+			break;
+		}
+		if (seg->getSecSeg() && !seg->getSecSeg()->isDebug())
+		{
+			if (!ranges.empty() && ranges.back().second == seg->getAddress())
+			{
+				ranges.back().second = seg->getEndAddress();
+			}
+			else
+			{
+				ranges.emplace_back(seg->getAddress(), seg->getEndAddress());
+			}
+		}
+	}
+
+	auto wordSz = img->getBytesPerWord();
+	if (overlap
+			|| img->getByteLength() != 8
+			|| wordSz == 0
+			|| wordSz > sizeof(std::uint64_t)
+			|| !(img->isLittleEndian() || img->isBigEndian()))
+	{
+		findPossibleVtables(img, possibleVtables, gcc);
+		return;
+	}
+
+	std::vector<const retdec::loader::Segment*> dataSegs;
+	for (auto* seg : segs)
+	{
+		if (seg->getSecSeg() == nullptr || seg->getSecSeg()->isSomeData())
+		{
+			dataSegs.push_back(seg);
+		}
+	}
+
+	std::vector<std::vector<retdec::common::Address>> segVtables(
+			dataSegs.size());
+	parallelFor(dataSegs.size(), threads, [&](std::size_t i)
+	{
+		findPossibleVtablesInSegment(
+				img,
+				dataSegs[i],
+				ranges,
+				gcc,
+				segVtables[i]);
+	});
+
+	for (auto& vts : segVtables)
+	{
+		possibleVtables.insert(vts.begin(), vts.end());
+	}
+}
+
 /**
  * @return @c True if vtable ok and can be used, @c false if it should
  * be thrown away.
@@ -145,10 +342,11 @@ bool fillVtable(
 void retdec::rtti_finder::findGccVtables(
 		const retdec::loader::Image* img,
 		retdec::rtti_finder::VtablesGcc& vtables,
-		retdec::rtti_finder::RttiGcc& rttis)
+		retdec::rtti_finder::RttiGcc& rttis,
+		unsigned threads)
 {
 	std::set<retdec::common::Address> possibleVtables;
-	findPossibleVtables(img, possibleVtables, true);
+	findPossibleVtables(img, possibleVtables, true, threads);
 
 	std::set<retdec::common::Address> processedAddresses;
 	for (auto addr : possibleVtables)
@@ -195,10 +393,11 @@ void retdec::rtti_finder::findGccVtables(
 void retdec::rtti_finder::findMsvcVtables(
 		const retdec::loader::Image* img,
 		retdec::rtti_finder::VtablesMsvc& vtables,
-		retdec::rtti_finder::RttiMsvc& rttis)
+		retdec::rtti_finder::RttiMsvc& rttis,
+		unsigned threads)
 {
 	std::set<retdec::common::Address> possibleVtables;
-	findPossibleVtables(img, possibleVtables, false);
+	findPossibleVtables(img, possibleVtables, false, threads);
 
 	std::set<retdec::common::Address> processedAddresses;
 	for (auto addr : possibleVtables)
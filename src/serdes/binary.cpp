@@ -0,0 +1,499 @@
+/**
+ * @file src/serdes/binary.cpp
+ * @brief Compact binary (de)serialization format.
+ * @copyright (c) 2019 Avast Software, licensed under the MIT license
+ */
+
+#include <cstring>
+#include <utility>
+
+#include "retdec/serdes/binary.h"
+
+namespace {
+
+const char BINARY_MAGIC[] = {'R', 'D', 'C', 'B'};
+const std::size_t BINARY_HEADER_SIZE = sizeof(BINARY_MAGIC) + 4;
+
+const uint8_t TAG_NULL         = 0x00;
+const uint8_t TAG_FALSE        = 0x01;
+const uint8_t TAG_TRUE         = 0x02;
+const uint8_t TAG_INT          = 0x03; // zigzag varint
+const uint8_t TAG_UINT         = 0x04; // varint
+const uint8_t TAG_DOUBLE       = 0x05; // 8 bytes, little endian
+const uint8_t TAG_STRING       = 0x06; // varint length + bytes
+const uint8_t TAG_NEW_KEY      = 0x07; // varint length + bytes
+const uint8_t TAG_KEY_REF      = 0x08; // varint number of key
+const uint8_t TAG_OBJECT_START = 0x09;
+const uint8_t TAG_OBJECT_END   = 0x0a;
+const uint8_t TAG_ARRAY_START  = 0x0b;
+const uint8_t TAG_ARRAY_END    = 0x0c;
+
+/**
+ * Reader of the binary format, generator of SAX events for
+ * @c rapidjson::Document::Populate().
+ */
+class BinaryReader
+{
+	public:
+		BinaryReader(const char* data, std::size_t size)
+			: _pos(reinterpret_cast<const uint8_t*>(data))
+			, _end(_pos + size)
+		{
+		}
+
+		template <typename Handler>
+		bool operator()(Handler& handler);
+
+	private:
+		struct Container
+		{
+			bool isObject = false;
+			bool expectKey = false;
+			rapidjson::SizeType count = 0;
+		};
+
+	private:
+		bool readByte(uint8_t& b);
+		bool readVarUint(uint64_t& u);
+		bool readBytes(std::size_t size, const char*& data);
+
+	private:
+		const uint8_t* _pos = nullptr;
+		const uint8_t* _end = nullptr;
+		/// Object keys in the order of their first occurrence.
+		std::vector<std::pair<const char*, rapidjson::SizeType>> _keys;
+};
+
+bool BinaryReader::readByte(uint8_t& b)
+{
+	if (_pos == _end)
+	{
+		return false;
+	}
+	b = *_pos++;
+	return true;
+}
+
+bool BinaryReader::readVarUint(uint64_t& u)
+{
+	u = 0;
+	for (unsigned shift = 0; shift < 64; shift += 7)
+	{
+		uint8_t b = 0;
+		if (!readByte(b))
+		{
+			return false;
+		}
+		u |= uint64_t(b & 0x7f) << shift;
+		if ((b & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool BinaryReader::readBytes(std::size_t size, const char*& data)
+{
+	if (size > std::size_t(_end - _pos))
+	{
+		return false;
+	}
+	data = reinterpret_cast<const char*>(_pos);
+	_pos += size;
+	return true;
+}
+
+/**
+ * Send all the values of the data to the given handler.
+ * @return @c true if the data hold exactly one complete value, @c false
+ *         otherwise.
+ */
+template <typename Handler>
+bool BinaryReader::operator()(Handler& handler)
+{
+	std::vector<Container> containers;
+	bool root = false;
+
+	while (!root || !containers.empty())
+	{
+		uint8_t tag = 0;
+		if (!readByte(tag))
+		{
+			return false;
+		}
+
+		if (!containers.empty() && containers.back().expectKey)
+		{
+			auto& c = containers.back();
+			if (tag == TAG_OBJECT_END)
+			{
+				auto count = c.count;
+				containers.pop_back();
+				if (!handler.EndObject(count))
+				{
+					return false;
+				}
+			}
+			else if (tag == TAG_NEW_KEY)
+			{
+				uint64_t size = 0;
+				const char* str = nullptr;
+				if (!readVarUint(size) || !readBytes(size, str))
+				{
+					return false;
+				}
+				_keys.emplace_back(str, rapidjson::SizeType(size));
+				c.expectKey = false;
+				if (!handler.Key(str, rapidjson::SizeType(size), true))
+				{
+					return false;
+				}
+				continue;
+			}
+			else if (tag == TAG_KEY_REF)
+			{
+				uint64_t id = 0;
+				if (!readVarUint(id) || id >= _keys.size())
+				{
+					return false;
+				}
+				c.expectKey = false;
+				auto& key = _keys[id];
+				if (!handler.Key(key.first, key.second, true))
+				{
+					return false;
+				}
+				continue;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		else if (tag == TAG_OBJECT_START)
+		{
+			if (!handler.StartObject())
+			{
+				return false;
+			}
+			Container c;
+			c.isObject = true;
+			c.expectKey = true;
+			containers.push_back(c);
+			continue;
+		}
+		else if (tag == TAG_ARRAY_START)
+		{
+			if (!handler.StartArray())
+			{
+				return false;
+			}
+			containers.push_back(Container());
+			continue;
+		}
+		else if (tag == TAG_ARRAY_END)
+		{
+			if (containers.empty() || containers.back().isObject)
+			{
+				return false;
+			}
+			auto count = containers.back().count;
+			containers.pop_back();
+			if (!handler.EndArray(count))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			bool ok = false;
+			uint64_t u = 0;
+			const char* str = nullptr;
+			switch (tag)
+			{
+				case TAG_NULL:
+					ok = handler.Null();
+					break;
+				case TAG_FALSE:
+					ok = handler.Bool(false);
+					break;
+				case TAG_TRUE:
+					ok = handler.Bool(true);
+					break;
+				case TAG_INT:
+					ok = readVarUint(u)
+							&& handler.Int64(int64_t(u >> 1) ^ -int64_t(u & 1));
+					break;
+				case TAG_UINT:
+					ok = readVarUint(u) && handler.Uint64(u);
+					break;
+				case TAG_DOUBLE:
+				{
+					uint64_t bits = 0;
+					for (unsigned i = 0; i < 8; ++i)
+					{
+						uint8_t b = 0;
+						if (!readByte(b))
+						{
+							return false;
+						}
+						bits |= uint64_t(b) << (8 * i);
+					}
+					double d = 0.0;
+					std::memcpy(&d, &bits, sizeof(d));
+					ok = handler.Double(d);
+					break;
+				}
+				case TAG_STRING:
+					ok = readVarUint(u)
+							&& readBytes(u, str)
+							&& handler.String(str, rapidjson::SizeType(u), true);
+					break;
+				default:
+					break;
+			}
+			if (!ok)
+			{
+				return false;
+			}
+		}
+
+		// A complete value was read.
+		if (containers.empty())
+		{
+			root = true;
+		}
+		else
+		{
+			auto& c = containers.back();
+			++c.count;
+			c.expectKey = c.isObject;
+		}
+	}
+
+	return _pos == _end;
+}
+
+} // anonymous namespace
+
+namespace retdec {
+namespace serdes {
+
+/**
+ * Create writer writing the binary format into the given stream. The header
+ * of the format is written immediately.
+ */
+BinaryWriter::BinaryWriter(std::ostream& out) :
+		_out(out)
+{
+	writeBytes(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+	for (unsigned i = 0; i < 4; ++i)
+	{
+		_out.put(char((BINARY_FORMAT_VERSION >> (8 * i)) & 0xff));
+	}
+}
+
+bool BinaryWriter::Null()
+{
+	return writeValue(TAG_NULL);
+}
+
+bool BinaryWriter::Bool(bool b)
+{
+	return writeValue(b ? TAG_TRUE : TAG_FALSE);
+}
+
+bool BinaryWriter::Int(int i)
+{
+	return Int64(i);
+}
+
+bool BinaryWriter::Uint(unsigned u)
+{
+	return Uint64(u);
+}
+
+bool BinaryWriter::Int64(int64_t i)
+{
+	writeValue(TAG_INT);
+	writeVarUint((uint64_t(i) << 1) ^ uint64_t(i >> 63));
+	return _out.good();
+}
+
+bool BinaryWriter::Uint64(uint64_t u)
+{
+	writeValue(TAG_UINT);
+	writeVarUint(u);
+	return _out.good();
+}
+
+bool BinaryWriter::Double(double d)
+{
+	uint64_t bits = 0;
+	std::memcpy(&bits, &d, sizeof(bits));
+	writeValue(TAG_DOUBLE);
+	for (unsigned i = 0; i < 8; ++i)
+	{
+		_out.put(char((bits >> (8 * i)) & 0xff));
+	}
+	return _out.good();
+}
+
+/**
+ * Write string. If an object key is expected, the string is written as the
+ * key, as rapidjson writers do.
+ */
+bool BinaryWriter::String(
+		const char* str,
+		rapidjson::SizeType length,
+		bool /*copy*/)
+{
+	if (!_containers.empty() && _containers.back() == State::OBJECT_KEY)
+	{
+		return writeKey(str, length);
+	}
+
+	writeValue(TAG_STRING);
+	writeVarUint(length);
+	writeBytes(str, length);
+	return _out.good();
+}
+
+bool BinaryWriter::String(const char* str)
+{
+	return String(str, rapidjson::SizeType(std::strlen(str)));
+}
+
+bool BinaryWriter::String(const std::string& str)
+{
+	return String(str.data(), rapidjson::SizeType(str.size()));
+}
+
+bool BinaryWriter::Key(const char* str, rapidjson::SizeType length, bool copy)
+{
+	return String(str, length, copy);
+}
+
+bool BinaryWriter::StartObject()
+{
+	writeValue(TAG_OBJECT_START);
+	_containers.push_back(State::OBJECT_KEY);
+	return _out.good();
+}
+
+bool BinaryWriter::EndObject(rapidjson::SizeType /*memberCount*/)
+{
+	_containers.pop_back();
+	_out.put(char(TAG_OBJECT_END));
+	return _out.good();
+}
+
+bool BinaryWriter::StartArray()
+{
+	writeValue(TAG_ARRAY_START);
+	_containers.push_back(State::ARRAY);
+	return _out.good();
+}
+
+bool BinaryWriter::EndArray(rapidjson::SizeType /*elementCount*/)
+{
+	_containers.pop_back();
+	_out.put(char(TAG_ARRAY_END));
+	return _out.good();
+}
+
+/**
+ * Write tag of a value and mark a value of the current object as written.
+ */
+bool BinaryWriter::writeValue(uint8_t tag)
+{
+	if (!_containers.empty() && _containers.back() == State::OBJECT_VALUE)
+	{
+		_containers.back() = State::OBJECT_KEY;
+	}
+	_out.put(char(tag));
+	return _out.good();
+}
+
+bool BinaryWriter::writeKey(const char* str, std::size_t length)
+{
+	_containers.back() = State::OBJECT_VALUE;
+
+	auto inserted = _keys.emplace(std::string(str, length), _keys.size());
+	if (inserted.second)
+	{
+		_out.put(char(TAG_NEW_KEY));
+		writeVarUint(length);
+		writeBytes(str, length);
+	}
+	else
+	{
+		_out.put(char(TAG_KEY_REF));
+		writeVarUint(inserted.first->second);
+	}
+	return _out.good();
+}
+
+void BinaryWriter::writeVarUint(uint64_t u)
+{
+	while (u >= 0x80)
+	{
+		_out.put(char((u & 0x7f) | 0x80));
+		u >>= 7;
+	}
+	_out.put(char(u));
+}
+
+void BinaryWriter::writeBytes(const char* data, std::size_t size)
+{
+	_out.write(data, size);
+}
+
+/**
+ * Check whether the given data start with the header of the binary format.
+ * The version of the format is not checked.
+ */
+bool isBinary(const char* data, std::size_t size)
+{
+	return size >= BINARY_HEADER_SIZE
+			&& std::memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+}
+
+/**
+ * Read data in the binary format into the given document.
+ * @param data Data starting with the header of the format.
+ * @param size Size of the data.
+ * @param doc Document to fill.
+ * @return @c true if the data were read, @c false if they are not in the
+ *         binary format of the current version or if they are malformed.
+ */
+bool readBinary(const char* data, std::size_t size, rapidjson::Document& doc)
+{
+	if (!isBinary(data, size))
+	{
+		return false;
+	}
+
+	uint32_t version = 0;
+	for (unsigned i = 0; i < 4; ++i)
+	{
+		version |= uint32_t(uint8_t(data[sizeof(BINARY_MAGIC) + i])) << (8 * i);
+	}
+	if (version != BINARY_FORMAT_VERSION)
+	{
+		return false;
+	}
+
+	BinaryReader reader(data + BINARY_HEADER_SIZE, size - BINARY_HEADER_SIZE);
+	bool ok = false;
+	auto generator = [&reader, &ok](rapidjson::Document& handler) {
+		ok = reader(handler);
+		return ok;
+	};
+	doc.Populate(generator);
+	return ok;
+}
+
+} // namespace serdes
+} // namespace retdec
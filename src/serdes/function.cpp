@@ -47,6 +47,7 @@ const std::string JSON_isExported    = "isExported";
 const std::string JSON_isVariadic    = "isVariadic";
 const std::string JSON_isThumb       = "isThumb";
 const std::string JSON_usedCrypto    = "usedCryptoConstants";
+const std::string JSON_degradations  = "degradations";
 const std::string JSON_basicBlocks   = "basicBlocks";
 
 std::vector<std::string> fncTypes =
@@ -104,6 +105,7 @@ void serialize(Writer& writer, const common::Function& f)
 	serializeContainer(writer, JSON_parameters, f.parameters);
 	serializeContainer(writer, JSON_basicBlocks, f.basicBlocks);
 	serializeContainer(writer, JSON_usedCrypto, f.usedCryptoConstants);
+	serializeContainer(writer, JSON_degradations, f.degradations);
 
 	writer.EndObject();
 }
@@ -155,6 +157,7 @@ void deserialize(const rapidjson::Value& val, common::Function& f)
 	deserializeContainer(val, JSON_locals, f.locals);
 	deserializeContainer(val, JSON_parameters, f.parameters);
 	deserializeContainer(val, JSON_usedCrypto, f.usedCryptoConstants);
+	deserializeContainer(val, JSON_degradations, f.degradations);
 	deserializeContainer(val, JSON_basicBlocks, f.basicBlocks);
 
 	std::string enumStr = deserializeString(val, JSON_fncType);
@@ -4,6 +4,7 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <fstream>
 #include <sstream>
 #include <string>
 
@@ -75,11 +76,58 @@ void selectSignaturesWithNames(
 	}
 }
 
+/**
+ * Name of the catalog of signature files in a signature directory. Each of
+ * its lines holds a hash of the file and the file path relative to the
+ * directory, separated by a tab.
+ */
+const std::string SIGNATURE_CATALOG = "catalog.txt";
+
+/**
+ * Add signature files listed in the catalog in directory @p dir.
+ * @return @c false if there is no usable catalog in the directory
+ */
+bool getCatalogSignatureFiles(
+		const fs::path& dir,
+		std::set<std::string>& signFiles,
+		const std::set<std::string>& suffixes)
+{
+	std::ifstream catalog(dir / SIGNATURE_CATALOG);
+	if (!catalog)
+	{
+		return false;
+	}
+
+	std::string line;
+	while (std::getline(catalog, line))
+	{
+		const auto tab = line.find('\t');
+		if (tab == std::string::npos)
+		{
+			continue;
+		}
+
+		const auto path = line.substr(tab + 1);
+		if (endsWith(path, suffixes))
+		{
+			signFiles.insert(fs::absolute(dir / path).string());
+		}
+	}
+
+	return true;
+}
+
 void getAllSignatureFiles(
 		const fs::path& fp,
 		std::set<std::string>& signFiles,
 		const std::set<std::string>& suffixes = {".yar", ".yara", ".yarac"})
 {
+	if (fs::is_directory(fp)
+			&& getCatalogSignatureFiles(fp, signFiles, suffixes))
+	{
+		return;
+	}
+
 	if (fs::is_regular_file(fp)
 			&& std::any_of(suffixes.begin(), suffixes.end(),
 			[&] (const auto &suffix)
@@ -695,6 +743,54 @@ const DetectedFunctionsPtrMap& Finder::getConfirmedDetections() const
 void Finder::search(
 	const Image& image,
 	const std::string& yaraFile)
+{
+	YaraDetector detector;
+	detector.setRulesCacheDirectory(_cacheDirectory);
+	detector.addRuleFile(yaraFile);
+	searchDetector(image, detector, yaraFile);
+}
+
+/**
+ * Search for static code in input file.
+ *
+ * @param image input file image
+ * @param yaraFiles static code signature files
+ */
+void Finder::search(
+	const retdec::loader::Image& image,
+	const std::set<std::string>& yaraFiles)
+{
+	// Text signature files are compiled together, so the input is scanned
+	// only once. Paths of the files are used as namespaces of their rules.
+	YaraDetector detector;
+	detector.setRulesCacheDirectory(_cacheDirectory);
+	for (const auto& f : yaraFiles)
+	{
+		// Precompiled files keep their own namespaces.
+		if (endsWith(f, ".yarac"))
+		{
+			search(image, f);
+		}
+		else
+		{
+			detector.addRuleFile(f, f);
+		}
+	}
+	searchDetector(image, detector, std::string());
+}
+
+/**
+ * Search for static code in input file by rules of the given detector.
+ *
+ * @param image input file image
+ * @param detector detector with added rules
+ * @param yaraFile signature file of all rules, if empty, namespaces of
+ *                 rules are used as their signature files
+ */
+void Finder::searchDetector(
+	const Image& image,
+	YaraDetector& detector,
+	const std::string& yaraFile)
 {
 	// Get FileFormat instance.
 	const auto* fileFormat = image.getFileFormat();
@@ -703,11 +799,30 @@ void Finder::search(
 		return;
 	}
 
-	// Start Yara detector.
-	YaraDetector detector;
-	detector.addRuleFile(yaraFile);
-	auto inputBytes = fileFormat->getLoadedBytes();
-	detector.analyze(inputBytes);
+	// Code is searched only in code segments, straight in their bytes.
+	// If segments do not tell what they contain, all of them are searched.
+	std::vector<YaraDetector::MemoryRegion> codeRegions;
+	std::vector<YaraDetector::MemoryRegion> allRegions;
+	for (const auto& seg : image.getSegments())
+	{
+		const auto rawData = seg->getRawData();
+		if (!rawData.first || !rawData.second)
+		{
+			continue;
+		}
+
+		const YaraDetector::MemoryRegion region = {
+				seg->getAddress(),
+				rawData.first,
+				static_cast<std::size_t>(rawData.second)};
+		allRegions.push_back(region);
+		const auto* secSeg = seg->getSecSeg();
+		if (!secSeg || secSeg->isSomeCode())
+		{
+			codeRegions.push_back(region);
+		}
+	}
+	detector.analyze(codeRegions.empty() ? allRegions : codeRegions);
 	if (!detector.isInValidState())
 	{
 		return;
@@ -717,7 +832,9 @@ void Finder::search(
 	for (const YaraRule &detectedRule : detector.getDetectedRules())
 	{
 		DetectedFunction detectedFunction;
-		detectedFunction.signaturePath = yaraFile;
+		detectedFunction.signaturePath = yaraFile.empty()
+				? detectedRule.getNamespace()
+				: yaraFile;
 
 		for (const YaraMeta &ruleMeta : detectedRule.getMetas())
 		{
@@ -750,14 +867,10 @@ void Finder::search(
 		for (const YaraMatch &ruleMatch : detectedRule.getMatches())
 		{
 			// This is different for every match.
-			detectedFunction.offset = ruleMatch.getOffset();
-			std::uint64_t address = 0;
-			if (!fileFormat->getAddressFromOffset(
-						address, detectedFunction.offset))
-			{
-				// Cannot get address. Maybe report error?
-				continue;
-			}
+			const std::uint64_t address = ruleMatch.getOffset();
+			std::uint64_t offset = 0;
+			detectedFunction.offset = fileFormat->getOffsetFromAddress(
+						offset, address) ? offset : 0;
 
 			// Store data.
 			detectedFunction.setAddress(address);
@@ -770,22 +883,6 @@ void Finder::search(
 	}
 }
 
-/**
- * Search for static code in input file.
- *
- * @param image input file image
- * @param yaraFiles static code signature files
- */
-void Finder::search(
-	const retdec::loader::Image& image,
-	const std::set<std::string>& yaraFiles)
-{
-	for (const auto& f : yaraFiles)
-	{
-		search(image, f);
-	}
-}
-
 /**
  * Search for static code in input file based on information in config file.
  *
@@ -797,6 +894,7 @@ void Finder::search(
 	const retdec::config::Config& config)
 {
 	auto sigPaths = selectSignaturePaths(image, config);
+	_cacheDirectory = config.parameters.getStaticCodeCacheDirectory();
 	search(image, sigPaths);
 }
 
@@ -913,6 +1011,9 @@ bool Finder::initDisassembler()
 
 void Finder::solveReferences()
 {
+	_refTargets.clear();
+	_importStubs_x86.clear();
+
 	for (auto& p : _allDetections)
 	{
 		bool modeSwitch = false;
@@ -930,7 +1031,14 @@ void Finder::solveReferences()
 
 		for (auto& r : p.second.references)
 		{
-			r.target = getAddressFromRef(r.address);
+			auto tIt = _refTargets.find({r.address, modeSwitch});
+			if (tIt == _refTargets.end())
+			{
+				tIt = _refTargets.emplace(
+						std::make_pair(r.address, modeSwitch),
+						getAddressFromRef(r.address)).first;
+			}
+			r.target = tIt->second;
 			checkRef(r);
 		}
 
@@ -1435,17 +1543,45 @@ void Finder::checkRef_x86(Reference& ref)
 		return;
 	}
 
-	uint64_t addr = ref.target;
-	ByteData bytes = _image->getRawSegmentData(ref.target);
-	if (cs_disasm_iter(_ce, &bytes.first, &bytes.second, &addr, _ceInsn))
+	auto sIt = _importStubs_x86.find(ref.target);
+	if (sIt == _importStubs_x86.end())
 	{
-		auto& x86 = _ceInsn->detail->x86;
+		sIt = _importStubs_x86.emplace(
+				ref.target,
+				getImportStubTarget_x86(ref.target)).first;
+	}
+	if (sIt->second.isUndefined())
+	{
+		return;
+	}
 
-		// Pattern: reference to stub function jumping to import:
-		//     _localeconv     proc near
-		//     FF 25 E0 B1 40 00        jmp ds:__imp__localeconv
-		//     _localeconv     endp
-		//
+	auto fIt = _imports.find(sIt->second);
+	if (fIt != _imports.end())
+	{
+		if (utils::contains(fIt->second, ref.name)
+				|| utils::contains(ref.name, fIt->second))
+		{
+			ref.ok = true;
+		}
+	}
+}
+
+/**
+ * Get memory operand of a stub function jumping to import at @p addr.
+ * Pattern:
+ *     _localeconv     proc near
+ *     FF 25 E0 B1 40 00        jmp ds:__imp__localeconv
+ *     _localeconv     endp
+ *
+ * @return Jump operand or undefined address if there is no such stub.
+ */
+common::Address Finder::getImportStubTarget_x86(common::Address addr)
+{
+	uint64_t a = addr;
+	ByteData bytes = _image->getRawSegmentData(addr);
+	if (cs_disasm_iter(_ce, &bytes.first, &bytes.second, &a, _ceInsn))
+	{
+		auto& x86 = _ceInsn->detail->x86;
 		if (_ceInsn->id == X86_INS_JMP
 				&& x86.op_count == 1
 				&& x86.operands[0].type == X86_OP_MEM
@@ -1455,19 +1591,11 @@ void Finder::checkRef_x86(Reference& ref)
 				&& x86.operands[0].mem.scale == 1
 				&& x86.operands[0].mem.disp)
 		{
-			auto fIt = _imports.find(x86.operands[0].mem.disp);
-			if (fIt != _imports.end())
-			{
-				if (utils::contains(fIt->second, ref.name)
-						|| utils::contains(ref.name, fIt->second))
-				{
-					ref.ok = true;
-				}
-
-				return;
-			}
+			return x86.operands[0].mem.disp;
 		}
 	}
+
+	return Address();
 }
 
 /**
@@ -19,7 +19,7 @@ namespace unpacker {
  * @param lp Property of LZMA.
  * @param lc Property of LZMA.
  */
-LzmaData::LzmaData(const DynamicBuffer& buffer, uint8_t pb, uint8_t lp, uint8_t lc) : CompressedData(buffer),
+LzmaData::LzmaData(DynamicBuffer buffer, uint8_t pb, uint8_t lp, uint8_t lc) : CompressedData(std::move(buffer)),
 		_readPos(0), _pb(pb), _lp(lp), _lc(lc), _rangeDecoder()
 {
 }
@@ -231,6 +231,11 @@ bool LzmaData::decompress(DynamicBuffer& outputBuffer)
 	return true;
 }
 
+bool LzmaData::isInputExhausted() const
+{
+	return _readPos >= _buffer.getRealDataSize();
+}
+
 bool LzmaData::decodeBit(uint32_t pos, uint32_t& bit)
 {
 	// Normalization
@@ -9,7 +9,7 @@
 namespace retdec {
 namespace unpacker {
 
-LzmatData::LzmatData(const DynamicBuffer& buffer) : CompressedData(buffer)
+LzmatData::LzmatData(DynamicBuffer buffer) : CompressedData(std::move(buffer))
 {
 }
 
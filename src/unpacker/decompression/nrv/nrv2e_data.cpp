@@ -10,7 +10,7 @@
 namespace retdec {
 namespace unpacker {
 
-Nrv2eData::Nrv2eData(const DynamicBuffer& buffer, BitParser* bitParser) : NrvData(buffer, bitParser)
+Nrv2eData::Nrv2eData(DynamicBuffer buffer, BitParser* bitParser) : NrvData(std::move(buffer), bitParser)
 {
 }
 
@@ -19,12 +19,19 @@ bool Nrv2eData::decompress(DynamicBuffer& outputBuffer)
 	// Reset just in case decompress() is called more times in row
 	reset();
 
+	return withBitParser([&](auto& bitParser) {
+		return decompress(bitParser, outputBuffer);
+	});
+}
+
+template <typename T> bool Nrv2eData::decompress(T& bitParser, DynamicBuffer& outputBuffer)
+{
 	int32_t lastDist = 1;
 	uint8_t bit;
 
 	while (true)
 	{
-		if (!_bitParser->getBit(bit, _buffer, _readPos))
+		if (!bitParser.getBit(bit, _buffer, _readPos))
 			return false;
 
 		while (bit == 1)
@@ -32,27 +39,27 @@ bool Nrv2eData::decompress(DynamicBuffer& outputBuffer)
 			if (_writePos >= outputBuffer.getCapacity() || _readPos >= _buffer.getRealDataSize())
 				return false;
 
-			outputBuffer.write<uint8_t>(_buffer.read<uint8_t>(_readPos++), _writePos++);
+			outputBuffer.write<uint8_t>(_buffer.getRawBuffer()[_readPos++], _writePos++);
 
-			if (!_bitParser->getBit(bit, _buffer, _readPos))
+			if (!bitParser.getBit(bit, _buffer, _readPos))
 				return false;
 		}
 
 		int32_t dist = 1;
 		while (true)
 		{
-			if (!_bitParser->getBit(bit, _buffer, _readPos))
+			if (!bitParser.getBit(bit, _buffer, _readPos))
 				return false;
 
 			dist += dist + bit;
 
-			if (!_bitParser->getBit(bit, _buffer, _readPos))
+			if (!bitParser.getBit(bit, _buffer, _readPos))
 				return false;
 
 			if (bit == 1)
 				break;
 
-			if (!_bitParser->getBit(bit, _buffer, _readPos))
+			if (!bitParser.getBit(bit, _buffer, _readPos))
 				return false;
 
 			dist = ((dist - 1) << 1) + bit;
@@ -63,7 +70,7 @@ bool Nrv2eData::decompress(DynamicBuffer& outputBuffer)
 		{
 			dist = lastDist;
 
-			if (!_bitParser->getBit(bit, _buffer, _readPos))
+			if (!bitParser.getBit(bit, _buffer, _readPos))
 				return false;
 
 			count = bit;
@@ -73,7 +80,7 @@ bool Nrv2eData::decompress(DynamicBuffer& outputBuffer)
 			if (_readPos >= _buffer.getRealDataSize())
 				return false;
 
-			dist = ((dist - 3) << 8) | _buffer.read<uint8_t>(_readPos++);
+			dist = ((dist - 3) << 8) | _buffer.getRawBuffer()[_readPos++];
 
 			if (dist == -1)
 				return true;
@@ -86,19 +93,19 @@ bool Nrv2eData::decompress(DynamicBuffer& outputBuffer)
 
 		if (count != 0)
 		{
-			if (!_bitParser->getBit(bit, _buffer, _readPos))
+			if (!bitParser.getBit(bit, _buffer, _readPos))
 				return false;
 
 			count = 1 + bit;
 		}
 		else
 		{
-			if (!_bitParser->getBit(bit, _buffer, _readPos))
+			if (!bitParser.getBit(bit, _buffer, _readPos))
 				return false;
 
 			if (bit == 1)
 			{
-				if (!_bitParser->getBit(bit, _buffer, _readPos))
+				if (!bitParser.getBit(bit, _buffer, _readPos))
 					return false;
 
 				count = 3 + bit;
@@ -109,12 +116,12 @@ bool Nrv2eData::decompress(DynamicBuffer& outputBuffer)
 
 				do
 				{
-					if (!_bitParser->getBit(bit, _buffer, _readPos))
+					if (!bitParser.getBit(bit, _buffer, _readPos))
 						return false;
 
 					count += count + bit;
 
-					if (!_bitParser->getBit(bit, _buffer, _readPos))
+					if (!bitParser.getBit(bit, _buffer, _readPos))
 						return false;
 				} while (bit == 0);
 
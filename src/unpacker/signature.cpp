@@ -107,9 +107,9 @@ bool Signature::match(const Signature::MatchSettings& settings, retdec::loader::
 bool Signature::match(const Signature::MatchSettings& settings, const DynamicBuffer& data) const
 {
 	if (settings.isSearch())
-		return searchMatchImpl(data.getBuffer(), settings.getOffset(), settings.getSearchDistance(), nullptr);
+		return searchMatchImpl(data.getSpan(), settings.getOffset(), settings.getSearchDistance(), nullptr);
 
-	return (matchImpl(data.getBuffer(), settings.getOffset(), nullptr) == static_cast<int64_t>(getSize()));
+	return (matchImpl(data.getSpan(), settings.getOffset(), nullptr) == static_cast<int64_t>(getSize()));
 }
 
 /**
@@ -149,12 +149,12 @@ bool Signature::match(const Signature::MatchSettings& settings, retdec::loader::
 bool Signature::match(const Signature::MatchSettings& settings, const DynamicBuffer& data, DynamicBuffer& capturedData) const
 {
 	if (settings.isSearch())
-		return searchMatchImpl(data.getBuffer(), settings.getOffset(), settings.getSearchDistance(), &capturedData);
+		return searchMatchImpl(data.getSpan(), settings.getOffset(), settings.getSearchDistance(), &capturedData);
 
-	return (matchImpl(data.getBuffer(), settings.getOffset(), &capturedData) == static_cast<int64_t>(getSize()));
+	return (matchImpl(data.getSpan(), settings.getOffset(), &capturedData) == static_cast<int64_t>(getSize()));
 }
 
-bool Signature::searchMatchImpl(const std::vector<uint8_t>& bytesToMatch, uint64_t offset, uint64_t maxSearchDist, DynamicBuffer* capturedData) const
+bool Signature::searchMatchImpl(retdec::utils::Span<const uint8_t> bytesToMatch, uint64_t offset, uint64_t maxSearchDist, DynamicBuffer* capturedData) const
 {
 	// Boyer-Moore search over whole bytesToMatch buffer
 	uint64_t searchOffset = 0;
@@ -184,7 +184,7 @@ bool Signature::searchMatchImpl(const std::vector<uint8_t>& bytesToMatch, uint64
 	return false;
 }
 
-int64_t Signature::matchImpl(const std::vector<uint8_t>& bytesToMatch, uint64_t offset, DynamicBuffer* captureBuffer) const
+int64_t Signature::matchImpl(retdec::utils::Span<const uint8_t> bytesToMatch, uint64_t offset, DynamicBuffer* captureBuffer) const
 {
 	// Bytes to match are not big enough to match this signature
 	if (bytesToMatch.size() - offset < getSize())
@@ -159,7 +159,7 @@ void MpressPlugin::unpack()
 	trailingBytesAnalysis(unpackedContent);
 
 	// Save the new file
-	saveFile(getStartupArguments()->outputFile, unpackedContent);
+	saveFile(getOutput(), unpackedContent);
 }
 
 /**
@@ -648,17 +648,13 @@ MpressFixStub MpressPlugin::detectFixStubVersion(DynamicBuffer& unpackedContent)
 	return MPRESS_FIX_STUB_UNKNOWN;
 }
 
-void MpressPlugin::saveFile(const std::string& fileName, DynamicBuffer& content)
+void MpressPlugin::saveFile(std::ostream& outputFile, DynamicBuffer& content)
 {
 	PeLib::ImageLoader & imageLoader = _peFile->imageLoader();
 
-	// Removes the file if it already exists
-	std::remove(fileName.c_str());
-
 	// Headers
-	imageLoader.Save(fileName.c_str(), PeLib::IoFlagNewFile);
+	imageLoader.Save(outputFile, 0, PeLib::IoFlagNewFile);
 
-	std::fstream outputFile(fileName, std::ios::binary | std::ios::out | std::ios::in);
 	// Copy the section bytes from original file for the sections preceding the packed section
 	for (std::uint32_t index = 0; index < _packedContentSect->getSecSeg()->getIndex(); ++index)
 		copySectionFromOriginalFile(index, outputFile, index);
@@ -673,7 +669,7 @@ void MpressPlugin::saveFile(const std::string& fileName, DynamicBuffer& content)
 
 	// Write content of new import section
 	std::uint32_t Rva = imageLoader.getDataDirRva(PeLib::PELIB_IMAGE_DIRECTORY_ENTRY_IMPORT);
-	_peFile->impDir().write(fileName, imageLoader.getFileOffsetFromRva(Rva), Rva, imageLoader.getPointerSize());
+	_peFile->impDir().write(outputFile, imageLoader.getFileOffsetFromRva(Rva), Rva, imageLoader.getPointerSize());
 
 	// After this all we need to update the IAT with the contents of ILT
 	// since Import Directory in PeLib is built after the write to the file
@@ -691,10 +687,8 @@ void MpressPlugin::saveFile(const std::string& fileName, DynamicBuffer& content)
 	}
 
 	// Write the unpacked content to the packed content section
-	// Use regular file as we will write more sections at once
 	outputFile.seekp(imageLoader.getSectionHeader(_packedContentSect->getSecSeg()->getIndex())->PointerToRawData, std::ios_base::beg);
 	outputFile.write(reinterpret_cast<const char*>(content.getRawBuffer()), content.getRealDataSize());
-	outputFile.close();
 }
 
 void MpressPlugin::copySectionFromOriginalFile(std::uint32_t origSectIndex, std::ostream& outputFile, std::uint32_t newSectIndex)
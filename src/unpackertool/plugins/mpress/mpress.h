@@ -85,7 +85,7 @@ private:
 	void fixRelocations();
 	MpressUnpackerStub detectUnpackerStubVersion();
 	MpressFixStub detectFixStubVersion(retdec::utils::DynamicBuffer& unpackedContent);
-	void saveFile(const std::string& fileName, retdec::utils::DynamicBuffer& content);
+	void saveFile(std::ostream& outputFile, retdec::utils::DynamicBuffer& content);
 	void copySectionFromOriginalFile(std::uint32_t origSectIndex, std::ostream& outputFile, std::uint32_t newSectIndex);
 
 	std::unique_ptr<retdec::loader::Image> _file;
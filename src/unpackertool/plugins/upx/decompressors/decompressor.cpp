@@ -4,6 +4,10 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include "unpackertool/plugins/upx/decompressors/decompressor.h"
 #include "unpackertool/plugins/upx/upx.h"
 #include "unpackertool/plugins/upx/upx_exceptions.h"
@@ -15,10 +19,47 @@ namespace retdec {
 namespace unpackertool {
 namespace upx {
 
+namespace {
+
+/**
+ * Size of the beginning of compressed data which is decompressed first
+ * with every XOR value. Only values which do not fail on it are tried on
+ * the whole data.
+ */
+const std::size_t XOR_PROBE_SIZE = 0x1000;
+
+/**
+ * XORs @a size bytes of @a src with @a key and stores them into @a dst.
+ * Bytes are processed by whole 64-bit words.
+ */
+void xorBytes(const std::uint8_t* src, std::uint8_t* dst, std::size_t size, std::uint8_t key)
+{
+	const std::uint64_t wordKey = key * 0x0101010101010101ULL;
+
+	std::size_t i = 0;
+	for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+	{
+		std::uint64_t word;
+		std::memcpy(&word, src + i, sizeof(word));
+		word ^= wordKey;
+		std::memcpy(dst + i, &word, sizeof(word));
+	}
+
+	for (; i < size; ++i)
+		dst[i] = src[i] ^ key;
+}
+
+} // anonymous namespace
+
 /**
  * Performs decompression using provided compressed data and decompresses it into provided buffer.
  * If it fails to decompress them, it uses XOR bruteforce on the packed data.
  *
+ * Every XOR value is first tried only on the beginning of the data. Values
+ * for which the decompression fails before it reaches the end of the
+ * beginning would fail on the whole data as well, so they are rejected
+ * without XORing and decompressing the rest of the data.
+ *
  * @param compressedDataWptr The compressed data.
  * @param unpackedData Buffer where to decompress data.
  */
@@ -32,13 +73,28 @@ void Decompressor::performDecompression(const std::weak_ptr<CompressedData>& com
 			upx_plugin->log("Bruteforcing compressed data with XOR.");
 
 			// If we failed, try to bruteforce the data with XOR
-			DynamicBuffer originalData = compressedData->getBuffer();
+			const DynamicBuffer originalData = compressedData->getBuffer();
+			const auto* original = originalData.getRawBuffer();
+			const std::size_t size = originalData.getRealDataSize();
+			const std::size_t probeSize = std::min(size, XOR_PROBE_SIZE);
+			std::vector<std::uint8_t> xoredData(size);
 			for (std::uint32_t i = 0x01; i <= 0xFF; ++i)
 			{
-				DynamicBuffer xoredData = originalData;
-				xoredData.forEach([i](std::uint8_t& byte) { byte ^= i; });
-				compressedData->setBuffer(xoredData);
+				xorBytes(original, xoredData.data(), probeSize, i);
+				if (probeSize < size)
+				{
+					compressedData->setBuffer(DynamicBuffer(
+							std::vector<std::uint8_t>(xoredData.begin(), xoredData.begin() + probeSize),
+							originalData.getEndianness()));
+
+					DynamicBuffer probeData(unpackedData.getCapacity(), unpackedData.getEndianness());
+					if (!compressedData->decompress(probeData) && !compressedData->isInputExhausted())
+						continue;
+
+					xorBytes(original + probeSize, xoredData.data() + probeSize, size - probeSize, i);
+				}
 
+				compressedData->setBuffer(DynamicBuffer(xoredData, originalData.getEndianness()));
 				if (compressedData->decompress(unpackedData))
 				{
 					upx_plugin->log("Bruteforcing compressed data with XOR succeeded on XOR value 0x", std::hex, i, std::dec, ".");
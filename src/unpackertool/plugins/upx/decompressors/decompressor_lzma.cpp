@@ -37,7 +37,7 @@ void DecompressorLzma::setupPackingMethod(ElfUpxStub<32>* /*stub*/, std::uint8_t
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The ELF32 UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  */
 void DecompressorLzma::decompress(ElfUpxStub<32>* /*stub*/, DynamicBuffer& packedData, DynamicBuffer& unpackedData)
@@ -52,7 +52,7 @@ void DecompressorLzma::decompress(ElfUpxStub<32>* /*stub*/, DynamicBuffer& packe
 	std::uint8_t lp = (prop1 & 0xF0) >> 4;
 	packedData.erase(0, 2);
 
-	auto lzmaData = std::make_shared<LzmaData>(packedData, pb, lp, lc);
+	auto lzmaData = std::make_shared<LzmaData>(std::move(packedData), pb, lp, lc);
 	performDecompression(lzmaData, unpackedData);
 }
 
@@ -72,7 +72,7 @@ void DecompressorLzma::setupPackingMethod(ElfUpxStub<64>* /*stub*/, std::uint8_t
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The ELF64 UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  */
 void DecompressorLzma::decompress(ElfUpxStub<64>* /*stub*/, DynamicBuffer& packedData, DynamicBuffer& unpackedData)
@@ -87,7 +87,7 @@ void DecompressorLzma::decompress(ElfUpxStub<64>* /*stub*/, DynamicBuffer& packe
 	std::uint8_t lp = (prop1 & 0xF0) >> 4;
 	packedData.erase(0, 2);
 
-	auto lzmaData = std::make_shared<LzmaData>(packedData, pb, lp, lc);
+	auto lzmaData = std::make_shared<LzmaData>(std::move(packedData), pb, lp, lc);
 	performDecompression(lzmaData, unpackedData);
 }
 
@@ -107,7 +107,7 @@ void DecompressorLzma::setupPackingMethod(MachOUpxStub<32>* /*stub*/, std::uint8
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The Mach-O 32-bit UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  */
 void DecompressorLzma::decompress(MachOUpxStub<32>* /*stub*/, DynamicBuffer& packedData, DynamicBuffer& unpackedData)
@@ -122,7 +122,7 @@ void DecompressorLzma::decompress(MachOUpxStub<32>* /*stub*/, DynamicBuffer& pac
 	std::uint8_t lp = (prop1 & 0xF0) >> 4;
 	packedData.erase(0, 2);
 
-	auto lzmaData = std::make_shared<LzmaData>(packedData, pb, lp, lc);
+	auto lzmaData = std::make_shared<LzmaData>(std::move(packedData), pb, lp, lc);
 	performDecompression(lzmaData, unpackedData);
 }
 
@@ -142,7 +142,7 @@ void DecompressorLzma::setupPackingMethod(MachOUpxStub<64>* /*stub*/, std::uint8
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The Mach-O 64-bit UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  */
 void DecompressorLzma::decompress(MachOUpxStub<64>* /*stub*/, DynamicBuffer& packedData, DynamicBuffer& unpackedData)
@@ -157,7 +157,7 @@ void DecompressorLzma::decompress(MachOUpxStub<64>* /*stub*/, DynamicBuffer& pac
 	std::uint8_t lp = (prop1 & 0xF0) >> 4;
 	packedData.erase(0, 2);
 
-	auto lzmaData = std::make_shared<LzmaData>(packedData, pb, lp, lc);
+	auto lzmaData = std::make_shared<LzmaData>(std::move(packedData), pb, lp, lc);
 	performDecompression(lzmaData, unpackedData);
 }
 
@@ -219,14 +219,14 @@ void DecompressorLzma::readPackedData(PeUpxStub<32>* stub, DynamicBuffer& packed
 	std::vector<std::uint8_t> packedDataBytes;
 	stub->getFile()->getEpSegment()->getBytes(packedDataBytes, packedDataOffset, packedDataSize);
 
-	packedData = DynamicBuffer(packedDataBytes, stub->getFile()->getFileFormat()->getEndianness());
+	packedData = DynamicBuffer(std::move(packedDataBytes), stub->getFile()->getFileFormat()->getEndianness());
 }
 
 /**
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The PE32 UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  * @param trustMetadata True if UPX metadata are trusted, otherwise false.
  */
@@ -249,7 +249,7 @@ void DecompressorLzma::decompress(PeUpxStub<32>* stub, DynamicBuffer& packedData
 	std::uint8_t lp = (prop1 & 0xF0) >> 4;
 	packedData.erase(0, 2);
 
-	auto lzmaData = std::make_shared<LzmaData>(packedData, pb, lp, lc);
+	auto lzmaData = std::make_shared<LzmaData>(std::move(packedData), pb, lp, lc);
 	performDecompression(lzmaData, unpackedData);
 }
 
@@ -312,14 +312,14 @@ void DecompressorLzma::readPackedData(PeUpxStub<64>* stub, DynamicBuffer& packed
 	std::vector<std::uint8_t> packedDataBytes;
 	stub->getFile()->getEpSegment()->getBytes(packedDataBytes, packedDataOffset, packedDataSize);
 
-	packedData = DynamicBuffer(packedDataBytes, stub->getFile()->getFileFormat()->getEndianness());
+	packedData = DynamicBuffer(std::move(packedDataBytes), stub->getFile()->getFileFormat()->getEndianness());
 }
 
 /**
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The PE64 UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  * @param trustMetadata True if UPX metadata are trusted, otherwise false.
  */
@@ -342,7 +342,7 @@ void DecompressorLzma::decompress(PeUpxStub<64>* stub, DynamicBuffer& packedData
 	std::uint8_t lp = (prop1 & 0xF0) >> 4;
 	packedData.erase(0, 2);
 
-	auto lzmaData = std::make_shared<LzmaData>(packedData, pb, lp, lc);
+	auto lzmaData = std::make_shared<LzmaData>(std::move(packedData), pb, lp, lc);
 	performDecompression(lzmaData, unpackedData);
 }
 
@@ -45,7 +45,7 @@ void DecompressorNrv::setupPackingMethod(ElfUpxStub<32>* /*stub*/, std::uint8_t
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The ELF32 UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  */
 void DecompressorNrv::decompress(ElfUpxStub<32>* /*stub*/, DynamicBuffer& packedData, DynamicBuffer& unpackedData)
@@ -68,7 +68,7 @@ void DecompressorNrv::setupPackingMethod(ElfUpxStub<64>* /*stub*/, std::uint8_t
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The ELF64 UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  */
 void DecompressorNrv::decompress(ElfUpxStub<64>* /*stub*/, DynamicBuffer& packedData, DynamicBuffer& unpackedData)
@@ -91,7 +91,7 @@ void DecompressorNrv::setupPackingMethod(MachOUpxStub<32>* /*stub*/, std::uint8_
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The Mach-O 32-bit UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  */
 void DecompressorNrv::decompress(MachOUpxStub<32>* /*stub*/, DynamicBuffer& packedData, DynamicBuffer& unpackedData)
@@ -114,7 +114,7 @@ void DecompressorNrv::setupPackingMethod(MachOUpxStub<64>* /*stub*/, std::uint8_
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The Mach-O 64-bit UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  */
 void DecompressorNrv::decompress(MachOUpxStub<64>* /*stub*/, DynamicBuffer& packedData, DynamicBuffer& unpackedData)
@@ -183,7 +183,7 @@ void DecompressorNrv::readPackedData(PeUpxStub<32>* stub, DynamicBuffer& packedD
 	std::vector<std::uint8_t> packedDataBytes;
 	stub->getFile()->getEpSegment()->getBytes(packedDataBytes, packedDataOffset, packedDataSize);
 
-	packedData = DynamicBuffer(packedDataBytes, stub->getFile()->getFileFormat()->getEndianness());
+	packedData = DynamicBuffer(std::move(packedDataBytes), stub->getFile()->getFileFormat()->getEndianness());
 
 	// Stub is modified and contains rewrite dword modification
 	// We need to take a dword and rewrite it in the packed data
@@ -201,7 +201,7 @@ void DecompressorNrv::readPackedData(PeUpxStub<32>* stub, DynamicBuffer& packedD
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The PE32 UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  * @param trustMetadata True if UPX metadata are trusted, otherwise false.
  */
@@ -294,7 +294,7 @@ void DecompressorNrv::readPackedData(PeUpxStub<64>* stub, DynamicBuffer& packedD
 	std::vector<std::uint8_t> packedDataBytes;
 	stub->getFile()->getEpSegment()->getBytes(packedDataBytes, packedDataOffset, packedDataSize);
 
-	packedData = DynamicBuffer(packedDataBytes, stub->getFile()->getFileFormat()->getEndianness());
+	packedData = DynamicBuffer(std::move(packedDataBytes), stub->getFile()->getFileFormat()->getEndianness());
 
 	// Stub is modified and contains rewrite dword modification
 	// We need to take a dword and rewrite it in the packed data
@@ -312,7 +312,7 @@ void DecompressorNrv::readPackedData(PeUpxStub<64>* stub, DynamicBuffer& packedD
  * Performs decompression of packed data and place it into another buffer.
  *
  * @param stub The PE64 UPX unpacking stub object.
- * @param packedData The compressed packed data.
+ * @param packedData The compressed packed data, consumed by decompression.
  * @param unpackedData The buffer where to decompress data.
  * @param trustMetadata True if UPX metadata are trusted, otherwise false.
  */
@@ -382,13 +382,13 @@ void DecompressorNrv::decompress(DynamicBuffer& packedData, DynamicBuffer& unpac
 	switch (_nrvVersion)
 	{
 		case 'B':
-			nrvData.reset(new Nrv2bData(packedData, _bitParser.get()));
+			nrvData.reset(new Nrv2bData(std::move(packedData), _bitParser.get()));
 			break;
 		case 'D':
-			nrvData.reset(new Nrv2dData(packedData, _bitParser.get()));
+			nrvData.reset(new Nrv2dData(std::move(packedData), _bitParser.get()));
 			break;
 		case 'E':
-			nrvData.reset(new Nrv2eData(packedData, _bitParser.get()));
+			nrvData.reset(new Nrv2eData(std::move(packedData), _bitParser.get()));
 			break;
 		default:
 			throw UnsupportedStubException();
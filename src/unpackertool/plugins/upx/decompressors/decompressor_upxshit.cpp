@@ -5,6 +5,7 @@
  */
 
 #include <cstdlib>
+#include <utility>
 #include <vector>
 
 #include "unpackertool/plugins/upx/decompressors/decompressor_upxshit.h"
@@ -20,6 +21,30 @@ namespace retdec {
 namespace unpackertool {
 namespace upx {
 
+namespace {
+
+/**
+ * XORs back the stub scrambled by UPX$HIT.
+ *
+ * The scrambling loop goes from the last byte of the stub and ends when its
+ * counter reaches 0, so the first byte is not XORed. If only a part of the
+ * stub could be read, the loop never gets to it and all the read bytes are
+ * XORed.
+ *
+ * @param stub The scrambled stub.
+ * @param stubSize The size of the stub stored in the scrambling code.
+ * @param xorValue The XOR constant.
+ */
+void unscrambleStub(DynamicBuffer& stub, std::uint32_t stubSize, std::uint8_t xorValue)
+{
+	std::uint32_t startPos = (stubSize != 0 && stub.getRealDataSize() == stubSize) ? 1 : 0;
+	stub.transform(startPos, stub.getRealDataSize(), [xorValue](std::uint8_t byte) {
+			return byte ^ xorValue;
+		});
+}
+
+} // anonymous namespace
+
 Signature secondStubSignature =
 {
 	0xB8, CAP, CAP, CAP, CAP, // MOV EAX, <UPX unpacking stub address>
@@ -51,14 +76,8 @@ void DecompressorUpxshit::readUnpackingStub(PeUpxStub<32>* stub, DynamicBuffer&
 	stub->getFile()->getEpSegment()->getBytes(secondStubBytes, secondStubOffset, secondStubSize);
 
 	// XOR it back with the constant value
-	DynamicBuffer secondStub(secondStubBytes, stub->getFile()->getFileFormat()->getEndianness());
-	secondStub.forEachReverse([secondStubXorValue, &secondStubSize](std::uint8_t& byte) {
-			// We need to use prefix decrement since this is also being done on assembly level
-			if (--secondStubSize == 0)
-				return;
-
-			byte ^= secondStubXorValue;
-		});
+	DynamicBuffer secondStub(std::move(secondStubBytes), stub->getFile()->getFileFormat()->getEndianness());
+	unscrambleStub(secondStub, secondStubSize, secondStubXorValue);
 
 	// Match it against known signature of second UPX$HIT stub
 	DynamicBuffer secondStubCapturedData(stub->getFile()->getFileFormat()->getEndianness());
@@ -77,14 +96,8 @@ void DecompressorUpxshit::readUnpackingStub(PeUpxStub<32>* stub, DynamicBuffer&
 	stub->getFile()->getEpSegment()->getBytes(upxStubBytes, upxStubOffset, upxStubSize);
 
 	// XOR it back with the constant value
-	DynamicBuffer upxStub(upxStubBytes, stub->getFile()->getFileFormat()->getEndianness());
-	upxStub.forEachReverse([upxStubXorValue, &upxStubSize](std::uint8_t& byte) {
-			// We need to use prefix decrement since this is also being done on assembly level
-			if (--upxStubSize == 0)
-				return;
-
-			byte ^= upxStubXorValue;
-		});
+	DynamicBuffer upxStub(std::move(upxStubBytes), stub->getFile()->getFileFormat()->getEndianness());
+	unscrambleStub(upxStub, upxStubSize, upxStubXorValue);
 
 	try
 	{
@@ -127,14 +140,8 @@ void DecompressorUpxshit::readUnpackingStub(PeUpxStub<64>* stub, DynamicBuffer&
 	stub->getFile()->getEpSegment()->getBytes(secondStubBytes, secondStubOffset, secondStubSize);
 
 	// XOR it back with the constant value
-	DynamicBuffer secondStub(secondStubBytes, stub->getFile()->getFileFormat()->getEndianness());
-	secondStub.forEachReverse([secondStubXorValue, &secondStubSize](std::uint8_t& byte) {
-			// We need to use prefix decrement since this is also being done on assembly level
-			if (--secondStubSize == 0)
-				return;
-
-			byte ^= secondStubXorValue;
-		});
+	DynamicBuffer secondStub(std::move(secondStubBytes), stub->getFile()->getFileFormat()->getEndianness());
+	unscrambleStub(secondStub, secondStubSize, secondStubXorValue);
 
 	// Match it against known signature of second UPX$HIT stub
 	DynamicBuffer secondStubCapturedData(stub->getFile()->getFileFormat()->getEndianness());
@@ -153,14 +160,8 @@ void DecompressorUpxshit::readUnpackingStub(PeUpxStub<64>* stub, DynamicBuffer&
 	stub->getFile()->getEpSegment()->getBytes(upxStubBytes, upxStubOffset, upxStubSize);
 
 	// XOR it back with the constant value
-	DynamicBuffer upxStub(upxStubBytes, stub->getFile()->getFileFormat()->getEndianness());
-	upxStub.forEachReverse([upxStubXorValue, &upxStubSize](std::uint8_t& byte) {
-			// We need to use prefix decrement since this is also being done on assembly level
-			if (--upxStubSize == 0)
-				return;
-
-			byte ^= upxStubXorValue;
-		});
+	DynamicBuffer upxStub(std::move(upxStubBytes), stub->getFile()->getFileFormat()->getEndianness());
+	unscrambleStub(upxStub, upxStubSize, upxStubXorValue);
 
 	try
 	{
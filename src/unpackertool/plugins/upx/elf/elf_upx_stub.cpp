@@ -64,9 +64,9 @@ template <int bits> ElfUpxStub<bits>::ElfUpxStub(
  *
  * @tparam bits Number of bits of the architecture.
  *
- * @param outputFile Path to unpacked output file.
+ * @param output Stream the unpacked file is written to.
  */
-template <int bits> void ElfUpxStub<bits>::unpack(const std::string& outputFile)
+template <int bits> void ElfUpxStub<bits>::unpack(std::ostream& output)
 {
 	// Find where is the first packed block
 	auto firstBlockOffset = getFirstBlockOffset();
@@ -76,11 +76,7 @@ template <int bits> void ElfUpxStub<bits>::unpack(const std::string& outputFile)
 	DynamicBuffer originalHeaderData(_file->getFileFormat()->getEndianness());
 	unpackBlock(originalHeaderData, firstBlockOffset, readPos);
 
-	std::fstream output(
-			outputFile,
-			std::ios::out | std::ios::trunc | std::ios::binary
-	);
-	retdec::utils::writeFile(output, originalHeaderData.getBuffer());
+	retdec::utils::writeFile(output, originalHeaderData.getSpan());
 
 	// Load these data manually because of endianness independence
 	ElfHeaderType originalHeader;
@@ -135,7 +131,7 @@ template <int bits> void ElfUpxStub<bits>::unpack(const std::string& outputFile)
 
 		retdec::utils::writeFile(
 				output,
-				unpackedData.getBuffer(),
+				unpackedData.getSpan(),
 				initialOffset + originalProgHeaders[i].p_offset
 		);
 
@@ -290,7 +286,7 @@ template <int bits> void ElfUpxStub<bits>::unpack(const std::string& outputFile)
 		unpackBlock(unpackedData, additionalData, readPos);
 		retdec::utils::writeFile(
 				output,
-				unpackedData.getBuffer(),
+				unpackedData.getSpan(),
 				originalProgHeaders[i].p_offset
 					+ originalProgHeaders[i].p_filesz
 		);
@@ -313,15 +309,13 @@ template <int bits> void ElfUpxStub<bits>::unpack(const std::string& outputFile)
 		output.seekp(0, std::ios::end);
 		retdec::utils::writeFile(
 				output,
-				unpackedData.getBuffer(),
+				unpackedData.getSpan(),
 				output.tellp()
 		);
 
 		// Erase already unpacked data from additional data buffer
 		additionalData.erase(0, readPos);
 	}
-
-	output.close();
 }
 
 /**
@@ -484,7 +478,7 @@ template <int bits> void ElfUpxStub<bits>::unpackBlock(
 			PackedBlockHeaderSize + packedDataSize
 	);
 	DynamicBuffer packedBlock = DynamicBuffer(
-			packedBlockBytes,
+			std::move(packedBlockBytes),
 			_file->getFileFormat()->getEndianness()
 	);
 
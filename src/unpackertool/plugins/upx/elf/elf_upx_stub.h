@@ -110,7 +110,7 @@ public:
 			const UpxMetadata& metadata
 	);
 
-	virtual void unpack(const std::string& outputFile) override;
+	virtual void unpack(std::ostream& output) override;
 	virtual void cleanup() override;
 
 	void setupPackingMethod(std::uint8_t packingMethod);
@@ -76,11 +76,10 @@ template <int bits> MachOUpxStub<bits>::MachOUpxStub(retdec::loader::Image* inpu
  *
  * @tparam bits Number of bits of the architecture.
  *
- * @param outputFile Path to unpacked output file.
+ * @param output Stream the unpacked file is written to.
  */
-template <int bits> void MachOUpxStub<bits>::unpack(const std::string& outputFile)
+template <int bits> void MachOUpxStub<bits>::unpack(std::ostream& output)
 {
-	std::ofstream output(outputFile, std::ios::out | std::ios::trunc | std::ios::binary);
 	std::ifstream input(_file->getFileFormat()->getPathToFile(), std::ios::in | std::ios::binary);
 
 	auto fileFormat = _file->getFileFormatWptr().lock();
@@ -139,11 +138,10 @@ template <int bits> void MachOUpxStub<bits>::unpack(const std::string& outputFil
 			fatHeader.write<std::uint32_t>(offsetAndSize[i].second, FatHeaderEntriesOffset + FatHeaderArchSizeOffset + i * FatHeaderEntrySize);
 		}
 
-		retdec::utils::writeFile(output, fatHeader.getBuffer());
+		retdec::utils::writeFile(output, fatHeader.getSpan());
 	}
 
 	input.close();
-	output.close();
 }
 
 /**
@@ -167,7 +165,7 @@ template <int bits> void MachOUpxStub<bits>::decompress(DynamicBuffer& packedDat
 	_decompressor->decompress(this, packedData, unpackedData);
 }
 
-template <int bits> void MachOUpxStub<bits>::unpack(std::ifstream& inputFile, std::ofstream& outputFile, std::uint64_t baseInputOffset, std::uint64_t baseOutputOffset)
+template <int bits> void MachOUpxStub<bits>::unpack(std::ifstream& inputFile, std::ostream& outputFile, std::uint64_t baseInputOffset, std::uint64_t baseOutputOffset)
 {
 	// Move to the specific offset of the first packed block.
 	inputFile.seekg(baseInputOffset + getFirstBlockOffset(inputFile), std::ios::beg);
@@ -177,7 +175,7 @@ template <int bits> void MachOUpxStub<bits>::unpack(std::ifstream& inputFile, st
 	// First read packed original Mach-O header and unpack it.
 	DynamicBuffer packedOriginalHeader = readNextBlock(inputFile);
 	DynamicBuffer originalHeaderData = unpackBlock(packedOriginalHeader);
-	retdec::utils::writeFile(outputFile, originalHeaderData.getBuffer(), baseOutputOffset);
+	retdec::utils::writeFile(outputFile, originalHeaderData.getSpan(), baseOutputOffset);
 
 	// Extract number of commands from the original header.
 	MachOHeaderType machoHeader;
@@ -222,7 +220,7 @@ template <int bits> void MachOUpxStub<bits>::unpack(std::ifstream& inputFile, st
 		DynamicBuffer unpackedData = unpackBlock(packedBlock);
 
 		// Segments are always written at the position of fileoff with first segment shifted by the specific offset.
-		retdec::utils::writeFile(outputFile, unpackedData.getBuffer(), baseOutputOffset + command.fileoff + firstSegmentOffset);
+		retdec::utils::writeFile(outputFile, unpackedData.getSpan(), baseOutputOffset + command.fileoff + firstSegmentOffset);
 
 		// Shift offset of the first segment will be reset after the first iteration so all other segments will have its original file offset.
 		firstSegmentOffset = 0;
@@ -269,7 +267,7 @@ template <int bits> DynamicBuffer MachOUpxStub<bits>::readNextBlock(std::ifstrea
 	std::vector<std::uint8_t> packedBlockBytes;
 	retdec::utils::readFile(inputFile, packedBlockBytes, blockFilePos, PackedBlockHeaderSize + packedDataSize);
 
-	return DynamicBuffer(packedBlockBytes, _file->getEndianness());
+	return DynamicBuffer(std::move(packedBlockBytes), _file->getEndianness());
 }
 
 template <int bits> DynamicBuffer MachOUpxStub<bits>::unpackBlock(DynamicBuffer& packedBlock)
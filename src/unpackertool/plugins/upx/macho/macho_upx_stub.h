@@ -72,13 +72,13 @@ public:
 	MachOUpxStub(retdec::loader::Image* inputFile, const UpxStubData* stubData, const DynamicBuffer& stubCapturedData,
 			std::unique_ptr<Decompressor> decompressor, const UpxMetadata& metadata);
 
-	virtual void unpack(const std::string& outputFile) override;
+	virtual void unpack(std::ostream& output) override;
 	virtual void cleanup() override;
 
 	void setupPackingMethod(std::uint8_t packingMethod);
 	void decompress(DynamicBuffer& packedData, DynamicBuffer& unpackedData);
 
-	void unpack(std::ifstream& inputFile, std::ofstream& outputFile, std::uint64_t baseInputOffset, std::uint64_t baseOutputOffset);
+	void unpack(std::ifstream& inputFile, std::ostream& outputFile, std::uint64_t baseInputOffset, std::uint64_t baseOutputOffset);
 
 protected:
 	std::uint32_t getFirstBlockOffset(std::ifstream& inputFile) const;
@@ -169,9 +169,9 @@ template <int bits> PeUpxStub<bits>::PeUpxStub(retdec::loader::Image* inputFile,
  * Performs the whole process of unpacking. This is the method that is being run from @ref UpxPlugin to start
  * unpacking stub.
  *
- * @param outputFile Path to unpacked output file.
+ * @param output Stream the unpacked file is written to.
  */
-template <int bits> void PeUpxStub<bits>::unpack(const std::string& outputFile)
+template <int bits> void PeUpxStub<bits>::unpack(std::ostream& output)
 {
 	// Prepare unpacking stub for unpacking.
 	prepare();
@@ -248,7 +248,7 @@ template <int bits> void PeUpxStub<bits>::unpack(const std::string& outputFile)
 	cutHintsData(unpackedData, extraData);
 
 	// Save the output to the file
-	saveFile(outputFile, unpackedData);
+	saveFile(output, unpackedData);
 }
 
 /**
@@ -1192,28 +1192,25 @@ template <int bits> void PeUpxStub<bits>::cutHintsData(DynamicBuffer& unpackedDa
 /**
  * Saves the unpacked data to the output file.
  *
- * @param outputFile Path to the unpacked output file.
+ * @param output Stream the unpacked file is written to.
  * @param unpackedData Unpacked data to write.
  */
-template <int bits> void PeUpxStub<bits>::saveFile(const std::string& outputFile, DynamicBuffer& unpackedData)
+template <int bits> void PeUpxStub<bits>::saveFile(std::ostream& output, DynamicBuffer& unpackedData)
 {
 	PeLib::PELIB_IMAGE_SECTION_HEADER * pSectionHeader;
 	PeLib::ImageLoader & imageLoader = _newPeFile->imageLoader();
 	std::uint32_t Rva;
 
-	// Remove the file if it already exists
-	std::remove(outputFile.c_str());
-
 	// Write the DOS header, PE headers and section headers
 	pSectionHeader = imageLoader.getSectionHeader(_upx0Sect->getSecSeg()->getIndex());
-	imageLoader.Save(outputFile.c_str(), PeLib::IoFlagNewFile);
+	imageLoader.Save(output, 0, PeLib::IoFlagNewFile);
 
 	// Save the import directory
 	if((Rva = imageLoader.getDataDirRva(PeLib::PELIB_IMAGE_DIRECTORY_ENTRY_IMPORT)) != 0)
 	{
 		std::uint32_t VirtualAddress = pSectionHeader->VirtualAddress;
 
-		_newPeFile->impDir().write(outputFile, imageLoader.getFileOffsetFromRva(Rva), Rva, imageLoader.getPointerSize());
+		_newPeFile->impDir().write(output, imageLoader.getFileOffsetFromRva(Rva), Rva, imageLoader.getPointerSize());
 
 		// OrignalFirstThunk-s are known only after the impDir is written into the file
 		// We then need to read it function by function and set the contents of IAT to be same as ILT
@@ -1230,23 +1227,20 @@ template <int bits> void PeUpxStub<bits>::saveFile(const std::string& outputFile
 	}
 
 	// Write the unpacked content to the packed content section
-	// Use regular file as we will write more sections at once
-	std::fstream outputFileHandle(outputFile, std::ios::binary | std::ios::out | std::ios::in);
-	retdec::utils::writeFile(outputFileHandle, unpackedData.getBuffer(), pSectionHeader->PointerToRawData);
+	retdec::utils::writeFile(output, unpackedData.getSpan(), pSectionHeader->PointerToRawData);
 
 	// If there were COFF symbols in the original file, write them also to the new one
 	if (!_coffSymbolTable.empty())
-		retdec::utils::writeFile(outputFileHandle, _coffSymbolTable, imageLoader.getPointerToSymbolTable());
-	outputFileHandle.close();
+		retdec::utils::writeFile(output, _coffSymbolTable, imageLoader.getPointerToSymbolTable());
 
 	// Write resources at the end, because they would be rewritten by unpackedData which have them zeroed
 	if((Rva = imageLoader.getDataDirRva(PeLib::PELIB_IMAGE_DIRECTORY_ENTRY_RESOURCE)) != 0)
-		_newPeFile->resDir().write(outputFile, imageLoader.getFileOffsetFromRva(Rva), Rva);
+		_newPeFile->resDir().write(output, imageLoader.getFileOffsetFromRva(Rva), Rva);
 
 	// Write exports at the end, because they would be rewritten by unpackedData which have them zeroed
 	// Write them only when exports are not compressed
 	if((Rva = imageLoader.getDataDirRva(PeLib::PELIB_IMAGE_DIRECTORY_ENTRY_EXPORT)) != 0 && !_exportsCompressed)
-		_newPeFile->expDir().write(outputFile, imageLoader.getFileOffsetFromRva(Rva), Rva);
+		_newPeFile->expDir().write(output, imageLoader.getFileOffsetFromRva(Rva), Rva);
 
 	// Copy file overlay if any
 	if (_file->getFileFormat()->getDeclaredFileLength() < _file->getFileFormat()->getLoadedFileLength())
@@ -1259,9 +1253,8 @@ template <int bits> void PeUpxStub<bits>::saveFile(const std::string& outputFile
 		std::fstream inputFileHandle(_file->getFileFormat()->getPathToFile(), std::ios::binary | std::ios::in);
 		retdec::utils::readFile(inputFileHandle, overlay, _file->getFileFormat()->getDeclaredFileLength(), overlaySize);
 
-		std::fstream outputFileHandle(outputFile, std::ios::binary | std::ios::out | std::ios::in);
-		outputFileHandle.seekp(0, std::ios::end);
-		retdec::utils::writeFile(outputFileHandle, overlay, outputFileHandle.tellp());
+		output.seekp(0, std::ios::end);
+		retdec::utils::writeFile(output, overlay, output.tellp());
 	}
 }
 
@@ -1384,7 +1377,7 @@ template <int bits> void PeUpxStub<bits>::loadResources(PeLib::ResourceNode* roo
 				if (dataOffset + leaf->getSize() >= unpackedData.getRealDataSize())
 					throw InvalidDataDirectoryException("Resources");
 
-				data = DynamicBuffer(unpackedData, dataOffset, leaf->getSize()).getBuffer();
+				data = unpackedData.getSpan(dataOffset, leaf->getSize()).toVector();
 			}
 			else
 			{
@@ -1395,7 +1388,7 @@ template <int bits> void PeUpxStub<bits>::loadResources(PeLib::ResourceNode* roo
 				if (dataOffset + leaf->getSize() >= uncompressedRsrcs.getRealDataSize())
 					throw InvalidDataDirectoryException("Resources");
 
-				data = DynamicBuffer(uncompressedRsrcs, dataOffset, leaf->getSize()).getBuffer();
+				data = uncompressedRsrcs.getSpan(dataOffset, leaf->getSize()).toVector();
 
 				// Update offset for uncompressed resource because it is going to containg data at different position
 				leaf->setOffsetToData(dataOffset + compressedRsrcRva);
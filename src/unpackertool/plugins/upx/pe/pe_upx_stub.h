@@ -68,7 +68,7 @@ template <int bits> class PeUpxStub : public UpxStub
 	PeUpxStub(retdec::loader::Image* inputFile, const UpxStubData* stubData, const DynamicBuffer& stubCapturedData,
 			std::unique_ptr<Decompressor> decompressor, const UpxMetadata& metadata);
 
-	virtual void unpack(const std::string& ouputFile) override;
+	virtual void unpack(std::ostream& output) override;
 	virtual void setupPackingMethod(std::uint8_t packingMethod);
 	virtual void readUnpackingStub(DynamicBuffer& unpackingStub);
 	virtual void readPackedData(DynamicBuffer& packedData, bool trustMetadata);
@@ -102,7 +102,7 @@ private:
 	void fixCoffSymbolTable();
 	void fixCertificates();
 	void cutHintsData(DynamicBuffer& unpackedData, const UpxExtraData& extraData);
-	void saveFile(const std::string& outputFile, DynamicBuffer& unpackedData);
+	void saveFile(std::ostream& output, DynamicBuffer& unpackedData);
 
 	void loadResources(PeLib::ResourceNode* rootNode, std::uint32_t offset, std::uint32_t uncompressedRsrcRva, std::uint32_t compressedRsrcRva,
 			const DynamicBuffer& uncompressedRsrcs, const DynamicBuffer& unpackedData, std::unordered_set<std::uint32_t>& visitedNodes);
@@ -92,7 +92,7 @@ void UpxPlugin::prepare()
 void UpxPlugin::unpack()
 {
 	log("Started unpacking of file '", _file->getFileFormat()->getPathToFile(), "'.");
-	_stub->unpack(getStartupArguments()->outputFile);
+	_stub->unpack(getOutput());
 }
 
 /**
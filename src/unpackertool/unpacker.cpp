@@ -4,13 +4,18 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <fstream>
+#include <map>
 #include <memory>
 
 #include "retdec/utils/conversion.h"
 #include "retdec/utils/filesystem.h"
 #include "retdec/utils/io/log.h"
 #include "retdec/utils/memory.h"
+#include "retdec/utils/string.h"
 #include "retdec/utils/version.h"
 #include "retdec/cpdetect/cpdetect.h"
 #include "retdec/fileformat/fileformat.h"
@@ -36,9 +41,44 @@ enum ExitCode
 	EXIT_CODE_NOTHING_TO_DO, ///< There was not found matching plugin.
 	EXIT_CODE_UNPACKING_FAILED, ///< At least one plugin failed at the unpacking of the file.
 	EXIT_CODE_PREPROCESSING_ERROR, ///< Error with preprocessing of input file before unpacking.
-	EXIT_CODE_MEMORY_LIMIT_ERROR ///< There was an error when setting the memory limit.
+	EXIT_CODE_MEMORY_LIMIT_ERROR, ///< There was an error when setting the memory limit.
+	EXIT_CODE_BENCHMARK_REGRESSION ///< Benchmark results are worse than the baseline.
 };
 
+void detectPackers(retdec::fileformat::FileFormat& fileParser, std::vector<retdec::cpdetect::DetectResult>& detectedPackers)
+{
+	using namespace retdec::cpdetect;
+
+	DetectParams detectionParams(SearchType::MOST_SIMILAR, true, false);
+
+	ToolInformation toolInfo;
+	CompilerDetector compilerDetector(fileParser, detectionParams, toolInfo);
+	compilerDetector.getAllInformation();
+
+	detectedPackers = toolInfo.detectedTools;
+}
+
+/**
+ * Check whether headers of the input allow it to be packed by a packer with a plugin.
+ *
+ * Supported packers leave recognizable traces in headers of PE and ELF files, so the full
+ * detection of packers, which parses the whole file and matches all signatures, runs only
+ * for those that look packed. Files in other formats are always inspected.
+ */
+bool mayBePacked(const retdec::fileformat::FormatSummary& summary)
+{
+	using namespace retdec::fileformat;
+
+	switch (summary.format)
+	{
+		case Format::PE:
+		case Format::ELF:
+			return summary.isPackedHint;
+		default:
+			return true;
+	}
+}
+
 bool detectPackers(const std::string& inputFile, std::vector<retdec::cpdetect::DetectResult>& detectedPackers)
 {
 	using namespace retdec::cpdetect;
@@ -47,7 +87,8 @@ bool detectPackers(const std::string& inputFile, std::vector<retdec::cpdetect::D
 	DetectParams detectionParams(SearchType::MOST_SIMILAR, true, false);
 
 	ToolInformation toolInfo;
-	switch (detectFileFormat(inputFile))
+	auto summary = detectFileFormatSummary(inputFile);
+	switch (summary.format)
 	{
 		case Format::UNDETECTABLE:
 			Log::error() << "Input file '" << inputFile << "' doesn't exist!" << std::endl;
@@ -57,6 +98,9 @@ bool detectPackers(const std::string& inputFile, std::vector<retdec::cpdetect::D
 			return false;
 		default:
 		{
+			if (!mayBePacked(summary))
+				break;
+
 			auto fileParser = createFileFormat(inputFile);
 			if (!fileParser)
 			{
@@ -84,7 +128,8 @@ bool detectPackers(const std::string& inputFile, std::vector<retdec::cpdetect::D
 	return true;
 }
 
-ExitCode unpackFile(const std::string& inputFile, const std::string& outputFile, bool brute, const std::vector<retdec::cpdetect::DetectResult>& detectedPackers)
+ExitCode unpackFile(const std::string& inputFile, const std::string& outputFile, bool brute, const std::vector<retdec::cpdetect::DetectResult>& detectedPackers,
+		std::vector<std::uint8_t>* unpackedData = nullptr, std::string* usedPlugin = nullptr)
 {
 	Plugin::Arguments pluginArgs = { inputFile, outputFile, brute };
 
@@ -108,6 +153,10 @@ ExitCode unpackFile(const std::string& inputFile, const std::string& outputFile,
 			if (pluginExitCode == PLUGIN_EXIT_UNPACKED)
 			{
 				plugin->log("Successfully unpacked '", inputFile, "'!");
+				if (unpackedData)
+					*unpackedData = plugin->getUnpackedData();
+				if (usedPlugin)
+					*usedPlugin = plugin->getInfo()->name;
 				return EXIT_CODE_OK;
 			}
 			else if (pluginExitCode == PLUGIN_EXIT_FAILED)
@@ -118,6 +167,203 @@ ExitCode unpackFile(const std::string& inputFile, const std::string& outputFile,
 	return ret;
 }
 
+/**
+ * Result of unpacking of one sample in the benchmark mode.
+ */
+struct BenchmarkResult
+{
+	std::string file; ///< Name of the sample.
+	std::string status; ///< @c unpacked, @c not-packed, @c failed or @c error.
+	std::string plugin; ///< Plugin that unpacked the sample, @c - if none did.
+	std::size_t inputSize = 0; ///< Size of the sample in bytes.
+	std::size_t outputSize = 0; ///< Size of the unpacked file in bytes.
+	double detectionMs = 0.0; ///< Time spent by the detection of packers.
+	double unpackingMs = 0.0; ///< Time spent by the plugins.
+	std::size_t peakMemory = 0; ///< Peak memory of the process after the sample.
+};
+
+std::ostream& operator<<(std::ostream& out, const BenchmarkResult& result)
+{
+	double throughput = result.unpackingMs > 0.0
+			? result.outputSize / (1024.0 * 1024.0) / (result.unpackingMs / 1000.0)
+			: 0.0;
+
+	return out << result.file
+		<< "\t" << result.status
+		<< "\t" << result.plugin
+		<< "\t" << result.inputSize
+		<< "\t" << result.outputSize
+		<< "\t" << result.detectionMs
+		<< "\t" << result.unpackingMs
+		<< "\t" << throughput
+		<< "\t" << result.peakMemory;
+}
+
+BenchmarkResult benchmarkFile(const fs::path& inputFile, bool brute)
+{
+	using Clock = std::chrono::steady_clock;
+	using Ms = std::chrono::duration<double, std::milli>;
+
+	BenchmarkResult result;
+	result.file = inputFile.filename().string();
+	result.plugin = "-";
+	result.inputSize = fs::file_size(inputFile);
+
+	std::vector<retdec::cpdetect::DetectResult> detectedPackers;
+	auto start = Clock::now();
+	bool detected = detectPackers(inputFile.string(), detectedPackers);
+	result.detectionMs = Ms(Clock::now() - start).count();
+
+	if (!detected)
+	{
+		result.status = "error";
+	}
+	else
+	{
+		// Unpacked data are only kept in memory, so that the disk does not
+		// distort the measurement.
+		std::vector<std::uint8_t> unpackedData;
+		start = Clock::now();
+		auto ret = unpackFile(inputFile.string(), std::string{}, brute, detectedPackers, &unpackedData, &result.plugin);
+		result.unpackingMs = Ms(Clock::now() - start).count();
+		result.outputSize = unpackedData.size();
+
+		switch (ret)
+		{
+			case EXIT_CODE_OK:
+				result.status = "unpacked";
+				break;
+			case EXIT_CODE_NOTHING_TO_DO:
+				result.status = "not-packed";
+				break;
+			default:
+				result.status = "failed";
+				break;
+		}
+	}
+
+	result.peakMemory = getPeakProcessMemory();
+	return result;
+}
+
+/**
+ * Load results stored by an earlier run of the benchmark.
+ *
+ * @param baselineFile File with the output of the benchmark mode.
+ * @param baseline Results indexed by names of samples.
+ * @return @c true if the file could be read, otherwise @c false.
+ */
+bool loadBenchmarkBaseline(const std::string& baselineFile, std::map<std::string, BenchmarkResult>& baseline)
+{
+	std::ifstream in(baselineFile);
+	if (!in)
+		return false;
+
+	std::string line;
+	while (std::getline(in, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		auto columns = split(line, '\t');
+		if (columns.size() < 7)
+			continue;
+
+		BenchmarkResult result;
+		result.file = columns[0];
+		result.status = columns[1];
+		result.plugin = columns[2];
+		strToNum(columns[3], result.inputSize);
+		strToNum(columns[4], result.outputSize);
+		strToNum(columns[5], result.detectionMs);
+		strToNum(columns[6], result.unpackingMs);
+		baseline[result.file] = result;
+	}
+
+	return true;
+}
+
+/**
+ * Check whether the time is worse than the time in the baseline.
+ *
+ * Short runs are dominated by noise, so only slowdowns over a quarter of the
+ * baseline time and also over a few milliseconds are reported.
+ */
+bool isSlowerThan(double time, double baselineTime)
+{
+	return time > 1.25 * baselineTime && time - baselineTime > 5.0;
+}
+
+/**
+ * Unpack all regular files in the given directory and print one line of
+ * tab-separated results for each of them.
+ *
+ * The output may be stored and given to the later runs as a baseline. Samples
+ * whose status, plugin or output size differs from the baseline, or which are
+ * significantly slower than in the baseline, are then reported as regressions.
+ * The peak memory is the high-water mark of the whole process after the sample,
+ * so it grows only with samples that need more memory than all the previous ones.
+ */
+ExitCode runBenchmark(const std::string& directory, const std::string& baselineFile, bool brute)
+{
+	if (!fs::is_directory(directory))
+	{
+		Log::error() << "Benchmark directory '" << directory << "' doesn't exist!" << std::endl;
+		return EXIT_CODE_PREPROCESSING_ERROR;
+	}
+
+	std::map<std::string, BenchmarkResult> baseline;
+	if (!baselineFile.empty() && !loadBenchmarkBaseline(baselineFile, baseline))
+	{
+		Log::error() << "Unable to read benchmark baseline '" << baselineFile << "'!" << std::endl;
+		return EXIT_CODE_PREPROCESSING_ERROR;
+	}
+
+	std::vector<fs::path> samples;
+	for (const auto& entry : fs::directory_iterator(directory))
+	{
+		if (fs::is_regular_file(entry.path()))
+			samples.push_back(entry.path());
+	}
+	std::sort(samples.begin(), samples.end());
+
+	Log::info() << "# file\tstatus\tplugin\tinput_size\toutput_size"
+		<< "\tdetection_ms\tunpacking_ms\tthroughput_mbps\tpeak_memory" << std::endl;
+
+	std::size_t regressions = 0;
+	for (const auto& sample : samples)
+	{
+		auto result = benchmarkFile(sample, brute);
+		Log::info() << result << std::endl;
+
+		auto baselineIt = baseline.find(result.file);
+		if (baselineIt == baseline.end())
+			continue;
+
+		const auto& expected = baselineIt->second;
+		if (result.status != expected.status
+				|| result.plugin != expected.plugin
+				|| result.outputSize != expected.outputSize)
+		{
+			Log::error() << "Regression: '" << result.file << "' was " << expected.status
+				<< " by " << expected.plugin << " to " << expected.outputSize << " bytes, now it is "
+				<< result.status << " by " << result.plugin << " to " << result.outputSize << " bytes" << std::endl;
+			++regressions;
+		}
+		else if (isSlowerThan(result.detectionMs, expected.detectionMs)
+				|| isSlowerThan(result.unpackingMs, expected.unpackingMs))
+		{
+			Log::error() << "Regression: '" << result.file << "' took "
+				<< result.detectionMs << " + " << result.unpackingMs << " ms, baseline is "
+				<< expected.detectionMs << " + " << expected.unpackingMs << " ms" << std::endl;
+			++regressions;
+		}
+	}
+
+	Log::info() << "# peak memory: " << getPeakProcessMemory() << " bytes" << std::endl;
+	return regressions == 0 ? EXIT_CODE_OK : EXIT_CODE_BENCHMARK_REGRESSION;
+}
+
 ExitCode processArgs(ArgHandler& handler, char argc, char** argv)
 {
 	// In case of failed parsing just print the help
@@ -185,6 +431,12 @@ ExitCode processArgs(ArgHandler& handler, char argc, char** argv)
 				<< "' (" << info->author << ")" << std::endl;
 		}
 	}
+	// --benchmark DIR [--baseline FILE]
+	else if (handler["benchmark"]->used)
+	{
+		std::string baselineFile = handler["baseline"]->used ? handler["baseline"]->input : std::string{};
+		return runBenchmark(handler["benchmark"]->input, baselineFile, brute);
+	}
 	// PACKED_FILE [-o|--output FILE]
 	else if (handler.getRawInputs().size() == 1)
 	{
@@ -204,6 +456,35 @@ ExitCode processArgs(ArgHandler& handler, char argc, char** argv)
 	return EXIT_CODE_OK;
 }
 
+bool isPacked(const std::uint8_t* data, std::size_t size)
+{
+	if (!mayBePacked(retdec::fileformat::detectFileFormatSummary(data, size)))
+		return false;
+
+	auto fileParser = retdec::fileformat::createFileFormat(data, size);
+	if (!fileParser)
+		return false;
+
+	std::vector<retdec::cpdetect::DetectResult> detectedPackers;
+	detectPackers(*fileParser, detectedPackers);
+	for (const auto& detectedPacker : detectedPackers)
+	{
+		if (!PluginMgr::matchingPlugins(detectedPacker.name, detectedPacker.versionInfo).empty())
+			return true;
+	}
+
+	return false;
+}
+
+int unpack(const std::string& inputFile, std::vector<std::uint8_t>& unpackedData, bool brute)
+{
+	std::vector<retdec::cpdetect::DetectResult> detectedPackers;
+	if (!detectPackers(inputFile, detectedPackers))
+		return EXIT_CODE_PREPROCESSING_ERROR;
+
+	return unpackFile(inputFile, std::string{}, brute, detectedPackers, &unpackedData);
+}
+
 int _main(int argc, char** argv)
 {
 	ArgHandler handler("unpacker options [PACKED_FILE] [optional]");
@@ -222,6 +503,13 @@ int _main(int argc, char** argv)
 			"Listing group:\n"
 			"   -p|--plugins           Show the list of all available plugins.\n"
 			"\n"
+			"Benchmark group:\n"
+			"   --benchmark DIR        Unpack all files in DIR in memory and print tab-separated results\n"
+			"                          of each of them: status, plugin, input and output size, time of\n"
+			"                          detection and unpacking, throughput and peak memory.\n"
+			"   --baseline FILE        Optional. Compare results with the output of an earlier benchmark\n"
+			"                          stored in FILE and fail if any sample regressed.\n"
+			"\n"
 			"Unpacking group:\n"
 			"   PACKED_FILE            Specify the packed file, which is needed to be unpacked.\n"
 			"   -o|--output FILE       Optional. Specify the output file of unpacking as FILE.\n"
@@ -238,6 +526,8 @@ int _main(int argc, char** argv)
 	handler.registerArg('v', "version", false);
 	handler.registerArg('o', "output", true);
 	handler.registerArg('p', "plugins", false);
+	handler.registerArg('B', "benchmark", true);
+	handler.registerArg('L', "baseline", true);
 	handler.registerArg('b', "brute", false);
 	handler.registerArg('m', "max-memory", true);
 	handler.registerArg('M', "max-memory-half-ram", false);
@@ -930,10 +930,43 @@ bool ByteValueStorage::createValueFromBytes(
 		std::uint64_t offset,
 		std::uint64_t size) const
 {
-	const std::uint64_t realSize = (!size || offset + size > data.size())
-			? data.size() - offset
+	return createValueFromBytes(
+			data.data(),
+			data.size(),
+			value,
+			endian,
+			offset,
+			size
+	);
+}
+
+/**
+ * Create integer from an array of bytes
+ *
+ * @param data Array of bytes
+ * @param dataSize Number of bytes in @a data
+ * @param value Resulted value
+ * @param endian Endian - if specified it is forced, otherwise file's endian
+ *               is used
+ * @param offset Offset of first byte from @a data which will be converted
+ *    (0 means first offset from @a data)
+ * @param size Number of bytes for conversion (0 means all bytes from @a offset
+ *    to end of @a data)
+ *
+ * @return @c true if conversion went OK, @c false otherwise
+ */
+bool ByteValueStorage::createValueFromBytes(
+		const std::uint8_t* data,
+		std::size_t dataSize,
+		std::uint64_t& value,
+		Endianness endian,
+		std::uint64_t offset,
+		std::uint64_t size) const
+{
+	const std::uint64_t realSize = (!size || offset + size > dataSize)
+			? dataSize - offset
 			: size;
-	if (offset >= data.size() || (size && realSize != size))
+	if (offset >= dataSize || (size && realSize != size))
 	{
 		return false;
 	}
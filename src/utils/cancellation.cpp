@@ -0,0 +1,196 @@
+/**
+ * @file src/utils/cancellation.cpp
+ * @brief Cooperative cancellation of long-running operations.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include "retdec/utils/cancellation.h"
+#include "retdec/utils/memory.h"
+
+namespace retdec {
+namespace utils {
+
+namespace {
+
+/// Token of the operation run by the current thread.
+thread_local CancellationToken* currentToken = nullptr;
+
+/// How often the memory usage is sampled for the soft memory limit.
+const auto MEMORY_SAMPLE_PERIOD = std::chrono::milliseconds(50);
+
+} // anonymous namespace
+
+//
+//==============================================================================
+// OperationCancelled
+//==============================================================================
+//
+
+OperationCancelled::OperationCancelled()
+		: std::runtime_error("operation cancelled")
+{
+}
+
+//
+//==============================================================================
+// CancellationToken
+//==============================================================================
+//
+
+/**
+ * Requests cancellation of the operation. It is safe to call it from any
+ * thread.
+ */
+void CancellationToken::cancel()
+{
+	_cancelled = true;
+}
+
+/**
+ * The operation is cancelled when @a deadline passes.
+ * It has to be set before the operation is started.
+ */
+void CancellationToken::setDeadline(Clock::time_point deadline)
+{
+	_deadline = deadline;
+}
+
+/**
+ * Every phase started by @c startPhase() gets time @a budget.
+ * Zero budget (the default) means that phases are not limited.
+ */
+void CancellationToken::setPhaseBudget(Clock::duration budget)
+{
+	_phaseBudget = budget;
+}
+
+/**
+ * Every phase is considered out of its budget while the process uses more
+ * than @a limit bytes of memory. Zero limit (the default) means that memory
+ * is not limited.
+ */
+void CancellationToken::setMemoryLimit(std::size_t limit)
+{
+	_memoryLimit = limit;
+}
+
+/**
+ * Starts a new phase, i.e. its time budget is counted from now.
+ */
+void CancellationToken::startPhase()
+{
+	_phaseDeadline = _phaseBudget == Clock::duration::zero()
+			? Clock::time_point::max()
+			: Clock::now() + _phaseBudget;
+}
+
+bool CancellationToken::isCancelled() const
+{
+	return _cancelled
+			|| (_deadline != Clock::time_point::max()
+					&& Clock::now() >= _deadline);
+}
+
+bool CancellationToken::isPhaseBudgetExpired() const
+{
+	return (_phaseDeadline != Clock::time_point::max()
+					&& Clock::now() >= _phaseDeadline)
+			|| isMemoryLimitExceeded();
+}
+
+bool CancellationToken::isMemoryLimitExceeded() const
+{
+	if (_memoryLimit == 0)
+	{
+		return false;
+	}
+
+	auto now = Clock::now().time_since_epoch().count();
+	if (now >= _nextMemorySample)
+	{
+		_nextMemorySample = now + Clock::duration(MEMORY_SAMPLE_PERIOD).count();
+		_memoryLimitExceeded = getCurrentProcessMemory() > _memoryLimit;
+	}
+	return _memoryLimitExceeded;
+}
+
+/**
+ * @throw OperationCancelled If the operation is cancelled.
+ */
+void CancellationToken::throwIfCancelled() const
+{
+	if (isCancelled())
+	{
+		throw OperationCancelled();
+	}
+}
+
+//
+//==============================================================================
+// CancellationScope
+//==============================================================================
+//
+
+CancellationScope::CancellationScope(CancellationToken& token)
+		: _previous(currentToken)
+{
+	currentToken = &token;
+}
+
+CancellationScope::~CancellationScope()
+{
+	currentToken = _previous;
+}
+
+//
+//==============================================================================
+// Current token.
+//==============================================================================
+//
+
+/**
+ * Returns the current token of the calling thread, or @c nullptr if no
+ * @c CancellationScope is active in it.
+ */
+CancellationToken* getCurrentCancellationToken()
+{
+	return currentToken;
+}
+
+bool isCancellationRequested()
+{
+	return currentToken && currentToken->isCancelled();
+}
+
+/**
+ * A cancellation point: stops the current operation if it was cancelled.
+ * @throw OperationCancelled If the operation is cancelled.
+ */
+void throwIfCancellationRequested()
+{
+	if (currentToken)
+	{
+		currentToken->throwIfCancelled();
+	}
+}
+
+void startCancellationPhase()
+{
+	if (currentToken)
+	{
+		currentToken->startPhase();
+	}
+}
+
+bool isPhaseBudgetExpired()
+{
+	return currentToken && currentToken->isPhaseBudgetExpired();
+}
+
+bool isMemoryLimitExceeded()
+{
+	return currentToken && currentToken->isMemoryLimitExceeded();
+}
+
+} // namespace utils
+} // namespace retdec
@@ -52,6 +52,22 @@ DynamicBuffer::DynamicBuffer(
 {
 }
 
+/**
+ * Creates the DynamicBuffer object which takes over specified data with
+ * specified endianness.
+ *
+ * @param data The bytes to initialize the buffer with.
+ * @param endianness Endiannes of the bytes in the buffer.
+ */
+DynamicBuffer::DynamicBuffer(
+		std::vector<uint8_t>&& data,
+		Endianness endianness)
+		: _data(std::move(data))
+		, _endianness(endianness)
+		, _capacity(static_cast<uint32_t>(_data.size()))
+{
+}
+
 /**
  * Creates the copy of the DynamicBuffer object.
  *
@@ -64,6 +80,20 @@ DynamicBuffer::DynamicBuffer(const DynamicBuffer& dynamicBuffer)
 {
 }
 
+/**
+ * Moves the DynamicBuffer object.
+ *
+ * @param dynamicBuffer Buffer to move, it is left empty.
+ */
+DynamicBuffer::DynamicBuffer(DynamicBuffer&& dynamicBuffer) noexcept
+		: _data(std::move(dynamicBuffer._data))
+		, _endianness(dynamicBuffer._endianness)
+		, _capacity(dynamicBuffer._capacity)
+{
+	dynamicBuffer._data.clear();
+	dynamicBuffer._capacity = 0;
+}
+
 /**
  * Creates the copy of the DynamicBuffer object, but only the
  * specified subbuffer.
@@ -77,16 +107,26 @@ DynamicBuffer::DynamicBuffer(
 		const DynamicBuffer& dynamicBuffer,
 		uint32_t startPos,
 		uint32_t amount)
+		: _data(dynamicBuffer._data.begin() + startPos,
+				dynamicBuffer._data.begin() + startPos + amount)
+		, _endianness(dynamicBuffer._endianness)
+		, _capacity(amount)
+{
+}
+
+/**
+ * Creates the DynamicBuffer object and fills it with the copy of the
+ * specified data (e.g. a view of the part of another buffer that is about to
+ * be modified) with specified endianness.
+ *
+ * @param data The bytes to initialize the buffer with.
+ * @param endianness Endiannes of the bytes in the buffer.
+ */
+DynamicBuffer::DynamicBuffer(Span<const uint8_t> data, Endianness endianness)
+		: _data(data.begin(), data.end())
+		, _endianness(endianness)
+		, _capacity(static_cast<uint32_t>(data.size()))
 {
-	std::vector<uint8_t> tmpBuffer = dynamicBuffer.getBuffer();
-	std::vector<uint8_t> buffer(
-			tmpBuffer.begin() + startPos,
-			tmpBuffer.begin() + startPos + amount
-	);
-
-	_data = buffer;
-	_endianness = dynamicBuffer._endianness;
-	_capacity = static_cast<uint32_t>(buffer.size());
 }
 
 /**
@@ -193,6 +233,51 @@ const uint8_t* DynamicBuffer::getRawBuffer() const
 	return _data.data();
 }
 
+/**
+ * Gets the non-owning view of the bytes in the buffer. The view is valid
+ * until the buffer is modified by something else than the view itself.
+ *
+ * @return The view of the bytes in the buffer.
+ */
+Span<const uint8_t> DynamicBuffer::getSpan() const
+{
+	return Span<const uint8_t>(_data);
+}
+
+/**
+ * @copydoc getSpan() const
+ */
+Span<uint8_t> DynamicBuffer::getSpan()
+{
+	return Span<uint8_t>(_data);
+}
+
+/**
+ * Gets the non-owning view of the part of the bytes in the buffer. The range
+ * is clamped to the real data, so this never copies nor resizes the buffer.
+ * Construct a new DynamicBuffer from the view to get a copy that can be
+ * modified independently.
+ *
+ * @param startPos Starting position of the view.
+ * @param amount Number of bytes from startPos in the view.
+ *
+ * @return The view of the bytes in the buffer.
+ */
+Span<const uint8_t> DynamicBuffer::getSpan(
+		uint32_t startPos,
+		uint32_t amount) const
+{
+	return getSpan().subspan(startPos, amount);
+}
+
+/**
+ * @copydoc getSpan(uint32_t,uint32_t) const
+ */
+Span<uint8_t> DynamicBuffer::getSpan(uint32_t startPos, uint32_t amount)
+{
+	return getSpan().subspan(startPos, amount);
+}
+
 /**
  * Runs the specified function for every single byte in the DynamicBuffer.
  *
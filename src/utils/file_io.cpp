@@ -9,5 +9,34 @@
 namespace retdec {
 namespace utils {
 
+/**
+ * Write bytes to file without copying them into a vector first
+ *
+ * @param fileStream Representation of output file
+ * @param data Data to write into the file
+ * @param start Start offset of write
+ * @param desiredSize Number of bytes to write. If this parameter is set
+ *        to zero, function will write all bytes from @c data.
+ *
+ * @return @c true if operation went OK, otherwise @c false
+ */
+bool writeFile(
+		std::ostream& fileStream,
+		Span<const std::uint8_t> data,
+		std::size_t start,
+		std::size_t desiredSize)
+{
+	fileStream.seekp(start, std::ios::beg);
+	if (!fileStream.good())
+		return false;
+
+	// If no size specified, write the whole data.
+	if (!desiredSize || desiredSize > data.size())
+		desiredSize = data.size();
+
+	fileStream.write(reinterpret_cast<const char*>(data.data()), desiredSize);
+	return fileStream.good();
+}
+
 } // namespace utils
 } // namespace retdec
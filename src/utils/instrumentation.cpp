@@ -0,0 +1,479 @@
+/**
+ * @file src/utils/instrumentation.cpp
+ * @brief Scoped timers and named counters for hot-path instrumentation.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "retdec/utils/instrumentation.h"
+
+namespace retdec {
+namespace utils {
+namespace instrumentation {
+
+namespace detail {
+
+std::atomic<bool> enabled{false};
+std::atomic<bool> tracing{false};
+
+} // namespace detail
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Maximal number of trace events kept for one thread. Further events are
+/// only counted.
+const std::size_t MAX_TRACE_EVENTS = 1 << 20;
+/// Counter of trace events that were not kept.
+const char DROPPED_EVENTS_COUNTER[] = "instrumentation.droppedTraceEvents";
+
+struct TraceEvent
+{
+	const char* name = nullptr;
+	std::uint64_t startNs = 0;
+	std::uint64_t durationNs = 0;
+	/// Arguments as members of a JSON object.
+	std::string args;
+};
+
+/**
+ * Span or phase that has not ended yet.
+ */
+struct OpenSpan
+{
+	const char* name = nullptr;
+	std::uint64_t startNs = 0;
+	/// Nesting level of a phase.
+	unsigned level = 0;
+};
+
+/**
+ * Measurements of one thread. They are written only by their thread, the
+ * mutex is contended only while they are collected.
+ */
+struct ThreadData
+{
+	std::mutex mutex;
+	unsigned id = 0;
+	std::unordered_map<const char*, TimerStats> timers;
+	std::unordered_map<const char*, std::uint64_t> counters;
+	std::vector<TraceEvent> events;
+	/// Spans started by beginSpan(), the innermost one is the last.
+	std::vector<OpenSpan> spans;
+	/// Phases started by beginPhase(), the innermost one is the last.
+	std::vector<OpenSpan> phases;
+};
+
+/**
+ * Measurements of all threads that have ever measured something. They are
+ * kept even after their threads end.
+ */
+struct Registry
+{
+	std::mutex mutex;
+	std::vector<std::shared_ptr<ThreadData>> threads;
+};
+
+const Clock::time_point epoch = Clock::now();
+
+Registry& getRegistry()
+{
+	static Registry registry;
+	return registry;
+}
+
+ThreadData& getThreadData()
+{
+	thread_local std::shared_ptr<ThreadData> data = [] {
+		auto d = std::make_shared<ThreadData>();
+		auto& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		d->id = registry.threads.size() + 1;
+		registry.threads.push_back(d);
+		return d;
+	}();
+	return *data;
+}
+
+std::vector<std::shared_ptr<ThreadData>> getThreads()
+{
+	auto& registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	return registry.threads;
+}
+
+std::uint64_t toNs(Clock::duration d)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+}
+
+void writeJsonString(std::ostream& out, const std::string& str)
+{
+	out << '"';
+	for (unsigned char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			out << '\\' << c;
+		}
+		else if (c < 0x20)
+		{
+			char buffer[8];
+			std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+			out << buffer;
+		}
+		else
+		{
+			out << c;
+		}
+	}
+	out << '"';
+}
+
+/**
+ * Record trace event @a e of a thread with measurements @a data. The caller
+ * has to hold the mutex of @a data.
+ */
+void addEvent(ThreadData& data, TraceEvent&& e)
+{
+	if (data.events.size() < MAX_TRACE_EVENTS)
+	{
+		data.events.push_back(std::move(e));
+	}
+	else
+	{
+		++data.counters[DROPPED_EVENTS_COUNTER];
+	}
+}
+
+/**
+ * End the spans and phases of the calling thread which have not ended yet.
+ */
+void endOpenSpans()
+{
+	auto now = toNs(Clock::now() - epoch);
+	auto& data = getThreadData();
+	std::lock_guard<std::mutex> lock(data.mutex);
+	for (auto* open : {&data.spans, &data.phases})
+	{
+		while (!open->empty())
+		{
+			auto& s = open->back();
+			addEvent(data, {s.name, s.startNs, now - s.startNs, {}});
+			open->pop_back();
+		}
+	}
+}
+
+/**
+ * Write time in nanoseconds as microseconds, the unit of trace events.
+ */
+void writeUs(std::ostream& out, std::uint64_t ns)
+{
+	out << ns / 1000 << '.';
+	char buffer[4];
+	std::snprintf(buffer, sizeof(buffer), "%03u", unsigned(ns % 1000));
+	out << buffer;
+}
+
+} // anonymous namespace
+
+/**
+ * @return Measurements collected since @a other was collected. Timers and
+ *         counters that did not change are omitted. Maximal scope times
+ *         cannot be subtracted, they are taken from this object.
+ */
+Stats Stats::operator-(const Stats& other) const
+{
+	Stats ret;
+	for (auto& t : timers)
+	{
+		auto o = other.timers.find(t.first);
+		auto diff = t.second;
+		if (o != other.timers.end())
+		{
+			diff.count -= o->second.count;
+			diff.totalNs -= o->second.totalNs;
+		}
+		if (diff.count)
+		{
+			ret.timers.emplace(t.first, diff);
+		}
+	}
+	for (auto& c : counters)
+	{
+		auto o = other.counters.find(c.first);
+		auto diff = c.second - (o != other.counters.end() ? o->second : 0);
+		if (diff)
+		{
+			ret.counters.emplace(c.first, diff);
+		}
+	}
+	return ret;
+}
+
+/**
+ * Enable or disable collection of measurements in the whole process.
+ * Disabling it keeps what was already collected.
+ */
+void setEnabled(bool enabled)
+{
+	detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * Enable or disable recording of every timed scope as a trace event for
+ * @c writeChromeTrace(). It has an effect only while measurements are
+ * collected.
+ */
+void setTracing(bool t)
+{
+	detail::tracing.store(t, std::memory_order_relaxed);
+}
+
+/**
+ * Add @a value to the counter called @a name. The name has to be a string
+ * with static storage duration. Use the @c RETDEC_COUNTER_ADD macro, which
+ * calls this only if measurements are collected.
+ */
+void addToCounter(const char* name, std::uint64_t value)
+{
+	auto& data = getThreadData();
+	std::lock_guard<std::mutex> lock(data.mutex);
+	data.counters[name] += value;
+}
+
+/**
+ * @return Name equal to @a name with static storage duration, for timers and
+ *         counters whose names are known only at run time.
+ */
+const char* intern(const std::string& name)
+{
+	static std::mutex mutex;
+	static std::unordered_set<std::string> names;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	// Elements of unordered sets are not moved by rehashing.
+	return names.insert(name).first->c_str();
+}
+
+/**
+ * Start a span of the calling thread called @a name, which has to be a string
+ * with static storage duration. Unlike timed scopes, spans are only traced,
+ * they are not aggregated. Use the @c RETDEC_TRACE_BEGIN macro.
+ */
+void beginSpan(const char* name)
+{
+	if (!isTracing())
+	{
+		return;
+	}
+
+	auto start = toNs(Clock::now() - epoch);
+	auto& data = getThreadData();
+	std::lock_guard<std::mutex> lock(data.mutex);
+	data.spans.push_back({name, start});
+}
+
+/**
+ * End the last span started by @c beginSpan() on the calling thread. Spans
+ * that did not end before the trace is written end at that time.
+ */
+void endSpan()
+{
+	auto end = toNs(Clock::now() - epoch);
+	auto& data = getThreadData();
+	std::lock_guard<std::mutex> lock(data.mutex);
+	if (data.spans.empty())
+	{
+		return;
+	}
+
+	auto& s = data.spans.back();
+	addEvent(data, {s.name, s.startNs, end - s.startNs, {}});
+	data.spans.pop_back();
+}
+
+/**
+ * Start a phase of the calling thread called @a name. Phases do not end
+ * explicitly: a phase at @a level ends the previous phase at the same level
+ * and all the phases nested in it. Use the @c RETDEC_TRACE_PHASE macro.
+ */
+void beginPhase(const std::string& name, unsigned level)
+{
+	if (!isTracing())
+	{
+		return;
+	}
+
+	auto* interned = intern(name);
+	auto now = toNs(Clock::now() - epoch);
+	auto& data = getThreadData();
+	std::lock_guard<std::mutex> lock(data.mutex);
+	while (!data.phases.empty() && data.phases.back().level >= level)
+	{
+		auto& p = data.phases.back();
+		addEvent(data, {p.name, p.startNs, now - p.startNs, {}});
+		data.phases.pop_back();
+	}
+	data.phases.push_back({interned, now, level});
+}
+
+void ScopedTimer::stop()
+{
+	auto end = Clock::now();
+	auto duration = toNs(end - _start);
+
+	auto& data = getThreadData();
+	std::lock_guard<std::mutex> lock(data.mutex);
+
+	auto& stats = data.timers[_name];
+	++stats.count;
+	stats.totalNs += duration;
+	stats.maxNs = std::max(stats.maxNs, duration);
+
+	if (isTracing())
+	{
+		addEvent(data, {_name, toNs(_start - epoch), duration, std::move(_args)});
+	}
+}
+
+void ScopedTimer::appendArg(const char* key, std::uint64_t value)
+{
+	std::ostringstream out;
+	out << (_args.empty() ? "" : ",");
+	writeJsonString(out, key);
+	out << ':' << value;
+	_args += out.str();
+}
+
+void ScopedTimer::appendArg(const char* key, const std::string& value)
+{
+	std::ostringstream out;
+	out << (_args.empty() ? "" : ",");
+	writeJsonString(out, key);
+	out << ':';
+	writeJsonString(out, value);
+	_args += out.str();
+}
+
+/**
+ * @return Measurements of all threads merged by their names.
+ */
+Stats collect()
+{
+	Stats ret;
+	for (auto& data : getThreads())
+	{
+		std::lock_guard<std::mutex> lock(data->mutex);
+		for (auto& t : data->timers)
+		{
+			auto& stats = ret.timers[t.first];
+			stats.count += t.second.count;
+			stats.totalNs += t.second.totalNs;
+			stats.maxNs = std::max(stats.maxNs, t.second.maxNs);
+		}
+		for (auto& c : data->counters)
+		{
+			ret.counters[c.first] += c.second;
+		}
+	}
+	return ret;
+}
+
+/**
+ * Drop all the collected measurements and trace events.
+ */
+void reset()
+{
+	for (auto& data : getThreads())
+	{
+		std::lock_guard<std::mutex> lock(data->mutex);
+		data->timers.clear();
+		data->counters.clear();
+		data->events.clear();
+		data->spans.clear();
+		data->phases.clear();
+	}
+}
+
+/**
+ * Write the recorded trace events in the Chrome trace event format, which
+ * is understood by @c chrome://tracing and Perfetto. Timed scopes are
+ * written as complete events on the threads that measured them, counters
+ * as counter events at the time of writing. Spans and phases of the calling
+ * thread that have not ended yet end now.
+ * @return @c true if the trace was written, @c false otherwise.
+ */
+bool writeChromeTrace(std::ostream& out)
+{
+	endOpenSpans();
+
+	auto now = toNs(Clock::now() - epoch);
+	bool first = true;
+	auto separator = [&out, &first]() {
+		out << (first ? "\n" : ",\n");
+		first = false;
+	};
+
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (auto& data : getThreads())
+	{
+		std::lock_guard<std::mutex> lock(data->mutex);
+		separator();
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+				<< data->id << ",\"args\":{\"name\":\"thread " << data->id
+				<< "\"}}";
+		for (auto& e : data->events)
+		{
+			separator();
+			out << "{\"name\":";
+			writeJsonString(out, e.name);
+			out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << data->id << ",\"ts\":";
+			writeUs(out, e.startNs);
+			out << ",\"dur\":";
+			writeUs(out, e.durationNs);
+			if (!e.args.empty())
+			{
+				out << ",\"args\":{" << e.args << "}";
+			}
+			out << "}";
+		}
+	}
+	for (auto& c : collect().counters)
+	{
+		separator();
+		out << "{\"name\":";
+		writeJsonString(out, c.first);
+		out << ",\"ph\":\"C\",\"pid\":1,\"ts\":";
+		writeUs(out, now);
+		out << ",\"args\":{\"value\":" << c.second << "}}";
+	}
+	out << "\n]}\n";
+
+	return static_cast<bool>(out);
+}
+
+/**
+ * Write the recorded trace events into @a outFile.
+ * @see writeChromeTrace(std::ostream&)
+ */
+bool writeChromeTrace(const std::string& outFile)
+{
+	std::ofstream out(outFile);
+	return out && writeChromeTrace(out);
+}
+
+} // namespace instrumentation
+} // namespace utils
+} // namespace retdec
@@ -0,0 +1,107 @@
+/**
+ * @file src/utils/interned_string.cpp
+ * @brief Process-wide interning of strings.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <array>
+#include <mutex>
+#include <unordered_set>
+
+#include "retdec/utils/interned_string.h"
+
+namespace retdec {
+namespace utils {
+
+namespace {
+
+/**
+ * The pool is split into shards by hashes of the strings, so that threads
+ * interning different strings rarely wait for each other.
+ */
+class StringPool
+{
+	public:
+		const std::string* intern(const std::string& str)
+		{
+			auto& shard = shards[std::hash<std::string>()(str) % shards.size()];
+			std::lock_guard<std::mutex> lock(shard.mutex);
+			// Elements of unordered sets never move, so the pointer remains
+			// valid when the set grows.
+			return &*shard.strings.insert(str).first;
+		}
+
+		std::size_t size()
+		{
+			std::size_t size = 0;
+			for (auto& shard : shards)
+			{
+				std::lock_guard<std::mutex> lock(shard.mutex);
+				size += shard.strings.size();
+			}
+			return size;
+		}
+
+	private:
+		struct Shard
+		{
+			std::mutex mutex;
+			std::unordered_set<std::string> strings;
+		};
+
+		std::array<Shard, 16> shards;
+};
+
+StringPool& getPool()
+{
+	// Constructed on first use, so that strings may be interned during
+	// initialization of other static objects.
+	static StringPool pool;
+	return pool;
+}
+
+const std::string* getEmptyString()
+{
+	static const std::string* empty = getPool().intern(std::string());
+	return empty;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Creates a handle of the empty string.
+ */
+InternedString::InternedString() :
+		_str(getEmptyString())
+{
+
+}
+
+/**
+ * @brief Interns @a str.
+ */
+InternedString::InternedString(const std::string& str) :
+		_str(str.empty() ? getEmptyString() : getPool().intern(str))
+{
+
+}
+
+/**
+ * @brief Interns @a str.
+ */
+InternedString::InternedString(const char* str) :
+		InternedString(std::string(str))
+{
+
+}
+
+/**
+ * @brief Returns the number of strings in the pool.
+ */
+std::size_t InternedString::getPoolSize()
+{
+	return getPool().size();
+}
+
+} // namespace utils
+} // namespace retdec
@@ -6,6 +6,7 @@
 
 #include <cassert>
 
+#include "retdec/utils/instrumentation.h"
 #include "retdec/utils/io/log.h"
 
 namespace retdec {
@@ -59,6 +60,11 @@ Logger Log::info()
 void Log::phase(const std::string& phase, const Log::Action& action)
 {
 	Log::info() << action << phase << Log::ElapsedTime << std::endl;
+
+	if (action >= Log::Action::Phase && action <= Log::Action::SubSubPhase)
+	{
+		RETDEC_TRACE_PHASE(phase, action - Log::Action::Phase);
+	}
 }
 
 Logger Log::debug()
@@ -4,9 +4,15 @@
 * @copyright (c) 2020 Avast Software, licensed under the MIT license
 */
 
+#include <atomic>
+#include <condition_variable>
 #include <iomanip>
 #include <map>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "retdec/utils/io/logger.h"
 #include "retdec/utils/os.h"
@@ -155,6 +161,220 @@ FileLogger::FileLogger(const std::string& file, bool verbose):
 		throw std::runtime_error("unable to open file \""+file+"\" for writing.");
 }
 
+//////////
+//
+// AsyncLogger
+//
+//////
+
+namespace {
+
+/// Identifiers of AsyncLogger buffers, so that a buffer cached by a thread
+/// is never mistaken for another one created at the same address.
+std::atomic<std::uint64_t> nextBufferId(1);
+
+/// Record being written by this thread, cached for the last used buffer.
+struct PendingRecord
+{
+	std::uint64_t bufferId = 0;
+	std::string* record = nullptr;
+};
+thread_local PendingRecord pendingRecord;
+
+} // anonymous namespace
+
+/**
+ * Stream buffer collecting records of every thread separately and writing
+ * complete records to the target on a background thread. It has no put
+ * area, so that every output goes to the current thread's record.
+ */
+class AsyncLogger::Buffer : public std::streambuf {
+public:
+	explicit Buffer(std::ostream& target);
+	~Buffer();
+
+	void flush(bool allThreads);
+
+protected:
+	int_type overflow(int_type c) override;
+	std::streamsize xsputn(const char* s, std::streamsize n) override;
+	int sync() override;
+
+private:
+	std::string& pending();
+	void complete(std::string&& record);
+	void write();
+
+private:
+	std::ostream& _target;
+	const std::uint64_t _id;
+
+	std::mutex _pendingMutex;
+	std::unordered_map<std::thread::id, std::string> _pending;
+
+	std::mutex _queueMutex;
+	std::condition_variable _queued;
+	std::condition_variable _written;
+	std::vector<std::string> _queue;
+	bool _writing = false;
+	bool _stop = false;
+
+	std::thread _writer;
+};
+
+AsyncLogger::Buffer::Buffer(std::ostream& target):
+	_target(target),
+	_id(nextBufferId++),
+	_writer(&Buffer::write, this)
+{
+}
+
+AsyncLogger::Buffer::~Buffer()
+{
+	flush(true);
+	{
+		std::lock_guard<std::mutex> lock(_queueMutex);
+		_stop = true;
+	}
+	_queued.notify_one();
+	_writer.join();
+}
+
+/**
+ * Complete the current thread's record (or records of all threads) and wait
+ * until all complete records are written. Records of other threads may be
+ * completed only when no other thread is logging.
+ */
+void AsyncLogger::Buffer::flush(bool allThreads)
+{
+	if (allThreads) {
+		std::lock_guard<std::mutex> lock(_pendingMutex);
+		for (auto& p : _pending) {
+			if (!p.second.empty()) {
+				complete(std::move(p.second));
+				p.second.clear();
+			}
+		}
+	}
+	else {
+		sync();
+	}
+
+	std::unique_lock<std::mutex> lock(_queueMutex);
+	_written.wait(lock, [this]() { return _queue.empty() && !_writing; });
+}
+
+AsyncLogger::Buffer::int_type AsyncLogger::Buffer::overflow(int_type c)
+{
+	if (traits_type::eq_int_type(c, traits_type::eof()))
+		return traits_type::not_eof(c);
+
+	char ch = traits_type::to_char_type(c);
+	xsputn(&ch, 1);
+	return c;
+}
+
+std::streamsize AsyncLogger::Buffer::xsputn(const char* s, std::streamsize n)
+{
+	auto& record = pending();
+	record.append(s, n);
+
+	auto end = record.rfind('\n');
+	if (end != std::string::npos) {
+		complete(record.substr(0, end + 1));
+		record.erase(0, end + 1);
+	}
+	return n;
+}
+
+int AsyncLogger::Buffer::sync()
+{
+	auto& record = pending();
+	if (!record.empty()) {
+		complete(std::move(record));
+		record.clear();
+	}
+	return 0;
+}
+
+std::string& AsyncLogger::Buffer::pending()
+{
+	if (pendingRecord.bufferId != _id) {
+		std::lock_guard<std::mutex> lock(_pendingMutex);
+		pendingRecord.bufferId = _id;
+		pendingRecord.record = &_pending[std::this_thread::get_id()];
+	}
+	return *pendingRecord.record;
+}
+
+void AsyncLogger::Buffer::complete(std::string&& record)
+{
+	{
+		std::lock_guard<std::mutex> lock(_queueMutex);
+		_queue.push_back(std::move(record));
+	}
+	_queued.notify_one();
+}
+
+/**
+ * Body of the background thread. All queued records are taken at once, so
+ * the queue is locked only for a moment, not while they are written.
+ */
+void AsyncLogger::Buffer::write()
+{
+	std::vector<std::string> records;
+	std::unique_lock<std::mutex> lock(_queueMutex);
+	while (true) {
+		_queued.wait(lock, [this]() { return _stop || !_queue.empty(); });
+		if (_queue.empty())
+			break;
+
+		records.swap(_queue);
+		_writing = true;
+		lock.unlock();
+
+		for (auto& r : records)
+			_target.write(r.data(), r.size());
+		_target.flush();
+		records.clear();
+
+		lock.lock();
+		_writing = false;
+		_written.notify_all();
+	}
+}
+
+AsyncLogger::AsyncLogger(std::ostream& target, bool verbose):
+	Logger(_stream, verbose),
+	_buffer(new Buffer(target)),
+	_stream(_buffer.get())
+{
+}
+
+AsyncLogger::AsyncLogger(const std::string& file, bool verbose):
+	Logger(_stream, verbose),
+	_file(file, std::ofstream::out),
+	_buffer(new Buffer(_file)),
+	_stream(_buffer.get())
+{
+	if (!_file)
+		throw std::runtime_error("unable to open file \""+file+"\" for writing.");
+}
+
+AsyncLogger::~AsyncLogger() = default;
+
+/**
+ * @brief Write all complete records and the current thread's unfinished one,
+ * and wait until they are written.
+ *
+ * Unfinished records of other threads are written when the logger is
+ * destroyed.
+ */
+void AsyncLogger::flush()
+{
+	_buffer->flush(false);
+}
+
 }
 }
 }
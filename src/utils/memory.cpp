@@ -11,11 +11,18 @@
 
 #ifdef OS_WINDOWS
 	#include <windows.h>
-#elif defined(OS_MACOS) || defined(OS_BSD)
+	#include <psapi.h>
+#elif defined(OS_MACOS)
+	#include <sys/types.h>
+	#include <sys/sysctl.h>
+	#include <mach/mach.h>
+#elif defined(OS_BSD)
 	#include <sys/types.h>
 	#include <sys/sysctl.h>
 #else
+	#include <fstream>
 	#include <sys/sysinfo.h>
+	#include <unistd.h>
 #endif
 
 #ifdef OS_POSIX
@@ -41,6 +48,19 @@ bool limitSystemMemoryOnPOSIX(std::size_t limit) {
 	return rc == 0;
 }
 
+/**
+* @brief Implementation of @c getPeakProcessMemory() on POSIX-compliant
+*        systems.
+*/
+std::size_t getPeakProcessMemoryOnPOSIX() {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+	// ru_maxrss is in kilobytes on both Linux and *BSD.
+	return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+}
+
 #endif
 
 #ifdef OS_WINDOWS
@@ -98,6 +118,18 @@ bool limitSystemMemoryOnWindows(std::size_t limit) {
 	return succeeded;
 }
 
+/**
+* @brief Implementation of @c getCurrentProcessMemory() and
+*        @c getPeakProcessMemory() on Windows.
+*/
+std::size_t getProcessMemoryOnWindows(bool peak) {
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return 0;
+	}
+	return peak ? counters.PeakWorkingSetSize : counters.WorkingSetSize;
+}
+
 #elif defined(OS_MACOS)
 
 /**
@@ -133,6 +165,33 @@ bool limitSystemMemoryOnMacOS(std::size_t limit) {
 	return true;
 }
 
+/**
+* @brief Implementation of @c getCurrentProcessMemory() on MacOS.
+*/
+std::size_t getCurrentProcessMemoryOnMacOS() {
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	auto rc = task_info(
+		mach_task_self(),
+		MACH_TASK_BASIC_INFO,
+		reinterpret_cast<task_info_t>(&info),
+		&count
+	);
+	return rc == KERN_SUCCESS ? info.resident_size : 0;
+}
+
+/**
+* @brief Implementation of @c getPeakProcessMemory() on MacOS.
+*/
+std::size_t getPeakProcessMemoryOnMacOS() {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+	// Unlike on other systems, ru_maxrss is in bytes on macOS.
+	return static_cast<std::size_t>(usage.ru_maxrss);
+}
+
 #elif defined(OS_BSD)
 
 /**
@@ -157,6 +216,16 @@ bool limitSystemMemoryOnBSD(std::size_t limit) {
 	return limitSystemMemoryOnPOSIX(limit);
 }
 
+/**
+* @brief Implementation of @c getCurrentProcessMemory() on *BSD.
+*
+* There is no portable way of getting the current resident set size on *BSD,
+* so the peak value is used as an approximation.
+*/
+std::size_t getCurrentProcessMemoryOnBSD() {
+	return getPeakProcessMemoryOnPOSIX();
+}
+
 #else
 
 /*
@@ -175,6 +244,21 @@ bool limitSystemMemoryOnLinux(std::size_t limit) {
 	return limitSystemMemoryOnPOSIX(limit);
 }
 
+/**
+* @brief Implementation of @c getCurrentProcessMemory() on Linux.
+*/
+std::size_t getCurrentProcessMemoryOnLinux() {
+	// The second field is the number of resident pages.
+	std::ifstream statm("/proc/self/statm");
+	std::size_t size = 0;
+	std::size_t resident = 0;
+	if (!(statm >> size >> resident)) {
+		return 0;
+	}
+	auto pageSize = sysconf(_SC_PAGESIZE);
+	return pageSize > 0 ? resident * static_cast<std::size_t>(pageSize) : 0;
+}
+
 #endif
 
 } // anonymous namespace
@@ -234,5 +318,37 @@ bool limitSystemMemoryToHalfOfTotalSystemMemory() {
 	return limitSystemMemory(totalSize / 2);
 }
 
+/**
+* @brief Returns the current resident memory size of this process (in bytes).
+*
+* When the size cannot be obtained, it returns @c 0.
+*/
+std::size_t getCurrentProcessMemory() {
+#ifdef OS_WINDOWS
+	return getProcessMemoryOnWindows(false);
+#elif defined(OS_MACOS)
+	return getCurrentProcessMemoryOnMacOS();
+#elif defined(OS_BSD)
+	return getCurrentProcessMemoryOnBSD();
+#else
+	return getCurrentProcessMemoryOnLinux();
+#endif
+}
+
+/**
+* @brief Returns the peak resident memory size of this process (in bytes).
+*
+* When the size cannot be obtained, it returns @c 0.
+*/
+std::size_t getPeakProcessMemory() {
+#ifdef OS_WINDOWS
+	return getProcessMemoryOnWindows(true);
+#elif defined(OS_MACOS)
+	return getPeakProcessMemoryOnMacOS();
+#else
+	return getPeakProcessMemoryOnPOSIX();
+#endif
+}
+
 } // namespace utils
 } // namespace retdec
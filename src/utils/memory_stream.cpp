@@ -0,0 +1,220 @@
+/**
+ * @file src/utils/memory_stream.cpp
+ * @brief Implementation of in-memory binary stream.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "retdec/utils/memory_stream.h"
+
+namespace retdec {
+namespace utils {
+
+//
+//==============================================================================
+// MemoryStreamBuffer
+//==============================================================================
+//
+
+/**
+ * Creates the stream buffer operating on @a data.
+ * Both read and write positions are at the beginning of the data.
+ *
+ * @param data Data to operate on. They must outlive the buffer.
+ */
+MemoryStreamBuffer::MemoryStreamBuffer(std::vector<std::uint8_t>& data)
+		: _data(data)
+{
+}
+
+/**
+ * Moves both read and write positions to the beginning of the data.
+ */
+void MemoryStreamBuffer::resetPositions()
+{
+	_getPos = 0;
+	_putPos = 0;
+}
+
+MemoryStreamBuffer::int_type MemoryStreamBuffer::underflow()
+{
+	if (_getPos >= _data.size())
+	{
+		return traits_type::eof();
+	}
+
+	return traits_type::to_int_type(static_cast<char>(_data[_getPos]));
+}
+
+MemoryStreamBuffer::int_type MemoryStreamBuffer::uflow()
+{
+	auto ret = underflow();
+	if (ret != traits_type::eof())
+	{
+		++_getPos;
+	}
+	return ret;
+}
+
+std::streamsize MemoryStreamBuffer::xsgetn(char* s, std::streamsize n)
+{
+	if (n <= 0 || _getPos >= _data.size())
+	{
+		return 0;
+	}
+
+	auto toRead = std::min(
+			static_cast<std::size_t>(n),
+			_data.size() - _getPos
+	);
+	std::memcpy(s, _data.data() + _getPos, toRead);
+	_getPos += toRead;
+	return static_cast<std::streamsize>(toRead);
+}
+
+std::streamsize MemoryStreamBuffer::showmanyc()
+{
+	return _getPos < _data.size()
+			? static_cast<std::streamsize>(_data.size() - _getPos)
+			: -1;
+}
+
+MemoryStreamBuffer::int_type MemoryStreamBuffer::overflow(int_type ch)
+{
+	if (traits_type::eq_int_type(ch, traits_type::eof()))
+	{
+		return traits_type::not_eof(ch);
+	}
+
+	char c = traits_type::to_char_type(ch);
+	xsputn(&c, 1);
+	return ch;
+}
+
+std::streamsize MemoryStreamBuffer::xsputn(const char* s, std::streamsize n)
+{
+	if (n <= 0)
+	{
+		return 0;
+	}
+
+	auto toWrite = static_cast<std::size_t>(n);
+	if (_putPos + toWrite > _data.size())
+	{
+		// Gaps behind the end of the data are filled with zeros.
+		_data.resize(_putPos + toWrite, 0);
+	}
+	std::memcpy(_data.data() + _putPos, s, toWrite);
+	_putPos += toWrite;
+	return n;
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekoff(
+		off_type off,
+		std::ios_base::seekdir dir,
+		std::ios_base::openmode which)
+{
+	bool in = which & std::ios_base::in;
+	bool out = which & std::ios_base::out;
+
+	off_type base = 0;
+	if (dir == std::ios_base::cur)
+	{
+		// Relative move of both positions is ambiguous.
+		if (in == out)
+		{
+			return pos_type(off_type(-1));
+		}
+		base = static_cast<off_type>(in ? _getPos : _putPos);
+	}
+	else if (dir == std::ios_base::end)
+	{
+		base = static_cast<off_type>(_data.size());
+	}
+
+	off_type newPos = base + off;
+	if (newPos < 0 || (!in && !out))
+	{
+		return pos_type(off_type(-1));
+	}
+
+	if (in)
+	{
+		_getPos = static_cast<std::size_t>(newPos);
+	}
+	if (out)
+	{
+		_putPos = static_cast<std::size_t>(newPos);
+	}
+	return pos_type(newPos);
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekpos(
+		pos_type pos,
+		std::ios_base::openmode which)
+{
+	return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+//
+//==============================================================================
+// MemoryStream
+//==============================================================================
+//
+
+/**
+ * Creates an empty stream.
+ */
+MemoryStream::MemoryStream()
+		: std::iostream(nullptr)
+		, _buffer(_data)
+{
+	rdbuf(&_buffer);
+}
+
+/**
+ * Creates a stream initialized with @a data.
+ * Both read and write positions are at the beginning of the data.
+ *
+ * @param data Initial content of the stream.
+ */
+MemoryStream::MemoryStream(std::vector<std::uint8_t> data)
+		: std::iostream(nullptr)
+		, _data(std::move(data))
+		, _buffer(_data)
+{
+	rdbuf(&_buffer);
+}
+
+/**
+ * Returns all the data written to the stream so far.
+ */
+const std::vector<std::uint8_t>& MemoryStream::getData() const
+{
+	return _data;
+}
+
+/**
+ * Moves the data out of the stream. The stream is empty afterwards.
+ */
+std::vector<std::uint8_t> MemoryStream::releaseData()
+{
+	auto ret = std::move(_data);
+	reset();
+	return ret;
+}
+
+/**
+ * Removes all the data, resets the positions and clears the stream state.
+ */
+void MemoryStream::reset()
+{
+	_data.clear();
+	_buffer.resetPositions();
+	clear();
+}
+
+} // namespace utils
+} // namespace retdec
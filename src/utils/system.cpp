@@ -4,9 +4,20 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "retdec/utils/filesystem.h"
 #include "retdec/utils/os.h"
 #include "retdec/utils/system.h"
 
+#ifdef OS_LINUX
+	#include <sched.h>
+#endif
+
 namespace retdec {
 namespace utils {
 
@@ -29,5 +40,124 @@ bool systemHasLongDouble() {
 	return sizeof(long double) >= 10;
 }
 
+/**
+* @brief Parses a list of CPUs in the Linux format (e.g. "0-3,8,10-11").
+*
+* @return Sorted CPU numbers, or an empty vector if @a list is invalid.
+*/
+std::vector<unsigned> parseCpuList(const std::string& list) {
+	std::vector<unsigned> cpus;
+	std::istringstream in(list);
+	std::string range;
+	while (std::getline(in, range, ',')) {
+		range.erase(std::remove_if(range.begin(), range.end(),
+			[](unsigned char c) { return std::isspace(c); }), range.end());
+		if (range.empty()) {
+			continue;
+		}
+
+		unsigned first = 0;
+		unsigned last = 0;
+		char dash = 0;
+		std::istringstream r(range);
+		if (!(r >> first)) {
+			return {};
+		}
+		if (r >> dash) {
+			if (dash != '-' || !(r >> last) || last < first) {
+				return {};
+			}
+		} else {
+			last = first;
+		}
+		if (r.rdbuf()->in_avail() != 0) {
+			return {};
+		}
+		for (unsigned cpu = first; cpu <= last; ++cpu) {
+			cpus.push_back(cpu);
+		}
+	}
+
+	std::sort(cpus.begin(), cpus.end());
+	cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+	return cpus;
+}
+
+/**
+* @brief Returns CPUs of the NUMA nodes of the system, one vector per node.
+*
+* If the nodes cannot be found out (e.g. on systems other than Linux), all the
+* CPUs are returned as a single node.
+*/
+std::vector<std::vector<unsigned>> getCpusByNumaNode() {
+	std::vector<std::vector<unsigned>> nodes;
+
+#ifdef OS_LINUX
+	std::error_code ec;
+	fs::path nodeDir("/sys/devices/system/node");
+	for (unsigned node = 0; fs::exists(nodeDir / ("node" + std::to_string(node)), ec); ++node) {
+		std::ifstream file(nodeDir / ("node" + std::to_string(node)) / "cpulist");
+		std::string list;
+		std::getline(file, list);
+		auto cpus = parseCpuList(list);
+		if (!cpus.empty()) {
+			nodes.push_back(std::move(cpus));
+		}
+	}
+#endif
+
+	if (nodes.empty()) {
+		std::vector<unsigned> cpus(std::max(1u, std::thread::hardware_concurrency()));
+		for (unsigned cpu = 0; cpu < cpus.size(); ++cpu) {
+			cpus[cpu] = cpu;
+		}
+		nodes.push_back(std::move(cpus));
+	}
+	return nodes;
+}
+
+/**
+* @brief Returns the number of CPUs this process may run on.
+*
+* Unlike @c std::thread::hardware_concurrency(), it respects the CPU affinity
+* of the process (e.g. set by @c setCpuAffinity() or @c taskset) on Linux.
+*/
+unsigned getAvailableCpuCount() {
+#ifdef OS_LINUX
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+		return std::max(1, CPU_COUNT(&set));
+	}
+#endif
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+* @brief Restricts this process to run only on the given @a cpus.
+*
+* On Linux, memory is allocated on the NUMA node of the CPU that first touches
+* it by default, so a process restricted to the CPUs of a single node also
+* allocates its memory there.
+*
+* @return @c true if the affinity was set, @c false otherwise (it is supported
+*         only on Linux).
+*/
+bool setCpuAffinity(const std::vector<unsigned>& cpus) {
+#ifdef OS_LINUX
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (auto cpu : cpus) {
+		if (cpu < CPU_SETSIZE) {
+			CPU_SET(cpu, &set);
+		}
+	}
+	return CPU_COUNT(&set) > 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+	(void) cpus;
+	return false;
+#endif
+}
+
 } // namespace utils
 } // namespace retdec
@@ -4,10 +4,17 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <random>
+
 #include <yara.h>
 #include <yara/compiler.h>
 #include <yara/types.h>
 
+#include "retdec/utils/filesystem.h"
 #include "retdec/yaracpp/yara_detector.h"
 
 namespace retdec {
@@ -67,6 +74,70 @@ struct Scanner<std::vector<std::uint8_t>>
 	}
 };
 
+/**
+ * Iterator over memory regions given to YARA as memory blocks.
+ */
+struct RegionIterator
+{
+	const std::vector<YaraDetector::MemoryRegion>* regions;
+	std::size_t next;
+	YR_MEMORY_BLOCK block;
+
+	static const std::uint8_t* fetchData(YR_MEMORY_BLOCK* block)
+	{
+		return static_cast<const std::uint8_t*>(block->context);
+	}
+
+	static YR_MEMORY_BLOCK* nextBlock(YR_MEMORY_BLOCK_ITERATOR* iterator)
+	{
+		auto* self = static_cast<RegionIterator*>(iterator->context);
+		if (self->next >= self->regions->size())
+			return nullptr;
+
+		const auto& region = (*self->regions)[self->next++];
+		self->block.base = region.address;
+		self->block.size = region.size;
+		self->block.context = const_cast<std::uint8_t*>(region.data);
+		self->block.fetch_data = fetchData;
+		return &self->block;
+	}
+
+	static YR_MEMORY_BLOCK* firstBlock(YR_MEMORY_BLOCK_ITERATOR* iterator)
+	{
+		static_cast<RegionIterator*>(iterator->context)->next = 0;
+		return nextBlock(iterator);
+	}
+};
+
+/**
+ * Specialization for scanning memory regions. Matches are reported at
+ * addresses of regions.
+ */
+template <>
+struct Scanner<std::vector<YaraDetector::MemoryRegion>>
+{
+	static bool scan(
+			YR_RULES* rules,
+			YR_CALLBACK_FUNC callback,
+			YaraDetector::CallbackSettings& settings,
+			const std::vector<YaraDetector::MemoryRegion>& regions)
+	{
+		RegionIterator regionIterator = {&regions, 0, {}};
+		YR_MEMORY_BLOCK_ITERATOR iterator = {};
+		iterator.context = &regionIterator;
+		iterator.first = RegionIterator::firstBlock;
+		iterator.next = RegionIterator::nextBlock;
+
+		return yr_rules_scan_mem_blocks(
+				rules,
+				&iterator,
+				0,
+				callback,
+				&settings, 0
+		) == ERROR_SUCCESS;
+	}
+};
+
 /**
  * Interface for Scanner. Provides template type deduction and
  * always passes correct type into Scanner template.
@@ -86,6 +157,31 @@ bool scan(
 	);
 }
 
+/**
+ * Guards the library-wide reference counting of yr_initialize() and
+ * yr_finalize(), which is not thread-safe on its own.
+ */
+std::mutex yaraInitMutex;
+
+/**
+ * Compute key of compiled rules in cache.
+ * @param source Everything the compiled rules depend on
+ * @return 64-bit FNV-1a hash of @p source as hexadecimal string
+ */
+std::string getCacheKey(const std::string &source)
+{
+	std::uint64_t hash = 0xcbf29ce484222325ULL;
+	for (unsigned char c : source)
+	{
+		hash ^= c;
+		hash *= 0x100000001b3ULL;
+	}
+
+	char key[17];
+	std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+	return key;
+}
+
 } // anonymous namespace
 
 /**
@@ -93,8 +189,12 @@ bool scan(
  */
 YaraDetector::YaraDetector()
 {
-	stateIsValid = ((yr_initialize() == ERROR_SUCCESS)
-			&& (yr_compiler_create(&compiler) == ERROR_SUCCESS));
+	{
+		std::lock_guard<std::mutex> lock(yaraInitMutex);
+		stateIsValid = (yr_initialize() == ERROR_SUCCESS);
+	}
+	stateIsValid = stateIsValid
+			&& (yr_compiler_create(&compiler) == ERROR_SUCCESS);
 	std::uint32_t max_match_data = 65536;
 	yr_set_configuration(YR_CONFIG_MAX_MATCH_DATA, &max_match_data);
 }
@@ -128,6 +228,7 @@ YaraDetector::~YaraDetector()
 			yr_rules_destroy(rules);
 	}
 
+	std::lock_guard<std::mutex> lock(yaraInitMutex);
 	yr_finalize();
 }
 
@@ -226,6 +327,10 @@ int YaraDetector::yaraCallback(
 
 	YaraRule actual;
 	actual.setName(actRule->identifier);
+	if (actRule->ns && actRule->ns->name)
+	{
+		actual.setNamespace(actRule->ns->name);
+	}
 	YR_META *meta;
 	yr_rule_metas_foreach(actRule, meta)
 	{
@@ -307,6 +412,12 @@ bool YaraDetector::addRuleFile(
 	{
 		precompiledRules.push_back(rules);
 	}
+	// Text file may have been already compiled by some other process
+	else if (!cacheDirectory.empty()
+			&& (rules = getCachedRules(pathToFile, nameSpace)))
+	{
+		precompiledRules.push_back(rules);
+	}
 	// If we didn't succeeded consider it as text file
 	else
 	{
@@ -328,6 +439,20 @@ bool YaraDetector::addRuleFile(
 	return true;
 }
 
+/**
+ * Set directory for caching of compiled text rule files
+ * @param dir Path to directory, empty string disables caching
+ *
+ * Each text file added by @c addRuleFile() after this call is compiled
+ * separately and stored into @p dir, so other processes can load it
+ * instead of compiling it again. Rules of such file therefore cannot
+ * refer to rules from other added files.
+ */
+void YaraDetector::setRulesCacheDirectory(const std::string &dir)
+{
+	cacheDirectory = dir;
+}
+
 /**
  * Getter for state of instance
  * @return @c true if all is OK, @c false otherwise
@@ -337,6 +462,18 @@ bool YaraDetector::isInValidState() const
 	return stateIsValid;
 }
 
+/**
+ * Compile all added text rules
+ * @return @c true if rules were compiled, @c false otherwise
+ *
+ * After successful compilation, instance can be used for concurrent
+ * analysis by the constant @c analyze() method.
+ */
+bool YaraDetector::compile()
+{
+	return stateIsValid && getCompiledRules();
+}
+
 /**
  * Analyze input file
  * @param pathToInputFile Path to input file
@@ -358,11 +495,53 @@ bool YaraDetector::analyze(
  *                      store all rules (not only detected)
  * @return @c true if analysis completed without any error, otherwise @c false.
  */
-bool YaraDetector::analyze(std::vector<std::uint8_t> &bytes, bool storeAllRules)
+bool YaraDetector::analyze(const std::vector<std::uint8_t> &bytes, bool storeAllRules)
 {
 	return analyzeWithScan(bytes, storeAllRules);
 }
 
+/**
+ * Analyze memory regions
+ * @param regions Regions to analyze, their bytes are not copied
+ * @param storeAllRules If this parameter is set to @c true,
+ *                      store all rules (not only detected)
+ * @return @c true if analysis completed without any error, otherwise @c false.
+ *
+ * Offsets of matches are addresses given by regions. Strings are not
+ * matched across borders of regions.
+ */
+bool YaraDetector::analyze(
+		const std::vector<MemoryRegion> &regions,
+		bool storeAllRules)
+{
+	return analyzeWithScan(regions, storeAllRules);
+}
+
+/**
+ * Analyze input bytes by already compiled rules
+ * @param bytes Vector of input bytes
+ * @param detected Into this variable detected rules are stored
+ * @param undetected Into this variable undetected rules are stored
+ * @param storeAllRules If this parameter is set to @c true,
+ *                      store all rules (not only detected)
+ * @return @c true if analysis completed without any error, otherwise @c false.
+ *
+ * Method does not change state of instance, so it may be called from
+ * more threads at once. Rules must be compiled by @c compile() before.
+ */
+bool YaraDetector::analyze(
+		const std::vector<std::uint8_t> &bytes,
+		std::vector<YaraRule> &detected,
+		std::vector<YaraRule> &undetected,
+		bool storeAllRules) const
+{
+	if (needsRecompilation)
+		return false;
+
+	auto settings = CallbackSettings(storeAllRules, detected, undetected);
+	return scanCompiledRules(bytes, settings);
+}
+
 /**
  * Get detected rules
  * @return Detected rules
@@ -397,22 +576,94 @@ bool YaraDetector::analyzeWithScan(T&& value, bool storeAllRules)
 			undetectedRules
 	);
 
-	auto rules = getCompiledRules();
-	if (!(rules))
+	if (!getCompiledRules())
 		return false;
 
-	if (!scan(rules, yaraCallback, settings, std::forward<T>(value)))
+	return scanCompiledRules(value, settings);
+}
+
+/**
+ * Scan input sequence by compiled text rules and precompiled rules
+ * @param value Value to analyze
+ * @param settings Settings with storage for results
+ * @return @c true if analysis completed without any error, otherwise @c false.
+ */
+template <typename T>
+bool YaraDetector::scanCompiledRules(
+		const T& value,
+		CallbackSettings &settings) const
+{
+	if (!scan(textFilesRules, yaraCallback, settings, value))
 		return false;
 
 	for (auto* rules : precompiledRules)
 	{
-		if (!scan(rules, yaraCallback, settings, std::forward<T>(value)))
+		if (!scan(rules, yaraCallback, settings, value))
 			return false;
 	}
 
 	return true;
 }
 
+/**
+ * Returns the compiled rules of the given text file from cache. If they
+ * are not cached yet, file is compiled and stored into cache.
+ * @param pathToFile Path to text rule file
+ * @param nameSpace Namespace of rules from the file
+ * @return Compiled rules or @c nullptr if they cannot be cached
+ */
+YR_RULES* YaraDetector::getCachedRules(
+		const std::string &pathToFile,
+		const std::string &nameSpace)
+{
+	std::ifstream input(pathToFile, std::ios::binary);
+	if (!input)
+		return nullptr;
+
+	std::string source(
+			(std::istreambuf_iterator<char>(input)),
+			std::istreambuf_iterator<char>());
+	// Content of included files is not part of the cache key
+	if (input.bad() || source.find("include") != std::string::npos)
+		return nullptr;
+
+	const auto key = getCacheKey(
+			source + '\0' + nameSpace + '\0' + YR_VERSION);
+	const auto cachePath = fs::path(cacheDirectory) / (key + ".yarac");
+
+	YR_RULES* rules = nullptr;
+	if (yr_rules_load(cachePath.string().c_str(), &rules) == ERROR_SUCCESS)
+		return rules;
+
+	YR_COMPILER* fileCompiler = nullptr;
+	if (yr_compiler_create(&fileCompiler) != ERROR_SUCCESS)
+		return nullptr;
+
+	const char* ns = nameSpace.empty() ? nullptr : nameSpace.c_str();
+	rules = nullptr;
+	if (yr_compiler_add_string(fileCompiler, source.c_str(), ns) != 0
+			|| yr_compiler_get_rules(fileCompiler, &rules) != ERROR_SUCCESS)
+	{
+		yr_compiler_destroy(fileCompiler);
+		return nullptr;
+	}
+	yr_compiler_destroy(fileCompiler);
+
+	// More processes may store the same rules at once, so rules are saved
+	// under unique name and then atomically renamed
+	std::error_code ec;
+	fs::create_directories(cacheDirectory, ec);
+	auto tmpPath = cachePath;
+	tmpPath += "." + std::to_string(std::random_device()()) + ".tmp";
+	if (yr_rules_save(rules, tmpPath.string().c_str()) == ERROR_SUCCESS)
+	{
+		fs::rename(tmpPath, cachePath, ec);
+	}
+	fs::remove(tmpPath, ec);
+
+	return rules;
+}
+
 /**
  * Returns the compiled rules from text files.
  * @return Compiled rules.
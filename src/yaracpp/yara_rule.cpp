@@ -20,6 +20,15 @@ const std::string &YaraRule::getName() const
 	return name;
 }
 
+/**
+ * Get namespace of rule
+ * @return Namespace given to the rule file the rule comes from
+ */
+const std::string &YaraRule::getNamespace() const
+{
+	return nameSpace;
+}
+
 /**
  * Get selected meta related to this rule
  * @param id Name of selected meta
@@ -135,6 +144,15 @@ void YaraRule::setName(const std::string &ruleName)
 	name = ruleName;
 }
 
+/**
+ * Set namespace of rule
+ * @param ruleNamespace Namespace of rule
+ */
+void YaraRule::setNamespace(const std::string &ruleNamespace)
+{
+	nameSpace = ruleNamespace;
+}
+
 /**
  * Add meta
  * @param meta Meta related to this rule
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+
+"""Compile all the *.ord files into a single ordinal database.
+Usage: compile-ordinals.py ordinals-path output-path
+    ordinals-path Path to the directory with <arch>/<lib>.ord files.
+    output-path   Path to the database file to create.
+
+See include/retdec/bin2llvmir/utils/ordinal_database.h for the format.
+"""
+
+import os
+import struct
+import sys
+
+MAGIC = b'RDORDDB1'
+
+
+def print_help():
+    print('Usage: %s ordinals-path output-path' % sys.argv[0])
+
+
+def get_arguments():
+    if len(sys.argv) != 3:
+        print_help()
+        sys.exit(1)
+    return sys.argv[1], sys.argv[2]
+
+
+def parse_ord_file(path):
+    """Parse lines '<ordinal> <name>' the same way as the decompiler does.
+    """
+    ords = {}
+    with open(path, 'r', errors='replace') as f:
+        for line in f:
+            parts = line.split()
+            if not parts:
+                continue
+            try:
+                ord = int(parts[0])
+            except ValueError:
+                continue
+            if 0 <= ord <= 0xffffffff:
+                ords[ord] = parts[1] if len(parts) > 1 else ''
+    return ords
+
+
+def read_libraries(ordinals_dir):
+    """Return a map '<arch>/<lib>' -> {ordinal: name}.
+    """
+    libs = {}
+    for arch in sorted(os.listdir(ordinals_dir)):
+        arch_dir = os.path.join(ordinals_dir, arch)
+        if not os.path.isdir(arch_dir):
+            continue
+        for name in sorted(os.listdir(arch_dir)):
+            if name.endswith('.ord'):
+                key = '%s/%s' % (arch, name[:-len('.ord')])
+                libs[key] = parse_ord_file(os.path.join(arch_dir, name))
+    return libs
+
+
+def compile_database(libs):
+    keys = sorted(libs, key=lambda k: k.encode('utf-8'))
+    ord_count = sum(len(libs[k]) for k in keys)
+    strings_offset = len(MAGIC) + 8 + 12 * len(keys) + 8 * ord_count
+
+    strings = bytearray()
+    string_offsets = {}
+
+    def intern(s):
+        if s not in string_offsets:
+            string_offsets[s] = strings_offset + len(strings)
+            strings.extend(s.encode('utf-8') + b'\0')
+        return string_offsets[s]
+
+    lib_entries = bytearray()
+    ord_entries = bytearray()
+    first = 0
+    for key in keys:
+        ords = libs[key]
+        lib_entries += struct.pack('<III', intern(key), first, len(ords))
+        for ord in sorted(ords):
+            ord_entries += struct.pack('<II', ord, intern(ords[ord]))
+        first += len(ords)
+
+    header = MAGIC + struct.pack('<II', len(keys), ord_count)
+    return header + lib_entries + ord_entries + strings
+
+
+def main():
+    ordinals_dir, output_path = get_arguments()
+    data = compile_database(read_libraries(ordinals_dir))
+
+    # Write atomically, so that running decompilations never see a partially
+    # written database.
+    tmp_path = output_path + '.tmp'
+    with open(tmp_path, 'wb') as f:
+        f.write(data)
+    os.replace(tmp_path, output_path)
+    print('-- Installing: %s' % output_path)
+
+
+if __name__ == '__main__':
+    main()
@@ -11,10 +11,44 @@ import shutil
 import tarfile
 import urllib.request
 
+SIGNATURE_SUFFIXES = ('.yar', '.yara', '.yarac')
+
+
 def cleanup(support_dir):
     shutil.rmtree(support_dir, ignore_errors=True)
 
 
+def get_signature_dir(support_dir):
+    return os.path.join(support_dir, 'generic', 'yara_patterns', 'static-code')
+
+
+def write_signature_catalog(support_dir):
+    """Write catalog of static code signature files.
+
+    Each line contains SHA-256 of a signature file and its path relative to
+    the signature directory, separated by a tab. Tools then do not need to
+    walk the whole directory.
+    """
+    sig_dir = get_signature_dir(support_dir)
+    if not os.path.isdir(sig_dir):
+        return
+
+    entries = []
+    for root, _, files in os.walk(sig_dir):
+        for name in files:
+            if not name.endswith(SIGNATURE_SUFFIXES):
+                continue
+            path = os.path.join(root, name)
+            with open(path, 'rb') as f:
+                digest = hashlib.sha256(f.read()).hexdigest()
+            rel_path = os.path.relpath(path, sig_dir).replace(os.sep, '/')
+            entries.append((rel_path, digest))
+
+    with open(os.path.join(sig_dir, 'catalog.txt'), 'w') as f:
+        for rel_path, digest in sorted(entries):
+            f.write('%s\t%s\n' % (digest, rel_path))
+
+
 def get_args(argv):
     if len(argv) != 5:
         print('ERROR: Unexpected number of arguments.')
@@ -38,6 +72,9 @@ def main():
 
             if version == version_from_file:
                 print('-- Up-to-date: %s (version is OK)' % support_dir)
+                catalog_path = os.path.join(get_signature_dir(support_dir), 'catalog.txt')
+                if not os.path.exists(catalog_path):
+                    write_signature_catalog(support_dir)
                 sys.exit(0)
             else:
                 print('version is not as expected -> replace with the expected version')
@@ -85,6 +122,9 @@ def main():
     # Remove archive.
     os.remove(arch_path)
 
+    print('Writing signature catalog ...')
+    write_signature_catalog(support_dir)
+
     print('RetDec support directory downloaded OK')
     sys.exit(0)
 
@@ -44,6 +44,128 @@ DummyTest)
 	EXPECT_EQ( nullptr, module->getGlobalVariable("glob1") );
 }
 
+TEST_F(ReachingDefinitionsTests,
+definitionsMeetInLoopHeaderAndJoinAndAreKilledByStore)
+{
+	parseInput(R"(
+		@r = global i32 0
+		@q = global i32 0
+		define void @f(i1 %c) {
+		entry:
+			store i32 1, i32* @r
+			store i32 7, i32* @q
+			br label %loop
+		loop:
+			%a = load i32, i32* @r
+			%b = add i32 %a, 1
+			store i32 %b, i32* @r
+			br i1 %c, label %loop, label %other
+		other:
+			br i1 %c, label %x, label %y
+		x:
+			store i32 5, i32* @r
+			br label %join
+		y:
+			store i32 3, i32* @q
+			br label %join
+		join:
+			%u = load i32, i32* @r
+			%v = load i32, i32* @q
+			store i32 9, i32* @r
+			%w = load i32, i32* @r
+			ret void
+		}
+	)");
+
+	RDA.runOnModule(*module);
+
+	auto* a = getInstructionByName("a");
+	auto* u = getInstructionByName("u");
+	auto* v = getInstructionByName("v");
+	auto* w = getInstructionByName("w");
+	EXPECT_EQ(ReachingDefinitionsAnalysis::defsFromUse_onDemand(a).size(), 2);
+	EXPECT_EQ(2, RDA.defsFromUse(a).size());
+	EXPECT_EQ(2, RDA.defsFromUse(u).size());
+	EXPECT_EQ(2, RDA.defsFromUse(v).size());
+	ASSERT_EQ(1, RDA.defsFromUse(w).size());
+
+	auto* d = *RDA.defsFromUse(w).begin();
+	EXPECT_EQ(w->getPrevNode(), d->def);
+	EXPECT_EQ(1, RDA.usesFromDef(d->def).size());
+	EXPECT_EQ(2, RDA.usesFromDef(a->getNextNode()->getNextNode()).size());
+}
+
+TEST_F(ReachingDefinitionsTests,
+providerRecomputesOnlyInvalidatedFunctions)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @f() {
+			store i32 1, i32* @r
+			%a = load i32, i32* @r
+			ret void
+		}
+		define void @g() {
+			store i32 2, i32* @r
+			%b = load i32, i32* @r
+			ret void
+		}
+	)");
+	auto* a = getInstructionByName("a");
+	auto* b = getInstructionByName("b");
+
+	auto* rda = ReachingDefinitionsProvider::getRda(module.get());
+	auto* bDef = *rda->defsFromUse(b).begin();
+	ASSERT_EQ(1, rda->defsFromUse(a).size());
+
+	auto* s = new StoreInst(
+			ConstantInt::get(Type::getInt32Ty(context), 3),
+			getGlobalByName("r"),
+			a);
+	ReachingDefinitionsProvider::invalidate(module.get(), a->getFunction());
+	rda = ReachingDefinitionsProvider::getRda(module.get());
+
+	ASSERT_EQ(1, rda->defsFromUse(a).size());
+	EXPECT_EQ(s, (*rda->defsFromUse(a).begin())->def);
+	EXPECT_EQ(bDef, *rda->defsFromUse(b).begin());
+}
+
+TEST_F(ReachingDefinitionsTests,
+functionsAnalysedInParallelGiveSameResults)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @f(i1 %c) {
+		entry:
+			store i32 1, i32* @r
+			br i1 %c, label %x, label %y
+		x:
+			store i32 2, i32* @r
+			br label %y
+		y:
+			%a = load i32, i32* @r
+			ret void
+		}
+		define void @g() {
+			%b = load i32, i32* @r
+			store i32 2, i32* @r
+			%c = load i32, i32* @r
+			ret void
+		}
+		define void @h() {
+			ret void
+		}
+	)");
+
+	ReachingDefinitionsAnalysis::setThreads(4);
+	RDA.runOnModule(*module);
+	ReachingDefinitionsAnalysis::setThreads(0);
+
+	EXPECT_EQ(2, RDA.defsFromUse(getInstructionByName("a")).size());
+	EXPECT_EQ(0, RDA.defsFromUse(getInstructionByName("b")).size());
+	EXPECT_EQ(1, RDA.defsFromUse(getInstructionByName("c")).size());
+}
+
 } // namespace tests
 } // namespace bin2llvmir
 } // namespace retdec
@@ -0,0 +1,265 @@
+/**
+ * @file tests/bin2llvmir/optimizations/decoder/decoder_ranges_tests.cpp
+ * @brief Tests for the @c AddressRangeMap and @c RangesToDecode classes.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/bin2llvmir/optimizations/decoder/decoder_ranges.h"
+
+using namespace ::testing;
+using namespace retdec::common;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+class AddressRangeMapTests : public Test
+{
+	protected:
+		std::vector<AddressRange> ranges(const AddressRangeMap& rm)
+		{
+			std::vector<AddressRange> ret;
+			for (auto& p : rm)
+			{
+				ret.push_back(p.second);
+			}
+			return ret;
+		}
+};
+
+TEST_F(AddressRangeMapTests, insertMergesOverlappingAndContinuousRanges)
+{
+	AddressRangeMap rm;
+
+	rm.insert(0x10, 0x20);
+	rm.insert(0x30, 0x40);
+	rm.insert(0x50, 0x60);
+	rm.insert(0x20, 0x30);
+	rm.insert(0x45, 0x55);
+
+	std::vector<AddressRange> exp = {
+		AddressRange(0x10, 0x40),
+		AddressRange(0x45, 0x60)};
+	EXPECT_EQ(exp, ranges(rm));
+}
+
+TEST_F(AddressRangeMapTests, insertCoveringRangeReplacesAllRanges)
+{
+	AddressRangeMap rm;
+
+	rm.insert(0x10, 0x20);
+	rm.insert(0x30, 0x40);
+	rm.insert(0x0, 0x100);
+
+	std::vector<AddressRange> exp = {AddressRange(0x0, 0x100)};
+	EXPECT_EQ(exp, ranges(rm));
+}
+
+TEST_F(AddressRangeMapTests, removeSplitsRanges)
+{
+	AddressRangeMap rm;
+	rm.insert(0x10, 0x40);
+	rm.insert(0x50, 0x60);
+
+	rm.remove(0x20, 0x30);
+	rm.remove(0x38, 0x58);
+
+	std::vector<AddressRange> exp = {
+		AddressRange(0x10, 0x20),
+		AddressRange(0x30, 0x38),
+		AddressRange(0x58, 0x60)};
+	EXPECT_EQ(exp, ranges(rm));
+}
+
+TEST_F(AddressRangeMapTests, removeOfWholeRangesAndEmptyRemoval)
+{
+	AddressRangeMap rm;
+	rm.insert(0x10, 0x20);
+	rm.insert(0x30, 0x40);
+
+	rm.remove(0x30, 0x30);
+	rm.remove(0x0, 0x30);
+
+	std::vector<AddressRange> exp = {AddressRange(0x30, 0x40)};
+	EXPECT_EQ(exp, ranges(rm));
+
+	rm.remove(0x30, 0x40);
+	EXPECT_TRUE(rm.empty());
+}
+
+TEST_F(AddressRangeMapTests, getRangeFindsContainingRange)
+{
+	AddressRangeMap rm;
+	rm.insert(0x10, 0x20);
+	rm.insert(0x30, 0x40);
+
+	EXPECT_EQ(nullptr, rm.getRange(0x0));
+	EXPECT_EQ(AddressRange(0x10, 0x20), *rm.getRange(0x10));
+	EXPECT_EQ(AddressRange(0x10, 0x20), *rm.getRange(0x1f));
+	EXPECT_EQ(nullptr, rm.getRange(0x20));
+	EXPECT_EQ(AddressRange(0x30, 0x40), *rm.getRange(0x35));
+	EXPECT_EQ(nullptr, rm.getRange(0x40));
+	EXPECT_EQ(AddressRange(0x10, 0x20), rm.front());
+}
+
+/**
+ * Benchmark of fragmentation typical for the decoder: every decoded chunk
+ * punches a hole into a big range. With a sorted vector, every hole moves all
+ * the following ranges, i.e. this would be quadratic.
+ */
+TEST_F(AddressRangeMapTests, manyHolesBenchmark)
+{
+	const std::size_t holes = 200000;
+	const Address start = 0x400000;
+
+	auto t = std::chrono::steady_clock::now();
+
+	AddressRangeMap rm;
+	rm.insert(start, start + 4 * holes);
+	for (std::size_t i = 0; i < holes; ++i)
+	{
+		// Front to back would take the cheap path of a vector as well.
+		Address h = start + 4 * ((i * 7919) % holes) + 1;
+		rm.remove(h, h + 2);
+	}
+	for (std::size_t i = 0; i < holes; ++i)
+	{
+		Address a = start + 4 * i;
+		ASSERT_NE(nullptr, rm.getRange(a));
+		ASSERT_EQ(nullptr, rm.getRange(a + 1));
+	}
+
+	auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - t).count();
+	RecordProperty("milliseconds", static_cast<int>(ms));
+
+	EXPECT_EQ(holes + 1, rm.size());
+}
+
+class RangesToDecodeTests : public Test
+{
+	protected:
+		/// Appends @a size bytes of code-like data to @a bytes.
+		void appendCode(std::vector<std::uint8_t>& bytes, std::size_t size)
+		{
+			// push ebp; mov ebp, esp; sub esp, 0x10; ... ; pop ebp; ret
+			std::vector<std::uint8_t> fnc = {
+					0x55, 0x8b, 0xec, 0x83, 0xec, 0x10, 0x8b, 0x45,
+					0x08, 0x89, 0x45, 0xfc, 0x8b, 0x4d, 0x0c, 0x03,
+					0x4d, 0xfc, 0x89, 0x4d, 0xf8, 0x8b, 0x45, 0xf8,
+					0x8b, 0xe5, 0x5d, 0xc3};
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				bytes.push_back(fnc[i % fnc.size()]);
+			}
+		}
+
+		/// Appends @a size bytes of text to @a bytes.
+		void appendText(std::vector<std::uint8_t>& bytes, std::size_t size)
+		{
+			std::string text = "The quick brown fox jumps over the lazy dog. ";
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				bytes.push_back(text[i % text.size()]);
+			}
+		}
+
+		/// Appends @a size bytes of high entropy data to @a bytes.
+		void appendRandom(std::vector<std::uint8_t>& bytes, std::size_t size)
+		{
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				bytes.push_back(_random() & 0xff);
+			}
+		}
+
+	protected:
+		std::mt19937 _random{42};
+};
+
+TEST_F(RangesToDecodeTests, removeRemovesFromBothPrimaryAndAlternative)
+{
+	RangesToDecode rs;
+	rs.addPrimary(0x10, 0x20);
+	rs.addAlternative(0x30, 0x40);
+
+	rs.remove(0x18, 0x38);
+
+	EXPECT_EQ(AddressRange(0x10, 0x18), *rs.getPrimary(0x10));
+	EXPECT_EQ(nullptr, rs.getPrimary(0x18));
+	EXPECT_EQ(AddressRange(0x38, 0x40), *rs.get(0x38));
+	EXPECT_EQ(nullptr, rs.get(0x30));
+}
+
+TEST_F(RangesToDecodeTests, alignmentIsAppliedOnAddAndRemove)
+{
+	RangesToDecode rs;
+	rs.setArchitectureInstructionAlignment(4);
+	rs.addPrimary(0x11, 0x40);
+
+	rs.remove(0x20, 0x22);
+
+	EXPECT_EQ(AddressRange(0x14, 0x20), rs.primaryFront());
+	EXPECT_EQ(AddressRange(0x24, 0x40), *rs.getPrimary(0x24));
+}
+
+TEST_F(RangesToDecodeTests, promoteAlternativeToPrimaryMakesItStrict)
+{
+	RangesToDecode rs;
+	rs.addAlternative(0x10, 0x20);
+
+	EXPECT_TRUE(rs.primaryEmpty());
+	rs.promoteAlternativeToPrimary();
+
+	EXPECT_TRUE(rs.isStrict());
+	EXPECT_FALSE(rs.primaryEmpty());
+	EXPECT_EQ(AddressRange(0x10, 0x20), rs.primaryFront());
+}
+
+TEST_F(RangesToDecodeTests, demoteDataSequencesDemotesTextAndCompressedData)
+{
+	std::vector<std::uint8_t> bytes;
+	appendCode(bytes, 0x100);
+	appendText(bytes, 0x100);
+	appendCode(bytes, 0x100);
+	appendRandom(bytes, 0x100);
+	appendCode(bytes, 0x80);
+	appendRandom(bytes, 0x80); // too short to be demoted
+	appendCode(bytes, 0x80);
+	RangesToDecode rs;
+	rs.addPrimary(0x1000, 0x1000 + bytes.size());
+
+	rs.demoteDataSequences(0x1000, bytes.data(), bytes.size());
+
+	EXPECT_EQ(AddressRange(0x1000, 0x1100), *rs.getPrimary(0x1000));
+	EXPECT_EQ(nullptr, rs.getPrimary(0x1100));
+	EXPECT_EQ(AddressRange(0x1100, 0x1200), *rs.getAlternative(0x1100));
+	EXPECT_EQ(AddressRange(0x1200, 0x1300), *rs.getPrimary(0x1200));
+	EXPECT_EQ(nullptr, rs.getPrimary(0x1300));
+	EXPECT_EQ(AddressRange(0x1300, 0x1400), *rs.getAlternative(0x1300));
+	EXPECT_EQ(AddressRange(0x1400, 0x1580), *rs.getPrimary(0x1400));
+}
+
+TEST_F(RangesToDecodeTests, demoteDataSequencesKeepsCode)
+{
+	std::vector<std::uint8_t> bytes;
+	appendCode(bytes, 0x1000);
+	RangesToDecode rs;
+	rs.addPrimary(0x1000, 0x2000);
+
+	rs.demoteDataSequences(0x1000, bytes.data(), bytes.size());
+
+	EXPECT_EQ(AddressRange(0x1000, 0x2000), rs.primaryFront());
+	EXPECT_TRUE(rs.alternativeEmpty());
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
@@ -0,0 +1,113 @@
+/**
+ * @file tests/bin2llvmir/optimizations/decoder/jump_targets_tests.cpp
+ * @brief Tests for the @c JumpTargets class.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <vector>
+
+#include "bin2llvmir/utils/llvmir_tests.h"
+#include "retdec/bin2llvmir/optimizations/decoder/jump_targets.h"
+
+using namespace ::testing;
+using namespace llvm;
+using namespace retdec::common;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+class JumpTargetsTests : public LlvmIrTests
+{
+	protected:
+		void SetUp() override
+		{
+			config = Config::empty(module.get());
+			config.getConfig().architecture.setIsX86();
+			config.getConfig().architecture.setBitSize(32);
+			JumpTarget::config = &config;
+			JumpTargets::config = &config;
+		}
+
+		const JumpTarget* push(
+				Address a,
+				JumpTarget::eType t,
+				Address from = Address::Undefined)
+		{
+			return jts.push(a, t, CS_MODE_32, from);
+		}
+
+		std::vector<Address> popAll()
+		{
+			std::vector<Address> ret;
+			while (!jts.empty())
+			{
+				ret.push_back(jts.top().getAddress());
+				jts.pop();
+			}
+			return ret;
+		}
+
+	protected:
+		Config config;
+		JumpTargets jts;
+};
+
+TEST_F(JumpTargetsTests, popOrderIsDeterminedByTypeThenAddress)
+{
+	push(0x30, JumpTarget::eType::SYMBOL);
+	push(0x20, JumpTarget::eType::ENTRY_POINT);
+	push(0x50, JumpTarget::eType::CONTROL_FLOW_CALL_TARGET, 0x1);
+	push(0x40, JumpTarget::eType::CONTROL_FLOW_BR_FALSE, 0x2);
+	push(0x10, JumpTarget::eType::SYMBOL);
+
+	std::vector<Address> exp = {0x40, 0x50, 0x20, 0x10, 0x30};
+	EXPECT_EQ(exp, popAll());
+}
+
+TEST_F(JumpTargetsTests, queuedDuplicatesAreSuppressed)
+{
+	auto* jt1 = push(0x10, JumpTarget::eType::CONTROL_FLOW_CALL_TARGET, 0x1);
+	auto* jt2 = push(0x10, JumpTarget::eType::CONTROL_FLOW_CALL_TARGET, 0x1);
+	push(0x10, JumpTarget::eType::CONTROL_FLOW_CALL_TARGET, 0x2);
+
+	EXPECT_EQ(jt1, jt2);
+	EXPECT_EQ(2, jts.size());
+	EXPECT_EQ(2, jts.getStatistics().pushed);
+	EXPECT_EQ(1, jts.getStatistics().duplicates);
+}
+
+TEST_F(JumpTargetsTests, poppedJumpTargetCanBePushedAgain)
+{
+	push(0x10, JumpTarget::eType::SYMBOL);
+	jts.pop();
+	push(0x10, JumpTarget::eType::SYMBOL);
+
+	EXPECT_EQ(1, jts.size());
+	EXPECT_EQ(2, jts.getStatistics().pushed);
+	EXPECT_EQ(1, jts.getStatistics().popped);
+}
+
+TEST_F(JumpTargetsTests, undefinedAddressIsRejected)
+{
+	auto* jt = push(Address::Undefined, JumpTarget::eType::SYMBOL);
+
+	EXPECT_EQ(nullptr, jt);
+	EXPECT_TRUE(jts.empty());
+	EXPECT_EQ(1, jts.getStatistics().rejected);
+}
+
+TEST_F(JumpTargetsTests, iterationStartsWithTop)
+{
+	push(0x30, JumpTarget::eType::SYMBOL);
+	push(0x20, JumpTarget::eType::ENTRY_POINT);
+	push(0x10, JumpTarget::eType::SYMBOL);
+
+	ASSERT_NE(jts.begin(), jts.end());
+	EXPECT_EQ(Address(0x20), (*jts.begin())->getAddress());
+	EXPECT_EQ(3, std::distance(jts.begin(), jts.end()));
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
@@ -0,0 +1,77 @@
+/**
+ * @file tests/bin2llvmir/optimizations/decoder/mode_map_tests.cpp
+ * @brief Tests for the @c ModeMap class.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <gtest/gtest.h>
+
+#include "retdec/bin2llvmir/optimizations/decoder/mode_map.h"
+
+using namespace ::testing;
+using namespace retdec::common;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+class ModeMapTests : public Test
+{
+	protected:
+		ModeMap modes;
+};
+
+TEST_F(ModeMapTests, modeIsUnknownBeforeFirstSetAddress)
+{
+	modes.set(0x100, CS_MODE_THUMB);
+
+	EXPECT_FALSE(modes.get(0xff).has_value());
+	EXPECT_EQ(CS_MODE_THUMB, modes.get(0x100));
+}
+
+TEST_F(ModeMapTests, modeHoldsUpToNextSetAddressLikeMappingSymbols)
+{
+	modes.set(0x100, CS_MODE_ARM);
+	modes.set(0x200, CS_MODE_THUMB);
+	modes.set(0x300, std::nullopt);
+
+	EXPECT_EQ(CS_MODE_ARM, modes.get(0x1fe));
+	EXPECT_EQ(CS_MODE_THUMB, modes.get(0x200));
+	EXPECT_EQ(CS_MODE_THUMB, modes.get(0x2fe));
+	EXPECT_FALSE(modes.get(0x300).has_value());
+	EXPECT_FALSE(modes.get(0x1000).has_value());
+}
+
+TEST_F(ModeMapTests, settingRangeReplacesModesInsideAndKeepsModeAfter)
+{
+	modes.set(0x100, CS_MODE_ARM);
+	modes.set(0x180, CS_MODE_THUMB);
+
+	modes.set(AddressRange(0x140, 0x1c0), CS_MODE_ARM);
+
+	EXPECT_EQ(CS_MODE_ARM, modes.get(0x100));
+	EXPECT_EQ(CS_MODE_ARM, modes.get(0x180));
+	EXPECT_EQ(CS_MODE_ARM, modes.get(0x1be));
+	EXPECT_EQ(CS_MODE_THUMB, modes.get(0x1c0));
+	EXPECT_EQ(3, modes.size());
+}
+
+TEST_F(ModeMapTests, settingRangeInUnknownAreaKeepsItUnknownAfter)
+{
+	modes.set(AddressRange(0x100, 0x120), CS_MODE_THUMB);
+
+	EXPECT_FALSE(modes.get(0xfe).has_value());
+	EXPECT_EQ(CS_MODE_THUMB, modes.get(0x11e));
+	EXPECT_FALSE(modes.get(0x120).has_value());
+}
+
+TEST_F(ModeMapTests, emptyRangeIsIgnored)
+{
+	modes.set(AddressRange(0x100, 0x100), CS_MODE_THUMB);
+
+	EXPECT_TRUE(modes.empty());
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
@@ -61,6 +61,42 @@ TEST_F(InstructionOptimizerTests, optimizationReturnsTrue)
 	EXPECT_TRUE(ret);
 }
 
+TEST_F(InstructionOptimizerTests, unchangedFunctionIsSkippedUntilItIsModified)
+{
+	parseInput(R"(
+		@reg = global i32 0
+		define i32 @fnc() {
+			%a = load i32, i32* @reg
+			ret i32 %a
+		}
+	)");
+
+	EXPECT_FALSE(pass.runOnModuleCustom(*module));
+	EXPECT_FALSE(pass.runOnModuleCustom(*module));
+
+	auto* f = getFunctionByName("fnc");
+	auto* ret = cast<ReturnInst>(f->back().getTerminator());
+	auto* a = ret->getReturnValue();
+	auto* add = BinaryOperator::CreateAdd(
+			a,
+			ConstantInt::get(a->getType(), 0),
+			"b",
+			ret);
+	ret->setOperand(0, add);
+
+	InstructionOptimizer pass2;
+	EXPECT_TRUE(pass2.runOnModuleCustom(*module));
+
+	std::string exp = R"(
+		@reg = global i32 0
+		define i32 @fnc() {
+			%a = load i32, i32* @reg
+			ret i32 %a
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+}
+
 } // namespace tests
 } // namespace bin2llvmir
 } // namespace retdec
@@ -619,6 +619,110 @@ TEST_F(ParamReturnTests, x86ExternalCallFixOnMultiplePlaces)
 	checkModuleAgainstExpectedIr(exp);
 }
 
+TEST_F(ParamReturnTests, x86ExternalCallFixOnMultiplePlacesCollectedInParallel)
+{
+	parseInput(R"(
+		declare void @print()
+		define void @fnc1() {
+			%stack_-4 = alloca i32
+			%stack_-8 = alloca i32
+			store i32 123, i32* %stack_-4
+			store i32 456, i32* %stack_-8
+			call void @print()
+			ret void
+		}
+		define void @fnc2() {
+			%stack_-16 = alloca i32
+			%stack_-20 = alloca i32
+			%stack_-24 = alloca i32
+			store i32 456, i32* %stack_-20
+			store i32 123, i32* %stack_-16
+			store i32 123, i32* %stack_-24
+			call void @print()
+			ret void
+		}
+	)");
+	auto c = config::Config::fromJsonString(R"({
+		"architecture" : {
+			"bitSize" : 32,
+			"endian" : "little",
+			"name" : "x86"
+		},
+		"functions" : [
+			{
+				"name" : "fnc1",
+				"startAddr" : "0x1234",
+				"locals" : [
+					{
+						"name" : "stack_-4",
+						"storage" : { "type" : "stack", "value" : -4 }
+					},
+					{
+						"name" : "stack_-8",
+						"storage" : { "type" : "stack", "value" : -8 }
+					}
+				]
+			},
+			{
+				"name" : "fnc2",
+				"startAddr" : "0x1235",
+				"locals" : [
+					{
+						"name" : "stack_-16",
+						"storage" : { "type" : "stack", "value" : -16 }
+					},
+					{
+						"name" : "stack_-20",
+						"storage" : { "type" : "stack", "value" : -20 }
+					},
+					{
+						"name" : "stack_-24",
+						"storage" : { "type" : "stack", "value" : -24 }
+					}
+				]
+			}
+		]
+	})");
+	auto config = Config::fromConfig(module.get(), c);
+	auto abi = AbiProvider::addAbi(module.get(), &config);
+	auto typeConfig = std::make_unique<ctypesparser::TypeConfig>();
+	auto demangler = DemanglerProvider::addDemangler(
+		module.get(),
+		&config,
+		std::move(typeConfig));
+	ReachingDefinitionsAnalysis::setThreads(4);
+	pass.runOnModuleCustom(*module, &config, abi, demangler);
+	ReachingDefinitionsAnalysis::setThreads(0);
+
+	std::string exp = R"(
+		declare void @print(i32, i32)
+		declare void @0()
+		define void @fnc1() {
+			%stack_-4 = alloca i32
+			%stack_-8 = alloca i32
+			store i32 123, i32* %stack_-4
+			store i32 456, i32* %stack_-8
+			%1 = load i32, i32* %stack_-8
+			%2 = load i32, i32* %stack_-4
+			call void @print(i32 %1, i32 %2)
+			ret void
+		}
+		define void @fnc2() {
+			%stack_-16 = alloca i32
+			%stack_-20 = alloca i32
+			%stack_-24 = alloca i32
+			store i32 456, i32* %stack_-20
+			store i32 123, i32* %stack_-16
+			store i32 123, i32* %stack_-24
+			%1 = load i32, i32* %stack_-24
+			%2 = load i32, i32* %stack_-20
+			call void @print(i32 %1, i32 %2)
+			ret void
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+}
+
 //TEST_F(ParamReturnTests, x86ExternalCallSomeFunctionCallsAreNotModified)
 //{
 //	parseInput(R"(
@@ -1706,6 +1706,71 @@ TEST_F(AsmInstructionTests, getInstructionFirstReturnsNullptrIfItDoesNotContainI
 	EXPECT_EQ(nullptr, ai.getInstructionFirst<llvm::CallInst>());
 }
 
+//
+// Llvm2CapstoneInsnMap
+//
+
+TEST_F(AsmInstructionTests, constructorFindsInstructionByAddressInCapstoneInsnMap)
+{
+	parseInput(R"(
+		define void @fnc() {
+			store volatile i64 5678, i64* @llvm2asm
+			store volatile i64 1234, i64* @llvm2asm
+			ret void
+		}
+		@llvm2asm = global i64 0
+	)");
+	auto* mapGv = getGlobalByName("llvm2asm");
+	AsmInstruction::setLlvmToAsmGlobalVariable(module.get(), mapGv);
+	auto* s1 = getNthInstruction<StoreInst>(0);
+	auto* s2 = getNthInstruction<StoreInst>(1);
+	cs_insn i1 = {};
+	i1.address = 5678;
+	i1.size = 4;
+	cs_insn i2 = {};
+	i2.address = 1234;
+	i2.size = 2;
+	auto& insnMap = AsmInstruction::getLlvmToCapstoneInsnMap(module.get());
+	insnMap.emplace(s1, &i1);
+	insnMap.emplace(s2, &i2);
+
+	auto ai = AsmInstruction(module.get(), 1234);
+
+	ASSERT_TRUE(ai.isValid());
+	EXPECT_EQ(s2, ai.getLlvmToAsmInstruction());
+	EXPECT_EQ(&i2, ai.getCapstoneInsn());
+	EXPECT_EQ(1236, ai.getEndAddress());
+	EXPECT_FALSE(AsmInstruction(module.get(), 1000).isValid());
+}
+
+TEST_F(AsmInstructionTests, constructorDoesNotFindErasedInstructionInCapstoneInsnMap)
+{
+	parseInput(R"(
+		define void @fnc() {
+			store volatile i64 1234, i64* @llvm2asm
+			store volatile i64 5678, i64* @llvm2asm
+			ret void
+		}
+		@llvm2asm = global i64 0
+	)");
+	auto* mapGv = getGlobalByName("llvm2asm");
+	AsmInstruction::setLlvmToAsmGlobalVariable(module.get(), mapGv);
+	auto* s1 = getNthInstruction<StoreInst>(0);
+	auto* s2 = getNthInstruction<StoreInst>(1);
+	cs_insn i1 = {};
+	i1.address = 1234;
+	cs_insn i2 = {};
+	i2.address = 5678;
+	auto& insnMap = AsmInstruction::getLlvmToCapstoneInsnMap(module.get());
+	insnMap.emplace(s1, &i1);
+	insnMap.emplace(s2, &i2);
+
+	s1->eraseFromParent();
+
+	EXPECT_FALSE(AsmInstruction(module.get(), 1234).isValid());
+	EXPECT_EQ(s2, AsmInstruction(module.get(), 5678).getLlvmToAsmInstruction());
+}
+
 } // namespace tests
 } // namespace bin2llvmir
 } // namespace retdec
@@ -42,7 +42,7 @@ TEST_F(DebugFormatProviderTests, addDebugFormatAddsDebugFormatForModule)
 	{
 		throw std::runtime_error("failed to load RawDataImage");
 	}
-	auto* r1 = DebugFormatProvider::addDebugFormat(
+	bool r1 = DebugFormatProvider::addDebugFormat(
 			module.get(),
 			image.get(),
 			"",
@@ -51,21 +51,24 @@ TEST_F(DebugFormatProviderTests, addDebugFormatAddsDebugFormatForModule)
 	DebugFormat* r3 = nullptr;
 	bool b = DebugFormatProvider::getDebugFormat(module.get(), r3);
 
-	EXPECT_NE(nullptr, r1);
-	EXPECT_EQ(r1, r2);
-	EXPECT_EQ(r1, r3);
+	EXPECT_TRUE(r1);
+	EXPECT_NE(nullptr, r2);
+	EXPECT_EQ(r2, r3);
 	EXPECT_TRUE(b);
+	EXPECT_FALSE(r2->hasInformation());
 }
 
-TEST_F(DebugFormatProviderTests, addDebugFormatReturnNullptrIfFileImageNotProvided)
+TEST_F(DebugFormatProviderTests, addDebugFormatReturnFalseIfFileImageNotProvided)
 {
-	auto* r1 = DebugFormatProvider::addDebugFormat(
+	bool r1 = DebugFormatProvider::addDebugFormat(
 			module.get(),
 			nullptr,
 			"",
 			nullptr);
+	auto* r2 = DebugFormatProvider::getDebugFormat(module.get());
 
-	EXPECT_EQ(nullptr, r1);
+	EXPECT_FALSE(r1);
+	EXPECT_EQ(nullptr, r2);
 }
 
 TEST_F(DebugFormatProviderTests, clearRemovesAllData)
@@ -85,6 +85,71 @@ TEST_F(DemanglerFactoryTests, GetBorlandDemangler)
 	EXPECT_FALSE(dem->demangleToString("@f$qi").empty());		// borland
 }
 
+//
+//=============================================================================
+//  CachingDemanglerTests
+//=============================================================================
+//
+
+/**
+ * @brief Tests for the @c CachingDemangler.
+ */
+class CachingDemanglerTests: public Test
+{
+	protected:
+		void TearDown() override
+		{
+			CachingDemangler::clearCache();
+		}
+
+		static std::unique_ptr<demangler::Demangler> itanium()
+		{
+			return std::make_unique<demangler::ItaniumDemangler>();
+		}
+
+		static std::unique_ptr<demangler::Demangler> microsoft()
+		{
+			return std::make_unique<demangler::MicrosoftDemangler>();
+		}
+};
+
+TEST_F(CachingDemanglerTests, demangledNamesAreSharedByInstancesWithSameCompiler)
+{
+	CachingDemangler d1("test", itanium);
+	CachingDemangler d2("test", microsoft);
+	CachingDemangler d3("test-other", microsoft);
+
+	EXPECT_EQ("f(int)", d1.demangleToString("_Z1fi"));
+	EXPECT_EQ(demangler::Demangler::success, d1.status());
+	EXPECT_EQ("f(int)", d2.demangleToString("_Z1fi"));
+	EXPECT_EQ(demangler::Demangler::success, d2.status());
+	EXPECT_EQ("", d3.demangleToString("_Z1fi"));
+}
+
+TEST_F(CachingDemanglerTests, demangleToStringsDemanglesAllNames)
+{
+	std::vector<std::string> names;
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		names.push_back("_Z1fILi" + std::to_string(i) + "EEvv");
+	}
+	names.push_back("not_mangled");
+
+	CachingDemangler d1("test", itanium);
+	d1.demangleToStrings(names, 4);
+
+	// Everything is in the cache, the microsoft demangler is never used.
+	CachingDemangler d2("test", microsoft);
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		EXPECT_EQ(
+				"void f<" + std::to_string(i) + ">()",
+				d2.demangleToString(names[i]));
+	}
+	EXPECT_EQ("", d2.demangleToString("not_mangled"));
+	EXPECT_NE(demangler::Demangler::success, d2.status());
+}
+
 //
 //=============================================================================
 //  DemanglerProviderTests
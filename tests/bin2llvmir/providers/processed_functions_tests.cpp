@@ -0,0 +1,85 @@
+/**
+* @file tests/bin2llvmir/providers/processed_functions_tests.cpp
+* @brief Tests for the @c ProcessedFunctionsProvider.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <llvm/IR/Instructions.h>
+
+#include "retdec/bin2llvmir/providers/processed_functions.h"
+#include "bin2llvmir/utils/llvmir_tests.h"
+
+using namespace ::testing;
+using namespace llvm;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+/**
+ * @brief Tests for the @c ProcessedFunctionsProvider.
+ */
+class ProcessedFunctionsProviderTests: public LlvmIrTests
+{
+	protected:
+		const char pass1 = 0;
+		const char pass2 = 0;
+};
+
+TEST_F(ProcessedFunctionsProviderTests, processedFunctionIsUnchangedOnlyForItsPass)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @fnc() {
+			store i32 1, i32* @r
+			ret void
+		}
+	)");
+	auto* f = getFunctionByName("fnc");
+
+	EXPECT_FALSE(ProcessedFunctionsProvider::isUnchanged(module.get(), &pass1, f));
+	ProcessedFunctionsProvider::setProcessed(module.get(), &pass1, f);
+
+	EXPECT_TRUE(ProcessedFunctionsProvider::isUnchanged(module.get(), &pass1, f));
+	EXPECT_FALSE(ProcessedFunctionsProvider::isUnchanged(module.get(), &pass2, f));
+}
+
+TEST_F(ProcessedFunctionsProviderTests, modifiedFunctionIsNotUnchanged)
+{
+	parseInput(R"(
+		@r = global i32 0
+		define void @fnc() {
+			store i32 1, i32* @r
+			ret void
+		}
+	)");
+	auto* f = getFunctionByName("fnc");
+	auto* s = cast<StoreInst>(&f->front().front());
+
+	ProcessedFunctionsProvider::setProcessed(module.get(), &pass1, f);
+	s->setOperand(0, ConstantInt::get(s->getValueOperand()->getType(), 2));
+	EXPECT_FALSE(ProcessedFunctionsProvider::isUnchanged(module.get(), &pass1, f));
+
+	ProcessedFunctionsProvider::setProcessed(module.get(), &pass1, f);
+	new LoadInst(s->getPointerOperand(), "", s);
+	EXPECT_FALSE(ProcessedFunctionsProvider::isUnchanged(module.get(), &pass1, f));
+}
+
+TEST_F(ProcessedFunctionsProviderTests, clearForgetsProcessedFunctions)
+{
+	parseInput(R"(
+		define void @fnc() {
+			ret void
+		}
+	)");
+	auto* f = getFunctionByName("fnc");
+
+	ProcessedFunctionsProvider::setProcessed(module.get(), &pass1, f);
+	ProcessedFunctionsProvider::clear();
+
+	EXPECT_FALSE(ProcessedFunctionsProvider::isUnchanged(module.get(), &pass1, f));
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
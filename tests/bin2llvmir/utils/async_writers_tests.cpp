@@ -0,0 +1,82 @@
+/**
+ * @file tests/bin2llvmir/utils/async_writers_tests.cpp
+ * @brief Tests for the @c AsyncWriters class.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <atomic>
+#include <stdexcept>
+
+#include <llvm/Support/raw_ostream.h>
+
+#include "bin2llvmir/utils/llvmir_tests.h"
+#include "retdec/bin2llvmir/utils/async_writers.h"
+
+using namespace ::testing;
+using namespace llvm;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+class AsyncWritersTests : public LlvmIrTests
+{
+	protected:
+		std::string print(const Module& m)
+		{
+			std::string str;
+			raw_string_ostream os(str);
+			m.print(os, nullptr, true);
+			return os.str();
+		}
+};
+
+TEST_F(AsyncWritersTests, snapshotPrintsSameAsModule)
+{
+	parseInput(R"(
+		@g = global i32 0
+		define i32 @fnc(i32 %a) {
+			%b = add i32 %a, 1
+			store i32 %b, i32* @g
+			%c = load i32, i32* @g
+			ret i32 %c
+		}
+		define void @main() {
+			%a = call i32 @fnc(i32 1)
+			ret void
+		}
+	)");
+
+	auto bitcode = AsyncWriters::serialize(*module);
+	auto s = AsyncWriters::snapshot(*bitcode, module->getModuleIdentifier());
+
+	ASSERT_NE(nullptr, s.module);
+	EXPECT_NE(&context, &s.module->getContext());
+	EXPECT_EQ(print(*module), print(*s.module));
+}
+
+TEST_F(AsyncWritersTests, waitJoinsAllJobs)
+{
+	std::atomic<int> done(0);
+	for (int i = 0; i < 4; ++i)
+	{
+		AsyncWriters::start([&done]() { ++done; });
+	}
+
+	AsyncWriters::wait();
+
+	EXPECT_EQ(4, done);
+	EXPECT_EQ(0, AsyncWriters::running());
+}
+
+TEST_F(AsyncWritersTests, waitRethrowsFailureOfJobOnce)
+{
+	AsyncWriters::start([]() { throw std::runtime_error("failure"); });
+
+	EXPECT_THROW(AsyncWriters::wait(), std::runtime_error);
+	EXPECT_NO_THROW(AsyncWriters::wait());
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
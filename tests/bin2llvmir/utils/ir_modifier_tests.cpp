@@ -487,6 +487,52 @@ TEST_F(IrModifierTests, modifyFunctionVariadic)
 	checkModuleAgainstExpectedIr(exp);
 }
 
+//
+// applyObjectTypeChanges()
+//
+
+TEST_F(IrModifierTests, applyObjectTypeChangesSharesCastsOfChangedObjects)
+{
+	parseInput(R"(
+		declare void @use(i32*)
+		define void @fnc() {
+			%x = alloca i32
+			%y = alloca i32
+			call void @use(i32* %x)
+			call void @use(i32* %y)
+			call void @use(i32* %x)
+			ret void
+		}
+	)");
+	auto* x = getValueByName("x");
+	auto* y = getValueByName("y");
+	auto* f = Type::getFloatTy(context);
+
+	auto c = Config::empty(module.get());
+	IrModifier irm(module.get(), &c);
+	irm.scheduleObjectTypeChange(x, f);
+	irm.scheduleObjectTypeChange(y, f);
+	auto n = irm.applyObjectTypeChanges(nullptr);
+
+	std::string exp = R"(
+		declare void @use(i32*)
+		define void @fnc() {
+			%x = alloca float
+			%1 = bitcast float* %x to i32*
+			%2 = alloca i32
+			%y = alloca float
+			%3 = bitcast float* %y to i32*
+			%4 = alloca i32
+			call void @use(i32* %1)
+			call void @use(i32* %3)
+			call void @use(i32* %1)
+			ret void
+		}
+	)";
+	checkModuleAgainstExpectedIr(exp);
+	EXPECT_EQ(2, n);
+}
+
 } // namespace tests
 } // namespace bin2llvmir
 } // namespace retdec
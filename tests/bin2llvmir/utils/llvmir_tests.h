@@ -20,7 +20,9 @@
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include "retdec/bin2llvmir/analyses/reaching_definitions.h"
 #include "retdec/bin2llvmir/analyses/symbolic_tree.h"
+#include "retdec/bin2llvmir/optimizations/inst_opt/inst_opt_pass.h"
 #include "retdec/bin2llvmir/utils/llvm.h"
 #include "retdec/fileformat/file_format/raw_data/raw_data_format.h"
 #include "retdec/loader/loader.h"
@@ -33,6 +35,7 @@
 #include "retdec/bin2llvmir/providers/fileimage.h"
 #include "retdec/bin2llvmir/providers/lti.h"
 #include "retdec/bin2llvmir/providers/names.h"
+#include "retdec/bin2llvmir/providers/processed_functions.h"
 #include "retdec/bin2llvmir/utils/debug.h"
 #include "retdec/utils/string.h"
 
@@ -67,8 +70,11 @@ class LlvmIrTests : public ::testing::Test
 			FileImageProvider::clear();
 			LtiProvider::clear();
 			NamesProvider::clear();
+			ProcessedFunctionsProvider::clear();
 			SymbolicTree::clear();
 			CallingConventionProvider::clear();
+			ReachingDefinitionsProvider::clear();
+			InstructionOptimizer::clear();
 		}
 
 		/**
@@ -0,0 +1,152 @@
+/**
+ * @file tests/bin2llvmir/utils/ordinal_database_tests.cpp
+ * @brief Tests for the @c OrdinalDatabase class.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <fstream>
+#include <map>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "retdec/bin2llvmir/utils/ordinal_database.h"
+#include "retdec/utils/filesystem.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+class OrdinalDatabaseTests : public Test
+{
+	protected:
+		using Libraries = std::map<std::string, std::map<std::uint32_t, std::string>>;
+
+	protected:
+		/// Compile @p libs the same way as @c support/compile-ordinals.py.
+		static std::string compile(const Libraries& libs)
+		{
+			std::size_t ordCount = 0;
+			for (auto& lib : libs)
+			{
+				ordCount += lib.second.size();
+			}
+
+			std::string header = "RDORDDB1";
+			append32(header, libs.size());
+			append32(header, ordCount);
+
+			std::size_t stringsOffset = header.size()
+					+ libs.size() * 12 + ordCount * 8;
+			std::string libEntries, ordEntries, strings;
+			auto intern = [&](const std::string& s) {
+				std::size_t offset = stringsOffset + strings.size();
+				strings += s + '\0';
+				return offset;
+			};
+
+			std::size_t first = 0;
+			for (auto& lib : libs)
+			{
+				append32(libEntries, intern(lib.first));
+				append32(libEntries, first);
+				append32(libEntries, lib.second.size());
+				for (auto& ord : lib.second)
+				{
+					append32(ordEntries, ord.first);
+					append32(ordEntries, intern(ord.second));
+				}
+				first += lib.second.size();
+			}
+
+			return header + libEntries + ordEntries + strings;
+		}
+
+		static void append32(std::string& data, std::uint32_t value)
+		{
+			for (int i = 0; i < 4; ++i)
+			{
+				data += static_cast<char>((value >> (8 * i)) & 0xff);
+			}
+		}
+
+		static std::unique_ptr<OrdinalDatabase> create(const std::string& data)
+		{
+			return OrdinalDatabase::create(
+					llvm::MemoryBuffer::getMemBufferCopy(data)
+			);
+		}
+};
+
+TEST_F(OrdinalDatabaseTests, getNameReturnsNamesOfKnownOrdinals)
+{
+	auto db = create(compile({
+		{"arm/ws2_32", {{3, "closesocket_arm"}}},
+		{"x86/oleaut32", {{2, "SysAllocString"}}},
+		{"x86/ws2_32", {{3, "closesocket"}, {115, "WSAStartup"}, {116, "WSACleanup"}}},
+	}));
+	ASSERT_NE(nullptr, db);
+
+	EXPECT_EQ("closesocket", db->getName("x86", "ws2_32", 3));
+	EXPECT_EQ("WSAStartup", db->getName("x86", "ws2_32", 115));
+	EXPECT_EQ("WSACleanup", db->getName("x86", "ws2_32", 116));
+	EXPECT_EQ("SysAllocString", db->getName("x86", "oleaut32", 2));
+	EXPECT_EQ("closesocket_arm", db->getName("arm", "ws2_32", 3));
+}
+
+TEST_F(OrdinalDatabaseTests, getNameReturnsEmptyStringForUnknownOrdinalsAndLibraries)
+{
+	auto db = create(compile({
+		{"x86/oleaut32", {{2, "SysAllocString"}}},
+		{"x86/ws2_32", {{3, "closesocket"}}},
+	}));
+	ASSERT_NE(nullptr, db);
+
+	EXPECT_TRUE(db->getName("x86", "ws2_32", 4).empty());
+	EXPECT_TRUE(db->getName("x86", "kernel32", 3).empty());
+	EXPECT_TRUE(db->getName("arm", "ws2_32", 3).empty());
+	EXPECT_TRUE(db->hasLibrary("x86", "oleaut32"));
+	EXPECT_FALSE(db->hasLibrary("x86", "oleaut"));
+}
+
+TEST_F(OrdinalDatabaseTests, createFailsForInvalidData)
+{
+	std::string data = compile({{"x86/ws2_32", {{3, "closesocket"}}}});
+
+	EXPECT_EQ(nullptr, create(""));
+	EXPECT_EQ(nullptr, create("RDORDDB0" + data.substr(8)));
+	EXPECT_EQ(nullptr, create(data.substr(0, 20)));
+}
+
+TEST_F(OrdinalDatabaseTests, getLoadsDatabaseFromDirectoryOnlyOnce)
+{
+	auto dir = fs::temp_directory_path() / ("retdec-ordinal-database-tests-"
+			+ std::to_string(std::random_device()()));
+	fs::create_directories(dir);
+	{
+		std::ofstream out(dir / OrdinalDatabase::fileName, std::ios::binary);
+		out << compile({{"x86/ws2_32", {{3, "closesocket"}}}});
+	}
+
+	auto db = OrdinalDatabase::get(dir.string());
+	std::error_code ec;
+	fs::remove_all(dir, ec);
+
+	ASSERT_NE(nullptr, db);
+	EXPECT_EQ("closesocket", db->getName("x86", "ws2_32", 3));
+	EXPECT_EQ(db, OrdinalDatabase::get(dir.string()));
+}
+
+TEST_F(OrdinalDatabaseTests, getReturnsNullptrForDirectoryWithoutDatabase)
+{
+	auto dir = fs::temp_directory_path() / ("retdec-ordinal-database-tests-"
+			+ std::to_string(std::random_device()()));
+
+	EXPECT_EQ(nullptr, OrdinalDatabase::get(dir.string()));
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
@@ -0,0 +1,242 @@
+/**
+* @file tests/bin2llvmir/utils/symbolic_tree_match_tests.cpp
+* @brief Tests for the @c SymbolicTree pattern matching.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <chrono>
+#include <sstream>
+
+#include "retdec/bin2llvmir/utils/symbolic_tree_match.h"
+#include "bin2llvmir/utils/llvmir_tests.h"
+
+using namespace ::testing;
+using namespace llvm;
+using namespace retdec::bin2llvmir::st_match;
+
+namespace retdec {
+namespace bin2llvmir {
+namespace tests {
+
+/**
+ * Pattern which counts how many times it was run.
+ */
+template <typename Pattern>
+struct counting_match
+{
+	Pattern P;
+	unsigned* runs;
+
+	counting_match(const Pattern& p, unsigned* r) :
+			P(p),
+			runs(r)
+	{
+	}
+
+	bool match(SymbolicTree& st)
+	{
+		++*runs;
+		return P.match(st);
+	}
+};
+
+} // namespace tests
+
+namespace st_match {
+
+template <typename Pattern>
+struct pattern_shape<tests::counting_match<Pattern>> : pattern_shape<Pattern>
+{
+};
+
+} // namespace st_match
+
+namespace tests {
+
+class SymbolicTreeMatchTests: public LlvmIrTests
+{
+	protected:
+		template <typename Pattern>
+		counting_match<Pattern> counted(const Pattern& p, unsigned* runs)
+		{
+			return counting_match<Pattern>(p, runs);
+		}
+};
+
+TEST_F(SymbolicTreeMatchTests,
+shapeIsOpcodeAndArityOfRoot)
+{
+	parseInput(R"(
+		define i32 @f(i32 %x) {
+			%a = add i32 %x, 5
+			%l = load i32, i32* inttoptr (i32 4096 to i32*)
+			ret i32 %a
+		}
+	)");
+
+	auto add = SymbolicTree::Linear(getValueByName("a"));
+	Shape addShape(add);
+	EXPECT_EQ(Instruction::Add, addShape.opcode);
+	EXPECT_EQ(2, addShape.arity);
+
+	auto load = SymbolicTree::Linear(getValueByName("l"));
+	Shape loadShape(load);
+	EXPECT_EQ(Instruction::Load, loadShape.opcode);
+	EXPECT_EQ(1, loadShape.arity);
+
+	auto x = SymbolicTree::Linear(getValueByName("x"));
+	Shape xShape(x);
+	EXPECT_EQ(0, xShape.opcode);
+	EXPECT_EQ(0, xShape.arity);
+}
+
+TEST_F(SymbolicTreeMatchTests,
+patternShapesAreKnownAtCompileTime)
+{
+	ConstantInt* ci = nullptr;
+	using AddPattern = decltype(m_Add(m_Value(), m_ConstantInt(ci)));
+	using LoadPattern = decltype(m_Load(m_Value()));
+	using OrPattern = decltype(m_CombineOr(
+			m_Add(m_Value(), m_Value()),
+			m_Sub(m_Value(), m_Value())));
+	using AndPattern = decltype(m_CombineAnd(
+			m_Value(),
+			m_Sub(m_Value(), m_Value())));
+
+	static_assert(pattern_shape<AddPattern>::opcode == Instruction::Add, "");
+	static_assert(pattern_shape<AddPattern>::arity == 2, "");
+	static_assert(pattern_shape<LoadPattern>::opcode == Instruction::Load, "");
+	static_assert(pattern_shape<LoadPattern>::arity == 1, "");
+	static_assert(pattern_shape<OrPattern>::opcode == ANY_OPCODE, "");
+	static_assert(pattern_shape<OrPattern>::arity == 2, "");
+	static_assert(pattern_shape<AndPattern>::opcode == Instruction::Sub, "");
+	static_assert(pattern_shape<decltype(m_Value())>::opcode == ANY_OPCODE, "");
+	static_assert(pattern_shape<decltype(m_Value())>::arity == ANY_ARITY, "");
+}
+
+TEST_F(SymbolicTreeMatchTests,
+matchFirstReturnsIndexOfFirstMatchingPattern)
+{
+	parseInput(R"(
+		define i32 @f(i32 %x) {
+			%a = sub i32 %x, 5
+			ret i32 %a
+		}
+	)");
+	auto st = SymbolicTree::Linear(getValueByName("a"));
+	ConstantInt* ci = nullptr;
+
+	EXPECT_EQ(1, match_first(st,
+			m_Add(m_Value(), m_ConstantInt(ci)),
+			m_Sub(m_Value(), m_ConstantInt(ci)),
+			m_Sub(m_Value(), m_Value())));
+	ASSERT_NE(nullptr, ci);
+	EXPECT_EQ(5, ci->getZExtValue());
+
+	EXPECT_EQ(-1, match_first(st,
+			m_Add(m_Value(), m_Value()),
+			m_Load(m_Value())));
+}
+
+TEST_F(SymbolicTreeMatchTests,
+patternsOfIncompatibleShapesAreNotRun)
+{
+	parseInput(R"(
+		define i32 @f(i32 %x) {
+			%a = sub i32 %x, 5
+			ret i32 %a
+		}
+	)");
+	auto st = SymbolicTree::Linear(getValueByName("a"));
+	unsigned addRuns = 0;
+	unsigned loadRuns = 0;
+	unsigned valueRuns = 0;
+
+	EXPECT_EQ(2, match_first(st,
+			counted(m_Add(m_Value(), m_Value()), &addRuns),
+			counted(m_Load(m_Value()), &loadRuns),
+			counted(m_Value(), &valueRuns)));
+
+	EXPECT_EQ(0, addRuns);
+	EXPECT_EQ(0, loadRuns);
+	EXPECT_EQ(1, valueRuns);
+}
+
+/**
+ * Benchmark of a chain of patterns tried on every node of many trees, as in
+ * @c SymbolicTree::simplifyNode(). Most nodes match none of the patterns.
+ */
+TEST_F(SymbolicTreeMatchTests,
+patternChainBenchmark)
+{
+	const unsigned count = 2000;
+	std::stringstream ir;
+	ir << "define i32 @f(i32 %x, i32 %y) {\n";
+	ir << "%v0 = add i32 %x, %y\n";
+	for (unsigned i = 1; i < count; ++i)
+	{
+		const char* op[] = {"xor", "mul", "shl", "lshr", "or", "and"};
+		ir << "%v" << i << " = " << op[i % 6] << " i32 %v" << i - 1
+				<< ", %" << (i % 2 ? "x" : "y") << "\n";
+	}
+	ir << "ret i32 %v" << count - 1 << "\n}\n";
+	parseInput(ir.str());
+
+	std::vector<SymbolicTree> trees;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		trees.push_back(SymbolicTree::Linear(
+				getValueByName("v" + std::to_string(i))));
+	}
+
+	ConstantInt* c1 = nullptr;
+	ConstantInt* c2 = nullptr;
+	GlobalVariable* g = nullptr;
+	auto chain = [&](SymbolicTree& n, auto... shape)
+	{
+		return match(n, shape..., m_Load(m_GlobalVariable(g)))
+				|| match(n, shape..., m_Load(m_Value()))
+				|| match(n, shape..., m_Add(m_ConstantInt(c1), m_ConstantInt(c2)))
+				|| match(n, shape..., m_Sub(m_ConstantInt(c1), m_ConstantInt(c2)))
+				|| match(n, shape..., m_Or(m_ConstantInt(c1), m_ConstantInt(c2)))
+				|| match(n, shape..., m_And(m_ConstantInt(c1), m_ConstantInt(c2)))
+				|| match(n, shape..., m_Add(m_GlobalVariable(g), m_ConstantInt(c1)))
+				|| match(n, shape..., m_Add(m_Value(), m_Zero()))
+				|| match(n, shape..., m_Sub(m_Value(), m_Zero()))
+				|| match(n, shape..., m_Add(m_Zero(), m_Value()))
+				|| match(n, shape..., m_Sub(m_Zero(), m_Value()));
+	};
+
+	unsigned plainMatches = 0;
+	auto t = std::chrono::steady_clock::now();
+	for (auto& tree : trees)
+	{
+		for (auto* n : tree.getPreOrder())
+		{
+			plainMatches += chain(*n);
+		}
+	}
+	auto plainUs = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - t).count();
+
+	unsigned shapeMatches = 0;
+	t = std::chrono::steady_clock::now();
+	for (auto& tree : trees)
+	{
+		for (auto* n : tree.getPreOrder())
+		{
+			shapeMatches += chain(*n, Shape(*n));
+		}
+	}
+	auto shapeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - t).count();
+
+	RecordProperty("plainMicroseconds", static_cast<int>(plainUs));
+	RecordProperty("shapeMicroseconds", static_cast<int>(shapeUs));
+
+	EXPECT_EQ(plainMatches, shapeMatches);
+}
+
+} // namespace tests
+} // namespace bin2llvmir
+} // namespace retdec
@@ -0,0 +1,113 @@
+/**
+ * @file tests/capstone2llvmir/insn_pool_tests.cpp
+ * @brief Tests for the @c CapstoneInsnPool class.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/capstone2llvmir/insn_pool.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace capstone2llvmir {
+namespace tests {
+
+class CapstoneInsnPoolTests : public Test
+{
+	protected:
+		/// Disassemble 32-bit x86 @a bytes into instruction @a insn.
+		bool disassembleX86(
+				const std::vector<uint8_t>& bytes,
+				cs_insn* insn)
+		{
+			csh h = 0;
+			if (cs_open(CS_ARCH_X86, CS_MODE_32, &h) != CS_ERR_OK)
+			{
+				return false;
+			}
+			cs_option(h, CS_OPT_DETAIL, CS_OPT_ON);
+
+			const uint8_t* code = bytes.data();
+			std::size_t size = bytes.size();
+			uint64_t address = 0x1000;
+			bool ret = cs_disasm_iter(h, &code, &size, &address, insn);
+
+			cs_close(&h);
+			return ret;
+		}
+};
+
+TEST_F(CapstoneInsnPoolTests,
+DetailSizeIsArchSpecificPrefixOfDetail) {
+	for (auto arch : {CS_ARCH_ARM, CS_ARCH_ARM64, CS_ARCH_MIPS,
+			CS_ARCH_PPC, CS_ARCH_X86})
+	{
+		auto sz = CapstoneInsnPool::getDetailSize(arch);
+		EXPECT_LE(sz, sizeof(cs_detail));
+		EXPECT_GT(sz, offsetof(cs_detail, x86));
+		EXPECT_EQ(0, sz % alignof(cs_detail));
+	}
+}
+
+TEST_F(CapstoneInsnPoolTests,
+AllocatedInstructionsAreDistinctAndHaveDetails) {
+	CapstoneInsnPool pool(CS_ARCH_MIPS, 2);
+
+	auto* i1 = pool.allocate();
+	auto* i2 = pool.allocate();
+	auto* i3 = pool.allocate();
+
+	EXPECT_NE(i1, i2);
+	EXPECT_NE(i2, i3);
+	EXPECT_NE(nullptr, i1->detail);
+	EXPECT_NE(nullptr, i3->detail);
+	EXPECT_NE(i1->detail, i2->detail);
+	EXPECT_EQ(3, pool.size());
+}
+
+TEST_F(CapstoneInsnPoolTests,
+ReleasedLastInstructionIsReused) {
+	CapstoneInsnPool pool(CS_ARCH_ARM);
+
+	pool.allocate();
+	auto* i2 = pool.allocate();
+	pool.release(i2);
+
+	EXPECT_EQ(1, pool.size());
+	EXPECT_EQ(i2, pool.allocate());
+}
+
+TEST_F(CapstoneInsnPoolTests,
+ReleasingNotLastInstructionDoesNothing) {
+	CapstoneInsnPool pool(CS_ARCH_ARM);
+
+	auto* i1 = pool.allocate();
+	pool.allocate();
+	pool.release(i1);
+
+	EXPECT_EQ(2, pool.size());
+}
+
+TEST_F(CapstoneInsnPoolTests,
+PooledInstructionCanBeDisassembledInto) {
+	CapstoneInsnPool pool(CS_ARCH_X86);
+	auto* insn = pool.allocate();
+
+	// mov eax, 0x12345678
+	ASSERT_TRUE(disassembleX86({0xb8, 0x78, 0x56, 0x34, 0x12}, insn));
+
+	EXPECT_EQ(X86_INS_MOV, insn->id);
+	EXPECT_EQ(0x1000, insn->address);
+	EXPECT_EQ(5, insn->size);
+	ASSERT_EQ(2, insn->detail->x86.op_count);
+	EXPECT_EQ(X86_OP_IMM, insn->detail->x86.operands[1].type);
+	EXPECT_EQ(0x12345678, insn->detail->x86.operands[1].imm);
+}
+
+} // namespace tests
+} // namespace capstone2llvmir
+} // namespace retdec
@@ -0,0 +1,126 @@
+/**
+ * @file tests/capstone2llvmir/translator_pool_tests.cpp
+ * @brief Tests for the @c TranslatorPool class.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <llvm/IR/Verifier.h>
+
+#include "retdec/capstone2llvmir/translator_pool.h"
+#include "retdec/utils/parallel.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace capstone2llvmir {
+namespace tests {
+
+class TranslatorPoolTests : public Test
+{
+	protected:
+		TranslatorPoolTests() :
+				_module("test", _context)
+		{
+			_translator = Capstone2LlvmIrTranslator::createX86_32(&_module);
+
+			auto* f = llvm::Function::Create(
+					llvm::FunctionType::get(
+							llvm::Type::getVoidTy(_context),
+							false),
+					llvm::GlobalValue::LinkageTypes::ExternalLinkage,
+					"root",
+					&_module);
+			auto* bb = llvm::BasicBlock::Create(_context, "", f);
+			_irb = std::make_unique<llvm::IRBuilder<>>(
+					llvm::ReturnInst::Create(_context, bb));
+		}
+
+		/// Addresses of the mapping instructions of function @c root.
+		std::vector<uint64_t> getMappedAddresses()
+		{
+			std::vector<uint64_t> ret;
+			for (auto& bb : *_module.getFunction("root"))
+			{
+				for (auto& i : bb)
+				{
+					if (auto* s = _translator->isSpecialAsm2LlvmInstr(&i))
+					{
+						auto* ci = llvm::cast<llvm::ConstantInt>(
+								s->getValueOperand());
+						ret.push_back(ci->getZExtValue());
+					}
+				}
+			}
+			return ret;
+		}
+
+	protected:
+		llvm::LLVMContext _context;
+		llvm::Module _module;
+		std::unique_ptr<Capstone2LlvmIrTranslator> _translator;
+		std::unique_ptr<llvm::IRBuilder<>> _irb;
+
+		/// mov eax, 1; add eax, ebx; inc ecx; sub eax, ecx
+		const std::vector<uint8_t> _code = {
+				0xb8, 0x01, 0x00, 0x00, 0x00,
+				0x01, 0xd8,
+				0x41,
+				0x29, 0xc8};
+};
+
+TEST_F(TranslatorPoolTests,
+CloneHasSameArchitectureAndModeButOwnModule) {
+	llvm::LLVMContext ctx;
+	llvm::Module m("clone", ctx);
+
+	auto clone = _translator->clone(&m);
+
+	EXPECT_EQ(_translator->getArchitecture(), clone->getArchitecture());
+	EXPECT_EQ(_translator->getBasicMode(), clone->getBasicMode());
+	EXPECT_EQ(&m, clone->getModule());
+	EXPECT_NE(nullptr, m.getNamedGlobal(
+			_translator->getAsm2LlvmMapGlobalVariable()->getName()));
+}
+
+TEST_F(TranslatorPoolTests,
+CommittedCodeIsInOrderOfCommitsAndUsesMainModuleGlobals) {
+	const std::size_t chunks = 16;
+	TranslatorPool pool(*_translator, 4);
+	std::vector<TranslatorPool::StagedCode> staged(chunks);
+
+	utils::parallelFor(chunks, 4, [&](std::size_t i)
+	{
+		auto* w = pool.acquire();
+		auto& irb = w->stage();
+		auto res = w->getTranslator().translate(
+				_code.data(),
+				_code.size(),
+				0x1000 + i * _code.size(),
+				irb);
+		EXPECT_EQ(4, res.count);
+		staged[i] = w->finish();
+		pool.release(w);
+	});
+
+	std::size_t mapped = 0;
+	for (auto& code : staged)
+	{
+		mapped += pool.commit(code, *_irb).size();
+	}
+
+	std::vector<uint64_t> addrs = getMappedAddresses();
+	EXPECT_EQ(4 * chunks, mapped);
+	ASSERT_EQ(4 * chunks, addrs.size());
+	EXPECT_EQ(0x1000, addrs.front());
+	EXPECT_TRUE(std::is_sorted(addrs.begin(), addrs.end()));
+	EXPECT_FALSE(llvm::verifyModule(_module, &llvm::errs()));
+	EXPECT_EQ(nullptr, _module.getFunction("__capstone2llvmir_staging"));
+}
+
+} // namespace tests
+} // namespace capstone2llvmir
+} // namespace retdec
@@ -991,6 +991,92 @@ TEST_P(Capstone2LlvmIrTranslatorX86Tests, X86_INS_ADD_reg8_imm8)
 	EXPECT_NO_VALUE_CALLED();
 }
 
+TEST_P(Capstone2LlvmIrTranslatorX86Tests, X86_INS_ADD_reg8_imm8_translation_cache)
+{
+	ALL_MODES;
+
+	_translator->setUseTranslationCache(true);
+	setRegisters({
+		{X86_REG_DL, 0xf0},
+	});
+
+	emulate("add dl, 0x12; add dl, 0x12");
+
+	EXPECT_JUST_REGISTERS_LOADED({X86_REG_DL});
+	EXPECT_JUST_REGISTERS_STORED({
+		{X86_REG_DL, 0x14ULL},
+		{X86_REG_PF, true},
+		{X86_REG_SF, false},
+		{X86_REG_ZF, false},
+		{X86_REG_OF, false},
+		{X86_REG_AF, false},
+		{X86_REG_CF, false},
+	});
+	EXPECT_NO_MEMORY_LOADED_STORED();
+	EXPECT_NO_VALUE_CALLED();
+}
+
+TEST_P(Capstone2LlvmIrTranslatorX86Tests, X86_INS_ADD_reg8_imm8_lazy_flags)
+{
+	ALL_MODES;
+
+	_translator->setLazyFlags(true);
+	setRegisters({
+		{X86_REG_DL, 0xf0},
+	});
+
+	auto* f = emulate("add dl, 0x12; add dl, 0x12");
+
+	EXPECT_JUST_REGISTERS_LOADED({X86_REG_DL});
+	EXPECT_JUST_REGISTERS_STORED({
+		{X86_REG_DL, 0x14ULL},
+		{X86_REG_PF, true},
+		{X86_REG_SF, false},
+		{X86_REG_ZF, false},
+		{X86_REG_OF, false},
+		{X86_REG_AF, false},
+		{X86_REG_CF, false},
+	});
+	EXPECT_NO_MEMORY_LOADED_STORED();
+	EXPECT_NO_VALUE_CALLED();
+
+	// Flags of the first addition are overwritten before they are read.
+	std::size_t zfStores = 0;
+	for (auto& bb : *f)
+	for (auto& i : bb)
+	{
+		auto* s = llvm::dyn_cast<llvm::StoreInst>(&i);
+		zfStores += s && s->getPointerOperand() == getRegister(X86_REG_ZF);
+	}
+	EXPECT_EQ(1, zfStores);
+}
+
+TEST_P(Capstone2LlvmIrTranslatorX86Tests, X86_INS_ADD_lazy_flags_read_flags_are_kept)
+{
+	ALL_MODES;
+
+	_translator->setLazyFlags(true);
+	setRegisters({
+		{X86_REG_DL, 0xf0},
+	});
+
+	emulate("add dl, 0x12; setb al; add dl, 0x12");
+
+	EXPECT_JUST_REGISTERS_LOADED({X86_REG_DL, X86_REG_CF, X86_REG_AX});
+	EXPECT_JUST_REGISTERS_STORED({
+		{X86_REG_AL, 0x1ULL},
+		{X86_REG_DL, 0x14ULL},
+		{X86_REG_PF, true},
+		{X86_REG_SF, false},
+		{X86_REG_ZF, false},
+		{X86_REG_OF, false},
+		{X86_REG_AF, false},
+		{X86_REG_CF, false},
+	});
+	EXPECT_NO_MEMORY_LOADED_STORED();
+	EXPECT_NO_VALUE_CALLED();
+}
+
 TEST_P(Capstone2LlvmIrTranslatorX86Tests, X86_INS_ADD_reg16_mem16)
 {
 	ALL_MODES;
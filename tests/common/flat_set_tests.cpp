@@ -0,0 +1,110 @@
+/**
+* @file tests/common/flat_set_tests.cpp
+* @brief Tests for the @c flat_set module.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/common/flat_set.h"
+#include "retdec/common/function.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace common {
+namespace tests {
+
+/**
+ * @brief Tests for the @c FlatSet class.
+ */
+class FlatSetTests: public Test
+{
+
+};
+
+TEST_F(FlatSetTests, InsertKeepsElementsSortedAndUnique)
+{
+	FlatSet<int> s;
+
+	EXPECT_TRUE(s.insert(3).second);
+	EXPECT_TRUE(s.insert(1).second);
+	EXPECT_TRUE(s.insert(5).second);
+	EXPECT_FALSE(s.insert(3).second);
+	EXPECT_EQ(1, *s.insert(1).first);
+
+	EXPECT_EQ(std::vector<int>({1, 3, 5}), std::vector<int>(s.begin(), s.end()));
+}
+
+TEST_F(FlatSetTests, InsertWithEndHintAppendsOrderedElements)
+{
+	FlatSet<int> s;
+
+	s.insert(s.end(), 1);
+	s.insert(s.end(), 2);
+	// Out of order and duplicate elements are inserted as without hint.
+	s.insert(s.end(), 0);
+	s.insert(s.end(), 2);
+
+	EXPECT_EQ(std::vector<int>({0, 1, 2}), std::vector<int>(s.begin(), s.end()));
+}
+
+TEST_F(FlatSetTests, RangeInsertMergesAndKeepsExistingEquivalentElements)
+{
+	using Pair = std::pair<int, std::string>;
+	auto firstLess = [](const Pair& a, const Pair& b) {
+		return a.first < b.first;
+	};
+	FlatSet<Pair, decltype(firstLess)> s(firstLess);
+	s.insert(Pair(2, "old"));
+
+	std::vector<Pair> v = {{3, "a"}, {2, "new"}, {1, "b"}, {3, "c"}};
+	s.insert(v.begin(), v.end());
+
+	ASSERT_EQ(3, s.size());
+	EXPECT_EQ(Pair(1, "b"), *s.begin());
+	EXPECT_EQ(Pair(2, "old"), *std::next(s.begin()));
+	EXPECT_EQ(Pair(3, "a"), *s.rbegin());
+}
+
+TEST_F(FlatSetTests, LookupsWorkAsInStdSet)
+{
+	FlatSet<int> s = {10, 20, 30};
+
+	EXPECT_EQ(1, s.count(20));
+	EXPECT_EQ(0, s.count(25));
+	EXPECT_EQ(s.end(), s.find(25));
+	EXPECT_EQ(20, *s.find(20));
+	EXPECT_EQ(20, *s.lower_bound(15));
+	EXPECT_EQ(30, *s.upper_bound(20));
+	EXPECT_EQ(s.end(), s.lower_bound(31));
+}
+
+TEST_F(FlatSetTests, EraseRemovesElements)
+{
+	FlatSet<int> s = {1, 2, 3};
+
+	EXPECT_EQ(1, s.erase(2));
+	EXPECT_EQ(0, s.erase(2));
+	EXPECT_EQ(3, *s.erase(s.begin()));
+
+	EXPECT_EQ(FlatSet<int>({3}), s);
+}
+
+TEST_F(FlatSetTests, TransparentComparatorAllowsLookupByKey)
+{
+	FunctionSet fs;
+	fs.emplace(Address(0x2000), Address(0x2010), "f2");
+	fs.emplace(Address(0x1000), Address(0x1010), "f1");
+
+	EXPECT_EQ("f1", fs.find(Address(0x1000))->getName());
+	EXPECT_EQ("f2", fs.getRange(0x2008)->getName());
+	EXPECT_EQ(nullptr, fs.getRange(0x1010));
+}
+
+} // namespace tests
+} // namespace common
+} // namespace retdec
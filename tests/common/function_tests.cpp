@@ -74,6 +74,60 @@ TEST_F(FunctionContainerTests, TestGetFunctionByStartAddress)
 	ASSERT_TRUE(n == nullptr);
 }
 
+TEST_F(FunctionContainerTests, TestGetFunctionByStartAddressReflectsErase)
+{
+	funcs.erase(fnc4);
+	EXPECT_EQ(nullptr, funcs.getFunctionByStartAddress(fnc4.getStart()));
+
+	funcs.erase(funcs.find(fnc3));
+	EXPECT_EQ(nullptr, funcs.getFunctionByStartAddress(fnc3.getStart()));
+
+	funcs.clear();
+	EXPECT_EQ(nullptr, funcs.getFunctionByStartAddress(fnc1.getStart()));
+}
+
+TEST_F(FunctionContainerTests, TestGetFunctionByStartAddressReturnsFirstOfFunctionsOnTheSameAddress)
+{
+	Function f("fnc0");
+	f.setStart(fnc2.getStart());
+	funcs.insert(f);
+
+	auto* r = funcs.getFunctionByStartAddress(fnc2.getStart());
+	ASSERT_TRUE(r != nullptr);
+	EXPECT_EQ("fnc0", r->getName());
+
+	funcs.erase(f);
+	r = funcs.getFunctionByStartAddress(fnc2.getStart());
+	ASSERT_TRUE(r != nullptr);
+	EXPECT_EQ("fnc2", r->getName());
+}
+
+TEST_F(FunctionContainerTests, TestInsertionOfExistingNameKeepsTheOriginalAddress)
+{
+	Function f(fnc1.getName());
+	f.setStart(0x5000);
+	funcs.insert(f);
+
+	EXPECT_EQ(nullptr, funcs.getFunctionByStartAddress(0x5000));
+	EXPECT_NE(nullptr, funcs.getFunctionByStartAddress(fnc1.getStart()));
+}
+
+TEST_F(FunctionContainerTests, TestCopiedContainerPointsToItsOwnFunctions)
+{
+	FunctionContainer copy(funcs);
+	FunctionContainer assigned;
+	assigned = funcs;
+	funcs.clear();
+
+	auto* c = copy.getFunctionByStartAddress(fnc2.getStart());
+	ASSERT_TRUE(c != nullptr);
+	EXPECT_EQ(&(*copy.find(fnc2)), c);
+
+	auto* a = assigned.getFunctionByStartAddress(fnc2.getStart());
+	ASSERT_TRUE(a != nullptr);
+	EXPECT_EQ(&(*assigned.find(fnc2)), a);
+}
+
 } // namespace tests
 } // namespace common
 } // namespace retdec
@@ -4,6 +4,10 @@
  * @copyright (c) 2017 Avast Software, licensed under the MIT license
  */
 
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
 #include <gtest/gtest.h>
 
 #include "retdec/config/config.h"
@@ -42,6 +46,84 @@ TEST_F(ConfigTests, ReadJsonStringCanReadEmptyJson)
 	ASSERT_NO_THROW(config.readJsonString("{}"));
 }
 
+TEST_F(ConfigTests, ReadBinaryStringReadsWhatGenerateBinaryStringGenerated)
+{
+	config.parameters.abiPaths.insert("/abi/path");
+	config.parameters.setSelectedDecodeDepth(1234567);
+	config.parameters.setIsBinaryOutputConfig(true);
+	config.functions.insert(common::Function("main"));
+	config.functions.insert(common::Function("ack"));
+
+	Config other;
+	other.readBinaryString(config.generateBinaryString());
+
+	EXPECT_EQ(config.parameters.abiPaths, other.parameters.abiPaths);
+	EXPECT_EQ(1234567, other.parameters.getSelectedDecodeDepth());
+	EXPECT_TRUE(other.parameters.isBinaryOutputConfig());
+	EXPECT_EQ(2, other.functions.size());
+	EXPECT_TRUE(other.functions.hasFunction("main"));
+	EXPECT_TRUE(other.functions.hasFunction("ack"));
+}
+
+TEST_F(ConfigTests, BinaryStringIsSmallerThanJsonString)
+{
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		config.functions.insert(common::Function("fnc" + std::to_string(i)));
+	}
+
+	EXPECT_LT(
+			config.generateBinaryString().size(),
+			config.generateJsonString().size());
+}
+
+TEST_F(ConfigTests, ReadJsonFileReadsWhatGenerateJsonFileGenerated)
+{
+	std::string path = "config_tests_generated.json";
+	config.parameters.abiPaths.insert("/abi/path");
+	config.functions.insert(common::Function("main"));
+
+	for (bool compact : {false, true})
+	{
+		config.parameters.setIsCompactOutputConfig(compact);
+		ASSERT_EQ(path, config.generateJsonFile(path));
+
+		Config other;
+		other.readJsonFile(path);
+
+		EXPECT_EQ(compact, other.parameters.isCompactOutputConfig());
+		EXPECT_EQ(config.parameters.abiPaths, other.parameters.abiPaths);
+		EXPECT_TRUE(other.functions.hasFunction("main"));
+	}
+	std::remove(path.c_str());
+}
+
+TEST_F(ConfigTests, CompactJsonFileHasNoIndentation)
+{
+	std::string path = "config_tests_compact.json";
+	config.functions.insert(common::Function("main"));
+	config.parameters.setIsCompactOutputConfig(true);
+
+	config.generateJsonFile(path);
+	std::ifstream file(path);
+	std::string content(
+			(std::istreambuf_iterator<char>(file)),
+			std::istreambuf_iterator<char>());
+	file.close();
+	std::remove(path.c_str());
+
+	EXPECT_EQ(std::string::npos, content.find('\n'));
+	EXPECT_LT(content.size(), config.generateJsonString().size());
+}
+
+TEST_F(ConfigTests, ParsingBadBinaryInputThrowsAnException)
+{
+	std::string data = config.generateBinaryString();
+	data.pop_back();
+
+	ASSERT_THROW(config.readBinaryString(data), ParseException);
+}
+
 TEST_F(ConfigTests, FailedReadJsonStringKeepsAllConfigData)
 {
 	std::string abi = "/abi/path";
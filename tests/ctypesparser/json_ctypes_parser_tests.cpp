@@ -1952,6 +1952,130 @@ ParsingCircularTypedefsBreaksLoopAndSetsTypedefToUnknownType)
 	EXPECT_EQ(retdec::ctypes::UnknownType::create(), type3->getAliasedType());
 }
 
+TEST_F(JSONCTypesParserTests,
+IndexedFunctionIsParsedOnlyWhenRequested)
+{
+	std::stringstream json(R"(
+		{
+			"functions": {
+				"ff": {
+					"decl": "int ff(int b);",
+					"header": "CHeader.h",
+					"name": "ff",
+					"params": [
+						{
+							"name": "b",
+							"type": "46f8ab7c0cff9df7cd124852e26022a6bf89e315"
+						}
+					],
+					"ret_type": "46f8ab7c0cff9df7cd124852e26022a6bf89e315"
+				},
+				"gg": {
+					"decl": "void gg();",
+					"header": "CHeader.h",
+					"name": "gg",
+					"params": [],
+					"ret_type": "invalid"
+				}
+			},
+			"types": {
+				"46f8ab7c0cff9df7cd124852e26022a6bf89e315": {
+					"name": "int",
+					"type": "integral_type"
+				}
+			}
+		}
+	)");
+	auto context = std::make_shared<retdec::ctypes::Context>();
+
+	ASSERT_NO_THROW(parser.loadIndex(json, context));
+	EXPECT_FALSE(context->hasFunctionWithName("ff"));
+
+	auto func = parser.parseIndexedFunction("ff");
+
+	ASSERT_TRUE(func != nullptr);
+	EXPECT_TRUE(context->hasFunctionWithName("ff"));
+	EXPECT_EQ(func, parser.parseIndexedFunction("ff"));
+	EXPECT_EQ("int", func->getReturnType()->getName());
+	ASSERT_EQ(1, func->getParameterCount());
+	EXPECT_EQ("int", func->getParameterType(1)->getName());
+	EXPECT_EQ(nullptr, parser.parseIndexedFunction("hh"));
+	EXPECT_FALSE(context->hasFunctionWithName("gg"));
+}
+
+TEST_F(JSONCTypesParserTests,
+IndexedFunctionTypesAreParsedFromIndex)
+{
+	std::stringstream json(R"(
+		{
+			"functions": {
+				"ff": {
+					"decl": "void ff(struct s *p);",
+					"header": "CHeader.h",
+					"name": "ff",
+					"params": [
+						{
+							"name": "p",
+							"type": "ptr"
+						}
+					],
+					"ret_type": "void"
+				}
+			},
+			"types": {
+				"ptr": {
+					"pointed_type": "struct",
+					"type": "pointer"
+				},
+				"struct": {
+					"members": [
+						{
+							"name": "next",
+							"type": "ptr"
+						}
+					],
+					"name": "s",
+					"type": "structure"
+				},
+				"void": {
+					"type": "void"
+				}
+			}
+		}
+	)");
+	auto context = std::make_shared<retdec::ctypes::Context>();
+	parser.loadIndex(json, context);
+
+	auto func = parser.parseIndexedFunction("ff");
+
+	ASSERT_TRUE(func != nullptr);
+	EXPECT_TRUE(func->getReturnType()->isVoid());
+	auto ptr = std::static_pointer_cast<retdec::ctypes::PointerType>(
+		func->getParameterType(1));
+	ASSERT_TRUE(ptr->isPointer());
+	auto str = std::static_pointer_cast<retdec::ctypes::StructType>(
+		ptr->getPointedType());
+	ASSERT_TRUE(str->isStruct());
+	EXPECT_EQ("s", str->getName());
+	ASSERT_EQ(1, str->getMemberCount());
+	EXPECT_EQ(ptr, str->getMemberType(1));
+}
+
+TEST_F(JSONCTypesParserTests,
+LoadingIndexOfInvalidJsonThrows)
+{
+	std::stringstream json(R"(
+		{
+			"functions": {}
+		}
+	)");
+
+	ASSERT_THROW(
+		parser.loadIndex(json, std::make_shared<retdec::ctypes::Context>()),
+		CTypesParseError
+	);
+}
+
 } // namespace tests
 } // namespace ctypesparser
 } // namespace retdec
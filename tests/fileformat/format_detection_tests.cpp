@@ -119,6 +119,77 @@ TEST_F(FileFormatDetectionTests, DetectRaw_data)
 					true));
 }
 
+TEST_F(FileFormatDetectionTests, SummaryOfPe)
+{
+	auto summary = detectFileFormatSummary(peBytes.data(), peBytes.size());
+
+	EXPECT_EQ(Format::PE, summary.format);
+	EXPECT_EQ(Architecture::X86, summary.architecture);
+	EXPECT_EQ(retdec::utils::Endianness::LITTLE, summary.endianness);
+	EXPECT_EQ(32, summary.bitness);
+	EXPECT_TRUE(summary.hasEntryPoint);
+	EXPECT_EQ(0x401000, summary.entryPoint);
+	EXPECT_FALSE(summary.hasOverlay);
+}
+
+TEST_F(FileFormatDetectionTests, SummaryOfPeWithOverlay)
+{
+	auto bytes = peBytes;
+	bytes.resize(bytes.size() + 0x10, 0xcc);
+	std::stringstream stream;
+	stream << std::string(bytes.begin(), bytes.end());
+
+	auto summary = detectFileFormatSummary(stream);
+
+	EXPECT_EQ(Format::PE, summary.format);
+	EXPECT_TRUE(summary.hasOverlay);
+	EXPECT_EQ(peBytes.size(), summary.overlayOffset);
+}
+
+TEST_F(FileFormatDetectionTests, SummaryOfElf)
+{
+	auto summary = detectFileFormatSummary(elfBytes.data(), elfBytes.size());
+
+	EXPECT_EQ(Format::ELF, summary.format);
+	EXPECT_EQ(Architecture::X86, summary.architecture);
+	EXPECT_EQ(retdec::utils::Endianness::LITTLE, summary.endianness);
+	EXPECT_EQ(32, summary.bitness);
+	EXPECT_TRUE(summary.hasEntryPoint);
+	EXPECT_EQ(0x8048080, summary.entryPoint);
+}
+
+TEST_F(FileFormatDetectionTests, SummaryOfMacho)
+{
+	auto summary = detectFileFormatSummary(machoBytes.data(), machoBytes.size());
+
+	EXPECT_EQ(Format::MACHO, summary.format);
+	EXPECT_EQ(Architecture::X86_64, summary.architecture);
+	EXPECT_EQ(retdec::utils::Endianness::LITTLE, summary.endianness);
+	EXPECT_EQ(64, summary.bitness);
+	EXPECT_FALSE(summary.hasEntryPoint);
+}
+
+TEST_F(FileFormatDetectionTests, SummaryOfCoff)
+{
+	auto summary = detectFileFormatSummary(coffBytes.data(), coffBytes.size());
+
+	EXPECT_EQ(Format::COFF, summary.format);
+	EXPECT_EQ(Architecture::X86, summary.architecture);
+	EXPECT_EQ(32, summary.bitness);
+}
+
+TEST_F(FileFormatDetectionTests, SummaryOfRaw)
+{
+	auto summary = detectFileFormatSummary(
+			reinterpret_cast<const uint8_t*>(rawBytes.data()),
+			rawBytes.size(),
+			true);
+
+	EXPECT_EQ(Format::RAW_DATA, summary.format);
+	EXPECT_EQ(Architecture::UNKNOWN, summary.architecture);
+	EXPECT_FALSE(summary.hasEntryPoint);
+}
+
 } // namespace tests
 } // namespace fileformat
 } // namespace retdec
@@ -98,6 +98,14 @@ TEST_F(IntelHexTokenTests, InvalidChecksum)
 	token.checksum[1] = 'C'; // Original value
 }
 
+TEST_F(IntelHexTokenTests, ChecksumValidWithLowercaseDigits)
+{
+	token.data = "ffFf";
+	token.checksum = "fc";
+	token.controlChecksum();
+	EXPECT_EQ(true, token.checksumValid);
+}
+
 } // namespace tests
 } // namespace fileformat
 } // namespace retdec
@@ -0,0 +1,81 @@
+/**
+* @file tests/fileformat/streamed_data_tests.cpp
+* @brief Tests for hashes and entropy of data read in chunks from streams.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "retdec/fileformat/utils/crypto.h"
+#include "retdec/fileformat/utils/other.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace fileformat {
+namespace tests {
+
+class StreamedDataTests : public Test
+{
+	protected:
+		StreamedDataTests()
+		{
+			// Longer than the chunks in which the streams are read, and not
+			// their multiple.
+			for (std::size_t i = 0; i < 3 * 1024 * 1024 + 123; ++i)
+			{
+				data.push_back(static_cast<char>((i * 7 + i / 1000) % 251));
+			}
+			stream.str(data);
+		}
+
+		const unsigned char* dataPtr() const
+		{
+			return reinterpret_cast<const unsigned char*>(data.data());
+		}
+
+	protected:
+		std::string data;
+		std::istringstream stream;
+};
+
+TEST_F(StreamedDataTests, HashesOfStreamAreSameAsHashesOfData)
+{
+	std::string crc32, md5, sha256;
+	ASSERT_TRUE(getCrc32Md5Sha256(stream, crc32, md5, sha256));
+
+	EXPECT_EQ(getCrc32(dataPtr(), data.size()), crc32);
+	EXPECT_EQ(getMd5(dataPtr(), data.size()), md5);
+	EXPECT_EQ(getSha256(dataPtr(), data.size()), sha256);
+}
+
+TEST_F(StreamedDataTests, HashesOfStreamAreComputedFromItsBeginning)
+{
+	std::string crc32, md5, sha256;
+	stream.seekg(1000);
+	ASSERT_TRUE(getCrc32Md5Sha256(stream, crc32, md5, sha256));
+
+	EXPECT_EQ(getSha256(dataPtr(), data.size()), sha256);
+}
+
+TEST_F(StreamedDataTests, EntropyOfStreamPartIsSameAsEntropyOfData)
+{
+	const std::size_t offset = 1000;
+	const std::size_t size = data.size() - 2 * offset;
+	double entropy = -1;
+	ASSERT_TRUE(computeDataEntropy(stream, offset, size, entropy));
+
+	EXPECT_DOUBLE_EQ(computeDataEntropy(dataPtr() + offset, size), entropy);
+}
+
+TEST_F(StreamedDataTests, EntropyOfStreamFailsIfPartIsOutOfStream)
+{
+	double entropy = -1;
+	EXPECT_FALSE(computeDataEntropy(stream, data.size() - 10, 20, entropy));
+}
+
+} // namespace tests
+} // namespace fileformat
+} // namespace retdec
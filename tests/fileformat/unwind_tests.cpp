@@ -0,0 +1,64 @@
+/**
+* @file tests/fileformat/unwind_tests.cpp
+* @brief Tests for the @c unwind module.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/fileformat/utils/unwind.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace fileformat {
+namespace tests {
+
+/**
+ * CIE with the "zR" augmentation (PC-relative 4-byte FDE pointers) and one
+ * FDE of function <0x1000, 0x1030), for .eh_frame at 0x2000.
+ */
+const std::vector<std::uint8_t> ehFrameBytes = {
+	// CIE
+	0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 'z', 'R', 0x00,
+	0x01, 0x78, 0x10, 0x01, 0x1b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	// FDE
+	0x14, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 0xe0, 0xef, 0xff, 0xff,
+	0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	// Terminator
+	0x00, 0x00, 0x00, 0x00
+};
+
+class UnwindTests : public Test
+{
+
+};
+
+TEST_F(UnwindTests, FunctionRangesAreParsedFromEhFrame)
+{
+	auto ranges = parseEhFrame(ehFrameBytes.data(), ehFrameBytes.size(), 0x2000, true, 8);
+
+	ASSERT_EQ(1, ranges.size());
+	EXPECT_EQ(0x1000, ranges[0].getStart());
+	EXPECT_EQ(0x1030, ranges[0].getEnd());
+}
+
+TEST_F(UnwindTests, TruncatedEhFrameGivesNoFunctionRanges)
+{
+	auto ranges = parseEhFrame(ehFrameBytes.data(), 30, 0x2000, true, 8);
+
+	EXPECT_TRUE(ranges.empty());
+}
+
+TEST_F(UnwindTests, FdeWithoutCieIsSkipped)
+{
+	std::vector<std::uint8_t> bytes(ehFrameBytes.begin() + 24, ehFrameBytes.end());
+
+	auto ranges = parseEhFrame(bytes.data(), bytes.size(), 0x2018, true, 8);
+
+	EXPECT_TRUE(ranges.empty());
+}
+
+} // namespace tests
+} // namespace fileformat
+} // namespace retdec
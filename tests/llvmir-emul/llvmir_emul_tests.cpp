@@ -329,6 +329,83 @@ TEST_F(LlvmIrEmulatorTests, setMemoryValue)
 	EXPECT_EQ(200, emu.getMemoryValue(2000).IntVal.getZExtValue());
 }
 
+//
+// saveSnapshot()
+// restoreSnapshot()
+//
+
+TEST_F(LlvmIrEmulatorTests, restoreSnapshotRestoresGlobalsMemoryAndVisits)
+{
+	parseInput(R"(
+		@eax = global i32 10
+		define i32 @f() {
+			%a = load i32, i32* @eax
+			%b = add i32 %a, 1
+			store i32 %b, i32* @eax
+			%mem = inttoptr i32 1000 to i32*
+			store i32 %b, i32* %mem
+			ret i32 %b
+		}
+	)");
+	auto* f = getFunctionByName("f");
+	auto* eax = getGlobalByName("eax");
+
+	LlvmIrEmulator emu(module.get());
+	auto snapshot = emu.saveSnapshot();
+	emu.runFunction(f);
+	emu.runFunction(f);
+	EXPECT_EQ(12, emu.getGlobalVariableValue(eax).IntVal.getZExtValue());
+
+	emu.restoreSnapshot(snapshot);
+
+	EXPECT_EQ(10, emu.getGlobalVariableValue(eax).IntVal.getZExtValue());
+	EXPECT_FALSE(emu.wasGlobalVariableStored(eax));
+	EXPECT_FALSE(emu.wasMemoryStored(1000));
+	EXPECT_TRUE(emu.getVisitedInstructions().empty());
+	EXPECT_EQ(11, emu.runFunction(f).IntVal.getZExtValue());
+}
+
+//
+// runFunctionBatch()
+//
+
+TEST_F(LlvmIrEmulatorTests, runFunctionBatchRunsEveryArgumentsFromTheSameState)
+{
+	parseInput(R"(
+		@eax = global i32 10
+		define i32 @f(i32 %arg) {
+			%a = load i32, i32* @eax
+			%b = add i32 %a, %arg
+			store i32 %b, i32* @eax
+			ret i32 %b
+		}
+	)");
+	auto* f = getFunctionByName("f");
+	auto* eax = getGlobalByName("eax");
+	std::vector<std::vector<GenericValue>> args(3);
+	for (unsigned i = 0; i < args.size(); ++i)
+	{
+		GenericValue val;
+		val.IntVal = APInt(32, i);
+		args[i].push_back(val);
+	}
+	std::vector<uint64_t> eaxAfterRun;
+
+	LlvmIrEmulator emu(module.get());
+	auto res = emu.runFunctionBatch(f, args, [&](std::size_t)
+	{
+		eaxAfterRun.push_back(emu.getGlobalVariableValue(eax).IntVal.getZExtValue());
+	});
+
+	ASSERT_EQ(3, res.size());
+	EXPECT_EQ(10, res[0].IntVal.getZExtValue());
+	EXPECT_EQ(11, res[1].IntVal.getZExtValue());
+	EXPECT_EQ(12, res[2].IntVal.getZExtValue());
+	std::vector<uint64_t> exEaxAfterRun = {10, 11, 12};
+	EXPECT_EQ(exEaxAfterRun, eaxAfterRun);
+	EXPECT_EQ(10, emu.getGlobalVariableValue(eax).IntVal.getZExtValue());
+}
+
 //
 // x86_fp80 test
 //
@@ -0,0 +1,339 @@
+/**
+* @file tests/llvmir2hll/analysis/alias_analysis/alias_analyses/steensgaard_alias_analysis_tests.cpp
+* @brief Tests for the @c steensgaard_alias_analysis module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/analysis/alias_analysis/alias_analyses/steensgaard_alias_analysis.h"
+#include "retdec/llvmir2hll/ir/address_op_expr.h"
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/call_expr.h"
+#include "retdec/llvmir2hll/ir/call_stmt.h"
+#include "retdec/llvmir2hll/ir/deref_op_expr.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "retdec/llvmir2hll/ir/pointer_type.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/ir/var_def_stmt.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/support/types.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c steensgaard_alias_analysis module.
+*/
+class SteensgaardAliasAnalysisTests: public TestsWithModule {
+protected:
+	virtual void SetUp() override {
+		TestsWithModule::SetUp();
+		analysis = SteensgaardAliasAnalysis::create();
+	}
+
+protected:
+	ShPtr<AliasAnalysis> analysis;
+};
+
+TEST_F(SteensgaardAliasAnalysisTests,
+AnalysisHasNonEmptyID) {
+	EXPECT_TRUE(!analysis->getId().empty()) <<
+		"the analysis should have a non-empty ID";
+}
+
+TEST_F(SteensgaardAliasAnalysisTests,
+AfterCallingInitItIsInitialized) {
+	analysis->init(module);
+
+	EXPECT_TRUE(analysis->isInitialized()) <<
+		"the analysis should be initialized by now";
+}
+
+TEST_F(SteensgaardAliasAnalysisTests,
+LocalNonPointerVariableDoesNotPointToAnything) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     int a;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(16)));
+	testFunc->addLocalVar(varA);
+	ShPtr<VarDefStmt> varDefA(VarDefStmt::create(varA));
+	testFunc->setBody(varDefA);
+
+	analysis->init(module);
+
+	// `a` does not point to anything.
+	VarSet refAMayPointTo;
+	EXPECT_EQ(refAMayPointTo, analysis->mayPointTo(varA));
+	EXPECT_EQ(ShPtr<Variable>(), analysis->pointsTo(varA));
+}
+
+TEST_F(SteensgaardAliasAnalysisTests,
+GlobalPointerVariableMayPointToAnythingWithAddressTaken) {
+	// Set-up the module.
+	//
+	// int *g;
+	//
+	// void test() {
+	//     int a;
+	//     int b;
+	//     g = &a;
+	// }
+	//
+	ShPtr<Variable> varG(Variable::create("g", PointerType::create(IntType::create(16))));
+	module->addGlobalVar(varG);
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(16)));
+	testFunc->addLocalVar(varA);
+	ShPtr<Variable> varB(Variable::create("b", IntType::create(16)));
+	testFunc->addLocalVar(varB);
+	ShPtr<AssignStmt> assignGA(AssignStmt::create(varG, AddressOpExpr::create(varA)));
+	ShPtr<VarDefStmt> varDefB(VarDefStmt::create(varB, ShPtr<Expression>(), assignGA));
+	ShPtr<VarDefStmt> varDefA(VarDefStmt::create(varA, ShPtr<Expression>(), varDefB));
+	testFunc->setBody(varDefA);
+
+	analysis->init(module);
+
+	// `g` may point to `a`.
+	VarSet refGMayPointTo;
+	refGMayPointTo.insert(varA);
+	EXPECT_EQ(refGMayPointTo, analysis->mayPointTo(varG));
+	EXPECT_EQ(ShPtr<Variable>(), analysis->pointsTo(varG));
+}
+
+TEST_F(SteensgaardAliasAnalysisTests,
+LocalPointersInDifferentClassesDoNotAlias) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     int a;
+	//     int b;
+	//     int *p = &a;
+	//     int *q = &b;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(16)));
+	testFunc->addLocalVar(varA);
+	ShPtr<Variable> varB(Variable::create("b", IntType::create(16)));
+	testFunc->addLocalVar(varB);
+	ShPtr<Variable> varP(Variable::create("p", PointerType::create(IntType::create(16))));
+	testFunc->addLocalVar(varP);
+	ShPtr<Variable> varQ(Variable::create("q", PointerType::create(IntType::create(16))));
+	testFunc->addLocalVar(varQ);
+	ShPtr<VarDefStmt> varDefQ(VarDefStmt::create(varQ, AddressOpExpr::create(varB)));
+	ShPtr<VarDefStmt> varDefP(VarDefStmt::create(varP, AddressOpExpr::create(varA), varDefQ));
+	ShPtr<VarDefStmt> varDefB(VarDefStmt::create(varB, ShPtr<Expression>(), varDefP));
+	ShPtr<VarDefStmt> varDefA(VarDefStmt::create(varA, ShPtr<Expression>(), varDefB));
+	testFunc->setBody(varDefA);
+
+	analysis->init(module);
+
+	// `p` may point only to `a` and `q` only to `b`.
+	VarSet refPMayPointTo;
+	refPMayPointTo.insert(varA);
+	EXPECT_EQ(refPMayPointTo, analysis->mayPointTo(varP));
+	VarSet refQMayPointTo;
+	refQMayPointTo.insert(varB);
+	EXPECT_EQ(refQMayPointTo, analysis->mayPointTo(varQ));
+}
+
+TEST_F(SteensgaardAliasAnalysisTests,
+AssignmentOfPointersMergesTheirClasses) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     int a;
+	//     int b;
+	//     int *p = &a;
+	//     int *q = &b;
+	//     p = q;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(16)));
+	testFunc->addLocalVar(varA);
+	ShPtr<Variable> varB(Variable::create("b", IntType::create(16)));
+	testFunc->addLocalVar(varB);
+	ShPtr<Variable> varP(Variable::create("p", PointerType::create(IntType::create(16))));
+	testFunc->addLocalVar(varP);
+	ShPtr<Variable> varQ(Variable::create("q", PointerType::create(IntType::create(16))));
+	testFunc->addLocalVar(varQ);
+	ShPtr<AssignStmt> assignPQ(AssignStmt::create(varP, varQ));
+	ShPtr<VarDefStmt> varDefQ(VarDefStmt::create(varQ, AddressOpExpr::create(varB), assignPQ));
+	ShPtr<VarDefStmt> varDefP(VarDefStmt::create(varP, AddressOpExpr::create(varA), varDefQ));
+	ShPtr<VarDefStmt> varDefB(VarDefStmt::create(varB, ShPtr<Expression>(), varDefP));
+	ShPtr<VarDefStmt> varDefA(VarDefStmt::create(varA, ShPtr<Expression>(), varDefB));
+	testFunc->setBody(varDefA);
+
+	analysis->init(module);
+
+	// Both `p` and `q` may point to `a` and `b`.
+	VarSet refMayPointTo;
+	refMayPointTo.insert(varA);
+	refMayPointTo.insert(varB);
+	EXPECT_EQ(refMayPointTo, analysis->mayPointTo(varP));
+	EXPECT_EQ(refMayPointTo, analysis->mayPointTo(varQ));
+}
+
+TEST_F(SteensgaardAliasAnalysisTests,
+StoreThroughPointerIsTracked) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     int a;
+	//     int *p;
+	//     int **pp = &p;
+	//     *pp = &a;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(16)));
+	testFunc->addLocalVar(varA);
+	ShPtr<Variable> varP(Variable::create("p", PointerType::create(IntType::create(16))));
+	testFunc->addLocalVar(varP);
+	ShPtr<Variable> varPP(Variable::create("pp", PointerType::create(
+		PointerType::create(IntType::create(16)))));
+	testFunc->addLocalVar(varPP);
+	ShPtr<AssignStmt> assignDerefPPA(AssignStmt::create(
+		DerefOpExpr::create(varPP), AddressOpExpr::create(varA)));
+	ShPtr<VarDefStmt> varDefPP(VarDefStmt::create(varPP,
+		AddressOpExpr::create(varP), assignDerefPPA));
+	ShPtr<VarDefStmt> varDefP(VarDefStmt::create(varP, ShPtr<Expression>(), varDefPP));
+	ShPtr<VarDefStmt> varDefA(VarDefStmt::create(varA, ShPtr<Expression>(), varDefP));
+	testFunc->setBody(varDefA);
+
+	analysis->init(module);
+
+	// `p` may point to `a` and `pp` to `p`.
+	VarSet refPMayPointTo;
+	refPMayPointTo.insert(varA);
+	EXPECT_EQ(refPMayPointTo, analysis->mayPointTo(varP));
+	VarSet refPPMayPointTo;
+	refPPMayPointTo.insert(varP);
+	EXPECT_EQ(refPPMayPointTo, analysis->mayPointTo(varPP));
+}
+
+TEST_F(SteensgaardAliasAnalysisTests,
+ParameterMayPointToAnythingInFuncWithAddressTaken) {
+	// Set-up the module.
+	//
+	// void test(int *p) {
+	//     int a;
+	//     int *q = &a;
+	// }
+	//
+	ShPtr<Variable> varP(Variable::create("p", PointerType::create(IntType::create(16))));
+	testFunc->addParam(varP);
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(16)));
+	testFunc->addLocalVar(varA);
+	ShPtr<Variable> varQ(Variable::create("q", PointerType::create(IntType::create(16))));
+	testFunc->addLocalVar(varQ);
+	ShPtr<VarDefStmt> varDefQ(VarDefStmt::create(varQ, AddressOpExpr::create(varA)));
+	ShPtr<VarDefStmt> varDefA(VarDefStmt::create(varA, ShPtr<Expression>(), varDefQ));
+	testFunc->setBody(varDefA);
+
+	analysis->init(module);
+
+	// `p` may point to `a`.
+	VarSet refPMayPointTo;
+	refPMayPointTo.insert(varA);
+	EXPECT_EQ(refPMayPointTo, analysis->mayPointTo(varP));
+}
+
+TEST_F(SteensgaardAliasAnalysisTests,
+PointerWhoseAddressIsPassedToCallMayPointToAnythingInFuncWithAddressTaken) {
+	// Set-up the module.
+	//
+	// void foo();
+	//
+	// void test() {
+	//     int a;
+	//     int b;
+	//     int *p = &a;
+	//     int *q = &b;
+	//     foo(&p);
+	// }
+	//
+	ShPtr<Function> fooFunc(addFuncDecl("foo"));
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(16)));
+	testFunc->addLocalVar(varA);
+	ShPtr<Variable> varB(Variable::create("b", IntType::create(16)));
+	testFunc->addLocalVar(varB);
+	ShPtr<Variable> varP(Variable::create("p", PointerType::create(IntType::create(16))));
+	testFunc->addLocalVar(varP);
+	ShPtr<Variable> varQ(Variable::create("q", PointerType::create(IntType::create(16))));
+	testFunc->addLocalVar(varQ);
+	ExprVector fooArgs;
+	fooArgs.push_back(AddressOpExpr::create(varP));
+	ShPtr<CallStmt> fooCall(CallStmt::create(
+		CallExpr::create(fooFunc->getAsVar(), fooArgs)));
+	ShPtr<VarDefStmt> varDefQ(VarDefStmt::create(varQ, AddressOpExpr::create(varB), fooCall));
+	ShPtr<VarDefStmt> varDefP(VarDefStmt::create(varP, AddressOpExpr::create(varA), varDefQ));
+	ShPtr<VarDefStmt> varDefB(VarDefStmt::create(varB, ShPtr<Expression>(), varDefP));
+	ShPtr<VarDefStmt> varDefA(VarDefStmt::create(varA, ShPtr<Expression>(), varDefB));
+	testFunc->setBody(varDefA);
+
+	analysis->init(module);
+
+	// `foo()` may change `p`, so it may point to any variable in `test()` that
+	// has its address taken; `q` is unaffected.
+	VarSet refPMayPointTo;
+	refPMayPointTo.insert(varA);
+	refPMayPointTo.insert(varB);
+	refPMayPointTo.insert(varP);
+	EXPECT_EQ(refPMayPointTo, analysis->mayPointTo(varP));
+	VarSet refQMayPointTo;
+	refQMayPointTo.insert(varB);
+	EXPECT_EQ(refQMayPointTo, analysis->mayPointTo(varQ));
+}
+
+TEST_F(SteensgaardAliasAnalysisTests,
+GlobalPointerVariableMayBeInitializedToAnAddress) {
+	// Set-up the module.
+	//
+	// int g1;
+	// int *g2 = &g1;
+	//
+	// void test() {
+	// }
+	//
+	ShPtr<Variable> varG1(Variable::create("g1", IntType::create(16)));
+	module->addGlobalVar(varG1);
+	ShPtr<Variable> varG2(Variable::create("g2", PointerType::create(IntType::create(16))));
+	module->addGlobalVar(varG2, AddressOpExpr::create(varG1));
+
+	analysis->init(module);
+
+	// `g2` may point to `g1`.
+	VarSet refG2MayPointTo;
+	refG2MayPointTo.insert(varG1);
+	EXPECT_EQ(refG2MayPointTo, analysis->mayPointTo(varG2));
+	EXPECT_TRUE(analysis->mayBePointed(varG1));
+}
+
+TEST_F(SteensgaardAliasAnalysisTests,
+VariableWhoseAddressIsNotTakenMayNotBePointed) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     int a;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	testFunc->addLocalVar(varA);
+	ShPtr<VarDefStmt> varADef(VarDefStmt::create(varA));
+	testFunc->setBody(varADef);
+
+	analysis->init(module);
+
+	// `a` may not be pointed.
+	EXPECT_FALSE(analysis->mayBePointed(varA));
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
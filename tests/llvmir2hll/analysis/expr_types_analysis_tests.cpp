@@ -0,0 +1,118 @@
+/**
+* @file tests/llvmir2hll/analysis/expr_types_analysis_tests.cpp
+* @brief Tests for the @c expr_types_analysis module.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/analysis/expr_types_analysis.h"
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/bit_shr_op_expr.h"
+#include "retdec/llvmir2hll/ir/const_int.h"
+#include "retdec/llvmir2hll/ir/div_op_expr.h"
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "retdec/llvmir2hll/ir/lt_op_expr.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/support/expr_types_fixer.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c expr_types_analysis module.
+*/
+class ExprTypesAnalysisTests: public TestsWithModule {
+protected:
+	virtual void SetUp() override;
+
+protected:
+	ShPtr<Variable> varA;
+	ShPtr<Variable> varB;
+	ShPtr<Variable> varX;
+	ShPtr<Variable> varY;
+	ShPtr<Variable> varZ;
+};
+
+void ExprTypesAnalysisTests::SetUp() {
+	// Set-up the module.
+	//
+	// void test() {
+	//   x = a / b;    // signed division
+	//   y = a < b;    // signed comparison
+	//   z = a >> 1;   // logical shift
+	// }
+	//
+	varA = Variable::create("a", IntType::create(32, false));
+	varB = Variable::create("b", IntType::create(32, false));
+	varX = Variable::create("x", IntType::create(32, false));
+	varY = Variable::create("y", IntType::create(32, false));
+	varZ = Variable::create("z", IntType::create(32, false));
+	for (const auto &var : {varA, varB, varX, varY, varZ}) {
+		testFunc->addLocalVar(var);
+	}
+	ShPtr<AssignStmt> assignX(AssignStmt::create(varX,
+		DivOpExpr::create(varA, varB, DivOpExpr::Variant::SDiv)));
+	ShPtr<AssignStmt> assignY(AssignStmt::create(varY,
+		LtOpExpr::create(varA, varB, LtOpExpr::Variant::SCmp)));
+	ShPtr<AssignStmt> assignZ(AssignStmt::create(varZ,
+		BitShrOpExpr::create(varA, ConstInt::create(1, 32),
+			BitShrOpExpr::Variant::Logical)));
+	assignX->setSuccessor(assignY);
+	assignY->setSuccessor(assignZ);
+	testFunc->setBody(assignX);
+}
+
+TEST_F(ExprTypesAnalysisTests,
+TagsOfExpressionsAreCounted) {
+	ShPtr<ExprTypesAnalysis> analysis(ExprTypesAnalysis::create());
+	analysis->analyzeExprTypes(module);
+
+	EXPECT_EQ(2, analysis->getCountOfTag(varA,
+		ExprTypesAnalysis::ExprTag::Signed));
+	EXPECT_EQ(1, analysis->getCountOfTag(varA,
+		ExprTypesAnalysis::ExprTag::Unsigned));
+	EXPECT_EQ(2, analysis->getCountOfTag(varB,
+		ExprTypesAnalysis::ExprTag::Signed));
+	EXPECT_EQ(0, analysis->getCountOfTag(varB,
+		ExprTypesAnalysis::ExprTag::Unsigned));
+	EXPECT_EQ(1, analysis->getCountOfTag(varX,
+		ExprTypesAnalysis::ExprTag::Signed));
+}
+
+TEST_F(ExprTypesAnalysisTests,
+CountOfTagOfUntaggedExpressionIsZeroAndItIsNotAddedToMap) {
+	ShPtr<ExprTypesAnalysis> analysis(ExprTypesAnalysis::create());
+	const ExprTypesAnalysis::ExprTagsMap &tags(
+		analysis->analyzeExprTypes(module));
+	std::size_t size = tags.size();
+
+	EXPECT_EQ(0, analysis->getCountOfTag(varZ,
+		ExprTypesAnalysis::ExprTag::Signed));
+	EXPECT_EQ(0, analysis->getCountOfTag(varZ,
+		ExprTypesAnalysis::ExprTag::Unsigned));
+	EXPECT_EQ(size, tags.size());
+}
+
+TEST_F(ExprTypesAnalysisTests,
+FixerMakesVariablesUsedMostlyAsSignedSigned) {
+	ExprTypesFixer::fixTypes(module);
+
+	ShPtr<IntType> aType(cast<IntType>(varA->getType()));
+	ASSERT_TRUE(aType);
+	EXPECT_TRUE(aType->isSigned());
+	ShPtr<IntType> bType(cast<IntType>(varB->getType()));
+	ASSERT_TRUE(bType);
+	EXPECT_TRUE(bType->isSigned());
+	ShPtr<IntType> zType(cast<IntType>(varZ->getType()));
+	ASSERT_TRUE(zType);
+	EXPECT_TRUE(zType->isUnsigned());
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -37,6 +37,8 @@ public:
 	MOCK_CONST_METHOD1(isInstructionIdiomFunc, bool (const std::string &));
 	MOCK_CONST_METHOD1(isExportedFunc, bool (const std::string &));
 	MOCK_METHOD1(markFuncAsStaticallyLinked, void (const std::string &));
+	MOCK_CONST_METHOD1(getDegradationsOfFunc, StringSet (const std::string &));
+	MOCK_METHOD2(markFuncAsDegraded, void (const std::string &, const std::string &));
 	MOCK_CONST_METHOD1(getRealNameForFunc, std::string (const std::string &func));
 	MOCK_CONST_METHOD1(getDeclarationStringForFunc, std::string (const std::string &));
 	MOCK_CONST_METHOD1(getCommentForFunc, std::string (const std::string &));
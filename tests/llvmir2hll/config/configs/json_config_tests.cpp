@@ -697,6 +697,52 @@ MarkFuncAsStaticallyLinkedSetsFuncAsStaticallyLinked) {
 	ASSERT_TRUE(config->isStaticallyLinkedFunc("my_func"));
 }
 
+//
+// getDegradationsOfFunc(), markFuncAsDegraded()
+//
+
+TEST_F(JSONConfigTests,
+GetDegradationsOfFuncReturnsEmptySetWhenThereIsNoSuchFunc) {
+	auto config = JSONConfig::empty();
+
+	config->markFuncAsDegraded("my_func", "structuredByGotos");
+
+	ASSERT_EQ(StringSet(), config->getDegradationsOfFunc("my_func"));
+}
+
+TEST_F(JSONConfigTests,
+GetDegradationsOfFuncReturnsCorrectValueWhenThereAreDegradations) {
+	auto config = JSONConfig::fromString(R"({
+		"functions": [
+			{
+				"name": "my_func",
+				"degradations": ["structuredByGotos"]
+			}
+		]
+	})");
+
+	ASSERT_EQ(StringSet({"structuredByGotos"}), config->getDegradationsOfFunc("my_func"));
+}
+
+TEST_F(JSONConfigTests,
+MarkFuncAsDegradedAddsDegradationToFunc) {
+	auto config = JSONConfig::fromString(R"({
+		"functions": [
+			{
+				"name": "my_func"
+			}
+		]
+	})");
+
+	config->markFuncAsDegraded("my_func", "structuredByGotos");
+	config->markFuncAsDegraded("my_func", "skippedCopyPropagationOptimizer");
+
+	ASSERT_EQ(
+		StringSet({"skippedCopyPropagationOptimizer", "structuredByGotos"}),
+		config->getDegradationsOfFunc("my_func")
+	);
+}
+
 //
 // getDeclarationStringForFunc()
 //
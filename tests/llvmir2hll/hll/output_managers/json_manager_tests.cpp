@@ -227,6 +227,33 @@ TEST_F(JsonOutputManagerTests, commentModifier_creates_comment_until_end_of_line
 		emitSingleToken());
 }
 
+//
+// flush()
+//
+
+TEST_F(JsonOutputManagerTests, flush_writes_tokens_generated_so_far)
+{
+	manager->functionId("f");
+	manager->flush();
+
+	EXPECT_EQ(
+		R"({"tokens":[{"addr":""},{"kind":"i_fnc","val":"f"})",
+		codeStream.str());
+}
+
+TEST_F(JsonOutputManagerTests, flush_does_not_change_emitted_code)
+{
+	manager->functionId("f");
+	manager->flush();
+	manager->newLine();
+	manager->flush();
+	manager->localVariableId("a");
+
+	EXPECT_EQ(
+		R"({"kind":"i_fnc","val":"f"},{"kind":"nl","val":"\n"},{"kind":"i_lvar","val":"a"})",
+		emitSingleToken());
+}
+
 //
 // addressPush()
 // addressPop()
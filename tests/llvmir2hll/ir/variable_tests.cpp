@@ -8,6 +8,7 @@
 
 #include "retdec/llvmir2hll/ir/int_type.h"
 #include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/support/types.h"
 
 using namespace ::testing;
 
@@ -142,6 +143,21 @@ HasNameReturnsFalseIfVariableHasEmptyName) {
 	ASSERT_FALSE(var->hasName());
 }
 
+//
+// VarSet
+//
+
+TEST_F(VariableTests,
+VarSetIteratesVariablesInTheOrderOfTheirCreation) {
+	auto a = Variable::create("a", IntType::create(32));
+	auto b = Variable::create("b", IntType::create(32));
+	auto c = Variable::create("c", IntType::create(32));
+
+	VarSet vars{c, a, b};
+
+	EXPECT_EQ((VarVector{a, b, c}), VarVector(vars.begin(), vars.end()));
+}
+
 } // namespace tests
 } // namespace llvmir2hll
 } // namespace retdec
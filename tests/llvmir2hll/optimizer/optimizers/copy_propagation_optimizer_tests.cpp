@@ -1102,6 +1102,61 @@ DoNotOptimizeWhenAuxiliaryVariableIsExternal) {
 		"expected `" << returnB << "`, got `" << stmt2 << "`";
 }
 
+TEST_F(CopyPropagationOptimizerTests,
+FunctionWithMoreStatementsThanLimitIsOptimizedBySimpleCopyPropagation) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;
+	//     return;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	testFunc->addLocalVar(varA);
+	ShPtr<ReturnStmt> returnStmt(ReturnStmt::create());
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32),
+		returnStmt));
+	testFunc->setBody(assignA1);
+
+	INSTANTIATE_ALIAS_ANALYSIS_AND_VALUE_ANALYSIS(module);
+
+	// Optimize the module.
+	Optimizer::optimize<CopyPropagationOptimizer>(module, va,
+		OptimCallInfoObtainer::create(), 1);
+
+	// Check that the output is correct (the simple copy propagation does not
+	// remove unused assignments).
+	EXPECT_EQ(assignA1, testFunc->getBody()) <<
+		"expected `" << assignA1 << "`, got `" << testFunc->getBody() << "`";
+}
+
+TEST_F(CopyPropagationOptimizerTests,
+FunctionWithStatementsWithinLimitIsOptimizedFully) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;
+	//     return;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	testFunc->addLocalVar(varA);
+	ShPtr<ReturnStmt> returnStmt(ReturnStmt::create());
+	ShPtr<AssignStmt> assignA1(AssignStmt::create(varA, ConstInt::create(1, 32),
+		returnStmt));
+	testFunc->setBody(assignA1);
+
+	INSTANTIATE_ALIAS_ANALYSIS_AND_VALUE_ANALYSIS(module);
+
+	// Optimize the module.
+	Optimizer::optimize<CopyPropagationOptimizer>(module, va,
+		OptimCallInfoObtainer::create(), 2);
+
+	// Check that the output is correct.
+	EXPECT_EQ(returnStmt, testFunc->getBody()) <<
+		"expected `" << returnStmt << "`, got `" << testFunc->getBody() << "`";
+}
+
 } // namespace tests
 } // namespace llvmir2hll
 } // namespace retdec
@@ -0,0 +1,333 @@
+/**
+* @file tests/llvmir2hll/support/bir_snapshot_tests.cpp
+* @brief Tests for the @c bir_snapshot module.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/ir/add_op_expr.h"
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/call_expr.h"
+#include "retdec/llvmir2hll/ir/call_stmt.h"
+#include "retdec/llvmir2hll/ir/const_float.h"
+#include "retdec/llvmir2hll/ir/const_int.h"
+#include "retdec/llvmir2hll/ir/const_string.h"
+#include "retdec/llvmir2hll/ir/empty_stmt.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/function_builder.h"
+#include "retdec/llvmir2hll/ir/goto_stmt.h"
+#include "retdec/llvmir2hll/ir/if_stmt.h"
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "retdec/llvmir2hll/ir/lt_op_expr.h"
+#include "retdec/llvmir2hll/ir/pointer_type.h"
+#include "retdec/llvmir2hll/ir/return_stmt.h"
+#include "retdec/llvmir2hll/ir/var_def_stmt.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/ir/while_loop_stmt.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/support/bir_snapshot.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c bir_snapshot module.
+*/
+class BIRSnapshotTests: public TestsWithModule {
+protected:
+	std::string save(ShPtr<Module> m);
+	ShPtr<Module> load(const std::string &snapshot);
+};
+
+std::string BIRSnapshotTests::save(ShPtr<Module> m) {
+	std::ostringstream out;
+	EXPECT_TRUE(BIRSnapshot::save(m, out));
+	return out.str();
+}
+
+ShPtr<Module> BIRSnapshotTests::load(const std::string &snapshot) {
+	std::istringstream in(snapshot);
+	return BIRSnapshot::load(in, &llvmModule, semanticsMock, configMock);
+}
+
+TEST_F(BIRSnapshotTests,
+LoadedModuleIsSavedIntoTheSameSnapshot) {
+	// Set-up the module.
+	//
+	// int g = 1;
+	// const char *s = "str";
+	//
+	// int f(int p) {
+	//     int a = p;
+	//   lab:
+	//     while (a < 10) {
+	//         if (a < 5) {
+	//             a = a + 1;
+	//         } else {
+	//             goto lab;
+	//         }
+	//     }
+	//     test();
+	//     return a;
+	// }
+	//
+	// void test() {}
+	//
+	ShPtr<Variable> varG(Variable::create("g", IntType::create(32)));
+	module->addGlobalVar(varG, ConstInt::create(1, 32));
+	ShPtr<Variable> varS(Variable::create("s",
+		PointerType::create(IntType::create(8))));
+	module->addGlobalVar(varS, ConstString::create("str"));
+	module->addGlobalVar(Variable::create("d", IntType::create(64)),
+		ConstFloat::create(llvm::APFloat(1.5)));
+	ShPtr<Variable> varP(Variable::create("p", IntType::create(32)));
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	module->addDebugNameForVar(varA, "counter");
+	ShPtr<ReturnStmt> returnA(ReturnStmt::create(varA));
+	ShPtr<CallStmt> callTest(CallStmt::create(
+		CallExpr::create(testFunc->getAsVar())));
+	callTest->setSuccessor(returnA);
+	ShPtr<AssignStmt> incA(AssignStmt::create(varA,
+		AddOpExpr::create(varA, ConstInt::create(1, 32))));
+	ShPtr<WhileLoopStmt> loop(WhileLoopStmt::create(
+		LtOpExpr::create(varA, ConstInt::create(10, 32),
+			LtOpExpr::Variant::SCmp),
+		EmptyStmt::create(), callTest));
+	loop->setLabel("lab");
+	ShPtr<IfStmt> ifStmt(IfStmt::create(
+		LtOpExpr::create(varA, ConstInt::create(5, 32)), incA));
+	ifStmt->setElseClause(GotoStmt::create(loop));
+	loop->setBody(ifStmt);
+	ShPtr<VarDefStmt> defA(VarDefStmt::create(varA, varP, loop));
+	defA->setMetadata("0x1000");
+	ShPtr<Function> funcF(FunctionBuilder("f")
+		.definitionWithBody(defA)
+		.withRetType(IntType::create(32))
+		.withParam(varP)
+		.withLocalVar(varA)
+		.build());
+	module->addFunc(funcF);
+
+	std::string snapshot(save(module));
+	ShPtr<Module> loaded(load(snapshot));
+
+	ASSERT_TRUE(loaded);
+	EXPECT_EQ(snapshot, save(loaded));
+}
+
+TEST_F(BIRSnapshotTests,
+LoadedVariablesAndStatementsKeepTheirIdentity) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     int a;
+	//   lab:
+	//     a = a;
+	//     goto lab;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	testFunc->addLocalVar(varA);
+	ShPtr<AssignStmt> assignA(AssignStmt::create(varA, varA));
+	assignA->setLabel("lab");
+	assignA->setSuccessor(GotoStmt::create(assignA));
+	ShPtr<VarDefStmt> defA(VarDefStmt::create(varA, nullptr, assignA));
+	testFunc->setBody(defA);
+
+	ShPtr<Module> loaded(load(save(module)));
+
+	ASSERT_TRUE(loaded);
+	ShPtr<Function> func(loaded->getFuncByName("test"));
+	ASSERT_TRUE(func);
+	ShPtr<VarDefStmt> loadedDefA(cast<VarDefStmt>(func->getBody()));
+	ASSERT_TRUE(loadedDefA);
+	ShPtr<AssignStmt> loadedAssignA(cast<AssignStmt>(loadedDefA->getSuccessor()));
+	ASSERT_TRUE(loadedAssignA);
+	ShPtr<GotoStmt> loadedGoto(cast<GotoStmt>(loadedAssignA->getSuccessor()));
+	ASSERT_TRUE(loadedGoto);
+	EXPECT_EQ(loadedDefA->getVar(), loadedAssignA->getLhs());
+	EXPECT_EQ(loadedDefA->getVar(), loadedAssignA->getRhs());
+	EXPECT_EQ(VarSet({loadedDefA->getVar()}), func->getLocalVars());
+	EXPECT_EQ(loadedAssignA, loadedGoto->getTarget());
+	EXPECT_EQ("lab", loadedAssignA->getLabel());
+	EXPECT_TRUE(loadedAssignA->isGotoTarget());
+}
+
+TEST_F(BIRSnapshotTests,
+LoadedVariablesAreCreatedInTheOriginalOrder) {
+	ShPtr<Variable> varB(Variable::create("b", IntType::create(32)));
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	// The variables are used in the opposite order than they were created.
+	module->addGlobalVar(varA);
+	module->addGlobalVar(varB);
+
+	ShPtr<Module> loaded(load(save(module)));
+
+	ASSERT_TRUE(loaded);
+	ShPtr<Variable> loadedA(loaded->getGlobalVarByName("a"));
+	ShPtr<Variable> loadedB(loaded->getGlobalVarByName("b"));
+	ASSERT_TRUE(loadedA && loadedB);
+	EXPECT_LT(loadedB->getId(), loadedA->getId());
+}
+
+TEST_F(BIRSnapshotTests,
+MergedSnapshotsShareFunctionsAndGlobalVariables) {
+	// Set-up the modules.
+	//
+	// The first one:
+	//
+	// int g;
+	// void test() {}
+	// void f();
+	//
+	// The second one:
+	//
+	// int g;
+	// void test();
+	// void f() { g = 1; test(); }
+	//
+	module->addGlobalVar(Variable::create("g", IntType::create(32)));
+	ShPtr<Function> declF(addFuncDecl("f"));
+	ShPtr<Module> otherModule(std::make_shared<Module>(&llvmModule,
+		llvmModule.getModuleIdentifier(), semanticsMock, configMock));
+	ShPtr<Variable> otherG(Variable::create("g", IntType::create(32)));
+	otherModule->addGlobalVar(otherG);
+	ShPtr<Function> declTest(FunctionBuilder("test").build());
+	otherModule->addFunc(declTest);
+	ShPtr<CallStmt> callTest(CallStmt::create(
+		CallExpr::create(declTest->getAsVar())));
+	ShPtr<AssignStmt> assignG(AssignStmt::create(otherG,
+		ConstInt::create(1, 32), callTest));
+	otherModule->addFunc(FunctionBuilder("f")
+		.definitionWithBody(assignG)
+		.build());
+
+	std::istringstream in1(save(module));
+	std::istringstream in2(save(otherModule));
+	ShPtr<Module> merged(BIRSnapshot::loadMerged({&in1, &in2}, &llvmModule,
+		semanticsMock, configMock));
+
+	ASSERT_TRUE(merged);
+	EXPECT_EQ(2, merged->getNumOfFuncDefinitions());
+	EXPECT_EQ(1, merged->getGlobalVars().size());
+	ShPtr<Function> func(merged->getFuncByName("f"));
+	ASSERT_TRUE(func && func->isDefinition());
+	ShPtr<AssignStmt> loadedAssignG(cast<AssignStmt>(func->getBody()));
+	ASSERT_TRUE(loadedAssignG);
+	EXPECT_EQ(merged->getGlobalVarByName("g"), loadedAssignG->getLhs());
+	ShPtr<CallStmt> loadedCallTest(cast<CallStmt>(loadedAssignG->getSuccessor()));
+	ASSERT_TRUE(loadedCallTest);
+	EXPECT_EQ(merged->getFuncByName("test")->getAsVar(),
+		loadedCallTest->getCall()->getCalledExpr());
+}
+
+TEST_F(BIRSnapshotTests,
+SavedFunctionIsLoadedIntoFunctionOfAnotherModule) {
+	// Set-up the modules.
+	//
+	// The first one:
+	//
+	// void test() {}
+	//
+	// int f(int p) {          // 0x1000 - 0x1010
+	//     int a = p;          // 0x1000
+	//   lab_0x1004:
+	//     test();             // 0x1004
+	//     goto lab_0x1004;
+	// }
+	//
+	// The second one, in which test() is named other():
+	//
+	// void other();
+	// int g(int q) {}         // 0x2000 - 0x2010
+	//
+	ON_CALL(*configMock, getAddressRangeForFunc("f"))
+		.WillByDefault(Return(AddressRange(0x1000, 0x1010)));
+	ON_CALL(*configMock, getAddressRangeForFunc("g"))
+		.WillByDefault(Return(AddressRange(0x2000, 0x2010)));
+	ShPtr<Variable> varP(Variable::create("p", IntType::create(32)));
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	ShPtr<CallStmt> callTest(CallStmt::create(
+		CallExpr::create(testFunc->getAsVar()), nullptr, 0x1004));
+	callTest->setLabel("lab_0x1004");
+	callTest->setSuccessor(GotoStmt::create(callTest));
+	ShPtr<VarDefStmt> defA(VarDefStmt::create(varA, varP, callTest, 0x1000));
+	ShPtr<Function> funcF(FunctionBuilder("f")
+		.definitionWithBody(defA)
+		.withRetType(IntType::create(32))
+		.withParam(varP)
+		.withLocalVar(varA)
+		.build());
+	module->addFunc(funcF);
+	ShPtr<Module> otherModule(std::make_shared<Module>(&llvmModule,
+		llvmModule.getModuleIdentifier(), semanticsMock, configMock));
+	ShPtr<Function> declOther(FunctionBuilder("other").build());
+	otherModule->addFunc(declOther);
+	ShPtr<Function> funcG(FunctionBuilder("g")
+		.definitionWithEmptyBody()
+		.withRetType(IntType::create(32))
+		.withParam(Variable::create("q", IntType::create(32)))
+		.build());
+	otherModule->addFunc(funcG);
+
+	std::ostringstream out;
+	ASSERT_TRUE(BIRSnapshot::saveFunc(module, funcF, out));
+	std::istringstream in(out.str());
+	FuncSet loaded(BIRSnapshot::loadFuncs(otherModule,
+		{{funcG, &in, {{"test", declOther}}}}));
+
+	EXPECT_EQ(FuncSet({funcG}), loaded);
+	ASSERT_EQ(1, funcG->getNumOfParams());
+	EXPECT_EQ("p", funcG->getParams().front()->getName());
+	ShPtr<VarDefStmt> loadedDefA(cast<VarDefStmt>(funcG->getBody()));
+	ASSERT_TRUE(loadedDefA);
+	EXPECT_EQ(Address(0x2000), loadedDefA->getAddress());
+	EXPECT_EQ(funcG->getParams().front(), loadedDefA->getInitializer());
+	ShPtr<CallStmt> loadedCallTest(cast<CallStmt>(loadedDefA->getSuccessor()));
+	ASSERT_TRUE(loadedCallTest);
+	EXPECT_EQ(Address(0x2004), loadedCallTest->getAddress());
+	EXPECT_EQ("lab_0x2004", loadedCallTest->getLabel());
+	EXPECT_EQ(declOther->getAsVar(),
+		loadedCallTest->getCall()->getCalledExpr());
+}
+
+TEST_F(BIRSnapshotTests,
+FunctionIsNotLoadedWhenItRefersToUnknownFunction) {
+	ShPtr<Function> funcF(addFuncDef("f"));
+	funcF->setBody(CallStmt::create(CallExpr::create(testFunc->getAsVar())));
+	ShPtr<Module> otherModule(std::make_shared<Module>(&llvmModule,
+		llvmModule.getModuleIdentifier(), semanticsMock, configMock));
+	ShPtr<Function> funcG(FunctionBuilder("g")
+		.definitionWithEmptyBody()
+		.build());
+	otherModule->addFunc(funcG);
+	ShPtr<Statement> body(funcG->getBody());
+
+	std::ostringstream out;
+	ASSERT_TRUE(BIRSnapshot::saveFunc(module, funcF, out));
+	std::istringstream in(out.str());
+	FuncSet loaded(BIRSnapshot::loadFuncs(otherModule, {{funcG, &in, {}}}));
+
+	EXPECT_TRUE(loaded.empty());
+	EXPECT_EQ(body, funcG->getBody());
+}
+
+TEST_F(BIRSnapshotTests,
+MalformedSnapshotIsNotLoaded) {
+	std::string snapshot(save(module));
+
+	EXPECT_FALSE(load(""));
+	EXPECT_FALSE(load("garbage"));
+	EXPECT_FALSE(load(snapshot.substr(0, snapshot.size() - 1)));
+	EXPECT_FALSE(load(snapshot + "x"));
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
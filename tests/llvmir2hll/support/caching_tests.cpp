@@ -0,0 +1,117 @@
+/**
+* @file tests/llvmir2hll/support/caching_tests.cpp
+* @brief Tests for the @c caching module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/support/caching.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+namespace {
+
+/**
+* @brief Caching of squares of numbers.
+*/
+class SquareComputer: public Caching<int, int> {
+public:
+	SquareComputer(std::size_t maxCacheSize):
+		Caching(true, maxCacheSize) {}
+
+	bool isCached(int n) const {
+		int result;
+		return getCachedResult(n, result);
+	}
+
+	int compute(int n) {
+		int result;
+		if (getCachedResult(n, result)) {
+			return result;
+		}
+		result = n * n;
+		addToCache(n, result);
+		return result;
+	}
+};
+
+} // anonymous namespace
+
+/**
+* @brief Tests for the @c caching module.
+*/
+class CachingTests: public Test {};
+
+TEST_F(CachingTests,
+UnboundedCacheKeepsAllResults) {
+	SquareComputer computer(0);
+
+	for (int i = 0; i < 100; ++i) {
+		computer.compute(i);
+	}
+
+	EXPECT_EQ(100, computer.getCacheSize());
+	EXPECT_TRUE(computer.isCached(0));
+	EXPECT_TRUE(computer.isCached(99));
+}
+
+TEST_F(CachingTests,
+BoundedCacheEvictsLeastRecentlyUsedResult) {
+	SquareComputer computer(2);
+
+	computer.compute(1);
+	computer.compute(2);
+	// Use 1, so 2 becomes the least recently used result.
+	computer.isCached(1);
+	computer.compute(3);
+
+	EXPECT_EQ(2, computer.getCacheSize());
+	EXPECT_TRUE(computer.isCached(1));
+	EXPECT_FALSE(computer.isCached(2));
+	EXPECT_TRUE(computer.isCached(3));
+}
+
+TEST_F(CachingTests,
+BoundedCacheReturnsCorrectResultsAfterEviction) {
+	SquareComputer computer(1);
+
+	EXPECT_EQ(4, computer.compute(2));
+	EXPECT_EQ(9, computer.compute(3));
+	EXPECT_EQ(4, computer.compute(2));
+}
+
+TEST_F(CachingTests,
+RemovingFromBoundedCacheFreesSpaceForAnotherResult) {
+	SquareComputer computer(2);
+
+	computer.compute(1);
+	computer.compute(2);
+	computer.removeFromCache(1);
+	computer.compute(3);
+
+	EXPECT_EQ(2, computer.getCacheSize());
+	EXPECT_TRUE(computer.isCached(2));
+	EXPECT_TRUE(computer.isCached(3));
+}
+
+TEST_F(CachingTests,
+ClearCacheRemovesAllResults) {
+	SquareComputer computer(2);
+
+	computer.compute(1);
+	computer.compute(2);
+	computer.clearCache();
+	computer.compute(3);
+
+	EXPECT_EQ(1, computer.getCacheSize());
+	EXPECT_FALSE(computer.isCached(1));
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -0,0 +1,114 @@
+/**
+* @file tests/llvmir2hll/support/func_fingerprinter_tests.cpp
+* @brief Tests for the @c func_fingerprinter module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/ir/assign_stmt.h"
+#include "retdec/llvmir2hll/ir/const_int.h"
+#include "retdec/llvmir2hll/ir/empty_stmt.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/int_type.h"
+#include "retdec/llvmir2hll/ir/return_stmt.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/support/func_fingerprinter.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c func_fingerprinter module.
+*/
+class FuncFingerprinterTests: public TestsWithModule {};
+
+TEST_F(FuncFingerprinterTests,
+FingerprintOfUnchangedFunctionIsTheSame) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;
+	//     return;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	testFunc->addLocalVar(varA);
+	ShPtr<ReturnStmt> returnStmt(ReturnStmt::create());
+	ShPtr<AssignStmt> assignA(AssignStmt::create(varA,
+		ConstInt::create(1, 32), returnStmt));
+	testFunc->setBody(assignA);
+
+	EXPECT_EQ(FuncFingerprinter::fingerprint(testFunc),
+		FuncFingerprinter::fingerprint(testFunc));
+}
+
+TEST_F(FuncFingerprinterTests,
+FingerprintChangesWhenExpressionInStatementIsReplaced) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	testFunc->addLocalVar(varA);
+	ShPtr<AssignStmt> assignA(AssignStmt::create(varA,
+		ConstInt::create(1, 32)));
+	testFunc->setBody(assignA);
+	auto fingerprintBefore = FuncFingerprinter::fingerprint(testFunc);
+
+	// a = 2;
+	assignA->setRhs(ConstInt::create(2, 32));
+
+	EXPECT_NE(fingerprintBefore, FuncFingerprinter::fingerprint(testFunc));
+}
+
+TEST_F(FuncFingerprinterTests,
+FingerprintChangesWhenStatementIsRemoved) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     a = 1;
+	//     return;
+	// }
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(32)));
+	testFunc->addLocalVar(varA);
+	ShPtr<ReturnStmt> returnStmt(ReturnStmt::create());
+	ShPtr<AssignStmt> assignA(AssignStmt::create(varA,
+		ConstInt::create(1, 32), returnStmt));
+	testFunc->setBody(assignA);
+	auto fingerprintBefore = FuncFingerprinter::fingerprint(testFunc);
+
+	// void test() {
+	//     a = 1;
+	// }
+	assignA->removeSuccessor();
+
+	EXPECT_NE(fingerprintBefore, FuncFingerprinter::fingerprint(testFunc));
+}
+
+TEST_F(FuncFingerprinterTests,
+FingerprintChangesWhenStatementIsReplacedWithEqualStatement) {
+	// Set-up the module.
+	//
+	// void test() {
+	//     return;
+	// }
+	//
+	testFunc->setBody(ReturnStmt::create());
+	auto fingerprintBefore = FuncFingerprinter::fingerprint(testFunc);
+
+	testFunc->setBody(ReturnStmt::create());
+
+	EXPECT_NE(fingerprintBefore, FuncFingerprinter::fingerprint(testFunc));
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -0,0 +1,261 @@
+/**
+* @file tests/llvmir2hll/support/func_result_cache_tests.cpp
+* @brief Tests for the @c func_result_cache module.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include "retdec/llvmir2hll/ir/call_expr.h"
+#include "retdec/llvmir2hll/ir/call_stmt.h"
+#include "retdec/llvmir2hll/ir/empty_stmt.h"
+#include "retdec/llvmir2hll/ir/function.h"
+#include "retdec/llvmir2hll/ir/function_builder.h"
+#include "llvmir2hll/ir/tests_with_module.h"
+#include "retdec/llvmir2hll/ir/variable.h"
+#include "retdec/llvmir2hll/support/func_result_cache.h"
+#include "retdec/utils/filesystem.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+/**
+* @brief Tests for the @c func_result_cache module.
+*/
+class FuncResultCacheTests: public TestsWithModule {
+protected:
+	FuncResultCacheTests();
+	~FuncResultCacheTests() override;
+
+	std::unique_ptr<llvm::Module> parse(const std::string &code);
+	std::string computeKey(const std::string &code,
+		const std::string &funcName);
+
+protected:
+	/// Directory with the cache.
+	fs::path cacheDir;
+};
+
+FuncResultCacheTests::FuncResultCacheTests():
+	cacheDir(fs::temp_directory_path() / ("retdec-func-result-cache-tests-"
+		+ std::to_string(std::random_device()()))) {}
+
+FuncResultCacheTests::~FuncResultCacheTests() {
+	std::error_code ec;
+	fs::remove_all(cacheDir, ec);
+}
+
+std::unique_ptr<llvm::Module> FuncResultCacheTests::parse(
+		const std::string &code) {
+	llvm::SMDiagnostic err;
+	auto module = llvm::parseAssemblyString(code, err, llvmContext);
+	if (!module) {
+		throw std::runtime_error("invalid LLVM IR");
+	}
+	return module;
+}
+
+std::string FuncResultCacheTests::computeKey(const std::string &code,
+		const std::string &funcName) {
+	auto llvmModule = parse(code);
+	FuncResultCache cache(cacheDir.string(), "context");
+	cache.computeKeys(*llvmModule);
+	return cache.getKey(funcName);
+}
+
+TEST_F(FuncResultCacheTests,
+FunctionsDifferingOnlyInNamesAndAddressesHaveSameKey) {
+	auto llvmModule = parse(R"(
+		declare i32 @puts(i8*)
+		define i32 @f(i32 %a) {
+		dec_label_pc_1000:
+			%b = add i32 %a, 1, !insn.addr !0
+			%c = call i32 @puts(i8* null), !insn.addr !1
+			ret i32 %b, !insn.addr !1
+		}
+		define i32 @g(i32 %x) {
+		dec_label_pc_2000:
+			%y = add i32 %x, 1, !insn.addr !2
+			%z = call i32 @puts(i8* null), !insn.addr !3
+			ret i32 %y, !insn.addr !3
+		}
+		!0 = !{i64 4096}
+		!1 = !{i64 4100}
+		!2 = !{i64 8192}
+		!3 = !{i64 8196}
+	)");
+	FuncResultCache cache(cacheDir.string(), "context");
+
+	cache.computeKeys(*llvmModule);
+
+	EXPECT_FALSE(cache.getKey("f").empty());
+	EXPECT_EQ(cache.getKey("f"), cache.getKey("g"));
+}
+
+TEST_F(FuncResultCacheTests,
+FunctionsDifferingInOffsetsOfInstructionsHaveDifferentKeys) {
+	auto llvmModule = parse(R"(
+		define i32 @f(i32 %a) {
+			%b = add i32 %a, 1, !insn.addr !0
+			ret i32 %b, !insn.addr !1
+		}
+		define i32 @g(i32 %a) {
+			%b = add i32 %a, 1, !insn.addr !0
+			ret i32 %b, !insn.addr !2
+		}
+		!0 = !{i64 4096}
+		!1 = !{i64 4100}
+		!2 = !{i64 4104}
+	)");
+	FuncResultCache cache(cacheDir.string(), "context");
+
+	cache.computeKeys(*llvmModule);
+
+	EXPECT_NE(cache.getKey("f"), cache.getKey("g"));
+}
+
+TEST_F(FuncResultCacheTests,
+KeyDependsOnContext) {
+	auto llvmModule = parse(R"(
+		define void @f() {
+			ret void
+		}
+	)");
+	FuncResultCache cache1(cacheDir.string(), "context1");
+	FuncResultCache cache2(cacheDir.string(), "context2");
+
+	cache1.computeKeys(*llvmModule);
+	cache2.computeKeys(*llvmModule);
+
+	EXPECT_NE(cache1.getKey("f"), cache2.getKey("f"));
+}
+
+TEST_F(FuncResultCacheTests,
+KeyOfCallerDependsOnBodyOfDefinedCallee) {
+	std::string key1(computeKey(R"(
+		define i32 @callee(i32 %a) {
+			%b = add i32 %a, 1
+			ret i32 %b
+		}
+		define i32 @f(i32 %a) {
+			%b = call i32 @callee(i32 %a)
+			ret i32 %b
+		}
+	)", "f"));
+	std::string key2(computeKey(R"(
+		define i32 @callee(i32 %a) {
+			%b = add i32 %a, 2
+			ret i32 %b
+		}
+		define i32 @f(i32 %a) {
+			%b = call i32 @callee(i32 %a)
+			ret i32 %b
+		}
+	)", "f"));
+
+	EXPECT_FALSE(key1.empty());
+	EXPECT_FALSE(key2.empty());
+	EXPECT_NE(key1, key2);
+}
+
+TEST_F(FuncResultCacheTests,
+FunctionReferringToGlobalVariableHasNoKey) {
+	EXPECT_TRUE(computeKey(R"(
+		@g = global i32 0
+		define void @f() {
+			store i32 1, i32* @g
+			ret void
+		}
+	)", "f").empty());
+}
+
+TEST_F(FuncResultCacheTests,
+MutuallyRecursiveFunctionsHaveNoKey) {
+	std::string code(R"(
+		define void @f() {
+			call void @g()
+			ret void
+		}
+		define void @g() {
+			call void @f()
+			ret void
+		}
+		define void @h() {
+			call void @h()
+			ret void
+		}
+	)");
+
+	EXPECT_TRUE(computeKey(code, "f").empty());
+	EXPECT_TRUE(computeKey(code, "g").empty());
+	EXPECT_FALSE(computeKey(code, "h").empty());
+}
+
+TEST_F(FuncResultCacheTests,
+StoredFunctionIsRestoredIntoFunctionWithSameKeyInAnotherModule) {
+	// Set-up the modules.
+	//
+	// The first one:
+	//
+	// void test() {}
+	// void f() { test(); }
+	//
+	// The second one, in which f() is named g():
+	//
+	// void test() {}
+	// void g() {}
+	//
+	std::string code(R"(
+		define void @test() {
+			ret void
+		}
+		define void @NAME() {
+			call void @test()
+			ret void
+		}
+	)");
+	auto llvmModule1 = parse(
+		std::string(code).replace(code.find("NAME"), 4, "f"));
+	ShPtr<Function> funcF(addFuncDef("f"));
+	funcF->setBody(CallStmt::create(CallExpr::create(testFunc->getAsVar())));
+	FuncResultCache cache1(cacheDir.string(), "context");
+	cache1.computeKeys(*llvmModule1);
+
+	auto llvmModule2 = parse(
+		std::string(code).replace(code.find("NAME"), 4, "g"));
+	ShPtr<Module> otherModule(std::make_shared<Module>(&llvmModule,
+		llvmModule.getModuleIdentifier(), semanticsMock, configMock));
+	ShPtr<Function> otherTest(FunctionBuilder("test")
+		.definitionWithEmptyBody()
+		.build());
+	otherModule->addFunc(otherTest);
+	ShPtr<Function> funcG(FunctionBuilder("g")
+		.definitionWithEmptyBody()
+		.build());
+	otherModule->addFunc(funcG);
+	FuncResultCache cache2(cacheDir.string(), "context");
+	cache2.computeKeys(*llvmModule2);
+
+	EXPECT_EQ(2, cache1.store(module));
+	FuncSet restored(cache2.restore(otherModule));
+
+	EXPECT_EQ(FuncSet({otherTest, funcG}), restored);
+	ShPtr<CallStmt> callTest(cast<CallStmt>(funcG->getBody()));
+	ASSERT_TRUE(callTest);
+	EXPECT_EQ(otherTest->getAsVar(), callTest->getCall()->getCalledExpr());
+	EXPECT_EQ(0, cache2.store(otherModule));
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -4,7 +4,9 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <iomanip>
 #include <set>
+#include <sstream>
 
 #include <gtest/gtest.h>
 
@@ -208,6 +210,91 @@ SortingWorksCorrectlyEvenIfVariableIsNested) {
 		GlobalVarsSorter::sortByInterdependencies(globalVars));
 }
 
+TEST_F(GlobalVarsSorterTests,
+DependencyLoopIsBrokenByOriginalName) {
+	//
+	// int *b = &a;
+	// int *a = &b;
+	//
+
+	GlobalVarDefVector globalVars;
+
+	ShPtr<Variable> varA(Variable::create("a", PointerType::create(
+		IntType::create(32))));
+	ShPtr<Variable> varB(Variable::create("b", PointerType::create(
+		IntType::create(32))));
+	ShPtr<Expression> varBInit(AddressOpExpr::create(varA));
+	ShPtr<GlobalVarDef> varBDef(GlobalVarDef::create(varB, varBInit));
+	globalVars.push_back(varBDef);
+
+	ShPtr<Expression> varAInit(AddressOpExpr::create(varB));
+	ShPtr<GlobalVarDef> varADef(GlobalVarDef::create(varA, varAInit));
+	globalVars.push_back(varADef);
+
+	GlobalVarDefVector refSortedGlobalVars;
+	refSortedGlobalVars.push_back(varADef);
+	refSortedGlobalVars.push_back(varBDef);
+
+	EXPECT_EQ(refSortedGlobalVars,
+		GlobalVarsSorter::sortByInterdependencies(globalVars));
+}
+
+TEST_F(GlobalVarsSorterTests,
+SelfReferenceDoesNotAffectTheOrder) {
+	//
+	// int *b = &b;
+	// int *a;
+	//
+
+	GlobalVarDefVector globalVars;
+
+	ShPtr<Variable> varB(Variable::create("b", PointerType::create(
+		IntType::create(32))));
+	ShPtr<Expression> varBInit(AddressOpExpr::create(varB));
+	ShPtr<GlobalVarDef> varBDef(GlobalVarDef::create(varB, varBInit));
+	globalVars.push_back(varBDef);
+
+	ShPtr<Variable> varA(Variable::create("a", PointerType::create(
+		IntType::create(32))));
+	ShPtr<Expression> varAInit;
+	ShPtr<GlobalVarDef> varADef(GlobalVarDef::create(varA, varAInit));
+	globalVars.push_back(varADef);
+
+	GlobalVarDefVector refSortedGlobalVars;
+	refSortedGlobalVars.push_back(varADef);
+	refSortedGlobalVars.push_back(varBDef);
+
+	EXPECT_EQ(refSortedGlobalVars,
+		GlobalVarsSorter::sortByInterdependencies(globalVars));
+}
+
+TEST_F(GlobalVarsSorterTests,
+LongChainOfInterdependenciesInReverseOrderGetsCorrectlyOrdered) {
+	//
+	// int g0000 = g0001;
+	// int g0001 = g0002;
+	// ...
+	// int g1999;
+	//
+
+	const std::size_t VARS_COUNT = 2000;
+	GlobalVarDefVector refSortedGlobalVars;
+	ShPtr<Variable> lastVar;
+	for (std::size_t i = VARS_COUNT; i-- > 0;) {
+		std::ostringstream name;
+		name << "g" << std::setw(4) << std::setfill('0') << i;
+		ShPtr<Variable> var(Variable::create(name.str(), IntType::create(32)));
+		ShPtr<Expression> varInit(lastVar);
+		refSortedGlobalVars.push_back(GlobalVarDef::create(var, varInit));
+		lastVar = var;
+	}
+	GlobalVarDefVector globalVars(refSortedGlobalVars.rbegin(),
+		refSortedGlobalVars.rend());
+
+	EXPECT_EQ(refSortedGlobalVars,
+		GlobalVarsSorter::sortByInterdependencies(globalVars));
+}
+
 } // namespace tests
 } // namespace llvmir2hll
 } // namespace retdec
@@ -0,0 +1,71 @@
+/**
+* @file tests/llvmir2hll/support/metadatable_tests.cpp
+* @brief Tests for the @c metadatable module.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/support/metadatable.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+namespace {
+
+class Commented: public Metadatable<std::string> {};
+
+} // anonymous namespace
+
+/**
+* @brief Tests for the @c metadatable module.
+*/
+class MetadatableTests: public Test {};
+
+TEST_F(MetadatableTests,
+ObjectHasNoMetadataByDefault) {
+	Commented c;
+
+	EXPECT_FALSE(c.hasMetadata());
+	EXPECT_EQ("", c.getMetadata());
+}
+
+TEST_F(MetadatableTests,
+AttachedMetadataAreReturned) {
+	Commented c;
+
+	c.setMetadata("branch -> 0x1000");
+
+	EXPECT_TRUE(c.hasMetadata());
+	EXPECT_EQ("branch -> 0x1000", c.getMetadata());
+}
+
+TEST_F(MetadatableTests,
+AttachedMetadataCanBeReplaced) {
+	Commented c;
+	c.setMetadata("branch -> 0x1000");
+
+	c.setMetadata("branch -> 0x2000");
+
+	EXPECT_EQ("branch -> 0x2000", c.getMetadata());
+}
+
+TEST_F(MetadatableTests,
+AttachingEmptyMetadataRemovesMetadata) {
+	Commented c;
+	c.setMetadata("branch -> 0x1000");
+
+	c.setMetadata("");
+
+	EXPECT_FALSE(c.hasMetadata());
+	EXPECT_EQ("", c.getMetadata());
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
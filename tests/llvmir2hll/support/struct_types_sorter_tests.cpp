@@ -4,6 +4,9 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <iomanip>
+#include <sstream>
+
 #include <gtest/gtest.h>
 
 #include "retdec/llvmir2hll/ir/array_type.h"
@@ -193,6 +196,41 @@ FiveStructTypesWithSomeDependenciesAreProperlySortedByNameAndByDependencies) {
 	EXPECT_EQ(refSortedStructTypes, StructTypesSorter::sort(structTypes));
 }
 
+TEST_F(StructTypesSorterTests,
+LongChainOfDependenciesInReverseNameOrderIsProperlySorted) {
+	// Input:
+	//
+	// struct S0000 { struct S0001 s; };
+	// struct S0001 { struct S0002 s; };
+	// ...
+	// struct S1999 {};
+	//
+	const std::size_t TYPES_COUNT = 2000;
+	StructTypeVector refSortedStructTypes;
+	ShPtr<StructType> lastType;
+	for (std::size_t i = TYPES_COUNT; i-- > 0;) {
+		std::ostringstream name;
+		name << "S" << std::setw(4) << std::setfill('0') << i;
+		StructType::ElementTypes elements;
+		if (lastType) {
+			elements.push_back(lastType);
+		}
+		lastType = StructType::create(elements, name.str());
+		refSortedStructTypes.push_back(lastType);
+	}
+	StructTypeSet structTypes(refSortedStructTypes.begin(),
+		refSortedStructTypes.end());
+
+	// Expected output:
+	//
+	// struct S1999 {};
+	// struct S1998 { struct S1999 s; };
+	// ...
+	// struct S0000 { struct S0001 s; };
+	//
+	EXPECT_EQ(refSortedStructTypes, StructTypesSorter::sort(structTypes));
+}
+
 } // namespace tests
 } // namespace llvmir2hll
 } // namespace retdec
@@ -0,0 +1,145 @@
+/**
+* @file tests/llvmir2hll/support/subject_tests.cpp
+* @brief Tests for the @c subject module.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/llvmir2hll/support/observer.h"
+#include "retdec/llvmir2hll/support/subject.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace llvmir2hll {
+namespace tests {
+
+namespace {
+
+class Planet: public Subject<Planet>, public SharableFromThis<Planet> {
+public:
+	virtual ShPtr<Planet> getSelf() override { return shared_from_this(); }
+
+	std::size_t getNumOfObservers() const {
+		return observer_end() - observer_begin();
+	}
+};
+
+class PlanetController: public Observer<Planet> {
+public:
+	PlanetController(std::vector<PlanetController *> &updates):
+		updates(updates) {}
+
+	virtual void update(ShPtr<Planet> subject,
+			ShPtr<Planet> arg = nullptr) override {
+		updates.push_back(this);
+	}
+
+private:
+	std::vector<PlanetController *> &updates;
+};
+
+} // anonymous namespace
+
+/**
+* @brief Tests for the @c subject module.
+*/
+class SubjectTests: public Test {
+protected:
+	std::vector<PlanetController *> updates;
+};
+
+TEST_F(SubjectTests,
+SubjectWithoutObserversHasNoObservers) {
+	auto planet = std::make_shared<Planet>();
+
+	planet->notifyObservers();
+	planet->removeObservers();
+
+	EXPECT_EQ(0, planet->getNumOfObservers());
+}
+
+TEST_F(SubjectTests,
+ObserversAreNotifiedInTheOrderTheyWereAdded) {
+	auto planet = std::make_shared<Planet>();
+	auto c1 = std::make_shared<PlanetController>(updates);
+	auto c2 = std::make_shared<PlanetController>(updates);
+	planet->addObserver(c1);
+	planet->addObserver(c2);
+
+	planet->notifyObservers();
+
+	ASSERT_EQ(2, updates.size());
+	EXPECT_EQ(c1.get(), updates[0]);
+	EXPECT_EQ(c2.get(), updates[1]);
+}
+
+TEST_F(SubjectTests,
+RemovedObserverIsNoLongerNotified) {
+	auto planet = std::make_shared<Planet>();
+	auto c1 = std::make_shared<PlanetController>(updates);
+	auto c2 = std::make_shared<PlanetController>(updates);
+	planet->addObserver(c1);
+	planet->addObserver(c2);
+
+	planet->removeObserver(c1);
+	planet->notifyObservers();
+
+	ASSERT_EQ(1, updates.size());
+	EXPECT_EQ(c2.get(), updates[0]);
+	EXPECT_EQ(1, planet->getNumOfObservers());
+}
+
+TEST_F(SubjectTests,
+RemovingObserverRemovesAlsoAllNonExistingObservers) {
+	auto planet = std::make_shared<Planet>();
+	auto c1 = std::make_shared<PlanetController>(updates);
+	auto c2 = std::make_shared<PlanetController>(updates);
+	auto c3 = std::make_shared<PlanetController>(updates);
+	planet->addObserver(c1);
+	planet->addObserver(c2);
+	planet->addObserver(c3);
+	c1.reset();
+	c3.reset();
+
+	planet->removeObserver(c2);
+
+	EXPECT_EQ(0, planet->getNumOfObservers());
+}
+
+TEST_F(SubjectTests,
+NotifyingRemovesNonExistingObservers) {
+	auto planet = std::make_shared<Planet>();
+	auto c1 = std::make_shared<PlanetController>(updates);
+	auto c2 = std::make_shared<PlanetController>(updates);
+	planet->addObserver(c1);
+	planet->addObserver(c2);
+	c1.reset();
+
+	planet->notifyObservers();
+
+	ASSERT_EQ(1, updates.size());
+	EXPECT_EQ(c2.get(), updates[0]);
+	EXPECT_EQ(1, planet->getNumOfObservers());
+}
+
+TEST_F(SubjectTests,
+ObserverCanBeAddedAfterAllObserversWereRemoved) {
+	auto planet = std::make_shared<Planet>();
+	auto c1 = std::make_shared<PlanetController>(updates);
+	planet->addObserver(c1);
+	planet->removeObservers();
+
+	planet->addObserver(c1);
+	planet->notifyObservers();
+
+	ASSERT_EQ(1, updates.size());
+	EXPECT_EQ(c1.get(), updates[0]);
+}
+
+} // namespace tests
+} // namespace llvmir2hll
+} // namespace retdec
@@ -80,6 +80,31 @@ ErrorWhenThereIsAGlobalVariableDefiningStatement) {
 	EXPECT_FALSE(validator->validate(module));
 }
 
+TEST_F(NoGlobalVarDefValidatorTests,
+NoErrorWhenTheErroneousFunctionIsNotAmongRestrictedFunctions) {
+	// Set-up the module.
+	//
+	// a
+	//
+	// def test():
+	//     a = 1   (VarDefStmt)
+	//
+	// def other():
+	//     pass
+	//
+	ShPtr<Variable> varA(Variable::create("a", IntType::create(16)));
+	module->addGlobalVar(varA);
+	ShPtr<VarDefStmt> varDefA(VarDefStmt::create(varA, ConstInt::create(1, 16)));
+	testFunc->setBody(varDefA);
+	ShPtr<Function> otherFunc(addFuncDef("other"));
+
+	validator->restrictToFuncs({otherFunc});
+	EXPECT_TRUE(validator->validate(module));
+
+	validator->restrictToFuncs({testFunc});
+	EXPECT_FALSE(validator->validate(module));
+}
+
 } // namespace tests
 } // namespace llvmir2hll
 } // namespace retdec
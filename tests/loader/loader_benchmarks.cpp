@@ -0,0 +1,377 @@
+/**
+ * @file tests/loader/loader_benchmarks.cpp
+ * @brief Micro-benchmarks of fileformat, pelib and loader primitives.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ *
+ * Every benchmark repeats its operation until it runs for at least the
+ * minimal time and reports the time and the number of C++ allocations per
+ * operation. Primitives working on plain data run on synthetic buffers,
+ * primitives working on a parsed file run on every file given on the
+ * command line.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "retdec/fileformat/file_format/file_format.h"
+#include "retdec/fileformat/format_factory.h"
+#include "retdec/fileformat/utils/crypto.h"
+#include "retdec/fileformat/utils/format_detection.h"
+#include "retdec/fileformat/utils/other.h"
+#include "retdec/loader/image_factory.h"
+#include "retdec/pelib/InputBuffer.h"
+#include "retdec/utils/io/log.h"
+
+using namespace retdec::fileformat;
+using namespace retdec::loader;
+using namespace retdec::utils::io;
+
+//
+//==============================================================================
+// Allocation counting.
+//==============================================================================
+//
+
+namespace {
+
+std::atomic<std::size_t> allocationCount(0);
+
+} // anonymous namespace
+
+void* operator new(std::size_t n)
+{
+	++allocationCount;
+	if (void* p = std::malloc(n ? n : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+//
+//==============================================================================
+// Benchmark runner.
+//==============================================================================
+//
+
+namespace {
+
+/// Size of the synthetic buffers.
+const std::size_t SYNTHETIC_SIZE = 1 << 20;
+
+/// Result of the operation, kept so that it is not optimized out.
+std::atomic<std::uint64_t> sink(0);
+
+class Runner
+{
+	public:
+		Runner(double minTime, const std::string& filter)
+				: _minTime(minTime)
+				, _filter(filter)
+		{
+		}
+
+		/**
+		 * Run @a op repeatedly and print its time and allocations per
+		 * operation.
+		 */
+		void run(const std::string& name, const std::function<void()>& op)
+		{
+			if (!_filter.empty() && name.find(_filter) == std::string::npos)
+			{
+				return;
+			}
+
+			// Warm-up, lazily initialized data are not measured.
+			op();
+
+			std::size_t iterations = 1;
+			while (true)
+			{
+				auto allocs = allocationCount.load();
+				auto start = std::chrono::steady_clock::now();
+				for (std::size_t i = 0; i < iterations; ++i)
+				{
+					op();
+				}
+				double elapsed = std::chrono::duration<double>(
+						std::chrono::steady_clock::now() - start).count();
+				allocs = allocationCount.load() - allocs;
+
+				if (elapsed >= _minTime || iterations >= (1u << 30))
+				{
+					Log::info() << std::left << std::setw(48) << name
+							<< std::right << std::fixed << std::setprecision(1)
+							<< std::setw(14) << elapsed * 1e9 / iterations << " ns/op"
+							<< std::setw(12) << double(allocs) / iterations
+							<< " allocs/op" << std::setw(12) << iterations
+							<< std::endl;
+					return;
+				}
+				iterations *= elapsed > 0.0
+						? std::max(2.0, std::min(100.0, 1.5 * _minTime / elapsed))
+						: 100;
+			}
+		}
+
+	private:
+		double _minTime = 0.0;
+		std::string _filter;
+};
+
+std::vector<std::uint8_t> randomBytes(std::size_t size)
+{
+	std::mt19937 gen(0);
+	std::uniform_int_distribution<unsigned> dist(0, 255);
+	std::vector<std::uint8_t> ret(size);
+	for (auto& b : ret)
+	{
+		b = static_cast<std::uint8_t>(dist(gen));
+	}
+	return ret;
+}
+
+/**
+ * Primitives working on plain data.
+ */
+void runSynthetic(Runner& r)
+{
+	auto bytes = randomBytes(SYNTHETIC_SIZE);
+
+	r.run("synthetic/computeDataEntropy/1MiB", [&bytes]() {
+		sink += computeDataEntropy(bytes.data(), bytes.size()) > 0.0;
+	});
+
+	r.run("synthetic/getCrc32Md5Sha256/1MiB", [&bytes]() {
+		std::string crc32, md5, sha256;
+		getCrc32Md5Sha256(bytes.data(), bytes.size(), crc32, md5, sha256);
+		sink += sha256.size();
+	});
+
+	r.run("synthetic/InputBuffer/read32/1MiB", [&bytes]() {
+		std::vector<unsigned char> data(bytes.begin(), bytes.end());
+		PeLib::InputBuffer ib(data);
+		std::uint32_t sum = 0;
+		for (std::size_t i = 0; i < data.size() / sizeof(sum); ++i)
+		{
+			std::uint32_t v = 0;
+			ib >> v;
+			sum += v;
+		}
+		sink += sum;
+	});
+
+	auto header = bytes;
+	const std::uint8_t elfMagic[] = {0x7f, 'E', 'L', 'F'};
+	std::copy(std::begin(elfMagic), std::end(elfMagic), header.begin());
+	r.run("synthetic/detectFileFormat/elfMagic", [&header]() {
+		sink += static_cast<unsigned>(
+				detectFileFormat(header.data(), header.size()));
+	});
+
+	header[0] = 'M';
+	header[1] = 'Z';
+	r.run("synthetic/detectFileFormat/mzMagic", [&header]() {
+		sink += static_cast<unsigned>(
+				detectFileFormat(header.data(), header.size()));
+	});
+}
+
+/**
+ * Primitives working on the parsed file @a path.
+ */
+void runFile(Runner& r, const std::string& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	std::vector<std::uint8_t> data(
+			(std::istreambuf_iterator<char>(in)),
+			std::istreambuf_iterator<char>());
+	if (!in.eof() && !in)
+	{
+		Log::error() << "Error: cannot read " << path << std::endl;
+		return;
+	}
+
+	std::shared_ptr<FileFormat> ff = createFileFormat(data.data(), data.size());
+	if (!ff || !ff->isInValidState())
+	{
+		Log::error() << "Error: " << path << " is not a supported file"
+				<< std::endl;
+		return;
+	}
+	auto prefix = path + "/";
+
+	r.run(prefix + "detectFileFormat", [&data]() {
+		sink += static_cast<unsigned>(
+				detectFileFormat(data.data(), data.size()));
+	});
+
+	r.run(prefix + "createFileFormat", [&data]() {
+		sink += createFileFormat(data.data(), data.size())->getNumberOfSections();
+	});
+
+	r.run(prefix + "createFileFormat/noHashes", [&data]() {
+		auto flags = static_cast<LoadFlags>(
+				LoadFlags::NO_FILE_HASHES | LoadFlags::NO_VERBOSE_HASHES);
+		sink += createFileFormat(data.data(), data.size(), false, flags)
+				->getNumberOfSections();
+	});
+
+	r.run(prefix + "getXBytes/sections/16B", [&ff]() {
+		std::vector<std::uint8_t> res;
+		for (const auto* sec : ff->getSections())
+		{
+			auto end = sec->getAddress() + sec->getLoadedSize();
+			for (auto a = sec->getAddress(); a + 16 <= end; a += 4096)
+			{
+				sink += ff->getXBytes(a, 16, res);
+			}
+		}
+	});
+
+	r.run(prefix + "computeDataEntropy/sections", [&ff]() {
+		for (const auto* sec : ff->getSections())
+		{
+			auto bytes = sec->getBytes();
+			sink += computeDataEntropy(
+					reinterpret_cast<const std::uint8_t*>(bytes.data()),
+					bytes.size()) > 0.0;
+		}
+	});
+
+	// The same computation as SecSeg::computeHashes(), which is private.
+	r.run(prefix + "computeHashes/sections", [&ff]() {
+		for (const auto* sec : ff->getSections())
+		{
+			auto bytes = sec->getBytes();
+			std::string crc32, md5, sha256;
+			getCrc32Md5Sha256(
+					reinterpret_cast<const unsigned char*>(bytes.data()),
+					bytes.size(), crc32, md5, sha256);
+			sink += sha256.size();
+		}
+	});
+
+	if (ff->getImportTable())
+	{
+		r.run(prefix + "ImportTable/imphashes", [&ff]() {
+			// Enabling the hashes drops the cached ones.
+			ff->loadImpHash();
+			auto* table = ff->getImportTable();
+			sink += table->getImphashCrc32().size()
+					+ table->getImphashMd5().size()
+					+ table->getImphashSha256().size()
+					+ table->getImpHashTlsh().size();
+		});
+	}
+
+	std::shared_ptr<FileFormat> strFf = createFileFormat(
+			data.data(), data.size(), false, LoadFlags::DETECT_STRINGS);
+	r.run(prefix + "loadStrings", [&strFf]() {
+		strFf->loadStrings();
+		sink += strFf->getStrings().size();
+	});
+
+	auto image = createImage(ff);
+	if (!image)
+	{
+		return;
+	}
+	std::vector<std::uint64_t> addresses;
+	for (const auto& seg : image->getSegments())
+	{
+		for (auto a = seg->getAddress(); a < seg->getEndAddress(); a += 256)
+		{
+			addresses.push_back(a);
+		}
+	}
+	if (addresses.empty())
+	{
+		return;
+	}
+	std::shuffle(addresses.begin(), addresses.end(), std::mt19937(0));
+	r.run(prefix + "Image/getSegmentFromAddress", [&image, &addresses]() {
+		for (auto a : addresses)
+		{
+			sink += image->getSegmentFromAddress(a) != nullptr;
+		}
+	});
+}
+
+void printHelp()
+{
+	Log::info() << "Micro-benchmarks of fileformat, pelib and loader primitives.\n\n"
+			<< "Usage: retdec-bench-loader [options] [FILE...]\n\n"
+			<< "Options:\n"
+			<< "\t--min-time SEC  Run every benchmark at least SEC seconds (default 0.2).\n"
+			<< "\t--filter TEXT   Run only benchmarks whose names contain TEXT.\n"
+			<< "\t-h, --help      Print this help.\n\n"
+			<< "Primitives working on parsed files run on every given FILE.\n";
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+	double minTime = 0.2;
+	std::string filter;
+	std::vector<std::string> files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "-h" || arg == "--help")
+		{
+			printHelp();
+			return EXIT_SUCCESS;
+		}
+		else if (arg == "--min-time" && i + 1 < argc)
+		{
+			minTime = std::atof(argv[++i]);
+		}
+		else if (arg == "--filter" && i + 1 < argc)
+		{
+			filter = argv[++i];
+		}
+		else if (!arg.empty() && arg[0] == '-')
+		{
+			Log::error() << "Error: unknown option " << arg << std::endl;
+			return EXIT_FAILURE;
+		}
+		else
+		{
+			files.push_back(arg);
+		}
+	}
+
+	Runner runner(minTime, filter);
+	runSynthetic(runner);
+	for (auto& f : files)
+	{
+		runFile(runner, f);
+	}
+
+	return EXIT_SUCCESS;
+}
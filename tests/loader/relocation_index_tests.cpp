@@ -0,0 +1,121 @@
+/**
+ * @file tests/loader/relocation_index_tests.cpp
+ * @brief Tests for the @c relocation_index module.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <deque>
+
+#include <gtest/gtest.h>
+
+#include "retdec/loader/loader/relocation_index.h"
+#include "retdec/loader/loader/segment.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace loader {
+namespace tests {
+
+class RelocationIndexTests : public Test
+{
+public:
+	RelocationIndexTests() :
+		index([this](const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol&) {
+			applied.push_back(rel.getAddress());
+		})
+	{
+	}
+
+	const retdec::fileformat::Relocation& makeRelocation(std::uint64_t address)
+	{
+		relocations.emplace_back();
+		relocations.back().setAddress(address);
+		return relocations.back();
+	}
+
+	std::deque<retdec::fileformat::Relocation> relocations;
+	retdec::fileformat::Symbol symbol;
+	std::vector<std::uint64_t> applied;
+	RelocationIndex index;
+};
+
+TEST_F(RelocationIndexTests,
+RelocationsAreNotAppliedWhenAdded) {
+	index.add(makeRelocation(0x1000), symbol, 4);
+	index.add(makeRelocation(0x1004), symbol, 4);
+
+	EXPECT_TRUE(applied.empty());
+	EXPECT_TRUE(index.hasPending());
+	EXPECT_EQ(2, index.getNumberOfPending());
+}
+
+TEST_F(RelocationIndexTests,
+ResolveAppliesOnlyOverlappingRelocationsOnce) {
+	index.add(makeRelocation(0x1000), symbol, 4);
+	index.add(makeRelocation(0x1004), symbol, 4);
+	index.add(makeRelocation(0x1008), symbol, 4);
+
+	index.resolve(0x1006, 1);
+	index.resolve(0x1004, 4);
+
+	EXPECT_EQ(std::vector<std::uint64_t>({0x1004}), applied);
+	EXPECT_EQ(2, index.getNumberOfPending());
+}
+
+TEST_F(RelocationIndexTests,
+OverlappingRelocationsAreAppliedTogetherInOriginalOrder) {
+	index.add(makeRelocation(0x1005), symbol, 4);
+	index.add(makeRelocation(0x1000), symbol, 4);
+	index.add(makeRelocation(0x1002), symbol, 4);
+	index.add(makeRelocation(0x1010), symbol, 4);
+
+	// Touches only 0x1000, which overlaps 0x1002, which overlaps 0x1005.
+	index.resolve(0x1000, 1);
+
+	EXPECT_EQ(std::vector<std::uint64_t>({0x1005, 0x1000, 0x1002}), applied);
+	EXPECT_EQ(1, index.getNumberOfPending());
+}
+
+TEST_F(RelocationIndexTests,
+ResolveAllAppliesPendingRelocationsInOriginalOrder) {
+	index.add(makeRelocation(0x2000), symbol, 4);
+	index.add(makeRelocation(0x1000), symbol, 4);
+	index.resolve(0x2000, 4);
+
+	index.resolveAll();
+
+	EXPECT_EQ(std::vector<std::uint64_t>({0x2000, 0x1000}), applied);
+	EXPECT_FALSE(index.hasPending());
+}
+
+TEST_F(RelocationIndexTests,
+SegmentAppliesRelocationsWhenDataAreAccessed) {
+	std::vector<std::uint8_t> data(16, 0);
+	llvm::StringRef dataRef(reinterpret_cast<const char*>(data.data()), data.size());
+	Segment seg(nullptr, 0x1000, data.size(), std::make_unique<SegmentDataSource>(dataRef));
+	RelocationIndex segIndex([&seg](const retdec::fileformat::Relocation& rel, const retdec::fileformat::Symbol&) {
+		// Reading the patched data from the resolver does not resolve again.
+		auto bytes = seg.getBytesRef(rel.getAddress() - seg.getAddress(), 1);
+		seg.setBytes({static_cast<std::uint8_t>(bytes[0] + 1)}, rel.getAddress() - seg.getAddress());
+	});
+	seg.setRelocationIndex(&segIndex);
+	segIndex.add(makeRelocation(0x1004), symbol, 4);
+	segIndex.add(makeRelocation(0x100c), symbol, 4);
+
+	std::vector<std::uint8_t> bytes;
+	ASSERT_TRUE(seg.getBytes(bytes, 4, 1));
+
+	EXPECT_EQ(std::vector<std::uint8_t>({1}), bytes);
+	EXPECT_EQ(0, data[0xc]);
+	EXPECT_EQ(1, segIndex.getNumberOfPending());
+
+	seg.getRawData();
+
+	EXPECT_EQ(1, data[0xc]);
+	EXPECT_FALSE(segIndex.hasPending());
+}
+
+} // namespace tests
+} // namespace loader
+} // namespace retdec
@@ -195,6 +195,26 @@ LoadDataPartiallyExceedingSizeWorks) {
 	EXPECT_EQ(expected, result);
 }
 
+TEST_F(SegmentDataSourceTests,
+GetDataRefPartiallyExceedingSizeWorks) {
+	std::vector<std::uint8_t> data = { 0x10, 0x11, 0x12, 0x13 };
+	llvm::StringRef dataRef = llvm::StringRef(reinterpret_cast<const char*>(data.data()), data.size());
+	SegmentDataSource dataSource(dataRef);
+
+	auto result = dataSource.getDataRef(2, 3);
+	EXPECT_EQ(data.data() + 2, result.data());
+	EXPECT_EQ(2, result.size());
+}
+
+TEST_F(SegmentDataSourceTests,
+GetDataRefFromOffsetOutOfBoundsWorks) {
+	std::vector<std::uint8_t> data = { 0x10, 0x11, 0x12, 0x13 };
+	llvm::StringRef dataRef = llvm::StringRef(reinterpret_cast<const char*>(data.data()), data.size());
+	SegmentDataSource dataSource(dataRef);
+
+	EXPECT_TRUE(dataSource.getDataRef(5, 1).empty());
+}
+
 TEST_F(SegmentDataSourceTests,
 LoadDataWithCorrectOffsetAndSizeWorks) {
 	std::vector<std::uint8_t> data = { 0x10, 0x11, 0x12, 0x13 };
@@ -211,6 +211,38 @@ GetBytesOutOfBoundsWithGreaterMemorySizeWorks) {
 	EXPECT_EQ(expected, loaded);
 }
 
+TEST_F(SegmentTests,
+GetBytesRefPointsIntoSegmentData) {
+	std::vector<std::uint8_t> mockFileData = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 };
+
+	Segment seg(nullptr, 0x1000, mockFileData.size(), makeDataSource(mockFileData));
+
+	auto ref = seg.getBytesRef(2, 4);
+
+	EXPECT_EQ(mockFileData.data() + 2, ref.data());
+	EXPECT_EQ(4, ref.size());
+}
+
+TEST_F(SegmentTests,
+GetBytesRefPartiallyOutOfBoundsReturnsEmptyRef) {
+	std::vector<std::uint8_t> mockFileData = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 };
+
+	Segment seg(nullptr, 0x1000, mockFileData.size(), makeDataSource(mockFileData));
+
+	EXPECT_TRUE(seg.getBytesRef(5, 5).empty());
+	EXPECT_TRUE(seg.getBytesRef(50, 5).empty());
+}
+
+TEST_F(SegmentTests,
+GetBytesRefOfRangeWithoutDataReturnsEmptyRef) {
+	std::vector<std::uint8_t> mockFileData = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 };
+
+	Segment seg(nullptr, 0x1000, 0x100, makeDataSource(mockFileData));
+
+	EXPECT_TRUE(seg.getBytesRef(4, 5).empty());
+	EXPECT_TRUE(seg.getBytesRef(0x50, 4).empty());
+}
+
 TEST_F(SegmentTests,
 SetBytesWorks) {
 	std::vector<std::uint8_t> mockFileData = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 };
@@ -0,0 +1,382 @@
+#!/usr/bin/env python3
+
+"""Generate the synthetic inputs of the slow-input corpus.
+Usage: generate-inputs.py [output-path]
+    output-path Directory to write the inputs into (default: the directory
+                of this script, i.e. the corpus itself).
+
+Every input is a minimal 32-bit x86 PE file with one adversarial property,
+see INPUTS below. The files are deterministic, so regenerating them must not
+change the committed corpus unless this script changes.
+"""
+
+import os
+import struct
+import sys
+
+IMAGE_BASE = 0x400000
+SECTION_ALIGNMENT = 0x1000
+FILE_ALIGNMENT = 0x200
+HEADERS_SIZE = 0x400
+
+SCN_CODE = 0x60000020       # code, execute, read
+SCN_RDATA = 0x40000040      # initialized data, read
+SCN_DATA = 0xC0000040       # initialized data, read, write
+
+DIR_IMPORT = 1
+DIR_RESOURCE = 2
+DIR_IAT = 12
+
+
+def align(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+
+def rel32(src, dst):
+    """Encode a relative displacement of an instruction ending at src."""
+    return struct.pack('<i', dst - src)
+
+
+def abs32(rva):
+    return struct.pack('<I', IMAGE_BASE + rva)
+
+
+class Code:
+    """Tiny x86 assembler with labels. Positions are RVAs."""
+
+    def __init__(self, rva):
+        self.rva = rva
+        self.data = bytearray()
+        self.labels = {}
+        self.fixups = []
+
+    def here(self):
+        return self.rva + len(self.data)
+
+    def label(self, name):
+        self.labels[name] = self.here()
+
+    def emit(self, *chunks):
+        for c in chunks:
+            self.data += c
+
+    def jump(self, opcode, name):
+        """Emit a jump/call with a rel32 displacement to the label."""
+        self.data += opcode
+        self.fixups.append((len(self.data), name))
+        self.data += b'\0\0\0\0'
+
+    def finish(self):
+        for offset, name in self.fixups:
+            end = self.rva + offset + 4
+            self.data[offset:offset + 4] = rel32(end, self.labels[name])
+        return bytes(self.data)
+
+
+class PeFile:
+    """Builder of a minimal PE32 file.
+
+    Section contents are produced by callbacks that get the RVAs of all the
+    sections, so that they can refer to each other. The callbacks are called
+    twice, the first time only to learn the sizes.
+    """
+
+    def __init__(self):
+        self.sections = []
+        self.directories = {}
+        self.entry = None
+
+    def section(self, name, characteristics, build):
+        self.sections.append((name, characteristics, build))
+
+    def layout(self, sizes):
+        rvas = {}
+        rva = SECTION_ALIGNMENT
+        for (name, _, _), size in zip(self.sections, sizes):
+            rvas[name] = rva
+            rva += align(max(size, 1), SECTION_ALIGNMENT)
+        return rvas, rva
+
+    def build(self):
+        # The first pass only measures the contents.
+        dummy = {name: SECTION_ALIGNMENT for name, _, _ in self.sections}
+        sizes = [len(b(dummy, self)) for _, _, b in self.sections]
+        rvas, image_size = self.layout(sizes)
+        self.directories = {}
+        contents = [b(rvas, self) for _, _, b in self.sections]
+        assert [len(c) for c in contents] == sizes
+
+        out = bytearray(HEADERS_SIZE)
+        out[0:2] = b'MZ'
+        struct.pack_into('<I', out, 0x3C, 0x40)
+        out[0x40:0x44] = b'PE\0\0'
+        struct.pack_into('<HHIIIHH', out, 0x44,
+                         0x14C, len(self.sections), 0, 0, 0, 0xE0, 0x0102)
+
+        code_size = sum(len(c) for c, s in zip(contents, self.sections)
+                        if s[1] == SCN_CODE)
+        data_size = sum(len(c) for c, s in zip(contents, self.sections)
+                        if s[1] != SCN_CODE)
+        opt = struct.pack('<HBBIIIIIIIIIHHHHHHIIIIHHIIIIII',
+                          0x10B, 0, 0, code_size, data_size, 0,
+                          rvas[self.entry[0]] + self.entry[1],
+                          SECTION_ALIGNMENT, SECTION_ALIGNMENT,
+                          IMAGE_BASE, SECTION_ALIGNMENT, FILE_ALIGNMENT,
+                          4, 0, 0, 0, 4, 0, 0,
+                          image_size, HEADERS_SIZE, 0, 3, 0,
+                          0x100000, 0x1000, 0x100000, 0x1000, 0, 16)
+        for i in range(16):
+            section, offset, size = self.directories.get(i, (None, 0, 0))
+            rva = rvas[section] + offset if section else 0
+            opt += struct.pack('<II', rva, size)
+        out[0x58:0x58 + len(opt)] = opt
+
+        offset = HEADERS_SIZE
+        header = 0x58 + len(opt)
+        for (name, characteristics, _), data in zip(self.sections, contents):
+            raw_size = align(len(data), FILE_ALIGNMENT)
+            struct.pack_into('<8sIIIIIIHHI', out, header,
+                             name.encode(), len(data), rvas[name], raw_size,
+                             offset, 0, 0, 0, 0, characteristics)
+            header += 40
+            out += data + bytes(raw_size - len(data))
+            offset += raw_size
+        return bytes(out)
+
+
+def entry_calling(functions):
+    """Build a .text section with the entry point calling all the given
+    function builders. A function builder gets the assembler and the section
+    RVAs and emits a function starting at the current position."""
+    def build(rvas, pe):
+        code = Code(rvas['.text'])
+        code.label('entry')
+        for i, _ in enumerate(functions):
+            code.emit(b'\x6A\x00')                      # push 0
+            code.jump(b'\xE8', 'f%d' % i)               # call f<i>
+            code.emit(b'\x83\xC4\x04')                  # add esp, 4
+        code.emit(b'\x31\xC0', b'\xC3')                 # xor eax, eax; ret
+        for i, f in enumerate(functions):
+            code.label('f%d' % i)
+            f(code, rvas)
+        pe.entry = ('.text', 0)
+        return code.finish()
+    return build
+
+
+def ret_function(code, rvas):
+    code.emit(b'\x31\xC0', b'\xC3')                     # xor eax, eax; ret
+
+
+#
+# Inputs.
+#
+
+def resource_loops():
+    """Resource directories pointing back to their ancestors and to
+    themselves."""
+    def rsrc(rvas, pe):
+        subdir = 0x80000000
+        data = bytearray()
+        # Root at 0x00: two entries -> A (0x20), B (0x38).
+        data += struct.pack('<IIHHHH', 0, 0, 0, 0, 0, 2)
+        data += struct.pack('<II', 3, subdir | 0x20)
+        data += struct.pack('<II', 14, subdir | 0x38)
+        # A at 0x20: one entry -> root.
+        data += struct.pack('<IIHHHH', 0, 0, 0, 0, 0, 1)
+        data += struct.pack('<II', 1, subdir | 0x00)
+        # B at 0x38: entries -> B itself and -> A.
+        data += struct.pack('<IIHHHH', 0, 0, 0, 0, 0, 2)
+        data += struct.pack('<II', 1, subdir | 0x38)
+        data += struct.pack('<II', 2, subdir | 0x20)
+        pe.directories[DIR_RESOURCE] = ('.rsrc', 0, len(data))
+        return bytes(data)
+
+    pe = PeFile()
+    pe.section('.text', SCN_CODE, entry_calling([ret_function]))
+    pe.section('.rsrc', SCN_RDATA, rsrc)
+    return pe
+
+
+def resource_fanout():
+    """Three levels of resource directories, each with thousands of entries
+    sharing the same subdirectory - a tree exponential in its depth unless
+    the shared nodes are visited once."""
+    entries = 1024
+
+    def rsrc(rvas, pe):
+        subdir = 0x80000000
+        dir_size = 16 + 8 * entries
+        data = bytearray()
+        for level in range(3):
+            data += struct.pack('<IIHHHH', 0, 0, 0, 0, 0, entries)
+            target = dir_size * (level + 1)
+            if level < 2:
+                target |= subdir
+            for i in range(entries):
+                data += struct.pack('<II', i + 1, target)
+        # Data entry shared by all the leaves, and 16 bytes of data.
+        leaf = len(data)
+        data += struct.pack("<IIII", rvas[".rsrc"] + leaf + 16, 16, 0, 0)
+        data += b'slow-input-data\0'
+        pe.directories[DIR_RESOURCE] = ('.rsrc', 0, len(data))
+        return bytes(data)
+
+    pe = PeFile()
+    pe.section('.text', SCN_CODE, entry_calling([ret_function]))
+    pe.section('.rsrc', SCN_RDATA, rsrc)
+    return pe
+
+
+def many_imports():
+    """Thousands of functions imported from one library."""
+    count = 2048
+
+    def idata(rvas, pe):
+        base = rvas['.idata']
+        thunks = (count + 1) * 4
+        descriptors = 0
+        ilt = descriptors + 2 * 20
+        iat = ilt + thunks
+        names = iat + thunks
+        name_data = bytearray()
+        hint_names = []
+        for i in range(count):
+            hint_names.append(names + len(name_data))
+            name_data += struct.pack('<H', i) + b'SlowImport%05d\0' % i
+            if len(name_data) % 2:
+                name_data += b'\0'
+        dll = names + len(name_data)
+        name_data += b'slowinputs.dll\0\0'
+
+        data = bytearray()
+        data += struct.pack('<IIIII', base + ilt, 0, 0, base + dll, base + iat)
+        data += bytes(20)
+        table = b''.join(struct.pack('<I', base + h) for h in hint_names)
+        table += bytes(4)
+        data += table + table + name_data
+        pe.directories[DIR_IMPORT] = ('.idata', descriptors, 2 * 20)
+        pe.directories[DIR_IAT] = ('.idata', iat, thunks)
+        return bytes(data)
+
+    def call_imports(code, rvas):
+        # Call every 16th import so that they are used by the code.
+        iat = rvas['.idata'] + 2 * 20 + (count + 1) * 4
+        for i in range(0, count, 16):
+            code.emit(b'\xFF\x15', abs32(iat + 4 * i))  # call [iat + 4 * i]
+        code.emit(b'\x31\xC0', b'\xC3')
+
+    pe = PeFile()
+    pe.section('.text', SCN_CODE, entry_calling([call_imports]))
+    pe.section('.idata', SCN_DATA, idata)
+    return pe
+
+
+def switch_table():
+    """Switch with a jump table of thousands of entries pointing to a few
+    case blocks."""
+    cases = 8192
+    targets = 64
+    labels = {}
+
+    def function(code, rvas):
+        table = rvas['.rdata']
+        code.emit(b'\x8B\x44\x24\x04')                  # mov eax, [esp + 4]
+        code.emit(b'\x3D', struct.pack('<I', cases - 1))  # cmp eax, cases - 1
+        code.jump(b'\x0F\x87', 'default')               # ja default
+        code.emit(b'\xFF\x24\x85', abs32(table))        # jmp [table + eax * 4]
+        for t in range(targets):
+            code.label('case%d' % t)
+            code.emit(b'\xB8', struct.pack('<I', t), b'\xC3')
+        code.label('default')
+        code.emit(b'\x31\xC0', b'\xC3')
+        labels.update(code.labels)
+
+    def rdata(rvas, pe):
+        return b''.join(abs32(labels['case%d' % (i % targets)])
+                        for i in range(cases))
+
+    pe = PeFile()
+    pe.section('.text', SCN_CODE, entry_calling([function]))
+    pe.section('.rdata', SCN_RDATA, rdata)
+    return pe
+
+
+def x87_blocks():
+    """Function with thousands of basic blocks, each manipulating the x87
+    register stack, which stays four registers deep across the blocks."""
+    blocks = 2048
+
+    def function(code, rvas):
+        x = rvas['.data']
+        y = x + 4
+        code.emit(b'\x8B\x44\x24\x04')                  # mov eax, [esp + 4]
+        code.emit(b'\xD9\xE8' * 4)                      # fld1 x 4
+        for b in range(blocks):
+            code.label('b%d' % b)
+            code.emit(b'\xD9\x05', abs32(x))            # fld [x]
+            code.emit(b'\xD8\x05', abs32(y))            # fadd [y]
+            code.emit(b'\xD9\xC9')                      # fxch st1
+            code.emit(b'\xDE\xC1')                      # faddp st1
+            code.emit(b'\xD9\xCA')                      # fxch st2
+            code.emit(b'\xD9\x15', abs32(x))            # fst [x]
+            code.emit(b'\x48')                          # dec eax
+            code.jump(b'\x0F\x84', 'b%d' % ((b * 5 + 7) % blocks))  # je
+        code.emit(b'\xDD\xD8' * 4)                      # fstp st0 x 4
+        code.emit(b'\x31\xC0', b'\xC3')
+
+    def data(rvas, pe):
+        return struct.pack('<ff', 1.5, 2.5)
+
+    pe = PeFile()
+    pe.section('.text', SCN_CODE, entry_calling([function]))
+    pe.section('.data', SCN_DATA, data)
+    return pe
+
+
+def irreducible_cfg():
+    """Chain of blocks with crossing forward and backward conditional
+    jumps, i.e. a large irreducible control-flow graph."""
+    blocks = 160
+
+    def function(code, rvas):
+        code.emit(b'\x8B\x4C\x24\x04')                  # mov ecx, [esp + 4]
+        for b in range(blocks):
+            code.label('b%d' % b)
+            code.emit(b'\x81\xF9', struct.pack('<I', b))  # cmp ecx, b
+            code.jump(b'\x0F\x84', 'b%d' % ((b * 7 + 3) % blocks))  # je
+            code.emit(b'\x41')                          # inc ecx
+            code.emit(b'\xF6\xC1\x04')                  # test cl, 4
+            code.jump(b'\x0F\x85', 'b%d' % ((b * 11 + 5) % blocks))  # jne
+        code.emit(b'\x89\xC8', b'\xC3')                 # mov eax, ecx; ret
+
+    pe = PeFile()
+    pe.section('.text', SCN_CODE, entry_calling([function]))
+    return pe
+
+
+INPUTS = {
+    'pe-resource-loops.exe': resource_loops,
+    'pe-resource-fanout.exe': resource_fanout,
+    'pe-many-imports.exe': many_imports,
+    'pe-switch-table.exe': switch_table,
+    'pe-x87-blocks.exe': x87_blocks,
+    'pe-irreducible-cfg.exe': irreducible_cfg,
+}
+
+
+def main():
+    if len(sys.argv) > 2 or (len(sys.argv) == 2 and sys.argv[1] in ['-h', '--help']):
+        print(__doc__.strip())
+        sys.exit(1)
+    out_dir = sys.argv[1] if len(sys.argv) == 2 \
+        else os.path.dirname(os.path.abspath(__file__))
+
+    os.makedirs(out_dir, exist_ok=True)
+    for name, generate in sorted(INPUTS.items()):
+        with open(os.path.join(out_dir, name), 'wb') as f:
+            f.write(generate().build())
+
+
+if __name__ == '__main__':
+    main()
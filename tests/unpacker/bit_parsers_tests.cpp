@@ -0,0 +1,94 @@
+/**
+* @file tests/unpacker/bit_parsers_tests.cpp
+* @brief Tests for the @c bit_parsers module.
+* @copyright (c) 2017 Avast Software, licensed under the MIT license
+*/
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/unpacker/decompression/nrv/bit_parsers.h"
+
+using namespace ::testing;
+using namespace retdec::utils;
+
+namespace retdec {
+namespace unpacker {
+namespace tests {
+
+class BitParsersTests : public Test
+{
+protected:
+	std::vector<uint8_t> readBits(BitParser& parser, const DynamicBuffer& data, uint32_t& pos, std::size_t count)
+	{
+		std::vector<uint8_t> bits;
+		uint8_t bit;
+		while (bits.size() < count && parser.getBit(bit, data, pos))
+			bits.push_back(bit);
+		return bits;
+	}
+};
+
+TEST_F(BitParsersTests,
+BitParser8ReadsBitsFromMostSignificant) {
+	DynamicBuffer data(std::vector<uint8_t>{ 0xA0, 0x01 });
+	BitParser8 parser;
+	uint32_t pos = 0;
+
+	EXPECT_EQ(std::vector<uint8_t>({ 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 }), readBits(parser, data, pos, 16));
+	EXPECT_EQ(2, pos);
+}
+
+TEST_F(BitParsersTests,
+BitParser8FailsAtEndOfData) {
+	DynamicBuffer data(std::vector<uint8_t>{ 0xFF });
+	BitParser8 parser;
+	uint32_t pos = 0;
+
+	EXPECT_EQ(8, readBits(parser, data, pos, 16).size());
+	EXPECT_EQ(1, pos);
+}
+
+TEST_F(BitParsersTests,
+BitParserLe32ReadsLittleEndianWords) {
+	DynamicBuffer data(std::vector<uint8_t>{ 0x01, 0x00, 0x00, 0x80 });
+	BitParserLe32 parser;
+	uint32_t pos = 0;
+
+	auto bits = readBits(parser, data, pos, 32);
+	ASSERT_EQ(32, bits.size());
+	EXPECT_EQ(1, bits[0]);
+	EXPECT_EQ(0, bits[1]);
+	EXPECT_EQ(1, bits[31]);
+	EXPECT_EQ(4, pos);
+}
+
+TEST_F(BitParsersTests,
+BitParserLe32ReadsMissingBytesOfLastWordAsZeroes) {
+	DynamicBuffer data(std::vector<uint8_t>{ 0x00, 0x00, 0x80 });
+	BitParserLe32 parser;
+	uint32_t pos = 0;
+
+	auto bits = readBits(parser, data, pos, 64);
+	ASSERT_EQ(32, bits.size());
+	EXPECT_EQ(0, bits[0]);
+	EXPECT_EQ(1, bits[8]);
+	EXPECT_EQ(4, pos);
+}
+
+TEST_F(BitParsersTests,
+BitParser8ReadsNewByteAfterReset) {
+	DynamicBuffer data(std::vector<uint8_t>{ 0xFF, 0x00 });
+	BitParser8 parser;
+	uint32_t pos = 0;
+
+	EXPECT_EQ(std::vector<uint8_t>({ 1, 1, 1 }), readBits(parser, data, pos, 3));
+	parser.reset();
+	EXPECT_EQ(std::vector<uint8_t>({ 0, 0, 0 }), readBits(parser, data, pos, 3));
+	EXPECT_EQ(2, pos);
+}
+
+} // namespace tests
+} // namespace unpacker
+} // namespace retdec
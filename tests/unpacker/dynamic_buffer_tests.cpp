@@ -70,6 +70,29 @@ PartialCopyInitializationWorks) {
 	EXPECT_EQ(std::vector<uint8_t>({ 0x37, 0x42 }), copiedBuffer.getBuffer());
 }
 
+TEST_F(DynamicBufferTests,
+MoveInitializationWorks) {
+	std::vector<uint8_t> data = { 0x24, 0x42 };
+	DynamicBuffer buffer(data, Endianness::BIG);
+	DynamicBuffer movedBuffer(std::move(buffer));
+
+	EXPECT_EQ(Endianness::BIG, movedBuffer.getEndianness());
+	EXPECT_EQ(2, movedBuffer.getCapacity());
+	EXPECT_EQ(data, movedBuffer.getBuffer());
+	EXPECT_EQ(0, buffer.getCapacity());
+	EXPECT_EQ(0, buffer.getRealDataSize());
+}
+
+TEST_F(DynamicBufferTests,
+DataMoveInitializationWorks) {
+	std::vector<uint8_t> data = { 0x01, 0x02, 0x03 };
+	DynamicBuffer buffer(std::vector<uint8_t>(data), Endianness::BIG);
+
+	EXPECT_EQ(Endianness::BIG, buffer.getEndianness());
+	EXPECT_EQ(3, buffer.getCapacity());
+	EXPECT_EQ(data, buffer.getBuffer());
+}
+
 TEST_F(DynamicBufferTests,
 AssignOperatorWorks) {
 	std::vector<uint8_t> data = { 0x24, 0x42, 0x37, 0x13 };
@@ -371,6 +394,64 @@ ForEachReverseWorks) {
 	EXPECT_EQ(std::vector<uint8_t>({ 0x00, 0x00, 0x00, 0xD4, 0xD5 }), buffer.getBuffer());
 }
 
+TEST_F(DynamicBufferTests,
+TransformWorks) {
+	DynamicBuffer buffer({ 0xD0, 0xD1, 0xD2, 0xD3, 0xD4 });
+	buffer.transform([](uint8_t byte) { return byte ^ 0xFF; });
+
+	EXPECT_EQ(std::vector<uint8_t>({ 0x2F, 0x2E, 0x2D, 0x2C, 0x2B }), buffer.getBuffer());
+}
+
+TEST_F(DynamicBufferTests,
+TransformOfRangeIsClampedToRealData) {
+	DynamicBuffer buffer(10);
+	buffer.write<uint32_t>(0xD3D2D1D0, 0);
+	buffer.transform(2, 10, [](uint8_t byte) { return byte + 1; });
+
+	EXPECT_EQ(std::vector<uint8_t>({ 0xD0, 0xD1, 0xD3, 0xD4 }), buffer.getBuffer());
+}
+
+TEST_F(DynamicBufferTests,
+SpanViewsDataWithoutCopying) {
+	DynamicBuffer buffer({ 0xD0, 0xD1, 0xD2, 0xD3, 0xD4 });
+	const DynamicBuffer& constBuffer = buffer;
+
+	EXPECT_EQ(buffer.getRawBuffer(), constBuffer.getSpan().data());
+	EXPECT_EQ(5, constBuffer.getSpan().size());
+	EXPECT_EQ(buffer.getRawBuffer() + 1, constBuffer.getSpan(1, 2).data());
+	EXPECT_EQ(std::vector<uint8_t>({ 0xD1, 0xD2 }), constBuffer.getSpan(1, 2).toVector());
+}
+
+TEST_F(DynamicBufferTests,
+SpanIsClampedToRealData) {
+	DynamicBuffer buffer({ 0xD0, 0xD1, 0xD2, 0xD3, 0xD4 });
+
+	EXPECT_EQ(std::vector<uint8_t>({ 0xD3, 0xD4 }), buffer.getSpan(3, 10).toVector());
+	EXPECT_TRUE(buffer.getSpan(10, 1).empty());
+	EXPECT_EQ(5, buffer.getRealDataSize());
+}
+
+TEST_F(DynamicBufferTests,
+WritingThroughSpanModifiesBuffer) {
+	DynamicBuffer buffer({ 0xD0, 0xD1, 0xD2, 0xD3, 0xD4 });
+	auto view = buffer.getSpan(1, 2);
+	view[0] = 0x00;
+
+	EXPECT_EQ(std::vector<uint8_t>({ 0xD0, 0x00, 0xD2, 0xD3, 0xD4 }), buffer.getBuffer());
+}
+
+TEST_F(DynamicBufferTests,
+BufferCreatedFromSpanIsIndependentCopy) {
+	DynamicBuffer buffer({ 0xD0, 0xD1, 0xD2, 0xD3, 0xD4 }, Endianness::BIG);
+	DynamicBuffer copy(buffer.getSpan(1, 3), buffer.getEndianness());
+	copy.write<uint8_t>(0x00, 0);
+
+	EXPECT_EQ(Endianness::BIG, copy.getEndianness());
+	EXPECT_EQ(3, copy.getCapacity());
+	EXPECT_EQ(std::vector<uint8_t>({ 0x00, 0xD2, 0xD3 }), copy.getBuffer());
+	EXPECT_EQ(std::vector<uint8_t>({ 0xD0, 0xD1, 0xD2, 0xD3, 0xD4 }), buffer.getBuffer());
+}
+
 } // namespace unpacker
 } // namespace retdec
 } // namespace tests
@@ -0,0 +1,155 @@
+/**
+ * @file tests/utils/cancellation_tests.cpp
+ * @brief Tests for the @c cancellation module.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/cancellation.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace tests {
+
+class CancellationTests: public Test {};
+
+TEST_F(CancellationTests,
+NewTokenIsNotCancelled) {
+	CancellationToken token;
+
+	EXPECT_FALSE(token.isCancelled());
+	EXPECT_FALSE(token.isPhaseBudgetExpired());
+	EXPECT_NO_THROW(token.throwIfCancelled());
+}
+
+TEST_F(CancellationTests,
+CancelledTokenThrows) {
+	CancellationToken token;
+	token.cancel();
+
+	EXPECT_TRUE(token.isCancelled());
+	EXPECT_THROW(token.throwIfCancelled(), OperationCancelled);
+}
+
+TEST_F(CancellationTests,
+TokenIsCancelledAfterDeadline) {
+	CancellationToken token;
+	token.setDeadline(CancellationToken::Clock::now());
+
+	EXPECT_TRUE(token.isCancelled());
+}
+
+TEST_F(CancellationTests,
+TokenIsNotCancelledBeforeDeadline) {
+	CancellationToken token;
+	token.setDeadline(
+		CancellationToken::Clock::now() + std::chrono::hours(1)
+	);
+
+	EXPECT_FALSE(token.isCancelled());
+}
+
+TEST_F(CancellationTests,
+PhaseWithoutBudgetNeverExpires) {
+	CancellationToken token;
+	token.startPhase();
+
+	EXPECT_FALSE(token.isPhaseBudgetExpired());
+}
+
+TEST_F(CancellationTests,
+PhaseBudgetExpiresButTokenIsNotCancelled) {
+	CancellationToken token;
+	token.setPhaseBudget(std::chrono::milliseconds(1));
+	token.startPhase();
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+	EXPECT_TRUE(token.isPhaseBudgetExpired());
+	EXPECT_FALSE(token.isCancelled());
+}
+
+TEST_F(CancellationTests,
+StartingNewPhaseRenewsBudget) {
+	CancellationToken token;
+	token.setPhaseBudget(std::chrono::hours(1));
+	token.startPhase();
+
+	EXPECT_FALSE(token.isPhaseBudgetExpired());
+}
+
+TEST_F(CancellationTests,
+TokenWithoutMemoryLimitIsNeverOverIt) {
+	CancellationToken token;
+
+	EXPECT_FALSE(token.isMemoryLimitExceeded());
+}
+
+TEST_F(CancellationTests,
+PhaseBudgetExpiresWhenMemoryLimitIsExceeded) {
+	CancellationToken token;
+	token.setMemoryLimit(1);
+	token.startPhase();
+
+	EXPECT_TRUE(token.isMemoryLimitExceeded());
+	EXPECT_TRUE(token.isPhaseBudgetExpired());
+	EXPECT_FALSE(token.isCancelled());
+}
+
+TEST_F(CancellationTests,
+NothingIsRequestedWithoutCurrentToken) {
+	EXPECT_EQ(nullptr, getCurrentCancellationToken());
+	EXPECT_FALSE(isCancellationRequested());
+	EXPECT_FALSE(isPhaseBudgetExpired());
+	EXPECT_FALSE(isMemoryLimitExceeded());
+	EXPECT_NO_THROW(throwIfCancellationRequested());
+}
+
+TEST_F(CancellationTests,
+ScopeSetsAndRestoresCurrentToken) {
+	CancellationToken outer;
+	CancellationToken inner;
+	inner.cancel();
+	{
+		CancellationScope s1(outer);
+		EXPECT_EQ(&outer, getCurrentCancellationToken());
+		{
+			CancellationScope s2(inner);
+			EXPECT_EQ(&inner, getCurrentCancellationToken());
+			EXPECT_THROW(throwIfCancellationRequested(), OperationCancelled);
+		}
+		EXPECT_EQ(&outer, getCurrentCancellationToken());
+		EXPECT_FALSE(isCancellationRequested());
+	}
+	EXPECT_EQ(nullptr, getCurrentCancellationToken());
+}
+
+TEST_F(CancellationTests,
+CurrentTokenIsPerThread) {
+	CancellationToken token;
+	CancellationScope scope(token);
+
+	CancellationToken* other = &token;
+	std::thread thr([&other]() { other = getCurrentCancellationToken(); });
+	thr.join();
+
+	EXPECT_EQ(nullptr, other);
+}
+
+TEST_F(CancellationTests,
+TokenCanBeCancelledFromAnotherThread) {
+	CancellationToken token;
+
+	std::thread thr([&token]() { token.cancel(); });
+	thr.join();
+
+	EXPECT_TRUE(token.isCancelled());
+}
+
+} // namespace tests
+} // namespace utils
+} // namespace retdec
@@ -4,6 +4,7 @@
 * @copyright (c) 2017 Avast Software, licensed under the MIT license
 */
 
+#include <functional>
 #include <map>
 
 #include <gtest/gtest.h>
@@ -287,6 +288,16 @@ RemoveFromSetRemovesEverythingWhenToRemoveIsFrom) {
 	EXPECT_TRUE(from.empty());
 }
 
+TEST_F(ContainerTests,
+RemoveFromSetWorksForSetsWithCustomOrdering) {
+	std::set<int, std::greater<int>> from{1, 2, 3, 4};
+	std::set<int, std::greater<int>> toRemove{1, 3};
+
+	removeFromSet(from, toRemove);
+
+	EXPECT_EQ((std::set<int, std::greater<int>>{4, 2}), from);
+}
+
 //
 // shareSomeItem()
 //
@@ -342,6 +353,16 @@ ShareSomeItemSetsShareTwoItems) {
 	EXPECT_TRUE(shareSomeItem(s2, s1));
 }
 
+TEST_F(ContainerTests,
+ShareSomeItemWorksForSetsWithCustomOrdering) {
+	std::set<int, std::greater<int>> s1{1, 2, 3};
+	std::set<int, std::greater<int>> s2{3, 4};
+	std::set<int, std::greater<int>> s3{4, 5};
+
+	EXPECT_TRUE(shareSomeItem(s1, s2));
+	EXPECT_FALSE(shareSomeItem(s1, s3));
+}
+
 //
 // getKeysFromMap()
 //
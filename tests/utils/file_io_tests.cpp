@@ -0,0 +1,74 @@
+/**
+* @file tests/utils/file_io_tests.cpp
+* @brief Tests for the @c file_io module.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/file_io.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace tests {
+
+/**
+* @brief Tests for the @c file_io module.
+*/
+class FileIoTests: public Test {};
+
+TEST_F(FileIoTests,
+ReadFileOfEmptyStreamReturnsEmptyVector) {
+	std::istringstream s("");
+	std::vector<std::uint8_t> result{1, 2, 3};
+
+	ASSERT_TRUE(readFile(s, result));
+	ASSERT_TRUE(result.empty());
+}
+
+TEST_F(FileIoTests,
+ReadFileReadsWholeStream) {
+	std::istringstream s("abc");
+	std::vector<std::uint8_t> result;
+
+	ASSERT_TRUE(readFile(s, result));
+	ASSERT_EQ(std::vector<std::uint8_t>({'a', 'b', 'c'}), result);
+}
+
+TEST_F(FileIoTests,
+ReadFileReadsWholeStreamFromGivenOffset) {
+	std::istringstream s("abcd");
+	std::vector<std::uint8_t> result;
+
+	ASSERT_TRUE(readFile(s, result, 2));
+	ASSERT_EQ(std::vector<std::uint8_t>({'c', 'd'}), result);
+}
+
+TEST_F(FileIoTests,
+ReadFileReadsOnlyDesiredNumberOfBytes) {
+	std::istringstream s("abcd");
+	std::vector<std::uint8_t> result;
+
+	ASSERT_TRUE(readFile(s, result, 1, 2));
+	ASSERT_EQ(std::vector<std::uint8_t>({'b', 'c'}), result);
+}
+
+TEST_F(FileIoTests,
+ReadFileOfLargeStreamDoesNotAllocateMoreThanNeeded) {
+	// Larger than a single read burst.
+	std::string data(3 * FILE_BURST_READ_LENGTH + 5, 'x');
+	std::istringstream s(data);
+	std::vector<std::uint8_t> result;
+
+	ASSERT_TRUE(readFile(s, result));
+	ASSERT_EQ(data.size(), result.size());
+	ASSERT_EQ(result.size(), result.capacity());
+}
+
+} // namespace tests
+} // namespace utils
+} // namespace retdec
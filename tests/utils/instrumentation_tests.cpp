@@ -0,0 +1,221 @@
+/**
+ * @file tests/utils/instrumentation_tests.cpp
+ * @brief Tests for the @c instrumentation module.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <sstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/instrumentation.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace instrumentation {
+namespace tests {
+
+class InstrumentationTests: public Test
+{
+	protected:
+		void SetUp() override
+		{
+			reset();
+			setEnabled(true);
+		}
+
+		void TearDown() override
+		{
+			setEnabled(false);
+			setTracing(false);
+			reset();
+		}
+};
+
+TEST_F(InstrumentationTests,
+NothingIsCollectedWhenDisabled) {
+	setEnabled(false);
+	{
+		ScopedTimer timer("timer");
+		addToCounter("counter", 1);
+	}
+
+	auto stats = collect();
+
+	EXPECT_TRUE(stats.timers.empty());
+	// The function itself does not check the flag, the macro does.
+	EXPECT_EQ(1, stats.counters["counter"]);
+}
+
+TEST_F(InstrumentationTests,
+TimersAndCountersAreAggregatedByName) {
+	for (unsigned i = 0; i < 3; ++i)
+	{
+		ScopedTimer timer("timer");
+		addToCounter("counter", 2);
+	}
+
+	auto stats = collect();
+
+	EXPECT_EQ(3, stats.timers["timer"].count);
+	EXPECT_GE(stats.timers["timer"].totalNs, stats.timers["timer"].maxNs);
+	EXPECT_EQ(6, stats.counters["counter"]);
+}
+
+TEST_F(InstrumentationTests,
+MeasurementsOfAllThreadsAreMerged) {
+	std::thread t1([]() { addToCounter("counter", 1); });
+	std::thread t2([]() { addToCounter("counter", 2); });
+	t1.join();
+	t2.join();
+	addToCounter("counter", 4);
+
+	EXPECT_EQ(7, collect().counters["counter"]);
+}
+
+TEST_F(InstrumentationTests,
+InternedNamesAreMergedWithLiterals) {
+	std::string name = "count";
+	addToCounter(intern(name + "er"), 1);
+	addToCounter("counter", 1);
+
+	EXPECT_EQ(intern("counter"), intern(name + "er"));
+	EXPECT_EQ(2, collect().counters["counter"]);
+}
+
+TEST_F(InstrumentationTests,
+DifferenceOfStatsContainsOnlyNewMeasurements) {
+	addToCounter("old", 1);
+	addToCounter("counter", 1);
+	auto before = collect();
+	addToCounter("counter", 2);
+	{
+		ScopedTimer timer("timer");
+	}
+
+	auto diff = collect() - before;
+
+	EXPECT_EQ(0, diff.counters.count("old"));
+	EXPECT_EQ(2, diff.counters["counter"]);
+	EXPECT_EQ(1, diff.timers["timer"].count);
+}
+
+TEST_F(InstrumentationTests,
+ChromeTraceContainsTracedScopesAndCounters) {
+	{
+		ScopedTimer timer("untraced");
+	}
+	setTracing(true);
+	{
+		ScopedTimer timer("traced");
+	}
+	addToCounter("counter", 5);
+
+	std::ostringstream out;
+	ASSERT_TRUE(writeChromeTrace(out));
+
+	auto trace = out.str();
+	EXPECT_EQ(0, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+	EXPECT_NE(std::string::npos, trace.find("{\"name\":\"traced\",\"ph\":\"X\""));
+	EXPECT_EQ(std::string::npos, trace.find("untraced"));
+	EXPECT_NE(std::string::npos, trace.find(
+			"{\"name\":\"counter\",\"ph\":\"C\""));
+	EXPECT_NE(std::string::npos, trace.find("\"args\":{\"value\":5}"));
+}
+
+TEST_F(InstrumentationTests,
+ArgumentsAreAddedOnlyToTracedScopes) {
+	{
+		ScopedTimer timer("untraced");
+		EXPECT_FALSE(timer.isTraced());
+		timer.addArg("untracedArg", 1);
+	}
+	setTracing(true);
+	{
+		ScopedTimer timer("traced");
+		timer.addArg("address", std::string("0x401000"));
+		timer.addArg("size", 16);
+	}
+
+	std::ostringstream out;
+	ASSERT_TRUE(writeChromeTrace(out));
+
+	auto trace = out.str();
+	EXPECT_EQ(std::string::npos, trace.find("untracedArg"));
+	EXPECT_NE(std::string::npos, trace.find(
+			"\"args\":{\"address\":\"0x401000\",\"size\":16}"));
+}
+
+TEST_F(InstrumentationTests,
+SpansAreTracedButNotAggregated) {
+	beginSpan("ignored");
+	endSpan();
+	setTracing(true);
+	beginSpan("outer");
+	beginSpan("inner");
+	endSpan();
+	endSpan();
+	beginSpan("unfinished");
+	// Unmatched ends are ignored.
+	endSpan();
+	endSpan();
+
+	std::ostringstream out;
+	ASSERT_TRUE(writeChromeTrace(out));
+
+	auto trace = out.str();
+	EXPECT_TRUE(collect().timers.empty());
+	EXPECT_EQ(std::string::npos, trace.find("ignored"));
+	EXPECT_NE(std::string::npos, trace.find("{\"name\":\"outer\",\"ph\":\"X\""));
+	EXPECT_NE(std::string::npos, trace.find("{\"name\":\"inner\",\"ph\":\"X\""));
+	EXPECT_NE(std::string::npos, trace.find("{\"name\":\"unfinished\",\"ph\":\"X\""));
+}
+
+TEST_F(InstrumentationTests,
+PhasesEndWhenPhaseOfTheSameOrOuterLevelBegins) {
+	setTracing(true);
+	beginPhase("phase1", 0);
+	beginPhase("sub1", 1);
+	beginPhase("sub2", 1);
+	beginPhase("phase2", 0);
+
+	std::ostringstream first;
+	ASSERT_TRUE(writeChromeTrace(first));
+	auto trace = first.str();
+	for (auto* name : {"phase1", "sub1", "sub2", "phase2"})
+	{
+		EXPECT_NE(std::string::npos, trace.find(
+				std::string("{\"name\":\"") + name + "\",\"ph\":\"X\""));
+	}
+
+	// Phases which have not ended yet end when the trace is written.
+	std::ostringstream second;
+	ASSERT_TRUE(writeChromeTrace(second));
+	EXPECT_EQ(trace.find("phase2"), second.str().find("phase2"));
+}
+
+#ifndef RETDEC_INSTRUMENTATION
+TEST_F(InstrumentationTests,
+MacrosDoNotEvaluateArgumentsWithoutInstrumentation) {
+	bool evaluated = false;
+	auto name = [&evaluated]() { evaluated = true; return "name"; };
+
+	RETDEC_SCOPED_TIMER(name());
+	RETDEC_SCOPED_TIMER_VAR(timer, name());
+	RETDEC_TIMER_ARG(timer, "key", name());
+	RETDEC_COUNTER_ADD(name(), 1);
+	RETDEC_TRACE_BEGIN(name());
+	RETDEC_TRACE_END();
+	RETDEC_TRACE_PHASE(name(), 0);
+
+	EXPECT_FALSE(evaluated);
+}
+#endif
+
+} // namespace tests
+} // namespace instrumentation
+} // namespace utils
+} // namespace retdec
@@ -0,0 +1,101 @@
+/**
+ * @file tests/utils/interned_string_tests.cpp
+ * @brief Tests for the @c interned_string module.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <set>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/interned_string.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace tests {
+
+class InternedStringTests: public Test {};
+
+TEST_F(InternedStringTests,
+DefaultConstructedStringIsEmpty) {
+	InternedString s;
+
+	EXPECT_TRUE(s.empty());
+	EXPECT_EQ("", s.str());
+	EXPECT_EQ(InternedString(""), s);
+}
+
+TEST_F(InternedStringTests,
+EqualStringsShareStorage) {
+	std::string name("_ZN4testC2Ev");
+	InternedString s1(name);
+	InternedString s2(name.c_str());
+
+	EXPECT_EQ(s1, s2);
+	EXPECT_EQ(s1.c_str(), s2.c_str());
+	EXPECT_NE(name.c_str(), s1.c_str());
+	EXPECT_EQ(name, s1.str());
+	EXPECT_EQ(std::hash<InternedString>()(s1), std::hash<InternedString>()(s2));
+}
+
+TEST_F(InternedStringTests,
+DifferentStringsAreNotEqual) {
+	InternedString s1("abc");
+	InternedString s2("abd");
+
+	EXPECT_NE(s1, s2);
+	EXPECT_FALSE(s1 == s2);
+}
+
+TEST_F(InternedStringTests,
+OrderingComparesStrings) {
+	std::set<InternedString> names{"c", "a", "b", "a"};
+
+	std::vector<std::string> sorted;
+	for (auto& name : names) {
+		sorted.push_back(name);
+	}
+
+	EXPECT_EQ(std::vector<std::string>({"a", "b", "c"}), sorted);
+	EXPECT_FALSE(InternedString("a") < InternedString("a"));
+}
+
+TEST_F(InternedStringTests,
+InterningSameStringAgainDoesNotGrowPool) {
+	InternedString s("interned_string_tests_unique_name");
+	std::size_t size = InternedString::getPoolSize();
+
+	InternedString again("interned_string_tests_unique_name");
+
+	EXPECT_EQ(s, again);
+	EXPECT_EQ(size, InternedString::getPoolSize());
+}
+
+TEST_F(InternedStringTests,
+StringsInternedFromDifferentThreadsAreEqual) {
+	std::vector<InternedString> results(8);
+	std::vector<std::thread> threads;
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		threads.emplace_back([&results, i]() {
+			for (int j = 0; j < 1000; ++j) {
+				InternedString(std::to_string(j));
+			}
+			results[i] = InternedString("shared_by_threads");
+		});
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+
+	std::unordered_set<InternedString> unique(results.begin(), results.end());
+	EXPECT_EQ(1, unique.size());
+}
+
+} // namespace tests
+} // namespace utils
+} // namespace retdec
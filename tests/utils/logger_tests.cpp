@@ -0,0 +1,96 @@
+/**
+ * @file tests/utils/logger_tests.cpp
+ * @brief Tests for the @c logger module.
+ * @copyright (c) 2021 Avast Software, licensed under the MIT license
+ */
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/io/logger.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace io {
+namespace tests {
+
+class AsyncLoggerTests: public Test {};
+
+TEST_F(AsyncLoggerTests,
+FlushWritesCompleteRecords) {
+	std::ostringstream out;
+	AsyncLogger logger(out);
+
+	logger << "value: " << 42 << std::endl;
+	logger.flush();
+
+	EXPECT_EQ("value: 42\n", out.str());
+}
+
+TEST_F(AsyncLoggerTests,
+UnfinishedRecordsAreWrittenOnDestruction) {
+	std::ostringstream out;
+	{
+		AsyncLogger logger(out);
+		logger << "first\nsecond";
+	}
+
+	EXPECT_EQ("first\nsecond", out.str());
+}
+
+TEST_F(AsyncLoggerTests,
+NonVerboseLoggerWritesNothing) {
+	std::ostringstream out;
+	{
+		AsyncLogger logger(out, false);
+		logger << "hidden" << std::endl;
+	}
+
+	EXPECT_EQ("", out.str());
+}
+
+TEST_F(AsyncLoggerTests,
+RecordsOfDifferentThreadsAreNotInterleaved) {
+	const unsigned threadCount = 4;
+	const unsigned lineCount = 1000;
+	std::ostringstream out;
+	{
+		AsyncLogger logger(out);
+		std::vector<std::thread> threads;
+		for (unsigned t = 0; t < threadCount; ++t) {
+			threads.emplace_back([&logger, t]() {
+				for (unsigned i = 0; i < lineCount; ++i) {
+					logger << "thread " << t << " line " << i << "\n";
+				}
+			});
+		}
+		for (auto& t : threads) {
+			t.join();
+		}
+	}
+
+	std::vector<unsigned> nextLine(threadCount, 0);
+	std::istringstream in(out.str());
+	std::string word1, word2;
+	unsigned t = 0, i = 0;
+	unsigned lines = 0;
+	while (in >> word1 >> t >> word2 >> i) {
+		ASSERT_EQ("thread", word1);
+		ASSERT_EQ("line", word2);
+		ASSERT_LT(t, threadCount);
+		EXPECT_EQ(nextLine[t], i);
+		nextLine[t] = i + 1;
+		++lines;
+	}
+	EXPECT_EQ(threadCount * lineCount, lines);
+}
+
+} // namespace tests
+} // namespace io
+} // namespace utils
+} // namespace retdec
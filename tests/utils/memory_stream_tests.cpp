@@ -0,0 +1,103 @@
+/**
+* @file tests/utils/memory_stream_tests.cpp
+* @brief Tests for the @c memory_stream module.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/file_io.h"
+#include "retdec/utils/memory_stream.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace tests {
+
+/**
+* @brief Tests for the @c memory_stream module.
+*/
+class MemoryStreamTests: public Test {};
+
+TEST_F(MemoryStreamTests,
+NewStreamIsEmpty) {
+	MemoryStream s;
+
+	ASSERT_TRUE(s.good());
+	ASSERT_TRUE(s.getData().empty());
+}
+
+TEST_F(MemoryStreamTests,
+WrittenDataAreStoredInStream) {
+	MemoryStream s;
+
+	s.write("abc", 3);
+
+	ASSERT_TRUE(s.good());
+	ASSERT_EQ(std::vector<std::uint8_t>({'a', 'b', 'c'}), s.getData());
+}
+
+TEST_F(MemoryStreamTests,
+WriteBeyondEndFillsGapWithZeros) {
+	MemoryStream s;
+
+	ASSERT_TRUE(writeFile(s, std::vector<std::uint8_t>{1, 2}, 3));
+
+	ASSERT_EQ(std::vector<std::uint8_t>({0, 0, 0, 1, 2}), s.getData());
+}
+
+TEST_F(MemoryStreamTests,
+WriteInsideDataOverwritesThem) {
+	MemoryStream s(std::vector<std::uint8_t>{1, 2, 3, 4});
+
+	ASSERT_TRUE(writeFile(s, std::vector<std::uint8_t>{7, 8}, 1));
+
+	ASSERT_EQ(std::vector<std::uint8_t>({1, 7, 8, 4}), s.getData());
+}
+
+TEST_F(MemoryStreamTests,
+TellpAfterSeekToEndReturnsDataSize) {
+	MemoryStream s(std::vector<std::uint8_t>{1, 2, 3});
+
+	s.seekp(0, std::ios::end);
+
+	ASSERT_EQ(3, s.tellp());
+}
+
+TEST_F(MemoryStreamTests,
+ReadReturnsStoredData) {
+	MemoryStream s(std::vector<std::uint8_t>{1, 2, 3, 4});
+	std::vector<std::uint8_t> data;
+
+	ASSERT_TRUE(readFile(s, data, 1, 2));
+
+	ASSERT_EQ(std::vector<std::uint8_t>({2, 3}), data);
+}
+
+TEST_F(MemoryStreamTests,
+ReadBeyondEndFails) {
+	MemoryStream s(std::vector<std::uint8_t>{1, 2});
+	char c[4];
+
+	s.read(c, 4);
+
+	ASSERT_TRUE(s.eof());
+	ASSERT_EQ(2, s.gcount());
+}
+
+TEST_F(MemoryStreamTests,
+ReleaseDataMovesDataOutAndEmptiesStream) {
+	MemoryStream s;
+	s.write("ab", 2);
+
+	auto data = s.releaseData();
+
+	ASSERT_EQ(std::vector<std::uint8_t>({'a', 'b'}), data);
+	ASSERT_TRUE(s.getData().empty());
+	ASSERT_EQ(0, s.tellp());
+}
+
+} // namespace tests
+} // namespace utils
+} // namespace retdec
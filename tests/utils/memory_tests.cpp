@@ -73,6 +73,16 @@ LimitSystemMemoryToHalfOfTotalSystemMemoryReturnsTrue) {
 	ASSERT_TRUE(limitSystemMemoryToHalfOfTotalSystemMemory());
 }
 
+TEST_F(MemoryTests,
+GetCurrentProcessMemoryReturnsNonZeroSize) {
+	ASSERT_GT(getCurrentProcessMemory(), 0);
+}
+
+TEST_F(MemoryTests,
+GetPeakProcessMemoryReturnsNonZeroSize) {
+	ASSERT_GT(getPeakProcessMemory(), 0);
+}
+
 } // namespace tests
 } // namespace utils
 } // namespace retdec
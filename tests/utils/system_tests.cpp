@@ -0,0 +1,72 @@
+/**
+* @file tests/utils/system_tests.cpp
+* @brief Tests for the @c system module.
+* @copyright (c) 2021 Avast Software, licensed under the MIT license
+*/
+
+#include <gtest/gtest.h>
+
+#include "retdec/utils/system.h"
+
+using namespace ::testing;
+
+namespace retdec {
+namespace utils {
+namespace tests {
+
+/**
+* @brief Tests for the @c system module.
+*/
+class SystemTests: public Test {};
+
+//
+// parseCpuList()
+//
+
+TEST_F(SystemTests,
+ParseCpuListParsesSingleCpusAndRanges) {
+	EXPECT_EQ(std::vector<unsigned>({0, 1, 2, 3, 8, 10, 11}),
+		parseCpuList("0-3,8,10-11"));
+}
+
+TEST_F(SystemTests,
+ParseCpuListSortsAndDeduplicatesCpusAndIgnoresWhiteSpaces) {
+	EXPECT_EQ(std::vector<unsigned>({1, 2, 3, 5}),
+		parseCpuList(" 5, 2-3 ,1-2\n"));
+}
+
+TEST_F(SystemTests,
+ParseCpuListReturnsNothingForEmptyList) {
+	EXPECT_TRUE(parseCpuList("").empty());
+}
+
+TEST_F(SystemTests,
+ParseCpuListReturnsNothingForInvalidList) {
+	EXPECT_TRUE(parseCpuList("0-3,x").empty());
+	EXPECT_TRUE(parseCpuList("3-1").empty());
+	EXPECT_TRUE(parseCpuList("1-3-5").empty());
+	EXPECT_TRUE(parseCpuList("2a").empty());
+}
+
+//
+// getCpusByNumaNode(), getAvailableCpuCount()
+//
+
+TEST_F(SystemTests,
+EveryNumaNodeHasSomeCpus) {
+	auto nodes = getCpusByNumaNode();
+
+	ASSERT_FALSE(nodes.empty());
+	for (auto& cpus : nodes) {
+		EXPECT_FALSE(cpus.empty());
+	}
+}
+
+TEST_F(SystemTests,
+AtLeastOneCpuIsAvailable) {
+	EXPECT_LE(1, getAvailableCpuCount());
+}
+
+} // namespace tests
+} // namespace utils
+} // namespace retdec